@@ -31,6 +31,10 @@ out vec4 FragColor;
 
 uniform sampler2D inputTexture;
 
+// With indexed input, the red channel of the input holds palette indexes
+uniform int       INDEXED_INPUT;
+uniform sampler2D paletteTexture;
+
 uniform int COLOR_SPACE;
 
 uniform int ENABLE_ADJUSTMENTS;
@@ -351,9 +355,18 @@ const float CrtBlackLevel =
         945461.0;
 
 
+vec3 get_input_color()
+{
+	if (INDEXED_INPUT == 1) {
+		int index = int(texture(inputTexture, v_texCoord).r * 255.0 + 0.5);
+		return texelFetch(paletteTexture, ivec2(index, 0), 0).rgb;
+	}
+	return texture(inputTexture, v_texCoord).rgb;
+}
+
 void main()
 {
-	vec3 color = texture(inputTexture, v_texCoord).rgb;
+	vec3 color = get_input_color();
 	vec3 orig_color = color;
 
 	color = sigmoid_contrast(color, DIGITAL_CONTRAST);
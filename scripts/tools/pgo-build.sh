@@ -0,0 +1,60 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# Builds a profile-guided optimized release binary on Linux:
+#
+#   1. builds an instrumented binary (the 'release-linux-pgo-generate' preset)
+#   2. trains it on the guest benchmark corpus with every CPU core, covering
+#      real and protected mode, the dynamic core, the Voodoo and audio
+#   3. rebuilds it with the collected profile ('release-linux-pgo-use')
+#
+# If a regular release build exists ('release-linux' preset), both binaries
+# are benchmarked afterwards and the speedup of the optimized build printed.
+
+set -euo pipefail
+
+if [ "$#" -ne 1 ]; then
+  echo "Usage: $0 <corpus-dir>"
+  echo
+  echo "See extras/benchmarks/corpus.json for the workloads of the corpus."
+  exit 1
+fi
+
+CORPUS_DIR="$1"
+
+cd "$(dirname "$0")/../.."
+
+BUILD_DIR=build/release-linux-pgo
+PROFILE_DIR=build/pgo-profile
+RUNNER=scripts/tools/run-guest-benchmarks.py
+
+# Stale profiles of older sources would skew the optimization
+rm -rf "$PROFILE_DIR"
+
+echo "Building the instrumented binary"
+cmake --preset=release-linux-pgo-generate
+cmake --build --preset=release-linux-pgo-generate
+
+echo "Training on the corpus"
+# A failed workload still leaves a usable profile of the others
+"$RUNNER" "$BUILD_DIR/dosbox" "$CORPUS_DIR" || echo "Some training runs failed"
+
+# Clang writes raw profiles that need merging; GCC's are used as they are
+if ls "$PROFILE_DIR"/*.profraw > /dev/null 2>&1; then
+  echo "Merging the profiles"
+  llvm-profdata merge -output="$PROFILE_DIR/default.profdata" "$PROFILE_DIR"/*.profraw
+fi
+
+echo "Building the optimized binary"
+cmake --preset=release-linux-pgo-use
+cmake --build --preset=release-linux-pgo-use
+
+if [ -x build/release-linux/dosbox ]; then
+  echo "Benchmarking the regular release build"
+  "$RUNNER" --json "$BUILD_DIR/baseline.json" build/release-linux/dosbox "$CORPUS_DIR"
+
+  echo "Benchmarking the optimized build"
+  "$RUNNER" --baseline "$BUILD_DIR/baseline.json" "$BUILD_DIR/dosbox" "$CORPUS_DIR"
+fi
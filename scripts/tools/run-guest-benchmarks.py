@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+
+# SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+"""
+Run a corpus of DOS workloads in benchmark mode and report how many times
+faster than real time each of them ran on each CPU core.
+
+Every workload is run with fixed cycles and its own autoexec for a fixed
+number of emulated frames, headless and unthrottled (see '--benchmark').
+The score of a core is the geometric mean of the speeds of its workloads,
+so a single number can be compared between builds and host machines.
+
+Usage: run-guest-benchmarks.py [options] DOSBOX CORPUS-DIR
+
+The workloads are described in extras/benchmarks/corpus.json by default.
+"""
+
+# pylint: disable=invalid-name
+# pylint: disable=missing-docstring
+
+import argparse
+import json
+import math
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+DEFAULT_CORES = ["normal", "dynamic", "simple"]
+
+DEFAULT_MANIFEST = os.path.join(os.path.dirname(__file__), "..", "..",
+                                "extras", "benchmarks", "corpus.json")
+
+REPORT_PATTERN = re.compile(
+    r"BENCHMARK: frames: (\d+), wall time: ([\d.]+) s, .*"
+    r"emulated time: ([\d.]+) s, speed: ([\d.]+)x")
+
+
+def write_config(file, workload, core, corpus_dir):
+    settings = {
+        "cpu": {
+            "core": core,
+            "cpu_cycles": str(workload["cycles"]),
+            "cpu_cycles_protected": str(workload["cycles"]),
+            "cpu_throttle": "false",
+        },
+    }
+    for section, values in workload.get("settings", {}).items():
+        settings.setdefault(section, {}).update(values)
+
+    for section, values in settings.items():
+        file.write(f"[{section}]\n")
+        for name, value in values.items():
+            file.write(f"{name} = {value}\n")
+        file.write("\n")
+
+    directory = os.path.abspath(os.path.join(corpus_dir, workload["directory"]))
+
+    file.write("[autoexec]\n")
+    file.write(f'mount c "{directory}"\n')
+    file.write("c:\n")
+    for command in workload["commands"]:
+        file.write(f"{command}\n")
+
+
+def run_workload(dosbox, workload, core, corpus_dir, timeout):
+    with tempfile.NamedTemporaryFile("w", suffix=".conf",
+                                     delete=False) as conf:
+        write_config(conf, workload, core, corpus_dir)
+
+    try:
+        result = subprocess.run(
+            [dosbox, "--noprimaryconf", "--nolocalconf", "--conf", conf.name,
+             "--benchmark", "--frames", str(workload["frames"])],
+            capture_output=True, text=True, timeout=timeout, check=False)
+    except subprocess.TimeoutExpired:
+        return None
+    finally:
+        os.remove(conf.name)
+
+    match = REPORT_PATTERN.search(result.stdout)
+    if not match:
+        return None
+
+    return {
+        "frames": int(match.group(1)),
+        "wall_time": float(match.group(2)),
+        "emulated_time": float(match.group(3)),
+        "speed": float(match.group(4)),
+    }
+
+
+def geometric_mean(values):
+    return math.exp(sum(math.log(v) for v in values) / len(values))
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        description=__doc__)
+
+    parser.add_argument("dosbox", help="path to the dosbox executable")
+
+    parser.add_argument("corpus_dir",
+                        help="directory holding the workload directories")
+
+    parser.add_argument("--manifest", default=DEFAULT_MANIFEST,
+                        help="workload descriptions (default: %(default)s)")
+
+    parser.add_argument("--cores", default=",".join(DEFAULT_CORES),
+                        help="comma-separated CPU cores to run "
+                             "(default: %(default)s)")
+
+    parser.add_argument("--workloads",
+                        help="comma-separated names of the workloads to run "
+                             "(default: all whose directory exists)")
+
+    parser.add_argument("--timeout", type=int, default=600,
+                        help="seconds before a run is abandoned "
+                             "(default: %(default)s)")
+
+    parser.add_argument("--json", metavar="FILE",
+                        help="also write the results to FILE as JSON")
+
+    parser.add_argument("--baseline", metavar="FILE",
+                        help="report the speedup of each core over the "
+                             "results of an earlier '--json' run")
+
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+
+    with open(args.manifest, encoding="utf-8") as file:
+        workloads = json.load(file)["workloads"]
+
+    if args.workloads:
+        wanted = args.workloads.split(",")
+        workloads = [w for w in workloads if w["name"] in wanted]
+
+    available = []
+    for workload in workloads:
+        if os.path.isdir(os.path.join(args.corpus_dir, workload["directory"])):
+            available.append(workload)
+        else:
+            print(f"Skipping '{workload['name']}': "
+                  f"'{workload['directory']}' not found in the corpus")
+
+    if not available:
+        print("No workloads to run")
+        return 1
+
+    cores = args.cores.split(",")
+    results = {core: {} for core in cores}
+    failed = False
+
+    for workload in available:
+        for core in cores:
+            name = workload["name"]
+            result = run_workload(args.dosbox, workload, core,
+                                  args.corpus_dir, args.timeout)
+            if not result:
+                print(f"{name:<20} {core:<8} FAILED")
+                failed = True
+                continue
+
+            results[core][name] = result
+            print(f"{name:<20} {core:<8} "
+                  f"{result['emulated_time']:8.2f} s emulated in "
+                  f"{result['wall_time']:7.2f} s, "
+                  f"speed: {result['speed']:7.2f}x")
+
+    baseline = {}
+    if args.baseline:
+        with open(args.baseline, encoding="utf-8") as file:
+            baseline = json.load(file)
+
+    print()
+    for core in cores:
+        speeds = [r["speed"] for r in results[core].values() if r["speed"] > 0]
+        if speeds:
+            print(f"Score of the {core} core: {geometric_mean(speeds):.2f}x "
+                  f"over {len(speeds)} workloads")
+
+        # Only compare the workloads both runs have completed
+        ratios = []
+        for name, result in results[core].items():
+            base = baseline.get(core, {}).get(name)
+            if base and base["speed"] > 0 and result["speed"] > 0:
+                ratios.append(result["speed"] / base["speed"])
+        if ratios:
+            print(f"  speedup over the baseline: "
+                  f"{(geometric_mean(ratios) - 1) * 100:+.1f}% "
+                  f"over {len(ratios)} workloads")
+
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as file:
+            json.dump(results, file, indent=2)
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
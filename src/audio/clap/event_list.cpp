@@ -113,6 +113,11 @@ void EventList::AddMidiSysExEvent(const std::vector<uint8_t>& msg,
 	event_data.insert(event_data.end(), ev_start, ev_end);
 }
 
+bool EventList::HasRoomForMidiSysExEvent(const size_t num_bytes) const
+{
+	return sysex_data.size() + num_bytes <= MaxMidiSysExBytes;
+}
+
 uint32_t EventList::Size() const
 {
 	return check_cast<uint32_t>(event_offsets.size());
@@ -30,6 +30,9 @@ public:
 	void AddMidiSysExEvent(const std::vector<uint8_t>& msg,
 	                       const uint32_t sample_offset);
 
+	// The SysEx messages of the list share a fixed-size buffer
+	bool HasRoomForMidiSysExEvent(const size_t num_bytes) const;
+
 	// Returns the number of events
 	uint32_t Size() const;
 
@@ -10,6 +10,7 @@
 #include "utils/checks.h"
 #include "event_list.h"
 #include "library.h"
+#include "misc/support.h"
 
 CHECK_NARROWING();
 
@@ -54,16 +55,24 @@ Plugin::~Plugin()
 	plugin = nullptr;
 }
 
-void Plugin::Activate(const int sample_rate_hz)
+void Plugin::Activate(const int sample_rate_hz, const int _max_block_frames)
 {
+	assert(_max_block_frames > 0);
+	max_block_frames = _max_block_frames;
+
+	// Partial blocks are still processed when the host needs to catch up
 	constexpr auto MinFrameCount = 1;
-	constexpr auto MaxFrameCount = 8192;
 
-	plugin->activate(plugin, sample_rate_hz, MinFrameCount, MaxFrameCount);
+	plugin->activate(plugin,
+	                 sample_rate_hz,
+	                 MinFrameCount,
+	                 check_cast<uint32_t>(max_block_frames));
 }
 
 void Plugin::Process(float** audio_out, const int num_frames, EventList& event_list)
 {
+	assert(num_frames > 0 && num_frames <= max_block_frames);
+
 	process.audio_outputs->data32 = audio_out;
 
 	constexpr auto SteadyTimeNotAvailable = -1;
@@ -23,9 +23,13 @@ public:
 	Plugin(const std::shared_ptr<Library> library, const clap_plugin_t* plugin);
 	~Plugin();
 
-	// Must be called before the first `Process()` call
-	void Activate(const int sample_rate_hz);
+	// Must be called before the first `Process()` call. The plugin is told
+	// it will be processed in blocks of at most `max_block_frames` audio
+	// frames, which lets it size its internal buffers for that block.
+	void Activate(const int sample_rate_hz, const int max_block_frames);
 
+	// The sample offsets of the events must be less than `num_frames` and
+	// in ascending order
 	void Process(float** audio_out, const int num_frames, EventList& event_list);
 
 	// prevent copying
@@ -47,6 +51,8 @@ private:
 
 	const clap_plugin_t* plugin = nullptr;
 
+	int max_block_frames = 0;
+
 	clap_audio_buffer_t audio_in  = {};
 	clap_audio_buffer_t audio_out = {};
 
@@ -8,8 +8,8 @@
 #include <cmath>
 #include <cstring>
 #include <fstream>
+#include <map>
 #include <memory>
-#include <mutex>
 #include <string>
 #include <vector>
 
@@ -17,6 +17,7 @@
 #include "config/setup.h"
 #include "decoders/dr_flac.h"
 #include "hardware/timer.h"
+#include "misc/support.h"
 #include "mixer.h"
 #include "utils/checks.h"
 
@@ -82,21 +83,20 @@ void DiskNoises::AudioCallback(const int num_frames_requested)
 	// Check if callback runs before mix_channel is assigned.
 	assert(mix_channel != nullptr);
 
-	// stereo interleaved buffer
-	static std::vector<AudioFrame> out = {};
-	out.clear();
-
-	// Mix audio frames from all active devices
-	for (auto i = 0; i < num_frames_requested; ++i) {
-		AudioFrame mixed_sample = {};
-		for (const auto& device : active_devices) {
-			auto sample = device->GetNextFrame();
-			mixed_sample += sample;
-		}
-		out.emplace_back(mixed_sample);
+	for (const auto& device : active_devices) {
+		device->ProcessEvents();
 	}
 
-	mix_channel->AddAudioFrames(out);
+	// Mix audio frames from all active devices straight into the channel
+	auto mix_devices = [&](std::span<AudioFrame> out) {
+		for (auto& frame : out) {
+			frame = {};
+			for (const auto& device : active_devices) {
+				frame += device->GetNextFrame();
+			}
+		}
+	};
+	mix_channel->RenderAudioFrames(num_frames_requested, mix_devices);
 }
 
 DiskNoises::~DiskNoises()
@@ -116,56 +116,50 @@ DiskNoises::~DiskNoises()
 
 AudioFrame DiskNoiseDevice::GetNextFrame()
 {
-	std::lock_guard<std::mutex> lock(mutex);
 	constexpr float DiskNoiseGain = 0.2f;
-	float sample                  = 0.0f;
+
+	if (!samples) {
+		return {};
+	}
+
+	const auto& buffer = samples->buffer;
+
+	float sample = 0.0f;
+
+	auto play = [&](Voice& voice) {
+		sample += static_cast<float>(buffer[voice.pos]) * DiskNoiseGain;
+		++voice.pos;
+	};
 
 	// Mix in spinup and spin samples
-	if (!spin.spin_up_sample.empty()) {
-		if (spin.spin_up_it != spin.spin_up_sample.end()) {
-			sample += (*spin.spin_up_it) * DiskNoiseGain;
-			++spin.spin_up_it;
-		} else {
-			// If spinup sample has finished playing, clear entry
-			spin.spin_up_sample.clear();
-			spin.spin_up_it = spin.spin_up_sample.end();
-		}
-	} else if (!spin.sample.empty() &&
-	           (spin.spin_it != spin.sample.end() || spin.loop)) {
+	if (spin_up.IsPlaying()) {
+		play(spin_up);
+	} else {
 		// Loop the spin sound if enabled. Used for persistent HDD
 		// noise. Not used for floppy noise because motor should stop
 		// after read-write operations are done.
-		if (spin.spin_it == spin.sample.end() && spin.loop) {
-			spin.spin_it = spin.sample.begin();
+		if (!spin.IsPlaying() && loop_spin) {
+			spin.Start(samples->spin);
 		}
-		if (spin.spin_it != spin.sample.end()) {
-			sample += (*spin.spin_it) * DiskNoiseGain;
-			++spin.spin_it;
+		if (spin.IsPlaying()) {
+			play(spin);
 		}
 	}
 
 	// Mix in seek sample, if it's playing
-	if (!seek.current_sample.empty() &&
-	    seek.current_it != seek.current_sample.end()) {
-		sample += (*seek.current_it) * DiskNoiseGain;
-		++seek.current_it;
-	}
-
-	// If seek sample has finished playing, clear entry
-	if (!seek.current_sample.empty() &&
-	    seek.current_it == seek.current_sample.end()) {
-		seek.current_sample.clear();
-		seek.current_it = seek.current_sample.end();
+	if (seek.IsPlaying()) {
+		play(seek);
 	}
 
 	return AudioFrame{sample};
 }
 
-void DiskNoiseDevice::LoadSample(const std::string& path,
-                                 std::vector<float>& destination_buffer)
+// Decodes a FLAC sample and appends it to the sample set's buffer
+static DiskNoiseSample decode_sample(const std::string& path,
+                                     std::vector<int16_t>& buffer)
 {
 	if (path.empty()) {
-		return;
+		return {};
 	}
 
 	constexpr auto SampleExtension = ".flac";
@@ -221,7 +215,7 @@ void DiskNoiseDevice::LoadSample(const std::string& path,
 
 			drflac_close(decoder);
 			continue;
-		}		
+		}
 		if (sample_rate != DiskNoiseSampleRateInHz) {
 			LOG_ERR("DISKNOISE: FLAC file '%s' should be %d kHz, but %d kHz was found",
 			        candidate.string().c_str(),
@@ -232,67 +226,71 @@ void DiskNoiseDevice::LoadSample(const std::string& path,
 			continue;
 		}
 
-		destination_buffer.resize(static_cast<size_t>(total_frames) * channels);
-		drflac_uint64 frames_read = drflac_read_pcm_frames_f32(
-		        decoder, total_frames, destination_buffer.data());
+		// Decode straight into the shared buffer; 16-bit samples are
+		// plenty for background noise and take half the memory of floats
+		const auto offset = buffer.size();
+		buffer.resize(offset + static_cast<size_t>(total_frames));
+
+		const auto frames_read = drflac_read_pcm_frames_s16(
+		        decoder, total_frames, buffer.data() + offset);
 		drflac_close(decoder);
 
+		buffer.resize(offset + static_cast<size_t>(frames_read));
+
 		if (frames_read == 0) {
 			LOG_ERR("DISKNOISE: Failed to decode FLAC frames from '%s'",
 			        candidate.string().c_str());
 			continue;
 		}
 
-		// Scale data to integer value range
-		const auto scale = static_cast<float>(INT16_MAX);
-		for (auto& sample : destination_buffer) {
-			sample *= scale;
-		}
-
-		LOG_DEBUG("DISKNOISE: Loaded %zu samples from '%s'",
-		          destination_buffer.size(),
+		LOG_DEBUG("DISKNOISE: Loaded %llu samples from '%s'",
+		          static_cast<unsigned long long>(frames_read),
 		          candidate.string().c_str());
-		return;
+
+		return {offset, static_cast<size_t>(frames_read)};
 	}
 
 	LOG_ERR("DISKNOISE: Failed to find FLAC file: '%s'", path.c_str());
+	return {};
 }
 
-void DiskNoiseDevice::LoadSeekSamples(const std::vector<std::string>& paths)
+// Returns the cached sample set of the disk type, decoding it on first use
+static std::shared_ptr<const DiskNoiseSampleSet> get_sample_set(
+        const DiskType disk_type, const std::string& spin_up_sample_path,
+        const std::string& spin_sample_path,
+        const std::vector<std::string>& seek_sample_paths)
 {
-	for (const auto& path : paths) {
-		if (path.empty()) {
-			// Placeholder for missing sample files
-			seek.samples.emplace_back();
-			continue;
-		}
+	static std::map<DiskType, std::shared_ptr<const DiskNoiseSampleSet>> cache = {};
 
-		std::vector<float> sample = {};
-		LoadSample(path, sample);
-		if (!sample.empty()) {
-			seek.samples.emplace_back(std::move(sample));
-		} else {
-			seek.samples.emplace_back();
-		}
+	if (const auto it = cache.find(disk_type); it != cache.end()) {
+		return it->second;
 	}
 
-	// Assign weights with descending priority (most weight to first samples)
-	const int max_weight = 10;
-	seek.sample_weights.resize(seek.samples.size());
-	for (size_t i = 0; i < seek.samples.size(); ++i) {
-		seek.sample_weights[i] = static_cast<int>(max_weight - i);
+	auto set = std::make_shared<DiskNoiseSampleSet>();
+
+	set->spin_up = decode_sample(spin_up_sample_path, set->buffer);
+	set->spin    = decode_sample(spin_sample_path, set->buffer);
+
+	for (const auto& path : seek_sample_paths) {
+		// Failed and missing samples keep their place as empty entries
+		set->seeks.emplace_back(decode_sample(path, set->buffer));
 	}
+
+	set->buffer.shrink_to_fit();
+
+	cache[disk_type] = set;
+	return set;
 }
 
 size_t DiskNoiseDevice::ChooseSeekIndex() const
 {
-	if (seek.samples.empty()) {
+	if (samples->seeks.empty()) {
 		return 0;
 	}
 
 	// Sequential seek, always use the first two samples
 	if (seek_type == DiskNoiseSeekType::Sequential) {
-		if (seek.samples.size() == 1) {
+		if (samples->seeks.size() == 1) {
 			return 0;
 		}
 		return (rand() % 2);
@@ -301,8 +299,8 @@ size_t DiskNoiseDevice::ChooseSeekIndex() const
 	// Choose a random sample
 	switch (disk_type) {
 	case DiskType::Floppy: {
-		if (seek.samples.size() <= 2) {
-			return rand() % seek.samples.size();
+		if (samples->seeks.size() <= 2) {
+			return rand() % samples->seeks.size();
 		}
 		// For floppy disks, prefer the first two samples with 80% chance
 		if (rand() % 10 < 8) {
@@ -310,8 +308,8 @@ size_t DiskNoiseDevice::ChooseSeekIndex() const
 		} else {
 			// 20% chance to use any of the other samples
 			std::vector<size_t> valid_indices;
-			for (size_t i = 2; i < seek.samples.size(); ++i) {
-				if (!seek.samples[i].empty()) {
+			for (size_t i = 2; i < samples->seeks.size(); ++i) {
+				if (!samples->seeks[i].IsEmpty()) {
 					valid_indices.push_back(i);
 				}
 			}
@@ -327,8 +325,8 @@ size_t DiskNoiseDevice::ChooseSeekIndex() const
 	case DiskType::HardDisk: {
 		std::vector<size_t> valid_indices;
 		// For hard disks, use all samples with equal probability
-		for (size_t i = 0; i < seek.samples.size(); ++i) {
-			if (!seek.samples[i].empty()) {
+		for (size_t i = 0; i < samples->seeks.size(); ++i) {
+			if (!samples->seeks[i].IsEmpty()) {
 				valid_indices.push_back(i);
 			}
 		}
@@ -387,40 +385,38 @@ DiskNoiseDevice::DiskNoiseDevice(const DiskType disk_type,
 		return;
 	}
 
-	// Only hard disk noises loop the spin sample
-	spin.loop = (disk_type == DiskType::HardDisk);
+	samples = get_sample_set(disk_type,
+	                         spin_up_sample_path,
+	                         spin_sample_path,
+	                         seek_sample_paths);
 
-	// Only attempt to load spin samples if disk noise mode is "on" instead
-	// of "seek-only"
-	if (disk_noise_mode == DiskNoiseMode::On) {
-		LoadSample(spin_up_sample_path, spin.spin_up_sample);
-		LoadSample(spin_sample_path, spin.sample);
-	}
+	// Plenty for the notifications arriving between two mixer callbacks;
+	// most are ignored anyway while a seek sample is playing
+	constexpr auto MaxPendingEvents = 64;
+	events.Resize(MaxPendingEvents);
 
-	// Start iterators at the beginning or end, depending on whether the
-	// disk noise is looping (HDD) or not (FDD)
-	// This prevents fdd spin noise on initial startup
-	if (disk_type == DiskType::HardDisk && !spin.spin_up_sample.empty()) {
-		spin.spin_up_it = spin.spin_up_sample.begin();
-	} else {
-		spin.spin_up_it = spin.spin_up_sample.end();
-	}
+	// Only play spin samples if disk noise mode is "on" instead of
+	// "seek-only". Only hard disk noises loop the spin sample.
+	const auto play_spin = (disk_noise_mode == DiskNoiseMode::On);
+	loop_spin = play_spin && (disk_type == DiskType::HardDisk);
 
-	if (disk_type == DiskType::HardDisk && !spin.sample.empty()) {
-		spin.spin_it = spin.sample.begin();
-	} else {
-		spin.spin_it = spin.sample.end();
+	// Spin up the hard disk right away. This prevents fdd spin noise on
+	// initial startup.
+	if (play_spin && disk_type == DiskType::HardDisk) {
+		spin_up.Start(samples->spin_up);
 	}
 
-	LoadSeekSamples(seek_sample_paths);
-	seek.current_sample.clear();
-	seek.current_it = seek.current_sample.end();
-
 	auto io_callback = [this]() {
-		// This callback is called from the DOS code
-		// to trigger the spin and seek sounds
-		ActivateSpin();
-		PlaySeek();
+		// This callback is called from the DOS code to trigger the
+		// spin and seek sounds. The sample is chosen here as it depends
+		// on the last I/O paths; the mixer thread picks up the event.
+		const auto index = ChooseSeekIndex();
+
+		const auto is_valid = index < samples->seeks.size() &&
+		                      !samples->seeks[index].IsEmpty();
+
+		events.NonblockingEnqueue(
+		        {is_valid ? check_cast<int>(index) : -1});
 	};
 
 	DOS_RegisterIoCallback(io_callback, disk_type);
@@ -432,53 +428,34 @@ DiskNoiseDevice::~DiskNoiseDevice()
 	DOS_UnregisterIoCallback(disk_type);
 }
 
-void DiskNoiseDevice::ActivateSpin()
+void DiskNoiseDevice::ProcessEvents()
 {
-	// Lock mutex to guard against GetNextFrame
-	std::lock_guard<std::mutex> lock(mutex);
-
-	if (disk_noise_mode == DiskNoiseMode::Off) {
-		return;
-	}
+	// We're the only consumer, so the queue can't run empty in between
+	while (!events.IsEmpty()) {
+		const auto event = events.Dequeue();
+		assert(event);
 
-	// Floppy spin samples can be re-started at any time
-	if (!spin.loop) {
-		// Check if the sample is still playing and don't interrupt if
-		// it does
-		if (spin.sample.empty() || spin.spin_it != spin.sample.end()) {
-			return;
-		}
-		// Restart spin sample
-		spin.spin_it = spin.sample.begin();
+		ActivateSpin();
+		PlaySeek(event->seek_index);
 	}
 }
 
-void DiskNoiseDevice::PlaySeek()
+void DiskNoiseDevice::ActivateSpin()
 {
-	// Lock mutex to guard against GetNextFrame
-	std::lock_guard<std::mutex> lock(mutex);
-
-	if (disk_noise_mode == DiskNoiseMode::Off) {
-		return;
-	}
-
-	// Check if the sample is still playing and don't interrupt if it is
-	if (!seek.current_sample.empty() &&
-	    seek.current_it != seek.current_sample.end()) {
+	// Floppy spin samples are restarted once they've finished playing
+	if (disk_noise_mode != DiskNoiseMode::On || loop_spin || spin.IsPlaying()) {
 		return;
 	}
+	spin.Start(samples->spin);
+}
 
-	// Select a seek sample
-	const size_t index = ChooseSeekIndex();
-	if (index >= seek.samples.size() || seek.samples[index].empty()) {
+void DiskNoiseDevice::PlaySeek(const int seek_index)
+{
+	// Don't interrupt the seek sample if it's still playing
+	if (seek_index < 0 || seek.IsPlaying()) {
 		return;
 	}
-
-	// Set the new seek sample
-	if (!seek.samples[index].empty()) {
-		seek.current_sample = seek.samples[index];
-		seek.current_it     = seek.current_sample.begin();
-	}
+	seek.Start(samples->seeks[static_cast<size_t>(seek_index)]);
 }
 
 void DiskNoises::SetLastIoPath(const std::string& path,
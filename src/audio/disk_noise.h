@@ -4,6 +4,7 @@
 #ifndef DOSBOX_DISK_NOISE_H
 #define DOSBOX_DISK_NOISE_H
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -11,6 +12,7 @@
 
 #include "dos/dos.h"
 #include "mixer.h"
+#include "utils/spsc_queue.h"
 
 enum DiskNoiseIoType { Read, Write };
 
@@ -25,6 +27,36 @@ enum class DiskNoiseMode {
 	On,
 };
 
+// A decoded sample; a range within its sample set's buffer
+struct DiskNoiseSample {
+	size_t offset      = 0;
+	size_t num_samples = 0;
+
+	bool IsEmpty() const
+	{
+		return num_samples == 0;
+	}
+};
+
+// All the spin and seek samples of a disk type. They're decoded only once and
+// kept for the lifetime of the program in a single buffer of 16-bit samples,
+// so restarting the emulated machine doesn't decode them again.
+struct DiskNoiseSampleSet {
+	std::vector<int16_t> buffer = {};
+
+	DiskNoiseSample spin_up = {};
+	DiskNoiseSample spin    = {};
+
+	// Empty entries stand in for the samples that couldn't be loaded
+	std::vector<DiskNoiseSample> seeks = {};
+};
+
+// Sent from the DOS I/O callback to the mixer thread
+struct DiskNoiseEvent {
+	// Seek sample to play unless one is playing already, or -1 for none
+	int seek_index = -1;
+};
+
 class DiskNoiseDevice {
 public:
 	DiskNoiseDevice(const DiskType disk_type, const DiskNoiseMode disk_noise_mode,
@@ -32,39 +64,52 @@ public:
 	                const std::string& spin_sample_path,
 	                const std::vector<std::string>& seek_sample_paths);
 	~DiskNoiseDevice();
-	void ActivateSpin();
-	void PlaySeek();
+	void ProcessEvents();
 	AudioFrame GetNextFrame();
 	void SetLastIoPath(const std::string& path,
 	                   DiskNoiseIoType disk_operation_type);
 
 private:
-	DiskNoiseMode disk_noise_mode    = DiskNoiseMode::Off;
-	DiskType disk_type               = DiskType::HardDisk;
-	std::mutex mutex                 = {};
+	// Playback position within the sample set's buffer
+	struct Voice {
+		size_t pos = 0;
+		size_t end = 0;
+
+		void Start(const DiskNoiseSample& sample)
+		{
+			pos = sample.offset;
+			end = sample.offset + sample.num_samples;
+		}
+
+		bool IsPlaying() const
+		{
+			return pos < end;
+		}
+	};
+
+	void ActivateSpin();
+	void PlaySeek(const int seek_index);
+	size_t ChooseSeekIndex() const;
+
+	DiskNoiseMode disk_noise_mode = DiskNoiseMode::Off;
+	DiskType disk_type            = DiskType::HardDisk;
+
+	std::shared_ptr<const DiskNoiseSampleSet> samples = {};
+
+	// I/O notifications from the emulation thread, consumed by the mixer
+	// thread without taking any locks
+	SpscQueue<DiskNoiseEvent> events{1};
+
+	// Only used on the emulation thread
 	std::string last_file_read_path  = {};
 	std::string last_file_write_path = {};
 	DiskNoiseSeekType seek_type      = DiskNoiseSeekType::RandomAccess;
 
-	struct SpinSample {
-		std::vector<float> spin_up_sample = {};
-		std::vector<float> sample         = {};
-		bool loop                         = false;
-		std::vector<float>::const_iterator spin_up_it;
-		std::vector<float>::const_iterator spin_it;
-	} spin = {};
-
-	struct SeekSample {
-		std::vector<std::vector<float>> samples = {};
-		std::vector<int> sample_weights         = {};
-		std::vector<float> current_sample       = {};
-		std::vector<float>::const_iterator current_it;
-	} seek = {};
-
-	void LoadSample(const std::string& path,
-	                std::vector<float>& destination_buffer);
-	void LoadSeekSamples(const std::vector<std::string>& paths);
-	size_t ChooseSeekIndex() const;
+	// Only used on the mixer thread
+	bool loop_spin = false;
+	Voice spin_up  = {};
+	Voice spin     = {};
+	Voice seek     = {};
 };
 
 class DiskNoises {
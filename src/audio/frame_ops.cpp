@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "private/frame_ops.h"
+
+#include "simde/x86/sse2.h"
+#include "utils/checks.h"
+#include "utils/math_utils.h"
+
+CHECK_NARROWING();
+
+// The SIMD versions treat the frame buffers as flat float arrays
+static_assert(sizeof(AudioFrame) == 2 * sizeof(float));
+
+// Number of frames that fit in one 128-bit register
+constexpr size_t FramesPerVector = 2;
+
+static float* as_floats(AudioFrame* frames)
+{
+	return &frames->left;
+}
+
+static const float* as_floats(const AudioFrame* frames)
+{
+	return &frames->left;
+}
+
+void add_frames(AudioFrame* dest, const AudioFrame* src, const size_t num_frames)
+{
+	auto d = as_floats(dest);
+	auto s = as_floats(src);
+
+	size_t i = 0;
+	for (; i + FramesPerVector <= num_frames; i += FramesPerVector) {
+		const auto sum = simde_mm_add_ps(simde_mm_loadu_ps(d),
+		                                 simde_mm_loadu_ps(s));
+		simde_mm_storeu_ps(d, sum);
+
+		d += FramesPerVector * 2;
+		s += FramesPerVector * 2;
+	}
+	scalar::add_frames(dest + i, src + i, num_frames - i);
+}
+
+void add_frames_scaled(AudioFrame* dest, const AudioFrame* src,
+                       const float gain, const size_t num_frames)
+{
+	auto d = as_floats(dest);
+	auto s = as_floats(src);
+
+	const auto g = simde_mm_set1_ps(gain);
+
+	size_t i = 0;
+	for (; i + FramesPerVector <= num_frames; i += FramesPerVector) {
+		const auto scaled = simde_mm_mul_ps(simde_mm_loadu_ps(s), g);
+		simde_mm_storeu_ps(d, simde_mm_add_ps(simde_mm_loadu_ps(d), scaled));
+
+		d += FramesPerVector * 2;
+		s += FramesPerVector * 2;
+	}
+	scalar::add_frames_scaled(dest + i, src + i, gain, num_frames - i);
+}
+
+void scale_frames(AudioFrame* frames, const AudioFrame gain, const size_t num_frames)
+{
+	auto f = as_floats(frames);
+
+	// Lanes from low to high: left, right, left, right
+	const auto g = simde_mm_set_ps(gain.right, gain.left, gain.right, gain.left);
+
+	size_t i = 0;
+	for (; i + FramesPerVector <= num_frames; i += FramesPerVector) {
+		simde_mm_storeu_ps(f, simde_mm_mul_ps(simde_mm_loadu_ps(f), g));
+		f += FramesPerVector * 2;
+	}
+	scalar::scale_frames(frames + i, gain, num_frames - i);
+}
+
+void frames_to_int16(const AudioFrame* src, int16_t* dest, const size_t num_frames)
+{
+	auto s = as_floats(src);
+
+	// Four frames per iteration to fill a register with 16-bit samples
+	constexpr size_t FramesPerStep = FramesPerVector * 2;
+
+	size_t i = 0;
+	for (; i + FramesPerStep <= num_frames; i += FramesPerStep) {
+		// Truncate towards zero like a static_cast<int>, then pack
+		// with signed saturation
+		const auto lo = simde_mm_cvttps_epi32(simde_mm_loadu_ps(s));
+		const auto hi = simde_mm_cvttps_epi32(simde_mm_loadu_ps(s + 4));
+
+		simde_mm_storeu_si128(reinterpret_cast<simde__m128i*>(dest),
+		                      simde_mm_packs_epi32(lo, hi));
+		s += FramesPerStep * 2;
+		dest += FramesPerStep * 2;
+	}
+	scalar::frames_to_int16(src + i, dest, num_frames - i);
+}
+
+namespace scalar {
+
+void add_frames(AudioFrame* dest, const AudioFrame* src, const size_t num_frames)
+{
+	for (size_t i = 0; i < num_frames; ++i) {
+		dest[i] += src[i];
+	}
+}
+
+void add_frames_scaled(AudioFrame* dest, const AudioFrame* src,
+                       const float gain, const size_t num_frames)
+{
+	for (size_t i = 0; i < num_frames; ++i) {
+		dest[i] += src[i] * gain;
+	}
+}
+
+void scale_frames(AudioFrame* frames, const AudioFrame gain, const size_t num_frames)
+{
+	for (size_t i = 0; i < num_frames; ++i) {
+		frames[i] *= gain;
+	}
+}
+
+void frames_to_int16(const AudioFrame* src, int16_t* dest, const size_t num_frames)
+{
+	for (size_t i = 0; i < num_frames; ++i) {
+		*dest++ = clamp_to_int16(static_cast<int>(src[i].left));
+		*dest++ = clamp_to_int16(static_cast<int>(src[i].right));
+	}
+}
+
+} // namespace scalar
@@ -9,8 +9,10 @@
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <condition_variable>
 #include <optional>
 #include <sys/types.h>
+#include <thread>
 
 #include <speex/speex_resampler.h>
 
@@ -18,8 +20,10 @@
 #include "tal-chorus/ChorusEngine.h"
 
 #include "private/compressor.h"
+#include "private/frame_ops.h"
 
 #include "capture/capture.h"
+#include "capture/shared_memory_output.h"
 #include "channel_names.h"
 #include "config/config.h"
 #include "config/setup.h"
@@ -37,7 +41,9 @@
 #include "hardware/video/reelmagic/reelmagic.h"
 #include "midi/midi.h"
 #include "misc/cross.h"
+#include "misc/metrics.h"
 #include "misc/notifications.h"
+#include "misc/tracing.h"
 #include "misc/video.h"
 #include "utils/checks.h"
 #include "utils/math_utils.h"
@@ -63,6 +69,9 @@ constexpr auto EnvelopeExpiresAfterSeconds = 10;
 
 constexpr auto MaxPrebufferMs = 100;
 
+// Upper limit of the extra threads rendering mixer channels
+constexpr auto MaxMixerWorkers = 7;
+
 template <class T, size_t ROWS, size_t COLS>
 using matrix = std::array<std::array<T, COLS>, ROWS>;
 
@@ -153,6 +162,116 @@ struct ChorusSettings {
 // This shows up nicely as 50% and -6.00 dB in the MIXER command's output
 constexpr auto Minus6db = 0.501f;
 
+// Renders mixer channels concurrently. The mixer thread hands over the
+// channels of a mixer block with Render(), takes part in the rendering, and
+// waits until all the channels are done. The results are summed up serially
+// afterwards, so the output is identical to serial rendering.
+class ChannelRenderPool {
+public:
+	~ChannelRenderPool()
+	{
+		Stop();
+	}
+
+	void Start(const int num_workers)
+	{
+		Stop();
+
+		for (auto i = 0; i < num_workers; ++i) {
+			workers.emplace_back(&ChannelRenderPool::WorkerLoop,
+			                     this,
+			                     generation);
+			set_thread_name(workers.back(), "dosbox:mixwork");
+		}
+	}
+
+	void Stop()
+	{
+		{
+			std::lock_guard lock(mutex);
+			should_quit = true;
+		}
+		work_available.notify_all();
+
+		for (auto& worker : workers) {
+			worker.join();
+		}
+		workers.clear();
+
+		should_quit = false;
+	}
+
+	bool IsRunning() const
+	{
+		return !workers.empty();
+	}
+
+	void Render(const std::vector<MixerChannel*>& channels, const int num_frames)
+	{
+		{
+			std::lock_guard lock(mutex);
+
+			jobs           = &channels;
+			frames         = num_frames;
+			next_job       = 0;
+			active_workers = workers.size();
+			++generation;
+		}
+		work_available.notify_all();
+
+		RenderJobs();
+
+		std::unique_lock lock(mutex);
+		work_done.wait(lock, [this] { return active_workers == 0; });
+
+		jobs = nullptr;
+	}
+
+private:
+	void RenderJobs()
+	{
+		for (auto i = next_job++; i < jobs->size(); i = next_job++) {
+			(*jobs)[i]->Mix(frames);
+		}
+	}
+
+	void WorkerLoop(uint64_t last_generation)
+	{
+		while (true) {
+			{
+				std::unique_lock lock(mutex);
+				work_available.wait(lock, [&] {
+					return should_quit || generation != last_generation;
+				});
+				if (should_quit) {
+					return;
+				}
+				last_generation = generation;
+			}
+
+			RenderJobs();
+
+			std::lock_guard lock(mutex);
+			if (--active_workers == 0) {
+				work_done.notify_one();
+			}
+		}
+	}
+
+	std::vector<std::thread> workers = {};
+
+	std::mutex mutex                       = {};
+	std::condition_variable work_available = {};
+	std::condition_variable work_done      = {};
+
+	const std::vector<MixerChannel*>* jobs = nullptr;
+	int frames                             = 0;
+	std::atomic<size_t> next_job           = 0;
+	size_t active_workers                  = 0;
+	uint64_t generation                    = 0;
+	bool should_quit                       = false;
+};
+
 struct MixerSettings {
 	RWQueue<AudioFrame> final_output{1};
 	RWQueue<int16_t> capture_queue{1};
@@ -174,6 +293,15 @@ struct MixerSettings {
 
 	std::map<std::string, MixerChannelPtr> channels = {};
 
+	// The channels mixed in each block. Sleeping and disabled channels are
+	// left out so they cost nothing; the list is rebuilt on the mixer
+	// thread whenever a channel is added, removed, enabled or disabled.
+	std::vector<MixerChannel*> active_channels = {};
+	std::atomic<bool> active_channels_changed  = true;
+
+	// Only used when mixing in parallel
+	ChannelRenderPool render_pool = {};
+
 	std::map<std::string, MixerChannelSettings> channel_settings_cache = {};
 
 	std::atomic<bool> thread_should_quit = false;
@@ -207,6 +335,18 @@ struct MixerSettings {
 
 	std::atomic<bool> fast_forward_mode = false;
 
+	// Play the sped up audio while fast-forwarding, or mute it
+	std::atomic<bool> fast_forward_audio = true;
+
+	// Performance counters, see MIXER_GetStats()
+	struct {
+		std::atomic<int64_t> output_underruns = 0;
+		std::atomic<int64_t> capture_overruns = 0;
+		std::atomic<int64_t> num_blocks       = 0;
+		std::atomic<int64_t> mix_us           = 0;
+		std::atomic<int64_t> max_mix_us       = 0;
+	} stats = {};
+
 	std::recursive_mutex mutex = {};
 };
 
@@ -223,6 +363,8 @@ static struct MixerSettings mixer = {};
 
 	case ResampleMethod::Resample: return "Resample";
 
+	case ResampleMethod::PolyphaseResample: return "Polyphase resample";
+
 	default: assertm(false, "Invalid ResampleMethod"); return "";
 	}
 }
@@ -269,6 +411,12 @@ bool MIXER_FastForwardModeEnabled()
 	return mixer.fast_forward_mode;
 }
 
+bool MIXER_IsFastForwardAudioMuted()
+{
+	return mixer.fast_forward_mode && !mixer.fast_forward_audio &&
+	       !CAPTURE_IsCapturingAudio() && !CAPTURE_IsCapturingVideo();
+}
+
 // The queues listed here are for audio devices that run on the main thread.
 // The mixer thread can be waiting on the main thread to produce audio in these
 // queues. We need to stop them before aquiring a mutex lock to avoid a
@@ -706,6 +854,8 @@ void MIXER_DeregisterChannel(MixerChannelPtr& channel_to_remove)
 			mixer.channel_settings_cache[name] = channel->GetSettings();
 
 			it = mixer.channels.erase(it);
+
+			mixer.active_channels_changed = true;
 			break;
 		}
 		++it;
@@ -756,6 +906,7 @@ MixerChannelPtr MIXER_AddChannel(MIXER_Handler handler,
 
 	MIXER_LockMixerThread();
 	mixer.channels[name] = chan; // replace the old, if it exists
+	mixer.active_channels_changed = true;
 	MIXER_UnlockMixerThread();
 
 	return chan;
@@ -893,6 +1044,8 @@ void MixerChannel::Enable(const bool should_enable)
 	}
 
 	is_enabled = should_enable;
+
+	mixer.active_channels_changed = true;
 }
 
 // Depending on the resampling method and the channel, mixer and ZoH upsampler
@@ -932,6 +1085,11 @@ void MixerChannel::Enable(const bool should_enable)
 //   - Speex resampling if:
 //   	   channel_rate_hz != mixer_rate_hz
 //
+// PolyphaseResample
+// -----------------
+//   - Polyphase resampling if:
+//   	   channel_rate_hz != mixer_rate_hz
+//
 void MixerChannel::ConfigureResampler()
 {
 #ifdef DEBUG_MIXER
@@ -947,6 +1105,8 @@ void MixerChannel::ConfigureResampler()
 	do_zoh_upsample  = false;
 	do_resample      = false;
 
+	do_polyphase_resample = false;
+
 	auto configure_speex_resampler = [&](const int _in_rate_hz) {
 		const spx_uint32_t in_rate_hz  = _in_rate_hz;
 		const spx_uint32_t out_rate_hz = mixer_rate_hz;
@@ -1048,6 +1208,20 @@ void MixerChannel::ConfigureResampler()
 			configure_speex_resampler(channel_rate_hz);
 		}
 		break;
+
+	case ResampleMethod::PolyphaseResample:
+		if (channel_rate_hz != mixer_rate_hz) {
+			do_polyphase_resample = true;
+			polyphase_resampler.Configure(channel_rate_hz, mixer_rate_hz);
+
+			LOG_DEBUG("%s: Polyphase resampler is on, input rate: %d Hz, "
+			          "output rate: %d Hz, %d taps",
+			          name.c_str(),
+			          channel_rate_hz,
+			          mixer_rate_hz,
+			          check_cast<int>(polyphase_resampler.GetNumTaps()));
+		}
+		break;
 	}
 }
 
@@ -1073,6 +1247,9 @@ void MixerChannel::ClearResampler()
 		          speex_resampler_get_input_latency(speex_resampler.state));
 #endif
 	}
+	if (do_polyphase_resample) {
+		polyphase_resampler.Reset();
+	}
 }
 
 void MixerChannel::SetSampleRate(const int new_sample_rate_hz)
@@ -1120,6 +1297,17 @@ void MixerChannel::SetSampleRate(const int new_sample_rate_hz)
 	}
 
 	ConfigureResampler();
+
+	// Preallocate room for a few blocks, so the buffers don't have to grow
+	// while the audio is streaming
+	constexpr auto NumBlocksToReserve = 4;
+
+	const auto num_input_frames  = iceil(GetFramesPerBlock() *
+	                                     NumBlocksToReserve);
+	const auto num_output_frames = mixer.blocksize * NumBlocksToReserve;
+
+	convert_buffer.reserve(check_cast<size_t>(std::max(num_input_frames, 0)));
+	audio_frames.reserve(check_cast<size_t>(std::max(num_output_frames, 0)));
 }
 
 const std::string& MixerChannel::GetName()
@@ -1188,6 +1376,10 @@ void MixerChannel::Mix(const int frames_requested)
 		return;
 	}
 
+	const auto start_us = GetTicksUs();
+
+	stats.awake_frames += frames_requested;
+
 	frames_needed = frames_requested;
 
 	while (frames_needed > audio_frames.size()) {
@@ -1208,6 +1400,43 @@ void MixerChannel::Mix(const int frames_requested)
 		lock.unlock();
 		handler(frames_remaining);
 	}
+
+	stats.mix_us += GetTicksUsSince(start_us);
+}
+
+MixerChannelStats MixerChannel::GetStats()
+{
+	MixerChannelStats s = {};
+
+	s.name               = name;
+	s.sample_rate_hz     = sample_rate_hz;
+	s.queue_percent_full = stats.queue_percent_full;
+	s.latency_ms         = stats.latency_ms;
+	s.underruns          = stats.underruns;
+	s.mix_us             = stats.mix_us;
+	s.resample_us        = stats.resample_us;
+
+	const auto mixer_rate_hz = mixer.sample_rate_hz.load();
+	if (mixer_rate_hz > 0) {
+		s.awake_ms = stats.awake_frames * 1000 / mixer_rate_hz;
+	}
+
+	return s;
+}
+
+void MixerChannel::RecordQueueFill(const float percent_full)
+{
+	stats.queue_percent_full.store(percent_full, std::memory_order_relaxed);
+}
+
+void MixerChannel::RecordUnderrun()
+{
+	stats.underruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MixerChannel::RecordLatency(const float latency_ms)
+{
+	stats.latency_ms.store(latency_ms, std::memory_order_relaxed);
 }
 
 void MixerChannel::AddSilence()
@@ -1863,6 +2092,32 @@ AudioFrame MixerChannel::ConvertNextFrame(const Type* data, const int pos)
 }
 // clang-format on
 
+// Applies the channel's gain and channel mappings to the previous frame, and
+// removes clicks
+AudioFrame MixerChannel::MapPrevFrame(const bool stereo)
+{
+	AudioFrame frame_with_gain = {};
+	if (stereo) {
+		frame_with_gain = {prev_frame[channel_map.left],
+		                   prev_frame[channel_map.right]};
+	} else {
+		frame_with_gain = {prev_frame[channel_map.left]};
+	}
+	frame_with_gain *= combined_volume_gain;
+
+	// Process initial samples through an expanding envelope to
+	// prevent severe clicks and pops. Skipped once it's done.
+	if (envelope.IsActive()) {
+		envelope.Process(stereo, frame_with_gain);
+	}
+
+	AudioFrame out_frame = {};
+	out_frame[output_map.left] += frame_with_gain.left;
+	out_frame[output_map.right] += frame_with_gain.right;
+
+	return out_frame;
+}
+
 // Converts sample stream to floats, performs output channel mappings, removes
 // clicks, and optionally performs zero-order-hold-upsampling.
 template <class Type, bool stereo, bool signeddata, bool nativeorder>
@@ -1872,12 +2127,6 @@ void MixerChannel::ConvertSamplesAndMaybeZohUpsample(const Type* data,
 	assert(num_frames > 0);
 	convert_buffer.clear();
 
-	const auto mapped_output_left  = output_map.left;
-	const auto mapped_output_right = output_map.right;
-
-	const auto mapped_channel_left  = channel_map.left;
-	const auto mapped_channel_right = channel_map.right;
-
 	auto pos = 0;
 
 	while (pos < num_frames) {
@@ -1898,24 +2147,7 @@ void MixerChannel::ConvertSamplesAndMaybeZohUpsample(const Type* data,
 			        data, pos);
 		}
 
-		AudioFrame frame_with_gain = {};
-		if (stereo) {
-			frame_with_gain = {prev_frame[mapped_channel_left],
-			                   prev_frame[mapped_channel_right]};
-		} else {
-			frame_with_gain = {prev_frame[mapped_channel_left]};
-		}
-		frame_with_gain *= combined_volume_gain;
-
-		// Process initial samples through an expanding envelope to
-		// prevent severe clicks and pops. Becomes a no-op when done.
-		envelope.Process(stereo, frame_with_gain);
-
-		AudioFrame out_frame = {};
-		out_frame[mapped_output_left] += frame_with_gain.left;
-		out_frame[mapped_output_right] += frame_with_gain.right;
-
-		convert_buffer.push_back(out_frame);
+		convert_buffer.push_back(MapPrevFrame(stereo));
 
 		if (do_zoh_upsample) {
 			zoh_upsampler.pos += zoh_upsampler.step;
@@ -1943,16 +2175,34 @@ static spx_uint32_t estimate_max_out_frames(SpeexResamplerState* resampler_state
 	return ceil_udivide(in_frames * ratio_den, ratio_num);
 }
 
-AudioFrame MixerChannel::ApplyCrossfeed(const AudioFrame frame)
+void MixerChannel::ApplyCrossfeed(std::span<AudioFrame> frames)
 {
 	// Pan mono sample using -6dB linear pan law in the stereo field
 	// pan: 0.0 = left, 0.5 = center, 1.0 = right
-	auto pan = [](const float sample, const float pan) -> AudioFrame {
-		return {(1.0f - pan) * sample, pan * sample};
-	};
-	const auto a = pan(frame.left, crossfeed.pan_left);
-	const auto b = pan(frame.right, crossfeed.pan_right);
-	return {a.left + b.left, a.right + b.right};
+	const auto left_to_left   = 1.0f - crossfeed.pan_left;
+	const auto left_to_right  = crossfeed.pan_left;
+	const auto right_to_left  = 1.0f - crossfeed.pan_right;
+	const auto right_to_right = crossfeed.pan_right;
+
+	for (auto& frame : frames) {
+		frame = {left_to_left * frame.left + right_to_left * frame.right,
+		         left_to_right * frame.left + right_to_right * frame.right};
+	}
+}
+
+// Runs a stereo pair of IIR filters over a block of frames. Each channel is
+// filtered in its own pass, so the state of the biquad cascade stays in
+// registers instead of being reloaded for every sample.
+template <class Filter>
+static void filter_frames(std::array<Filter, 2>& filters,
+                          std::span<AudioFrame> frames)
+{
+	for (auto& frame : frames) {
+		frame.left = filters[0].filter(frame.left);
+	}
+	for (auto& frame : frames) {
+		frame.right = filters[1].filter(frame.right);
+	}
 }
 
 // Returns true if configuration succeeded and false otherwise
@@ -2070,6 +2320,12 @@ AudioFrame MixerChannel::Sleeper::MaybeFadeOrListen(const AudioFrame& frame)
 
 void MixerChannel::Sleeper::MaybeSleep()
 {
+	// Pick up the wake-up requests made while mixing the last block
+	if (wants_wakeup.exchange(false)) {
+		WakeUp();
+		return;
+	}
+
 	// A signed integer can a durration of ~24 days in milliseconds, which
 	// is surely more than enough.
 	const auto awake_for_ms = check_cast<int>(GetTicksSince(woken_at_ms));
@@ -2092,6 +2348,12 @@ void MixerChannel::Sleeper::MaybeSleep()
 	if (channel.is_enabled) {
 		channel.Enable(false);
 		// LOG_INFO("MIXER: %s fell asleep", channel.name.c_str());
+
+		// A device might have requested a wake-up just before we
+		// disabled the channel, after it checked that it's awake
+		if (wants_wakeup.exchange(false)) {
+			WakeUp();
+		}
 	}
 }
 
@@ -2111,12 +2373,28 @@ bool MixerChannel::Sleeper::WakeUp()
 	return was_sleeping;
 }
 
+bool MixerChannel::Sleeper::RequestWakeUp()
+{
+	// Both this and MaybeSleep() store their flag before checking the
+	// other's, so at least one of them notices a concurrent request
+	wants_wakeup = true;
+	return channel.is_enabled;
+}
+
 // Audio devices that use the sleep feature need to wake up the channel whenever
 // they might prepare new samples for it. Typically this is on IO port
 // writes into the card.
 bool MixerChannel::WakeUp()
 {
 	assert(do_sleep);
+
+	// Most calls come from port writes to a channel that's already awake,
+	// so we defer resetting its sleep timer to the mixer thread instead of
+	// contending for the channel lock.
+	if (is_enabled && sleeper.RequestWakeUp()) {
+		return false;
+	}
+
 	std::lock_guard lock(mutex);
 	return sleeper.WakeUp();
 }
@@ -2132,8 +2410,29 @@ void MixerChannel::AddSamples(const int num_frames, const Type* data)
 
 	std::lock_guard lock(mutex);
 
+	PrepareToAddFrames(stereo);
+
+	ConvertSamplesAndMaybeZohUpsample<Type, stereo, signeddata, nativeorder>(
+	        data, num_frames);
+
+	ProcessConvertedFrames();
+}
+
+void MixerChannel::PrepareToAddFrames(const bool stereo)
+{
+	// Frames added to a disabled channel are still played out, so make
+	// sure the mixer visits it
+	if (!is_enabled) {
+		mixer.active_channels_changed = true;
+	}
+
 	last_samples_were_stereo = stereo;
+}
 
+// Resamples the frames in the conversion buffer and appends them to the
+// channel's audio frames
+void MixerChannel::ProcessConvertedFrames()
+{
 	// All possible resampling scenarios:
 	//
 	// - No upsampling or resampling
@@ -2141,25 +2440,26 @@ void MixerChannel::AddSamples(const int num_frames, const Type* data)
 	// - ZoH   upsampling only
 	// - Speex resampling only
 	// - ZoH upsampling followed by Speex resampling
+	// - Polyphase resampling only
 
 	// Zero-order-hold upsampling is performed in
 	// ConvertSamplesAndMaybeZohUpsample to reduce the number of temporary
 	// buffers and to simplify the code.
 	//
 
-	// Assert that we're not attempting to do both LERP and Speex resample
-	// We can do one or neither
-	assert((do_lerp_upsample && !do_resample) ||
-	       (!do_lerp_upsample && do_resample) ||
-	       (!do_lerp_upsample && !do_resample));
-
-	ConvertSamplesAndMaybeZohUpsample<Type, stereo, signeddata, nativeorder>(
-	        data, num_frames);
+	// Assert that we're not attempting to do more than one of LERP,
+	// Speex, and polyphase resampling. We can do one or neither.
+	assert(do_lerp_upsample + do_resample + do_polyphase_resample <= 1);
 
 	// Starting index this function will start writing to
 	// The audio_frames vector can contain previously converted/resampled audio
 	const size_t audio_frames_starting_size = audio_frames.size();
 
+	const auto is_resampling = (do_lerp_upsample || do_resample ||
+	                            do_polyphase_resample);
+
+	const auto resample_start_us = is_resampling ? GetTicksUs() : 0;
+
 	if (do_lerp_upsample) {
 		assert(!do_resample);
 
@@ -2234,36 +2534,40 @@ void MixerChannel::AddSamples(const int num_frames, const Type* data)
 		// is within the logical size.
 		assert(out_frames <= estimated_frames);
 		audio_frames.resize(audio_frames_starting_size + out_frames); // only shrinks
+	} else if (do_polyphase_resample) {
+		polyphase_resampler.Process(convert_buffer.data(),
+		                            convert_buffer.size(),
+		                            audio_frames);
 	} else {
 		audio_frames.insert(audio_frames.end(),
 		                    convert_buffer.begin(),
 		                    convert_buffer.end());
 	}
 
-	// Optionally gate, filter, and apply crossfeed.
-	// Runs in-place over newly added frames.
-	for (size_t i = audio_frames_starting_size; i < audio_frames.size(); ++i) {
-		if (do_noise_gate) {
-			audio_frames[i] = noise_gate.processor.Process(
-			        audio_frames[i]);
-		}
-
-		if (filters.highpass.state == FilterState::On) {
-			auto& hpf = filters.highpass.hpf;
-
-			audio_frames[i] = {hpf[0].filter(audio_frames[i].left),
-			                   hpf[1].filter(audio_frames[i].right)};
-		}
-		if (filters.lowpass.state == FilterState::On) {
-			auto& lpf = filters.lowpass.lpf;
+	if (is_resampling) {
+		stats.resample_us += GetTicksUsSince(resample_start_us);
+	}
 
-			audio_frames[i] = {lpf[0].filter(audio_frames[i].left),
-			                   lpf[1].filter(audio_frames[i].right)};
-		}
+	// Optionally gate, filter, and apply crossfeed. Each stage runs
+	// in-place over the whole block of newly added frames; disabled stages
+	// don't touch the frames at all.
+	const auto new_frames = std::span(audio_frames).subspan(
+	        audio_frames_starting_size);
 
-		if (do_crossfeed) {
-			audio_frames[i] = ApplyCrossfeed(audio_frames[i]);
-		}
+	if (new_frames.empty()) {
+		return;
+	}
+	if (do_noise_gate) {
+		noise_gate.processor.Process(new_frames);
+	}
+	if (filters.highpass.state == FilterState::On) {
+		filter_frames(filters.highpass.hpf, new_frames);
+	}
+	if (filters.lowpass.state == FilterState::On) {
+		filter_frames(filters.lowpass.lpf, new_frames);
+	}
+	if (do_crossfeed) {
+		ApplyCrossfeed(new_frames);
 	}
 }
 
@@ -2302,7 +2606,7 @@ void MixerChannel::AddSamples_s16_nonnative(const int num_frames, const int16_t*
 	AddSamples<int16_t, true, true, false>(num_frames, data);
 }
 
-void MixerChannel::AddAudioFrames(const std::vector<AudioFrame>& frames)
+void MixerChannel::AddAudioFrames(std::span<const AudioFrame> frames)
 {
 	constexpr bool IsStereo = true;
 	constexpr bool IsSigned = true;
@@ -2316,6 +2620,42 @@ void MixerChannel::AddAudioFrames(const std::vector<AudioFrame>& frames)
 	}
 }
 
+void MixerChannel::RenderAudioFrames(const int num_frames,
+                                     const RenderFramesFunction& render)
+{
+	if (num_frames <= 0) {
+		return;
+	}
+
+	std::lock_guard lock(mutex);
+
+	// Zero-order-hold upsampling repeats frames while converting them, so
+	// it needs the rendered frames in a buffer of their own
+	if (do_zoh_upsample) {
+		render_buffer.resize(check_cast<size_t>(num_frames));
+		render(render_buffer);
+		AddAudioFrames(render_buffer);
+		return;
+	}
+
+	constexpr bool IsStereo = true;
+	PrepareToAddFrames(IsStereo);
+
+	// Keeps its capacity, so this doesn't allocate once warmed up
+	convert_buffer.resize(check_cast<size_t>(num_frames));
+	render(convert_buffer);
+
+	// Map the rendered frames in-place, with the same one frame delay as
+	// the conversion of sample streams
+	for (auto& frame : convert_buffer) {
+		prev_frame = next_frame;
+		next_frame = frame;
+		frame      = MapPrevFrame(IsStereo);
+	}
+
+	ProcessConvertedFrames();
+}
+
 std::string MixerChannel::DescribeLineout()
 {
 	std::lock_guard lock(mutex);
@@ -2385,16 +2725,87 @@ MixerChannel::~MixerChannel()
 // It might be better for us to use normalized floats elsewhere in the future.
 // For now, that probably breaks some assumptions elsewhere in the mixer.
 // So just normalize as a final step before sending the data to SDL.
-static float normalize_sample(float sample)
+//
+// Multiplying by the reciprocal of a power of two is exact, so this gives the
+// same results as dividing by 32768.
+constexpr AudioFrame NormalizeGain = AudioFrame(1.0f / 32768.0f);
+
+// Apply the reverb effect to the reverb aux buffer, then mix the results to
+// the master output.
+static void apply_reverb()
+{
+	// MVerb operates on two non-interleaved sample streams. We feed it in
+	// blocks so its per-call setup and parameter smoothing is amortised
+	// over many frames.
+	constexpr size_t BlockFrames = 128;
+
+	std::array<float, BlockFrames> in_left   = {};
+	std::array<float, BlockFrames> in_right  = {};
+	std::array<float, BlockFrames> out_left  = {};
+	std::array<float, BlockFrames> out_right = {};
+
+	float* in_buf[2]  = {in_left.data(), in_right.data()};
+	float* out_buf[2] = {out_left.data(), out_right.data()};
+
+	auto& aux = mixer.reverb_aux_buffer;
+	auto& hpf = mixer.reverb.highpass_filter;
+
+	for (size_t start = 0; start < aux.size(); start += BlockFrames) {
+		const auto num_frames = std::min(BlockFrames, aux.size() - start);
+
+		// High-pass filter the reverb input while de-interleaving it
+		for (size_t i = 0; i < num_frames; ++i) {
+			in_left[i]  = hpf[0].filter(aux[start + i].left);
+			in_right[i] = hpf[1].filter(aux[start + i].right);
+		}
+
+		mixer.reverb.mverb.process(in_buf, out_buf, check_cast<int>(num_frames));
+
+		// Re-interleave the wet signal in place
+		for (size_t i = 0; i < num_frames; ++i) {
+			aux[start + i] = {out_left[i], out_right[i]};
+		}
+	}
+
+	add_frames(mixer.output_buffer.data(), aux.data(), aux.size());
+}
+
+// Apply the chorus effect to the chorus aux buffer, then mix the results to
+// the master output.
+static void apply_chorus()
 {
-	return sample / 32768.0f;
+	auto& aux = mixer.chorus_aux_buffer;
+
+	mixer.chorus.chorus_engine.process(&aux.data()->left,
+	                                   check_cast<int>(aux.size()));
+
+	add_frames(mixer.output_buffer.data(), aux.data(), aux.size());
+}
+
+// Collects the channels to mix from the now awake ones, plus those that have
+// had frames added while disabled, so those are still played out.
+static void update_active_channels()
+{
+	mixer.active_channels.clear();
+
+	for (const auto& [_, channel] : mixer.channels) {
+		std::lock_guard lock(channel->mutex);
+
+		if (channel->is_enabled || !channel->audio_frames.empty()) {
+			mixer.active_channels.push_back(channel.get());
+		}
+	}
 }
 
 // Mix a certain amount of new sample frames
 static void mix_samples(const int frames_requested)
 {
+	TRACE_SCOPE("Mix samples");
+
 	assert(frames_requested > 0);
 
+	const auto start_us = GetTicksUs();
+
 	mixer.output_buffer.clear();
 	mixer.output_buffer.resize(frames_requested);
 
@@ -2404,32 +2815,60 @@ static void mix_samples(const int frames_requested)
 	mixer.chorus_aux_buffer.clear();
 	mixer.chorus_aux_buffer.resize(frames_requested);
 
-	// Render all channels and accumulate results in the master mixbuffer
-	for (const auto& [_, channel] : mixer.channels) {
-		channel->Mix(frames_requested);
+	if (mixer.active_channels_changed.exchange(false)) {
+		update_active_channels();
+	}
+
+	// Render all awake channels, either concurrently or one by one
+	if (mixer.render_pool.IsRunning() && mixer.active_channels.size() > 1) {
+		mixer.render_pool.Render(mixer.active_channels, frames_requested);
+	} else {
+		for (const auto channel : mixer.active_channels) {
+			channel->Mix(frames_requested);
+		}
+	}
+
+	// The channels are still pulled to keep their queues moving, but
+	// there's nothing to mix if the output is muted
+	const auto is_muted = MIXER_IsFastForwardAudioMuted();
 
+	// Accumulate the results in the master mixbuffer
+	for (const auto channel : mixer.active_channels) {
 		std::lock_guard lock(channel->mutex);
 
 		const size_t num_frames = std::min(mixer.output_buffer.size(),
 		                                   channel->audio_frames.size());
 
-		for (size_t i = 0; i < num_frames; ++i) {
-			if (channel->do_sleep) {
+		if (is_muted) {
+			channel->audio_frames.erase(channel->audio_frames.begin(),
+			                            channel->audio_frames.begin() +
+			                                    num_frames);
+			continue;
+		}
+
+		const auto channel_frames = channel->audio_frames.data();
+
+		if (channel->do_sleep) {
+			for (size_t i = 0; i < num_frames; ++i) {
 				mixer.output_buffer[i] += channel->sleeper.MaybeFadeOrListen(
-				        channel->audio_frames[i]);
-			} else {
-				mixer.output_buffer[i] += channel->audio_frames[i];
+				        channel_frames[i]);
 			}
+		} else {
+			add_frames(mixer.output_buffer.data(), channel_frames, num_frames);
+		}
 
-			if (mixer.do_reverb && channel->do_reverb_send) {
-				mixer.reverb_aux_buffer[i] += channel->audio_frames[i] *
-				                              channel->reverb.send_gain;
-			}
+		if (mixer.do_reverb && channel->do_reverb_send) {
+			add_frames_scaled(mixer.reverb_aux_buffer.data(),
+			                  channel_frames,
+			                  channel->reverb.send_gain,
+			                  num_frames);
+		}
 
-			if (mixer.do_chorus && channel->do_chorus_send) {
-				mixer.chorus_aux_buffer[i] += channel->audio_frames[i] *
-				                              channel->chorus.send_gain;
-			}
+		if (mixer.do_chorus && channel->do_chorus_send) {
+			add_frames_scaled(mixer.chorus_aux_buffer.data(),
+			                  channel_frames,
+			                  channel->chorus.send_gain,
+			                  num_frames);
 		}
 
 		channel->audio_frames.erase(channel->audio_frames.begin(),
@@ -2440,40 +2879,19 @@ static void mix_samples(const int frames_requested)
 		}
 	}
 
-	if (mixer.do_reverb) {
-		// Apply reverb effect to the reverb aux buffer, then mix the
-		// results to the master output.
-		//
-		for (size_t i = 0; i < mixer.reverb_aux_buffer.size(); ++i) {
-			// High-pass filter the reverb input
-			auto& hpf = mixer.reverb.highpass_filter;
-
-			// MVerb operates on two non-interleaved sample streams
-			AudioFrame in_frame = mixer.reverb_aux_buffer[i];
-			in_frame.left       = hpf[0].filter(in_frame.left);
-			in_frame.right      = hpf[1].filter(in_frame.right);
-
-			float* in_buf[2] = {&in_frame.left, &in_frame.right};
-
-			AudioFrame out_frame = {};
-			float* out_buf[2] = {&out_frame.left, &out_frame.right};
-
-			constexpr auto NumFrames = 1;
-			mixer.reverb.mverb.process(in_buf, out_buf, NumFrames);
+	// The output buffer is left silent
+	if (is_muted) {
+		++mixer.stats.num_blocks;
+		mixer.stats.mix_us += GetTicksUsSince(start_us);
+		return;
+	}
 
-			mixer.output_buffer[i] += out_frame;
-		}
+	if (mixer.do_reverb) {
+		apply_reverb();
 	}
 
 	if (mixer.do_chorus) {
-		// Apply chorus effect to the chorus aux buffer, then mix the
-		// results to the master output.
-		//
-		for (size_t i = 0; i < mixer.chorus_aux_buffer.size(); ++i) {
-			auto frame = mixer.chorus_aux_buffer[i];
-			mixer.chorus.chorus_engine.process(&frame.left, &frame.right);
-			mixer.output_buffer[i] += frame;
-		}
+		apply_chorus();
 	}
 
 	// Apply high-pass filter to the master output
@@ -2484,9 +2902,7 @@ static void mix_samples(const int frames_requested)
 
 	// Apply master gain
 	const auto gain = mixer.master_gain.load(std::memory_order_relaxed);
-	for (auto& frame : mixer.output_buffer) {
-		frame *= gain;
-	}
+	scale_frames(mixer.output_buffer.data(), gain, mixer.output_buffer.size());
 
 	if (mixer.do_compressor) {
 		// Apply compressor to the master output as the very last step
@@ -2497,22 +2913,18 @@ static void mix_samples(const int frames_requested)
 
 	// Capture audio output if requested
 	if (CAPTURE_IsCapturingAudio() || CAPTURE_IsCapturingVideo()) {
-		mixer.capture_buffer.clear();
-		mixer.capture_buffer.reserve(mixer.output_buffer.size() * 2);
-
-		for (const auto frame : mixer.output_buffer) {
-			const auto left = static_cast<uint16_t>(
-			        clamp_to_int16(static_cast<int>(frame.left)));
+		mixer.capture_buffer.resize(mixer.output_buffer.size() * 2);
 
-			const auto right = static_cast<uint16_t>(
-			        clamp_to_int16(static_cast<int>(frame.right)));
+		frames_to_int16(mixer.output_buffer.data(),
+		                mixer.capture_buffer.data(),
+		                mixer.output_buffer.size());
 
-			mixer.capture_buffer.push_back(
-			        static_cast<int16_t>(host_to_le16(left)));
-
-			mixer.capture_buffer.push_back(
-			        static_cast<int16_t>(host_to_le16(right)));
+#ifdef WORDS_BIGENDIAN
+		for (auto& sample : mixer.capture_buffer) {
+			sample = static_cast<int16_t>(
+			        host_to_le16(static_cast<uint16_t>(sample)));
 		}
+#endif
 
 		if (mixer.capture_queue.Size() + mixer.capture_buffer.size() >
 		    mixer.capture_queue.MaxCapacity()) {
@@ -2526,14 +2938,27 @@ static void mix_samples(const int frames_requested)
 			// it's the lesser of two evils.
 			//
 			mixer.capture_queue.Clear();
+			++mixer.stats.capture_overruns;
 		}
 		mixer.capture_queue.NonblockingBulkEnqueue(mixer.capture_buffer);
 	}
 
 	// Normalize the final output before sending to SDL
-	for (auto& frame : mixer.output_buffer) {
-		frame.left  = normalize_sample(frame.left);
-		frame.right = normalize_sample(frame.right);
+	scale_frames(mixer.output_buffer.data(),
+	             NormalizeGain,
+	             mixer.output_buffer.size());
+
+	SHM_OUTPUT_AddAudio(mixer.output_buffer.data(),
+	                    check_cast<int>(mixer.output_buffer.size()),
+	                    mixer.sample_rate_hz);
+
+	// Only the mixer thread updates these
+	const auto elapsed_us = GetTicksUsSince(start_us);
+
+	++mixer.stats.num_blocks;
+	mixer.stats.mix_us += elapsed_us;
+	if (elapsed_us > mixer.stats.max_mix_us) {
+		mixer.stats.max_mix_us = elapsed_us;
 	}
 }
 
@@ -2592,11 +3017,25 @@ static void SDLCALL mixer_callback([[maybe_unused]] void* userdata,
 	const auto frames_to_dequeue = std::min(mixer.final_output.Size(),
 	                                        frames_requested);
 
+	static auto& queue_fill = METRICS_Gauge(
+	        "dosbox_audio_output_queue_percent_full",
+	        "Fill level of the audio output queue when the device last pulled from it");
+
+	queue_fill.Set(static_cast<double>(mixer.final_output.GetPercentFull()));
+
 	const auto frame_stream = reinterpret_cast<AudioFrame*>(stream);
 
 	const auto frames_received = mixer.final_output.BulkDequeue(frame_stream,
 	                                                            frames_to_dequeue);
 	// Satisfy any shortfall with silence
+	if (frames_received < frames_requested) {
+		++mixer.stats.output_underruns;
+
+		static auto& underruns = METRICS_Counter(
+		        "dosbox_audio_output_underruns_total",
+		        "Audio device callbacks padded with silence");
+		underruns.Add();
+	}
 	std::fill(frame_stream + frames_received,
 	          frame_stream + frames_requested,
 	          AudioFrame{});
@@ -2604,6 +3043,8 @@ static void SDLCALL mixer_callback([[maybe_unused]] void* userdata,
 
 static void mixer_thread_loop()
 {
+	TRACE_THREAD_NAME("Mixer");
+
 	double last_mixed = 0.0;
 	while (!mixer.thread_should_quit) {
 		std::unique_lock lock(mixer.mutex);
@@ -2729,6 +3170,32 @@ static void set_mixer_state(const MixerState new_state)
 	mixer.state = new_state;
 }
 
+// Only call from the main thread; the channels are only added and removed
+// there.
+MixerStats MIXER_GetStats()
+{
+	MixerStats s = {};
+
+	s.sample_rate_hz = mixer.sample_rate_hz;
+	s.blocksize      = mixer.blocksize;
+	s.prebuffer_ms   = mixer.prebuffer_ms;
+
+	s.output_queue_percent_full = mixer.final_output.GetPercentFull();
+
+	s.output_underruns = mixer.stats.output_underruns;
+	s.capture_overruns = mixer.stats.capture_overruns;
+
+	s.num_blocks = mixer.stats.num_blocks;
+	s.mix_us     = mixer.stats.mix_us;
+	s.max_mix_us = mixer.stats.max_mix_us;
+
+	for (const auto& [_, channel] : mixer.channels) {
+		s.channels.push_back(channel->GetStats());
+	}
+
+	return s;
+}
+
 void MIXER_CloseAudioDevice()
 {
 	TIMER_DelTickHandler(capture_callback);
@@ -2739,6 +3206,8 @@ void MIXER_CloseAudioDevice()
 		mixer.thread.join();
 	}
 
+	mixer.render_pool.Stop();
+
 	for (const auto& [_, channel] : mixer.channels) {
 		channel->Enable(false);
 	}
@@ -2949,6 +3418,19 @@ void MIXER_Init()
 	// One second of audio
 	mixer.capture_queue.Resize(mixer.sample_rate_hz * 2);
 
+	if (section->GetBool("parallel_mixing")) {
+		// The mixer thread renders channels too
+		const auto num_workers = std::min(
+		        static_cast<int>(std::thread::hardware_concurrency()) - 1,
+		        MaxMixerWorkers);
+
+		if (num_workers > 0) {
+			mixer.render_pool.Start(num_workers);
+			LOG_MSG("MIXER: Rendering channels on %d threads",
+			        num_workers + 1);
+		}
+	}
+
 	mixer.thread = std::thread(mixer_thread_loop);
 	set_thread_name(mixer.thread, "dosbox:mixer");
 
@@ -2971,6 +3453,8 @@ void MIXER_Init()
 	// Init per-channel denoisers
 	init_denoiser(section->GetBool("denoiser"));
 
+	mixer.fast_forward_audio = section->GetBool("fast_forward_audio");
+
 	// Initialise master compressor
 	init_compressor(section->GetBool("compressor"));
 
@@ -3015,6 +3499,9 @@ static void notify_mixer_setting_updated(SectionProp& section,
 	} else if (prop_name == "denoiser") {
 		init_denoiser(section.GetBool("denoiser"));
 
+	} else if (prop_name == "fast_forward_audio") {
+		mixer.fast_forward_audio = section.GetBool("fast_forward_audio");
+
 	} else if (prop_name == "reverb") {
 		const auto new_reverb_preset = reverb_pref_to_preset(
 		        section.GetString("reverb"));
@@ -3222,6 +3709,21 @@ static void init_mixer_config_settings(SectionProp& sec_prop)
 	        "  - Use the MIXER command to fine-tune the chorus levels per channel.");
 	string_prop->SetValues({"off", "on", "light", "normal", "strong"});
 
+	bool_prop = sec_prop.AddBool("parallel_mixing", OnlyAtStart, false);
+	bool_prop->SetHelp(
+	        "Render the audio channels on multiple CPU cores ('off' by default). This can\n"
+	        "help on multi-core hosts when several demanding synths are active at the same\n"
+	        "time (e.g., OPL, GUS, and an IMFC). The mixed output is identical to rendering\n"
+	        "the channels one after the other.");
+
+	bool_prop = sec_prop.AddBool("fast_forward_audio", WhenIdle, true);
+	bool_prop->SetHelp(
+	        "Play the sped up audio while fast-forwarding ('on' by default). When 'off', the\n"
+	        "audio is muted while fast-forwarding, the master effects are bypassed, and the\n"
+	        "MT-32 and FluidSynth emulations stop synthesising audio (the MIDI messages are\n"
+	        "still applied), so they don't hold back the emulation. Audio is never muted\n"
+	        "while capturing audio or video.");
+
 	bool_prop = sec_prop.AddBool("denoiser", WhenIdle, DefaultOn);
 	bool_prop->SetHelp(
 	        "Remove low-level residual noise from the output of the OPL synth and the Roland\n"
@@ -14,6 +14,7 @@
 #include <memory>
 #include <mutex>
 #include <set>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -22,6 +23,7 @@
 
 #include "private/envelope.h"
 #include "private/noise_gate.h"
+#include "private/polyphase_resampler.h"
 
 #include "audio/audio_frame.h"
 #include "config/config.h"
@@ -137,7 +139,68 @@ enum class ResampleMethod {
 	// This is mathematically correct, high-quality resampling that cuts all
 	// frequencies below the Nyquist frequency using a brickwall filter
 	// (everything below half the channel's sample rate is cut).
-	Resample
+	Resample,
+
+	// Resample from the channel sample rate to the mixer rate with the
+	// built-in polyphase resampler. The quality is comparable to Speex,
+	// and its stereo SIMD kernels suit channels running at odd or very
+	// high rates (e.g., the PC speaker and CMS).
+	PolyphaseResample
+};
+
+// Performance counters of a mixer channel; see MIXER_GetStats()
+struct MixerChannelStats {
+	std::string name   = {};
+	int sample_rate_hz = 0;
+
+	// Fill level of the channel's input queue when the mixer last pulled
+	// audio from it, or a negative value if the channel isn't fed through
+	// a queue
+	float queue_percent_full = -1.0f;
+
+	// Audio the channel had rendered ahead of the mixer when it last
+	// reported it, or a negative value if it doesn't report its latency
+	float latency_ms = -1.0f;
+
+	// Number of times the channel couldn't provide all the frames the
+	// mixer requested, and had to pad the shortfall with silence
+	int64_t underruns = 0;
+
+	// Total time spent rendering the channel (including the time spent in
+	// its handler), and the part of that spent upsampling or resampling
+	int64_t mix_us      = 0;
+	int64_t resample_us = 0;
+
+	// Total duration of the audio mixed while the channel was awake; it
+	// falls behind the mixer's while the channel sleeps or is disabled
+	int64_t awake_ms = 0;
+};
+
+// Performance counters of the mixer as a whole, useful for tuning the
+// 'blocksize' and 'prebuffer' settings
+struct MixerStats {
+	int sample_rate_hz = 0;
+	int blocksize      = 0;
+	int prebuffer_ms   = 0;
+
+	// Fill level of the queue between the mixer thread and the audio
+	// device
+	float output_queue_percent_full = 0.0f;
+
+	// Number of audio device callbacks that found the output queue short
+	// and had to play silence instead
+	int64_t output_underruns = 0;
+
+	// Number of times the capture queue overflowed and had to be cleared
+	int64_t capture_overruns = 0;
+
+	// Number of mixer blocks rendered, and the total and maximum time
+	// spent rendering a single block
+	int64_t num_blocks = 0;
+	int64_t mix_us     = 0;
+	int64_t max_mix_us = 0;
+
+	std::vector<MixerChannelStats> channels = {};
 };
 
 enum class CrossfeedPreset { None, Light, Normal, Strong };
@@ -237,7 +300,23 @@ public:
 	void SetChorusLevel(const float level);
 	float GetChorusLevel();
 
-	void AddAudioFrames(const std::vector<AudioFrame>& frames);
+	void AddAudioFrames(std::span<const AudioFrame> frames);
+
+	// Lets a device render a block of stereo frames straight into the
+	// channel's conversion buffer, saving the copy from a device-side
+	// buffer. The frames passed to the function are not cleared; it must
+	// write every one of them.
+	using RenderFramesFunction = std::function<void(std::span<AudioFrame> frames)>;
+	void RenderAudioFrames(const int num_frames, const RenderFramesFunction& render);
+
+	MixerChannelStats GetStats();
+
+	// Called by channels fed through a queue before pulling audio from it
+	void RecordQueueFill(const float percent_full);
+	void RecordUnderrun();
+
+	// Called by channels that render ahead of the mixer
+	void RecordLatency(const float latency_ms);
 
 	template <class Type, bool stereo, bool signeddata, bool nativeorder>
 	void AddSamples(const int num_frames, const Type* data);
@@ -281,6 +360,12 @@ public:
 		void MaybeSleep();
 		bool WakeUp();
 
+		// Resets the sleep timer of an awake channel after the mixer
+		// thread mixes the current block, without taking any locks.
+		// Returns false if the channel fell asleep in the meantime and
+		// needs a regular WakeUp() instead.
+		bool RequestWakeUp();
+
 	private:
 		void DecrementFadeLevel(const int awake_for_ms);
 
@@ -299,6 +384,8 @@ public:
 
 		bool wants_fadeout = false;
 		bool had_signal    = false;
+
+		std::atomic<bool> wants_wakeup = false;
 	};
 
 	Sleeper sleeper;
@@ -315,6 +402,11 @@ private:
 	template <class Type, bool stereo, bool signeddata, bool nativeorder>
 	void ConvertSamplesAndMaybeZohUpsample(const Type* data, const int frames);
 
+	AudioFrame MapPrevFrame(const bool stereo);
+
+	void PrepareToAddFrames(const bool stereo);
+	void ProcessConvertedFrames();
+
 	void InitNoiseGate();
 
 	void InitHighPassFilter();
@@ -325,7 +417,7 @@ private:
 	void InitZohUpsamplerState();
 	void InitLerpUpsamplerState();
 
-	AudioFrame ApplyCrossfeed(const AudioFrame frame);
+	void ApplyCrossfeed(std::span<AudioFrame> frames);
 
 	std::string name = {};
 	Envelope envelope;
@@ -333,6 +425,9 @@ private:
 
 	std::vector<AudioFrame> convert_buffer = {};
 
+	// Rendered frames waiting for zero-order-hold upsampling
+	std::vector<AudioFrame> render_buffer = {};
+
 	std::set<ChannelFeature> features = {};
 
 	// Timing on how many samples were needed by the mixer
@@ -397,6 +492,8 @@ private:
 	bool do_zoh_upsample  = false;
 	bool do_resample      = false;
 
+	bool do_polyphase_resample = false;
+
 	struct {
 		float pos             = 0.0f;
 		float step            = 0.0f;
@@ -413,6 +510,8 @@ private:
 		SpeexResamplerState* state = nullptr;
 	} speex_resampler = {};
 
+	PolyphaseResampler polyphase_resampler = {};
+
 	struct {
 		NoiseGate processor;
 
@@ -444,6 +543,16 @@ private:
 		float pan_right = 0.0f;
 	} crossfeed       = {};
 	bool do_crossfeed = false;
+
+	// Performance counters, updated from both the mixer and main threads
+	struct {
+		std::atomic<float> queue_percent_full = -1.0f;
+		std::atomic<float> latency_ms         = -1.0f;
+		std::atomic<int64_t> underruns        = 0;
+		std::atomic<int64_t> mix_us           = 0;
+		std::atomic<int64_t> resample_us      = 0;
+		std::atomic<int64_t> awake_frames     = 0;
+	} stats = {};
 };
 
 using MixerChannelPtr = std::shared_ptr<MixerChannel>;
@@ -469,6 +578,10 @@ void MIXER_EnableFastForwardMode();
 void MIXER_DisableFastForwardMode();
 bool MIXER_FastForwardModeEnabled();
 
+// True while fast-forwarding with the 'fast_forward_audio' setting off; the
+// synths may skip rendering their audio then
+bool MIXER_IsFastForwardAudioMuted();
+
 const AudioFrame MIXER_GetMasterVolume();
 void MIXER_SetMasterVolume(const AudioFrame gain);
 
@@ -479,6 +592,8 @@ void MIXER_LockMixerThread();
 void MIXER_UnlockMixerThread();
 void MIXER_CloseAudioDevice();
 
+MixerStats MIXER_GetStats();
+
 // Return true if the mixer was explicitly muted by the user (as opposed to
 // auto-muted when `mute_when_inactive` is enabled).
 bool MIXER_IsManuallyMuted();
@@ -533,6 +648,8 @@ inline void MIXER_PullFromQueueCallback(const int frames_requested, DeviceType*
 		device->output_queue.Resize(
 		        iceil(device->channel->GetFramesPerBlock() * 2.0f));
 	}
+	device->channel->RecordQueueFill(device->output_queue.GetPercentFull());
+
 	static std::vector<AudioType> to_mix = {};
 
 	const auto frames_received = check_cast<int>(
@@ -548,6 +665,7 @@ inline void MIXER_PullFromQueueCallback(const int frames_requested, DeviceType*
 	}
 	// Fill any shortfall with silence
 	if (frames_received < frames_requested) {
+		device->channel->RecordUnderrun();
 		device->channel->AddSilence();
 	}
 }
@@ -69,3 +69,33 @@ AudioFrame NoiseGate::Process(const AudioFrame in)
 
 	return {left * gain_scalar, right * gain_scalar};
 }
+
+void NoiseGate::Process(std::span<AudioFrame> frames)
+{
+	// Run the high-pass filter over one channel at a time, then the
+	// envelope follower over the filtered frames
+	for (auto& frame : frames) {
+		frame.left = highpass_filter[0].filter(frame.left * scale_in);
+	}
+	for (auto& frame : frames) {
+		frame.right = highpass_filter[1].filter(frame.right * scale_in);
+	}
+
+	for (auto& frame : frames) {
+		const auto is_open = std::abs(frame.left) > threshold_value ||
+		                     std::abs(frame.right) > threshold_value;
+
+		if (is_open) {
+			// attack phase
+			seek_v = seek_v * attack_coeff + (1 - attack_coeff);
+		} else {
+			// release phase
+			seek_v *= release_coeff;
+		}
+
+		const auto gain_scalar = seek_v * scale_out;
+
+		frame.left *= gain_scalar;
+		frame.right *= gain_scalar;
+	}
+}
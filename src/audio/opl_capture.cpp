@@ -6,11 +6,16 @@
 #include <memory>
 
 #include "capture/capture.h"
+#include "capture/private/write_behind_file.h"
 #include "utils/byteorder.h"
 #include "utils/checks.h"
 
 CHECK_NARROWING();
 
+// Even the busiest OPL music writes a few kB per second, so this covers very
+// long storage stalls
+static constexpr auto WriteBehindBufferSize = 1024 * 1024;
+
 enum { HwOpl2 = 0, HwDualOpl2 = 1, HwOpl3 = 2 };
 
 OplCapture::OplCapture(OplRegisterCache* _cache) : header(), cache(_cache)
@@ -101,6 +106,10 @@ skipWrite:
 	// Write the Raw To Reg table
 	fwrite(&to_reg, 1, raw_used, handle);
 
+	writer = std::make_unique<WriteBehindFile>(handle,
+	                                           WriteBehindBufferSize,
+	                                           "dosbox:oplcap");
+
 	// Write the cache of last commands
 	WriteCache();
 
@@ -188,8 +197,11 @@ void OplCapture::MakeTables()
 
 void OplCapture::ClearBuf()
 {
-	fwrite(buf, 1, bufUsed, handle);
-	header.commands += bufUsed / 2;
+	// Dropped commands are left out of the count, so the file stays
+	// playable, only missing some register writes
+	if (writer->Write(buf, bufUsed)) {
+		header.commands += bufUsed / 2;
+	}
 	bufUsed = 0;
 }
 
@@ -278,6 +290,15 @@ void OplCapture::CloseFile()
 {
 	if (handle) {
 		ClearBuf();
+		writer->Flush();
+
+		if (const auto num_bytes_dropped = writer->GetNumBytesDropped();
+		    num_bytes_dropped > 0) {
+			LOG_WARNING("CAPTURE: Storage was too slow; dropped %llu bytes "
+			            "of OPL commands from the captured DRO file",
+			            static_cast<unsigned long long>(num_bytes_dropped));
+		}
+		writer.reset();
 
 		// Endianise the header and write it to beginning of the
 		// file
@@ -6,9 +6,13 @@
 
 #include "dosbox.h"
 
+#include <memory>
+
 #include "hardware/audio/opl.h"
 #include "hardware/port.h"
 
+class WriteBehindFile;
+
 
 #ifdef _MSC_VER
 	#pragma pack(1)
@@ -84,9 +88,12 @@ private:
 
 	DroRawHeader header;
 
-	// File used for writing
+	// File used for writing; the commands are written from a background
+	// thread, and the header is updated directly when closing the file
 	FILE* handle = nullptr;
 
+	std::unique_ptr<WriteBehindFile> writer = {};
+
 	// Start used to check total raw length on end
 	uint32_t startTicks = 0;
 
@@ -0,0 +1,213 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "private/polyphase_resampler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+
+#include "misc/support.h"
+#include "simde/x86/sse2.h"
+#include "utils/checks.h"
+
+CHECK_NARROWING();
+
+// Filter length when upsampling; the same as Speex quality 4
+constexpr size_t BaseNumTaps = 64;
+
+// Upper bound for heavy downsampling (e.g., the 223 kHz CMS channel)
+constexpr size_t MaxNumTaps = 512;
+
+// Phases used when the reduced output rate would need more than this
+constexpr uint32_t MaxNumPhases = 256;
+
+// Passband as a fraction of the lower rate's Nyquist frequency
+constexpr double Cutoff = 0.91;
+
+// Gives around 80 dB of stopband attenuation
+constexpr double KaiserBeta = 8.0;
+
+// Zeroth-order modified Bessel function of the first kind
+static double bessel_i0(const double x)
+{
+	double sum  = 1.0;
+	double term = 1.0;
+
+	for (int k = 1; k < 50; ++k) {
+		const auto t = x / (2.0 * k);
+		term *= t * t;
+		sum += term;
+		if (term < sum * 1e-12) {
+			break;
+		}
+	}
+	return sum;
+}
+
+void PolyphaseResampler::Configure(const int _in_rate_hz, const int _out_rate_hz)
+{
+	assert(_in_rate_hz > 0);
+	assert(_out_rate_hz > 0);
+
+	if (_in_rate_hz != in_rate_hz || _out_rate_hz != out_rate_hz) {
+		in_rate_hz  = _in_rate_hz;
+		out_rate_hz = _out_rate_hz;
+
+		const auto divisor = std::gcd(in_rate_hz, out_rate_hz);
+
+		step  = check_cast<uint32_t>(in_rate_hz / divisor);
+		denom = check_cast<uint32_t>(out_rate_hz / divisor);
+
+		BuildFilterBank();
+	}
+	Reset();
+}
+
+void PolyphaseResampler::BuildFilterBank()
+{
+	const auto ratio = static_cast<double>(out_rate_hz) / in_rate_hz;
+
+	// Cut off below the lower of the two Nyquist frequencies, expressed in
+	// cycles per input frame
+	const auto cutoff = 0.5 * Cutoff * std::min(ratio, 1.0);
+
+	// Widen the filter when downsampling so the transition band stays
+	// equally narrow relative to the output rate. Keep an even number of
+	// taps so the frames pair up in the SIMD registers.
+	const auto scaled_taps = std::ceil(BaseNumTaps / std::min(ratio, 1.0));
+	num_taps = std::min(MaxNumTaps, static_cast<size_t>(scaled_taps));
+	num_taps += num_taps % 2;
+
+	num_phases = std::min(denom, MaxNumPhases);
+
+	const auto half_width = static_cast<double>(num_taps) / 2.0;
+	const auto center     = half_width - 1.0;
+	const auto i0_beta    = bessel_i0(KaiserBeta);
+
+	coeffs.resize((num_phases + 1) * num_taps * 2);
+
+	auto c = coeffs.begin();
+	for (uint32_t phase = 0; phase <= num_phases; ++phase) {
+		const auto frac = static_cast<double>(phase) / num_phases;
+
+		std::vector<double> taps(num_taps);
+		for (size_t i = 0; i < num_taps; ++i) {
+			// Distance of the tap's input frame from the output frame
+			const auto x = static_cast<double>(i) - center - frac;
+
+			const auto t = 2.0 * cutoff * x;
+			const auto sinc = (t == 0.0)
+			                        ? 1.0
+			                        : std::sin(std::numbers::pi * t) /
+			                                  (std::numbers::pi * t);
+
+			const auto r = x / half_width;
+			const auto window = (r * r < 1.0)
+			                          ? bessel_i0(KaiserBeta *
+			                                      std::sqrt(1.0 - r * r)) /
+			                                    i0_beta
+			                          : 0.0;
+
+			taps[i] = sinc * window;
+		}
+
+		// Normalise each phase to unity gain at DC so the blended
+		// phases don't introduce ripple
+		const auto sum = std::accumulate(taps.begin(), taps.end(), 0.0);
+		for (const auto tap : taps) {
+			const auto coeff = static_cast<float>(tap / sum);
+			*c++ = coeff;
+			*c++ = coeff;
+		}
+	}
+}
+
+void PolyphaseResampler::Reset()
+{
+	assert(num_taps > 0);
+
+	// Prime the history so the centre of the filter lines up with the
+	// first input frame
+	history.assign(num_taps / 2 - 1, AudioFrame{});
+
+	read_pos  = 0;
+	phase_acc = 0;
+}
+
+AudioFrame PolyphaseResampler::ComputeFrame(const AudioFrame* frames,
+                                            const size_t phase,
+                                            const float blend) const
+{
+	assert(phase < num_phases);
+
+	const auto phase_len = num_taps * 2;
+
+	auto f  = &frames->left;
+	auto c0 = coeffs.data() + phase * phase_len;
+	auto c1 = c0 + phase_len;
+
+	// Lanes from low to high: left, right, left, right of two frames
+	auto acc0 = simde_mm_setzero_ps();
+	auto acc1 = simde_mm_setzero_ps();
+
+	if (blend == 0.0f) {
+		for (size_t i = 0; i < phase_len; i += 4) {
+			const auto in = simde_mm_loadu_ps(f + i);
+			acc0 = simde_mm_add_ps(acc0,
+			                       simde_mm_mul_ps(in, simde_mm_loadu_ps(c0 + i)));
+		}
+	} else {
+		for (size_t i = 0; i < phase_len; i += 4) {
+			const auto in = simde_mm_loadu_ps(f + i);
+			acc0 = simde_mm_add_ps(acc0,
+			                       simde_mm_mul_ps(in, simde_mm_loadu_ps(c0 + i)));
+			acc1 = simde_mm_add_ps(acc1,
+			                       simde_mm_mul_ps(in, simde_mm_loadu_ps(c1 + i)));
+		}
+		acc0 = simde_mm_add_ps(acc0,
+		                       simde_mm_mul_ps(simde_mm_sub_ps(acc1, acc0),
+		                                       simde_mm_set1_ps(blend)));
+	}
+
+	// Fold the two frames' partial sums together
+	const auto sum = simde_mm_add_ps(acc0, simde_mm_movehl_ps(acc0, acc0));
+
+	alignas(16) float out[4] = {};
+	simde_mm_store_ps(out, sum);
+
+	return {out[0], out[1]};
+}
+
+void PolyphaseResampler::Process(const AudioFrame* in, const size_t num_frames,
+                                 std::vector<AudioFrame>& out)
+{
+	assert(num_taps > 0);
+
+	history.insert(history.end(), in, in + num_frames);
+
+	while (read_pos + num_taps <= history.size()) {
+		// Position within the phases, in units of 1 / 'denom'
+		const auto pos = static_cast<uint64_t>(phase_acc) * num_phases;
+
+		const auto phase = static_cast<size_t>(pos / denom);
+		const auto blend = static_cast<float>(pos % denom) /
+		                   static_cast<float>(denom);
+
+		out.push_back(ComputeFrame(&history[read_pos], phase, blend));
+
+		phase_acc += step;
+		read_pos += phase_acc / denom;
+		phase_acc %= denom;
+	}
+
+	// Drop the frames no longer needed. When downsampling, the next
+	// output frame can start beyond the frames we have.
+	const auto num_consumed = std::min(read_pos, history.size());
+
+	history.erase(history.begin(),
+	              history.begin() + static_cast<ptrdiff_t>(num_consumed));
+	read_pos -= num_consumed;
+}
@@ -56,6 +56,12 @@ public:
 
 	void Reactivate();
 
+	// False once the envelope has expired or is fully expanded
+	bool IsActive() const
+	{
+		return is_active;
+	}
+
 	// prevent copying
 	Envelope(const Envelope&) = delete;
 
@@ -91,6 +97,8 @@ private:
 
 	// Stop enveloping when the current edge is hits or exceeds this limit.
 	float edge_limit = 0.0f;
+
+	bool is_active = true;
 };
 
 #endif
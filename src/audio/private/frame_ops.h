@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_FRAME_OPS_H
+#define DOSBOX_FRAME_OPS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "audio/audio_frame.h"
+
+// Bulk operations on audio frame buffers used by the mixer thread.
+//
+// The default versions process two stereo frames per SSE2 register (NEON on
+// ARM via SIMDe); the 'scalar' ones are the plain reference implementations
+// that produce bit-identical results.
+
+// dest[i] += src[i]
+void add_frames(AudioFrame* dest, const AudioFrame* src, const size_t num_frames);
+
+// dest[i] += src[i] * gain
+void add_frames_scaled(AudioFrame* dest, const AudioFrame* src,
+                       const float gain, const size_t num_frames);
+
+// frames[i] *= gain
+void scale_frames(AudioFrame* frames, const AudioFrame gain, const size_t num_frames);
+
+// Convert to interleaved 16-bit samples; the fractional part is discarded
+// and out-of-range values are clamped
+void frames_to_int16(const AudioFrame* src, int16_t* dest, const size_t num_frames);
+
+namespace scalar {
+
+void add_frames(AudioFrame* dest, const AudioFrame* src, const size_t num_frames);
+
+void add_frames_scaled(AudioFrame* dest, const AudioFrame* src,
+                       const float gain, const size_t num_frames);
+
+void scale_frames(AudioFrame* frames, const AudioFrame gain, const size_t num_frames);
+
+void frames_to_int16(const AudioFrame* src, int16_t* dest, const size_t num_frames);
+
+} // namespace scalar
+
+#endif // DOSBOX_FRAME_OPS_H
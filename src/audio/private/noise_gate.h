@@ -18,10 +18,11 @@
 #include "dosbox.h"
 
 #include <array>
+#include <span>
 
 #include <Iir.h>
 
-typedef struct AudioFrame AudioFrame_;
+#include "audio/audio_frame.h"
 
 // Implements a simple noise gate that mutes the signal below a
 // given threshold. The release and attack parameters control how
@@ -42,6 +43,9 @@ public:
 
 	AudioFrame Process(const AudioFrame in);
 
+	// Processes a block of frames in-place
+	void Process(std::span<AudioFrame> frames);
+
 	// prevent copying
 	NoiseGate(const NoiseGate&) = delete;
 	// prevent assignment
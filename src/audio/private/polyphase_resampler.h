@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_POLYPHASE_RESAMPLER_H
+#define DOSBOX_POLYPHASE_RESAMPLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "audio/audio_frame.h"
+
+// Stereo windowed-sinc resampler using a polyphase filter bank.
+//
+// The rate ratio is reduced to 'out / in' and the fractional input position
+// of every output frame is tracked exactly. If the reduced output rate is
+// small enough, every possible position gets its own filter phase; otherwise
+// the nearest two of a fixed number of phases are blended linearly (the same
+// trade-off Speex makes for awkward ratios).
+//
+// The filter taps are stored duplicated per channel so the stereo dot
+// products run over interleaved frames with two frames per SSE2 register
+// (NEON on ARM via SIMDe). Downsampling widens the filter in proportion to
+// the ratio to keep the transition band narrow, like Speex.
+//
+class PolyphaseResampler {
+public:
+	// (Re-)builds the filter bank if the rates have changed, then resets
+	// the resampler.
+	void Configure(const int in_rate_hz, const int out_rate_hz);
+
+	// Clears the history and primes it so the first output frame lines up
+	// with the first input frame (there's no leading silence).
+	void Reset();
+
+	// Resamples the input frames and appends the result to 'out'. Output
+	// frames are produced once enough input has arrived to fill the filter,
+	// so a call can yield a few frames fewer than the ratio suggests; the
+	// backlog is emitted on subsequent calls.
+	void Process(const AudioFrame* in, const size_t num_frames,
+	             std::vector<AudioFrame>& out);
+
+	size_t GetNumTaps() const
+	{
+		return num_taps;
+	}
+
+private:
+	void BuildFilterBank();
+	AudioFrame ComputeFrame(const AudioFrame* frames, const size_t phase,
+	                        const float blend) const;
+
+	int in_rate_hz  = 0;
+	int out_rate_hz = 0;
+
+	// Input advances by 'step / denom' frames per output frame
+	uint32_t step  = 0;
+	uint32_t denom = 0;
+
+	// Fractional input position of the next output frame, in units of
+	// 1 / 'denom'
+	uint32_t phase_acc = 0;
+
+	uint32_t num_phases = 0;
+	size_t num_taps     = 0;
+
+	// 'num_phases + 1' phases of 'num_taps * 2' coefficients each; the
+	// extra phase lets the last one blend towards the next input frame
+	std::vector<float> coeffs = {};
+
+	std::vector<AudioFrame> history = {};
+
+	// Index of the first history frame the next output frame is built from
+	size_t read_pos = 0;
+};
+
+#endif // DOSBOX_POLYPHASE_RESAMPLER_H
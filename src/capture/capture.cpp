@@ -12,6 +12,7 @@
 #include "private/capture_audio.h"
 #include "private/capture_midi.h"
 #include "private/capture_video.h"
+#include "shared_memory_output.h"
 
 #include "config/config.h"
 #include "config/setup.h"
@@ -49,6 +50,13 @@ static struct {
 		int32_t serial_log         = 1;
 	} next_index = {};
 
+	// Requested FFmpeg video encoder; empty to use ZMBV
+	std::string ffmpeg_codec = {};
+
+	// Set when the video capture starts, as the FFmpeg encoder might not
+	// be available
+	bool use_ffmpeg = false;
+
 	void reset()
 	{
 		path.clear();
@@ -353,6 +361,14 @@ void CAPTURE_StartVideoCapture()
 {
 	switch (capture.state.video) {
 	case CaptureState::Off:
+		capture.use_ffmpeg = false;
+		if (!capture.ffmpeg_codec.empty()) {
+			capture.use_ffmpeg = capture_video_ffmpeg_init(capture.ffmpeg_codec);
+			if (!capture.use_ffmpeg) {
+				LOG_WARNING("CAPTURE: No working FFmpeg video encoder found; "
+				            "capturing with the ZMBV encoder instead");
+			}
+		}
 		capture.state.video = CaptureState::Pending;
 		TITLEBAR_NotifyVideoCaptureStatus(true);
 		break;
@@ -363,6 +379,15 @@ void CAPTURE_StartVideoCapture()
 	}
 }
 
+static void finalise_video_capture()
+{
+	if (capture.use_ffmpeg) {
+		capture_video_ffmpeg_finalise();
+	} else {
+		capture_video_finalise();
+	}
+}
+
 void CAPTURE_StopVideoCapture()
 {
 	switch (capture.state.video) {
@@ -377,7 +402,7 @@ void CAPTURE_StopVideoCapture()
 		TITLEBAR_NotifyVideoCaptureStatus(false);
 		break;
 	case CaptureState::InProgress:
-		capture_video_finalise();
+		finalise_video_capture();
 		capture.state.video = CaptureState::Off;
 		TITLEBAR_NotifyVideoCaptureStatus(false);
 		LOG_MSG("CAPTURE: Stopped capturing video output");
@@ -396,7 +421,11 @@ void CAPTURE_AddFrame(const RenderedImage& image, const float frames_per_second)
 		capture.state.video = CaptureState::InProgress;
 		[[fallthrough]];
 	case CaptureState::InProgress:
-		capture_video_add_frame(image, frames_per_second);
+		if (capture.use_ffmpeg) {
+			capture_video_ffmpeg_add_frame(image, frames_per_second);
+		} else {
+			capture_video_add_frame(image, frames_per_second);
+		}
 		break;
 	}
 }
@@ -417,9 +446,15 @@ void CAPTURE_AddAudioData(const uint32_t sample_rate, const uint32_t num_sample_
 		capture.state.video = CaptureState::InProgress;
 		[[fallthrough]];
 	case CaptureState::InProgress:
-		capture_video_add_audio_data(sample_rate,
-		                             num_sample_frames,
-		                             sample_frames);
+		if (capture.use_ffmpeg) {
+			capture_video_ffmpeg_add_audio_data(sample_rate,
+			                                    num_sample_frames,
+			                                    sample_frames);
+		} else {
+			capture_video_add_audio_data(sample_rate,
+			                             num_sample_frames,
+			                             sample_frames);
+		}
 		break;
 	}
 
@@ -571,9 +606,25 @@ void CAPTURE_Init()
 		capture.path = "capture";
 	}
 
+	const auto drop_frames = (section->GetString("video_capture_backlog") == "drop");
+
+	capture_video_set_frame_dropping(drop_frames);
+	capture_video_ffmpeg_set_frame_dropping(drop_frames);
+
+	capture.ffmpeg_codec = {};
+	if (section->GetString("video_capture_encoder") == "ffmpeg") {
+		capture.ffmpeg_codec = section->GetString("video_capture_ffmpeg_codec");
+		capture_video_ffmpeg_probe(capture.ffmpeg_codec);
+	}
+
 	const auto prefs = section->GetString("default_image_capture_formats");
 
-	image_capturer = std::make_unique<ImageCapturer>(prefs);
+	const auto compression_level = section->GetInt("image_compression_level");
+
+	image_capturer = std::make_unique<ImageCapturer>(prefs, compression_level);
+
+	// Keeps the current output if the name hasn't changed
+	SHM_OUTPUT_Init(section->GetString("shared_memory_output"));
 }
 
 void CAPTURE_Destroy()
@@ -593,9 +644,10 @@ void CAPTURE_Destroy()
 	image_capturer = {};
 
 	if (capture.state.video == CaptureState::InProgress) {
-		capture_video_finalise();
+		finalise_video_capture();
 		capture.state.video = CaptureState::Off;
 	}
+	capture_video_ffmpeg_destroy();
 
 	capture.reset();
 }
@@ -690,6 +742,64 @@ static void init_capture_config_settings(SectionProp& section)
 	        "screenshot action will save multiple images in the specified formats.\n"
 	        "Keybindings for taking single screenshots in specific formats are also\n"
 	        "available.");
+
+	constexpr auto DefaultCompressionLevel = 6;
+
+	auto* int_prop = section.AddInt("image_compression_level",
+	                                WhenIdle,
+	                                DefaultCompressionLevel);
+	int_prop->SetMinMax(0, 9);
+	int_prop->SetHelp(
+	        format_str("PNG compression level of the screenshots from 0 (no compression) to 9 (best\n"
+	                   "compression) (%d by default). Higher levels result in slightly smaller\n"
+	                   "files but take considerably longer to save; levels above 6 are rarely\n"
+	                   "worth it. Large screenshots are compressed on multiple CPU cores.",
+	                   DefaultCompressionLevel));
+
+	str_prop = section.AddString("video_capture_backlog", WhenIdle, "wait");
+	str_prop->SetValues({"wait", "drop"});
+	str_prop->SetHelp(
+	        "What to do when the video encoder falls behind the emulation while capturing\n"
+	        "video ('wait' by default). The video frames are compressed on a separate\n"
+	        "thread, with a few frames queued up to absorb short bursts. Possible values:\n"
+	        "\n"
+	        "  wait:  Slow down the emulation until the encoder catches up; every frame\n"
+	        "         is captured (default).\n"
+	        "\n"
+	        "  drop:  Keep the emulation running at full speed and skip frames until the\n"
+	        "         encoder catches up. Skipped frames repeat the previous frame in the\n"
+	        "         video, so it stays in sync with the audio.");
+
+	str_prop = section.AddString("video_capture_encoder", WhenIdle, "zmbv");
+	str_prop->SetValues({"zmbv", "ffmpeg"});
+	str_prop->SetHelp(
+	        "Encoder used for capturing video ('zmbv' by default). Possible values:\n"
+	        "\n"
+	        "  zmbv:    Lossless ZMBV video in an AVI file (default). Widely supported by\n"
+	        "           video editors, but takes a lot of CPU time and produces large\n"
+	        "           files for long recordings.\n"
+	        "\n"
+	        "  ffmpeg:  H.264 video compressed by the hardware video encoder of the GPU\n"
+	        "           (VA-API, NVENC, Quick Sync, AMF, Media Foundation, or\n"
+	        "           VideoToolbox) with FLAC audio in an MKV file. Requires the\n"
+	        "           'ffmpeg' program on the PATH; falls back to 'zmbv' if no working\n"
+	        "           encoder is found. See 'video_capture_ffmpeg_codec'.");
+
+	str_prop = section.AddString("video_capture_ffmpeg_codec", WhenIdle, "auto");
+	str_prop->SetHelp(
+	        "FFmpeg video encoder to use with 'video_capture_encoder = ffmpeg' ('auto' by\n"
+	        "default). 'auto' picks the first hardware encoder that works on this system;\n"
+	        "set it to the name of an FFmpeg encoder (e.g., 'h264_nvenc', 'hevc_nvenc',\n"
+	        "or 'libx264') to use that instead.");
+
+	str_prop = section.AddString("shared_memory_output", WhenIdle, "");
+	str_prop->SetHelp(
+	        "Publish the video and audio output in shared memory for an external encoder,\n"
+	        "e.g., of a game streaming service (disabled by default). Set it to a name to\n"
+	        "create the 'NAME-video' and 'NAME-audio' shared memory objects; the video\n"
+	        "object holds the last few raw frames as 32-bit BGRX pixels, the audio object\n"
+	        "a ring of the final mixer output as 32-bit float stereo samples. See\n"
+	        "'src/capture/shared_memory_output.h' for the layout.");
 }
 
 void CAPTURE_AddConfigSection(const ConfigPtr& conf)
@@ -1,4 +1,4 @@
-// SPDX-FileCopyrightText:  2023-2025 The DOSBox Staging Team
+// SPDX-FileCopyrightText:  2023-2026 The DOSBox Staging Team
 // SPDX-FileCopyrightText:  2002-2021 The DOSBox Team
 // SPDX-License-Identifier: GPL-2.0-or-later
 
@@ -6,6 +6,9 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <memory>
+
+#include "private/write_behind_file.h"
 
 #include "config/setup.h"
 #include "gui/titlebar.h"
@@ -16,27 +19,19 @@ static constexpr auto SampleFrameSize   = 4;
 static constexpr auto NumFramesInBuffer = 16 * 1024;
 static constexpr auto NumChannels       = 2;
 
+// Around 20 seconds of 48 kHz audio, to ride out storage stalls without
+// blocking the mixer thread
+static constexpr auto WriteBehindBufferSize = 4 * 1024 * 1024;
+
 static struct {
 	FILE* handle = nullptr;
 
+	std::unique_ptr<WriteBehindFile> writer = {};
+
 	uint16_t buf[NumFramesInBuffer][NumChannels] = {};
 
 	uint32_t sample_rate_hz  = 0;
 	uint32_t buf_frames_used = 0;
-	
-	// TODO A 16-bit / 44.1kHz WAV file is limited to a bit less than 4GB
-	// worth of sample data because the chunk sizes are stored as 32-bit
-	// unsigned integers in the RIFF container the WAV format uses.
-	//
-	// So technically we should chunk the recording into separate WAV files at
-	// ~3.4 hour intervals, which is the duration of a recording of a 2GB
-	// WAV file recorded at 16-bit/44.1kHz (some programs use 32-bit signed
-	// integers when handling WAV files, therefore 2GB is the safe limit).
-	//
-	// This will be more of a problem when adding support for 24 and 32-bit
-	// formats, as in case of a 32-bit float WAV file, the safe duration is
-	// reduced to ~1.7 hour.
-	uint32_t data_bytes_written = 0;
 } wave = {};
 
 // clang-format off
@@ -64,11 +59,15 @@ static void create_wave_file(const uint32_t sample_rate_hz)
 		return;
 	}
 
-	wave.sample_rate_hz     = sample_rate_hz;
-	wave.buf_frames_used    = 0;
-	wave.data_bytes_written = 0;
+	wave.sample_rate_hz  = sample_rate_hz;
+	wave.buf_frames_used = 0;
 
+	// The header is rewritten with the final sizes when the capture ends
 	fwrite(wav_header, 1, sizeof(wav_header), wave.handle);
+
+	wave.writer = std::make_unique<WriteBehindFile>(wave.handle,
+	                                                WriteBehindBufferSize,
+	                                                "dosbox:wavcap");
 }
 
 void capture_audio_add_data(const uint32_t sample_rate_hz,
@@ -91,9 +90,8 @@ void capture_audio_add_data(const uint32_t sample_rate_hz,
 		uint32_t frames_left = NumFramesInBuffer - wave.buf_frames_used;
 		if (!frames_left) {
 			const auto bytes_to_write = NumFramesInBuffer * SampleFrameSize;
-			fwrite(wave.buf, 1, bytes_to_write, wave.handle);
+			wave.writer->Write(wave.buf, bytes_to_write);
 
-			wave.data_bytes_written += bytes_to_write;
 			wave.buf_frames_used = 0;
 
 			frames_left = NumFramesInBuffer;
@@ -121,13 +119,36 @@ void capture_audio_finalise()
 
 	// Flush audio buffer
 	const auto bytes_to_write = wave.buf_frames_used * SampleFrameSize;
-	fwrite(wave.buf, 1, bytes_to_write, wave.handle);
-	wave.data_bytes_written += bytes_to_write;
+	wave.writer->Write(wave.buf, bytes_to_write);
+	wave.writer->Flush();
+
+	if (const auto num_bytes_dropped = wave.writer->GetNumBytesDropped();
+	    num_bytes_dropped > 0) {
+		LOG_WARNING("CAPTURE: Storage was too slow; dropped %.1f seconds "
+		            "of audio",
+		            static_cast<double>(num_bytes_dropped) /
+		                    (wave.sample_rate_hz * SampleFrameSize));
+	}
+
+	// TODO A 16-bit / 44.1kHz WAV file is limited to a bit less than 4GB
+	// worth of sample data because the chunk sizes are stored as 32-bit
+	// unsigned integers in the RIFF container the WAV format uses.
+	//
+	// So technically we should chunk the recording into separate WAV files at
+	// ~3.4 hour intervals, which is the duration of a recording of a 2GB
+	// WAV file recorded at 16-bit/44.1kHz (some programs use 32-bit signed
+	// integers when handling WAV files, therefore 2GB is the safe limit).
+	//
+	// This will be more of a problem when adding support for 24 and 32-bit
+	// formats, as in case of a 32-bit float WAV file, the safe duration is
+	// reduced to ~1.7 hour.
+	const auto data_bytes_written = static_cast<uint32_t>(
+	        wave.writer->GetNumBytesWritten());
 
 	// Update headers
 	constexpr auto chunk_header_size = 8;
 
-	const auto riff_chunk_size = static_cast<uint32_t>(wave.data_bytes_written +
+	const auto riff_chunk_size = static_cast<uint32_t>(data_bytes_written +
 	                             sizeof(wav_header) - chunk_header_size);
 
 	constexpr auto riff_chunk_size_offset = 0x04;
@@ -141,7 +162,7 @@ void capture_audio_finalise()
 	            wave.sample_rate_hz * SampleFrameSize);
 
 	constexpr auto data_chunk_size_offset = 0x28;
-	host_writed(&wav_header[data_chunk_size_offset], wave.data_bytes_written);
+	host_writed(&wav_header[data_chunk_size_offset], data_bytes_written);
 
 	fseek(wave.handle, 0, 0);
 	fwrite(wav_header, 1, sizeof(wav_header), wave.handle);
@@ -1,4 +1,4 @@
-// SPDX-FileCopyrightText:  2023-2025 The DOSBox Staging Team
+// SPDX-FileCopyrightText:  2023-2026 The DOSBox Staging Team
 // SPDX-FileCopyrightText:  2002-2021 The DOSBox Team
 // SPDX-License-Identifier: GPL-2.0-or-later
 
@@ -9,19 +9,26 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
+
+#include "private/write_behind_file.h"
 
 #include "hardware/pic.h"
 #include "midi/midi.h"
 #include "misc/support.h"
 
+// MIDI data rates are tiny, so this covers very long storage stalls
+static constexpr auto WriteBehindBufferSize = 256 * 1024;
+
 static struct {
 	FILE* handle = nullptr;
 
+	std::unique_ptr<WriteBehindFile> writer = {};
+
 	std::array<uint8_t, 4 * 1024> buffer = {};
 
-	uint32_t bytes_used    = 0;
-	uint32_t bytes_written = 0;
-	uint32_t last_tick     = 0;
+	uint32_t bytes_used = 0;
+	uint32_t last_tick  = 0;
 } midi = {};
 
 // clang-format off
@@ -41,8 +48,7 @@ static void raw_midi_add(const uint8_t data)
 	midi.buffer[midi.bytes_used++] = data;
 
 	if (midi.bytes_used >= midi.buffer.size()) {
-		midi.bytes_written += midi.bytes_used;
-		fwrite(midi.buffer.data(), 1, midi.buffer.size(), midi.handle);
+		midi.writer->Write(midi.buffer.data(), midi.buffer.size());
 		midi.bytes_used = 0;
 	}
 }
@@ -69,6 +75,10 @@ static void create_midi_file()
 	}
 	fwrite(midi_header, 1, sizeof(midi_header), midi.handle);
 	midi.last_tick = PIC_Ticks;
+
+	midi.writer = std::make_unique<WriteBehindFile>(midi.handle,
+	                                                WriteBehindBufferSize,
+	                                                "dosbox:midicap");
 }
 
 void capture_midi_add_data(const bool sysex, const size_t len, const uint8_t* data)
@@ -108,8 +118,18 @@ void capture_midi_finalise()
 	raw_midi_add(0x00);
 
 	// Flush buffer
-	fwrite(midi.buffer.data(), 1, midi.bytes_used, midi.handle);
-	midi.bytes_written += midi.bytes_used;
+	midi.writer->Write(midi.buffer.data(), midi.bytes_used);
+	midi.writer->Flush();
+
+	if (const auto num_bytes_dropped = midi.writer->GetNumBytesDropped();
+	    num_bytes_dropped > 0) {
+		LOG_WARNING("CAPTURE: Storage was too slow; dropped %llu bytes of "
+		            "MIDI data, the captured MIDI file is likely corrupt",
+		            static_cast<unsigned long long>(num_bytes_dropped));
+	}
+
+	const auto bytes_written = static_cast<uint32_t>(
+	        midi.writer->GetNumBytesWritten());
 
 	constexpr auto midi_header_size_offset = 18;
 	if (fseek(midi.handle, midi_header_size_offset, SEEK_SET) != 0) {
@@ -122,10 +142,10 @@ void capture_midi_finalise()
 
 	uint8_t size[4];
 
-	size[0] = (uint8_t)(midi.bytes_written >> 24);
-	size[1] = (uint8_t)(midi.bytes_written >> 16);
-	size[2] = (uint8_t)(midi.bytes_written >> 8);
-	size[3] = (uint8_t)(midi.bytes_written >> 0);
+	size[0] = (uint8_t)(bytes_written >> 24);
+	size[1] = (uint8_t)(bytes_written >> 16);
+	size[2] = (uint8_t)(bytes_written >> 8);
+	size[3] = (uint8_t)(bytes_written >> 0);
 	fwrite(&size, 1, 4, midi.handle);
 
 	fclose(midi.handle);
@@ -6,44 +6,74 @@
 
 #include "private/capture_video.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "hardware/memory.h"
 #include "misc/support.h"
 #include "utils/math_utils.h"
+#include "utils/rwqueue.h"
 
 #include "zmbv/zmbv.h"
 
-static constexpr auto NumSampleFramesInBuffer = 16 * 1024;
+// Audio captured while frames are dropped is held until the next frame is
+// queued, so it's not lost; that's over 20 seconds at 48 kHz. Only longer
+// drops lose audio and get out of sync.
+static constexpr size_t MaxPendingSampleFrames = 1024 * 1024;
 
 static constexpr auto SampleFrameSize  = 4;
 static constexpr auto NumAudioChannels = 2;
 
 static constexpr auto AviHeaderSize = 500;
 
+// Frames waiting to be encoded; at 640x480 in true colour, that's ~10 MB
+static constexpr auto MaxQueuedFrames = 8;
+
+// Insert a key frame after this many frames
+static constexpr auto KeyFrameInterval = 300;
+
 static struct {
 	FILE* handle = nullptr;
 
-	uint32_t frames          = 0;
-	VideoCodec* codec        = nullptr;
-	int width                = 0;
-	int height               = 0;
-	PixelFormat pixel_format = {};
-	float frames_per_second  = 0.0f;
-
+	// Only used by the encoder thread while capturing
+	uint32_t frames            = 0;
+	uint32_t next_key_frame    = 0;
+	VideoCodec* codec          = nullptr;
 	uint32_t written           = 0;
 	uint32_t buf_size          = 0;
 	std::vector<uint8_t> buf   = {};
 	std::vector<uint8_t> index = {};
 	uint32_t index_used        = 0;
 
+	int width                = 0;
+	int height               = 0;
+	PixelFormat pixel_format = {};
+	float frames_per_second  = 0.0f;
+
+	// The frames are compressed and written to the AVI file on the encoder
+	// thread. Their buffers are handed back through the pool for reuse.
+	RWQueue<VideoCaptureFrame> frame_fifo{MaxQueuedFrames};
+	std::thread encoder = {};
+
+	std::mutex pool_mutex                     = {};
+	std::vector<VideoCaptureFrame> frame_pool = {};
+
+	bool drop_frames           = false;
+	uint32_t num_dropped       = 0;
+	uint32_t num_dropped_total = 0;
+
 	struct {
-		int16_t buf[NumSampleFramesInBuffer][NumAudioChannels] = {};
+		// Interleaved sample frames captured since the last queued
+		// video frame
+		std::vector<int16_t> pending = {};
 
-		uint32_t sample_rate     = 0;
-		uint32_t buf_frames_used = 0;
-		uint32_t bytes_written   = 0;
+		uint32_t sample_rate   = 0;
+		uint32_t bytes_written = 0;
 	} audio = {};
 } video = {};
 
@@ -120,11 +150,28 @@ static void add_avi_chunk(const char* tag, const uint32_t size,
 	host_writed(index + 12, size);
 }
 
+void capture_video_set_frame_dropping(const bool enabled)
+{
+	video.drop_frames = enabled;
+}
+
 void capture_video_finalise()
 {
 	if (!video.handle) {
 		return;
 	}
+
+	// Let the encoder finish writing the queued frames
+	video.frame_fifo.Stop();
+	if (video.encoder.joinable()) {
+		video.encoder.join();
+	}
+
+	if (video.num_dropped_total > 0) {
+		LOG_MSG("CAPTURE: Dropped %u video frames because the encoder couldn't keep up",
+		        video.num_dropped_total);
+	}
+
 	if (video.codec) {
 		video.codec->FinishVideo();
 	}
@@ -292,19 +339,21 @@ void capture_video_add_audio_data(const uint32_t sample_rate,
 	if (!video.handle) {
 		return;
 	}
-	auto frames_left = NumSampleFramesInBuffer - video.audio.buf_frames_used;
-	if (frames_left > num_sample_frames) {
-		frames_left = num_sample_frames;
-	}
+	auto& pending = video.audio.pending;
 
-	memcpy(&video.audio.buf[video.audio.buf_frames_used],
-	       sample_frames,
-	       frames_left * SampleFrameSize);
+	const auto frames_used = pending.size() / NumAudioChannels;
+	const auto frames_left = std::min(MaxPendingSampleFrames - frames_used,
+	                                  static_cast<size_t>(num_sample_frames));
+
+	pending.insert(pending.end(),
+	               sample_frames,
+	               sample_frames + frames_left * NumAudioChannels);
 
-	video.audio.buf_frames_used += frames_left;
 	video.audio.sample_rate = sample_rate;
 }
 
+static void encode_queued_frames();
+
 static void create_avi_file(const uint16_t width, const uint16_t height,
                             const PixelFormat pixel_format,
                             const float frames_per_second, ZMBV_FORMAT format)
@@ -315,6 +364,11 @@ static void create_avi_file(const uint16_t width, const uint16_t height,
 	}
 	video.codec = new VideoCodec();
 	if (!video.codec->SetupCompress(width, height)) {
+		fclose(video.handle);
+		video.handle = nullptr;
+
+		delete video.codec;
+		video.codec = nullptr;
 		return;
 	}
 
@@ -334,16 +388,24 @@ static void create_avi_file(const uint16_t width, const uint16_t height,
 	}
 
 	video.frames                = 0;
+	video.next_key_frame        = 0;
 	video.written               = 0;
-	video.audio.buf_frames_used = 0;
-	video.audio.bytes_written   = 0;
+	video.audio.pending.clear();
+	video.audio.bytes_written = 0;
+
+	video.num_dropped       = 0;
+	video.num_dropped_total = 0;
+
+	video.frame_fifo.Start();
+	video.encoder = std::thread(encode_queued_frames);
+	set_thread_name(video.encoder, "dosbox:vidcap");
 }
 
 // Performs some transforms on the passed down rendered image to make sure
-// we're capturing the raw output, then passes the result in the same
-// byte-order to the encoder. Endianness varies per pixel format (see
-// PixelFormat in video.h for details); the ZMBV encoder handles all that
-// detail.
+// we're capturing the raw output, then copies the result in the same
+// byte-order into the frame buffer handed to the encoder. Endianness varies
+// per pixel format (see PixelFormat in video.h for details); the ZMBV encoder
+// handles all that detail.
 //
 // We always write non-double-scanned and non-pixel-doubled frames in raw
 // video capture mode :
@@ -363,7 +425,8 @@ static void create_avi_file(const uint16_t width, const uint16_t height,
 // artifacts (so 320x200 is rendered as 640x200, and 640x200 as 1280x200).
 // These are written as-is, otherwise we'd be losing information.
 //
-static void compress_raw_frame(const RenderedImage& image)
+void capture_video_copy_raw_frame(const RenderedImage& image,
+                                  std::vector<uint8_t>& dest)
 {
 	const auto& src = image.params;
 	auto src_row    = image.image_data;
@@ -379,50 +442,122 @@ static void compress_raw_frame(const RenderedImage& image)
 
 	const auto pixel_skip_count = (src.rendered_pixel_doubling ? 1 : 0);
 
-	auto compress_row = [&](const uint8_t* row_buffer) {
-		video.codec->CompressLines(1, &row_buffer);
-	};
-
 	const auto src_bpp = to_bytes_per_pixel(src.pixel_format);
 	const auto dest_bpp = to_bytes_per_pixel(to_zmbv_format(src.pixel_format));
 
-	// Maybe compress the source rows straight away without copying. Note
-	// that this is a shortcut scenario; hard-code it to false to exercise
-	// the rote version below.
+	const auto dest_pitch = static_cast<size_t>(raw_width * dest_bpp);
+
+	// Reusing the pooled buffer only reallocates when the video mode grows
+	dest.resize(dest_pitch * static_cast<size_t>(raw_height));
+	auto dest_row = dest.data();
+
+	// Maybe copy the source rows straight away. Note that this is a
+	// shortcut scenario; hard-code it to false to exercise the rote version
+	// below.
 
 	const auto can_use_src_directly = (src_bpp == dest_bpp &&
 	                                   pixel_skip_count == 0);
 	if (can_use_src_directly) {
 		for (auto i = 0; i < raw_height; ++i, src_row += src_pitch) {
-			compress_row(src_row);
+			std::memcpy(dest_row, src_row, dest_pitch);
+			dest_row += dest_pitch;
 		}
 		return;
 	}
 
-	// Otherwise we need to arrange the source bytes before compressing
+	// Otherwise we need to arrange the source bytes pixel by pixel
 	assert(!can_use_src_directly);
 
-	// Grow the target row buffer if needed
-	const auto dest_row_bytes = check_cast<uint16_t>(src.width * dest_bpp);
-	static std::vector<uint8_t> dest_row = {};
-	if (dest_row.size() < dest_row_bytes) {
-		dest_row.resize(dest_row_bytes, 0);
-	}
-
 	const auto src_advance = src_bpp * (pixel_skip_count + 1);
 
 	for (auto i = 0; i < raw_height; ++i, src_row += src_pitch) {
 		auto src_pixel  = src_row;
-		auto dest_pixel = dest_row.data();
+		auto dest_pixel = dest_row;
 
 		for (auto j = 0; j < raw_width; ++j, src_pixel += src_advance) {
 			std::memcpy(dest_pixel, src_pixel, src_bpp);
 			dest_pixel += dest_bpp;
 		}
-		compress_row(dest_row.data());
+		dest_row += dest_pitch;
+	}
+}
+
+// Runs on the encoder thread
+static void encode_frame(const VideoCaptureFrame& frame)
+{
+	// Empty chunks tell the player to keep showing the previous frame,
+	// which keeps the video in sync with the audio
+	for (uint32_t i = 0; i < frame.num_dropped_before; ++i) {
+		add_avi_chunk("00dc", 0, nullptr, 0x0);
+		video.frames++;
+	}
+
+	const auto codec_flags = (video.frames >= video.next_key_frame) ? 1 : 0;
+
+	const auto zmbv_format = to_zmbv_format(video.pixel_format);
+
+	if (video.codec->PrepareCompressFrame(codec_flags,
+	                                      zmbv_format,
+	                                      frame.palette.data(),
+	                                      video.buf.data(),
+	                                      video.buf_size)) {
+
+		const auto pitch = frame.pixels.size() /
+		                   static_cast<size_t>(video.height);
+
+		auto row = frame.pixels.data();
+		for (auto i = 0; i < video.height; ++i, row += pitch) {
+			const uint8_t* rows[] = {row};
+			video.codec->CompressLines(1, rows);
+		}
+
+		const auto written = video.codec->FinishCompressFrame();
+		if (written >= 0) {
+			add_avi_chunk("00dc",
+			              written,
+			              video.buf.data(),
+			              codec_flags & 1 ? 0x10 : 0x0);
+			video.frames++;
+
+			if (codec_flags & 1) {
+				video.next_key_frame = video.frames + KeyFrameInterval - 1;
+			}
+		}
+	}
+
+	if (!frame.audio.empty()) {
+		const auto num_bytes = check_cast<uint32_t>(frame.audio.size() *
+		                                            sizeof(int16_t));
+
+		add_avi_chunk("01wb", num_bytes, frame.audio.data(), 0);
+
+		video.audio.bytes_written = num_bytes;
+	}
+}
+
+static void encode_queued_frames()
+{
+	while (auto frame = video.frame_fifo.Dequeue()) {
+		encode_frame(*frame);
+
+		std::lock_guard lock(video.pool_mutex);
+		video.frame_pool.emplace_back(std::move(*frame));
 	}
 }
 
+static VideoCaptureFrame get_pooled_frame()
+{
+	std::lock_guard lock(video.pool_mutex);
+
+	if (video.frame_pool.empty()) {
+		return {};
+	}
+
+	auto frame = std::move(video.frame_pool.back());
+	video.frame_pool.pop_back();
+	return frame;
+}
+
 void capture_video_add_frame(const RenderedImage& image, const float frames_per_second)
 {
 	const auto& src = image.params;
@@ -445,59 +580,44 @@ void capture_video_add_frame(const RenderedImage& image, const float frames_per_
 		capture_video_finalise();
 	}
 
-	const auto zmbv_format = to_zmbv_format(src.pixel_format);
-
 	if (!video.handle) {
 		create_avi_file(raw_width,
 		                raw_height,
 		                src.pixel_format,
 		                frames_per_second,
-		                zmbv_format);
+		                to_zmbv_format(src.pixel_format));
 	}
 	if (!video.handle) {
 		return;
 	}
 
-	const auto codec_flags = (video.frames % 300 == 0) ? 1 : 0;
+	// We're the only producer, so the queue can't fill up in between. The
+	// audio keeps accumulating for the next frame, which carries the audio
+	// of the dropped ones.
+	if (video.drop_frames && video.frame_fifo.IsFull()) {
+		++video.num_dropped;
+		++video.num_dropped_total;
+		return;
+	}
+
+	auto frame = get_pooled_frame();
 
-	static uint8_t palette_data[NumVgaColors * 4] = {};
+	capture_video_copy_raw_frame(image, frame.pixels);
 
 	for (auto i = 0; i < NumVgaColors; ++i) {
 		const auto color = image.palette[i];
 
-		palette_data[i * 4]     = color.red;
-		palette_data[i * 4 + 1] = color.green;
-		palette_data[i * 4 + 2] = color.blue;
+		frame.palette[i * 4]     = color.red;
+		frame.palette[i * 4 + 1] = color.green;
+		frame.palette[i * 4 + 2] = color.blue;
 	}
 
-	if (!video.codec->PrepareCompressFrame(codec_flags,
-	                                       zmbv_format,
-	                                       palette_data,
-	                                       video.buf.data(),
-	                                       video.buf_size)) {
-		return;
-	}
+	// The pooled frame's buffer collects the audio for the next one
+	std::swap(frame.audio, video.audio.pending);
+	video.audio.pending.clear();
 
-	compress_raw_frame(image);
+	frame.num_dropped_before = video.num_dropped;
+	video.num_dropped        = 0;
 
-	const auto written = video.codec->FinishCompressFrame();
-	if (written < 0) {
-		return;
-	}
-
-	add_avi_chunk("00dc", written, video.buf.data(), codec_flags & 1 ? 0x10 : 0x0);
-	video.frames++;
-
-	//		LOG_MSG("CAPTURE: Frame %d video %d audio
-	//%d",video.frames, written, video.audio_buf_frames_used *4 );
-	if (video.audio.buf_frames_used) {
-		add_avi_chunk("01wb",
-		              video.audio.buf_frames_used * SampleFrameSize,
-		              video.audio.buf,
-		              0);
-
-		video.audio.bytes_written = video.audio.buf_frames_used *
-		                            SampleFrameSize;
-		video.audio.buf_frames_used = 0;
-	}
+	video.frame_fifo.Enqueue(std::move(frame));
 }
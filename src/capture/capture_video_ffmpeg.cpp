@@ -0,0 +1,815 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "capture.h"
+
+#include "private/capture_video.h"
+
+#include <cassert>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+#include "misc/support.h"
+#include "utils/checks.h"
+#include "utils/fs_utils.h"
+#include "utils/rwqueue.h"
+#include "utils/string_utils.h"
+
+CHECK_NARROWING();
+
+// Video capture through an external FFmpeg process.
+//
+// The emulation thread only copies the raw frames into pooled buffers; the
+// encoder thread expands them to a pixel format FFmpeg understands and pipes
+// them into FFmpeg, which hands them to the platform's hardware encoder. The
+// audio is written to a temporary raw PCM file and muxed with the video on a
+// worker thread once the capture ends.
+//
+// Using the FFmpeg executable found at runtime keeps the hardware encoder
+// APIs (VA-API, NVENC, Quick Sync, AMF, Media Foundation, VideoToolbox) out
+// of our build, and the capture falls back to ZMBV if none of them work.
+// FFmpeg is started directly with an argument list, never through a shell.
+
+// Frames waiting to be encoded
+static constexpr auto MaxQueuedFrames = 8;
+
+static constexpr auto NumAudioChannels = 2;
+
+// Constant quality for the encoders that support it, and a bitrate for the
+// rest; either is plenty for DOS resolutions
+struct FfmpegCodec {
+	std::string name                     = {};
+	std::vector<std::string> global_args = {};
+	std::string filter                   = "format=nv12";
+	std::vector<std::string> codec_args  = {};
+};
+
+static const FfmpegCodec HardwareCodecs[] = {
+#if defined(WIN32)
+        {"h264_nvenc", {}, "format=nv12", {"-rc", "constqp", "-qp", "20"}},
+        {"h264_qsv", {}, "format=nv12", {"-global_quality", "20"}},
+        {"h264_amf", {}, "format=nv12", {"-rc", "cqp", "-qp_i", "20", "-qp_p", "20"}},
+        {"h264_mf", {}, "format=nv12", {"-hw_encoding", "1", "-b:v", "8M"}},
+#elif defined(MACOSX)
+        {"h264_videotoolbox", {}, "format=nv12", {"-b:v", "8M"}},
+#else
+        {"h264_vaapi",
+         {"-vaapi_device", "/dev/dri/renderD128"},
+         "format=nv12,hwupload",
+         {"-qp", "20"}},
+        {"h264_nvenc", {}, "format=nv12", {"-rc", "constqp", "-qp", "20"}},
+#endif
+};
+
+// A running FFmpeg process, optionally with a pipe to its standard input
+struct FfmpegProcess {
+#if defined(WIN32)
+	HANDLE handle = nullptr;
+#else
+	pid_t pid = 0;
+#endif
+	FILE* input = nullptr;
+};
+
+static struct {
+	// The resolved encoder; empty if no working encoder was found
+	std::optional<FfmpegCodec> codec = {};
+
+	// Probing the encoders takes a moment, so it's done on a worker thread
+	// once for every requested codec
+	std::map<std::string, std::shared_future<std::optional<FfmpegCodec>>> probed_codecs = {};
+
+	// Muxing the video and audio of the last capture
+	std::future<void> muxer = {};
+
+	std::optional<FfmpegProcess> encoder_process = {};
+	FILE* audio_file = nullptr;
+
+	std_fs::path output_path = {};
+	std_fs::path video_path  = {};
+	std_fs::path audio_path  = {};
+
+	int width                = 0;
+	int height               = 0;
+	PixelFormat pixel_format = {};
+	float frames_per_second  = 0.0f;
+
+	RWQueue<VideoCaptureFrame> frame_fifo{MaxQueuedFrames};
+	std::thread encoder = {};
+
+	std::mutex pool_mutex                     = {};
+	std::vector<VideoCaptureFrame> frame_pool = {};
+
+	bool drop_frames           = false;
+	uint32_t num_dropped       = 0;
+	uint32_t num_dropped_total = 0;
+
+	// Only used by the main thread
+	std::vector<int16_t> audio_buf = {};
+	uint32_t audio_sample_rate     = 0;
+
+	// Only used by the encoder thread while capturing
+	std::vector<uint8_t> out_buf    = {};
+	std::vector<uint8_t> prev_frame = {};
+	bool has_write_error            = false;
+} ffmpeg = {};
+
+static std::vector<std::string> make_ffmpeg_argv(const std::vector<std::string>& args)
+{
+	std::vector<std::string> argv = {"ffmpeg", "-hide_banner", "-loglevel", "error"};
+	argv.insert(argv.end(), args.begin(), args.end());
+	return argv;
+}
+
+#if defined(WIN32)
+
+// Quotes an argument so the C runtime of the child process splits the
+// command line back into the same arguments
+static std::string quote_argument(const std::string& arg)
+{
+	if (!arg.empty() && arg.find_first_of(" \t\"") == std::string::npos) {
+		return arg;
+	}
+
+	std::string quoted     = "\"";
+	size_t num_backslashes = 0;
+
+	for (const auto c : arg) {
+		if (c == '\\') {
+			++num_backslashes;
+			continue;
+		}
+		if (c == '"') {
+			// Backslashes before a quote are escapes, so they're doubled,
+			// and the quote itself is escaped
+			quoted.append(num_backslashes * 2 + 1, '\\');
+		} else {
+			quoted.append(num_backslashes, '\\');
+		}
+		num_backslashes = 0;
+		quoted += c;
+	}
+	quoted.append(num_backslashes * 2, '\\');
+	quoted += '"';
+	return quoted;
+}
+
+static std::optional<FfmpegProcess> spawn_ffmpeg(const std::vector<std::string>& args,
+                                                 const bool with_input,
+                                                 const bool is_quiet)
+{
+	std::string command_line = {};
+	for (const auto& arg : make_ffmpeg_argv(args)) {
+		if (!command_line.empty()) {
+			command_line += ' ';
+		}
+		command_line += quote_argument(arg);
+	}
+
+	SECURITY_ATTRIBUTES inheritable = {};
+	inheritable.nLength             = sizeof(inheritable);
+	inheritable.bInheritHandle      = TRUE;
+
+	const auto null_device = CreateFileA("NUL",
+	                                     GENERIC_READ | GENERIC_WRITE,
+	                                     FILE_SHARE_READ | FILE_SHARE_WRITE,
+	                                     &inheritable,
+	                                     OPEN_EXISTING,
+	                                     0,
+	                                     nullptr);
+
+	HANDLE pipe_read  = nullptr;
+	HANDLE pipe_write = nullptr;
+	if (with_input) {
+		if (!CreatePipe(&pipe_read, &pipe_write, &inheritable, 0)) {
+			CloseHandle(null_device);
+			return {};
+		}
+		// Only the read end goes to FFmpeg
+		SetHandleInformation(pipe_write, HANDLE_FLAG_INHERIT, 0);
+	}
+
+	STARTUPINFOA startup_info = {};
+	startup_info.cb           = sizeof(startup_info);
+	startup_info.dwFlags      = STARTF_USESTDHANDLES;
+	startup_info.hStdInput    = with_input ? pipe_read : null_device;
+	startup_info.hStdOutput   = null_device;
+	startup_info.hStdError    = is_quiet ? null_device
+	                                     : GetStdHandle(STD_ERROR_HANDLE);
+
+	PROCESS_INFORMATION process_information = {};
+
+	const auto is_started = CreateProcessA(nullptr,
+	                                       command_line.data(),
+	                                       nullptr,
+	                                       nullptr,
+	                                       TRUE,
+	                                       CREATE_NO_WINDOW,
+	                                       nullptr,
+	                                       nullptr,
+	                                       &startup_info,
+	                                       &process_information);
+	CloseHandle(null_device);
+	if (with_input) {
+		CloseHandle(pipe_read);
+	}
+	if (!is_started) {
+		if (with_input) {
+			CloseHandle(pipe_write);
+		}
+		return {};
+	}
+	CloseHandle(process_information.hThread);
+
+	FfmpegProcess process = {};
+	process.handle        = process_information.hProcess;
+
+	if (with_input) {
+		const auto fd = _open_osfhandle(reinterpret_cast<intptr_t>(pipe_write),
+		                                _O_BINARY);
+		process.input = _fdopen(fd, "wb");
+	}
+	return process;
+}
+
+// Closes the input pipe and waits for FFmpeg to exit; returns true if it
+// succeeded
+static bool wait_for_ffmpeg(FfmpegProcess& process)
+{
+	if (process.input) {
+		fclose(process.input);
+		process.input = nullptr;
+	}
+
+	WaitForSingleObject(process.handle, INFINITE);
+
+	DWORD exit_code = 1;
+	GetExitCodeProcess(process.handle, &exit_code);
+	CloseHandle(process.handle);
+
+	return exit_code == 0;
+}
+
+#else
+
+static std::optional<FfmpegProcess> spawn_ffmpeg(const std::vector<std::string>& args,
+                                                 const bool with_input,
+                                                 const bool is_quiet)
+{
+	const auto argv_strings = make_ffmpeg_argv(args);
+
+	std::vector<char*> argv = {};
+	for (const auto& arg : argv_strings) {
+		argv.push_back(const_cast<char*>(arg.c_str()));
+	}
+	argv.push_back(nullptr);
+
+	// Both ends are closed on exec, so other child processes don't keep
+	// the pipe open; the read end is duplicated onto FFmpeg's stdin
+	int pipe_fds[2] = {-1, -1};
+	if (with_input) {
+		if (pipe(pipe_fds) != 0) {
+			return {};
+		}
+		fcntl(pipe_fds[0], F_SETFD, FD_CLOEXEC);
+		fcntl(pipe_fds[1], F_SETFD, FD_CLOEXEC);
+	}
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+
+	if (with_input) {
+		posix_spawn_file_actions_adddup2(&actions, pipe_fds[0], STDIN_FILENO);
+	} else {
+		posix_spawn_file_actions_addopen(
+		        &actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+	}
+	posix_spawn_file_actions_addopen(
+	        &actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+	if (is_quiet) {
+		posix_spawn_file_actions_addopen(
+		        &actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+	}
+
+	pid_t pid = 0;
+	const auto result = posix_spawnp(
+	        &pid, argv[0], &actions, nullptr, argv.data(), environ);
+
+	posix_spawn_file_actions_destroy(&actions);
+
+	if (with_input) {
+		close(pipe_fds[0]);
+	}
+	if (result != 0) {
+		if (with_input) {
+			close(pipe_fds[1]);
+		}
+		return {};
+	}
+
+	FfmpegProcess process = {};
+	process.pid           = pid;
+
+	if (with_input) {
+		process.input = fdopen(pipe_fds[1], "w");
+	}
+	return process;
+}
+
+// Closes the input pipe and waits for FFmpeg to exit; returns true if it
+// succeeded
+static bool wait_for_ffmpeg(FfmpegProcess& process)
+{
+	if (process.input) {
+		fclose(process.input);
+		process.input = nullptr;
+	}
+
+	int status = 0;
+	while (waitpid(process.pid, &status, 0) == -1) {
+		if (errno != EINTR) {
+			return false;
+		}
+	}
+	return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+#endif
+
+static bool run_ffmpeg(const std::vector<std::string>& args, const bool is_quiet)
+{
+	auto process = spawn_ffmpeg(args, false, is_quiet);
+	return process && wait_for_ffmpeg(*process);
+}
+
+static std::vector<std::string> concat(std::vector<std::string> a,
+                                       const std::vector<std::string>& b)
+{
+	a.insert(a.end(), b.begin(), b.end());
+	return a;
+}
+
+// Encodes a few synthetic frames to check that both FFmpeg and the hardware
+// encoder are available
+static bool probe_codec(const FfmpegCodec& codec)
+{
+	auto args = concat(codec.global_args,
+	                   {"-f", "lavfi", "-i", "color=size=320x200:rate=70",
+	                    "-frames:v", "3", "-vf", codec.filter, "-c:v", codec.name});
+
+	args = concat(args, codec.codec_args);
+	args = concat(args, {"-f", "null", "-"});
+
+	return run_ffmpeg(args, true);
+}
+
+// FFmpeg encoder names only consist of letters, digits and underscores
+static bool is_valid_codec_name(const std::string& name)
+{
+	if (name.empty()) {
+		return false;
+	}
+	for (const auto c : name) {
+		if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') {
+			return false;
+		}
+	}
+	return true;
+}
+
+static std::optional<FfmpegCodec> find_codec(const std::string& requested)
+{
+	if (requested != "auto") {
+		if (!is_valid_codec_name(requested)) {
+			LOG_WARNING("CAPTURE: Invalid FFmpeg video encoder name '%s'",
+			            requested.c_str());
+			return {};
+		}
+
+		// Unknown codecs are passed to FFmpeg as-is
+		FfmpegCodec codec = {requested};
+		for (const auto& c : HardwareCodecs) {
+			if (requested == c.name) {
+				codec = c;
+			}
+		}
+		if (probe_codec(codec)) {
+			return codec;
+		}
+		return {};
+	}
+
+	for (const auto& codec : HardwareCodecs) {
+		if (probe_codec(codec)) {
+			return codec;
+		}
+	}
+	return {};
+}
+
+void capture_video_ffmpeg_probe(const std::string& codec)
+{
+	if (ffmpeg.probed_codecs.contains(codec)) {
+		return;
+	}
+
+	LOG_MSG("CAPTURE: Looking for the '%s' FFmpeg video encoder", codec.c_str());
+
+	ffmpeg.probed_codecs[codec] =
+	        std::async(std::launch::async, find_codec, codec).share();
+}
+
+bool capture_video_ffmpeg_init(const std::string& codec)
+{
+	capture_video_ffmpeg_probe(codec);
+
+	const auto& probe = ffmpeg.probed_codecs[codec];
+
+	// The probe normally finishes long before a capture is started
+	if (probe.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+		LOG_MSG("CAPTURE: Waiting for the FFmpeg video encoder check to finish");
+	}
+	ffmpeg.codec = probe.get();
+
+	if (ffmpeg.codec) {
+		LOG_MSG("CAPTURE: Using the '%s' FFmpeg video encoder",
+		        ffmpeg.codec->name.c_str());
+	}
+	return ffmpeg.codec.has_value();
+}
+
+void capture_video_ffmpeg_set_frame_dropping(const bool enabled)
+{
+	ffmpeg.drop_frames = enabled;
+}
+
+static std::vector<std::string> mux_args()
+{
+	if (ffmpeg.audio_sample_rate == 0) {
+		return {"-nostdin",
+		        "-i",
+		        ffmpeg.video_path.string(),
+		        "-c",
+		        "copy",
+		        ffmpeg.output_path.string()};
+	}
+	return {"-nostdin",
+	        "-i",
+	        ffmpeg.video_path.string(),
+	        "-f",
+	        "s16le",
+	        "-ar",
+	        std::to_string(ffmpeg.audio_sample_rate),
+	        "-ac",
+	        std::to_string(NumAudioChannels),
+	        "-i",
+	        ffmpeg.audio_path.string(),
+	        "-c:v",
+	        "copy",
+	        "-c:a",
+	        "flac",
+	        ffmpeg.output_path.string()};
+}
+
+// Runs on a worker thread, so stopping the capture doesn't stall the
+// emulation while FFmpeg rewrites the whole file
+static void mux_capture(const std::vector<std::string>& args,
+                        const std_fs::path& output_path,
+                        const std_fs::path& video_path,
+                        const std_fs::path& audio_path)
+{
+	if (!run_ffmpeg(args, false)) {
+		LOG_WARNING("CAPTURE: Can't mux the video and audio into '%s'; "
+		            "they're kept in '%s' and '%s'",
+		            output_path.string().c_str(),
+		            video_path.string().c_str(),
+		            audio_path.string().c_str());
+		return;
+	}
+	std::error_code ec = {};
+	std_fs::remove(video_path, ec);
+	std_fs::remove(audio_path, ec);
+}
+
+static void wait_for_muxer()
+{
+	if (ffmpeg.muxer.valid()) {
+		ffmpeg.muxer.wait();
+	}
+}
+
+void capture_video_ffmpeg_finalise()
+{
+	if (!ffmpeg.encoder_process) {
+		return;
+	}
+
+	// Let the encoder finish writing the queued frames
+	ffmpeg.frame_fifo.Stop();
+	if (ffmpeg.encoder.joinable()) {
+		ffmpeg.encoder.join();
+	}
+
+	if (ffmpeg.num_dropped_total > 0) {
+		LOG_MSG("CAPTURE: Dropped %u video frames because the encoder couldn't keep up",
+		        ffmpeg.num_dropped_total);
+	}
+
+	// Closing the pipe lets FFmpeg flush the encoder
+	const auto encoder_ok = wait_for_ffmpeg(*ffmpeg.encoder_process) &&
+	                        !ffmpeg.has_write_error;
+	ffmpeg.encoder_process.reset();
+
+	fclose(ffmpeg.audio_file);
+	ffmpeg.audio_file = nullptr;
+
+	if (!encoder_ok) {
+		LOG_WARNING("CAPTURE: The FFmpeg video encoder failed; the video is kept in '%s'",
+		            ffmpeg.video_path.string().c_str());
+		return;
+	}
+
+	// Only one capture is muxed at a time
+	wait_for_muxer();
+	ffmpeg.muxer = std::async(std::launch::async,
+	                          mux_capture,
+	                          mux_args(),
+	                          ffmpeg.output_path,
+	                          ffmpeg.video_path,
+	                          ffmpeg.audio_path);
+}
+
+void capture_video_ffmpeg_destroy()
+{
+	wait_for_muxer();
+}
+
+void capture_video_ffmpeg_add_audio_data(const uint32_t sample_rate,
+                                         const uint32_t num_sample_frames,
+                                         const int16_t* sample_frames)
+{
+	if (!ffmpeg.encoder_process) {
+		return;
+	}
+	// The raw PCM stream has a single rate; it only changes if the mixer
+	// is reconfigured, which is rare enough to ignore
+	if (ffmpeg.audio_sample_rate == 0) {
+		ffmpeg.audio_sample_rate = sample_rate;
+	}
+	ffmpeg.audio_buf.insert(ffmpeg.audio_buf.end(),
+	                        sample_frames,
+	                        sample_frames + num_sample_frames * NumAudioChannels);
+}
+
+static const char* to_ffmpeg_pixel_format(const PixelFormat format)
+{
+	switch (format) {
+	case PixelFormat::RGB555_Packed16: return "rgb555le";
+	case PixelFormat::RGB565_Packed16: return "rgb565le";
+
+	// Paletted frames are expanded on the encoder thread, and 24-bit
+	// frames are padded to 32 bits by the raw frame copy
+	default: return "bgr0";
+	}
+}
+
+static void encode_queued_frames();
+
+static void start_encoder(const int width, const int height,
+                          const PixelFormat pixel_format,
+                          const float frames_per_second)
+{
+	assert(ffmpeg.codec);
+
+	const auto index = get_next_capture_index(CaptureType::Video);
+
+	const auto base_path = generate_capture_filename(CaptureType::Video, index);
+
+	ffmpeg.output_path = base_path;
+	ffmpeg.output_path.replace_extension(".mkv");
+
+	// The dash keeps the temporary files from bumping the capture index
+	ffmpeg.video_path = base_path;
+	ffmpeg.video_path.replace_filename(base_path.stem().string() + "-video.mkv");
+
+	ffmpeg.audio_path = base_path;
+	ffmpeg.audio_path.replace_filename(base_path.stem().string() + "-audio.pcm");
+
+	ffmpeg.audio_file = open_file(ffmpeg.audio_path.string().c_str(), "wb");
+	if (!ffmpeg.audio_file) {
+		LOG_WARNING("CAPTURE: Failed to create file '%s' for capturing video output",
+		            ffmpeg.audio_path.string().c_str());
+		return;
+	}
+
+	const auto& codec = *ffmpeg.codec;
+
+	auto args = concat({"-y"}, codec.global_args);
+
+	const auto size = format_str("%dx%d", width, height);
+	const auto rate = format_str("%.6f", static_cast<double>(frames_per_second));
+
+	args = concat(args,
+	              {"-f", "rawvideo",
+	               "-pix_fmt", to_ffmpeg_pixel_format(pixel_format),
+	               "-s", size,
+	               "-framerate", rate,
+	               "-i", "-",
+	               "-vf", codec.filter,
+	               "-c:v", codec.name});
+
+	args = concat(args, codec.codec_args);
+	args.push_back(ffmpeg.video_path.string());
+
+#if !defined(WIN32)
+	// Writing into the pipe of a crashed FFmpeg process must fail instead
+	// of terminating the emulator
+	signal(SIGPIPE, SIG_IGN);
+#endif
+
+	ffmpeg.encoder_process = spawn_ffmpeg(args, true, false);
+	if (!ffmpeg.encoder_process || !ffmpeg.encoder_process->input) {
+		LOG_WARNING("CAPTURE: Can't start the FFmpeg video encoder");
+		if (ffmpeg.encoder_process) {
+			wait_for_ffmpeg(*ffmpeg.encoder_process);
+			ffmpeg.encoder_process.reset();
+		}
+		fclose(ffmpeg.audio_file);
+		ffmpeg.audio_file = nullptr;
+		return;
+	}
+
+	LOG_MSG("CAPTURE: Capturing video output to '%s'",
+	        ffmpeg.output_path.string().c_str());
+
+	ffmpeg.width             = width;
+	ffmpeg.height            = height;
+	ffmpeg.pixel_format      = pixel_format;
+	ffmpeg.frames_per_second = frames_per_second;
+
+	ffmpeg.audio_buf.clear();
+	ffmpeg.audio_sample_rate = 0;
+	ffmpeg.prev_frame.clear();
+	ffmpeg.has_write_error = false;
+
+	ffmpeg.num_dropped       = 0;
+	ffmpeg.num_dropped_total = 0;
+
+	ffmpeg.frame_fifo.Start();
+	ffmpeg.encoder = std::thread(encode_queued_frames);
+	set_thread_name(ffmpeg.encoder, "dosbox:vidcap");
+}
+
+// Runs on the encoder thread
+static void write_to_encoder(const void* data, const size_t num_bytes)
+{
+	if (ffmpeg.has_write_error) {
+		return;
+	}
+	if (fwrite(data, 1, num_bytes, ffmpeg.encoder_process->input) != num_bytes) {
+		LOG_WARNING("CAPTURE: The FFmpeg video encoder stopped accepting frames");
+		ffmpeg.has_write_error = true;
+	}
+}
+
+// Runs on the encoder thread
+static void encode_frame(const VideoCaptureFrame& frame)
+{
+	// Paletted pixels are expanded to BGRX; the other formats are passed on
+	// as they are
+	if (ffmpeg.pixel_format == PixelFormat::Indexed8) {
+		ffmpeg.out_buf.resize(frame.pixels.size() * 4);
+
+		auto out = ffmpeg.out_buf.data();
+		for (const auto index : frame.pixels) {
+			const auto color = &frame.palette[index * 4];
+
+			out[0] = color[2];
+			out[1] = color[1];
+			out[2] = color[0];
+			out[3] = 0;
+			out += 4;
+		}
+	} else {
+		ffmpeg.out_buf = frame.pixels;
+	}
+
+	// Repeating the previous frame in place of the dropped ones keeps the
+	// video in sync with the audio
+	for (uint32_t i = 0; i < frame.num_dropped_before; ++i) {
+		write_to_encoder(ffmpeg.prev_frame.data(), ffmpeg.prev_frame.size());
+	}
+	write_to_encoder(ffmpeg.out_buf.data(), ffmpeg.out_buf.size());
+
+	std::swap(ffmpeg.prev_frame, ffmpeg.out_buf);
+
+	if (!frame.audio.empty()) {
+		fwrite(frame.audio.data(),
+		       sizeof(int16_t),
+		       frame.audio.size(),
+		       ffmpeg.audio_file);
+	}
+}
+
+static void encode_queued_frames()
+{
+	while (auto frame = ffmpeg.frame_fifo.Dequeue()) {
+		encode_frame(*frame);
+
+		std::lock_guard lock(ffmpeg.pool_mutex);
+		ffmpeg.frame_pool.emplace_back(std::move(*frame));
+	}
+}
+
+static VideoCaptureFrame get_pooled_frame()
+{
+	std::lock_guard lock(ffmpeg.pool_mutex);
+
+	if (ffmpeg.frame_pool.empty()) {
+		return {};
+	}
+
+	auto frame = std::move(ffmpeg.frame_pool.back());
+	ffmpeg.frame_pool.pop_back();
+	return frame;
+}
+
+void capture_video_ffmpeg_add_frame(const RenderedImage& image,
+                                    const float frames_per_second)
+{
+	const auto& src = image.params;
+
+	const auto raw_width  = src.width / (src.rendered_pixel_doubling ? 2 : 1);
+	const auto raw_height = src.height / (src.rendered_double_scan ? 2 : 1);
+
+	// Start a new file if the video mode changes
+	if (ffmpeg.encoder_process &&
+	    (ffmpeg.width != raw_width || ffmpeg.height != raw_height ||
+	     ffmpeg.pixel_format != src.pixel_format ||
+	     ffmpeg.frames_per_second != frames_per_second)) {
+		capture_video_ffmpeg_finalise();
+	}
+
+	if (!ffmpeg.encoder_process) {
+		start_encoder(raw_width, raw_height, src.pixel_format, frames_per_second);
+	}
+	if (!ffmpeg.encoder_process) {
+		return;
+	}
+
+	// We're the only producer, so the queue can't fill up in between. The
+	// audio keeps accumulating for the next frame.
+	if (ffmpeg.drop_frames && ffmpeg.frame_fifo.IsFull()) {
+		++ffmpeg.num_dropped;
+		++ffmpeg.num_dropped_total;
+		return;
+	}
+
+	auto frame = get_pooled_frame();
+
+	capture_video_copy_raw_frame(image, frame.pixels);
+
+	if (src.pixel_format == PixelFormat::Indexed8) {
+		for (auto i = 0; i < NumVgaColors; ++i) {
+			const auto color = image.palette[i];
+
+			frame.palette[i * 4]     = color.red;
+			frame.palette[i * 4 + 1] = color.green;
+			frame.palette[i * 4 + 2] = color.blue;
+		}
+	}
+
+	frame.audio.assign(ffmpeg.audio_buf.begin(), ffmpeg.audio_buf.end());
+	ffmpeg.audio_buf.clear();
+
+	frame.num_dropped_before = ffmpeg.num_dropped;
+	ffmpeg.num_dropped       = 0;
+
+	ffmpeg.frame_fifo.Enqueue(std::move(frame));
+}
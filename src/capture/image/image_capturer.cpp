@@ -13,12 +13,13 @@
 
 CHECK_NARROWING();
 
-ImageCapturer::ImageCapturer(const std::string& grouped_mode_prefs)
+ImageCapturer::ImageCapturer(const std::string& grouped_mode_prefs,
+                             const int compression_level)
 {
 	ConfigureGroupedMode(grouped_mode_prefs);
 
 	for (auto& image_saver : image_savers) {
-		image_saver.Open();
+		image_saver.Open(compression_level);
 	}
 
 	LOG_MSG("CAPTURE: Image capturer started");
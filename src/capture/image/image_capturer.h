@@ -40,7 +40,8 @@
 class ImageCapturer {
 public:
 	ImageCapturer() = default;
-	ImageCapturer(const std::string& grouped_mode_prefs);
+	ImageCapturer(const std::string& grouped_mode_prefs,
+	              const int compression_level);
 
 	~ImageCapturer();
 
@@ -13,6 +13,7 @@
 #include "hardware/video/vga.h"
 #include "misc/image_decoder.h"
 #include "misc/support.h"
+#include "misc/tracing.h"
 #include "png_writer.h"
 #include "utils/bgrx8888.h"
 #include "utils/checks.h"
@@ -24,12 +25,14 @@ ImageSaver::~ImageSaver()
 	Close();
 }
 
-void ImageSaver::Open()
+void ImageSaver::Open(const int _compression_level)
 {
 	if (is_open) {
 		Close();
 	}
 
+	compression_level = _compression_level;
+
 	const auto worker_function = std::bind(&ImageSaver::SaveQueuedImages, this);
 	renderer = std::thread(worker_function);
 	set_thread_name(renderer, "dosbox:imgcap");
@@ -70,6 +73,8 @@ void ImageSaver::QueueImage(const RenderedImage& image, const CapturedImageType
 
 void ImageSaver::SaveQueuedImages()
 {
+	TRACE_THREAD_NAME("Image capture");
+
 	while (auto task = image_fifo.Dequeue()) {
 		SaveImage(*task);
 		task->image.free();
@@ -88,6 +93,8 @@ static CaptureType to_capture_type(const CapturedImageType type)
 
 void ImageSaver::SaveImage(const SaveImageTask& task)
 {
+	TRACE_SCOPE("Save image");
+
 	CaptureType capture_type = to_capture_type(task.image_type);
 
 	outfile = CAPTURE_CreateFile(capture_type, task.path);
@@ -106,7 +113,7 @@ void ImageSaver::SaveImage(const SaveImageTask& task)
 
 void ImageSaver::SaveRawImage(const RenderedImage& image)
 {
-	PngWriter png_writer = {};
+	PngWriter png_writer(compression_level);
 
 	const auto& src = image.params;
 
@@ -180,7 +187,7 @@ static constexpr auto SquarePixelAspectRatio = Fraction{1};
 
 void ImageSaver::SaveUpscaledImage(const RenderedImage& image)
 {
-	PngWriter png_writer = {};
+	PngWriter png_writer(compression_level);
 
 	image_scaler.Init(image);
 
@@ -219,7 +226,7 @@ void ImageSaver::SaveUpscaledImage(const RenderedImage& image)
 
 void ImageSaver::SaveRenderedImage(const RenderedImage& image)
 {
-	PngWriter png_writer = {};
+	PngWriter png_writer(compression_level);
 
 	const auto& src = image.params;
 
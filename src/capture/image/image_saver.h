@@ -51,6 +51,8 @@ struct SaveImageTask {
 // stored full images (the intermediary 32-bit float linear RGB buffer, plus
 // the final RBG888 output buffer). With the row-based approach, the memory
 // requirement is only 13K (!) and we get much better cache utilisation.
+// The exception is large upscaled images that the image scaler processes in
+// parallel; it then holds the distinct output rows (a few MB at most).
 //
 // Also, we're running multiple image capture worker threads in parallel, so
 // that would add a multiplier to the memory usage.
@@ -60,7 +62,8 @@ public:
 	ImageSaver() = default;
 	~ImageSaver();
 
-	void Open();
+	// Compression level of the saved PNG images from 0 (none) to 9 (best)
+	void Open(const int compression_level);
 	void Close();
 
 	// IMPORTANT: The capturer _frees_ the passed in RenderedImage after the
@@ -91,6 +94,8 @@ private:
 	std::thread renderer = {};
 	bool is_open         = false;
 
+	int compression_level = 0;
+
 	ImageScaler image_scaler = {};
 
 	std::vector<uint32_t> row_decode_buf = {};
@@ -3,38 +3,42 @@
 
 #include "image_scaler.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <thread>
 
 #include "hardware/video/vga.h"
 #include "misc/support.h"
+#include "simde/x86/sse2.h"
 #include "utils/bgrx8888.h"
 #include "utils/byteorder.h"
 #include "utils/checks.h"
 #include "utils/math_utils.h"
+#include "utils/mem_host.h"
 #include "utils/rgb.h"
 
 CHECK_NARROWING();
 
 // #define DEBUG_IMAGE_SCALER
 
-void ImageScaler::Init(const RenderedImage& image)
-{
-	input = image;
+// Images with less distinct output data than this per thread are scaled row
+// by row on the calling thread
+constexpr size_t MinBytesPerBand = 1024 * 1024;
+constexpr unsigned MaxNumBands   = 8;
 
+static int get_row_skip_count(const RenderedImage& image)
+{
 	// To reconstruct the raw image, we must skip every second row when
 	// dealing with "baked-in" double scanning. "De-double-scanning" VGA
 	// images has the beneficial side effect that we can use finer vertical
 	// integer scaling steps, so it's worthwhile doing it.
-	const auto row_skip_count = (image.params.rendered_double_scan ? 1 : 0);
-
-	// "Baked-in" pixel doubling is only used for the 160x200 16-colour
-	// Tandy/PCjr modes. We wouldn't gain anything by reconstructing the raw
-	// 160-pixel-wide image when upscaling, so we'll just leave it be.
-	const auto pixel_skip_count = 0;
+	return image.params.rendered_double_scan ? 1 : 0;
+}
 
-	input_decoder = std::make_unique<ImageDecoder>(image,
-	                                               row_skip_count,
-	                                               pixel_skip_count);
+void ImageScaler::Init(const RenderedImage& image)
+{
+	input = image;
 
 	UpdateOutputParamsUpscale();
 
@@ -46,6 +50,85 @@ void ImageScaler::Init(const RenderedImage& image)
 	LogParams();
 
 	AllocateBuffers();
+
+	if (const auto num_bands = GetNumBands(); num_bands > 1) {
+		ScaleImageInBands(num_bands);
+	} else {
+		scaled_rows.clear();
+		InitRowContext(row_context, 0);
+	}
+}
+
+void ImageScaler::InitRowContext(RowContext& context, const int first_row) const
+{
+	// "Baked-in" pixel doubling is only used for the 160x200 16-colour
+	// Tandy/PCjr modes. We wouldn't gain anything by reconstructing the raw
+	// 160-pixel-wide image when upscaling, so we'll just leave it be.
+	const auto pixel_skip_count = 0;
+
+	context.decoder = std::make_unique<ImageDecoder>(input,
+	                                                 get_row_skip_count(input),
+	                                                 pixel_skip_count);
+	context.decoder->SkipRows(first_row);
+
+	const auto width = static_cast<size_t>(input.params.width);
+
+	context.decode_buf_8.resize(width);
+	context.decode_buf_32.resize(width);
+
+	// Pad by 1 pixel at the end so we can handle the last pixel of the row
+	// without branching (the interpolator operates on the current and the
+	// next pixel).
+	context.linear_row_buf.assign((width + 1) * ComponentsPerRgbPixel, 0.0f);
+}
+
+int ImageScaler::GetNumBands() const
+{
+	const auto num_rows = static_cast<size_t>(output.height / output.vert_scale);
+	const auto num_bytes = static_cast<size_t>(output.row_bytes) * num_rows;
+
+	const auto num_threads = std::min(std::thread::hardware_concurrency(),
+	                                  MaxNumBands);
+
+	return static_cast<int>(
+	        std::min(static_cast<size_t>(num_threads), num_bytes / MinBytesPerBand));
+}
+
+void ImageScaler::ScaleImageInBands(const int num_bands)
+{
+	// The vertical scaling is integral, so each distinct row only needs to
+	// be scaled once
+	assert(output.vert_scaling_mode == PerAxisScaling::Integer);
+
+	const auto num_rows  = output.height / output.vert_scale;
+	const auto row_bytes = static_cast<size_t>(output.row_bytes);
+
+	// One spare byte for the overlapping stores of the last RGB pixel
+	scaled_rows.resize(row_bytes * static_cast<size_t>(num_rows) + 1);
+
+	auto scale_band = [&](const int band) {
+		const auto first_row = num_rows * band / num_bands;
+		const auto last_row  = num_rows * (band + 1) / num_bands;
+
+		RowContext context = {};
+		InitRowContext(context, first_row);
+
+		for (auto row = first_row; row < last_row; ++row) {
+			ScaleNextRow(context,
+			             scaled_rows.data() + row_bytes * static_cast<size_t>(row));
+		}
+	};
+
+	std::vector<std::thread> threads = {};
+	for (auto band = 1; band < num_bands; ++band) {
+		threads.emplace_back(scale_band, band);
+		set_thread_name(threads.back(), "dosbox:imgscale");
+	}
+	scale_band(0);
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
 }
 
 static bool is_integer(const float f)
@@ -208,19 +291,17 @@ void ImageScaler::LogParams()
 
 void ImageScaler::AllocateBuffers()
 {
-	// Pad by 1 pixel at the end so we can handle the last pixel of the row
-	// without branching (the interpolator operates on the current and the
-	// next pixel).
-	linear_row_buf.resize((input.params.width + 1u) * ComponentsPerRgbPixel);
-
 	int bytes_per_pixel = {};
 	switch (output.pixel_format) {
-	case OutputPixelFormat::Indexed8: bytes_per_pixel = 8; break;
-	case OutputPixelFormat::Rgb888: bytes_per_pixel = 24; break;
+	case OutputPixelFormat::Indexed8: bytes_per_pixel = 1; break;
+	case OutputPixelFormat::Rgb888: bytes_per_pixel = ComponentsPerRgbPixel; break;
 	default: assertm(false, "Unsupported OutputPixelFormat");
 	}
 
-	output.row_buf.resize(output.width * bytes_per_pixel);
+	output.row_bytes = output.width * bytes_per_pixel;
+
+	// One spare byte for the overlapping stores of the last RGB pixel
+	output.row_buf.resize(static_cast<size_t>(output.row_bytes) + 1);
 }
 
 int ImageScaler::GetOutputWidth() const
@@ -238,15 +319,13 @@ OutputPixelFormat ImageScaler::GetOutputPixelFormat() const
 	return output.pixel_format;
 }
 
-void ImageScaler::DecodeNextRowToLinearRgb()
+void ImageScaler::DecodeNextRowToLinearRgb(RowContext& context) const
 {
-	row_decode_buf_32.resize(input.params.width);
-
-	input_decoder->GetNextRowAsBgrx32Pixels(row_decode_buf_32.begin());
+	context.decoder->GetNextRowAsBgrx32Pixels(context.decode_buf_32.begin());
 
-	auto out = linear_row_buf.begin();
+	auto out = context.linear_row_buf.begin();
 
-	for (const auto pixel : row_decode_buf_32) {
+	for (const auto pixel : context.decode_buf_32) {
 		const auto color = Bgrx8888(pixel);
 
 		*(out + 0) = srgb8_to_linear_lut(color.Red());
@@ -268,50 +347,117 @@ void ImageScaler::SetRowRepeat()
 	}
 }
 
-void ImageScaler::GenerateNextIntegerUpscaledOutputRow()
+// Repeats each pixel `scale` times. Doubling and quadrupling, the most common
+// factors, interleave 16 pixels at a time with themselves.
+static void upscale_indexed8_row(const uint8_t* in, const int width,
+                                 const int scale, uint8_t* out)
 {
-	auto out = output.row_buf.begin();
-
-	if (input.is_paletted()) {
-		row_decode_buf_8.resize(input.params.width);
+	auto store = [&](const simde__m128i v) {
+		simde_mm_storeu_si128(reinterpret_cast<simde__m128i*>(out), v);
+		out += 16;
+	};
 
-		input_decoder->GetNextRowAsIndexed8Pixels(row_decode_buf_8.begin());
+	auto x = 0;
+	if (scale == 2 || scale == 4) {
+		for (; x + 16 <= width; x += 16) {
+			const auto pixels = simde_mm_loadu_si128(
+			        reinterpret_cast<const simde__m128i*>(in + x));
 
-		for (const auto pixel : row_decode_buf_8) {
-			auto pixels_to_write = iround(output.horiz_scale);
+			const auto lo = simde_mm_unpacklo_epi8(pixels, pixels);
+			const auto hi = simde_mm_unpackhi_epi8(pixels, pixels);
 
-			while (pixels_to_write--) {
-				*out = pixel;
-				++out;
+			if (scale == 2) {
+				store(lo);
+				store(hi);
+			} else {
+				store(simde_mm_unpacklo_epi8(lo, lo));
+				store(simde_mm_unpackhi_epi8(lo, lo));
+				store(simde_mm_unpacklo_epi8(hi, hi));
+				store(simde_mm_unpackhi_epi8(hi, hi));
 			}
 		}
+	}
+	for (; x < width; ++x) {
+		std::memset(out, in[x], static_cast<size_t>(scale));
+		out += scale;
+	}
+}
 
-	} else { // Bgrx32
-		row_decode_buf_32.resize(input.params.width);
+// Converts each BGRX pixel to RGB888 and repeats it `scale` times. The
+// pixels are written with overlapping 4-byte stores, so one byte past the
+// end of the row is overwritten.
+static void upscale_bgrx32_row(const uint32_t* in, const int width,
+                               const int scale, uint8_t* out)
+{
+	auto write_pixels = [&](const uint32_t rgb) {
+		for (auto n = 0; n < scale; ++n) {
+			host_writed(out, rgb);
+			out += 3;
+		}
+	};
 
-		input_decoder->GetNextRowAsBgrx32Pixels(row_decode_buf_32.begin());
+	const auto component_mask = simde_mm_set1_epi32(0xff);
+	const auto green_mask     = simde_mm_set1_epi32(0xff00);
 
-		for (const auto pixel : row_decode_buf_32) {
-			const auto color     = Bgrx8888(pixel);
-			auto pixels_to_write = iround(output.horiz_scale);
+	auto x = 0;
+	for (; x + 4 <= width; x += 4) {
+		const auto pixels = simde_mm_loadu_si128(
+		        reinterpret_cast<const simde__m128i*>(in + x));
 
-			while (pixels_to_write--) {
-				*(out + 0) = color.Red();
-				*(out + 1) = color.Green();
-				*(out + 2) = color.Blue();
+		// Swap the red and blue components so red ends up in the lowest
+		// byte, and drop the unused top byte
+		const auto red = simde_mm_and_si128(simde_mm_srli_epi32(pixels, 16),
+		                                    component_mask);
 
-				out += 3;
-			}
+		const auto green = simde_mm_and_si128(pixels, green_mask);
+
+		const auto blue = simde_mm_slli_epi32(simde_mm_and_si128(pixels,
+		                                                         component_mask),
+		                                      16);
+
+		alignas(16) uint32_t rgb[4];
+		simde_mm_store_si128(reinterpret_cast<simde__m128i*>(rgb),
+		                     simde_mm_or_si128(simde_mm_or_si128(red, green), blue));
+
+		for (const auto pixel : rgb) {
+			write_pixels(pixel);
 		}
 	}
+	for (; x < width; ++x) {
+		const auto color = Bgrx8888(in[x]);
+		write_pixels(static_cast<uint32_t>(color.Red()) |
+		             static_cast<uint32_t>(color.Green() << 8) |
+		             static_cast<uint32_t>(color.Blue() << 16));
+	}
+}
 
-	SetRowRepeat();
+void ImageScaler::GenerateNextIntegerUpscaledOutputRow(RowContext& context,
+                                                       uint8_t* out) const
+{
+	const auto scale = iround(output.horiz_scale);
+
+	if (input.is_paletted()) {
+		context.decoder->GetNextRowAsIndexed8Pixels(context.decode_buf_8.begin());
+
+		upscale_indexed8_row(context.decode_buf_8.data(),
+		                     input.params.width,
+		                     scale,
+		                     out);
+
+	} else { // Bgrx32
+		context.decoder->GetNextRowAsBgrx32Pixels(context.decode_buf_32.begin());
+
+		upscale_bgrx32_row(context.decode_buf_32.data(),
+		                   input.params.width,
+		                   scale,
+		                   out);
+	}
 }
 
-void ImageScaler::GenerateNextSharpUpscaledOutputRow()
+void ImageScaler::GenerateNextSharpUpscaledOutputRow(const RowContext& context,
+                                                     uint8_t* out) const
 {
-	auto row_start = linear_row_buf.begin();
-	auto out       = output.row_buf.begin();
+	auto row_start = context.linear_row_buf.begin();
 
 	for (auto x = 0; x < output.width; ++x) {
 		const auto x0 = static_cast<float>(x) * output.one_per_horiz_scale;
@@ -354,8 +500,19 @@ void ImageScaler::GenerateNextSharpUpscaledOutputRow()
 
 		out += 3;
 	}
+}
+
+void ImageScaler::ScaleNextRow(RowContext& context, uint8_t* out) const
+{
+	if (output.horiz_scaling_mode == PerAxisScaling::Integer &&
+	    output.vert_scaling_mode == PerAxisScaling::Integer) {
 
-	SetRowRepeat();
+		GenerateNextIntegerUpscaledOutputRow(context, out);
+
+	} else {
+		DecodeNextRowToLinearRgb(context);
+		GenerateNextSharpUpscaledOutputRow(context, out);
+	}
 }
 
 std::vector<uint8_t>::const_iterator ImageScaler::GetNextOutputRow()
@@ -364,16 +521,18 @@ std::vector<uint8_t>::const_iterator ImageScaler::GetNextOutputRow()
 		return output.row_buf.end();
 	}
 
-	if (output.row_repeat == 0) {
-		if (output.horiz_scaling_mode == PerAxisScaling::Integer &&
-		    output.vert_scaling_mode == PerAxisScaling::Integer) {
+	// Serve the rows scaled up front, each repeated by the vertical
+	// scaling factor
+	if (!scaled_rows.empty()) {
+		const auto row = output.curr_row / output.vert_scale;
+		++output.curr_row;
 
-			GenerateNextIntegerUpscaledOutputRow();
+		return scaled_rows.cbegin() + static_cast<ptrdiff_t>(row) * output.row_bytes;
+	}
 
-		} else {
-			DecodeNextRowToLinearRgb();
-			GenerateNextSharpUpscaledOutputRow();
-		}
+	if (output.row_repeat == 0) {
+		ScaleNextRow(row_context, output.row_buf.data());
+		SetRowRepeat();
 	} else {
 		--output.row_repeat;
 	}
@@ -4,6 +4,7 @@
 #ifndef DOSBOX_IMAGE_SCALER_H
 #define DOSBOX_IMAGE_SCALER_H
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -33,6 +34,11 @@ enum class PerAxisScaling { Integer, Fractional };
 // The scaling is always performed on the "raw", non-double-scanned and
 // non-pixel-doubled input image.
 //
+// Small images are scaled one row at a time as the output rows are requested.
+// Large ones are scaled up front in horizontal bands on multiple threads into
+// a buffer holding one copy of each distinct output row (the vertical scaling
+// is always integral, so the rows are repeated on output).
+//
 // A few examples:
 //
 //      320x200  - upscaled to 1600x1200 (5:6 scaling factors)
@@ -80,25 +86,47 @@ public:
 private:
 	static constexpr auto ComponentsPerRgbPixel = 3;
 
+	// Decoder and work buffers for scaling input rows; every band of rows
+	// that's scaled in parallel has its own
+	struct RowContext {
+		std::unique_ptr<ImageDecoder> decoder = {};
+
+		std::vector<uint8_t> decode_buf_8   = {};
+		std::vector<uint32_t> decode_buf_32 = {};
+
+		std::vector<float> linear_row_buf = {};
+	};
+
 	void UpdateOutputParamsDoublingOnly();
 	void UpdateOutputParamsUpscale();
 	void LogParams();
 	void AllocateBuffers();
 
-	void DecodeNextRowToLinearRgb();
+	void InitRowContext(RowContext& context, const int first_row) const;
+
+	void DecodeNextRowToLinearRgb(RowContext& context) const;
 
 	void SetRowRepeat();
 
-	void GenerateNextIntegerUpscaledOutputRow();
-	void GenerateNextSharpUpscaledOutputRow();
+	void ScaleNextRow(RowContext& context, uint8_t* out) const;
 
-	RenderedImage input                         = {};
-	std::unique_ptr<ImageDecoder> input_decoder = {};
+	void GenerateNextIntegerUpscaledOutputRow(RowContext& context,
+	                                          uint8_t* out) const;
 
-	std::vector<uint8_t> row_decode_buf_8   = {};
-	std::vector<uint32_t> row_decode_buf_32 = {};
+	void GenerateNextSharpUpscaledOutputRow(const RowContext& context,
+	                                        uint8_t* out) const;
 
-	std::vector<float> linear_row_buf = {};
+	int GetNumBands() const;
+	void ScaleImageInBands(const int num_bands);
+
+	RenderedImage input = {};
+
+	// Used when scaling row by row
+	RowContext row_context = {};
+
+	// Holds each distinct output row when the image is scaled up front;
+	// empty otherwise
+	std::vector<uint8_t> scaled_rows = {};
 
 	struct {
 		int width  = 0;
@@ -112,6 +140,9 @@ private:
 
 		OutputPixelFormat pixel_format = {};
 
+		// Bytes in an output row
+		int row_bytes = 0;
+
 		int curr_row   = 0;
 		int row_repeat = 0;
 
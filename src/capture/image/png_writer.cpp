@@ -3,7 +3,11 @@
 
 #include "png_writer.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
 
 #include <zlib.h>
 
@@ -14,6 +18,27 @@
 
 CHECK_NARROWING();
 
+// Compress in parallel only if every stripe gets at least this much image
+// data (e.g., 1920x1080 RGB is split into up to five stripes)
+constexpr size_t MinBytesPerStripe = 1024 * 1024;
+constexpr unsigned MaxNumStripes   = 8;
+
+// Size of the deflate window; each stripe is primed with the end of the
+// previous one to keep the compression ratio close to a single stream
+constexpr int WindowBits       = 15;
+constexpr size_t WindowSize    = size_t(1) << WindowBits;
+constexpr int DeflateMemLevel  = 8;
+constexpr size_t MaxIdatLength = 256 * 1024;
+
+constexpr auto NumPngFilters = 5;
+
+PngWriter::PngWriter(const int _compression_level)
+        : compression_level(_compression_level)
+{
+	assert(compression_level >= Z_NO_COMPRESSION &&
+	       compression_level <= Z_BEST_COMPRESSION);
+}
+
 PngWriter::~PngWriter()
 {
 	FinalisePng();
@@ -86,11 +111,10 @@ void PngWriter::SetPngCompressionsParams()
 {
 	assert(png_ptr);
 
-	// Default compression (equal to level 6) is the sweet spot between
-	// speed and compression. Z_BEST_COMPRESSION (level 9) rarely results in
-	// smaller file sizes, but makes the compression significantly slower
-	// (by several folds).
-	png_set_compression_level(png_ptr, Z_DEFAULT_COMPRESSION);
+	// The default level 6 is the sweet spot between speed and compression.
+	// Z_BEST_COMPRESSION (level 9) rarely results in smaller file sizes,
+	// but makes the compression significantly slower (by several folds).
+	png_set_compression_level(png_ptr, compression_level);
 
 	// Larger buffer sizes (e.g. 64K or 128K) could significantly speed up
 	// decompression, but not compression.
@@ -221,11 +245,32 @@ void PngWriter::WritePngInfo(const int width, const int height,
 #endif
 
 	png_write_info(png_ptr, png_info_ptr);
+
+	bytes_per_pixel = is_paletted ? 1 : 3;
+	row_bytes       = static_cast<size_t>(width) * bytes_per_pixel;
+
+	const auto image_size  = row_bytes * static_cast<size_t>(height);
+	const auto num_threads = std::min(std::thread::hardware_concurrency(),
+	                                  MaxNumStripes);
+
+	num_stripes = std::min(static_cast<size_t>(num_threads),
+	                       image_size / MinBytesPerStripe);
+
+	if (num_stripes > 1) {
+		image_bytes.reserve(image_size);
+	} else {
+		num_stripes = 0;
+	}
 }
 
 void PngWriter::WriteRow(std::vector<uint8_t>::const_iterator row)
 {
 	assert(png_ptr);
+
+	if (num_stripes > 0) {
+		image_bytes.insert(image_bytes.end(), row, row + static_cast<ptrdiff_t>(row_bytes));
+		return;
+	}
 	png_write_row(png_ptr, const_cast<png_bytep>(std::to_address(row)));
 }
 
@@ -233,7 +278,242 @@ void PngWriter::FinalisePng()
 {
 	assert(png_ptr);
 
+	if (num_stripes > 0) {
+		WriteParallelCompressedImage();
+		return;
+	}
+
 	const png_infop end_info_ptr = nullptr;
 	png_write_end(png_ptr, end_info_ptr);
 }
 
+// Runs 'task' with the indices 0 to 'num_tasks - 1' on separate threads and
+// waits for all of them to finish
+template <typename Task>
+static void run_in_parallel(const size_t num_tasks, Task task)
+{
+	std::vector<std::thread> threads = {};
+
+	for (size_t i = 1; i < num_tasks; ++i) {
+		threads.emplace_back(task, i);
+		set_thread_name(threads.back(), "dosbox:pngzip");
+	}
+	task(0);
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+
+static uint8_t paeth_predictor(const int a, const int b, const int c)
+{
+	const auto p  = a + b - c;
+	const auto pa = std::abs(p - a);
+	const auto pb = std::abs(p - b);
+	const auto pc = std::abs(p - c);
+
+	if (pa <= pb && pa <= pc) {
+		return static_cast<uint8_t>(a);
+	}
+	return static_cast<uint8_t>(pb <= pc ? b : c);
+}
+
+// Writes the filter type byte and the filtered row to 'out'. Like libpng
+// with PNG_ALL_FILTERS, the filter with the smallest sum of absolute
+// differences wins.
+static void filter_row(const uint8_t* row, const uint8_t* prev_row,
+                       const size_t row_bytes, const size_t bpp,
+                       std::array<std::vector<uint8_t>, NumPngFilters>& candidates,
+                       uint8_t* out)
+{
+	std::array<uint64_t, NumPngFilters> sums = {};
+
+	for (auto& candidate : candidates) {
+		candidate.resize(row_bytes);
+	}
+
+	auto cost = [](const uint8_t value) {
+		return static_cast<uint64_t>(std::abs(static_cast<int8_t>(value)));
+	};
+
+	for (size_t i = 0; i < row_bytes; ++i) {
+		const int x = row[i];
+		const int a = (i >= bpp) ? row[i - bpp] : 0;
+		const int b = prev_row[i];
+		const int c = (i >= bpp) ? prev_row[i - bpp] : 0;
+
+		const uint8_t filtered[NumPngFilters] = {
+		        static_cast<uint8_t>(x),
+		        static_cast<uint8_t>(x - a),
+		        static_cast<uint8_t>(x - b),
+		        static_cast<uint8_t>(x - (a + b) / 2),
+		        static_cast<uint8_t>(x - paeth_predictor(a, b, c))};
+
+		for (auto f = 0; f < NumPngFilters; ++f) {
+			candidates[f][i] = filtered[f];
+			sums[f] += cost(filtered[f]);
+		}
+	}
+
+	const auto best = std::min_element(sums.begin(), sums.end()) - sums.begin();
+
+	out[0] = static_cast<uint8_t>(best);
+	std::memcpy(out + 1, candidates[static_cast<size_t>(best)].data(), row_bytes);
+}
+
+// Compresses a stripe into a raw deflate stream. All but the last stripe end
+// on a byte boundary with a sync flush, so the streams can be concatenated.
+static std::vector<uint8_t> deflate_stripe(const uint8_t* data, const size_t size,
+                                           const uint8_t* dictionary,
+                                           const size_t dictionary_size,
+                                           const int compression_level,
+                                           const bool is_last)
+{
+	z_stream stream = {};
+
+	[[maybe_unused]] auto result = deflateInit2(&stream,
+	                                            compression_level,
+	                                            Z_DEFLATED,
+	                                            -WindowBits,
+	                                            DeflateMemLevel,
+	                                            Z_DEFAULT_STRATEGY);
+	assert(result == Z_OK);
+
+	if (dictionary_size > 0) {
+		deflateSetDictionary(&stream,
+		                     dictionary,
+		                     check_cast<uInt>(dictionary_size));
+	}
+
+	// Leave room for the sync flush marker
+	constexpr auto SyncFlushBytes = 16;
+
+	std::vector<uint8_t> out(deflateBound(&stream, static_cast<uLong>(size)) +
+	                         SyncFlushBytes);
+
+	stream.next_in   = const_cast<Bytef*>(data);
+	stream.avail_in  = check_cast<uInt>(size);
+	stream.next_out  = out.data();
+	stream.avail_out = check_cast<uInt>(out.size());
+
+	result = deflate(&stream, is_last ? Z_FINISH : Z_SYNC_FLUSH);
+	assert(result == (is_last ? Z_STREAM_END : Z_OK));
+	assert(stream.avail_in == 0);
+
+	out.resize(stream.total_out);
+	deflateEnd(&stream);
+
+	return out;
+}
+
+void PngWriter::WriteParallelCompressedImage()
+{
+	assert(row_bytes > 0);
+
+	const auto num_rows       = image_bytes.size() / row_bytes;
+	const auto filtered_pitch = row_bytes + 1;
+
+	auto first_row = [&](const size_t stripe) {
+		return num_rows * stripe / num_stripes;
+	};
+
+	// Filter the rows; every row only depends on the unfiltered rows
+	std::vector<uint8_t> filtered(num_rows * filtered_pitch);
+	const std::vector<uint8_t> zero_row(row_bytes);
+
+	run_in_parallel(num_stripes, [&](const size_t stripe) {
+		std::array<std::vector<uint8_t>, NumPngFilters> candidates = {};
+
+		for (auto y = first_row(stripe); y < first_row(stripe + 1); ++y) {
+			const auto row = image_bytes.data() + y * row_bytes;
+			const auto prev_row = (y > 0) ? row - row_bytes
+			                              : zero_row.data();
+
+			filter_row(row,
+			           prev_row,
+			           row_bytes,
+			           bytes_per_pixel,
+			           candidates,
+			           filtered.data() + y * filtered_pitch);
+		}
+	});
+
+	// Compress the stripes and checksum them
+	std::vector<std::vector<uint8_t>> compressed(num_stripes);
+	std::vector<uLong> checksums(num_stripes);
+
+	run_in_parallel(num_stripes, [&](const size_t stripe) {
+		const auto begin = first_row(stripe) * filtered_pitch;
+		const auto end   = first_row(stripe + 1) * filtered_pitch;
+
+		const auto dictionary_size = std::min(begin, WindowSize);
+
+		compressed[stripe] = deflate_stripe(filtered.data() + begin,
+		                                    end - begin,
+		                                    filtered.data() + begin -
+		                                            dictionary_size,
+		                                    dictionary_size,
+		                                    compression_level,
+		                                    stripe == num_stripes - 1);
+
+		checksums[stripe] = adler32(adler32(0, nullptr, 0),
+		                            filtered.data() + begin,
+		                            check_cast<uInt>(end - begin));
+	});
+
+	// Wrap the raw deflate streams into a single zlib stream
+	std::vector<uint8_t> zlib_stream = {};
+
+	constexpr uint8_t DeflateWithMaxWindow = 0x78;
+
+	const auto level_flags = [&]() -> uint8_t {
+		if (compression_level < 2) {
+			return 0;
+		}
+		if (compression_level < 6) {
+			return 1;
+		}
+		return (compression_level == 6) ? 2 : 3;
+	}();
+
+	auto flags = static_cast<uint8_t>(level_flags << 6);
+	flags = static_cast<uint8_t>(flags + 31 - (DeflateWithMaxWindow * 256 + flags) % 31);
+
+	zlib_stream.push_back(DeflateWithMaxWindow);
+	zlib_stream.push_back(flags);
+
+	auto checksum = adler32(0, nullptr, 0);
+
+	for (size_t stripe = 0; stripe < num_stripes; ++stripe) {
+		zlib_stream.insert(zlib_stream.end(),
+		                   compressed[stripe].begin(),
+		                   compressed[stripe].end());
+
+		const auto begin = first_row(stripe) * filtered_pitch;
+		const auto end   = first_row(stripe + 1) * filtered_pitch;
+
+		checksum = adler32_combine(checksum,
+		                           checksums[stripe],
+		                           check_cast<z_off_t>(end - begin));
+	}
+
+	for (auto shift = 24; shift >= 0; shift -= 8) {
+		zlib_stream.push_back(static_cast<uint8_t>(checksum >> shift));
+	}
+
+	// Write the zlib stream in IDAT chunks and end the file
+	for (size_t pos = 0; pos < zlib_stream.size(); pos += MaxIdatLength) {
+		const auto length = std::min(MaxIdatLength, zlib_stream.size() - pos);
+
+		png_write_chunk(png_ptr,
+		                reinterpret_cast<png_const_bytep>("IDAT"),
+		                zlib_stream.data() + pos,
+		                length);
+	}
+
+	png_write_chunk(png_ptr, reinterpret_cast<png_const_bytep>("IEND"), nullptr, 0);
+	png_write_flush(png_ptr);
+
+	image_bytes.clear();
+}
+
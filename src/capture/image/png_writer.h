@@ -18,9 +18,15 @@
 
 // A row-based PNG writer that also writes the pixel aspect ratio of the image
 // into the standard pHYs PNG chunk.
+//
+// Large images are collected in full instead, then filtered and compressed in
+// stripes on multiple threads when the writer is finalised (in the style of
+// pigz). This trades a full-image buffer for saving high-resolution captures
+// several times faster.
 class PngWriter {
 public:
-	PngWriter() = default;
+	// Compression level from 0 (none) to 9 (best)
+	explicit PngWriter(const int compression_level);
 	~PngWriter();
 
 	bool InitRgb888(FILE* fp, const int width, const int height,
@@ -49,9 +55,18 @@ private:
 	                  const std::array<Rgb888, NumVgaColors>& palette);
 
 	void FinalisePng();
+	void WriteParallelCompressedImage();
 
 	png_structp png_ptr    = nullptr;
 	png_infop png_info_ptr = nullptr;
+
+	int compression_level = 0;
+
+	// Only used when compressing in parallel
+	size_t num_stripes               = 0;
+	size_t row_bytes                 = 0;
+	size_t bytes_per_pixel           = 0;
+	std::vector<uint8_t> image_bytes = {};
 };
 
 #endif
@@ -1,12 +1,36 @@
-// SPDX-FileCopyrightText:  2023-2025 The DOSBox Staging Team
+// SPDX-FileCopyrightText:  2023-2026 The DOSBox Staging Team
 // SPDX-FileCopyrightText:  2002-2021 The DOSBox Team
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #ifndef DOSBOX_CAPTURE_VIDEO_H
 #define DOSBOX_CAPTURE_VIDEO_H
 
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include "gui/render/render.h"
 
+// A raw video frame and the audio captured since the previous frame, handed
+// over to the encoder thread. The buffers are recycled between frames.
+struct VideoCaptureFrame {
+	// Rows of the raw image in the encoder's pixel format, without padding
+	std::vector<uint8_t> pixels = {};
+
+	// Interleaved 16-bit stereo sample frames
+	std::vector<int16_t> audio = {};
+
+	std::array<uint8_t, NumVgaColors * 4> palette = {};
+
+	// Number of frames dropped right before this one because the encoder
+	// couldn't keep up
+	uint32_t num_dropped_before = 0;
+};
+
+// Drop frames instead of waiting for the encoder when it falls behind
+void capture_video_set_frame_dropping(const bool enabled);
+
 void capture_video_add_frame(const RenderedImage& image,
                              const float frames_per_second);
 
@@ -16,4 +40,34 @@ void capture_video_add_audio_data(const uint32_t sample_rate,
 
 void capture_video_finalise();
 
+// Copies the raw image without any "baked-in" doubling into 'dest', in the
+// pixel layout of the ZMBV encoder (8-bit indexed, 15/16-bit packed, or
+// 32-bit BGRX for the 24 and 32-bit formats)
+void capture_video_copy_raw_frame(const RenderedImage& image,
+                                  std::vector<uint8_t>& dest);
+
+// Alternative encoder handing the frames to an external FFmpeg process, so
+// they can be compressed by a hardware video encoder.
+
+// Starts looking for a working FFmpeg encoder in the background
+void capture_video_ffmpeg_probe(const std::string& codec);
+
+// Returns false if no working FFmpeg encoder is found; waits for the probe
+// if it's still running
+bool capture_video_ffmpeg_init(const std::string& codec);
+
+void capture_video_ffmpeg_set_frame_dropping(const bool enabled);
+
+void capture_video_ffmpeg_add_frame(const RenderedImage& image,
+                                    const float frames_per_second);
+
+void capture_video_ffmpeg_add_audio_data(const uint32_t sample_rate,
+                                         const uint32_t num_sample_frames,
+                                         const int16_t* sample_frames);
+
+void capture_video_ffmpeg_finalise();
+
+// Waits for the last capture to be muxed
+void capture_video_ffmpeg_destroy();
+
 #endif
@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_WRITE_BEHIND_FILE_H
+#define DOSBOX_WRITE_BEHIND_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "utils/spsc_queue.h"
+
+// Writes to a file from a background thread through a bounded buffer, so
+// slow storage (e.g., network shares or spun-down disks) doesn't stall the
+// thread producing the data.
+//
+// Writing never blocks: if the data doesn't fit into the buffer, the entire
+// write is dropped and counted instead. Dropping whole writes keeps the file
+// aligned to the writer's record size (e.g., audio frames).
+//
+// Only a single thread may call Write().
+//
+class WriteBehindFile {
+public:
+	WriteBehindFile(FILE* handle, const size_t buffer_size,
+	                const char* thread_name);
+	~WriteBehindFile();
+
+	// Returns false if the data was dropped because the buffer is full
+	bool Write(const void* data, const size_t num_bytes);
+
+	// Waits until all buffered data has been written and stops the
+	// background thread. The file is left open so the caller can update
+	// its headers.
+	void Flush();
+
+	// Number of bytes accepted by Write(), all of which end up in the file
+	uint64_t GetNumBytesWritten() const
+	{
+		return num_bytes_written;
+	}
+
+	uint64_t GetNumBytesDropped() const
+	{
+		return num_bytes_dropped;
+	}
+
+	// prevent copying
+	WriteBehindFile(const WriteBehindFile&) = delete;
+	// prevent assignment
+	WriteBehindFile& operator=(const WriteBehindFile&) = delete;
+
+private:
+	void WriteQueuedData();
+
+	FILE* handle = nullptr;
+
+	SpscQueue<uint8_t> queue;
+	std::thread writer = {};
+
+	// Reused to hand the data to the queue without reallocating
+	std::vector<uint8_t> staging_buf = {};
+
+	uint64_t num_bytes_written = 0;
+	uint64_t num_bytes_dropped = 0;
+};
+
+#endif // DOSBOX_WRITE_BEHIND_FILE_H
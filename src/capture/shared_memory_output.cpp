@@ -0,0 +1,399 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "shared_memory_output.h"
+
+#include <cassert>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "hardware/timer.h"
+#include "misc/image_decoder.h"
+#include "misc/logging.h"
+#include "utils/checks.h"
+#include "utils/string_utils.h"
+
+CHECK_NARROWING();
+
+// Three slots let a reader encode from one slot while the next frame is
+// being written into another
+constexpr uint32_t NumVideoSlots = 3;
+
+// Enough for the largest SVGA modes
+constexpr uint32_t MaxFrameWidth  = 2048;
+constexpr uint32_t MaxFrameHeight = 1536;
+
+// Two seconds at 48 kHz
+constexpr uint32_t AudioCapacityFrames = 96000;
+
+constexpr size_t SlotAlignment = 64;
+
+static size_t align_up(const size_t n)
+{
+	return (n + SlotAlignment - 1) & ~(SlotAlignment - 1);
+}
+
+// A named, read-write shared memory object mapped into our address space
+class SharedMemory {
+public:
+	SharedMemory() = default;
+	~SharedMemory()
+	{
+		Close();
+	}
+
+	SharedMemory(const SharedMemory&)            = delete;
+	SharedMemory& operator=(const SharedMemory&) = delete;
+
+	bool Open(const std::string& _name, const size_t _size)
+	{
+		name = _name;
+		size = _size;
+#if defined(WIN32)
+		const auto object_name = "Local\\" + name;
+
+		const auto size64 = static_cast<uint64_t>(size);
+
+		mapping = CreateFileMappingA(INVALID_HANDLE_VALUE,
+		                             nullptr,
+		                             PAGE_READWRITE,
+		                             static_cast<DWORD>(size64 >> 32),
+		                             static_cast<DWORD>(size64 & 0xffffffff),
+		                             object_name.c_str());
+		if (!mapping) {
+			return false;
+		}
+		data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+		if (!data) {
+			CloseHandle(mapping);
+			mapping = nullptr;
+			return false;
+		}
+#else
+		const auto object_name = "/" + name;
+
+		const auto fd = shm_open(object_name.c_str(), O_CREAT | O_RDWR, 0600);
+		if (fd < 0) {
+			return false;
+		}
+		if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+			close(fd);
+			shm_unlink(object_name.c_str());
+			return false;
+		}
+		auto mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+
+		if (mem == MAP_FAILED) {
+			shm_unlink(object_name.c_str());
+			return false;
+		}
+		data = mem;
+#endif
+		std::memset(data, 0, size);
+		return true;
+	}
+
+	void Close()
+	{
+		if (!data) {
+			return;
+		}
+#if defined(WIN32)
+		UnmapViewOfFile(data);
+		CloseHandle(mapping);
+		mapping = nullptr;
+#else
+		munmap(data, size);
+		shm_unlink(("/" + name).c_str());
+#endif
+		data = nullptr;
+	}
+
+	uint8_t* Data() const
+	{
+		return static_cast<uint8_t*>(data);
+	}
+
+private:
+	std::string name = {};
+	size_t size      = 0;
+	void* data       = nullptr;
+#if defined(WIN32)
+	HANDLE mapping = nullptr;
+#endif
+};
+
+static struct {
+	std::string name = {};
+
+	// Only accessed by the main thread
+	SharedMemory video_memory  = {};
+	ShmVideoHeader* video      = nullptr;
+	size_t video_slot_size     = 0;
+	uint32_t last_slot         = 0;
+	uint64_t num_frames        = 0;
+	bool has_frame             = false;
+	bool has_warned_frame_size = false;
+
+	std::vector<uint32_t> row_buf = {};
+
+	// Guards the audio ring against being closed while the mixer thread
+	// writes into it
+	std::mutex audio_mutex    = {};
+	SharedMemory audio_memory = {};
+	ShmAudioHeader* audio     = nullptr;
+	float* audio_samples      = nullptr;
+} shm = {};
+
+static ShmFrameHeader& get_slot(const uint32_t index)
+{
+	auto base = reinterpret_cast<uint8_t*>(shm.video) +
+	            align_up(sizeof(ShmVideoHeader));
+
+	return *reinterpret_cast<ShmFrameHeader*>(base + index * shm.video_slot_size);
+}
+
+static uint8_t* get_slot_pixels(const uint32_t index)
+{
+	return reinterpret_cast<uint8_t*>(&get_slot(index)) +
+	       align_up(sizeof(ShmFrameHeader));
+}
+
+static bool open_video(const std::string& name)
+{
+	constexpr auto MaxFrameBytes = MaxFrameWidth * MaxFrameHeight * 4;
+
+	shm.video_slot_size = align_up(sizeof(ShmFrameHeader)) + MaxFrameBytes;
+
+	const auto size = align_up(sizeof(ShmVideoHeader)) +
+	                  NumVideoSlots * shm.video_slot_size;
+
+	if (!shm.video_memory.Open(name + "-video", size)) {
+		return false;
+	}
+
+	shm.video = new (shm.video_memory.Data()) ShmVideoHeader();
+
+	shm.video->num_slots       = NumVideoSlots;
+	shm.video->slot_size       = check_cast<uint32_t>(shm.video_slot_size);
+	shm.video->max_frame_bytes = MaxFrameBytes;
+
+	for (uint32_t i = 0; i < NumVideoSlots; ++i) {
+		new (&get_slot(i)) ShmFrameHeader();
+	}
+
+	shm.last_slot  = 0;
+	shm.num_frames = 0;
+	shm.has_frame  = false;
+	return true;
+}
+
+static bool open_audio(const std::string& name)
+{
+	const auto size = align_up(sizeof(ShmAudioHeader)) +
+	                  AudioCapacityFrames * 2 * sizeof(float);
+
+	const std::lock_guard lock(shm.audio_mutex);
+
+	if (!shm.audio_memory.Open(name + "-audio", size)) {
+		return false;
+	}
+
+	shm.audio = new (shm.audio_memory.Data()) ShmAudioHeader();
+
+	shm.audio->capacity_frames = AudioCapacityFrames;
+
+	shm.audio_samples = reinterpret_cast<float*>(
+	        shm.audio_memory.Data() + align_up(sizeof(ShmAudioHeader)));
+	return true;
+}
+
+static void close_all()
+{
+	shm.video = nullptr;
+	shm.video_memory.Close();
+
+	const std::lock_guard lock(shm.audio_mutex);
+	shm.audio         = nullptr;
+	shm.audio_samples = nullptr;
+	shm.audio_memory.Close();
+}
+
+void SHM_OUTPUT_Destroy()
+{
+	if (shm.name.empty()) {
+		return;
+	}
+	close_all();
+
+	LOG_MSG("CAPTURE: Stopped the shared memory output '%s'", shm.name.c_str());
+	shm.name.clear();
+}
+
+void SHM_OUTPUT_Init(const std::string& name)
+{
+	if (name == shm.name) {
+		return;
+	}
+	SHM_OUTPUT_Destroy();
+
+	if (name.empty()) {
+		return;
+	}
+
+	if (!open_video(name) || !open_audio(name)) {
+		LOG_WARNING("CAPTURE: Can't create the shared memory output '%s'",
+		            name.c_str());
+
+		// Close whichever object was opened
+		close_all();
+		return;
+	}
+
+	shm.name = name;
+	LOG_MSG("CAPTURE: Publishing the video and audio output in shared memory "
+	        "'%s-video' and '%s-audio'",
+	        name.c_str(),
+	        name.c_str());
+}
+
+bool SHM_OUTPUT_IsEnabled()
+{
+	return shm.video != nullptr;
+}
+
+static void publish_slot(const uint32_t index)
+{
+	shm.video->latest_slot.store(index, std::memory_order_release);
+	shm.video->num_frames.store(++shm.num_frames, std::memory_order_release);
+}
+
+void SHM_OUTPUT_AddFrame(const RenderedImage& image, const float frames_per_second,
+                         const bool is_dirty)
+{
+	if (!shm.video) {
+		return;
+	}
+
+	const auto now_us = GetTicksUs();
+
+	// Republish the unchanged frame without copying the pixels
+	if (!is_dirty && shm.has_frame) {
+		auto& slot = get_slot(shm.last_slot);
+
+		const auto seq = slot.sequence.load(std::memory_order_relaxed);
+		slot.sequence.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		slot.is_dirty     = 0;
+		slot.frame_number = shm.num_frames;
+		slot.timestamp_us = now_us;
+
+		slot.sequence.store(seq + 2, std::memory_order_release);
+		publish_slot(shm.last_slot);
+		return;
+	}
+
+	const auto& params = image.params;
+
+	const auto width  = check_cast<uint32_t>(params.width);
+	const auto height = check_cast<uint32_t>(params.height);
+	const auto pitch  = width * 4;
+
+	if (width > MaxFrameWidth || height > MaxFrameHeight) {
+		if (!shm.has_warned_frame_size) {
+			LOG_WARNING("CAPTURE: Frames larger than %ux%u are not "
+			            "published in shared memory",
+			            MaxFrameWidth,
+			            MaxFrameHeight);
+			shm.has_warned_frame_size = true;
+		}
+		return;
+	}
+
+	const auto index = (shm.last_slot + 1) % NumVideoSlots;
+	auto& slot       = get_slot(index);
+
+	const auto seq = slot.sequence.load(std::memory_order_relaxed);
+	slot.sequence.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot.width              = width;
+	slot.height             = height;
+	slot.pitch              = pitch;
+	slot.pixel_format       = ShmPixelFormat::Bgrx32;
+	slot.is_dirty           = 1;
+	slot.frame_number       = shm.num_frames;
+	slot.timestamp_us       = now_us;
+	slot.frames_per_second  = frames_per_second;
+	slot.pixel_aspect_ratio = params.pixel_aspect_ratio.ToDouble();
+	slot.double_width       = params.double_width ? 1 : 0;
+	slot.double_height      = params.double_height ? 1 : 0;
+
+	auto out = get_slot_pixels(index);
+
+	if (params.pixel_format == PixelFormat::BGRX32_ByteArray) {
+		for (uint32_t y = 0; y < height; ++y) {
+			std::memcpy(out + y * pitch,
+			            image.image_data + y * static_cast<size_t>(image.pitch),
+			            pitch);
+		}
+	} else {
+		shm.row_buf.resize(width);
+
+		constexpr auto RowSkipCount   = 0;
+		constexpr auto PixelSkipCount = 0;
+
+		ImageDecoder decoder(image, RowSkipCount, PixelSkipCount);
+
+		for (uint32_t y = 0; y < height; ++y) {
+			decoder.GetNextRowAsBgrx32Pixels(shm.row_buf.begin());
+			std::memcpy(out + y * pitch, shm.row_buf.data(), pitch);
+		}
+	}
+
+	slot.sequence.store(seq + 2, std::memory_order_release);
+
+	shm.last_slot = index;
+	shm.has_frame = true;
+	publish_slot(index);
+}
+
+void SHM_OUTPUT_AddAudio(const AudioFrame* frames, const int num_frames,
+                         const int sample_rate_hz)
+{
+	assert(frames);
+
+	std::unique_lock lock(shm.audio_mutex, std::try_to_lock);
+	if (!lock.owns_lock() || !shm.audio) {
+		return;
+	}
+
+	auto& header = *shm.audio;
+	header.sample_rate_hz.store(check_cast<uint32_t>(sample_rate_hz),
+	                            std::memory_order_relaxed);
+
+	auto write_pos = header.write_pos.load(std::memory_order_relaxed);
+
+	for (auto i = 0; i < num_frames; ++i) {
+		const auto pos = (write_pos % AudioCapacityFrames) * 2;
+
+		shm.audio_samples[pos]     = frames[i].left;
+		shm.audio_samples[pos + 1] = frames[i].right;
+		++write_pos;
+	}
+
+	header.last_write_time_us.store(GetTicksUs(), std::memory_order_relaxed);
+	header.write_pos.store(write_pos, std::memory_order_release);
+}
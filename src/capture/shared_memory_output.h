@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_SHARED_MEMORY_OUTPUT_H
+#define DOSBOX_SHARED_MEMORY_OUTPUT_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "audio/audio_frame.h"
+#include "misc/rendered_image.h"
+
+// Publishes the emulated video and audio output in shared memory, so an
+// external encoder (e.g., of a game streaming service) can consume it
+// without capturing the window.
+//
+// Enabled with the 'shared_memory_output' setting in the [capture] section;
+// with the name 'NAME', two shared memory objects are created:
+//
+//   - 'NAME-video' (POSIX: '/NAME-video', Windows: 'Local\NAME-video')
+//     holds a ShmVideoHeader followed by 'num_slots' frame slots of
+//     'slot_size' bytes. Each slot is a ShmFrameHeader followed by the
+//     pixels of the raw frame (before scaling and shaders) as 32-bit BGRX.
+//
+//   - 'NAME-audio' holds a ShmAudioHeader followed by a ring of
+//     'capacity_frames' interleaved stereo 32-bit float sample frames of
+//     the final mixer output.
+//
+// All fields are little-endian in host byte order, and the timestamps are
+// microseconds since the emulator started, so video and audio can be
+// synchronised.
+//
+// Reading a frame: load 'latest_slot', then the slot's 'sequence'; if it's
+// even, use the frame, then load 'sequence' again. If it has changed, the
+// frame was overwritten while being read and should be discarded. Slots are
+// only reused after 'num_slots - 1' newer frames, so a reader keeping up
+// with the frame rate can encode straight from the shared memory. Frames
+// that haven't changed since the previous one republish the same slot with
+// 'is_dirty' cleared and a new timestamp, without copying the pixels.
+//
+// Reading audio: readers keep their own read position in frames; the frames
+// in [read_pos, write_pos) are at 'read_pos % capacity_frames' onwards. If
+// 'write_pos - read_pos' exceeds 'capacity_frames', the reader has been
+// overrun and should skip ahead. The writer never waits for readers.
+
+constexpr uint32_t ShmOutputVersion = 1;
+
+enum class ShmPixelFormat : uint32_t { Bgrx32 = 0 };
+
+struct ShmVideoHeader {
+	char magic[8]      = {'D', 'B', 'X', 'V', 'I', 'D', 'E', 'O'};
+	uint32_t version   = ShmOutputVersion;
+	uint32_t num_slots = 0;
+	uint32_t slot_size = 0;
+
+	// Frames larger than this are not published
+	uint32_t max_frame_bytes = 0;
+
+	// Index of the most recently published slot
+	std::atomic<uint32_t> latest_slot = 0;
+
+	// Incremented after every published frame (also the unchanged ones)
+	std::atomic<uint64_t> num_frames = 0;
+};
+
+struct ShmFrameHeader {
+	// Odd while the slot is being written
+	std::atomic<uint32_t> sequence = 0;
+
+	uint32_t width  = 0;
+	uint32_t height = 0;
+
+	// Bytes per row of the pixel data following the header
+	uint32_t pitch = 0;
+
+	ShmPixelFormat pixel_format = ShmPixelFormat::Bgrx32;
+
+	// Zero if the frame is the same as the previously published one
+	uint32_t is_dirty = 0;
+
+	uint64_t frame_number = 0;
+	int64_t timestamp_us  = 0;
+
+	double frames_per_second = 0.0;
+
+	// To be applied after the optional doubling below to get the
+	// intended display aspect ratio
+	double pixel_aspect_ratio = 1.0;
+
+	uint32_t double_width  = 0;
+	uint32_t double_height = 0;
+};
+
+struct ShmAudioHeader {
+	char magic[8]            = {'D', 'B', 'X', 'A', 'U', 'D', 'I', 'O'};
+	uint32_t version         = ShmOutputVersion;
+	uint32_t num_channels    = 2;
+	uint32_t capacity_frames = 0;
+
+	std::atomic<uint32_t> sample_rate_hz = 0;
+
+	// Total number of sample frames written, and the time the last block
+	// was written at
+	std::atomic<uint64_t> write_pos         = 0;
+	std::atomic<int64_t> last_write_time_us = 0;
+};
+
+// Opens the shared memory objects for the given name, or closes them if the
+// name is empty. Keeps the current objects if the name hasn't changed, so
+// readers stay connected when other settings change.
+void SHM_OUTPUT_Init(const std::string& name);
+void SHM_OUTPUT_Destroy();
+
+bool SHM_OUTPUT_IsEnabled();
+
+// Called at the end of every rendered frame on the main thread
+void SHM_OUTPUT_AddFrame(const RenderedImage& image, const float frames_per_second,
+                         const bool is_dirty);
+
+// Called by the mixer thread with the final output
+void SHM_OUTPUT_AddAudio(const AudioFrame* frames, const int num_frames,
+                         const int sample_rate_hz);
+
+#endif // DOSBOX_SHARED_MEMORY_OUTPUT_H
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "private/write_behind_file.h"
+
+#include <cassert>
+
+#include "misc/support.h"
+#include "utils/checks.h"
+
+CHECK_NARROWING();
+
+// The background thread writes the data in chunks of this size, unless the
+// writer is being flushed
+constexpr size_t WriteChunkSize = 64 * 1024;
+
+WriteBehindFile::WriteBehindFile(FILE* _handle, const size_t buffer_size,
+                                 const char* thread_name)
+        : handle(_handle),
+          queue(buffer_size)
+{
+	assert(handle);
+	assert(buffer_size > 0);
+
+	writer = std::thread(&WriteBehindFile::WriteQueuedData, this);
+	set_thread_name(writer, thread_name);
+}
+
+WriteBehindFile::~WriteBehindFile()
+{
+	Flush();
+}
+
+bool WriteBehindFile::Write(const void* data, const size_t num_bytes)
+{
+	assert(data);
+
+	if (num_bytes == 0) {
+		return true;
+	}
+
+	// Only the background thread frees up room concurrently, so if the
+	// data fits now, it will fit when enqueued
+	if (!queue.IsRunning() || queue.MaxCapacity() - queue.Size() < num_bytes) {
+		num_bytes_dropped += num_bytes;
+		return false;
+	}
+
+	const auto bytes = static_cast<const uint8_t*>(data);
+	staging_buf.assign(bytes, bytes + num_bytes);
+
+	[[maybe_unused]] const auto num_enqueued = queue.NonblockingBulkEnqueue(
+	        staging_buf);
+	assert(num_enqueued == num_bytes);
+
+	num_bytes_written += num_bytes;
+	return true;
+}
+
+void WriteBehindFile::Flush()
+{
+	if (!writer.joinable()) {
+		return;
+	}
+
+	// The background thread drains the queue before it exits
+	queue.Stop();
+	writer.join();
+}
+
+void WriteBehindFile::WriteQueuedData()
+{
+	std::vector<uint8_t> chunk(WriteChunkSize);
+
+	// Blocks until a full chunk is available, or returns the remainder
+	// once the queue has been stopped
+	while (const auto num_bytes = queue.BulkDequeue(chunk.data(), chunk.size())) {
+		fwrite(chunk.data(), 1, num_bytes, handle);
+	}
+}
@@ -587,6 +587,7 @@ void Config::ParseArguments()
 	arguments.exit        = cmdline->FindRemoveBoolArgument("exit");
 	arguments.securemode  = cmdline->FindRemoveBoolArgument("securemode");
 	arguments.noautoexec  = cmdline->FindRemoveBoolArgument("noautoexec");
+	arguments.benchmark   = cmdline->FindRemoveBoolArgument("benchmark");
 
 	arguments.eraseconf = cmdline->FindRemoveBoolArgument("eraseconf") ||
 	                      cmdline->FindRemoveBoolArgument("resetconf");
@@ -600,9 +601,14 @@ void Config::ParseArguments()
 	arguments.working_dir = cmdline->FindRemoveStringArgument("working-dir");
 	arguments.lang    = cmdline->FindRemoveStringArgument("lang");
 	arguments.machine = cmdline->FindRemoveStringArgument("machine");
+	arguments.trace   = cmdline->FindRemoveStringArgument("trace");
+
+	arguments.record_input = cmdline->FindRemoveStringArgument("record-input");
+	arguments.replay_input = cmdline->FindRemoveStringArgument("replay-input");
 
 	arguments.socket   = cmdline->FindRemoveIntArgument("socket");
 	arguments.wait_pid = cmdline->FindRemoveIntArgument("waitpid");
+	arguments.frames   = cmdline->FindRemoveIntArgument("frames");
 
 	arguments.conf = cmdline->FindRemoveVectorArgument("conf");
 	arguments.set  = cmdline->FindRemoveVectorArgument("set");
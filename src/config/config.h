@@ -42,16 +42,21 @@ struct CommandLineArguments {
 	bool exit;
 	bool securemode;
 	bool noautoexec;
+	bool benchmark;
 
 	std::string working_dir;
 	std::string lang;
 	std::string machine;
+	std::string trace;
+	std::string record_input;
+	std::string replay_input;
 	std::vector<std::string> conf;
 	std::vector<std::string> set;
 	std::optional<std::vector<std::string>> editconf;
 
 	std::optional<int> socket;
 	std::optional<int> wait_pid;
+	std::optional<int> frames;
 };
 
 class Config {
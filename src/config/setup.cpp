@@ -842,168 +842,143 @@ void Property::SetEnabledOptions(const std::vector<std::string>& options)
 	enabled_options = options;
 }
 
-PropInt* SectionProp::AddInt(const std::string& _propname,
-                             Property::Changeable::Value when, int new_value)
+template <typename T>
+T* SectionProp::AddProperty(T* prop)
 {
-	const auto prop = new PropInt(_propname, when, new_value);
 	properties.push_back(prop);
+
+	auto name = prop->propname;
+	lowcase(name);
+	properties_by_name.try_emplace(std::move(name), prop);
+
 	return prop;
 }
 
+Property* SectionProp::FindProperty(const std::string_view propname) const
+{
+	std::string name(propname);
+	lowcase(name);
+
+	const auto it = properties_by_name.find(name);
+	return (it != properties_by_name.end()) ? it->second : nullptr;
+}
+
+PropInt* SectionProp::AddInt(const std::string& _propname,
+                             Property::Changeable::Value when, int new_value)
+{
+	return AddProperty(new PropInt(_propname, when, new_value));
+}
+
 PropString* SectionProp::AddString(const std::string& _propname,
                                    Property::Changeable::Value when,
                                    const char* new_value)
 {
-	const auto prop = new PropString(_propname, when, new_value);
-	properties.push_back(prop);
-	return prop;
+	return AddProperty(new PropString(_propname, when, new_value));
 }
 
 PropPath* SectionProp::AddPath(const std::string& _propname,
                                Property::Changeable::Value when, const char* new_value)
 {
-	const auto prop = new PropPath(_propname, when, new_value);
-	properties.push_back(prop);
-	return prop;
+	return AddProperty(new PropPath(_propname, when, new_value));
 }
 
 PropBool* SectionProp::AddBool(const std::string& _propname,
                                Property::Changeable::Value when, bool new_value)
 {
-	const auto prop = new PropBool(_propname, when, new_value);
-	properties.push_back(prop);
-	return prop;
+	return AddProperty(new PropBool(_propname, when, new_value));
 }
 
 PropHex* SectionProp::AddHex(const std::string& _propname,
                              Property::Changeable::Value when, Hex new_value)
 {
-	const auto prop = new PropHex(_propname, when, new_value);
-	properties.push_back(prop);
-	return prop;
+	return AddProperty(new PropHex(_propname, when, new_value));
 }
 
 PropMultiVal* SectionProp::AddMultiVal(const std::string& _propname,
                                        Property::Changeable::Value when,
                                        const std::string& sep)
 {
-	const auto prop = new PropMultiVal(_propname, when, sep);
-	properties.push_back(prop);
-	return prop;
+	return AddProperty(new PropMultiVal(_propname, when, sep));
 }
 
 PropMultiValRemain* SectionProp::AddMultiValRemain(const std::string& _propname,
                                                    Property::Changeable::Value when,
                                                    const std::string& sep)
 {
-	const auto prop = new PropMultiValRemain(_propname, when, sep);
-	properties.push_back(prop);
-	return prop;
+	return AddProperty(new PropMultiValRemain(_propname, when, sep));
 }
 
 int SectionProp::GetInt(const std::string& _propname) const
 {
-	for (const auto &property : properties) {
-		if (property->propname == _propname) {
-			return property->GetValue();
-		}
+	const auto property = FindProperty(_propname);
+	if (property && property->propname == _propname) {
+		return property->GetValue();
 	}
 	return 0;
 }
 
 bool SectionProp::GetBool(const std::string& _propname) const
 {
-	for (const auto &property : properties) {
-		if (property->propname == _propname) {
-			return property->GetValue();
-		}
+	const auto property = FindProperty(_propname);
+	if (property && property->propname == _propname) {
+		return property->GetValue();
 	}
 	return false;
 }
 
 double SectionProp::GetDouble(const std::string& _propname) const
 {
-	for (const auto &property : properties) {
-		if (property->propname == _propname) {
-			return property->GetValue();
-		}
+	const auto property = FindProperty(_propname);
+	if (property && property->propname == _propname) {
+		return property->GetValue();
 	}
 	return 0.0;
 }
 
 PropPath* SectionProp::GetPath(const std::string& _propname) const
 {
-	for (const auto &property : properties) {
-		if (property->propname == _propname) {
-			auto val = dynamic_cast<PropPath*>(property);
-			if (val) {
-				return val;
-			} else {
-				return nullptr;
-			}
-		}
+	const auto property = FindProperty(_propname);
+	if (property && property->propname == _propname) {
+		return dynamic_cast<PropPath*>(property);
 	}
 	return nullptr;
 }
 
 PropMultiVal* SectionProp::GetMultiVal(const std::string& _propname) const
 {
-	for (const auto &property : properties) {
-		if (property->propname == _propname) {
-			auto val = dynamic_cast<PropMultiVal*>(property);
-			if (val) {
-				return val;
-			} else {
-				return nullptr;
-			}
-		}
+	const auto property = FindProperty(_propname);
+	if (property && property->propname == _propname) {
+		return dynamic_cast<PropMultiVal*>(property);
 	}
 	return nullptr;
 }
 
 PropMultiValRemain* SectionProp::GetMultiValRemain(const std::string& _propname) const
 {
-	for (const auto &property : properties) {
-		if (property->propname == _propname) {
-			auto val = dynamic_cast<PropMultiValRemain*>(property);
-			if (val) {
-				return val;
-			} else {
-				return nullptr;
-			}
-		}
+	const auto property = FindProperty(_propname);
+	if (property && property->propname == _propname) {
+		return dynamic_cast<PropMultiValRemain*>(property);
 	}
 	return nullptr;
 }
 
 Property* SectionProp::GetProperty(int index)
 {
-	for (const auto &property : properties) {
-		if (!index--) {
-			return property;
-		}
+	if (index < 0 || static_cast<size_t>(index) >= properties.size()) {
+		return nullptr;
 	}
-	return nullptr;
+	return properties[static_cast<size_t>(index)];
 }
 
 Property* SectionProp::GetProperty(const std::string_view propname)
 {
-	for (const auto &property : properties) {
-		if (iequals(property->propname, propname)) {
-			return property;
-		}
-	}
-	return nullptr;
+	return FindProperty(propname);
 }
 
 std::string SectionProp::GetString(const std::string& _propname) const
 {
-	for (const auto &property : properties) {
-		if (iequals(property->propname, _propname)) {
-			return (property->GetValue());
-		}
-	}
-	return "";
+	const auto property = FindProperty(_propname);
+	return property ? std::string(property->GetValue()) : "";
 }
 
 std::string SectionProp::GetStringLowCase(const std::string& _propname) const
@@ -1016,32 +991,18 @@ std::string SectionProp::GetStringLowCase(const std::string& _propname) const
 
 PropBool* SectionProp::GetBoolProp(const std::string& propname) const
 {
-	for (const auto property : properties) {
-		if (iequals(property->propname, propname)) {
-			return dynamic_cast<PropBool*>(property);
-		}
-	}
-	return nullptr;
+	return dynamic_cast<PropBool*>(FindProperty(propname));
 }
 
 PropString* SectionProp::GetStringProp(const std::string& propname) const
 {
-	for (const auto property : properties) {
-		if (iequals(property->propname, propname)) {
-			return dynamic_cast<PropString*>(property);
-		}
-	}
-	return nullptr;
+	return dynamic_cast<PropString*>(FindProperty(propname));
 }
 
 Hex SectionProp::GetHex(const std::string& _propname) const
 {
-	for (const auto property : properties) {
-		if (iequals(property->propname, _propname)) {
-			return (property->GetValue());
-		}
-	}
-	return 0;
+	const auto property = FindProperty(_propname);
+	return property ? Hex(property->GetValue()) : Hex(0);
 }
 
 bool SectionProp::HandleInputLine(const std::string& line)
@@ -1074,11 +1035,7 @@ bool SectionProp::HandleInputLine(const std::string& line)
 	trim(setting_value_str);
 
 	// Find the configuration setting and try to set it
-	for (auto& p : properties) {
-		if (strcasecmp(p->propname.c_str(), setting_name.c_str()) != 0) {
-			continue;
-		}
-
+	if (const auto p = FindProperty(setting_name); p) {
 		if (p->IsDeprecated()) {
 			NOTIFY_DisplayWarning(Notification::Source::Console,
 			                      "CONFIG",
@@ -1110,12 +1067,8 @@ void SectionProp::PrintData([[maybe_unused]] FILE* outfile) const {}
 
 std::string SectionProp::GetPropertyValue(const std::string& _property) const
 {
-	for (auto tel = properties.begin(); tel != properties.end(); ++tel) {
-		if (!strcasecmp((*tel)->propname.c_str(), _property.c_str())) {
-			return (*tel)->GetValue().ToString();
-		}
-	}
-	return NO_SUCH_PROPERTY;
+	const auto property = FindProperty(_property);
+	return property ? property->GetValue().ToString() : NO_SUCH_PROPERTY;
 }
 
 AutoExecSection* get_autoexec_section(const char* section_name)
@@ -13,7 +13,9 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include "misc/std_filesystem.h"
@@ -388,6 +390,16 @@ private:
 	typedef std::deque<Property*>::iterator it;
 	typedef std::deque<Property*>::const_iterator const_it;
 
+	// Properties by lower-case name, so lookups don't have to scan the
+	// whole section; the first property added under a name wins, as
+	// with a scan
+	std::unordered_map<std::string, Property*> properties_by_name = {};
+
+	template <typename T>
+	T* AddProperty(T* prop);
+
+	Property* FindProperty(const std::string_view propname) const;
+
 public:
 	SectionProp(const std::string& name, bool active = true)
 	        : Section(name, active)
@@ -243,25 +243,38 @@ static void dyn_restoreregister(DynReg * src_reg, DynReg * dst_reg) {
 enum class CoreType { Dynamic,  Normal };
 static auto last_core = CoreType::Dynamic;
 
+// Set when the host FPU state saved by the dynamic core hasn't been copied to
+// the normal FPU yet
+static bool dh_fpu_state_changed = false;
+
 static void maybe_sync_host_fpu_to_dh()
 {
 	if (dyn_dh_fpu.state_used) {
 		gen_dh_fpu_save();
+		dh_fpu_state_changed = true;
 	}
 }
 
 // The active core being run (dynamic or normal) synchronizes its respective FPU
-// from the opposite FPU if the other core was last run. Subsequent runs that
-// stay within the same core do not need synchronization.
+// from the opposite FPU if the other core was last run and has changed its FPU
+// state since. Code that keeps falling back to the normal core without using
+// the FPU (exceptions, unsupported opcodes, page faults) skips the copy.
 
 static BlockReturn sync_normal_fpu_and_run_dyn_code(const uint8_t* code) noexcept
 {
 	if (last_core == CoreType::Normal) {
-		FPU_SET_TOP(TOP);
-		dyn_dh_fpu.state.tag = FPU_GetTag();
-		dyn_dh_fpu.state.cw  = FPU_GetCW();
-		dyn_dh_fpu.state.sw  = FPU_GetSW();
-		FPU_GetPRegsTo(dyn_dh_fpu.state.st_reg);
+		const auto needs_sync = fpu_state_changed;
+		if (needs_sync) {
+			FPU_SET_TOP(TOP);
+			dyn_dh_fpu.state.tag = FPU_GetTag();
+			dyn_dh_fpu.state.cw  = FPU_GetCW();
+			dyn_dh_fpu.state.sw  = FPU_GetSW();
+			FPU_GetPRegsTo(dyn_dh_fpu.state.st_reg);
+			fpu_state_changed = false;
+		}
+		if (dyn_profiler_enabled) {
+			DYN_PROFILER_AddCoreSwitch(needs_sync);
+		}
 		last_core = CoreType::Dynamic;
 	}
 	return gen_runcode(code);
@@ -271,11 +284,19 @@ static Bits sync_dh_fpu_and_run_normal_core() noexcept
 {
 	if (last_core == CoreType::Dynamic) {
 		maybe_sync_host_fpu_to_dh();
-		FPU_SetTag(static_cast<uint16_t>(dyn_dh_fpu.state.tag & 0xffff));
-		FPU_SetCW(static_cast<uint16_t>(dyn_dh_fpu.state.cw & 0xffff));
-		FPU_SetSW(static_cast<uint16_t>(dyn_dh_fpu.state.sw & 0xffff));
-		TOP = FPU_GET_TOP();
-		FPU_SetPRegsFrom(dyn_dh_fpu.state.st_reg);
+
+		const auto needs_sync = dh_fpu_state_changed;
+		if (needs_sync) {
+			FPU_SetTag(static_cast<uint16_t>(dyn_dh_fpu.state.tag & 0xffff));
+			FPU_SetCW(static_cast<uint16_t>(dyn_dh_fpu.state.cw & 0xffff));
+			FPU_SetSW(static_cast<uint16_t>(dyn_dh_fpu.state.sw & 0xffff));
+			TOP = FPU_GET_TOP();
+			FPU_SetPRegsFrom(dyn_dh_fpu.state.st_reg);
+			dh_fpu_state_changed = false;
+		}
+		if (dyn_profiler_enabled) {
+			DYN_PROFILER_AddCoreSwitch(needs_sync);
+		}
 		last_core = CoreType::Normal;
 	}
 	assert(!dyn_dh_fpu.state_used);
@@ -338,7 +359,17 @@ restart_core:
 	}
 run_block:
 	cache.block.running=nullptr;
+
+	if (dyn_profiler_enabled) {
+		dyn_profiler_register_block(block);
+	}
+	const auto cycles_before = CPU_Cycles;
+
 	const auto ret = sync_normal_fpu_and_run_dyn_code(block->cache.start);
+
+	if (dyn_profiler_enabled) {
+		DYN_PROFILER_AddEntry(block->profile_id, cycles_before - CPU_Cycles);
+	}
 #	if C_DEBUGGER
 	cycle_count += 32;
 #endif
@@ -396,7 +427,11 @@ run_block:
 			if (temp_handler->flags & (cpu.code.big ? PFLAG_HASCODE32:PFLAG_HASCODE16)) {
 				block=temp_handler->FindCacheBlock(temp_ip & 4095);
 				if (!block || !cache.block.running) goto restart_core;
-				cache.block.running->LinkTo(ret==BR_Link2,block);
+				// profiling needs every block entry to pass
+				// through here, so don't link blocks then
+				if (!dyn_profiler_enabled) {
+					cache.block.running->LinkTo(ret == BR_Link2, block);
+				}
 				goto run_block;
 			}
 		}
@@ -491,10 +526,20 @@ void CPU_Core_Dyn_X86_Cache_Init(bool enable_cache) {
 	cache_init(enable_cache);
 }
 
+void CPU_Core_Dyn_X86_Cache_SetSize(const int size_mb)
+{
+	cache_set_size(size_mb);
+}
+
 void CPU_Core_Dyn_X86_Cache_Close(void) {
 	cache_close();
 }
 
+DynCacheStats CPU_Core_Dyn_X86_Cache_GetStats()
+{
+	return cache_get_stats();
+}
+
 void CPU_Core_Dyn_X86_SetFPUMode(bool dh_fpu) {
 #if defined(X86_DYNFPU_DH_ENABLED)
 	dyn_dh_fpu.dh_fpu_enabled=dh_fpu;
@@ -83,6 +83,7 @@ static bool MakeCodePage(Bitu lin_addr,CodePageHandler * &cph) {
 	}
 	/* Find a free CodePage */
 	if (!cache.free_pages && cache.used_pages) {
+		++cache_stats.page_evictions;
 		if (cache.used_pages != decode.page.code)
 			cache.used_pages->ClearRelease();
 		else {
@@ -5,7 +5,9 @@
 
 #if (C_DYNREC)
 
+#include <algorithm>
 #include <cassert>
+#include <cinttypes>
 // simde needs std::isnan
 #include <cmath>
 #include <cstdarg>
@@ -40,7 +42,10 @@
 #include "hardware/memory.h"
 #include "hardware/pic.h"
 #include "hardware/port.h"
+#include "hardware/timer.h"
 #include "lazyflags.h"
+#include "misc/metrics.h"
+#include "utils/checks.h"
 
 #define CACHE_MAXSIZE	(4096*2)
 #define CACHE_TOTAL		(1024*1024*8)
@@ -167,14 +172,11 @@ static_assert(offsetof(core_dynrec_t, readdata) % sizeof(uint32_t) == 0,
 #define gen_mov_LE_word_to_reg gen_mov_word_to_reg
 #endif
 
-#include "core_dynrec/decoder.h"
-
-CacheBlock *LinkBlocks(BlockReturn ret)
+// the code page handler of an address if it contains translated code of
+// the current code size
+static CodePageHandler* get_code_page_handler(const PhysPt ip)
 {
-	// the last instruction was a control flow modifying instruction
-	const auto temp_ip = SegPhys(cs) + reg_eip;
-
-	const auto read_handler = get_tlb_readhandler(temp_ip);
+	const auto read_handler = get_tlb_readhandler(ip);
 	if (!read_handler) {
 		return nullptr;
 	}
@@ -189,6 +191,192 @@ CacheBlock *LinkBlocks(BlockReturn ret)
 	if (!cp_has_code) {
 		return nullptr;
 	}
+	return cp_handler;
+}
+
+// the block an indirect jump, call, or near return continues with
+static CacheBlock* indirect_target = nullptr;
+
+// Called at the end of blocks that end with an indirect jump, call, or near
+// return. Returns non-zero if the target is an already translated block,
+// which is then jumped to directly instead of returning to the dispatcher.
+// Each such block remembers its last target, so the common case of always
+// jumping to the same place only needs a few compares.
+static uint32_t dynrec_find_indirect_target()
+{
+#if C_HEAVY_DEBUGGER
+	return 0;
+#else
+	// profiling needs every block entry to pass through the dispatch loop
+	if (dyn_profiler_enabled) {
+		return 0;
+	}
+	const auto ip = SegPhys(cs) + reg_eip;
+
+	const auto cp_handler = get_code_page_handler(ip);
+	if (!cp_handler) {
+		return 0;
+	}
+
+	auto& prediction = cache.block.running->indirect;
+
+	const auto predicted = prediction.to;
+	if (predicted && prediction.ip == ip &&
+	    predicted->page.handler == cp_handler &&
+	    predicted->page.start == (ip & 4095)) {
+		indirect_target = predicted;
+		return 1;
+	}
+
+	const auto cache_block = cp_handler->FindCacheBlock(ip & 4095);
+	if (!cache_block) {
+		return 0;
+	}
+	prediction.to = cache_block;
+	prediction.ip = ip;
+
+	indirect_target = cache_block;
+	return 1;
+#endif
+}
+
+#include "core_dynrec/decoder.h"
+
+// Number of cycles the normal core runs new code for instead of translating
+// it, before the dispatcher checks again
+constexpr int DeferredChunkCycles = 64;
+
+// Caps how many blocks are translated per emulated millisecond, so bursts of
+// new code (level loads, protected mode program startup) are spread out
+// instead of stalling the emulation; the code that doesn't fit the budget is
+// interpreted by the normal core in the meantime. Zero means no limit.
+static struct {
+	int blocks_per_ms     = 0;
+	int remaining         = 0;
+	uint32_t tick         = 0;
+	uint64_t num_deferred = 0;
+} translation_budget = {};
+
+static bool take_translation_budget()
+{
+	auto& budget = translation_budget;
+	if (budget.blocks_per_ms == 0) {
+		return true;
+	}
+	if (budget.tick != PIC_Ticks) {
+		budget.tick      = PIC_Ticks;
+		budget.remaining = budget.blocks_per_ms;
+	}
+	if (budget.remaining == 0) {
+		++budget.num_deferred;
+		return false;
+	}
+	--budget.remaining;
+	return true;
+}
+
+// Tiering: new code is run on the normal core until its page has been
+// entered this many times, so code that only runs once or twice (e.g.,
+// initialisation and loaders) doesn't pay for its translation. Zero
+// translates all code right away.
+static uint32_t tier_threshold = 0;
+
+// New code is only ever interpreted with tiering or a translation budget, so
+// the cycle and translation time accounting is skipped without them
+static bool is_tiering_enabled()
+{
+	return tier_threshold > 0 || translation_budget.blocks_per_ms > 0;
+}
+
+// Where the dispatched cycles went and how long the translation took;
+// accumulated locally and published to the metrics once per time slice
+static struct {
+	int64_t interpreted_cycles = 0;
+	int64_t translated_cycles  = 0;
+	int64_t translation_us     = 0;
+	int64_t translated_blocks  = 0;
+
+	int64_t total_interpreted_cycles = 0;
+	int64_t total_translated_cycles  = 0;
+	int64_t total_translation_us     = 0;
+	int64_t total_translated_blocks  = 0;
+} tiers = {};
+
+// Counts the entries into pages that aren't hot yet
+static bool is_hot_code_page(CodePageHandler& handler)
+{
+	if (handler.num_interpreted_entries >= tier_threshold) {
+		return true;
+	}
+	++handler.num_interpreted_entries;
+	return false;
+}
+
+static void publish_tier_metrics()
+{
+	static auto& interpreted_cycles = METRICS_Counter(
+	        "dosbox_dynrec_interpreted_cycles_total",
+	        "Cycles the dynamic core ran new code on the normal core");
+
+	static auto& translated_cycles = METRICS_Counter(
+	        "dosbox_dynrec_translated_cycles_total",
+	        "Cycles the dynamic core ran translated code");
+
+	static auto& translation_us = METRICS_Counter(
+	        "dosbox_dynrec_translation_microseconds_total",
+	        "Host time the dynamic core spent translating code");
+
+	static auto& translated_blocks = METRICS_Counter(
+	        "dosbox_dynrec_translated_blocks_total",
+	        "Blocks translated by the dynamic core");
+
+	interpreted_cycles.Add(tiers.interpreted_cycles);
+	translated_cycles.Add(tiers.translated_cycles);
+	translation_us.Add(tiers.translation_us);
+	translated_blocks.Add(tiers.translated_blocks);
+
+	tiers.total_interpreted_cycles += tiers.interpreted_cycles;
+	tiers.total_translated_cycles += tiers.translated_cycles;
+	tiers.total_translation_us += tiers.translation_us;
+	tiers.total_translated_blocks += tiers.translated_blocks;
+
+	tiers.interpreted_cycles = 0;
+	tiers.translated_cycles  = 0;
+	tiers.translation_us     = 0;
+	tiers.translated_blocks  = 0;
+}
+
+// Runs the new code at CS:EIP on the normal core for a few cycles instead of
+// translating it. Returns true if the dispatcher has to return 'retcode'.
+static bool interpret_new_code(Bits& retcode)
+{
+	const auto old_cycles = CPU_Cycles;
+	const auto chunk      = std::min(old_cycles, DeferredChunkCycles);
+
+	CPU_Cycles = chunk;
+	retcode    = CPU_Core_Normal_Run();
+
+	const auto cycles_left = std::max(CPU_Cycles, 0);
+	tiers.interpreted_cycles += chunk - cycles_left;
+
+	if (retcode) {
+		CPU_CycleLeft += old_cycles - chunk;
+		return true;
+	}
+	CPU_Cycles = old_cycles - chunk + cycles_left;
+
+	return CPU_Cycles <= 0 || cpudecoder != &CPU_Core_Dynrec_Run;
+}
+
+CacheBlock *LinkBlocks(BlockReturn ret)
+{
+	// the last instruction was a control flow modifying instruction
+	const auto temp_ip = SegPhys(cs) + reg_eip;
+
+	const auto cp_handler = get_code_page_handler(temp_ip);
+	if (!cp_handler) {
+		return nullptr;
+	}
 
 	// see if the target is an already translated block
 	const auto cache_block = cp_handler->FindCacheBlock(temp_ip & 4095);
@@ -196,8 +384,11 @@ CacheBlock *LinkBlocks(BlockReturn ret)
 		return nullptr;
 	}
 
-	// found it, link the current block to
-	cache.block.running->LinkTo(ret == BR_Link2, cache_block);
+	// found it, link the current block to it unless profiling, which
+	// needs every block entry to pass through the dispatch loop
+	if (!dyn_profiler_enabled) {
+		cache.block.running->LinkTo(ret == BR_Link2, cache_block);
+	}
 	return cache_block;
 }
 
@@ -242,8 +433,23 @@ Bits CPU_Core_Dynrec_Run() noexcept
 			// no block found, thus translate the instruction stream
 			// unless the instruction is known to be modified
 			if (!chandler->invalidation_map || (chandler->invalidation_map[ip_point&4095]<4)) {
+				if (!is_hot_code_page(*chandler) ||
+				    !take_translation_budget()) {
+					Bits nc_retcode = 0;
+					if (interpret_new_code(nc_retcode)) {
+						return nc_retcode;
+					}
+					continue;
+				}
 				// translate up to 32 instructions
-				block=CreateCacheBlock(chandler,ip_point,32);
+				if (is_tiering_enabled()) {
+					const auto start_us = GetTicksUs();
+					block = CreateCacheBlock(chandler, ip_point, 32);
+					tiers.translation_us += GetTicksUs() - start_us;
+					++tiers.translated_blocks;
+				} else {
+					block = CreateCacheBlock(chandler, ip_point, 32);
+				}
 			} else {
 				// let the normal core handle this instruction to avoid zero-sized blocks
 				Bitu old_cycles=CPU_Cycles;
@@ -260,10 +466,25 @@ Bits CPU_Core_Dynrec_Run() noexcept
 
 run_block:
 		cache.block.running=nullptr;
+
+		if (dyn_profiler_enabled) {
+			dyn_profiler_register_block(block);
+		}
+		const auto cycles_before = CPU_Cycles;
+
 		// now we're ready to run the dynamic code block
 //		BlockReturn ret=((BlockReturn (*)(void))(block->cache.start))();
 		BlockReturn ret=core_dynrec.runcode(block->cache.start);
 
+		if (is_tiering_enabled()) {
+			tiers.translated_cycles += cycles_before - CPU_Cycles;
+		}
+
+		if (dyn_profiler_enabled) {
+			DYN_PROFILER_AddEntry(block->profile_id,
+			                      cycles_before - CPU_Cycles);
+		}
+
 		switch (ret) {
 		case BR_Iret:
 #if C_DEBUGGER
@@ -294,6 +515,9 @@ run_block:
 		case BR_Cycles:
 			// cycles went negative, return from the core to handle
 			// external events, schedule the pic...
+			if (is_tiering_enabled()) {
+				publish_tier_metrics();
+			}
 #if C_DEBUGGER
 #if C_HEAVY_DEBUGGER
 			if (DEBUG_HeavyIsBreakpoint()) return debugCallback;
@@ -368,8 +592,49 @@ void CPU_Core_Dynrec_Cache_Init(bool enable_cache) {
 	cache_init(enable_cache);
 }
 
+void CPU_Core_Dynrec_Cache_SetSize(const int size_mb)
+{
+	cache_set_size(size_mb);
+}
+
+void CPU_Core_Dynrec_SetTranslationBudget(const int blocks_per_ms)
+{
+	translation_budget.blocks_per_ms = blocks_per_ms;
+}
+
+void CPU_Core_Dynrec_SetTierThreshold(const int num_entries)
+{
+	tier_threshold = check_cast<uint32_t>(num_entries);
+}
+
 void CPU_Core_Dynrec_Cache_Close(void) {
+	if (is_tiering_enabled()) {
+		publish_tier_metrics();
+	}
+
+	const auto total_cycles = tiers.total_interpreted_cycles +
+	                          tiers.total_translated_cycles;
+	if (total_cycles > 0) {
+		LOG_MSG("DYNREC: %.1f%% of the cycles ran translated, %.1f%% interpreted; "
+		        "%" PRId64 " blocks translated in %.1f ms",
+		        100.0 * static_cast<double>(tiers.total_translated_cycles) /
+		                static_cast<double>(total_cycles),
+		        100.0 * static_cast<double>(tiers.total_interpreted_cycles) /
+		                static_cast<double>(total_cycles),
+		        tiers.total_translated_blocks,
+		        static_cast<double>(tiers.total_translation_us) / 1000.0);
+	}
+	if (translation_budget.num_deferred > 0) {
+		LOG_MSG("DYNREC: Interpreted new code %" PRIu64
+		        " times while the translation budget was used up",
+		        translation_budget.num_deferred);
+	}
 	cache_close();
 }
 
+DynCacheStats CPU_Core_Dynrec_Cache_GetStats()
+{
+	return cache_get_stats();
+}
+
 #endif
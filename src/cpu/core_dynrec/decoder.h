@@ -951,6 +951,8 @@ static CacheBlock *CreateCacheBlock(CodePageHandler *codepage, PhysPt start, Bit
 				goto core_close_block;
 			case 2:
 				goto illegalopcode;
+			case 3:
+				goto core_indirect_block;
 			default:
 				break;
 			}
@@ -974,6 +976,11 @@ core_close_block:
 	dyn_return(BR_Normal);
 	dyn_closeblock();
 	goto finish_block;
+core_indirect_block:
+	dyn_reduce_cycles();
+	dyn_return_indirect();
+	dyn_closeblock();
+	goto finish_block;
 illegalopcode:
 	// some unhandled opcode has been encountered
 	dyn_set_eip_last();
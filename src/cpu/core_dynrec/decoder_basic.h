@@ -150,6 +150,7 @@ static bool MakeCodePage(Bitu lin_addr, CodePageHandler *&cph)
 	}
 	// find a free CodePage
 	if (!cache.free_pages) {
+		++cache_stats.page_evictions;
 		if (cache.used_pages!=decode.page.code) cache.used_pages->ClearRelease();
 		else {
 			// try another page to avoid clearing our source-crosspage
@@ -581,6 +582,16 @@ static void dyn_return(BlockReturn retcode,bool ret_exception=false) {
 	gen_return_function();
 }
 
+// end the block with an indirect jump, continue with the target block if it
+// has been translated already, otherwise return to the dispatcher
+static void dyn_return_indirect(void) {
+	gen_call_function_raw((void*)&dynrec_find_indirect_target);
+	const uint8_t* no_target=gen_create_branch_on_zero(FC_RETOP,true);
+	gen_jmp_ptr(&indirect_target,offsetof(CacheBlock,cache.start));
+	gen_fill_branch(no_target);
+	dyn_return(BR_Normal);
+}
+
 static void dyn_run_code(void) {
 	gen_run_code();
 	gen_return_function();
@@ -1140,21 +1151,79 @@ static struct {
 	const uint8_t* pos;
 	void* fct_ptr;
 	Bitu ftype;
+	Bitu live_flags;	// flags this function may still provide
 } mf_functions[64];
 
 static void InitFlagsOptimization(void) {
 	mf_functions_num=0;
 }
 
+#ifdef DRC_FLAGS_INVALIDATION
+// the condition flags that a function of the given type may change
+static Bitu FlagsChangedBy(Bitu flags_type) {
+	switch (flags_type) {
+		case t_INCb: case t_INCw: case t_INCd:
+		case t_DECb: case t_DECw: case t_DECd:
+			return FMASK_TEST & ~FLAG_CF;
+		case t_ROLb: case t_ROLw: case t_ROLd:
+		case t_RORb: case t_RORw: case t_RORd:
+			return FLAG_CF | FLAG_OF;
+		default:
+			return FMASK_TEST;
+	}
+}
+
+// the condition flags that a function of the given type always changes,
+// shifts and rotates leave all flags alone if the count is zero
+static Bitu FlagsDestroyedBy(Bitu flags_type) {
+	switch (flags_type) {
+		case t_INCb: case t_INCw: case t_INCd:
+		case t_DECb: case t_DECw: case t_DECd:
+			return FMASK_TEST & ~FLAG_CF;
+		case t_ADCb: case t_ADCw: case t_ADCd:
+		case t_SBBb: case t_SBBw: case t_SBBd:
+			return FMASK_TEST;
+		default:
+			return 0;
+	}
+}
+
+// drop the flags that are overwritten by the current instruction from the
+// queued functions, the ones that provide no flags anymore are replaced by
+// their simpler variants
+static void KillQueuedFlags(Bitu flags_mask) {
+	if (!flags_mask) return;
+	Bitu num=0;
+	for (Bitu ct=0; ct<mf_functions_num; ct++) {
+		mf_functions[ct].live_flags&=~flags_mask;
+		if (mf_functions[ct].live_flags) {
+			mf_functions[num++]=mf_functions[ct];
+		} else {
+			gen_fill_function_ptr(mf_functions[ct].pos,mf_functions[ct].fct_ptr,mf_functions[ct].ftype);
+		}
+	}
+	mf_functions_num=num;
+}
+
+static void QueueFlagsFunction(void* current_simple_function,const uint8_t* cpos,Bitu flags_type) {
+	KillQueuedFlags(FlagsDestroyedBy(flags_type));
+	// the dropped functions simply keep generating their flags
+	if (mf_functions_num==(sizeof(mf_functions)/sizeof(mf_functions[0])))
+		mf_functions_num=0;
+	mf_functions[mf_functions_num].pos=cpos;
+	mf_functions[mf_functions_num].fct_ptr=current_simple_function;
+	mf_functions[mf_functions_num].ftype=flags_type;
+	mf_functions[mf_functions_num].live_flags=FlagsChangedBy(flags_type);
+	++mf_functions_num;
+}
+#endif
+
 // replace all queued functions with their simpler variants
 // because the current instruction destroys all condition flags and
 // the flags are not required before
 static void InvalidateFlags(void) {
 #ifdef DRC_FLAGS_INVALIDATION
-	for (Bitu ct=0; ct<mf_functions_num; ct++) {
-		gen_fill_function_ptr(mf_functions[ct].pos,mf_functions[ct].fct_ptr,mf_functions[ct].ftype);
-	}
-	mf_functions_num=0;
+	KillQueuedFlags(FMASK_TEST);
 #endif
 }
 
@@ -1163,43 +1232,40 @@ static void InvalidateFlags(void) {
 // the flags are not required before
 static void InvalidateFlags(void* current_simple_function,Bitu flags_type) {
 #ifdef DRC_FLAGS_INVALIDATION
-	for (Bitu ct=0; ct<mf_functions_num; ct++) {
-		gen_fill_function_ptr(mf_functions[ct].pos,mf_functions[ct].fct_ptr,mf_functions[ct].ftype);
-	}
-	mf_functions_num=1;
-	mf_functions[0].pos=cache.pos;
-	mf_functions[0].fct_ptr=current_simple_function;
-	mf_functions[0].ftype=flags_type;
+	KillQueuedFlags(FMASK_TEST);
+	QueueFlagsFunction(current_simple_function,cache.pos,flags_type);
 #endif
 }
 
-// enqueue this instruction, if later an instruction is encountered that
-// destroys all condition flags and the flags weren't needed in-between
-// this function can be replaced by a simpler one as well
+// enqueue this instruction, if later instructions destroy all condition
+// flags it provides and the flags weren't needed in-between this function
+// can be replaced by a simpler one as well
 static void InvalidateFlagsPartially(void* current_simple_function,Bitu flags_type) {
 #ifdef DRC_FLAGS_INVALIDATION
-	mf_functions[mf_functions_num].pos=cache.pos;
-	mf_functions[mf_functions_num].fct_ptr=current_simple_function;
-	mf_functions[mf_functions_num].ftype=flags_type;
-	++mf_functions_num;
+	QueueFlagsFunction(current_simple_function,cache.pos,flags_type);
 #endif
 }
 
-// enqueue this instruction, if later an instruction is encountered that
-// destroys all condition flags and the flags weren't needed in-between
-// this function can be replaced by a simpler one as well
+// enqueue this instruction, if later instructions destroy all condition
+// flags it provides and the flags weren't needed in-between this function
+// can be replaced by a simpler one as well
 static void InvalidateFlagsPartially(void* current_simple_function,const uint8_t* cpos,Bitu flags_type) {
 #ifdef DRC_FLAGS_INVALIDATION
-	mf_functions[mf_functions_num].pos=cpos;
-	mf_functions[mf_functions_num].fct_ptr=current_simple_function;
-	mf_functions[mf_functions_num].ftype=flags_type;
-	++mf_functions_num;
+	QueueFlagsFunction(current_simple_function,cpos,flags_type);
 #endif
 }
 
-// the current function needs the condition flags thus reset the queue
+// the current function needs the condition flags in flags_mask, thus
+// remove the functions that may provide them from the queue; functions
+// that only change other flags (like inc before adc) stay optimizable
 static void AcquireFlags([[maybe_unused]] Bitu flags_mask) {
 #ifdef DRC_FLAGS_INVALIDATION
-	mf_functions_num=0;
+	Bitu num=0;
+	for (Bitu ct=0; ct<mf_functions_num; ct++) {
+		if (!(mf_functions[ct].live_flags & flags_mask)) {
+			mf_functions[num++]=mf_functions[ct];
+		}
+	}
+	mf_functions_num=num;
 #endif
 }
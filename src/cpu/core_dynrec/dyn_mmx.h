@@ -14,6 +14,24 @@ extern uint32_t* lookupRMEAregd[256];
 #define SaveMd(off, val) mem_writed_inline(off, val)
 #define SaveMq(off, val) mem_writeq_inline(off, val)
 
+// Register to register moves and clears don't need any SIMD, so they're
+// emitted inline as two 32-bit moves per register instead of calling the
+// helpers. These are by far the most frequent MMX instructions.
+
+static void dyn_mmx_copy_reg(MMX_reg* dest, MMX_reg* src)
+{
+	gen_mov_word_to_reg(FC_OP1, &src->ud.d0, true);
+	gen_mov_word_from_reg(FC_OP1, &dest->ud.d0, true);
+	gen_mov_word_to_reg(FC_OP1, &src->ud.d1, true);
+	gen_mov_word_from_reg(FC_OP1, &dest->ud.d1, true);
+}
+
+static void dyn_mmx_clear_reg(MMX_reg* reg)
+{
+	gen_mov_direct_dword(&reg->ud.d0, 0);
+	gen_mov_direct_dword(&reg->ud.d1, 0);
+}
+
 static void mmx_movd_pqed(const Bitu rm, const PhysPt eaa = 0)
 {
 	auto rmrq = lookupRMregMM[rm];
@@ -36,7 +54,10 @@ static void dyn_mmx_movd_pqed()
 		dyn_fill_ea(FC_ADDR);
 		gen_call_function_IR((void*)mmx_movd_pqed, decode.modrm.val, FC_ADDR);
 	} else {
-		gen_call_function_I((void*)mmx_movd_pqed, decode.modrm.val);
+		auto dest = reg_mmx[decode.modrm.reg];
+		MOV_REG_WORD32_TO_HOST_REG(FC_OP1, decode.modrm.rm);
+		gen_mov_word_from_reg(FC_OP1, &dest->ud.d0, true);
+		gen_mov_direct_dword(&dest->ud.d1, 0);
 	}
 }
 
@@ -60,7 +81,8 @@ static void dyn_mmx_movd_edpq()
 		dyn_fill_ea(FC_ADDR);
 		gen_call_function_IR((void*)mmx_movd_edpq, decode.modrm.val, FC_ADDR);
 	} else {
-		gen_call_function_I((void*)mmx_movd_edpq, decode.modrm.val);
+		gen_mov_word_to_reg(FC_OP1, &reg_mmx[decode.modrm.reg]->ud.d0, true);
+		MOV_REG_WORD32_FROM_HOST_REG(FC_OP1, decode.modrm.rm);
 	}
 }
 
@@ -83,8 +105,8 @@ static void dyn_mmx_movq_pqqq()
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
 		gen_call_function_IR((void*)mmx_movq_pqqq, decode.modrm.val, FC_ADDR);
-	} else {
-		gen_call_function_I((void*)mmx_movq_pqqq, decode.modrm.val);
+	} else if (decode.modrm.reg != decode.modrm.rm) {
+		dyn_mmx_copy_reg(reg_mmx[decode.modrm.reg], reg_mmx[decode.modrm.rm]);
 	}
 }
 
@@ -107,8 +129,8 @@ static void dyn_mmx_movq_qqpq()
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
 		gen_call_function_IR((void*)mmx_movq_qqpq, decode.modrm.val, FC_ADDR);
-	} else {
-		gen_call_function_I((void*)mmx_movq_qqpq, decode.modrm.val);
+	} else if (decode.modrm.reg != decode.modrm.rm) {
+		dyn_mmx_copy_reg(reg_mmx[decode.modrm.rm], reg_mmx[decode.modrm.reg]);
 	}
 }
 
@@ -1399,6 +1421,9 @@ static void dyn_mmx_pxor()
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
 		gen_call_function_IR((void*)mmx_pxor, decode.modrm.val, FC_ADDR);
+	} else if (decode.modrm.reg == decode.modrm.rm) {
+		// PXOR mm,mm is the usual way to zero a register
+		dyn_mmx_clear_reg(reg_mmx[decode.modrm.reg]);
 	} else {
 		gen_call_function_I((void*)mmx_pxor, decode.modrm.val);
 	}
@@ -174,6 +174,12 @@ typedef uint8_t HostReg;
 // used to hold the address of "core_dynrec.readdata" - filled in function gen_run_code
 #define readdata_addr HOST_r22
 
+// used to hold the address of "CPU_Cycles" - filled in function gen_run_code
+#define cycles_addr HOST_r23
+
+// used to hold the address of "cache.block.running" - filled in function gen_run_code
+#define block_running_addr HOST_r24
+
 
 // instruction encodings
 
@@ -392,6 +398,8 @@ static bool gen_mov_memval_to_reg(HostReg dest_reg, void *data, Bitu size) {
 	if (gen_mov_memval_to_reg_helper(dest_reg, (uint64_t)data, size, FC_REGS_ADDR, (uint64_t)&cpu_regs)) return true;
 	if (gen_mov_memval_to_reg_helper(dest_reg, (uint64_t)data, size, readdata_addr, (uint64_t)&core_dynrec.readdata)) return true;
 	if (gen_mov_memval_to_reg_helper(dest_reg, (uint64_t)data, size, FC_SEGS_ADDR, (uint64_t)&Segs)) return true;
+	if (gen_mov_memval_to_reg_helper(dest_reg, (uint64_t)data, size, cycles_addr, (uint64_t)&CPU_Cycles)) return true;
+	if (gen_mov_memval_to_reg_helper(dest_reg, (uint64_t)data, size, block_running_addr, (uint64_t)&cache.block.running)) return true;
 	return false;
 }
 
@@ -506,6 +514,8 @@ static bool gen_mov_memval_from_reg(HostReg src_reg, void *dest, Bitu size) {
 	if (gen_mov_memval_from_reg_helper(src_reg, (uint64_t)dest, size, FC_REGS_ADDR, (uint64_t)&cpu_regs)) return true;
 	if (gen_mov_memval_from_reg_helper(src_reg, (uint64_t)dest, size, readdata_addr, (uint64_t)&core_dynrec.readdata)) return true;
 	if (gen_mov_memval_from_reg_helper(src_reg, (uint64_t)dest, size, FC_SEGS_ADDR, (uint64_t)&Segs)) return true;
+	if (gen_mov_memval_from_reg_helper(src_reg, (uint64_t)dest, size, cycles_addr, (uint64_t)&CPU_Cycles)) return true;
+	if (gen_mov_memval_from_reg_helper(src_reg, (uint64_t)dest, size, block_running_addr, (uint64_t)&cache.block.running)) return true;
 	return false;
 }
 
@@ -860,12 +870,13 @@ static void inline gen_fill_branch_long(const uint8_t* data) {
 }
 
 static void gen_run_code(void) {
-	const uint8_t *pos1, *pos2, *pos3;
+	const uint8_t *pos1, *pos2, *pos3, *pos4, *pos5;
 
-	cache_addd( 0xa9bd7bfd );                                           // stp fp, lr, [sp, #-48]!
+	cache_addd( 0xa9bc7bfd );                                           // stp fp, lr, [sp, #-64]!
 	cache_addd( 0x910003fd );                                           // mov fp, sp
 	cache_addd( STP64_IMM(FC_ADDR, FC_REGS_ADDR, HOST_sp, 16) );        // stp FC_ADDR, FC_REGS_ADDR, [sp, #16]
 	cache_addd( STP64_IMM(FC_SEGS_ADDR, readdata_addr, HOST_sp, 32) );  // stp FC_SEGS_ADDR, readdata_addr, [sp, #32]
+	cache_addd( STP64_IMM(cycles_addr, block_running_addr, HOST_sp, 48) ); // stp cycles_addr, block_running_addr, [sp, #48]
 
 	pos1 = cache.pos;
 	cache_addd( 0 );
@@ -873,6 +884,10 @@ static void gen_run_code(void) {
 	cache_addd( 0 );
 	pos3 = cache.pos;
 	cache_addd( 0 );
+	pos4 = cache.pos;
+	cache_addd( 0 );
+	pos5 = cache.pos;
+	cache_addd( 0 );
 
 	cache_addd( BR(HOST_x0) );			// br x0
 
@@ -890,6 +905,12 @@ static void gen_run_code(void) {
 	cache_addd(LDR64_PC(readdata_addr, cache.pos - pos3),pos3);  // ldr readdata_addr, [pc, #(&core_dynrec.readdata)]
 	cache_addq((uint64_t)&core_dynrec.readdata);      // address of "core_dynrec.readdata"
 
+	cache_addd(LDR64_PC(cycles_addr, cache.pos - pos4),pos4);    // ldr cycles_addr, [pc, #(&CPU_Cycles)]
+	cache_addq((uint64_t)&CPU_Cycles);                // address of "CPU_Cycles"
+
+	cache_addd(LDR64_PC(block_running_addr, cache.pos - pos5),pos5); // ldr block_running_addr, [pc, #(&cache.block.running)]
+	cache_addq((uint64_t)&cache.block.running);       // address of "cache.block.running"
+
 	// align cache.pos to 32 bytes
 	if ((((Bitu)cache.pos) & 0x1f) != 0) {
 		cache.pos = cache.pos + (32 - (((Bitu)cache.pos) & 0x1f));
@@ -900,7 +921,8 @@ static void gen_run_code(void) {
 static void gen_return_function(void) {
 	cache_addd( LDP64_IMM(FC_ADDR, FC_REGS_ADDR, HOST_sp, 16) );        // ldp FC_ADDR, FC_REGS_ADDR, [sp, #16]
 	cache_addd( LDP64_IMM(FC_SEGS_ADDR, readdata_addr, HOST_sp, 32) );  // ldp FC_SEGS_ADDR, readdata_addr, [sp, #32]
-	cache_addd( 0xa8c37bfd );                                           // ldp fp, lr, [sp], #48
+	cache_addd( LDP64_IMM(cycles_addr, block_running_addr, HOST_sp, 48) ); // ldp cycles_addr, block_running_addr, [sp, #48]
+	cache_addd( 0xa8c47bfd );                                           // ldp fp, lr, [sp], #64
 	cache_addd( RET );                                                  // ret
 }
 
@@ -1092,6 +1092,21 @@
 				{
 					Bitu cb=Fetchw();
 					FillFlags();SAVEIP;
+#if defined(CPU_CALLBACK_DECODER)
+					// Run the handler here instead of unwinding to the
+					// main loop; continuing picks up the CS:IP and mode
+					// it leaves behind. Stop requests and decoder
+					// switches still have to leave the core.
+					if (cb < CB_MAX && cpudecoder == &CPU_CALLBACK_DECODER) {
+						if ((*Callback_Handlers[cb])() != CBRET_NONE) {
+							return -1;
+						}
+						if (cpudecoder != &CPU_CALLBACK_DECODER) {
+							return CBRET_NONE;
+						}
+						continue;
+					}
+#endif
 					return cb;
 				}
 			default:
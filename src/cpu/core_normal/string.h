@@ -3,8 +3,312 @@
 
 #include "cpu/string_ops.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include "cpu/paging.h"
+#include "hardware/port.h"
+
 #define LoadD(_BLAH) _BLAH
 
+// Bulk paths for forward REP MOVS, STOS, LODS, INS and OUTS. They work on runs of
+// elements that stay within one page on both the source and the destination
+// side, and only while the TLB maps those pages straight to host memory.
+// Anything else (MMIO, the VGA planar handlers, pages that still have to be
+// faulted in, and pages holding dynamic core code) is handed back to the
+// per-element loops in DoString.
+//
+// INS and OUTS additionally need a block handler on the port (see
+// IO_RegisterBlockReadHandler); other ports keep the per-element path.
+//
+// The heavy debugger checks memory breakpoints on every read, so it always
+// takes the per-element path.
+#if C_HEAVY_DEBUGGER
+constexpr bool BulkStringOps = false;
+#else
+constexpr bool BulkStringOps = true;
+#endif
+
+// Number of whole elements, up to 'count', that can be accessed upwards from
+// 'base + index' before crossing a page or the segment's address mask.
+// Returns 0 if the next element itself straddles a page, and sets 'wraps' if
+// it's the address mask that stops the run.
+template <typename T>
+static inline uint32_t string_run(const PhysPt base, const uint32_t index,
+                                  const uint32_t add_mask,
+                                  const uint32_t count, bool& wraps)
+{
+	const auto to_mask_end = static_cast<uint64_t>(add_mask) - index + 1;
+	const auto to_page_end = static_cast<uint64_t>(
+	        MEM_PAGE_SIZE - ((base + index) & (MEM_PAGE_SIZE - 1)));
+
+	wraps = to_mask_end < sizeof(T);
+
+	const auto elements = std::min(to_mask_end, to_page_end) / sizeof(T);
+	return static_cast<uint32_t>(std::min<uint64_t>(count, elements));
+}
+
+template <typename T>
+static inline T string_load(const PhysPt address)
+{
+	if constexpr (sizeof(T) == 1) {
+		return LoadMb(address);
+	} else if constexpr (sizeof(T) == 2) {
+		return LoadMw(address);
+	} else {
+		return LoadMd(address);
+	}
+}
+
+template <typename T>
+static inline void string_save(const PhysPt address, const T val)
+{
+	if constexpr (sizeof(T) == 1) {
+		SaveMb(address, val);
+	} else if constexpr (sizeof(T) == 2) {
+		SaveMw(address, val);
+	} else {
+		SaveMd(address, val);
+	}
+}
+
+template <typename T>
+static inline T string_host_read(const HostPt ptr)
+{
+	if constexpr (sizeof(T) == 1) {
+		return host_readb(ptr);
+	} else if constexpr (sizeof(T) == 2) {
+		return host_readw(ptr);
+	} else {
+		return host_readd(ptr);
+	}
+}
+
+template <typename T>
+static inline void string_host_write(const HostPt ptr, const T val)
+{
+	if constexpr (sizeof(T) == 1) {
+		host_writeb(ptr, val);
+	} else if constexpr (sizeof(T) == 2) {
+		host_writew(ptr, val);
+	} else {
+		host_writed(ptr, val);
+	}
+}
+
+// Each of the bulk helpers returns the number of elements left for the
+// per-element loop to finish off
+
+template <typename T>
+static uint32_t string_bulk_movs(const PhysPt si_base, const PhysPt di_base,
+                                 uint32_t& si_index, uint32_t& di_index,
+                                 const uint32_t add_mask, uint32_t count)
+{
+	while (count > 0) {
+		const PhysPt src = si_base + si_index;
+		const PhysPt dst = di_base + di_index;
+
+		const auto src_host = get_tlb_read(src);
+		const auto dst_host = get_tlb_write(dst);
+		if (!src_host || !dst_host) {
+			break;
+		}
+
+		bool src_wraps = false;
+		bool dst_wraps = false;
+
+		const auto n = std::min(
+		        string_run<T>(si_base, si_index, add_mask, count, src_wraps),
+		        string_run<T>(di_base, di_index, add_mask, count, dst_wraps));
+
+		if (n == 0) {
+			if (src_wraps || dst_wraps) {
+				break;
+			}
+			// Move the element straddling the page boundary the
+			// slow way, then carry on with the next page
+			string_save<T>(dst, string_load<T>(src));
+			si_index = (si_index + sizeof(T)) & add_mask;
+			di_index = (di_index + sizeof(T)) & add_mask;
+			--count;
+			continue;
+		}
+
+		const auto num_bytes = n * sizeof(T);
+		const auto from      = src_host + src;
+		const auto to        = dst_host + dst;
+
+		// Moving upwards element by element into a destination that
+		// overlaps the source from above repeats the leading bytes,
+		// which memmove wouldn't do
+		if (to > from && to < from + num_bytes) {
+			break;
+		}
+		std::memmove(to, from, num_bytes);
+
+		si_index = (si_index + num_bytes) & add_mask;
+		di_index = (di_index + num_bytes) & add_mask;
+		count -= n;
+	}
+	return count;
+}
+
+template <typename T>
+static uint32_t string_bulk_stos(const PhysPt di_base, uint32_t& di_index,
+                                 const uint32_t add_mask, const T val,
+                                 uint32_t count)
+{
+	while (count > 0) {
+		const PhysPt dst = di_base + di_index;
+
+		const auto dst_host = get_tlb_write(dst);
+		if (!dst_host) {
+			break;
+		}
+
+		bool wraps   = false;
+		const auto n = string_run<T>(di_base, di_index, add_mask, count, wraps);
+
+		if (n == 0) {
+			if (wraps) {
+				break;
+			}
+			string_save<T>(dst, val);
+			di_index = (di_index + sizeof(T)) & add_mask;
+			--count;
+			continue;
+		}
+
+		const auto to = dst_host + dst;
+		if constexpr (sizeof(T) == 1) {
+			std::memset(to, val, n);
+		} else {
+			for (uint32_t i = 0; i < n; ++i) {
+				string_host_write<T>(to + i * sizeof(T), val);
+			}
+		}
+
+		di_index = (di_index + n * sizeof(T)) & add_mask;
+		count -= n;
+	}
+	return count;
+}
+
+template <typename T>
+static uint32_t string_bulk_lods(const PhysPt si_base, uint32_t& si_index,
+                                 const uint32_t add_mask, T& val, uint32_t count)
+{
+	while (count > 0) {
+		const PhysPt src = si_base + si_index;
+
+		const auto src_host = get_tlb_read(src);
+		if (!src_host) {
+			break;
+		}
+
+		bool wraps   = false;
+		const auto n = string_run<T>(si_base, si_index, add_mask, count, wraps);
+
+		if (n == 0) {
+			if (wraps) {
+				break;
+			}
+			val      = string_load<T>(src);
+			si_index = (si_index + sizeof(T)) & add_mask;
+			--count;
+			continue;
+		}
+
+		// Reads from host memory have no side effects, so only the last
+		// element of the run matters
+		val = string_host_read<T>(src_host + src + (n - 1) * sizeof(T));
+
+		si_index = (si_index + n * sizeof(T)) & add_mask;
+		count -= n;
+	}
+	return count;
+}
+
+template <typename T>
+static constexpr io_width_t string_io_width()
+{
+	if constexpr (sizeof(T) == 1) {
+		return io_width_t::byte;
+	} else if constexpr (sizeof(T) == 2) {
+		return io_width_t::word;
+	} else {
+		return io_width_t::dword;
+	}
+}
+
+// Stops at the first run the port's block handler doesn't take in full, as
+// the port's state may have changed (for example at the end of a sector)
+template <typename T>
+static uint32_t string_bulk_ins(const PhysPt di_base, uint32_t& di_index,
+                                const uint32_t add_mask, const io_port_t port,
+                                uint32_t count)
+{
+	while (count > 0) {
+		const PhysPt dst = di_base + di_index;
+
+		const auto dst_host = get_tlb_write(dst);
+		if (!dst_host) {
+			break;
+		}
+
+		bool wraps   = false;
+		const auto n = string_run<T>(di_base, di_index, add_mask, count, wraps);
+		if (n == 0) {
+			break;
+		}
+
+		const auto num_read = IO_ReadBlock(port,
+		                                   string_io_width<T>(),
+		                                   dst_host + dst,
+		                                   n);
+
+		di_index = (di_index + num_read * sizeof(T)) & add_mask;
+		count -= num_read;
+		if (num_read < n) {
+			break;
+		}
+	}
+	return count;
+}
+
+template <typename T>
+static uint32_t string_bulk_outs(const PhysPt si_base, uint32_t& si_index,
+                                 const uint32_t add_mask, const io_port_t port,
+                                 uint32_t count)
+{
+	while (count > 0) {
+		const PhysPt src = si_base + si_index;
+
+		const auto src_host = get_tlb_read(src);
+		if (!src_host) {
+			break;
+		}
+
+		bool wraps   = false;
+		const auto n = string_run<T>(si_base, si_index, add_mask, count, wraps);
+		if (n == 0) {
+			break;
+		}
+
+		const auto num_written = IO_WriteBlock(port,
+		                                       string_io_width<T>(),
+		                                       src_host + src,
+		                                       n);
+
+		si_index = (si_index + num_written * sizeof(T)) & add_mask;
+		count -= num_written;
+		if (num_written < n) {
+			break;
+		}
+	}
+	return count;
+}
+
 static void DoString(STRING_OP type) {
 	const auto si_base = BaseDS;
 	const auto di_base = SegBase(es);
@@ -37,6 +341,10 @@ static void DoString(STRING_OP type) {
 	auto add_index = cpu.direction;
 	if (count) switch (type) {
 	case R_OUTSB:
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_outs<uint8_t>(
+			        si_base, si_index, add_mask, reg_dx, count);
+		}
 		for (;count>0;count--) {
 			IO_WriteB(reg_dx,LoadMb(si_base+si_index));
 			si_index=(si_index+add_index) & add_mask;
@@ -44,6 +352,10 @@ static void DoString(STRING_OP type) {
 		break;
 	case R_OUTSW:
 		add_index *= 2;
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_outs<uint16_t>(
+			        si_base, si_index, add_mask, reg_dx, count);
+		}
 		for (;count>0;count--) {
 			IO_WriteW(reg_dx,LoadMw(si_base+si_index));
 			si_index=(si_index+add_index) & add_mask;
@@ -51,12 +363,20 @@ static void DoString(STRING_OP type) {
 		break;
 	case R_OUTSD:
 		add_index *= 4;
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_outs<uint32_t>(
+			        si_base, si_index, add_mask, reg_dx, count);
+		}
 		for (;count>0;count--) {
 			IO_WriteD(reg_dx,LoadMd(si_base+si_index));
 			si_index=(si_index+add_index) & add_mask;
 		}
 		break;
 	case R_INSB:
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_ins<uint8_t>(
+			        di_base, di_index, add_mask, reg_dx, count);
+		}
 		for (;count>0;count--) {
 			SaveMb(di_base+di_index,IO_ReadB(reg_dx));
 			di_index=(di_index+add_index) & add_mask;
@@ -64,6 +384,10 @@ static void DoString(STRING_OP type) {
 		break;
 	case R_INSW:
 		add_index *= 2;
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_ins<uint16_t>(
+			        di_base, di_index, add_mask, reg_dx, count);
+		}
 		for (;count>0;count--) {
 			SaveMw(di_base+di_index,IO_ReadW(reg_dx));
 			di_index=(di_index+add_index) & add_mask;
@@ -71,12 +395,20 @@ static void DoString(STRING_OP type) {
 		break;
 	case R_INSD:
 		add_index *= 4;
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_ins<uint32_t>(
+			        di_base, di_index, add_mask, reg_dx, count);
+		}
 		for (;count>0;count--) {
 			SaveMd(di_base+di_index,IO_ReadD(reg_dx));
 			di_index=(di_index+add_index) & add_mask;
 		}
 		break;
 	case R_STOSB:
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_stos<uint8_t>(
+			        di_base, di_index, add_mask, reg_al, count);
+		}
 		for (;count>0;count--) {
 			SaveMb(di_base+di_index,reg_al);
 			di_index=(di_index+add_index) & add_mask;
@@ -84,6 +416,10 @@ static void DoString(STRING_OP type) {
 		break;
 	case R_STOSW:
 		add_index *= 2;
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_stos<uint16_t>(
+			        di_base, di_index, add_mask, reg_ax, count);
+		}
 		for (;count>0;count--) {
 			SaveMw(di_base+di_index,reg_ax);
 			di_index=(di_index+add_index) & add_mask;
@@ -91,12 +427,20 @@ static void DoString(STRING_OP type) {
 		break;
 	case R_STOSD:
 		add_index *= 4;
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_stos<uint32_t>(
+			        di_base, di_index, add_mask, reg_eax, count);
+		}
 		for (;count>0;count--) {
 			SaveMd(di_base+di_index,reg_eax);
 			di_index=(di_index+add_index) & add_mask;
 		}
 		break;
 	case R_MOVSB:
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_movs<uint8_t>(
+			        si_base, di_base, si_index, di_index, add_mask, count);
+		}
 		for (;count>0;count--) {
 			SaveMb(di_base+di_index,LoadMb(si_base+si_index));
 			di_index=(di_index+add_index) & add_mask;
@@ -105,6 +449,10 @@ static void DoString(STRING_OP type) {
 		break;
 	case R_MOVSW:
 		add_index *= 2;
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_movs<uint16_t>(
+			        si_base, di_base, si_index, di_index, add_mask, count);
+		}
 		for (;count>0;count--) {
 			SaveMw(di_base+di_index,LoadMw(si_base+si_index));
 			di_index=(di_index+add_index) & add_mask;
@@ -113,6 +461,10 @@ static void DoString(STRING_OP type) {
 		break;
 	case R_MOVSD:
 		add_index *= 4;
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_movs<uint32_t>(
+			        si_base, di_base, si_index, di_index, add_mask, count);
+		}
 		for (;count>0;count--) {
 			SaveMd(di_base+di_index,LoadMd(si_base+si_index));
 			di_index=(di_index+add_index) & add_mask;
@@ -120,6 +472,10 @@ static void DoString(STRING_OP type) {
 		}
 		break;
 	case R_LODSB:
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_lods<uint8_t>(
+			        si_base, si_index, add_mask, reg_al, count);
+		}
 		for (;count>0;count--) {
 			reg_al=LoadMb(si_base+si_index);
 			si_index=(si_index+add_index) & add_mask;
@@ -127,6 +483,10 @@ static void DoString(STRING_OP type) {
 		break;
 	case R_LODSW:
 		add_index *= 2;
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_lods<uint16_t>(
+			        si_base, si_index, add_mask, reg_ax, count);
+		}
 		for (;count>0;count--) {
 			reg_ax=LoadMw(si_base+si_index);
 			si_index=(si_index+add_index) & add_mask;
@@ -134,6 +494,10 @@ static void DoString(STRING_OP type) {
 		break;
 	case R_LODSD:
 		add_index *= 4;
+		if (BulkStringOps && add_index > 0) {
+			count = string_bulk_lods<uint32_t>(
+			        si_base, si_index, add_mask, reg_eax, count);
+		}
 		for (;count>0;count--) {
 			reg_eax=LoadMd(si_base+si_index);
 			si_index=(si_index+add_index) & add_mask;
@@ -42,6 +42,10 @@ extern Bitu cycle_count;
 
 #define CPU_TRAP_DECODER	CPU_Core_Simple_Trap_Run
 
+// Callback handlers are run without leaving the core while this decoder is
+// the active one
+#define CPU_CALLBACK_DECODER	CPU_Core_Simple_Run
+
 #define OPCODE_NONE			0x000
 #define OPCODE_0F			0x100
 #define OPCODE_SIZE			0x200
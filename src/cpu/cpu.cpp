@@ -12,6 +12,8 @@
 #include "config/config.h"
 #include "config/setup.h"
 #include "cpu/cpu.h"
+#include "cpu/dyn_profiler.h"
+#include "cpu/guest_profiler.h"
 #include "cpu/paging.h"
 #include "debugger/debugger.h"
 #include "dos/programs.h"
@@ -19,6 +21,8 @@
 #include "gui/mapper.h"
 #include "gui/titlebar.h"
 #include "hardware/pic.h"
+#include "hardware/port.h"
+#include "hardware/snapshot.h"
 #include "lazyflags.h"
 #include "misc/support.h"
 #include "misc/video.h"
@@ -79,6 +83,14 @@ static constexpr auto CpuCycleStepMax     = 1'000'000;
 static constexpr auto DefaultCpuCycleUp   = 10;
 static constexpr auto DefaultCpuCycleDown = 20;
 
+// Dynamic core code cache size in megabytes
+static constexpr auto MinDynamicCoreCacheSizeMb     = 4;
+static constexpr auto MaxDynamicCoreCacheSizeMb     = 64;
+static constexpr auto DefaultDynamicCoreCacheSizeMb = 8;
+
+static constexpr auto MaxDynamicCoreTranslationBudget = 10000;
+static constexpr auto MaxDynamicCoreTierThreshold     = 100000;
+
 static int cpu_cycle_up   = 0;
 static int cpu_cycle_down = 0;
 
@@ -107,13 +119,19 @@ void CPU_Core_Simple_Init();
 #if C_DYNAMIC_X86
 void CPU_Core_Dyn_X86_Init();
 void CPU_Core_Dyn_X86_Cache_Init(bool enable_cache);
+void CPU_Core_Dyn_X86_Cache_SetSize(int size_mb);
 void CPU_Core_Dyn_X86_Cache_Close();
+DynCacheStats CPU_Core_Dyn_X86_Cache_GetStats();
 void CPU_Core_Dyn_X86_SetFPUMode(bool dh_fpu);
 
 #elif C_DYNREC
 void CPU_Core_Dynrec_Init();
 void CPU_Core_Dynrec_Cache_Init(bool enable_cache);
+void CPU_Core_Dynrec_Cache_SetSize(int size_mb);
+void CPU_Core_Dynrec_SetTranslationBudget(int blocks_per_ms);
+void CPU_Core_Dynrec_SetTierThreshold(int num_entries);
 void CPU_Core_Dynrec_Cache_Close();
+DynCacheStats CPU_Core_Dynrec_Cache_GetStats();
 #endif
 
 /* In debug mode exceptions are tested and dosbox exits when
@@ -2301,6 +2319,14 @@ void CPU_HLT(Bitu oldeip)
 	cpudecoder          = &hlt_decode;
 }
 
+void CPU_SkipIdleCycles()
+{
+	// Accounted like HLT so the skipped cycles don't count as work for
+	// the auto cycles adjustment
+	CPU_IODelayRemoved += CPU_Cycles;
+	CPU_Cycles = 0;
+}
+
 void CPU_ENTER(bool use32,Bitu bytes,Bitu level) {
 	level&=0x1f;
 	Bitu sp_index=reg_esp&cpu.stack.mask;
@@ -2596,6 +2622,49 @@ static void cpu_decrease_cycles(bool pressed)
 	TITLEBAR_NotifyCyclesChanged();
 }
 
+#if C_DYNAMIC_X86 || C_DYNREC
+static void log_dynamic_core_profile(bool pressed)
+{
+	if (!pressed) {
+		return;
+	}
+	if (!dyn_profiler_enabled) {
+		LOG_WARNING("CPU: Set 'dynamic_core_profiler = on' to profile the "
+		            "dynamic core");
+		return;
+	}
+	DYN_PROFILER_LogReport();
+}
+
+static void reset_dynamic_core_profile(bool pressed)
+{
+	if (pressed && dyn_profiler_enabled) {
+		DYN_PROFILER_Reset();
+	}
+}
+#endif
+
+static void write_guest_profile()
+{
+	GUEST_PROFILER_LogReport();
+	GUEST_PROFILER_WriteFolded("guest_profile.folded");
+}
+
+static void toggle_guest_profiler(bool pressed)
+{
+	if (!pressed) {
+		return;
+	}
+	if (GUEST_PROFILER_IsRunning()) {
+		GUEST_PROFILER_Stop();
+		write_guest_profile();
+		return;
+	}
+	const auto rate_hz = get_section("cpu")->GetInt("guest_profiler");
+	GUEST_PROFILER_Start(rate_hz > 0 ? rate_hz : DefaultGuestProfilerRateHz);
+	LOG_MSG("CPU: Guest profiler started at %d Hz", GUEST_PROFILER_GetRate());
+}
+
 void CPU_ResetAutoAdjust()
 {
 	CPU_IODelayRemoved = 0;
@@ -2604,6 +2673,17 @@ void CPU_ResetAutoAdjust()
 	DOSBOX_SetTicksScheduled(0);
 }
 
+DynCacheStats CPU_GetDynCacheStats()
+{
+#if C_DYNAMIC_X86
+	return CPU_Core_Dyn_X86_Cache_GetStats();
+#elif C_DYNREC
+	return CPU_Core_Dynrec_Cache_GetStats();
+#else
+	return {};
+#endif
+}
+
 std::string CPU_GetCyclesConfigAsString()
 {
 	if (legacy_cycles_mode) {
@@ -2745,6 +2825,25 @@ public:
 		                  "cycleup",
 		                  "Inc Cycles");
 
+#if C_DYNAMIC_X86 || C_DYNREC
+		MAPPER_AddHandler(log_dynamic_core_profile,
+		                  SDL_SCANCODE_UNKNOWN,
+		                  0,
+		                  "dynprofile",
+		                  "Dyn Profile");
+		MAPPER_AddHandler(reset_dynamic_core_profile,
+		                  SDL_SCANCODE_UNKNOWN,
+		                  0,
+		                  "dynprofreset",
+		                  "Dyn Prof Reset");
+#endif
+
+		MAPPER_AddHandler(toggle_guest_profiler,
+		                  SDL_SCANCODE_UNKNOWN,
+		                  0,
+		                  "guestprofile",
+		                  "Guest Profile");
+
 		Configure(sec);
 
 		// Set up the first CPU core
@@ -3173,6 +3272,27 @@ public:
 		const std::string cpu_core = secprop->GetString("core");
 		const std::string cpu_type = secprop->GetString("cputype");
 
+#if C_DYNAMIC_X86
+		CPU_Core_Dyn_X86_Cache_SetSize(
+		        secprop->GetInt("dynamic_core_cache_size"));
+#elif C_DYNREC
+		CPU_Core_Dynrec_Cache_SetSize(
+		        secprop->GetInt("dynamic_core_cache_size"));
+		CPU_Core_Dynrec_SetTranslationBudget(
+		        secprop->GetInt("dynamic_core_translation_budget"));
+		CPU_Core_Dynrec_SetTierThreshold(
+		        secprop->GetInt("dynamic_core_tier_threshold"));
+#endif
+
+#if C_DYNAMIC_X86 || C_DYNREC
+		DYN_PROFILER_SetEnabled(secprop->GetBool("dynamic_core_profiler"));
+#endif
+
+		if (const auto rate_hz = secprop->GetInt("guest_profiler");
+		    rate_hz > 0 && !GUEST_PROFILER_IsRunning()) {
+			GUEST_PROFILER_Start(rate_hz);
+		}
+
 		ConfigureCpuCore(cpu_core);
 		ConfigureCpuType(cpu_core, cpu_type);
 
@@ -3209,6 +3329,7 @@ public:
 		cpu_cycle_down = secprop->GetInt("cycledown");
 
 		should_hlt_on_idle = secprop->GetBool("cpu_idle");
+		IO_SetIdlePollDetection(secprop->GetBool("cpu_idle_polling"));
 
 		TITLEBAR_NotifyCyclesChanged();
 
@@ -3226,10 +3347,38 @@ void CPU_Init()
 	auto section = get_section("cpu");
 
 	cpu_instance = std::make_unique<Cpu>(section);
+
+	SNAPSHOT_AddComponent("cpu", [] {
+		const auto regs        = cpu_regs;
+		const auto segs        = Segs;
+		const auto block       = cpu;
+		const auto flags       = lflags;
+		const auto cycles      = CPU_Cycles;
+		const auto cycles_left = CPU_CycleLeft;
+		const auto decoder     = cpudecoder;
+
+		return [=] {
+			cpu_regs      = regs;
+			Segs          = segs;
+			cpu           = block;
+			lflags        = flags;
+			CPU_Cycles    = cycles;
+			CPU_CycleLeft = cycles_left;
+			cpudecoder    = decoder;
+		};
+	});
 }
 
 void CPU_Destroy()
 {
+	if (dyn_profiler_enabled) {
+		DYN_PROFILER_LogReport();
+	}
+	if (GUEST_PROFILER_IsRunning()) {
+		GUEST_PROFILER_Stop();
+		write_guest_profile();
+	}
+
 #if C_DYNAMIC_X86
 	CPU_Core_Dyn_X86_Cache_Close();
 #elif C_DYNREC
@@ -3285,6 +3434,68 @@ void init_cpu_config_settings(SectionProp& secprop)
 	        "            Programs that self-modify their code might misbehave or crash on\n"
 	        "            the 'dynamic' core; use the 'normal' core for such programs.");
 
+	auto pint = secprop.AddInt("dynamic_core_cache_size",
+	                           OnlyAtStart,
+	                           DefaultDynamicCoreCacheSizeMb);
+	pint->SetMinMax(MinDynamicCoreCacheSizeMb, MaxDynamicCoreCacheSizeMb);
+	pint->SetHelp(format_str(
+	        "Size of the 'dynamic' core's code cache in megabytes (%d by default).\n"
+	        "Valid range is from %d to %d. The pools of translated blocks and code pages\n"
+	        "scale along with it. Larger caches can reduce stuttering in protected mode\n"
+	        "programs with a lot of code (e.g., Windows 3.x or large DOS4GW games) that\n"
+	        "otherwise keep flushing and retranslating code. The number of cache flushes\n"
+	        "and code page evictions is logged on exit to help with tuning.",
+	        DefaultDynamicCoreCacheSizeMb,
+	        MinDynamicCoreCacheSizeMb,
+	        MaxDynamicCoreCacheSizeMb));
+
+	pint = secprop.AddInt("dynamic_core_translation_budget", OnlyAtStart, 0);
+	pint->SetMinMax(0, MaxDynamicCoreTranslationBudget);
+	pint->SetHelp(format_str(
+	        "Maximum number of new code blocks the 'dynamic' core translates per emulated\n"
+	        "millisecond (0 by default, meaning no limit). Valid range is from 0 to %d.\n"
+	        "Code that doesn't fit the budget runs on the 'normal' core until the next\n"
+	        "millisecond, which spreads the translation work of bursts of new code (e.g.,\n"
+	        "level loads or protected mode programs starting up) and can smooth out the\n"
+	        "resulting stutters. Values around 50 to 200 work well; only available with\n"
+	        "the 'dynrec' variant of the 'dynamic' core.",
+	        MaxDynamicCoreTranslationBudget));
+
+	pint = secprop.AddInt("dynamic_core_tier_threshold", OnlyAtStart, 0);
+	pint->SetMinMax(0, MaxDynamicCoreTierThreshold);
+	pint->SetHelp(format_str(
+	        "Number of times the 'dynamic' core runs new code on the 'normal' core before\n"
+	        "translating it (0 by default, meaning new code is translated right away).\n"
+	        "Valid range is from 0 to %d. Code is counted per 4 KB page, so pages that\n"
+	        "only run briefly (e.g., initialisation code and loaders) are never\n"
+	        "translated, while hot pages are translated after the threshold. Values\n"
+	        "around 10 to 100 work well. The share of cycles spent in each core and the\n"
+	        "time spent translating are logged on exit and exported as metrics; only\n"
+	        "available with the 'dynrec' variant of the 'dynamic' core.",
+	        MaxDynamicCoreTierThreshold));
+
+	auto pbool = secprop.AddBool("dynamic_core_profiler", OnlyAtStart, false);
+	pbool->SetHelp(
+	        "Record how often each block translated by the 'dynamic' core is entered,\n"
+	        "how many cycles it takes, and how often it's invalidated by self-modifying\n"
+	        "code ('off' by default). The hottest blocks are logged on exit and with the\n"
+	        "'Dyn Profile' hotkey (unbound by default); the 'Dyn Prof Reset' hotkey starts\n"
+	        "a new profile. Translated blocks are not linked together while profiling, so\n"
+	        "the emulation runs slower.");
+
+	pint = secprop.AddInt("guest_profiler", OnlyAtStart, 0);
+	pint->SetMinMax(0, MaxGuestProfilerRateHz);
+	pint->SetHelp(format_str(
+	        "Sample where the guest code spends its time, at the given rate in Hz\n"
+	        "(0 by default, disabled). The busiest programs and CS:EIP locations are\n"
+	        "logged on exit, and written to 'guest_profile.folded' as folded stacks for\n"
+	        "flame graph tools. The 'Guest Profile' hotkey (unbound by default) starts\n"
+	        "the profiler, or stops it and writes the report (at %d Hz if 0 is set here).\n"
+	        "Sampling doesn't slow down the emulation. Valid rates are %d to %d Hz.",
+	        DefaultGuestProfilerRateHz,
+	        MinGuestProfilerRateHz,
+	        MaxGuestProfilerRateHz));
+
 	pstring = secprop.AddString("cputype", Always, "auto");
 	pstring->SetValues(
 	        {"auto", "386", "386_fast", "386_prefetch", "486", "pentium", "pentium_mmx"});
@@ -3405,7 +3616,7 @@ void init_cpu_config_settings(SectionProp& secprop)
 	        CpuCyclesMin,
 	        CpuCyclesMax));
 
-	auto pbool = secprop.AddBool("cpu_throttle", Always, CpuThrottleDefault);
+	pbool = secprop.AddBool("cpu_throttle", Always, CpuThrottleDefault);
 	pbool->SetHelp(
 	        format_str("Throttle down the number of emulated CPU cycles dynamically if your host CPU\n"
 	                   "cannot keep up (%s by default). Only affects fixed cycles settings. When\n"
@@ -3413,7 +3624,7 @@ void init_cpu_config_settings(SectionProp& secprop)
 	                   "in some DOS programs.",
 	                   (CpuThrottleDefault ? "'on'" : "'off'")));
 
-	auto pint = secprop.AddInt("cycleup", Always, DefaultCpuCycleUp);
+	pint = secprop.AddInt("cycleup", Always, DefaultCpuCycleUp);
 	pint->SetMinMax(CpuCycleStepMin, CpuCycleStepMax);
 	pint->SetHelp(
 	        format_str("Number of cycles to add with the 'Inc Cycles' hotkey (%d by default).\n"
@@ -3433,6 +3644,13 @@ void init_cpu_config_settings(SectionProp& secprop)
 	        "idle ('on' by default). This is done by emulating the HLT CPU instruction, so\n"
 	        "it might interfere with other power management tools such as DOSidle and FDAPM\n"
 	        "when enabled.");
+
+	pbool = secprop.AddBool("cpu_idle_polling", Always, false);
+	pbool->SetHelp(
+	        "Reduce the CPU usage when programs busy-wait by reading the same value from an\n"
+	        "I/O port over and over, such as the VGA status port or the keyboard controller\n"
+	        "('off' by default). The polling is skipped until the next emulated device\n"
+	        "event. Programs that time raster effects by polling may glitch when enabled.");
 }
 
 bool CPU_ShouldHltOnIdle()
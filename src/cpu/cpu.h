@@ -114,6 +114,24 @@ Bits CPU_Core_Prefetch_Trap_Run() noexcept;
 
 void CPU_ResetAutoAdjust();
 
+// Code cache counters of the dynamic core; see CPU_GetDynCacheStats()
+struct DynCacheStats {
+	// False if the build has no dynamic core or its cache isn't set up yet
+	bool is_available = false;
+
+	size_t size_bytes = 0;
+
+	// Translated code up to the cache's write position; stays at the full
+	// size once the cache has been flushed
+	size_t used_bytes = 0;
+
+	uint64_t flushes           = 0;
+	uint64_t page_evictions    = 0;
+	uint64_t smc_invalidations = 0;
+};
+
+DynCacheStats CPU_GetDynCacheStats();
+
 extern uint16_t parity_lookup[256];
 
 bool CPU_LLDT(Bitu selector);
@@ -155,6 +173,9 @@ void CPU_RET(bool use32, Bitu bytes, Bitu oldeip);
 void CPU_IRET(bool use32, Bitu oldeip);
 void CPU_HLT(Bitu oldeip);
 
+// End the current cycle slice early because the guest is busy-waiting
+void CPU_SkipIdleCycles();
+
 bool CPU_POPF(Bitu use32);
 bool CPU_PUSHF(Bitu use32);
 bool CPU_CLI();
@@ -4,17 +4,25 @@
 
 #include <cassert>
 #include <cerrno>
+#include <cinttypes>
 #include <new>
 #include <type_traits>
+#include <vector>
 
 #include "utils/mem_unaligned.h"
+#include "cpu/dyn_profiler.h"
 #include "cpu/paging.h"
+#include "misc/host_memory.h"
 #include "misc/types.h"
 
 #if defined(HAVE_MMAP)
 #include <sys/mman.h>
 #endif
 
+#if defined(HAVE_MEMFD_CREATE)
+#include <unistd.h>
+#endif
+
 #if defined(HAVE_PTHREAD_WRITE_PROTECT_NP)
 #include <pthread.h>
 #endif
@@ -66,9 +74,11 @@ public:
 
 		Bitu size        = 0;
 		CacheBlock* next = {};
-		// writemap masking maskpointer/start/length to allow holes in
-		// the writemap
-		uint8_t* wmapmask = {};
+		// writemap masking bitset/start/length to allow holes in the
+		// writemap; a set bit means the byte at maskstart + bit index
+		// is not counted in the writemap for this block. The length is
+		// the number of bytes covered, always a multiple of 64.
+		uint64_t* wmapmask = {};
 		uint16_t maskstart = 0;
 		uint16_t masklen   = 0;
 
@@ -78,10 +88,19 @@ public:
 		inline void AddWordToWriteMaskAt(const size_t page_index);
 		inline void AddDwordToWriteMaskAt(const size_t page_index);
 
+		// Check if the byte at the offset from maskstart is masked
+		inline bool IsMaskedAt(const size_t mask_offset) const
+		{
+			return mask_offset < masklen &&
+			       ((wmapmask[mask_offset / 64] >> (mask_offset % 64)) & 1);
+		}
+
 	private:
 		inline void GrowWriteMask(const uint16_t new_mask_len);
 		size_t GrowMaskForTypeAt(const uint8_t type_size,
 		                         const size_t page_index);
+		inline void SetMaskBits(const size_t mask_offset,
+		                        const uint8_t num_bits);
 	} cache = {};
 
 	struct Hash {
@@ -98,7 +117,17 @@ public:
 		                       // to this block
 	} link[2] = {};                // maximum two links (conditional jumps)
 
+	// last target of the indirect jump, call, or return ending this
+	// block; only a prediction, checked against CS:EIP before it's used
+	struct Indirect {
+		CacheBlock* to = {};
+		PhysPt ip      = 0;
+	} indirect = {};
+
 	CacheBlock* crossblock = {};
+
+	// entry in the hot-block profiler, only set when profiling
+	DynBlockId profile_id = DynBlockIdNone;
 };
 
 static_assert(std::is_standard_layout_v<CacheBlock::Page>, "standard-layout is required for offsetof");
@@ -134,7 +163,32 @@ static uint8_t* cache_code_start_ptr   = {};
 static uint8_t* cache_code             = {};
 static uint8_t* cache_code_link_blocks = {};
 
-static std::vector<CacheBlock> cache_blocks(CACHE_BLOCKS);
+// When the code cache is mapped twice, once writable and once executable,
+// the generated code is written through the writable view at this offset
+// from the executable one and the permissions never need to change.
+static uintptr_t cache_write_offset = 0;
+static bool cache_is_dual_mapped    = false;
+
+// Code cache sizing; CACHE_TOTAL, CACHE_BLOCKS and CACHE_PAGES are the
+// defaults for an 8 MB cache, cache_set_size() scales all three before the
+// cache is allocated.
+static size_t cache_total      = CACHE_TOTAL;
+static size_t cache_num_blocks = CACHE_BLOCKS;
+static size_t cache_num_pages  = CACHE_PAGES;
+
+// Counters to help tune the cache size per program
+static struct {
+	// the code cache ran full and translation restarted from the
+	// beginning, overwriting the oldest blocks
+	uint64_t flushes = 0;
+	// no free code page handlers were left, so the oldest page and all
+	// its blocks were discarded
+	uint64_t page_evictions = 0;
+	// blocks cleared because the guest wrote to their code
+	uint64_t smc_invalidations = 0;
+} cache_stats = {};
+
+static std::vector<CacheBlock> cache_blocks = {};
 static CacheBlock link_blocks[2] = {}; // default linking (specially marked)
 
 // the CodePageHandler class provides access to the contained
@@ -159,6 +213,7 @@ public:
 
 		active_blocks=0;
 		active_count=16;
+		num_interpreted_entries = 0;
 
 		// initialize the maps with zero (no cache blocks as well as
 		// code present)
@@ -195,6 +250,10 @@ public:
 				// test if this block is in the range
 				if (start<=block->page.end && end>=block->page.start) {
 					if (ip_point<=block->page.end && ip_point>=block->page.start) is_current_block=true;
+					++cache_stats.smc_invalidations;
+					if (dyn_profiler_enabled) {
+						DYN_PROFILER_AddSmcInvalidation(block->profile_id);
+					}
 					block->Clear(); // clear the block,
 					                // decrements the
 					                // write_map accordingly
@@ -453,8 +512,7 @@ public:
 			     i++, maskct++) {
 				if (write_map[i]) {
 					// only adjust writemap if it isn't masked
-					if ((maskct >= block->cache.masklen) ||
-					    (!block->cache.wmapmask[maskct])) {
+					if (!block->cache.IsMaskedAt(maskct)) {
 						write_map[i]--;
 					}
 				}
@@ -513,6 +571,11 @@ public:
 		return nullptr; // none found
 	}
 
+	Bitu GetPhysPage() const
+	{
+		return phys_page;
+	}
+
 	HostPt GetHostReadPt(Bitu phys_page) override
 	{
 		hostmem = old_pagehandler->GetHostReadPt(phys_page);
@@ -530,6 +593,10 @@ public:
 	uint8_t write_map[4096] = {};
 	uint8_t *invalidation_map = nullptr;
 
+	// number of times code in this page was run on the normal core
+	// before the page was considered hot enough to translate
+	uint32_t num_interpreted_entries = 0;
+
 	CodePageHandler *prev = nullptr;
 	CodePageHandler *next = nullptr;
 
@@ -579,13 +646,15 @@ inline void CacheBlock::Cache::GrowWriteMask(const uint16_t new_mask_len)
 {
 	// This function is only called to increase the mask
 	assert(new_mask_len > masklen);
+	assert(new_mask_len % 64 == 0);
 
-	// Allocate the new mask
-	auto new_mask = new uint8_t[new_mask_len];
-	memset(new_mask, 0, new_mask_len);
+	// Allocate the new mask, cleared
+	const auto old_num_words = masklen / 64;
+	const auto new_num_words = new_mask_len / 64;
+	auto new_mask = new uint64_t[new_num_words]();
 
 	// Copy the current into the new
-	std::copy(wmapmask, wmapmask + masklen, new_mask);
+	std::copy(wmapmask, wmapmask + old_num_words, new_mask);
 
 	// Update the current
 	delete[] wmapmask;
@@ -603,7 +672,7 @@ size_t CacheBlock::Cache::GrowMaskForTypeAt(const uint8_t type_size,
 
 	// Make the map mask if needed
 	if (!wmapmask) {
-		constexpr uint8_t initial_mask_len = 64;
+		constexpr uint16_t initial_mask_len = 64;
 		GrowWriteMask(initial_mask_len);
 		maskstart = check_cast<uint16_t>(page_index);
 	}
@@ -613,8 +682,9 @@ size_t CacheBlock::Cache::GrowMaskForTypeAt(const uint8_t type_size,
 		const size_t map_offset_end = map_offset + type_size;
 		if (map_offset_end >= masklen) {
 			size_t new_mask_len = masklen * 4;
-			if (new_mask_len < map_offset_end) {
-				new_mask_len = (map_offset_end & ~3) * 2;
+			if (new_mask_len <= map_offset_end) {
+				// round up to the next multiple of 64 bytes
+				new_mask_len = (map_offset_end | 63) + 1;
 			}
 			GrowWriteMask(check_cast<uint16_t>(new_mask_len));
 		}
@@ -623,22 +693,30 @@ size_t CacheBlock::Cache::GrowMaskForTypeAt(const uint8_t type_size,
 	return map_offset;
 }
 
+inline void CacheBlock::Cache::SetMaskBits(const size_t mask_offset,
+                                           const uint8_t num_bits)
+{
+	for (auto i = mask_offset; i < mask_offset + num_bits; ++i) {
+		wmapmask[i / 64] |= uint64_t(1) << (i % 64);
+	}
+}
+
 inline void CacheBlock::Cache::AddByteToWriteMaskAt(const size_t page_index)
 {
 	const auto map_offset = GrowMaskForTypeAt(sizeof(uint8_t), page_index);
-	wmapmask[map_offset] += 0x01;
+	SetMaskBits(map_offset, sizeof(uint8_t));
 }
 
 inline void CacheBlock::Cache::AddWordToWriteMaskAt(const size_t page_index)
 {
 	const auto map_offset = GrowMaskForTypeAt(sizeof(uint16_t), page_index);
-	add_to_unaligned_uint16(wmapmask + map_offset, 0x0101);
+	SetMaskBits(map_offset, sizeof(uint16_t));
 }
 
 inline void CacheBlock::Cache::AddDwordToWriteMaskAt(const size_t page_index)
 {
 	const auto map_offset = GrowMaskForTypeAt(sizeof(uint32_t), page_index);
-	add_to_unaligned_uint32(wmapmask + map_offset, 0x01010101);
+	SetMaskBits(map_offset, sizeof(uint32_t));
 }
 
 void CacheBlock::Clear()
@@ -685,6 +763,27 @@ void CacheBlock::Clear()
 		page.handler=nullptr;
 	}
 	cache.DeleteWriteMask();
+	indirect   = {};
+	profile_id = DynBlockIdNone;
+}
+
+// Register the block with the hot-block profiler when it's first entered;
+// must be called with CS:EIP pointing to the start of the block
+static inline void dyn_profiler_register_block(CacheBlock* block)
+{
+	if (block->profile_id != DynBlockIdNone || !block->page.handler) {
+		return;
+	}
+	const auto phys_addr = check_cast<uint32_t>(
+	        (block->page.handler->GetPhysPage() << 12) + block->page.start);
+
+	const auto size_bytes = block->page.end - block->page.start + 1;
+
+	block->profile_id = DYN_PROFILER_RegisterBlock(phys_addr,
+	                                               SegValue(cs),
+	                                               reg_eip,
+	                                               SegPhys(cs) + reg_eip,
+	                                               size_bytes);
 }
 
 static CacheBlock *cache_openblock()
@@ -756,12 +855,13 @@ static void cache_closeblock()
 #if (C_DYNAMIC_X86)
 	const bool cache_is_full = !block->cache.next;
 #elif (C_DYNREC)
-	const uint8_t *limit = (cache_code_start_ptr + CACHE_TOTAL - CACHE_MAXSIZE);
+	const uint8_t *limit = (cache_code_start_ptr + cache_total - CACHE_MAXSIZE);
 	const bool cache_is_full = (!block->cache.next ||
 	                            (block->cache.next->cache.start > limit));
 #endif
 	if (cache_is_full) {
 		// LOG_DEBUG("Cache full; restarting");
+		++cache_stats.flushes;
 		cache.block.active=cache.block.first;
 	} else {
 		cache.block.active=block->cache.next;
@@ -778,11 +878,18 @@ static void cache_closeblock()
 // revert this change bring back the previous version and remove this comment.
 //
 
+// Returns the writable address of the given position in the cache
+static inline uint8_t* cache_writable(const uint8_t* pos)
+{
+	return reinterpret_cast<uint8_t*>(reinterpret_cast<uintptr_t>(pos) +
+	                                  cache_write_offset);
+}
+
 // place an 8bit value into the cache
 
 static inline void cache_addb(uint8_t val, const uint8_t *pos)
 {
-	*const_cast<uint8_t *>(pos) = val;
+	*cache_writable(pos) = val;
 }
 
 static inline void cache_addb(uint8_t val)
@@ -795,7 +902,7 @@ static inline void cache_addb(uint8_t val)
 
 static inline void cache_addw(uint16_t val, const uint8_t *pos)
 {
-	write_unaligned_uint16(const_cast<uint8_t *>(pos), val);
+	write_unaligned_uint16(cache_writable(pos), val);
 }
 
 static inline void cache_addw(uint16_t val)
@@ -808,7 +915,7 @@ static inline void cache_addw(uint16_t val)
 
 static inline void cache_addd(uint32_t val, const uint8_t *pos)
 {
-	write_unaligned_uint32(const_cast<uint8_t *>(pos), val);
+	write_unaligned_uint32(cache_writable(pos), val);
 }
 
 static inline void cache_addd(uint32_t val)
@@ -821,7 +928,7 @@ static inline void cache_addd(uint32_t val)
 
 static inline void cache_addq(uint64_t val, const uint8_t *pos)
 {
-	write_unaligned_uint64(const_cast<uint8_t *>(pos), val);
+	write_unaligned_uint64(cache_writable(pos), val);
 }
 
 static inline void cache_addq(uint64_t val)
@@ -840,7 +947,10 @@ static void cache_block_before_close();
 static void cache_block_closing(const uint8_t *block_start, Bitu block_size);
 #endif
 
-static constexpr size_t cache_code_size = CACHE_TOTAL + CACHE_MAXSIZE + HostPageSize - 1 + HostPageSize;
+static size_t get_cache_code_size()
+{
+	return cache_total + CACHE_MAXSIZE + HostPageSize - 1 + HostPageSize;
+}
 constexpr bool is_64bit_platform = sizeof(void *) == 8;
 
 static inline void dyn_mem_adjust(void *&ptr, size_t &size)
@@ -906,6 +1016,9 @@ static inline void dyn_mem_set_access([[maybe_unused]] void *ptr,
 static inline void dyn_mem_execute(void *ptr, size_t size)
 {
 #if defined(C_PER_PAGE_W_OR_X)
+	if (cache_is_dual_mapped) {
+		return;
+	}
 	dyn_mem_set_access(ptr, size, true);
 #else
 	// Skip per-page execute-flagging
@@ -915,6 +1028,9 @@ static inline void dyn_mem_execute(void *ptr, size_t size)
 static inline void dyn_mem_write(void *ptr, size_t size)
 {
 #if defined(C_PER_PAGE_W_OR_X)
+	if (cache_is_dual_mapped) {
+		return;
+	}
 	dyn_mem_set_access(ptr, size, false);
 #else
 	// Skip per-page write-flagging
@@ -948,8 +1064,139 @@ static inline void dyn_cache_invalidate([[maybe_unused]] void *ptr,
 #endif
 }
 
+[[maybe_unused]] static uint8_t* use_dual_mapping(void* rw, void* rx)
+{
+	cache_write_offset = reinterpret_cast<uintptr_t>(rw) -
+	                     reinterpret_cast<uintptr_t>(rx);
+	cache_is_dual_mapped = true;
+	return static_cast<uint8_t*>(rx);
+}
+
+// Maps the same memory twice, writable and executable, and returns the
+// executable view; returns nullptr if the platform doesn't support it or
+// disallows it (e.g., SELinux's execmem restrictions), in which case the
+// permissions are flipped per block instead.
+static uint8_t* cache_map_dual([[maybe_unused]] const size_t size)
+{
+#if defined(C_PER_PAGE_W_OR_X) && defined(HAVE_MEMFD_CREATE)
+	const auto fd = memfd_create("dosbox-dyncache", MFD_CLOEXEC);
+	if (fd < 0) {
+		return nullptr;
+	}
+	if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+		close(fd);
+		return nullptr;
+	}
+	auto rw = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	auto rx = (rw == MAP_FAILED)
+	                ? MAP_FAILED
+	                : mmap(nullptr, size, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (rx == MAP_FAILED) {
+		if (rw != MAP_FAILED) {
+			munmap(rw, size);
+		}
+		return nullptr;
+	}
+	return use_dual_mapping(rw, rx);
+#elif defined(C_PER_PAGE_W_OR_X) && defined(WIN32)
+	if (CPU_UseRwxMemProtect) {
+		return nullptr; // the cache is RWX anyway
+	}
+	const auto size64 = static_cast<uint64_t>(size);
+
+	auto mapping = CreateFileMappingW(INVALID_HANDLE_VALUE,
+	                                  nullptr,
+	                                  PAGE_EXECUTE_READWRITE | SEC_COMMIT,
+	                                  static_cast<DWORD>(size64 >> 32),
+	                                  static_cast<DWORD>(size64 & 0xffffffff),
+	                                  nullptr);
+	if (!mapping) {
+		return nullptr;
+	}
+	auto rw = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+	auto rx = rw ? MapViewOfFile(mapping, FILE_MAP_READ | FILE_MAP_EXECUTE, 0, 0, size)
+	             : nullptr;
+
+	// The views keep the mapping alive
+	CloseHandle(mapping);
+
+	if (!rx) {
+		if (rw) {
+			UnmapViewOfFile(rw);
+		}
+		return nullptr;
+	}
+	return use_dual_mapping(rw, rx);
+#else
+	// macOS toggles MAP_JIT memory per thread without a system call, so
+	// there's nothing to gain there
+	return nullptr;
+#endif
+}
+
+// Allocates the code cache memory with a single view whose permissions are
+// flipped per block
+static uint8_t* cache_map_single(const size_t cache_code_size)
+{
+#if defined (WIN32)
+	LPVOID lp_vmem = nullptr;
+	if (CPU_UseRwxMemProtect) {
+		lp_vmem = VirtualAlloc(nullptr, cache_code_size,
+		                       MEM_COMMIT,
+		                       PAGE_EXECUTE_READWRITE); // all operations allowed
+	} else {
+		lp_vmem = VirtualAlloc(nullptr, cache_code_size,
+		                       MEM_COMMIT | MEM_RESERVE,
+		                       PAGE_READWRITE); // needs on-going management
+	}
+	assert(lp_vmem);
+	return static_cast<uint8_t *>(lp_vmem);
+#elif defined(HAVE_MMAP)
+	int map_flags = MAP_PRIVATE | MAP_ANON;
+	int prot_flags = PROT_READ | PROT_WRITE | PROT_EXEC;
+#if defined(HAVE_MAP_JIT)
+	map_flags |= MAP_JIT;
+#endif
+	auto ptr = mmap(nullptr, cache_code_size, prot_flags, map_flags, -1, 0);
+	if (ptr == MAP_FAILED) {
+		E_Exit("DYNCACHE: Failed memory-mapping cache memory because: %s", strerror(errno));
+	}
+	return static_cast<uint8_t *>(ptr);
+#else
+	auto ptr = static_cast<uint8_t *>(malloc(cache_code_size));
+	if (!ptr) {
+		E_Exit("DYNCACHE: Failed allocating cache memory because: %s", strerror(errno));
+	}
+	return ptr;
+#endif
+}
+
 static bool cache_initialized = false;
 
+// Set the size of the code cache in megabytes; the block and code page pools
+// are scaled proportionally. Only takes effect before the cache is first
+// initialised as the memory is never reallocated.
+static void cache_set_size(const int size_mb)
+{
+	constexpr size_t default_size_mb = CACHE_TOTAL / (1024 * 1024);
+	assert(size_mb > 0);
+
+	const auto new_total = static_cast<size_t>(size_mb) * 1024 * 1024;
+	if (new_total == cache_total) {
+		return;
+	}
+	if (cache_initialized) {
+		LOG_WARNING("DYNCACHE: Code cache is already allocated, "
+		            "the new size will be used after restart");
+		return;
+	}
+	cache_total      = new_total;
+	cache_num_blocks = (CACHE_BLOCKS / default_size_mb) * size_mb;
+	cache_num_pages  = (CACHE_PAGES / default_size_mb) * size_mb;
+}
+
 static void cache_init(bool enable) {
 	if (enable) {
 		// see if cache is already initialized
@@ -957,44 +1204,25 @@ static void cache_init(bool enable) {
 			return;
 		}
 		cache_initialized = true;
+		cache_blocks = std::vector<CacheBlock>(cache_num_blocks);
 		cache.block.free = &cache_blocks[0];
 		// initialize the cache blocks
-		for (int i=0;i<CACHE_BLOCKS-1;i++) {
+		for (size_t i = 0; i < cache_num_blocks - 1; i++) {
 			cache_blocks[i].link[0].to = (CacheBlock *)1;
 			cache_blocks[i].link[1].to = (CacheBlock *)1;
 			cache_blocks[i].cache.next = &cache_blocks[i + 1];
 		}
 		if (cache_code_start_ptr == nullptr) {
 			// allocate the code cache memory
-#if defined (WIN32)
-			LPVOID lp_vmem = nullptr;
-			if (CPU_UseRwxMemProtect) {
-				lp_vmem = VirtualAlloc(nullptr, cache_code_size,
-				                       MEM_COMMIT,
-				                       PAGE_EXECUTE_READWRITE); // all operations allowed
+			const auto cache_code_size = get_cache_code_size();
+
+			cache_code_start_ptr = cache_map_dual(cache_code_size);
+			if (cache_code_start_ptr) {
+				LOG_MSG("DYNCACHE: Using separate writable and executable "
+				        "views of the code cache");
 			} else {
-				lp_vmem = VirtualAlloc(nullptr, cache_code_size,
-				                       MEM_COMMIT | MEM_RESERVE,
-				                       PAGE_READWRITE); // needs on-going management
-			}
-			assert(lp_vmem);
-			cache_code_start_ptr = static_cast<uint8_t *>(lp_vmem);
-#elif defined(HAVE_MMAP)
-			int map_flags = MAP_PRIVATE | MAP_ANON;
-			int prot_flags = PROT_READ | PROT_WRITE | PROT_EXEC;
-#if defined(HAVE_MAP_JIT)
-			map_flags |= MAP_JIT;
-#endif
-			cache_code_start_ptr=static_cast<uint8_t *>(mmap(nullptr, cache_code_size, prot_flags, map_flags, -1, 0));
-			if (cache_code_start_ptr == MAP_FAILED) {
-				E_Exit("DYNCACHE: Failed memory-mapping cache memory because: %s", strerror(errno));
-			}
-#else
-			cache_code_start_ptr=static_cast<uint8_t *>(malloc(cache_code_size));
-			if (!cache_code_start_ptr) {
-				E_Exit("DYNCACHE: Failed allocating cache memory because: %s", strerror(errno));
+				cache_code_start_ptr = cache_map_single(cache_code_size);
 			}
-#endif
 			// align the cache at a page boundary
 			cache_code = reinterpret_cast<uint8_t *>(
 			    (reinterpret_cast<uintptr_t>(cache_code_start_ptr) +
@@ -1006,7 +1234,7 @@ static void cache_init(bool enable) {
 			cache.block.first=block;
 			cache.block.active=block;
 			block->cache.start=&cache_code[0];
-			block->cache.size=CACHE_TOTAL;
+			block->cache.size=cache_total;
 			block->cache.next = nullptr; // last block in the list
 		}
 
@@ -1056,7 +1284,7 @@ static void cache_init(bool enable) {
 		cache.last_page=nullptr;
 		cache.used_pages=nullptr;
 		// setup the code pages
-		for (int i=0;i<CACHE_PAGES;i++) {
+		for (size_t i = 0; i < cache_num_pages; i++) {
 			auto newpage = new (std::nothrow) CodePageHandler();
 			if (!newpage) {
 				E_Exit("DYN_CACHE: Failed to allocate code-page handler");
@@ -1064,10 +1292,47 @@ static void cache_init(bool enable) {
 			newpage->next = cache.free_pages;
 			cache.free_pages=newpage;
 		}
+
+		// The cache is never freed
+		HOST_MEMORY_AddSubsystem("Dynamic core code cache", [] {
+			return get_cache_code_size() +
+			       cache_blocks.size() * sizeof(CacheBlock) +
+			       cache_num_pages * sizeof(CodePageHandler);
+		});
 	}
 }
 
+static DynCacheStats cache_get_stats()
+{
+	DynCacheStats stats = {};
+	if (!cache_initialized || !cache.block.active) {
+		return stats;
+	}
+
+	stats.is_available = true;
+	stats.size_bytes   = cache_total;
+
+	const auto position = static_cast<size_t>(cache.block.active->cache.start -
+	                                          cache_code);
+
+	stats.used_bytes = cache_stats.flushes > 0 ? cache_total
+	                                           : std::min(position, cache_total);
+
+	stats.flushes           = cache_stats.flushes;
+	stats.page_evictions    = cache_stats.page_evictions;
+	stats.smc_invalidations = cache_stats.smc_invalidations;
+	return stats;
+}
+
 static void cache_close(void) {
+	if (cache_initialized) {
+		LOG_MSG("DYNCACHE: %zu MB code cache, %" PRIu64 " flushes, %" PRIu64
+		        " code page evictions, %" PRIu64 " SMC invalidations",
+		        cache_total / (1024 * 1024),
+		        cache_stats.flushes,
+		        cache_stats.page_evictions,
+		        cache_stats.smc_invalidations);
+	}
 /*	for (;;) {
 		if (cache.used_pages) {
 			CodePageHandler * cpage=cache.used_pages;
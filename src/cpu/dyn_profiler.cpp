@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "cpu/dyn_profiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <unordered_map>
+#include <vector>
+
+#include "dosbox.h"
+#include "misc/support.h"
+
+bool dyn_profiler_enabled = false;
+
+// Number of blocks listed in the report
+constexpr int MaxReportedBlocks = 50;
+
+struct BlockProfile {
+	uint32_t phys_addr   = 0;
+	uint32_t linear_addr = 0;
+	uint32_t eip         = 0;
+	uint16_t cs          = 0;
+	int size_bytes       = 0;
+
+	int64_t entries           = 0;
+	int64_t cycles            = 0;
+	int64_t smc_invalidations = 0;
+	int64_t translations      = 0;
+};
+
+static struct {
+	std::vector<BlockProfile> blocks = {};
+
+	// Physical start address to index into 'blocks'
+	std::unordered_map<uint32_t, size_t> index_by_addr = {};
+
+	int64_t core_switches = 0;
+	int64_t fpu_syncs     = 0;
+} profiler = {};
+
+void DYN_PROFILER_SetEnabled(const bool enabled)
+{
+	dyn_profiler_enabled = enabled;
+}
+
+DynBlockId DYN_PROFILER_RegisterBlock(const uint32_t phys_addr,
+                                      const uint16_t cs, const uint32_t eip,
+                                      const uint32_t linear_addr,
+                                      const int size_bytes)
+{
+	auto [it, inserted] = profiler.index_by_addr.try_emplace(
+	        phys_addr, profiler.blocks.size());
+
+	if (inserted) {
+		profiler.blocks.push_back({phys_addr, linear_addr, eip, cs, size_bytes});
+	}
+
+	auto& block = profiler.blocks[it->second];
+
+	// The same physical code can be retranslated after an invalidation,
+	// possibly into a block of a different size
+	block.size_bytes = size_bytes;
+	++block.translations;
+
+	return check_cast<DynBlockId>(it->second + 1);
+}
+
+static BlockProfile* get_block(const DynBlockId id)
+{
+	if (id == DynBlockIdNone || id > profiler.blocks.size()) {
+		return nullptr;
+	}
+	return &profiler.blocks[id - 1];
+}
+
+void DYN_PROFILER_AddEntry(const DynBlockId id, const int cycles)
+{
+	if (auto block = get_block(id); block) {
+		++block->entries;
+		block->cycles += cycles;
+	}
+}
+
+void DYN_PROFILER_AddSmcInvalidation(const DynBlockId id)
+{
+	if (auto block = get_block(id); block) {
+		++block->smc_invalidations;
+	}
+}
+
+void DYN_PROFILER_AddCoreSwitch(const bool synced_fpu)
+{
+	++profiler.core_switches;
+	if (synced_fpu) {
+		++profiler.fpu_syncs;
+	}
+}
+
+void DYN_PROFILER_LogReport()
+{
+	if (profiler.core_switches) {
+		LOG_MSG("DYNPROF: %" PRId64 " switches to and from the normal core, "
+		        "%" PRId64 " copied the FPU state",
+		        profiler.core_switches,
+		        profiler.fpu_syncs);
+	}
+
+	if (profiler.blocks.empty()) {
+		LOG_MSG("DYNPROF: No blocks have been profiled");
+		return;
+	}
+
+	std::vector<const BlockProfile*> sorted = {};
+	sorted.reserve(profiler.blocks.size());
+
+	int64_t total_entries = 0;
+	int64_t total_cycles  = 0;
+
+	for (const auto& block : profiler.blocks) {
+		sorted.push_back(&block);
+		total_entries += block.entries;
+		total_cycles += block.cycles;
+	}
+
+	std::sort(sorted.begin(), sorted.end(), [](const auto a, const auto b) {
+		return a->entries > b->entries;
+	});
+
+	LOG_MSG("DYNPROF: %zu blocks, %" PRId64 " entries, %" PRId64 " cycles",
+	        profiler.blocks.size(),
+	        total_entries,
+	        total_cycles);
+
+	LOG_MSG("DYNPROF:   CS:EIP          linear    size       entries  "
+	        "cycles%%   SMC  trans");
+
+	const auto num_reported = std::min(sorted.size(),
+	                                   static_cast<size_t>(MaxReportedBlocks));
+
+	for (size_t i = 0; i < num_reported; ++i) {
+		const auto& b = *sorted[i];
+
+		const auto cycles_percent = total_cycles
+		                                  ? 100.0 * static_cast<double>(b.cycles) /
+		                                            static_cast<double>(total_cycles)
+		                                  : 0.0;
+
+		LOG_MSG("DYNPROF:   %04x:%08x  %08x  %4d  %12" PRId64
+		        "  %6.2f  %4" PRId64 "  %5" PRId64,
+		        b.cs,
+		        b.eip,
+		        b.linear_addr,
+		        b.size_bytes,
+		        b.entries,
+		        cycles_percent,
+		        b.smc_invalidations,
+		        b.translations);
+	}
+}
+
+void DYN_PROFILER_Reset()
+{
+	// The translated blocks keep their IDs, so only the counts are cleared
+	for (auto& block : profiler.blocks) {
+		block.entries           = 0;
+		block.cycles            = 0;
+		block.smc_invalidations = 0;
+		block.translations      = 0;
+	}
+	profiler.core_switches = 0;
+	profiler.fpu_syncs     = 0;
+
+	LOG_MSG("DYNPROF: Profile reset");
+}
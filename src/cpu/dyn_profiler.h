@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_DYN_PROFILER_H
+#define DOSBOX_DYN_PROFILER_H
+
+#include <cstdint>
+
+// Hot-block profiler for the dynamic cores (dyn_x86 and dynrec).
+//
+// When enabled, the dynamic cores stop linking translated blocks together so
+// every block entry goes through the core's dispatch loop, where it's counted
+// along with the number of emulated cycles the block consumed. Blocks are
+// tracked by the physical address of their first instruction, so the
+// statistics survive the block being cleared and retranslated.
+//
+// Invalidations caused by self-modifying code are counted as well; a high
+// count is a good indicator that a program runs better on the normal core.
+
+// Block IDs are 1-based; 0 means the block hasn't been registered yet
+using DynBlockId = uint32_t;
+
+constexpr DynBlockId DynBlockIdNone = 0;
+
+extern bool dyn_profiler_enabled;
+
+void DYN_PROFILER_SetEnabled(const bool enabled);
+
+// Look up or create the profile entry of a block starting at the given
+// physical address
+DynBlockId DYN_PROFILER_RegisterBlock(const uint32_t phys_addr,
+                                      const uint16_t cs, const uint32_t eip,
+                                      const uint32_t linear_addr,
+                                      const int size_bytes);
+
+void DYN_PROFILER_AddEntry(const DynBlockId id, const int cycles);
+void DYN_PROFILER_AddSmcInvalidation(const DynBlockId id);
+
+// Count a switch between the dynamic and the normal core, and whether the
+// FPU state had to be copied between them
+void DYN_PROFILER_AddCoreSwitch(const bool synced_fpu);
+
+// Log the hottest blocks sorted by entry count
+void DYN_PROFILER_LogReport();
+
+// Start a new profile, e.g., right before the part of a program of interest
+void DYN_PROFILER_Reset();
+
+#endif // DOSBOX_DYN_PROFILER_H
@@ -0,0 +1,230 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "cpu/guest_profiler.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <fstream>
+#include <unordered_map>
+
+#include "cpu/registers.h"
+#include "dos/dos.h"
+#include "dosbox.h"
+#include "hardware/pic.h"
+#include "misc/support.h"
+#include "utils/string_utils.h"
+
+// Number of programs and locations listed in the report
+constexpr int MaxReportedPrograms  = 10;
+constexpr int MaxReportedLocations = 30;
+
+// Reported for samples taken after a guest OS was booted
+constexpr auto UnknownProgram = "(unknown)";
+
+static struct {
+	bool is_running        = false;
+	int rate_hz            = DefaultGuestProfilerRateHz;
+	uint64_t total_samples = 0;
+
+	// Program names are stored once; the samples refer to them by index
+	std::vector<std::string> programs                     = {};
+	std::unordered_map<std::string, uint16_t> program_ids = {};
+
+	// Program index, CS, and EIP packed into one key
+	std::unordered_map<uint64_t, uint64_t> samples = {};
+} profiler = {};
+
+static uint16_t get_program_id(const std::string& name)
+{
+	const auto it = profiler.program_ids.find(name);
+	if (it != profiler.program_ids.end()) {
+		return it->second;
+	}
+	// Way more than a session will ever run; share the last index if not
+	if (profiler.programs.size() > UINT16_MAX) {
+		return UINT16_MAX;
+	}
+	const auto id = static_cast<uint16_t>(profiler.programs.size());
+	profiler.programs.push_back(name);
+	profiler.program_ids.emplace(name, id);
+	return id;
+}
+
+static uint64_t make_key(const uint16_t program_id, const uint16_t cs,
+                         const uint32_t eip)
+{
+	return (static_cast<uint64_t>(program_id) << 48) |
+	       (static_cast<uint64_t>(cs) << 32) | eip;
+}
+
+static GuestProfileEntry unpack_key(const uint64_t key, const uint64_t samples)
+{
+	const auto program_id = static_cast<uint16_t>(key >> 48);
+	const auto& program   = profiler.programs[program_id];
+
+	return {program.empty() ? UnknownProgram : program,
+	        static_cast<uint16_t>(key >> 32),
+	        static_cast<uint32_t>(key),
+	        samples};
+}
+
+static void sample_event(uint32_t /*val*/)
+{
+	const auto program_id = get_program_id(DOS_GetCurrentProgramName());
+
+	++profiler.samples[make_key(program_id, SegValue(cs), reg_eip)];
+	++profiler.total_samples;
+
+	PIC_AddEvent(sample_event, 1000.0 / profiler.rate_hz);
+}
+
+void GUEST_PROFILER_Start(const int rate_hz)
+{
+	// A restart discards the previous profile, a change of rate doesn't
+	if (!profiler.is_running) {
+		GUEST_PROFILER_Reset();
+	}
+	PIC_RemoveEvents(sample_event);
+
+	profiler.rate_hz = std::clamp(rate_hz,
+	                              MinGuestProfilerRateHz,
+	                              MaxGuestProfilerRateHz);
+
+	profiler.is_running = true;
+
+	PIC_AddEvent(sample_event, 1000.0 / profiler.rate_hz);
+}
+
+void GUEST_PROFILER_Stop()
+{
+	if (profiler.is_running) {
+		PIC_RemoveEvents(sample_event);
+		profiler.is_running = false;
+	}
+}
+
+bool GUEST_PROFILER_IsRunning()
+{
+	return profiler.is_running;
+}
+
+int GUEST_PROFILER_GetRate()
+{
+	return profiler.rate_hz;
+}
+
+uint64_t GUEST_PROFILER_GetTotalSamples()
+{
+	return profiler.total_samples;
+}
+
+std::vector<GuestProfileEntry> GUEST_PROFILER_GetLocations()
+{
+	std::vector<GuestProfileEntry> locations = {};
+	locations.reserve(profiler.samples.size());
+
+	for (const auto& [key, samples] : profiler.samples) {
+		locations.push_back(unpack_key(key, samples));
+	}
+	std::sort(locations.begin(), locations.end(), [](const auto& a, const auto& b) {
+		return a.samples > b.samples;
+	});
+	return locations;
+}
+
+std::vector<GuestProgramProfile> GUEST_PROFILER_GetPrograms()
+{
+	std::vector<uint64_t> samples_by_id(profiler.programs.size());
+	for (const auto& [key, samples] : profiler.samples) {
+		samples_by_id[key >> 48] += samples;
+	}
+
+	std::vector<GuestProgramProfile> programs = {};
+	for (size_t id = 0; id < profiler.programs.size(); ++id) {
+		const auto& name = profiler.programs[id];
+		programs.push_back({name.empty() ? UnknownProgram : name,
+		                    samples_by_id[id]});
+	}
+	std::sort(programs.begin(), programs.end(), [](const auto& a, const auto& b) {
+		return a.samples > b.samples;
+	});
+	return programs;
+}
+
+static double to_percent(const uint64_t samples)
+{
+	return profiler.total_samples ? 100.0 * static_cast<double>(samples) /
+	                                        static_cast<double>(profiler.total_samples)
+	                              : 0.0;
+}
+
+void GUEST_PROFILER_LogReport()
+{
+	if (profiler.total_samples == 0) {
+		LOG_MSG("GUESTPROF: No samples have been taken");
+		return;
+	}
+
+	LOG_MSG("GUESTPROF: %" PRIu64 " samples at %d Hz, %zu locations",
+	        profiler.total_samples,
+	        profiler.rate_hz,
+	        profiler.samples.size());
+
+	const auto programs = GUEST_PROFILER_GetPrograms();
+	LOG_MSG("GUESTPROF:   samples%%  program");
+
+	const auto num_programs = std::min(programs.size(),
+	                                   static_cast<size_t>(MaxReportedPrograms));
+	for (size_t i = 0; i < num_programs; ++i) {
+		LOG_MSG("GUESTPROF:    %6.2f   %s",
+		        to_percent(programs[i].samples),
+		        programs[i].program.c_str());
+	}
+
+	const auto locations = GUEST_PROFILER_GetLocations();
+	LOG_MSG("GUESTPROF:   CS:EIP         samples%%  program");
+
+	const auto num_locations = std::min(locations.size(),
+	                                    static_cast<size_t>(MaxReportedLocations));
+	for (size_t i = 0; i < num_locations; ++i) {
+		const auto& l = locations[i];
+		LOG_MSG("GUESTPROF:   %04x:%08x   %6.2f   %s",
+		        l.cs,
+		        l.eip,
+		        to_percent(l.samples),
+		        l.program.c_str());
+	}
+}
+
+bool GUEST_PROFILER_WriteFolded(const std::string& path)
+{
+	std::ofstream out(path);
+	if (!out.is_open()) {
+		LOG_WARNING("GUESTPROF: Could not create '%s'", path.c_str());
+		return false;
+	}
+
+	for (const auto& l : GUEST_PROFILER_GetLocations()) {
+		// Semicolons separate the frames
+		auto program = l.program;
+		std::replace(program.begin(), program.end(), ';', '_');
+
+		out << program << format_str(";%04x;%04x:%08x %" PRIu64 "\n",
+		                             l.cs,
+		                             l.cs,
+		                             l.eip,
+		                             l.samples);
+	}
+
+	LOG_MSG("GUESTPROF: Wrote the profile to '%s'", path.c_str());
+	return true;
+}
+
+void GUEST_PROFILER_Reset()
+{
+	profiler.total_samples = 0;
+	profiler.programs.clear();
+	profiler.program_ids.clear();
+	profiler.samples.clear();
+}
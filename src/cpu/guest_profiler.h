@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_GUEST_PROFILER_H
+#define DOSBOX_GUEST_PROFILER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Sampling profiler of the guest code.
+//
+// While running, CS:EIP is sampled at a fixed rate of emulated time together
+// with the name of the running DOS program, and counted in a histogram. No
+// instruction is instrumented, so the emulation runs at full speed with any
+// core. The results can be logged, or written as folded stacks (program;
+// code segment;address) for flame graph tools.
+
+constexpr int DefaultGuestProfilerRateHz = 1000;
+constexpr int MinGuestProfilerRateHz     = 10;
+constexpr int MaxGuestProfilerRateHz     = 10000;
+
+struct GuestProfileEntry {
+	std::string program = {};
+	uint16_t cs         = 0;
+	uint32_t eip        = 0;
+	uint64_t samples    = 0;
+};
+
+struct GuestProgramProfile {
+	std::string program = {};
+	uint64_t samples    = 0;
+};
+
+// Starting discards the samples of the previous run; calling it while running
+// only changes the rate
+void GUEST_PROFILER_Start(const int rate_hz);
+void GUEST_PROFILER_Stop();
+bool GUEST_PROFILER_IsRunning();
+int GUEST_PROFILER_GetRate();
+
+uint64_t GUEST_PROFILER_GetTotalSamples();
+
+// Sampled locations and programs, busiest first
+std::vector<GuestProfileEntry> GUEST_PROFILER_GetLocations();
+std::vector<GuestProgramProfile> GUEST_PROFILER_GetPrograms();
+
+// Log the busiest programs and locations
+void GUEST_PROFILER_LogReport();
+
+// Write the samples as folded stacks, one "program;segment;cs:eip count"
+// line per location, as read by flamegraph.pl and speedscope
+bool GUEST_PROFILER_WriteFolded(const std::string& path);
+
+void GUEST_PROFILER_Reset();
+
+#endif // DOSBOX_GUEST_PROFILER_H
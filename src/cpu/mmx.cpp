@@ -92,6 +92,7 @@ MMX_reg* lookupRMregMM[256] = {
 
 void setFPUTagEmpty()
 {
+	fpu_state_changed = true;
 	fpu.tags[0] = TAG_Empty;
 	fpu.tags[1] = TAG_Empty;
 	fpu.tags[2] = TAG_Empty;
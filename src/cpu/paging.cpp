@@ -4,6 +4,7 @@
 
 #include "cpu/paging.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
@@ -13,6 +14,8 @@
 #include "cpu/registers.h"
 #include "debugger/debugger.h"
 #include "hardware/memory.h"
+#include "hardware/pic.h"
+#include "hardware/snapshot.h"
 #include "lazyflags.h"
 
 #define LINK_TOTAL		(64*1024)
@@ -132,24 +135,37 @@ static struct {
 	PF_Entry entries[PF_QUEUESIZE];
 } pf_queue;
 
+// Runs the guest's page fault handler one instruction at a time, so its
+// return to the faulting instruction is noticed right away. The handler's
+// instructions don't advance the emulated time, so a batch of them is run
+// per call instead of going back to the main loop after each one; the batch
+// ends early when an interrupt is pending.
 static Bits PageFaultCore()
 {
+	auto num_instructions = std::max(CPU_Cycles, 1);
+
 	CPU_CycleLeft+=CPU_Cycles;
-	CPU_Cycles=1;
-	Bits ret=CPU_Core_Full_Run();
-	CPU_CycleLeft+=CPU_Cycles;
-	if (ret<0) E_Exit("Got a dosbox close machine in pagefault core?");
-	if (ret) 
-		return ret;
-	if (!pf_queue.used) E_Exit("PF Core without PF");
-	PF_Entry * entry=&pf_queue.entries[pf_queue.used-1];
-	X86PageEntry pentry;
-	pentry.set(phys_readd(entry->page_addr));
-	if (pentry.p && entry->cs == SegValue(cs) && entry->eip == reg_eip) {
-		cpu.mpl = entry->mpl;
-		return -1;
+	while (true) {
+		CPU_Cycles=1;
+		Bits ret=CPU_Core_Full_Run();
+		CPU_CycleLeft+=CPU_Cycles;
+		if (ret<0) E_Exit("Got a dosbox close machine in pagefault core?");
+		if (ret) 
+			return ret;
+		if (!pf_queue.used) E_Exit("PF Core without PF");
+		PF_Entry * entry=&pf_queue.entries[pf_queue.used-1];
+		X86PageEntry pentry;
+		pentry.set(phys_readd(entry->page_addr));
+		if (pentry.p && entry->cs == SegValue(cs) && entry->eip == reg_eip) {
+			cpu.mpl = entry->mpl;
+			return -1;
+		}
+		if (--num_instructions == 0 || PIC_IRQCheck ||
+		    cpudecoder != &PageFaultCore) {
+			CPU_Cycles = 0;
+			return 0;
+		}
 	}
-	return 0;
 }
 
 bool first=false;
@@ -160,6 +176,8 @@ void PAGING_PageFault(PhysPt lin_addr,uint32_t page_addr,uint32_t faultcode) {
 	const auto old_cpudecoder=cpudecoder;
 	cpudecoder=&PageFaultCore;
 	paging.cr2=lin_addr;
+	++paging.stats.page_faults;
+	++paging.stats.nested_page_faults;
 	PF_Entry * entry=&pf_queue.entries[pf_queue.used++];
 	LOG(LOG_PAGING, LOG_NORMAL)("PageFault at %X type [%x] queue %u", lin_addr, faultcode, pf_queue.used);
 	// LOG_MSG("EAX:%04X ECX:%04X EDX:%04X EBX:%04X",reg_eax,reg_ecx,reg_edx,reg_ebx);
@@ -227,6 +245,7 @@ static inline bool InitPageCheckPresence_CheckOnly(PhysPt lin_addr,bool writing,
 	if (!table.p) {
 		paging.cr2         = lin_addr;
 		cpu.exception.which=EXCEPTION_PF;
+		++paging.stats.page_faults;
 		cpu.exception.error=(writing?0x02:0x00) | (((cpu.cpl&cpu.mpl)==0)?0x00:0x04);
 		return false;
 	}
@@ -235,6 +254,7 @@ static inline bool InitPageCheckPresence_CheckOnly(PhysPt lin_addr,bool writing,
 	if (!entry.p) {
 		paging.cr2         = lin_addr;
 		cpu.exception.which=EXCEPTION_PF;
+		++paging.stats.page_faults;
 		cpu.exception.error=(writing?0x02:0x00) | (((cpu.cpl&cpu.mpl)==0)?0x00:0x04);
 		return false;
 	}
@@ -376,6 +396,8 @@ public:
 	}
 	uint32_t InitPage(uint32_t lin_addr, bool writing)
 	{
+		++paging.stats.misses;
+
 		const auto lin_page = lin_addr >> 12;
 		uint32_t phys_page;
 		if (paging.enabled) {
@@ -514,6 +536,7 @@ public:
 				 table.wr);
 				paging.cr2=lin_addr;
 				cpu.exception.which=EXCEPTION_PF;
+				++paging.stats.page_faults;
 				cpu.exception.error=0x05 | (writing?0x02:0x00);
 				return false;
 			}
@@ -612,6 +635,8 @@ public:
 		return true;
 	}
 	void InitPage(uint32_t lin_addr, [[maybe_unused]] uint32_t val) {
+		++paging.stats.misses;
+
 		const auto lin_page=lin_addr >> 12;
 		uint32_t phys_page;
 		if (paging.enabled) {
@@ -673,6 +698,7 @@ public:
 				 table.wr);
 				paging.cr2=lin_addr;
 				cpu.exception.which=EXCEPTION_PF;
+				++paging.stats.page_faults;
 				cpu.exception.error=0x07;
 				return 0;
 			}
@@ -772,6 +798,9 @@ void PAGING_InitTLB()
 
 void PAGING_ClearTLB()
 {
+	++paging.stats.flushes;
+	paging.stats.flushed_entries += paging.links.used;
+
 	uint32_t * entries=&paging.links.entries[0];
 	for (;paging.links.used>0;paging.links.used--) {
 		const auto page=*entries++;
@@ -793,6 +822,24 @@ void PAGING_UnlinkPages(Bitu lin_page,Bitu pages) {
 	}
 }
 
+void PAGING_UnlinkPhysPages(const Bitu phys_page, const Bitu pages)
+{
+	const auto end_page = phys_page + pages;
+
+	auto& links = paging.links;
+	for (uint32_t i = 0; i < links.used;) {
+		const auto lin_page    = links.entries[i];
+		const auto linked_page = paging.tlb.phys_page[lin_page];
+
+		if (linked_page >= phys_page && linked_page < end_page) {
+			PAGING_UnlinkPages(lin_page, 1);
+			links.entries[i] = links.entries[--links.used];
+		} else {
+			++i;
+		}
+	}
+}
+
 void PAGING_MapPage(Bitu lin_page,Bitu phys_page) {
 	if (lin_page<LINK_START) {
 		paging.firstmb[lin_page]=phys_page;
@@ -812,6 +859,7 @@ void PAGING_LinkPage(uint32_t lin_page,uint32_t phys_page) {
 		E_Exit("Illegal page");
 
 	if (paging.links.used >= PAGING_LINKS) {
+		++paging.stats.link_overflows;
 		LOG(LOG_PAGING,LOG_NORMAL)("Not enough paging links, resetting cache");
 		PAGING_ClearTLB();
 		assert(paging.links.used == 0);
@@ -824,6 +872,7 @@ void PAGING_LinkPage(uint32_t lin_page,uint32_t phys_page) {
 	else paging.tlb.write[lin_page]=nullptr;
 
 	paging.links.entries[paging.links.used++]=lin_page;
+	++paging.stats.links;
 	paging.tlb.readhandler[lin_page]=handler;
 	paging.tlb.writehandler[lin_page]=handler;
 }
@@ -835,6 +884,7 @@ void PAGING_LinkPage_ReadOnly(uint32_t lin_page,uint32_t phys_page) {
 		E_Exit("Illegal page");
 
 	if (paging.links.used >= PAGING_LINKS) {
+		++paging.stats.link_overflows;
 		LOG(LOG_PAGING,LOG_NORMAL)("Not enough paging links, resetting cache");
 		PAGING_ClearTLB();
 		assert(paging.links.used == 0);
@@ -846,6 +896,7 @@ void PAGING_LinkPage_ReadOnly(uint32_t lin_page,uint32_t phys_page) {
 	paging.tlb.write[lin_page]=nullptr;
 
 	paging.links.entries[paging.links.used++]=lin_page;
+	++paging.stats.links;
 	paging.tlb.readhandler[lin_page]=handler;
 	paging.tlb.writehandler[lin_page]=&init_page_handler_userro;
 }
@@ -875,6 +926,9 @@ void PAGING_InitTLB()
 
 void PAGING_ClearTLB()
 {
+	++paging.stats.flushes;
+	paging.stats.flushed_entries += paging.links.used;
+
 	uint32_t* entries = &paging.links.entries[0];
 	for (;paging.links.used>0;paging.links.used--) {
 		Bitu page=*entries++;
@@ -898,6 +952,24 @@ void PAGING_UnlinkPages(Bitu lin_page,Bitu pages) {
 	}
 }
 
+void PAGING_UnlinkPhysPages(const Bitu phys_page, const Bitu pages)
+{
+	const auto end_page = phys_page + pages;
+
+	auto& links = paging.links;
+	for (uint32_t i = 0; i < links.used;) {
+		const auto lin_page    = links.entries[i];
+		const auto linked_page = get_tlb_entry(lin_page << 12)->phys_page;
+
+		if (linked_page >= phys_page && linked_page < end_page) {
+			PAGING_UnlinkPages(lin_page, 1);
+			links.entries[i] = links.entries[--links.used];
+		} else {
+			++i;
+		}
+	}
+}
+
 void PAGING_MapPage(Bitu lin_page,Bitu phys_page) {
 	if (lin_page<LINK_START) {
 		paging.firstmb[lin_page]=phys_page;
@@ -918,6 +990,7 @@ void PAGING_LinkPage(uint32_t lin_page, uint32_t phys_page)
 		E_Exit("Illegal page");
 
 	if (paging.links.used>=PAGING_LINKS) {
+		++paging.stats.link_overflows;
 		LOG(LOG_PAGING,LOG_NORMAL)("Not enough paging links, resetting cache");
 		PAGING_ClearTLB();
 	}
@@ -930,6 +1003,7 @@ void PAGING_LinkPage(uint32_t lin_page, uint32_t phys_page)
 	else entry->write=0;
 
  	paging.links.entries[paging.links.used++]=lin_page;
+	++paging.stats.links;
 	entry->readhandler=handler;
 	entry->writehandler=handler;
 }
@@ -942,6 +1016,7 @@ void PAGING_LinkPage_ReadOnly(uint32_t lin_page, uint32_t phys_page)
 		E_Exit("Illegal page");
 
 	if (paging.links.used>=PAGING_LINKS) {
+		++paging.stats.link_overflows;
 		LOG(LOG_PAGING,LOG_NORMAL)("Not enough paging links, resetting cache");
 		PAGING_ClearTLB();
 	}
@@ -953,6 +1028,7 @@ void PAGING_LinkPage_ReadOnly(uint32_t lin_page, uint32_t phys_page)
 	entry->write=0;
 
  	paging.links.entries[paging.links.used++]=lin_page;
+	++paging.stats.links;
 	entry->readhandler=handler;
 	entry->writehandler=&init_page_handler_userro;
 }
@@ -968,10 +1044,16 @@ void PAGING_SetDirBase(Bitu cr3) {
 	paging.base.addr=static_cast<PhysPt>(cr3 & ~4095);
 //	LOG(LOG_PAGING,LOG_NORMAL)("CR3:%X Base %X",cr3,paging.base.page);
 	if (paging.enabled) {
+		++paging.stats.cr3_reloads;
 		PAGING_ClearTLB();
 	}
 }
 
+const PagingTlbStats& PAGING_GetTlbStats()
+{
+	return paging.stats;
+}
+
 void PAGING_Enable(bool enabled) {
 	/* If paging is disabled, we work from a default paging table */
 	if (paging.enabled==enabled) return;
@@ -1014,4 +1096,16 @@ static std::unique_ptr<PAGING> paging_instance = {};
 void PAGING_Init()
 {
 	paging_instance = std::make_unique<PAGING>();
+
+	// The TLB is rebuilt from the page tables in the restored RAM
+	SNAPSHOT_AddComponent("paging", [] {
+		const auto cr3     = paging.cr3;
+		const auto enabled = paging.enabled;
+
+		return [=] {
+			PAGING_Enable(enabled);
+			PAGING_SetDirBase(cr3);
+			PAGING_ClearTLB();
+		};
+	});
 }
@@ -83,12 +83,16 @@ void PAGING_ClearTLB();
 void PAGING_LinkPage(uint32_t lin_page,uint32_t phys_page);
 void PAGING_LinkPage_ReadOnly(uint32_t lin_page,uint32_t phys_page);
 void PAGING_UnlinkPages(Bitu lin_page,Bitu pages);
+// Unlinks only the TLB entries that map to the given physical pages
+void PAGING_UnlinkPhysPages(Bitu phys_page, Bitu pages);
 /* This maps the page directly, only use when paging is disabled */
 void PAGING_MapPage(Bitu lin_page,Bitu phys_page);
 bool PAGING_MakePhysPage(Bitu & page);
 bool PAGING_ForcePageInit(Bitu lin_addr);
 
 void MEM_SetLFB(Bitu page, Bitu pages, PageHandler *handler, PageHandler *mmiohandler);
+// Swaps the handler of the LFB pages without flushing the whole TLB
+void MEM_SetLFBHandler(PageHandler* handler);
 void MEM_SetPageHandler(Bitu phys_page, Bitu pages, PageHandler * handler);
 void MEM_ResetPageHandler(Bitu phys_page, Bitu pages);
 
@@ -192,6 +196,31 @@ typedef struct {
 } tlb_entry = {};
 #endif
 
+// TLB activity counters. Lookups that hit are served inline from the TLB
+// arrays (and from code generated by the dynamic cores), so only the slow
+// paths are counted.
+struct PagingTlbStats {
+	// Accesses that went through the page init handlers to fill an entry
+	uint64_t misses = 0;
+
+	// Entries linked to a physical page
+	uint64_t links = 0;
+
+	// Full TLB flushes, the entries they cleared, and how many of them
+	// were caused by a CR3 reload
+	uint64_t flushes         = 0;
+	uint64_t flushed_entries = 0;
+	uint64_t cr3_reloads     = 0;
+
+	// Flushes forced by running out of link entries
+	uint64_t link_overflows = 0;
+
+	// Page faults raised, and how many of them ran the guest's handler in
+	// a nested page fault core instead of the interrupted CPU core
+	uint64_t page_faults        = 0;
+	uint64_t nested_page_faults = 0;
+};
+
 struct PagingBlock {
 	uint32_t cr3 = 0;
 	uint32_t cr2 = 0;
@@ -220,10 +249,14 @@ struct PagingBlock {
 
 	std::vector<uint32_t> firstmb = std::vector<uint32_t>(LINK_START);
 	bool enabled = false;
+
+	PagingTlbStats stats = {};
 };
 
 extern PagingBlock paging; 
 
+const PagingTlbStats& PAGING_GetTlbStats();
+
 /* Some support functions */
 
 PageHandler * MEM_GetPageHandler(Bitu phys_page);
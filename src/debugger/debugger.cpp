@@ -7,12 +7,15 @@
 #if C_DEBUGGER
 
 #include <cctype>
+#include <cinttypes>
 #include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <list>
+#include <map>
 #include <sstream>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "audio/mixer.h"
@@ -373,11 +376,13 @@ public:
 		type     = BKPNT_PHYSICAL;
 		segment  = seg;
 		offset   = off;
+		is_index_stale = true;
 	}
 	void SetAddress(PhysPt adr)
 	{
 		location = adr;
 		type     = BKPNT_PHYSICAL;
+		is_index_stale = true;
 	}
 	void SetInt(uint8_t _intNr, uint16_t ah, uint16_t al)
 	{
@@ -392,6 +397,7 @@ public:
 	void SetType(EBreakpoint _type)
 	{
 		type = _type;
+		is_index_stale = true;
 	}
 	void SetValue(uint8_t value)
 	{
@@ -477,7 +483,28 @@ public:
 	static void DeleteAll(void);
 	static void ShowList(void);
 
+#if C_HEAVY_DEBUGGER
+	template <typename T>
+	static void FlagMemoryReadsAt(const PhysPt addr);
+#endif
+
 private:
+	// Rebuilds the lookup structures below from BPoints if any breakpoint
+	// was added, removed, (de)activated, or moved since the last call
+	static void UpdateIndex();
+
+	static inline bool is_index_stale = true;
+
+	// Locations of the active execution breakpoints
+	static inline std::unordered_set<PhysPt> active_locations = {};
+
+	// Memory value breakpoints are compared on every instruction, so
+	// with any of them active every instruction takes the slow path
+	static inline bool has_active_memory_breakpoints = false;
+
+	// Memory read breakpoints by address, for DEBUG_UpdateMemoryReadBreakpoints()
+	static inline std::multimap<PhysPt, CBreakpoint*> memory_read_breakpoints = {};
+
 	EBreakpoint type = {};
 	// Physical
 	PhysPt location  = 0;
@@ -556,33 +583,73 @@ void CBreakpoint::Activate(bool _active)
 		}
 	}
 #endif
+	if (active != _active) {
+		is_index_stale = true;
+	}
 	active = _active;
 }
 
 // Statics
 static std::list<CBreakpoint*> BPoints = {};
 
+void CBreakpoint::UpdateIndex()
+{
+	if (!is_index_stale) {
+		return;
+	}
+	active_locations.clear();
+	has_active_memory_breakpoints = false;
+	memory_read_breakpoints.clear();
+
+	for (auto bp : BPoints) {
+		const auto type = bp->GetType();
+		if (type == BKPNT_PHYSICAL && bp->IsActive()) {
+			active_locations.insert(bp->GetLocation());
+		} else if (type == BKPNT_MEMORY || type == BKPNT_MEMORY_PROT ||
+		           type == BKPNT_MEMORY_LINEAR ||
+		           type == BKPNT_MEMORY_READ) {
+			has_active_memory_breakpoints |= bp->IsActive();
+		}
+		if (type == BKPNT_MEMORY_READ) {
+			memory_read_breakpoints.emplace(bp->GetLocation(), bp);
+		}
+	}
+	is_index_stale = false;
+}
+
 #if C_HEAVY_DEBUGGER
+template <typename T>
+void CBreakpoint::FlagMemoryReadsAt(const PhysPt addr)
+{
+	UpdateIndex();
+	if (memory_read_breakpoints.empty()) {
+		return;
+	}
+
+	// A read of sizeof(T) bytes at 'addr' hits the breakpoints located
+	// in (addr - sizeof(T), addr]
+	const PhysPt first = addr >= sizeof(T) ? addr - sizeof(T) + 1 : 0;
+
+	for (auto it = memory_read_breakpoints.lower_bound(first);
+	     it != memory_read_breakpoints.end() && it->first <= addr;
+	     ++it) {
+		auto bp = it->second;
+		DEBUG_ShowMsg("bpmr hit: %04X:%04X, cs:ip = %04X:%04X",
+		              bp->GetSegment(),
+		              bp->GetOffset(),
+		              SegValue(cs),
+		              reg_eip);
+		bp->FlagMemoryAsRead();
+	}
+}
+
 template <typename T>
 void DEBUG_UpdateMemoryReadBreakpoints(const PhysPt addr)
 {
 	static_assert(std::is_unsigned_v<T>);
 	static_assert(std::is_integral_v<T>);
 
-	for (CBreakpoint* bp : BPoints) {
-		if (bp->GetType() == BKPNT_MEMORY_READ) {
-			const PhysPt location_begin = bp->GetLocation();
-			const PhysPt location_end = location_begin + sizeof(T);
-			if ((addr >= location_begin) && (addr < location_end)) {
-				DEBUG_ShowMsg("bpmr hit: %04X:%04X, cs:ip = %04X:%04X",
-				              bp->GetSegment(),
-				              bp->GetOffset(),
-				              SegValue(cs),
-				              reg_eip);
-				bp->FlagMemoryAsRead();
-			}
-		}
-	}
+	CBreakpoint::FlagMemoryReadsAt<T>(addr);
 }
 // Explicit instantiations
 template void DEBUG_UpdateMemoryReadBreakpoints<uint8_t>(const PhysPt addr);
@@ -597,6 +664,7 @@ CBreakpoint* CBreakpoint::AddBreakpoint(uint16_t seg, uint32_t off, bool once)
 	bp->SetAddress(seg, off);
 	bp->SetOnce(once);
 	BPoints.push_front(bp);
+	is_index_stale = true;
 	return bp;
 }
 
@@ -607,6 +675,7 @@ CBreakpoint* CBreakpoint::AddIntBreakpoint(uint8_t intNum, uint16_t ah,
 	bp->SetInt(intNum, ah, al);
 	bp->SetOnce(once);
 	BPoints.push_front(bp);
+	is_index_stale = true;
 	return bp;
 }
 
@@ -617,6 +686,7 @@ CBreakpoint* CBreakpoint::AddMemBreakpoint(uint16_t seg, uint32_t off)
 	bp->SetOnce(false);
 	bp->SetType(BKPNT_MEMORY);
 	BPoints.push_front(bp);
+	is_index_stale = true;
 	return bp;
 }
 
@@ -658,6 +728,14 @@ bool CBreakpoint::CheckBreakpoint(Bitu seg, Bitu off)
 		return false;
 	}
 
+	// Quick exit if no active breakpoint can trigger here; this runs for
+	// every instruction with the heavy debugger
+	UpdateIndex();
+	if (!has_active_memory_breakpoints &&
+	    !active_locations.contains(GetAddress(seg, off))) {
+		return false;
+	}
+
 	// Search matching breakpoint
 	for (auto i = BPoints.begin(); i != BPoints.end(); ++i) {
 		auto bp = (*i);
@@ -668,6 +746,7 @@ bool CBreakpoint::CheckBreakpoint(Bitu seg, Bitu off)
 			if (bp->GetOnce()) {
 				// delete it, if it should only be used once
 				BPoints.erase(i);
+				is_index_stale = true;
 				bp->Activate(false);
 				delete bp;
 			} else {
@@ -676,6 +755,7 @@ bool CBreakpoint::CheckBreakpoint(Bitu seg, Bitu off)
 				bp = FindPhysBreakpoint(seg, off, true);
 				if (bp) {
 					BPoints.remove(bp);
+					is_index_stale = true;
 					bp->Activate(false);
 					delete bp;
 				}
@@ -768,6 +848,7 @@ bool CBreakpoint::CheckIntBreakpoint([[maybe_unused]] PhysPt adr, uint8_t intNr,
 					// delete it, if it should only be used
 					// once
 					BPoints.erase(i);
+					is_index_stale = true;
 					bp->Activate(false);
 					delete bp;
 				}
@@ -785,6 +866,7 @@ void CBreakpoint::DeleteAll()
 		delete bp;
 	}
 	BPoints.clear();
+	is_index_stale = true;
 }
 
 bool CBreakpoint::DeleteByIndex(uint16_t index)
@@ -799,6 +881,7 @@ bool CBreakpoint::DeleteByIndex(uint16_t index)
 	auto bp = *it;
 
 	BPoints.erase(it);
+	is_index_stale = true;
 	bp->Activate(false);
 	delete bp;
 	return true;
@@ -853,6 +936,7 @@ bool CBreakpoint::DeleteBreakpoint(uint16_t seg, uint32_t off)
 	CBreakpoint* bp = FindPhysBreakpoint(seg, off, false);
 	if (bp) {
 		BPoints.remove(bp);
+		is_index_stale = true;
 		delete bp;
 		return true;
 	}
@@ -1491,6 +1575,142 @@ bool ChangeRegister(char* str)
 	return true;
 }
 
+#if C_HEAVY_DEBUGGER
+// Binary instruction trace: a ring of compact records filled on every
+// instruction, only disassembled when written out. Much cheaper than the
+// text logs, so it can hold the last few million instructions.
+
+constexpr uint32_t DefaultTraceEntries = 0x100000;
+constexpr size_t MaxTraceOpcodeBytes   = 10;
+
+struct TraceRecord {
+	uint64_t cycle = 0;
+	uint32_t eip   = 0;
+	uint32_t eax   = 0;
+	uint32_t ebx   = 0;
+	uint32_t ecx   = 0;
+	uint32_t edx   = 0;
+	uint32_t esi   = 0;
+	uint32_t edi   = 0;
+	uint32_t ebp   = 0;
+	uint32_t esp   = 0;
+	uint32_t flags = 0;
+	uint16_t cs    = 0;
+	uint16_t ds    = 0;
+	uint16_t es    = 0;
+	uint16_t ss    = 0;
+	bool is_32bit  = false;
+	uint8_t opcode[MaxTraceOpcodeBytes] = {};
+};
+
+static struct {
+	std::vector<TraceRecord> records = {};
+	size_t next                      = 0;
+	bool has_wrapped                 = false;
+	bool enabled                     = false;
+} instruction_trace = {};
+
+static void record_trace()
+{
+	auto& record = instruction_trace.records[instruction_trace.next];
+
+	record.cycle    = cycle_count;
+	record.eip      = reg_eip;
+	record.eax      = reg_eax;
+	record.ebx      = reg_ebx;
+	record.ecx      = reg_ecx;
+	record.edx      = reg_edx;
+	record.esi      = reg_esi;
+	record.edi      = reg_edi;
+	record.ebp      = reg_ebp;
+	record.esp      = reg_esp;
+	record.flags    = static_cast<uint32_t>(reg_flags);
+	record.cs       = SegValue(cs);
+	record.ds       = SegValue(ds);
+	record.es       = SegValue(es);
+	record.ss       = SegValue(ss);
+	record.is_32bit = cpu.code.big;
+
+	const auto pc = SegPhys(cs) + reg_eip;
+	for (size_t i = 0; i < MaxTraceOpcodeBytes; ++i) {
+		record.opcode[i] = mem_readb<MemOpMode::SkipBreakpoints>(pc + i);
+	}
+
+	if (++instruction_trace.next == instruction_trace.records.size()) {
+		instruction_trace.next        = 0;
+		instruction_trace.has_wrapped = true;
+	}
+}
+
+static void start_trace(const uint32_t num_entries)
+{
+	instruction_trace.records.assign(num_entries, {});
+	instruction_trace.next        = 0;
+	instruction_trace.has_wrapped = false;
+	instruction_trace.enabled     = true;
+}
+
+static void write_trace()
+{
+	const auto num_records = instruction_trace.has_wrapped ? instruction_trace.records.size()
+	                                           : instruction_trace.next;
+	if (num_records == 0) {
+		DEBUG_ShowMsg("DEBUG: The instruction trace is empty.\n");
+		return;
+	}
+
+	const std_fs::path log_trace_txt = "LOGTRACE.TXT";
+	std::ofstream out(log_trace_txt);
+	if (!out.is_open()) {
+		DEBUG_ShowMsg("DEBUG: Tracefile couldn't be created.\n");
+		return;
+	}
+	out << std::hex << std::noshowbase << std::setfill('0') << std::uppercase;
+
+	// Oldest first
+	auto pos = instruction_trace.has_wrapped ? instruction_trace.next : 0;
+	for (size_t i = 0; i < num_records; ++i) {
+		const auto& record = instruction_trace.records[pos];
+		if (++pos == instruction_trace.records.size()) {
+			pos = 0;
+		}
+
+		char dline[200];
+		const auto size = DasmI386Bytes(dline,
+		                                record.opcode,
+		                                MaxTraceOpcodeBytes,
+		                                0,
+		                                record.eip,
+		                                record.is_32bit);
+
+		std::string bytes = {};
+		for (size_t j = 0; j < std::min<size_t>(size, MaxTraceOpcodeBytes); ++j) {
+			bytes += format_str("%02X", record.opcode[j]);
+		}
+
+		using std::setw;
+		out << std::dec << std::setfill(' ') << setw(12) << record.cycle
+		    << std::hex << std::setfill('0') << " " << setw(4) << record.cs
+		    << ":" << setw(8) << record.eip << "  " << std::left
+		    << std::setfill(' ') << setw(20) << bytes << setw(30) << dline
+		    << std::right << std::setfill('0') << " EAX:" << setw(8)
+		    << record.eax << " EBX:" << setw(8) << record.ebx
+		    << " ECX:" << setw(8) << record.ecx << " EDX:" << setw(8)
+		    << record.edx << " ESI:" << setw(8) << record.esi
+		    << " EDI:" << setw(8) << record.edi << " EBP:" << setw(8)
+		    << record.ebp << " ESP:" << setw(8) << record.esp
+		    << " DS:" << setw(4) << record.ds << " ES:" << setw(4)
+		    << record.es << " SS:" << setw(4) << record.ss
+		    << " FLAGS:" << setw(8) << record.flags << "\n";
+	}
+
+	DEBUG_ShowMsg("DEBUG: Wrote %zu traced instructions to '%s'.\n",
+	              num_records,
+	              std_fs::absolute(log_trace_txt).string().c_str());
+}
+
+#endif
+
 bool ParseCommand(char* str)
 {
 	char* found = str;
@@ -1909,6 +2129,32 @@ bool ParseCommand(char* str)
 		return true;
 	}
 
+	if (command == "TRACE") { // Toggle the binary instruction trace
+		if (instruction_trace.enabled) {
+			instruction_trace.enabled = false;
+			instruction_trace.records.clear();
+			DEBUG_ShowMsg("DEBUG: Instruction trace off.\n");
+			return true;
+		}
+		auto num_entries = static_cast<uint32_t>(GetHexValue(found, found));
+		if (num_entries == 0) {
+			num_entries = DefaultTraceEntries;
+		}
+		start_trace(num_entries);
+		DEBUG_ShowMsg("DEBUG: Tracing the last %X instructions.\n",
+		              num_entries);
+		return true;
+	}
+
+	if (command == "TRACEDUMP") { // Write the binary instruction trace
+		if (!instruction_trace.enabled) {
+			DEBUG_ShowMsg("DEBUG: Instruction trace is off.\n");
+			return false;
+		}
+		write_trace();
+		return true;
+	}
+
 	if (command == "ZEROPROTECT") { // toggle zero protection
 		zeroProtect = !zeroProtect;
 		DEBUG_ShowMsg("DEBUG: Zero code execution protection %s.\n",
@@ -1939,6 +2185,8 @@ bool ParseCommand(char* str)
 		DEBUG_ShowMsg("LOG [num]                 - Write cpu log file.\n");
 		DEBUG_ShowMsg("LOGS/LOGL/LOGC [num]      - Write short/long/cs:ip-only cpu log file.\n");
 		DEBUG_ShowMsg("HEAVYLOG                  - Enable/Disable automatic cpu log when DOSBox exits.\n");
+		DEBUG_ShowMsg("TRACE [num]               - Enable/Disable tracing the last num instructions.\n");
+		DEBUG_ShowMsg("TRACEDUMP                 - Write the trace to LOGTRACE.TXT (also when DOSBox exits).\n");
 		DEBUG_ShowMsg("ZEROPROTECT               - Enable/Disable zero code execution detection.\n");
 #endif
 		DEBUG_ShowMsg("SR [reg] [value]          - Set register value.\n");
@@ -2893,6 +3141,23 @@ static void LogCPUInfo(void)
 	        cpu.idt.GetLimit());
 	LOG(LOG_MISC, LOG_ERROR)("%s", out1);
 
+	const auto& tlb = PAGING_GetTlbStats();
+	sprintf(out1,
+	        "TLB misses=%" PRIu64 " links=%" PRIu64 " flushes=%" PRIu64
+	        " (cr3=%" PRIu64 " overflow=%" PRIu64 ") flushed=%" PRIu64,
+	        tlb.misses,
+	        tlb.links,
+	        tlb.flushes,
+	        tlb.cr3_reloads,
+	        tlb.link_overflows,
+	        tlb.flushed_entries);
+	LOG(LOG_MISC, LOG_ERROR)("%s", out1);
+	sprintf(out1,
+	        "Page faults=%" PRIu64 " (nested=%" PRIu64 ")",
+	        tlb.page_faults,
+	        tlb.nested_page_faults);
+	LOG(LOG_MISC, LOG_ERROR)("%s", out1);
+
 	Bitu sel = CPU_STR();
 	Descriptor desc;
 	if (cpu.gdt.GetDescriptor(sel, desc)) {
@@ -3483,6 +3748,10 @@ void DEBUG_HeavyLogInstruction()
 
 void DEBUG_HeavyWriteLogInstruction()
 {
+	if (instruction_trace.enabled) {
+		write_trace();
+	}
+
 	if (!logHeavy) {
 		return;
 	}
@@ -3552,6 +3821,9 @@ bool DEBUG_HeavyIsBreakpoint(void)
 	if (logHeavy) {
 		DEBUG_HeavyLogInstruction();
 	}
+	if (instruction_trace.enabled) {
+		record_trace();
+	}
 	if (zeroProtect) {
 		uint32_t value = 0;
 		if (!mem_readd_checked(SegPhys(cs) + reg_eip, &value)) {
@@ -471,8 +471,16 @@ static char *addr_to_hex(UINT32 addr, int splitup) {
 static PhysPt getbyte_mac;
 static PhysPt startPtr;
 
+// Set while disassembling recorded bytes instead of emulated memory
+static const uint8_t* getbyte_buffer = nullptr;
+static size_t getbyte_buffer_size    = 0;
+
 static UINT8 getbyte()
 {
+	if (getbyte_buffer) {
+		const size_t pos = getbyte_mac++ - startPtr;
+		return pos < getbyte_buffer_size ? getbyte_buffer[pos] : 0;
+	}
 	return mem_readb<MemOpMode::SkipBreakpoints>(getbyte_mac++);
 }
 
@@ -1120,6 +1128,18 @@ Bitu DasmI386(char* buffer, PhysPt pc, Bitu cur_ip, bool bit32)
 	return getbyte_mac-pc;
 }
 
+Bitu DasmI386Bytes(char* buffer, const uint8_t* bytes, size_t num_bytes,
+                   PhysPt pc, Bitu cur_ip, bool bit32)
+{
+	getbyte_buffer      = bytes;
+	getbyte_buffer_size = num_bytes;
+
+	const auto size = DasmI386(buffer, pc, cur_ip, bit32);
+
+	getbyte_buffer = nullptr;
+	return size;
+}
+
 int DasmLastOperandSize()
 {
 	return opsize;
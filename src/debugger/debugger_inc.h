@@ -47,4 +47,8 @@ extern DBGBlock dbg;
 
 /* Local Debug Stuff */
 Bitu DasmI386(char* buffer, PhysPt pc, Bitu cur_ip, bool bit32);
+// Disassembles the given instruction bytes as if located at 'pc'; missing
+// bytes read as zeros
+Bitu DasmI386Bytes(char* buffer, const uint8_t* bytes, size_t num_bytes,
+                   PhysPt pc, Bitu cur_ip, bool bit32);
 int DasmLastOperandSize();
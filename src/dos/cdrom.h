@@ -49,6 +49,8 @@
 // Number of letters in the English alphabet (A to Z)
 constexpr auto MaxNumDosDriveLetters = 26;
 
+class ImagePreloader;
+
 struct TMSF
 {
 	unsigned char min;
@@ -239,7 +241,18 @@ private:
 		}
 
 	private:
+		class ReadAhead;
+
+		std_fs::path image_path = {};
 		std::ifstream* file;
+
+		// Created on the first data read, so audio-only tracks don't
+		// get a worker thread
+		std::unique_ptr<ReadAhead> read_ahead;
+
+		// Serves the data reads instead of the read-ahead if the image
+		// is preloaded
+		std::unique_ptr<ImagePreloader> preloader;
 	};
 
 	class AudioFile final : public TrackFile {
@@ -313,12 +326,16 @@ public:
 	}
 
 private:
+	class AudioDecoder;
+
+	// The player state is only changed with the mixer thread locked, so
+	// the mixer callback runs without taking a lock of its own
 	static struct imagePlayer {
 		// Objects, pointers, and then scalars; in descending size-order.
-		std::mutex mutex                   = {};
-		std::weak_ptr<TrackFile> trackFile = {};
-		MixerChannelPtr channel            = nullptr;
-		CDROM_Interface_Image* cd          = nullptr;
+		std::unique_ptr<AudioDecoder> decoder;
+		std::weak_ptr<TrackFile> trackFile    = {};
+		MixerChannelPtr channel               = nullptr;
+		CDROM_Interface_Image* cd             = nullptr;
 
 		void (MixerChannel::*addFrames)(int, const int16_t*) = nullptr;
 
@@ -350,6 +367,7 @@ private:
 	void CDAudioCallback(const int desired_track_frames);
 	void PlayNextAudioTrack();
 	bool PlayAudioTrack(const Track& track, const uint32_t sector_offset);
+	bool PlayAudioSectorLocked(uint32_t start, uint32_t len);
 
 	bool LoadMdsFile(const char *filename);
 
@@ -7,29 +7,36 @@
 #include "cdrom.h"
 #include "cdrom_mds.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cctype>
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #if !defined(WIN32)
 #include <libgen.h>
-#else
-#include <cstring>
 #endif
 
 #include "audio/channel_names.h"
 #include "config/setup.h"
 #include "dos/drives.h"
+#include "misc/image_preloader.h"
 #include "utils/fs_utils.h"
 #include "utils/math_utils.h"
+#include "utils/spsc_queue.h"
 #include "utils/string_utils.h"
 
 // String maximums, local to this file
@@ -81,13 +88,261 @@ uint32_t CDROM_Interface_Image::TrackFile::adjustOverRead(const uint32_t offset,
 	return adjusted_bytes;
 }
 
+// Reads the data track ahead of the emulation on a worker thread once the
+// reads turn sequential, as they do while a game streams a video or an
+// installer copies files. The chunks are kept in a small ring. The worker
+// has its own file handle, so the stream shared by the data reads and the
+// audio decoder is never touched from two threads.
+class CDROM_Interface_Image::BinaryFile::ReadAhead {
+public:
+	explicit ReadAhead(const std_fs::path& filename);
+	~ReadAhead();
+
+	ReadAhead(const ReadAhead&)            = delete;
+	ReadAhead& operator=(const ReadAhead&) = delete;
+
+	// Copies the range out of the ring, scheduling the chunks after it
+	// when reading sequentially. Returns false if the range has to be
+	// read directly.
+	bool Read(uint8_t* buffer, const uint32_t offset, const uint32_t num_bytes);
+
+private:
+	static constexpr uint32_t ChunkBytes = 64 * 1024;
+	static constexpr size_t NumChunks    = 8;
+
+	// Cooked reads of raw sectors skip the header and error correction
+	// bytes between the sectors, so allow for such a gap
+	static constexpr uint32_t MaxSequentialGap = BYTES_PER_RAW_REDBOOK_FRAME;
+
+	enum class ChunkState { Empty, Pending, Ready, Failed };
+
+	struct Chunk {
+		std::vector<uint8_t> data = {};
+		uint32_t index            = 0;
+		uint32_t size             = 0;
+		ChunkState state          = ChunkState::Empty;
+	};
+
+	Chunk* FindChunk(const uint32_t index);
+	void Schedule(const uint32_t first_index);
+	bool CopyOut(uint8_t* buffer, const uint32_t offset,
+	             const uint32_t num_bytes, const bool wait);
+	void Run();
+
+	std::ifstream file = {};
+	uint32_t file_size = 0;
+
+	std::mutex mutex                 = {};
+	std::condition_variable work_cv  = {};
+	std::condition_variable ready_cv = {};
+	std::vector<Chunk> chunks        = std::vector<Chunk>(NumChunks);
+	bool should_exit                 = false;
+
+	// Only touched by the emulation thread
+	uint32_t prev_offset = 0;
+	uint32_t prev_end    = 0;
+	uint64_t num_hits    = 0;
+	uint64_t num_misses  = 0;
+
+	std::thread thread = {};
+};
+
+CDROM_Interface_Image::BinaryFile::ReadAhead::ReadAhead(const std_fs::path& filename)
+        : file(filename, std::ios::in | std::ios::binary)
+{
+	file.seekg(0, std::ios::end);
+	const auto size = file.tellg();
+	file_size = size > 0 ? static_cast<uint32_t>(size) : 0;
+
+	thread = std::thread(&ReadAhead::Run, this);
+	set_thread_name(thread, "dosbox:cdrom");
+}
+
+CDROM_Interface_Image::BinaryFile::ReadAhead::~ReadAhead()
+{
+	{
+		std::lock_guard lock(mutex);
+		should_exit = true;
+	}
+	work_cv.notify_one();
+	thread.join();
+
+	LOG_DEBUG("CDROM: Read-ahead served %llu reads, missed %llu",
+	          static_cast<unsigned long long>(num_hits),
+	          static_cast<unsigned long long>(num_misses));
+}
+
+CDROM_Interface_Image::BinaryFile::ReadAhead::Chunk*
+CDROM_Interface_Image::BinaryFile::ReadAhead::FindChunk(const uint32_t index)
+{
+	for (auto& chunk : chunks) {
+		if (chunk.state != ChunkState::Empty && chunk.index == index) {
+			return &chunk;
+		}
+	}
+	return nullptr;
+}
+
+void CDROM_Interface_Image::BinaryFile::ReadAhead::Schedule(const uint32_t first_index)
+{
+	const auto end_index = ceil_udivide(file_size, ChunkBytes);
+
+	bool has_work = false;
+	for (auto index = first_index;
+	     index < end_index && index < first_index + NumChunks;
+	     ++index) {
+		if (FindChunk(index)) {
+			continue;
+		}
+		// Recycle a chunk that's unused or behind the reader; the ring
+		// never holds more than the window, so there always is one
+		Chunk* free_chunk = nullptr;
+		for (auto& chunk : chunks) {
+			if (chunk.state == ChunkState::Empty ||
+			    (chunk.state != ChunkState::Pending &&
+			     chunk.index < first_index)) {
+				free_chunk = &chunk;
+				break;
+			}
+		}
+		if (!free_chunk) {
+			break;
+		}
+		free_chunk->index = index;
+		free_chunk->size  = 0;
+		free_chunk->state = ChunkState::Pending;
+		has_work          = true;
+	}
+	if (has_work) {
+		work_cv.notify_one();
+	}
+}
+
+bool CDROM_Interface_Image::BinaryFile::ReadAhead::CopyOut(uint8_t* buffer,
+                                                           const uint32_t offset,
+                                                           const uint32_t num_bytes,
+                                                           const bool wait)
+{
+	std::unique_lock lock(mutex);
+
+	// Check the whole range first, so a failed read copies nothing
+	for (auto pos = offset; pos < offset + num_bytes;) {
+		const auto index = pos / ChunkBytes;
+		auto chunk       = FindChunk(index);
+		if (chunk && wait) {
+			ready_cv.wait(lock, [&] {
+				return chunk->state != ChunkState::Pending ||
+				       chunk->index != index;
+			});
+			chunk = FindChunk(index);
+		}
+		if (!chunk || chunk->state != ChunkState::Ready ||
+		    index * ChunkBytes + chunk->size < std::min(offset + num_bytes,
+		                                                (index + 1) * ChunkBytes)) {
+			return false;
+		}
+		pos = (index + 1) * ChunkBytes;
+	}
+	for (auto pos = offset; pos < offset + num_bytes;) {
+		const auto index     = pos / ChunkBytes;
+		const auto chunk     = FindChunk(index);
+		const auto chunk_pos = pos - index * ChunkBytes;
+		const auto len = std::min(offset + num_bytes - pos, ChunkBytes - chunk_pos);
+
+		memcpy(buffer + (pos - offset), chunk->data.data() + chunk_pos, len);
+		pos += len;
+	}
+	return true;
+}
+
+bool CDROM_Interface_Image::BinaryFile::ReadAhead::Read(uint8_t* buffer,
+                                                        const uint32_t offset,
+                                                        const uint32_t num_bytes)
+{
+	const bool is_sequential = offset > prev_offset && offset >= prev_end &&
+	                           offset - prev_end <= MaxSequentialGap;
+	prev_offset = offset;
+	prev_end    = offset + num_bytes;
+
+	if (CopyOut(buffer, offset, num_bytes, false)) {
+		++num_hits;
+		if (is_sequential) {
+			std::lock_guard lock(mutex);
+			Schedule(offset / ChunkBytes);
+		}
+		return true;
+	}
+	++num_misses;
+
+	if (!is_sequential) {
+		return false;
+	}
+	// Starting out or fallen behind; wait for the worker instead of
+	// competing with it for the file
+	{
+		std::lock_guard lock(mutex);
+		Schedule(offset / ChunkBytes);
+	}
+	return CopyOut(buffer, offset, num_bytes, true);
+}
+
+void CDROM_Interface_Image::BinaryFile::ReadAhead::Run()
+{
+	std::unique_lock lock(mutex);
+
+	while (true) {
+		// Serve the pending chunk closest to the reader first
+		Chunk* next = nullptr;
+		for (auto& chunk : chunks) {
+			if (chunk.state == ChunkState::Pending &&
+			    (!next || chunk.index < next->index)) {
+				next = &chunk;
+			}
+		}
+		if (should_exit) {
+			return;
+		}
+		if (!next) {
+			work_cv.wait(lock);
+			continue;
+		}
+
+		// Pending chunks are never recycled, so the chunk can be filled
+		// without holding the lock
+		const auto offset = next->index * ChunkBytes;
+		const auto size   = std::min(ChunkBytes, file_size - offset);
+		lock.unlock();
+
+		next->data.resize(ChunkBytes);
+		file.clear();
+		file.seekg(offset, std::ios::beg);
+		file.read(reinterpret_cast<char*>(next->data.data()), size);
+		const bool success = !file.fail();
+
+		lock.lock();
+		next->size  = size;
+		next->state = success ? ChunkState::Ready : ChunkState::Failed;
+		ready_cv.notify_all();
+	}
+}
+
 CDROM_Interface_Image::BinaryFile::BinaryFile(const std_fs::path &filename, bool &error)
         : TrackFile(BYTES_PER_RAW_REDBOOK_FRAME),
+          image_path(filename),
           file(nullptr)
 {
 	file = new std::ifstream(filename, std::ios::in | std::ios::binary);
 	// If new fails, an exception is generated and scope leaves this constructor
 	error = file->fail();
+
+	std::error_code ec = {};
+	const auto size    = std_fs::file_size(filename, ec);
+	if (!error && !ec && DOS_ShouldPreloadImage(static_cast<int64_t>(size))) {
+		if (const auto preload_file = fopen(filename.string().c_str(), "rb")) {
+			preloader = std::make_unique<ImagePreloader>(preload_file,
+			                                             filename.string());
+		}
+	}
 }
 
 CDROM_Interface_Image::BinaryFile::~BinaryFile()
@@ -113,6 +368,18 @@ bool CDROM_Interface_Image::BinaryFile::read(uint8_t *buffer,
 	if (adjusted_bytes == 0) // no work to do!
 		return true;
 
+	if (!offsetInsideTrack(offset))
+		return false;
+
+	if (preloader)
+		return preloader->Read(offset, buffer, adjusted_bytes);
+
+	if (!read_ahead)
+		read_ahead = std::make_unique<ReadAhead>(image_path);
+
+	if (read_ahead->Read(buffer, offset, adjusted_bytes))
+		return true;
+
 	// Reposition if needed
 	if (!seek(offset))
 		return false;
@@ -461,6 +728,236 @@ int CDROM_Interface_Image::AudioFile::getLength()
 	return length_redbook_bytes;
 }
 
+// Decodes the playing track on a worker thread, one second at a time, and
+// hands the audio to the mixer callback through a lock-free queue. The
+// decoded seconds are kept, so replaying a passage (as games do to loop
+// their music) doesn't have to seek and decode it again.
+//
+// Start() must only be called with the mixer thread locked (or from the
+// mixer callback), as it resets the queue the callback reads from.
+class CDROM_Interface_Image::AudioDecoder {
+public:
+	AudioDecoder();
+	~AudioDecoder();
+
+	AudioDecoder(const AudioDecoder&)            = delete;
+	AudioDecoder& operator=(const AudioDecoder&) = delete;
+
+	// Starts decoding the file from a Redbook byte offset
+	void Start(const std::shared_ptr<TrackFile>& file, const uint32_t redbook_pos);
+
+	// Mixer thread only. Returns fewer frames than requested only at the
+	// end of the file; if the decoder falls behind, the rest is silence.
+	uint32_t Read(int16_t* buffer, const uint32_t num_frames,
+	              const uint8_t channels);
+
+private:
+	static constexpr uint32_t BytesPerBlock = REDBOOK_PCM_FRAMES_PER_SECOND *
+	                                         BYTES_PER_REDBOOK_PCM_FRAME;
+
+	// About a minute of CD quality audio
+	static constexpr size_t MaxCachedBlocks = 60;
+	static constexpr uint32_t QueuedSeconds = 2;
+
+	struct Block {
+		std::vector<int16_t> samples = {};
+		uint32_t num_frames          = 0;
+		bool is_last                 = false;
+		uint64_t last_used           = 0;
+	};
+
+	static Block DecodeBlock(TrackFile& file, const uint32_t index);
+	void Run();
+
+	SpscQueue<int16_t> fifo{1};
+	std::atomic<bool> is_end_queued = false;
+
+	std::mutex mutex                          = {};
+	std::condition_variable cv                = {};
+	std::weak_ptr<TrackFile> file             = {};
+	std::unordered_map<uint32_t, Block> cache = {};
+	std::vector<int16_t> pending              = {};
+	uint64_t use_counter                      = 0;
+	uint32_t next_block                       = 0;
+	uint32_t first_sample                     = 0;
+	uint32_t generation                       = 0;
+	bool is_last_pending                      = false;
+	bool should_exit                          = false;
+
+	std::thread thread = {};
+};
+
+CDROM_Interface_Image::AudioDecoder::AudioDecoder()
+{
+	thread = std::thread(&AudioDecoder::Run, this);
+	set_thread_name(thread, "dosbox:cdaudio");
+}
+
+CDROM_Interface_Image::AudioDecoder::~AudioDecoder()
+{
+	{
+		std::lock_guard lock(mutex);
+		should_exit = true;
+	}
+	cv.notify_one();
+	thread.join();
+}
+
+void CDROM_Interface_Image::AudioDecoder::Start(const std::shared_ptr<TrackFile>& new_file,
+                                                const uint32_t redbook_pos)
+{
+	std::lock_guard lock(mutex);
+
+	if (file.lock() != new_file) {
+		file = new_file;
+		cache.clear();
+	}
+
+	// Neither side is using the queue: the mixer thread is locked and
+	// the worker only enqueues with the mutex held
+	const size_t capacity = new_file->getRate() * new_file->getChannels() *
+	                        QueuedSeconds;
+	if (fifo.MaxCapacity() != capacity) {
+		fifo.Resize(capacity);
+	} else {
+		fifo.Clear();
+	}
+	is_end_queued = false;
+
+	// The first block is entered part way, at the requested frame
+	const auto offset = redbook_pos % BytesPerBlock;
+	const auto frame  = static_cast<uint64_t>(offset / BYTES_PER_REDBOOK_PCM_FRAME) *
+	                   new_file->getRate() / REDBOOK_PCM_FRAMES_PER_SECOND;
+
+	next_block      = redbook_pos / BytesPerBlock;
+	first_sample    = static_cast<uint32_t>(frame * new_file->getChannels());
+	is_last_pending = false;
+	pending.clear();
+	++generation;
+
+	cv.notify_one();
+}
+
+uint32_t CDROM_Interface_Image::AudioDecoder::Read(int16_t* buffer,
+                                                   const uint32_t num_frames,
+                                                   const uint8_t channels)
+{
+	// Check for the end first, as the last samples are queued before it's
+	// flagged
+	const bool is_end = is_end_queued.load(std::memory_order_acquire);
+
+	const auto num_queued = static_cast<uint32_t>(fifo.Size() / channels);
+	const auto num_read   = std::min(num_frames, num_queued);
+	if (num_read > 0) {
+		fifo.BulkDequeue(buffer, num_read * channels);
+	}
+	if (num_read == num_frames || is_end) {
+		return num_read;
+	}
+	std::fill(buffer + num_read * channels, buffer + num_frames * channels, 0);
+	return num_frames;
+}
+
+CDROM_Interface_Image::AudioDecoder::Block CDROM_Interface_Image::AudioDecoder::DecodeBlock(
+        TrackFile& file, const uint32_t index)
+{
+	Block block = {};
+
+	const auto pos = index * BytesPerBlock;
+	if (static_cast<int>(pos) >= file.getLength() || !file.seek(pos)) {
+		block.is_last = true;
+		return block;
+	}
+	file.setAudioPosition(pos);
+
+	// A block holds a second's worth of the file's own frames
+	const auto block_frames = file.getRate();
+	const auto channels     = file.getChannels();
+	block.samples.resize(block_frames * channels);
+
+	while (block.num_frames < block_frames) {
+		const auto num_decoded = file.decode(
+		        block.samples.data() + block.num_frames * channels,
+		        block_frames - block.num_frames);
+		if (num_decoded == 0) {
+			break;
+		}
+		block.num_frames += num_decoded;
+	}
+	block.samples.resize(block.num_frames * channels);
+	block.is_last = block.num_frames < block_frames;
+	return block;
+}
+
+void CDROM_Interface_Image::AudioDecoder::Run()
+{
+	using namespace std::chrono_literals;
+
+	std::unique_lock lock(mutex);
+
+	while (!should_exit) {
+		if (!pending.empty()) {
+			fifo.NonblockingBulkEnqueue(pending);
+			if (!pending.empty()) {
+				// The mixer doesn't signal when it takes audio out
+				cv.wait_for(lock, 10ms);
+				continue;
+			}
+			if (is_last_pending) {
+				is_end_queued.store(true, std::memory_order_release);
+			}
+			continue;
+		}
+		const auto track_file = file.lock();
+		if (!track_file || is_end_queued || is_last_pending) {
+			cv.wait(lock);
+			continue;
+		}
+
+		const auto index = next_block;
+		auto it          = cache.find(index);
+		if (it == cache.end()) {
+			// Decode without the lock held, so starting another
+			// passage never has to wait for it
+			const auto start_generation = generation;
+			lock.unlock();
+			auto block = DecodeBlock(*track_file, index);
+			lock.lock();
+
+			if (file.lock() != track_file) {
+				continue;
+			}
+			if (cache.size() >= MaxCachedBlocks) {
+				cache.erase(std::min_element(cache.begin(),
+				                             cache.end(),
+				                             [](const auto& a, const auto& b) {
+					                             return a.second.last_used <
+					                                    b.second.last_used;
+				                             }));
+			}
+			it = cache.emplace(index, std::move(block)).first;
+
+			if (generation != start_generation) {
+				continue;
+			}
+		}
+		auto& block     = it->second;
+		block.last_used = ++use_counter;
+
+		const auto start = std::min(first_sample,
+		                            static_cast<uint32_t>(block.samples.size()));
+		pending.assign(block.samples.begin() + start, block.samples.end());
+
+		first_sample    = 0;
+		is_last_pending = block.is_last;
+		++next_block;
+
+		if (pending.empty() && is_last_pending) {
+			is_end_queued.store(true, std::memory_order_release);
+		}
+	}
+}
+
 // initialize static members
 int CDROM_Interface_Image::refCount = 0;
 CDROM_Interface_Image::imagePlayer CDROM_Interface_Image::player;
@@ -506,6 +1003,7 @@ CDROM_Interface_Image::~CDROM_Interface_Image()
 		}
 		MIXER_DeregisterChannel(player.channel);
 		player.channel.reset();
+		player.decoder.reset();
 	}
 	if (player.cd == this) {
 		player.cd = nullptr;
@@ -515,8 +1013,9 @@ CDROM_Interface_Image::~CDROM_Interface_Image()
 
 bool CDROM_Interface_Image::SetDevice(const char* path)
 {
-	std::lock_guard lock(player.mutex);
+	MIXER_LockMixerThread();
 	const bool result = LoadMdsFile(path) || LoadCueSheet(path) || LoadIsoFile(path);
+	MIXER_UnlockMixerThread();
 	if (!result) {
 		// print error message on dosbox console
 		char buf[MAX_LINE_LENGTH];
@@ -697,15 +1196,18 @@ bool CDROM_Interface_Image::PlayAudioTrack(const Track& track, const uint32_t se
 	const auto byte_offset = track.skip + sector_offset * track.sector_size;
 
 	// Guard: Bail if our track could not be seeked
-	if (!track_file->seek(byte_offset)) {
+	if (static_cast<int>(byte_offset) >= track_file->getLength()) {
 		LOG_MSG("CDROM: Track %d failed to seek to byte %u, so cancelling playback",
 		        track.number, byte_offset);
 		StopAudio();
 		return false;
 	}
 
-	// We're performing an audio-task, so update the audio position
-	track_file->setAudioPosition(byte_offset);
+	// The decoder seeks and decodes the track on its own thread
+	if (!player.decoder) {
+		player.decoder = std::make_unique<AudioDecoder>();
+	}
+	player.decoder->Start(track_file, byte_offset);
 
 	// Get properties about the current track
 	const uint8_t track_channels = track_file->getChannels();
@@ -737,7 +1239,14 @@ bool CDROM_Interface_Image::PlayAudioTrack(const Track& track, const uint32_t se
 
 bool CDROM_Interface_Image::PlayAudioSector(uint32_t start, uint32_t len)
 {
-	std::lock_guard lock(player.mutex);
+	MIXER_LockMixerThread();
+	const bool result = PlayAudioSectorLocked(start, len);
+	MIXER_UnlockMixerThread();
+	return result;
+}
+
+bool CDROM_Interface_Image::PlayAudioSectorLocked(uint32_t start, uint32_t len)
+{
 
 	// Find the track that holds the requested sector
 	track_const_iter track = GetTrack(start);
@@ -1021,15 +1530,14 @@ void CDROM_Interface_Image::PlayNextAudioTrack()
 void CDROM_Interface_Image::CDAudioCallback(const int desired_track_frames)
 {
 	/**
-	 *  This callback runs in SDL's mixer thread, so there's a risk
+	 *  This callback runs in the mixer thread, so there's a risk
 	 *  our track_file pointer could be removed by the main thread.
 	 *  We reserve the track_file up-front for the scope of this call.
 	 */
-	std::lock_guard lock(player.mutex);
 	std::shared_ptr<TrackFile> track_file = player.trackFile.lock();
 
 	// Guards: Bail if the request or our player is invalid
-	if (desired_track_frames == 0 || !player.cd || !track_file) {
+	if (desired_track_frames == 0 || !player.cd || !track_file || !player.decoder) {
 #ifdef DEBUG
 		LOG_MSG("CDROM: CDAudioCallback called with one more empty dependencies:\n"
 		        "\t - frames to play (%" PRIuPTR ")\n"
@@ -1044,7 +1552,9 @@ void CDROM_Interface_Image::CDAudioCallback(const int desired_track_frames)
 	}
 
 	const auto decoded_track_frames = check_cast<uint16_t>(
-	        track_file->decode(player.buffer, desired_track_frames));
+	        player.decoder->Read(player.buffer,
+	                             check_cast<uint32_t>(desired_track_frames),
+	                             track_file->getChannels()));
 
 	if (!decoded_track_frames) {
 		// This particular CDDA track has come to an end, but the
@@ -44,6 +44,7 @@ public:
 private:
 	void ClearAnsi();
 	void Output(uint8_t chr);
+	uint16_t OutputRun(const uint8_t* data, uint16_t size);
 
 	uint8_t readcache = 0;
 	struct ansi {
@@ -178,6 +179,12 @@ bool device_CON::Write(uint8_t* data, uint16_t* size)
 	INT10_SetCurMode();
 	while (*size > count) {
 		if (!ansi.esc) {
+			if (const auto num_written = OutputRun(data + count,
+			                                       *size - count);
+			    num_written > 0) {
+				count += num_written;
+				continue;
+			}
 			if (data[count] == Ascii::Escape) {
 				// Clear the datastructure
 				ClearAnsi();
@@ -528,6 +535,40 @@ uint16_t device_CON::GetInformation()
 	return 0x80D3;
 }
 
+// Outputs the characters up to the next one that needs the per-character
+// path in one go, and returns how many were written. This is only done in text
+// modes while nothing has hooked INT 10h, as the video BIOS functions are
+// called directly instead of through the interrupt.
+uint16_t device_CON::OutputRun(const uint8_t* data, const uint16_t size)
+{
+	if (CurMode->type != M_TEXT || INT10_IsVectorHooked()) {
+		return 0;
+	}
+
+	auto is_run_char = [](const uint8_t chr) {
+		return chr != Ascii::Escape && chr != Ascii::Bell &&
+		       (chr != '\t' || dos.direct_output);
+	};
+
+	uint16_t count = 0;
+	while (count < size && is_run_char(data[count])) {
+		++count;
+	}
+	if (count == 0) {
+		return 0;
+	}
+
+	if (dos.internal_output || ansi.enabled) {
+		constexpr auto use_attribute = true;
+		INT10_TeletypeOutputString(data, count, ansi.attr, use_attribute, ansi.attr);
+	} else {
+		// As INT 10h function 0Eh in text modes
+		constexpr auto use_attribute = false;
+		INT10_TeletypeOutputString(data, count, 7, use_attribute, {});
+	}
+	return count;
+}
+
 void device_CON::Output(uint8_t chr)
 {
 	if (dos.internal_output || ansi.enabled) {
@@ -24,6 +24,7 @@
 #include "dos/drives.h"
 #include "hardware/memory.h"
 #include "hardware/pic.h"
+#include "hardware/snapshot.h"
 #include "hardware/serialport/serialport.h"
 #include "ints/bios.h"
 #include "ints/ems.h"
@@ -1840,6 +1841,13 @@ void DOS_Init()
 
 	dos_module = std::make_unique<DOS>(section);
 
+	// The kernel's tables live in the guest RAM; the files and drives
+	// opened on the host are not part of the snapshot
+	SNAPSHOT_AddComponent("dos", [] {
+		const auto state = dos;
+		return [=] { dos = state; };
+	});
+
 	XMS_Init(*section);
 	EMS_Init(*section);
 
@@ -1911,6 +1919,13 @@ static void init_dos_settings(SectionProp& section)
 	pbool = section.AddBool("umb", WhenIdle, true);
 	pbool->SetHelp("Enable UMB memory support ('on' by default).");
 
+	pbool = section.AddBool("scan_mounted_dirs", WhenIdle, false);
+	pbool->SetHelp(
+	        "Read the directory tree of mounted host directories in the background ('off'\n"
+	        "by default). This makes the first listing of each directory faster. On Linux,\n"
+	        "changes made on the host are also picked up without running RESCAN. Applies to\n"
+	        "directories mounted after the setting is changed.");
+
 	pstring = section.AddString("pcjr_memory_config", OnlyAtStart, "expanded");
 	pstring->SetValues({"expanded", "standard"});
 	pstring->SetHelp(
@@ -2006,6 +2021,29 @@ static void init_dos_settings(SectionProp& section)
 	        "  auto:  Enable file locking only when Windows 3.1 is running.\n"
 	        "  on:    Always enable file locking.\n"
 	        "  off:   Always disable file locking.");
+
+	pbool = section.AddBool("file_read_ahead", WhenIdle, true);
+	pbool->SetHelp(
+	        "Read files opened read-only from mounted host directories in large chunks\n"
+	        "('on' by default). Programs reading their data files a few hundred bytes at a\n"
+	        "time load faster. Changes made to such a file from outside DOSBox while it is\n"
+	        "open might not be seen; disable this if that is a problem.");
+
+	pbool = section.AddBool("disk_image_write_back", WhenIdle, false);
+	pbool->SetHelp(
+	        "Hold back writes to mounted disk images and write them out about once a second\n"
+	        "('off' by default). Speeds up operating systems booted from a hard disk image,\n"
+	        "at the risk of losing the last second of writes if DOSBox crashes. Applies to\n"
+	        "images mounted after the setting is changed.");
+
+	auto pint = section.AddInt("image_preload_max_mb", WhenIdle, 0);
+	pint->SetMinMax(0, 4096);
+	pint->SetHelp(
+	        "Read mounted disk and CD-ROM images up to this size (in MB) into memory in\n"
+	        "the background (0 by default, disabled). Speeds up the first accesses to images\n"
+	        "on slow or network storage; writes to disk images still reach the image file,\n"
+	        "in the background. Use the '-preload' option of MOUNT to preload a single image\n"
+	        "of any size. Applies to images mounted after the setting is changed.");
 }
 
 void DOS_AddConfigSection([[maybe_unused]] const ConfigPtr& conf)
@@ -130,6 +130,10 @@ void DOS_SetError(uint16_t code);
 void DOS_NotifyBooting();
 bool DOS_IsGuestOsBooted();
 
+// Canonical path and name of the running program if known, otherwise the
+// name from its memory control block; empty once a guest OS is booted
+std::string DOS_GetCurrentProgramName();
+
 // File handling routines
 
 enum { STDIN=0,STDOUT=1,STDERR=2,STDAUX=3,STDPRN=4};
@@ -140,6 +144,12 @@ void DOS_Init(Section*);
 void DOS_SetupFiles (void);
 bool DOS_ReadFile(uint16_t handle,uint8_t * data,uint16_t * amount, bool fcb = false);
 bool DOS_WriteFile(uint16_t handle,uint8_t * data,uint16_t * amount,bool fcb = false);
+
+// Copies the rest of the source file to the target on the host if both are on
+// local or overlay drives. Returns false if that isn't possible or the copy
+// fails; the files' positions are then consistent with the bytes copied, so
+// the caller can carry on with DOS_ReadFile() and DOS_WriteFile().
+bool DOS_CopyFileOnHost(const uint16_t source_entry, const uint16_t target_entry);
 bool DOS_SeekFile(uint16_t handle,uint32_t * pos,uint32_t type,bool fcb = false);
 bool DOS_CloseFile(uint16_t handle,bool fcb = false,uint8_t * refcnt = nullptr);
 bool DOS_FlushFile(uint16_t handle);
@@ -238,6 +248,21 @@ bool DOS_LockFile(const uint16_t entry, const uint32_t pos, const uint32_t len);
 bool DOS_UnlockFile(const uint16_t entry, const uint32_t pos, const uint32_t len);
 void DOS_InitFileLocking(Section* sec);
 bool DOS_IsFileLocking();
+bool DOS_IsFileReadAhead();
+bool DOS_IsDiskImageWriteBack();
+
+// Whether an image of the given size should be read into memory when it's
+// mounted; the images mounted with 'MOUNT -preload' always are
+bool DOS_ShouldPreloadImage(const int64_t size_bytes);
+void DOS_SetImagePreloadForced(const bool is_forced);
+
+// Changes whenever a file might have been written, created, renamed, or
+// deleted through DOS; for caching file contents
+uint32_t DOS_GetFileChangeCount();
+// Changes whenever a file might have appeared, disappeared, or been renamed;
+// also after the host side has been rescanned
+uint32_t DOS_GetDirectoryChangeCount();
+void DOS_NotifyDirectoryChange();
 
 /* Helper Functions */
 bool DOS_MakeName(const char* const name, char* const fullname, uint8_t* drive);
@@ -4,8 +4,10 @@
 
 #include "dosbox.h"
 
+#include <algorithm>
 #include <cctype>
 #include <cstring>
+#include <vector>
 
 #include "cpu/callback.h"
 #include "cpu/cpu.h"
@@ -87,6 +89,28 @@ void DOS_UpdateCurrentProgramName()
 	VMWARE_NotifyProgramName(segment_name);
 }
 
+std::string DOS_GetCurrentProgramName()
+{
+	if (DOS_IsGuestOsBooted()) {
+		return {};
+	}
+
+	const auto psp_segment = dos.psp();
+	if (!PAGING_Enabled()) {
+		const auto it = psp_to_canonical_map.find(psp_segment);
+		if (it != psp_to_canonical_map.end()) {
+			return it->second;
+		}
+	}
+
+	char segment_name[9];
+	DOS_MCB mcb(psp_segment - 1);
+	mcb.GetFileName(segment_name);
+	segment_name[8] = 0;
+
+	return segment_name;
+}
+
 static void add_canonical_name(const uint16_t pspseg, const std::string& canonical_name)
 {
 	if (!PAGING_Enabled() && !DOS_IsGuestOsBooted()) {
@@ -423,9 +447,22 @@ bool DOS_Execute(char * name,PhysPt block_pt,uint8_t flags) {
 		if (flags==OVERLAY) relocate=block.overlay.relocation;
 		else relocate=loadseg;
 		pos=head.reloctable;DOS_SeekFile(fhandle,&pos,0);
-		for (i=0;i<head.relocations;i++) {
-			readsize=4;DOS_ReadFile(fhandle,(uint8_t *)&relocpt,&readsize);
-			relocpt=host_readd((HostPt)&relocpt);		//Endianize
+		/* Read the whole table at once, one read per entry is slow on mounted drives */
+		const auto table_size = head.relocations * sizeof(RealPt);
+		std::vector<uint8_t> reloctable(table_size);
+		size_t table_read = 0;
+		while (table_read < table_size) {
+			readsize = static_cast<uint16_t>(
+			        std::min(table_size - table_read, size_t{0x8000}));
+			if (!DOS_ReadFile(fhandle, reloctable.data() + table_read, &readsize) ||
+			    readsize == 0) {
+				break;
+			}
+			table_read += readsize;
+		}
+		const auto num_relocations = table_read / sizeof(RealPt);
+		for (i=0;i<num_relocations;i++) {
+			relocpt=host_readd(&reloctable[i*sizeof(RealPt)]);		//Endianize
 			PhysPt address=PhysicalMake(RealSegment(relocpt)+loadseg,RealOffset(relocpt));
 			mem_writew(address,mem_readw(address)+relocate);
 		}
@@ -10,13 +10,16 @@
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <random>
 
 #include "dosbox.h"
 #include "dos_windows.h"
 #include "ints/bios.h"
+#include "hardware/input/input_replay.h"
 #include "hardware/memory.h"
 #include "cpu/registers.h"
 #include "dos/drives.h"
+#include "dos/drive_local.h"
 #include "misc/cross.h"
 #include "config/setup.h"
 #include "utils/string_utils.h"
@@ -39,6 +42,17 @@ std::array<std::shared_ptr<DOS_Drive>, DOS_DRIVES> Drives = {};
 enum class FileLockingConfig { Auto, On, Off };
 static FileLockingConfig emulate_file_locking = FileLockingConfig::Auto;
 
+static bool file_read_ahead = true;
+static bool disk_image_write_back = false;
+
+static int image_preload_max_mb     = 0;
+static bool is_image_preload_forced = false;
+
+// Bumped by every call that might change a file's contents or name
+static uint32_t file_change_count = 0;
+// Bumped by every call that might add, remove, or rename a file
+static uint32_t directory_change_count = 0;
+
 enum class FileSharingMode
 {
 	Compatibility,
@@ -538,6 +552,7 @@ bool DOS_Rename(const char* const oldname, const char* const newname)
 	}
 
 	const auto new_ptr = Drives.at(drivenew);
+	DOS_NotifyDirectoryChange();
 
 	/*Test if target exists => no access */
 	FatAttributeFlags attr = {};
@@ -695,6 +710,7 @@ bool DOS_WriteFile(uint16_t entry,uint8_t * data,uint16_t * amount,bool fcb) {
 
 	bool ret=Files[handle]->Write(data,&towrite);
 	*amount=towrite;
+	++file_change_count;
 	if (ret) {
 		// When a write happens, mark that the time should be flushed on close.
 		// The updated time value is not the time of the write but the time of the close.
@@ -707,6 +723,38 @@ bool DOS_WriteFile(uint16_t entry,uint8_t * data,uint16_t * amount,bool fcb) {
 	return ret;
 }
 
+bool DOS_CopyFileOnHost(const uint16_t source_entry, const uint16_t target_entry)
+{
+	const auto source_handle = RealHandle(source_entry);
+	const auto target_handle = RealHandle(target_entry);
+	if (source_handle >= DOS_FILES || target_handle >= DOS_FILES ||
+	    !Files[source_handle] || !Files[target_handle]) {
+		return false;
+	}
+
+	auto source = dynamic_cast<localFile*>(Files[source_handle].get());
+	auto target = dynamic_cast<localFile*>(Files[target_handle].get());
+	if (!source || !target || source == target) {
+		return false;
+	}
+
+	// The locked regions are checked the same way as the chunked copy
+	// would, for the whole rest of the files
+	uint32_t source_pos = 0;
+	uint32_t target_pos = 0;
+	source->Seek(&source_pos, DOS_SEEK_CUR);
+	target->Seek(&target_pos, DOS_SEEK_CUR);
+	if (region_is_locked(source_handle, source_pos, UINT32_MAX - source_pos) ||
+	    region_is_locked(target_handle, target_pos, UINT32_MAX - target_pos)) {
+		return false;
+	}
+
+	const auto ret = source->CopyTo(*target);
+	++file_change_count;
+	target->flush_time_on_close = FlushTimeOnClose::CurrentTime;
+	return ret;
+}
+
 bool DOS_SeekFile(uint16_t entry,uint32_t * pos,uint32_t type,bool fcb) {
 	if (type > DOS_SEEK_END) {
 		DOS_SetError(DOSERR_FUNCTION_NUMBER_INVALID);
@@ -773,6 +821,7 @@ bool DOS_CreateFile(const char* name, FatAttributeFlags attributes,
 		return DOS_OpenFile(name, OPEN_READ, entry, fcb);
 
 	LOG(LOG_FILES, LOG_NORMAL)("file create attributes %X file %s", attributes._data, name);
+	DOS_NotifyDirectoryChange();
 
 	/* First check if the name is correct */
 	char fullname[DOS_PATHLENGTH];
@@ -978,6 +1027,7 @@ bool DOS_UnlinkFile(const char* const name)
 		return false;
 	}
 
+	DOS_NotifyDirectoryChange();
 	return Drives.at(drive)->FileUnlink(fullname);
 }
 
@@ -1143,11 +1193,14 @@ bool DOS_CreateTempFile(char * const name,uint16_t * entry) {
 	const auto old_errorcode = dos.errorcode;
 	dos.errorcode = 0;
 
-	static const auto randomize_letter = create_randomizer<int16_t>('A', 'Z');
+	// The names are visible to the guest, so the seed is recorded and
+	// replayed along with the input
+	static std::mt19937 generator(REPLAY_GetRandomSeed());
+	std::uniform_int_distribution<int16_t> randomize_letter('A', 'Z');
 	do {
 		uint32_t i;
 		for (i=0;i<8;i++) {
-			tempname[i] = check_cast<char>(randomize_letter());
+			tempname[i] = check_cast<char>(randomize_letter(generator));
 		}
 		tempname[8]=0;
 	} while (DOS_FileExists(name));
@@ -1888,8 +1941,54 @@ bool DOS_IsFileLocking()
 	}
 }
 
+bool DOS_IsFileReadAhead()
+{
+	return file_read_ahead;
+}
+
+bool DOS_IsDiskImageWriteBack()
+{
+	return disk_image_write_back;
+}
+
+bool DOS_ShouldPreloadImage(const int64_t size_bytes)
+{
+	if (size_bytes <= 0) {
+		return false;
+	}
+	constexpr int64_t BytesPerMb = 1024 * 1024;
+
+	return is_image_preload_forced ||
+	       size_bytes <= int64_t(image_preload_max_mb) * BytesPerMb;
+}
+
+void DOS_SetImagePreloadForced(const bool is_forced)
+{
+	is_image_preload_forced = is_forced;
+}
+
+uint32_t DOS_GetFileChangeCount()
+{
+	return file_change_count;
+}
+
+uint32_t DOS_GetDirectoryChangeCount()
+{
+	return directory_change_count;
+}
+
+void DOS_NotifyDirectoryChange()
+{
+	++file_change_count;
+	++directory_change_count;
+}
+
 void DOS_Files_Init(SectionProp& section)
 {
+	file_read_ahead = section.GetBool("file_read_ahead");
+	disk_image_write_back = section.GetBool("disk_image_write_back");
+	image_preload_max_mb  = section.GetInt("image_preload_max_mb");
+
 	const auto locking = section.GetString("file_locking");
 	const auto maybe_bool = parse_bool_setting(locking);
 	if (maybe_bool) {
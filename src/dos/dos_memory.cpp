@@ -6,6 +6,7 @@
 #include "config/config.h"
 #include "dos.h"
 #include "dos/dos_memory.h"
+#include "cpu/paging.h"
 #include "hardware/memory.h"
 #include "misc/support.h"
 
@@ -46,6 +47,29 @@ void DOS_SetMcbFaultStrategy(const char * mcb_fault_strategy_pref)
 		assertm(false, "Unhandled MCB fault strategy");
 }
 
+// Host-side copy of the fields of an MCB header that the chain walks use
+struct McbHeader {
+	uint8_t type         = 0;
+	uint16_t psp_segment = 0;
+	uint16_t size        = 0;
+};
+
+// Walking the chain reads every header, so it reads them straight from host
+// memory instead of going through the guest memory accessors one field at a
+// time. MCBs are paragraph aligned, so a header never crosses a page.
+static McbHeader read_mcb_header(const uint16_t segment)
+{
+	const auto address = PhysicalMake(segment, 0);
+#if !C_HEAVY_DEBUGGER
+	if (const auto tlb_addr = get_tlb_read(address); tlb_addr) {
+		const auto header = tlb_addr + address;
+		return {host_readb(header), host_readw(header + 1), host_readw(header + 3)};
+	}
+#endif
+	const DOS_MCB mcb(segment);
+	return {mcb.GetType(), mcb.GetPSPSeg(), mcb.GetSize()};
+}
+
 // returns true if the MCB block needed triaging
 static bool triage_block(DOS_MCB &mcb, const uint8_t repair_type)
 {
@@ -85,56 +109,64 @@ static bool triage_block(DOS_MCB &mcb, const uint8_t repair_type)
 static void DOS_CompressMemory()
 {
 	uint16_t mcb_segment = dos.firstMCB;
-	DOS_MCB mcb(mcb_segment);
-	DOS_MCB mcb_next(0);
+	auto header          = read_mcb_header(mcb_segment);
 
 	uint16_t faults = 0;
 
-	while (mcb.GetType() != ending_mcb_type && faults < max_allowed_faults) {
-		mcb_next.SetPt((uint16_t)(mcb_segment + mcb.GetSize() + 1));
-		if ((mcb.GetPSPSeg() == MCB_FREE) &&
-		    (mcb_next.GetPSPSeg() == MCB_FREE)) {
-			faults += triage_block(mcb_next, mcb.GetType());
-			mcb.SetSize(mcb.GetSize() + mcb_next.GetSize() + 1);
+	while (header.type != ending_mcb_type && faults < max_allowed_faults) {
+		const auto next_segment = static_cast<uint16_t>(mcb_segment +
+		                                                header.size + 1);
+		const auto next_header = read_mcb_header(next_segment);
+
+		if ((header.psp_segment == MCB_FREE) &&
+		    (next_header.psp_segment == MCB_FREE)) {
+			DOS_MCB mcb(mcb_segment);
+			DOS_MCB mcb_next(next_segment);
+			faults += triage_block(mcb_next, header.type);
+			mcb.SetSize(header.size + mcb_next.GetSize() + 1);
 			mcb.SetType(mcb_next.GetType());
+			header = read_mcb_header(mcb_segment);
 		} else {
-			mcb_segment+=mcb.GetSize()+1;
-			mcb.SetPt(mcb_segment);
+			mcb_segment = next_segment;
+			header      = next_header;
 		}
 	}
 }
 
 void DOS_FreeProcessMemory(uint16_t pspseg) {
 	uint16_t mcb_segment=dos.firstMCB;
-	DOS_MCB mcb(mcb_segment);
 
 	uint16_t faults = 0;
 	while (faults < max_allowed_faults) {
-		if (mcb.GetPSPSeg() == pspseg) {
-			mcb.SetPSPSeg(MCB_FREE);
+		const auto header = read_mcb_header(mcb_segment);
+		if (header.psp_segment == pspseg) {
+			DOS_MCB(mcb_segment).SetPSPSeg(MCB_FREE);
 		}
-		if (mcb.GetType() == ending_mcb_type)
+		if (header.type == ending_mcb_type)
 			break;
-		faults += triage_block(mcb, middle_mcb_type);
-		mcb_segment += mcb.GetSize() + 1;
-		mcb.SetPt(mcb_segment);
+		if (header.type != middle_mcb_type) {
+			DOS_MCB mcb(mcb_segment);
+			faults += triage_block(mcb, middle_mcb_type);
+		}
+		mcb_segment += header.size + 1;
 	}
 
 	uint16_t umb_start=dos_infoblock.GetStartOfUMBChain();
 	if (umb_start == umb_start_seg) {
-		DOS_MCB umb_mcb(umb_start);
-
 		faults = 0;
 		while (faults < max_allowed_faults) {
-			if (umb_mcb.GetPSPSeg() == pspseg) {
-				umb_mcb.SetPSPSeg(MCB_FREE);
+			const auto header = read_mcb_header(umb_start);
+			if (header.psp_segment == pspseg) {
+				DOS_MCB(umb_start).SetPSPSeg(MCB_FREE);
 			}
-			if (umb_mcb.GetType() == ending_mcb_type) {
+			if (header.type == ending_mcb_type) {
 				break;
 			}
-			faults += triage_block(umb_mcb, middle_mcb_type);
-			umb_start += umb_mcb.GetSize() + 1;
-			umb_mcb.SetPt(umb_start);
+			if (header.type != middle_mcb_type) {
+				DOS_MCB umb_mcb(umb_start);
+				faults += triage_block(umb_mcb, middle_mcb_type);
+			}
+			umb_start += header.size + 1;
 		}
 	} else if (umb_start != 0xffff)
 		LOG(LOG_DOSMISC, LOG_ERROR)("Corrupt UMB chain: %x", umb_start);
@@ -177,10 +209,11 @@ bool DOS_AllocateMemory(uint16_t * segment,uint16_t * blocks) {
 	psp_mcb.GetFileName(psp_name);
 	uint16_t found_seg=0,found_seg_size=0;
 	for (;;) {
+		const auto header = read_mcb_header(mcb_segment);
 		mcb.SetPt(mcb_segment);
-		if (mcb.GetPSPSeg()==MCB_FREE) {
+		if (header.psp_segment == MCB_FREE) {
 			/* Check for enough free memory in current block */
-			uint16_t block_size=mcb.GetSize();			
+			uint16_t block_size = header.size;
 			if (block_size<(*blocks)) {
 				if (bigsize<block_size) {
 					/* current block is largest block that was found,
@@ -197,7 +230,7 @@ bool DOS_AllocateMemory(uint16_t * segment,uint16_t * blocks) {
 					case 0: /* firstfit */
 						mcb_next.SetPt((uint16_t)(mcb_segment+*blocks+1));
 						mcb_next.SetPSPSeg(MCB_FREE);
-						mcb_next.SetType(mcb.GetType());
+						mcb_next.SetType(header.type);
 						mcb_next.SetSize(block_size-*blocks-1);
 						mcb.SetSize(*blocks);
 						mcb.SetType(middle_mcb_type);
@@ -222,7 +255,7 @@ bool DOS_AllocateMemory(uint16_t * segment,uint16_t * blocks) {
 			}
 		}
 		/* Onward to the next MCB if there is one */
-		if (mcb.GetType() == ending_mcb_type) {
+		if (header.type == ending_mcb_type) {
 			if ((mem_strat & 0x80) && (umb_start == umb_start_seg)) {
 				/* bit 7 set: try high memory first, then low */
 				mcb_segment=dos.firstMCB;
@@ -276,7 +309,7 @@ bool DOS_AllocateMemory(uint16_t * segment,uint16_t * blocks) {
 				return false;
 			}
 		} else
-			mcb_segment += mcb.GetSize() + 1;
+			mcb_segment += header.size + 1;
 	}
 	return false;
 }
@@ -395,17 +428,17 @@ void DOS_BuildUMBChain(bool umb_active, bool ems_active)
 		umb_mcb.SetType(ending_mcb_type);
 
 		/* Scan MCB-chain for last block */
-		uint16_t mcb_segment=dos.firstMCB;
-		DOS_MCB mcb(mcb_segment);
-		while (mcb.GetType() != ending_mcb_type) {
-			mcb_segment+=mcb.GetSize()+1;
-			mcb.SetPt(mcb_segment);
+		uint16_t mcb_segment = dos.firstMCB;
+		auto header          = read_mcb_header(mcb_segment);
+		while (header.type != ending_mcb_type) {
+			mcb_segment += header.size + 1;
+			header = read_mcb_header(mcb_segment);
 		}
 
 		/* A system MCB has to cover the space between the
 		   regular MCB-chain and the UMBs */
-		auto cover_mcb = static_cast<uint16_t>(mcb_segment+mcb.GetSize() + 1);
-		mcb.SetPt(cover_mcb);
+		auto cover_mcb = static_cast<uint16_t>(mcb_segment + header.size + 1);
+		DOS_MCB mcb(cover_mcb);
 		mcb.SetType(middle_mcb_type);
 		mcb.SetPSPSeg(0x0008);
 		mcb.SetSize(first_umb_seg-cover_mcb-1);
@@ -430,12 +463,13 @@ bool DOS_LinkUMBsToMemChain(uint16_t linkstate) {
 	/* Scan MCB-chain for last block before UMB-chain */
 	uint16_t mcb_segment=dos.firstMCB;
 	uint16_t prev_mcb_segment=dos.firstMCB;
-	DOS_MCB mcb(mcb_segment);
-	while ((mcb_segment != umb_start) && (mcb.GetType() != ending_mcb_type)) {
+	auto header = read_mcb_header(mcb_segment);
+	while ((mcb_segment != umb_start) && (header.type != ending_mcb_type)) {
 		prev_mcb_segment=mcb_segment;
-		mcb_segment+=mcb.GetSize()+1;
-		mcb.SetPt(mcb_segment);
+		mcb_segment += header.size + 1;
+		header = read_mcb_header(mcb_segment);
 	}
+	DOS_MCB mcb(mcb_segment);
 	DOS_MCB prev_mcb(prev_mcb_segment);
 
 	switch (linkstate) {
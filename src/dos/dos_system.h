@@ -7,7 +7,10 @@
 
 #include "dosbox.h"
 
+#include <list>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "utils/bit_view.h"
@@ -170,6 +173,8 @@ private:
 #define MAX_OPENDIRS 2048
 //Can be high as it's only storage (16 bit variable)
 
+class DirCacheScanner;
+
 class DOS_Drive_Cache final {
 public:
 	enum TDirSort { NOSORT, ALPHABETICAL, DIRALPHABETICAL, ALPHABETICALREV, DIRALPHABETICALREV };
@@ -202,6 +207,10 @@ public:
 	void SetLabel(const char *name, bool cdrom, bool allowupdate);
 	const char *GetLabel() const { return label; }
 
+	// Read the directory tree in the background, and keep the cache up
+	// to date with changes made on the host (where supported)
+	void StartHostScan();
+
 	class CFileInfo final {
 	public:
 		CFileInfo(void)
@@ -213,7 +222,9 @@ public:
 		          nextEntry(0),
 		          shortNr(0),
 		          fileList(0),
-		          longNameList(0)
+		          longNameList(0),
+		          longNameIndex(),
+		          hasLongNameIndex(false)
 		{}
 
 		~CFileInfo()
@@ -223,6 +234,7 @@ public:
 			}
 			fileList.clear();
 			longNameList.clear();
+			longNameIndex.clear();
 		}
 
 		char        orgname[CROSS_LEN];
@@ -235,6 +247,9 @@ public:
 		// contents
 		std::vector<CFileInfo*> fileList;
 		std::vector<CFileInfo*> longNameList;
+		// long name -> entry of longNameList; built on the first lookup
+		std::unordered_map<std::string, CFileInfo*> longNameIndex;
+		bool        hasLongNameIndex;
 	};
 
 private:
@@ -244,6 +259,7 @@ private:
 	bool		RemoveTrailingDot	(char* shortname);
 	Bits		GetLongName		(CFileInfo* info, char* shortname, const size_t shortname_len);
 	void		CreateShortName		(CFileInfo* dir, CFileInfo* info);
+	void		AddToLongNameIndex	(CFileInfo* dir, CFileInfo* info);
 	unsigned        CreateShortNameID       (CFileInfo* dir, const char* name);
 	int		CompareShortname	(const char* compareName, const char* shortName);
 	bool		SetResult		(CFileInfo* dir, char * &result, Bitu entryNr);
@@ -251,6 +267,12 @@ private:
 	CFileInfo*	FindDirInfo		(const char* path, char* expandedPath);
 	bool		RemoveSpaces		(char* str);
 	bool		OpenDir			(CFileInfo* dir, const char* path, uint16_t& id);
+	bool		CacheInPrefetched	(CFileInfo* dir);
+	void		CacheOutDir		(CFileInfo* dir);
+	void		ApplyHostChanges	(void);
+	void		ForgetExpandedNames	(void);
+	CFileInfo*	FindHostEntry		(CFileInfo* dir, const std::string& name);
+	CFileInfo*	FindCachedHostDir	(const std::string& host_dir);
 	void		CreateEntry		(CFileInfo* dir, const char* name, bool is_directory);
 	void		CopyEntry		(CFileInfo* dir, CFileInfo* from);
 	uint16_t		GetFreeID		(CFileInfo* dir);
@@ -271,6 +293,17 @@ private:
 
 	char		label				[CROSS_LEN];
 	bool		updatelabel;
+
+	std::unique_ptr<DirCacheScanner> scanner;
+
+	// Recent GetExpandNameAndNormaliseCase results, host path as passed
+	// in -> expanded path; dropped whenever the cached tree changes
+	struct ExpandedName {
+		std::string name = {};
+		std::list<std::string>::iterator lru_pos = {};
+	};
+	std::unordered_map<std::string, ExpandedName> expanded_names = {};
+	std::list<std::string> expanded_names_lru = {};
 };
 
 enum class DosDriveType : uint16_t {
@@ -280,6 +313,7 @@ enum class DosDriveType : uint16_t {
 	Fat     = 3,
 	Iso     = 4,
 	Virtual = 5,
+	Zip     = 6,
 };
 
 class DOS_Drive {
@@ -333,6 +367,8 @@ public:
 			return MSG_Get("MOUNT_TYPE_FAT") + std::string(" ") + info;
 		case DosDriveType::Iso:
 			return MSG_Get("MOUNT_TYPE_ISO") + std::string(" ") + info;
+		case DosDriveType::Zip:
+			return MSG_Get("MOUNT_TYPE_ZIP") + std::string(" ") + info;
 		case DosDriveType::Virtual: return MSG_Get("MOUNT_TYPE_VIRTUAL");
 		default: return MSG_Get("MOUNT_TYPE_UNKNOWN");
 		}
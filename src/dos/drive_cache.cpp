@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "dos.h"
+#include "dos/drive_cache_scanner.h"
 #include "dos/drives.h"
 #include "misc/cross.h"
 #include "misc/support.h"
@@ -17,6 +18,9 @@
 
 int fileInfoCounter = 0;
 
+// Enough for the include and library paths of a compiler run
+constexpr size_t MaxExpandedNames = 512;
+
 bool SortByName(DOS_Drive_Cache::CFileInfo* const a,
                 DOS_Drive_Cache::CFileInfo* const b)
 {
@@ -45,6 +49,17 @@ bool SortByDirNameRev(DOS_Drive_Cache::CFileInfo* const a,
 	return strcmp(a->shortname,b->shortname)>0;
 }
 
+// Key of a long name in the long name index; matches the comparison
+// GetShortName used to scan the list with
+static std::string to_long_name_key(const char* name)
+{
+	std::string key = name;
+#if defined(WIN32)
+	upcase(key);
+#endif
+	return key;
+}
+
 DOS_Drive_Cache::DOS_Drive_Cache(void)
 	: dirBase(new CFileInfo),
 	  dirPath{0},
@@ -89,6 +104,7 @@ DOS_Drive_Cache::~DOS_Drive_Cache(void) {
 }
 
 void DOS_Drive_Cache::Clear(void) {
+	ForgetExpandedNames();
 	DeleteFileInfo(dirBase);
 	dirBase = nullptr;
 	nextFreeFindFirst	= 0;
@@ -105,6 +121,13 @@ void DOS_Drive_Cache::EmptyCache(void) {
 	if (basePath[0] != 0) SetBaseDir(basePath);
 }
 
+void DOS_Drive_Cache::StartHostScan()
+{
+	if (!scanner && basePath[0] != 0) {
+		scanner = std::make_unique<DirCacheScanner>(basePath);
+	}
+}
+
 void DOS_Drive_Cache::SetLabel(const char* vname,bool cdrom,bool allowupdate) {
 /* allowupdate defaults to true. if mount sets a label then allowupdate is 
  * false and will this function return at once after the first call.
@@ -170,6 +193,21 @@ char* DOS_Drive_Cache::GetExpandNameAndNormaliseCase(const char* path)
 	static char work [CROSS_LEN] = { 0 };
 	char dir [CROSS_LEN];
 
+	// Host changes are applied by FindDirInfo; do it first, so they
+	// drop the stale names
+	if (scanner && scanner->HasChanges()) {
+		ApplyHostChanges();
+	}
+
+	const std::string key = path;
+	if (const auto it = expanded_names.find(key); it != expanded_names.end()) {
+		expanded_names_lru.splice(expanded_names_lru.begin(),
+		                          expanded_names_lru,
+		                          it->second.lru_pos);
+		safe_strcpy(work, it->second.name.c_str());
+		return work;
+	}
+
 	work[0] = 0;
 	safe_strcpy (dir, path);
 
@@ -195,9 +233,25 @@ char* DOS_Drive_Cache::GetExpandNameAndNormaliseCase(const char* path)
 			work[len-1] = 0; // Remove trailing slashes except when in root
 		}
 	}
+
+	if (expanded_names.size() >= MaxExpandedNames) {
+		expanded_names.erase(expanded_names_lru.back());
+		expanded_names_lru.pop_back();
+	}
+	expanded_names_lru.push_front(key);
+	expanded_names[key] = {work, expanded_names_lru.begin()};
+
 	return work;
 }
 
+void DOS_Drive_Cache::ForgetExpandedNames()
+{
+	if (!expanded_names.empty()) {
+		expanded_names.clear();
+		expanded_names_lru.clear();
+	}
+}
+
 void DOS_Drive_Cache::AddEntry(const char* path, bool checkExists) {
 	// Get Last part...
 	char file	[CROSS_LEN];
@@ -341,6 +395,10 @@ void DOS_Drive_Cache::CacheOut(const char* path, bool ignoreLastDir) {
 	}
 
 //	LOG_DEBUG("DIR: Caching out %s : dir %s",expand,dir->orgname);
+	CacheOutDir(dir);
+}
+
+void DOS_Drive_Cache::CacheOutDir(CFileInfo* dir) {
 	// delete file objects...
 	//Maybe check if it is a file and then only delete the file and possibly the long name. instead of all objects in the dir.
 	for(uint32_t i=0; i<dir->fileList.size(); i++) {
@@ -349,12 +407,103 @@ void DOS_Drive_Cache::CacheOut(const char* path, bool ignoreLastDir) {
 		DeleteFileInfo(dir->fileList[i]);
 		dir->fileList[i] = nullptr;
 	}
+	ForgetExpandedNames();
+
 	// clear lists
 	dir->fileList.clear();
 	dir->longNameList.clear();
+	dir->longNameIndex.clear();
+	dir->hasLongNameIndex = false;
 	save_dir = nullptr;
 }
 
+void DOS_Drive_Cache::ApplyHostChanges()
+{
+	assert(scanner);
+
+	for (const auto& change : scanner->TakeChanges()) {
+		if (change.type == DirCacheScanner::ChangeType::Overflow) {
+			// Some changes were lost; the remaining ones are older
+			// than the fresh cache anyway
+			EmptyCache();
+			return;
+		}
+
+		// Directories which are not cached in get read from the host
+		// once they are needed, with the change in place already
+		CFileInfo* dir = FindCachedHostDir(change.dir);
+		if (!dir) {
+			continue;
+		}
+
+		if (change.type == DirCacheScanner::ChangeType::Removed) {
+			// Same as DeleteEntry, entries cannot be removed one by one
+			CacheOutDir(dir);
+			continue;
+		}
+
+		// DOS programs creating files cause these as well
+		if (FindHostEntry(dir, change.name)) {
+			continue;
+		}
+		CreateEntry(dir, change.name.c_str(), change.is_directory);
+
+		const auto& list = dir->fileList;
+		const auto it = std::find(list.begin(),
+		                          list.end(),
+		                          FindHostEntry(dir, change.name));
+		const auto index = static_cast<size_t>(it - list.begin());
+
+		// Check if there are any open search dir that are affected by this...
+		for (uint32_t i = 0; i < MAX_OPENDIRS; i++) {
+			if ((dirSearch[i] == dir) && (index <= dirSearch[i]->nextEntry)) {
+				dirSearch[i]->nextEntry++;
+			}
+		}
+	}
+}
+
+DOS_Drive_Cache::CFileInfo* DOS_Drive_Cache::FindHostEntry(CFileInfo* dir,
+                                                           const std::string& name)
+{
+	for (const auto info : dir->fileList) {
+		if (name == info->orgname) {
+			return info;
+		}
+	}
+	return nullptr;
+}
+
+DOS_Drive_Cache::CFileInfo* DOS_Drive_Cache::FindCachedHostDir(const std::string& host_dir)
+{
+	// Unlike FindDirInfo, this walks the tree by the host (long) names and
+	// never caches anything in
+	std::string base = basePath;
+	if (base.empty() || base.back() != CROSS_FILESPLIT) {
+		base += CROSS_FILESPLIT;
+	}
+	if (!host_dir.starts_with(base)) {
+		return nullptr;
+	}
+
+	CFileInfo* dir = dirBase;
+	for (auto start = base.size(); start < host_dir.size();) {
+		if (!IsCachedIn(dir)) {
+			return nullptr;
+		}
+		auto end = host_dir.find(CROSS_FILESPLIT, start);
+		if (end == std::string::npos) {
+			end = host_dir.size();
+		}
+		dir = FindHostEntry(dir, host_dir.substr(start, end - start));
+		if (!dir || !dir->isDir) {
+			return nullptr;
+		}
+		start = end + 1;
+	}
+	return IsCachedIn(dir) ? dir : nullptr;
+}
+
 bool DOS_Drive_Cache::IsCachedIn(CFileInfo* curDir)
 {
 	return curDir->isOverlayDir || !curDir->fileList.empty();
@@ -372,23 +521,38 @@ bool DOS_Drive_Cache::GetShortName(const char* fullname, char* shortname) {
 	else
 		return false;
 
-	std::vector<CFileInfo*>::size_type filelist_size = curDir->longNameList.size();
-	if (filelist_size <= 0) {
+	if (curDir->longNameList.empty()) {
 		return false;
 	}
 
-	// The orgname part of the list is not sorted (shortname is)! So we can only walk through it.
-	for(Bitu i = 0; i < filelist_size; i++) {
-#if defined (WIN32)
-		if (strcasecmp(pos,curDir->longNameList[i]->orgname) == 0) {
-#else
-		if (strcmp(pos,curDir->longNameList[i]->orgname) == 0) {
-#endif
-			safe_strncpy(shortname, curDir->longNameList[i]->shortname, DOS_NAMELENGTH_ASCII);
-			return true;
+	// The orgname part of the list is not sorted (shortname is), so look
+	// it up in the index instead of walking through it
+	if (!curDir->hasLongNameIndex) {
+		curDir->longNameIndex.reserve(curDir->longNameList.size());
+		for (const auto info : curDir->longNameList) {
+			AddToLongNameIndex(curDir, info);
 		}
+		curDir->hasLongNameIndex = true;
+	}
+
+	const auto it = curDir->longNameIndex.find(to_long_name_key(pos));
+	if (it == curDir->longNameIndex.end()) {
+		return false;
+	}
+	safe_strncpy(shortname, it->second->shortname, DOS_NAMELENGTH_ASCII);
+	return true;
+}
+
+void DOS_Drive_Cache::AddToLongNameIndex(CFileInfo* dir, CFileInfo* info)
+{
+	// If several entries have the same long name, the first one in the
+	// (sorted) list wins
+	const auto [it, inserted] = dir->longNameIndex.try_emplace(
+	        to_long_name_key(info->orgname), info);
+
+	if (!inserted && SortByName(info, it->second)) {
+		it->second = info;
 	}
-	return false;
 }
 
 int DOS_Drive_Cache::CompareShortname(const char* compareName, const char* shortName) {
@@ -579,28 +743,14 @@ void DOS_Drive_Cache::CreateShortName(CFileInfo* curDir, CFileInfo* info) {
 			info->shortname[DOS_NAMELENGTH] = 0;
 		}
 
-		// keep list sorted for CreateShortNameID to work correctly
-		if (!curDir->longNameList.empty()) {
-			if (!(strcmp(info->shortname,curDir->longNameList.back()->shortname)<0)) {
-				// append at end of list
-				curDir->longNameList.push_back(info);
-			} else {
-				// look for position where to insert this element
-				bool found=false;
-				std::vector<CFileInfo*>::iterator it;
-				for (it=curDir->longNameList.begin(); it!=curDir->longNameList.end(); ++it) {
-					if (strcmp(info->shortname,(*it)->shortname)<0) {
-						found = true;
-						break;
-					}
-				}
-				// Put it in longname list...
-				if (found) curDir->longNameList.insert(it,info);
-				else curDir->longNameList.push_back(info);
-			}
-		} else {
-			// empty file list, append
-			curDir->longNameList.push_back(info);
+		// keep list sorted for CreateShortNameID to work correctly;
+		// the element goes after any with the same short name
+		auto& list = curDir->longNameList;
+		list.insert(std::upper_bound(list.begin(), list.end(), info, SortByName),
+		            info);
+
+		if (curDir->hasLongNameIndex) {
+			AddToLongNameIndex(curDir, info);
 		}
 	} else {
 		safe_strcpy(info->shortname, tmpName);
@@ -609,6 +759,11 @@ void DOS_Drive_Cache::CreateShortName(CFileInfo* curDir, CFileInfo* info) {
 }
 
 DOS_Drive_Cache::CFileInfo* DOS_Drive_Cache::FindDirInfo(const char* path, char* expandedPath) {
+	// Before anything else, as this can replace dirBase
+	if (scanner && scanner->HasChanges()) {
+		ApplyHostChanges();
+	}
+
 	// statics
 	static char	split[2] = { CROSS_FILESPLIT,0 };
 	
@@ -737,6 +892,8 @@ bool DOS_Drive_Cache::OpenDir(CFileInfo* dir, const char* expand, uint16_t& id)
 }
 
 void DOS_Drive_Cache::CreateEntry(CFileInfo* dir, const char* name, bool is_directory) {
+	ForgetExpandedNames();
+
 	auto info = new CFileInfo;
 	safe_strcpy(info->orgname, name);
 	info->shortNr = 0;
@@ -745,30 +902,12 @@ void DOS_Drive_Cache::CreateEntry(CFileInfo* dir, const char* name, bool is_dire
 	// Check for long filenames...
 	CreateShortName(dir, info);		
 
-	bool found = false;
-
-	// keep list sorted (so GetLongName works correctly, used by CreateShortName in this routine)
-	if (!dir->fileList.empty()) {
-		if (!(strcmp(info->shortname,dir->fileList.back()->shortname)<0)) {
-			// append at end of list
-			dir->fileList.push_back(info);
-		} else {
-			// look for position where to insert this element
-			std::vector<CFileInfo*>::iterator it;
-			for (it=dir->fileList.begin(); it!=dir->fileList.end(); ++it) {
-				if (strcmp(info->shortname,(*it)->shortname)<0) {
-					found = true;
-					break;
-				}
-			}
-			// Put file in lists
-			if (found) dir->fileList.insert(it,info);
-			else dir->fileList.push_back(info);
-		}
-	} else {
-		// empty file list, append
-		dir->fileList.push_back(info);
-	}
+	// keep list sorted (so GetLongName works correctly, used by
+	// CreateShortName in this routine); the element goes after any with
+	// the same short name
+	auto& list = dir->fileList;
+	list.insert(std::upper_bound(list.begin(), list.end(), info, SortByName),
+	            info);
 }
 
 void DOS_Drive_Cache::CopyEntry(CFileInfo* dir, CFileInfo* from) {
@@ -787,7 +926,7 @@ bool DOS_Drive_Cache::ReadDir(uint16_t id, char* &result) {
 	if (id >= MAX_OPENDIRS)
 		return false;
 
-	if (!IsCachedIn(dirSearch[id])) {
+	if (!IsCachedIn(dirSearch[id]) && !CacheInPrefetched(dirSearch[id])) {
 		// Try to open directory
 		DirInformation* dirp = open_directory(dirPath);
 		if (!dirp) {
@@ -829,6 +968,23 @@ bool DOS_Drive_Cache::ReadDir(uint16_t id, char* &result) {
 	return false;
 }
 
+bool DOS_Drive_Cache::CacheInPrefetched(CFileInfo* dir)
+{
+	if (!scanner) {
+		return false;
+	}
+	const auto entries = scanner->TakeListing(dirPath);
+	if (!entries) {
+		return false;
+	}
+	// Same order as read_directory_next() gives, so the short names
+	// come out the same
+	for (const auto& entry : *entries) {
+		CreateEntry(dir, entry.name.c_str(), entry.is_directory);
+	}
+	return true;
+}
+
 bool DOS_Drive_Cache::SetResult(CFileInfo* dir, char* &result, Bitu entryNr)
 {
 	static char res[CROSS_LEN] = { 0 };
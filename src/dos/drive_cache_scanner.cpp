@@ -0,0 +1,303 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dos/drive_cache_scanner.h"
+
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+#if defined(LINUX)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "misc/cross.h"
+#include "misc/support.h"
+
+// Stop prefetching once this many entries are held, so mounting a huge tree
+// (or the root of the host filesystem) does not eat the memory. The rest is
+// read on demand, as before.
+constexpr size_t MaxPrefetchedEntries = 100'000;
+
+// Time stamps are coarse (two seconds on FAT), so a change made this soon
+// after the last one might not show. Such directories are read on demand.
+constexpr auto RecentlyModified = std::chrono::seconds(3);
+
+static std::string with_trailing_separator(std::string dir)
+{
+	if (dir.empty() || dir.back() != CROSS_FILESPLIT) {
+		dir += CROSS_FILESPLIT;
+	}
+	return dir;
+}
+
+DirCacheScanner::DirCacheScanner(const std::string& _base_dir)
+        : base_dir(with_trailing_separator(_base_dir))
+{
+#if defined(LINUX)
+	inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	wakeup_fd  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (inotify_fd < 0 || wakeup_fd < 0) {
+		LOG_WARNING("DIRCACHE: Cannot watch '%s' for changes: %s",
+		            base_dir.c_str(),
+		            strerror(errno));
+		if (inotify_fd >= 0) {
+			close(inotify_fd);
+			inotify_fd = -1;
+		}
+		can_watch = false;
+	}
+#endif
+	thread = std::thread(&DirCacheScanner::Run, this);
+	set_thread_name(thread, "dosbox:dircache");
+}
+
+DirCacheScanner::~DirCacheScanner()
+{
+	should_exit = true;
+
+#if defined(LINUX)
+	if (wakeup_fd >= 0) {
+		const uint64_t value = 1;
+		[[maybe_unused]] const auto ret = write(wakeup_fd,
+		                                        &value,
+		                                        sizeof(value));
+	}
+#endif
+	thread.join();
+
+#if defined(LINUX)
+	if (inotify_fd >= 0) {
+		close(inotify_fd);
+	}
+	if (wakeup_fd >= 0) {
+		close(wakeup_fd);
+	}
+#endif
+}
+
+std::optional<std::vector<DirCacheScanner::Entry>> DirCacheScanner::TakeListing(
+        const std::string& dir)
+{
+	std::unique_lock lock(mutex);
+
+	const auto it = listings.find(dir);
+	if (it == listings.end()) {
+		return {};
+	}
+	auto listing = std::move(it->second);
+	listings.erase(it);
+	lock.unlock();
+
+	// Anything created, deleted, or renamed in the directory after the
+	// scan bumps its modification time
+	std::error_code ec = {};
+	if (std_fs::last_write_time(dir, ec) != listing.modified || ec) {
+		return {};
+	}
+	return std::move(listing.entries);
+}
+
+std::vector<DirCacheScanner::Change> DirCacheScanner::TakeChanges()
+{
+	std::lock_guard lock(mutex);
+
+	has_changes.store(false, std::memory_order_release);
+	return std::exchange(changes, {});
+}
+
+void DirCacheScanner::AddChange(Change&& change)
+{
+	std::lock_guard lock(mutex);
+
+	listings.erase(change.dir);
+	changes.emplace_back(std::move(change));
+	has_changes.store(true, std::memory_order_release);
+}
+
+void DirCacheScanner::Run()
+{
+	// Breadth-first, so the directories closest to the root (the ones
+	// likely to be listed first) are ready first
+	std::deque<std::string> pending = {base_dir};
+	size_t num_entries = 0;
+
+	while (!should_exit) {
+		if (!pending.empty() && num_entries < MaxPrefetchedEntries) {
+			const auto dir = std::move(pending.front());
+			pending.pop_front();
+			num_entries += ScanDir(dir, pending);
+#if defined(LINUX)
+			ReadEvents(false);
+#endif
+			continue;
+		}
+#if defined(LINUX)
+		if (inotify_fd >= 0) {
+			ReadEvents(true);
+			continue;
+		}
+#endif
+		break;
+	}
+}
+
+size_t DirCacheScanner::ScanDir(const std::string& dir,
+                                std::deque<std::string>& pending)
+{
+#if defined(LINUX)
+	// Watch before reading, so no change can slip in between
+	Watch(dir);
+#endif
+
+	// Take the time stamp before reading too; a change made while the
+	// directory is being read makes the listing stale
+	const auto now      = std_fs::file_time_type::clock::now();
+	std::error_code ec  = {};
+	const auto modified = std_fs::last_write_time(dir, ec);
+	if (ec) {
+		return 0;
+	}
+	const bool is_trusted = modified < now - RecentlyModified;
+
+	Listing listing = {modified, {}};
+
+	// Mimic read_directory_first/next(), which report the dot entries
+	// except for the root of a Windows drive
+#if defined(WIN32)
+	const bool has_dot_entries = std_fs::path(dir).has_relative_path();
+#else
+	constexpr bool has_dot_entries = true;
+#endif
+	if (has_dot_entries) {
+		listing.entries.push_back({".", true});
+		listing.entries.push_back({"..", true});
+	}
+
+	for (const auto& entry : std_fs::directory_iterator(dir, ec)) {
+		if (should_exit) {
+			return 0;
+		}
+		std::error_code entry_ec = {};
+		const bool is_directory  = entry.is_directory(entry_ec);
+
+		auto name = entry.path().filename().string();
+		if (is_directory && !entry.is_symlink(entry_ec)) {
+			// Symlinks are not followed, as they could form a loop
+			pending.push_back(dir + name + CROSS_FILESPLIT);
+		}
+		listing.entries.push_back({std::move(name), is_directory});
+	}
+	if (ec || !is_trusted) {
+		return 0;
+	}
+
+	const auto num_entries = listing.entries.size();
+
+	std::lock_guard lock(mutex);
+	listings[dir] = std::move(listing);
+
+	return num_entries;
+}
+
+#if defined(LINUX)
+
+bool DirCacheScanner::Watch(const std::string& dir)
+{
+	if (inotify_fd < 0 || !can_watch) {
+		return false;
+	}
+	constexpr uint32_t Mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+	                          IN_MOVED_TO | IN_ONLYDIR;
+
+	const auto wd = inotify_add_watch(inotify_fd, dir.c_str(), Mask);
+	if (wd < 0) {
+		// Usually the per-user watch limit; the directories that are
+		// already watched stay up to date
+		LOG_WARNING("DIRCACHE: Cannot watch '%s' for changes: %s",
+		            dir.c_str(),
+		            strerror(errno));
+		can_watch = false;
+		return false;
+	}
+	watched_dirs[wd] = dir;
+	watch_ids[dir]   = wd;
+	return true;
+}
+
+void DirCacheScanner::Unwatch(const std::string& dir)
+{
+	// Drops the directory and everything below it
+	for (auto it = watch_ids.begin(); it != watch_ids.end();) {
+		if (it->first.starts_with(dir)) {
+			inotify_rm_watch(inotify_fd, it->second);
+			watched_dirs.erase(it->second);
+			it = watch_ids.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+void DirCacheScanner::ReadEvents(const bool wait)
+{
+	pollfd fds[2] = {{inotify_fd, POLLIN, 0}, {wakeup_fd, POLLIN, 0}};
+	if (poll(fds, 2, wait ? -1 : 0) <= 0 || !(fds[0].revents & POLLIN)) {
+		return;
+	}
+
+	alignas(inotify_event) char buffer[4096];
+	const auto len = read(inotify_fd, buffer, sizeof(buffer));
+	if (len <= 0) {
+		return;
+	}
+
+	for (auto pos = buffer; pos < buffer + len;) {
+		const auto event = reinterpret_cast<const inotify_event*>(pos);
+		pos += sizeof(inotify_event) + event->len;
+
+		if (event->mask & IN_Q_OVERFLOW) {
+			AddChange({ChangeType::Overflow});
+			continue;
+		}
+		const auto it = watched_dirs.find(event->wd);
+		if (it == watched_dirs.end()) {
+			continue;
+		}
+		if (event->mask & IN_IGNORED) {
+			// The directory is gone; its parent reports the removal
+			watch_ids.erase(it->second);
+			watched_dirs.erase(it);
+			continue;
+		}
+		if (event->len == 0) {
+			continue;
+		}
+
+		const auto dir          = it->second;
+		const std::string name  = event->name;
+		const bool is_directory = event->mask & IN_ISDIR;
+		const auto path         = dir + name + CROSS_FILESPLIT;
+
+		if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+			if (is_directory) {
+				Watch(path);
+			}
+			AddChange({ChangeType::Added, dir, name, is_directory});
+
+		} else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+			if (is_directory) {
+				Unwatch(path);
+			}
+			AddChange({ChangeType::Removed, dir, name, is_directory});
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_DRIVE_CACHE_SCANNER_H
+#define DOSBOX_DRIVE_CACHE_SCANNER_H
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/fs_utils.h"
+
+// Reads the host directory tree of a mounted drive on a background thread,
+// so DOS_Drive_Cache does not have to block on the first listing of each
+// directory. On Linux it also watches the tree with inotify and reports
+// host-side changes, so the cache can update single directories instead of
+// being thrown away by RESCAN.
+//
+// Listings are stamped with the directory's modification time taken before
+// reading it, and are only handed out if the stamp still matches. A listing
+// that went stale in the meantime (for example because a DOS program created
+// a file) is never used. Directories modified just before the scan are not
+// prefetched, as the stamp could miss a change made right after.
+class DirCacheScanner {
+public:
+	struct Entry {
+		std::string name  = {};
+		bool is_directory = false;
+	};
+
+	enum class ChangeType {
+		Added,
+		Removed,
+		// Changes were lost; the whole cache has to be rebuilt
+		Overflow,
+	};
+
+	struct Change {
+		ChangeType type = ChangeType::Added;
+		// Host directory with a trailing separator, as used by the cache
+		std::string dir   = {};
+		std::string name  = {};
+		bool is_directory = false;
+	};
+
+	explicit DirCacheScanner(const std::string& base_dir);
+	~DirCacheScanner();
+
+	DirCacheScanner(const DirCacheScanner&)            = delete;
+	DirCacheScanner& operator=(const DirCacheScanner&) = delete;
+
+	// Hands over the listing of 'dir' (with a trailing separator) if the
+	// scan has read it and the directory has not changed since
+	std::optional<std::vector<Entry>> TakeListing(const std::string& dir);
+
+	// Returns the host-side changes reported since the last call, oldest
+	// first
+	std::vector<Change> TakeChanges();
+
+	bool HasChanges() const
+	{
+		return has_changes.load(std::memory_order_acquire);
+	}
+
+private:
+	struct Listing {
+		std_fs::file_time_type modified = {};
+		std::vector<Entry> entries      = {};
+	};
+
+	void Run();
+	size_t ScanDir(const std::string& dir, std::deque<std::string>& pending);
+	void AddChange(Change&& change);
+
+#if defined(LINUX)
+	bool Watch(const std::string& dir);
+	void Unwatch(const std::string& dir);
+	void ReadEvents(const bool wait);
+
+	int inotify_fd = -1;
+	int wakeup_fd  = -1;
+	// Cleared once a watch could not be added, e.g. at the user's limit
+	bool can_watch = true;
+
+	// Watch descriptor <-> directory, only touched by the scanner thread
+	std::unordered_map<int, std::string> watched_dirs = {};
+	std::unordered_map<std::string, int> watch_ids    = {};
+#endif
+
+	std::string base_dir = {};
+
+	std::mutex mutex                                   = {};
+	std::unordered_map<std::string, Listing> listings = {};
+	std::vector<Change> changes                        = {};
+	std::atomic<bool> has_changes                      = false;
+
+	std::atomic<bool> should_exit = false;
+	std::thread thread            = {};
+};
+
+#endif
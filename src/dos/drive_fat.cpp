@@ -3,6 +3,7 @@
 
 #include "dos/drives.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -43,6 +44,7 @@ public:
 	uint32_t currentSector              = 0;
 	uint32_t curSectOff                 = 0;
 	uint8_t sectorBuffer[BytePerSector] = {0};
+	FatClusterChain clusterChain        = {};
 	/* Record of where in the directory structure this file is located */
 	uint32_t dirCluster = 0;
 	uint32_t dirIndex   = 0;
@@ -96,7 +98,7 @@ bool fatFile::Read(uint8_t * data, uint16_t *size) {
 	}
 
 	if (!loadedSector) {
-		currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos);
+		currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos, clusterChain);
 		if(currentSector == 0) {
 			/* EOC reached before EOF */
 			*size = 0;
@@ -118,7 +120,7 @@ bool fatFile::Read(uint8_t * data, uint16_t *size) {
 		data[sizecount++] = sectorBuffer[curSectOff++];
 		seekpos++;
 		if(curSectOff >= myDrive->getSectorSize()) {
-			currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos);
+			currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos, clusterChain);
 			if(currentSector == 0) {
 				/* EOC reached before EOF */
 				//LOG_MSG("EOC reached before EOF, seekpos %d, filelen %d", seekpos, filelength);
@@ -190,17 +192,17 @@ bool fatFile::Write(uint8_t * data, uint16_t *size) {
 				firstCluster = myDrive->getFirstFreeClust();
 				if(firstCluster == 0) goto finalizeWrite; // out of space
 				myDrive->allocateCluster(firstCluster, 0);
-				currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos);
+				currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos, clusterChain);
 				myDrive->readSector(currentSector, sectorBuffer);
 				loadedSector = true;
 			}
 			if (!loadedSector) {
-				currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos);
+				currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos, clusterChain);
 				if(currentSector == 0) {
 					/* EOC reached before EOF - try to increase file allocation */
 					myDrive->appendCluster(firstCluster);
 					/* Try getting sector again */
-					currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos);
+					currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos, clusterChain);
 					if(currentSector == 0) {
 						/* No can do. lets give up and go home.  We must be out of room */
 						goto finalizeWrite;
@@ -217,7 +219,7 @@ bool fatFile::Write(uint8_t * data, uint16_t *size) {
 		if(curSectOff >= myDrive->getSectorSize()) {
 			if(loadedSector) myDrive->writeSector(currentSector, sectorBuffer);
 
-			currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos);
+			currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos, clusterChain);
 			if(currentSector == 0) loadedSector = false;
 			else {
 				curSectOff = 0;
@@ -263,7 +265,7 @@ bool fatFile::Seek(uint32_t *pos, uint32_t type) {
 
 	if(seekto<0) seekto = 0;
 	seekpos = (uint32_t)seekto;
-	currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos);
+	currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos, clusterChain);
 	if (currentSector == 0) {
 		/* not within file size, thus no sector is available */
 		loadedSector = false;
@@ -316,10 +318,64 @@ uint32_t fatDrive::getClustFirstSect(uint32_t clustNum) {
 	return ((clustNum - 2) * bootbuffer.sectorspercluster) + firstDataSector;
 }
 
+uint8_t* fatDrive::getFatEntry(uint32_t fatoffset) {
+	const uint32_t bytesPerSector = bootbuffer.bytespersector;
+	const uint32_t pageBytes = fatCachePageSectors * bytesPerSector;
+	const uint32_t pageNum = fatoffset / pageBytes;
+
+	if (pageNum >= fatCache.size())
+		fatCache.resize(pageNum + 1);
+
+	auto& page = fatCache[pageNum];
+	if (page.empty()) {
+		/* One sector more, as the two-sector buffer this replaces
+		 * did, for FAT12 entries straddling the end of the page */
+		page.resize(pageBytes + bytesPerSector);
+		const uint32_t firstSect = bootbuffer.reservedsectors +
+		                           pageNum * fatCachePageSectors + partSectOff;
+		for (uint32_t i = 0; i <= fatCachePageSectors; i++)
+			readSector(firstSect + i, &page[i * bytesPerSector]);
+	}
+	return &page[fatoffset % pageBytes];
+}
+
+void fatDrive::updateFatCache(uint32_t sectnum, const void* data) {
+	/* Only the first FAT is ever read */
+	const uint32_t fatStart = bootbuffer.reservedsectors + partSectOff;
+	if (sectnum < fatStart || sectnum > fatStart + bootbuffer.sectorsperfat)
+		return;
+
+	const uint32_t bytesPerSector = bootbuffer.bytespersector;
+	const uint32_t fatSect = sectnum - fatStart;
+
+	/* A sector can also be the extra one at the end of the page before */
+	for (uint32_t pageNum = fatSect / fatCachePageSectors;; pageNum--) {
+		const uint32_t offset = (fatSect - pageNum * fatCachePageSectors) * bytesPerSector;
+		if (pageNum < fatCache.size() && offset < fatCache[pageNum].size()) {
+			uint8_t* cached = &fatCache[pageNum][offset];
+			if (memcmp(cached, data, bytesPerSector) != 0) {
+				/* Written by someone else than setClusterValue(),
+				 * such as INT 26h; any chain could have changed */
+				memcpy(cached, data, bytesPerSector);
+				chainGeneration++;
+			}
+		}
+		if (pageNum == 0 || (fatSect % fatCachePageSectors) != 0)
+			break;
+	}
+}
+
+bool fatDrive::isEndOfChain(uint32_t clustValue) const {
+	switch(fattype) {
+		case FAT12: return clustValue >= 0xff8;
+		case FAT16: return clustValue >= 0xfff8;
+		case FAT32: return clustValue >= 0xfffffff8;
+	}
+	return true;
+}
+
 uint32_t fatDrive::getClusterValue(uint32_t clustNum) {
 	uint32_t fatoffset=0;
-	uint32_t fatsectnum;
-	uint32_t fatentoff;
 	uint32_t clustValue=0;
 
 	switch(fattype) {
@@ -333,20 +389,11 @@ uint32_t fatDrive::getClusterValue(uint32_t clustNum) {
 			fatoffset = clustNum * 4;
 			break;
 	}
-	fatsectnum = bootbuffer.reservedsectors + (fatoffset / bootbuffer.bytespersector) + partSectOff;
-	fatentoff = fatoffset % bootbuffer.bytespersector;
-
-	if(curFatSect != fatsectnum) {
-		/* Load two sectors at once for FAT12 */
-		readSector(fatsectnum, &fatSectBuffer[0]);
-		if (fattype==FAT12)
-			readSector(fatsectnum + 1, &fatSectBuffer[BytePerSector]);
-		curFatSect = fatsectnum;
-	}
+	uint8_t* entry = getFatEntry(fatoffset);
 
 	switch(fattype) {
 		case FAT12:
-			clustValue = var_read((uint16_t *)&fatSectBuffer[fatentoff]);
+			clustValue = var_read((uint16_t *)entry);
 			if(clustNum & 0x1) { //-V1051
 				clustValue >>= 4;
 			} else {
@@ -354,10 +401,10 @@ uint32_t fatDrive::getClusterValue(uint32_t clustNum) {
 			}
 			break;
 		case FAT16:
-			clustValue = var_read((uint16_t *)&fatSectBuffer[fatentoff]);
+			clustValue = var_read((uint16_t *)entry);
 			break;
 		case FAT32:
-			clustValue = var_read((uint32_t *)&fatSectBuffer[fatentoff]);
+			clustValue = var_read((uint32_t *)entry);
 			break;
 	}
 
@@ -383,18 +430,18 @@ void fatDrive::setClusterValue(uint32_t clustNum, uint32_t clustValue) {
 	fatsectnum = bootbuffer.reservedsectors + (fatoffset / bootbuffer.bytespersector) + partSectOff;
 	fatentoff = fatoffset % bootbuffer.bytespersector;
 
-	if(curFatSect != fatsectnum) {
-		/* Load two sectors at once for FAT12 */
-		readSector(fatsectnum, &fatSectBuffer[0]);
-		if (fattype==FAT12)
-			        readSector(fatsectnum + 1,
-			                   &fatSectBuffer[BytePerSector]);
-		curFatSect = fatsectnum;
-	}
+	/* Changing a link (unlike ending or extending a chain) invalidates
+	 * the chains cached by open files */
+	const uint32_t oldValue = getClusterValue(clustNum);
+	if (oldValue >= 2 && !isEndOfChain(oldValue) && oldValue != clustValue)
+		chainGeneration++;
+
+	uint8_t* entry = getFatEntry(fatoffset);
+	uint8_t* sectorData = entry - fatentoff;
 
 	switch(fattype) {
 		case FAT12: {
-			uint16_t tmpValue = var_read((uint16_t *)&fatSectBuffer[fatentoff]);
+			uint16_t tmpValue = var_read((uint16_t *)entry);
 			if(clustNum & 0x1) {
 				clustValue &= 0xfff;
 				clustValue <<= 4;
@@ -406,23 +453,23 @@ void fatDrive::setClusterValue(uint32_t clustNum, uint32_t clustValue) {
 				tmpValue &= 0xf000;
 				tmpValue |= (uint16_t)clustValue;
 			}
-			var_write((uint16_t *)&fatSectBuffer[fatentoff], tmpValue);
+			var_write((uint16_t *)entry, tmpValue);
 			break;
 			}
 		case FAT16:
-			var_write((uint16_t *)&fatSectBuffer[fatentoff], (uint16_t)clustValue);
+			var_write((uint16_t *)entry, (uint16_t)clustValue);
 			break;
 		case FAT32:
-			var_write((uint32_t *)&fatSectBuffer[fatentoff], clustValue);
+			var_write((uint32_t *)entry, clustValue);
 			break;
 	}
 	for(int fc=0;fc<bootbuffer.fatcopies;fc++) {
-		writeSector(fatsectnum + (fc * bootbuffer.sectorsperfat), &fatSectBuffer[0]);
+		writeSector(fatsectnum + (fc * bootbuffer.sectorsperfat), sectorData);
 		if (fattype==FAT12) {
-			if (fatentoff>=511)
+			if (fatentoff >= bootbuffer.bytespersector - 1u)
 				writeSector(fatsectnum + 1 +
 				                    (fc * bootbuffer.sectorsperfat),
-				            &fatSectBuffer[BytePerSector]);
+				            sectorData + bootbuffer.bytespersector);
 		}
 	}
 }
@@ -577,6 +624,8 @@ uint8_t fatDrive::writeSector(uint32_t sectnum, void * data) {
 		return 0;
 	}
 
+	updateFatCache(sectnum, data);
+
 	if (absolute) {
 		return loadedDisk->Write_AbsoluteSector(sectnum, data);
 	}
@@ -609,6 +658,39 @@ uint32_t fatDrive::getAbsoluteSectFromBytePos(uint32_t startClustNum, uint32_t b
 	return  getAbsoluteSectFromChain(startClustNum, bytePos / bootbuffer.bytespersector);
 }
 
+uint32_t fatDrive::getAbsoluteSectFromBytePos(uint32_t startClustNum, uint32_t bytePos,
+                                              FatClusterChain& chain) {
+	const uint32_t logicalSector = bytePos / bootbuffer.bytespersector;
+	const uint32_t clustIndex = logicalSector / bootbuffer.sectorspercluster;
+	const uint32_t sectClust = logicalSector % bootbuffer.sectorspercluster;
+
+	if (chain.clusters.empty() || chain.firstCluster != startClustNum ||
+	    chain.generation != chainGeneration) {
+		chain.firstCluster = startClustNum;
+		chain.generation = chainGeneration;
+		chain.clusters.assign(1, startClustNum);
+	}
+
+	/* No chain is longer than the number of clusters, unless broken */
+	if (clustIndex > CountOfClusters)
+		return 0;
+
+	/* Follow the chain on from the last cluster known */
+	while (chain.clusters.size() <= clustIndex) {
+		const uint32_t testvalue = getClusterValue(chain.clusters.back());
+		if (isEndOfChain(testvalue)) {
+			if (clustIndex == chain.clusters.size() && fattype == FAT12) {
+				LOG(LOG_DOSMISC,
+				    LOG_WARN)("End of cluster chain reached.");
+			}
+			return 0;
+		}
+		chain.clusters.push_back(testvalue);
+	}
+
+	return (getClustFirstSect(chain.clusters[clustIndex]) + sectClust);
+}
+
 uint32_t fatDrive::getAbsoluteSectFromChain(uint32_t startClustNum, uint32_t logicalSector) {
 	int32_t skipClust = logicalSector / bootbuffer.sectorspercluster;
 	uint32_t sectClust = logicalSector % bootbuffer.sectorspercluster;
@@ -779,8 +861,9 @@ fatDrive::fatDrive(const char* sysFilename, uint32_t bytesector,
           firstDataSector(0),
           firstRootDirSect(0),
           cwdDirCluster(0),
-          fatSectBuffer{0},
-          curFatSect(0)
+          fatCache(),
+          fatCachePageSectors(0),
+          chainGeneration(0)
 {
 	FILE *diskfile;
 	uint32_t filesize;
@@ -797,16 +880,21 @@ fatDrive::fatDrive(const char* sysFilename, uint32_t bytesector,
 	created_successfully = (diskfile != nullptr);
 	if (!created_successfully)
 		return;
-	const auto sz = stdio_size_kb(diskfile);
+	const auto sz = DISK_IMAGE_GetSize(diskfile);
 	if (sz < 0) {
 		fclose(diskfile);
+		created_successfully = false;
 		return;
 	}
-	filesize = check_cast<uint32_t>(sz);
+	filesize = check_cast<uint32_t>(sz / 1024);
 	is_hdd   = (filesize > 2880);
 
 	/* Load disk image */
 	loadedDisk = std::make_shared<imageDisk>(diskfile, sysFilename, filesize, is_hdd);
+	if (!loadedDisk->diskimg) {
+		created_successfully = false;
+		return;
+	}
 
 	if(is_hdd) {
 		/* Set user specified harddrive parameters */
@@ -1015,8 +1103,13 @@ fatDrive::fatDrive(const char* sysFilename, uint32_t bytesector,
 	/* There is no cluster 0, this means we are in the root directory */
 	cwdDirCluster = 0;
 
-	memset(fatSectBuffer,0,1024);
-	curFatSect = 0xffffffff;
+	/* FAT12 and FAT16 tables are small enough (up to 6 and 128 KB) to be
+	 * cached whole; FAT32 ones are cached in 32 KB pages */
+	constexpr uint32_t Fat32CachePageBytes = 32 * 1024;
+	if (fattype == FAT32)
+		fatCachePageSectors = std::max(Fat32CachePageBytes / bootbuffer.bytespersector, 1u);
+	else
+		fatCachePageSectors = std::max<uint32_t>(bootbuffer.sectorsperfat, 1);
 
 	type = DosDriveType::Fat;
 	safe_strcpy(info, sysFilename);
@@ -1076,6 +1169,14 @@ Bits fatDrive::UnMount()
 	return 0;
 }
 
+void fatDrive::EmptyCache()
+{
+	// Re-read the FAT, e.g. after RESCAN when the image was changed behind
+	// our back
+	fatCache.clear();
+	chainGeneration++;
+}
+
 uint8_t fatDrive::GetMediaByte(void) {
 	return mediaid;
 }
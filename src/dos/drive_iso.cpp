@@ -3,6 +3,7 @@
 
 #include "dos/drives.h"
 
+#include <algorithm>
 #include <cctype>
 #include <cstring>
 
@@ -384,18 +385,71 @@ Bits isoDrive::UnMount()
 	return MSCDEX_RemoveDrive(driveLetter) ? 0 : 2;
 }
 
+void isoDrive::ReadDirectory(const isoDirEntry& de, IsoDirectory& dir)
+{
+	// get start and end sector of the directory entry (pad end sector if necessary)
+	uint32_t currentSector = EXTENT_LOCATION(de);
+	uint32_t endSector = EXTENT_LOCATION(de) + DATA_LENGTH(de) / ISO_FRAMESIZE - 1;
+	if (DATA_LENGTH(de) % ISO_FRAMESIZE != 0)
+		endSector++;
+
+	uint32_t pos = 0;
+	uint8_t* buffer = nullptr;
+	if (!ReadCachedSector(&buffer, currentSector))
+		return;
+
+	for (;;) {
+		// check if the next sector has to be read
+		if ((pos >= ISO_FRAMESIZE)
+		 || (buffer[pos] == 0)
+		 || (pos + buffer[pos] > ISO_FRAMESIZE)) {
+
+			// check if there is another sector available
+			if (currentSector >= endSector)
+				return;
+			pos = 0;
+			currentSector++;
+			if (!ReadCachedSector(&buffer, currentSector))
+				return;
+		}
+		// a broken entry ends the directory, as it always did
+		isoDirEntry entry;
+		const int length = readDirEntry(&entry, &buffer[pos]);
+		if (length < 0)
+			return;
+		pos += static_cast<unsigned>(length);
+
+		const auto index = static_cast<uint32_t>(dir.entries.size());
+		dir.entries.push_back(entry);
+
+		// the name matching in lookup() was limited to this length
+		if (!IS_ASSOC((iso) ? entry.fileFlags : entry.timeZone)) {
+			std::string name(reinterpret_cast<const char*>(entry.ident));
+			name.resize(std::min(name.size(), size_t{ISO_MAX_FILENAME_LENGTH}));
+			upcase(name);
+			dir.byName.try_emplace(std::move(name), index);
+		}
+	}
+}
+
+const isoDrive::IsoDirectory& isoDrive::GetDirectory(const isoDirEntry& de)
+{
+	const auto [it, inserted] = directories.try_emplace(EXTENT_LOCATION(de));
+	if (inserted)
+		ReadDirectory(de, it->second);
+
+	return it->second;
+}
+
 int isoDrive::GetDirIterator(const isoDirEntry* de) {
 	int dirIterator = nextFreeDirIterator;
 
-	// get start and end sector of the directory entry (pad end sector if necessary)
-	dirIterators[dirIterator].currentSector = EXTENT_LOCATION(*de);
-	dirIterators[dirIterator].endSector =
-		EXTENT_LOCATION(*de) + DATA_LENGTH(*de) / ISO_FRAMESIZE - 1;
-	if (DATA_LENGTH(*de) % ISO_FRAMESIZE != 0)
-		dirIterators[dirIterator].endSector++;
+	// parse the directory up front, so searching it doesn't read sectors
+	GetDirectory(*de);
+	dirIterators[dirIterator].extent = EXTENT_LOCATION(*de);
 
 	// reset position and mark as valid
-	dirIterators[dirIterator].pos = 0;
+	dirIterators[dirIterator].index = 0;
 	dirIterators[dirIterator].valid = true;
 
 	// advance to next directory iterator (wrap around if necessary)
@@ -405,37 +459,16 @@ int isoDrive::GetDirIterator(const isoDirEntry* de) {
 }
 
 bool isoDrive::GetNextDirEntry(const int dirIteratorHandle, isoDirEntry* de) {
-	bool result = false;
-	uint8_t* buffer = nullptr;
 	DirIterator& dirIterator = dirIterators[dirIteratorHandle];
+	if (!dirIterator.valid)
+		return false;
 
-	// check if the directory entry is valid
-	if (dirIterator.valid && ReadCachedSector(&buffer, dirIterator.currentSector)) {
-		// check if the next sector has to be read
-		if ((dirIterator.pos >= ISO_FRAMESIZE)
-		 || (buffer[dirIterator.pos] == 0)
-		 || (dirIterator.pos + buffer[dirIterator.pos] > ISO_FRAMESIZE)) {
+	const auto dir = directories.find(dirIterator.extent);
+	if (dir == directories.end() || dirIterator.index >= dir->second.entries.size())
+		return false;
 
-			// check if there is another sector available
-		 	if (dirIterator.currentSector < dirIterator.endSector) {
-			 	dirIterator.pos = 0;
-			 	dirIterator.currentSector++;
-			 	if (!ReadCachedSector(&buffer, dirIterator.currentSector)) {
-			 		return false;
-			 	}
-		 	} else {
-		 		return false;
-		 	}
-		 }
-		 // read sector and advance sector pointer
-		 const int length = readDirEntry(de, &buffer[dirIterator.pos]);
-		 result = length >= 0;
-		 if (length >= 0)
-			 dirIterator.pos += static_cast<unsigned>(length);
-		 else // read failed, so step back to our prior iterator
-			 dirIterator.pos--;
-	}
-	return result;
+	*de = dir->second.entries[dirIterator.index++];
+	return true;
 }
 
 void isoDrive::FreeDirIterator(const int dirIterator) {
@@ -556,13 +589,16 @@ bool isoDrive :: lookup(isoDirEntry *de, const char *path) {
 			}
 
 			// look for the current path element
-			int dirIterator = GetDirIterator(de);
-			while (!found && GetNextDirEntry(dirIterator, de)) {
-				if (!IS_ASSOC(FLAGS2) && (0 == strncasecmp((char*) de->ident, name, ISO_MAX_FILENAME_LENGTH))) {
-					found = true;
-				}
+			std::string key(name);
+			key.resize(std::min(key.size(), size_t{ISO_MAX_FILENAME_LENGTH}));
+			upcase(key);
+
+			const auto& dir = GetDirectory(*de);
+			const auto it = dir.byName.find(key);
+			if (it != dir.byName.end()) {
+				*de = dir.entries[it->second];
+				found = true;
 			}
-			FreeDirIterator(dirIterator);
 		}
 		if (!found) return false;
 	}
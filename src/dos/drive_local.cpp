@@ -25,6 +25,14 @@
 #include "utils/fs_utils.h"
 #include "utils/string_utils.h"
 
+// Large enough to turn the typical 512-byte reads into few host reads,
+// small enough not to matter with many files open
+constexpr size_t ReadAheadSize = 32 * 1024;
+
+// Bumped whenever a file gets written or created, so read-ahead buffers of
+// other handles to the same file can't serve stale data
+static uint32_t file_write_generation = 0;
+
 bool localDrive::FileIsReadOnly(const char* name)
 {
 	FatAttributeFlags test_attr = {};
@@ -74,6 +82,9 @@ std::unique_ptr<DOS_File> localDrive::FileCreate(const char* name,
 
 	if (!file_exists) {
 		dirCache.AddEntry(newname, true);
+	} else {
+		// Creating an existing file truncates it
+		++file_write_generation;
 	}
 
 	const DosDateTime dos_time = {
@@ -590,11 +601,20 @@ bool localFile::Read(uint8_t* data, uint16_t* num_bytes)
 		                                   local_drive.lock()->GetMediaByte()));
 	}
 
-	const auto ret = read_native_file(file_handle, data, *num_bytes);
-	*num_bytes     = check_cast<uint16_t>(ret.num_bytes);
-	if (ret.error) {
-		DOS_SetError(DOSERR_ACCESS_DENIED);
-		return false;
+	if (UseReadAhead()) {
+		if (!ReadFromReadAhead(data, num_bytes)) {
+			DOS_SetError(DOSERR_ACCESS_DENIED);
+			return false;
+		}
+	} else {
+		StopReadAhead();
+
+		const auto ret = read_native_file(file_handle, data, *num_bytes);
+		*num_bytes     = check_cast<uint16_t>(ret.num_bytes);
+		if (ret.error) {
+			DOS_SetError(DOSERR_ACCESS_DENIED);
+			return false;
+		}
 	}
 
 	/* Fake harddrive motion. Inspector Gadget with Sound Blaster compatible */
@@ -608,6 +628,92 @@ bool localFile::Read(uint8_t* data, uint16_t* num_bytes)
 	return true;
 }
 
+bool localFile::UseReadAhead() const
+{
+	const auto access_mode = flags & 0xf;
+	return DOS_IsFileReadAhead() &&
+	       (access_mode == OPEN_READ || access_mode == OPEN_READ_NO_MOD);
+}
+
+bool localFile::ReadFromReadAhead(uint8_t* data, uint16_t* num_bytes)
+{
+	if (!is_reading_ahead) {
+		native_position = get_native_file_position(file_handle);
+		if (native_position == NativeSeekFailed) {
+			return false;
+		}
+		position         = check_cast<uint32_t>(native_position);
+		is_reading_ahead = true;
+		read_ahead.clear();
+	}
+
+	// The file was written through another handle
+	if (read_ahead_generation != file_write_generation) {
+		read_ahead_generation = file_write_generation;
+		read_ahead.clear();
+	}
+
+	const uint16_t requested = *num_bytes;
+	uint16_t copied          = 0;
+
+	while (copied < requested) {
+		const auto offset = static_cast<size_t>(position - read_ahead_start);
+
+		if (position >= read_ahead_start && offset < read_ahead.size()) {
+			const auto chunk = std::min(static_cast<size_t>(requested - copied),
+			                            read_ahead.size() - offset);
+			memcpy(data + copied, read_ahead.data() + offset, chunk);
+			copied += check_cast<uint16_t>(chunk);
+			position += check_cast<uint32_t>(chunk);
+			continue;
+		}
+
+		// Refill the buffer from the current position
+		if (native_position != position) {
+			native_position = seek_native_file(file_handle,
+			                                   position,
+			                                   NativeSeek::Set);
+			if (native_position == NativeSeekFailed) {
+				read_ahead.clear();
+				return false;
+			}
+		}
+		read_ahead.resize(ReadAheadSize);
+		const auto ret = read_native_file(file_handle,
+		                                  read_ahead.data(),
+		                                  ReadAheadSize);
+		if (ret.error) {
+			read_ahead.clear();
+			return false;
+		}
+		read_ahead.resize(check_cast<size_t>(ret.num_bytes));
+		read_ahead_start = position;
+		native_position += ret.num_bytes;
+
+		if (ret.num_bytes == 0) {
+			// End of file
+			break;
+		}
+	}
+
+	*num_bytes = copied;
+	return true;
+}
+
+void localFile::StopReadAhead()
+{
+	if (!is_reading_ahead) {
+		return;
+	}
+	// Put the host file position back to where DOS thinks it is
+	if (native_position != position) {
+		seek_native_file(file_handle, position, NativeSeek::Set);
+	}
+	read_ahead.clear();
+	read_ahead.shrink_to_fit();
+	is_reading_ahead = false;
+}
+
 bool localFile::Write(uint8_t* data, uint16_t* num_bytes)
 {
 	assert(file_handle != InvalidNativeFileHandle);
@@ -622,6 +728,9 @@ bool localFile::Write(uint8_t* data, uint16_t* num_bytes)
 
 	set_archive_on_close = true;
 
+	StopReadAhead();
+	++file_write_generation;
+
 	// Truncate the file
 	if (*num_bytes == 0) {
 		if (!truncate_native_file(file_handle)) {
@@ -653,6 +762,45 @@ bool localFile::Write(uint8_t* data, uint16_t* num_bytes)
 	return true;
 }
 
+bool localFile::CopyTo(localFile& dest)
+{
+	assert(file_handle != InvalidNativeFileHandle);
+	assert(dest.file_handle != InvalidNativeFileHandle);
+
+	const auto source_mode = flags & 0xf;
+	const auto dest_mode   = dest.flags & 0xf;
+	if (source_mode == OPEN_WRITE || dest_mode == OPEN_READ ||
+	    dest_mode == OPEN_READ_NO_MOD) {
+		DOS_SetError(DOSERR_ACCESS_DENIED);
+		return false;
+	}
+	assert(!dest.IsOnReadOnlyMedium());
+
+	if (!dest.PrepareForWrite()) {
+		return false;
+	}
+	StopReadAhead();
+	dest.StopReadAhead();
+	++file_write_generation;
+	dest.set_archive_on_close = true;
+
+	const auto source_start = get_native_file_position(file_handle);
+	if (source_start == NativeSeekFailed) {
+		DOS_SetError(DOSERR_ACCESS_DENIED);
+		return false;
+	}
+
+	const auto ret = copy_native_file(file_handle, dest.file_handle);
+	if (ret.error) {
+		// The source might have been read further than the
+		// destination was written
+		seek_native_file(file_handle, source_start + ret.num_bytes, NativeSeek::Set);
+		DOS_SetError(DOSERR_ACCESS_DENIED);
+		return false;
+	}
+	return true;
+}
+
 bool localFile::Seek(uint32_t *pos_addr, uint32_t type)
 {
 	assert(file_handle != InvalidNativeFileHandle);
@@ -663,6 +811,24 @@ bool localFile::Seek(uint32_t *pos_addr, uint32_t type)
 	// Example: WinG installer for Windows 3.1
 	// Wrapping a 32-bit signed is technically undefined in C
 	// So just leave it unsigned and the math works out to be the same
+	// Positions within the file are tracked here while reading ahead; only
+	// seeking relative to the end needs the host
+	if (is_reading_ahead && type != DOS_SEEK_END) {
+		if (type == DOS_SEEK_SET) {
+			position = *pos_addr;
+		} else if (type == DOS_SEEK_CUR) {
+			position += *pos_addr;
+		} else {
+			// DOS_SeekFile() should have already thrown this error
+			assertm(false, "Invalid seek type");
+			DOS_SetError(DOSERR_FUNCTION_NUMBER_INVALID);
+			return false;
+		}
+		*pos_addr = position;
+		return true;
+	}
+	StopReadAhead();
+
 	uint32_t seek_to = 0;
 	switch (type) {
 		case DOS_SEEK_SET: {
@@ -23,6 +23,18 @@ public:
 	void Close() override;
 	uint16_t GetInformation() override;
 	bool IsOnReadOnlyMedium() const override { return read_only_medium; }
+
+	// Copies the rest of this file from its position to the position of
+	// 'dest' on the host. On failure, both positions are left after the
+	// bytes that have been copied.
+	bool CopyTo(localFile& dest);
+
+	// Called before the file is written to; the overlay drive moves the
+	// file to the overlay directory here
+	virtual bool PrepareForWrite()
+	{
+		return true;
+	}
 	const char* GetBaseDir() const
 	{
 		return basedir;
@@ -36,11 +48,24 @@ public:
 
 private:
 	void MaybeFlushTime();
+	bool UseReadAhead() const;
+	bool ReadFromReadAhead(uint8_t* data, uint16_t* num_bytes);
+	void StopReadAhead();
+
 	const std_fs::path path = {};
 	const char* basedir     = nullptr;
 
 	const bool read_only_medium = false;
 	bool set_archive_on_close   = false;
+
+	// Read-ahead for files opened read-only. While it is active, the host
+	// file position runs ahead of the DOS one ('position').
+	std::vector<uint8_t> read_ahead = {};
+	uint32_t read_ahead_start       = 0;
+	uint32_t read_ahead_generation  = 0;
+	uint32_t position               = 0;
+	int64_t native_position         = 0;
+	bool is_reading_ahead           = false;
 };
 
 #endif // DOSBOX_DRIVE_LOCAL_H
@@ -6,11 +6,13 @@
 
 #include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <fstream>
 #include <string>
 #include <vector>
 
@@ -25,6 +27,12 @@
 #define OVERLAY_DIR 1
 bool logoverlay = false;
 
+// Listings of the overlay directories, kept in the overlay between sessions
+// so mounting doesn't have to read the directories that haven't changed.
+// The name isn't a valid DOS name, so it can't clash with a DOS file.
+constexpr auto OverlayIndexFilename = "DBOVERLAY.IDX";
+constexpr auto OverlayIndexHeader   = "DOSBox overlay index 1";
+
 #if defined (WIN32)
 #define CROSS_DOSFILENAME(blah)
 #else
@@ -216,13 +224,20 @@ public:
 	}
 
 	bool Write(uint8_t* data, uint16_t* size) override
+	{
+		if (!overlay_active && *data == 0 && logoverlay) {
+			LOG_MSG("OPTIMISE: truncate on switch!!!!");
+		}
+		if (!PrepareForWrite()) {
+			return false;
+		}
+		return localFile::Write(data,size);
+	}
+	bool PrepareForWrite() override
 	{
 		uint8_t f = flags & 0xf;
 		if (!overlay_active && (f == OPEN_READWRITE || f == OPEN_WRITE)) {
 			if (logoverlay) LOG_MSG("write detected, switching file for %s",GetName());
-			if (*data == 0) {
-				if (logoverlay) LOG_MSG("OPTIMISE: truncate on switch!!!!");
-			}
 			const auto a = logoverlay ? GetTicks() : 0;
 			bool r = create_copy();
 			const auto b = logoverlay ? GetTicksSince(a) : 0;
@@ -233,7 +248,7 @@ public:
 			overlay_active = true;
 			
 		}
-		return localFile::Write(data,size);
+		return true;
 	}
 	bool create_copy();
 //private:
@@ -641,6 +656,123 @@ bool Overlay_Drive::Sync_leading_dirs(const char* dos_filename){
 
 	return true;
 }
+// Lists an overlay directory (given relative to the overlay, with a trailing
+// separator) and records the listing in the new index. The listing of the
+// last session is reused if the directory's modification time still matches.
+bool Overlay_Drive::list_overlay_dir(const std::string& rel_dir,
+                                     OverlayIndex& new_index,
+                                     std::vector<OverlayIndexEntry>& entries,
+                                     bool& has_index_changed)
+{
+	entries.clear();
+
+	const std::string dir = std::string(overlaydir) + rel_dir;
+
+	// Take the time stamp before reading, so a change made while reading
+	// makes the recorded listing stale rather than wrong
+	const auto now     = std_fs::file_time_type::clock::now();
+	std::error_code ec = {};
+	const auto modified = std_fs::last_write_time(dir, ec);
+	const auto stamp    = ec ? 0 : modified.time_since_epoch().count();
+
+	const auto it = overlay_index.find(rel_dir);
+	if (!ec && it != overlay_index.end() && it->second.modified == stamp) {
+		entries = it->second.entries;
+		new_index.emplace(rel_dir, std::move(it->second));
+		return true;
+	}
+	has_index_changed = true;
+
+	DirInformation* dirp = open_directory(dir.c_str());
+	if (dirp == nullptr) {
+		return false;
+	}
+	char dir_name[CROSS_LEN];
+	bool is_directory;
+	if (read_directory_first(dirp, dir_name, is_directory)) {
+		do {
+			entries.push_back({dir_name, is_directory});
+		} while (read_directory_next(dirp, dir_name, is_directory));
+	}
+	close_directory(dirp);
+
+	// Time stamps can be coarse, so a change made right after this one
+	// might not show. Such directories are read again next time.
+	constexpr auto RecentlyModified = std::chrono::seconds(3);
+	if (!ec && modified < now - RecentlyModified) {
+		new_index.emplace(rel_dir, OverlayIndexDir{stamp, entries});
+	}
+	return true;
+}
+
+void Overlay_Drive::read_overlay_index()
+{
+	overlay_index.clear();
+
+	std::ifstream file(std::string(overlaydir) + OverlayIndexFilename);
+	std::string line = {};
+	if (!std::getline(file, line) || line != OverlayIndexHeader) {
+		return;
+	}
+
+	OverlayIndex index   = {};
+	OverlayIndexDir* dir = nullptr;
+	bool is_complete     = false;
+	while (std::getline(file, line)) {
+		if (line == "END") {
+			is_complete = true;
+			break;
+		}
+		if (line.length() < 2 || line[1] != ' ') {
+			break;
+		}
+		if (line[0] == 'D') {
+			// D <time stamp> <directory>
+			const auto separator = line.find(' ', 2);
+			if (separator == std::string::npos) {
+				break;
+			}
+			const auto field = line.substr(2, separator - 2);
+			char* field_end  = nullptr;
+			const auto stamp = strtoll(field.c_str(), &field_end, 10);
+			if (field.empty() || *field_end != '\0') {
+				break;
+			}
+			dir = &index[line.substr(separator + 1)];
+			dir->modified = stamp;
+		} else if (line[0] == 'E' && dir && line.length() > 4) {
+			// E <d|f> <name>
+			dir->entries.push_back({line.substr(4), line[2] == 'd'});
+		} else {
+			break;
+		}
+	}
+	// A partly written index is ignored
+	if (is_complete) {
+		overlay_index = std::move(index);
+	}
+}
+
+void Overlay_Drive::write_overlay_index() const
+{
+	// Overwrite the index in place, so its directory isn't modified after
+	// the first time
+	std::ofstream file(std::string(overlaydir) + OverlayIndexFilename,
+	                   std::ios::trunc);
+	if (!file) {
+		return;
+	}
+	file << OverlayIndexHeader << '\n';
+	for (const auto& [rel_dir, dir] : overlay_index) {
+		file << "D " << dir.modified << ' ' << rel_dir << '\n';
+		for (const auto& entry : dir.entries) {
+			file << "E " << (entry.is_directory ? 'd' : 'f') << ' '
+			     << entry.name << '\n';
+		}
+	}
+	file << "END\n";
+}
+
 void Overlay_Drive::update_cache(bool read_directory_contents) {
 	const auto a = logoverlay ? GetTicks() : 0;
 	std::vector<std::string> specials;
@@ -678,33 +810,32 @@ void Overlay_Drive::update_cache(bool read_directory_contents) {
 	std::vector<std::string>::iterator i;
 	std::string::size_type const prefix_lengh = special_prefix.length();
 	if (read_directory_contents) {
-		DirInformation* dirp = open_directory(overlaydir);
-		if (dirp == nullptr) return;
-		// Read complete directory
-		char dir_name[CROSS_LEN];
-		bool is_directory;
-		if (read_directory_first(dirp, dir_name, is_directory)) {
-			if ((safe_strlen(dir_name) > prefix_lengh+5) &&
-			    strncmp(dir_name, special_prefix.c_str(), prefix_lengh) == 0) {
-				specials.emplace_back(dir_name);
-			} else if (is_directory) {
-				dirnames.emplace_back(dir_name);
-			} else {
-				filenames.emplace_back(dir_name);
+		// Directories that haven't changed since the last session
+		// are taken from the index instead of being read again
+		if (!is_index_loaded) {
+			read_overlay_index();
+			is_index_loaded = true;
+		}
+		OverlayIndex new_index = {};
+		bool has_index_changed = false;
+
+		std::vector<OverlayIndexEntry> entries = {};
+		if (!list_overlay_dir("", new_index, entries, has_index_changed)) {
+			return;
+		}
+		for (const auto& entry : entries) {
+			if (entry.name == OverlayIndexFilename) {
+				continue;
 			}
-			while (read_directory_next(dirp, dir_name, is_directory)) {
-				if ((safe_strlen(dir_name) > prefix_lengh+5) &&
-				    strncmp(dir_name,special_prefix.c_str(),prefix_lengh) == 0) {
-					specials.emplace_back(dir_name);
-				} else if (is_directory) {
-					dirnames.emplace_back(dir_name);
-				} else {
-					filenames.emplace_back(dir_name);
-				}
+			if ((entry.name.length() > prefix_lengh + 5) &&
+			    entry.name.compare(0, prefix_lengh, special_prefix) == 0) {
+				specials.emplace_back(entry.name);
+			} else if (entry.is_directory) {
+				dirnames.emplace_back(entry.name);
+			} else {
+				filenames.emplace_back(entry.name);
 			}
 		}
-		close_directory(dirp);
-		dirp = nullptr;
 
 		// parse directories to add them.
 		for (i = dirnames.begin(); i != dirnames.end(); ++i) {
@@ -723,17 +854,14 @@ void Overlay_Drive::update_cache(bool read_directory_contents) {
 			bool dir_exists_in_base = localDrive::TestDir(tdir);
 #endif
 
-			char dir[CROSS_LEN];
-			safe_strcpy(dir, overlaydir);
-			safe_strcat(dir, (*i).c_str());
 			char dirpush[CROSS_LEN];
 			safe_strcpy(dirpush, (*i).c_str());
 			static char end[2] = {CROSS_FILESPLIT,0};
 			safe_strcat(dirpush, end); // Linux ?
 
-			assert(dirp == nullptr);
-			dirp = open_directory(dir);
-			if (dirp == nullptr) continue;
+			if (!list_overlay_dir(dirpush, new_index, entries, has_index_changed)) {
+				continue;
+			}
 
 #if OVERLAY_DIR
 			//Good directory, add to DOSdirs_cache if not existing in localDrive. tested earlier to prevent problems with opendir
@@ -742,30 +870,16 @@ void Overlay_Drive::update_cache(bool read_directory_contents) {
 
 			std::string backupi(*i);
 
-			auto maybe_add_path = [&]() {
-				if ((safe_strlen(dir_name) > prefix_lengh + 5) &&
-				    strncmp(dir_name,
-				            special_prefix.c_str(),
-				            prefix_lengh) == 0) {
-					specials.emplace_back(
-					        std::string(dirpush) + dir_name);
-				} else if (is_directory) {
-					dirnames.emplace_back(
-					        std::string(dirpush) + dir_name);
+			for (const auto& entry : entries) {
+				if ((entry.name.length() > prefix_lengh + 5) &&
+				    entry.name.compare(0, prefix_lengh, special_prefix) == 0) {
+					specials.emplace_back(std::string(dirpush) + entry.name);
+				} else if (entry.is_directory) {
+					dirnames.emplace_back(std::string(dirpush) + entry.name);
 				} else {
-					filenames.emplace_back(
-					        std::string(dirpush) + dir_name);
-				}
-			};
-			// Read complete directory
-			if (read_directory_first(dirp, dir_name, is_directory)) {
-				maybe_add_path();
-				while (read_directory_next(dirp, dir_name, is_directory)) {
-					maybe_add_path();
+					filenames.emplace_back(std::string(dirpush) + entry.name);
 				}
 			}
-			close_directory(dirp);
-			dirp = nullptr;
 
 			// find current directory again, for the next round. But
 			// if it's not there, then bail out before the next
@@ -774,6 +888,13 @@ void Overlay_Drive::update_cache(bool read_directory_contents) {
 			if (i == dirnames.end())
 				break;
 		}
+
+		// Directories that are gone also change the index
+		has_index_changed |= new_index.size() != overlay_index.size();
+		overlay_index = std::move(new_index);
+		if (has_index_changed) {
+			write_overlay_index();
+		}
 	}
 
 
@@ -0,0 +1,820 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dos/drives.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <list>
+
+#include <zlib.h>
+
+#include "dos/dos_system.h"
+#include "misc/cross.h"
+#include "misc/logging.h"
+#include "utils/mem_host.h"
+#include "utils/string_utils.h"
+
+// ZIP format constants, see PKWARE's APPNOTE.TXT
+constexpr uint32_t EndOfCentralDirSignature = 0x06054b50;
+constexpr uint32_t CentralDirSignature      = 0x02014b50;
+constexpr uint32_t LocalHeaderSignature     = 0x04034b50;
+
+constexpr size_t EndOfCentralDirSize = 22;
+constexpr size_t CentralDirEntrySize = 46;
+constexpr size_t LocalHeaderSize     = 30;
+constexpr size_t MaxCommentSize      = UINT16_MAX;
+
+constexpr uint16_t MethodStored   = 0;
+constexpr uint16_t MethodDeflated = 8;
+
+constexpr uint16_t FlagEncrypted = 1 << 0;
+
+// The sizes and offsets of ZIP64 archives are in extra fields
+constexpr uint32_t Zip64Marker = UINT32_MAX;
+
+// Host system of the "version made by" field whose external attributes are
+// the DOS ones
+constexpr uint8_t HostMsDos = 0;
+
+// Inflated files of all the mounted archives are kept up to this size in
+// total. Open files hold on to their data even after it's dropped.
+constexpr size_t MaxCachedBytes = 64 * 1024 * 1024;
+
+// Compressed files are inflated in one go, so larger ones are refused rather
+// than trusting the size in the central directory
+constexpr uint32_t MaxInflatedBytes = 256 * 1024 * 1024;
+
+// Deflate can't expand data by more than about 1032:1; entries claiming more
+// are damaged or crafted
+constexpr uint64_t MaxDeflateRatio = 1032;
+
+class InflatedFileCache {
+public:
+	using data_t = std::shared_ptr<const std::vector<uint8_t>>;
+
+	data_t Get(const uint64_t key)
+	{
+		const auto it = index.find(key);
+		if (it == index.end()) {
+			return nullptr;
+		}
+		items.splice(items.begin(), items, it->second);
+		return it->second->data;
+	}
+
+	void Add(const uint64_t key, data_t data)
+	{
+		if (data->size() > MaxCachedBytes || index.count(key)) {
+			return;
+		}
+		total_bytes += data->size();
+		items.push_front({key, std::move(data)});
+		index[key] = items.begin();
+
+		while (total_bytes > MaxCachedBytes) {
+			Remove(std::prev(items.end()));
+		}
+	}
+
+	void RemoveArchive(const uint32_t archive_id)
+	{
+		for (auto it = items.begin(); it != items.end();) {
+			const auto next = std::next(it);
+			if ((it->key >> 32) == archive_id) {
+				Remove(it);
+			}
+			it = next;
+		}
+	}
+
+private:
+	struct Item {
+		uint64_t key = 0;
+		data_t data  = {};
+	};
+
+	void Remove(std::list<Item>::iterator it)
+	{
+		total_bytes -= it->data->size();
+		index.erase(it->key);
+		items.erase(it);
+	}
+
+	// Most recently used first
+	std::list<Item> items = {};
+	std::unordered_map<uint64_t, std::list<Item>::iterator> index = {};
+
+	size_t total_bytes = 0;
+};
+
+static InflatedFileCache inflated_files = {};
+
+static uint64_t cache_key(const uint32_t archive_id, const uint32_t entry_index)
+{
+	return (static_cast<uint64_t>(archive_id) << 32) | entry_index;
+}
+
+class zipFile final : public DOS_File {
+public:
+	zipFile(std::shared_ptr<zipDrive> drive, const char* name,
+	        uint32_t entry_index, uint32_t data_offset);
+	zipFile(const zipFile&)            = delete; // prevent copying
+	zipFile& operator=(const zipFile&) = delete; // prevent assignment
+
+	bool Read(uint8_t* data, uint16_t* size) override;
+	bool Write(uint8_t* data, uint16_t* size) override;
+	bool Seek(uint32_t* pos, uint32_t type) override;
+	void Close() override;
+	uint16_t GetInformation() override;
+	bool IsOnReadOnlyMedium() const override;
+
+private:
+	std::shared_ptr<zipDrive> drive = nullptr;
+
+	uint32_t entry_index = 0;
+	uint32_t data_offset = 0;
+	uint32_t file_size   = 0;
+	uint32_t file_pos    = 0;
+
+	// Set on the first read of a deflated file
+	std::shared_ptr<const std::vector<uint8_t>> inflated = {};
+};
+
+zipFile::zipFile(std::shared_ptr<zipDrive> zip_drive, const char* name,
+                 const uint32_t index, const uint32_t offset)
+        : drive(std::move(zip_drive)),
+          entry_index(index),
+          data_offset(offset)
+{
+	SetName(name);
+
+	const auto& entry = drive->GetEntry(entry_index);
+
+	file_size = entry.size;
+	time      = entry.time;
+	date      = entry.date;
+	attr      = entry.attr;
+}
+
+bool zipFile::Read(uint8_t* data, uint16_t* size)
+{
+	const auto num_bytes = std::min<uint32_t>(*size, file_size - file_pos);
+	if (num_bytes == 0) {
+		*size = 0;
+		return true;
+	}
+
+	if (drive->GetEntry(entry_index).method == MethodStored) {
+		*size = static_cast<uint16_t>(
+		        drive->ReadArchive(data_offset + file_pos, data, num_bytes));
+	} else {
+		if (!inflated) {
+			inflated = drive->GetInflated(entry_index, data_offset);
+		}
+		if (!inflated) {
+			DOS_SetError(DOSERR_ACCESS_DENIED);
+			return false;
+		}
+		std::memcpy(data, inflated->data() + file_pos, num_bytes);
+		*size = static_cast<uint16_t>(num_bytes);
+	}
+
+	file_pos += *size;
+	return true;
+}
+
+bool zipFile::Write(uint8_t* /*data*/, uint16_t* /*size*/)
+{
+	return false;
+}
+
+bool zipFile::Seek(uint32_t* pos, uint32_t type)
+{
+	int64_t new_pos = static_cast<int32_t>(*pos);
+	switch (type) {
+	case DOS_SEEK_SET: new_pos = *pos; break;
+	case DOS_SEEK_CUR: new_pos += file_pos; break;
+	case DOS_SEEK_END: new_pos += file_size; break;
+	default: return false;
+	}
+	if (new_pos < 0 || new_pos > file_size) {
+		new_pos = file_size;
+	}
+
+	file_pos = static_cast<uint32_t>(new_pos);
+	*pos     = file_pos;
+	return true;
+}
+
+void zipFile::Close() {}
+
+uint16_t zipFile::GetInformation()
+{
+	return 0x40; // read-only drive
+}
+
+bool zipFile::IsOnReadOnlyMedium() const
+{
+	return true;
+}
+
+zipDrive::zipDrive(const char* archive_path, const uint8_t media_id, int& error)
+        : mediaid(media_id)
+{
+	static uint32_t last_archive_id = 0;
+	archive_id = ++last_archive_id;
+
+	type = DosDriveType::Zip;
+
+	// The root directory
+	entries.emplace_back();
+	entries[0].attr.directory = true;
+	entries[0].directory      = 0;
+	directories.emplace_back();
+
+	safe_strcpy(info, archive_path);
+
+	archive = make_fopen(archive_path, "rb");
+	if (!archive) {
+		error = 1;
+		return;
+	}
+	if (!LoadCentralDirectory()) {
+		error = 6;
+		return;
+	}
+
+	const auto stem = std_fs::path(archive_path).stem().string();
+	Set_Label(stem.c_str(), label, false);
+
+	error = 0;
+}
+
+zipDrive::~zipDrive()
+{
+	inflated_files.RemoveArchive(archive_id);
+}
+
+void zipDrive::SetLabel(const char* new_label)
+{
+	Set_Label(new_label, label, false);
+}
+
+bool zipDrive::LoadCentralDirectory()
+{
+	const auto archive_size = stdio_size_bytes(archive.get());
+	if (archive_size < static_cast<int64_t>(EndOfCentralDirSize)) {
+		return false;
+	}
+
+	// The end of central directory record is followed by a comment of up
+	// to 64 KiB, so search for its signature backwards
+	const auto tail_size = static_cast<size_t>(
+	        std::min<int64_t>(archive_size, EndOfCentralDirSize + MaxCommentSize));
+
+	std::vector<uint8_t> tail(tail_size);
+	const auto tail_offset = archive_size - static_cast<int64_t>(tail_size);
+	if (cross_fseeko(archive.get(), tail_offset, SEEK_SET) != 0 ||
+	    fread(tail.data(), 1, tail_size, archive.get()) != tail_size) {
+		return false;
+	}
+
+	const uint8_t* eocd = nullptr;
+	for (auto pos = tail_size - EndOfCentralDirSize + 1; pos-- > 0;) {
+		if (host_readd(&tail[pos]) == EndOfCentralDirSignature) {
+			eocd = &tail[pos];
+			break;
+		}
+	}
+	if (!eocd) {
+		LOG_WARNING("ZIP: '%s' is not a ZIP archive", info);
+		return false;
+	}
+
+	const auto num_entries = host_readw(eocd + 10);
+	const auto dir_size    = host_readd(eocd + 12);
+	const auto dir_offset  = host_readd(eocd + 16);
+
+	if (dir_offset == Zip64Marker || num_entries == UINT16_MAX) {
+		LOG_WARNING("ZIP: ZIP64 archives are not supported");
+		return false;
+	}
+	if (static_cast<int64_t>(dir_offset) + dir_size > archive_size) {
+		return false;
+	}
+
+	std::vector<uint8_t> central_dir(dir_size);
+	if (cross_fseeko(archive.get(), dir_offset, SEEK_SET) != 0 ||
+	    fread(central_dir.data(), 1, dir_size, archive.get()) != dir_size) {
+		return false;
+	}
+
+	size_t pos = 0;
+	for (uint16_t i = 0; i < num_entries; ++i) {
+		if (pos + CentralDirEntrySize > central_dir.size()) {
+			return false;
+		}
+		const auto record = &central_dir[pos];
+		if (host_readd(record) != CentralDirSignature) {
+			return false;
+		}
+
+		const auto name_length    = host_readw(record + 28);
+		const auto extra_length   = host_readw(record + 30);
+		const auto comment_length = host_readw(record + 32);
+
+		const auto name_pos = pos + CentralDirEntrySize;
+		if (name_pos + name_length > central_dir.size()) {
+			return false;
+		}
+		const std::string zip_path(reinterpret_cast<const char*>(
+		                                   &central_dir[name_pos]),
+		                           name_length);
+
+		pos = name_pos + name_length + extra_length + comment_length;
+
+		Entry entry = {};
+
+		const auto flags      = host_readw(record + 8);
+		entry.method          = host_readw(record + 10);
+		entry.time            = host_readw(record + 12);
+		entry.date            = host_readw(record + 14);
+		entry.crc             = host_readd(record + 16);
+		entry.compressed_size = host_readd(record + 20);
+		entry.size            = host_readd(record + 24);
+		entry.header_offset   = host_readd(record + 42);
+
+		if (entry.size == Zip64Marker || entry.compressed_size == Zip64Marker ||
+		    entry.header_offset == Zip64Marker) {
+			LOG_WARNING("ZIP: ZIP64 archives are not supported");
+			return false;
+		}
+
+		const auto made_by_host = static_cast<uint8_t>(host_readw(record + 4) >> 8);
+		if (made_by_host == HostMsDos) {
+			const auto dos_attr = static_cast<uint8_t>(host_readd(record + 38));
+			entry.attr.read_only = dos_attr & 0x01;
+			entry.attr.hidden    = dos_attr & 0x02;
+			entry.attr.system    = dos_attr & 0x04;
+			entry.attr.archive   = dos_attr & 0x20;
+		}
+		entry.attr.directory = !zip_path.empty() && zip_path.back() == '/';
+
+		if (!entry.attr.directory) {
+			if (flags & FlagEncrypted) {
+				LOG_WARNING("ZIP: Skipping encrypted file '%s'",
+				            zip_path.c_str());
+				continue;
+			}
+			if (entry.method != MethodStored && entry.method != MethodDeflated) {
+				LOG_WARNING("ZIP: Skipping '%s', its compression method %u is not supported",
+				            zip_path.c_str(),
+				            entry.method);
+				continue;
+			}
+		}
+
+		if (!AddEntry(zip_path, entry)) {
+			LOG_WARNING("ZIP: Skipping '%s', its path is not valid",
+			            zip_path.c_str());
+		}
+	}
+	return true;
+}
+
+std::string zipDrive::MakeDosName(const Directory& dir,
+                                  const std::string& host_name) const
+{
+	auto name = upcase(host_name);
+	if (!filename_not_8x3(name.c_str()) && !dir.by_name.count(name)) {
+		return name;
+	}
+	for (unsigned int num = 1;; ++num) {
+		name = generate_8x3(host_name.c_str(), num, true);
+		if (name.empty() || !dir.by_name.count(name)) {
+			return name;
+		}
+	}
+}
+
+uint32_t zipDrive::AddToDirectory(const int32_t dir_index,
+                                  const std::string& host_name, Entry entry)
+{
+	entry.name = MakeDosName(directories[dir_index], host_name);
+
+	const auto entry_index = static_cast<uint32_t>(entries.size());
+	if (entry.attr.directory) {
+		entry.directory = static_cast<int32_t>(directories.size());
+		directories.emplace_back();
+	}
+
+	auto& dir = directories[dir_index];
+	dir.entries.push_back(entry_index);
+	dir.by_name[entry.name]     = entry_index;
+	dir.by_host_name[host_name] = entry_index;
+
+	entries.push_back(std::move(entry));
+	return entry_index;
+}
+
+bool zipDrive::AddEntry(const std::string& zip_path, Entry entry)
+{
+	// Split the path, which always uses forward slashes
+	std::vector<std::string> names = {};
+	for (const auto& name : split(zip_path, "/")) {
+		if (name == ".") {
+			continue;
+		}
+		if (name == "..") {
+			return false;
+		}
+		names.push_back(name);
+	}
+	if (names.empty()) {
+		return false;
+	}
+
+	int32_t dir_index = 0;
+	for (size_t i = 0; i < names.size(); ++i) {
+		const auto is_last = (i == names.size() - 1);
+		const auto& dir    = directories[dir_index];
+
+		const auto it = dir.by_host_name.find(names[i]);
+		if (it != dir.by_host_name.end()) {
+			auto& existing = entries[it->second];
+			if (!existing.attr.directory) {
+				// A file of the same name, keep the first one
+				return false;
+			}
+			if (is_last && entry.attr.directory) {
+				// The directory has been added for an earlier
+				// path, now we know its details
+				existing.date = entry.date;
+				existing.time = entry.time;
+				existing.attr = entry.attr;
+				return true;
+			}
+			if (is_last) {
+				return false;
+			}
+			dir_index = existing.directory;
+			continue;
+		}
+
+		if (is_last) {
+			AddToDirectory(dir_index, names[i], entry);
+			return true;
+		}
+
+		// A directory without an entry of its own in the archive
+		Entry implied          = {};
+		implied.date           = entry.date;
+		implied.time           = entry.time;
+		implied.attr.directory = true;
+
+		const auto implied_index = AddToDirectory(dir_index, names[i], implied);
+		dir_index = entries[implied_index].directory;
+	}
+	return true;
+}
+
+const zipDrive::Entry* zipDrive::Lookup(const char* path) const
+{
+	const Entry* entry = &entries[0];
+
+	for (const auto& name : split(path, "\\")) {
+		if (!entry->attr.directory) {
+			return nullptr;
+		}
+		const auto& dir = directories[entry->directory];
+
+		const auto it = dir.by_name.find(upcase(name));
+		if (it == dir.by_name.end()) {
+			return nullptr;
+		}
+		entry = &entries[it->second];
+	}
+	return entry;
+}
+
+std::optional<uint32_t> zipDrive::GetDataOffset(const Entry& entry)
+{
+	std::array<uint8_t, LocalHeaderSize> header = {};
+	if (cross_fseeko(archive.get(), entry.header_offset, SEEK_SET) != 0 ||
+	    fread(header.data(), 1, header.size(), archive.get()) != header.size() ||
+	    host_readd(header.data()) != LocalHeaderSignature) {
+		LOG_WARNING("ZIP: Damaged local header of '%s'", entry.name.c_str());
+		return {};
+	}
+
+	// The name and extra field may differ from the central directory's
+	const auto name_length  = host_readw(&header[26]);
+	const auto extra_length = host_readw(&header[28]);
+
+	return entry.header_offset + static_cast<uint32_t>(LocalHeaderSize) +
+	       name_length + extra_length;
+}
+
+size_t zipDrive::ReadArchive(const uint32_t offset, uint8_t* data,
+                             const size_t num_bytes)
+{
+	if (cross_fseeko(archive.get(), offset, SEEK_SET) != 0) {
+		return 0;
+	}
+	return fread(data, 1, num_bytes, archive.get());
+}
+
+bool zipDrive::Inflate(const Entry& entry, const uint32_t data_offset,
+                       std::vector<uint8_t>& data)
+{
+	if (entry.size > MaxInflatedBytes) {
+		LOG_WARNING("ZIP: '%s' is too large to decompress", entry.name.c_str());
+		return false;
+	}
+	if (entry.size > (entry.compressed_size + 1ULL) * MaxDeflateRatio) {
+		LOG_WARNING("ZIP: Damaged compressed size of '%s'", entry.name.c_str());
+		return false;
+	}
+
+	z_stream stream = {};
+
+	// Raw deflate data without a zlib header
+	if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+		return false;
+	}
+
+	data.resize(entry.size);
+	stream.next_out  = data.data();
+	stream.avail_out = entry.size;
+
+	std::vector<uint8_t> input(std::min<uint32_t>(entry.compressed_size,
+	                                              64 * 1024));
+	auto remaining_input = entry.compressed_size;
+	auto input_offset    = data_offset;
+
+	auto result = Z_OK;
+	while (result == Z_OK) {
+		if (stream.avail_in == 0 && remaining_input > 0) {
+			const auto chunk_size = std::min<uint32_t>(remaining_input,
+			                                           static_cast<uint32_t>(
+			                                                   input.size()));
+			if (ReadArchive(input_offset, input.data(), chunk_size) != chunk_size) {
+				break;
+			}
+			stream.next_in  = input.data();
+			stream.avail_in = chunk_size;
+
+			input_offset += chunk_size;
+			remaining_input -= chunk_size;
+		}
+		result = inflate(&stream, Z_NO_FLUSH);
+		if (result == Z_BUF_ERROR && stream.avail_in == 0 && remaining_input == 0) {
+			break;
+		}
+	}
+	inflateEnd(&stream);
+
+	if (result != Z_STREAM_END || stream.total_out != entry.size) {
+		LOG_WARNING("ZIP: Damaged compressed data of '%s'", entry.name.c_str());
+		return false;
+	}
+	if (crc32(0, data.data(), static_cast<uInt>(data.size())) != entry.crc) {
+		LOG_WARNING("ZIP: CRC mismatch in '%s'", entry.name.c_str());
+		return false;
+	}
+	return true;
+}
+
+std::shared_ptr<const std::vector<uint8_t>> zipDrive::GetInflated(
+        const uint32_t entry_index, const uint32_t data_offset)
+{
+	const auto key = cache_key(archive_id, entry_index);
+	if (auto data = inflated_files.Get(key)) {
+		return data;
+	}
+
+	auto data = std::make_shared<std::vector<uint8_t>>();
+	if (!Inflate(entries[entry_index], data_offset, *data)) {
+		return nullptr;
+	}
+	inflated_files.Add(key, data);
+	return data;
+}
+
+std::unique_ptr<DOS_File> zipDrive::FileOpen(const char* name, uint8_t flags)
+{
+	if ((flags & 0x0f) != OPEN_READ) {
+		DOS_SetError(DOSERR_ACCESS_DENIED);
+		return nullptr;
+	}
+
+	const auto entry = Lookup(name);
+	if (!entry || entry->attr.directory) {
+		return nullptr;
+	}
+	const auto data_offset = GetDataOffset(*entry);
+	if (!data_offset) {
+		DOS_SetError(DOSERR_ACCESS_DENIED);
+		return nullptr;
+	}
+
+	const auto entry_index = static_cast<uint32_t>(entry - entries.data());
+
+	auto file = std::make_unique<zipFile>(shared_from_this(),
+	                                      name,
+	                                      entry_index,
+	                                      *data_offset);
+	file->flags = flags;
+	return file;
+}
+
+std::unique_ptr<DOS_File> zipDrive::FileCreate(const char* /*name*/,
+                                               FatAttributeFlags /*attributes*/)
+{
+	DOS_SetError(DOSERR_ACCESS_DENIED);
+	return nullptr;
+}
+
+bool zipDrive::FileUnlink(const char* /*name*/)
+{
+	DOS_SetError(DOSERR_ACCESS_DENIED);
+	return false;
+}
+
+bool zipDrive::RemoveDir(const char* /*dir*/)
+{
+	DOS_SetError(DOSERR_ACCESS_DENIED);
+	return false;
+}
+
+bool zipDrive::MakeDir(const char* /*dir*/)
+{
+	DOS_SetError(DOSERR_ACCESS_DENIED);
+	return false;
+}
+
+bool zipDrive::TestDir(const char* dir)
+{
+	const auto entry = Lookup(dir);
+	return entry && entry->attr.directory;
+}
+
+bool zipDrive::FindFirst(const char* dir, DOS_DTA& dta, bool fcb_findfirst)
+{
+	const auto entry = Lookup(dir);
+	if (!entry || !entry->attr.directory) {
+		DOS_SetError(DOSERR_PATH_NOT_FOUND);
+		return false;
+	}
+
+	const auto iterator_id = next_dir_iterator;
+	next_dir_iterator      = (next_dir_iterator + 1) % MAX_OPENDIRS;
+
+	dir_iterators[iterator_id] = {entry->directory, 0, true};
+	dta.SetDirID(iterator_id);
+
+	FatAttributeFlags attr = {};
+	char pattern[DOS_NAMELENGTH_ASCII];
+	dta.GetSearchParams(attr, pattern);
+
+	const auto is_root = (entry->directory == 0);
+	if (attr == FatAttributeFlags::Volume) {
+		dta.SetResult(label, 0, 0, 0, FatAttributeFlags::Volume);
+		return true;
+	} else if (attr.volume && is_root && !fcb_findfirst) {
+		if (wild_file_cmp(label, pattern)) {
+			dta.SetResult(label, 0, 0, 0, FatAttributeFlags::Volume);
+			return true;
+		}
+	}
+	return FindNext(dta);
+}
+
+bool zipDrive::FindNext(DOS_DTA& dta)
+{
+	FatAttributeFlags attr = {};
+	char pattern[DOS_NAMELENGTH_ASCII];
+	dta.GetSearchParams(attr, pattern);
+
+	const auto iterator_id = dta.GetDirID();
+	if (iterator_id >= dir_iterators.size() || !dir_iterators[iterator_id].valid) {
+		DOS_SetError(DOSERR_NO_MORE_FILES);
+		return false;
+	}
+	auto& iterator = dir_iterators[iterator_id];
+
+	FatAttributeFlags attr_mask = {};
+	attr_mask.directory         = true;
+	attr_mask.hidden            = true;
+	attr_mask.system            = true;
+
+	const auto is_root = (iterator.directory == 0);
+	const auto& dir    = directories[iterator.directory];
+
+	// Subdirectories start with the '.' and '..' entries
+	const uint32_t num_dot_entries = is_root ? 0 : 2;
+
+	while (iterator.index < num_dot_entries + dir.entries.size()) {
+		const auto index = iterator.index++;
+
+		if (index < num_dot_entries) {
+			const auto dot_name = (index == 0) ? "." : "..";
+			if (attr.directory && wild_file_cmp(dot_name, pattern)) {
+				dta.SetResult(dot_name, 0, 0, 0, FatAttributeFlags::Directory);
+				return true;
+			}
+			continue;
+		}
+
+		const auto& entry = entries[dir.entries[index - num_dot_entries]];
+		if (!wild_file_cmp(entry.name.c_str(), pattern) ||
+		    (~(attr._data) & entry.attr._data & attr_mask._data)) {
+			continue;
+		}
+
+		auto find_attr      = entry.attr;
+		find_attr.read_only = true;
+		dta.SetResult(entry.name.c_str(),
+		              entry.attr.directory ? 0 : entry.size,
+		              entry.date,
+		              entry.time,
+		              find_attr);
+		return true;
+	}
+
+	iterator.valid = false;
+	DOS_SetError(DOSERR_NO_MORE_FILES);
+	return false;
+}
+
+bool zipDrive::GetFileAttr(const char* name, FatAttributeFlags* attr)
+{
+	const auto entry = Lookup(name);
+	if (!entry) {
+		*attr = {};
+		return false;
+	}
+	*attr           = entry->attr;
+	attr->read_only = true;
+	return true;
+}
+
+bool zipDrive::SetFileAttr(const char* name,
+                           [[maybe_unused]] const FatAttributeFlags attr)
+{
+	DOS_SetError(Lookup(name) ? DOSERR_ACCESS_DENIED : DOSERR_FILE_NOT_FOUND);
+	return false;
+}
+
+bool zipDrive::Rename(const char* /*oldname*/, const char* /*newname*/)
+{
+	DOS_SetError(DOSERR_ACCESS_DENIED);
+	return false;
+}
+
+bool zipDrive::AllocationInfo(uint16_t* bytes_sector, uint8_t* sectors_cluster,
+                              uint16_t* total_clusters, uint16_t* free_clusters)
+{
+	constexpr uint32_t ClusterSize = 32 * 1024;
+
+	uint64_t total_bytes = 0;
+	for (const auto& entry : entries) {
+		total_bytes += entry.size;
+	}
+
+	*bytes_sector    = 512;
+	*sectors_cluster = ClusterSize / 512;
+	*total_clusters  = static_cast<uint16_t>(
+                std::clamp<uint64_t>(total_bytes / ClusterSize + 1, 1, UINT16_MAX));
+	*free_clusters = 0;
+	return true;
+}
+
+bool zipDrive::FileExists(const char* name)
+{
+	const auto entry = Lookup(name);
+	return entry && !entry->attr.directory;
+}
+
+uint8_t zipDrive::GetMediaByte()
+{
+	return mediaid;
+}
+
+bool zipDrive::IsRemote()
+{
+	return false;
+}
+
+bool zipDrive::IsRemovable()
+{
+	return false;
+}
+
+Bits zipDrive::UnMount()
+{
+	return 0;
+}
@@ -7,6 +7,7 @@
 #include "dosbox.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -15,6 +16,7 @@
 #include "config/setup.h"
 #include "dos/dos.h"
 #include "dos/dos_system.h"
+#include "misc/support.h"
 
 // GCC throws a warning about non-virtual destructor for std::enable_shared_from_this
 // This is normally a helpful warning. Ex: If DOS_Drive had a non-virtual destructor, it would be a problem.
@@ -178,6 +180,14 @@ struct partTable {
 #pragma pack ()
 #endif
 
+// The clusters of a file in chain order, filled in as far as they have been
+// needed, so seeking within the file doesn't walk the chain from the start
+struct FatClusterChain {
+	uint32_t firstCluster          = 0;
+	uint32_t generation            = 0;
+	std::vector<uint32_t> clusters = {};
+};
+
 // Must be constructed with a shared_ptr or it will throw an exception on internal call to shared_from_this()
 class fatDrive final : public DOS_Drive, public std::enable_shared_from_this<fatDrive> {
 public:
@@ -207,12 +217,14 @@ public:
 	bool IsRemote(void) override;
 	bool IsRemovable(void) override;
 	Bits UnMount(void) override;
-	void EmptyCache(void) override {}
+	void EmptyCache(void) override;
 
 public:
 	uint8_t readSector(uint32_t sectnum, void * data);
 	uint8_t writeSector(uint32_t sectnum, void * data);
 	uint32_t getAbsoluteSectFromBytePos(uint32_t startClustNum, uint32_t bytePos);
+	uint32_t getAbsoluteSectFromBytePos(uint32_t startClustNum, uint32_t bytePos,
+	                                    FatClusterChain& chain);
 	uint32_t getSectorCount();
 	uint32_t getSectorSize(void);
 	uint32_t getClusterSize(void);
@@ -230,6 +242,9 @@ public:
 private:
 	uint32_t getClusterValue(uint32_t clustNum);
 	void setClusterValue(uint32_t clustNum, uint32_t clustValue);
+	bool isEndOfChain(uint32_t clustValue) const;
+	uint8_t* getFatEntry(uint32_t fatoffset);
+	void updateFatCache(uint32_t sectnum, const void* data);
 	uint32_t getClustFirstSect(uint32_t clustNum);
 	bool FindNextInternal(uint32_t dirClustNumber, DOS_DTA & dta, direntry *foundEntry);
 	bool getDirClustNum(const char * dir, uint32_t * clustNum, bool parDir);
@@ -251,8 +266,14 @@ private:
 
 	uint32_t cwdDirCluster;
 
-	uint8_t fatSectBuffer[1024];
-	uint32_t curFatSect;
+	// In-memory copy of the first FAT, loaded a page at a time. FAT12
+	// entries can straddle sectors, so its FAT is a single page.
+	std::vector<std::vector<uint8_t>> fatCache;
+	uint32_t fatCachePageSectors;
+
+	// Bumped whenever a link in a cluster chain changes, which makes the
+	// FatClusterChain of open files stale
+	uint32_t chainGeneration;
 };
 
 class cdromDrive final : public localDrive
@@ -403,13 +424,26 @@ private:
 	bool GetNextDirEntry(const int dirIterator, isoDirEntry* de);
 	void FreeDirIterator(const int dirIterator);
 	bool ReadCachedSector(uint8_t** buffer, const uint32_t sector);
-	
+
+	// A directory's entries, parsed the first time it's looked up or
+	// searched. The image can't change, so they're kept for good.
+	struct IsoDirectory {
+		std::vector<isoDirEntry> entries = {};
+		// Upper-cased name -> index into entries, skipping associated
+		// files; the first of duplicate names wins as with a scan
+		std::unordered_map<std::string, uint32_t> byName = {};
+	};
+	const IsoDirectory& GetDirectory(const isoDirEntry& de);
+	void ReadDirectory(const isoDirEntry& de, IsoDirectory& dir);
+
+	// Keyed by the directory's extent location
+	std::unordered_map<uint32_t, IsoDirectory> directories = {};
+
 	struct DirIterator {
 		bool valid;
 		bool root;
-		uint32_t currentSector;
-		uint32_t endSector;
-		uint32_t pos;
+		uint32_t extent;
+		uint32_t index;
 	} dirIterators[MAX_OPENDIRS];
 	
 	int nextFreeDirIterator;
@@ -430,6 +464,121 @@ private:
 	char discLabel[32];
 };
 
+// Read-only drive holding the files of a ZIP archive. The central directory
+// is indexed once when mounting. Deflated files are inflated when first read,
+// into a cache shared by all the mounted archives; stored files are read
+// straight from the archive.
+// Must be constructed with a shared_ptr as the files use shared_from_this()
+class zipDrive final : public DOS_Drive, public std::enable_shared_from_this<zipDrive> {
+public:
+	zipDrive(const char* archive_path, uint8_t mediaid, int& error);
+	~zipDrive() override;
+	std::unique_ptr<DOS_File> FileOpen(const char* name, uint8_t flags) override;
+	std::unique_ptr<DOS_File> FileCreate(const char* name,
+	                                     FatAttributeFlags attributes) override;
+	bool FileUnlink(const char* name) override;
+	bool RemoveDir(const char* dir) override;
+	bool MakeDir(const char* dir) override;
+	bool TestDir(const char* dir) override;
+	bool FindFirst(const char* _dir, DOS_DTA& dta, bool fcb_findfirst) override;
+	bool FindNext(DOS_DTA& dta) override;
+	bool GetFileAttr(const char* name, FatAttributeFlags* attr) override;
+	bool SetFileAttr(const char* name, const FatAttributeFlags attr) override;
+	bool Rename(const char* oldname, const char* newname) override;
+	bool AllocationInfo(uint16_t* bytes_sector, uint8_t* sectors_cluster,
+	                    uint16_t* total_clusters,
+	                    uint16_t* free_clusters) override;
+	bool FileExists(const char* name) override;
+	uint8_t GetMediaByte() override;
+	void EmptyCache() override {}
+	bool IsReadOnly() const override { return true; }
+	bool IsRemote() override;
+	bool IsRemovable() override;
+	Bits UnMount() override;
+	const char* GetLabel() override
+	{
+		return label;
+	}
+	void SetLabel(const char* new_label);
+
+	struct Entry {
+		std::string name = {};
+
+		uint32_t size            = 0;
+		uint32_t compressed_size = 0;
+		uint32_t crc             = 0;
+
+		// Offset of the local header; the data follows it
+		uint32_t header_offset = 0;
+
+		uint16_t method = 0;
+		uint16_t date   = 0;
+		uint16_t time   = 0;
+
+		FatAttributeFlags attr = {};
+
+		// Index into directories if the entry is a directory
+		int32_t directory = -1;
+	};
+
+	// Reads stored data straight from the archive, returns the number of
+	// bytes read
+	size_t ReadArchive(uint32_t offset, uint8_t* data, size_t num_bytes);
+
+	// The whole data of a deflated entry, or nullptr if it can't be
+	// inflated
+	std::shared_ptr<const std::vector<uint8_t>> GetInflated(uint32_t entry_index,
+	                                                        uint32_t data_offset);
+
+	const Entry& GetEntry(uint32_t entry_index) const
+	{
+		return entries[entry_index];
+	}
+
+private:
+	zipDrive(const zipDrive&)            = delete; // prevent copying
+	zipDrive& operator=(const zipDrive&) = delete; // prevent assignment
+
+	struct Directory {
+		std::vector<uint32_t> entries = {};
+		// Upper-cased DOS name -> index into entries
+		std::unordered_map<std::string, uint32_t> by_name = {};
+		// Name in the archive -> index into entries, to merge the paths
+		// that share a directory
+		std::unordered_map<std::string, uint32_t> by_host_name = {};
+	};
+
+	bool LoadCentralDirectory();
+	bool AddEntry(const std::string& zip_path, Entry entry);
+	uint32_t AddToDirectory(int32_t dir_index, const std::string& host_name,
+	                        Entry entry);
+	std::string MakeDosName(const Directory& dir, const std::string& host_name) const;
+	std::optional<uint32_t> GetDataOffset(const Entry& entry);
+	const Entry* Lookup(const char* path) const;
+	bool Inflate(const Entry& entry, uint32_t data_offset,
+	             std::vector<uint8_t>& data);
+
+	// The root directory is both the first entry and the first directory
+	std::vector<Entry> entries         = {};
+	std::vector<Directory> directories = {};
+
+	struct DirIterator {
+		int32_t directory = 0;
+		uint32_t index    = 0;
+		bool valid        = false;
+	};
+	std::vector<DirIterator> dir_iterators = std::vector<DirIterator>(MAX_OPENDIRS);
+	uint16_t next_dir_iterator = 0;
+
+	FILE_unique_ptr archive = {};
+
+	// Keys the entries of this archive in the shared cache
+	uint32_t archive_id = 0;
+
+	uint8_t mediaid = 0;
+	char label[32]  = {};
+};
+
 class VFILE_Block;
 using vfile_block_t = std::shared_ptr<VFILE_Block>;
 
@@ -512,6 +661,26 @@ private:
 	void remove_DOSdir_from_cache(const char* name);
 	void update_cache(bool read_directory_contents = false);
 
+	struct OverlayIndexEntry {
+		std::string name  = {};
+		bool is_directory = false;
+	};
+	struct OverlayIndexDir {
+		int64_t modified                       = 0;
+		std::vector<OverlayIndexEntry> entries = {};
+	};
+	// By directory relative to the overlay, with a trailing separator
+	using OverlayIndex = std::unordered_map<std::string, OverlayIndexDir>;
+
+	bool list_overlay_dir(const std::string& rel_dir, OverlayIndex& new_index,
+	                      std::vector<OverlayIndexEntry>& entries,
+	                      bool& has_index_changed);
+	void read_overlay_index();
+	void write_overlay_index() const;
+
+	OverlayIndex overlay_index = {};
+	bool is_index_loaded       = false;
+
 	std::vector<std::string> deleted_files_in_base; //Set is probably better, or some other solution (involving the disk).
 	std::vector<std::string> deleted_paths_in_base; //Currently only used to hide the overlay folder.
 	std::string overlap_folder;
@@ -117,6 +117,8 @@ void AUTOTYPE::Run()
 		return;
 	}
 
+	const auto is_fast = cmd->FindExist("-fast", true);
+
 	// Get the wait delay in milliseconds
 	double wait_s;
 	constexpr double def_wait_s = 2.0;
@@ -142,7 +144,7 @@ void AUTOTYPE::Run()
 		WriteOut_NoParsing("AUTOTYPE: button sequence is empty\n");
 		return;
 	}
-	MAPPER_AutoType(sequence, wait_ms, pace_ms);
+	MAPPER_AutoType(sequence, wait_ms, pace_ms, is_fast);
 }
 
 void AUTOTYPE::AddMessages() {
@@ -151,11 +153,12 @@ void AUTOTYPE::AddMessages() {
 	        "\n"
 	        "Usage:\n"
 	        "  [color=light-green]autotype[reset] -list\n"
-	        "  [color=light-green]autotype[reset] [-w [color=white]WAIT[reset]] [-p [color=white]PACE[reset]] [color=light-cyan]BUTTONS[reset]\n"
+	        "  [color=light-green]autotype[reset] [-w [color=white]WAIT[reset]] [-p [color=white]PACE[reset]] [-fast] [color=light-cyan]BUTTONS[reset]\n"
 	        "\n"
 	        "Parameters:\n"
 	        "  [color=white]WAIT[reset]     number of seconds to wait before typing begins (max of 30)\n"
 	        "  [color=white]PACE[reset]     number of seconds before each keystroke (max of 10)\n"
+	        "  -fast    type the buttons as fast as the DOS program reads them\n"
 	        "  [color=light-cyan]BUTTONS[reset]  one or more space-separated buttons\n"
 	        "\n"
 	        "Notes:\n"
@@ -163,11 +166,15 @@ void AUTOTYPE::AddMessages() {
 	        "  after they start. Autotyping begins after [color=light-cyan]WAIT[reset] seconds, and each button is\n"
 	        "  entered every [color=white]PACE[reset] seconds. The [color=light-cyan],[reset] character inserts an extra [color=white]PACE[reset] delay.\n"
 	        "  [color=white]WAIT[reset] and [color=white]PACE[reset] default to 2 and 0.5 seconds respectively if not specified.\n"
+	        "  With -fast, the buttons are typed as soon as the keyboard buffer has room,\n"
+	        "  ignoring [color=white]PACE[reset] and [color=light-cyan],[reset]; programs reading the keyboard hardware directly\n"
+	        "  fall back to typing every [color=white]PACE[reset] seconds.\n"
 	        "  A list of all available button names can be obtained using the -list option.\n"
 	        "\n"
 	        "Examples:\n"
 	        "  [color=light-green]autotype[reset] -list\n"
 	        "  [color=light-green]autotype[reset] -w [color=white]1[reset] -p [color=white]0.3[reset] [color=light-cyan]up enter , right enter[reset]\n"
 	        "  [color=light-green]autotype[reset] -p [color=white]0.2[reset] [color=light-cyan]f1 kp_8 , , enter[reset]\n"
-	        "  [color=light-green]autotype[reset] -w [color=white]1.3[reset] [color=light-cyan]esc enter , p l a y e r enter[reset]\n");
+	        "  [color=light-green]autotype[reset] -w [color=white]1.3[reset] [color=light-cyan]esc enter , p l a y e r enter[reset]\n"
+	        "  [color=light-green]autotype[reset] -fast [color=light-cyan]d i r space slash w enter[reset]\n");
 }
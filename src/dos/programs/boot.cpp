@@ -4,6 +4,7 @@
 
 #include "boot.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <limits>
 
@@ -24,6 +25,13 @@
 #include "utils/fs_utils.h"
 #include "utils/string_utils.h"
 
+// The size of the disk held in a compressed image differs from the file's
+static uint32_t get_image_size_kb(FILE* image_file)
+{
+	return check_cast<uint32_t>(std::max(DISK_IMAGE_GetSize(image_file), int64_t(0)) /
+	                            1024);
+}
+
 FILE* BOOT::getFSFile_mounted(const char* filename, uint32_t* ksize,
                               uint32_t* bsize, uint8_t* error)
 {
@@ -57,7 +65,7 @@ FILE* BOOT::getFSFile_mounted(const char* filename, uint32_t* ksize,
 			return nullptr;
 		}
 
-		*ksize = (ftell(tmpfile) / 1024);
+		*ksize = get_image_size_kb(tmpfile);
 		*bsize = ftell(tmpfile);
 		fclose(tmpfile);
 
@@ -103,7 +111,7 @@ FILE* BOOT::getFSFile(const char* filename, uint32_t* ksize, uint32_t* bsize,
 			if (!fseek_in_tmpfile(tmpfile, 0L, SEEK_END)) {
 				return nullptr;
 			}
-			*ksize = (ftell(tmpfile) / 1024);
+			*ksize = get_image_size_kb(tmpfile);
 			*bsize = ftell(tmpfile);
 			return tmpfile;
 		}
@@ -118,7 +126,7 @@ FILE* BOOT::getFSFile(const char* filename, uint32_t* ksize, uint32_t* bsize,
 	if (!fseek_in_tmpfile(tmpfile, 0L, SEEK_END)) {
 		return nullptr;
 	}
-	*ksize = (ftell(tmpfile) / 1024);
+	*ksize = get_image_size_kb(tmpfile);
 	*bsize = ftell(tmpfile);
 	return tmpfile;
 }
@@ -20,6 +20,7 @@
 #include "dos/dos.h"
 #include "dos/drive_local.h"
 #include "dosbox.h"
+#include "ints/disk_image_file.h"
 #include "misc/ansi_code_markup.h"
 #include "misc/notifications.h"
 #include "misc/support.h"
@@ -424,6 +425,7 @@ struct CommandSettings {
 	bool no_format  = false;
 	bool use_chs    = false;
 	bool use_dos_fs = false;
+	bool compress   = false;
 };
 
 using ParseResult = std::variant<ErrorType, CommandSettings>;
@@ -700,6 +702,9 @@ static ParseResult parse_args(const std::vector<std::string>& args)
 		} else if (arg == "-noformat") {
 			settings.no_format = true;
 
+		} else if (arg == "-compress") {
+			settings.compress = true;
+
 		} else if (arg == "-writetodos" || arg == "-d") {
 			settings.use_dos_fs = true;
 
@@ -1356,6 +1361,29 @@ static void write_root_dir(const CommandSettings& settings, ImageCreationContext
 	fwrite(root_buffer.data(), 1, root_buffer.size(), ctx.fs);
 }
 
+// Replaces the raw image with a compressed one holding the same disk
+static bool compress_image(const std_fs::path& filename)
+{
+	auto temp_filename = filename;
+	temp_filename += ".tmp";
+
+	{
+		FilePtr raw_fs(fopen(filename.string().c_str(), "rb"));
+		FilePtr compressed_fs(fopen(temp_filename.string().c_str(), "wb+"));
+		if (!raw_fs || !compressed_fs ||
+		    !DISK_IMAGE_Compress(raw_fs.get(), compressed_fs.get())) {
+			compressed_fs.reset();
+			std::error_code ec;
+			std_fs::remove(temp_filename, ec);
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	std_fs::rename(temp_filename, filename, ec);
+	return !ec;
+}
+
 static bool execute(Program* program, CommandSettings& settings)
 {
 	ImageCreationContext ctx;
@@ -1429,6 +1457,12 @@ static bool execute(Program* program, CommandSettings& settings)
 		// DOSBox to rescan.
 	}
 
+	if (settings.compress && !compress_image(settings.filename)) {
+		notify_warning("SHELL_CMD_MAKEIMG_COMPRESS_ERROR",
+		               settings.filename.string().c_str());
+		return false;
+	}
+
 	program->WriteOut(MSG_Get("SHELL_CMD_MAKEIMG_CREATED"),
 	                  display_path.c_str(),
 	                  ctx.geometry.cylinders,
@@ -1505,6 +1539,8 @@ void MAKEIMG::AddMessages()
 	        "  -fat [color=white]FF[reset]      Filesystem type ([color=light-cyan]-fat 12[reset], [color=light-cyan]-fat 16[reset] or [color=light-cyan]-fat 32[reset]).\n"
 	        "               Default is determined automatically.\n"
 	        "  -noformat    Do not format the filesystem (raw image).\n"
+	        "  -compress    Create a compressed image; only the parts of the disk\n"
+	        "               that have been written to take up space.\n"
 	        "  -label [color=white]NAME[reset]  Volume label.\n"
 	        "\n"
 	        "  -writetodos\n"
@@ -1534,6 +1570,8 @@ void MAKEIMG::AddMessages()
 	        "Cannot open file [color=light-cyan]%s[reset] for writing.");
 	MSG_Add("SHELL_CMD_MAKEIMG_SPACE_ERROR",
 	        "Disk full or cannot allocate image size.");
+	MSG_Add("SHELL_CMD_MAKEIMG_COMPRESS_ERROR",
+	        "Cannot write the compressed image [color=light-cyan]%s[reset].");
 	MSG_Add("SHELL_CMD_MAKEIMG_CREATED",
 	        "Created [color=light-cyan]%s[reset] [CHS: %u, %u, %u]");
 	MSG_Add("SHELL_CMD_MAKEIMG_FORMATTED",
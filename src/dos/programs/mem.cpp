@@ -10,6 +10,7 @@
 #include "hardware/port.h"
 #include "ints/bios.h"
 #include "ints/ems.h"
+#include "misc/host_memory.h"
 #include "more_output.h"
 #include "shell/shell.h"
 #include "utils/checks.h"
@@ -49,6 +50,8 @@ void MEM::Run()
 	// FreeDOS extesions
 	const auto has_option_xms = cmd->FindExistRemoveAll("/x", "/xms");
 	const auto has_option_ems = cmd->FindExistRemoveAll("/e", "/ems");
+	// DOSBox Staging extensions
+	const auto has_option_host = cmd->FindExistRemoveAll("/h", "/host");
 
 	// Check that only one report is selected
 	const std::vector<bool> all_selected = {has_option_classify,
@@ -57,7 +60,8 @@ void MEM::Run()
 	                                        has_option_module,
 	                                        has_option_module_colon,
 	                                        has_option_xms,
-	                                        has_option_ems};
+	                                        has_option_ems,
+	                                        has_option_host};
 
 	const auto num_selected = std::ranges::count_if(all_selected.begin(),
 	                                                all_selected.end(),
@@ -123,6 +127,8 @@ void MEM::Run()
 		error_string = DisplayXms(output);
 	} else if (has_option_ems) {
 		error_string = DisplayEms(output);
+	} else if (has_option_host) {
+		error_string = DisplayHost(output);
 	} else {
 		assert(num_selected == 0);
 		error_string = DisplaySummary(output);
@@ -579,6 +585,40 @@ std::string MEM::DisplayEms(MoreOutputStrings& output) const
 	return {};
 }
 
+std::string MEM::DisplayHost(MoreOutputStrings& output) const
+{
+	output.AddString(MSG_Get("PROGRAM_MEM_HOST_TITLE"));
+	output.AddString("\n\n");
+
+	output.AddString(MSG_Get("PROGRAM_MEM_HOST_TABLE_HEADER"));
+	output.AddString("\n");
+	output.AddString(MSG_Get("PROGRAM_MEM_HOST_TABLE_HORIZONTAL_LINE"));
+	output.AddString("\n");
+
+	size_t total_bytes = 0;
+	for (const auto& usage : HOST_MEMORY_GetUsage()) {
+		output.AddString(MSG_Get("PROGRAM_MEM_HOST_TABLE_ROW_FORMAT"),
+		                 usage.subsystem.c_str(),
+		                 ToBytesKbString(usage.num_bytes).c_str());
+		output.AddString("\n");
+		total_bytes += usage.num_bytes;
+	}
+
+	output.AddString(MSG_Get("PROGRAM_MEM_HOST_TABLE_UNDERLINE"));
+	output.AddString("\n");
+	output.AddString(MSG_Get("PROGRAM_MEM_HOST_TABLE_SUMMARY"),
+	                 ToBytesKbString(total_bytes).c_str());
+	output.AddString("\n");
+
+	if (const auto resident_bytes = HOST_MEMORY_GetResidentSize()) {
+		output.AddString("\n");
+		output.AddString(MSG_Get("PROGRAM_MEM_HOST_RESIDENT"),
+		                 ToBytesKbString(*resident_bytes).c_str());
+		output.AddString("\n");
+	}
+	return {};
+}
+
 void MEM::DisplayEmsHandleTable(MoreOutputStrings& output,
                                 const EmsExtraInfo& info) const
 {
@@ -666,6 +706,11 @@ void MEM::DisplayEmsValues(MoreOutputStrings& output,
 	const auto value_free = ToBytesString(ems.free_bytes) + " " +
 	                        InBrackets(ToKbString(ems.free_bytes));
 	values.emplace_back(Indentation + label_free, value_free);
+	values.emplace_back();
+
+	const auto label_maps = MSG_Get("PROGRAM_MEM_EMS_LABEL_PAGE_MAPS");
+	values.emplace_back(Indentation + label_maps,
+	                    ToBytesString(static_cast<size_t>(info.num_page_maps)));
 
 	DisplayValues(output, values);
 }
@@ -1151,6 +1196,9 @@ MEM::EmsExtraInfo MEM::GetEmsExtraInfo(const EmsInfo& ems) const
 		info.total_handles = {};
 	}
 
+	// Not available through the EMS API, ask our driver directly
+	info.num_page_maps = EMS_GetNumPageMaps();
+
 	// Get the allocated pages for each handle
 	for (uint16_t handle = 0; handle <= UINT8_MAX; ++handle) {
 		reg_ah = 0x4c;
@@ -1247,7 +1295,7 @@ void MEM::AddMessages()
 	        "Display the amount of used and free memory.\n"
 	        "\n"
 	        "Usage:\n"
-	        "  [color=light-green]mem[reset] [/p] [/c | /d | /f | /x | /e]\n"
+	        "  [color=light-green]mem[reset] [/p] [/c | /d | /f | /x | /e | /h]\n"
 	        "  [color=light-green]mem[reset] [/p] /m [color=light-cyan]MODULE[reset]\n"
 	        "  [color=light-green]mem[reset] [/p] /m:[color=light-cyan]MODULE[reset]\n"
 	        "\n"
@@ -1261,6 +1309,7 @@ void MEM::AddMessages()
 	        "  /m or /module    display memory usage of the specified [color=light-cyan]MODULE[reset]\n"
 	        "  /x or /xms       display Extended Memory (XMS) usage\n"
 	        "  /e or /ems       display Expanded Memory (EMS) usage\n"
+	        "  /h or /host      display host memory used by the emulator\n"
 	        "\n"
 	        "Notes:\n"
 	        "  - If no report is selected, a brief summary is displayed.\n"
@@ -1391,6 +1440,24 @@ void MEM::AddMessages()
 	MSG_Add("PROGRAM_MEM_EMS_LABEL_HANDLES_FREE",  "Free handles");
 	MSG_Add("PROGRAM_MEM_EMS_LABEL_TOTAL",         "Total EMS memory");
 	MSG_Add("PROGRAM_MEM_EMS_LABEL_FREE",          "Free EMS memory");
+	MSG_Add("PROGRAM_MEM_EMS_LABEL_PAGE_MAPS",     "Page mappings");
+
+	// Host memory report
+
+	MSG_Add("PROGRAM_MEM_HOST_TITLE", "Host memory used by the emulator:");
+
+	MSG_Add("PROGRAM_MEM_HOST_TABLE_HEADER",
+	        "[color=white]Subsystem                        Size[reset]");
+	MSG_Add("PROGRAM_MEM_HOST_TABLE_HORIZONTAL_LINE",
+	        "-------------------------   ---------------------");
+	MSG_Add("PROGRAM_MEM_HOST_TABLE_ROW_FORMAT",
+	        "[color=light-cyan]%-25s[reset]   %s");
+	MSG_Add("PROGRAM_MEM_HOST_TABLE_UNDERLINE",
+	        "                            ---------------------");
+	MSG_Add("PROGRAM_MEM_HOST_TABLE_SUMMARY",
+	        "Total:                      %s");
+	MSG_Add("PROGRAM_MEM_HOST_RESIDENT",
+	        "Resident size of the process: %s");
 
 	// Common messages
 
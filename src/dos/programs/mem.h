@@ -141,6 +141,8 @@ private:
 		std::optional<uint16_t> open_handles  = {};
 		std::optional<uint16_t> total_handles = {};
 
+		uint64_t num_page_maps = 0;
+
 		// Order is important for display purposes, so no 'unordered_map'
 		std::map<uint16_t, uint16_t> handle_pages    = {};
 		std::map<uint16_t, std::string> handle_names = {};
@@ -155,6 +157,7 @@ private:
 	                          const std::string& module_name) const;
 	std::string DisplayXms(MoreOutputStrings& output) const;
 	std::string DisplayEms(MoreOutputStrings& output) const;
+	std::string DisplayHost(MoreOutputStrings& output) const;
 
 	void DisplayEmsHandleTable(MoreOutputStrings& output,
 	                           const EmsExtraInfo& info) const;
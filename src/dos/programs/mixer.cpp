@@ -753,6 +753,10 @@ void MIXER::Run()
 		MIDI_ListDevices(this);
 		return;
 	}
+	if (cmd->FindExist("/STATS")) {
+		ShowMixerStats();
+		return;
+	}
 
 	constexpr auto remove = true;
 
@@ -793,6 +797,7 @@ void MIXER::AddMessages()
 	        "Usage:\n"
 	        "  [color=light-green]mixer[reset] [color=light-cyan][CHANNEL][reset] [color=white]COMMANDS[reset] [/noshow]\n"
 	        "  [color=light-green]mixer[reset] [/listmidi]\n"
+	        "  [color=light-green]mixer[reset] [/stats]\n"
 	        "\n"
 	        "Parameters:\n"
 	        "  [color=light-cyan]CHANNEL[reset]   mixer channel to change the settings of\n"
@@ -808,6 +813,7 @@ void MIXER::AddMessages()
 	        "Notes:\n"
 	        "  - Run [color=light-green]mixer[reset] without arguments to view the current settings.\n"
 	        "  - Run [color=light-green]mixer[reset] /listmidi to list all available MIDI devices.\n"
+	        "  - Run [color=light-green]mixer[reset] /stats to view the mixer's buffering and timing statistics.\n"
 	        "  - You may change the settings of more than one channel in a single command.\n"
 	        "  - If no channel is specified, you can set crossfeed, reverb, or chorus\n"
 	        "    of all channels globally.\n"
@@ -823,6 +829,28 @@ void MIXER::AddMessages()
 	MSG_Add("SHELL_CMD_MIXER_HEADER_LABELS",
 	        "[color=white]Channel      Volume    Volume (dB)   Mode     Xfeed  Reverb  Chorus[reset]");
 
+	MSG_Add("SHELL_CMD_MIXER_STATS_SUMMARY",
+	        "[color=white]Mixer statistics[reset]\n"
+	        "\n"
+	        "  Sample rate:       %d Hz\n"
+	        "  Block size:        %d frames (%.2f ms)\n"
+	        "  Prebuffer:         %d ms\n"
+	        "  Output queue:      %.0f%% full\n"
+	        "  Output underruns:  %s\n"
+	        "  Capture overruns:  %s\n"
+	        "  Blocks mixed:      %s\n"
+	        "  Mix time / block:  %.0f us average, %s us peak\n"
+	        "\n");
+
+	MSG_Add("SHELL_CMD_MIXER_STATS_HEADER_LAYOUT", "%-22s %9s %6s %8s %9s %9s %7s %8s");
+
+	MSG_Add("SHELL_CMD_MIXER_STATS_HEADER_LABELS",
+	        "[color=white]Channel     Rate (Hz)  Queue  Latency Underruns     Awake  Render Resample[reset]");
+
+	MSG_Add("SHELL_CMD_MIXER_STATS_NOTE",
+	        "Awake is the audio time a channel has mixed while awake. Render and resample\n"
+	        "times are averages per mixed block, in microseconds.\n");
+
 	MSG_Add("SHELL_CMD_MIXER_CHANNEL_OFF", "off");
 	MSG_Add("SHELL_CMD_MIXER_CHANNEL_STEREO", "Stereo");
 	MSG_Add("SHELL_CMD_MIXER_CHANNEL_REVERSE", "Reverse");
@@ -989,3 +1017,74 @@ void MIXER::ShowMixerStatus()
 
 	WriteOut("\n");
 }
+
+void MIXER::ShowMixerStats()
+{
+	const auto stats = MIXER_GetStats();
+
+	const auto blocksize_ms = stats.sample_rate_hz > 0
+	                                ? stats.blocksize * MillisInSecond /
+	                                          stats.sample_rate_hz
+	                                : 0.0;
+
+	// Averages per mixed block, in microseconds
+	auto per_block = [&](const int64_t total_us) {
+		return stats.num_blocks > 0 ? static_cast<double>(total_us) /
+		                                      static_cast<double>(stats.num_blocks)
+		                            : 0.0;
+	};
+
+	WriteOut(MSG_Get("SHELL_CMD_MIXER_STATS_SUMMARY"),
+	         stats.sample_rate_hz,
+	         stats.blocksize,
+	         blocksize_ms,
+	         stats.prebuffer_ms,
+	         static_cast<double>(stats.output_queue_percent_full),
+	         std::to_string(stats.output_underruns).c_str(),
+	         std::to_string(stats.capture_overruns).c_str(),
+	         std::to_string(stats.num_blocks).c_str(),
+	         per_block(stats.mix_us),
+	         std::to_string(stats.max_mix_us).c_str());
+
+	std::string column_layout = MSG_Get("SHELL_CMD_MIXER_STATS_HEADER_LAYOUT");
+	column_layout.append({'\n'});
+
+	WriteOut(MSG_Get("SHELL_CMD_MIXER_STATS_HEADER_LABELS"));
+	WriteOut("\n");
+
+	constexpr auto none_value = "-";
+
+	for (const auto& channel : stats.channels) {
+		const auto channel_name = std::string("[color=light-cyan]") +
+		                          channel.name + std::string("[reset]");
+
+		const auto queue = channel.queue_percent_full < 0.0f
+		                         ? std::string(none_value)
+		                         : format_str("%.0f%%",
+		                                      static_cast<double>(
+		                                              channel.queue_percent_full));
+
+		const auto latency = channel.latency_ms < 0.0f
+		                           ? std::string(none_value)
+		                           : format_str("%.0f ms",
+		                                        static_cast<double>(
+		                                                channel.latency_ms));
+
+		const auto awake = format_str("%.1f s",
+		                              static_cast<double>(channel.awake_ms) /
+		                                      MillisInSecond);
+
+		WriteOut(column_layout,
+		         convert_ansi_markup(channel_name).c_str(),
+		         std::to_string(channel.sample_rate_hz).c_str(),
+		         queue.c_str(),
+		         latency.c_str(),
+		         std::to_string(channel.underruns).c_str(),
+		         awake.c_str(),
+		         format_str("%.1f", per_block(channel.mix_us)).c_str(),
+		         format_str("%.1f", per_block(channel.resample_us)).c_str());
+	}
+
+	WriteOut("\n");
+	WriteOut(MSG_Get("SHELL_CMD_MIXER_STATS_NOTE"));
+}
@@ -153,7 +153,7 @@ bool MOUNT::MountImageFat(MountParameters& params)
 			                      "PROGRAM_IMGMOUNT_INVALID_IMAGE");
 			return false;
 		}
-		const auto sz = stdio_num_sectors(diskfile);
+		const auto sz = DISK_IMAGE_GetSize(diskfile);
 		if (sz < 0) {
 			fclose(diskfile);
 			NOTIFY_DisplayWarning(Notification::Source::Console,
@@ -161,17 +161,16 @@ bool MOUNT::MountImageFat(MountParameters& params)
 			                      "PROGRAM_IMGMOUNT_INVALID_IMAGE");
 			return false;
 		}
-		uint32_t fcsize = check_cast<uint32_t>(sz);
+		uint32_t fcsize = check_cast<uint32_t>(sz / 512);
 		uint8_t buf[512];
-		if (cross_fseeko(diskfile, 0L, SEEK_SET) != 0 ||
-		    fread(buf, sizeof(uint8_t), 512, diskfile) < 512) {
-			fclose(diskfile);
+		// Closes the file
+		const auto image = DISK_IMAGE_Open(diskfile);
+		if (!image || !image->Read(0, buf, sizeof(buf))) {
 			NOTIFY_DisplayWarning(Notification::Source::Console,
 			                      "MOUNT",
 			                      "PROGRAM_IMGMOUNT_INVALID_IMAGE");
 			return false;
 		}
-		fclose(diskfile);
 		if ((buf[510] != 0x55) || (buf[511] != 0xaa)) {
 			NOTIFY_DisplayWarning(Notification::Source::Console,
 			                      "MOUNT",
@@ -346,6 +345,53 @@ bool MOUNT::MountImageIso(MountParameters& params)
 	return true;
 }
 
+bool MOUNT::MountZip(MountParameters& params)
+{
+	if (params.is_drive_number) {
+		NOTIFY_DisplayWarning(Notification::Source::Console,
+		                      "MOUNT",
+		                      "PROGRAM_MOUNT_ZIP_NOT_BOOTABLE");
+		return false;
+	}
+	if (Drives.at(drive_index(params.drive))) {
+		NOTIFY_DisplayWarning(Notification::Source::Console,
+		                      "MOUNT",
+		                      "PROGRAM_IMGMOUNT_ALREADY_MOUNTED");
+		return false;
+	}
+
+	// Several archives can be cycled through like disk images
+	DriveManager::filesystem_images_t zip_archives = {};
+	for (const auto& zip_path : params.paths) {
+		int error     = -1;
+		auto zip_drive = std::make_shared<zipDrive>(zip_path.c_str(),
+		                                            params.mediaid,
+		                                            error);
+		if (error) {
+			NOTIFY_DisplayWarning(Notification::Source::Console,
+			                      "MOUNT",
+			                      "PROGRAM_MOUNT_ZIP_INVALID",
+			                      zip_path.c_str());
+			return false;
+		}
+		if (!params.label.empty()) {
+			zip_drive->SetLabel(params.label.c_str());
+		}
+		zip_archives.push_back(std::move(zip_drive));
+	}
+
+	DriveManager::AppendFilesystemImages(drive_index(params.drive), zip_archives);
+	DriveManager::InitializeDrive(drive_index(params.drive));
+
+	// Set the correct media byte in the table
+	mem_writeb(RealToPhysical(dos.tables.mediaid) + drive_index(params.drive) * 9,
+	           params.mediaid);
+
+	WriteMountStatus(MSG_Get("MOUNT_TYPE_ZIP").c_str(), params.paths, params.drive);
+	WriteOut(MSG_Get("PROGRAM_MOUNT_READONLY"));
+	return true;
+}
+
 bool MOUNT::MountImageRaw(MountParameters& params)
 {
 	auto new_disk = fopen_wrap_ro_fallback(params.paths[0], params.roflag);
@@ -355,7 +401,7 @@ bool MOUNT::MountImageRaw(MountParameters& params)
 		                      "PROGRAM_IMGMOUNT_INVALID_IMAGE");
 		return false;
 	}
-	const auto sz = stdio_size_kb(new_disk);
+	const auto sz = DISK_IMAGE_GetSize(new_disk);
 	if (sz < 0) {
 		fclose(new_disk);
 		NOTIFY_DisplayWarning(Notification::Source::Console,
@@ -363,7 +409,7 @@ bool MOUNT::MountImageRaw(MountParameters& params)
 		                      "PROGRAM_IMGMOUNT_INVALID_IMAGE");
 		return false;
 	}
-	auto imagesize = check_cast<uint32_t>(sz);
+	auto imagesize = check_cast<uint32_t>(sz / 1024);
 	// 0=A:, 1=B:, 2=C:, 3=D:
 	const auto is_hdd = (params.drive >= '2');
 	// Seems to make sense to require a valid geometry..
@@ -378,8 +424,17 @@ bool MOUNT::MountImageRaw(MountParameters& params)
 
 	const auto drv_idx = params.drive - '0';
 
-	imageDiskList.at(drv_idx) = std::make_shared<imageDisk>(
-	        new_disk, params.paths[0].c_str(), imagesize, is_hdd);
+	auto disk = std::make_shared<imageDisk>(new_disk,
+	                                        params.paths[0].c_str(),
+	                                        imagesize,
+	                                        is_hdd);
+	if (!disk->diskimg) {
+		NOTIFY_DisplayWarning(Notification::Source::Console,
+		                      "MOUNT",
+		                      "PROGRAM_IMGMOUNT_INVALID_IMAGE");
+		return false;
+	}
+	imageDiskList.at(drv_idx) = std::move(disk);
 
 	if (is_hdd) {
 		imageDiskList.at(drv_idx)->Set_Geometry(params.sizes[2],
@@ -404,14 +459,22 @@ bool MOUNT::MountImage(MountParameters& params)
 	params.mediaid = (params.type == "floppy") ? MediaId::Floppy1_44MB
 	                                           : MediaId::HardDisk;
 
-	if (params.fstype == "fat") {
-		return MountImageFat(params);
+	// The disk and CD-ROM images check this when opening their files
+	DOS_SetImagePreloadForced(params.should_preload);
+
+	auto success = true;
+	if (params.type == "zip") {
+		success = MountZip(params);
+	} else if (params.fstype == "fat") {
+		success = MountImageFat(params);
 	} else if (params.fstype == "iso") {
-		return MountImageIso(params);
+		success = MountImageIso(params);
 	} else if (params.fstype == "none") {
-		return MountImageRaw(params);
+		success = MountImageRaw(params);
 	}
-	return true;
+
+	DOS_SetImagePreloadForced(false);
+	return success;
 }
 
 bool MOUNT::HandleUnmount()
@@ -439,6 +502,8 @@ void MOUNT::ParseArguments(MountParameters& params, bool& explicit_fs,
 
 	params.roflag = cmd->FindExist("-ro", true);
 
+	params.should_preload = cmd->FindExist("-preload", true);
+
 	// Parse -fs (filesystem type)
 	if (params.type == "iso") {
 		params.fstype = "iso";
@@ -486,7 +551,7 @@ void MOUNT::ParseGeometry(MountParameters& params)
 		}
 	} else if (params.type == "iso") {
 		str_size = "2048,1,65535,0";
-	} else if (params.type != "hdd") {
+	} else if (params.type != "hdd" && params.type != "zip") {
 		// If it is 'hdd', we leave sizes 0 to trigger detection or
 		// parsing below. If it is unknown, we error out later.
 		NOTIFY_DisplayWarning(Notification::Source::Console,
@@ -698,7 +763,7 @@ bool MOUNT::ProcessPaths(MountParameters& params, bool path_relative_to_last_con
 	auto stat_ok       = (stat(path_arg_1.c_str(), &test) == 0);
 	auto target_is_dir = stat_ok && S_ISDIR(test.st_mode);
 	auto explicit_image_type = (params.type == "hdd" || params.type == "iso" ||
-	                            params.type == "floppy");
+	                            params.type == "floppy" || params.type == "zip");
 
 	const auto has_wildcards = path_arg_1.find_first_of("*?") !=
 	                           std::string::npos;
@@ -838,6 +903,8 @@ bool MOUNT::ProcessPaths(MountParameters& params, bool path_relative_to_last_con
 					} else if (ext == "img" ||
 					           ext == "ima" || ext == "vhd") {
 						params.type = "hdd";
+					} else if (ext == "zip") {
+						params.type = "zip";
 					}
 				}
 			}
@@ -961,6 +1028,10 @@ void MOUNT::MountLocal(MountParameters& params, const std::string& local_path)
 		        params.mediaid,
 		        params.roflag,
 		        section->GetBool("allow_write_protected_files"));
+
+		if (get_section("dos")->GetBool("scan_mounted_dirs")) {
+			newdrive->dirCache.StartHostScan();
+		}
 	}
 
 	DriveManager::RegisterFilesystemImage(drive_index(params.drive), newdrive);
@@ -1079,7 +1150,8 @@ void MOUNT::AddMessages()
 	        "                  mounted DOS drive (e.g. C:\\GAME.ISO)\n"
 	        "  [color=light-cyan]IMAGE-SET[reset]       ISO, CUE+BIN, CUE+ISO, or CUE+ISO+FLAC/OPUS/OGG/MP3/WAV\n"
 	        "\n"
-	        "  -t [color=white]TYPE[reset]         type of mount: [color=light-cyan]dir[reset], [color=light-cyan]overlay[reset], [color=light-cyan]floppy[reset], [color=light-cyan]hdd[reset], [color=light-cyan]iso[reset] (or [color=light-cyan]cdrom[reset])\n"
+	        "  -t [color=white]TYPE[reset]         type of mount: [color=light-cyan]dir[reset], [color=light-cyan]overlay[reset], [color=light-cyan]floppy[reset], [color=light-cyan]hdd[reset], [color=light-cyan]iso[reset] (or [color=light-cyan]cdrom[reset]),\n"
+	        "                  [color=light-cyan]zip[reset]\n"
 	        "  -fs [color=white]FS[reset]          filesystem: [color=light-cyan]fat[reset], [color=light-cyan]iso[reset], or [color=light-cyan]none[reset] (for bootable images)\n"
 	        "  -label [color=white]LABEL[reset]    volume label to assign to the mounted drive\n"
 	        "  -ro             mount as read-only\n"
@@ -1095,6 +1167,8 @@ void MOUNT::AddMessages()
 	        "  -size [color=white]B,S,H,C[reset]   specify geometry ([color=white]B[reset]ytesPerSector,[color=white]S[reset]ectors,[color=white]H[reset]eads,[color=white]C[reset]ylinders);\n"
 	        "                  alternative to -chs for HDD images\n"
 	        "  -ide            attach as IDE device (for CD-ROM and HDD images)\n"
+	        "  -preload        read the image into memory in the background (for images on\n"
+	        "                  slow or network storage)\n"
 	        "  -pr             path is relative to the configuration file location\n"
 	        "\n"
 	        "Notes:\n"
@@ -1106,6 +1180,9 @@ void MOUNT::AddMessages()
 	        "    for CD-based games that need a real DOS environment via a bootable HDD\n"
 	        "    image.\n"
 	        "\n"
+	        "  - Type [color=light-cyan]zip[reset] mounts the files of a ZIP archive as a read-only drive.\n"
+	        "    Files are decompressed when they're first read.\n"
+	        "\n"
 	        "  - Type [color=light-cyan]overlay[reset] requires [color=white]DRIVE[reset] to be already mounted. It mounts [color=light-cyan]PATH[reset] on the\n"
 	        "    host OS as a write-layer over the drive. Modified files are stored in [color=light-cyan]PATH[reset],\n"
 	        "    leaving the original drive data unchanged.\n"
@@ -1186,6 +1263,12 @@ void MOUNT::AddMessages()
 	MSG_Add("PROGRAM_MOUNT_OVERLAY_GENERIC_ERROR", "Something went wrong.\n");
 	MSG_Add("PROGRAM_MOUNT_OVERLAY_STATUS", "Overlay %s on drive %c mounted.\n");
 
+	MSG_Add("PROGRAM_MOUNT_ZIP_INVALID",
+	        "Could not read the ZIP archive '%s'.\n");
+
+	MSG_Add("PROGRAM_MOUNT_ZIP_NOT_BOOTABLE",
+	        "ZIP archives can only be mounted to a drive letter.\n");
+
 	MSG_Add("PROGRAM_MOUNT_INVALID_CHS",
 	        "Invalid CHS format. Use -chs cylinders,heads,sectors\n");
 
@@ -22,6 +22,7 @@ struct MountParameters {
 	std::array<uint16_t, 4> sizes = {0, 0, 0, 0};
 
 	bool roflag               = false;
+	bool should_preload       = false;
 	bool is_ide               = false;
 	int8_t ide_index          = -1;
 	bool is_second_cable_slot = false;
@@ -62,6 +63,7 @@ private:
 	bool MountImageFat(MountParameters& params);
 	bool MountImageIso(MountParameters& params);
 	bool MountImageRaw(MountParameters& params);
+	bool MountZip(MountParameters& params);
 
 	void WriteMountStatus(const char* image_type,
 	                      const std::vector<std::string>& images,
@@ -82,6 +82,7 @@ void AddMountTypeMessages() {
 	MSG_Add("MOUNT_TYPE_CDROM", "CD-ROM drive");
 	MSG_Add("MOUNT_TYPE_FAT", "FAT image");
 	MSG_Add("MOUNT_TYPE_ISO", "ISO image");
+	MSG_Add("MOUNT_TYPE_ZIP", "ZIP archive");
 	MSG_Add("MOUNT_TYPE_VIRTUAL", "Internal virtual drive");
 	MSG_Add("MOUNT_TYPE_UNKNOWN", "unknown drive");
 }
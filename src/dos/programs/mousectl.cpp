@@ -287,6 +287,15 @@ bool MOUSECTL::CmdShow(const bool show_all)
 		WriteOut("\n");
 	}
 
+	if (show_all) {
+		const auto stats = MouseControlAPI::GetMotionStats();
+		WriteOut(MSG_Get("PROGRAM_MOUSECTL_MOTION_STATS"),
+		         static_cast<unsigned long long>(stats.num_received),
+		         static_cast<unsigned long long>(stats.num_merged),
+		         static_cast<unsigned long long>(stats.num_dropped));
+		WriteOut("\n\n");
+	}
+
 	if (!show_all && !show_mapped) {
 		return true;
 	}
@@ -594,6 +603,8 @@ void MOUSECTL::AddMessages()
 	        "  - If sensitivity or rate is omitted, it is reset to default value.\n"
 	        "  - Mouse sensitivity set in the configuration file acts as global scale factor,\n"
 	        "    per-interface sensitivity set by this commands works on top of that.\n"
+	        "  - The [color=white]-all[reset] option also displays how many host mouse motion events were\n"
+	        "    merged or dropped.\n"
 	        "\n"
 	        "Examples:\n"
 	        "  [color=light-green]mousectl[reset] [color=white]DOS[reset] [color=white]COM1[reset] -map    ; asks user to select mice for a two player game");
@@ -657,6 +668,9 @@ void MOUSECTL::AddMessages()
 	MSG_Add("PROGRAM_MOUSECTL_TABLE_HINT_RATE_COM",
 	        "Sampling rates for mice on [color=light-cyan]COM[reset] interfaces are estimations only.");
 
+	MSG_Add("PROGRAM_MOUSECTL_MOTION_STATS",
+	        "Host mouse motion events: %llu received, %llu merged, %llu dropped.");
+
 	MSG_Add("PROGRAM_MOUSECTL_TABLE_HINT_RATE_MIN",
 	        "Sampling rates with minimum value set are marked with '*'.");
 
@@ -30,6 +30,9 @@ void RESCAN::Run(void)
 			drive  = temp_line[0] - 'a';
 		}
 	}
+	// Files might have come and gone on the host
+	DOS_NotifyDirectoryChange();
+
 	// Get current drive
 	if (all) {
 		for (Bitu i =0; i<DOS_DRIVES; i++) {
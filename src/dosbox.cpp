@@ -4,12 +4,17 @@
 
 #include "dosbox.h"
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <limits>
 #include <memory>
+#include <set>
+#include <string>
 
 #ifdef WIN32
 #ifndef WIN32_LEAN_AND_MEAN
@@ -23,6 +28,7 @@
 #include "audio/disk_noise.h"
 #include "audio/mixer.h"
 #include "capture/capture.h"
+#include "capture/shared_memory_output.h"
 #include "config/config.h"
 #include "config/setup.h"
 #include "cpu/callback.h"
@@ -45,6 +51,7 @@
 #include "hardware/audio/speaker.h"
 #include "hardware/cmos.h"
 #include "hardware/dma.h"
+#include "hardware/input/input_replay.h"
 #include "hardware/input/joystick.h"
 #include "hardware/input/keyboard.h"
 #include "hardware/input/mouse.h"
@@ -55,6 +62,7 @@
 #include "hardware/pic.h"
 #include "hardware/port.h"
 #include "hardware/serialport/serialport.h"
+#include "hardware/snapshot.h"
 #include "hardware/timer.h"
 #include "hardware/video/reelmagic/reelmagic.h"
 #include "hardware/video/vga.h"
@@ -65,7 +73,9 @@
 #include "ints/int10.h"
 #include "midi/midi.h"
 #include "misc/cross.h"
+#include "misc/metrics.h"
 #include "misc/support.h"
+#include "misc/tracing.h"
 #include "misc/video.h"
 #include "network/ethernet.h"
 #include "shell/autoexec.h"
@@ -103,6 +113,185 @@ void DOSBOX_SetTicksScheduled(const int64_t ticks_scheduled)
 	ticks.scheduled = ticks_scheduled;
 }
 
+// The share of the wall time spent emulating is measured over windows of at
+// least this length
+constexpr int64_t EmulationLoadWindowUs = 250'000;
+
+static struct {
+	int64_t window_start_us = 0;
+	int64_t idle_us         = 0;
+	float load              = 1.0f;
+} emulation_load = {};
+
+static void update_emulation_load(const int64_t now_us, const int64_t idle_us)
+{
+	auto& e = emulation_load;
+
+	e.idle_us += idle_us;
+
+	const auto window_us = now_us - e.window_start_us;
+	if (window_us < EmulationLoadWindowUs) {
+		return;
+	}
+	// The first window starts at the first update and isn't measured
+	if (e.window_start_us != 0) {
+		const auto idle_share = static_cast<float>(e.idle_us) /
+		                        static_cast<float>(window_us);
+		e.load = std::clamp(1.0f - idle_share, 0.0f, 1.0f);
+	}
+	e.window_start_us = now_us;
+	e.idle_us         = 0;
+}
+
+void DOSBOX_AddIdleTime(const int64_t idle_us)
+{
+	update_emulation_load(GetTicksUs(), idle_us);
+}
+
+float DOSBOX_GetEmulationLoad()
+{
+	return emulation_load.load;
+}
+
+// Smoothed wall time between the ticks in milliseconds. It stays at or below
+// one while the emulation keeps up with real time (and sleeps between the
+// ticks), and grows when the ticks take longer than the time they emulate.
+static float wall_ms_per_tick = 1.0f;
+
+static void update_wall_ms_per_tick(const int64_t elapsed_ms)
+{
+	constexpr auto Smoothing = 0.125f;
+	wall_ms_per_tick += (static_cast<float>(elapsed_ms) - wall_ms_per_tick) *
+	                    Smoothing;
+}
+
+bool DOSBOX_IsFallingBehind()
+{
+	constexpr auto MaxWallMsPerTick = 1.5f;
+	return !ticks.locked && wall_ms_per_tick > MaxWallMsPerTick;
+}
+
+// Cycles emulated since startup; like the benchmark's count, every tick
+// adds the cycles budget of the tick
+static MetricCounter& emulated_cycles()
+{
+	static auto& counter = METRICS_Counter("dosbox_emulated_cycles_total",
+	                                       "Emulated CPU cycles");
+	return counter;
+}
+
+int64_t DOSBOX_GetEmulatedCycles()
+{
+	return emulated_cycles().Value();
+}
+
+static struct {
+	bool running     = false;
+	int num_frames   = 0;
+	int frames_done  = 0;
+	int64_t cycles   = 0;
+	int64_t start_us = 0;
+
+	// Every tick is one emulated millisecond
+	int64_t emulated_ms = 0;
+} benchmark = {};
+
+void DOSBOX_StartBenchmark(const int num_frames)
+{
+	assert(num_frames > 0);
+
+	benchmark = {};
+
+	benchmark.running    = true;
+	benchmark.num_frames = num_frames;
+	benchmark.start_us   = GetTicksUs();
+
+	// Run unthrottled, the same way as the fast-forward mode does
+	ticks.locked = true;
+
+	LOG_MSG("BENCHMARK: Running for %d frames", num_frames);
+}
+
+bool DOSBOX_IsBenchmarkRunning()
+{
+	return benchmark.running;
+}
+
+static void log_benchmark_report()
+{
+	const auto wall_time_us = std::max(GetTicksUsSince(benchmark.start_us),
+	                                   static_cast<int64_t>(1));
+
+	constexpr auto MicrosInSecond = 1'000'000.0;
+
+	const auto wall_time_s = static_cast<double>(wall_time_us) / MicrosInSecond;
+
+	// One emulated cycle roughly corresponds to one emulated instruction
+	const auto mips = static_cast<double>(benchmark.cycles) /
+	                  static_cast<double>(wall_time_us);
+
+	constexpr auto MillisInSecond = 1000.0;
+
+	const auto emulated_time_s = static_cast<double>(benchmark.emulated_ms) /
+	                             MillisInSecond;
+
+	// How many times faster than real time the emulation ran
+	const auto speed = emulated_time_s / wall_time_s;
+
+	// The report goes to stdout so build scripts can parse it regardless
+	// of the logging setup
+	printf("BENCHMARK: frames: %d, wall time: %.3f s, emulated cycles: %lld, "
+	       "MIPS: %.2f, FPS: %.2f, emulated time: %.3f s, speed: %.3fx\n",
+	       benchmark.frames_done,
+	       wall_time_s,
+	       static_cast<long long>(benchmark.cycles),
+	       mips,
+	       benchmark.frames_done / wall_time_s,
+	       emulated_time_s,
+	       speed);
+
+	LOG_MSG("BENCHMARK: %d frames in %.3f s, %.2f MIPS",
+	        benchmark.frames_done,
+	        wall_time_s,
+	        mips);
+}
+
+void DOSBOX_LogStartupTime(const char* stage)
+{
+	static std::set<std::string> logged_stages = {};
+
+	// Only the first start counts, not the restarts
+	if (!logged_stages.emplace(stage).second) {
+		return;
+	}
+
+	constexpr auto MicrosInMilli = 1000.0;
+
+	const auto elapsed_ms = static_cast<double>(GetTicksUs()) / MicrosInMilli;
+
+	LOG_MSG("STARTUP: %s after %.1f ms", stage, elapsed_ms);
+
+	if (benchmark.running) {
+		printf("BENCHMARK: %s after %.1f ms\n", stage, elapsed_ms);
+	}
+}
+
+void DOSBOX_AddBenchmarkFrame()
+{
+	if (!benchmark.running) {
+		return;
+	}
+
+	++benchmark.frames_done;
+
+	if (benchmark.frames_done >= benchmark.num_frames) {
+		log_benchmark_report();
+
+		benchmark.running = false;
+		DOSBOX_RequestShutdown();
+	}
+}
+
 void Null_Init([[maybe_unused]] Section *sec) {
 	// do nothing
 }
@@ -118,7 +307,10 @@ static Bitu normal_loop()
 		if (PIC_RunQueue()) {
 			Webserver::DebugBridge::Instance().ProcessRequests();
 
-			ret = (*cpudecoder)();
+			{
+				TRACE_SCOPE("CPU");
+				ret = (*cpudecoder)();
+			}
 			if (ret < 0) {
 				return 1;
 			}
@@ -152,14 +344,31 @@ static Bitu normal_loop()
 			// presenting the last-rendered frame at regular
 			// intervals from the main thread.
 			//
-			if (GFX_GetPresentationMode() == PresentationMode::HostRate) {
-				GFX_MaybePresentFrame();
-			}
+			// Nothing is presented and no host events are handled
+			// in benchmark mode
+			if (!benchmark.running) {
+				if (GFX_GetPresentationMode() ==
+				    PresentationMode::HostRate) {
+					GFX_MaybePresentFrame();
+				}
+				REPLAY_BeginHostEvents();
+				const auto keep_running = GFX_PollAndHandleEvents();
+				REPLAY_EndHostEvents();
 
-			if (!GFX_PollAndHandleEvents()) {
-				return 0;
+				if (!keep_running) {
+					return 0;
+				}
 			}
+			REPLAY_InjectEvents();
+
 			if (ticks.remain > 0) {
+				if (benchmark.running) {
+					benchmark.cycles += CPU_CycleMax;
+					++benchmark.emulated_ms;
+				}
+				emulated_cycles().Add(CPU_CycleMax);
+
+				TRACE_SCOPE("Timer tick");
 				TIMER_AddTick();
 				--ticks.remain;
 			} else {
@@ -172,6 +381,107 @@ static Bitu normal_loop()
 
 constexpr auto auto_cpu_cycles_min = 200;
 
+// Adjustments of less than this are skipped, the measurements jitter by
+// about as much and following them only makes the cycles wander
+constexpr auto CyclesDeadbandPercent = 2;
+
+// After falling behind, this many following adjustments only make half of
+// the suggested increase so the cycles settle just below the host's limit
+// instead of overshooting it again
+constexpr auto CyclesIncreaseDampingSteps = 8;
+
+constexpr size_t CyclesHistorySize = 64;
+
+static struct {
+	int increase_damping_left = 0;
+
+	uint64_t increases = 0;
+	uint64_t decreases = 0;
+	uint64_t holds     = 0;
+
+	std::array<CyclesAdjustment, CyclesHistorySize> history = {};
+	size_t history_next = 0;
+	size_t history_size = 0;
+} cycles_control = {};
+
+static int limit_auto_cycles(const int cycles)
+{
+	// Hardcoded limit if the limit wasn't explicitly specified
+	const auto limit = CPU_CycleLimit > 0 ? CPU_CycleLimit : CpuCyclesMax;
+
+	return std::max(std::min(cycles, limit), auto_cpu_cycles_min);
+}
+
+// Moves the cycles towards the target suggested by the last measurement.
+// Decreases are applied at once as running behind makes the audio crackle;
+// increases are damped for a while after a decrease, and tiny changes in
+// either direction are skipped.
+static void adjust_auto_cycles(const int target, const int64_t ratio)
+{
+	auto& c = cycles_control;
+
+	const auto current = CPU_CycleMax;
+	auto next          = current;
+
+	if (target < current) {
+		next                    = target;
+		c.increase_damping_left = CyclesIncreaseDampingSteps;
+	} else if (target > current) {
+		next = c.increase_damping_left > 0
+		             ? current + (target - current) / 2
+		             : target;
+	}
+	if (c.increase_damping_left > 0 && next >= current) {
+		--c.increase_damping_left;
+	}
+
+	const auto deadband = static_cast<int64_t>(current) *
+	                      CyclesDeadbandPercent / 100;
+	if (std::abs(static_cast<int64_t>(next) - current) <= deadband) {
+		next = current;
+	}
+
+	if (next > current) {
+		++c.increases;
+	} else if (next < current) {
+		++c.decreases;
+	} else {
+		++c.holds;
+	}
+
+	c.history[c.history_next] = {GetTicks(),
+	                             current,
+	                             target,
+	                             next,
+	                             static_cast<int>(ratio * 100 / 1024)};
+
+	c.history_next = (c.history_next + 1) % CyclesHistorySize;
+	c.history_size = std::min(c.history_size + 1, CyclesHistorySize);
+
+	CPU_CycleMax = next;
+}
+
+CyclesAutoAdjustStats DOSBOX_GetCyclesAutoAdjustStats()
+{
+	const auto& c = cycles_control;
+
+	CyclesAutoAdjustStats stats = {};
+
+	stats.is_enabled            = CPU_CycleAutoAdjust;
+	stats.cycles                = CPU_CycleMax;
+	stats.increase_damping_left = c.increase_damping_left;
+	stats.increases             = c.increases;
+	stats.decreases             = c.decreases;
+	stats.holds                 = c.holds;
+
+	const auto first = (c.history_next + CyclesHistorySize - c.history_size) %
+	                   CyclesHistorySize;
+	for (size_t i = 0; i < c.history_size; ++i) {
+		stats.history.push_back(c.history[(first + i) % CyclesHistorySize]);
+	}
+	return stats;
+}
+
 static void increase_ticks()
 {
 	// Make it return ticks.remain and set it in the function above to
@@ -206,6 +516,9 @@ static void increase_ticks()
 		const auto time_slept_us = GetTicksUsSince(ticks_new_us);
 		cumulative_time_slept_us += time_slept_us;
 
+		update_emulation_load(ticks_new_us + time_slept_us, time_slept_us);
+		update_wall_ms_per_tick(0);
+
 		// Update ticks.done with the total time spent sleeping
 		if (cumulative_time_slept_us >= MicrosInMillisecond) {
 			// 1 tick == 1 millisecond
@@ -235,10 +548,14 @@ static void increase_ticks()
 	}
 
 	// ticks_new > ticks.last
+	update_emulation_load(ticks_new_us, 0);
+
 	ticks.remain = GetTicksDiff(ticks_new, ticks.last);
 	ticks.last   = ticks_new;
 	ticks.done += ticks.remain;
 
+	update_wall_ms_per_tick(ticks.remain);
+
 	if (ticks.remain > 20) {
 #if 0
 		LOG(LOG_MISC,LOG_ERROR)("large remain %d", ticks.remain);
@@ -362,17 +679,8 @@ static void increase_ticks()
 			// heavy load through a different application, the
 			// cycles adjusting is skipped as well.
 			if ((ratio > 120) || (ticks.done < 700)) {
-				CPU_CycleMax = new_cycle_max;
-
-				if (CPU_CycleLimit > 0) {
-					if (CPU_CycleMax > CPU_CycleLimit) {
-						CPU_CycleMax = CPU_CycleLimit;
-					}
-				} else if (CPU_CycleMax > CpuCyclesMax) {
-					// Hardcoded limit if the limit wasn't
-					// explicitly specified.
-					CPU_CycleMax = CpuCyclesMax;
-				}
+				adjust_auto_cycles(limit_auto_cycles(new_cycle_max),
+				                   ratio);
 			}
 		}
 
@@ -385,11 +693,8 @@ static void increase_ticks()
 		// ticks.added > 15 but ticks.scheduled < 5, lower the cycles
 		// but do not reset the scheduled/done ticks to take them into
 		// account during the next auto cycle adjustment.
-		CPU_CycleMax /= 3;
-
-		if (CPU_CycleMax < auto_cpu_cycles_min) {
-			CPU_CycleMax = auto_cpu_cycles_min;
-		}
+		adjust_auto_cycles(std::max(CPU_CycleMax / 3, auto_cpu_cycles_min),
+		                   0);
 	}
 }
 
@@ -433,10 +738,19 @@ bool DOSBOX_IsShutdownRequested()
 	return is_shutdown_requested;
 }
 
+static bool is_fast_forwarding = false;
+
+bool DOSBOX_IsFastForwarding()
+{
+	return is_fast_forwarding;
+}
+
 static void DOSBOX_UnlockSpeed(bool pressed)
 {
 	static bool autoadjust = false;
 
+	is_fast_forwarding = pressed;
+
 	if (pressed) {
 		LOG_MSG("Fast Forward ON");
 		ticks.locked = true;
@@ -857,6 +1171,21 @@ static void add_dosbox_config_section(const ConfigPtr& conf)
 	        "might require a higher value. There is generally no speed advantage when raising\n"
 	        "this value.");
 
+	auto pbool = section->AddBool("memory_huge_pages", OnlyAtStart, false);
+	pbool->SetHelp(
+	        "Back the emulated memory with huge pages of the host to reduce the address\n"
+	        "translation misses of the host CPU ('off' by default). Mostly helps with a\n"
+	        "'memsize' of 64 MB or more together with the dynamic core or the Voodoo\n"
+	        "emulation. On Linux, reserved 2 MB pages are used if there are enough of them,\n"
+	        "otherwise transparent huge pages are requested. On Windows, the user needs the\n"
+	        "'Lock pages in memory' privilege. The log tells whether it took effect.");
+
+	pbool = section->AddBool("memory_lock", OnlyAtStart, false);
+	pbool->SetHelp(
+	        "Lock the emulated memory into the physical memory of the host so it's never\n"
+	        "swapped out, for latency-sensitive setups ('off' by default). On Linux and\n"
+	        "macOS, the locked memory limit ('ulimit -l') might need to be raised.");
+
 	pstring = section->AddString("mcb_fault_strategy", OnlyAtStart, "repair");
 	pstring->SetHelp(
 	        "How software-corrupted memory chain blocks should be handled ('repair' by\n"
@@ -959,7 +1288,7 @@ static void add_dosbox_config_section(const ConfigPtr& conf)
 	        "               modes available in this mode are often required by late '90s\n"
 	        "               demoscene productions.");
 
-	auto pbool = section->AddBool("vga_8dot_font", OnlyAtStart, false);
+	pbool = section->AddBool("vga_8dot_font", OnlyAtStart, false);
 	pbool->SetHelp("Use 8-pixel-wide fonts on VGA adapters ('off' by default).");
 
 	pbool = section->AddBool("vga_render_per_scanline", OnlyAtStart, true);
@@ -1103,62 +1432,81 @@ void DOSBOX_InitModuleConfigsAndMessages()
 	PROGRAMS_AddMessages();
 }
 
+// Logs how long each module takes to initialise, to find the ones that
+// slow down the startup
+template <typename InitFunction>
+static void timed_init(const char* name, InitFunction init_function)
+{
+	const auto start_us = GetTicksUs();
+	init_function();
+
+	constexpr auto MicrosInMilli = 1000.0;
+	LOG_DEBUG("STARTUP: %s took %.2f ms",
+	          name,
+	          static_cast<double>(GetTicksUsSince(start_us)) / MicrosInMilli);
+}
+
+#define TIMED_INIT(init_function) \
+	timed_init(#init_function, [] { init_function(); })
+
 void DOSBOX_InitModules()
 {
-	DOSBOX_Init();
+	TIMED_INIT(DOSBOX_Init);
 
 #if C_DEBUGGER
-	LOG_StartUp();
-	LOG_Init();
+	TIMED_INIT(LOG_StartUp);
+	TIMED_INIT(LOG_Init);
 #endif
 
-	COMPOSITE_Init();
+	TIMED_INIT(COMPOSITE_Init);
 
-	CPU_Init();
-	FPU_Init();
-	DMA_Init();
-	VGA_Init();
-	KEYBOARD_Init();
-	PCI_Init();
+	TIMED_INIT(CPU_Init);
+	TIMED_INIT(FPU_Init);
+	TIMED_INIT(DMA_Init);
+	TIMED_INIT(VGA_Init);
+	TIMED_INIT(KEYBOARD_Init);
+	TIMED_INIT(PCI_Init);
 
-	VOODOO_Init();
-	CAPTURE_Init();
+	TIMED_INIT(VOODOO_Init);
+	TIMED_INIT(CAPTURE_Init);
 
-	MIXER_Init();
-	MIDI_Init();
+	TIMED_INIT(MIXER_Init);
+	TIMED_INIT(MIDI_Init);
 
 #if C_DEBUGGER
-	DEBUG_Init();
+	TIMED_INIT(DEBUG_Init);
 #endif
 
-	SBLASTER_Init();
-	GUS_Init();
-	IMFC_Init();
-	INNOVATION_Init();
-	SPEAKER_Init();
+	TIMED_INIT(SBLASTER_Init);
+	TIMED_INIT(GUS_Init);
+	TIMED_INIT(IMFC_Init);
+	TIMED_INIT(INNOVATION_Init);
+	TIMED_INIT(SPEAKER_Init);
 
-	REELMAGIC_Init();
+	TIMED_INIT(REELMAGIC_Init);
 
-	BIOS_Init();
-	INT10_Init();
-	MOUSE_Init();
-	JOYSTICK_Init();
+	TIMED_INIT(BIOS_Init);
+	TIMED_INIT(INT10_Init);
+	TIMED_INIT(MOUSE_Init);
+	TIMED_INIT(JOYSTICK_Init);
 
-	DISKNOISE_Init();
-	SERIAL_Init();
-	DOS_Init();
+	TIMED_INIT(DISKNOISE_Init);
+	TIMED_INIT(SERIAL_Init);
+	TIMED_INIT(DOS_Init);
 
-	IPX_Init();
-	ETHERNET_Init();
-	VIRTUALBOX_Init();
-	VMWARE_Init();
-	WEBSERVER_Init();
+	TIMED_INIT(IPX_Init);
+	TIMED_INIT(ETHERNET_Init);
+	TIMED_INIT(VIRTUALBOX_Init);
+	TIMED_INIT(VMWARE_Init);
+	TIMED_INIT(WEBSERVER_Init);
+	TIMED_INIT(SNAPSHOT_Init);
 
-	AUTOEXEC_Init();
+	TIMED_INIT(AUTOEXEC_Init);
 }
 
 void DOSBOX_DestroyModules()
 {
+	SNAPSHOT_Destroy();
 	WEBSERVER_Destroy();
 	VMWARE_Destroy();
 	VIRTUALBOX_Destroy();
@@ -1187,6 +1535,7 @@ void DOSBOX_DestroyModules()
 	MIXER_Destroy();
 
 	CAPTURE_Destroy();
+	SHM_OUTPUT_Destroy();
 	VOODOO_Destroy();
 
 	PCI_Destroy();
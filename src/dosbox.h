@@ -12,6 +12,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 // Project name, lower-case and without spaces
 #define DOSBOX_PROJECT_NAME "dosbox-staging"
@@ -44,6 +45,9 @@ void DOSBOX_RequestShutdown();
 
 bool DOSBOX_IsShutdownRequested();
 
+// True while the fast-forward hotkey is held down
+bool DOSBOX_IsFastForwarding();
+
 // The E_Exit function throws an exception to quit. Call it in unexpected
 // circumstances.
 [[noreturn]] void E_Exit(const char *message, ...)
@@ -74,6 +78,58 @@ int64_t DOSBOX_GetTicksDone();
 void DOSBOX_SetTicksDone(const int64_t ticks_done);
 void DOSBOX_SetTicksScheduled(const int64_t ticks_scheduled);
 
+// Share of the wall time spent emulating rather than waiting, from 0.0 to
+// 1.0, measured over the last quarter second. Time the GFX subsystem spends
+// waiting (for the present, or in the frame delay) is reported as idle.
+void DOSBOX_AddIdleTime(const int64_t idle_us);
+float DOSBOX_GetEmulationLoad();
+
+// True if the emulation can't keep up with real time at the moment (not
+// while fast-forwarding)
+bool DOSBOX_IsFallingBehind();
+
+// One step of the automatic cycles adjustment ('cycles = max' and the
+// 'cycles = auto' protected mode setting)
+struct CyclesAdjustment {
+	int64_t time_ms      = 0;
+	int cycles_before    = 0;
+	int cycles_target    = 0;
+	int cycles_after     = 0;
+	int headroom_percent = 0;
+};
+
+struct CyclesAutoAdjustStats {
+	bool is_enabled           = false;
+	int cycles                = 0;
+	int increase_damping_left = 0;
+	uint64_t increases        = 0;
+	uint64_t decreases        = 0;
+	uint64_t holds            = 0;
+
+	// The most recent adjustments, oldest first
+	std::vector<CyclesAdjustment> history = {};
+};
+
+CyclesAutoAdjustStats DOSBOX_GetCyclesAutoAdjustStats();
+
+// Total number of cycles emulated since startup
+int64_t DOSBOX_GetEmulatedCycles();
+
+// Headless benchmark mode: the emulation runs unthrottled without polling
+// host events or presenting frames, and a report of the emulated MIPS, the
+// number of frames rendered and the wall time is printed after the given
+// number of emulated frames, then the emulator shuts down.
+void DOSBOX_StartBenchmark(const int num_frames);
+bool DOSBOX_IsBenchmarkRunning();
+
+// Called at the end of each emulated frame
+void DOSBOX_AddBenchmarkFrame();
+
+// Startup profile: logs the time since the process start at which the given
+// stage was first reached; also printed to stdout in benchmark mode, so
+// time-to-prompt can be tracked
+void DOSBOX_LogStartupTime(const char* stage);
+
 void DOSBOX_Restart();
 void DOSBOX_Restart(std::vector<std::string>& parameters);
 
@@ -176,6 +232,7 @@ constexpr auto DefaultSoundfontsDir      = "soundfonts";
 constexpr auto DefaultWebserverDir       = "webserver";
 constexpr auto DiskNoisesDir             = "disk-noises";
 constexpr auto PluginsDir                = "plugins";
+constexpr auto ShaderCacheDir            = "shader-cache";
 constexpr auto ShaderPresetsDir          = "shader-presets";
 constexpr auto ShadersDir                = "shaders";
 
@@ -74,6 +74,9 @@
 // Define to 1 to enable heavy debugging (requires C_DEBUGGER)
 #cmakedefine01 C_HEAVY_DEBUGGER
 
+// Define to 1 to compile in the trace points for timeline export
+#cmakedefine01 C_TRACING
+
 // Define to 1 to enable MT-32 emulator
 #cmakedefine01 C_MT32EMU
 
@@ -131,6 +134,9 @@
 // Defined if mmap flag MAPJIT is available
 #cmakedefine HAVE_MAP_JIT
 
+// Defined if function memfd_create is available
+#cmakedefine HAVE_MEMFD_CREATE
+
 // Defined if function pthread_jit_write_protect_np is available
 #cmakedefine HAVE_PTHREAD_WRITE_PROTECT_NP
 
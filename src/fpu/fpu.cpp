@@ -7,10 +7,13 @@
 #include "misc/cross.h"
 #include "fpu/fpu.h"
 #include "hardware/memory.h"
+#include "hardware/snapshot.h"
 #include <cmath>
 
 FPU_rec fpu = {};
 
+bool fpu_state_changed = true;
+
 void FPU_FLDCW(PhysPt addr){
 	uint16_t temp = mem_readw(addr);
 	FPU_SetCW(temp);
@@ -606,4 +609,13 @@ void FPU_Init()
 	LOG_WARNING("FPU: Using reduced-precision floating-point emulation");
 #endif
 	FPU_FINIT();
+	fpu_state_changed = true;
+
+	SNAPSHOT_AddComponent("fpu", [] {
+		const auto state = fpu;
+		return [=] {
+			fpu               = state;
+			fpu_state_changed = true;
+		};
+	});
 }
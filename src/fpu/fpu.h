@@ -110,6 +110,10 @@ struct FPU_rec {
 
 extern FPU_rec fpu;
 
+// Set when an interpreter core changes the FPU state; the dyn_x86 core only
+// copies the state into its host FPU image when this is set
+extern bool fpu_state_changed;
+
 #define TOP fpu.top
 #define STV(i)  ( (fpu.top+ (i) ) & 7 )
 
@@ -181,6 +185,20 @@ static inline void FPU_SET_C3(bool C)
 	fpu.sw = (fpu.sw & ~0x4000u) | (C * 0x4000u);
 }
 
+constexpr uint16_t FpuC0 = 0x0100;
+constexpr uint16_t FpuC1 = 0x0200;
+constexpr uint16_t FpuC2 = 0x0400;
+constexpr uint16_t FpuC3 = 0x4000;
+
+constexpr uint16_t FpuConditionCodes = FpuC0 | FpuC1 | FpuC2 | FpuC3;
+
+// Replaces all four condition code flags with a single status word update;
+// 'codes' is a combination of the FpuC0..FpuC3 bits that are set
+static inline void FPU_SetConditionCodes(const uint16_t codes)
+{
+	fpu.sw = (fpu.sw & ~FpuConditionCodes) | (codes & FpuConditionCodes);
+}
+
 static inline void FPU_LOG_WARN(unsigned tree, bool ea, uintptr_t group, uintptr_t sub)
 {
 	LOG(LOG_FPU, LOG_WARN)("ESC %u%s: Unhandled group %" PRIuPTR " subfunction %" PRIuPTR,
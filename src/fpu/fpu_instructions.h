@@ -6,6 +6,7 @@
 #endif
 
 #include "utils/math_utils.h"
+#include <algorithm>
 #include <bit>
 
 static constexpr uint16_t PrecisionModeMask = 0x0300;
@@ -23,14 +24,7 @@ static void FPU_FINIT(void)
 	FPU_SetCW(0x37F);
 	fpu.sw = 0;
 	TOP=FPU_GET_TOP();
-	fpu.tags[0] = TAG_Empty;
-	fpu.tags[1] = TAG_Empty;
-	fpu.tags[2] = TAG_Empty;
-	fpu.tags[3] = TAG_Empty;
-	fpu.tags[4] = TAG_Empty;
-	fpu.tags[5] = TAG_Empty;
-	fpu.tags[6] = TAG_Empty;
-	fpu.tags[7] = TAG_Empty;
+	std::fill_n(fpu.tags, 8, TAG_Empty);
 	fpu.tags[8] = TAG_Valid; // is only used by us
 }
 
@@ -636,29 +630,26 @@ static void FPU_FCOM(Bitu st, Bitu other){
 	C0, C2, C3 See table.
 	*/
 
-	FPU_SET_C1(0);
+	constexpr uint16_t Unordered = FpuC3 | FpuC2 | FpuC0;
 
-	if (((fpu.tags[st] != TAG_Valid) && (fpu.tags[st] != TAG_Zero)) ||
-	    ((fpu.tags[other] != TAG_Valid) && (fpu.tags[other] != TAG_Zero))) {
-		FPU_SET_C3(1);
-		FPU_SET_C2(1);
-		FPU_SET_C0(1);
+	// Only valid and zero tags (0 and 1) hold comparable values
+	static_assert(TAG_Valid == 0 && TAG_Zero == 1);
+	if ((fpu.tags[st] | fpu.tags[other]) > TAG_Zero) {
+		FPU_SetConditionCodes(Unordered);
 		return;
 	}
 
 	if (std::isunordered(a, b)) {
 		fpu.sw |= InvalidArithmeticFlag;
 		if (fpu.cw & InvalidArithmeticFlag) {
-			FPU_SET_C3(1);
-			FPU_SET_C2(1);
-			FPU_SET_C0(1);
+			FPU_SetConditionCodes(Unordered);
+		} else {
+			FPU_SET_C1(0);
 		}
 		return;
 	}
 
-	FPU_SET_C3(a == b);
-	FPU_SET_C2(0);
-	FPU_SET_C0(a < b);
+	FPU_SetConditionCodes((a == b ? FpuC3 : 0) | (a < b ? FpuC0 : 0));
 }
 
 static void FPU_FUCOM(Bitu st, Bitu other){
@@ -695,10 +686,9 @@ static void FPU_FPREM(void)
 	const auto q    = static_cast<int64_t>(st0 / st1);
 	fpu.regs[TOP].d = std::fmod(st0, st1);
 
-	FPU_SET_C0((q >> 2) & 1);
-	FPU_SET_C3((q >> 1) & 1);
-	FPU_SET_C1(q & 1);
-	FPU_SET_C2(0);
+	// The three low bits of the quotient
+	FPU_SetConditionCodes(((q & 4) ? FpuC0 : 0) | ((q & 2) ? FpuC3 : 0) |
+	                      ((q & 1) ? FpuC1 : 0));
 }
 
 static void FPU_FPREM1(void)
@@ -716,62 +706,31 @@ static void FPU_FPREM1(void)
 	const auto q    = static_cast<int64_t>(std::nearbyint(st0 / st1));
 	fpu.regs[TOP].d = std::remainder(st0, st1);
 
-	FPU_SET_C0((q >> 2) & 1);
-	FPU_SET_C3((q >> 1) & 1);
-	FPU_SET_C1(q & 1);
-	FPU_SET_C2(0);
+	// The three low bits of the quotient
+	FPU_SetConditionCodes(((q & 4) ? FpuC0 : 0) | ((q & 2) ? FpuC3 : 0) |
+	                      ((q & 1) ? FpuC1 : 0));
 }
 
 static void FPU_FXAM(void)
 {
 	const auto st0 = fpu.regs[TOP].d;
 
-	FPU_SET_C1(std::signbit(st0));
+	const uint16_t sign = std::signbit(st0) ? FpuC1 : 0;
 
 	if (fpu.tags[TOP] == TAG_Empty) {
-		FPU_SET_C3(1);
-		FPU_SET_C2(0);
-		FPU_SET_C0(1);
+		FPU_SetConditionCodes(sign | FpuC3 | FpuC0);
 		return;
 	}
 
 	switch (std::fpclassify(st0)) {
-	case FP_NORMAL:
-		FPU_SET_C3(0);
-		FPU_SET_C2(1);
-		FPU_SET_C0(0);
-		break;
-
-	case FP_ZERO:
-		FPU_SET_C3(1);
-		FPU_SET_C2(0);
-		FPU_SET_C0(0);
-		break;
-
-	case FP_NAN:
-		FPU_SET_C3(0);
-		FPU_SET_C2(0);
-		FPU_SET_C0(1);
-		break;
-
-	case FP_INFINITE:
-		FPU_SET_C3(0);
-		FPU_SET_C2(1);
-		FPU_SET_C0(1);
-		break;
-
-	case FP_SUBNORMAL:
-		FPU_SET_C3(1);
-		FPU_SET_C2(1);
-		FPU_SET_C0(0);
-		break;
+	case FP_NORMAL: FPU_SetConditionCodes(sign | FpuC2); break;
+	case FP_ZERO: FPU_SetConditionCodes(sign | FpuC3); break;
+	case FP_NAN: FPU_SetConditionCodes(sign | FpuC0); break;
+	case FP_INFINITE: FPU_SetConditionCodes(sign | FpuC2 | FpuC0); break;
+	case FP_SUBNORMAL: FPU_SetConditionCodes(sign | FpuC3 | FpuC2); break;
 
 	// Unsupported
-	default:
-		FPU_SET_C3(0);
-		FPU_SET_C2(0);
-		FPU_SET_C0(0);
-		break;
+	default: FPU_SetConditionCodes(sign); break;
 	}
 }
 
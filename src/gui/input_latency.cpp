@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gui/input_latency.h"
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include "dosbox.h"
+#include "hardware/timer.h"
+
+// Enough for hours of interactive use; the later samples are not recorded
+constexpr size_t MaxSamples = 100'000;
+
+struct LatencySample {
+	int64_t to_frame_us   = 0;
+	int64_t to_present_us = 0;
+};
+
+static struct {
+	bool is_enabled = false;
+
+	// Earliest input still waiting for a changed frame
+	std::optional<int64_t> input_us = {};
+
+	// Input whose reaction frame has been rendered but not presented yet
+	std::optional<int64_t> reacted_input_us = {};
+	int64_t reaction_frame_us               = 0;
+
+	std::vector<LatencySample> samples = {};
+} latency = {};
+
+void INPUT_LATENCY_SetEnabled(const bool enabled)
+{
+	if (enabled && !latency.is_enabled) {
+		latency.input_us.reset();
+		latency.reacted_input_us.reset();
+		latency.samples.clear();
+	}
+	latency.is_enabled = enabled;
+}
+
+bool INPUT_LATENCY_IsEnabled()
+{
+	return latency.is_enabled;
+}
+
+void INPUT_LATENCY_NotifyInput()
+{
+	if (latency.is_enabled && !latency.input_us) {
+		latency.input_us = GetTicksUs();
+	}
+}
+
+void INPUT_LATENCY_NotifyFrameChanged()
+{
+	if (!latency.is_enabled || !latency.input_us) {
+		return;
+	}
+	// A reaction that hasn't been presented yet is superseded by the newer
+	// frame; it gets presented with it
+	if (!latency.reacted_input_us) {
+		latency.reacted_input_us  = latency.input_us;
+		latency.reaction_frame_us = GetTicksUs();
+	}
+	latency.input_us.reset();
+}
+
+void INPUT_LATENCY_NotifyFramePresented()
+{
+	if (!latency.is_enabled || !latency.reacted_input_us) {
+		return;
+	}
+
+	const auto input_us = *latency.reacted_input_us;
+	latency.reacted_input_us.reset();
+
+	if (latency.samples.size() < MaxSamples) {
+		latency.samples.push_back({latency.reaction_frame_us - input_us,
+		                           GetTicksUs() - input_us});
+	}
+}
+
+static InputLatencyPercentiles get_percentiles(std::vector<int64_t> values)
+{
+	if (values.empty()) {
+		return {};
+	}
+	std::sort(values.begin(), values.end());
+
+	auto at = [&](const size_t percent) {
+		return values[(values.size() - 1) * percent / 100];
+	};
+	return {values.front(), at(50), at(90), at(99), values.back()};
+}
+
+InputLatencyStats INPUT_LATENCY_GetStats()
+{
+	std::vector<int64_t> to_frame   = {};
+	std::vector<int64_t> to_present = {};
+
+	for (const auto& sample : latency.samples) {
+		to_frame.push_back(sample.to_frame_us);
+		to_present.push_back(sample.to_present_us);
+	}
+
+	return {latency.samples.size(),
+	        get_percentiles(std::move(to_frame)),
+	        get_percentiles(std::move(to_present))};
+}
+
+static void log_percentiles(const char* name, const InputLatencyPercentiles& p)
+{
+	constexpr auto ToMs = 0.001;
+
+	LOG_MSG("LATENCY:   %-10s  %6.2f  %6.2f  %6.2f  %6.2f  %6.2f",
+	        name,
+	        static_cast<double>(p.min_us) * ToMs,
+	        static_cast<double>(p.median_us) * ToMs,
+	        static_cast<double>(p.p90_us) * ToMs,
+	        static_cast<double>(p.p99_us) * ToMs,
+	        static_cast<double>(p.max_us) * ToMs);
+}
+
+void INPUT_LATENCY_LogReport()
+{
+	const auto stats = INPUT_LATENCY_GetStats();
+	if (stats.num_samples == 0) {
+		LOG_MSG("LATENCY: No input has been followed by a frame change");
+		return;
+	}
+
+	LOG_MSG("LATENCY: Input latency of %zu inputs, in milliseconds",
+	        stats.num_samples);
+	LOG_MSG("LATENCY:   input to       min  median     p90     p99     max");
+
+	log_percentiles("frame", stats.to_frame);
+	log_percentiles("present", stats.to_present);
+}
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_INPUT_LATENCY_H
+#define DOSBOX_INPUT_LATENCY_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Input-to-photon latency measurement.
+//
+// While enabled, the arrival of a key press, mouse button press, or wheel
+// event from the host is timestamped. The next emulated frame whose contents
+// changed is taken as the guest's reaction to it, and the time at which that
+// frame is handed over to the host's presentation (the swap or present call
+// of the render backend) completes the sample. The display's own latency
+// after that is not included.
+//
+// Only the earliest input waiting for a reaction is tracked, and frames that
+// change without any input (animations, blinking cursors) are attributed to
+// the pending input, so the measurement is meant for static screens that
+// only change in response to the input, e.g. a text editor or a menu.
+
+struct InputLatencyPercentiles {
+	int64_t min_us    = 0;
+	int64_t median_us = 0;
+	int64_t p90_us    = 0;
+	int64_t p99_us    = 0;
+	int64_t max_us    = 0;
+};
+
+struct InputLatencyStats {
+	size_t num_samples = 0;
+
+	// From the input event to the end of the emulated frame that changed
+	// in response, i.e. the emulation's and the guest's share
+	InputLatencyPercentiles to_frame = {};
+
+	// From the input event to the presentation of that frame, which adds
+	// the wait for the present and the vsync
+	InputLatencyPercentiles to_present = {};
+};
+
+// Enabling discards the samples of the previous measurement
+void INPUT_LATENCY_SetEnabled(const bool enabled);
+bool INPUT_LATENCY_IsEnabled();
+
+// Called by the GFX subsystem for input events from the host, for frames
+// whose contents changed, and after presenting a frame
+void INPUT_LATENCY_NotifyInput();
+void INPUT_LATENCY_NotifyFrameChanged();
+void INPUT_LATENCY_NotifyFramePresented();
+
+InputLatencyStats INPUT_LATENCY_GetStats();
+
+void INPUT_LATENCY_LogReport();
+
+#endif // DOSBOX_INPUT_LATENCY_H
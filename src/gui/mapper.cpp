@@ -27,6 +27,7 @@
 #include "hardware/input/mouse.h"
 #include "hardware/pic.h"
 #include "hardware/timer.h"
+#include "ints/bios.h"
 #include "misc/video.h"
 #include "utils/math_utils.h"
 #include "utils/rgb888.h"
@@ -1210,11 +1211,81 @@ static void auto_type_queued_button(uint32_t type_action_value)
 	}
 }
 
+// Adds a pair of PIC-timed press and release events for a queued button,
+// starting after the given delay, which is advanced past the release
+static void schedule_queued_button(uint32_t& running_delay_ms)
+{
+	PIC_AddEvent(auto_type_queued_button,
+	             running_delay_ms,
+	             static_cast<uint32_t>(TypeAction::Press));
+
+	constexpr auto ReleaseDelayMs = 50;
+	running_delay_ms += ReleaseDelayMs;
+
+	PIC_AddEvent(auto_type_queued_button,
+	             running_delay_ms,
+	             static_cast<uint32_t>(TypeAction::Release));
+}
+
+// The pace the fast mode falls back to if the guest reads the keyboard port
+// itself
+static uint32_t auto_type_fallback_pace_ms = 0;
+
+static bool is_auto_typing_fast = false;
+
+// Types the queued buttons in fast mode as soon as the guest has taken the
+// previous one. The keys still pass through the keyboard and the 8042
+// controller, so the BIOS translates them with the loaded keyboard layout;
+// typing is only paced by the emulated hardware and the BIOS keyboard
+// buffer having room for the next key.
+static void auto_type_fast(uint32_t /*val*/)
+{
+	if (auto_type_queue.empty()) {
+		is_auto_typing_fast = false;
+		return;
+	}
+
+	// Programs reading port 60h directly might miss the keys typed at
+	// this rate, so type the rest with the regular delays
+	if (BIOS_IsKeyboardIrqHooked()) {
+		uint32_t running_delay_ms = auto_type_fallback_pace_ms;
+		for (size_t i = 0; i < auto_type_queue.size(); ++i) {
+			schedule_queued_button(running_delay_ms);
+			running_delay_ms += auto_type_fallback_pace_ms;
+		}
+		is_auto_typing_fast = false;
+		return;
+	}
+
+	if (KEYBOARD_IsIdle() && !BIOS_IsKeyboardBufferFull()) {
+		auto_type_queued_button(static_cast<uint32_t>(TypeAction::Press));
+		auto_type_queued_button(static_cast<uint32_t>(TypeAction::Release));
+	}
+
+	constexpr auto PollIntervalMs = 1.0;
+	PIC_AddEvent(auto_type_fast, PollIntervalMs);
+}
+
 // Add each of the given buttons with a corresponding pair of press and release
 // PIC-timed events delayed into the future based on the given wait and pace times.
+// In fast mode, the buttons are typed as fast as the guest takes them instead.
 void MAPPER_AutoType(std::vector<std::string>& buttons, uint32_t wait_ms,
-                     uint32_t pace_ms)
+                     uint32_t pace_ms, const bool is_fast)
 {
+	if (is_fast) {
+		for (auto& button : buttons) {
+			if (button != ",") {
+				auto_type_queue.emplace(button);
+			}
+		}
+		auto_type_fallback_pace_ms = pace_ms;
+		if (!is_auto_typing_fast) {
+			is_auto_typing_fast = true;
+			PIC_AddEvent(auto_type_fast, wait_ms);
+		}
+		return;
+	}
+
 	uint32_t running_delay_ms = wait_ms;
 
 	for (auto& button : buttons) {
@@ -1222,17 +1293,7 @@ void MAPPER_AutoType(std::vector<std::string>& buttons, uint32_t wait_ms,
 			running_delay_ms += pace_ms;
 		} else {
 			auto_type_queue.emplace(button);
-
-			PIC_AddEvent(auto_type_queued_button,
-			             running_delay_ms,
-			             static_cast<uint32_t>(TypeAction::Press));
-
-			constexpr auto ReleaseDelayMs = 50;
-			running_delay_ms += ReleaseDelayMs;
-
-			PIC_AddEvent(auto_type_queued_button,
-			             running_delay_ms,
-			             static_cast<uint32_t>(TypeAction::Release));
+			schedule_queued_button(running_delay_ms);
 		}
 		running_delay_ms += pace_ms;
 	}
@@ -1242,6 +1303,8 @@ static void stop_auto_typing()
 {
 	auto_type_queue = {};
 	PIC_RemoveEvents(auto_type_queued_button);
+	PIC_RemoveEvents(auto_type_fast);
+	is_auto_typing_fast = false;
 }
 
 static struct CMapper {
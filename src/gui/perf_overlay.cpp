@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gui/perf_overlay.h"
+
+#include <algorithm>
+
+#include "audio/mixer.h"
+#include "cpu/cpu.h"
+#include "dosbox.h"
+#include "hardware/timer.h"
+#include "hardware/video/voodoo.h"
+#include "utils/checks.h"
+#include "utils/string_utils.h"
+
+CHECK_NARROWING();
+
+static struct {
+	bool is_enabled = false;
+
+	// Start of the current measurement window
+	int64_t window_start_us = 0;
+
+	// Accumulated over the window
+	int num_frames_rendered  = 0;
+	int num_frames_presented = 0;
+	int64_t render_us        = 0;
+	int64_t present_us       = 0;
+
+	// Totals at the start of the window
+	int64_t emulated_cycles  = 0;
+	int64_t output_underruns = 0;
+	uint64_t cache_flushes   = 0;
+	int64_t num_triangles    = 0;
+} perf = {};
+
+static void start_window()
+{
+	perf.window_start_us = GetTicksUs();
+
+	perf.num_frames_rendered  = 0;
+	perf.num_frames_presented = 0;
+	perf.render_us            = 0;
+	perf.present_us           = 0;
+
+	perf.emulated_cycles  = DOSBOX_GetEmulatedCycles();
+	perf.output_underruns = MIXER_GetStats().output_underruns;
+	perf.cache_flushes    = CPU_GetDynCacheStats().flushes;
+	perf.num_triangles    = VOODOO_GetNumTrianglesDrawn();
+}
+
+void PERF_OVERLAY_SetEnabled(const bool enabled)
+{
+	if (enabled && !perf.is_enabled) {
+		start_window();
+	}
+	perf.is_enabled = enabled;
+}
+
+bool PERF_OVERLAY_IsEnabled()
+{
+	return perf.is_enabled;
+}
+
+void PERF_OVERLAY_NotifyFrameRendered(const int64_t render_us)
+{
+	if (perf.is_enabled) {
+		++perf.num_frames_rendered;
+		perf.render_us += render_us;
+	}
+}
+
+void PERF_OVERLAY_NotifyFramePresented(const int64_t present_us)
+{
+	if (perf.is_enabled) {
+		++perf.num_frames_presented;
+		perf.present_us += present_us;
+	}
+}
+
+std::string PERF_OVERLAY_Sample()
+{
+	const auto window_us = std::max(GetTicksUsSince(perf.window_start_us),
+	                                static_cast<int64_t>(1));
+
+	const auto window_s = static_cast<double>(window_us) / 1'000'000.0;
+
+	constexpr auto ToMs = 0.001;
+
+	auto per_frame_ms = [&](const int64_t total_us, const int num_frames) {
+		return num_frames > 0 ? static_cast<double>(total_us) * ToMs / num_frames
+		                      : 0.0;
+	};
+
+	// One emulated cycle roughly corresponds to one emulated instruction
+	const auto cycles = DOSBOX_GetEmulatedCycles() - perf.emulated_cycles;
+	const auto mips = static_cast<double>(cycles) / static_cast<double>(window_us);
+
+	const auto fps = perf.num_frames_presented / window_s;
+
+	// Presenting (including the pacing wait) counts as idle time, so the
+	// busy share of a frame is emulating and rendering it
+	const auto frame_ms   = fps > 0.0 ? 1000.0 / fps : 0.0;
+	const auto render_ms  = per_frame_ms(perf.render_us, perf.num_frames_rendered);
+	const auto present_ms = per_frame_ms(perf.present_us, perf.num_frames_presented);
+	const auto emulate_ms = std::max(frame_ms * DOSBOX_GetEmulationLoad() - render_ms,
+	                                 0.0);
+
+	auto str = format_str("%.1f MIPS (%s), %.1f FPS, frame %.1f ms "
+	                      "(emu %.1f, render %.1f, present %.1f)",
+	                      mips,
+	                      CPU_GetCyclesConfigAsString().c_str(),
+	                      fps,
+	                      frame_ms,
+	                      emulate_ms,
+	                      render_ms,
+	                      present_ms);
+
+	const auto mixer_stats = MIXER_GetStats();
+	str += format_str(", audio %d%% %lld xruns",
+	                  static_cast<int>(mixer_stats.output_queue_percent_full),
+	                  static_cast<long long>(mixer_stats.output_underruns -
+	                                         perf.output_underruns));
+
+	if (const auto cache_stats = CPU_GetDynCacheStats(); cache_stats.is_available) {
+		const auto used_percent = 100.0 * static_cast<double>(cache_stats.used_bytes) /
+		                          static_cast<double>(cache_stats.size_bytes);
+
+		str += format_str(", dyncache %d%% %llu flushes",
+		                  static_cast<int>(used_percent),
+		                  static_cast<unsigned long long>(cache_stats.flushes -
+		                                                  perf.cache_flushes));
+	}
+
+	const auto num_triangles = VOODOO_GetNumTrianglesDrawn() - perf.num_triangles;
+	if (num_triangles > 0) {
+		str += format_str(", Voodoo %.1fk tri/s",
+		                  static_cast<double>(num_triangles) / window_s / 1000.0);
+	}
+
+	start_window();
+	return str;
+}
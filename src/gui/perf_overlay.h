@@ -0,0 +1,34 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_PERF_OVERLAY_H
+#define DOSBOX_PERF_OVERLAY_H
+
+#include <cstdint>
+#include <string>
+
+// Live performance counters shown in the window's titlebar.
+//
+// While enabled, the titlebar is refreshed once per second with the rates
+// and averages measured over the past second: the emulated MIPS and cycles
+// setting, the frame rate and the frame time split into emulation,
+// rendering and presentation, the fill level and underruns of the audio
+// output queue, the usage and flushes of the dynamic core's code cache, and
+// the Voodoo triangle rate.
+//
+// Toggled with the 'perfstats' hotkey or the 'perf' 'window_titlebar'
+// setting; the counters are read on the main thread only.
+
+void PERF_OVERLAY_SetEnabled(const bool enabled);
+bool PERF_OVERLAY_IsEnabled();
+
+// Called by the render and GFX subsystems with the time spent finishing a
+// rendered frame and presenting it
+void PERF_OVERLAY_NotifyFrameRendered(const int64_t render_us);
+void PERF_OVERLAY_NotifyFramePresented(const int64_t present_us);
+
+// Returns the counters measured since the previous call as a single line,
+// and starts a new measurement window
+std::string PERF_OVERLAY_Sample();
+
+#endif // DOSBOX_PERF_OVERLAY_H
@@ -4,6 +4,9 @@
 #ifndef DOSBOX_GUI_PRIVATE_COMMON_H
 #define DOSBOX_GUI_PRIVATE_COMMON_H
 
+#include <span>
+#include <vector>
+
 #include "dosbox_config.h"
 #include "misc/video.h"
 #include "utils/fraction.h"
@@ -93,13 +96,32 @@ void GFX_ResetScreen();
 void GFX_Start();
 void GFX_Stop();
 
+// Requests the frames of paletted video modes as 8-bit palette indexes, with
+// the palette lookup done by the render backend. Returns false if the render
+// backend can't do the lookup; the frames are then 32-bit pixels. Must be
+// followed by a `GFX_SetSize()` call.
+bool GFX_SetIndexedFrames(const bool is_enabled);
+
+// Sets the palette of indexed frames, as pixels made by `GFX_MakePixel()`.
+// Applies to the frames ended after the call.
+void GFX_SetPalette(std::span<const uint32_t> lut);
+
 // Called at the start of every unique frame (when there have been changes to
 // the framebuffer).
 bool GFX_StartUpdate(uint32_t*& pixels, int& pitch);
 
+// A range of framebuffer rows that have changed in the current frame
+struct DirtyRowRange {
+	int first_row = 0;
+	int num_rows  = 0;
+};
+
 // Called at the end of every frame, regardless of whether there have been
 // changes to the framebuffer or not.
-void GFX_EndUpdate();
+//
+// `dirty_rows` lists the rows written since `GFX_StartUpdate()`; an empty
+// list means any row might have changed.
+void GFX_EndUpdate(const std::vector<DirtyRowRange>& dirty_rows = {});
 
 void GFX_CaptureRenderedImage();
 
@@ -114,6 +136,7 @@ SDL_Rect to_sdl_rect(const DosBox::Rect& r);
 
 enum class DosBoxSdlEvent {
 	RefreshAnimatedTitle,
+	RefreshPerfStats,
 	NumEvents // dummy, keep last, do not use
 };
 
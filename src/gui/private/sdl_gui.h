@@ -156,6 +156,17 @@ struct SDL_Block {
 		int frame_time_us            = 0;
 		int early_present_window_us  = 0;
 		int64_t last_present_time_us = 0;
+
+		// In 'vrr' mode, the 'dos-rate' presents are paced to the
+		// emulated refresh rate
+		bool is_vrr_paced             = false;
+		int64_t next_paced_present_us = 0;
+
+		// Time the emulation is held back after presenting a frame in
+		// 'host-rate' mode (see the 'frame_delay' setting)
+		bool is_frame_delay_auto = false;
+		int frame_delay_us       = 0;
+		int frame_delay_holdoff  = 0;
 	} presentation = {};
 
 	struct {
@@ -14,6 +14,7 @@
 
 #include "gui/render/render.h"
 #include "hardware/video/vga.h"
+#include "utils/fs_utils.h"
 #include "utils/rect.h"
 
 namespace SymbolicShaderName {
@@ -292,6 +293,20 @@ private:
 	ShaderDescriptor GetEgaShader() const;
 	ShaderDescriptor GetVgaShader() const;
 
+	const std::vector<std_fs::path>& GetShaderFiles(const std_fs::path& dir) const;
+
+	// Listing of a shader directory, stamped with the modification times
+	// of the directory and all its subdirectories. Adding, removing, or
+	// renaming a shader bumps the time of the directory holding it.
+	struct ShaderDirListing {
+		std::vector<std::pair<std_fs::path, std_fs::file_time_type>> stamps = {};
+		std::vector<std_fs::path> shaders = {};
+	};
+
+	// Shader directories are only walked when the inventory is asked for,
+	// and walked again only if they changed since
+	mutable std::unordered_map<std::string, ShaderDirListing> shader_listings = {};
+
 	ShaderDescriptor last_shader_descriptor = {};
 	ShaderMode current_shader_mode          = {};
 
@@ -5,6 +5,7 @@
 
 #include <vector>
 
+#include "gui/render/private/deinterlacer_kernels.h"
 #include "gui/render/render.h"
 #include "misc/image_decoder.h"
 #include "utils/checks.h"
@@ -69,51 +70,15 @@ void Deinterlacer::ThresholdInput(const uint32_t* src, bit_buffer& dest,
 	auto out_line = dest.data() + BufferOffset + buffer_pitch;
 
 	for (auto y = 0; y < image.height; ++y) {
-		auto in  = in_line;
-		auto out = out_line;
-
-		for (auto x = 0; x < image.width / PixelsPerBitBufferElement; ++x) {
-			uint64_t out_buf = 0;
-
-			// Build the 64-bit mask 8 pixels at a time to reduce
-			// loop overhead.
-			for (auto n = 0; n < 8; ++n) {
-				// Make sure the alpha component is set to zero
-				constexpr auto mask = 0x00ffffff;
-
-				const auto a1 = in[0] & mask;
-				const auto a2 = in[1] & mask;
-				const auto a3 = in[2] & mask;
-				const auto a4 = in[3] & mask;
-				const auto a5 = in[4] & mask;
-				const auto a6 = in[5] & mask;
-				const auto a7 = in[6] & mask;
-				const auto a8 = in[7] & mask;
-
-				in += 8;
-
-				// Non-black pixels are set to 1 in the bit
-				// mask. We convert the pixels by row, top to
-				// down, left to right. When converting the
-				// first 64 pixels of a row, the LSB of the mask
-				// uint64_t is the first pixel, and the MSB is
-				// the 64th pixel.
-				//
-				const uint8_t bits =
-				        static_cast<uint8_t>(((a1 != bg_color) << 0)) |
-				        static_cast<uint8_t>(((a2 != bg_color) << 1)) |
-				        static_cast<uint8_t>(((a3 != bg_color) << 2)) |
-				        static_cast<uint8_t>(((a4 != bg_color) << 3)) |
-				        static_cast<uint8_t>(((a5 != bg_color) << 4)) |
-				        static_cast<uint8_t>(((a6 != bg_color) << 5)) |
-				        static_cast<uint8_t>(((a7 != bg_color) << 6)) |
-				        static_cast<uint8_t>(((a8 != bg_color) << 7));
-
-				out_buf |= static_cast<uint64_t>(bits) << (n * 8);
-			}
-			*out = out_buf;
-			++out;
-		}
+		// Non-black pixels are set to 1 in the bit mask. We convert the
+		// pixels by row, top to down, left to right. When converting the
+		// first 64 pixels of a row, the LSB of the mask uint64_t is the
+		// first pixel, and the MSB is the 64th pixel.
+		//
+		threshold_row(in_line,
+		              bg_color,
+		              out_line,
+		              image.width / PixelsPerBitBufferElement);
 
 		in_line += image.pitch_pixels;
 		out_line += buffer_pitch;
@@ -147,51 +112,25 @@ void Deinterlacer::DownshiftAndXor(bit_buffer& src, bit_buffer& dest) const
 
 void Deinterlacer::ErodeHorizontal(bit_buffer& src, bit_buffer& dest) const
 {
-	auto in_line  = src.begin() + buffer_pitch;
-	auto out_line = dest.begin() + buffer_pitch;
-
-	for (auto y = 0; y < image.height; ++y) {
-		auto in  = in_line;
-		auto out = out_line;
-
-		// We process the input horizontally in 64-pixel chunks.
-		// This is the layout of a single chunk in an uint64_t:
-		//
-		//    bits         pixels
-		//
-		//    0-7    pixels N    to N+7
-		//    8-15   pixels N+8  to N+15
-		//   16-23   pixels N+16 to N+23
-		//    ...            ...
-		//   48-55   pixels N+48 to N+55
-		//   56-63   pixels N+56 to N+63
-		//
-		uint64_t curr = *in++;
-		uint64_t prev = 0;
-
-		for (auto x = 0; x < image.width / PixelsPerBitBufferElement + 1;
-		     ++x) {
-
-			const auto next = *in;
-			++in;
+	auto in_line  = src.data() + buffer_pitch;
+	auto out_line = dest.data() + buffer_pitch;
 
-			// Shift in the last pixel of the previous chunk from
-			// the right
-			const auto prev_pixel63 =
-			        (prev & (static_cast<uint64_t>(1) << 63)) >> 63;
-
-			const auto left_neighbours = (curr << 1) | prev_pixel63;
-
-			// Shift in the first pixel of the next chunk from the left
-			const auto next_pixel1      = (next & 1) << 63;
-			const auto right_neighbours = next_pixel1 | curr >> 1;
-
-			*out = left_neighbours & curr & right_neighbours;
-			++out;
+	// We process the input horizontally in 64-pixel chunks.
+	// This is the layout of a single chunk in an uint64_t:
+	//
+	//    bits         pixels
+	//
+	//    0-7    pixels N    to N+7
+	//    8-15   pixels N+8  to N+15
+	//   16-23   pixels N+16 to N+23
+	//    ...            ...
+	//   48-55   pixels N+48 to N+55
+	//   56-63   pixels N+56 to N+63
+	//
+	const auto num_chunks = image.width / PixelsPerBitBufferElement + 1;
 
-			prev = curr;
-			curr = next;
-		}
+	for (auto y = 0; y < image.height; ++y) {
+		erode_row_horizontal(in_line, out_line, num_chunks);
 
 		in_line += buffer_pitch;
 		out_line += buffer_pitch;
@@ -200,23 +139,17 @@ void Deinterlacer::ErodeHorizontal(bit_buffer& src, bit_buffer& dest) const
 
 void Deinterlacer::ErodeVertical(bit_buffer& src, bit_buffer& dest) const
 {
-	auto in_line  = src.begin() + BufferOffset + buffer_pitch;
-	auto out_line = dest.begin() + BufferOffset + buffer_pitch;
-
-	for (auto y = 0; y < image.height; ++y) {
-		auto in  = in_line;
-		auto out = out_line;
-
-		for (auto x = 0; x < image.width / PixelsPerBitBufferElement; ++x) {
-			const auto prev = *(in - buffer_pitch);
-			const auto curr = *in;
-			const auto next = *(in + buffer_pitch);
+	auto in_line  = src.data() + BufferOffset + buffer_pitch;
+	auto out_line = dest.data() + BufferOffset + buffer_pitch;
 
-			*out = prev & curr & next;
+	const auto num_chunks = image.width / PixelsPerBitBufferElement;
 
-			++in;
-			++out;
-		}
+	for (auto y = 0; y < image.height; ++y) {
+		erode_row_vertical(in_line - buffer_pitch,
+		                   in_line,
+		                   in_line + buffer_pitch,
+		                   out_line,
+		                   num_chunks);
 
 		in_line += buffer_pitch;
 		out_line += buffer_pitch;
@@ -225,50 +158,14 @@ void Deinterlacer::ErodeVertical(bit_buffer& src, bit_buffer& dest) const
 
 void Deinterlacer::DilateHorizontal(bit_buffer& src, bit_buffer& dest) const
 {
-	auto in_line  = src.begin() + buffer_pitch;
-	auto out_line = dest.begin() + buffer_pitch;
-
-	for (auto y = 0; y < image.height; ++y) {
-		auto in  = in_line;
-		auto out = out_line;
+	auto in_line  = src.data() + buffer_pitch;
+	auto out_line = dest.data() + buffer_pitch;
 
-		// We process the input horizontally in 64-pixel chunks.
-		// This is the layout of a single chunk in an uint64_t:
-		//
-		//    bits         pixels
-		//
-		//    0-7    pixels N    to N+7
-		//    8-15   pixels N+8  to N+15
-		//   16-23   pixels N+16 to N+23
-		//    ...            ...
-		//   48-55   pixels N+48 to N+55
-		//   56-63   pixels N+56 to N+63
-		//
-		uint64_t curr = *in++;
-		uint64_t prev = 0;
+	// Same 64-pixel chunk layout as in ErodeHorizontal()
+	const auto num_chunks = image.width / PixelsPerBitBufferElement + 1;
 
-		for (auto x = 0; x < image.width / PixelsPerBitBufferElement + 1;
-		     ++x) {
-
-			const auto next = *in;
-			++in;
-
-			// "Shift in" the last pixel of the previous chunk
-			const auto prev_pixel63 =
-			        (prev & (static_cast<uint64_t>(1) << 63)) >> 63;
-
-			const auto left_neighbours = (curr << 1) | prev_pixel63;
-
-			// "Shift in" the firs pixel of the next chunk
-			const auto next_pixel1      = (next & 1) << 63;
-			const auto right_neighbours = next_pixel1 | curr >> 1;
-
-			*out = left_neighbours | curr | right_neighbours;
-			++out;
-
-			prev = curr;
-			curr = next;
-		}
+	for (auto y = 0; y < image.height; ++y) {
+		dilate_row_horizontal(in_line, out_line, num_chunks);
 
 		in_line += buffer_pitch;
 		out_line += buffer_pitch;
@@ -277,57 +174,23 @@ void Deinterlacer::DilateHorizontal(bit_buffer& src, bit_buffer& dest) const
 
 void Deinterlacer::DilateVertical(bit_buffer& src, bit_buffer& dest) const
 {
-	auto in_line  = src.begin() + BufferOffset + buffer_pitch;
-	auto out_line = dest.begin() + BufferOffset + buffer_pitch;
-
-	for (auto y = 0; y < image.height; ++y) {
-		auto in  = in_line;
-		auto out = out_line;
-
-		for (auto x = 0; x < image.width / PixelsPerBitBufferElement; ++x) {
-			const auto prev = *(in - buffer_pitch);
-			const auto curr = *in;
-			const auto next = *(in + buffer_pitch);
+	auto in_line  = src.data() + BufferOffset + buffer_pitch;
+	auto out_line = dest.data() + BufferOffset + buffer_pitch;
 
-			*out = prev | curr | next;
+	const auto num_chunks = image.width / PixelsPerBitBufferElement;
 
-			++in;
-			++out;
-		}
+	for (auto y = 0; y < image.height; ++y) {
+		dilate_row_vertical(in_line - buffer_pitch,
+		                    in_line,
+		                    in_line + buffer_pitch,
+		                    out_line,
+		                    num_chunks);
 
 		in_line += buffer_pitch;
 		out_line += buffer_pitch;
 	}
 }
 
-static inline uint32_t scale_rgb(uint32_t color, const int factor)
-{
-	// Scale RGB component values by factor/256 with rounding
-	auto scale = [&](uint32_t c) {
-		return (c * factor + 128) >> 8; // 0..255
-	};
-
-	const auto r = scale(color & 0xff);
-	const auto g = (scale((color >> 8) & 0xff) << 8);
-	const auto b = (scale((color >> 16) & 0xff) << 16);
-	return r | g | b;
-}
-
-void apply_masked_bleed_64(uint64_t m, const uint32_t* in, uint32_t* out,
-                           const int rgb_scale_factor)
-{
-	while (m) {
-		const auto k      = std::countr_zero(m);
-		const auto in_buf = in[k];
-		const auto scaled = scale_rgb(in_buf, rgb_scale_factor);
-
-		out[k] |= scaled;
-
-		// clear lowest set bit
-		m &= (m - 1);
-	}
-}
-
 static int to_rgb_scale_factor_linear(const DeinterlacingStrength strength)
 {
 	using enum DeinterlacingStrength;
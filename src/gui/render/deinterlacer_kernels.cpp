@@ -0,0 +1,278 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "private/deinterlacer_kernels.h"
+
+#include <bit>
+
+#include "simde/x86/sse2.h"
+#include "utils/checks.h"
+
+CHECK_NARROWING();
+
+// Make sure the alpha component is set to zero
+constexpr uint32_t RgbMask = 0x00ffffff;
+
+static simde__m128i load(const void* p)
+{
+	return simde_mm_loadu_si128(static_cast<const simde__m128i*>(p));
+}
+
+static void store(void* p, const simde__m128i v)
+{
+	simde_mm_storeu_si128(static_cast<simde__m128i*>(p), v);
+}
+
+uint32_t scale_rgb(const uint32_t color, const int factor)
+{
+	// Scale RGB component values by factor/256 with rounding
+	auto scale = [&](uint32_t c) {
+		return (c * static_cast<uint32_t>(factor) + 128) >> 8; // 0..255
+	};
+
+	const auto r = scale(color & 0xff);
+	const auto g = (scale((color >> 8) & 0xff) << 8);
+	const auto b = (scale((color >> 16) & 0xff) << 16);
+	return r | g | b;
+}
+
+// Pixels left and right of each pixel in a chunk, shifting in the adjacent
+// pixels of the chunks before and after it
+static uint64_t get_left_neighbours(const uint64_t prev, const uint64_t curr)
+{
+	return (curr << 1) | (prev >> 63);
+}
+
+static uint64_t get_right_neighbours(const uint64_t curr, const uint64_t next)
+{
+	return (curr >> 1) | ((next & 1) << 63);
+}
+
+// The same for the two chunks at 'in'
+static simde__m128i get_left_neighbours_x2(const uint64_t* in)
+{
+	return simde_mm_or_si128(simde_mm_slli_epi64(load(in), 1),
+	                         simde_mm_srli_epi64(load(in - 1), 63));
+}
+
+static simde__m128i get_right_neighbours_x2(const uint64_t* in)
+{
+	return simde_mm_or_si128(simde_mm_srli_epi64(load(in), 1),
+	                         simde_mm_slli_epi64(load(in + 1), 63));
+}
+
+void threshold_row(const uint32_t* pixels, const uint32_t bg_color,
+                   uint64_t* mask, const int num_chunks)
+{
+	const auto rgb_mask = simde_mm_set1_epi32(static_cast<int32_t>(RgbMask));
+	const auto bg       = simde_mm_set1_epi32(static_cast<int32_t>(bg_color));
+
+	for (auto x = 0; x < num_chunks; ++x) {
+		uint64_t bits = 0;
+
+		// Four pixels per compare; the sign bits of the lanes give the
+		// background pixels
+		for (auto n = 0; n < 64; n += 4) {
+			const auto rgb = simde_mm_and_si128(load(pixels + n), rgb_mask);
+			const auto is_bg = simde_mm_cmpeq_epi32(rgb, bg);
+
+			const auto bg_bits = simde_mm_movemask_ps(simde_mm_castsi128_ps(is_bg));
+			bits |= static_cast<uint64_t>(~bg_bits & 0xf) << n;
+		}
+		mask[x] = bits;
+		pixels += 64;
+	}
+}
+
+template <bool IsErosion>
+static simde__m128i combine_x2(const simde__m128i a, const simde__m128i b,
+                               const simde__m128i c)
+{
+	if constexpr (IsErosion) {
+		return simde_mm_and_si128(simde_mm_and_si128(a, b), c);
+	} else {
+		return simde_mm_or_si128(simde_mm_or_si128(a, b), c);
+	}
+}
+
+template <bool IsErosion>
+static uint64_t combine(const uint64_t a, const uint64_t b, const uint64_t c)
+{
+	if constexpr (IsErosion) {
+		return a & b & c;
+	} else {
+		return a | b | c;
+	}
+}
+
+template <bool IsErosion>
+static void morph_row_horizontal(const uint64_t* in, uint64_t* out,
+                                 const int num_chunks)
+{
+	if (num_chunks <= 0) {
+		return;
+	}
+
+	// Nothing is shifted in from the left of the first chunk
+	out[0] = combine<IsErosion>(get_left_neighbours(0, in[0]),
+	                            in[0],
+	                            get_right_neighbours(in[0], in[1]));
+	auto x = 1;
+	for (; x + 2 <= num_chunks; x += 2) {
+		store(out + x,
+		      combine_x2<IsErosion>(get_left_neighbours_x2(in + x),
+		                            load(in + x),
+		                            get_right_neighbours_x2(in + x)));
+	}
+	for (; x < num_chunks; ++x) {
+		out[x] = combine<IsErosion>(get_left_neighbours(in[x - 1], in[x]),
+		                            in[x],
+		                            get_right_neighbours(in[x], in[x + 1]));
+	}
+}
+
+template <bool IsErosion>
+static void morph_row_vertical(const uint64_t* prev, const uint64_t* curr,
+                               const uint64_t* next, uint64_t* out,
+                               const int num_chunks)
+{
+	auto x = 0;
+	for (; x + 2 <= num_chunks; x += 2) {
+		store(out + x,
+		      combine_x2<IsErosion>(load(prev + x), load(curr + x), load(next + x)));
+	}
+	for (; x < num_chunks; ++x) {
+		out[x] = combine<IsErosion>(prev[x], curr[x], next[x]);
+	}
+}
+
+void erode_row_horizontal(const uint64_t* in, uint64_t* out, const int num_chunks)
+{
+	morph_row_horizontal<true>(in, out, num_chunks);
+}
+
+void dilate_row_horizontal(const uint64_t* in, uint64_t* out, const int num_chunks)
+{
+	morph_row_horizontal<false>(in, out, num_chunks);
+}
+
+void erode_row_vertical(const uint64_t* prev, const uint64_t* curr,
+                        const uint64_t* next, uint64_t* out, const int num_chunks)
+{
+	morph_row_vertical<true>(prev, curr, next, out, num_chunks);
+}
+
+void dilate_row_vertical(const uint64_t* prev, const uint64_t* curr,
+                         const uint64_t* next, uint64_t* out, const int num_chunks)
+{
+	morph_row_vertical<false>(prev, curr, next, out, num_chunks);
+}
+
+void apply_masked_bleed_64(uint64_t mask, const uint32_t* in, uint32_t* out,
+                           const int rgb_scale_factor)
+{
+	const auto zero     = simde_mm_setzero_si128();
+	const auto factor   = simde_mm_set1_epi16(static_cast<int16_t>(rgb_scale_factor));
+	const auto rounding = simde_mm_set1_epi16(128);
+	const auto rgb_mask = simde_mm_set1_epi32(static_cast<int32_t>(RgbMask));
+
+	// One bit per lane to select the pixels of a group of four
+	const auto lane_bits = simde_mm_set_epi32(8, 4, 2, 1);
+
+	auto scale = [&](const simde__m128i components) {
+		// At most 255 * 256 + 128, so the 16-bit lanes don't overflow
+		const auto scaled = simde_mm_add_epi16(simde_mm_mullo_epi16(components,
+		                                                            factor),
+		                                       rounding);
+		return simde_mm_srli_epi16(scaled, 8);
+	};
+
+	while (mask) {
+		// Process the pixels in groups of four, skipping the empty ones
+		const auto group = std::countr_zero(mask) / 4 * 4;
+		const auto bits  = static_cast<int32_t>((mask >> group) & 0xf);
+
+		const auto pixels = load(in + group);
+
+		const auto lo     = scale(simde_mm_unpacklo_epi8(pixels, zero));
+		const auto hi     = scale(simde_mm_unpackhi_epi8(pixels, zero));
+		const auto scaled = simde_mm_and_si128(simde_mm_packus_epi16(lo, hi),
+		                                       rgb_mask);
+
+		const auto lanes = simde_mm_cmpeq_epi32(
+		        simde_mm_and_si128(simde_mm_set1_epi32(bits), lane_bits),
+		        lane_bits);
+
+		store(out + group,
+		      simde_mm_or_si128(load(out + group), simde_mm_and_si128(scaled, lanes)));
+
+		mask &= ~(static_cast<uint64_t>(0xf) << group);
+	}
+}
+
+namespace scalar {
+
+void threshold_row(const uint32_t* pixels, const uint32_t bg_color,
+                   uint64_t* mask, const int num_chunks)
+{
+	for (auto x = 0; x < num_chunks; ++x) {
+		uint64_t bits = 0;
+		for (auto n = 0; n < 64; ++n) {
+			const auto rgb = pixels[n] & RgbMask;
+			bits |= static_cast<uint64_t>(rgb != bg_color) << n;
+		}
+		mask[x] = bits;
+		pixels += 64;
+	}
+}
+
+void erode_row_horizontal(const uint64_t* in, uint64_t* out, const int num_chunks)
+{
+	uint64_t prev = 0;
+	for (auto x = 0; x < num_chunks; ++x) {
+		out[x] = get_left_neighbours(prev, in[x]) & in[x] &
+		         get_right_neighbours(in[x], in[x + 1]);
+		prev = in[x];
+	}
+}
+
+void dilate_row_horizontal(const uint64_t* in, uint64_t* out, const int num_chunks)
+{
+	uint64_t prev = 0;
+	for (auto x = 0; x < num_chunks; ++x) {
+		out[x] = get_left_neighbours(prev, in[x]) | in[x] |
+		         get_right_neighbours(in[x], in[x + 1]);
+		prev = in[x];
+	}
+}
+
+void erode_row_vertical(const uint64_t* prev, const uint64_t* curr,
+                        const uint64_t* next, uint64_t* out, const int num_chunks)
+{
+	for (auto x = 0; x < num_chunks; ++x) {
+		out[x] = prev[x] & curr[x] & next[x];
+	}
+}
+
+void dilate_row_vertical(const uint64_t* prev, const uint64_t* curr,
+                         const uint64_t* next, uint64_t* out, const int num_chunks)
+{
+	for (auto x = 0; x < num_chunks; ++x) {
+		out[x] = prev[x] | curr[x] | next[x];
+	}
+}
+
+void apply_masked_bleed_64(uint64_t mask, const uint32_t* in, uint32_t* out,
+                           const int rgb_scale_factor)
+{
+	while (mask) {
+		const auto k = std::countr_zero(mask);
+
+		out[k] |= scale_rgb(in[k], rgb_scale_factor);
+
+		// clear lowest set bit
+		mask &= (mask - 1);
+	}
+}
+
+} // namespace scalar
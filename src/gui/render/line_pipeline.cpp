@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "private/line_pipeline.h"
+
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+#include "misc/support.h"
+#include "utils/checks.h"
+
+CHECK_NARROWING();
+
+// Enough lines to let the emulation run ahead by a few dozen scanlines
+constexpr size_t NumSlots = 64;
+
+LinePipeline::LinePipeline(LineHandler _handler, const char* thread_name)
+        : handler(std::move(_handler)),
+          slots(NumSlots)
+{
+	assert(handler);
+
+	worker = std::thread(&LinePipeline::ProcessLines, this);
+	set_thread_name(worker, thread_name);
+}
+
+LinePipeline::~LinePipeline()
+{
+	{
+		std::lock_guard lock(mutex);
+		is_stopping = true;
+	}
+	has_work.notify_one();
+
+	// The worker processes the pending lines before it exits
+	worker.join();
+}
+
+void LinePipeline::SetLineSize(const size_t num_bytes)
+{
+	Wait();
+
+	line_size = num_bytes;
+	for (auto& slot : slots) {
+		slot.data.resize(line_size);
+	}
+}
+
+void LinePipeline::Submit(const void* line)
+{
+	std::unique_lock lock(mutex);
+
+	has_processed.wait(lock, [&] {
+		return num_submitted - num_processed < NumSlots;
+	});
+
+	// The worker never touches free slots, so the copy can be made
+	// without holding the lock
+	auto& slot = slots[num_submitted % NumSlots];
+	lock.unlock();
+
+	slot.has_data = (line != nullptr);
+	if (line) {
+		std::memcpy(slot.data.data(), line, line_size);
+	}
+
+	lock.lock();
+	++num_submitted;
+	lock.unlock();
+
+	has_work.notify_one();
+}
+
+void LinePipeline::Wait()
+{
+	std::unique_lock lock(mutex);
+
+	has_processed.wait(lock, [&] { return num_processed == num_submitted; });
+}
+
+void LinePipeline::ProcessLines()
+{
+	std::unique_lock lock(mutex);
+
+	while (true) {
+		has_work.wait(lock, [&] {
+			return is_stopping || num_processed != num_submitted;
+		});
+
+		if (num_processed == num_submitted) {
+			assert(is_stopping);
+			return;
+		}
+
+		const auto& slot = slots[num_processed % NumSlots];
+		lock.unlock();
+
+		handler(slot.has_data ? slot.data.data() : nullptr);
+
+		lock.lock();
+		++num_processed;
+		has_processed.notify_all();
+	}
+}
@@ -5,11 +5,15 @@
 
 #if C_OPENGL
 
+#include <algorithm>
+#include <cstring>
+
 #include "gui/private/common.h"
 #include "gui/private/shader_manager.h"
 
 #include "capture/capture.h"
 #include "dosbox_config.h"
+#include "misc/host_memory.h"
 #include "misc/support.h"
 #include "misc/video.h"
 #include "utils/checks.h"
@@ -32,6 +36,9 @@ constexpr auto GlslExtension = ".glsl";
 
 constexpr auto ImageAdjustmentsShaderName = "_internal/image-adjustments-pass";
 
+// From ARB_buffer_storage
+constexpr GLbitfield GlMapPersistentBit = 0x0040;
+
 // A safe wrapper around that returns the default result on failure
 static const char* safe_gl_get_string(const GLenum requested_name,
                                       const char* default_result = "")
@@ -146,6 +153,23 @@ bool OpenGlRenderer::InitRenderer()
 	         safe_gl_get_string(GL_SHADING_LANGUAGE_VERSION, "unknown"),
 	         safe_gl_get_string(GL_VENDOR, "unknown"));
 
+	const auto driver_id = format_str("%s|%s|%s",
+	                                  safe_gl_get_string(GL_VENDOR),
+	                                  safe_gl_get_string(GL_RENDERER),
+	                                  safe_gl_get_string(GL_VERSION));
+
+	shader_binary_cache.Init(version, driver_id);
+
+	const auto has_buffer_storage = (GLAD_VERSION_MAJOR(version) > 4 ||
+	                                 (GLAD_VERSION_MAJOR(version) == 4 &&
+	                                  GLAD_VERSION_MINOR(version) >= 4) ||
+	                                 SDL_GL_ExtensionSupported(
+	                                         "GL_ARB_buffer_storage"));
+	if (has_buffer_storage) {
+		buffer_storage = reinterpret_cast<BufferStorageProc>(
+		        SDL_GL_GetProcAddress("glBufferStorage"));
+	}
+
 	// Vertex data of a single oversized triangle encompassing the viewport
 	// Lower left
 	vertex_data[0] = -1.0f;
@@ -198,11 +222,15 @@ bool OpenGlRenderer::InitRenderer()
 	glUseProgram(pass1.shader.program_object);
 	GetPass1UniformLocations();
 
+	CreatePaletteTexture();
+
 	return true;
 }
 
 OpenGlRenderer::~OpenGlRenderer()
 {
+	HOST_MEMORY_RemoveSubsystem("Framebuffers");
+
 	SDL_GL_ResetAttributes();
 
 	glDeleteVertexArrays(1, &vao);
@@ -212,6 +240,12 @@ OpenGlRenderer::~OpenGlRenderer()
 		glDeleteTextures(1, &pass1.in_texture);
 		pass1.in_texture = 0;
 	}
+	DeleteUploadBuffers();
+
+	if (pass1.palette_texture) {
+		glDeleteTextures(1, &pass1.palette_texture);
+		pass1.palette_texture = 0;
+	}
 
 	if (pass1.out_texture) {
 		glDeleteTextures(1, &pass1.out_texture);
@@ -219,6 +253,15 @@ OpenGlRenderer::~OpenGlRenderer()
 	}
 	glDeleteFramebuffers(1, &pass1.out_fbo);
 
+	if (output_cache.texture) {
+		glDeleteTextures(1, &output_cache.texture);
+		output_cache.texture = 0;
+	}
+	if (output_cache.fbo) {
+		glDeleteFramebuffers(1, &output_cache.fbo);
+		output_cache.fbo = 0;
+	}
+
 	for (auto& [_, shader] : shader_cache) {
 		glDeleteProgram(shader.program_object);
 	}
@@ -257,6 +300,7 @@ DosBox::Rect OpenGlRenderer::GetCanvasSizeInPixels()
 void OpenGlRenderer::NotifyViewportSizeChanged(const DosBox::Rect draw_rect_px)
 {
 	viewport_rect_px = draw_rect_px;
+	output_cache.is_valid = false;
 
 	// If the viewport size has changed, the canvas size might have changed
 	// too.
@@ -357,6 +401,8 @@ void OpenGlRenderer::MaybeUpdateRenderSize(const int new_render_width_px,
 	pass1.width  = new_render_width_px;
 	pass1.height = new_render_height_px;
 
+	output_cache.is_valid = false;
+
 	RecreatePass1InputTextureAndRenderBuffer();
 	RecreatePass1OutputTexture();
 
@@ -386,21 +432,27 @@ void OpenGlRenderer::RecreatePass1InputTextureAndRenderBuffer()
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, pass1.in_texture);
 
+	// Palette indexes must not be interpolated
+	const GLint filter_param = indexed_frames ? GL_NEAREST : GL_LINEAR;
+
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter_param);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter_param);
+
+	upload_format = indexed_frames ? GL_RED : GL_BGRA;
+	upload_type = indexed_frames ? GL_UNSIGNED_BYTE : GL_UNSIGNED_INT_8_8_8_8_REV;
 
 	// Just create the texture; we'll copy the image data later with
 	// `glTexSubImage2D()`
 	//
 	glTexImage2D(GL_TEXTURE_2D,
 	             0,                // mimap level (0 = base image)
-	             GL_RGB8,          // internal format
+	             indexed_frames ? GL_R8 : GL_RGB8, // internal format
 	             pass1.width,      // width
 	             pass1.height,     // height
 	             0,                // border (must be always 0)
-	             GL_BGRA,          // pixel data format
+	             upload_format,    // pixel data format
 	             GL_UNSIGNED_BYTE, // pixel data type
 	             nullptr           // pointer to image data
 	);
@@ -411,16 +463,235 @@ void OpenGlRenderer::RecreatePass1InputTextureAndRenderBuffer()
 	// emulation will write to these buffers, then we'll copy the data to
 	// the texture in GPU memory with `glTexSubImage2D()` before presenting
 	// the frame.
-	const auto pitch_pixels = pass1.width;
-	const auto num_pixels = static_cast<size_t>(pitch_pixels) * pass1.height;
+	//
+	// The rows of indexed frames are padded to 4 bytes, which is the
+	// default row alignment of the uploads.
+	const auto bytes_per_pixel = indexed_frames ? sizeof(uint8_t)
+	                                            : sizeof(uint32_t);
+
+	const auto pitch_bytes = (static_cast<size_t>(pass1.width) * bytes_per_pixel +
+	                          sizeof(uint32_t) - 1) /
+	                         sizeof(uint32_t) * sizeof(uint32_t);
+
+	const auto num_words = pitch_bytes * pass1.height / sizeof(uint32_t);
 
-	curr_framebuf.resize(num_pixels);
-	last_framebuf.resize(num_pixels);
+	curr_framebuf.resize(num_words);
+	last_framebuf.resize(num_words);
 
-	constexpr auto BytesPerPixel = sizeof(uint32_t);
-	const auto pitch_bytes       = pitch_pixels * BytesPerPixel;
+	HOST_MEMORY_AddSubsystem("Framebuffers", [this] {
+		return (curr_framebuf.size() + last_framebuf.size()) *
+		       sizeof(uint32_t);
+	});
+
+	// The new texture has no contents yet
+	pending_upload_rows.Resize(pass1.height);
 
 	pass1.in_texture_pitch = check_cast<int>(pitch_bytes);
+
+	RecreateUploadBuffers();
+}
+
+void OpenGlRenderer::CreatePaletteTexture()
+{
+	glGenTextures(1, &pass1.palette_texture);
+
+	glBindTexture(GL_TEXTURE_2D, pass1.palette_texture);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glTexImage2D(GL_TEXTURE_2D,
+	             0,                // mimap level (0 = base image)
+	             GL_RGB8,          // internal format
+	             NumVgaColors,     // width
+	             1,                // height
+	             0,                // border (must be always 0)
+	             GL_BGRA,          // pixel data format
+	             GL_UNSIGNED_BYTE, // pixel data type
+	             nullptr           // pointer to image data
+	);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+bool OpenGlRenderer::SetIndexedFrames(const bool is_enabled)
+{
+	if (is_enabled == indexed_frames) {
+		return true;
+	}
+	indexed_frames = is_enabled;
+
+	// The framebuffer size might not change, so the buffers have to be
+	// recreated for the new pixel format here
+	if (pass1.width > 0 && pass1.height > 0) {
+		RecreatePass1InputTextureAndRenderBuffer();
+	}
+
+	glUseProgram(pass1.shader.program_object);
+	UpdatePass1Uniforms();
+
+	return true;
+}
+
+void OpenGlRenderer::SetPalette(std::span<const uint32_t> lut)
+{
+	assert(lut.size() == curr_palette.size());
+
+	std::copy(lut.begin(), lut.end(), curr_palette.begin());
+}
+
+void OpenGlRenderer::RecreateUploadBuffers()
+{
+	DeleteUploadBuffers();
+
+	upload_buffer_size = static_cast<GLsizeiptr>(last_framebuf.size() *
+	                                             sizeof(uint32_t));
+
+	for (auto& buffer : upload_buffers) {
+		glGenBuffers(1, &buffer.pbo);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.pbo);
+
+		if (buffer_storage) {
+			// Immutable storage that stays mapped; the explicit
+			// flushes make the written rows visible to the GPU
+			constexpr GLbitfield Flags = GL_MAP_WRITE_BIT |
+			                             GlMapPersistentBit;
+
+			buffer_storage(GL_PIXEL_UNPACK_BUFFER,
+			               upload_buffer_size,
+			               nullptr,
+			               Flags);
+
+			buffer.persistent_mapping = static_cast<uint8_t*>(
+			        glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+			                         0,
+			                         upload_buffer_size,
+			                         Flags | GL_MAP_FLUSH_EXPLICIT_BIT));
+
+			if (buffer.persistent_mapping) {
+				continue;
+			}
+
+			// Buffer storage is immutable, so start over with a
+			// regular buffer
+			glDeleteBuffers(1, &buffer.pbo);
+			glGenBuffers(1, &buffer.pbo);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.pbo);
+		}
+
+		glBufferData(GL_PIXEL_UNPACK_BUFFER,
+		             upload_buffer_size,
+		             nullptr,
+		             GL_STREAM_DRAW);
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	upload_buffer_index = 0;
+}
+
+void OpenGlRenderer::DeleteUploadBuffers()
+{
+	for (auto& buffer : upload_buffers) {
+		if (buffer.fence) {
+			glDeleteSync(buffer.fence);
+		}
+		if (buffer.persistent_mapping) {
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.pbo);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		}
+		if (buffer.pbo) {
+			glDeleteBuffers(1, &buffer.pbo);
+		}
+		buffer = {};
+	}
+	upload_buffer_size = 0;
+}
+
+// Uploads the dirty rows through the next pixel buffer object of the ring.
+// Returns false if the buffer couldn't be mapped, in which case nothing has
+// been uploaded.
+bool OpenGlRenderer::UploadViaPixelBuffer()
+{
+	auto& buffer = upload_buffers[upload_buffer_index];
+	if (!buffer.pbo) {
+		return false;
+	}
+
+	// The GPU is normally done with a buffer long before we come back
+	// to it, but make sure we don't overwrite data still being read
+	if (buffer.fence) {
+		constexpr GLuint64 TimeoutNs = 1'000'000'000;
+		glClientWaitSync(buffer.fence, GL_SYNC_FLUSH_COMMANDS_BIT, TimeoutNs);
+
+		glDeleteSync(buffer.fence);
+		buffer.fence = nullptr;
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.pbo);
+
+	// Unsynchronised mapping is safe because of the fence above, and we
+	// only flush the rows we actually write
+	auto mapped = buffer.persistent_mapping;
+	if (!mapped) {
+		mapped = static_cast<uint8_t*>(
+		        glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+		                         0,
+		                         upload_buffer_size,
+		                         GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+		                                 GL_MAP_FLUSH_EXPLICIT_BIT));
+	}
+	if (!mapped) {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		return false;
+	}
+
+	const auto pitch_bytes = static_cast<size_t>(pass1.in_texture_pitch);
+	const auto src = reinterpret_cast<const uint8_t*>(last_framebuf.data());
+
+	for (const auto& range : upload_ranges) {
+		const auto offset = static_cast<size_t>(range.first_row) * pitch_bytes;
+		const auto num_bytes = static_cast<size_t>(range.num_rows) * pitch_bytes;
+
+		std::memcpy(mapped + offset, src + offset, num_bytes);
+
+		glFlushMappedBufferRange(GL_PIXEL_UNPACK_BUFFER,
+		                         static_cast<GLintptr>(offset),
+		                         static_cast<GLsizeiptr>(num_bytes));
+	}
+
+	if (!buffer.persistent_mapping &&
+	    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) != GL_TRUE) {
+		// The buffer contents got lost (e.g., on a display mode switch)
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		return false;
+	}
+
+	// With a pixel buffer bound, the data pointer is an offset into it
+	for (const auto& range : upload_ranges) {
+		const auto offset = static_cast<uintptr_t>(range.first_row) *
+		                    pitch_bytes;
+
+		glTexSubImage2D(GL_TEXTURE_2D,
+		                0,               // mimap level (0 = base image)
+		                0,               // x offset
+		                range.first_row, // y offset
+		                pass1.width,     // width
+		                range.num_rows,  // height
+		                upload_format,   // pixel data format
+		                upload_type,     // pixel data type
+		                reinterpret_cast<const void*>(offset) // buffer offset
+		);
+	}
+
+	buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	upload_buffer_index = (upload_buffer_index + 1) % NumUploadBuffers;
+	return true;
 }
 
 void OpenGlRenderer::RecreatePass1OutputTexture()
@@ -455,6 +726,8 @@ void OpenGlRenderer::SetPass1OutputTextureFiltering()
 {
 	glBindTexture(GL_TEXTURE_2D, pass1.out_texture);
 
+	output_cache.is_valid = false;
+
 	const auto& shader_settings = pass2.shader_preset.settings;
 
 	const int filter_param = [&] {
@@ -480,43 +753,103 @@ void OpenGlRenderer::StartFrame(uint32_t*& pixels_out, int& pitch_out)
 	pitch_out = pass1.in_texture_pitch;
 }
 
-void OpenGlRenderer::EndFrame()
+void OpenGlRenderer::EndFrame(const std::vector<DirtyRowRange>& dirty_rows)
 {
 	assert(!curr_framebuf.empty());
 	assert(!last_framebuf.empty());
 
 	// We need to copy the buffers. We can't just swap them because the VGA
 	// emulation only writes the changed pixels to the framebuffer in each
-	// frame.
+	// frame. But it's enough to copy the rows that have changed.
+	const auto pitch_bytes = static_cast<size_t>(pass1.in_texture_pitch);
+
+	const auto src = reinterpret_cast<const uint8_t*>(curr_framebuf.data());
+	const auto dest = reinterpret_cast<uint8_t*>(last_framebuf.data());
+
+	pending_upload_rows.ForEachChanged(dirty_rows, [&](const DirtyRowRange& range) {
+		const auto offset = static_cast<size_t>(range.first_row) * pitch_bytes;
+		const auto num_bytes = static_cast<size_t>(range.num_rows) * pitch_bytes;
+
+		std::memcpy(dest + offset, src + offset, num_bytes);
+
+		pending_upload_rows.Mark(range);
+	});
 
-	last_framebuf       = curr_framebuf;
 	last_framebuf_dirty = true;
+
+	if (indexed_frames && last_palette != curr_palette) {
+		last_palette       = curr_palette;
+		last_palette_dirty = true;
+	}
 }
 
 void OpenGlRenderer::PrepareFrame()
 {
 	assert(!last_framebuf.empty());
 
-	if (last_framebuf_dirty) {
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, pass1.in_texture);
+	if (last_palette_dirty) {
+		glBindTexture(GL_TEXTURE_2D, pass1.palette_texture);
 
 		glTexSubImage2D(GL_TEXTURE_2D,
 		                0,            // mimap level (0 = base image)
 		                0,            // x offset
 		                0,            // y offset
-		                pass1.width,  // width
-		                pass1.height, // height
+		                NumVgaColors, // width
+		                1,            // height
 		                GL_BGRA,      // pixel data format
 		                GL_UNSIGNED_INT_8_8_8_8_REV, // pixel data type
-		                last_framebuf.data() // pointer to image data
+		                last_palette.data() // pointer to image data
 		);
 
 		glBindTexture(GL_TEXTURE_2D, 0);
 
+		last_palette_dirty    = false;
+		output_cache.is_valid = false;
+	}
+
+	if (last_framebuf_dirty) {
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, pass1.in_texture);
+
+		// Only upload the rows that have changed since the last upload
+		// (e.g., just the blinking cursor in text modes)
+		upload_ranges.clear();
+
+		pending_upload_rows.Flush([&](const DirtyRowRange& range) {
+			upload_ranges.push_back(range);
+		});
+
+		if (!UploadViaPixelBuffer()) {
+			// Fall back to a synchronous upload from host memory
+			const auto pitch_bytes = static_cast<size_t>(
+			        pass1.in_texture_pitch);
+
+			const auto src = reinterpret_cast<const uint8_t*>(
+			        last_framebuf.data());
+
+			for (const auto& range : upload_ranges) {
+				const auto offset = static_cast<size_t>(range.first_row) *
+				                    pitch_bytes;
+
+				glTexSubImage2D(GL_TEXTURE_2D,
+				                0,               // mimap level (0 = base image)
+				                0,               // x offset
+				                range.first_row, // y offset
+				                pass1.width,     // width
+				                range.num_rows,  // height
+				                upload_format,   // pixel data format
+				                upload_type,     // pixel data type
+				                src + offset     // pointer to image data
+				);
+			}
+		}
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+
 		++frame_count;
 
-		last_framebuf_dirty = false;
+		last_framebuf_dirty   = false;
+		output_cache.is_valid = false;
 	}
 }
 
@@ -531,6 +864,12 @@ void OpenGlRenderer::RenderPass1()
 
 	glUseProgram(pass1.shader.program_object);
 
+	// Bind the palette of indexed frames
+	if (indexed_frames) {
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D, pass1.palette_texture);
+	}
+
 	// Bind input texture containing the raw framebuffer data of the
 	// emulated video card
 	glActiveTexture(GL_TEXTURE0);
@@ -547,6 +886,12 @@ void OpenGlRenderer::RenderPass1()
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 	glBindTexture(GL_TEXTURE_2D, 0);
 	glBindVertexArray(0);
+
+	if (indexed_frames) {
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glActiveTexture(GL_TEXTURE0);
+	}
 }
 
 void OpenGlRenderer::RenderPass2()
@@ -580,10 +925,88 @@ void OpenGlRenderer::RenderPass2()
 	glBindVertexArray(0);
 }
 
+void OpenGlRenderer::SaveOutputToCache(const int width, const int height)
+{
+	if (!output_cache.fbo) {
+		glGenFramebuffers(1, &output_cache.fbo);
+	}
+
+	if (width != output_cache.width || height != output_cache.height) {
+		if (output_cache.texture) {
+			glDeleteTextures(1, &output_cache.texture);
+		}
+		glGenTextures(1, &output_cache.texture);
+		glBindTexture(GL_TEXTURE_2D, output_cache.texture);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		glTexImage2D(GL_TEXTURE_2D,
+		             0,                // mimap level (0 = base image)
+		             GL_RGBA8,         // internal format
+		             width,            // width
+		             height,           // height
+		             0,                // border (must be always 0)
+		             GL_RGBA,          // pixel data format
+		             GL_UNSIGNED_BYTE, // pixel data type
+		             nullptr);         // pointer to image data
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, output_cache.fbo);
+		glFramebufferTexture2D(GL_FRAMEBUFFER,
+		                       GL_COLOR_ATTACHMENT0,
+		                       GL_TEXTURE_2D,
+		                       output_cache.texture,
+		                       0);
+
+		output_cache.width  = width;
+		output_cache.height = height;
+	}
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, output_cache.fbo);
+
+	glBlitFramebuffer(0, 0, width, height,
+	                  0, 0, width, height,
+	                  GL_COLOR_BUFFER_BIT,
+	                  GL_NEAREST);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	output_cache.is_valid = true;
+}
+
+void OpenGlRenderer::PresentCachedOutput()
+{
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, output_cache.fbo);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+
+	glBlitFramebuffer(0, 0, output_cache.width, output_cache.height,
+	                  0, 0, output_cache.width, output_cache.height,
+	                  GL_COLOR_BUFFER_BIT,
+	                  GL_NEAREST);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
 void OpenGlRenderer::PresentFrame()
 {
-	RenderPass1();
-	RenderPass2();
+	const auto canvas_size_px = GetCanvasSizeInPixels();
+
+	const auto canvas_width  = iroundf(canvas_size_px.w);
+	const auto canvas_height = iroundf(canvas_size_px.h);
+
+	if (output_cache.is_valid && canvas_width == output_cache.width &&
+	    canvas_height == output_cache.height) {
+		// Nothing has changed since the last full render
+		PresentCachedOutput();
+	} else {
+		RenderPass1();
+		RenderPass2();
+
+		SaveOutputToCache(canvas_width, canvas_height);
+	}
 
 	// Optionally capture frame
 	if (CAPTURE_IsCapturingPostRenderImage()) {
@@ -681,6 +1104,11 @@ std::optional<GLuint> OpenGlRenderer::BuildShaderProgram(const std::string& shad
 		return {};
 	}
 
+	if (const auto cached_program = shader_binary_cache.Load(shader_source);
+	    cached_program) {
+		return *cached_program;
+	}
+
 	const auto maybe_vertex_shader = BuildShader(GL_VERTEX_SHADER, shader_source);
 	if (!maybe_vertex_shader) {
 		LOG_ERR("OPENGL: Error compiling vertex shader");
@@ -709,6 +1137,8 @@ std::optional<GLuint> OpenGlRenderer::BuildShaderProgram(const std::string& shad
 	glAttachShader(shader_program, vertex_shader);
 	glAttachShader(shader_program, fragment_shader);
 
+	shader_binary_cache.PrepareProgram(shader_program);
+
 	glLinkProgram(shader_program);
 
 	glDeleteShader(vertex_shader);
@@ -745,6 +1175,8 @@ std::optional<GLuint> OpenGlRenderer::BuildShaderProgram(const std::string& shad
 		return {};
 	}
 
+	shader_binary_cache.Store(shader_source, shader_program);
+
 	return shader_program;
 }
 
@@ -910,6 +1342,8 @@ bool OpenGlRenderer::SwitchShader(const std::string& shader_name)
 
 	pass2.shader = *maybe_shader;
 
+	output_cache.is_valid = false;
+
 	glUseProgram(pass2.shader.program_object);
 	GetPass2UniformLocations(pass2.shader.info.default_preset.params);
 
@@ -920,6 +1354,8 @@ bool OpenGlRenderer::SwitchShaderPresetOrSetDefault(const ShaderDescriptor& desc
 {
 	assert(!descriptor.shader_name.empty());
 
+	output_cache.is_valid = false;
+
 	auto set_default_preset = [&]() {
 		assert(shader_cache.contains(descriptor.shader_name));
 		auto& default_preset = shader_cache[descriptor.shader_name].info.default_preset;
@@ -1080,6 +1516,9 @@ void OpenGlRenderer::GetPass1UniformLocations()
 
 	u.input_texture = glGetUniformLocation(po, "inputTexture");
 
+	u.indexed_input   = glGetUniformLocation(po, "INDEXED_INPUT");
+	u.palette_texture = glGetUniformLocation(po, "paletteTexture");
+
 	u.color_space = glGetUniformLocation(po, "COLOR_SPACE");
 
 	u.enable_adjustments = glGetUniformLocation(po, "ENABLE_ADJUSTMENTS");
@@ -1105,11 +1544,16 @@ void OpenGlRenderer::GetPass1UniformLocations()
 
 void OpenGlRenderer::UpdatePass1Uniforms()
 {
+	output_cache.is_valid = false;
+
 	const auto& u = pass1.uniforms;
 	const auto& s = pass1.image_adjustment_settings;
 
 	glUniform1i(u.input_texture, 0);
 
+	glUniform1i(u.indexed_input, indexed_frames ? 1 : 0);
+	glUniform1i(u.palette_texture, 1);
+
 	glUniform1i(u.color_space, enum_val(color_space));
 
 	glUniform1i(u.enable_adjustments, pass1.enable_image_adjustments ? 1 : 0);
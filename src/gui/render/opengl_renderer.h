@@ -17,6 +17,8 @@
 #include <vector>
 
 #include "dosbox_config.h"
+#include "gui/render/private/dirty_rows.h"
+#include "gui/render/private/shader_binary_cache.h"
 #include "gui/render/render.h"
 #include "misc/video.h"
 #include "utils/rect.h"
@@ -54,8 +56,11 @@ public:
 
 	std::string GetCurrentSymbolicShaderDescriptor() override;
 
+	bool SetIndexedFrames(const bool is_enabled) override;
+	void SetPalette(std::span<const uint32_t> lut) override;
+
 	void StartFrame(uint32_t*& pixels_out, int& pitch_out) override;
-	void EndFrame() override;
+	void EndFrame(const std::vector<DirtyRowRange>& dirty_rows) override;
 
 	void PrepareFrame() override;
 	void PresentFrame() override;
@@ -121,12 +126,19 @@ private:
 	void UpdatePass2Uniforms();
 
 	void RecreatePass1InputTextureAndRenderBuffer();
+	void CreatePaletteTexture();
+	void RecreateUploadBuffers();
+	void DeleteUploadBuffers();
+	bool UploadViaPixelBuffer();
 	void RecreatePass1OutputTexture();
 	void SetPass1OutputTextureFiltering();
 
 	void RenderPass1();
 	void RenderPass2();
 
+	void SaveOutputToCache(const int width, const int height);
+	void PresentCachedOutput();
+
 	// ---------------------------------------------------------------------
 	// Common
 	// ---------------------------------------------------------------------
@@ -151,6 +163,58 @@ private:
 	// True if the last framebuffer has been updated since the last present
 	bool last_framebuf_dirty = false;
 
+	// With indexed frames, the framebuffers hold 8-bit palette indexes,
+	// and the colours are looked up from the palette in the first render
+	// pass. The buffers are still allocated in 32-bit units.
+	bool indexed_frames = false;
+
+	// Palette of the current frame, and of the last fully rendered frame
+	std::array<uint32_t, NumVgaColors> curr_palette = {};
+	std::array<uint32_t, NumVgaColors> last_palette = {};
+
+	bool last_palette_dirty = false;
+
+	// Pixel data format and type of the framebuffer uploads
+	GLenum upload_format = GL_BGRA;
+	GLenum upload_type   = GL_UNSIGNED_INT_8_8_8_8_REV;
+
+	// Rows of the last framebuffer not yet uploaded to the texture
+	DirtyRows pending_upload_rows = {};
+
+	// Ring of pixel buffer objects the framebuffer is uploaded through.
+	// Copying into a mapped buffer is a plain memcpy, and the transfer to
+	// the texture then happens asynchronously on the GPU, so the upload no
+	// longer stalls on driver synchronisation. Each buffer is reused only
+	// after the fence of its previous upload has signalled.
+	static constexpr auto NumUploadBuffers = 3;
+
+	struct UploadBuffer {
+		GLuint pbo   = 0;
+		GLsync fence = nullptr;
+
+		// Set if the buffer stays mapped for its whole lifetime
+		uint8_t* persistent_mapping = nullptr;
+	};
+
+	std::array<UploadBuffer, NumUploadBuffers> upload_buffers = {};
+
+	size_t upload_buffer_index    = 0;
+	GLsizeiptr upload_buffer_size = 0;
+
+	// From ARB_buffer_storage (core in OpenGL 4.4). If available, the
+	// upload buffers are mapped once when created instead of being mapped
+	// and unmapped on every upload, which takes the driver out of the
+	// per-frame upload path altogether.
+	using BufferStorageProc = void(GLAD_API_PTR*)(GLenum target,
+	                                              GLsizeiptr size,
+	                                              const void* data,
+	                                              GLbitfield flags);
+
+	BufferStorageProc buffer_storage = nullptr;
+
+	// Reused to collect the row ranges of an upload
+	std::vector<DirtyRowRange> upload_ranges = {};
+
 	DosBox::Rect viewport_rect_px = {};
 
 	GLuint frame_count = 0;
@@ -176,6 +240,9 @@ private:
 		GLuint in_texture    = 0;
 		int in_texture_pitch = 0;
 
+		// 256x1 texture of the palette of indexed frames
+		GLuint palette_texture = 0;
+
 		GLuint out_fbo     = 0;
 		GLuint out_texture = 0;
 
@@ -185,6 +252,9 @@ private:
 		struct {
 			GLint input_texture = -1;
 
+			GLint indexed_input   = -1;
+			GLint palette_texture = -1;
+
 			GLint color_space = -1;
 
 			GLint enable_adjustments = -1;
@@ -226,6 +296,24 @@ private:
 		} uniforms = {};
 	} pass2 = {};
 
+	// Copy of the whole canvas as left by the last run of both passes.
+	// Presenting a frame when neither the input, the shaders, their
+	// uniforms nor the canvas have changed only blits this back, instead of
+	// running a potentially expensive pass 2 shader again. This matters in
+	// host-rate presentation mode on high refresh rate displays, where most
+	// presented frames repeat the previous one. None of the pass 2 uniforms
+	// are time-based (the frame count only advances with new frames), so
+	// the copy is exact.
+	struct {
+		GLuint fbo     = 0;
+		GLuint texture = 0;
+
+		int width  = 0;
+		int height = 0;
+
+		bool is_valid = false;
+	} output_cache = {};
+
 	// ---------------------------------------------------------------------
 	// Shader caching & preset management
 	// ---------------------------------------------------------------------
@@ -234,6 +322,9 @@ private:
 	// .glsl file extension
 	std::unordered_map<std::string, Shader> shader_cache = {};
 
+	// Linked programs persisted across sessions
+	ShaderBinaryCache shader_binary_cache = {};
+
 	// Keys are the shader names including the path part but without the
 	// .glsl file extension
 	std::unordered_map<std::string, ShaderPreset> shader_preset_cache = {};
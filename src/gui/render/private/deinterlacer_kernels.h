@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_RENDER_DEINTERLACER_KERNELS_H
+#define DOSBOX_RENDER_DEINTERLACER_KERNELS_H
+
+#include <cstdint>
+
+// Row kernels of the deinterlacer working on 1-bit masks stored as 64-pixel
+// chunks (the first pixel in the LSB) and on 32-bit BGRX pixels.
+//
+// The default versions use SSE2 (NEON on ARM via SIMDe); the 'scalar' ones
+// are the plain reference implementations that produce bit-identical results.
+
+// Sets the mask bits of the pixels that differ from 'bg_color', ignoring
+// their alpha component
+void threshold_row(const uint32_t* pixels, const uint32_t bg_color,
+                   uint64_t* mask, const int num_chunks);
+
+// Keeps or sets a mask bit depending on its left and right neighbours. The
+// pixel left of the first chunk counts as 0; the chunk after the last one
+// is read for the pixel right of it.
+void erode_row_horizontal(const uint64_t* in, uint64_t* out, const int num_chunks);
+void dilate_row_horizontal(const uint64_t* in, uint64_t* out, const int num_chunks);
+
+// Keeps or sets a mask bit depending on the bits above and below it
+void erode_row_vertical(const uint64_t* prev, const uint64_t* curr,
+                        const uint64_t* next, uint64_t* out, const int num_chunks);
+void dilate_row_vertical(const uint64_t* prev, const uint64_t* curr,
+                         const uint64_t* next, uint64_t* out, const int num_chunks);
+
+// Scales the RGB components by 'factor' / 256 with rounding; the alpha
+// component is cleared
+uint32_t scale_rgb(const uint32_t color, const int factor);
+
+// ORs the RGB components of the 64 'in' pixels whose mask bits are set,
+// scaled by 'rgb_scale_factor' / 256, onto the 'out' pixels
+void apply_masked_bleed_64(uint64_t mask, const uint32_t* in, uint32_t* out,
+                           const int rgb_scale_factor);
+
+namespace scalar {
+
+void threshold_row(const uint32_t* pixels, const uint32_t bg_color,
+                   uint64_t* mask, const int num_chunks);
+
+void erode_row_horizontal(const uint64_t* in, uint64_t* out, const int num_chunks);
+void dilate_row_horizontal(const uint64_t* in, uint64_t* out, const int num_chunks);
+
+void erode_row_vertical(const uint64_t* prev, const uint64_t* curr,
+                        const uint64_t* next, uint64_t* out, const int num_chunks);
+void dilate_row_vertical(const uint64_t* prev, const uint64_t* curr,
+                         const uint64_t* next, uint64_t* out, const int num_chunks);
+
+void apply_masked_bleed_64(uint64_t mask, const uint32_t* in, uint32_t* out,
+                           const int rgb_scale_factor);
+
+} // namespace scalar
+
+#endif // DOSBOX_RENDER_DEINTERLACER_KERNELS_H
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_RENDER_DIRTY_ROWS_H
+#define DOSBOX_RENDER_DIRTY_ROWS_H
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "gui/private/common.h"
+
+// Bitmap of the framebuffer rows that have changed since they were last
+// uploaded to the GPU.
+//
+// The render backends copy only the rows changed in the current frame to
+// their "last" framebuffer, and accumulate them here because frames can be
+// skipped between uploads in host-rate presentation mode.
+//
+class DirtyRows {
+public:
+	// Resizes the bitmap and marks all rows dirty
+	void Resize(const int num_rows)
+	{
+		assert(num_rows >= 0);
+		is_dirty.assign(static_cast<size_t>(num_rows), true);
+	}
+
+	int GetNumRows() const
+	{
+		return static_cast<int>(is_dirty.size());
+	}
+
+	// Calls 'func' with every range of 'rows', clipped to the framebuffer.
+	// An empty list means the whole framebuffer has changed.
+	template <typename Func>
+	void ForEachChanged(const std::vector<DirtyRowRange>& rows, Func func) const
+	{
+		const auto num_rows = GetNumRows();
+
+		if (rows.empty()) {
+			func(DirtyRowRange{0, num_rows});
+			return;
+		}
+		for (const auto& range : rows) {
+			const auto first = std::clamp(range.first_row, 0, num_rows);
+			const auto last = std::clamp(range.first_row + range.num_rows,
+			                             first,
+			                             num_rows);
+			if (last > first) {
+				func(DirtyRowRange{first, last - first});
+			}
+		}
+	}
+
+	void Mark(const DirtyRowRange& range)
+	{
+		const auto begin = is_dirty.begin() + range.first_row;
+		std::fill(begin, begin + range.num_rows, true);
+	}
+
+	// Calls 'func' with the dirty row ranges, then clears the bitmap. Runs
+	// separated by only a few clean rows are merged to save on uploads.
+	template <typename Func>
+	void Flush(Func func)
+	{
+		constexpr auto MaxMergedGap = 8;
+
+		const auto num_rows = GetNumRows();
+
+		auto row = 0;
+		while (row < num_rows) {
+			if (!is_dirty[static_cast<size_t>(row)]) {
+				++row;
+				continue;
+			}
+
+			const auto first = row;
+			auto last        = row + 1;
+
+			for (row = last; row < num_rows && row - last <= MaxMergedGap;
+			     ++row) {
+				if (is_dirty[static_cast<size_t>(row)]) {
+					last = row + 1;
+				}
+			}
+
+			func(DirtyRowRange{first, last - first});
+			row = last;
+		}
+
+		std::fill(is_dirty.begin(), is_dirty.end(), false);
+	}
+
+private:
+	std::vector<bool> is_dirty = {};
+};
+
+#endif // DOSBOX_RENDER_DIRTY_ROWS_H
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_RENDER_LINE_PIPELINE_H
+#define DOSBOX_RENDER_LINE_PIPELINE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Hands the scanlines of the emulated video output to a worker thread that
+// runs the scaler line handlers on them, in order, while the emulation
+// continues.
+//
+// The lines are copied into a small ring of slots on submission, so the
+// VGA emulation can reuse its line buffer immediately. Submitting blocks
+// only while all slots are in use.
+//
+class LinePipeline {
+public:
+	using LineHandler = std::function<void(const void* line)>;
+
+	LinePipeline(LineHandler handler, const char* thread_name);
+	~LinePipeline();
+
+	// Sets the number of bytes to copy per line; waits for the pending
+	// lines first
+	void SetLineSize(const size_t num_bytes);
+
+	// Queues a line for the worker thread; the line can be null, like the
+	// lines passed to the scaler line handlers
+	void Submit(const void* line);
+
+	// Blocks until all submitted lines have been processed
+	void Wait();
+
+	// prevent copying
+	LinePipeline(const LinePipeline&) = delete;
+	// prevent assignment
+	LinePipeline& operator=(const LinePipeline&) = delete;
+
+private:
+	void ProcessLines();
+
+	struct Slot {
+		std::vector<uint8_t> data = {};
+		bool has_data             = false;
+	};
+
+	LineHandler handler = {};
+
+	std::vector<Slot> slots = {};
+	size_t line_size        = 0;
+
+	std::mutex mutex                      = {};
+	std::condition_variable has_work      = {};
+	std::condition_variable has_processed = {};
+
+	// Running counts; the slot of a line is its count modulo the number
+	// of slots
+	size_t num_submitted = 0;
+	size_t num_processed = 0;
+
+	bool is_stopping = false;
+
+	std::thread worker = {};
+};
+
+#endif // DOSBOX_RENDER_LINE_PIPELINE_H
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_SHADER_BINARY_CACHE_H
+#define DOSBOX_SHADER_BINARY_CACHE_H
+
+#include "dosbox_config.h"
+
+#if C_OPENGL
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "misc/std_filesystem.h"
+
+#include "glad/gl.h"
+
+// On-disk cache of linked shader programs in the driver's own binary format
+// (ARB_get_program_binary), so shaders don't have to be compiled from source
+// on every start. Compiling complex shaders (e.g., the CRT shaders) takes
+// hundreds of milliseconds on some drivers.
+//
+// The programs are keyed by their GLSL source and the OpenGL vendor, renderer
+// and version strings, so an updated driver doesn't load stale binaries. The
+// driver can still reject a cached binary, in which case Load() fails and the
+// caller should compile the source and Store() the result.
+//
+// All methods require a current OpenGL context.
+//
+class ShaderBinaryCache {
+public:
+	// The cache stays disabled if the driver doesn't support program
+	// binaries. `gl_version` is the version returned by `gladLoadGL()`.
+	void Init(const int gl_version, const std::string& driver_id);
+
+	// Returns a linked program created from the cached binary
+	std::optional<GLuint> Load(const std::string& shader_source);
+
+	// Must be called on a new program before linking it, otherwise some
+	// drivers don't make the binary retrievable
+	void PrepareProgram(const GLuint program) const;
+
+	void Store(const std::string& shader_source, const GLuint program);
+
+private:
+	using GetProgramBinaryProc = void(GLAD_API_PTR*)(GLuint program,
+	                                                 GLsizei buf_size,
+	                                                 GLsizei* length,
+	                                                 GLenum* binary_format,
+	                                                 void* binary);
+
+	using ProgramBinaryProc = void(GLAD_API_PTR*)(GLuint program,
+	                                              GLenum binary_format,
+	                                              const void* binary,
+	                                              GLsizei length);
+
+	using ProgramParameteriProc = void(GLAD_API_PTR*)(GLuint program,
+	                                                  GLenum pname, GLint value);
+
+	uint64_t GetKey(const std::string& shader_source) const;
+	std_fs::path GetPath(const uint64_t key, const char* extension) const;
+
+	// Not part of the OpenGL 3.3 API the loader provides
+	GetProgramBinaryProc get_program_binary  = nullptr;
+	ProgramBinaryProc program_binary         = nullptr;
+	ProgramParameteriProc program_parameteri = nullptr;
+
+	std::string driver_id  = {};
+	std_fs::path cache_dir = {};
+
+	bool is_enabled = false;
+};
+
+#endif // C_OPENGL
+
+#endif // DOSBOX_SHADER_BINARY_CACHE_H
@@ -9,30 +9,67 @@
 #include <cstdlib>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include "gui/private/auto_image_adjustments.h"
+#include "gui/render/private/line_pipeline.h"
 
 #include "capture/capture.h"
+#include "capture/shared_memory_output.h"
 #include "config/config.h"
 #include "config/setup.h"
 #include "gui/common.h"
 #include "gui/mapper.h"
+#include "gui/perf_overlay.h"
 #include "gui/render/render.h"
 #include "gui/render/render_backend.h"
+#include "hardware/timer.h"
 #include "hardware/video/vga.h"
 #include "misc/notifications.h"
 #include "misc/support.h"
+#include "misc/tracing.h"
 #include "misc/video.h"
 #include "shell/shell.h"
 #include "utils/checks.h"
 #include "utils/fraction.h"
 #include "utils/math_utils.h"
 #include "utils/string_utils.h"
+#include "webserver/webserver.h"
 
 CHECK_NARROWING();
 
 Render render;
-ScalerLineHandler RENDER_DrawLine;
+
+static void empty_line_handler(const void*) {}
+
+// The line handler of the current rendering stage. The handlers below switch
+// it as the frame progresses (e.g., on the first changed line).
+static ScalerLineHandler draw_line = empty_line_handler;
+
+// Runs the line handlers on a worker thread if 'threaded_rendering' is on
+static std::unique_ptr<LinePipeline> line_pipeline = {};
+
+static void forward_line_handler(const void* src_line_data)
+{
+	draw_line(src_line_data);
+}
+
+static void submit_line_handler(const void* src_line_data)
+{
+	if (render.render_in_progress) {
+		line_pipeline->Submit(src_line_data);
+	}
+}
+
+ScalerLineHandler RENDER_DrawLine = forward_line_handler;
+
+// Must be called before touching any state the line handlers use
+static void wait_for_line_handlers()
+{
+	if (line_pipeline) {
+		line_pipeline->Wait();
+	}
+}
 
 static void render_callback(GFX_CallbackFunctions_t function);
 
@@ -90,6 +127,10 @@ static bool is_deinterlacing()
 	return (render.deinterlacing_strength != DeinterlacingStrength::Off);
 }
 
+// Set when the frame being rendered has a new palette but otherwise
+// unchanged pixel data
+static bool has_palette_update = false;
+
 static bool maybe_gfx_start_update()
 {
 	uint32_t* pixel_data = nullptr;
@@ -118,8 +159,6 @@ static bool maybe_gfx_start_update()
 	return true;
 }
 
-static void empty_line_handler(const void*) {}
-
 static void start_line_handler(const void* src_line_data)
 {
 	if (src_line_data) {
@@ -136,7 +175,7 @@ static void start_line_handler(const void* src_line_data)
 			// swap followed by a texture upload to the GPU.
 			//
 			if (!maybe_gfx_start_update()) {
-				RENDER_DrawLine = empty_line_handler;
+				draw_line = empty_line_handler;
 				return;
 			}
 
@@ -145,8 +184,8 @@ static void start_line_handler(const void* src_line_data)
 
 			render.updating_frame = true;
 
-			RENDER_DrawLine = render.scale.line_handler;
-			RENDER_DrawLine(src_line_data);
+			draw_line = render.scale.line_handler;
+			draw_line(src_line_data);
 			return;
 		}
 	}
@@ -167,37 +206,10 @@ static void finish_line_handler(const void* src_line_data)
 	render.scale.cache_read += render.scale.cache_pitch;
 }
 
-static void clear_cache_handler(const void* src_line_data)
-{
-	// `src_line_data` contains a scanline worth of pixel data. All screen
-	// mode widths are multiples of 8, therefore we can access this data one
-	// uint64_t at a time, regardless of pixel format (pixel can be stored
-	// on 1 to 4 bytes).
-	auto src = static_cast<const uint8_t*>(src_line_data);
-
-	// The width of all screen modes and therefore `cache_pitch` too is a
-	// multiple of 8 (`cache_pitch` equals the screen mode's width
-	// multiplied by the number of bytes per pixel and no padding).
-	//
-	auto cache = render.scale.cache_read;
-
-	constexpr auto Step = sizeof(uint64_t);
-	const auto count    = render.scale.cache_pitch / Step;
-
-	for (size_t x = 0; x < count; ++x) {
-		const auto src_val = read_unaligned_uint64(src);
-
-		write_unaligned_uint64(cache, ~src_val);
-
-		src += Step;
-		cache += Step;
-	}
-
-	render.scale.line_handler(src_line_data);
-}
-
 bool RENDER_StartUpdate()
 {
+	wait_for_line_handlers();
+
 	if (render.render_in_progress) {
 		return false;
 	}
@@ -207,6 +219,14 @@ bool RENDER_StartUpdate()
 
 	if (render.scale.line_palette_handler) {
 		check_palette();
+
+	} else if (render.scale.is_indexed_output) {
+		check_palette();
+
+		// The backend's palette is set up again after a reset
+		if (render.palette.changed || render.scale.clear_cache) {
+			GFX_SetPalette(render.palette.lut);
+		}
 	}
 
 	render.scale.cache_read = reinterpret_cast<uint8_t*>(
@@ -236,7 +256,8 @@ bool RENDER_StartUpdate()
 			return false;
 		}
 
-		RENDER_DrawLine = clear_cache_handler;
+		// The cache contents are stale, so convert every line
+		draw_line = render.scale.line_full_handler;
 
 		render.render_in_progress = true;
 		render.updating_frame     = true;
@@ -254,7 +275,12 @@ bool RENDER_StartUpdate()
 			return false;
 		}
 
-		RENDER_DrawLine = render.scale.line_palette_handler;
+		has_palette_update = true;
+
+		// With indexed output, only the palette has to be passed on
+		draw_line = render.scale.is_indexed_output
+		                  ? render.scale.line_handler
+		                  : render.scale.line_palette_handler;
 
 		render.render_in_progress = true;
 		return true;
@@ -267,7 +293,7 @@ bool RENDER_StartUpdate()
 	// `start_line_handler()` if the contents of the current frame differs
 	// from the previous one (see comments in `start_line_handler()`).
 	//
-	RENDER_DrawLine = start_line_handler;
+	draw_line = start_line_handler;
 
 	render.render_in_progress = true;
 	return true;
@@ -275,7 +301,9 @@ bool RENDER_StartUpdate()
 
 static void halt_render()
 {
-	RENDER_DrawLine = empty_line_handler;
+	wait_for_line_handlers();
+
+	draw_line = empty_line_handler;
 	GFX_EndUpdate();
 
 	render.render_in_progress = false;
@@ -318,6 +346,34 @@ static void handle_capture_frame()
 	}
 }
 
+// The raw frame before scaling, as passed to the frame consumers other than
+// the capturers
+static RenderedImage get_rendered_image()
+{
+	RenderedImage image = {};
+
+	image.params = render.src;
+	image.pitch  = render.scale.cache_pitch;
+
+	image.image_data = reinterpret_cast<uint8_t*>(render.scale.cache.data());
+
+	image.palette = render.palette.rgb;
+
+	return image;
+}
+
+static bool is_frame_dirty()
+{
+	return render.updating_frame || has_palette_update;
+}
+
+static void handle_shared_memory_output()
+{
+	SHM_OUTPUT_AddFrame(get_rendered_image(),
+	                    static_cast<float>(render.fps),
+	                    is_frame_dirty());
+}
+
 static void deinterlace_rendered_output()
 {
 	// Copy scaled & deinterlaced output into the render backend's
@@ -346,27 +402,102 @@ static void deinterlace_rendered_output()
 	render.deinterlacer->Deinterlace(image, render.deinterlacing_strength);
 }
 
+// Converts the alternating runs of unchanged and changed output rows
+// recorded by the scalers (starting with an unchanged run) into row ranges
+static void get_dirty_rows(std::vector<DirtyRowRange>& dirty_rows)
+{
+	dirty_rows.clear();
+
+	auto row = 0;
+	for (auto i = 0; i <= scaler_changed_line_index; ++i) {
+		const auto num_rows = scaler_changed_lines[static_cast<size_t>(i)];
+
+		const auto is_changed = (i % 2 == 1);
+		if (is_changed && num_rows > 0) {
+			dirty_rows.push_back({row, num_rows});
+		}
+		row += num_rows;
+	}
+}
+
+bool RENDER_IsFrameUpdateRequired()
+{
+	return render.scale.clear_cache || render.palette.changed ||
+	       CAPTURE_IsCapturingImage() || CAPTURE_IsCapturingVideo() ||
+	       DOSBOX_IsBenchmarkRunning();
+}
+
+bool RENDER_IsSkippingFrame()
+{
+	const auto max_skipped_frames = [] {
+		if (DOSBOX_IsFastForwarding()) {
+			return render.fast_forward_frameskip;
+		}
+		// Keep the audio flowing at the expense of the frame rate
+		if (DOSBOX_IsFallingBehind()) {
+			return render.adaptive_frameskip;
+		}
+		return 0;
+	}();
+
+	if (max_skipped_frames == 0 || RENDER_IsFrameUpdateRequired()) {
+		render.num_skipped_frames = 0;
+		return false;
+	}
+
+	if (render.num_skipped_frames < max_skipped_frames) {
+		++render.num_skipped_frames;
+		return true;
+	}
+	render.num_skipped_frames = 0;
+	return false;
+}
+
 void RENDER_EndUpdate([[maybe_unused]] bool abort)
 {
+	TRACE_SCOPE("RENDER_EndUpdate");
+
 	if (!render.render_in_progress) {
 		return;
 	}
 
-	RENDER_DrawLine = empty_line_handler;
+	const auto start_us = GetTicksUs();
+
+	wait_for_line_handlers();
+
+	draw_line = empty_line_handler;
 
 	if (CAPTURE_IsCapturingImage() || CAPTURE_IsCapturingVideo()) {
 		handle_capture_frame();
 	}
 
+	if (SHM_OUTPUT_IsEnabled()) {
+		handle_shared_memory_output();
+	}
+	WEBSERVER_AddFrame(get_rendered_image(), is_frame_dirty());
+	has_palette_update = false;
+
 	// Only deinterlace the output if the frame has changed
 	if (is_deinterlacing() && render.updating_frame) {
 		deinterlace_rendered_output();
 	}
 
-	GFX_EndUpdate();
+	// The deinterlacer rewrites the whole backend buffer; otherwise only
+	// the rows the scalers have changed need to be presented again
+	static std::vector<DirtyRowRange> dirty_rows = {};
+
+	if (is_deinterlacing()) {
+		dirty_rows.clear();
+	} else {
+		get_dirty_rows(dirty_rows);
+	}
+
+	GFX_EndUpdate(dirty_rows);
 
 	render.render_in_progress = false;
 	render.updating_frame     = false;
+
+	PERF_OVERLAY_NotifyFrameRendered(GetTicksUsSince(start_us));
 }
 
 static SectionProp& get_render_section()
@@ -391,6 +522,9 @@ static void render_reset()
 		return;
 	}
 
+	// The scalers and the framebuffer are about to change
+	wait_for_line_handlers();
+
 	// Despite rendering being a single-threaded sequence, the Reset() can
 	// be called from the rendering callback, which might come from a video
 	// driver operating in a different thread or process.
@@ -400,30 +534,31 @@ static void render_reset()
 	bool double_width   = render.src.double_width;
 	bool double_height  = render.src.double_height;
 
-	auto scaler = &Scale1x;
+	auto x_scale = double_width ? 2 : 1;
+	auto y_scale = double_height ? 2 : 1;
 
-	if (double_height && double_width) {
-		scaler = &Scale2x;
-	} else if (double_width) {
-		scaler = &ScaleHoriz2x;
-	} else if (double_height) {
-		scaler = &ScaleVert2x;
-	} else {
-		scaler = &Scale1x;
-	}
+	render.scale.y_scale = y_scale;
 
-	render.scale.y_scale = scaler->y_scale;
-
-	if ((render_width_px * scaler->x_scale > ScalerMaxWidth) ||
-	    (render.src.height * scaler->y_scale > ScalerMaxHeight)) {
-		scaler = &Scale1x;
+	if ((render_width_px * x_scale > ScalerMaxWidth) ||
+	    (render.src.height * y_scale > ScalerMaxHeight)) {
+		x_scale = 1;
+		y_scale = 1;
 	}
 
-	render_width_px *= scaler->x_scale;
-	const auto render_height_px = render.src.height * scaler->y_scale;
+	render_width_px *= x_scale;
+	const auto render_height_px = render.src.height * y_scale;
 
 	const auto render_pixel_aspect_ratio = render.src.pixel_aspect_ratio;
 
+	// Paletted video modes are passed to the render backend as 8-bit
+	// palette indexes if it can do the palette lookup on the GPU. This
+	// quarters the upload size, and palette changes don't require
+	// converting the whole frame again. The deinterlacer only works with
+	// 32-bit pixels.
+	render.scale.is_indexed_output = GFX_SetIndexedFrames(
+	        render.src.pixel_format == PixelFormat::Indexed8 &&
+	        !is_deinterlacing());
+
 	GFX_SetSize(render_width_px,
 	            render_height_px,
 	            render_pixel_aspect_ratio,
@@ -433,35 +568,34 @@ static void render_reset()
 	            &render_callback);
 
 	// Set up scaler variables
+	auto source = ScalerSource::Indexed8;
+
 	switch (render.src.pixel_format) {
 	case PixelFormat::Indexed8:
-		render.scale.line_handler         = scaler->line_handlers[0];
-		render.scale.line_palette_handler = scaler->line_handlers[5];
-		render.scale.cache_pitch          = render.src.width * 1;
+		source = render.scale.is_indexed_output
+		               ? ScalerSource::Indexed8Passthrough
+		               : ScalerSource::Indexed8;
+		render.scale.cache_pitch = render.src.width * 1;
 		break;
 
 	case PixelFormat::RGB555_Packed16:
-		render.scale.line_handler         = scaler->line_handlers[1];
-		render.scale.line_palette_handler = nullptr;
-		render.scale.cache_pitch          = render.src.width * 2;
+		source                   = ScalerSource::Rgb555;
+		render.scale.cache_pitch = render.src.width * 2;
 		break;
 
 	case PixelFormat::RGB565_Packed16:
-		render.scale.line_handler         = scaler->line_handlers[2];
-		render.scale.line_palette_handler = nullptr;
-		render.scale.cache_pitch          = render.src.width * 2;
+		source                   = ScalerSource::Rgb565;
+		render.scale.cache_pitch = render.src.width * 2;
 		break;
 
 	case PixelFormat::BGR24_ByteArray:
-		render.scale.line_handler         = scaler->line_handlers[3];
-		render.scale.line_palette_handler = nullptr;
-		render.scale.cache_pitch          = render.src.width * 3;
+		source                   = ScalerSource::Bgr24;
+		render.scale.cache_pitch = render.src.width * 3;
 		break;
 
 	case PixelFormat::BGRX32_ByteArray:
-		render.scale.line_handler         = scaler->line_handlers[4];
-		render.scale.line_palette_handler = nullptr;
-		render.scale.cache_pitch          = render.src.width * 4;
+		source                   = ScalerSource::Bgrx32;
+		render.scale.cache_pitch = render.src.width * 4;
 		break;
 
 	default:
@@ -469,6 +603,32 @@ static void render_reset()
 		       static_cast<uint8_t>(render.src.pixel_format));
 	}
 
+	constexpr auto IsChangeDetecting = true;
+
+	render.scale.line_handler = SCALER_GetLineHandler(source,
+	                                                  x_scale,
+	                                                  y_scale,
+	                                                  IsChangeDetecting);
+
+	render.scale.line_full_handler = SCALER_GetLineHandler(source,
+	                                                       x_scale,
+	                                                       y_scale,
+	                                                       !IsChangeDetecting);
+
+	// Palette changes have to be picked up by the unchanged pixels too,
+	// unless the render backend does the palette lookup
+	render.scale.line_palette_handler =
+	        (source == ScalerSource::Indexed8)
+	                ? SCALER_GetLineHandler(ScalerSource::Indexed8PaletteCheck,
+	                                        x_scale,
+	                                        y_scale,
+	                                        IsChangeDetecting)
+	                : nullptr;
+
+	if (line_pipeline) {
+		line_pipeline->SetLineSize(render.scale.cache_pitch);
+	}
+
 	// Reset the palette change detection to its initial value
 	render.palette.first   = 0;
 	render.palette.last    = 255;
@@ -476,7 +636,7 @@ static void render_reset()
 	memset(render.palette.modified, 0, sizeof(render.palette.modified));
 
 	// Finish this frame using a copy only handler
-	RENDER_DrawLine        = finish_line_handler;
+	draw_line              = finish_line_handler;
 	render.scale.out_write = nullptr;
 
 	// Signal the next frame to first reinit the cache
@@ -486,6 +646,8 @@ static void render_reset()
 
 static void render_callback(GFX_CallbackFunctions_t function)
 {
+	wait_for_line_handlers();
+
 	if (function == GFX_CallbackStop) {
 		halt_render();
 		return;
@@ -1493,6 +1655,11 @@ constexpr int ColorTemperatureLumaPreserveMax = 100;
 constexpr int RgbGainMin = 0;
 constexpr int RgbGainMax = 200;
 
+constexpr int DefaultFastForwardFrameskip = 4;
+constexpr int MaxFastForwardFrameskip     = 60;
+
+constexpr int MaxAdaptiveFrameskip = 10;
+
 static void init_render_settings(SectionProp& section)
 {
 	using enum Property::Changeable::Value;
@@ -1931,6 +2098,35 @@ static void init_render_settings(SectionProp& section)
 	                   RgbGainMin,
 	                   RgbGainMax));
 
+	int_prop = section.AddInt("fast_forward_frameskip",
+	                          Always,
+	                          DefaultFastForwardFrameskip);
+	int_prop->SetMinMax(0, MaxFastForwardFrameskip);
+	int_prop->SetHelp(
+	        format_str("Number of frames to skip between presented frames while fast-forwarding\n"
+	                   "(%d by default). The skipped frames are not drawn, scaled, or presented at\n"
+	                   "all, so fast-forwarding isn't held back by the video output. Valid range is\n"
+	                   "0 to %d; 0 presents every frame. Captures always get every frame.",
+	                   DefaultFastForwardFrameskip,
+	                   MaxFastForwardFrameskip));
+
+	int_prop = section.AddInt("adaptive_frameskip", Always, 0);
+	int_prop->SetMinMax(0, MaxAdaptiveFrameskip);
+	int_prop->SetHelp(
+	        format_str("Skip drawing frames while the host can't keep up with the emulation, to\n"
+	                   "prioritise smooth audio over smooth video (0 by default). Sets the maximum\n"
+	                   "number of consecutive frames to skip; valid range is 0 to %d, and 0 disables\n"
+	                   "frame skipping. Only the drawing and presentation of the frames is skipped;\n"
+	                   "the emulated video timings and retraces are not affected.",
+	                   MaxAdaptiveFrameskip));
+
+	bool_prop = section.AddBool("threaded_rendering", OnlyAtStart, false);
+	bool_prop->SetHelp(
+	        "Scale the emulated video output on a separate thread ('off' by default).\n"
+	        "The VGA emulation still renders each scanline at the exact emulated time, but\n"
+	        "the scaling and change detection continues on another CPU core. This can\n"
+	        "speed up high-resolution SVGA modes on multi-core hosts.");
+
 	string_prop = section.AddString("deinterlacing", Always, "off");
 	string_prop->SetValues({"on", "off", "light", "medium", "strong", "full"});
 	string_prop->SetHelp(
@@ -2683,6 +2879,17 @@ void RENDER_Init()
 	set_image_adjustment_settings();
 
 	set_deinterlacing(*section);
+
+	render.fast_forward_frameskip = section->GetInt("fast_forward_frameskip");
+	render.adaptive_frameskip     = section->GetInt("adaptive_frameskip");
+
+	if (section->GetBool("threaded_rendering") && !line_pipeline) {
+		line_pipeline = std::make_unique<LinePipeline>(
+		        [](const void* src_line_data) { draw_line(src_line_data); },
+		        "dosbox:render");
+
+		RENDER_DrawLine = submit_line_handler;
+	}
 }
 
 static void notify_render_setting_updated(SectionProp& section,
@@ -2717,6 +2924,12 @@ static void notify_render_setting_updated(SectionProp& section,
 		set_integer_scaling(section);
 		reinit_drawing();
 
+	} else if (prop_name == "fast_forward_frameskip") {
+		render.fast_forward_frameskip = section.GetInt(prop_name);
+
+	} else if (prop_name == "adaptive_frameskip") {
+		render.adaptive_frameskip = section.GetInt(prop_name);
+
 	} else if (prop_name == "monochrome_palette") {
 		set_monochrome_palette(section);
 		update_black_level_color_setting();
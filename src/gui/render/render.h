@@ -90,6 +90,13 @@ struct Render {
 		ScalerLineHandler line_handler         = nullptr;
 		ScalerLineHandler line_palette_handler = nullptr;
 
+		// Converts the whole line without comparing it to the cache
+		ScalerLineHandler line_full_handler = nullptr;
+
+		// Paletted video modes are output as palette indexes, and the
+		// render backend does the palette lookup
+		bool is_indexed_output = false;
+
 		int cache_pitch     = 0;
 		uint8_t* cache_read = nullptr;
 
@@ -115,6 +122,14 @@ struct Render {
 	bool render_in_progress = false;
 	bool updating_frame     = false;
 
+	// Maximum number of frames not drawn between presented ones while
+	// fast-forwarding, and while the host can't keep up, respectively
+	int fast_forward_frameskip = 0;
+	int adaptive_frameskip     = 0;
+
+	// Frames skipped since the last drawn one
+	int num_skipped_frames = 0;
+
 	AspectRatioCorrectionMode aspect_ratio_correction_mode = {};
 	IntegerScalingMode integer_scaling_mode                = {};
 
@@ -262,6 +277,17 @@ void RENDER_SetSize(const ImageInfo& image_info, const double frames_per_second)
 bool RENDER_StartUpdate();
 void RENDER_EndUpdate(bool abort);
 
+// Returns true if the next frame must be rendered even if the emulated video
+// output hasn't changed; e.g., after the scaler cache has been cleared or
+// while capturing.
+bool RENDER_IsFrameUpdateRequired();
+
+// Returns true if the next frame should not be drawn at all, because the
+// emulation is being fast-forwarded or the host can't keep up with it (see
+// the 'fast_forward_frameskip' and 'adaptive_frameskip' settings). The
+// emulated video timings are not affected.
+bool RENDER_IsSkippingFrame();
+
 void RENDER_SetPalette(const uint8_t entry, const uint8_t red,
                        const uint8_t green, const uint8_t blue);
 
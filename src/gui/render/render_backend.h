@@ -7,7 +7,9 @@
 #include "gui/private/common.h"
 #include "gui/private/shader_manager.h"
 
+#include <span>
 #include <string>
+#include <vector>
 
 #include "dosbox_config.h"
 #include "gui/render/render.h"
@@ -75,6 +77,18 @@ public:
 	// (see `ShaderManager::NotifyShaderChanged()`.
 	virtual std::string GetCurrentSymbolicShaderDescriptor() = 0;
 
+	// Requests the frames of paletted video modes as 8-bit palette indexes
+	// (one byte per pixel) rather than 32-bit pixels, with the colours
+	// looked up from the palette set by `SetPalette()` when presenting the
+	// frame. Returns true if the renderer supports this; the frames are
+	// 32-bit pixels otherwise. Followed by a `NotifyRenderSizeChanged()`
+	// call.
+	virtual bool SetIndexedFrames(const bool is_enabled) = 0;
+
+	// Sets the palette of indexed frames, as `NumVgaColors` pixels made by
+	// `MakePixel()`. Applies to the frames ended after the call.
+	virtual void SetPalette(std::span<const uint32_t> lut) = 0;
+
 	// Called at the start of every unique frame (when there have been
 	// changes to the DOS framebuffer).
 	//
@@ -93,10 +107,15 @@ public:
 	// Called at the end of every frame. There is a matching EndUpdate()
 	// call for every StartUpdate() call.
 	//
+	// `dirty_rows` lists the rows the video emulation has written in this
+	// frame; an empty list means any row might have changed.
+	//
 	// If a renderer implements a double buffering scheme, this call should
-	// swap the "current" and "last" buffers.
+	// update the "last" buffer from the "current" one. Only the dirty rows
+	// need to be copied, and only those need to be uploaded to the GPU by
+	// the next PrepareFrame() call.
 	//
-	virtual void EndFrame() = 0;
+	virtual void EndFrame(const std::vector<DirtyRowRange>& dirty_rows) = 0;
 
 	// Prepares the frame for presentation (e.g., by uploading it to
 	// GPU memory).
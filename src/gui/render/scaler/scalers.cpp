@@ -2,25 +2,23 @@
 // SPDX-FileCopyrightText:  2002-2021 The DOSBox Team
 // SPDX-License-Identifier: GPL-2.0-or-later
 
-// TODO:
-// Maybe just do the cache checking back into the simple scalers so they can
-// just handle it all in one go, but this seems to work well enough for now
-
 #include "dosbox.h"
 
 #include "gui/private/common.h"
 #include "gui/render/render.h"
 
 #include <array>
+#include <cassert>
 #include <cstring>
+#include <type_traits>
+
+#include "simde/x86/sse2.h"
+#include "utils/rgb888.h"
 
 std::array<int, ScalerMaxHeight> scaler_changed_lines = {};
 
 int scaler_changed_line_index = 0;
 
-#define _conc3(A, B, C) A##B##C
-#define conc2d(A, B)    _conc3(A, _, B)
-
 static inline void scaler_add_lines(int changed, int count)
 {
 	if ((scaler_changed_line_index & 1) == changed) {
@@ -31,62 +29,231 @@ static inline void scaler_add_lines(int changed, int count)
 	render.scale.out_write += render.scale.out_pitch * count;
 }
 
-/* Include the different rendering routines */
-#define SBPP 8
-#include "templates.h"
-#undef SBPP
-
-/* SBPP 9 is a special case with palette check support */
-#define SBPP 9
-#include "templates.h"
-#undef SBPP
-
-#define SBPP 15
-#include "templates.h"
-#undef SBPP
-
-#define SBPP 16
-#include "templates.h"
-#undef SBPP
-
-#define SBPP 24
-#include "templates.h"
-#undef SBPP
-
-#define SBPP 32
-#include "templates.h"
-#undef SBPP
-
-// clang-format off
-
-Scaler Scale1x = {
-        1,
-        1,
-        {Scale1x_8,  Scale1x_15, Scale1x_16,
-         Scale1x_24, Scale1x_32, Scale1x_9}
-};
-
-// Renders double-wide DOS video modes
-Scaler ScaleHoriz2x = {
-        2,
-        1,
-        {ScaleHoriz2x_8,  ScaleHoriz2x_15, ScaleHoriz2x_16,
-         ScaleHoriz2x_24, ScaleHoriz2x_32, ScaleHoriz2x_9}
-};
-
-// Renders double-high DOS video modes
-Scaler ScaleVert2x = {
-        1,
-        2,
-        {ScaleVert2x_8,  ScaleVert2x_15, ScaleVert2x_16,
-         ScaleVert2x_24, ScaleVert2x_32, ScaleVert2x_9}
-};
-
-Scaler Scale2x = {
-        2,
-        2,
-        {Scale2x_8 , Scale2x_15, Scale2x_16,
-         Scale2x_24, Scale2x_32, Scale2x_9}
-};
-
-// clang-format on
+constexpr bool is_indexed(const ScalerSource source)
+{
+	return source == ScalerSource::Indexed8 ||
+	       source == ScalerSource::Indexed8PaletteCheck ||
+	       source == ScalerSource::Indexed8Passthrough;
+}
+
+// The source pixels are stored on 1 to 4 bytes; Rgb888 is a packed 3-byte
+// struct
+template <ScalerSource Source>
+using SourcePixel = std::conditional_t<
+        is_indexed(Source), uint8_t,
+        std::conditional_t<Source == ScalerSource::Rgb555 || Source == ScalerSource::Rgb565,
+                           uint16_t,
+                           std::conditional_t<Source == ScalerSource::Bgr24, Rgb888, uint32_t>>>;
+
+// The output pixel format is 32-bit BGRX, or 8-bit palette indexes if the
+// render backend does the palette lookup
+template <ScalerSource Source>
+using OutputPixel = std::conditional_t<Source == ScalerSource::Indexed8Passthrough,
+                                       uint8_t, uint32_t>;
+
+template <ScalerSource Source>
+static OutputPixel<Source> to_output_pixel(const SourcePixel<Source> pixel)
+{
+	if constexpr (Source == ScalerSource::Indexed8 ||
+	              Source == ScalerSource::Indexed8PaletteCheck) {
+		return render.palette.lut[pixel];
+
+	} else if constexpr (Source == ScalerSource::Rgb555) {
+		// xRRRrrGGGggBBBbb -> RRRrrRRRGGGggGGGBBBbbBBB
+		const uint32_t v = pixel;
+		return ((v & (31 << 10)) << 9) | ((v & (31 << 5)) << 6) |
+		       ((v & 31) << 3) | ((v & (7 << 12)) << 4) |
+		       ((v & (7 << 7)) << 1) | ((v & (7 << 2)) >> 2);
+
+	} else if constexpr (Source == ScalerSource::Rgb565) {
+		// RRRrrGGggggBBBbb -> RRRrrRRRGGggggGGBBBbbBBB
+		const uint32_t v = pixel;
+		return ((v & (31 << 11)) << 8) | ((v & (63 << 5)) << 5) |
+		       ((v & 0xe01f) << 3) | ((v & (3 << 9)) >> 1) |
+		       ((v & (7 << 2)) >> 2);
+
+	} else if constexpr (Source == ScalerSource::Bgr24) {
+		return static_cast<uint32_t>(static_cast<int>(pixel));
+
+	} else {
+		// Palette indexes passed on as they are, and BGRX32 pixels
+		return pixel;
+	}
+}
+
+// The line and the line cache are compared this many bytes at a time
+constexpr size_t BlockSize = 16;
+
+static bool is_same_block(const void* a, const void* b)
+{
+	const auto eq = simde_mm_cmpeq_epi8(
+	        simde_mm_loadu_si128(static_cast<const simde__m128i*>(a)),
+	        simde_mm_loadu_si128(static_cast<const simde__m128i*>(b)));
+
+	return simde_mm_movemask_epi8(eq) == 0xffff;
+}
+
+static bool has_modified_palette_entry(const uint8_t* src, const int num_pixels)
+{
+	uint8_t modified = 0;
+	for (auto i = 0; i < num_pixels; ++i) {
+		modified |= render.palette.modified[src[i]];
+	}
+	return modified != 0;
+}
+
+template <ScalerSource Source, int XScale, int YScale, bool IsChangeDetecting>
+static void scale_line(const void* src_line_data)
+{
+	using Src = SourcePixel<Source>;
+	using Dst = OutputPixel<Source>;
+
+	// `src_line_data` contains a scanline worth of pixel data, and the line
+	// cache the previous frame's scanline, both without any extra padding.
+	// All screen mode widths are multiples of 8.
+	auto src   = static_cast<const Src*>(src_line_data);
+	auto cache = reinterpret_cast<Src*>(render.scale.cache_read);
+
+	render.scale.cache_read += render.scale.cache_pitch;
+
+	// `out_write` points to a buffer aligned to an 8-byte boundary at
+	// least
+	auto out = reinterpret_cast<Dst*>(render.scale.out_write);
+
+	const auto out_pitch = render.scale.out_pitch;
+
+	// Converts the pixels, which have been copied to the cache already
+	auto convert_pixels = [&](const int num_pixels) {
+		for (auto i = 0; i < num_pixels; ++i) {
+			const auto pixel = to_output_pixel<Source>(src[i]);
+
+			for (auto x = 0; x < XScale; ++x) {
+				out[x] = pixel;
+			}
+			if constexpr (YScale > 1) {
+				auto out_line1 = reinterpret_cast<Dst*>(
+				        reinterpret_cast<uint8_t*>(out) + out_pitch);
+
+				for (auto x = 0; x < XScale; ++x) {
+					out_line1[x] = pixel;
+				}
+			}
+			out += XScale;
+		}
+		src += num_pixels;
+		cache += num_pixels;
+	};
+
+	auto pixels_left = render.src.width;
+
+	if constexpr (!IsChangeDetecting) {
+		std::memcpy(cache, src, render.scale.cache_pitch);
+		convert_pixels(pixels_left);
+
+		scaler_add_lines(1, render.scale.y_scale);
+		return;
+	}
+
+	// Compare-and-copy the line one block at a time, converting only the
+	// blocks that differ from the cache. With 3-byte pixels, the last
+	// byte of a block belongs to the next pixel; that one is compared
+	// again with the next block.
+	constexpr auto PixelsPerBlock = static_cast<int>(BlockSize / sizeof(Src));
+
+	auto had_change = false;
+
+	auto is_unchanged = [&](const bool is_same_data, const int num_pixels) {
+		if constexpr (Source == ScalerSource::Indexed8PaletteCheck) {
+			return is_same_data &&
+			       !has_modified_palette_entry(src, num_pixels);
+		} else {
+			return is_same_data;
+		}
+	};
+
+	auto skip_pixels = [&](const int num_pixels) {
+		src += num_pixels;
+		cache += num_pixels;
+		out += num_pixels * XScale;
+	};
+
+	while (pixels_left * static_cast<int>(sizeof(Src)) >=
+	       static_cast<int>(BlockSize)) {
+		if (is_unchanged(is_same_block(src, cache), PixelsPerBlock)) {
+			skip_pixels(PixelsPerBlock);
+		} else {
+			std::memcpy(cache, src, PixelsPerBlock * sizeof(Src));
+			convert_pixels(PixelsPerBlock);
+			had_change = true;
+		}
+		pixels_left -= PixelsPerBlock;
+	}
+
+	// The pixels after the last whole block
+	if (pixels_left > 0) {
+		const auto num_bytes = static_cast<size_t>(pixels_left) * sizeof(Src);
+
+		if (is_unchanged(std::memcmp(src, cache, num_bytes) == 0, pixels_left)) {
+			skip_pixels(pixels_left);
+		} else {
+			std::memcpy(cache, src, num_bytes);
+			convert_pixels(pixels_left);
+			had_change = true;
+		}
+	}
+
+	scaler_add_lines(had_change ? 1 : 0, render.scale.y_scale);
+}
+
+template <ScalerSource Source, int XScale, int YScale>
+static ScalerLineHandler get_line_handler(const bool is_change_detecting)
+{
+	return is_change_detecting ? scale_line<Source, XScale, YScale, true>
+	                           : scale_line<Source, XScale, YScale, false>;
+}
+
+template <ScalerSource Source>
+static ScalerLineHandler get_line_handler(const int x_scale, const int y_scale,
+                                          const bool is_change_detecting)
+{
+	if (x_scale == 2) {
+		return (y_scale == 2)
+		             ? get_line_handler<Source, 2, 2>(is_change_detecting)
+		             : get_line_handler<Source, 2, 1>(is_change_detecting);
+	}
+	return (y_scale == 2) ? get_line_handler<Source, 1, 2>(is_change_detecting)
+	                      : get_line_handler<Source, 1, 1>(is_change_detecting);
+}
+
+ScalerLineHandler SCALER_GetLineHandler(const ScalerSource source,
+                                        const int x_scale, const int y_scale,
+                                        const bool is_change_detecting)
+{
+	assert(x_scale == 1 || x_scale == 2);
+	assert(y_scale == 1 || y_scale == 2);
+
+	using enum ScalerSource;
+
+	switch (source) {
+	case Indexed8:
+		return get_line_handler<Indexed8>(x_scale, y_scale, is_change_detecting);
+	case Indexed8PaletteCheck:
+		return get_line_handler<Indexed8PaletteCheck>(x_scale,
+		                                              y_scale,
+		                                              is_change_detecting);
+	case Indexed8Passthrough:
+		return get_line_handler<Indexed8Passthrough>(x_scale,
+		                                             y_scale,
+		                                             is_change_detecting);
+	case Rgb555:
+		return get_line_handler<Rgb555>(x_scale, y_scale, is_change_detecting);
+	case Rgb565:
+		return get_line_handler<Rgb565>(x_scale, y_scale, is_change_detecting);
+	case Bgr24:
+		return get_line_handler<Bgr24>(x_scale, y_scale, is_change_detecting);
+	case Bgrx32:
+		return get_line_handler<Bgrx32>(x_scale, y_scale, is_change_detecting);
+	}
+	assert(false);
+	return nullptr;
+}
@@ -6,15 +6,12 @@
 #define DOSBOX_RENDER_SCALERS_H
 
 #include <array>
+#include <cstdint>
 
 #include "misc/video.h"
 
 // The additional padding pixels are party for some tweaked text modes (e.g.,
 // Q200x25x8 used by Necromancer's DOS Navigator) plus as a safety margin.
-//
-// This ensures we're not going to crash in the 1600x1200 24-bit (BGR24)
-// 0x184 VESA mode when reading a few bytes beyond the end of the buffer (see
-// comment above `PixelsPerStep` in `scaler/simple.h`).
 
 // Make sure ScalerMaxWidth remains a multiple of 8
 constexpr int ScalerWidthExtraPadding = 8 * 5;
@@ -27,17 +24,36 @@ extern int scaler_changed_line_index;
 
 typedef void (*ScalerLineHandler)(const void* src);
 
-struct Scaler {
-	int x_scale = 0;
-	int y_scale = 0;
+// How the line handlers read the source pixels and write the output pixels
+enum class ScalerSource : uint8_t {
+	// Palette indexes converted to 32-bit BGRX pixels
+	Indexed8,
+
+	// As above, but the pixels whose palette entry has changed since the
+	// last frame count as changed too
+	Indexed8PaletteCheck,
 
-	ScalerLineHandler line_handlers[6] = {};
+	// Palette indexes passed on as they are, for render backends that do
+	// the palette lookup on the GPU
+	Indexed8Passthrough,
+
+	Rgb555,
+	Rgb565,
+	Bgr24,
+	Bgrx32,
 };
 
-// Simple scalers
-extern Scaler Scale1x;
-extern Scaler ScaleHoriz2x;
-extern Scaler ScaleVert2x;
-extern Scaler Scale2x;
+// Returns the line handler that converts the scanlines of 'source' pixels
+// and scales them by 'x_scale' and 'y_scale' (1 or 2 each). Every pixel
+// format and scale factor combination is a separate function, so the line
+// handlers don't branch on any of them per pixel.
+//
+// With change detection, only the pixels that differ from the line cache are
+// converted, and the unchanged lines aren't reported as changed. Without it,
+// the whole line is converted and copied to the cache (e.g., after the cache
+// has been invalidated).
+ScalerLineHandler SCALER_GetLineHandler(const ScalerSource source,
+                                        const int x_scale, const int y_scale,
+                                        const bool is_change_detecting);
 
 #endif // DOSBOX_RENDER_SCALERS_H
@@ -7,6 +7,7 @@
 
 #include "capture/capture.h"
 #include "config/setup.h"
+#include "misc/host_memory.h"
 #include "misc/video.h"
 #include "utils/checks.h"
 #include "utils/math_utils.h"
@@ -125,6 +126,8 @@ bool SdlRenderer::InitRenderer(const std::string& render_driver)
 
 SdlRenderer::~SdlRenderer()
 {
+	HOST_MEMORY_RemoveSubsystem("Framebuffers");
+
 	if (renderer) {
 		// Frees associated textures automatically.
 		SDL_DestroyRenderer(renderer);
@@ -243,6 +246,14 @@ void SdlRenderer::NotifyRenderSizeChanged(const int render_width_px,
 		LOG_ERR("SDL: Error creating input surface: %s", SDL_GetError());
 		return;
 	}
+
+	// The new texture has no contents yet
+	pending_upload_rows.Resize(render_height_px);
+
+	HOST_MEMORY_AddSubsystem("Framebuffers", [this] {
+		return static_cast<size_t>(curr_framebuf->pitch) * curr_framebuf->h +
+		       static_cast<size_t>(last_framebuf->pitch) * last_framebuf->h;
+	});
 }
 
 SdlRenderer::SetShaderResult SdlRenderer::SetShader(
@@ -284,6 +295,17 @@ std::string SdlRenderer::GetCurrentSymbolicShaderDescriptor()
 	return {};
 }
 
+bool SdlRenderer::SetIndexedFrames([[maybe_unused]] const bool is_enabled)
+{
+	// no palette lookup support
+	return false;
+}
+
+void SdlRenderer::SetPalette([[maybe_unused]] std::span<const uint32_t> lut)
+{
+	// no-op (no palette lookup support)
+}
+
 void SdlRenderer::StartFrame(uint32_t*& pixels_out, int& pitch_out)
 {
 	assert(curr_framebuf);
@@ -297,7 +319,7 @@ void SdlRenderer::StartFrame(uint32_t*& pixels_out, int& pitch_out)
 	pitch_out  = curr_framebuf->pitch;
 }
 
-void SdlRenderer::EndFrame()
+void SdlRenderer::EndFrame(const std::vector<DirtyRowRange>& dirty_rows)
 {
 	assert(curr_framebuf);
 	assert(last_framebuf);
@@ -308,13 +330,24 @@ void SdlRenderer::EndFrame()
 
 	// We need to copy the buffers. We can't just swap them because the VGA
 	// emulation only writes the changed pixels to the framebuffer in each
-	// frame.
+	// frame. But it's enough to copy the rows that have changed.
 
 	// TODO Couldn't get SDL_BlitSurface to work... If you can, feel free to
 	// use that here, but this works perfectly fine.
-	std::memcpy(last_framebuf->pixels,
-	            curr_framebuf->pixels,
-	            (curr_framebuf->h * curr_framebuf->pitch));
+	const auto pitch = static_cast<size_t>(curr_framebuf->pitch);
+
+	const auto src  = static_cast<const uint8_t*>(curr_framebuf->pixels);
+	const auto dest = static_cast<uint8_t*>(last_framebuf->pixels);
+
+	pending_upload_rows.ForEachChanged(dirty_rows, [&](const DirtyRowRange& range) {
+		const auto offset = static_cast<size_t>(range.first_row) * pitch;
+
+		std::memcpy(dest + offset,
+		            src + offset,
+		            static_cast<size_t>(range.num_rows) * pitch);
+
+		pending_upload_rows.Mark(range);
+	});
 
 	last_framebuf_dirty = true;
 }
@@ -329,10 +362,20 @@ void SdlRenderer::PrepareFrame()
 	}
 
 	if (last_framebuf_dirty) {
-		SDL_UpdateTexture(texture,
-		                  nullptr, // entire texture
-		                  last_framebuf->pixels,
-		                  last_framebuf->pitch);
+		// Only upload the rows that have changed since the last upload
+		const auto pixels = static_cast<const uint8_t*>(last_framebuf->pixels);
+
+		pending_upload_rows.Flush([&](const DirtyRowRange& range) {
+			const SDL_Rect rect = {0,
+			                       range.first_row,
+			                       last_framebuf->w,
+			                       range.num_rows};
+
+			SDL_UpdateTexture(texture,
+			                  &rect,
+			                  pixels + range.first_row * last_framebuf->pitch,
+			                  last_framebuf->pitch);
+		});
 
 		last_framebuf_dirty = false;
 	}
@@ -8,6 +8,7 @@
 
 #include "dosbox_config.h"
 #include "gui/private/common.h"
+#include "gui/render/private/dirty_rows.h"
 #include "gui/render/render.h"
 #include "utils/rect.h"
 
@@ -45,8 +46,11 @@ public:
 
 	std::string GetCurrentSymbolicShaderDescriptor() override;
 
+	bool SetIndexedFrames(const bool is_enabled) override;
+	void SetPalette(std::span<const uint32_t> lut) override;
+
 	void StartFrame(uint32_t*& pixels_out, int& pitch_out) override;
-	void EndFrame() override;
+	void EndFrame(const std::vector<DirtyRowRange>& dirty_rows) override;
 
 	void PrepareFrame() override;
 	void PresentFrame() override;
@@ -90,6 +94,9 @@ private:
 	// True if the last framebuffer has been updated since the last present
 	bool last_framebuf_dirty = false;
 
+	// Rows of the last framebuffer not yet uploaded to the texture
+	DirtyRows pending_upload_rows = {};
+
 	SDL_Texture* texture = {};
 
 	TextureFilterMode texture_filter_mode = TextureFilterMode::Bilinear;
@@ -0,0 +1,260 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "private/shader_binary_cache.h"
+
+#if C_OPENGL
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include "dosbox.h"
+#include "misc/cross.h"
+#include "utils/checks.h"
+#include "utils/fs_utils.h"
+#include "utils/string_utils.h"
+
+// must be included after dosbox_config.h
+#include <SDL.h>
+
+CHECK_NARROWING();
+
+// From ARB_get_program_binary
+constexpr GLenum GlProgramBinaryRetrievableHint = 0x8257;
+constexpr GLenum GlProgramBinaryLength          = 0x8741;
+constexpr GLenum GlNumProgramBinaryFormats      = 0x87fe;
+
+// Bump this to invalidate all cached programs if the file format changes
+constexpr uint32_t CacheFormatVersion = 1;
+
+constexpr char CacheFileMagic[4] = {'D', 'B', 'S', 'B'};
+
+struct CacheFileHeader {
+	char magic[4]          = {};
+	uint32_t version       = 0;
+	uint64_t key           = 0;
+	uint32_t binary_format = 0;
+	uint32_t binary_length = 0;
+};
+
+void ShaderBinaryCache::Init(const int gl_version,
+                             const std::string& _driver_id)
+{
+	is_enabled = false;
+
+	const auto has_program_binary = (GLAD_VERSION_MAJOR(gl_version) > 4 ||
+	                                 (GLAD_VERSION_MAJOR(gl_version) == 4 &&
+	                                  GLAD_VERSION_MINOR(gl_version) >= 1) ||
+	                                 SDL_GL_ExtensionSupported(
+	                                         "GL_ARB_get_program_binary"));
+	if (!has_program_binary) {
+		return;
+	}
+
+	// The driver might support the API without supporting any formats
+	// (e.g., some Mesa drivers)
+	GLint num_formats = 0;
+	glGetIntegerv(GlNumProgramBinaryFormats, &num_formats);
+	if (num_formats <= 0) {
+		return;
+	}
+
+	get_program_binary = reinterpret_cast<GetProgramBinaryProc>(
+	        SDL_GL_GetProcAddress("glGetProgramBinary"));
+	program_binary = reinterpret_cast<ProgramBinaryProc>(
+	        SDL_GL_GetProcAddress("glProgramBinary"));
+	program_parameteri = reinterpret_cast<ProgramParameteriProc>(
+	        SDL_GL_GetProcAddress("glProgramParameteri"));
+
+	if (!get_program_binary || !program_binary || !program_parameteri) {
+		return;
+	}
+
+	driver_id  = _driver_id;
+	cache_dir  = get_config_dir() / ShaderCacheDir;
+	is_enabled = true;
+}
+
+// 64-bit FNV-1a hash of the driver and the shader source
+uint64_t ShaderBinaryCache::GetKey(const std::string& shader_source) const
+{
+	constexpr uint64_t OffsetBasis = 0xcbf29ce484222325;
+	constexpr uint64_t Prime       = 0x100000001b3;
+
+	auto hash = OffsetBasis;
+
+	auto add = [&](const std::string& str) {
+		for (const auto c : str) {
+			hash = (hash ^ static_cast<uint8_t>(c)) * Prime;
+		}
+		// Separate the strings so they can't run into each other
+		hash = (hash ^ 0xff) * Prime;
+	};
+
+	add(driver_id);
+	add(shader_source);
+
+	return hash;
+}
+
+std_fs::path ShaderBinaryCache::GetPath(const uint64_t key,
+                                        const char* extension) const
+{
+	return cache_dir / format_str("%016llx%s",
+	                              static_cast<unsigned long long>(key),
+	                              extension);
+}
+
+std::optional<GLuint> ShaderBinaryCache::Load(const std::string& shader_source)
+{
+	if (!is_enabled) {
+		return {};
+	}
+
+	const auto key  = GetKey(shader_source);
+	const auto path = GetPath(key, ".bin");
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		return {};
+	}
+
+	CacheFileHeader header = {};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	const auto is_valid_header = file &&
+	                             std::memcmp(header.magic,
+	                                         CacheFileMagic,
+	                                         sizeof(CacheFileMagic)) == 0 &&
+	                             header.version == CacheFormatVersion &&
+	                             header.key == key &&
+	                             header.binary_length > 0;
+
+	std::vector<char> binary = {};
+	if (is_valid_header) {
+		binary.resize(header.binary_length);
+		file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+	}
+	file.close();
+
+	auto discard = [&] {
+		std::error_code ec = {};
+		std_fs::remove(path, ec);
+		return std::optional<GLuint>{};
+	};
+
+	if (!is_valid_header || binary.empty() ||
+	    file.gcount() != static_cast<std::streamsize>(binary.size())) {
+		return discard();
+	}
+
+	const auto program = glCreateProgram();
+	if (!program) {
+		return {};
+	}
+
+	program_binary(program,
+	               header.binary_format,
+	               binary.data(),
+	               static_cast<GLsizei>(binary.size()));
+
+	GLint is_program_linked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &is_program_linked);
+
+	if (!is_program_linked) {
+		// The driver has rejected the binary (e.g., after a driver
+		// update that kept the version string)
+		LOG_DEBUG("OPENGL: Discarding rejected cached shader program '%s'",
+		          path.string().c_str());
+
+		glDeleteProgram(program);
+		return discard();
+	}
+
+	return program;
+}
+
+void ShaderBinaryCache::PrepareProgram(const GLuint program) const
+{
+	if (is_enabled) {
+		program_parameteri(program, GlProgramBinaryRetrievableHint, GL_TRUE);
+	}
+}
+
+void ShaderBinaryCache::Store(const std::string& shader_source,
+                              const GLuint program)
+{
+	if (!is_enabled) {
+		return;
+	}
+
+	GLint binary_length = 0;
+	glGetProgramiv(program, GlProgramBinaryLength, &binary_length);
+	if (binary_length <= 0) {
+		return;
+	}
+
+	std::vector<char> binary(static_cast<size_t>(binary_length));
+
+	GLsizei num_bytes_written = 0;
+	GLenum binary_format      = 0;
+
+	get_program_binary(program,
+	                   binary_length,
+	                   &num_bytes_written,
+	                   &binary_format,
+	                   binary.data());
+
+	if (num_bytes_written <= 0) {
+		return;
+	}
+
+	if (create_dir(cache_dir, 0700, OK_IF_EXISTS) != 0) {
+		return;
+	}
+
+	CacheFileHeader header = {};
+	std::memcpy(header.magic, CacheFileMagic, sizeof(CacheFileMagic));
+
+	header.version       = CacheFormatVersion;
+	header.key           = GetKey(shader_source);
+	header.binary_format = binary_format;
+	header.binary_length = static_cast<uint32_t>(num_bytes_written);
+
+	// Write to a temporary file first so a concurrently starting instance
+	// never reads a partially written program. Hosts running many
+	// instances start them at the same time, so the temporary file is
+	// unique to the process, otherwise two instances compiling the same
+	// program could interleave their writes.
+	static const auto temp_extension = format_str(".%08x.tmp",
+	                                              std::random_device{}());
+
+	const auto path      = GetPath(header.key, ".bin");
+	const auto temp_path = GetPath(header.key, temp_extension.c_str());
+
+	{
+		std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(binary.data(), num_bytes_written);
+
+		if (!file) {
+			file.close();
+
+			std::error_code ec = {};
+			std_fs::remove(temp_path, ec);
+			return;
+		}
+	}
+
+	std::error_code ec = {};
+	std_fs::rename(temp_path, path, ec);
+	if (ec) {
+		std_fs::remove(temp_path, ec);
+	}
+}
+
+#endif // C_OPENGL
@@ -12,6 +12,7 @@
 #include <filesystem>
 #include <memory>
 #include <sys/types.h>
+#include <thread>
 #include <unistd.h>
 
 #if C_DEBUGGER
@@ -24,7 +25,9 @@
 #include "config/setup.h"
 #include "cpu/cpu.h"
 #include "dosbox.h"
+#include "gui/input_latency.h"
 #include "gui/mapper.h"
+#include "gui/perf_overlay.h"
 #include "gui/render/opengl_renderer.h"
 #include "gui/render/sdl_renderer.h"
 #include "gui/titlebar.h"
@@ -33,8 +36,10 @@
 #include "hardware/timer.h"
 #include "hardware/video/vga.h"
 #include "misc/cross.h"
+#include "misc/metrics.h"
 #include "misc/notifications.h"
 #include "misc/support.h"
+#include "misc/tracing.h"
 #include "misc/video.h"
 #include "utils/checks.h"
 #include "utils/env_utils.h"
@@ -241,7 +246,9 @@ static void configure_presentation_mode()
 	const std::string presentation_mode_pref = get_sdl_section()->GetString(
 	        "presentation_mode");
 
-	if (presentation_mode_pref == "dos-rate") {
+	sdl.presentation.is_vrr_paced = (presentation_mode_pref == "vrr");
+
+	if (presentation_mode_pref == "dos-rate" || presentation_mode_pref == "vrr") {
 		sdl.presentation.windowed_mode   = DosRate;
 		sdl.presentation.fullscreen_mode = DosRate;
 
@@ -260,6 +267,42 @@ static void configure_presentation_mode()
 	}
 }
 
+// Longer delays leave too little of a 60 Hz frame for the emulation
+constexpr int MaxFrameDelayMs = 12;
+
+static void configure_frame_delay()
+{
+	constexpr auto SettingName = "frame_delay";
+	constexpr auto DefaultStr  = "off";
+
+	const std::string frame_delay_pref = get_sdl_section()->GetString(SettingName);
+
+	auto& p = sdl.presentation;
+
+	p.is_frame_delay_auto = false;
+	p.frame_delay_us      = 0;
+	p.frame_delay_holdoff = 0;
+
+	if (has_false(frame_delay_pref)) {
+		return;
+	}
+	if (frame_delay_pref == "auto") {
+		p.is_frame_delay_auto = true;
+		return;
+	}
+
+	const auto delay_ms = parse_int(frame_delay_pref);
+	if (!delay_ms || *delay_ms < 1 || *delay_ms > MaxFrameDelayMs) {
+		LOG_WARNING("SDL: Invalid 'frame_delay' setting: '%s', using '%s'",
+		            frame_delay_pref.c_str(),
+		            DefaultStr);
+
+		set_section_property_value("sdl", SettingName, DefaultStr);
+		return;
+	}
+	p.frame_delay_us = *delay_ms * 1000;
+}
+
 static void configure_renderer()
 {
 	const std::string output = get_sdl_section()->GetString("output");
@@ -434,7 +477,9 @@ static void maybe_log_presentation_and_vsync_mode()
 
 	const auto presentation_rate = [&]() -> std::string {
 		switch (presentation_mode) {
-		case PresentationMode::DosRate: return "DOS rate";
+		case PresentationMode::DosRate:
+			return sdl.presentation.is_vrr_paced ? "paced DOS rate"
+			                                     : "DOS rate";
 
 		case PresentationMode::HostRate:
 			return format_str("%2.5g Hz host rate",
@@ -569,7 +614,8 @@ static void setup_presentation_mode()
 	} break;
 	}
 
-	sdl.presentation.last_present_time_us = 0;
+	sdl.presentation.last_present_time_us  = 0;
+	sdl.presentation.next_paced_present_us = 0;
 }
 
 static void notify_new_mouse_screen_params()
@@ -1121,6 +1167,20 @@ static void toggle_fullscreen_handler(bool pressed)
 //    - `GFX_StartUpdate()` IS called for this frame.
 //    - `GFX_EndUpdate()` IS called; `sdl.draw.updating_framebuffer` is TRUE.
 //
+bool GFX_SetIndexedFrames(const bool is_enabled)
+{
+	assert(sdl.renderer);
+
+	return sdl.renderer->SetIndexedFrames(is_enabled);
+}
+
+void GFX_SetPalette(std::span<const uint32_t> lut)
+{
+	assert(sdl.renderer);
+
+	sdl.renderer->SetPalette(lut);
+}
+
 bool GFX_StartUpdate(uint32_t*& pixels, int& pitch)
 {
 	assert(sdl.renderer);
@@ -1138,7 +1198,7 @@ bool GFX_StartUpdate(uint32_t*& pixels, int& pitch)
 // Called at the end of each frame at the emulated DOS rate, *regardless* of
 // whether contents of the framebuffer have changed or not compared to the
 // prevoius frame.
-void GFX_EndUpdate()
+void GFX_EndUpdate(const std::vector<DirtyRowRange>& dirty_rows)
 {
 	assert(sdl.renderer);
 
@@ -1156,7 +1216,17 @@ void GFX_EndUpdate()
 		// frames are skiped due to host vs DOS refresh mismatch, we
 		// don't want to upload the texture for the skipped frames.
 		//
-		sdl.renderer->EndFrame();
+		sdl.renderer->EndFrame(dirty_rows);
+
+		INPUT_LATENCY_NotifyFrameChanged();
+	}
+
+	if (DOSBOX_IsBenchmarkRunning()) {
+		// Frames are rendered but never presented in benchmark mode
+		DOSBOX_AddBenchmarkFrame();
+
+		sdl.draw.updating_framebuffer = false;
+		return;
 	}
 
 	if (GFX_GetPresentationMode() == PresentationMode::DosRate) {
@@ -1626,6 +1696,27 @@ static void restart_hotkey_handler([[maybe_unused]] bool pressed)
 	DOSBOX_Restart();
 }
 
+static void toggle_input_latency_measurement(const bool pressed)
+{
+	if (!pressed) {
+		return;
+	}
+	if (INPUT_LATENCY_IsEnabled()) {
+		INPUT_LATENCY_SetEnabled(false);
+		INPUT_LATENCY_LogReport();
+	} else {
+		INPUT_LATENCY_SetEnabled(true);
+		LOG_MSG("LATENCY: Input latency measurement started");
+	}
+}
+
+static void toggle_perf_stats(const bool pressed)
+{
+	if (pressed) {
+		TITLEBAR_TogglePerfStats();
+	}
+}
+
 static void configure_fullscreen_mode()
 {
 	const auto section = get_sdl_section();
@@ -1729,6 +1820,18 @@ static void add_default_sdl_section_mapper_bindings()
 	                  "restart",
 	                  "Restart");
 
+	MAPPER_AddHandler(toggle_input_latency_measurement,
+	                  SDL_SCANCODE_UNKNOWN,
+	                  0,
+	                  "inputlatency",
+	                  "Input Latency");
+
+	MAPPER_AddHandler(toggle_perf_stats,
+	                  SDL_SCANCODE_UNKNOWN,
+	                  0,
+	                  "perfstats",
+	                  "Perf. Stats");
+
 	MAPPER_AddHandler(MOUSE_ToggleUserCapture,
 	                  SDL_SCANCODE_F10,
 	                  PRIMARY_MOD,
@@ -1862,6 +1965,7 @@ void GFX_InitAndStartGui()
 	validate_vsync_and_presentation_mode_settings();
 	configure_vsync();
 	configure_presentation_mode();
+	configure_frame_delay();
 	configure_renderer();
 
 	save_window_position_from_conf();
@@ -1958,6 +2062,9 @@ static void notify_sdl_setting_updated(SectionProp& section,
 			enter_fullscreen();
 		}
 
+	} else if (prop_name == "frame_delay") {
+		configure_frame_delay();
+
 	} else if (prop_name == "keyboard_capture") {
 		set_keyboard_capture();
 
@@ -2091,6 +2198,10 @@ static void handle_user_event(const SDL_Event& event)
 		TITLEBAR_RefreshAnimatedTitle();
 		break;
 
+	case DosBoxSdlEvent::RefreshPerfStats:
+		TITLEBAR_RefreshPerfStats();
+		break;
+
 	default: assert(false);
 	}
 }
@@ -2428,8 +2539,97 @@ void GFX_CaptureRenderedImage()
 	CAPTURE_AddPostRenderImage(image);
 }
 
+// The emulated frames are finished with a jitter of a few milliseconds, as
+// the emulation runs in 1 ms ticks and catches up in bursts after falling
+// behind. Frames finished up to this early are held back until their paced
+// present time.
+constexpr int MaxPacedPresentWaitUs = 4000;
+
+// Sleeping is only accurate to about a millisecond, so the last part of the
+// wait is spent yielding
+constexpr int PacedPresentSpinUs = 1500;
+
+// In 'vrr' mode, the presents follow the cadence of the emulated refresh
+// rate, rather than the jittery times the frames are finished at. On a VRR
+// monitor, the present times drive the refresh of the display, so evenly
+// spaced presents give judder-free scrolling at any DOS refresh rate.
+static void wait_for_paced_present(const int64_t now_us)
+{
+	auto& p = sdl.presentation;
+
+	const auto lead_us = p.next_paced_present_us - now_us;
+
+	if (p.next_paced_present_us == 0 || lead_us > MaxPacedPresentWaitUs ||
+	    -lead_us > p.frame_time_us / 2) {
+		// First frame, or the emulation has lost the cadence (e.g.,
+		// after a pause or a slow frame), so restart it from this frame
+		p.next_paced_present_us = now_us + p.frame_time_us;
+		return;
+	}
+
+	if (lead_us > PacedPresentSpinUs) {
+		std::this_thread::sleep_for(
+		        std::chrono::microseconds(lead_us - PacedPresentSpinUs));
+	}
+	while (GetTicksUs() < p.next_paced_present_us) {
+		std::this_thread::yield();
+	}
+
+	p.next_paced_present_us += p.frame_time_us;
+}
+
+// Grow the automatic frame delay by at most this much per frame
+constexpr int FrameDelayStepUs = 500;
+
+// Margin kept for the jitter of the sleep and the emulation
+constexpr int FrameDelaySafetyMarginUs = 1000;
+
+// After a missed vsync, the automatic frame delay isn't grown for this many
+// frames
+constexpr int FrameDelayHoldoffFrames = 120;
+
+// Returns how long to hold back the emulation after presenting a frame in
+// 'host-rate' mode. The emulation catches up on the held back time in a burst
+// right after the delay, so the emulated frame is finished, and the input for
+// it is read, closer to the next present.
+static int get_frame_delay_us(const int64_t measured_frame_time_us)
+{
+	auto& p = sdl.presentation;
+
+	// The delay and the emulation of the whole frame have to fit before
+	// the present window opens
+	const auto emulation_us = static_cast<int>(DOSBOX_GetEmulationLoad() *
+	                                           static_cast<float>(p.frame_time_us));
+
+	const auto max_delay_us = std::max(p.frame_time_us - p.early_present_window_us -
+	                                           FrameDelaySafetyMarginUs - emulation_us,
+	                                   0);
+
+	if (!p.is_frame_delay_auto) {
+		return std::min(p.frame_delay_us, max_delay_us);
+	}
+
+	if (measured_frame_time_us > p.frame_time_us * 3 / 2) {
+		// Missed the vsync, so back off and stay there for a while
+		p.frame_delay_us /= 2;
+		p.frame_delay_holdoff = FrameDelayHoldoffFrames;
+
+	} else if (p.frame_delay_holdoff > 0) {
+		--p.frame_delay_holdoff;
+
+	} else {
+		p.frame_delay_us = std::min(p.frame_delay_us + FrameDelayStepUs,
+		                            MaxFrameDelayMs * 1000);
+	}
+
+	p.frame_delay_us = std::min(p.frame_delay_us, max_delay_us);
+	return p.frame_delay_us;
+}
+
 void GFX_MaybePresentFrame()
 {
+	TRACE_SCOPE("GFX_MaybePresentFrame");
+
 	assert(sdl.renderer);
 
 	const auto start_us = GetTicksUs();
@@ -2441,6 +2641,11 @@ void GFX_MaybePresentFrame()
 	// multi-output image capture modes.
 	const auto force_present = CAPTURE_IsCapturingPostRenderImage();
 
+	if (GFX_GetPresentationMode() == PresentationMode::DosRate &&
+	    sdl.presentation.is_vrr_paced && !force_present) {
+		wait_for_paced_present(start_us);
+	}
+
 	const auto curr_frame_time_us =
 	        GetTicksDiff(start_us, sdl.presentation.last_present_time_us);
 
@@ -2452,15 +2657,20 @@ void GFX_MaybePresentFrame()
 		if (sdl.draw.active) {
 			sdl.renderer->PrepareFrame();
 			sdl.renderer->PresentFrame();
+
+			INPUT_LATENCY_NotifyFramePresented();
 		}
 
 		const auto end_us = GetTicksUs();
+
+		// Zero for the first frame after a presentation mode change
+		const auto measured_frame_time_us =
+		        sdl.presentation.last_present_time_us
+		                ? GetTicksDiff(end_us, sdl.presentation.last_present_time_us)
+		                : 0;
 #if 0
 		LOG_TRACE("DISPLAY: present took %2.4f ms", 0.001 * GetTicksDiff(end_us, start_us));
 
-		const auto measured_frame_time_us = GetTicksDiff(
-			end_us, sdl.presentation.last_present_time_us);
-
 		LOG_TRACE("DISPLAY: frame time: %2.4f ms", 0.001 * measured_frame_time_us);
 
 		if (measured_frame_time_us >
@@ -2470,9 +2680,45 @@ void GFX_MaybePresentFrame()
 #endif
 		sdl.presentation.last_present_time_us = end_us;
 
+		if (GFX_GetPresentationMode() == PresentationMode::HostRate &&
+		    (sdl.presentation.is_frame_delay_auto ||
+		     sdl.presentation.frame_delay_us > 0)) {
+
+			const auto delay_us = get_frame_delay_us(measured_frame_time_us);
+			if (delay_us > 0) {
+				std::this_thread::sleep_for(
+				        std::chrono::microseconds(delay_us));
+			}
+		}
+
 		// Adjust "ticks done" counter by the time it took to present
-		// the frame
-		adjust_ticks_after_present_frame(GetTicksDiff(end_us, start_us));
+		// the frame, including the pacing wait and the frame delay, so
+		// none of these count as time spent emulating
+		const auto elapsed_us = GetTicksUsSince(start_us);
+
+		PERF_OVERLAY_NotifyFramePresented(elapsed_us);
+
+		static auto& present_time = METRICS_Histogram(
+		        "dosbox_frame_present_seconds",
+		        "Time spent presenting a frame, including the pacing wait",
+		        {0.001, 0.002, 0.004, 0.008, 0.016, 0.033, 0.066, 0.1});
+
+		present_time.Observe(static_cast<double>(elapsed_us) / 1'000'000.0);
+
+		DOSBOX_AddIdleTime(elapsed_us);
+		adjust_ticks_after_present_frame(elapsed_us);
+	}
+}
+
+// Presses rather than motion, so the measurement isn't flooded by a mouse
+// that's merely resting in the hand
+static bool is_latency_measured_input(const SDL_Event& event)
+{
+	switch (event.type) {
+	case SDL_KEYDOWN: return event.key.repeat == 0;
+	case SDL_MOUSEBUTTONDOWN:
+	case SDL_MOUSEWHEEL: return true;
+	default: return false;
 	}
 }
 
@@ -2507,6 +2753,10 @@ bool GFX_PollAndHandleEvents()
 			continue;
 		}
 
+		if (is_latency_measured_input(event)) {
+			INPUT_LATENCY_NotifyInput();
+		}
+
 		switch (event.type) {
 		case SDL_DISPLAYEVENT:
 			switch (event.display.event) {
@@ -2540,6 +2790,10 @@ bool GFX_PollAndHandleEvents()
 		default: MAPPER_CheckEvent(&event);
 		}
 	}
+
+	// The motion events of the whole batch reach the guest as one
+	MOUSE_FlushMotion();
+
 	return !DOSBOX_IsShutdownRequested();
 }
 
@@ -2747,14 +3001,14 @@ static void init_sdl_config_settings(SectionProp& section)
 	        "\n"
 	        "  on:               Enable vsync in both windowed and fullscreen mode. This can\n"
 	        "                    prevent tearing in fast-paced games but will increase input\n"
-	        "                    lag. Vsync is only available with 'host-rate' presentation\n"
-	        "                    (see 'presentation_mode').\n"
+	        "                    lag. Vsync is only available with 'host-rate' and 'vrr'\n"
+	        "                    presentation (see 'presentation_mode').\n"
 	        "\n"
 	        "  fullscreen-only:  Enable vsync in fullscreen mode only. This might be useful\n"
 	        "                    if your operating system enforces vsync in windowed mode and\n"
 	        "                    the 'on' setting causes audio glitches or other issues in\n"
 	        "                    windowed mode only. Vsync is only available with 'host-rate'\n"
-	        "                    presentation (see 'presentation_mode').\n"
+	        "                    and 'vrr' presentation (see 'presentation_mode').\n"
 	        "\n"
 	        "Notes:\n"
 	        "  - For perfectly smooth scrolling in 2D games (e.g., in Pinball Dreams\n"
@@ -2785,8 +3039,39 @@ static void init_sdl_config_settings(SectionProp& section)
 	        "              games where tearing is a problem. 'host-rate' combined with\n"
 	        "              'vsync' disabled can be a good workaround on systems that always\n"
 	        "              enforce blocking vsync at the OS level (e.g., forced 60 Hz vsync\n"
-	        "              could cause problems with VGA games presenting frames at 70 Hz).");
-	pstring->SetValues({"auto", "dos-rate", "host-rate"});
+	        "              could cause problems with VGA games presenting frames at 70 Hz).\n"
+	        "\n"
+	        "  vrr:        Like 'dos-rate', but the frames are presented at evenly spaced\n"
+	        "              times following the emulated refresh rate, holding back the\n"
+	        "              frames that finished early by up to a few milliseconds. This gives\n"
+	        "              the smoothest motion on VRR monitors running in VRR mode. 'vsync'\n"
+	        "              can be enabled to avoid tearing when the DOS refresh rate is\n"
+	        "              outside of the monitor's VRR range.");
+	pstring->SetValues({"auto", "dos-rate", "host-rate", "vrr"});
+
+	pstring = section.AddString("frame_delay", Always, "off");
+	pstring->SetHelp(
+	        "Hold back the emulation after presenting a frame to lower the input lag in\n"
+	        "'host-rate' presentation mode ('off' by default). The emulation then catches\n"
+	        "up on the held back time just before the next frame is presented, so the\n"
+	        "presented frame reacts to more recent input. Possible values:\n"
+	        "\n"
+	        "  off:       Don't delay the emulation (default).\n"
+	        "\n"
+	        "  auto:      Delay as much as the measured emulation load allows, backing off\n"
+	        "             when a vsync is missed.\n"
+	        "\n"
+	        "  <number>:  Delay by this many milliseconds, from 1 to 12. The delay is\n"
+	        "             shortened when the emulation load leaves no room for it.\n"
+	        "\n"
+	        "Notes:\n"
+	        "  - Only has an effect with 'host-rate' presentation (see 'presentation_mode'),\n"
+	        "    and is meant to be used with 'vsync' enabled.\n"
+	        "\n"
+	        "  - The emulation runs in bursts with a frame delay, so audio might need a\n"
+	        "    larger 'prebuffer' in the [mixer] section to play without glitches.\n"
+	        "\n"
+	        "  - Use the 'Input Latency' hotkey to measure the effect.");
 
 	auto pmulti = section.AddMultiVal("capture_mouse", Deprecated, ",");
 	pmulti->SetHelp(
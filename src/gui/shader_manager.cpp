@@ -289,6 +289,68 @@ ShaderMode ShaderManager::GetCurrentShaderMode() const
 	return current_shader_mode;
 }
 
+static std::vector<std::pair<std_fs::path, std_fs::file_time_type>> get_dir_stamps(
+        const std_fs::path& dir)
+{
+	std::vector<std::pair<std_fs::path, std_fs::file_time_type>> stamps = {};
+
+	std::error_code ec = {};
+	if (!std_fs::is_directory(dir, ec)) {
+		return stamps;
+	}
+	stamps.emplace_back(dir, std_fs::last_write_time(dir, ec));
+
+	constexpr auto idir_opts = std_fs::directory_options::skip_permission_denied |
+	                           std_fs::directory_options::follow_directory_symlink;
+
+	for (const auto& entry : std_fs::recursive_directory_iterator(dir, idir_opts, ec)) {
+		if (ec) {
+			break;
+		}
+		std::error_code entry_ec = {};
+		if (entry.is_directory(entry_ec)) {
+			stamps.emplace_back(entry.path(),
+			                    std_fs::last_write_time(entry.path(), entry_ec));
+		}
+	}
+	return stamps;
+}
+
+static bool are_dir_stamps_current(
+        const std_fs::path& dir,
+        const std::vector<std::pair<std_fs::path, std_fs::file_time_type>>& stamps)
+{
+	std::error_code ec = {};
+	if (stamps.empty()) {
+		return !std_fs::is_directory(dir, ec);
+	}
+	for (const auto& [path, modified] : stamps) {
+		if (std_fs::last_write_time(path, ec) != modified || ec) {
+			return false;
+		}
+	}
+	return true;
+}
+
+const std::vector<std_fs::path>& ShaderManager::GetShaderFiles(const std_fs::path& dir) const
+{
+	const auto [it, is_new] = shader_listings.try_emplace(dir.string());
+
+	auto& listing = it->second;
+	if (!is_new && are_dir_stamps_current(dir, listing.stamps)) {
+		return listing.shaders;
+	}
+
+	// Take the stamps before listing, so a change made in between makes
+	// the listing stale on the next query rather than being missed
+	constexpr auto OnlyRegularFiles = true;
+
+	listing.stamps  = get_dir_stamps(dir);
+	listing.shaders = get_directory_entries(dir, ".glsl", OnlyRegularFiles);
+
+	return listing.shaders;
+}
+
 std::deque<std::string> ShaderManager::GenerateShaderInventoryMessage() const
 {
 	std::deque<std::string> inventory;
@@ -300,14 +362,12 @@ std::deque<std::string> ShaderManager::GenerateShaderInventoryMessage() const
 
 	std::error_code ec = {};
 
-	constexpr auto OnlyRegularFiles = true;
-
 	for (const auto& parent : get_resource_parent_paths()) {
 		// TODO Handling the optional shader file extension should be
 		// handled by the render backend once we add more backends with
 		// shader support.
 		const auto dir = parent / ShadersDir;
-		auto shaders = get_directory_entries(dir, ".glsl", OnlyRegularFiles);
+		auto shaders = GetShaderFiles(dir);
 
 		const auto dir_exists      = std_fs::is_directory(dir, ec);
 		auto shader                = shaders.begin();
@@ -14,6 +14,7 @@
 #include "dosbox.h"
 #include "dosbox_config.h"
 #include "gui/mapper.h"
+#include "gui/perf_overlay.h"
 #include "hardware/input/mouse.h"
 #include "misc/support.h"
 #include "misc/unicode.h"
@@ -30,7 +31,7 @@ CHECK_NARROWING();
 // ***************************************************************************
 
 static struct TitlebarConfig {
-	enum class Setting { Animation, Program, Dosbox, Version, Cycles, Mouse };
+	enum class Setting { Animation, Program, Dosbox, Version, Cycles, Mouse, Perf };
 
 	enum class ProgramDisplay   { None, Name, Path, Segment, Custom };
 	enum class VersionDisplay   { None, Simple, Detailed };
@@ -39,6 +40,7 @@ static struct TitlebarConfig {
 	bool animated_record_mark = true;
 	bool show_cycles          = true;
 	bool show_dosbox_always   = false;
+	bool show_perf_stats      = false;
 
 	ProgramDisplay program  = ProgramDisplay::Name;
 	VersionDisplay version  = VersionDisplay::None;
@@ -56,6 +58,7 @@ static const std::vector<TitlebarConfig::Setting> settings_order = {
 	TitlebarConfig::Setting::Version,
 	TitlebarConfig::Setting::Cycles,
 	TitlebarConfig::Setting::Mouse,
+	TitlebarConfig::Setting::Perf,
 };
 
 static const std::map<TitlebarConfig::Setting, std::string> settings_strings = {
@@ -64,7 +67,8 @@ static const std::map<TitlebarConfig::Setting, std::string> settings_strings = {
 	{ TitlebarConfig::Setting::Dosbox,    "dosbox"    },
 	{ TitlebarConfig::Setting::Version,   "version"   },
 	{ TitlebarConfig::Setting::Cycles,    "cycles"    },
-	{ TitlebarConfig::Setting::Mouse,     "mouse"     }
+	{ TitlebarConfig::Setting::Mouse,     "mouse"     },
+	{ TitlebarConfig::Setting::Perf,      "perf"      }
 };
 
 static struct {
@@ -81,6 +85,9 @@ static struct {
 
 	SDL_TimerID timer_id           = {};
 	bool animation_phase_alternate = false;
+
+	std::string perf_stats      = {};
+	SDL_TimerID perf_timer_id   = {};
 } state = {};
 
 // ***************************************************************************
@@ -154,6 +161,41 @@ static void maybe_stop_animation()
 	}
 }
 
+// Interval of the performance counter refreshes, in milliseconds
+constexpr uint32_t PerfStatsIntervalMs = 1000;
+
+static uint32_t perf_stats_tick([[maybe_unused]] uint32_t interval,
+                                [[maybe_unused]] void* name)
+{
+	SDL_Event event = {};
+	event.user.type = GFX_GetUserSdlEventId(DosBoxSdlEvent::RefreshPerfStats);
+
+	// Same as for the animation, the counters are read and the title is
+	// updated on the main thread
+	SDL_PushEvent(&event);
+	return PerfStatsIntervalMs;
+}
+
+static void maybe_start_perf_stats_timer()
+{
+	if (state.perf_timer_id == 0) {
+		state.perf_timer_id = SDL_AddTimer(PerfStatsIntervalMs,
+		                                   perf_stats_tick,
+		                                   nullptr);
+		if (state.perf_timer_id == 0) {
+			LOG_ERR("SDL: Could not start timer: %s", SDL_GetError());
+		}
+	}
+}
+
+static void maybe_stop_perf_stats_timer()
+{
+	if (state.perf_timer_id != 0) {
+		SDL_RemoveTimer(state.perf_timer_id);
+		state.perf_timer_id = 0;
+	}
+}
+
 static void strip_path(std::string& name)
 {
 	const auto position = name.rfind('\\');
@@ -341,6 +383,22 @@ void TITLEBAR_RefreshAnimatedTitle()
 	set_window_title();
 }
 
+void TITLEBAR_RefreshPerfStats()
+{
+	if (!PERF_OVERLAY_IsEnabled()) {
+		return;
+	}
+
+	state.perf_stats = PERF_OVERLAY_Sample();
+	TITLEBAR_RefreshTitle();
+}
+
+void TITLEBAR_TogglePerfStats()
+{
+	PERF_OVERLAY_SetEnabled(!PERF_OVERLAY_IsEnabled());
+	TITLEBAR_RefreshTitle();
+}
+
 void TITLEBAR_RefreshTitle()
 {
 	// Running program name
@@ -375,6 +433,17 @@ void TITLEBAR_RefreshTitle()
 		state.title_no_tags += Separator + hint_str;
 	}
 
+	// Performance counters, refreshed by their own timer
+	if (PERF_OVERLAY_IsEnabled()) {
+		maybe_start_perf_stats_timer();
+		if (!state.perf_stats.empty()) {
+			state.title_no_tags += Separator + state.perf_stats;
+		}
+	} else {
+		maybe_stop_perf_stats_timer();
+		state.perf_stats.clear();
+	}
+
 	// Start/stop animation if needed
 	const bool is_capturing = state.is_capturing_audio || state.is_capturing_video;
 	if (config.animated_record_mark && !GFX_IsPaused() && is_capturing) {
@@ -697,6 +766,18 @@ static void parse_config(const std::string& new_setting_str)
 			continue;
 		}
 
+		if (iequals(setting_str, "perf=on")) {
+			check_double_setting(TitlebarConfig::Setting::Perf);
+			config.show_perf_stats = true;
+			continue;
+		}
+
+		if (iequals(setting_str, "perf=off")) {
+			check_double_setting(TitlebarConfig::Setting::Perf);
+			config.show_perf_stats = false;
+			continue;
+		}
+
 		LOG_WARNING("SDL: Invalid 'window_titlebar' setting: '%s', ignoring",
 		            setting_str.c_str());
 		config_needs_sync = true;
@@ -715,6 +796,8 @@ void TITLEBAR_ReadConfig()
 
 	parse_config(section->GetString("window_titlebar"));
 
+	PERF_OVERLAY_SetEnabled(config.show_perf_stats);
+
 	TITLEBAR_RefreshTitle();
 }
 
@@ -770,7 +853,14 @@ void TITLEBAR_AddConfigSettings()
 	        "                        none/off:  Do not display any mouse hints.\n"
 	        "                        short:     Only display if mouse is captured.\n"
 	        "                        full:      Display verbose information on how to\n"
-	        "                                   capture or release the cursor (default).");
+	        "                                   capture or release the cursor (default).\n"
+	        "\n"
+	        "  perf=<value>:       If set to 'on', show live performance counters updated\n"
+	        "                      every second: emulated MIPS, FPS, frame time split into\n"
+	        "                      emulation, rendering and presentation, audio buffer fill\n"
+	        "                      and underruns, dynamic core cache usage and flushes, and\n"
+	        "                      Voodoo triangles per second. 'off' by default; can also\n"
+	        "                      be toggled with the 'perfstats' hotkey in the mapper.");
 }
 
 void TITLEBAR_AddMessages()
@@ -13,6 +13,9 @@ void TITLEBAR_ReadConfig();
 
 void TITLEBAR_RefreshTitle();
 void TITLEBAR_RefreshAnimatedTitle();
+void TITLEBAR_RefreshPerfStats();
+
+void TITLEBAR_TogglePerfStats();
 
 void TITLEBAR_NotifyBooting();
 void TITLEBAR_NotifyAudioCaptureStatus(const bool is_capturing);
@@ -73,15 +73,15 @@ void SurroundProcessor::ControlWrite(const uint8_t val)
 	control_state.a0  = reg.a0;
 }
 
-AudioFrame SurroundProcessor::Process(const AudioFrame frame)
+void SurroundProcessor::Process(const float* in, const int frames,
+                                AudioFrame* out)
 {
-	YM7128B_ChipIdeal_Process_Data data = {};
+	static_assert(sizeof(AudioFrame) == 2 * sizeof(float));
 
-	data.inputs[0] = frame.left + frame.right;
-
-	YM7128B_ChipIdeal_Process(&chip, &data);
-
-	return {data.outputs[0], data.outputs[1]};
+	YM7128B_ChipIdeal_Process_Block(&chip,
+	                                in,
+	                                &out[0][0],
+	                                static_cast<size_t>(frames));
 }
 
 // Philips Semiconductors TDA8425 hi-fi stereo audio processor emulation
@@ -234,78 +234,91 @@ void StereoProcessor::ControlWrite(const StereoProcessorControlReg reg,
 	}
 }
 
-AudioFrame StereoProcessor::ProcessSourceSelection(const AudioFrame frame)
+// The registers can only change between blocks, so the processing modes are
+// selected once per block and the loops only do the arithmetic
+
+void StereoProcessor::ProcessSourceSelection(AudioFrame* frames,
+                                             const int num_frames)
 {
 	switch (source_selector) {
 	case StereoProcessorSourceSelector::SoundA1:
 	case StereoProcessorSourceSelector::SoundA2:
-		return {frame.left, frame.left};
+		for (auto i = 0; i < num_frames; ++i) {
+			frames[i].right = frames[i].left;
+		}
+		break;
 
 	case StereoProcessorSourceSelector::SoundB1:
 	case StereoProcessorSourceSelector::SoundB2:
-		return {frame.right, frame.right};
+		for (auto i = 0; i < num_frames; ++i) {
+			frames[i].left = frames[i].right;
+		}
+		break;
 
 	case StereoProcessorSourceSelector::Stereo1:
 	case StereoProcessorSourceSelector::Stereo2:
 	default:
 		// Dune sends an invalid source selector value of 0 during the
 		// intro; we'll just revert to stereo operation
-		return frame;
+		break;
 	}
 }
 
-AudioFrame StereoProcessor::ProcessShelvingFilters(const AudioFrame frame)
+void StereoProcessor::ProcessShelvingFilters(AudioFrame* frames,
+                                             const int num_frames)
 {
-	AudioFrame out_frame = {};
-
-	for (std::size_t i = 0; i < 2; ++i) {
-		out_frame[i] = lowshelf[i].filter(frame[i]);
-		out_frame[i] = highshelf[i].filter(out_frame[i]);
+	for (std::size_t c = 0; c < 2; ++c) {
+		for (auto i = 0; i < num_frames; ++i) {
+			frames[i][c] = lowshelf[c].filter(frames[i][c]);
+			frames[i][c] = highshelf[c].filter(frames[i][c]);
+		}
 	}
-	return out_frame;
 }
 
-AudioFrame StereoProcessor::ProcessStereoProcessing(const AudioFrame frame)
+void StereoProcessor::ProcessStereoProcessing(AudioFrame* frames,
+                                              const int num_frames)
 {
-	AudioFrame out_frame = {};
-
 	switch (stereo_mode) {
-	case StereoProcessorStereoMode::ForcedMono: {
-		const auto m    = frame.left + frame.right;
-		out_frame.left  = m;
-		out_frame.right = m;
-	} break;
+	case StereoProcessorStereoMode::ForcedMono:
+		for (auto i = 0; i < num_frames; ++i) {
+			const auto m    = frames[i].left + frames[i].right;
+			frames[i].left  = m;
+			frames[i].right = m;
+		}
+		break;
 
 	case StereoProcessorStereoMode::PseudoStereo:
-		out_frame.left  = allpass.filter(frame.left);
-		out_frame.right = frame.right;
+		for (auto i = 0; i < num_frames; ++i) {
+			frames[i].left = allpass.filter(frames[i].left);
+		}
 		break;
 
 	case StereoProcessorStereoMode::SpatialStereo: {
 		constexpr auto crosstalk_percentage = 52.0f;
 		constexpr auto k = crosstalk_percentage / 100.0f;
-		const auto l     = frame.left;
-		const auto r     = frame.right;
-		out_frame.left   = l + (l - r) * k;
-		out_frame.right  = r + (r - l) * k;
+		for (auto i = 0; i < num_frames; ++i) {
+			const auto l    = frames[i].left;
+			const auto r    = frames[i].right;
+			frames[i].left  = l + (l - r) * k;
+			frames[i].right = r + (r - l) * k;
+		}
 	} break;
 
 	case StereoProcessorStereoMode::LinearStereo:
-	default: out_frame = frame; break;
+	default: break;
 	}
-	return out_frame;
 }
 
-AudioFrame StereoProcessor::Process(const AudioFrame frame)
+void StereoProcessor::Process(AudioFrame* frames, const int num_frames)
 {
-	auto out_frame = ProcessSourceSelection(frame);
-	out_frame      = ProcessShelvingFilters(out_frame);
-	out_frame      = ProcessStereoProcessing(out_frame);
+	ProcessSourceSelection(frames, num_frames);
+	ProcessShelvingFilters(frames, num_frames);
+	ProcessStereoProcessing(frames, num_frames);
 
-	out_frame.left *= gain.left;
-	out_frame.right *= gain.right;
-
-	return out_frame;
+	for (auto i = 0; i < num_frames; ++i) {
+		frames[i].left *= gain.left;
+		frames[i].right *= gain.right;
+	}
 }
 
 // AdLib Gold module
@@ -334,26 +347,30 @@ void AdlibGold::SurroundControlWrite(const uint8_t val)
 
 void AdlibGold::Process(const int16_t* in, const int frames, float* out)
 {
-	auto frames_remaining = frames;
+	const auto num_frames = static_cast<size_t>(frames);
 
-	while (frames_remaining--) {
-		AudioFrame frame = {static_cast<float>(in[0]),
-		                    static_cast<float>(in[1])};
+	mono_buf.resize(num_frames);
+	wet_buf.resize(num_frames);
 
-		const auto wet = surround_processor->Process(frame);
+	auto out_frames = reinterpret_cast<AudioFrame*>(out);
 
-		// Additional wet signal level boost to make the emulated
-		// sound more closely resemble real hardware recordings.
-		constexpr auto wet_boost = 1.8f;
-		frame.left += wet.left * wet_boost;
-		frame.right += wet.right * wet_boost;
+	for (size_t i = 0; i < num_frames; ++i) {
+		out_frames[i] = {static_cast<float>(in[i * 2]),
+		                 static_cast<float>(in[i * 2 + 1])};
 
-		frame = stereo_processor->Process(frame);
+		mono_buf[i] = out_frames[i].left + out_frames[i].right;
+	}
 
-		out[0] = frame.left;
-		out[1] = frame.right;
-		in += 2;
-		out += 2;
+	surround_processor->Process(mono_buf.data(), frames, wet_buf.data());
+
+	// Additional wet signal level boost to make the emulated
+	// sound more closely resemble real hardware recordings.
+	constexpr auto wet_boost = 1.8f;
+	for (size_t i = 0; i < num_frames; ++i) {
+		out_frames[i].left += wet_buf[i].left * wet_boost;
+		out_frames[i].right += wet_buf[i].right * wet_boost;
 	}
+
+	stereo_processor->Process(out_frames, frames);
 }
 
@@ -4,6 +4,7 @@
 
 #include "private/cms.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "audio/channel_names.h"
@@ -98,6 +99,9 @@ Cms::Cms(const int port_choice, const std::string& card_choice,
 	                            ChannelFeature::ChorusSend,
 	                            ChannelFeature::Synthesizer});
 
+	// Downsampling from the very high render rate is costly with Speex
+	channel->SetResampleMethod(ResampleMethod::PolyphaseResample);
+
 	// The filter parameters have been tweaked by analysing real hardware
 	// recordings. The results are virtually indistinguishable from the
 	// real thing by ear only.
@@ -168,100 +172,134 @@ Cms::~Cms()
 	MIXER_UnlockMixerThread();
 }
 
-AudioFrame Cms::RenderFrame()
+// Append frames mixed from the two devices, rendering each in one run
+void Cms::RenderFrames(const int num_frames)
 {
-	// left and right
-	static std::array<int16_t, 2> buf = {};
+	if (num_frames <= 0) {
+		return;
+	}
 
 	static device_sound_interface::sound_stream stream;
 
-	int16_t* p_buf[] = {&buf[0], &buf[1]};
-
-	// Accumulate the samples from both SAA-1099 devices
-	devices[0]->sound_stream_update(stream, nullptr, p_buf, 1);
-	int left_accum  = buf[0];
-	int right_accum = buf[1];
+	const auto n = static_cast<size_t>(num_frames);
+	for (auto& b : buf) {
+		b.resize(n);
+	}
+	int16_t* p_buf[] = {buf[0].data(), buf[1].data()};
 
-	devices[1]->sound_stream_update(stream, nullptr, p_buf, 1);
-	left_accum += buf[0];
-	right_accum += buf[1];
+	const auto offset = frames.size();
+	frames.resize(offset + n);
 
-	// Increment our time datum up to which the device has rendered
-	last_rendered_ms += MsPerRender;
+	// Accumulate the samples from both SAA-1099 devices
+	for (const auto& device : devices) {
+		device->sound_stream_update(stream, nullptr, p_buf, num_frames);
 
-	return {static_cast<float>(left_accum), static_cast<float>(right_accum)};
+		for (size_t i = 0; i < n; ++i) {
+			frames[offset + i].left += static_cast<float>(buf[0][i]);
+			frames[offset + i].right += static_cast<float>(buf[1][i]);
+		}
+	}
 }
 
-void Cms::RenderUpToNow()
+void Cms::QueueWrite(const uint8_t device, const bool is_control, io_val_t value)
 {
 	std::lock_guard lock(mutex);
 
-	const auto now = PIC_FullIndex();
-
-	// Wake up the channel and update the last rendered time datum.
+	// The mixer thread renders the audio, we only need to restart the
+	// block timeline after the channel has been asleep
 	assert(channel);
+	const auto now = PIC_FullIndex();
 	if (channel->WakeUp()) {
-		last_rendered_ms = now;
-		return;
+		block_start_ms = now;
 	}
-	// Keep rendering until we're current
-	while (last_rendered_ms < now) {
-		last_rendered_ms += MsPerRender;
-		fifo.emplace(RenderFrame());
+	pending_writes.push_back({now, device, is_control, check_cast<uint8_t>(value)});
+}
+
+// Only called on the mixer thread
+void Cms::ApplyWrite(const QueuedWrite& write)
+{
+	auto& device = devices[write.device];
+	if (write.is_control) {
+		device->control_w(0, 0, write.val);
+	} else {
+		device->data_w(0, 0, write.val);
 	}
 }
 
 void Cms::WriteDataToLeftDevice(io_port_t, io_val_t value, io_width_t)
 {
-	RenderUpToNow();
-	devices[0]->data_w(0, 0, check_cast<uint8_t>(value));
+	QueueWrite(0, false, value);
 }
 
 void Cms::WriteControlToLeftDevice(io_port_t, io_val_t value, io_width_t)
 {
-	RenderUpToNow();
-	devices[0]->control_w(0, 0, check_cast<uint8_t>(value));
+	QueueWrite(0, true, value);
 }
 
 void Cms::WriteDataToRightDevice(io_port_t, io_val_t value, io_width_t)
 {
-	RenderUpToNow();
-	devices[1]->data_w(0, 0, check_cast<uint8_t>(value));
+	QueueWrite(1, false, value);
 }
 
 void Cms::WriteControlToRightDevice(io_port_t, io_val_t value, io_width_t)
 {
-	RenderUpToNow();
-	devices[1]->control_w(0, 0, check_cast<uint8_t>(value));
+	QueueWrite(1, true, value);
 }
 
+// Render a whole block on the mixer thread. The block spans the emulated time
+// since the previous block, and the port writes made in that period are
+// applied right before the first frame at or after their timestamp. The
+// frames between two writes are rendered in one run of the devices.
 void Cms::AudioCallback(const int requested_frames)
 {
 	assert(channel);
+	assert(requested_frames > 0);
 
-	std::lock_guard lock(mutex);
+	double start_ms = 0.0;
+	double end_ms   = 0.0;
+	{
+		std::lock_guard lock(mutex);
 
-#if 0
-	if (fifo.size()) {
-		LOG_MSG("CMS: Queued %2lu cycle-accurate frames", fifo.size());
+		writes.insert(writes.end(), pending_writes.begin(), pending_writes.end());
+		pending_writes.clear();
+
+		start_ms = block_start_ms;
+		end_ms   = PIC_AtomicIndex();
+
+		block_start_ms = std::max(start_ms, end_ms);
 	}
-#endif
 
-	auto frames_remaining = requested_frames;
+	// The emulated time doesn't advance while the emulation is paused
+	const auto span_ms = std::max(end_ms - start_ms, 0.0);
+
+	frames.clear();
 
-	// First, add any frames we've queued since the last callback
-	while (frames_remaining && fifo.size()) {
-		channel->AddSamples_sfloat(1, &fifo.front()[0]);
-		fifo.pop();
-		--frames_remaining;
+	size_t next_write = 0;
+	for (int i = 0; i < requested_frames && next_write < writes.size(); ++i) {
+		const auto frame_ms = start_ms + span_ms * i / requested_frames;
+		if (writes[next_write].timestamp_ms > frame_ms) {
+			continue;
+		}
+		RenderFrames(i - static_cast<int>(frames.size()));
+
+		while (next_write < writes.size() &&
+		       writes[next_write].timestamp_ms <= frame_ms) {
+			ApplyWrite(writes[next_write++]);
+		}
 	}
-	// If the queue's run dry, render the remainder and sync-up our time datum
-	while (frames_remaining) {
-		auto frame = RenderFrame();
-		channel->AddSamples_sfloat(1, &frame[0]);
-		--frames_remaining;
+	RenderFrames(requested_frames - static_cast<int>(frames.size()));
+
+	// Writes made during the last frame take effect in the next block
+	while (next_write < writes.size() && writes[next_write].timestamp_ms < end_ms) {
+		ApplyWrite(writes[next_write++]);
 	}
-	last_rendered_ms = PIC_AtomicIndex();
+
+	// The main thread can be slightly ahead of the atomic time index, so
+	// keep any writes timestamped after this block for the next one
+	writes.erase(writes.begin(),
+	             writes.begin() + static_cast<std::ptrdiff_t>(next_write));
+
+	channel->AddAudioFrames(frames);
 }
 
 void Cms::WriteToDetectionPort(io_port_t port, io_val_t value, io_width_t)
@@ -36,10 +36,13 @@ void Covox::ConfigureFilters(const FilterState state)
 	channel->SetLowPassFilter(state);
 }
 
-AudioFrame Covox::Render()
+void Covox::Render(const int num_frames)
 {
+	// The output holds the last written sample
 	const float sample = lut_u8to16[data_reg];
-	return {sample, sample};
+	render_buffer.insert(render_buffer.end(),
+	                     static_cast<size_t>(num_frames),
+	                     {sample, sample});
 }
 
 void Covox::WriteData(const io_port_t, const io_val_t data, const io_width_t)
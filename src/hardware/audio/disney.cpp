@@ -66,13 +66,24 @@ void Disney::ConfigureFilters(const FilterState state)
 
 // Eight bit data sent to the D/A convener is loaded into a 16 level FIFO. Data
 // is clocked from this FIFO at the fixed rate of 7 kHz +/- 5%.
-AudioFrame Disney::Render()
+void Disney::Render(const int num_frames)
 {
 	assert(fifo.size());
-	const float sample = lut_u8to16[fifo.front()];
-	if (fifo.size() > 1)
+
+	// Clock the samples out of the FIFO, one per frame
+	auto remaining = num_frames;
+	while (remaining > 0 && fifo.size() > 1) {
+		const float sample = lut_u8to16[fifo.front()];
+		render_buffer.push_back({sample, sample});
 		fifo.pop();
-	return {sample, sample};
+		--remaining;
+	}
+
+	// The last sample is held once the FIFO has run dry
+	const float sample = lut_u8to16[fifo.front()];
+	render_buffer.insert(render_buffer.end(),
+	                     static_cast<size_t>(remaining),
+	                     {sample, sample});
 }
 
 bool Disney::IsFifoFull() const
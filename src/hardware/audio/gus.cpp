@@ -4,10 +4,12 @@
 
 #include "private/gus.h"
 
+#include <algorithm>
 #include <array>
 #include <iomanip>
 #include <memory>
 #include <queue>
+#include <span>
 #include <string>
 #include <unistd.h>
 #include <vector>
@@ -18,9 +20,11 @@
 #include "dosbox.h"
 #include "hardware/pic.h"
 #include "hardware/timer.h"
+#include "misc/host_memory.h"
 #include "misc/notifications.h"
 #include "shell/autoexec.h"
 #include "shell/shell.h"
+#include "simde/x86/sse2.h"
 #include "utils/bit_view.h"
 #include "utils/math_utils.h"
 #include "utils/string_utils.h"
@@ -150,16 +154,153 @@ void Voice::RenderFrames(const ram_array_t& ram,
 	const auto pan_scalar = pan_scalars.at(pan_position);
 
 	// Sum the voice's samples into the exising frames, angled in L-R space
-	for (auto& frame : frames) {
+	const auto num_frames = frames.size();
+
+	size_t i = 0;
+	while (i < num_frames) {
+		// Frames in between the wave and volume boundaries are rendered
+		// in bulk
+		const auto num_steady = std::min({CountSteadySteps(wave_ctrl),
+		                                  CountSteadySteps(vol_ctrl),
+		                                  num_frames - i,
+		                                  MaxSteadyFrames});
+		if (num_steady > 0) {
+			RenderSteadyFrames(ram, vol_scalars, pan_scalar, &frames[i], num_steady);
+			i += num_steady;
+			continue;
+		}
+
+		// The next frame reaches a boundary, which might loop or stop
+		// the voice or raise an IRQ
 		float sample = GetSample(ram);
 		sample *= PopVolScalar(vol_scalars);
-		frame.left += sample * pan_scalar.left;
-		frame.right += sample * pan_scalar.right;
+		frames[i].left += sample * pan_scalar.left;
+		frames[i].right += sample * pan_scalar.right;
+		++i;
 	}
 	// Keep track of how many ms this voice has generated
 	Is16Bit() ? generated_16bit_ms++ : generated_8bit_ms++;
 }
 
+// Returns how many times the control's position can be incremented without
+// reaching its start or end boundary, i.e. without IncrementCtrlPos() having
+// to loop, stop, or raise an IRQ.
+size_t Voice::CountSteadySteps(const VoiceCtrl& ctrl) const noexcept
+{
+	constexpr auto Unlimited = std::numeric_limits<size_t>::max();
+	if (ctrl.state & CTRL::DISABLED) {
+		return Unlimited;
+	}
+	const auto distance = (ctrl.state & CTRL::DECREASING)
+	                            ? ctrl.pos - ctrl.start
+	                            : ctrl.end - ctrl.pos;
+	if (distance <= 0) {
+		return 0;
+	}
+	if (ctrl.inc <= 0) {
+		return Unlimited;
+	}
+	// Step 'n' is steady while n * inc < distance
+	return static_cast<size_t>((distance - 1) / ctrl.inc);
+}
+
+// Renders frames that don't cross any of the voice's boundaries. Because the
+// positions only move by their increments, the samples, interpolation
+// fractions and volume scalars are first gathered into separate arrays, then
+// the arithmetic runs on four frames at a time. The results are identical to
+// rendering the frames one by one.
+void Voice::RenderSteadyFrames(const ram_array_t& ram,
+                               const vol_scalars_array_t& vol_scalars,
+                               const AudioFrame pan_scalar,
+                               AudioFrame* frames, const size_t num_frames)
+{
+	assert(num_frames <= MaxSteadyFrames);
+
+	std::array<float, MaxSteadyFrames> samples   = {};
+	std::array<float, MaxSteadyFrames> deltas    = {};
+	std::array<float, MaxSteadyFrames> fractions = {};
+	std::array<float, MaxSteadyFrames> volumes   = {};
+
+	auto get_step = [](const VoiceCtrl& ctrl) {
+		if (ctrl.state & CTRL::DISABLED) {
+			return 0;
+		}
+		return (ctrl.state & CTRL::DECREASING) ? -ctrl.inc : ctrl.inc;
+	};
+	const auto wave_step = get_step(wave_ctrl);
+	const auto vol_step  = get_step(vol_ctrl);
+
+	const bool can_interpolate = wave_ctrl.inc < WAVE_WIDTH;
+	const auto is_16bit        = Is16Bit();
+
+	auto wave_pos = wave_ctrl.pos;
+	auto vol_pos  = vol_ctrl.pos;
+
+	for (size_t i = 0; i < num_frames; ++i) {
+		const auto addr = wave_pos / WAVE_WIDTH;
+		samples[i] = is_16bit ? Read16BitSample(ram, addr)
+		                      : Read8BitSample(ram, addr);
+
+		// Frames without interpolation get a zero fraction, which
+		// leaves their sample unchanged
+		if (can_interpolate) {
+			const float next_sample = is_16bit
+			                                ? Read16BitSample(ram, addr + 1)
+			                                : Read8BitSample(ram, addr + 1);
+			deltas[i]    = next_sample - samples[i];
+			fractions[i] = static_cast<float>(wave_pos & (WAVE_WIDTH - 1));
+		}
+
+		const auto vol_index = ceil_sdivide(vol_pos, VOLUME_INC_SCALAR);
+		assert(vol_index >= 0 && vol_index < VOLUME_LEVELS);
+		volumes[i] = vol_scalars[static_cast<size_t>(vol_index)];
+
+		wave_pos += wave_step;
+		vol_pos += vol_step;
+	}
+	wave_ctrl.pos = wave_pos;
+	vol_ctrl.pos  = vol_pos;
+
+	constexpr float WAVE_WIDTH_INV = 1.0 / WAVE_WIDTH;
+
+	// Lanes from low to high: left, right, left, right
+	const auto pan = simde_mm_set_ps(pan_scalar.right,
+	                                 pan_scalar.left,
+	                                 pan_scalar.right,
+	                                 pan_scalar.left);
+	const auto width_inv = simde_mm_set1_ps(WAVE_WIDTH_INV);
+
+	auto out = &frames->left;
+
+	size_t i = 0;
+	for (; i + 4 <= num_frames; i += 4) {
+		const auto interpolation = simde_mm_mul_ps(
+		        simde_mm_mul_ps(simde_mm_loadu_ps(&deltas[i]),
+		                        simde_mm_loadu_ps(&fractions[i])),
+		        width_inv);
+
+		const auto sample = simde_mm_mul_ps(
+		        simde_mm_add_ps(simde_mm_loadu_ps(&samples[i]), interpolation),
+		        simde_mm_loadu_ps(&volumes[i]));
+
+		// Duplicate each sample into its left and right lanes
+		const auto lo = simde_mm_unpacklo_ps(sample, sample);
+		const auto hi = simde_mm_unpackhi_ps(sample, sample);
+
+		simde_mm_storeu_ps(out, simde_mm_add_ps(simde_mm_loadu_ps(out),
+		                                        simde_mm_mul_ps(lo, pan)));
+		simde_mm_storeu_ps(out + 4, simde_mm_add_ps(simde_mm_loadu_ps(out + 4),
+		                                            simde_mm_mul_ps(hi, pan)));
+		out += 8;
+	}
+	for (; i < num_frames; ++i) {
+		float sample = samples[i] + deltas[i] * fractions[i] * WAVE_WIDTH_INV;
+		sample *= volumes[i];
+		frames[i].left += sample * pan_scalar.left;
+		frames[i].right += sample * pan_scalar.right;
+	}
+}
+
 // Returns the current wave position and increments the position
 // to the next wave position.
 int32_t Voice::PopWavePos() noexcept
@@ -550,8 +691,10 @@ void Gus::PicCallback(const int num_requested_frames)
 	}
 	// If the queue's run dry, render the remainder and sync-up our time datum
 	if (num_frames_remaining > 0) {
-		auto frames = RenderFrames(num_frames_remaining);
-		output_queue.NonblockingBulkEnqueue(frames, num_frames_remaining);
+		// Enqueue from the render buffer rather than a copy of it
+		RenderFrames(num_frames_remaining);
+		output_queue.NonblockingBulkEnqueue(rendered_frames,
+		                                    check_cast<size_t>(num_frames_remaining));
 	}
 	last_rendered_ms = PIC_FullIndex();
 }
@@ -677,9 +820,32 @@ bool Gus::SizedDmaTransfer()
 	assert(static_cast<size_t>(offset) + desired <= ram.size());
 
 	// Perform the DMA transfer
-	const auto transfered = dma_control_register.is_direction_gus_to_host
-	                              ? dma_channel->Write(desired, &ram.at(offset))
-	                              : dma_channel->Read(desired, &ram.at(offset));
+	size_t transfered = 0;
+	if (dma_control_register.is_direction_gus_to_host) {
+		transfered = dma_channel->Write(desired, &ram.at(offset));
+	} else {
+		// Copy the samples straight from guest RAM, inverting their
+		// most-significant bits on the way if requested. That's every
+		// byte of 8-bit samples and the odd bytes of 16-bit samples.
+		const bool should_invert = dma_control_register.are_samples_high_bit_inverted;
+		constexpr size_t msb_mask = (sample_size == SampleSize::Bits16) ? 1 : 0;
+
+		auto ram_pos      = ram.begin() + offset;
+		size_t byte_index = 0;
+
+		auto copy_samples = [&](const std::span<const uint8_t> data) {
+			assert(ram_pos + static_cast<ptrdiff_t>(data.size()) <= ram.end());
+			if (!should_invert) {
+				ram_pos = std::copy(data.begin(), data.end(), ram_pos);
+				return;
+			}
+			for (const auto byte : data) {
+				const bool is_msb = (byte_index++ & msb_mask) == msb_mask;
+				*ram_pos++ = is_msb ? static_cast<uint8_t>(byte ^ 0x80) : byte;
+			}
+		};
+		transfered = dma_channel->ReadSpans(desired, copy_samples);
+	}
 
 	// Did we get everything we asked for?
 	assert(transfered == desired);
@@ -690,24 +856,6 @@ bool Gus::SizedDmaTransfer()
 	// Update the GUS's DMA address with the current position
 	UpdateDmaAddr(check_cast<uint32_t>(offset + bytes_transfered));
 
-	// If requested, invert the loaded samples' most-significant bits
-	if (!dma_control_register.is_direction_gus_to_host &&
-	    dma_control_register.are_samples_high_bit_inverted) {
-		auto ram_pos           = ram.begin() + offset;
-		const auto ram_pos_end = ram_pos + bytes_transfered;
-
-		// adjust our start and skip size if handling 16-bit PCM samples
-		ram_pos += (sample_size == SampleSize::Bits16) ? 1 : 0;
-		const auto skip = (sample_size == SampleSize::Bits16) ? 2 : 1;
-
-		assert(ram_pos >= ram.begin() && ram_pos <= ram_pos_end &&
-		       ram_pos_end <= ram.end());
-		while (ram_pos < ram_pos_end) {
-			*ram_pos ^= 0x80;
-			ram_pos += skip;
-		}
-	}
-
 	if (dma_channel->has_reached_terminal_count) {
 		dma_control_register.has_pending_terminal_count_irq = true;
 
@@ -1615,6 +1763,11 @@ void GUS_Init()
 
 	// Instantiate the GUS with the settings
 	gus = std::make_unique<Gus>(port, dma, irq, ultradir.c_str(), filter_prefs);
+
+	// Mostly the sample RAM
+	HOST_MEMORY_AddSubsystem("Gravis UltraSound", [] {
+		return gus ? sizeof(Gus) : 0;
+	});
 }
 
 void GUS_Destroy()
@@ -38,18 +38,21 @@
 //    there is a way to upload Z80 programs to the IMFC card and execute it! Who
 //    knew that IBM added this back-door :)
 
+#include "hardware/audio/imfc.h"
+
 #include "dosbox.h"
 
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cstring>
 #include <deque>
 #include <functional>
-#include <queue>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "audio/channel_names.h"
 #include "audio/mixer.h"
@@ -60,8 +63,11 @@
 #include "hardware/pic.h"
 #include "hardware/port.h"
 #include "misc/notifications.h"
+#include "misc/support.h"
 #include "shell/shell.h"
 #include "utils/math_utils.h"
+#include "utils/rwqueue.h"
+#include "utils/spsc_queue.h"
 
 #include "SDL_thread.h"
 
@@ -3119,9 +3125,18 @@ public:
 	// sound stream update overrides
 	void sound_stream_update(const int requested_frames);
 
+	// Stops the render thread; the later register writes are dropped
+	void StopRendering();
+
 private:
+	void ApplyWrite(const offs_t offset, const uint8_t data);
+
 	AudioFrame RenderFrame();
-	void RenderUpToNow();
+	int GetNumPendingFrames();
+	int GetNumIdleFrames();
+	void RenderFramesToFifo(const int num_frames);
+	void ProcessWorkFromFifo();
+	void Render();
 
 	enum : uint8_t {
 		TIMER_IRQ_A_OFF,
@@ -3146,11 +3161,23 @@ private:
 		SIN_MASK = SIN_LEN - 1,
 	};
 
-	// Playback related
+	// Playback related. The chip is rendered on its own thread, which runs
+	// ahead of the mixer by filling the audio frame FIFO, so the card's
+	// processor threads only queue their register writes.
 	MixerChannelPtr audio_channel = nullptr;
-	std::queue<AudioFrame> fifo   = {};
-	double last_rendered_ms       = 0.0;
-	double ms_per_render          = 0.0;
+	SpscQueue<AudioFrame> audio_frame_fifo{1};
+	RWQueue<ImfcYmWork> work_fifo{1};
+	std::thread renderer = {};
+
+	// Only used by the render thread
+	std::vector<AudioFrame> rendered_frames = {};
+
+	// Used to track the balance of time between the last mixer callback
+	// and the current register write
+	std::atomic<double> last_rendered_ms = 0.0;
+	double ms_per_render                 = 0.0;
+
+	bool had_underruns = false;
 
 	int tl_tab[TL_TAB_LEN]{};
 	unsigned int sin_tab[SIN_LEN]{};
@@ -4826,8 +4853,24 @@ ym2151_device::ym2151_device(MixerChannelPtr&& channel)
 	device_reset();
 
 	assert(audio_channel);
-	ms_per_render = MillisInSecond / audio_channel->GetSampleRate();
+	const auto sample_rate_hz = audio_channel->GetSampleRate();
+	ms_per_render = MillisInSecond / sample_rate_hz;
+
+	// Render ahead by the baseline PCM prebuffer, the same as the mixer
+	// would for a streaming device
+	const auto audio_frames_per_ms = iround(sample_rate_hz / MillisInSecond);
+	audio_frame_fifo.Resize(
+	        check_cast<size_t>(MIXER_GetPreBufferMs() * audio_frames_per_ms));
+
+	// The card resets the chip with a burst of a few hundred writes, and
+	// every note takes a dozen or so
+	constexpr size_t MaxYmWorkFifoSize = 4096;
+	work_fifo.Resize(MaxYmWorkFifoSize);
+
 	audio_channel->Enable(true);
+
+	renderer = std::thread(std::bind(&ym2151_device::Render, this));
+	set_thread_name(renderer, "dosbox:imfc");
 }
 
 //-------------------------------------------------
@@ -4836,6 +4879,14 @@ ym2151_device::ym2151_device(MixerChannelPtr&& channel)
 
 ym2151_device::~ym2151_device()
 {
+	StopRendering();
+
+	if (had_underruns) {
+		LOG_WARNING(
+		        "IMFC: Fix underruns by lowering the CPU load or "
+		        "increasing the 'prebuffer' or 'blocksize' settings");
+	}
+
 	// Deregister the mixer channel, after which it's cleaned up
 	assert(audio_channel);
 	MIXER_DeregisterChannel(audio_channel);
@@ -4858,9 +4909,16 @@ uint8_t ym2151_device::read(const offs_t offset) const
 //  write - write from the device
 //-------------------------------------------------
 
+// The register write is placed in the work FIFO of the render thread
 void ym2151_device::write(const offs_t offset, const uint8_t data)
 {
-	RenderUpToNow();
+	ImfcYmWork work{GetNumPendingFrames(), offset, data};
+
+	work_fifo.Enqueue(std::move(work));
+}
+
+void ym2151_device::ApplyWrite(const offs_t offset, const uint8_t data)
+{
 	if ((offset & 1) != 0) {
 		if (!m_reset_active) {
 			// m_stream->update();
@@ -4976,15 +5034,87 @@ AudioFrame ym2151_device::RenderFrame()
 	return {static_cast<float>(outl), static_cast<float>(outr)};
 }
 
-void ym2151_device::RenderUpToNow()
+void ym2151_device::StopRendering()
 {
-	const auto now = PIC_AtomicIndex();
-	// Keep rendering until we're current
-	while (last_rendered_ms < now) {
-		last_rendered_ms += ms_per_render;
-		fifo.emplace(RenderFrame());
+	// Stop queueing new register writes and audio frames
+	work_fifo.Stop();
+	audio_frame_fifo.Stop();
+
+	// Wait for the rendering thread to finish
+	if (renderer.joinable()) {
+		renderer.join();
 	}
 }
+
+int ym2151_device::GetNumPendingFrames()
+{
+	const auto now_ms = PIC_AtomicIndex();
+
+	auto rendered_ms = last_rendered_ms.load();
+	if (rendered_ms >= now_ms) {
+		return 0;
+	}
+
+	// Return the number of audio frames needed to get current again
+	assert(ms_per_render > 0.0);
+
+	const auto elapsed_ms = now_ms - rendered_ms;
+	const auto num_frames = iround(ceil(elapsed_ms / ms_per_render));
+	rendered_ms += (num_frames * ms_per_render);
+	last_rendered_ms.store(rendered_ms);
+
+	return num_frames;
+}
+
+// Returns how many audio frames to render while there are no register writes
+// pending: up to a block at a time, but only as many as the FIFO has room for
+// so pending writes aren't held up behind a blocked enqueue
+int ym2151_device::GetNumIdleFrames()
+{
+	constexpr size_t RenderBlockFrames = 64;
+
+	const auto fill_limit  = audio_frame_fifo.GetFillLimit();
+	const auto num_queued  = audio_frame_fifo.Size();
+	const auto num_vacant  = fill_limit > num_queued ? fill_limit - num_queued : 0;
+	const auto num_to_fill = std::clamp(num_vacant, size_t{1}, RenderBlockFrames);
+
+	return check_cast<int>(num_to_fill);
+}
+
+void ym2151_device::RenderFramesToFifo(const int num_frames)
+{
+	assert(num_frames > 0);
+
+	rendered_frames.resize(check_cast<size_t>(num_frames));
+	for (auto& frame : rendered_frames) {
+		frame = RenderFrame();
+	}
+	audio_frame_fifo.BulkEnqueue(rendered_frames, rendered_frames.size());
+}
+
+// The chip is rendered up to the next register write, which is then applied
+void ym2151_device::ProcessWorkFromFifo()
+{
+	const auto work = work_fifo.Dequeue();
+	if (!work) {
+		return;
+	}
+
+	if (work->num_pending_frames > 0) {
+		RenderFramesToFifo(work->num_pending_frames);
+	}
+	ApplyWrite(work->offset, work->data);
+}
+
+// Keep the FIFO populated with freshly rendered audio frames
+void ym2151_device::Render()
+{
+	while (work_fifo.IsRunning()) {
+		work_fifo.IsEmpty() ? RenderFramesToFifo(GetNumIdleFrames())
+		                    : ProcessWorkFromFifo();
+	}
+}
+
 //-------------------------------------------------
 //  sound_stream_update - handle a stream update
 //-------------------------------------------------
@@ -4998,24 +5128,34 @@ void ym2151_device::sound_stream_update(const int requested_frames)
 		audio_channel->AddSilence();
 		return;
 	}
-	// if (fifo.size())
-	//	LOG_MSG("IMFC: Queued %2lu cycle-accurate frames", fifo.size());
 
-	auto frames_remaining = requested_frames;
+	// Report buffer underruns
+	constexpr auto WarningPercent = 5.0f;
 
-	// First, send any frames we've queued since the last callback
-	while (frames_remaining && fifo.size()) {
-		audio_channel->AddSamples_sfloat(1, &fifo.front()[0]);
-		fifo.pop();
-		--frames_remaining;
+	if (const auto percent_full = audio_frame_fifo.GetPercentFull();
+	    percent_full < WarningPercent) {
+		static auto iteration = 0;
+		if (iteration++ % 100 == 0) {
+			LOG_WARNING("IMFC: Audio buffer underrun");
+		}
+		had_underruns = true;
 	}
-	// If the queue's run dry, render the remainder and sync-up our time datum
-	while (frames_remaining) {
-		const auto frame = RenderFrame();
-		audio_channel->AddSamples_sfloat(1, &frame[0]);
-		--frames_remaining;
+
+	static std::vector<AudioFrame> audio_frames = {};
+
+	const auto has_dequeued = audio_frame_fifo.BulkDequeue(audio_frames,
+	                                                       requested_frames);
+
+	if (has_dequeued) {
+		assert(check_cast<int>(audio_frames.size()) == requested_frames);
+		audio_channel->AddSamples_sfloat(requested_frames,
+		                                 &audio_frames[0][0]);
+
+		last_rendered_ms = PIC_AtomicIndex();
+	} else {
+		assert(!audio_frame_fifo.IsRunning());
+		audio_channel->AddSilence();
 	}
-	last_rendered_ms = PIC_AtomicIndex();
 }
 
 // clang-format off
@@ -13199,11 +13339,11 @@ public:
 		SDL_UnlockMutex(m_hardwareMutex);
 	}
 
+	// The YM2151 is rendered on its own thread, so the mixer doesn't hold
+	// up the port handshake with the hardware mutex
 	void mixerCallback(const int requested_frames)
 	{
-		SDL_LockMutex(m_hardwareMutex);
 		m_ya2151.sound_stream_update(requested_frames);
-		SDL_UnlockMutex(m_hardwareMutex);
 	}
 
 	void onTimerEvent(const uint32_t val)
@@ -13226,6 +13366,10 @@ public:
 		for (auto& wh : writeHandlers)
 			wh.Uninstall();
 
+		// Release the processor threads if they're waiting to queue a
+		// YM2151 write
+		m_ya2151.StopRendering();
+
 		// Give the threads a small bit of time to gracefully complete
 		std::this_thread::sleep_for(20ms);
 
@@ -4,8 +4,18 @@
 #ifndef DOSBOX_IMFC_H
 #define DOSBOX_IMFC_H
 
+#include <cstdint>
+
 #include "config/config.h"
 
+// A YM2151 register write for the IMFC render thread, made after the chip has
+// rendered the given number of audio frames since the previous one
+struct ImfcYmWork {
+	int num_pending_frames = 0;
+	uint8_t offset         = 0;
+	uint8_t data           = 0;
+};
+
 void IMFC_AddConfigSection(const ConfigPtr& conf);
 void IMFC_Init();
 void IMFC_Destroy();
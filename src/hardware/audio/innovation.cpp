@@ -4,6 +4,8 @@
 
 #include "private/innovation.h"
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 
 #include "audio/channel_names.h"
@@ -12,9 +14,14 @@
 #include "misc/notifications.h"
 #include "misc/support.h"
 #include "utils/checks.h"
+#include "utils/math_utils.h"
 
 CHECK_NARROWING();
 
+// Games write the SID registers in bursts of a few dozen per frame, while
+// sampled sound can write thousands per second
+constexpr size_t MaxSidWorkFifoSize = 4096;
+
 Innovation::Innovation(const std::string_view model_choice,
                        const std::string_view clock_choice,
                        const int filter_strength_6581,
@@ -100,6 +107,19 @@ Innovation::Innovation(const std::string_view model_choice,
 	                                   sample_rate_hz,
 	                                   passband);
 
+	clocks_per_frame = chip_clock / sample_rate_hz;
+
+	// Render ahead by the baseline PCM prebuffer, the same as the mixer
+	// would for a streaming device
+	assertm(sample_rate_hz >= 8000, "Sample rate must be at least 8 kHz");
+
+	const auto audio_frames_per_ms = iround(sample_rate_hz / MillisInSecond);
+	audio_frame_fifo.Resize(
+	        check_cast<size_t>(MIXER_GetPreBufferMs() * audio_frames_per_ms));
+
+	// Size the in-bound register write FIFO
+	work_fifo.Resize(MaxSidWorkFifoSize);
+
 	// Setup and assign the port address
 	const auto read_from = std::bind(&Innovation::ReadFromPort, this, _1, _2);
 	const auto write_to = std::bind(&Innovation::WriteToPort, this, _1, _2, _3);
@@ -114,6 +134,11 @@ Innovation::Innovation(const std::string_view model_choice,
 	// Ready state-values for rendering
 	last_rendered_ms = 0.0;
 
+	// Start rendering audio
+	const auto render = std::bind(&Innovation::Render, this);
+	renderer          = std::thread(render);
+	set_thread_name(renderer, "dosbox:sid");
+
 	// Variable model_name is only used for logging, so use a const char* here
 	const char* model_name  = model_choice == "8580" ? "8580" : "6581";
 	constexpr auto us_per_s = 1'000'000.0;
@@ -137,6 +162,12 @@ Innovation::~Innovation()
 {
 	LOG_MSG("INNOVATION: Shutting down");
 
+	if (had_underruns) {
+		LOG_WARNING(
+		        "INNOVATION: Fix underruns by lowering the CPU load or "
+		        "increasing the 'prebuffer' or 'blocksize' settings");
+	}
+
 	MIXER_LockMixerThread();
 
 	// Stop playback
@@ -148,6 +179,15 @@ Innovation::~Innovation()
 	read_handler.Uninstall();
 	write_handler.Uninstall();
 
+	// Stop queueing new register writes and audio frames
+	work_fifo.Stop();
+	audio_frame_fifo.Stop();
+
+	// Wait for the rendering thread to finish
+	if (renderer.joinable()) {
+		renderer.join();
+	}
+
 	// Deregister the mixer channel and remove it
 	assert(channel);
 	MIXER_DeregisterChannel(channel);
@@ -160,85 +200,149 @@ Innovation::~Innovation()
 	MIXER_UnlockMixerThread();
 }
 
+// The SID state is read as far as the render thread has clocked it, which
+// only matters for the OSC3 and ENV3 readback registers
 uint8_t Innovation::ReadFromPort(io_port_t port, io_width_t)
 {
-	std::lock_guard lock(mutex);
+	const std::lock_guard lock(service_mutex);
 	const auto sid_port = static_cast<io_port_t>(port - base_port);
 	return service->read(sid_port);
 }
 
+// The register write is placed in the work FIFO of the render thread
 void Innovation::WriteToPort(io_port_t port, io_val_t value, io_width_t)
 {
-	std::lock_guard lock(mutex);
+	const auto sid_port = static_cast<io_port_t>(port - base_port);
 
-	RenderUpToNow();
+	SidWork work{GetNumPendingCycles(),
+	             check_cast<uint8_t>(sid_port),
+	             check_cast<uint8_t>(value)};
 
-	const auto data     = check_cast<uint8_t>(value);
-	const auto sid_port = static_cast<io_port_t>(port - base_port);
-	service->write(sid_port, data);
+	work_fifo.Enqueue(std::move(work));
 }
 
-void Innovation::RenderUpToNow()
+int Innovation::GetNumPendingCycles()
 {
-	const auto now = PIC_FullIndex();
+	const auto now_ms = PIC_FullIndex();
 
 	// Wake up the channel and update the last rendered time datum.
 	assert(channel);
 	if (channel->WakeUp()) {
-		last_rendered_ms = now;
-		return;
+		last_rendered_ms = now_ms;
+		return 0;
 	}
-	// Keep rendering until we're current
-	while (last_rendered_ms < now) {
-		last_rendered_ms += ms_per_clock;
-		if (float frame = 0.0f; MaybeRenderFrame(frame)) {
-			fifo.emplace(frame);
-		}
+	if (last_rendered_ms >= now_ms) {
+		return 0;
 	}
+
+	// Return the number of chip cycles needed to get current again
+	assert(ms_per_clock > 0.0);
+
+	const auto elapsed_ms = now_ms - last_rendered_ms;
+	const auto num_cycles = iround(ceil(elapsed_ms / ms_per_clock));
+	last_rendered_ms += (num_cycles * ms_per_clock);
+
+	return num_cycles;
+}
+
+// Returns how many chip cycles to clock while there are no register writes
+// pending: up to a block of audio frames at a time, but only as many as the
+// FIFO has room for so pending writes aren't held up behind a blocked enqueue
+int Innovation::GetNumIdleCycles()
+{
+	constexpr size_t RenderBlockFrames = 64;
+
+	const auto fill_limit  = audio_frame_fifo.GetFillLimit();
+	const auto num_queued  = audio_frame_fifo.Size();
+	const auto num_vacant  = fill_limit > num_queued ? fill_limit - num_queued : 0;
+	const auto num_to_fill = std::clamp(num_vacant, size_t{1}, RenderBlockFrames);
+
+	return std::max(iround(static_cast<double>(num_to_fill) * clocks_per_frame), 1);
 }
 
-bool Innovation::MaybeRenderFrame(float& frame)
+void Innovation::RenderCyclesToFifo(const int num_cycles)
 {
 	assert(service);
+	assert(num_cycles > 0);
 
-	int16_t sample = {0};
+	// The resampler makes at most one audio frame per frame's worth of
+	// cycles, plus one for the phase it starts at
+	const auto max_frames = iround(ceil(num_cycles / clocks_per_frame)) + 1;
+	if (check_cast<int>(render_buffer.size()) < max_frames) {
+		render_buffer.resize(check_cast<size_t>(max_frames));
+	}
+
+	std::unique_lock lock(service_mutex);
+	const auto num_frames = service->clock(check_cast<unsigned int>(num_cycles),
+	                                       render_buffer.data());
+	lock.unlock();
+
+	if (num_frames <= 0) {
+		return;
+	}
 
-	const auto frame_is_ready = service->clock(1, &sample);
+	rendered_frames.resize(check_cast<size_t>(num_frames));
+	for (size_t i = 0; i < rendered_frames.size(); ++i) {
+		rendered_frames[i] = static_cast<float>(render_buffer[i] * 2);
+	}
+	audio_frame_fifo.BulkEnqueue(rendered_frames, rendered_frames.size());
+}
+
+// The SID is clocked up to the next register write, which is then applied
+void Innovation::ProcessWorkFromFifo()
+{
+	const auto work = work_fifo.Dequeue();
+	if (!work) {
+		return;
+	}
 
-	// Get the frame
-	if (frame_is_ready) {
-		frame = static_cast<float>(sample * 2);
+	if (work->num_pending_cycles > 0) {
+		RenderCyclesToFifo(work->num_pending_cycles);
 	}
 
-	return frame_is_ready;
+	const std::lock_guard lock(service_mutex);
+	service->write(work->reg, work->val);
+}
+
+// Keep the FIFO populated with freshly rendered audio frames
+void Innovation::Render()
+{
+	while (work_fifo.IsRunning()) {
+		work_fifo.IsEmpty() ? RenderCyclesToFifo(GetNumIdleCycles())
+		                    : ProcessWorkFromFifo();
+	}
 }
 
 void Innovation::AudioCallback(const int requested_frames)
 {
 	assert(channel);
 
-	std::lock_guard lock(mutex);
+	// Report buffer underruns
+	constexpr auto WarningPercent = 5.0f;
 
-	// if (fifo.size())
-	//	LOG_MSG("INNOVATION: Queued %2lu cycle-accurate frames",
-	// fifo.size());
+	if (const auto percent_full = audio_frame_fifo.GetPercentFull();
+	    percent_full < WarningPercent) {
+		static auto iteration = 0;
+		if (iteration++ % 100 == 0) {
+			LOG_WARNING("INNOVATION: Audio buffer underrun");
+		}
+		had_underruns = true;
+	}
 
-	auto frames_remaining = requested_frames;
+	static std::vector<float> audio_frames = {};
 
-	// First, send any frames we've queued since the last callback
-	while (frames_remaining && fifo.size()) {
-		channel->AddSamples_mfloat(1, &fifo.front());
-		fifo.pop();
-		--frames_remaining;
-	}
-	// If the queue's run dry, render the remainder and sync-up our time datum
-	while (frames_remaining) {
-		if (float frame = 0.0f; MaybeRenderFrame(frame)) {
-			channel->AddSamples_mfloat(1, &frame);
-		}
-		--frames_remaining;
+	const auto has_dequeued = audio_frame_fifo.BulkDequeue(audio_frames,
+	                                                       requested_frames);
+
+	if (has_dequeued) {
+		assert(check_cast<int>(audio_frames.size()) == requested_frames);
+		channel->AddSamples_mfloat(requested_frames, audio_frames.data());
+
+		last_rendered_ms = PIC_AtomicIndex();
+	} else {
+		assert(!audio_frame_fifo.IsRunning());
+		channel->AddSilence();
 	}
-	last_rendered_ms = PIC_AtomicIndex();
 }
 
 static std::unique_ptr<Innovation> innovation = {};
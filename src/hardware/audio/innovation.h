@@ -4,8 +4,18 @@
 #ifndef DOSBOX_INNOVATION_H
 #define DOSBOX_INNOVATION_H
 
+#include <cstdint>
+
 #include "config/config.h"
 
+// A register write for the SID render thread, made after the chip has been
+// clocked for the given number of cycles since the previous one
+struct SidWork {
+	int num_pending_cycles = 0;
+	uint8_t reg            = 0;
+	uint8_t val            = 0;
+};
+
 void INNOVATION_AddConfigSection(const ConfigPtr& conf);
 void INNOVATION_Init();
 void INNOVATION_Destroy();
@@ -82,10 +82,14 @@ void LptDac::RenderUpToNow()
 	}
 	// Keep rendering until we're current
 	assert(ms_per_frame > 0.0);
+	int num_frames = 0;
 	while (last_rendered_ms < now) {
 		last_rendered_ms += ms_per_frame;
-		++frames_rendered_this_tick;
-		output_queue.NonblockingEnqueue(Render());
+		++num_frames;
+	}
+	if (num_frames > 0) {
+		frames_rendered_this_tick += num_frames;
+		Render(num_frames);
 	}
 }
 
@@ -96,11 +100,17 @@ void LptDac::PicCallback(const int requested_frames)
 	const auto frames_remaining = requested_frames - frames_rendered_this_tick;
 
 	// If the queue's run dry, render the remainder and sync-up our time datum
-	for (int i = 0; i < frames_remaining; ++i) {
-		output_queue.NonblockingEnqueue(Render());
+	if (frames_remaining > 0) {
+		Render(frames_remaining);
 	}
 	last_rendered_ms = PIC_FullIndex();
 	frames_rendered_this_tick = 0;
+
+	// Pass the tick's frames to the mixer with a single queue operation.
+	// Like the frame-wise enqueuing before, the frames that don't fit are
+	// dropped.
+	output_queue.NonblockingBulkEnqueue(render_buffer);
+	render_buffer.clear();
 }
 
 LptDac::~LptDac()
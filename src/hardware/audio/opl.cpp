@@ -5,6 +5,7 @@
 
 #include "private/gus.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
@@ -299,6 +300,21 @@ void Opl::Init()
 }
 
 void Opl::WriteReg(const io_port_t selected_reg, const uint8_t val)
+{
+	if (batch.enabled) {
+		// Batched rendering is never enabled in ESFM mode
+		assert(opl.mode != OplMode::Esfm);
+
+		QueueWrite(QueuedWrite::Target::Chip, selected_reg, val);
+		if (selected_reg == 0x105) {
+			opl.newm = selected_reg & 0x01;
+		}
+	} else {
+		WriteChipReg(selected_reg, val);
+	}
+}
+
+void Opl::WriteChipReg(const io_port_t selected_reg, const uint8_t val)
 {
 	if (opl.mode == OplMode::Esfm) {
 		ESFM_write_reg_buffered_fast(&esfm.chip, selected_reg, val);
@@ -312,6 +328,26 @@ void Opl::WriteReg(const io_port_t selected_reg, const uint8_t val)
 	}
 }
 
+void Opl::QueueWrite(const QueuedWrite::Target target, const uint16_t reg,
+                     const uint8_t val)
+{
+	batch.pending.push_back({PIC_FullIndex(), target, reg, val});
+}
+
+// Only called on the mixer thread in batched mode
+void Opl::ApplyWrite(const QueuedWrite& write)
+{
+	switch (write.target) {
+	case QueuedWrite::Target::Chip:
+		OPL3_WriteRegBuffered(&opl.chip, write.reg, write.val);
+		break;
+
+	case QueuedWrite::Target::AdlibGold:
+		AdlibGoldProcessorWrite(check_cast<uint8_t>(write.reg), write.val);
+		break;
+	}
+}
+
 io_port_t Opl::WriteAddr(const io_port_t port, const uint8_t val)
 {
 	if (opl.mode == OplMode::Esfm) {
@@ -380,37 +416,36 @@ int16_t remove_dc_bias(const int16_t back_sample)
 	return static_cast<int16_t>(front_sample - average);
 }
 
-AudioFrame Opl::RenderFrame()
+// Renders a block of frames with the current register state; the register
+// writes must be applied between the blocks
+void Opl::RenderFrames(const int num_frames, AudioFrame* frames)
 {
-	static int16_t buf[2] = {};
-
-	if (opl.mode == OplMode::Esfm) {
-		ESFM_generate_stream(&esfm.chip, buf, 1);
+	assert(num_frames > 0);
 
-		if (ctrl.wants_dc_bias_removed) {
-			buf[0] = remove_dc_bias<Left>(buf[0]);
-			buf[1] = remove_dc_bias<Right>(buf[1]);
-		}
+	const auto num_samples = static_cast<size_t>(num_frames) * 2;
+	render_buf.resize(num_samples);
 
-		AudioFrame frame = {buf[0], buf[1]};
-		return frame;
+	auto buf = render_buf.data();
 
+	if (opl.mode == OplMode::Esfm) {
+		ESFM_generate_stream(&esfm.chip, buf, static_cast<uint32_t>(num_frames));
 	} else { // OPL
-		OPL3_GenerateStream(&opl.chip, buf, 1);
+		OPL3_GenerateStream(&opl.chip, buf, static_cast<uint32_t>(num_frames));
+	}
 
-		if (ctrl.wants_dc_bias_removed) {
-			buf[0] = remove_dc_bias<Left>(buf[0]);
-			buf[1] = remove_dc_bias<Right>(buf[1]);
+	if (ctrl.wants_dc_bias_removed) {
+		for (size_t i = 0; i < num_samples; i += 2) {
+			buf[i]     = remove_dc_bias<Left>(buf[i]);
+			buf[i + 1] = remove_dc_bias<Right>(buf[i + 1]);
 		}
+	}
 
-		AudioFrame frame = {};
-		if (adlib_gold) {
-			adlib_gold->Process(buf, 1, &frame[0]);
-		} else {
-			frame.left  = buf[0];
-			frame.right = buf[1];
+	if (adlib_gold) {
+		adlib_gold->Process(buf, num_frames, &frames[0][0]);
+	} else {
+		for (auto i = 0; i < num_frames; ++i) {
+			frames[i] = {buf[i * 2], buf[i * 2 + 1]};
 		}
-		return frame;
 	}
 }
 
@@ -425,16 +460,106 @@ void Opl::RenderUpToNow()
 		return;
 	}
 	// Keep rendering until we're current
+	auto num_frames = 0;
 	while (last_rendered_ms < now) {
 		last_rendered_ms += ms_per_frame;
-		fifo.emplace(RenderFrame());
+		++num_frames;
+	}
+	if (num_frames == 0) {
+		return;
+	}
+
+	render_frames.resize(static_cast<size_t>(num_frames));
+	RenderFrames(num_frames, render_frames.data());
+
+	for (const auto& frame : render_frames) {
+		fifo.emplace(frame);
 	}
 }
 
+// Render a whole block on the mixer thread. The block spans the emulated time
+// since the previous block, and the register writes made in that period are
+// applied right before the first frame at or after their timestamp, just like
+// RenderUpToNow() would have done.
+void Opl::RenderBatch(const int num_frames)
+{
+	assert(num_frames > 0);
+
+	double start_ms = 0.0;
+	double end_ms   = 0.0;
+	{
+		std::lock_guard lock(mutex);
+
+		batch.writes.insert(batch.writes.end(),
+		                    batch.pending.begin(),
+		                    batch.pending.end());
+		batch.pending.clear();
+
+		start_ms = batch.start_ms;
+		end_ms   = PIC_AtomicIndex();
+
+		batch.start_ms = std::max(start_ms, end_ms);
+	}
+
+	// The emulated time doesn't advance while the emulation is paused
+	const auto span_ms = std::max(end_ms - start_ms, 0.0);
+
+	size_t next_write = 0;
+
+	auto frame_ms = [&](const int i) {
+		return start_ms + span_ms * i / num_frames;
+	};
+
+	// Render straight into the channel's buffer, in runs of frames between
+	// the register writes
+	auto render = [&](std::span<AudioFrame> frames) {
+		auto i = 0;
+		while (i < num_frames) {
+			while (next_write < batch.writes.size() &&
+			       batch.writes[next_write].timestamp_ms <= frame_ms(i)) {
+				ApplyWrite(batch.writes[next_write++]);
+			}
+
+			// The run ends at the frame the next write applies to
+			auto run_end = i + 1;
+			if (next_write < batch.writes.size()) {
+				const auto write_ms = batch.writes[next_write].timestamp_ms;
+				while (run_end < num_frames && frame_ms(run_end) < write_ms) {
+					++run_end;
+				}
+			} else {
+				run_end = num_frames;
+			}
+
+			RenderFrames(run_end - i, &frames[check_cast<size_t>(i)]);
+			i = run_end;
+		}
+	};
+	channel->RenderAudioFrames(num_frames, render);
+
+	// Writes made during the last frame take effect in the next block
+	while (next_write < batch.writes.size() &&
+	       batch.writes[next_write].timestamp_ms < end_ms) {
+		ApplyWrite(batch.writes[next_write++]);
+	}
+
+	// The main thread can be slightly ahead of the atomic time index, so
+	// keep any writes timestamped after this block for the next one
+	batch.writes.erase(batch.writes.begin(),
+	                   batch.writes.begin() +
+	                           static_cast<std::ptrdiff_t>(next_write));
+}
+
 void Opl::AudioCallback(const int requested_frames)
 {
-	std::lock_guard lock(mutex);
 	assert(channel);
+
+	if (batch.enabled) {
+		RenderBatch(requested_frames);
+		return;
+	}
+
+	std::lock_guard lock(mutex);
 #if 0
 	if (fifo.size()) {
 		LOG_MSG("%s: Queued %2lu cycle-accurate frames",
@@ -451,10 +576,11 @@ void Opl::AudioCallback(const int requested_frames)
 		--frames_remaining;
 	}
 	// If the queue's run dry, render the remainder and sync-up our time datum
-	while (frames_remaining) {
-		const auto frame = RenderFrame();
-		channel->AddSamples_sfloat(1, &frame[0]);
-		--frames_remaining;
+	if (frames_remaining > 0) {
+		render_frames.resize(static_cast<size_t>(frames_remaining));
+		RenderFrames(frames_remaining, render_frames.data());
+
+		channel->AddSamples_sfloat(frames_remaining, &render_frames[0][0]);
 	}
 	last_rendered_ms = PIC_AtomicIndex();
 }
@@ -499,9 +625,9 @@ void Opl::DualWrite(const uint8_t index, const uint8_t port, const uint8_t value
 	CacheWrite(full_port, val);
 }
 
-void Opl::AdlibGoldControlWrite(const uint8_t val)
+void Opl::AdlibGoldProcessorWrite(const uint8_t index, const uint8_t val)
 {
-	switch (ctrl.index) {
+	switch (index) {
 	case 0x04:
 		adlib_gold->StereoControlWrite(StereoProcessorControlReg::VolumeLeft,
 		                               val);
@@ -523,6 +649,29 @@ void Opl::AdlibGoldControlWrite(const uint8_t val)
 		                               val);
 		break;
 
+	case 0x18: // Surround
+		adlib_gold->SurroundControlWrite(val);
+	}
+}
+
+void Opl::AdlibGoldControlWrite(const uint8_t val)
+{
+	switch (ctrl.index) {
+	case 0x04:
+	case 0x05:
+	case 0x06:
+	case 0x07:
+	case 0x08:
+	case 0x18:
+		// The stereo and surround processors run on the mixer thread
+		// in batched mode
+		if (batch.enabled) {
+			QueueWrite(QueuedWrite::Target::AdlibGold, ctrl.index, val);
+		} else {
+			AdlibGoldProcessorWrite(ctrl.index, val);
+		}
+		break;
+
 	case 0x09: // Left FM Volume
 		ctrl.lvol = val;
 		goto setvol;
@@ -539,9 +688,6 @@ void Opl::AdlibGoldControlWrite(const uint8_t val)
 			         static_cast<float>(ctrl.rvol & 0x1f) / 31.0f});
 		}
 		break;
-
-	case 0x18: // Surround
-		adlib_gold->SurroundControlWrite(val);
 	}
 }
 
@@ -570,7 +716,17 @@ uint8_t Opl::AdlibGoldControlRead()
 void Opl::PortWrite(const io_port_t port, const io_val_t value, const io_width_t)
 {
 	std::lock_guard lock(mutex);
-	RenderUpToNow();
+
+	if (batch.enabled) {
+		// The mixer thread renders the audio, we only need to restart
+		// the block timeline after the channel has been asleep
+		assert(channel);
+		if (channel->WakeUp()) {
+			batch.start_ms = PIC_FullIndex();
+		}
+	} else {
+		RenderUpToNow();
+	}
 
 	const auto val = check_cast<uint8_t>(value);
 
@@ -908,6 +1064,19 @@ Opl::Opl(Section* configuration, const OplMode _opl_mode)
 		LOG_MSG("%s: DC bias removal enabled", channel->GetName().c_str());
 	}
 
+	if (section->GetBool("opl_batch_rendering")) {
+		// The ESFM's native mode reads and writes the synth state
+		// directly from the port handlers
+		if (opl.mode == OplMode::Esfm) {
+			LOG_WARNING("%s: Batched rendering is not supported in ESFM mode",
+			            channel->GetName().c_str());
+		} else {
+			batch.enabled = true;
+			LOG_MSG("%s: Batched rendering enabled",
+			        channel->GetName().c_str());
+		}
+	}
+
 	Init();
 
 	using namespace std::placeholders;
@@ -1024,6 +1193,14 @@ static void init_opl_config_settings(SectionProp& secprop)
 	        "Wizardry 6 (1990), and Wizardry 7 (1992). Please open an issue ticket if you\n"
 	        "find other affected games.");
 
+	pbool = secprop.AddBool("opl_batch_rendering", when_idle, false);
+	pbool->SetHelp(
+	        "Render the OPL output in whole blocks on the mixer thread ('off' by default).\n"
+	        "Register writes are timestamped and applied at their position within the block,\n"
+	        "so the emulation no longer has to synthesise audio on every port write. This\n"
+	        "can help with music that writes the OPL registers very often on slow hosts.\n"
+	        "Not supported with 'oplmode = esfm'.");
+
 	pstring = secprop.AddString("oplemu", deprecated, "");
 	pstring->SetHelp("Only 'nuked' OPL emulation is supported now.");
 
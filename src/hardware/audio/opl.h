@@ -9,6 +9,7 @@
 #include <cmath>
 #include <memory>
 #include <queue>
+#include <vector>
 
 #include "ESFMu/esfm.h"
 #include "nuked/opl3.h"
@@ -122,6 +123,36 @@ private:
 	double last_rendered_ms = 0.0;
 	double ms_per_frame     = 0.0;
 
+	// Scratch buffers for the block rendering; only used by the thread
+	// holding 'mutex', or by the mixer thread in batched mode
+	std::vector<int16_t> render_buf       = {};
+	std::vector<AudioFrame> render_frames = {};
+
+	// A register write deferred to the mixer thread
+	struct QueuedWrite {
+		enum class Target : uint8_t { Chip, AdlibGold };
+
+		double timestamp_ms = 0.0;
+		Target target       = Target::Chip;
+		uint16_t reg        = 0;
+		uint8_t val         = 0;
+	};
+
+	// Batched rendering: instead of rendering up to the current time on
+	// every port write, the writes are timestamped and queued, then the
+	// mixer thread renders whole blocks and applies them at the matching
+	// frame positions.
+	struct {
+		bool enabled = false;
+
+		// Written by the main thread, guarded by 'mutex'
+		std::vector<QueuedWrite> pending = {};
+		double start_ms                  = 0.0;
+
+		// Only used by the mixer thread
+		std::vector<QueuedWrite> writes = {};
+	} batch = {};
+
 	// Last selected address in the chip for the different modes
 	union {
 		uint16_t normal = 0;
@@ -143,8 +174,13 @@ private:
 	void Init();
 
 	void AudioCallback(const int frames);
-	AudioFrame RenderFrame();
+	void RenderFrames(const int num_frames, AudioFrame* frames);
 	void RenderUpToNow();
+	void RenderBatch(const int frames);
+
+	void QueueWrite(const QueuedWrite::Target target, const uint16_t reg,
+	                const uint8_t val);
+	void ApplyWrite(const QueuedWrite& write);
 
 	void PortWrite(const io_port_t port, const io_val_t value,
 	               const io_width_t width);
@@ -153,10 +189,12 @@ private:
 
 	io_port_t WriteAddr(const io_port_t port, const uint8_t val);
 	void WriteReg(const io_port_t selected_reg, const uint8_t val);
+	void WriteChipReg(const io_port_t selected_reg, const uint8_t val);
 	void CacheWrite(const io_port_t port, const uint8_t val);
 	void DualWrite(const uint8_t index, const uint8_t reg, const uint8_t value);
 
 	void AdlibGoldControlWrite(const uint8_t val);
+	void AdlibGoldProcessorWrite(const uint8_t index, const uint8_t val);
 	uint8_t AdlibGoldControlRead(void);
 
 	void EsfmSetLegacyMode();
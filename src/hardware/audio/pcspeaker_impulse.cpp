@@ -8,6 +8,9 @@
 
 #include "private/pcspeaker_impulse.h"
 
+#include <algorithm>
+
+#include "simde/x86/sse2.h"
 #include "utils/checks.h"
 #include "utils/math_utils.h"
 
@@ -374,6 +377,24 @@ float PcSpeakerImpulse::CalcImpulse(const double t) const
 		return 0.0f;
 }
 
+// Add the impulse scaled by the amplitude to the waveform, four samples at a
+// time. PWM-driven digitised sound adds thousands of impulses per second.
+static void add_scaled(float* waveform, const float* impulse,
+                       const float amplitude, const size_t num_samples)
+{
+	const auto scale = simde_mm_set1_ps(amplitude);
+
+	size_t i = 0;
+	for (; i + 4 <= num_samples; i += 4) {
+		const auto scaled = simde_mm_mul_ps(scale, simde_mm_loadu_ps(impulse + i));
+		simde_mm_storeu_ps(waveform + i,
+		                   simde_mm_add_ps(simde_mm_loadu_ps(waveform + i), scaled));
+	}
+	for (; i < num_samples; ++i) {
+		waveform[i] += amplitude * impulse[i];
+	}
+}
+
 void PcSpeakerImpulse::AddImpulse(float index, const int16_t amplitude)
 {
 	if (channel->WakeUp())
@@ -398,22 +419,29 @@ void PcSpeakerImpulse::AddImpulse(float index, const int16_t amplitude)
 		phase = sinc_oversampling_factor - phase;
 	}
 
-	for (auto i = 0; i < sinc_filter_quality; ++i) {
-		const auto wave_i    = check_cast<uint16_t>(offset + i);
-		const auto impulse_i = check_cast<uint16_t>(
-		        phase + i * sinc_oversampling_factor);
-		waveform_deque.at(wave_i) += amplitude * impulse_lut.at(impulse_i);
-	}
+	const auto& impulse = impulse_lut[static_cast<size_t>(phase)];
+
+	// The impulse wraps around the end of the ring buffer
+	const auto start = (waveform_head + static_cast<size_t>(offset)) %
+	                   waveform.size();
+	const auto first_run = std::min(impulse.size(), waveform.size() - start);
+
+	add_scaled(waveform.data() + start, impulse.data(), amplitude, first_run);
+	add_scaled(waveform.data(),
+	           impulse.data() + first_run,
+	           amplitude,
+	           impulse.size() - first_run);
 }
 
 #else
 	// Mathematically intensive reference implementation
 	const auto portion_of_ms = static_cast <double>(index) / MillisInSecond;
-	for (size_t i = 0; i < waveform_deque.size(); ++i) {
+	for (size_t i = 0; i < waveform.size(); ++i) {
 		const auto impulse_time = static_cast<double>(i) / sample_rate_hz -
 		                          portion_of_ms;
 
-		waveform_deque[i] += amplitude * CalcImpulse(impulse_time);
+		const auto wave_i = (waveform_head + i) % waveform.size();
+		waveform[wave_i] += amplitude * CalcImpulse(impulse_time);
 	}
 }
 #endif
@@ -425,11 +453,13 @@ void PcSpeakerImpulse::PicCallback(const int requested_frames)
 	int remaining_frames = requested_frames;
 
 	static float accumulator = 0;
-	while (remaining_frames > 0 && waveform_deque.size()) {
-		// Pop the first sample off the waveform
-		accumulator += waveform_deque.front();
-		waveform_deque.pop_front();
-		waveform_deque.push_back(0.0f);
+	while (remaining_frames > 0 && waveform.size()) {
+		// Pop the first sample off the waveform, making room for a new
+		// one at the end
+		auto& sample = waveform[waveform_head];
+		accumulator += sample;
+		sample        = 0.0f;
+		waveform_head = (waveform_head + 1) % waveform.size();
 
 		// std::move only used here because it won't compile without
 		// This is just a float so it's safe to use afterwards
@@ -459,11 +489,15 @@ void PcSpeakerImpulse::PicCallback(const int requested_frames)
 
 void PcSpeakerImpulse::InitializeImpulseLUT()
 {
-	assert(impulse_lut.size() == sinc_filter_width);
-
-	for (auto i = 0u; i < sinc_filter_width; ++i) {
-		impulse_lut[i] = CalcImpulse(i / (static_cast<double>(sample_rate_hz) *
-		                                  sinc_oversampling_factor));
+	constexpr auto phases_per_second = static_cast<double>(sample_rate_hz) *
+	                                   sinc_oversampling_factor;
+
+	for (auto phase = 0; phase < sinc_oversampling_factor; ++phase) {
+		auto& impulse = impulse_lut[static_cast<size_t>(phase)];
+		for (auto i = 0; i < sinc_filter_quality; ++i) {
+			const auto t = phase + i * sinc_oversampling_factor;
+			impulse[static_cast<size_t>(i)] = CalcImpulse(t / phases_per_second);
+		}
 	}
 }
 
@@ -512,7 +546,7 @@ PcSpeakerImpulse::PcSpeakerImpulse()
 
 	// Size the waveform queue
 	constexpr auto waveform_size = sinc_filter_quality + sample_rate_per_ms;
-	waveform_deque.resize(waveform_size, 0.0f);
+	waveform.resize(waveform_size, 0.0f);
 
 	// Register the sound channel
 	constexpr bool Stereo = false;
@@ -531,6 +565,8 @@ PcSpeakerImpulse::PcSpeakerImpulse()
 	                            ChannelFeature::Synthesizer});
 	assert(channel);
 
+	channel->SetResampleMethod(ResampleMethod::PolyphaseResample);
+
 	LOG_MSG("%s: Initialised %s model", device_name, model_name);
 
 	channel->SetPeakAmplitude(positive_amplitude);
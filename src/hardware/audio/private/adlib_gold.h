@@ -6,6 +6,8 @@
 
 #include "dosbox.h"
 
+#include <vector>
+
 #include "audio/mixer.h"
 #include "utils/bit_view.h"
 
@@ -23,7 +25,9 @@ public:
 	~SurroundProcessor();
 
 	void ControlWrite(const uint8_t val);
-	AudioFrame Process(const AudioFrame frame);
+
+	// Processes a block of mono samples into stereo frames
+	void Process(const float* in, const int frames, AudioFrame* out);
 
 	// prevent copying
 	SurroundProcessor(const SurroundProcessor&) = delete;
@@ -80,7 +84,9 @@ public:
 
 	void Reset();
 	void ControlWrite(const StereoProcessorControlReg, const uint8_t data);
-	AudioFrame Process(const AudioFrame frame);
+
+	// Processes a block of frames in place
+	void Process(AudioFrame* frames, const int num_frames);
 
 	void SetLowShelfGain(const double gain_db);
 	void SetHighShelfGain(const double gain_db);
@@ -105,9 +111,9 @@ private:
 	// All-pass filter for pseudo-stereo processing
 	Iir::RBJ::AllPass allpass = {};
 
-	AudioFrame ProcessSourceSelection(const AudioFrame frame);
-	AudioFrame ProcessShelvingFilters(const AudioFrame frame);
-	AudioFrame ProcessStereoProcessing(const AudioFrame frame);
+	void ProcessSourceSelection(AudioFrame* frames, const int num_frames);
+	void ProcessShelvingFilters(AudioFrame* frames, const int num_frames);
+	void ProcessStereoProcessing(AudioFrame* frames, const int num_frames);
 };
 
 class AdlibGold {
@@ -124,6 +130,10 @@ public:
 private:
 	std::unique_ptr<SurroundProcessor> surround_processor = {};
 	std::unique_ptr<StereoProcessor> stereo_processor     = {};
+
+	// Scratch buffers for the block processing
+	std::vector<float> mono_buf     = {};
+	std::vector<AudioFrame> wet_buf = {};
 };
 
 #endif // DOSBOX_ADLIB_GOLD_H
@@ -8,7 +8,6 @@
 
 #include <array>
 #include <memory>
-#include <queue>
 #include <string>
 #include <vector>
 
@@ -30,9 +29,19 @@ public:
 	~Cms();
 
 private:
-	AudioFrame RenderFrame();
 	void AudioCallback(const int requested_frames);
-	void RenderUpToNow();
+	void RenderFrames(const int num_frames);
+
+	// A port write deferred to the mixer thread
+	struct QueuedWrite {
+		double timestamp_ms = 0.0;
+		uint8_t device      = 0;
+		bool is_control     = false;
+		uint8_t val         = 0;
+	};
+
+	void QueueWrite(const uint8_t device, const bool is_control, io_val_t value);
+	void ApplyWrite(const QueuedWrite& write);
 
 	// IO callbacks to the left SAA1099 device
 	void WriteDataToLeftDevice(io_port_t port, io_val_t value, io_width_t width);
@@ -59,18 +68,23 @@ private:
 
 	std::unique_ptr<saa1099_device> devices[2] = {};
 
-	std::queue<AudioFrame> fifo = {};
-
 	std::mutex mutex = {};
 
 	// Static rate-related configuration
 	static constexpr auto ChipClockHz   = 14318180 / 2;
 	static constexpr auto RenderDivisor = 32;
 	static constexpr auto RenderRateHz = ceil_sdivide(ChipClockHz, RenderDivisor);
-	static constexpr auto MsPerRender = MillisInSecond / RenderRateHz;
+
+	// Written by the main thread, guarded by 'mutex'
+	std::vector<QueuedWrite> pending_writes = {};
+	double block_start_ms                   = 0.0;
+
+	// Only used by the mixer thread
+	std::vector<QueuedWrite> writes         = {};
+	std::vector<AudioFrame> frames          = {};
+	std::array<std::vector<int16_t>, 2> buf = {};
 
 	// Runtime states
-	double last_rendered_ms        = 0;
 	io_port_t base_port            = 0;
 	bool is_standalone_gameblaster = false;
 	uint8_t cms_detect_register    = 0xff;
@@ -19,7 +19,7 @@ public:
 	void ConfigureFilters(const FilterState state) override;
 
 protected:
-	AudioFrame Render() override;
+	void Render(const int num_frames) override;
 
 private:
 	void WriteData(const io_port_t, const io_val_t value, const io_width_t);
@@ -22,7 +22,7 @@ public:
 	void ConfigureFilters(const FilterState state) override;
 
 protected:
-	AudioFrame Render() override;
+	void Render(const int num_frames) override;
 
 private:
 	bool IsFifoFull() const;
@@ -139,6 +139,11 @@ private:
 	bool Is16Bit() const noexcept;
 	float GetVolScalar(const vol_scalars_array_t& vol_scalars);
 	float GetSample(const ram_array_t& ram) noexcept;
+	size_t CountSteadySteps(const VoiceCtrl& ctrl) const noexcept;
+	void RenderSteadyFrames(const ram_array_t& ram,
+	                        const vol_scalars_array_t& vol_scalars,
+	                        const AudioFrame pan_scalar, AudioFrame* frames,
+	                        const size_t num_frames);
 	int32_t PopWavePos() noexcept;
 	float PopVolScalar(const vol_scalars_array_t& vol_scalars);
 	float Read8BitSample(const ram_array_t& ram, int32_t addr) const noexcept;
@@ -159,6 +164,9 @@ private:
 		DECREASING    = 0x40,
 	};
 
+	// Upper limit of the frames rendered in one go by RenderSteadyFrames()
+	static constexpr size_t MaxSteadyFrames = 64;
+
 	uint32_t irq_mask = 0;
 	uint8_t& shared_irq_status;
 	uint8_t pan_position = PAN_DEFAULT_POSITION;
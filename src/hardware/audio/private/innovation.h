@@ -7,13 +7,18 @@
 #include "dosbox.h"
 
 #include <memory>
-#include <queue>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "residfp/SID.h"
 
 #include "audio/mixer.h"
+#include "hardware/audio/innovation.h"
 #include "hardware/port.h"
+#include "utils/rwqueue.h"
+#include "utils/spsc_queue.h"
 
 class Innovation {
 public:
@@ -30,28 +35,40 @@ private:
 	uint8_t ReadFromPort(io_port_t port, io_width_t width);
 	void WriteToPort(io_port_t port, io_val_t value, io_width_t width);
 
-	bool MaybeRenderFrame(float& frame);
-	void RenderUpToNow();
-
-	int16_t TallySilence(const int16_t sample);
+	int GetNumPendingCycles();
+	int GetNumIdleCycles();
+	void RenderCyclesToFifo(const int num_cycles);
+	void ProcessWorkFromFifo();
+	void Render();
 
 	// Managed objects
 	MixerChannelPtr channel               = nullptr;
 	IO_ReadHandleObject read_handler      = {};
 	IO_WriteHandleObject write_handler    = {};
 	std::unique_ptr<reSIDfp::SID> service = {};
-	std::queue<float> fifo                = {};
-	std::mutex mutex                      = {};
+	std::mutex service_mutex              = {};
+
+	// The SID is clocked on the render thread, which runs ahead of the
+	// mixer by filling the audio frame FIFO
+	SpscQueue<float> audio_frame_fifo{1};
+	RWQueue<SidWork> work_fifo{1};
+	std::thread renderer = {};
+
+	// Only used by the render thread
+	std::vector<int16_t> render_buffer = {};
+	std::vector<float> rendered_frames = {};
 
 	// Initial configuration
-	double chip_clock            = 0.0;
-	double ms_per_clock          = 0.0;
-	io_port_t base_port          = 0;
-	int idle_after_silent_frames = 0;
+	double chip_clock       = 0.0;
+	double ms_per_clock     = 0.0;
+	double clocks_per_frame = 0.0;
+	io_port_t base_port     = 0;
 
-	// Runtime states
+	// Used to track the balance of time between the last mixer callback
+	// and the current register write
 	double last_rendered_ms = 0.0;
-	bool is_open            = false;
+
+	bool had_underruns = false;
 };
 
 #endif // DOSBOX_PRIVATE_INNOVATION_H
@@ -10,6 +10,7 @@
 #include <set>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "audio/mixer.h"
 #include "hardware/lpt.h"
@@ -45,9 +46,15 @@ public:
 
 protected:
 	// Base LPT DAC functionality
-	virtual AudioFrame Render() = 0;
+
+	// Appends the given number of frames to the render buffer
+	virtual void Render(const int num_frames) = 0;
 	void RenderUpToNow();
 
+	// The frames rendered during the current tick; they're passed to the
+	// mixer in one go at the end of the tick
+	std::vector<AudioFrame> render_buffer = {};
+
 	double last_rendered_ms = 0.0;
 	double ms_per_frame     = 0.0;
 
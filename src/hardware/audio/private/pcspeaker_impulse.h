@@ -7,8 +7,8 @@
 #include "pcspeaker.h"
 
 #include <array>
-#include <deque>
 #include <string>
+#include <vector>
 
 #include "audio/channel_names.h"
 #include "config/setup.h"
@@ -68,9 +68,6 @@ private:
 	static constexpr auto sinc_filter_quality      = 100;
 	static constexpr auto sinc_oversampling_factor = 32;
 
-	static constexpr auto sinc_filter_width = sinc_filter_quality *
-	                                          sinc_oversampling_factor;
-
 	static constexpr float max_possible_pit_ms = 1320000.0f / PIT_TICK_RATE;
 
 	// Compound types and containers
@@ -96,9 +93,14 @@ private:
 		int16_t prev_amplitude = negative_amplitude;
 	} pit = {};
 
-	std::deque<float> waveform_deque = {};
+	// Ring buffer of the upcoming output samples, starting at the head
+	std::vector<float> waveform = {};
+	size_t waveform_head        = 0;
 
-	std::array<float, sinc_filter_width> impulse_lut = {};
+	// The impulse response at each sub-sample phase, stored contiguously
+	// so adding an impulse is a single multiply-add run
+	using Impulse = std::array<float, sinc_filter_quality>;
+	std::array<Impulse, sinc_oversampling_factor> impulse_lut = {};
 
 	PpiPortB prev_port_b = {};
 
@@ -23,7 +23,7 @@ public:
 	void ConfigureFilters(const FilterState state) override;
 
 private:
-	AudioFrame Render() override;
+	void Render(const int num_frames) override;
 	void WriteData(const io_port_t, const io_val_t value, const io_width_t);
 	uint8_t ReadStatus(const io_port_t, const io_width_t);
 	void WriteControl(const io_port_t, const io_val_t value, const io_width_t);
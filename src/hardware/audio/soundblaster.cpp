@@ -13,6 +13,7 @@
 #include <iomanip>
 #include <map>
 #include <optional>
+#include <span>
 #include <string>
 #include <tuple>
 
@@ -25,6 +26,7 @@
 #include "hardware/timer.h"
 #include "ints/bios.h"
 #include "midi/midi.h"
+#include "misc/host_memory.h"
 #include "misc/messages.h"
 #include "misc/notifications.h"
 #include "misc/support.h"
@@ -1057,6 +1059,22 @@ static uint32_t read_dma_8bit(const uint32_t bytes_to_read,
 	return check_cast<uint32_t>(bytes_read);
 }
 
+// Like read_dma_8bit(), but passes the bytes straight from guest RAM to the
+// 'consume' function instead of copying them into the DMA buffer
+static uint32_t read_dma_8bit_spans(const uint32_t bytes_to_read,
+                                    const DMA_SpanCallback& consume)
+{
+	assertm(!sb.dma.chan->is_16bit,
+	        "SBLASTER: read_dma_8bit_spans() called but DMA controller is configured for 16-bit reads");
+
+	const uint32_t clamped_bytes = std::min(bytes_to_read,
+	                                        static_cast<uint32_t>(DmaBufSize));
+	const auto bytes_read = sb.dma.chan->ReadSpans(clamped_bytes, consume);
+	assert(bytes_read <= clamped_bytes);
+
+	return check_cast<uint32_t>(bytes_read);
+}
+
 static uint32_t read_dma_16bit(const uint32_t words_to_read,
                                const uint32_t buffer_index = 0)
 {
@@ -1142,30 +1160,33 @@ static void play_dma_transfer(const uint32_t bytes_requested)
 
 	auto decode_adpcm_dma =
 	        [&](auto decode_adpcm_fn) -> std::tuple<uint32_t, uint32_t, uint16_t> {
-		const uint32_t num_bytes = read_dma_8bit(bytes_to_read);
-		uint32_t num_samples     = 0;
-		uint16_t num_frames      = 0;
-
-		// Parse the reference ADPCM byte, if provided
-		uint32_t i = 0;
-		if (num_bytes > 0 && sb.adpcm.haveref) {
-			sb.adpcm.haveref   = false;
-			sb.adpcm.reference = sb.dma.buf.b8[0];
-			sb.adpcm.stepsize  = MinAdaptiveStepSize;
-			++i;
-		}
-		// Decode the remaining DMA buffer into samples using the
-		// provided function
-		while (i < num_bytes) {
-			const auto decoded = decode_adpcm_fn(sb.dma.buf.b8[i]);
-			constexpr auto NumDecoded = check_cast<uint8_t>(
-			        decoded.size());
-
-			enqueue_frames(maybe_silence<FrameType::Mono>(decoded.data(),
-			                                              NumDecoded));
-			num_samples += NumDecoded;
-			i++;
-		}
+		uint32_t num_samples = 0;
+		uint16_t num_frames  = 0;
+
+		auto decode_span = [&](const std::span<const uint8_t> data) {
+			auto byte = data.begin();
+
+			// Parse the reference ADPCM byte, if provided
+			if (byte != data.end() && sb.adpcm.haveref) {
+				sb.adpcm.haveref   = false;
+				sb.adpcm.reference = *byte;
+				sb.adpcm.stepsize  = MinAdaptiveStepSize;
+				++byte;
+			}
+			// Decode the remaining DMA data into samples using the
+			// provided function
+			for (; byte != data.end(); ++byte) {
+				const auto decoded = decode_adpcm_fn(*byte);
+				constexpr auto NumDecoded = check_cast<uint8_t>(
+				        decoded.size());
+
+				enqueue_frames(maybe_silence<FrameType::Mono>(
+				        decoded.data(), NumDecoded));
+				num_samples += NumDecoded;
+			}
+		};
+		const uint32_t num_bytes = read_dma_8bit_spans(bytes_to_read,
+		                                               decode_span);
 		// ADPCM is mono
 		num_frames = check_cast<uint16_t>(num_samples);
 		return {num_bytes, num_samples, num_frames};
@@ -1218,20 +1239,25 @@ static void play_dma_transfer(const uint32_t bytes_requested)
 			}
 
 		} else { // Mono
-			bytes_read = read_dma_8bit(bytes_to_read);
-			samples    = bytes_read;
 			// mono sanity-check
 			assert(channels == 1);
-			if (sb.dma.sign) {
-				const auto signed_buf = reinterpret_cast<int8_t*>(
-				        sb.dma.buf.b8);
-				enqueue_frames(
-				        maybe_silence<FrameType::Mono>(signed_buf,
-				                                       samples));
-			} else {
-				enqueue_frames(maybe_silence<FrameType::Mono>(
-				        sb.dma.buf.b8, samples));
-			}
+
+			// Mono samples are converted straight from guest RAM
+			auto convert_span = [&](const std::span<const uint8_t> data) {
+				const auto num_samples = check_cast<uint32_t>(
+				        data.size());
+				if (sb.dma.sign) {
+					const auto signed_data = reinterpret_cast<const int8_t*>(
+					        data.data());
+					enqueue_frames(maybe_silence<FrameType::Mono>(
+					        signed_data, num_samples));
+				} else {
+					enqueue_frames(maybe_silence<FrameType::Mono>(
+					        data.data(), num_samples));
+				}
+			};
+			bytes_read = read_dma_8bit_spans(bytes_to_read, convert_span);
+			samples    = bytes_read;
 		}
 		break;
 
@@ -3112,12 +3138,22 @@ static uint8_t read_sb(const io_port_t port, const io_width_t)
 		}
 		BufferStatus read_status = {};
 		read_status.has_data     = (sb.dsp.out.used != 0);
+
+		// Data only arrives in response to a command or from an event,
+		// such as the 0xAA that finishes a reset
+		if (!read_status.has_data) {
+			IO_MarkReadAsEventBound();
+		}
 		return read_status.data;
 	}
 
 	case DspAck16Bit: sb.irq.pending_16bit = false; break;
 
 	case DspWriteStatus: {
+		// The DSP only leaves the reset states with an event
+		if (sb.dsp.state != DspState::Normal) {
+			IO_MarkReadAsEventBound();
+		}
 		BufferStatus write_status = {};
 		write_status.has_data     = write_buffer_at_capacity();
 		return write_status.data;
@@ -3867,6 +3903,11 @@ void SBLASTER_Init()
 	MIXER_LockMixerThread();
 	sblaster = std::make_unique<SoundBlaster>(get_section("sblaster"));
 	MIXER_UnlockMixerThread();
+
+	// The DSP and DMA buffers are part of the state
+	HOST_MEMORY_AddSubsystem("Sound Blaster", [] {
+		return sblaster ? sizeof(SoundBlaster) + sizeof(sb) : 0;
+	});
 }
 
 void SBLASTER_Destroy()
@@ -35,11 +35,14 @@ void StereoOn1::ConfigureFilters(const FilterState state)
 	channel->SetLowPassFilter(state);
 }
 
-AudioFrame StereoOn1::Render()
+void StereoOn1::Render(const int num_frames)
 {
+	// Both channels hold their last written samples
 	const float left  = lut_u8to16[stereo_data[0]];
 	const float right = lut_u8to16[stereo_data[1]];
-	return {left, right};
+	render_buffer.insert(render_buffer.end(),
+	                     static_cast<size_t>(num_frames),
+	                     {left, right});
 }
 
 void StereoOn1::WriteData(const io_port_t, const io_val_t data, const io_width_t)
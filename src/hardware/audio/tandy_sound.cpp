@@ -29,7 +29,7 @@
 
 #include <algorithm>
 #include <array>
-#include <queue>
+#include <vector>
 #include <string_view>
 
 #include "audio/channel_names.h"
@@ -66,26 +66,36 @@ private:
 	TandyPSG& operator=(const TandyPSG&) = delete;
 
 	void AudioCallback(const int requested_frames);
-	float RenderSample();
-	void RenderUpToNow();
+	void RenderFrames(const int num_frames);
 	void WriteToPort(io_port_t, io_val_t value, io_width_t);
 
 	// Managed objects
 	MixerChannelPtr channel                     = nullptr;
 	IO_WriteHandleObject write_handlers[2]      = {};
 	std::unique_ptr<sn76496_base_device> device = {};
-	std::queue<float> fifo                      = {};
 	std::mutex mutex                            = {};
 
 	// Static rate-related configuration
 	static constexpr auto RenderDivisor = 16;
 	static constexpr auto RenderRateHz  = ceil_sdivide(TandyPsgClockHz,
                                                           RenderDivisor);
-	static constexpr auto MsPerRender   = MillisInSecond / RenderRateHz;
+
+	// A port write deferred to the mixer thread
+	struct QueuedWrite {
+		double timestamp_ms = 0.0;
+		uint8_t val         = 0;
+	};
+
+	// Written by the main thread, guarded by 'mutex'
+	std::vector<QueuedWrite> pending_writes = {};
+	double block_start_ms                   = 0.0;
+
+	// Only used by the mixer thread
+	std::vector<QueuedWrite> writes = {};
+	std::vector<int16_t> samples    = {};
 
 	// Runtime states
 	device_sound_interface* dsi = nullptr;
-	double last_rendered_ms     = 0.0;
 };
 
 static void setup_filter(MixerChannelPtr& channel, const bool filter_enabled)
@@ -519,76 +529,93 @@ TandyPSG::~TandyPSG()
 	MIXER_UnlockMixerThread();
 }
 
-float TandyPSG::RenderSample()
+// Append mono frames in one run of the device
+void TandyPSG::RenderFrames(const int num_frames)
 {
 	assert(dsi);
 
+	if (num_frames <= 0) {
+		return;
+	}
+
 	static device_sound_interface::sound_stream ss;
 
-	// Request a mono frame from the audio device
-	int16_t sample;
-	int16_t* buf[] = {&sample, nullptr};
+	const auto offset = samples.size();
+	samples.resize(offset + static_cast<size_t>(num_frames));
 
-	dsi->sound_stream_update(ss, nullptr, buf, 1);
+	int16_t* buf[] = {samples.data() + offset, nullptr};
 
-	return static_cast<float>(sample);
+	dsi->sound_stream_update(ss, nullptr, buf, num_frames);
 }
 
-void TandyPSG::RenderUpToNow()
+void TandyPSG::WriteToPort(io_port_t, io_val_t value, io_width_t)
 {
-	const auto now = PIC_FullIndex();
+	std::lock_guard lock(mutex);
 
-	// Wake up the channel and update the last rendered time datum.
+	// The mixer thread renders the audio, we only need to restart the
+	// block timeline after the channel has been asleep
 	assert(channel);
+	const auto now = PIC_FullIndex();
 	if (channel->WakeUp()) {
-		last_rendered_ms = now;
-		return;
-	}
-	// Keep rendering until we're current
-	while (last_rendered_ms < now) {
-		last_rendered_ms += MsPerRender;
-		fifo.emplace(RenderSample());
+		block_start_ms = now;
 	}
+	pending_writes.push_back({now, check_cast<uint8_t>(value)});
 }
 
-void TandyPSG::WriteToPort(io_port_t, io_val_t value, io_width_t)
+// Render a whole block on the mixer thread. The block spans the emulated time
+// since the previous block, and the port writes made in that period are
+// applied right before the first frame at or after their timestamp. The
+// frames between two writes are rendered in one run of the device.
+void TandyPSG::AudioCallback(const int requested_frames)
 {
-	std::lock_guard lock(mutex);
+	assert(channel);
+	assert(requested_frames > 0);
 
-	RenderUpToNow();
+	double start_ms = 0.0;
+	double end_ms   = 0.0;
+	{
+		std::lock_guard lock(mutex);
 
-	const auto data = check_cast<uint8_t>(value);
-	device->write(data);
-}
+		writes.insert(writes.end(), pending_writes.begin(), pending_writes.end());
+		pending_writes.clear();
 
-void TandyPSG::AudioCallback(const int requested_frames)
-{
-	assert(channel);
-	std::lock_guard lock(mutex);
+		start_ms = block_start_ms;
+		end_ms   = PIC_AtomicIndex();
 
-#if 0
-	if (fifo.size()) {
-		LOG_TRACE("%s: Queued %2lu cycle-accurate frames",
-		        ChannelName::TandyPsd,
-		        fifo.size());
+		block_start_ms = std::max(start_ms, end_ms);
 	}
-#endif
 
-	auto frames_remaining = requested_frames;
+	// The emulated time doesn't advance while the emulation is paused
+	const auto span_ms = std::max(end_ms - start_ms, 0.0);
 
-	// First, send any frames we've queued since the last callback
-	while (frames_remaining && fifo.size()) {
-		channel->AddSamples_mfloat(1, &fifo.front());
-		fifo.pop();
-		--frames_remaining;
+	samples.clear();
+
+	size_t next_write = 0;
+	for (int i = 0; i < requested_frames && next_write < writes.size(); ++i) {
+		const auto frame_ms = start_ms + span_ms * i / requested_frames;
+		if (writes[next_write].timestamp_ms > frame_ms) {
+			continue;
+		}
+		RenderFrames(i - static_cast<int>(samples.size()));
+
+		while (next_write < writes.size() &&
+		       writes[next_write].timestamp_ms <= frame_ms) {
+			device->write(writes[next_write++].val);
+		}
 	}
-	// If the queue's run dry, render the remainder and sync-up our time datum
-	while (frames_remaining) {
-		float sample = RenderSample();
-		channel->AddSamples_mfloat(1, &sample);
-		--frames_remaining;
+	RenderFrames(requested_frames - static_cast<int>(samples.size()));
+
+	// Writes made during the last frame take effect in the next block
+	while (next_write < writes.size() && writes[next_write].timestamp_ms < end_ms) {
+		device->write(writes[next_write++].val);
 	}
-	last_rendered_ms = PIC_AtomicIndex();
+
+	// The main thread can be slightly ahead of the atomic time index, so
+	// keep any writes timestamped after this block for the next one
+	writes.erase(writes.begin(),
+	             writes.begin() + static_cast<std::ptrdiff_t>(next_write));
+
+	channel->AddSamples_m16(requested_frames, samples.data());
 }
 
 // The Tandy DAC and PSG (programmable sound generator) managed pointers
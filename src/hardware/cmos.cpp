@@ -8,6 +8,7 @@
 #include <ctime>
 #include <memory>
 
+#include "hardware/input/input_replay.h"
 #include "hardware/memory.h"
 #include "hardware/pic.h"
 #include "hardware/port.h"
@@ -123,7 +124,7 @@ static uint8_t cmos_readreg(io_port_t, io_width_t)
 	Bitu drive_a, drive_b;
 	uint8_t hdparm;
 
-	const time_t curtime = time(nullptr);
+	const time_t curtime = REPLAY_GetHostTimeMs() / 1000;
 	struct tm datetime;
 	cross::localtime_r(&curtime, &datetime);
 
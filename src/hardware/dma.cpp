@@ -5,8 +5,10 @@
 #include "dma.h"
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <memory>
+#include <optional>
 
 #include "config/setup.h"
 #include "cpu/paging.h"
@@ -14,6 +16,7 @@
 #include "hardware/memory.h"
 #include "hardware/pic.h"
 #include "hardware/port.h"
+#include "hardware/snapshot.h"
 
 std::unique_ptr<DmaController> primary   = {};
 std::unique_ptr<DmaController> secondary = {};
@@ -38,11 +41,14 @@ static void UpdateEMSMapping()
 	}
 }
 
-// Generic function to read or write a block of data to or from memory.
-// Don't use this directly; call two helpers: DMA_BlockRead or DMA_BlockWrite
-static void perform_dma_io(const DmaDirection direction, const PhysPt spage,
-                           PhysPt mem_address, void* const data_start,
-                           const size_t num_words, const uint8_t is_dma16)
+// Calls 'transfer' with the host memory of each contiguous chunk of a DMA
+// block. The block is split at the 4 KB page boundaries so each page can be
+// mapped through the first-MB paging and EMS board tables; neighbouring pages
+// that stay adjacent in host memory are passed on as a single chunk.
+template <typename Func>
+static void for_each_dma_chunk(const PhysPt spage, PhysPt mem_address,
+                               const size_t num_words, const uint8_t is_dma16,
+                               Func transfer)
 {
 	assert(is_dma16 == 0 || is_dma16 == 1);
 
@@ -51,12 +57,13 @@ static void perform_dma_io(const DmaDirection direction, const PhysPt spage,
 	// Maybe move the mem_address into the 16-bit range
 	mem_address <<= is_dma16;
 
-	// The data pointer will be incremented per transfer
-	auto data_pt = reinterpret_cast<uint8_t*>(data_start);
+	// Convert from DMA 'words' to actual bytes
+	auto remaining_bytes = num_words << is_dma16;
+
+	HostPt pending_chunk = nullptr;
+	size_t pending_bytes = 0;
 
-	// Convert from DMA 'words' to actual bytes, no greater than 64 KB
-	auto remaining_bytes = check_cast<uint16_t>(num_words << is_dma16);
-	do {
+	while (remaining_bytes) {
 		// Find the right EMS page that contains the current address
 		auto page = highpart_addr_page + (mem_address >> 12);
 		if (page < EMM_PAGEFRAME4K) {
@@ -69,32 +76,54 @@ static void perform_dma_io(const DmaDirection direction, const PhysPt spage,
 
 		// Calculate the offset within the page
 		const auto pos_in_page = mem_address & (DosPageSize - 1);
-		const auto bytes_to_page_end = check_cast<uint16_t>(DosPageSize -
-		                                                    pos_in_page);
+		const size_t bytes_to_page_end = DosPageSize - pos_in_page;
 		const auto chunk_start = check_cast<PhysPt>(page * DosPageSize +
 		                                            pos_in_page);
 
 		// Determine how many bytes to transfer within this page
 		const auto chunk_bytes = std::min(remaining_bytes, bytes_to_page_end);
 
-		// Copy the data from the page address into the data pointer
-		if (direction == DmaDirection::Read) {
-			for (auto i = 0; i < chunk_bytes; ++i) {
-				data_pt[i] = phys_readb(chunk_start + i);
+		const auto chunk = MemBase + chunk_start;
+		if (pending_chunk && pending_chunk + pending_bytes == chunk) {
+			pending_bytes += chunk_bytes;
+		} else {
+			if (pending_chunk) {
+				transfer(pending_chunk, pending_bytes);
 			}
+			pending_chunk = chunk;
+			pending_bytes = chunk_bytes;
 		}
 
+		mem_address += check_cast<PhysPt>(chunk_bytes);
+		remaining_bytes -= chunk_bytes;
+	}
+	if (pending_chunk) {
+		transfer(pending_chunk, pending_bytes);
+	}
+}
+
+// Generic function to read or write a block of data to or from memory.
+// Don't use this directly; call two helpers: DMA_BlockRead or DMA_BlockWrite
+static void perform_dma_io(const DmaDirection direction, const PhysPt spage,
+                           const PhysPt mem_address, void* const data_start,
+                           const size_t num_words, const uint8_t is_dma16)
+{
+	// The data pointer will be incremented per transfer
+	auto data_pt = reinterpret_cast<uint8_t*>(data_start);
+
+	auto copy_chunk = [&](const HostPt chunk, const size_t num_bytes) {
+		// Copy the data from the page address into the data pointer
+		if (direction == DmaDirection::Read) {
+			std::memcpy(data_pt, chunk, num_bytes);
+		}
 		// Copy the data from the data pointer into the page address
 		else if (direction == DmaDirection::Write) {
-			for (auto i = 0; i < chunk_bytes; ++i) {
-				phys_writeb(chunk_start + i, data_pt[i]);
-			}
+			mark_phys_dirty(static_cast<PhysPt>(chunk - MemBase), num_bytes);
+			std::memcpy(chunk, data_pt, num_bytes);
 		}
-
-		mem_address += chunk_bytes;
-		data_pt += chunk_bytes;
-		remaining_bytes -= chunk_bytes;
-	} while (remaining_bytes);
+		data_pt += num_bytes;
+	};
+	for_each_dma_chunk(spage, mem_address, num_words, is_dma16, copy_chunk);
 }
 
 static bool activate_primary()
@@ -404,35 +433,24 @@ void DmaChannel::ClearRequest()
 	has_raised_request = false;
 }
 
-size_t DmaChannel::Read(const size_t words, uint8_t* const dest_buffer)
-{
-	return ReadOrWrite(DmaDirection::Read, words, dest_buffer);
-}
-
-size_t DmaChannel::Write(const size_t words, uint8_t* const src_buffer)
-{
-	return ReadOrWrite(DmaDirection::Write, words, src_buffer);
-}
-
-size_t DmaChannel::ReadOrWrite(const DmaDirection direction, const size_t words,
-                               uint8_t* const buffer)
+// Moves the channel through up to 'words' words, calling 'transfer_block'
+// with the address and length of each run up to the terminal count
+template <typename Func>
+size_t DmaChannel::Transfer(const size_t words, Func transfer_block)
 {
 	auto want     = check_cast<uint16_t>(words);
 	uint16_t done = 0;
 	curr_addr &= dma_wrapping;
 
-	// incremented per transfer
-	auto curr_buffer = buffer;
 again:
 	Bitu left = (curr_count + 1);
 	if (want < left) {
-		perform_dma_io(direction, page_base, curr_addr, curr_buffer, want, is_16bit);
+		transfer_block(curr_addr, want);
 		done += want;
 		curr_addr += want;
 		curr_count -= want;
 	} else {
-		perform_dma_io(direction, page_base, curr_addr, curr_buffer, left, is_16bit);
-		curr_buffer += left << is_16bit;
+		transfer_block(curr_addr, left);
 		want -= left;
 		done += left;
 		ReachedTerminalCount();
@@ -454,6 +472,38 @@ again:
 	return done;
 }
 
+size_t DmaChannel::Read(const size_t words, uint8_t* const dest_buffer)
+{
+	return ReadOrWrite(DmaDirection::Read, words, dest_buffer);
+}
+
+size_t DmaChannel::Write(const size_t words, uint8_t* const src_buffer)
+{
+	return ReadOrWrite(DmaDirection::Write, words, src_buffer);
+}
+
+size_t DmaChannel::ReadSpans(const size_t words, const DMA_SpanCallback& consume)
+{
+	auto pass_chunk = [&](const HostPt chunk, const size_t num_bytes) {
+		consume(std::span<const uint8_t>(chunk, num_bytes));
+	};
+	return Transfer(words, [&](const PhysPt addr, const size_t num_words) {
+		for_each_dma_chunk(page_base, addr, num_words, is_16bit, pass_chunk);
+	});
+}
+
+size_t DmaChannel::ReadOrWrite(const DmaDirection direction, const size_t words,
+                               uint8_t* const buffer)
+{
+	// incremented per transfer
+	auto curr_buffer = buffer;
+
+	return Transfer(words, [&](const PhysPt addr, const size_t num_words) {
+		perform_dma_io(direction, page_base, addr, curr_buffer, num_words, is_16bit);
+		curr_buffer += num_words << is_16bit;
+	});
+}
+
 bool DmaChannel::HasReservation() const
 {
 	return (evict_callback && !reservation_owner_name.empty());
@@ -641,6 +691,59 @@ void DMA_Destroy()
 	secondary = {};
 }
 
+// The registers of a channel; the callbacks and reservations belong to the
+// devices and stay as they are
+struct DmaChannelState {
+	uint32_t page_base              = 0;
+	uint32_t curr_addr              = 0;
+	uint16_t base_addr              = 0;
+	uint16_t base_count             = 0;
+	uint16_t curr_count             = 0;
+	uint8_t page_num                = 0;
+	bool is_incremented             = true;
+	bool is_autoiniting             = false;
+	bool is_masked                  = true;
+	bool has_reached_terminal_count = false;
+	bool has_raised_request         = false;
+};
+
+static DmaChannelState save_channel_state(const DmaChannel& c)
+{
+	return {c.page_base,
+	        c.curr_addr,
+	        c.base_addr,
+	        c.base_count,
+	        c.curr_count,
+	        c.page_num,
+	        c.is_incremented,
+	        c.is_autoiniting,
+	        c.is_masked,
+	        c.has_reached_terminal_count,
+	        c.has_raised_request};
+}
+
+static void restore_channel_state(DmaChannel& c, const DmaChannelState& s)
+{
+	c.page_base                  = s.page_base;
+	c.curr_addr                  = s.curr_addr;
+	c.base_addr                  = s.base_addr;
+	c.base_count                 = s.base_count;
+	c.curr_count                 = s.curr_count;
+	c.page_num                   = s.page_num;
+	c.is_incremented             = s.is_incremented;
+	c.is_autoiniting             = s.is_autoiniting;
+	c.is_masked                  = s.is_masked;
+	c.has_reached_terminal_count = s.has_reached_terminal_count;
+	c.has_raised_request         = s.has_raised_request;
+}
+
+// Unlike DMA_GetChannel(), doesn't activate the controller
+static DmaChannel* get_active_channel(const uint8_t channel_num)
+{
+	const auto& controller = is_primary(channel_num) ? primary : secondary;
+	return controller ? controller->GetChannel(channel_num % 4) : nullptr;
+}
+
 void DMA_Init()
 {
 	DMA_SetWrapping(0xffff);
@@ -649,4 +752,26 @@ void DMA_Init()
 	for (i = 0; i < LINK_START; i++) {
 		ems_board_mapping[i] = i;
 	}
+
+	// Only the channels of the controllers that are active at both the
+	// time of the snapshot and of the restore are restored
+	SNAPSHOT_AddComponent("dma", [] {
+		std::array<std::optional<DmaChannelState>, 8> channels = {};
+		for (uint8_t i = 0; i < channels.size(); ++i) {
+			if (const auto c = get_active_channel(i); c) {
+				channels[i] = save_channel_state(*c);
+			}
+		}
+		const auto wrapping = dma_wrapping;
+
+		return [=] {
+			for (uint8_t i = 0; i < channels.size(); ++i) {
+				const auto c = get_active_channel(i);
+				if (c && channels[i]) {
+					restore_channel_state(*c, *channels[i]);
+				}
+			}
+			dma_wrapping = wrapping;
+		};
+	});
 }
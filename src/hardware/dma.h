@@ -9,6 +9,7 @@
 
 #include <cassert>
 #include <functional>
+#include <span>
 
 #include "config/setup.h"
 #include "hardware/port.h"
@@ -30,6 +31,10 @@ using DMA_EvictCallback = std::function<void(Section*)>;
 class DmaChannel;
 using DMA_Callback = std::function<void(const DmaChannel* chan, DmaEvent event)>;
 
+// Receives a run of guest RAM that's contiguous in host memory. The memory
+// is only valid for the duration of the call.
+using DMA_SpanCallback = std::function<void(std::span<const uint8_t> data)>;
+
 class DmaChannel {
 public:
 	// Defaults at the time of initialization
@@ -64,6 +69,14 @@ public:
 	void ClearRequest();
 	size_t Read(size_t words, uint8_t* const dest_buffer);
 	size_t Write(size_t words, uint8_t* const src_buffer);
+
+	// Reads up to 'words' words without copying them. The data is passed
+	// to 'consume' as one or more spans of guest RAM, split where the
+	// transfer crosses a non-contiguous page or wraps around at the
+	// terminal count, in the order they're transferred. Returns the
+	// number of words read.
+	size_t ReadSpans(size_t words, const DMA_SpanCallback& consume);
+
 	void LogDetails() const;
 
 	// Reset the channel back to defaults, without callbacks or reservations.
@@ -88,6 +101,9 @@ private:
 	size_t ReadOrWrite(DmaDirection direction, size_t words,
 	                   uint8_t* const buffer);
 
+	template <typename Func>
+	size_t Transfer(size_t words, Func transfer_block);
+
 	DMA_EvictCallback evict_callback   = {};
 	std::string reservation_owner_name = {};
 };
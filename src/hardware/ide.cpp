@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <cassert>
 
 #include "audio/mixer.h"
@@ -28,6 +29,10 @@ static void ide_altio_w(io_port_t port, io_val_t val, io_width_t width);
 static uint32_t ide_altio_r(io_port_t port, io_width_t width);
 static void ide_baseio_w(io_port_t port, io_val_t val, io_width_t width);
 static uint32_t ide_baseio_r(io_port_t port, io_width_t width);
+static uint32_t ide_data_read_block(io_port_t port, io_width_t width,
+                                   uint8_t* data, uint32_t count);
+static uint32_t ide_data_write_block(io_port_t port, io_width_t width,
+                                     const uint8_t* data, uint32_t count);
 bool GetMSCDEXDrive(uint8_t drive_letter, CDROM_Interface **_cdrom);
 
 enum IDEDeviceType { IDE_TYPE_NONE, IDE_TYPE_HDD = 1, IDE_TYPE_CDROM };
@@ -143,6 +148,9 @@ public:
 	virtual void writecommand(uint8_t cmd);
 	virtual uint32_t data_read(io_width_t width);          /* read from 1F0h data port from IDE device */
 	virtual void data_write(uint32_t v, io_width_t width); /* write to 1F0h data port to IDE device */
+	/* REP INS/OUTS on the data port; return the number of elements moved */
+	virtual uint32_t data_read_block(io_width_t width, uint8_t* data, uint32_t count);
+	virtual uint32_t data_write_block(io_width_t width, const uint8_t* data, uint32_t count);
 	virtual bool command_interruption_ok(uint8_t cmd);
 	virtual void abort_silent();
 };
@@ -169,6 +177,8 @@ public:
 	uint32_t data_read(io_width_t width) override;
 	/* write to 1F0h data port to IDE device */
 	void data_write(uint32_t v, io_width_t width) override;
+	uint32_t data_read_block(io_width_t width, uint8_t* data, uint32_t count) override;
+	uint32_t data_write_block(io_width_t width, const uint8_t* data, uint32_t count) override;
 	virtual void generate_identify_device();
 	virtual void prepare_read(uint32_t offset, uint32_t size);
 	virtual void prepare_write(uint32_t offset, uint32_t size);
@@ -227,6 +237,7 @@ public:
 	uint32_t data_read(io_width_t width) override;
 	/* write to 1F0h data port to IDE device */
 	void data_write(uint32_t v, io_width_t width) override;
+	uint32_t data_read_block(io_width_t width, uint8_t* data, uint32_t count) override;
 	virtual void generate_identify_device();
 	virtual void generate_mmc_inquiry();
 	virtual void prepare_read(uint32_t offset, uint32_t size);
@@ -1543,6 +1554,36 @@ uint32_t IDEATAPICDROMDevice::data_read(io_width_t width)
 	return w;
 }
 
+/* Number of whole elements of a REP INS/OUTS that fit in what's left of the
+ * sector buffer; a partial one at the end is left to data_read/data_write */
+static uint32_t sector_block_count(const uint32_t sector_i, const uint32_t sector_total,
+                                   const io_width_t width, const uint32_t count)
+{
+	if (sector_i >= sector_total)
+		return 0;
+
+	return std::min(count, (sector_total - sector_i) / static_cast<uint32_t>(width));
+}
+
+uint32_t IDEATAPICDROMDevice::data_read_block(io_width_t width, uint8_t* data, uint32_t count)
+{
+	if (state != IDE_DEV_DATA_READ || !(status & IDE_STATUS_DRQ))
+		return 0;
+
+	const auto n = sector_block_count(sector_i, sector_total, width, count);
+	if (n == 0)
+		return 0;
+
+	const auto num_bytes = n * static_cast<uint32_t>(width);
+	memcpy(data, sector + sector_i, num_bytes);
+	sector_i += num_bytes;
+
+	if (sector_i >= sector_total)
+		io_completion();
+
+	return n;
+}
+
 /* TBD: Your code should also be paying attention to the "transfer length" field
          in many of the commands here. Right now it doesn't matter. */
 void IDEATAPICDROMDevice::atapi_cmd_completion()
@@ -1857,6 +1898,44 @@ uint32_t IDEATADevice::data_read(io_width_t width)
 	return w;
 }
 
+uint32_t IDEATADevice::data_read_block(io_width_t width, uint8_t* data, uint32_t count)
+{
+	if (state != IDE_DEV_DATA_READ || !(status & IDE_STATUS_DRQ))
+		return 0;
+
+	const auto n = sector_block_count(sector_i, sector_total, width, count);
+	if (n == 0)
+		return 0;
+
+	const auto num_bytes = n * static_cast<uint32_t>(width);
+	memcpy(data, sector + sector_i, num_bytes);
+	sector_i += num_bytes;
+
+	if (sector_i >= sector_total)
+		io_completion();
+
+	return n;
+}
+
+uint32_t IDEATADevice::data_write_block(io_width_t width, const uint8_t* data, uint32_t count)
+{
+	if (state != IDE_DEV_DATA_WRITE || !(status & IDE_STATUS_DRQ))
+		return 0;
+
+	const auto n = sector_block_count(sector_i, sector_total, width, count);
+	if (n == 0)
+		return 0;
+
+	const auto num_bytes = n * static_cast<uint32_t>(width);
+	memcpy(sector + sector_i, data, num_bytes);
+	sector_i += num_bytes;
+
+	if (sector_i >= sector_total)
+		io_completion();
+
+	return n;
+}
+
 void IDEATADevice::data_write(uint32_t v, io_width_t width)
 {
 	if (state != IDE_DEV_DATA_WRITE) {
@@ -3184,15 +3263,13 @@ static void IDE_DelayedCommand(uint32_t idx /*which IDE controller*/)
 			if ((512 * ata->multiple_sector_count) > sizeof(ata->sector))
 				E_Exit("SECTOR OVERFLOW");
 
-			for (uint32_t cc = 0; cc < std::min(ata->multiple_sector_count, sectcount); cc++) {
-				/* it would be great if the disk object had a "read
-				 * multiple sectors" member function */
-				if (disk->Read_AbsoluteSector(sectorn + cc, ata->sector + (cc * 512)) != 0) {
-					LOG_WARNING("IDE: ATA read failed");
-					ata->abort_error();
-					dev->controller->raise_irq();
-					return;
-				}
+			if (disk->Read_AbsoluteSectors(sectorn,
+			                               std::min(ata->multiple_sector_count, sectcount),
+			                               ata->sector) != 0) {
+				LOG_WARNING("IDE: ATA read failed");
+				ata->abort_error();
+				dev->controller->raise_irq();
+				return;
 			}
 
 			/* NTS: the way this command works is that the drive reads ONE sector, then fires the IRQ
@@ -3247,15 +3324,13 @@ static void IDE_DelayedCommand(uint32_t idx /*which IDE controller*/)
 				          ((uint32_t)ata->lba[0] - 1);
 			}
 
-			for (uint32_t cc = 0; cc < std::min(ata->multiple_sector_count, sectcount); cc++) {
-				/* it would be great if the disk object had a "write
-				 * multiple sectors" member function */
-				if (disk->Write_AbsoluteSector(sectorn + cc, ata->sector + (cc * 512)) != 0) {
-					LOG_WARNING("IDE: Failed to write sector");
-					ata->abort_error();
-					dev->controller->raise_irq();
-					return;
-				}
+			if (disk->Write_AbsoluteSectors(sectorn,
+			                                std::min(ata->multiple_sector_count, sectcount),
+			                                ata->sector) != 0) {
+				LOG_WARNING("IDE: Failed to write sector");
+				ata->abort_error();
+				dev->controller->raise_irq();
+				return;
 			}
 
 			for (uint32_t cc = 0; cc < std::min(ata->multiple_sector_count, sectcount); cc++) {
@@ -3389,6 +3464,16 @@ uint32_t IDEDevice::data_read(io_width_t)
 void IDEDevice::data_write(io_val_t, io_width_t)
 {}
 
+uint32_t IDEDevice::data_read_block(io_width_t, uint8_t*, uint32_t)
+{
+	return 0;
+}
+
+uint32_t IDEDevice::data_write_block(io_width_t, const uint8_t*, uint32_t)
+{
+	return 0;
+}
+
 /* IDE controller -> upon writing bit 2 of alt (0x3F6) */
 void IDEDevice::host_reset_complete()
 {
@@ -3810,6 +3895,8 @@ void IDEController::install_io_ports()
 			WriteHandler[i].Install(base_io + i, ide_baseio_w, io_width_t::dword);
 			ReadHandler[i].Install(base_io + i, ide_baseio_r, io_width_t::dword);
 		}
+		IO_RegisterBlockReadHandler(base_io, ide_data_read_block);
+		IO_RegisterBlockWriteHandler(base_io, ide_data_write_block);
 	}
 
 	if (alt_io != 0) {
@@ -3829,6 +3916,8 @@ void IDEController::uninstall_io_ports()
 		h.Uninstall();
 	for (auto & h : ReadHandler)
 		h.Uninstall();
+	IO_FreeBlockReadHandler(base_io);
+	IO_FreeBlockWriteHandler(base_io);
 
 	// Uninstall the two sets of alternate I/O ports
 	assert(alt_io != 0);
@@ -3966,6 +4055,40 @@ static uint32_t ide_baseio_r(io_port_t port, io_width_t width)
 	return ret;
 }
 
+/* REP INSW/INSD on the data port, served straight from the sector buffer.
+ * Returning 0 leaves the transfer to ide_baseio_r, one element at a time. */
+static uint32_t ide_data_read_block(io_port_t port, io_width_t width, uint8_t* data, uint32_t count)
+{
+	IDEController *ide = match_ide_controller(port);
+	if (ide == nullptr)
+		return 0;
+
+	/* 32-bit PIO split into two words, or ignored */
+	if (width == io_width_t::dword && (!ide->enable_pio32 || ide->ignore_pio32))
+		return 0;
+
+	IDEDevice *dev = ide->device[ide->select];
+	return (dev != nullptr) ? dev->data_read_block(width, data, count) : 0;
+}
+
+static uint32_t ide_data_write_block(io_port_t port, io_width_t width, const uint8_t* data,
+                                     uint32_t count)
+{
+	IDEController *ide = match_ide_controller(port);
+	if (ide == nullptr)
+		return 0;
+
+	if (width == io_width_t::dword && (!ide->enable_pio32 || ide->ignore_pio32))
+		return 0;
+
+	/* writes are dropped while busy, which ide_baseio_w takes care of */
+	IDEDevice *dev = ide->device[ide->select];
+	if (dev == nullptr || (dev->status & IDE_STATUS_BUSY))
+		return 0;
+
+	return dev->data_write_block(width, data, count);
+}
+
 static void ide_baseio_w(io_port_t port, io_val_t val, io_width_t width)
 {
 	IDEController *ide = match_ide_controller(port);
@@ -0,0 +1,403 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "input_replay.h"
+
+#include <cassert>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include "hardware/input/joystick.h"
+#include "hardware/input/keyboard.h"
+#include "hardware/input/mouse.h"
+#include "hardware/pic.h"
+#include "misc/logging.h"
+#include "utils/checks.h"
+#include "utils/string_utils.h"
+
+CHECK_NARROWING();
+
+constexpr auto RecordingHeader = "# DOSBox Staging input recording, version 1";
+
+constexpr std::array<const char*, 7> EventTypeNames = {"key",
+                                                       "mouse_moved",
+                                                       "mouse_button",
+                                                       "mouse_wheel",
+                                                       "joystick_button",
+                                                       "joystick_x",
+                                                       "joystick_y"};
+
+enum class HostValueType : uint8_t { Time, RandomSeed };
+
+constexpr std::array<const char*, 2> HostValueTypeNames = {"host_time",
+                                                           "random_seed"};
+
+// Only the values that differ from the previous one of the same type are
+// recorded, keyed by the number of earlier reads of that type
+struct HostValue {
+	uint64_t read_count = 0;
+	int64_t value       = 0;
+};
+
+struct HostValues {
+	uint64_t num_reads = 0;
+
+	// While recording
+	std::optional<int64_t> last_value = {};
+
+	// While replaying, and the index of the next one to take effect
+	std::vector<HostValue> recorded = {};
+	size_t next_index               = 0;
+};
+
+enum class ReplayMode : uint8_t { Off, Recording, Playing };
+
+static struct {
+	ReplayMode mode = ReplayMode::Off;
+
+	bool is_handling_host_events = false;
+	bool is_injecting            = false;
+
+	// Recording
+	FILE* file = nullptr;
+
+	// Playback
+	std::vector<ReplayEntry> entries = {};
+	size_t next_entry_index          = 0;
+	bool has_diverged                = false;
+
+	std::array<HostValues, HostValueTypeNames.size()> host_values = {};
+} replay = {};
+
+template <typename T>
+static std::optional<T> parse_number(const std::string& s)
+{
+	T value = {};
+
+	const auto end = s.data() + s.size();
+
+	const auto [ptr, ec] = std::from_chars(s.data(), end, value);
+	if (ec != std::errc() || ptr != end) {
+		return {};
+	}
+	return value;
+}
+
+template <size_t N>
+static std::optional<size_t> find_name(const std::array<const char*, N>& names,
+                                       const std::string_view name)
+{
+	for (size_t i = 0; i < N; ++i) {
+		if (name == names[i]) {
+			return i;
+		}
+	}
+	return {};
+}
+
+std::string REPLAY_FormatEntry(const ReplayEntry& entry)
+{
+	const auto& event = entry.event;
+
+	// Nine significant digits restore every float exactly
+	return format_str("%llu %s %d %d %.9g %.9g %.9g %.9g",
+	                  static_cast<unsigned long long>(entry.tick),
+	                  EventTypeNames[static_cast<size_t>(event.type)],
+	                  event.device,
+	                  event.id,
+	                  static_cast<double>(event.values[0]),
+	                  static_cast<double>(event.values[1]),
+	                  static_cast<double>(event.values[2]),
+	                  static_cast<double>(event.values[3]));
+}
+
+// Rejects the events the input devices would assert on
+static bool is_valid(const ReplayEvent& event)
+{
+	switch (event.type) {
+	case ReplayEventType::Key:
+		return event.id >= 0 && event.id < KBD_LAST;
+
+	case ReplayEventType::MouseButton:
+		return event.id >= static_cast<int>(MouseButtonId::First) &&
+		       event.id <= static_cast<int>(MouseButtonId::Last);
+
+	case ReplayEventType::JoystickButton:
+		return (event.device == 0 || event.device == 1) &&
+		       (event.id == 0 || event.id == 1);
+
+	case ReplayEventType::JoystickAxisX:
+	case ReplayEventType::JoystickAxisY:
+		return event.device == 0 || event.device == 1;
+
+	case ReplayEventType::MouseMoved:
+	case ReplayEventType::MouseWheel: return true;
+	}
+	return false;
+}
+
+std::optional<ReplayEntry> REPLAY_ParseEntry(const std::string_view line)
+{
+	const auto tokens = split(line);
+	if (tokens.size() != 8) {
+		return {};
+	}
+
+	const auto tick   = parse_number<uint64_t>(tokens[0]);
+	const auto type   = find_name(EventTypeNames, tokens[1]);
+	const auto device = parse_number<int>(tokens[2]);
+	const auto id     = parse_number<int>(tokens[3]);
+	if (!tick || !type || !device || !id) {
+		return {};
+	}
+
+	ReplayEntry entry  = {};
+	entry.tick         = *tick;
+	entry.event.type   = static_cast<ReplayEventType>(*type);
+	entry.event.device = *device;
+	entry.event.id     = *id;
+
+	for (size_t i = 0; i < entry.event.values.size(); ++i) {
+		const auto value = parse_float(tokens[4 + i]);
+		if (!value) {
+			return {};
+		}
+		entry.event.values[i] = *value;
+	}
+
+	if (!is_valid(entry.event)) {
+		return {};
+	}
+	return entry;
+}
+
+static bool parse_host_value(const std::string_view line)
+{
+	const auto tokens = split(line);
+	if (tokens.size() != 3) {
+		return false;
+	}
+
+	const auto type       = find_name(HostValueTypeNames, tokens[0]);
+	const auto read_count = parse_number<uint64_t>(tokens[1]);
+	const auto value      = parse_number<int64_t>(tokens[2]);
+	if (!type || !read_count || !value) {
+		return false;
+	}
+
+	replay.host_values[*type].recorded.push_back({*read_count, *value});
+	return true;
+}
+
+void REPLAY_StartRecording(const std::string& path)
+{
+	REPLAY_Stop();
+
+	replay.file = fopen(path.c_str(), "w");
+	if (!replay.file) {
+		LOG_WARNING("REPLAY: Can't create the input recording '%s'", path.c_str());
+		return;
+	}
+	fprintf(replay.file, "%s\n", RecordingHeader);
+
+	replay.mode = ReplayMode::Recording;
+	LOG_MSG("REPLAY: Recording the input to '%s'", path.c_str());
+}
+
+void REPLAY_StartPlayback(const std::string& path)
+{
+	REPLAY_Stop();
+
+	std::ifstream file(path);
+	if (!file) {
+		LOG_WARNING("REPLAY: Can't open the input recording '%s'", path.c_str());
+		return;
+	}
+
+	std::string line = {};
+	if (!std::getline(file, line) || line != RecordingHeader) {
+		LOG_WARNING("REPLAY: '%s' is not an input recording", path.c_str());
+		return;
+	}
+
+	for (auto line_number = 2; std::getline(file, line); ++line_number) {
+		if (const auto entry = REPLAY_ParseEntry(line); entry) {
+			replay.entries.push_back(*entry);
+		} else if (!parse_host_value(line)) {
+			LOG_WARNING("REPLAY: Skipping invalid line %d of '%s'",
+			            line_number,
+			            path.c_str());
+		}
+	}
+
+	replay.mode = ReplayMode::Playing;
+	LOG_MSG("REPLAY: Replaying %d input events from '%s'",
+	        check_cast<int>(replay.entries.size()),
+	        path.c_str());
+}
+
+void REPLAY_Stop()
+{
+	if (replay.file) {
+		fclose(replay.file);
+	}
+	replay = {};
+}
+
+bool REPLAY_IsPlaying()
+{
+	return replay.mode == ReplayMode::Playing;
+}
+
+void REPLAY_BeginHostEvents()
+{
+	replay.is_handling_host_events = true;
+}
+
+void REPLAY_EndHostEvents()
+{
+	replay.is_handling_host_events = false;
+}
+
+bool REPLAY_AcceptEvent(const ReplayEvent& event)
+{
+	if (replay.mode == ReplayMode::Off || !replay.is_handling_host_events ||
+	    replay.is_injecting) {
+		return true;
+	}
+	if (replay.mode == ReplayMode::Playing) {
+		return false;
+	}
+
+	assert(replay.file);
+	fprintf(replay.file,
+	        "%s\n",
+	        REPLAY_FormatEntry({PIC_Ticks, event}).c_str());
+	return true;
+}
+
+static void inject(const ReplayEvent& event)
+{
+	const auto& v = event.values;
+
+	const auto is_pressed = (v[0] != 0.0f);
+
+	switch (event.type) {
+	case ReplayEventType::Key:
+		KEYBOARD_AddKey(static_cast<KBD_KEYS>(event.id), is_pressed);
+		break;
+	case ReplayEventType::MouseMoved:
+		MOUSE_EventMoved(v[0], v[1], v[2], v[3]);
+		break;
+	case ReplayEventType::MouseButton:
+		MOUSE_EventButton(static_cast<MouseButtonId>(event.id), is_pressed);
+		break;
+	case ReplayEventType::MouseWheel: MOUSE_EventWheel(v[0]); break;
+	case ReplayEventType::JoystickButton:
+		JOYSTICK_Button(check_cast<uint8_t>(event.device), event.id, is_pressed);
+		break;
+	case ReplayEventType::JoystickAxisX:
+		JOYSTICK_Move_X(check_cast<uint8_t>(event.device),
+		                static_cast<int16_t>(v[0]));
+		break;
+	case ReplayEventType::JoystickAxisY:
+		JOYSTICK_Move_Y(check_cast<uint8_t>(event.device),
+		                static_cast<int16_t>(v[0]));
+		break;
+	}
+}
+
+void REPLAY_InjectEvents()
+{
+	if (replay.mode != ReplayMode::Playing ||
+	    replay.next_entry_index == replay.entries.size()) {
+		return;
+	}
+
+	const auto first_index = replay.next_entry_index;
+
+	replay.is_injecting = true;
+
+	while (replay.next_entry_index < replay.entries.size()) {
+		const auto& entry = replay.entries[replay.next_entry_index];
+		if (entry.tick > PIC_Ticks) {
+			break;
+		}
+		inject(entry.event);
+		++replay.next_entry_index;
+	}
+
+	// The host event handling flushes the merged motion the same way
+	if (replay.next_entry_index != first_index) {
+		MOUSE_FlushMotion();
+	}
+
+	replay.is_injecting = false;
+
+	if (replay.next_entry_index == replay.entries.size()) {
+		LOG_MSG("REPLAY: All recorded input events have been replayed");
+	}
+}
+
+static int64_t read_host_value(const HostValueType type, const int64_t host_value)
+{
+	auto& values = replay.host_values[static_cast<size_t>(type)];
+
+	const auto read_count = values.num_reads++;
+
+	switch (replay.mode) {
+	case ReplayMode::Off: return host_value;
+
+	case ReplayMode::Recording:
+		if (values.last_value != host_value) {
+			values.last_value = host_value;
+
+			fprintf(replay.file,
+			        "%s %llu %lld\n",
+			        HostValueTypeNames[static_cast<size_t>(type)],
+			        static_cast<unsigned long long>(read_count),
+			        static_cast<long long>(host_value));
+		}
+		return host_value;
+
+	case ReplayMode::Playing: {
+		auto& index = values.next_index;
+		while (index < values.recorded.size() &&
+		       values.recorded[index].read_count <= read_count) {
+			++index;
+		}
+		if (index > 0) {
+			return values.recorded[index - 1].value;
+		}
+		// No value of this type was recorded
+		if (!replay.has_diverged) {
+			LOG_WARNING("REPLAY: The emulation has diverged from the recording");
+			replay.has_diverged = true;
+		}
+		return host_value;
+	}
+	}
+	return host_value;
+}
+
+int64_t REPLAY_GetHostTimeMs()
+{
+	using namespace std::chrono;
+
+	const auto now_ms = duration_cast<milliseconds>(
+	                            system_clock::now().time_since_epoch())
+	                            .count();
+
+	return read_host_value(HostValueType::Time, now_ms);
+}
+
+uint32_t REPLAY_GetRandomSeed()
+{
+	const auto seed = std::random_device{}();
+
+	return static_cast<uint32_t>(read_host_value(HostValueType::RandomSeed, seed));
+}
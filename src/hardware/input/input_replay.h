@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_INPUT_REPLAY_H
+#define DOSBOX_INPUT_REPLAY_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Records the host input reaching the emulation, and replays it at the same
+// emulated times, so interactive workloads can be run reproducibly (e.g.,
+// in benchmark mode, to compare builds).
+//
+// See the '--record-input' and '--replay-input' command line arguments.
+//
+// The keyboard, mouse and joystick events handled while the host events are
+// polled are recorded with the emulated tick they arrived in. Host events
+// are polled between the ticks only, so replaying the events right after
+// the same tick delivers them at the same point of the guest's execution.
+// Events the emulation generates itself (e.g., AUTOTYPE) are not recorded,
+// as they happen again on replay. While replaying, the host input is
+// ignored.
+//
+// The host values the guest can observe (the wall clock and random seeds)
+// are recorded as well and returned in the same order on replay.
+//
+// The recording is a text file, one entry per line:
+//
+//   <tick> <event type> <device> <id> <value 1> <value 2> <value 3> <value 4>
+//   <host value type> <read count> <value>
+//
+// A replay only stays in sync with the recording if the emulated machine
+// is set up the same way, including the cycles setting, and the guest is
+// deterministic otherwise.
+
+enum class ReplayEventType : uint8_t {
+	Key,
+	MouseMoved,
+	MouseButton,
+	MouseWheel,
+	JoystickButton,
+	JoystickAxisX,
+	JoystickAxisY,
+};
+
+struct ReplayEvent {
+	ReplayEventType type = ReplayEventType::Key;
+
+	// Joystick number
+	int device = 0;
+
+	// Key, mouse or joystick button
+	int id = 0;
+
+	// Pressed state (0 or 1), mouse movement (relative X and Y, then
+	// absolute X and Y) or wheel, or joystick axis position
+	std::array<float, 4> values = {};
+
+	bool operator==(const ReplayEvent& other) const = default;
+};
+
+struct ReplayEntry {
+	uint64_t tick     = 0;
+	ReplayEvent event = {};
+
+	bool operator==(const ReplayEntry& other) const = default;
+};
+
+std::string REPLAY_FormatEntry(const ReplayEntry& entry);
+std::optional<ReplayEntry> REPLAY_ParseEntry(const std::string_view line);
+
+void REPLAY_StartRecording(const std::string& path);
+void REPLAY_StartPlayback(const std::string& path);
+
+// Closes the recording or ends the replay
+void REPLAY_Stop();
+
+bool REPLAY_IsPlaying();
+
+// Brackets the handling of the host events; events reaching the input
+// devices in between come from the host
+void REPLAY_BeginHostEvents();
+void REPLAY_EndHostEvents();
+
+// Called by the input devices with every event before handling it. The
+// host events are recorded; returns false if the event comes from the host
+// while replaying and should be dropped.
+bool REPLAY_AcceptEvent(const ReplayEvent& event);
+
+// Delivers the recorded events of the current tick; called after the host
+// events have been handled
+void REPLAY_InjectEvents();
+
+// The host's wall clock in milliseconds since the epoch, for the emulated
+// real-time clocks
+int64_t REPLAY_GetHostTimeMs();
+
+// A seed for the random number generators the guest can observe
+uint32_t REPLAY_GetRandomSeed();
+
+#endif // DOSBOX_INPUT_REPLAY_H
@@ -11,6 +11,7 @@
 #include "config/config.h"
 #include "config/setup.h"
 #include "gui/mapper.h"
+#include "hardware/input/input_replay.h"
 #include "hardware/input/mouse.h"
 #include "hardware/pic.h"
 #include "hardware/port.h"
@@ -52,8 +53,8 @@ struct JoyStick {
 	double xpos = 0.0;
 	double ypos = 0.0; // position as set by SDL
 
-	double xtick = 0.0;
-	double ytick = 0.0;
+	PicTime xtick = 0;
+	PicTime ytick = 0;
 
 	double xfinal = 0.0;
 	double yfinal = 0.0; // position returned to the game for stick 0
@@ -212,7 +213,7 @@ static uint8_t read_p201(io_port_t, io_width_t)
 static uint8_t read_p201_timed(io_port_t, io_width_t)
 {
 	uint8_t ret = 0xff;
-	const auto currentTick = PIC_FullIndex();
+	const auto currentTick = PIC_FullTime();
 	if( stick[0].enabled ){
 		if( stick[0].xtick < currentTick ) ret &=~1;
 		if( stick[0].ytick < currentTick ) ret &=~2;
@@ -279,11 +280,12 @@ static void write_p201_timed(io_port_t, io_val_t, io_width_t)
 	};
 	*/
 
-	const auto now = PIC_FullIndex();
+	const auto now = PIC_FullTime();
 	// Newer calculation, derived from joycheck measurements
 	auto position_to_ticks = [&](const auto position,
 	                             const AxisRateConstants &axis_rate) {
-		return now + (position + 1.0) * axis_rate.scalar + axis_rate.offset;
+		return now + PIC_MsToTime((position + 1.0) * axis_rate.scalar +
+		                          axis_rate.offset);
 	};
 
 	if (stick[0].enabled) {
@@ -313,6 +315,13 @@ void JOYSTICK_Button(uint8_t which, int num, bool pressed)
 {
 	assert(which < 2);
 	assert(num < 2);
+
+	if (!REPLAY_AcceptEvent({ReplayEventType::JoystickButton,
+	                         which,
+	                         num,
+	                         {pressed ? 1.0f : 0.0f}})) {
+		return;
+	}
 	stick[which].button[num] = pressed;
 }
 
@@ -326,6 +335,13 @@ void JOYSTICK_Move_X(uint8_t which, int16_t x_val)
 {
 	assert(which < 2);
 
+	if (!REPLAY_AcceptEvent({ReplayEventType::JoystickAxisX,
+	                         which,
+	                         0,
+	                         {static_cast<float>(x_val)}})) {
+		return;
+	}
+
 	const auto x = position_to_percent(x_val);
 	if (stick[which].xpos == x)
 		return;
@@ -338,6 +354,13 @@ void JOYSTICK_Move_X(uint8_t which, int16_t x_val)
 void JOYSTICK_Move_Y(uint8_t which, int16_t y_val)
 {
 	assert(which < 2);
+
+	if (!REPLAY_AcceptEvent({ReplayEventType::JoystickAxisY,
+	                         which,
+	                         0,
+	                         {static_cast<float>(y_val)}})) {
+		return;
+	}
 	const auto y = position_to_percent(y_val);
 	if (stick[which].ypos == y)
 		return;
@@ -563,7 +586,7 @@ public:
 		configure_calibration(section);
 
 		// Set initial time and position states
-		const auto ticks = PIC_FullIndex();
+		const auto ticks = PIC_FullTime();
 		stick[0].xtick = ticks;
 		stick[0].ytick = ticks;
 		stick[1].xtick = ticks;
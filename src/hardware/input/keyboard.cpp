@@ -12,6 +12,7 @@
 #include "config/config.h"
 #include "cpu/cpu.h"
 #include "dosbox.h"
+#include "hardware/input/input_replay.h"
 #include "hardware/pic.h"
 #include "hardware/timer.h"
 #include "misc/support.h"
@@ -650,6 +651,13 @@ void KEYBOARD_NotifyReadyForFrame()
 
 void KEYBOARD_AddKey(const KBD_KEYS key_type, const bool is_pressed)
 {
+	if (!REPLAY_AcceptEvent({ReplayEventType::Key,
+	                         0,
+	                         key_type,
+	                         {is_pressed ? 1.0f : 0.0f}})) {
+		return;
+	}
+
 	if (should_wait_for_secure_mode && !control->SecureMode()) {
 		warn_waiting_for_secure_mode();
 		return;
@@ -690,6 +698,11 @@ uint8_t KEYBOARD_GetLedState()
 	return (leds_all_on ? 0xff : led_state) & 0b0000'0111;
 }
 
+bool KEYBOARD_IsIdle()
+{
+	return buffer_num_used == 0 && I8042_IsReadyForKbdFrame();
+}
+
 void KEYBOARD_ClrBuffer()
 {
 	// Sometimes the GUI part wants us to clear the buffer. Original code
@@ -214,6 +214,9 @@ void KEYBOARD_AddKey(const KBD_KEYS key_type, const bool is_pressed);
 // TODO: BIOS does not update LEDs as of yet
 uint8_t KEYBOARD_GetLedState();
 
+// True if no scan codes are waiting to be passed to the guest
+bool KEYBOARD_IsIdle();
+
 // Do not use KEYBOARD_ClrBuffer in new code, it can't clear everything!
 void KEYBOARD_ClrBuffer();
 
@@ -17,6 +17,7 @@
 #include "cpu/callback.h"
 #include "cpu/cpu.h"
 #include "gui/common.h"
+#include "hardware/input/input_replay.h"
 #include "hardware/pic.h"
 #include "misc/video.h"
 #include "utils/checks.h"
@@ -76,6 +77,21 @@ static struct {
 
 } state;
 
+// Host pointer motion reported since the interfaces were last notified; a
+// high polling rate mouse produces many motion events per emulated
+// millisecond, and the interfaces only need their sum and the latest
+// absolute position
+static struct {
+	bool has_motion = false;
+
+	float x_rel = 0.0f;
+	float y_rel = 0.0f;
+	float x_abs = 0.0f;
+	float y_abs = 0.0f;
+} pending_motion = {};
+
+static MouseMotionStats motion_stats = {};
+
 static void update_cursor_absolute_position(const float x_abs, const float y_abs)
 {
 	state.cursor_is_outside = false;
@@ -485,6 +501,9 @@ Bitu int74_ret_handler()
 
 void MOUSE_NewScreenParams(const MouseScreenParams &params)
 {
+	// The pending position is relative to the old draw area
+	MOUSE_FlushMotion();
+
 	state.draw_rect = params.draw_rect;
 
 	// Protection against strange window sizes,
@@ -553,12 +572,58 @@ void MOUSE_EventMoved(const float x_rel, const float y_rel,
 {
 	// Event from GFX
 
+	if (!REPLAY_AcceptEvent({ReplayEventType::MouseMoved,
+	                         0,
+	                         0,
+	                         {x_rel, y_rel, x_abs, y_abs}})) {
+		return;
+	}
+
+	++motion_stats.num_received;
+
+	// Merge with the motion not delivered yet; it gets delivered once the
+	// host event queue is drained, or before the next button or wheel event
+	if (pending_motion.has_motion) {
+		++motion_stats.num_merged;
+	}
+
+	pending_motion.has_motion = true;
+
+	pending_motion.x_rel = MOUSE_ClampRelativeMovement(pending_motion.x_rel + x_rel);
+	pending_motion.y_rel = MOUSE_ClampRelativeMovement(pending_motion.y_rel + y_rel);
+	pending_motion.x_abs = x_abs;
+	pending_motion.y_abs = y_abs;
+}
+
+void MOUSE_FlushMotion()
+{
+	if (!pending_motion.has_motion) {
+		return;
+	}
+
+	const auto motion = pending_motion;
+	pending_motion    = {};
+
+	const auto old_cursor_x_abs = state.cursor_x_abs;
+	const auto old_cursor_y_abs = state.cursor_y_abs;
+
 	// Update cursor position and visibility
-	update_cursor_absolute_position(x_abs, y_abs);
+	update_cursor_absolute_position(motion.x_abs, motion.y_abs);
 	update_cursor_visibility();
 
 	// Drop unneeded events
 	if (should_drop_move()) {
+		++motion_stats.num_dropped;
+		return;
+	}
+
+	// Absolute position fast path: with no relative movement (e.g., the
+	// host pointer moved within the same logical unit, or was warped back
+	// to where it was) there's nothing new for any interface
+	if (motion.x_rel == 0.0f && motion.y_rel == 0.0f &&
+	    state.cursor_x_abs == old_cursor_x_abs &&
+	    state.cursor_y_abs == old_cursor_y_abs) {
+		++motion_stats.num_dropped;
 		return;
 	}
 
@@ -579,8 +644,8 @@ void MOUSE_EventMoved(const float x_rel, const float y_rel,
 	// so it needs data in both formats.
 
 	// Notify mouse interfaces
-	const float x_scaled = x_rel * mouse_config.sensitivity_coeff_x;
-	const float y_scaled = y_rel * mouse_config.sensitivity_coeff_y;
+	const float x_scaled = motion.x_rel * mouse_config.sensitivity_coeff_x;
+	const float y_scaled = motion.y_rel * mouse_config.sensitivity_coeff_y;
 	for (const auto interface_id : AllMouseInterfaceIds) {
 		auto& interface = MouseInterface::GetInstance(interface_id);
 		if (interface.IsUsingHostPointer()) {
@@ -615,6 +680,16 @@ void MOUSE_EventButton(const MouseButtonId button_id, const bool pressed)
 {
 	// Event from GFX
 
+	if (!REPLAY_AcceptEvent({ReplayEventType::MouseButton,
+	                         0,
+	                         static_cast<int>(button_id),
+	                         {pressed ? 1.0f : 0.0f}})) {
+		return;
+	}
+
+	// The button event has to reach the guest after the earlier motion
+	MOUSE_FlushMotion();
+
 	// Never ignore any button releases - always pass them
 	// to concrete interfaces, they will decide whether to
 	// ignore them or not.
@@ -678,6 +753,12 @@ void MOUSE_EventWheel(const float w_rel)
 {
 	// Event from GFX
 
+	if (!REPLAY_AcceptEvent({ReplayEventType::MouseWheel, 0, 0, {w_rel}})) {
+		return;
+	}
+
+	MOUSE_FlushMotion();
+
 	// Drop unneeded events
 	if (should_drop_press_or_wheel()) {
 		return;
@@ -755,6 +836,11 @@ MouseControlAPI::~MouseControlAPI()
 	MOUSE_UpdateGFX();
 }
 
+MouseMotionStats MouseControlAPI::GetMotionStats()
+{
+	return motion_stats;
+}
+
 bool MouseControlAPI::IsNoMouseMode()
 {
 	return mouse_config.capture == MouseCapture::NoMouse;
@@ -80,8 +80,11 @@ enum class MouseHint {
 // Notifications from external subsystems - all should go via these methods
 // ***************************************************************************
 
+// Motion of the host pointer is merged until flushed, by the GFX subsystem
+// once it has drained its event queue, or by a button or wheel event
 void MOUSE_EventMoved(const float x_rel, const float y_rel,
                       const float x_abs, const float y_abs);
+void MOUSE_FlushMotion();
 void MOUSE_EventMoved(const float x_rel, const float y_rel,
                       const MouseInterfaceId device_id);
 
@@ -260,6 +263,16 @@ int16_t MOUSE_ConsumeInt16(float& delta, const bool skip_delta_update = false);
 class MouseInterface;
 class MousePhysical;
 
+// Host pointer motion events, since the start of the emulator
+struct MouseMotionStats {
+	uint64_t num_received = 0;
+	// Merged with a later event before reaching the interfaces
+	uint64_t num_merged = 0;
+	// Not delivered, as the mouse is not captured, the pointer is outside
+	// of the window, or the motion changed nothing
+	uint64_t num_dropped = 0;
+};
+
 class MouseInterfaceInfoEntry final {
 public:
 	bool IsEmulated() const;
@@ -317,6 +330,8 @@ public:
 	const std::vector<MouseInterfaceInfoEntry> &GetInfoInterfaces() const;
 	const std::vector<MousePhysicalInfoEntry> &GetInfoPhysical();
 
+	static MouseMotionStats GetMotionStats();
+
 	static bool IsNoMouseMode();
 	static bool IsMappingBlockedByDriver();
 
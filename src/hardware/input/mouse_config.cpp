@@ -427,6 +427,31 @@ static void set_mouse_sensitivity(const SectionProp& section)
 	mouse_config.sensitivity_coeff_y = convert_value(*value_y);
 }
 
+static void set_max_rate(const SectionProp& section)
+{
+	constexpr auto SettingName = "mouse_max_rate";
+	constexpr auto DefaultStr  = "off";
+
+	const auto option_str = section.GetString(SettingName);
+
+	if (const auto maybe_bool = parse_bool_setting(option_str);
+	    maybe_bool && !*maybe_bool) {
+		mouse_config.max_rate_hz = 0;
+		return;
+	}
+
+	const auto value = parse_int(option_str);
+	if (!value || *value <= 0) {
+		log_invalid_parameter(SettingName, option_str, DefaultStr);
+		set_section_property_value(SectionName, SettingName, DefaultStr);
+		mouse_config.max_rate_hz = 0;
+		return;
+	}
+
+	mouse_config.max_rate_hz = MOUSE_ClampRateHz(
+	        static_cast<uint16_t>(std::min(*value, UINT16_MAX)));
+}
+
 static void set_multi_display_aware(const SectionProp& section)
 {
 	const std::string OptionStr = "mouse_multi_display_aware";
@@ -484,6 +509,7 @@ void MOUSE_Init()
 	set_multi_display_aware(*section);
 	set_middle_release(*section);
 	set_raw_input(*section);
+	set_max_rate(*section);
 
 	// Built-in DOS driver configuration
 	set_dos_driver(*section);
@@ -543,6 +569,13 @@ static void notify_mouse_setting_updated(SectionProp& section,
 
 	} else if (prop_name == "mouse_sensitivity") {
 		set_mouse_sensitivity(section);
+
+	} else if (prop_name == "mouse_max_rate") {
+		set_max_rate(section);
+
+		for (const auto interface_id : AllMouseInterfaceIds) {
+			MouseInterface::GetInstance(interface_id).NotifyMaxRate();
+		}
 	}
 }
 
@@ -611,6 +644,19 @@ static void init_mouse_config_settings(SectionProp& secprop)
 	        "  - Sensitivity can be fine-tuned futher per mouse interface with the internal\n"
 	        "    MOUSECTL.COM command.");
 
+	prop_str = secprop.AddString("mouse_max_rate", Always, "off");
+	prop_str->SetHelp(
+	        "Limit the rate at which each emulated mouse interface reports motion to the\n"
+	        "guest, in Hz ('off' by default). Possible values:\n"
+	        "\n"
+	        "  off:     Report motion at the sampling rate set by the guest or by\n"
+	        "           MOUSECTL.COM (default).\n"
+	        "  <value>  Maximum rate between 10 and 500 Hz; the motion in between is merged.\n"
+	        "           Lowers the number of mouse interrupts the guest has to handle.\n"
+	        "\n"
+	        "Note: The host mouse motion is always merged between two polls of the host\n"
+	        "      event queue, so high polling rate mice don't flood the interfaces.");
+
 	prop_bool = secprop.AddBool("mouse_raw_input", Always, true);
 	prop_bool->SetHelp(
 	        "Bypass the mouse acceleration and sensitivity settings of the host operating\n"
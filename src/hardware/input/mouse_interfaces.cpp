@@ -340,6 +340,11 @@ void MouseInterface::NotifyInterfaceRate(const uint16_t new_rate_hz)
 	UpdateRate();
 }
 
+void MouseInterface::NotifyMaxRate()
+{
+	UpdateRate();
+}
+
 void MouseInterface::NotifyMoved(const float, const float, const float, const float) {}
 
 void MouseInterface::NotifyButton(const MouseButtonId, const bool) {}
@@ -520,6 +525,11 @@ void MouseInterface::UpdateMinRate()
 void MouseInterface::UpdateRate()
 {
 	rate_hz = MOUSE_ClampRateHz(std::max(interface_rate_hz, min_rate_hz));
+
+	// The configured limit takes precedence over the minimum rate
+	if (mouse_config.max_rate_hz) {
+		rate_hz = std::min(rate_hz, mouse_config.max_rate_hz);
+	}
 }
 
 void MouseInterface::UpdateButtons(const MouseButtonId button_id, const bool pressed)
@@ -73,6 +73,10 @@ struct MouseConfig {
 	float sensitivity_coeff_y = 1.0f;
 
 	bool raw_input           = false; // true = relative input is raw data
+
+	// Limit of the rate at which each interface reports motion to the
+	// guest, 0 for no limit
+	uint16_t max_rate_hz = 0;
 	bool multi_display_aware = false;
 
 	bool dos_driver_autoexec = false;
@@ -122,6 +122,7 @@ public:
 	virtual void NotifyWheel(const float w_rel);
 
 	void NotifyInterfaceRate(const uint16_t rate_hz);
+	void NotifyMaxRate();
 	virtual void NotifyBooting();
 	void NotifyDisconnect();
 
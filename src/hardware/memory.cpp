@@ -4,14 +4,25 @@
 
 #include "memory.h"
 
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
+#include <fstream>
 #include <memory>
+#include <span>
+
+#if defined(WIN32)
+#include <windows.h>
+#elif defined(HAVE_MMAP)
+#include <sys/mman.h>
+#endif
 
 #include "config/setup.h"
 #include "cpu/paging.h"
 #include "cpu/registers.h"
 #include "hardware/pci_bus.h"
 #include "hardware/port.h"
+#include "misc/host_memory.h"
 #include "misc/support.h"
 
 constexpr auto Megabyte = 1024 * 1024;
@@ -29,7 +40,7 @@ static struct MemoryBlock {
 	struct page_t {
 		uint8_t bytes[DosPageSize] = {};
 	};
-	std::vector<page_t> pages           = {};
+	std::span<page_t> pages             = {};
 	std::vector<PageHandler*> phandlers = {};
 	std::vector<MemHandle> mhandles     = {};
 	struct {
@@ -45,8 +56,13 @@ static struct MemoryBlock {
 
 		uint8_t controlport = 0;
 	} a20 = {};
+
+	// Pages written to since the dirty tracking was (re)started
+	std::vector<bool> dirty_pages = {};
 } memory = {};
 
+bool mem_tracks_dirty_pages = false;
+
 // Points to the first byte of the first DOS memory page
 HostPt MemBase = {};
 
@@ -115,6 +131,32 @@ public:
 	}
 };
 
+// Maps the clean RAM pages while the dirty pages are tracked. The pages
+// aren't linked for direct writes, so the first write to each page lands here
+class DirtyTrackingPageHandler final : public RAMPageHandler {
+public:
+	DirtyTrackingPageHandler() {
+		flags=PFLAG_READABLE;
+	}
+	void writeb(PhysPt addr, uint8_t val) override {
+		host_writeb(MarkDirty(addr), val);
+	}
+	void writew(PhysPt addr, uint16_t val) override {
+		host_writew(MarkDirty(addr), val);
+	}
+	void writed(PhysPt addr, uint32_t val) override {
+		host_writed(MarkDirty(addr), val);
+	}
+	void writeq(PhysPt addr, uint64_t val) override {
+		host_writeq(MarkDirty(addr), val);
+	}
+
+private:
+	// Marks the page, hands it back to the RAM handler, and returns the
+	// host address of the linear address being written to
+	HostPt MarkDirty(const PhysPt addr);
+};
+
 uint16_t MEM_GetMinMegabytes()
 {
 	return MinMegabytes;
@@ -128,6 +170,25 @@ uint16_t MEM_GetMaxMegabytes()
 static IllegalPageHandler illegal_page_handler;
 static RAMPageHandler ram_page_handler;
 static ROMPageHandler rom_page_handler;
+static DirtyTrackingPageHandler dirty_tracking_page_handler;
+
+HostPt DirtyTrackingPageHandler::MarkDirty(const PhysPt addr)
+{
+	const auto phys_addr = PAGING_GetPhysicalAddress(addr);
+	const auto phys_page = phys_addr / DosPageSize;
+
+	if (phys_page < memory.dirty_pages.size()) {
+		memory.dirty_pages[phys_page] = true;
+	}
+	// The page might have become a code page since it was linked
+	if (memory.phandlers[phys_page] == this) {
+		memory.phandlers[phys_page] = &ram_page_handler;
+	}
+	// Relinked for direct writes on the next access
+	PAGING_UnlinkPages(addr / DosPageSize, 1);
+
+	return GetHostWritePt(phys_page) + (phys_addr & (DosPageSize - 1));
+}
 
 void MEM_SetLFB(Bitu page, Bitu pages, PageHandler *handler, PageHandler *mmiohandler) {
 	memory.lfb.handler=handler;
@@ -138,6 +199,12 @@ void MEM_SetLFB(Bitu page, Bitu pages, PageHandler *handler, PageHandler *mmioha
 	PAGING_ClearTLB();
 }
 
+void MEM_SetLFBHandler(PageHandler* handler)
+{
+	memory.lfb.handler = handler;
+	PAGING_UnlinkPhysPages(memory.lfb.start_page, memory.lfb.pages);
+}
+
 PageHandler * MEM_GetPageHandler(Bitu phys_page) {
 	if (phys_page < memory.pages.size()) {
 		return memory.phandlers[phys_page];
@@ -163,8 +230,20 @@ PageHandler * MEM_GetPageHandler(Bitu phys_page) {
 	return &illegal_page_handler;
 }
 
+static bool is_tracked_ram_page(const Bitu phys_page)
+{
+	const auto handler = memory.phandlers[phys_page];
+	return handler == &ram_page_handler || handler == &dirty_tracking_page_handler;
+}
+
 void MEM_SetPageHandler(Bitu phys_page,Bitu pages,PageHandler * handler) {
 	for (;pages>0;pages--) {
+		// A RAM page taken over by another handler (such as a code page)
+		// can be written without being caught by the tracking handler
+		if (mem_tracks_dirty_pages && handler != &dirty_tracking_page_handler &&
+		    is_tracked_ram_page(phys_page)) {
+			memory.dirty_pages[phys_page] = true;
+		}
 		memory.phandlers[phys_page]=handler;
 		phys_page++;
 	}
@@ -177,6 +256,87 @@ void MEM_ResetPageHandler(Bitu phys_page, Bitu pages) {
 	}
 }
 
+void MEM_StartDirtyTracking()
+{
+	memory.dirty_pages.assign(memory.pages.size(), false);
+
+	for (auto& handler : memory.phandlers) {
+		if (handler == &ram_page_handler) {
+			handler = &dirty_tracking_page_handler;
+		}
+	}
+	mem_tracks_dirty_pages = true;
+
+	// Drops the direct write links of the pages
+	PAGING_ClearTLB();
+}
+
+void MEM_StopDirtyTracking()
+{
+	if (!mem_tracks_dirty_pages) {
+		return;
+	}
+	for (auto& handler : memory.phandlers) {
+		if (handler == &dirty_tracking_page_handler) {
+			handler = &ram_page_handler;
+		}
+	}
+	memory.dirty_pages.clear();
+	mem_tracks_dirty_pages = false;
+
+	PAGING_ClearTLB();
+}
+
+// The Tandy and PCjr video memory is part of the RAM and is written through
+// the video memory handlers, bypassing the tracking
+static bool is_video_ram_page(const uint32_t phys_page)
+{
+	constexpr uint32_t VideoPages = 128 * 1024 / DosPageSize;
+
+	// The PCjr video memory can be any bank of the first 128 KB
+	constexpr uint32_t TandyFirstPage = 0x80000 / DosPageSize;
+
+	if (is_machine_pcjr()) {
+		return phys_page < VideoPages;
+	}
+	if (is_machine_tandy()) {
+		return phys_page >= TandyFirstPage && phys_page < TandyFirstPage + VideoPages;
+	}
+	return false;
+}
+
+std::vector<uint32_t> MEM_GetDirtyPages()
+{
+	std::vector<uint32_t> dirty_pages = {};
+	if (!mem_tracks_dirty_pages) {
+		return dirty_pages;
+	}
+	for (uint32_t page = 0; page < memory.dirty_pages.size(); ++page) {
+		// Code pages and pages handed back to the RAM handler behind
+		// the tracking's back (e.g. released code pages) are written
+		// directly
+		const auto handler = memory.phandlers[page];
+		if (memory.dirty_pages[page] || handler == &ram_page_handler ||
+		    (handler->flags & PFLAG_HASCODE) || is_video_ram_page(page)) {
+			dirty_pages.push_back(page);
+		}
+	}
+	return dirty_pages;
+}
+
+void MEM_MarkDirty(const PhysPt addr, const size_t num_bytes)
+{
+	if (num_bytes == 0) {
+		return;
+	}
+	const auto last_page = std::min((addr + num_bytes - 1) / DosPageSize,
+	                                memory.dirty_pages.size() - 1);
+
+	for (auto page = addr / DosPageSize; page <= last_page; ++page) {
+		memory.dirty_pages[page] = true;
+	}
+}
+
 Bitu mem_strlen(PhysPt pt) {
 	Bitu x=0;
 	while (x<1024) {
@@ -192,22 +352,112 @@ void mem_strcpy(PhysPt dest,PhysPt src) {
 	mem_writeb_inline(dest,0);
 }
 
-void mem_memcpy(PhysPt dest,PhysPt src,Bitu size) {
-	while (size--) mem_writeb_inline(dest++,mem_readb_inline(src++));
+// The block transfers below walk guest memory one page at a time and copy
+// directly from or to host memory when the TLB maps the page that way. Pages
+// served by a handler (MMIO, VGA, ROM writes, unmapped pages that have to be
+// faulted in, or code pages watched by the dynamic core) are copied byte by
+// byte through the handler. The heavy debugger sees every byte so its memory
+// breakpoints still trigger.
+
+// Number of bytes, up to 'size', from 'address' to the end of its page
+static size_t bytes_to_page_end(const PhysPt address, const size_t size)
+{
+	const size_t to_end = MemPageSize - (address & (MemPageSize - 1));
+	return std::min(size, to_end);
 }
 
-void MEM_BlockRead(PhysPt pt,void * data,Bitu size) {
-	auto write = reinterpret_cast<uint8_t *>(data);
-	while (size--) {
-		*write++=mem_readb_inline(pt++);
+static HostPt get_host_read_pt(const PhysPt address)
+{
+#if C_HEAVY_DEBUGGER
+	(void)address;
+	return nullptr;
+#else
+	const auto tlb_addr = get_tlb_read(address);
+	return tlb_addr ? tlb_addr + address : nullptr;
+#endif
+}
+
+static HostPt get_host_write_pt(const PhysPt address)
+{
+	const auto tlb_addr = get_tlb_write(address);
+	return tlb_addr ? tlb_addr + address : nullptr;
+}
+
+void mem_memcpy(PhysPt dest, PhysPt src, Bitu size)
+{
+	while (size > 0) {
+		const auto chunk = bytes_to_page_end(dest, bytes_to_page_end(src, size));
+
+		const auto from = get_host_read_pt(src);
+		const auto to   = get_host_write_pt(dest);
+
+		// Pages that follow each other in host memory on both sides
+		// (such as XMS blocks) are moved with a single memmove
+		size_t run = chunk;
+		while (from && to && run < size) {
+			const auto next = bytes_to_page_end(dest + run,
+			                                    bytes_to_page_end(src + run,
+			                                                      size - run));
+			if (get_host_read_pt(src + run) != from + run ||
+			    get_host_write_pt(dest + run) != to + run) {
+				break;
+			}
+			run += next;
+		}
+
+		// The byte loop replicates the leading bytes when the
+		// destination overlaps the source from above
+		if (from && to && (to > from && to < from + run)) {
+			run = chunk;
+		}
+		if (from && to && !(to > from && to < from + run)) {
+			std::memmove(to, from, run);
+		} else {
+			for (size_t i = 0; i < chunk; ++i) {
+				mem_writeb_inline(dest + i, mem_readb_inline(src + i));
+			}
+		}
+		dest += run;
+		src += run;
+		size -= run;
+	}
+}
+
+void MEM_BlockRead(PhysPt pt, void* data, Bitu size)
+{
+	auto write = reinterpret_cast<uint8_t*>(data);
+	while (size > 0) {
+		const auto chunk = bytes_to_page_end(pt, size);
+
+		if (const auto from = get_host_read_pt(pt); from) {
+			std::memcpy(write, from, chunk);
+		} else {
+			for (size_t i = 0; i < chunk; ++i) {
+				write[i] = mem_readb_inline(pt + i);
+			}
+		}
+		pt += chunk;
+		write += chunk;
+		size -= chunk;
 	}
 }
 
 void MEM_BlockWrite(PhysPt pt, const void *data, size_t size)
 {
 	auto read = static_cast<const uint8_t *>(data);
-	while (size--) {
-		mem_writeb_inline(pt++,*read++);
+	while (size > 0) {
+		const auto chunk = bytes_to_page_end(pt, size);
+
+		if (const auto to = get_host_write_pt(pt); to) {
+			std::memcpy(to, read, chunk);
+		} else {
+			for (size_t i = 0; i < chunk; ++i) {
+				mem_writeb_inline(pt + i, read[i]);
+			}
+		}
+		pt += chunk;
+		read += chunk;
+		size -= chunk;
 	}
 }
 
@@ -215,6 +465,23 @@ void MEM_BlockCopy(PhysPt dest,PhysPt src,Bitu size) {
 	mem_memcpy(dest,src,size);
 }
 
+void MEM_BlockFill(PhysPt pt, const uint8_t value, size_t size)
+{
+	while (size > 0) {
+		const auto chunk = bytes_to_page_end(pt, size);
+
+		if (const auto to = get_host_write_pt(pt); to) {
+			std::memset(to, value, chunk);
+		} else {
+			for (size_t i = 0; i < chunk; ++i) {
+				mem_writeb_inline(pt + i, value);
+			}
+		}
+		pt += chunk;
+		size -= chunk;
+	}
+}
+
 void MEM_StrCopy(PhysPt pt,char * data,Bitu size) {
 	while (size--) {
 		uint8_t r=mem_readb_inline(pt++);
@@ -471,13 +738,35 @@ void MEM_A20_Enable(bool enabled) {
 }
 
 /* Memory access functions */
+
+// The unaligned accessors are also called for accesses that might cross a
+// page boundary; the ones that don't are done with a single access to the
+// page, and only the real page crossings are split into bytes
+template <typename T>
+static inline bool is_within_page(const PhysPt address)
+{
+	return (address & 0xfff) <= 0x1000 - sizeof(T);
+}
+
 uint16_t mem_unalignedreadw(PhysPt address) {
+	if (is_within_page<uint16_t>(address)) {
+		const auto tlb_addr = get_tlb_read(address);
+		return tlb_addr ? host_readw(tlb_addr + address)
+		                : get_tlb_readhandler(address)->readw(address);
+	}
+
 	uint16_t ret = mem_readb_inline(address);
 	ret       |= mem_readb_inline(address+1) << 8;
 	return ret;
 }
 
 uint32_t mem_unalignedreadd(PhysPt address) {
+	if (is_within_page<uint32_t>(address)) {
+		const auto tlb_addr = get_tlb_read(address);
+		return tlb_addr ? host_readd(tlb_addr + address)
+		                : get_tlb_readhandler(address)->readd(address);
+	}
+
 	uint32_t ret = mem_readb_inline(address);
 	ret       |= mem_readb_inline(address+1) << 8;
 	ret       |= mem_readb_inline(address+2) << 16;
@@ -487,6 +776,12 @@ uint32_t mem_unalignedreadd(PhysPt address) {
 
 uint64_t mem_unalignedreadq(PhysPt address)
 {
+	if (is_within_page<uint64_t>(address)) {
+		const auto tlb_addr = get_tlb_read(address);
+		return tlb_addr ? host_readq(tlb_addr + address)
+		                : get_tlb_readhandler(address)->readq(address);
+	}
+
 	uint64_t ret = 0;
 	for (int i = 0; i < 8; ++i) {
 		ret |= static_cast<uint64_t>(mem_readb_inline(address + i))
@@ -496,11 +791,31 @@ uint64_t mem_unalignedreadq(PhysPt address)
 }
 
 void mem_unalignedwritew(PhysPt address,uint16_t val) {
+	if (is_within_page<uint16_t>(address)) {
+		const auto tlb_addr = get_tlb_write(address);
+		if (tlb_addr) {
+			host_writew(tlb_addr + address, val);
+		} else {
+			get_tlb_writehandler(address)->writew(address, val);
+		}
+		return;
+	}
+
 	mem_writeb_inline(address,(uint8_t)val);val>>=8;
 	mem_writeb_inline(address+1,(uint8_t)val);
 }
 
 void mem_unalignedwrited(PhysPt address,uint32_t val) {
+	if (is_within_page<uint32_t>(address)) {
+		const auto tlb_addr = get_tlb_write(address);
+		if (tlb_addr) {
+			host_writed(tlb_addr + address, val);
+		} else {
+			get_tlb_writehandler(address)->writed(address, val);
+		}
+		return;
+	}
+
 	mem_writeb_inline(address,(uint8_t)val);val>>=8;
 	mem_writeb_inline(address+1,(uint8_t)val);val>>=8;
 	mem_writeb_inline(address+2,(uint8_t)val);val>>=8;
@@ -509,6 +824,16 @@ void mem_unalignedwrited(PhysPt address,uint32_t val) {
 
 void mem_unalignedwriteq(PhysPt address, uint64_t val)
 {
+	if (is_within_page<uint64_t>(address)) {
+		const auto tlb_addr = get_tlb_write(address);
+		if (tlb_addr) {
+			host_writeq(tlb_addr + address, val);
+		} else {
+			get_tlb_writehandler(address)->writeq(address, val);
+		}
+		return;
+	}
+
 	for (int i = 0; i < 8; ++i) {
 		mem_writeb_inline(address + i, static_cast<uint8_t>(val));
 		val >>= 8;
@@ -516,6 +841,15 @@ void mem_unalignedwriteq(PhysPt address, uint64_t val)
 }
 
 bool mem_unalignedreadw_checked(PhysPt address, uint16_t * val) {
+	if (is_within_page<uint16_t>(address)) {
+		const auto tlb_addr = get_tlb_read(address);
+		if (tlb_addr) {
+			*val = host_readw(tlb_addr + address);
+			return false;
+		}
+		return get_tlb_readhandler(address)->readw_checked(address, val);
+	}
+
 	uint8_t rval1;
 	if (mem_readb_checked(address + 0, &rval1))
 		return true;
@@ -529,6 +863,15 @@ bool mem_unalignedreadw_checked(PhysPt address, uint16_t * val) {
 }
 
 bool mem_unalignedreadd_checked(PhysPt address, uint32_t * val) {
+	if (is_within_page<uint32_t>(address)) {
+		const auto tlb_addr = get_tlb_read(address);
+		if (tlb_addr) {
+			*val = host_readd(tlb_addr + address);
+			return false;
+		}
+		return get_tlb_readhandler(address)->readd_checked(address, val);
+	}
+
 	uint8_t rval1;
 	if (mem_readb_checked(address+0, &rval1)) return true;
 
@@ -550,6 +893,15 @@ bool mem_unalignedreadd_checked(PhysPt address, uint32_t * val) {
 
 bool mem_unalignedreadq_checked(PhysPt address, uint64_t* val)
 {
+	if (is_within_page<uint64_t>(address)) {
+		const auto tlb_addr = get_tlb_read(address);
+		if (tlb_addr) {
+			*val = host_readq(tlb_addr + address);
+			return false;
+		}
+		return get_tlb_readhandler(address)->readq_checked(address, val);
+	}
+
 	uint8_t rval[8];
 	for (int i = 0; i < 8; ++i) {
 		if (mem_readb_checked(address + i, &rval[i])) {
@@ -566,6 +918,15 @@ bool mem_unalignedreadq_checked(PhysPt address, uint64_t* val)
 
 bool mem_unalignedwritew_checked(PhysPt address, uint16_t val)
 {
+	if (is_within_page<uint16_t>(address)) {
+		const auto tlb_addr = get_tlb_write(address);
+		if (tlb_addr) {
+			host_writew(tlb_addr + address, val);
+			return false;
+		}
+		return get_tlb_writehandler(address)->writew_checked(address, val);
+	}
+
 	if (mem_writeb_checked(address + 0, (uint8_t)(val & 0xff))) {
 		return true;
 	}
@@ -575,6 +936,15 @@ bool mem_unalignedwritew_checked(PhysPt address, uint16_t val)
 }
 
 bool mem_unalignedwrited_checked(PhysPt address, uint32_t val) {
+	if (is_within_page<uint32_t>(address)) {
+		const auto tlb_addr = get_tlb_write(address);
+		if (tlb_addr) {
+			host_writed(tlb_addr + address, val);
+			return false;
+		}
+		return get_tlb_writehandler(address)->writed_checked(address, val);
+	}
+
 	if (mem_writeb_checked(address+0, (uint8_t)(val & 0xff))) return true;
 	val >>= 8;
 	if (mem_writeb_checked(address+1, (uint8_t)(val & 0xff))) return true;
@@ -587,6 +957,15 @@ bool mem_unalignedwrited_checked(PhysPt address, uint32_t val) {
 
 bool mem_unalignedwriteq_checked(PhysPt address, uint64_t val)
 {
+	if (is_within_page<uint64_t>(address)) {
+		const auto tlb_addr = get_tlb_write(address);
+		if (tlb_addr) {
+			host_writeq(tlb_addr + address, val);
+			return false;
+		}
+		return get_tlb_writehandler(address)->writeq_checked(address, val);
+	}
+
 	for (int i = 0; i < 8; ++i) {
 		if (mem_writeb_checked(address + i,
 		                       static_cast<uint8_t>(val & 0xff))) {
@@ -704,6 +1083,260 @@ HostPt GetMemBase(void)
 	return MemBase;
 }
 
+constexpr size_t HugePageSize = 2 * Megabyte;
+
+static size_t round_up(const size_t num_bytes, const size_t alignment)
+{
+	return (num_bytes + alignment - 1) / alignment * alignment;
+}
+
+#if defined(WIN32)
+
+// Large pages need the 'Lock pages in memory' privilege to be granted to the
+// user and enabled for the process
+static bool enable_lock_memory_privilege()
+{
+	HANDLE token = nullptr;
+	if (!OpenProcessToken(GetCurrentProcess(),
+	                      TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY,
+	                      &token)) {
+		return false;
+	}
+	TOKEN_PRIVILEGES privileges = {};
+
+	privileges.PrivilegeCount           = 1;
+	privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+	// Succeeds without enabling privileges the user doesn't have
+	const auto is_enabled = LookupPrivilegeValue(nullptr,
+	                                             SE_LOCK_MEMORY_NAME,
+	                                             &privileges.Privileges[0].Luid) &&
+	                        AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+	                        GetLastError() == ERROR_SUCCESS;
+	CloseHandle(token);
+	return is_enabled;
+}
+
+#elif defined(HAVE_MMAP)
+
+static uint8_t* map_anonymous(const size_t num_bytes, const int extra_flags)
+{
+	const auto ptr = mmap(nullptr,
+	                      num_bytes,
+	                      PROT_READ | PROT_WRITE,
+	                      MAP_PRIVATE | MAP_ANON | extra_flags,
+	                      -1,
+	                      0);
+	return ptr == MAP_FAILED ? nullptr : static_cast<uint8_t*>(ptr);
+}
+
+#if defined(MADV_HUGEPAGE)
+// The transparent huge pages can be disabled system-wide, in which case
+// madvise() still succeeds
+static bool are_transparent_huge_pages_enabled()
+{
+	std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+
+	std::string modes = {};
+	std::getline(file, modes);
+	return modes.find("[never]") == std::string::npos;
+}
+#endif
+
+#endif
+
+// Host memory backing the guest RAM, optionally on huge pages and locked into
+// the physical memory of the host
+class HostRam {
+public:
+	HostRam(const size_t num_bytes, const bool use_huge_pages, const bool lock)
+	        : size(num_bytes),
+	          use_huge_pages(use_huge_pages),
+	          is_locked(lock)
+	{
+		Allocate();
+		if (is_locked) {
+			Lock();
+		}
+	}
+
+	~HostRam()
+	{
+#if defined(WIN32)
+		VirtualFree(data, 0, MEM_RELEASE);
+#elif defined(HAVE_MMAP)
+		munmap(data, mapped_size);
+#else
+		std::free(data);
+#endif
+	}
+
+	HostRam(const HostRam&)            = delete;
+	HostRam& operator=(const HostRam&) = delete;
+
+	uint8_t* GetData() const
+	{
+		return data;
+	}
+
+	bool IsAllocatedAs(const size_t num_bytes, const bool huge_pages,
+	                   const bool lock) const
+	{
+		return size == num_bytes && use_huge_pages == huge_pages &&
+		       is_locked == lock;
+	}
+
+private:
+	// The memory is zeroed by all the allocators
+	void Allocate()
+	{
+#if defined(WIN32)
+		if (use_huge_pages) {
+			const auto large_page_size = GetLargePageMinimum();
+			if (large_page_size && enable_lock_memory_privilege()) {
+				mapped_size = round_up(size, large_page_size);
+				data = static_cast<uint8_t*>(VirtualAlloc(
+				        nullptr,
+				        mapped_size,
+				        MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+				        PAGE_READWRITE));
+			}
+			if (data) {
+				has_large_pages = true;
+				LOG_MSG("MEMORY: Using %zu KB large pages",
+				        large_page_size / 1024);
+				return;
+			}
+			LOG_WARNING("MEMORY: Large pages aren't available, the user needs "
+			            "the 'Lock pages in memory' privilege; using normal pages");
+		}
+		mapped_size = size;
+		data = static_cast<uint8_t*>(VirtualAlloc(nullptr,
+		                                          mapped_size,
+		                                          MEM_RESERVE | MEM_COMMIT,
+		                                          PAGE_READWRITE));
+		if (!data) {
+			E_Exit("MEMORY: Failed allocating %zu bytes, error %lu",
+			       size,
+			       GetLastError());
+		}
+#elif defined(HAVE_MMAP)
+		if (use_huge_pages && AllocateHugePages()) {
+			return;
+		}
+		mapped_size = size;
+		data        = map_anonymous(mapped_size, 0);
+		if (!data) {
+			E_Exit("MEMORY: Failed allocating %zu bytes because: %s",
+			       size,
+			       strerror(errno));
+		}
+#else
+		if (use_huge_pages) {
+			LOG_WARNING("MEMORY: Huge pages aren't supported on this host, using normal pages");
+		}
+		mapped_size = size;
+		data        = static_cast<uint8_t*>(std::calloc(mapped_size, 1));
+		if (!data) {
+			E_Exit("MEMORY: Failed allocating %zu bytes", size);
+		}
+#endif
+	}
+
+#if defined(HAVE_MMAP) && !defined(WIN32)
+	bool AllocateHugePages()
+	{
+		mapped_size = round_up(size, HugePageSize);
+
+#if defined(MAP_HUGETLB)
+		// Only succeeds if the administrator has reserved enough of them
+		data = map_anonymous(mapped_size, MAP_HUGETLB);
+		if (data) {
+			LOG_MSG("MEMORY: Using reserved 2 MB huge pages");
+			return true;
+		}
+#endif
+#if defined(MADV_HUGEPAGE)
+		// The kernel only backs 2 MB aligned ranges with transparent huge
+		// pages, so the mapping is padded and trimmed to the alignment
+		const auto padded_size = mapped_size + HugePageSize;
+
+		const auto padded = map_anonymous(padded_size, 0);
+		if (!padded) {
+			return false;
+		}
+		const auto head = round_up(reinterpret_cast<uintptr_t>(padded),
+		                           HugePageSize) -
+		                  reinterpret_cast<uintptr_t>(padded);
+		if (head) {
+			munmap(padded, head);
+		}
+		data = padded + head;
+		munmap(data + mapped_size, HugePageSize - head);
+
+		if (madvise(data, mapped_size, MADV_HUGEPAGE) == 0 &&
+		    are_transparent_huge_pages_enabled()) {
+			LOG_MSG("MEMORY: Using transparent huge pages");
+		} else {
+			LOG_WARNING("MEMORY: Transparent huge pages are disabled on the host, using normal pages");
+		}
+		return true;
+#else
+		LOG_WARNING("MEMORY: Huge pages aren't supported on this host, using normal pages");
+		return false;
+#endif
+	}
+#endif
+
+	void Lock()
+	{
+#if defined(WIN32)
+		// Large pages are never paged out
+		if (has_large_pages) {
+			return;
+		}
+		// Locking is limited by the minimum working set size
+		SIZE_T min_size = 0;
+		SIZE_T max_size = 0;
+
+		const auto process = GetCurrentProcess();
+		if (GetProcessWorkingSetSize(process, &min_size, &max_size)) {
+			SetProcessWorkingSetSize(process,
+			                         min_size + mapped_size,
+			                         max_size + mapped_size);
+		}
+		if (VirtualLock(data, mapped_size)) {
+			LOG_MSG("MEMORY: Locked the memory into physical memory");
+		} else {
+			LOG_WARNING("MEMORY: Could not lock the memory into physical memory, error %lu",
+			            GetLastError());
+		}
+#elif defined(HAVE_MMAP)
+		if (mlock(data, mapped_size) == 0) {
+			LOG_MSG("MEMORY: Locked the memory into physical memory");
+		} else {
+			LOG_WARNING("MEMORY: Could not lock the memory into physical memory because: %s",
+			            strerror(errno));
+		}
+#else
+		LOG_WARNING("MEMORY: Locking the memory isn't supported on this host");
+#endif
+	}
+
+	uint8_t* data      = nullptr;
+	size_t size        = 0;
+	size_t mapped_size = 0;
+
+	bool use_huge_pages = false;
+	bool is_locked      = false;
+
+#if defined(WIN32)
+	bool has_large_pages = false;
+#endif
+};
+
+static std::unique_ptr<HostRam> host_ram = {};
+
 class MEMORY {
 private:
 	IO_ReadHandleObject ReadHandler   = {};
@@ -719,8 +1352,26 @@ public:
 
 		const auto num_pages = num_megabytes * PagesPerMegabyte;
 
-		// Size the actual memory pages
-		memory.pages.resize(num_pages);
+		// Allocate the actual memory pages; the RAM keeps its contents
+		// across restarts unless its size or allocation changes
+		const auto num_bytes = num_pages * sizeof(MemoryBlock::page_t);
+		const auto use_huge_pages = section->GetBool("memory_huge_pages");
+		const auto lock = section->GetBool("memory_lock");
+
+		if (!host_ram ||
+		    !host_ram->IsAllocatedAs(num_bytes, use_huge_pages, lock)) {
+			memory.pages = {};
+			host_ram     = {};
+			host_ram     = std::make_unique<HostRam>(num_bytes,
+			                                         use_huge_pages,
+			                                         lock);
+		}
+		memory.pages = {reinterpret_cast<MemoryBlock::page_t*>(host_ram->GetData()),
+		                static_cast<size_t>(num_pages)};
+
+		HOST_MEMORY_AddSubsystem("Guest RAM", [] {
+			return memory.pages.size_bytes();
+		});
 
 		// The MemBase is address of the first page's first byte
 		MemBase = &(memory.pages[0].bytes[0]);
@@ -734,6 +1385,9 @@ public:
 		memory.phandlers.clear();
 		memory.phandlers.resize(num_pages, &ram_page_handler);
 
+		memory.dirty_pages.clear();
+		mem_tracks_dirty_pages = false;
+
 		// Setup the memory handers, defaulting to 0 which means
 		// memory-allocation
 		memory.mhandles.clear();
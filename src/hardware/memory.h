@@ -7,6 +7,8 @@
 
 #include "dosbox.h"
 
+#include <vector>
+
 #include "config/setup.h"
 #include "misc/types.h"
 #include "utils/mem_host.h"
@@ -125,28 +127,56 @@ void mem_writew(PhysPt pt, uint16_t val);
 void mem_writed(PhysPt pt, uint32_t val);
 void mem_writeq(PhysPt pt, uint64_t val);
 
+// Tracking of the RAM pages written to, used by the incremental snapshots.
+// While enabled, the clean RAM pages are mapped through a handler that
+// catches the first write to each of them; the page is then marked dirty and
+// mapped for direct access again. Writes that bypass the page handlers (the
+// phys_* helpers and DMA) mark their pages themselves.
+extern bool mem_tracks_dirty_pages;
+
+// Starting while already tracking marks all pages clean again
+void MEM_StartDirtyTracking();
+void MEM_StopDirtyTracking();
+
+// Pages written to since the tracking was (re)started, in ascending order
+std::vector<uint32_t> MEM_GetDirtyPages();
+
+void MEM_MarkDirty(PhysPt addr, size_t num_bytes);
+
+static inline void mark_phys_dirty(PhysPt addr, size_t num_bytes)
+{
+	if (mem_tracks_dirty_pages) {
+		MEM_MarkDirty(addr, num_bytes);
+	}
+}
+
 static inline void phys_writeb(PhysPt addr, uint8_t val)
 {
+	mark_phys_dirty(addr, 1);
 	host_writeb(MemBase + addr, val);
 }
 
 static inline void phys_writew(PhysPt addr, uint16_t val)
 {
+	mark_phys_dirty(addr, 2);
 	host_writew(MemBase + addr, val);
 }
 
 static inline void phys_writed(PhysPt addr, uint32_t val)
 {
+	mark_phys_dirty(addr, 4);
 	host_writed(MemBase + addr, val);
 }
 
 static inline void phys_writeq(PhysPt addr, uint64_t val)
 {
+	mark_phys_dirty(addr, 8);
 	host_writeq(MemBase + addr, val);
 }
 
 static inline void phys_writes(PhysPt addr, const std::string& string)
 {
+	mark_phys_dirty(addr, string.size());
 	auto destination = MemBase + addr;
 	for (auto character : string) {
 		host_writeb(destination++, character);
@@ -178,6 +208,7 @@ static inline uint64_t phys_readq(PhysPt addr)
 void MEM_BlockWrite(PhysPt pt, const void *data, size_t size);
 void MEM_BlockRead(PhysPt pt, void *data, Bitu size);
 void MEM_BlockCopy(PhysPt dest, PhysPt src, Bitu size);
+void MEM_BlockFill(PhysPt pt, uint8_t value, size_t size);
 void MEM_StrCopy(PhysPt pt, char *data, Bitu size);
 
 void mem_memcpy(PhysPt dest, PhysPt src, Bitu size);
@@ -1101,6 +1101,8 @@ public:
 							                 ptrAddr->port));
 						}
 					}
+					WriteOut("\nPackets received: %u per second\n",
+					         IPX_GetServerPacketRate());
 					WriteOut("\n");
 				}
 				return;
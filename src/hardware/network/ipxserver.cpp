@@ -7,8 +7,11 @@
 
 #include <atomic>
 #include <chrono>
+#include <deque>
+#include <memory>
 #include <optional>
 #include <thread>
+#include <vector>
 
 #ifndef ASIO_STANDALONE
 #define ASIO_STANDALONE
@@ -32,6 +35,29 @@ static IPaddress ipconn[SOCKETTABLESIZE]; // Active TCP/IP connection
 static std::thread ipx_server_thread;
 static std::atomic_bool ipx_server_running = false;
 
+// Packets waiting to be sent to each client. A packet relayed to several
+// clients is shared between their queues rather than copied. Only the
+// server thread touches the queues, and each has at most one send in
+// flight, so a slow or unreachable client never holds up the others.
+using SharedPacket = std::shared_ptr<const std::vector<uint8_t>>;
+
+struct ClientSendQueue {
+	std::deque<SharedPacket> packets = {};
+	bool is_sending                  = false;
+};
+
+static ClientSendQueue send_queues[SOCKETTABLESIZE];
+
+// Beyond this the client is not keeping up; newer packets are dropped
+constexpr size_t MaxQueuedPackets = 256;
+
+static uint64_t num_dropped_packets = 0;
+
+// Packets received per second, measured over the last full second
+static std::atomic<uint32_t> packet_rate         = 0;
+static std::atomic<int64_t> packet_rate_start_ms = 0;
+static uint32_t num_packets_this_second          = 0;
+
 static void ipx_server_arm_receive();
 
 static asio::ip::udp::endpoint to_endpoint(const IPaddress& addr)
@@ -58,6 +84,47 @@ uint8_t packetCRC(uint8_t* buffer, uint16_t bufSize)
 	return tmpCRC;
 }
 
+static void send_next_packet(const uint16_t client)
+{
+	auto& queue = send_queues[client];
+	if (queue.is_sending || queue.packets.empty() || !ipx_server_socket) {
+		return;
+	}
+	queue.is_sending = true;
+
+	const auto packet = queue.packets.front();
+	ipx_server_socket->async_send_to(
+	        asio::buffer(*packet),
+	        to_endpoint(ipconn[client]),
+	        [client, packet](const std::error_code& ec, const std::size_t) {
+		        auto& queue      = send_queues[client];
+		        queue.is_sending = false;
+
+		        if (!ipx_server_running || ec == asio::error::operation_aborted) {
+			        return;
+		        }
+		        if (ec) {
+			        LOG_MSG("IPXSERVER: send failed: %s",
+			                ec.message().c_str());
+		        }
+		        if (!queue.packets.empty()) {
+			        queue.packets.pop_front();
+		        }
+		        send_next_packet(client);
+	        });
+}
+
+static void queue_packet(const uint16_t client, const SharedPacket& packet)
+{
+	auto& queue = send_queues[client];
+	if (queue.packets.size() >= MaxQueuedPackets) {
+		++num_dropped_packets;
+		return;
+	}
+	queue.packets.push_back(packet);
+	send_next_packet(client);
+}
+
 static void sendIPXPacket(uint8_t *buffer, int16_t bufSize) {
 	uint16_t srcport, destport;
 	uint32_t srchost, desthost;
@@ -70,23 +137,16 @@ static void sendIPXPacket(uint8_t *buffer, int16_t bufSize) {
 	srcport = tmpHeader->src.addr.byIP.port;
 	destport = tmpHeader->dest.addr.byIP.port;
 
+	// One copy for all the recipients; the receive buffer is reused
+	// before the sends complete
+	const auto packet = std::make_shared<const std::vector<uint8_t>>(buffer,
+	                                                                 buffer + bufSize);
+
 	if(desthost == 0xffffffff) {
 		// Broadcast
 		for (uint16_t i = 0; i < SOCKETTABLESIZE; ++i) {
 			if(connBuffer[i].connected && ((ipconn[i].host != srchost)||(ipconn[i].port!=srcport))) {
-				if (!ipx_server_socket) {
-					continue;
-				}
-				std::error_code ec;
-				ipx_server_socket->send_to(asio::buffer(buffer, bufSize),
-				                           to_endpoint(ipconn[i]),
-				                           0,
-				                           ec);
-				if (ec) {
-					LOG_MSG("IPXSERVER: send failed: %s",
-					        ec.message().c_str());
-					continue;
-				}
+				queue_packet(i, packet);
 				//LOG_MSG("IPXSERVER: Packet of %d bytes sent from %d.%d.%d.%d to %d.%d.%d.%d (BROADCAST) (%x CRC)", bufSize, CONVIP(srchost), CONVIP(ipconn[i].host), packetCRC(&buffer[30], bufSize-30));
 			}
 		}
@@ -94,25 +154,34 @@ static void sendIPXPacket(uint8_t *buffer, int16_t bufSize) {
 		// Specific address
 		for (uint16_t i = 0; i < SOCKETTABLESIZE; ++i) {
 			if((connBuffer[i].connected) && (ipconn[i].host == desthost) && (ipconn[i].port == destport)) {
-				if (!ipx_server_socket) {
-					continue;
-				}
-				std::error_code ec;
-				ipx_server_socket->send_to(asio::buffer(buffer, bufSize),
-				                           to_endpoint(ipconn[i]),
-				                           0,
-				                           ec);
-				if (ec) {
-					LOG_MSG("IPXSERVER: send failed: %s",
-					        ec.message().c_str());
-					continue;
-				}
+				queue_packet(i, packet);
 				//LOG_MSG("IPXSERVER: Packet sent from %d.%d.%d.%d to %d.%d.%d.%d", CONVIP(srchost), CONVIP(desthost));
 			}
 		}
 	}
 }
 
+static void count_packet()
+{
+	const auto now = GetTicks();
+	if (now - packet_rate_start_ms >= 1000) {
+		packet_rate          = num_packets_this_second;
+		packet_rate_start_ms = now;
+
+		num_packets_this_second = 0;
+	}
+	++num_packets_this_second;
+}
+
+uint32_t IPX_GetServerPacketRate()
+{
+	// Nothing has arrived for a while
+	if (GetTicks() - packet_rate_start_ms >= 2000) {
+		return 0;
+	}
+	return packet_rate;
+}
+
 bool IPX_isConnectedToServer(Bits tableNum, IPaddress ** ptrAddr) {
 	if(tableNum >= SOCKETTABLESIZE) return false;
 	*ptrAddr = &ipconn[tableNum];
@@ -159,6 +228,7 @@ static void IPX_ServerHandlePacket(const IPaddress& sender_addr, const size_t pa
 	if (packet_len > IPXBUFFERSIZE) {
 		return;
 	}
+	count_packet();
 
 	// Check to see if incoming packet is a registration packet
 	// For this, I just spoofed the echo protocol packet designation 0x02
@@ -251,6 +321,16 @@ void IPX_StopServer()
 	if (ipx_server_thread.joinable()) {
 		ipx_server_thread.join();
 	}
+
+	for (auto& queue : send_queues) {
+		queue = {};
+	}
+	if (num_dropped_packets) {
+		LOG_WARNING("IPXSERVER: Dropped %llu packets for clients that could not keep up",
+		            static_cast<unsigned long long>(num_dropped_packets));
+		num_dropped_packets = 0;
+	}
+	packet_rate = 0;
 }
 
 bool IPX_StartServer(uint16_t portnum)
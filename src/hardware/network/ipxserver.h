@@ -28,6 +28,9 @@ void IPX_StopServer();
 bool IPX_StartServer(uint16_t portnum);
 bool IPX_isConnectedToServer(Bits tableNum, IPaddress ** ptrAddr);
 
+// Packets per second the server has received from its clients recently
+uint32_t IPX_GetServerPacketRate();
+
 uint8_t packetCRC(uint8_t *buffer, uint16_t bufSize);
 
 #endif // DOSBOX_IPXSERVER_H_
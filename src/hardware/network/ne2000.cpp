@@ -95,6 +95,7 @@ bx_ne2k_c::reset(unsigned type)
   s.RSR = bx_ne2k_t::RSR_t{};
 
   BX_NE2K_THIS s.tx_timer_active = 0;
+  tx_batch.clear();
   BX_NE2K_THIS s.local_dma  = 0;
   BX_NE2K_THIS s.page_start = 0;
   BX_NE2K_THIS s.page_stop  = 0;
@@ -229,30 +230,43 @@ bx_ne2k_c::write_cr(io_val_t data)
       printf("");
 #endif
 
-      // If a scheduled transmission is still queued, then
-      // send it now to ensure order is maintained.
-      if (BX_NE2K_THIS s.tx_timer_active) {
-	      PIC_RemoveEvents(NE2000_TX_Event);
-	      NE2000_TX_Event(0);
-	      LOG_MSG("NE2000: Preemptive transmit to retain packet order");
+      const auto frame = &s.mem[s.tx_page_start * 256 - BX_NE2K_MEMSTART];
+
+      if (tx_coalescing) {
+        // Join the batch of the pending completion, if any
+        tx_batch.emplace_back(frame, frame + s.tx_bytes);
+        if (!s.tx_timer_active) {
+          s.tx_timer_active = 1;
+          const auto tx_bits = 64 + 96 + 4 * 8 + s.tx_bytes * 8;
+          const auto tx_usec = tx_bits / (100 * 1000.0);
+          PIC_AddEvent(NE2000_TX_Event, tx_usec, 0);
+        }
+      } else {
+        // If a scheduled transmission is still queued, then
+        // send it now to ensure order is maintained.
+        if (BX_NE2K_THIS s.tx_timer_active) {
+          PIC_RemoveEvents(NE2000_TX_Event);
+          NE2000_TX_Event(0);
+          LOG_MSG("NE2000: Preemptive transmit to retain packet order");
+        }
+
+        // Send the packet to the system driver
+        // BX_NE2K_THIS ethdev->sendpkt(& BX_NE2K_THIS s.mem[BX_NE2K_THIS
+        // s.tx_page_start*256 - BX_NE2K_MEMSTART], BX_NE2K_THIS s.tx_bytes);
+        ethernet->SendPacket(frame, s.tx_bytes);
+        // s.tx_timer_index = (64 + 96 + 4*8 + BX_NE2K_THIS s.tx_bytes*8)/10;
+        s.tx_timer_active = 1;
+
+        // Schedule a timer to trigger a tx-complete interrupt
+        // The number of microseconds is the bit-time / 100.
+        // The bit-time is the preamble+sfd (64 bits), the
+        // inter-frame gap (96 bits), the CRC (4 bytes), and the
+        // the number of bits in the frame (s.tx_bytes * 8).
+        //
+        const auto tx_bits = 64 + 96 + 4 * 8 + s.tx_bytes * 8;
+        const auto tx_usec = tx_bits / (100 * 1000.0);
+        PIC_AddEvent(NE2000_TX_Event, tx_usec, 0);
       }
-
-      // Send the packet to the system driver
-      // BX_NE2K_THIS ethdev->sendpkt(& BX_NE2K_THIS s.mem[BX_NE2K_THIS
-      // s.tx_page_start*256 - BX_NE2K_MEMSTART], BX_NE2K_THIS s.tx_bytes);
-      ethernet->SendPacket(&s.mem[s.tx_page_start * 256 - BX_NE2K_MEMSTART], s.tx_bytes);
-      // s.tx_timer_index = (64 + 96 + 4*8 + BX_NE2K_THIS s.tx_bytes*8)/10;
-      s.tx_timer_active = 1;
-
-      // Schedule a timer to trigger a tx-complete interrupt
-      // The number of microseconds is the bit-time / 100.
-      // The bit-time is the preamble+sfd (64 bits), the
-      // inter-frame gap (96 bits), the CRC (4 bytes), and the
-      // the number of bits in the frame (s.tx_bytes * 8).
-      //
-      const auto tx_bits = 64 + 96 + 4 * 8 + s.tx_bytes * 8;
-      const auto tx_usec = tx_bits / (100 * 1000.0);
-      PIC_AddEvent(NE2000_TX_Event, tx_usec, 0);
     }
 
   // Linux probes for an interrupt by setting up a remote-DMA read
@@ -399,6 +413,83 @@ bx_ne2k_c::asic_read(io_port_t offset, io_width_t io_len)
   return (retval);
 }
 
+//
+// asic_read_block/asic_write_block - the bulk counterparts of the data
+// register accesses above, for drivers that move a whole frame with a
+// single REP INSW/OUTSW. Only transfers whose width matches the DMA word
+// size are handled; anything else (and whatever is left over, such as a
+// trailing odd byte or an access outside the buffer memory) goes through
+// asic_read/asic_write one element at a time, which returning fewer than
+// 'count' elements leaves to the caller.
+//
+uint32_t
+bx_ne2k_c::asic_read_block(io_width_t io_len, uint8_t* data, uint32_t count)
+{
+  const unsigned step = BX_NE2K_THIS s.DCR.wdsize + 1u;
+  if (enum_val(io_len) != step)
+    return 0;
+
+  uint32_t num_read = 0;
+  while (num_read < count && BX_NE2K_THIS s.remote_bytes >= step) {
+    const unsigned address = BX_NE2K_THIS s.remote_dma;
+    if ((address < BX_NE2K_MEMSTART) || (address + step > BX_NE2K_MEMEND) ||
+        (address % step))
+      break;
+
+    memcpy(data, &BX_NE2K_THIS s.mem[address - BX_NE2K_MEMSTART], step);
+    data += step;
+    ++num_read;
+
+    BX_NE2K_THIS s.remote_dma += step;
+    if (BX_NE2K_THIS s.remote_dma == BX_NE2K_THIS s.page_stop << 8) {
+      BX_NE2K_THIS s.remote_dma = check_cast<uint16_t>(BX_NE2K_THIS s.page_start << 8);
+    }
+    BX_NE2K_THIS s.remote_bytes -= step;
+  }
+
+  if (num_read && BX_NE2K_THIS s.remote_bytes == 0) {
+    BX_NE2K_THIS s.ISR.rdma_done = 1;
+    if (BX_NE2K_THIS s.IMR.rdma_inte) {
+      PIC_ActivateIRQ(s.base_irq);
+    }
+  }
+  return num_read;
+}
+
+uint32_t
+bx_ne2k_c::asic_write_block(io_width_t io_len, const uint8_t* data, uint32_t count)
+{
+  const unsigned step = BX_NE2K_THIS s.DCR.wdsize + 1u;
+  if (enum_val(io_len) != step)
+    return 0;
+
+  uint32_t num_written = 0;
+  while (num_written < count && BX_NE2K_THIS s.remote_bytes >= step) {
+    const unsigned address = BX_NE2K_THIS s.remote_dma;
+    if ((address < BX_NE2K_MEMSTART) || (address + step > BX_NE2K_MEMEND) ||
+        (address % step))
+      break;
+
+    memcpy(&BX_NE2K_THIS s.mem[address - BX_NE2K_MEMSTART], data, step);
+    data += step;
+    ++num_written;
+
+    BX_NE2K_THIS s.remote_dma += step;
+    if (BX_NE2K_THIS s.remote_dma == BX_NE2K_THIS s.page_stop << 8) {
+      BX_NE2K_THIS s.remote_dma = check_cast<uint16_t>(BX_NE2K_THIS s.page_start << 8);
+    }
+    BX_NE2K_THIS s.remote_bytes -= step;
+  }
+
+  if (num_written && BX_NE2K_THIS s.remote_bytes == 0) {
+    BX_NE2K_THIS s.ISR.rdma_done = 1;
+    if (BX_NE2K_THIS s.IMR.rdma_inte) {
+      PIC_ActivateIRQ(s.base_irq);
+    }
+  }
+  return num_written;
+}
+
 void
 bx_ne2k_c::asic_write(io_port_t offset, io_val_t value, io_width_t io_len)
 {
@@ -1024,6 +1115,9 @@ void
 bx_ne2k_c::tx_timer(void)
 {
   BX_DEBUG(("tx_timer"));
+  if (!tx_batch.empty()) {
+    ethernet->SendPackets(tx_batch);
+  }
   BX_NE2K_THIS s.TSR.tx_ok = 1;
   // Generate an interrupt if not masked and not one in progress
   if (BX_NE2K_THIS s.IMR.tx_inte && !BX_NE2K_THIS s.ISR.pkt_tx) {
@@ -1252,7 +1346,15 @@ int bx_ne2k_c::rx_frame(const void *buf, unsigned io_len)
     return -1;
   }
   // some computers don't care...
-  if (io_len < 60) io_len=60;
+  // Pad runts with zeros rather than reading past the end of the frame
+  uint8_t padded[60];
+  if (io_len < 60) {
+    memset(padded, 0, sizeof(padded));
+    memcpy(padded, buf, io_len);
+    buf = padded;
+    pktbuf = padded;
+    io_len = 60;
+  }
 
   // Do address filtering if not in promiscuous mode
   if (! BX_NE2K_THIS s.RCR.promisc) {
@@ -1405,6 +1507,19 @@ static void NE2000_TX_Event([[maybe_unused]] uint32_t val)
 	theNE2kDevice->tx_timer();
 }
 
+static uint32_t ne2000_data_read_block([[maybe_unused]] io_port_t port,
+                                       io_width_t width, uint8_t* data, uint32_t count)
+{
+	return theNE2kDevice->asic_read_block(width, data, count);
+}
+
+static uint32_t ne2000_data_write_block([[maybe_unused]] io_port_t port,
+                                        io_width_t width, const uint8_t* data,
+                                        uint32_t count)
+{
+	return theNE2kDevice->asic_write_block(width, data, count);
+}
+
 static void NE2000_Poller(void) {
 	ethernet->GetPackets([](const uint8_t *packet, int len) {
 		//LOG_MSG("NE2000: Received %d bytes", header->len);
@@ -1424,6 +1539,9 @@ private:
 	IO_ReadHandleObject ReadHandler16[0x10];
 	IO_WriteHandleObject WriteHandler16[0x10];
 
+	// Data register, served in bulk for REP INSW/OUTSW
+	io_port_t data_port = 0;
+
 public:
 	bool load_success;
 	NE2K(SectionProp& section) : load_success(true)
@@ -1490,6 +1608,7 @@ public:
 
 		theNE2kDevice->s.base_address = base;
 		theNE2kDevice->s.base_irq = irq;
+		theNE2kDevice->tx_coalescing = section.GetBool("tx_coalescing");
 
 		theNE2kDevice->init();
 
@@ -1499,10 +1618,18 @@ public:
 			ReadHandler8[i].Install(port_num, dosbox_read, io_width_t::word);
 			WriteHandler8[i].Install(port_num, dosbox_write, io_width_t::word);
 		}
+		data_port = static_cast<io_port_t>(theNE2kDevice->s.base_address + 0x10);
+		IO_RegisterBlockReadHandler(data_port, ne2000_data_read_block);
+		IO_RegisterBlockWriteHandler(data_port, ne2000_data_write_block);
+
 		TIMER_AddTickHandler(NE2000_Poller);
 	}
 
 	~NE2K() {
+		if (data_port) {
+			IO_FreeBlockReadHandler(data_port);
+			IO_FreeBlockWriteHandler(data_port);
+		}
 		delete ethernet;
 		ethernet = nullptr;
 		delete theNE2kDevice;
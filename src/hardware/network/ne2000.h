@@ -15,6 +15,7 @@
 #include "dosbox.h"
 
 #include <string>
+#include <vector>
 
 #include "config/setup.h"
 #include "hardware/port.h"
@@ -191,6 +192,11 @@ public:
 public:
 	bx_ne2k_t s = {};
 
+	// Frames started while a transmit completion is pending are collected
+	// here and sent, and completed, together with it
+	bool tx_coalescing = false;
+	std::vector<std::vector<uint8_t>> tx_batch = {};
+
   /* TODO: Setup SDL */
   //eth_pktmover_c *ethdev;
 
@@ -211,6 +217,11 @@ public:
 	BX_NE2K_SMF void page2_write(io_port_t address, io_val_t value, io_width_t io_len);
 	BX_NE2K_SMF void page3_write(io_port_t address, io_val_t value, io_width_t io_len);
 
+	// REP INSW/OUTSW on the data port, moved straight between the guest
+	// and the buffer memory. They return the number of elements moved.
+	BX_NE2K_SMF uint32_t asic_read_block(io_width_t io_len, uint8_t* data, uint32_t count);
+	BX_NE2K_SMF uint32_t asic_write_block(io_width_t io_len, const uint8_t* data, uint32_t count);
+
 public:
   static void tx_timer_handler(void *);
   BX_NE2K_SMF void tx_timer(void);
@@ -4,13 +4,19 @@
 
 #include "pic.h"
 
+#include <algorithm>
+#include <array>
 #include <memory>
+#include <vector>
 
 #include "cpu/callback.h"
 #include "cpu/cpu.h"
 #include "hardware/pic.h"
 #include "hardware/port.h"
+#include "hardware/snapshot.h"
 #include "hardware/timer.h"
+#include "misc/metrics.h"
+#include "misc/tracing.h"
 
 // PIC Controllers
 // ~~~~~~~~~~~~~~~
@@ -26,7 +32,8 @@
 // "master-slave" relationship, which is misleading given that fact that the
 // primary has no control over the secondary.
 
-#define PIC_QUEUESIZE 512
+// Initial capacity of the event queue; it grows as needed
+constexpr size_t InitialEventQueueCapacity = 512;
 
 struct PIC_Controller {
 	Bitu icw_words;
@@ -123,6 +130,7 @@ static PIC_Controller pics[2];
 static PIC_Controller &primary_controller = pics[0];
 static PIC_Controller &secondary_controller = pics[1];
 uint32_t PIC_Ticks = 0;
+PicTime PIC_TickStartTime = 0;
 uint32_t PIC_IRQCheck = 0; // x86 dynamic core expects a 32 bit variable size
 std::atomic<double> atomic_pic_index = 0.0;
 
@@ -181,17 +189,35 @@ void PIC_Controller::start_irq(uint8_t val) {
 
 
 struct PICEntry {
-	double index;
-	Bitu value;
-	PIC_EventHandler pic_event;
-	PICEntry * next;
+	PicTime time = 0;
+
+	// Breaks ties between events due at the same time so they run in
+	// the order they were added
+	uint64_t sequence = 0;
+
+	uint32_t value = 0;
+
+	PIC_EventHandler pic_event = nullptr;
 };
 
+// Orders the queue as a min-heap on the event time
+static bool is_later(const PICEntry& a, const PICEntry& b)
+{
+	if (a.time != b.time) {
+		return a.time > b.time;
+	}
+	return a.sequence > b.sequence;
+}
+
 static struct {
-	PICEntry entries[PIC_QUEUESIZE];
-	PICEntry * free_entry;
-	PICEntry * next_entry;
-} pic_queue;
+	// Binary heap of pending events, the next one due is at the front
+	std::vector<PICEntry> entries = {};
+
+	uint64_t next_sequence = 0;
+
+	// Debug counter of the deepest the queue has been
+	size_t peak_depth = 0;
+} pic_queue = {};
 
 static void write_command(io_port_t port, io_val_t value, io_width_t)
 {
@@ -423,107 +449,77 @@ void PIC_SetIRQMask(uint32_t irq, bool masked)
 	pic->set_imr(newmask);
 }
 
-static void AddEntry(PICEntry * entry) {
-	PICEntry * find_entry=pic_queue.next_entry;
-	if (find_entry == nullptr) {
-		entry->next=nullptr;
-		pic_queue.next_entry=entry;
-	} else if (find_entry->index > entry->index) {
-		pic_queue.next_entry=entry;
-		entry->next=find_entry;
-	} else {
-		while (find_entry) {
-			if (find_entry->next) {
-				/* See if the next index comes later than this
-				 * one */
-				if (find_entry->next->index > entry->index) {
-					entry->next      = find_entry->next;
-					find_entry->next = entry;
-					break;
-				} else {
-					find_entry = find_entry->next;
-				}
-			} else {
-				entry->next      = find_entry->next;
-				find_entry->next = entry;
-				break;
-			}
-		}
+// Returns the number of cycles from the current position in the tick until
+// the given time; at least the rest of the tick if the time is beyond it
+static int32_t cycles_until(const PicTime time)
+{
+	const auto index_nd = PIC_TickIndexND();
+	const auto offset   = time - PIC_TickStartTime;
+
+	if (offset > PicTimePerMs) {
+		return CPU_CycleMax - index_nd;
 	}
-	Bits cycles=PIC_MakeCycles(pic_queue.next_entry->index-PIC_TickIndex());
+	const auto cycles = offset * CPU_CycleMax / PicTimePerMs;
+	return static_cast<int32_t>(cycles) - index_nd;
+}
+
+static void AddEntry(const PICEntry& entry)
+{
+	auto& entries = pic_queue.entries;
+
+	entries.push_back(entry);
+	std::push_heap(entries.begin(), entries.end(), is_later);
+
+	pic_queue.peak_depth = std::max(pic_queue.peak_depth, entries.size());
+
+	const auto cycles = cycles_until(entries.front().time);
 	if (cycles<CPU_Cycles) {
 		CPU_CycleLeft+=CPU_Cycles;
 		CPU_Cycles=0;
 	}
 }
 static bool InEventService = false;
-static double srv_lag = 0.0;
+static PicTime srv_lag = 0;
 
 void PIC_AddEvent(PIC_EventHandler handler, double delay, uint32_t val)
 {
-	if (!pic_queue.free_entry) {
-		LOG(LOG_PIC,LOG_ERROR)("Event queue full");
-		return;
-	}
-	PICEntry * entry=pic_queue.free_entry;
-	if(InEventService) entry->index = delay + srv_lag;
-	else entry->index = delay + PIC_TickIndex();
+	PICEntry entry = {};
 
-	entry->pic_event=handler;
-	entry->value=val;
-	pic_queue.free_entry=pic_queue.free_entry->next;
+	// Events added by event handlers are relative to the time the handler
+	// was due, so periodic events don't drift
+	entry.time = PIC_MsToTime(delay) + (InEventService ? srv_lag : PIC_FullTime());
+
+	entry.sequence  = pic_queue.next_sequence++;
+	entry.pic_event = handler;
+	entry.value     = val;
 	AddEntry(entry);
 }
 
-void PIC_RemoveSpecificEvents(PIC_EventHandler handler, uint32_t val)
+template <typename Predicate>
+static void remove_events_if(Predicate predicate)
 {
-	PICEntry *entry = pic_queue.next_entry;
-	PICEntry *prev_entry;
-	prev_entry = nullptr;
-	while (entry) {
-		if ((entry->pic_event == handler) && (entry->value == val)) {
-			if (prev_entry) {
-				prev_entry->next=entry->next;
-				entry->next=pic_queue.free_entry;
-				pic_queue.free_entry=entry;
-				entry=prev_entry->next;
-				continue;
-			} else {
-				pic_queue.next_entry=entry->next;
-				entry->next=pic_queue.free_entry;
-				pic_queue.free_entry=entry;
-				entry=pic_queue.next_entry;
-				continue;
-			}
-		}
-		prev_entry=entry;
-		entry=entry->next;
+	auto& entries = pic_queue.entries;
+
+	const auto it = std::remove_if(entries.begin(), entries.end(), predicate);
+	if (it == entries.end()) {
+		return;
 	}
+	entries.erase(it, entries.end());
+	std::make_heap(entries.begin(), entries.end(), is_later);
 }
 
-void PIC_RemoveEvents(PIC_EventHandler handler) {
-	PICEntry * entry=pic_queue.next_entry;
-	PICEntry * prev_entry;
-	prev_entry=nullptr;
-	while (entry) {
-		if (entry->pic_event == handler) {
-			if (prev_entry) {
-				prev_entry->next=entry->next;
-				entry->next=pic_queue.free_entry;
-				pic_queue.free_entry=entry;
-				entry=prev_entry->next;
-				continue;
-			} else {
-				pic_queue.next_entry=entry->next;
-				entry->next=pic_queue.free_entry;
-				pic_queue.free_entry=entry;
-				entry=pic_queue.next_entry;
-				continue;
-			}
-		}
-		prev_entry=entry;
-		entry=entry->next;
-	}
+void PIC_RemoveSpecificEvents(PIC_EventHandler handler, uint32_t val)
+{
+	remove_events_if([=](const PICEntry& entry) {
+		return entry.pic_event == handler && entry.value == val;
+	});
+}
+
+void PIC_RemoveEvents(PIC_EventHandler handler)
+{
+	remove_events_if([=](const PICEntry& entry) {
+		return entry.pic_event == handler;
+	});
 }
 
 
@@ -537,29 +533,41 @@ bool PIC_RunQueue(void) {
 		return false;
 	}
 
-	const auto index_nd_f = static_cast<double>(PIC_TickIndexND());
+	const auto index_nd = static_cast<PicTime>(PIC_TickIndexND());
+
+	// Due if the event's time is no later than the current position in
+	// the tick, compared in cycles without any rounding
+	auto is_due = [&](const PICEntry& entry) {
+		const auto offset = entry.time - PIC_TickStartTime;
+		return offset <= PicTimePerMs &&
+		       offset * CPU_CycleMax <= index_nd * PicTimePerMs;
+	};
+
+	static auto& num_events = METRICS_Counter("dosbox_pic_events_total",
+	                                          "PIC timer events serviced");
 
 	/* Check the queue for an entry */
 	InEventService = true;
-	while (pic_queue.next_entry &&
-	       (pic_queue.next_entry->index * static_cast<double>(CPU_CycleMax) <= index_nd_f)) {
-		PICEntry *entry = pic_queue.next_entry;
-		pic_queue.next_entry = entry->next;
+	auto& entries = pic_queue.entries;
+	while (!entries.empty() && is_due(entries.front())) {
+		// Take the entry off the queue first as the handler is free to
+		// add and remove events
+		std::pop_heap(entries.begin(), entries.end(), is_later);
+		const auto entry = entries.back();
+		entries.pop_back();
 
-		srv_lag = entry->index;
-		(entry->pic_event)(entry->value); // call the event handler
+		srv_lag = entry.time;
 
-		/* Put the entry in the free list */
-		entry->next=pic_queue.free_entry;
-		pic_queue.free_entry=entry;
+		TRACE_SCOPE("PIC event");
+		(entry.pic_event)(entry.value); // call the event handler
+
+		num_events.Add();
 	}
 	InEventService = false;
 
 	/* Check when to set the new cycle end */
-	if (pic_queue.next_entry) {
-		auto cycles = static_cast<int32_t>(
-		        pic_queue.next_entry->index * static_cast<double>(CPU_CycleMax) -
-		        index_nd_f);
+	if (!entries.empty()) {
+		auto cycles = cycles_until(entries.front().time);
 		if (!cycles) {
 			cycles = 1;
 		}
@@ -609,12 +617,8 @@ void TIMER_AddTick(void) {
 	CPU_CycleLeft=CPU_CycleMax;
 	CPU_Cycles=0;
 	PIC_Ticks++;
-	/* Go through the list of scheduled events and lower their index with 1000 */
-	PICEntry * entry=pic_queue.next_entry;
-	while (entry) {
-		entry->index -= 1.0f;
-		entry=entry->next;
-	}
+	// The events are scheduled at absolute times, so they stay in place
+	PIC_TickStartTime += PicTimePerMs;
 	/* Call our list of ticker handlers */
 	TickerBlock * ticker=firstticker;
 	while (ticker) {
@@ -635,6 +639,7 @@ public:
 		/* Setup pic0 and pic1 with initial values like DOS has normally */
 		PIC_IRQCheck = 0;
 		PIC_Ticks = 0;
+		PIC_TickStartTime = 0;
 		Bitu i;
 		for (i=0;i<2;i++) {
 			pics[i].auto_eoi=false;
@@ -678,15 +683,17 @@ public:
 		WriteHandler[2].Install(0xa0, write_command, io_width_t::byte);
 		WriteHandler[3].Install(0xa1, write_data, io_width_t::byte);
 		/* Initialize the pic queue */
-		for (i=0;i<PIC_QUEUESIZE-1;i++) {
-			pic_queue.entries[i].next=&pic_queue.entries[i+1];
-		}
-		pic_queue.entries[PIC_QUEUESIZE-1].next=nullptr;
-		pic_queue.free_entry=&pic_queue.entries[0];
-		pic_queue.next_entry=nullptr;
+		pic_queue.entries.clear();
+		pic_queue.entries.reserve(InitialEventQueueCapacity);
+		pic_queue.next_sequence = 0;
+		pic_queue.peak_depth    = 0;
 	}
 
-	~PIC_8259A() = default;
+	~PIC_8259A()
+	{
+		LOG_DEBUG("PIC: Event queue peaked at %zu entries",
+		          pic_queue.peak_depth);
+	}
 };
 
 static std::unique_ptr<PIC_8259A> pic = {};
@@ -694,6 +701,24 @@ static std::unique_ptr<PIC_8259A> pic = {};
 void PIC_Init()
 {
 	pic = std::make_unique<PIC_8259A>();
+
+	SNAPSHOT_AddComponent("pic", [] {
+		const auto controllers = std::to_array(pics);
+		const auto queue       = pic_queue;
+		const auto ticks       = PIC_Ticks;
+		const auto tick_start  = PIC_TickStartTime;
+		const auto irq_check   = PIC_IRQCheck;
+		const auto lag         = srv_lag;
+
+		return [=] {
+			std::copy(controllers.begin(), controllers.end(), pics);
+			pic_queue         = queue;
+			PIC_Ticks         = ticks;
+			PIC_TickStartTime = tick_start;
+			PIC_IRQCheck      = irq_check;
+			srv_lag           = lag;
+		};
+	});
 }
 
 void PIC_Destroy()
@@ -25,6 +25,18 @@ extern uint32_t PIC_Ticks;
 
 extern std::atomic<double> atomic_pic_index;
 
+// Emulated time as a 64-bit integer count of picoseconds since starting
+// DOSBox, the master time base of the event queue. Unlike the floating-point
+// millisecond indexes, it doesn't lose precision as the session gets longer,
+// and adding up periods can't drift by more than a picosecond each. Holds
+// ~106 days before overflowing.
+using PicTime = int64_t;
+
+constexpr PicTime PicTimePerMs = 1'000'000'000;
+
+// Time at the start of the current "millisecond tick"
+extern PicTime PIC_TickStartTime;
+
 // The number of cycles not done yet (ND)
 static inline int32_t PIC_TickIndexND()
 {
@@ -50,6 +62,23 @@ static inline double PIC_FullIndex()
 	return static_cast<double>(PIC_Ticks) + PIC_TickIndex();
 }
 
+static inline PicTime PIC_MsToTime(const double ms)
+{
+	return std::llround(ms * static_cast<double>(PicTimePerMs));
+}
+
+static inline double PIC_TimeToMs(const PicTime time)
+{
+	return static_cast<double>(time) / static_cast<double>(PicTimePerMs);
+}
+
+// Integer counterpart of PIC_FullIndex()
+static inline PicTime PIC_FullTime()
+{
+	return PIC_TickStartTime +
+	       static_cast<PicTime>(PIC_TickIndexND()) * PicTimePerMs / CPU_CycleMax;
+}
+
 // Thread safe version of PIC_FullIndex()
 // Callers on the main thread should prefer PIC_FullIndex() as it is more precise.
 // I attempted to change this everywhere and had regressions from VGA code for example.
@@ -8,19 +8,15 @@
 #include <cstring>
 #include <limits>
 #include <memory>
-#include <unordered_map>
 
 #include "config/setup.h"
 #include "cpu/callback.h"
 #include "cpu/cpu.h"
 #include "cpu/lazyflags.h"
+#include "gui/mapper.h"
 
 //#define ENABLE_PORTLOG
 
-// type-sized IO handler containers
-extern std::unordered_map<io_port_t, io_read_f> io_read_handlers[io_widths];
-extern std::unordered_map<io_port_t, io_write_f> io_write_handlers[io_widths];
-
 // type-sized IO handler API
 uint8_t read_byte_from_port(const io_port_t port);
 uint16_t read_word_from_port(const io_port_t port);
@@ -28,6 +24,11 @@ uint32_t read_dword_from_port(const io_port_t port);
 void write_byte_to_port(const io_port_t port, const uint8_t val);
 void write_word_to_port(const io_port_t port, const uint16_t val);
 void write_dword_to_port(const io_port_t port, const uint32_t val);
+uint32_t read_block_from_port(const io_port_t port, const io_width_t width,
+                              uint8_t* data, const uint32_t count);
+uint32_t write_block_to_port(const io_port_t port, const io_width_t width,
+                             const uint8_t* data, const uint32_t count);
+void release_port_handlers();
 
 
 struct IOF_Entry {
@@ -87,6 +88,65 @@ inline void IO_USEC_write_delay() {
 	CPU_IODelayRemoved += delaycyc;
 }
 
+// Busy-wait detection. Reading the same value from the same port over and over
+// again without any port writes in between means the guest is polling for a
+// change that can only come from a device event (or the passage of time), so
+// the rest of the current cycle slice is skipped, just like with HLT. The PIC
+// then services the next event straight away.
+constexpr int IdlePollThreshold = 64;
+
+// Reads the device has marked as only changing with an event don't need the
+// long run of repeats to rule out values that change over time
+constexpr int EventBoundIdlePollThreshold = 4;
+
+static struct {
+	bool enabled = false;
+
+	io_port_t port = 0;
+	io_val_t value = 0;
+	int repeats    = 0;
+
+	// Set by the read handler of the current read
+	bool is_event_bound = false;
+} idle_poll = {};
+
+void IO_SetIdlePollDetection(const bool enabled)
+{
+	idle_poll         = {};
+	idle_poll.enabled = enabled;
+}
+
+void IO_MarkReadAsEventBound()
+{
+	idle_poll.is_event_bound = true;
+}
+
+static void check_idle_poll(const io_port_t port, const io_val_t value)
+{
+	const auto is_event_bound = idle_poll.is_event_bound;
+	idle_poll.is_event_bound  = false;
+
+	if (!idle_poll.enabled) {
+		return;
+	}
+	if (port == idle_poll.port && value == idle_poll.value) {
+		const auto threshold = is_event_bound ? EventBoundIdlePollThreshold
+		                                      : IdlePollThreshold;
+		if (++idle_poll.repeats >= threshold) {
+			CPU_SkipIdleCycles();
+		}
+		return;
+	}
+	idle_poll.port    = port;
+	idle_poll.value   = value;
+	idle_poll.repeats = 0;
+}
+
+static void reset_idle_poll()
+{
+	idle_poll.repeats = 0;
+}
+
 #ifdef ENABLE_PORTLOG
 static uint8_t crtc_index = 0;
 
@@ -180,6 +240,7 @@ void IO_WriteB(io_port_t port, uint8_t val)
 	} else {
 		IO_USEC_write_delay();
 		write_byte_to_port(port, val);
+		reset_idle_poll();
 	}
 }
 
@@ -214,6 +275,7 @@ void IO_WriteW(io_port_t port, uint16_t val)
 	} else {
 		IO_USEC_write_delay();
 		write_word_to_port(port, val);
+		reset_idle_poll();
 	}
 }
 
@@ -247,6 +309,7 @@ void IO_WriteD(io_port_t port, uint32_t val)
 		cpudecoder=old_cpudecoder;
 	} else {
 		write_dword_to_port(port, val);
+		reset_idle_poll();
 	}
 }
 
@@ -282,6 +345,7 @@ uint8_t IO_ReadB(io_port_t port)
 	} else {
 		IO_USEC_read_delay();
 		retval = read_byte_from_port(port);
+		check_idle_poll(port, retval);
 	}
 	log_io(io_width_t::byte, false, port, retval);
 	return retval;
@@ -318,6 +382,7 @@ uint16_t IO_ReadW(io_port_t port)
 	} else {
 		IO_USEC_read_delay();
 		retval = read_word_from_port(port);
+		check_idle_poll(port, retval);
 	}
 	log_io(io_width_t::word, false, port, retval);
 	return retval;
@@ -353,37 +418,87 @@ uint32_t IO_ReadD(io_port_t port)
 		cpudecoder=old_cpudecoder;
 	} else {
 		retval = read_dword_from_port(port);
+		check_idle_poll(port, retval);
 	}
 
 	log_io(io_width_t::dword, false, port, retval);
 	return retval;
 }
 
+// The delays are the same as for the elements moved one by one; dword accesses
+// have none
+static void add_block_delay(const io_width_t width, const uint32_t count,
+                            const int32_t micros_k)
+{
+	if (width == io_width_t::dword || count == 0) {
+		return;
+	}
+	auto delaycyc = (CPU_CycleMax / micros_k) * static_cast<int64_t>(count);
+	if (delaycyc > CPU_Cycles) {
+		delaycyc = CPU_Cycles;
+	}
+	CPU_Cycles -= static_cast<int>(delaycyc);
+	CPU_IODelayRemoved += delaycyc;
+}
+
+uint32_t IO_ReadBlock(const io_port_t port, const io_width_t width,
+                      uint8_t* data, const uint32_t count)
+{
+	// Trapped accesses are emulated one by one
+	if (GETFLAG(VM) && CPU_IO_Exception(port, static_cast<uint8_t>(width))) {
+		return 0;
+	}
+	const auto num_read = read_block_from_port(port, width, data, count);
+	add_block_delay(width, num_read, IODELAY_READ_MICROSk);
+	return num_read;
+}
+
+uint32_t IO_WriteBlock(const io_port_t port, const io_width_t width,
+                       const uint8_t* data, const uint32_t count)
+{
+	if (GETFLAG(VM) && CPU_IO_Exception(port, static_cast<uint8_t>(width))) {
+		return 0;
+	}
+	const auto num_written = write_block_to_port(port, width, data, count);
+	add_block_delay(width, num_written, IODELAY_WRITE_MICROSk);
+	if (num_written > 0) {
+		reset_idle_poll();
+	}
+	return num_written;
+}
+
+// Starts the port profiler on the first press and logs its report on the next
+static void toggle_port_profiler(bool pressed)
+{
+	if (!pressed) {
+		return;
+	}
+	if (IO_IsProfilerEnabled()) {
+		IO_LogPortProfile();
+		IO_SetProfilerEnabled(false);
+	} else {
+		IO_SetProfilerEnabled(true);
+		LOG_MSG("IOBUS: Port profiler started; press the hotkey again "
+		        "for the report");
+	}
+}
+
 class IO {
 public:
 	IO()
 	{
 		iof_queue.used = 0;
+
+		MAPPER_AddHandler(toggle_port_profiler,
+		                  SDL_SCANCODE_UNKNOWN,
+		                  0,
+		                  "portprofile",
+		                  "Port Profile");
 	}
 
 	~IO()
 	{
-		[[maybe_unused]] size_t total_bytes = 0u;
-		for (uint8_t i = 0; i < io_widths; ++i) {
-			const auto readers = io_read_handlers[i].size();
-			const auto writers = io_write_handlers[i].size();
-			LOG_DEBUG("IOBUS: Releasing %d read and %d write %d-bit port handlers",
-			          static_cast<int>(readers),
-			          static_cast<int>(writers),
-			          8 << i);
-
-			total_bytes += readers * sizeof(io_read_f) + sizeof(io_read_handlers[i]);
-			total_bytes += writers * sizeof(io_write_f) + sizeof(io_write_handlers[i]);
-			io_read_handlers[i].clear();
-			io_write_handlers[i].clear();
-		}
-		LOG_DEBUG("IOBUS: Handlers consumed %d total bytes",
-		          static_cast<int>(total_bytes));
+		release_port_handlers();
 	}
 };
 
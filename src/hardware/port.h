@@ -8,6 +8,7 @@
 #include "dosbox.h"
 
 #include <functional>
+#include <vector>
 
 using io_port_t = uint16_t; // DOS only supports 16-bit port addresses
 using io_val_t  = uint32_t; // Handling exists up to a dword (or less)
@@ -58,6 +59,58 @@ void IO_FreeWriteHandler(io_port_t port,
                          io_width_t max_width,
                          io_port_t range = 1);
 
+// Block handlers service a whole REP INS or REP OUTS on a port in one call,
+// moving up to 'count' elements of 'width' between the port and 'data' (guest
+// byte order). They return the number of elements moved; anything left over
+// goes through the regular handlers one element at a time. Ports without a
+// block handler always take that path.
+using io_read_block_f = std::function<uint32_t(io_port_t port, io_width_t width,
+                                               uint8_t* data, uint32_t count)>;
+using io_write_block_f = std::function<uint32_t(io_port_t port, io_width_t width,
+                                                const uint8_t* data, uint32_t count)>;
+
+void IO_RegisterBlockReadHandler(io_port_t port, io_read_block_f handler);
+void IO_RegisterBlockWriteHandler(io_port_t port, io_write_block_f handler);
+
+void IO_FreeBlockReadHandler(io_port_t port);
+void IO_FreeBlockWriteHandler(io_port_t port);
+
+// Return the number of elements moved, possibly none
+uint32_t IO_ReadBlock(io_port_t port, io_width_t width, uint8_t* data,
+                      uint32_t count);
+uint32_t IO_WriteBlock(io_port_t port, io_width_t width, const uint8_t* data,
+                       uint32_t count);
+
+// Port access profiler. While enabled, every handler call is counted per
+// port along with the host time spent in it, so busy-wait loops on status
+// ports (such as 0x3da or the Sound Blaster DSP) become visible.
+struct IoPortProfile {
+	io_port_t port = 0;
+
+	uint64_t reads  = 0;
+	uint64_t writes = 0;
+
+	// Host time spent in the port's handlers
+	int64_t read_ns  = 0;
+	int64_t write_ns = 0;
+};
+
+void IO_SetProfilerEnabled(bool enabled);
+bool IO_IsProfilerEnabled();
+
+// Ports that have been accessed since the profiler was enabled, busiest first
+std::vector<IoPortProfile> IO_GetPortProfile();
+
+void IO_LogPortProfile();
+
+// Skip ahead to the next PIC event when the guest busy-waits on a port
+void IO_SetIdlePollDetection(bool enabled);
+
+// Called by read handlers when the value they return can only change with a
+// device event or a port write, e.g., a status register waiting for a reset to
+// finish. Polling such a value is detected after a few reads instead of many.
+void IO_MarkReadAsEventBound();
+
 /* Classes to manage the IO objects created by the various devices.
  * The io objects will remove itself on destruction.*/
 class IO_Base{
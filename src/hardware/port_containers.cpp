@@ -4,11 +4,15 @@
 
 #include "port.h"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cinttypes>
 #include <cstring>
+#include <deque>
 #include <functional>
 #include <limits>
-#include <unordered_map>
+#include <vector>
 
 #include "misc/support.h"
 
@@ -36,74 +40,298 @@ IO_WriteHandleObject::~IO_WriteHandleObject(){
 	// static_cast<uint32_t>(m_port));
 }
 
+// Flat dispatch table for one IO width. Every port holds an index into a pool
+// of installed handlers, so looking up a port is a single array access. All
+// the ports of a range installed together share one pool slot, which is
+// recycled once the last of them is freed.
+//
+// Handlers often install or free other handlers, so the pool is a deque:
+// growing it must not move the handler that's currently running.
+template <typename Handler>
+class IoHandlerTable {
+public:
+	IoHandlerTable() : slots(NumPorts, EmptySlot), pool(1) {}
+
+	const Handler* Find(const io_port_t port) const
+	{
+		const auto slot = slots[port];
+		return slot != EmptySlot ? &pool[slot].handler : nullptr;
+	}
+
+	void Register(io_port_t port, const Handler& handler, io_port_t range)
+	{
+		const auto slot = AllocateSlot(handler);
+		while (range--) {
+			Free(port);
+			slots[port] = slot;
+			++pool[slot].num_ports;
+			++port;
+		}
+		if (pool[slot].num_ports == 0) {
+			ReleaseSlot(slot);
+		}
+	}
+
+	void Free(const io_port_t port)
+	{
+		const auto slot = slots[port];
+		if (slot == EmptySlot) {
+			return;
+		}
+		slots[port] = EmptySlot;
+
+		assert(pool[slot].num_ports > 0);
+		if (--pool[slot].num_ports == 0) {
+			ReleaseSlot(slot);
+		}
+	}
+
+	// Number of ports with an installed handler
+	size_t NumPortsInUse() const
+	{
+		size_t num_ports = 0;
+		for (const auto& entry : pool) {
+			num_ports += entry.num_ports;
+		}
+		return num_ports;
+	}
+
+	size_t NumBytes() const
+	{
+		return slots.size() * sizeof(uint32_t) + pool.size() * sizeof(Entry);
+	}
+
+	void Clear()
+	{
+		std::fill(slots.begin(), slots.end(), EmptySlot);
+		pool.resize(1);
+		free_slots.clear();
+	}
+
+private:
+	static constexpr size_t NumPorts    = UINT16_MAX + 1;
+	static constexpr uint32_t EmptySlot = 0;
+
+	struct Entry {
+		Handler handler  = {};
+		size_t num_ports = 0;
+	};
+
+	uint32_t AllocateSlot(const Handler& handler)
+	{
+		if (free_slots.empty()) {
+			pool.push_back({handler, 0});
+			return check_cast<uint32_t>(pool.size() - 1);
+		}
+		const auto slot = free_slots.back();
+		free_slots.pop_back();
+		pool[slot] = {handler, 0};
+		return slot;
+	}
+
+	// The handler is left in place until the slot is reused, as it may
+	// be the one freeing itself
+	void ReleaseSlot(const uint32_t slot)
+	{
+		free_slots.push_back(slot);
+	}
+
+	std::vector<uint32_t> slots = {};
+
+	// Slot 0 is never used so a zero index marks an empty port
+	std::deque<Entry> pool = {};
+
+	std::vector<uint32_t> free_slots = {};
+};
+
 // type-sized IO handlers
-std::unordered_map<io_port_t, io_read_f> io_read_handlers[io_widths] = {};
-constexpr auto &io_read_byte_handler = io_read_handlers[0];
-constexpr auto &io_read_word_handler = io_read_handlers[1];
-constexpr auto &io_read_dword_handler = io_read_handlers[2];
+static IoHandlerTable<io_read_f> io_read_handlers[io_widths] = {};
+static auto& io_read_byte_handler  = io_read_handlers[0];
+static auto& io_read_word_handler  = io_read_handlers[1];
+static auto& io_read_dword_handler = io_read_handlers[2];
+
+static IoHandlerTable<io_write_f> io_write_handlers[io_widths] = {};
+static auto& io_write_byte_handler  = io_write_handlers[0];
+static auto& io_write_word_handler  = io_write_handlers[1];
+static auto& io_write_dword_handler = io_write_handlers[2];
+
+// Block handlers serve all widths
+static IoHandlerTable<io_read_block_f> io_read_block_handlers   = {};
+static IoHandlerTable<io_write_block_f> io_write_block_handlers = {};
+
+// Unhandled ports read as 0xff and ignore writes. Each is only reported the
+// first time it's accessed.
+static std::vector<bool> warned_unhandled_reads(UINT16_MAX + 1);
+static std::vector<bool> warned_unhandled_writes(UINT16_MAX + 1);
+
+constexpr io_val_t BlockedRead = 0xff;
 
-std::unordered_map<io_port_t, io_write_f> io_write_handlers[io_widths] = {};
-constexpr auto &io_write_byte_handler = io_write_handlers[0];
-constexpr auto &io_write_word_handler = io_write_handlers[1];
-constexpr auto &io_write_dword_handler = io_write_handlers[2];
+// Number of ports listed in the profiler report
+constexpr size_t MaxReportedPorts = 30;
 
-constexpr io_val_t blocked_read(const io_port_t, const io_width_t)
+static struct {
+	bool enabled = false;
+
+	std::vector<IoPortProfile> ports = {};
+
+	std::chrono::steady_clock::time_point started_at = {};
+} port_profiler = {};
+
+static int64_t ns_since(const std::chrono::steady_clock::time_point start)
+{
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(steady_clock::now() - start).count();
+}
+
+static io_val_t call_reader(const io_read_f& reader, const io_port_t port,
+                            const io_width_t width)
+{
+	if (!port_profiler.enabled) {
+		return reader(port, width);
+	}
+	const auto start = std::chrono::steady_clock::now();
+	const auto value = reader(port, width);
+
+	auto& profile = port_profiler.ports[port];
+	++profile.reads;
+	profile.read_ns += ns_since(start);
+	return value;
+}
+
+static void call_writer(const io_write_f& writer, const io_port_t port,
+                        const io_val_t val, const io_width_t width)
 {
-	return 0xff;
+	if (!port_profiler.enabled) {
+		writer(port, val, width);
+		return;
+	}
+	const auto start = std::chrono::steady_clock::now();
+	writer(port, val, width);
+
+	auto& profile = port_profiler.ports[port];
+	++profile.writes;
+	profile.write_ns += ns_since(start);
+}
+
+void IO_SetProfilerEnabled(const bool enabled)
+{
+	if (enabled == port_profiler.enabled) {
+		return;
+	}
+	if (enabled) {
+		port_profiler.ports.assign(UINT16_MAX + 1, {});
+		for (size_t port = 0; port < port_profiler.ports.size(); ++port) {
+			port_profiler.ports[port].port = static_cast<io_port_t>(port);
+		}
+		port_profiler.started_at = std::chrono::steady_clock::now();
+	}
+	port_profiler.enabled = enabled;
+}
+
+bool IO_IsProfilerEnabled()
+{
+	return port_profiler.enabled;
+}
+
+std::vector<IoPortProfile> IO_GetPortProfile()
+{
+	std::vector<IoPortProfile> accessed = {};
+	for (const auto& profile : port_profiler.ports) {
+		if (profile.reads || profile.writes) {
+			accessed.push_back(profile);
+		}
+	}
+	std::sort(accessed.begin(), accessed.end(), [](const auto& a, const auto& b) {
+		return a.reads + a.writes > b.reads + b.writes;
+	});
+	return accessed;
+}
+
+void IO_LogPortProfile()
+{
+	const auto accessed = IO_GetPortProfile();
+	if (accessed.empty()) {
+		LOG_MSG("IOBUS: No port accesses have been profiled");
+		return;
+	}
+
+	const auto elapsed_ms = ns_since(port_profiler.started_at) / 1'000'000;
+	LOG_MSG("IOBUS: Port accesses over the last %" PRId64 " ms, busiest first",
+	        elapsed_ms);
+	LOG_MSG("IOBUS:   port         reads     read us        writes    write us");
+
+	const auto num_reported = std::min(accessed.size(), MaxReportedPorts);
+	for (size_t i = 0; i < num_reported; ++i) {
+		const auto& p = accessed[i];
+		LOG_MSG("IOBUS:   %04Xh  %12" PRIu64 "  %10" PRId64 "  %12" PRIu64
+		        "  %10" PRId64,
+		        p.port,
+		        p.reads,
+		        p.read_ns / 1000,
+		        p.writes,
+		        p.write_ns / 1000);
+	}
 }
 
 // type-sized IO handler API
 uint8_t read_byte_from_port(const io_port_t port)
 {
-	const auto [it, was_blocked] = io_read_byte_handler.try_emplace(port, blocked_read);
-	if (was_blocked)
+	if (const auto reader = io_read_byte_handler.Find(port); reader) {
+		return call_reader(*reader, port, io_width_t::byte) & 0xff;
+	}
+	if (port_profiler.enabled) {
+		++port_profiler.ports[port].reads;
+	}
+	if (!warned_unhandled_reads[port]) {
+		warned_unhandled_reads[port] = true;
 		LOG(LOG_IO, LOG_WARN)("Unhandled read from port %04Xh; blocking", port);
-	return it->second(port, io_width_t::byte) & 0xff;
+	}
+	return BlockedRead;
 }
 
 uint16_t read_word_from_port(const io_port_t port)
 {
-	const auto reader = io_read_word_handler.find(port);
-	const auto value = reader != io_read_word_handler.end()
-	                           ? (reader->second(port, io_width_t::word) & 0xffff)
-	                           : static_cast<io_val_t>(
-	                                     read_byte_from_port(port) |
-	                                     (read_byte_from_port(port + 1) << 8));
+	const auto reader = io_read_word_handler.Find(port);
+	const auto value = reader
+	                         ? (call_reader(*reader, port, io_width_t::word) & 0xffff)
+	                         : static_cast<io_val_t>(
+	                                   read_byte_from_port(port) |
+	                                   (read_byte_from_port(port + 1) << 8));
 	return check_cast<uint16_t>(value);
 }
 
 uint32_t read_dword_from_port(const io_port_t port)
 {
-	const auto reader = io_read_dword_handler.find(port);
-	const auto value = reader != io_read_dword_handler.end()
-	                           ? reader->second(port, io_width_t::dword)
-	                           : static_cast<io_val_t>(
-	                                     read_word_from_port(port) |
-	                                     (read_word_from_port(port + 2) << 16));
+	const auto reader = io_read_dword_handler.Find(port);
+	const auto value = reader ? call_reader(*reader, port, io_width_t::dword)
+	                          : static_cast<io_val_t>(
+	                                    read_word_from_port(port) |
+	                                    (read_word_from_port(port + 2) << 16));
 	assert(value <= UINT32_MAX);
 	return static_cast<uint32_t>(value);
 }
 
-constexpr void blocked_write(const io_port_t, const io_val_t, const io_width_t)
-{
-	// nothing to write to
-}
-
 void write_byte_to_port(const io_port_t port, const uint8_t val)
 {
-	const auto [it, was_blocked] = io_write_byte_handler.try_emplace(port, blocked_write);
-	if (was_blocked)
+	if (const auto writer = io_write_byte_handler.Find(port); writer) {
+		call_writer(*writer, port, val, io_width_t::byte);
+		return;
+	}
+	if (port_profiler.enabled) {
+		++port_profiler.ports[port].writes;
+	}
+	if (!warned_unhandled_writes[port]) {
+		warned_unhandled_writes[port] = true;
 		LOG(LOG_IO, LOG_WARN)("Unhandled write of value 0x%02x"
 		                      " (%u) to port %04Xh; blocking",
 		                      val, val, port);
-	it->second(port, val, io_width_t::byte);
+	}
 }
 
 void write_word_to_port(const io_port_t port, const uint16_t val)
 {
-	const auto writer = io_write_word_handler.find(port);
-	if (writer != io_write_word_handler.end()) {
-		writer->second(port, val, io_width_t::word);
+	if (const auto writer = io_write_word_handler.Find(port); writer) {
+		call_writer(*writer, port, val, io_width_t::word);
 	} else {
 		write_byte_to_port(port, static_cast<uint8_t>(val & 0xff));
 		write_byte_to_port(port + 1, static_cast<uint8_t>(val >> 8));
@@ -112,9 +340,8 @@ void write_word_to_port(const io_port_t port, const uint16_t val)
 
 void write_dword_to_port(const io_port_t port, const uint32_t val)
 {
-	const auto writer = io_write_dword_handler.find(port);
-	if (writer != io_write_dword_handler.end()) {
-		writer->second(port, val, io_width_t::dword);
+	if (const auto writer = io_write_dword_handler.Find(port); writer) {
+		call_writer(*writer, port, val, io_width_t::dword);
 	} else {
 		write_word_to_port(port, static_cast<uint16_t>(val & 0xffff));
 		write_word_to_port(port + 2, static_cast<uint16_t>(val >> 16));
@@ -126,14 +353,11 @@ void IO_RegisterReadHandler(io_port_t port,
                             const io_width_t max_width,
                             io_port_t range)
 {
-	while (range--) {
-		io_read_byte_handler[port] = handler;
-		if (max_width == io_width_t::word || max_width == io_width_t::dword)
-			io_read_word_handler[port] = handler;
-		if (max_width == io_width_t::dword)
-			io_read_dword_handler[port] = handler;
-		++port;
-	}
+	io_read_byte_handler.Register(port, handler, range);
+	if (max_width == io_width_t::word || max_width == io_width_t::dword)
+		io_read_word_handler.Register(port, handler, range);
+	if (max_width == io_width_t::dword)
+		io_read_dword_handler.Register(port, handler, range);
 }
 
 void IO_RegisterWriteHandler(io_port_t port,
@@ -141,14 +365,11 @@ void IO_RegisterWriteHandler(io_port_t port,
                              const io_width_t max_width,
                              io_port_t range)
 {
-	while (range--) {
-		io_write_byte_handler[port] = handler;
-		if (max_width == io_width_t::word || max_width == io_width_t::dword)
-			io_write_word_handler[port] = handler;
-		if (max_width == io_width_t::dword)
-			io_write_dword_handler[port] = handler;
-		++port;
-	}
+	io_write_byte_handler.Register(port, handler, range);
+	if (max_width == io_width_t::word || max_width == io_width_t::dword)
+		io_write_word_handler.Register(port, handler, range);
+	if (max_width == io_width_t::dword)
+		io_write_dword_handler.Register(port, handler, range);
 }
 
 void IO_FreeReadHandler(io_port_t port,
@@ -156,11 +377,11 @@ void IO_FreeReadHandler(io_port_t port,
                         io_port_t range)
 {
 	while (range--) {
-		io_read_byte_handler.erase(port);
+		io_read_byte_handler.Free(port);
 		if (max_width == io_width_t::word || max_width == io_width_t::dword)
-			io_read_word_handler.erase(port);
+			io_read_word_handler.Free(port);
 		if (max_width == io_width_t::dword)
-			io_read_dword_handler.erase(port);
+			io_read_dword_handler.Free(port);
 		++port;
 	}
 }
@@ -170,15 +391,89 @@ void IO_FreeWriteHandler(io_port_t port,
                          io_port_t range)
 {
 	while (range--) {
-		io_write_byte_handler.erase(port);
+		io_write_byte_handler.Free(port);
 		if (width == io_width_t::word || width == io_width_t::dword)
-			io_write_word_handler.erase(port);
+			io_write_word_handler.Free(port);
 		if (width == io_width_t::dword)
-			io_write_dword_handler.erase(port);
+			io_write_dword_handler.Free(port);
 		++port;
 	}
 }
 
+void IO_RegisterBlockReadHandler(const io_port_t port, const io_read_block_f handler)
+{
+	io_read_block_handlers.Register(port, handler, 1);
+}
+
+void IO_RegisterBlockWriteHandler(const io_port_t port, const io_write_block_f handler)
+{
+	io_write_block_handlers.Register(port, handler, 1);
+}
+
+void IO_FreeBlockReadHandler(const io_port_t port)
+{
+	io_read_block_handlers.Free(port);
+}
+
+void IO_FreeBlockWriteHandler(const io_port_t port)
+{
+	io_write_block_handlers.Free(port);
+}
+
+uint32_t read_block_from_port(const io_port_t port, const io_width_t width,
+                              uint8_t* data, const uint32_t count)
+{
+	const auto reader = io_read_block_handlers.Find(port);
+	if (!reader) {
+		return 0;
+	}
+	const auto num_read = (*reader)(port, width, data, count);
+	assert(num_read <= count);
+
+	if (port_profiler.enabled) {
+		port_profiler.ports[port].reads += num_read;
+	}
+	return num_read;
+}
+
+uint32_t write_block_to_port(const io_port_t port, const io_width_t width,
+                             const uint8_t* data, const uint32_t count)
+{
+	const auto writer = io_write_block_handlers.Find(port);
+	if (!writer) {
+		return 0;
+	}
+	const auto num_written = (*writer)(port, width, data, count);
+	assert(num_written <= count);
+
+	if (port_profiler.enabled) {
+		port_profiler.ports[port].writes += num_written;
+	}
+	return num_written;
+}
+
+void release_port_handlers()
+{
+	[[maybe_unused]] size_t total_bytes = 0u;
+	for (uint8_t i = 0; i < io_widths; ++i) {
+		const auto readers = io_read_handlers[i].NumPortsInUse();
+		const auto writers = io_write_handlers[i].NumPortsInUse();
+		LOG_DEBUG("IOBUS: Releasing %d read and %d write %d-bit port handlers",
+		          static_cast<int>(readers),
+		          static_cast<int>(writers),
+		          8 << i);
+
+		total_bytes += io_read_handlers[i].NumBytes();
+		total_bytes += io_write_handlers[i].NumBytes();
+		io_read_handlers[i].Clear();
+		io_write_handlers[i].Clear();
+	}
+	io_read_block_handlers.Clear();
+	io_write_block_handlers.Clear();
+	LOG_DEBUG("IOBUS: Handlers consumed %d total bytes",
+	          static_cast<int>(total_bytes));
+}
+
 void IO_ReadHandleObject::Install(const io_port_t port,
                                   const io_read_f handler,
                                   const io_width_t max_width,
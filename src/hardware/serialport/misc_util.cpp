@@ -550,47 +550,59 @@ bool TCPClientSocket::GetRemoteAddressString(char* buffer)
 	return true;
 }
 
-bool TCPClientSocket::ReceiveArray(uint8_t* data, size_t& n)
+SocketState TCPClientSocket::FillReceiveBuffer()
 {
-	assert(data);
+	constexpr size_t MaxReadAhead = 4096;
+
 	std::error_code ec;
 	const auto available = socket.available(ec);
 	if (ec) {
 		isopen = false;
-		n      = 0;
-		return false;
+		return SocketState::Closed;
 	}
 	if (available == 0) {
-		n = 0;
-		return true;
+		return SocketState::Empty;
 	}
-	const auto to_read = std::min<size_t>(n, available);
-	const auto bytes_read = socket.read_some(asio::buffer(data, to_read), ec);
-	if (ec) {
+	receive_buffer.resize(std::min<size_t>(available, MaxReadAhead));
+	receive_pos = 0;
+
+	const auto bytes_read = socket.read_some(asio::buffer(receive_buffer), ec);
+	if (ec || bytes_read == 0) {
+		receive_buffer.clear();
 		isopen = false;
-		n      = 0;
-		return false;
+		return SocketState::Closed;
 	}
-	n = bytes_read;
+	receive_buffer.resize(bytes_read);
+	return SocketState::Good;
+}
+
+bool TCPClientSocket::ReceiveArray(uint8_t* data, size_t& n)
+{
+	assert(data);
+	if (receive_pos == receive_buffer.size()) {
+		const auto state = FillReceiveBuffer();
+		if (state != SocketState::Good) {
+			n = 0;
+			return state == SocketState::Empty;
+		}
+	}
+	n = std::min(n, receive_buffer.size() - receive_pos);
+	std::copy_n(receive_buffer.begin() + static_cast<std::ptrdiff_t>(receive_pos),
+	            n,
+	            data);
+	receive_pos += n;
 	return true;
 }
 
 SocketState TCPClientSocket::GetcharNonBlock(uint8_t& val)
 {
-	std::error_code ec;
-	const auto available = socket.available(ec);
-	if (ec) {
-		isopen = false;
-		return SocketState::Closed;
-	}
-	if (available == 0) {
-		return SocketState::Empty;
-	}
-	const auto bytes_read = socket.read_some(asio::buffer(&val, 1), ec);
-	if (ec || bytes_read != 1) {
-		isopen = false;
-		return SocketState::Closed;
+	if (receive_pos == receive_buffer.size()) {
+		const auto state = FillReceiveBuffer();
+		if (state != SocketState::Good) {
+			return state;
+		}
 	}
+	val = receive_buffer[receive_pos++];
 	return SocketState::Good;
 }
 
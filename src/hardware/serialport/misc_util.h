@@ -172,11 +172,18 @@ public:
 	bool GetRemoteAddressString(char* buffer) override;
 
 private:
+	SocketState FillReceiveBuffer();
+
 	std::shared_ptr<asio::io_context> io = {};
 	asio::ip::tcp::socket socket;
 #ifdef NATIVESOCKETS
 	bool is_inherited_socket = false;
 #endif
+
+	// Everything available is read in one go and handed out from here,
+	// instead of costing two system calls per received byte
+	std::vector<uint8_t> receive_buffer = {};
+	size_t receive_pos                  = 0;
 };
 
 class TCPServerSocket : public NETServerSocket {
@@ -221,6 +221,33 @@ void CSerial::removeEvent(uint16_t type)
 	                         static_cast<Bitu>((type << 2) | port_index));
 }
 
+// Bytes usually arrive back to back, each pushing the timeout out by another
+// few byte times. Instead of removing and re-adding the PIC event for every
+// byte, only the deadline moves; the pending event checks it when it fires
+// and reschedules itself for the rest of the time.
+void CSerial::ArmRxTimeout()
+{
+	rx_timeout_deadline = PIC_FullIndex() + static_cast<double>(bytetime) * 4.0;
+
+	// Only an event that would fire too late (the line got faster) has to
+	// be replaced
+	if (rx_timeout_event_pending && rx_timeout_event_time <= rx_timeout_deadline) {
+		return;
+	}
+	if (rx_timeout_event_pending) {
+		removeEvent(SERIAL_RX_TIMEOUT_EVENT);
+	}
+	rx_timeout_event_pending = true;
+	rx_timeout_event_time    = rx_timeout_deadline;
+	setEvent(SERIAL_RX_TIMEOUT_EVENT, bytetime * 4.0f);
+}
+
+void CSerial::DisarmRxTimeout()
+{
+	// The pending event, if any, finds no deadline and does nothing
+	rx_timeout_deadline = 0.0;
+}
+
 void CSerial::handleEvent(uint16_t type)
 {
 	switch (type) { 
@@ -272,9 +299,23 @@ void CSerial::handleEvent(uint16_t type)
 		breakErrors      = 0;
 		break;
 
-	case SERIAL_RX_TIMEOUT_EVENT:
+	case SERIAL_RX_TIMEOUT_EVENT: {
+		rx_timeout_event_pending = false;
+		if (rx_timeout_deadline <= 0.0) {
+			break;
+		}
+		// The deadline may have moved since the event was scheduled
+		const auto remaining = rx_timeout_deadline - PIC_FullIndex();
+		if (remaining > 0.0001) {
+			rx_timeout_event_pending = true;
+			rx_timeout_event_time    = rx_timeout_deadline;
+			setEvent(SERIAL_RX_TIMEOUT_EVENT, static_cast<float>(remaining));
+			break;
+		}
+		rx_timeout_deadline = 0.0;
 		rise(TIMEOUT_PRIORITY);
 		break;
+	}
 
 	default:
 		handleUpperEvent(type);
@@ -369,9 +410,12 @@ void CSerial::receiveByteEx(uint8_t data, uint8_t error)
 		// Overrun error ;o
 		error |= LSR_OVERRUN_ERROR_MASK;
 	}
-	removeEvent(SERIAL_RX_TIMEOUT_EVENT);
-	if(rxfifo->getUsage()==rx_interrupt_threshold) rise (RX_PRIORITY);
-	else setEvent(SERIAL_RX_TIMEOUT_EVENT,bytetime*4.0f);
+	if (rxfifo->getUsage() == rx_interrupt_threshold) {
+		rise(RX_PRIORITY);
+		DisarmRxTimeout();
+	} else {
+		ArmRxTimeout();
+	}
 
 	if(error) {
 		// A lot of UART chips generate a framing error too when receiving break
@@ -561,8 +605,11 @@ uint32_t CSerial::Read_RHR()
 		clear (TIMEOUT_PRIORITY);
 		// RX int. is cleared if the buffer holds less data than the threshold
 		if(rxfifo->getUsage()<rx_interrupt_threshold)clear(RX_PRIORITY);
-		removeEvent(SERIAL_RX_TIMEOUT_EVENT);
-		if(!rxfifo->isEmpty()) setEvent(SERIAL_RX_TIMEOUT_EVENT,bytetime*4.0f);
+		if (rxfifo->isEmpty()) {
+			DisarmRxTimeout();
+		} else {
+			ArmRxTimeout();
+		}
 		return data;
 	}
 }
@@ -176,6 +176,14 @@ public:
 	void handleEvent(uint16_t type);
 	virtual void handleUpperEvent(uint16_t type) = 0;
 
+	void ArmRxTimeout();
+	void DisarmRxTimeout();
+
+	// PIC time the RX FIFO timeout expires at, 0 when not armed
+	double rx_timeout_deadline    = 0.0;
+	double rx_timeout_event_time  = 0.0;
+	bool rx_timeout_event_pending = false;
+
 	// defines for event type
 #define SERIAL_TX_LOOPBACK_EVENT 0
 #define SERIAL_THR_LOOPBACK_EVENT 1
@@ -889,6 +889,23 @@ void CSerialModem::Echo(uint8_t ch)
 	}
 }
 
+void CSerialModem::TrackEscapeSequence(const uint8_t *data, const size_t len)
+{
+	cmdpause = 0;
+
+	// Only a run of escape characters right after the guard time counts;
+	// any other character ends it, and later ones cannot restart it until
+	// the guard time passes again
+	for (size_t i = 0; i < len; ++i) {
+		if (plusinc >= 1 && plusinc <= 3 && data[i] == reg[MREG_ESCAPE_CHAR]) {
+			plusinc++;
+		} else {
+			plusinc = 0;
+			break;
+		}
+	}
+}
+
 void CSerialModem::Timer2()
 {
 	uint32_t txbuffersize = 0;
@@ -915,54 +932,56 @@ void CSerialModem::Timer2()
 	// Handle incoming data from serial port, read as much as available
 	CSerial::setCTS(true);	// buffer will get 'emptier', new data can be received
 	while (tqueue->inuse()) {
+		if (!commandmode) {
+			// Online: hand the data over in one go; only the escape
+			// sequence needs looking at
+			const auto len = std::min<size_t>(tqueue->inuse(),
+			                                  sizeof(tmpbuf) - txbuffersize);
+			if (len == 0) {
+				break;
+			}
+			tqueue->gets(&tmpbuf[txbuffersize], len);
+			TrackEscapeSequence(&tmpbuf[txbuffersize], len);
+			txbuffersize += static_cast<uint32_t>(len);
+			continue;
+		}
 		const uint8_t txval = tqueue->getb();
-		if (commandmode) {
-			if (cmdpos < 2) {
-				// Ignore everything until we see "AT" sequence.
-				if (cmdpos == 0 && toupper(txval) != 'A') {
-					continue;
-				}
-
-				if (cmdpos == 1 && toupper(txval) != 'T') {
-					Echo(reg[MREG_BACKSPACE_CHAR]);
-					cmdpos = 0;
-					continue;
-				}
-			} else {
-				// Now entering command.
-				if (txval == reg[MREG_BACKSPACE_CHAR]) {
-					if (cmdpos > 2) {
-						Echo(txval);
-						cmdpos--;
-					}
-					continue;
-				}
-
-				if (txval == reg[MREG_LF_CHAR]) {
-					continue; // Real modem doesn't seem to skip this?
-				}
+		if (cmdpos < 2) {
+			// Ignore everything until we see "AT" sequence.
+			if (cmdpos == 0 && toupper(txval) != 'A') {
+				continue;
+			}
 
-				if (txval == reg[MREG_CR_CHAR]) {
+			if (cmdpos == 1 && toupper(txval) != 'T') {
+				Echo(reg[MREG_BACKSPACE_CHAR]);
+				cmdpos = 0;
+				continue;
+			}
+		} else {
+			// Now entering command.
+			if (txval == reg[MREG_BACKSPACE_CHAR]) {
+				if (cmdpos > 2) {
 					Echo(txval);
-					DoCommand();
-					continue;
+					cmdpos--;
 				}
+				continue;
 			}
 
-			if (cmdpos < 99) {
-				Echo(txval);
-				cmdbuf[cmdpos] = txval;
-				cmdpos++;
+			if (txval == reg[MREG_LF_CHAR]) {
+				continue; // Real modem doesn't seem to skip this?
 			}
-		} else {
-			if (plusinc >= 1 && plusinc <= 3 && txval == reg[MREG_ESCAPE_CHAR]) // +
-				plusinc++;
-			else {
-				plusinc = 0;
+
+			if (txval == reg[MREG_CR_CHAR]) {
+				Echo(txval);
+				DoCommand();
+				continue;
 			}
-			cmdpause = 0;
-			tmpbuf[txbuffersize] = txval;
-			txbuffersize++;
+		}
+
+		if (cmdpos < 99) {
+			Echo(txval);
+			cmdbuf[cmdpos] = txval;
+			cmdpos++;
 		}
 	} // while loop
 
@@ -975,10 +994,10 @@ void CSerialModem::Timer2()
 		}
 	}
 
-	// Handle incoming to the serial port
+	// Handle incoming to the serial port; the socket reads ahead, so take
+	// as much as fits, the UART still drains it at the line speed
 	if (!commandmode && clientsocket && rqueue->left()) {
-		size_t usesize = rqueue->left() >= 16 ? 16 : rqueue->left();
-		// size_t usesize = 1;
+		size_t usesize = std::min<size_t>(rqueue->left(), sizeof(tmpbuf));
 		if (!clientsocket->ReceiveArray(tmpbuf, usesize)) {
 			SendRes(ResNOCARRIER);
 			LOG_INFO("SERIAL: No carrier on receive");
@@ -6,6 +6,8 @@
 
 #include "dosbox.h"
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 #include <memory>
 
@@ -93,13 +95,14 @@ public:
 
 		//assert((used + len) <= size);
 		size_t where = pos + used;
+		if (where >= size)
+			where -= size;
 		used += len;
-		while (len--) {
-			if (where >= size)
-				where -= size;
-			//LOG_MSG("+'%x'", *str);
-			data[where++] = *str++;
-		}
+
+		// Copy up to the end of the buffer, then wrap around
+		const auto first = std::min(len, size - where);
+		std::memcpy(&data[where], str, first);
+		std::memcpy(&data[0], str + first, len - first);
 	}
 
 	uint8_t getb()
@@ -133,12 +136,13 @@ public:
 		}
 		// assert(used >= len);
 		used -= len;
-		while (len--) {
-			//LOG_MSG("-%x", data[pos]);
-			*str++ = data[pos];
-			if (++pos >= size)
-				pos -= size;
-		}
+
+		const auto first = std::min(len, size - pos);
+		std::memcpy(str, &data[pos], first);
+		std::memcpy(str + first, &data[0], len - first);
+		pos += len;
+		if (pos >= size)
+			pos -= size;
 	}
 
 private:
@@ -184,6 +188,7 @@ public:
 
 	void Echo(uint8_t ch);
 	void Timer2();
+	void TrackEscapeSequence(const uint8_t *data, const size_t len);
 	void handleUpperEvent(uint16_t type) override;
 
 	void RXBufferEmpty();
@@ -0,0 +1,344 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "hardware/snapshot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <vector>
+
+#include "cpu/paging.h"
+#include "dosbox.h"
+#include "gui/mapper.h"
+#include "hardware/memory.h"
+#include "hardware/timer.h"
+#include "misc/host_memory.h"
+#include "utils/mem_unaligned.h"
+
+struct SnapshotComponent {
+	std::string name                = {};
+	SnapshotCaptureFunction capture = {};
+};
+
+static std::vector<SnapshotComponent> components = {};
+
+// Saving more snapshots folds the oldest one into the next
+constexpr size_t MaxSnapshots = 64;
+
+// RAM pages of a snapshot. The first snapshot holds all the pages except the
+// ones that only hold zeros; the later ones only the pages written to since
+// the previous snapshot.
+struct CompactRam {
+	uint32_t num_pages = 0;
+
+	// Indexes of the stored pages in ascending order, and their contents
+	std::vector<uint32_t> page_indexes = {};
+	std::vector<uint8_t> pages         = {};
+};
+
+struct Snapshot {
+	std::vector<SnapshotRestoreFunction> restore_functions = {};
+
+	// The first snapshot is compacted by a worker after it has been taken
+	std::shared_future<CompactRam> ram = {};
+};
+
+static std::vector<Snapshot> snapshots = {};
+
+void SNAPSHOT_AddComponent(const std::string& name,
+                           const SnapshotCaptureFunction& capture)
+{
+	const auto it = std::find_if(components.begin(),
+	                             components.end(),
+	                             [&](const auto& c) { return c.name == name; });
+	if (it != components.end()) {
+		it->capture = capture;
+	} else {
+		components.push_back({name, capture});
+	}
+}
+
+static bool is_zero_page(const uint8_t* page)
+{
+	return std::all_of(page, page + MemPageSize, [](const uint8_t b) {
+		return b == 0;
+	});
+}
+
+static CompactRam compact_ram(std::vector<uint8_t> ram)
+{
+	CompactRam compact = {};
+
+	compact.num_pages = static_cast<uint32_t>(ram.size() / MemPageSize);
+
+	for (uint32_t page = 0; page < compact.num_pages; ++page) {
+		const auto data = ram.data() + page * MemPageSize;
+		if (is_zero_page(data)) {
+			continue;
+		}
+		compact.page_indexes.push_back(page);
+		compact.pages.insert(compact.pages.end(), data, data + MemPageSize);
+	}
+	return compact;
+}
+
+static void append_page(CompactRam& ram, const uint32_t page, const uint8_t* data)
+{
+	ram.page_indexes.push_back(page);
+	ram.pages.insert(ram.pages.end(), data, data + MemPageSize);
+}
+
+static CompactRam copy_dirty_pages()
+{
+	CompactRam dirty = {};
+
+	dirty.num_pages = MEM_TotalPages();
+
+	for (const auto page : MEM_GetDirtyPages()) {
+		append_page(dirty, page, GetMemBase() + page * MemPageSize);
+	}
+	return dirty;
+}
+
+// The pages of 'later' replace the ones of 'earlier'
+static CompactRam merge_ram(const CompactRam& earlier, const CompactRam& later)
+{
+	CompactRam merged = {};
+
+	merged.num_pages = later.num_pages;
+
+	size_t e = 0;
+	size_t l = 0;
+	while (e < earlier.page_indexes.size() || l < later.page_indexes.size()) {
+		const auto has_earlier = e < earlier.page_indexes.size();
+		const auto has_later   = l < later.page_indexes.size();
+
+		if (has_later && (!has_earlier || later.page_indexes[l] <=
+		                                          earlier.page_indexes[e])) {
+			if (has_earlier &&
+			    earlier.page_indexes[e] == later.page_indexes[l]) {
+				++e;
+			}
+			append_page(merged,
+			            later.page_indexes[l],
+			            later.pages.data() + l * MemPageSize);
+			++l;
+		} else {
+			append_page(merged,
+			            earlier.page_indexes[e],
+			            earlier.pages.data() + e * MemPageSize);
+			++e;
+		}
+	}
+	return merged;
+}
+
+static std::shared_future<CompactRam> make_ready(CompactRam ram)
+{
+	std::promise<CompactRam> promise = {};
+	promise.set_value(std::move(ram));
+	return promise.get_future().share();
+}
+
+static void restore_page(const uint32_t page, const uint8_t* data)
+{
+	const auto dest = GetMemBase() + page * MemPageSize;
+	if (std::memcmp(dest, data, MemPageSize) == 0) {
+		return;
+	}
+
+	// Write pages holding translated code through their handler so the
+	// code is invalidated
+	const auto handler = MEM_GetPageHandler(page);
+	if (handler && (handler->flags & PFLAG_HASCODE)) {
+		for (uint32_t offset = 0; offset < MemPageSize; offset += 4) {
+			handler->writed(page * MemPageSize + offset,
+			                read_unaligned_uint32(data + offset));
+		}
+	} else {
+		std::memcpy(dest, data, MemPageSize);
+	}
+}
+
+static bool restore_ram(const size_t index)
+{
+	const auto num_pages = snapshots.front().ram.get().num_pages;
+	if (num_pages != MEM_TotalPages()) {
+		LOG_WARNING("SNAPSHOT: The memory size has changed, can't restore the snapshot");
+		return false;
+	}
+
+	static const std::vector<uint8_t> zero_page(MemPageSize, 0);
+
+	// The latest version of each page up to the restored snapshot; waits
+	// for the worker if it's still compacting the first one
+	std::vector<const uint8_t*> pages(num_pages, zero_page.data());
+	for (size_t i = 0; i <= index; ++i) {
+		const auto& ram = snapshots[i].ram.get();
+		for (size_t stored = 0; stored < ram.page_indexes.size(); ++stored) {
+			pages[ram.page_indexes[stored]] = ram.pages.data() +
+			                                  stored * MemPageSize;
+		}
+	}
+
+	for (uint32_t page = 0; page < num_pages; ++page) {
+		restore_page(page, pages[page]);
+	}
+	return true;
+}
+
+bool SNAPSHOT_Save()
+{
+	// Without the tracking since the previous snapshot there's nothing to
+	// store the changes relative to
+	if (!mem_tracks_dirty_pages) {
+		SNAPSHOT_Discard();
+	}
+
+	const auto start_us = GetTicksUs();
+
+	Snapshot snapshot = {};
+	for (const auto& component : components) {
+		snapshot.restore_functions.push_back(component.capture());
+	}
+
+	if (snapshots.empty()) {
+		const auto ram_size = MEM_TotalPages() * MemPageSize;
+		std::vector<uint8_t> ram(GetMemBase(), GetMemBase() + ram_size);
+
+		snapshot.ram = std::async(std::launch::async, compact_ram, std::move(ram))
+		                       .share();
+	} else {
+		snapshot.ram = make_ready(copy_dirty_pages());
+	}
+	MEM_StartDirtyTracking();
+
+	snapshots.push_back(std::move(snapshot));
+
+	if (snapshots.size() > MaxSnapshots) {
+		// Folding the oldest snapshot into the next one copies most of
+		// the RAM, so it's left to a worker as well
+		const auto earlier = snapshots[0].ram;
+		const auto later   = snapshots[1].ram;
+
+		snapshots[1].ram = std::async(std::launch::async, [earlier, later] {
+			return merge_ram(earlier.get(), later.get());
+		}).share();
+
+		snapshots.erase(snapshots.begin());
+	}
+
+	LOG_MSG("SNAPSHOT: Saved snapshot %zu in %.2f ms",
+	        snapshots.size(),
+	        static_cast<double>(GetTicksUsSince(start_us)) / 1000.0);
+	return true;
+}
+
+bool SNAPSHOT_Restore()
+{
+	if (snapshots.empty()) {
+		LOG_WARNING("SNAPSHOT: No snapshot has been saved");
+		return false;
+	}
+	return SNAPSHOT_Restore(snapshots.size() - 1);
+}
+
+bool SNAPSHOT_Restore(const size_t index)
+{
+	if (index >= snapshots.size()) {
+		LOG_WARNING("SNAPSHOT: Snapshot %zu doesn't exist", index + 1);
+		return false;
+	}
+
+	const auto start_us = GetTicksUs();
+
+	if (!restore_ram(index)) {
+		return false;
+	}
+	for (const auto& restore : snapshots[index].restore_functions) {
+		restore();
+	}
+	PAGING_ClearTLB();
+
+	// The later snapshots are lost, and the next one is stored relative to
+	// the restored one
+	snapshots.resize(index + 1);
+	MEM_StartDirtyTracking();
+
+	LOG_MSG("SNAPSHOT: Restored snapshot %zu in %.2f ms",
+	        index + 1,
+	        static_cast<double>(GetTicksUsSince(start_us)) / 1000.0);
+	return true;
+}
+
+size_t SNAPSHOT_GetCount()
+{
+	return snapshots.size();
+}
+
+bool SNAPSHOT_IsAvailable()
+{
+	return !snapshots.empty();
+}
+
+void SNAPSHOT_Discard()
+{
+	// Waits for the workers that are still running
+	snapshots.clear();
+
+	MEM_StopDirtyTracking();
+}
+
+static void save_snapshot(const bool pressed)
+{
+	if (pressed) {
+		SNAPSHOT_Save();
+	}
+}
+
+static void restore_snapshot(const bool pressed)
+{
+	if (pressed) {
+		SNAPSHOT_Restore();
+	}
+}
+
+// The RAM still being compacted or merged by a worker isn't counted
+static size_t get_snapshots_size()
+{
+	size_t num_bytes = 0;
+	for (const auto& snapshot : snapshots) {
+		using namespace std::chrono_literals;
+		if (snapshot.ram.wait_for(0s) != std::future_status::ready) {
+			continue;
+		}
+		const auto& ram = snapshot.ram.get();
+		num_bytes += ram.pages.size() +
+		             ram.page_indexes.size() * sizeof(uint32_t);
+	}
+	return num_bytes;
+}
+
+void SNAPSHOT_Init()
+{
+	HOST_MEMORY_AddSubsystem("Snapshots", get_snapshots_size);
+
+	MAPPER_AddHandler(save_snapshot,
+	                  SDL_SCANCODE_UNKNOWN,
+	                  0,
+	                  "savesnapshot",
+	                  "Save Snapshot");
+
+	MAPPER_AddHandler(restore_snapshot,
+	                  SDL_SCANCODE_UNKNOWN,
+	                  0,
+	                  "loadsnapshot",
+	                  "Load Snapshot");
+}
+
+void SNAPSHOT_Destroy()
+{
+	SNAPSHOT_Discard();
+}
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_SNAPSHOT_H
+#define DOSBOX_SNAPSHOT_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+// Machine snapshots.
+//
+// A snapshot holds the guest RAM and the state of every registered
+// component (CPU, FPU, paging, PIC, PIT, DMA, VGA, and the DOS kernel), and
+// can be restored any number of times later in the same session, e.g. to
+// return a kiosk machine to its start screen, to skip the boot of a test, or
+// to rewind a game.
+//
+// Snapshots only live in memory: the captured state includes host pointers
+// (event handlers, memory handlers, the video memory) that are only valid in
+// the running process.
+//
+// The guest RAM is copied when the first snapshot is taken. A worker thread
+// then compacts the copy by dropping the pages that only hold zeros, which is
+// most of the memory of a typical DOS machine. The later snapshots only store
+// the RAM pages written to since the previous one, as found by the memory's
+// dirty page tracking, so they're cheap enough to be taken every second.
+
+// Captures the state of a component and returns the function that puts the
+// captured state back
+using SnapshotRestoreFunction = std::function<void()>;
+using SnapshotCaptureFunction = std::function<SnapshotRestoreFunction()>;
+
+// Registering a component with the name of an existing one replaces it
+void SNAPSHOT_AddComponent(const std::string& name,
+                           const SnapshotCaptureFunction& capture);
+
+// Up to 64 snapshots are kept; saving more merges the oldest two
+bool SNAPSHOT_Save();
+
+// Restores the latest snapshot, or the given one counting from zero for the
+// oldest. The snapshots taken after the restored one are discarded.
+bool SNAPSHOT_Restore();
+bool SNAPSHOT_Restore(const size_t index);
+
+size_t SNAPSHOT_GetCount();
+bool SNAPSHOT_IsAvailable();
+
+// Discards all snapshots and stops the dirty page tracking
+void SNAPSHOT_Discard();
+
+// Adds the hotkeys
+void SNAPSHOT_Init();
+
+// Discards the snapshot, waiting for the worker if it's still running
+void SNAPSHOT_Destroy();
+
+#endif // DOSBOX_SNAPSHOT_H
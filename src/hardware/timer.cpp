@@ -4,6 +4,7 @@
 
 #include "timer.h"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cmath>
@@ -13,6 +14,7 @@
 #include "hardware/memory.h"
 #include "hardware/pic.h"
 #include "hardware/port.h"
+#include "hardware/snapshot.h"
 #include "utils/math_utils.h"
 
 const std::chrono::steady_clock::time_point system_start_time =
@@ -60,9 +62,18 @@ constexpr void bcd_to_decimal(uint16_t& val)
 struct PIT_Block {
 	// The PIT has only 16 bits that are used as frequency
 	// divider, which can represent dividers from 0 to 65535.
-	int count    = 0;
-	double delay = 0.0;
-	double start = 0.0;
+	int count     = 0;
+	double delay  = 0.0;
+	PicTime start = 0;
+
+	// The delay in whole PIT ticks
+	int period_ticks = 1;
+
+	// The ticks elapsed since 'start' at the time of the last read, so
+	// repeated reads in the same emulated cycle can reuse them
+	PicTime cached_time    = -1;
+	PicTime cached_start   = -1;
+	int64_t cached_elapsed = 0;
 
 	uint16_t read_latch  = 0;
 	uint16_t write_latch = 0;
@@ -165,16 +176,43 @@ constexpr int update_channel_delay(PIT_Block& channel)
 	const auto freq_divider = channel.count ? channel.count
 	                                        : (get_max_count(channel) + 1);
 
-	channel.delay = 1000.0 * freq_divider / PIT_TICK_RATE;
+	channel.delay        = 1000.0 * freq_divider / PIT_TICK_RATE;
+	channel.period_ticks = freq_divider;
 	return freq_divider;
 }
 
+// Converts in two steps so the multiplication can't overflow
+static int64_t time_to_pit_ticks(const PicTime time)
+{
+	constexpr PicTime PicTimePerSecond = PicTimePerMs * 1000;
+
+	const auto seconds   = time / PicTimePerSecond;
+	const auto remainder = time % PicTimePerSecond;
+
+	return seconds * PIT_TICK_RATE + remainder * PIT_TICK_RATE / PicTimePerSecond;
+}
+
+// Whole PIT ticks since the channel was started
+static int64_t get_elapsed_ticks(PIT_Block& channel)
+{
+	const auto now = PIC_FullTime();
+
+	// Timing loops poll the counter many times in a row
+	if (now != channel.cached_time || channel.start != channel.cached_start) {
+		channel.cached_time    = now;
+		channel.cached_start   = channel.start;
+		channel.cached_elapsed = time_to_pit_ticks(
+		        std::max(now - channel.start, PicTime{0}));
+	}
+	return channel.cached_elapsed;
+}
+
 static void PIT0_Event(uint32_t /*val*/)
 {
 	PIC_ActivateIRQ(0);
 
 	if (channel_0.mode != PitMode::InterruptOnTerminalCount) {
-		channel_0.start += channel_0.delay;
+		channel_0.start += PIC_MsToTime(channel_0.delay);
 
 		if (channel_0.update_count) {
 			update_channel_delay(channel_0);
@@ -184,31 +222,29 @@ static void PIT0_Event(uint32_t /*val*/)
 	}
 }
 
-static bool counter_output(const PIT_Block& channel)
+static bool counter_output(PIT_Block& channel)
 {
-	auto index = PIC_FullIndex() - channel.start;
+	const auto elapsed = get_elapsed_ticks(channel);
 	switch (channel.mode) {
 	case PitMode::InterruptOnTerminalCount:
 		if (channel.mode_changed) {
 			return false;
 		}
-		return (index > channel.delay);
+		return (elapsed >= channel.period_ticks);
 
 	case PitMode::RateGenerator:
 	case PitMode::RateGeneratorAlias:
 		if (channel.mode_changed) {
 			return true;
 		}
-		index = fmod(index, channel.delay);
-		return index > 0;
+		return (elapsed % channel.period_ticks) > 0;
 
 	case PitMode::SquareWave:
 	case PitMode::SquareWaveAlias:
 		if (channel.mode_changed) {
 			return true;
 		}
-		index = fmod(index, channel.delay);
-		return (index * 2 < channel.delay);
+		return (elapsed % channel.period_ticks) * 2 < channel.period_ticks;
 
 	case PitMode::SoftwareStrobe:
 		// Only low on terminal count
@@ -275,11 +311,11 @@ static void counter_latch(PIT_Block& channel)
 		return;
 	}
 
-	auto elapsed_ms = PIC_FullIndex() - channel.start;
+	auto elapsed = get_elapsed_ticks(channel);
 
-	auto save_read_latch = [&](double latch_time) {
+	auto save_read_latch = [&](const int64_t latch_value) {
 		// Latch is a 16-bit counter, wrap it to ensure it doesn't overflow
-		const auto wrapped = iround(latch_time) % UINT16_MAX;
+		const auto wrapped = latch_value % UINT16_MAX;
 		channel.read_latch = check_cast<uint16_t>(wrapped);
 	};
 
@@ -289,63 +325,53 @@ static void counter_latch(PIT_Block& channel)
 		// TODO figure this out on real hardware
 
 		// Ensure the remaining ticks aren't negative
-		const auto elapsed_ticks   = elapsed_ms * PIT_TICK_RATE_KHZ;
-		const auto remaining_ticks = std::max(0.0,
-		                                      channel.read_latch -
-		                                              elapsed_ticks);
+		const auto remaining_ticks = std::max(int64_t{0},
+		                                      channel.read_latch - elapsed);
 		save_read_latch(remaining_ticks);
 		return;
 	}
 
-	const auto count = static_cast<double>(channel.count);
+	const auto count  = channel.count;
+	const auto period = channel.period_ticks;
 
 	switch (channel.mode) {
 	case PitMode::SoftwareStrobe:
 	case PitMode::InterruptOnTerminalCount:
 		// Counter keeps on counting after passing terminal count
-		if (elapsed_ms > channel.delay) {
-			elapsed_ms -= channel.delay;
+		if (elapsed > period) {
+			elapsed -= period;
 			if (channel.bcd) {
-				elapsed_ms = fmod(elapsed_ms,
-				                  period_of_1k_pit_ticks * 10000.0);
-				save_read_latch(max_bcd_count -
-				                elapsed_ms * PIT_TICK_RATE_KHZ);
+				save_read_latch(max_bcd_count - elapsed % 10000);
 			} else {
-				elapsed_ms = fmod(elapsed_ms,
-				                  period_of_1k_pit_ticks *
-				                          max_dec_count);
-				save_read_latch(0xffff -
-				                elapsed_ms * PIT_TICK_RATE_KHZ);
+				save_read_latch(0xffff - elapsed % max_dec_count);
 			}
 		} else {
-			save_read_latch(count - elapsed_ms * PIT_TICK_RATE_KHZ);
+			save_read_latch(count - elapsed);
 		}
 		break;
 
 	case PitMode::OneShot:
 		if (channel.counting) {
-			if (elapsed_ms > channel.delay) { // has timed out
-				save_read_latch(0xffff);  // unconfirmed
+			if (elapsed > period) {          // has timed out
+				save_read_latch(0xffff); // unconfirmed
 			} else {
-				save_read_latch(count - elapsed_ms * PIT_TICK_RATE_KHZ);
+				save_read_latch(count - elapsed);
 			}
 		}
 		break;
 
 	case PitMode::RateGenerator:
 	case PitMode::RateGeneratorAlias:
-		elapsed_ms = fmod(elapsed_ms, channel.delay);
-		save_read_latch(count - (elapsed_ms / channel.delay) * count);
+		save_read_latch(count - elapsed % period);
 		break;
 
 	case PitMode::SquareWave:
 	case PitMode::SquareWaveAlias:
-		elapsed_ms = fmod(elapsed_ms, channel.delay);
-		elapsed_ms *= 2;
-		if (elapsed_ms > channel.delay) {
-			elapsed_ms -= channel.delay;
+		elapsed = (elapsed % period) * 2;
+		if (elapsed > period) {
+			elapsed -= period;
 		}
-		save_read_latch(count - (elapsed_ms / channel.delay) * count);
+		save_read_latch(count - elapsed);
 		// In mode 3 it never returns odd numbers LSB (if odd number is
 		// written 1 will be subtracted on first clock and then always
 		// 2) fixes "Corncob 3D"
@@ -353,7 +379,7 @@ static void counter_latch(PIT_Block& channel)
 		break;
 
 	default:
-		LOG(LOG_PIT, LOG_ERROR)("Illegal Mode %s for reading counter %f",
+		LOG(LOG_PIT, LOG_ERROR)("Illegal Mode %s for reading counter %d",
 		                        pit_mode_to_string(channel.mode),
 		                        count);
 		save_read_latch(0xffff);
@@ -411,7 +437,7 @@ static void write_latch(io_port_t port, io_val_t value, io_width_t)
 			channel.update_count = true;
 			return;
 		}
-		channel.start = PIC_FullIndex();
+		channel.start = PIC_FullTime();
 		update_channel_delay(channel);
 
 		switch (channel_num) {
@@ -561,7 +587,7 @@ static void latch_single_channel(const uint8_t channel_num, const uint8_t val)
 		channel.counterstatus_set  = false;
 		latched_timerstatus_locked = false;
 	}
-	channel.start         = PIC_FullIndex(); // for undocumented newmode
+	channel.start         = PIC_FullTime(); // for undocumented newmode
 	channel.go_read_latch = true;
 	channel.update_count  = false;
 	channel.counting      = false;
@@ -651,7 +677,7 @@ void TIMER_SetGate2(bool in)
 	switch (mode) {
 	case PitMode::InterruptOnTerminalCount:
 		if (in) {
-			channel_2.start = PIC_FullIndex();
+			channel_2.start = PIC_FullTime();
 		} else {
 			// Fill readlatch and store it.
 			counter_latch(channel_2);
@@ -663,7 +689,7 @@ void TIMER_SetGate2(bool in)
 		// gate 1 on: reload counter; off: nothing
 		if (in) {
 			channel_2.counting = true;
-			channel_2.start    = PIC_FullIndex();
+			channel_2.start    = PIC_FullTime();
 		}
 		break;
 
@@ -674,7 +700,7 @@ void TIMER_SetGate2(bool in)
 		// If gate is enabled restart counting. If disable store the
 		// current read_latch
 		if (in) {
-			channel_2.start = PIC_FullIndex();
+			channel_2.start = PIC_FullTime();
 		} else {
 			counter_latch(channel_2);
 		}
@@ -762,6 +788,20 @@ static std::unique_ptr<TIMER> timer = {};
 void TIMER_Init()
 {
 	timer = std::make_unique<TIMER>();
+
+	SNAPSHOT_AddComponent("pit", [] {
+		const auto channels      = pit;
+		const auto gate          = gate2;
+		const auto status        = latched_timerstatus;
+		const auto status_locked = latched_timerstatus_locked;
+
+		return [=] {
+			pit                        = channels;
+			gate2                      = gate;
+			latched_timerstatus        = status;
+			latched_timerstatus_locked = status_locked;
+		};
+	});
 }
 
 void TIMER_Destroy()
@@ -0,0 +1,366 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "private/mpeg_video_kernels.h"
+
+#include <algorithm>
+
+#include "simde/x86/sse2.h"
+#include "utils/checks.h"
+
+CHECK_NARROWING();
+
+static simde__m128i load(const void* p)
+{
+	return simde_mm_loadu_si128(static_cast<const simde__m128i*>(p));
+}
+
+static simde__m128i load_low(const void* p)
+{
+	return simde_mm_loadl_epi64(static_cast<const simde__m128i*>(p));
+}
+
+static void store(void* p, const simde__m128i v)
+{
+	simde_mm_storeu_si128(static_cast<simde__m128i*>(p), v);
+}
+
+static void store_low(void* p, const simde__m128i v)
+{
+	simde_mm_storel_epi64(static_cast<simde__m128i*>(p), v);
+}
+
+// SSE2 has no 32-bit multiply keeping the low halves, so the constant factors
+// of the IDCT are applied as shifts and adds, which wrap around the same way
+template <int Factor>
+static simde__m128i multiply(const simde__m128i v)
+{
+	auto product = simde_mm_setzero_si128();
+	for (auto bit = 0; (Factor >> bit) != 0; ++bit) {
+		if ((Factor >> bit) & 1) {
+			const auto count = simde_mm_cvtsi32_si128(bit);
+			product = simde_mm_add_epi32(product, simde_mm_sll_epi32(v, count));
+		}
+	}
+	return product;
+}
+
+static simde__m128i round_shift(const simde__m128i v)
+{
+	return simde_mm_srai_epi32(simde_mm_add_epi32(v, simde_mm_set1_epi32(128)), 8);
+}
+
+// One pass of the IDCT over four columns, v[n] holding the n-th coefficient
+static void idct_1d_x4(simde__m128i (&v)[8])
+{
+	auto add = [](const simde__m128i a, const simde__m128i b) {
+		return simde_mm_add_epi32(a, b);
+	};
+	auto sub = [](const simde__m128i a, const simde__m128i b) {
+		return simde_mm_sub_epi32(a, b);
+	};
+
+	const auto b1   = v[4];
+	const auto b3   = add(v[2], v[6]);
+	const auto b4   = sub(v[5], v[3]);
+	const auto tmp1 = add(v[1], v[7]);
+	const auto tmp2 = add(v[3], v[5]);
+	const auto b6   = sub(v[1], v[7]);
+	const auto b7   = add(tmp1, tmp2);
+	const auto m0   = v[0];
+
+	const auto x4 = sub(round_shift(sub(multiply<473>(b6), multiply<196>(b4))), b7);
+	const auto x0 = sub(x4, round_shift(multiply<362>(sub(tmp1, tmp2))));
+	const auto x1 = sub(m0, b1);
+	const auto x2 = sub(round_shift(multiply<362>(sub(v[2], v[6]))), b3);
+	const auto x3 = add(m0, b1);
+
+	const auto y3 = add(x1, x2);
+	const auto y4 = add(x3, b3);
+	const auto y5 = sub(x1, x2);
+	const auto y6 = sub(x3, b3);
+	const auto y7 = sub(sub(simde_mm_setzero_si128(), x0),
+	                    round_shift(add(multiply<473>(b4), multiply<196>(b6))));
+
+	v[0] = add(b7, y4);
+	v[1] = add(x4, y3);
+	v[2] = sub(y5, x0);
+	v[3] = sub(y6, y7);
+	v[4] = add(y6, y7);
+	v[5] = add(x0, y5);
+	v[6] = sub(y3, x4);
+	v[7] = sub(y4, b7);
+}
+
+static void transpose_4x4(simde__m128i& a, simde__m128i& b, simde__m128i& c,
+                          simde__m128i& d)
+{
+	const auto ab_lo = simde_mm_unpacklo_epi32(a, b);
+	const auto ab_hi = simde_mm_unpackhi_epi32(a, b);
+	const auto cd_lo = simde_mm_unpacklo_epi32(c, d);
+	const auto cd_hi = simde_mm_unpackhi_epi32(c, d);
+
+	a = simde_mm_unpacklo_epi64(ab_lo, cd_lo);
+	b = simde_mm_unpackhi_epi64(ab_lo, cd_lo);
+	c = simde_mm_unpacklo_epi64(ab_hi, cd_hi);
+	d = simde_mm_unpackhi_epi64(ab_hi, cd_hi);
+}
+
+// The left and right halves of the rows of an 8x8 block become the top and
+// bottom halves of its columns
+static void transpose_8x8(simde__m128i (&left)[8], simde__m128i (&right)[8])
+{
+	for (auto n = 0; n < 8; n += 4) {
+		transpose_4x4(left[n], left[n + 1], left[n + 2], left[n + 3]);
+		transpose_4x4(right[n], right[n + 1], right[n + 2], right[n + 3]);
+	}
+	for (auto n = 0; n < 4; ++n) {
+		std::swap(left[n + 4], right[n]);
+	}
+}
+
+void idct_8x8(int* block)
+{
+	simde__m128i left[8]  = {};
+	simde__m128i right[8] = {};
+	for (auto row = 0; row < 8; ++row) {
+		left[row]  = load(block + row * 8);
+		right[row] = load(block + row * 8 + 4);
+	}
+
+	idct_1d_x4(left);
+	idct_1d_x4(right);
+
+	// The rows are transformed as the columns of the transposed block
+	transpose_8x8(left, right);
+	idct_1d_x4(left);
+	idct_1d_x4(right);
+
+	for (auto n = 0; n < 8; ++n) {
+		left[n]  = round_shift(left[n]);
+		right[n] = round_shift(right[n]);
+	}
+	transpose_8x8(left, right);
+
+	for (auto row = 0; row < 8; ++row) {
+		store(block + row * 8, left[row]);
+		store(block + row * 8 + 4, right[row]);
+	}
+}
+
+// A row of the IDCT output saturated to 16 bits, which keeps the clamping of
+// the final pixels exact
+static simde__m128i load_idct_row(const int* block)
+{
+	return simde_mm_packs_epi32(load(block), load(block + 4));
+}
+
+void put_idct_block(const int* block, uint8_t* dest, const int stride)
+{
+	for (auto row = 0; row < 8; ++row) {
+		const auto values = load_idct_row(block + row * 8);
+		store_low(dest + row * stride, simde_mm_packus_epi16(values, values));
+	}
+}
+
+void add_idct_block(const int* block, uint8_t* dest, const int stride)
+{
+	const auto zero = simde_mm_setzero_si128();
+
+	for (auto row = 0; row < 8; ++row) {
+		const auto d      = dest + row * stride;
+		const auto pixels = simde_mm_unpacklo_epi8(load_low(d), zero);
+		const auto values = load_idct_row(block + row * 8);
+		const auto sum    = simde_mm_adds_epi16(pixels, values);
+		store_low(d, simde_mm_packus_epi16(sum, sum));
+	}
+}
+
+// Rounded average of four pixel rows
+static simde__m128i average_x4(const simde__m128i a, const simde__m128i b,
+                               const simde__m128i c, const simde__m128i d)
+{
+	const auto zero = simde_mm_setzero_si128();
+	const auto two  = simde_mm_set1_epi16(2);
+
+	auto sum = [&](auto unpack) {
+		const auto ab = simde_mm_add_epi16(unpack(a, zero), unpack(b, zero));
+		const auto cd = simde_mm_add_epi16(unpack(c, zero), unpack(d, zero));
+		return simde_mm_srli_epi16(simde_mm_add_epi16(simde_mm_add_epi16(ab, cd),
+		                                              two),
+		                           2);
+	};
+	return simde_mm_packus_epi16(
+	        sum([](const simde__m128i x, const simde__m128i y) {
+		        return simde_mm_unpacklo_epi8(x, y);
+	        }),
+	        sum([](const simde__m128i x, const simde__m128i y) {
+		        return simde_mm_unpackhi_epi8(x, y);
+	        }));
+}
+
+template <int Size>
+static void predict_block(const uint8_t* src, uint8_t* dest, const int stride,
+                          const bool half_h, const bool half_v, const bool average)
+{
+	auto load_row = [](const uint8_t* p) {
+		return (Size == 16) ? load(p) : load_low(p);
+	};
+
+	for (auto row = 0; row < Size; ++row) {
+		const auto s = src + row * stride;
+		const auto d = dest + row * stride;
+
+		auto prediction = load_row(s);
+		if (half_h && half_v) {
+			prediction = average_x4(prediction,
+			                        load_row(s + 1),
+			                        load_row(s + stride),
+			                        load_row(s + stride + 1));
+		} else if (half_h) {
+			prediction = simde_mm_avg_epu8(prediction, load_row(s + 1));
+		} else if (half_v) {
+			prediction = simde_mm_avg_epu8(prediction, load_row(s + stride));
+		}
+		if (average) {
+			prediction = simde_mm_avg_epu8(load_row(d), prediction);
+		}
+
+		if (Size == 16) {
+			store(d, prediction);
+		} else {
+			store_low(d, prediction);
+		}
+	}
+}
+
+void predict_block(const uint8_t* src, uint8_t* dest, const int stride,
+                   const int size, const bool half_h, const bool half_v,
+                   const bool average)
+{
+	if (size == 16) {
+		predict_block<16>(src, dest, stride, half_h, half_v, average);
+	} else {
+		predict_block<8>(src, dest, stride, half_h, half_v, average);
+	}
+}
+
+namespace scalar {
+
+static uint8_t clamp(const int value)
+{
+	return static_cast<uint8_t>(std::clamp(value, 0, 255));
+}
+
+void idct_8x8(int* block)
+{
+	int b1, b3, b4, b6, b7, tmp1, tmp2, m0, x0, x1, x2, x3, x4, y3, y4,
+	        y5, y6, y7;
+
+	// Transform columns
+	for (int i = 0; i < 8; ++i) {
+		b1   = block[4 * 8 + i];
+		b3   = block[2 * 8 + i] + block[6 * 8 + i];
+		b4   = block[5 * 8 + i] - block[3 * 8 + i];
+		tmp1 = block[1 * 8 + i] + block[7 * 8 + i];
+		tmp2 = block[3 * 8 + i] + block[5 * 8 + i];
+		b6   = block[1 * 8 + i] - block[7 * 8 + i];
+		b7   = tmp1 + tmp2;
+		m0   = block[0 * 8 + i];
+		x4   = ((b6 * 473 - b4 * 196 + 128) >> 8) - b7;
+		x0   = x4 - (((tmp1 - tmp2) * 362 + 128) >> 8);
+		x1   = m0 - b1;
+		x2 = (((block[2 * 8 + i] - block[6 * 8 + i]) * 362 + 128) >> 8) - b3;
+		x3 = m0 + b1;
+		y3 = x1 + x2;
+		y4 = x3 + b3;
+		y5 = x1 - x2;
+		y6 = x3 - b3;
+		y7 = -x0 - ((b4 * 473 + b6 * 196 + 128) >> 8);
+		block[0 * 8 + i] = b7 + y4;
+		block[1 * 8 + i] = x4 + y3;
+		block[2 * 8 + i] = y5 - x0;
+		block[3 * 8 + i] = y6 - y7;
+		block[4 * 8 + i] = y6 + y7;
+		block[5 * 8 + i] = x0 + y5;
+		block[6 * 8 + i] = y3 - x4;
+		block[7 * 8 + i] = y4 - b7;
+	}
+
+	// Transform rows
+	for (int i = 0; i < 64; i += 8) {
+		b1   = block[4 + i];
+		b3   = block[2 + i] + block[6 + i];
+		b4   = block[5 + i] - block[3 + i];
+		tmp1 = block[1 + i] + block[7 + i];
+		tmp2 = block[3 + i] + block[5 + i];
+		b6   = block[1 + i] - block[7 + i];
+		b7   = tmp1 + tmp2;
+		m0   = block[0 + i];
+		x4   = ((b6 * 473 - b4 * 196 + 128) >> 8) - b7;
+		x0   = x4 - (((tmp1 - tmp2) * 362 + 128) >> 8);
+		x1   = m0 - b1;
+		x2   = (((block[2 + i] - block[6 + i]) * 362 + 128) >> 8) - b3;
+		x3   = m0 + b1;
+		y3   = x1 + x2;
+		y4   = x3 + b3;
+		y5   = x1 - x2;
+		y6   = x3 - b3;
+		y7   = -x0 - ((b4 * 473 + b6 * 196 + 128) >> 8);
+		block[0 + i] = (b7 + y4 + 128) >> 8;
+		block[1 + i] = (x4 + y3 + 128) >> 8;
+		block[2 + i] = (y5 - x0 + 128) >> 8;
+		block[3 + i] = (y6 - y7 + 128) >> 8;
+		block[4 + i] = (y6 + y7 + 128) >> 8;
+		block[5 + i] = (x0 + y5 + 128) >> 8;
+		block[6 + i] = (y3 - x4 + 128) >> 8;
+		block[7 + i] = (y4 - b7 + 128) >> 8;
+	}
+}
+
+void put_idct_block(const int* block, uint8_t* dest, const int stride)
+{
+	for (auto y = 0; y < 8; ++y) {
+		for (auto x = 0; x < 8; ++x) {
+			dest[y * stride + x] = clamp(block[y * 8 + x]);
+		}
+	}
+}
+
+void add_idct_block(const int* block, uint8_t* dest, const int stride)
+{
+	for (auto y = 0; y < 8; ++y) {
+		for (auto x = 0; x < 8; ++x) {
+			auto& pixel = dest[y * stride + x];
+			pixel       = clamp(pixel + block[y * 8 + x]);
+		}
+	}
+}
+
+void predict_block(const uint8_t* src, uint8_t* dest, const int stride,
+                   const int size, const bool half_h, const bool half_v,
+                   const bool average)
+{
+	for (auto y = 0; y < size; ++y) {
+		for (auto x = 0; x < size; ++x) {
+			const auto s = src + y * stride + x;
+
+			int prediction = s[0];
+			if (half_h && half_v) {
+				prediction = (s[0] + s[1] + s[stride] + s[stride + 1] + 2) >> 2;
+			} else if (half_h) {
+				prediction = (s[0] + s[1] + 1) >> 1;
+			} else if (half_v) {
+				prediction = (s[0] + s[stride] + 1) >> 1;
+			}
+
+			auto& pixel = dest[y * stride + x];
+			if (average) {
+				prediction = (pixel + prediction + 1) >> 1;
+			}
+			pixel = static_cast<uint8_t>(prediction);
+		}
+	}
+}
+
+} // namespace scalar
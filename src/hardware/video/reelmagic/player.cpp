@@ -12,6 +12,7 @@
 #include <cstdio>
 #include <cstring>
 #include <exception>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -22,11 +23,15 @@
 #include "hardware/timer.h"
 #include "misc/logging.h"
 #include "player.h"
+#include "private/mpeg_video_kernels.h"
+#include "private/ycbcr_kernels.h"
 #include "utils/rwqueue.h"
 #include "config/setup.h"
 
-// bring in the MPEG-1 decoder library...
+// bring in the MPEG-1 decoder library with its block loops replaced by the
+// SIMD kernels...
 #define PL_MPEG_IMPLEMENTATION
+#define PLM_USE_SIMD_KERNELS
 #include "libs/PL_MPEG/mpeg_decoder.h"
 
 // global config
@@ -189,6 +194,64 @@ class ReelMagic_MediaPlayerImplementation : public ReelMagic_MediaPlayer,
 
 	AudioFifo audio_fifo = {};
 
+	// The picture of the next frame is converted to BGRX by a worker while
+	// the emulation runs until the vertical refresh that shows it. The
+	// decoding itself stays here: it reads the file through DOS and shares
+	// the demuxer with the audio decoding.
+	std::vector<uint32_t> _nextPicture   = {};
+	std::future<void> _pictureConversion = {};
+
+	static void convertFrame(const plm_frame_t* frame, uint32_t* out)
+	{
+		const auto width = static_cast<int>(frame->width);
+		for (unsigned row = 0; row + 1 < frame->height; row += 2) {
+			const auto y = frame->y.data + row * frame->y.width;
+			const auto c = (row / 2) * frame->cb.width;
+
+			ycbcr420_to_bgrx_row_pair(y,
+			                          y + frame->y.width,
+			                          frame->cb.data + c,
+			                          frame->cr.data + c,
+			                          out + row * frame->width,
+			                          out + (row + 1) * frame->width,
+			                          width & ~1);
+		}
+	}
+
+	void startPictureConversion()
+	{
+		if (!_nextFrame) {
+			return;
+		}
+		_nextPicture.resize(static_cast<size_t>(_nextFrame->width) *
+		                    _nextFrame->height);
+
+		_pictureConversion = std::async(std::launch::async, [this] {
+			convertFrame(_nextFrame, _nextPicture.data());
+		});
+	}
+
+	// The decoder reuses the buffers of the frame being converted
+	void waitForPictureConversion()
+	{
+		if (_pictureConversion.valid()) {
+			_pictureConversion.get();
+		}
+	}
+
+	void drawNextFrame(void* const outputBuffer)
+	{
+		if (_pictureConversion.valid()) {
+			_pictureConversion.get();
+			std::memcpy(outputBuffer,
+			            _nextPicture.data(),
+			            _nextPicture.size() * sizeof(uint32_t));
+		} else if (_nextFrame) {
+			// The first frame, or one whose conversion wasn't started
+			convertFrame(_nextFrame, static_cast<uint32_t*>(outputBuffer));
+		}
+	}
+
 	static void plmBufferLoadCallback(plm_buffer_t* self, void* user)
 	{
 		// note: based on plm_buffer_load_file_callback()
@@ -238,6 +301,8 @@ class ReelMagic_MediaPlayerImplementation : public ReelMagic_MediaPlayer,
 
 	void advanceNextFrame()
 	{
+		waitForPictureConversion();
+
 		_nextFrame = plm_decode_video(_plm);
 		if (!_nextFrame) {
 			// note: will return nullptr frame once when looping...
@@ -449,6 +514,7 @@ public:
 		DeactivatePlayerAudioFifo(audio_fifo);
 		if (ReelMagic_GetVideoMixerMPEGProvider() == this)
 			ReelMagic_ClearVideoMixerMPEGProvider();
+		waitForPictureConversion();
 		if (_plm) {
 			plm_destroy(_plm);
 		}
@@ -468,11 +534,7 @@ public:
 		}
 
 		if (_drawNextFrame) {
-			if (_nextFrame) {
-				plm_frame_to_rgb(_nextFrame,
-				                 (uint8_t*)outputBuffer,
-				                 _attrs.PictureSize.Width * 3);
-			}
+			drawNextFrame(outputBuffer);
 			_drawNextFrame = false;
 		}
 
@@ -487,6 +549,9 @@ public:
 			advanceNextFrame();
 			_drawNextFrame = true;
 		}
+		if (_drawNextFrame) {
+			startPictureConversion();
+		}
 	}
 
 	const ReelMagic_PlayerConfiguration& GetConfig() const override
@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_REELMAGIC_MPEG_VIDEO_KERNELS_H
+#define DOSBOX_REELMAGIC_MPEG_VIDEO_KERNELS_H
+
+#include <cstdint>
+
+// Block kernels of the MPEG-1 video decoder, replacing the scalar loops of
+// pl_mpeg when PLM_USE_SIMD_KERNELS is defined before its implementation.
+//
+// The default versions use SSE2 (NEON on ARM via SIMDe); the 'scalar' ones
+// are pl_mpeg's own code and produce bit-identical results.
+
+// Inverse DCT of an 8x8 block of coefficients, in place
+void idct_8x8(int* block);
+
+// Writes the IDCT output of an 8x8 block clamped to 0..255, or adds it to the
+// predicted pixels
+void put_idct_block(const int* block, uint8_t* dest, const int stride);
+void add_idct_block(const int* block, uint8_t* dest, const int stride);
+
+// Motion compensation of a square block of 'size' (8 or 16) pixels from the
+// reference pixels at 'src', with half-pixel offsets interpolated. With
+// 'average' set, the prediction is averaged with the pixels already at
+// 'dest', as for bidirectionally predicted blocks.
+void predict_block(const uint8_t* src, uint8_t* dest, const int stride,
+                   const int size, const bool half_h, const bool half_v,
+                   const bool average);
+
+namespace scalar {
+
+void idct_8x8(int* block);
+
+void put_idct_block(const int* block, uint8_t* dest, const int stride);
+void add_idct_block(const int* block, uint8_t* dest, const int stride);
+
+void predict_block(const uint8_t* src, uint8_t* dest, const int stride,
+                   const int size, const bool half_h, const bool half_v,
+                   const bool average);
+
+} // namespace scalar
+
+#endif // DOSBOX_REELMAGIC_MPEG_VIDEO_KERNELS_H
@@ -0,0 +1,31 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_REELMAGIC_YCBCR_KERNELS_H
+#define DOSBOX_REELMAGIC_YCBCR_KERNELS_H
+
+#include <cstdint>
+
+// Colour conversion of the decoded MPEG-1 pictures (YCbCr 4:2:0 with BT.601
+// studio swing) to 32-bit BGRX pixels with the alpha component cleared.
+//
+// The conversion uses the coefficients of pl_mpeg's plm_frame_to_rgb() in
+// 16-bit fixed point, so the results may differ from it by one or two steps.
+// The default version uses SSE2 (NEON on ARM via SIMDe); the 'scalar' one is
+// the plain reference implementation that produces bit-identical results.
+
+// Converts two rows of 'width' pixels (an even number) sharing the row of
+// chroma samples at 'cb' and 'cr'
+void ycbcr420_to_bgrx_row_pair(const uint8_t* y0, const uint8_t* y1,
+                               const uint8_t* cb, const uint8_t* cr,
+                               uint32_t* out0, uint32_t* out1, const int width);
+
+namespace scalar {
+
+void ycbcr420_to_bgrx_row_pair(const uint8_t* y0, const uint8_t* y1,
+                               const uint8_t* cb, const uint8_t* cr,
+                               uint32_t* out0, uint32_t* out1, const int width);
+
+} // namespace scalar
+
+#endif // DOSBOX_REELMAGIC_YCBCR_KERNELS_H
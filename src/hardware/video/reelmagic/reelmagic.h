@@ -19,6 +19,7 @@ struct ReelMagic_PlayerConfiguration;
 struct ReelMagic_PlayerAttributes;
 struct ReelMagic_VideoMixerMPEGProvider {
 	virtual ~ReelMagic_VideoMixerMPEGProvider() = default;
+	// Writes the picture as 32-bit BGRX pixels when it has changed
 	virtual void OnVerticalRefresh(void* const outputBuffer, const float fps) = 0;
 	virtual const ReelMagic_PlayerConfiguration& GetConfig() const = 0;
 	virtual const ReelMagic_PlayerAttributes& GetAttrs() const     = 0;
@@ -142,10 +142,12 @@ struct VGAOverPalettePixel : VGAPalettePixel {
 	}
 };
 
+// The players output 32-bit BGRX pixels, the layout of the mixer's output
 struct PlayerPicturePixel {
-	uint8_t red;
-	uint8_t green;
 	uint8_t blue;
+	uint8_t green;
+	uint8_t red;
+	uint8_t alpha;
 	template <typename T>
 	inline void CopyRGBTo(T& out) const
 	{
@@ -243,6 +245,7 @@ static void ClearMpegPictureBuffer()
 	p.red   = 0;
 	p.green = 0;
 	p.blue  = 0;
+	p.alpha = 0;
 	ClearMpegPictureBuffer(p);
 }
 
@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "private/ycbcr_kernels.h"
+
+#include <algorithm>
+
+#include "simde/x86/sse2.h"
+#include "utils/checks.h"
+
+CHECK_NARROWING();
+
+// Fixed-point coefficients scaled by 2^16, applied to the luma and chroma
+// values scaled by 4 so the 16-bit high-half multiplies keep enough precision
+constexpr int16_t LumaCoeff    = 19077; // 1.164
+constexpr int16_t CrToRedCoeff = 26149; // 1.596
+constexpr int16_t CbToGrnCoeff = 6419;  // 0.392
+constexpr int16_t CrToGrnCoeff = 13320; // 0.813
+constexpr int16_t CbToBluCoeff = 282;   // 2.017 - 2
+
+static simde__m128i load(const void* p)
+{
+	return simde_mm_loadu_si128(static_cast<const simde__m128i*>(p));
+}
+
+static simde__m128i load_low(const void* p)
+{
+	return simde_mm_loadl_epi64(static_cast<const simde__m128i*>(p));
+}
+
+static void store(void* p, const simde__m128i v)
+{
+	simde_mm_storeu_si128(static_cast<simde__m128i*>(p), v);
+}
+
+// Scaled luma of eight 16-bit values
+static simde__m128i scale_luma_x8(const simde__m128i y)
+{
+	const auto offset = simde_mm_set1_epi16(16);
+	const auto coeff  = simde_mm_set1_epi16(LumaCoeff);
+
+	const auto y4 = simde_mm_slli_epi16(simde_mm_sub_epi16(y, offset), 2);
+	return simde_mm_mulhi_epi16(y4, coeff);
+}
+
+// Stores 16 pixels from their saturated B, G, and R components
+static void store_bgrx_x16(uint32_t* out, const simde__m128i b,
+                           const simde__m128i g, const simde__m128i r)
+{
+	const auto zero = simde_mm_setzero_si128();
+
+	const auto bg_lo = simde_mm_unpacklo_epi8(b, g);
+	const auto bg_hi = simde_mm_unpackhi_epi8(b, g);
+	const auto rx_lo = simde_mm_unpacklo_epi8(r, zero);
+	const auto rx_hi = simde_mm_unpackhi_epi8(r, zero);
+
+	store(out + 0, simde_mm_unpacklo_epi16(bg_lo, rx_lo));
+	store(out + 4, simde_mm_unpackhi_epi16(bg_lo, rx_lo));
+	store(out + 8, simde_mm_unpacklo_epi16(bg_hi, rx_hi));
+	store(out + 12, simde_mm_unpackhi_epi16(bg_hi, rx_hi));
+}
+
+// Converts 16 pixels of a row given the chroma terms of their 8 chroma
+// samples, each already doubled to cover two pixels
+static void convert_x16(const uint8_t* y, uint32_t* out,
+                        const simde__m128i (&r)[2], const simde__m128i (&g)[2],
+                        const simde__m128i (&b)[2])
+{
+	const auto zero = simde_mm_setzero_si128();
+	const auto luma = load(y);
+
+	const simde__m128i yy[2] = {
+	        scale_luma_x8(simde_mm_unpacklo_epi8(luma, zero)),
+	        scale_luma_x8(simde_mm_unpackhi_epi8(luma, zero))};
+
+	auto add_packed = [&](const simde__m128i (&c)[2]) {
+		return simde_mm_packus_epi16(simde_mm_add_epi16(yy[0], c[0]),
+		                             simde_mm_add_epi16(yy[1], c[1]));
+	};
+	auto sub_packed = [&](const simde__m128i (&c)[2]) {
+		return simde_mm_packus_epi16(simde_mm_sub_epi16(yy[0], c[0]),
+		                             simde_mm_sub_epi16(yy[1], c[1]));
+	};
+
+	store_bgrx_x16(out, add_packed(b), sub_packed(g), add_packed(r));
+}
+
+void ycbcr420_to_bgrx_row_pair(const uint8_t* y0, const uint8_t* y1,
+                               const uint8_t* cb, const uint8_t* cr,
+                               uint32_t* out0, uint32_t* out1, const int width)
+{
+	const auto zero   = simde_mm_setzero_si128();
+	const auto offset = simde_mm_set1_epi16(128);
+
+	auto x = 0;
+	for (; x + 16 <= width; x += 16) {
+		const auto c = x / 2;
+
+		const auto cb4 = simde_mm_slli_epi16(
+		        simde_mm_sub_epi16(simde_mm_unpacklo_epi8(load_low(cb + c), zero),
+		                           offset),
+		        2);
+		const auto cr4 = simde_mm_slli_epi16(
+		        simde_mm_sub_epi16(simde_mm_unpacklo_epi8(load_low(cr + c), zero),
+		                           offset),
+		        2);
+
+		const auto r = simde_mm_mulhi_epi16(cr4, simde_mm_set1_epi16(CrToRedCoeff));
+		const auto g = simde_mm_add_epi16(
+		        simde_mm_mulhi_epi16(cb4, simde_mm_set1_epi16(CbToGrnCoeff)),
+		        simde_mm_mulhi_epi16(cr4, simde_mm_set1_epi16(CrToGrnCoeff)));
+		const auto b = simde_mm_add_epi16(
+		        simde_mm_srai_epi16(cb4, 1),
+		        simde_mm_mulhi_epi16(cb4, simde_mm_set1_epi16(CbToBluCoeff)));
+
+		// Each chroma sample covers two horizontally adjacent pixels
+		const simde__m128i rr[2] = {simde_mm_unpacklo_epi16(r, r),
+		                            simde_mm_unpackhi_epi16(r, r)};
+		const simde__m128i gg[2] = {simde_mm_unpacklo_epi16(g, g),
+		                            simde_mm_unpackhi_epi16(g, g)};
+		const simde__m128i bb[2] = {simde_mm_unpacklo_epi16(b, b),
+		                            simde_mm_unpackhi_epi16(b, b)};
+
+		convert_x16(y0 + x, out0 + x, rr, gg, bb);
+		convert_x16(y1 + x, out1 + x, rr, gg, bb);
+	}
+
+	scalar::ycbcr420_to_bgrx_row_pair(
+	        y0 + x, y1 + x, cb + x / 2, cr + x / 2, out0 + x, out1 + x, width - x);
+}
+
+namespace scalar {
+
+// The high half of a signed 16-bit multiply
+static int mulhi(const int a, const int b)
+{
+	return (a * b) >> 16;
+}
+
+static uint32_t to_bgrx(const int yy, const int r, const int g, const int b)
+{
+	auto clamp = [](const int c) {
+		return static_cast<uint32_t>(std::clamp(c, 0, 255));
+	};
+	return clamp(yy + b) | (clamp(yy - g) << 8) | (clamp(yy + r) << 16);
+}
+
+void ycbcr420_to_bgrx_row_pair(const uint8_t* y0, const uint8_t* y1,
+                               const uint8_t* cb, const uint8_t* cr,
+                               uint32_t* out0, uint32_t* out1, const int width)
+{
+	for (auto x = 0; x + 1 < width; x += 2) {
+		const auto c = x / 2;
+
+		const auto cb4 = (cb[c] - 128) * 4;
+		const auto cr4 = (cr[c] - 128) * 4;
+
+		const auto r = mulhi(cr4, CrToRedCoeff);
+		const auto g = mulhi(cb4, CbToGrnCoeff) + mulhi(cr4, CrToGrnCoeff);
+		const auto b = cb4 / 2 + mulhi(cb4, CbToBluCoeff);
+
+		auto luma = [](const uint8_t y) {
+			return mulhi((y - 16) * 4, LumaCoeff);
+		};
+
+		out0[x]     = to_bgrx(luma(y0[x]), r, g, b);
+		out0[x + 1] = to_bgrx(luma(y0[x + 1]), r, g, b);
+		out1[x]     = to_bgrx(luma(y1[x]), r, g, b);
+		out1[x + 1] = to_bgrx(luma(y1[x + 1]), r, g, b);
+	}
+}
+
+} // namespace scalar
@@ -8,10 +8,12 @@
 #include <cstring>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "config/setup.h"
 #include "gui/common.h"
 #include "hardware/pic.h"
+#include "hardware/snapshot.h"
 #include "ints/int10.h"
 #include "misc/logging.h"
 #include "misc/video.h"
@@ -387,6 +389,35 @@ void VGA_Init()
 #endif
 		}
 	}
+
+	SNAPSHOT_AddComponent("vga", [] {
+		// The register unions can't be assigned, but like the rest of
+		// the state they only hold plain values and pointers into the
+		// video memory, so the state is copied byte by byte
+		std::vector<uint8_t> state(sizeof(vga));
+		std::memcpy(state.data(), static_cast<const void*>(&vga), sizeof(vga));
+
+		const auto linear   = vga.mem.linear;
+		const auto fastmem  = vga.fastmem;
+		const auto vmemsize = vga.vmemsize;
+
+		std::vector<uint8_t> vram(linear, linear + vmemsize);
+		std::vector<uint8_t> fast(fastmem, fastmem + 2 * vmemsize);
+
+		return [=] {
+			if (vga.mem.linear != linear || vga.fastmem != fastmem ||
+			    vga.vmemsize != vmemsize) {
+				LOG_WARNING("VGA: The video memory has changed, can't restore the snapshot");
+				return;
+			}
+			std::memcpy(static_cast<void*>(&vga), state.data(), sizeof(vga));
+			std::copy(vram.begin(), vram.end(), vga.mem.linear);
+			std::copy(fast.begin(), fast.end(), vga.fastmem);
+
+			VGA_SetupHandlers();
+			VGA_StartResize();
+		};
+	});
 }
 
 void VGA_Destroy()
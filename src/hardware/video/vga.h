@@ -313,6 +313,10 @@ struct VgaDraw {
 	uint8_t font[64 * 1024] = {};
 	uint8_t* font_tables[2] = {nullptr, nullptr};
 
+	// Incremented on every write to the font map so cached glyph rows can
+	// be invalidated
+	uint32_t font_generation = 0;
+
 	Bitu blinking                      = 0;
 	bool blink                         = false;
 	PixelsPerChar pixels_per_character = PixelsPerChar::Eight;
@@ -329,6 +333,22 @@ struct VgaDraw {
 	DrawMode mode       = {};
 	bool vret_triggered = false;
 	bool vga_override   = false;
+
+	// Set by writes to video memory, the palette and the display registers.
+	// Frames are only drawn if something has changed since the last one;
+	// otherwise the previously rendered frame stays on screen.
+	bool is_frame_dirty = true;
+
+	// True if all writes to the displayed video memory go through page
+	// handlers that set 'is_frame_dirty'. Modes that map video memory
+	// directly into the guest's address space draw every frame.
+	bool is_write_tracking_reliable = false;
+
+	// While set, the directly mapped VESA framebuffer pages (the linear
+	// framebuffer and the banked window) are only mapped for direct reads.
+	// The first write of a frame is trapped to set 'is_frame_dirty', then
+	// the pages are mapped for direct writes until the next frame starts.
+	bool are_direct_writes_trapped = false;
 };
 
 struct VGA_HWCURSOR {
@@ -971,6 +991,10 @@ struct VgaDac {
 	Rgb666 rgb[NumVgaColors]           = {};
 	Bgrx8888 palette_map[NumVgaColors] = {};
 
+	// Incremented on every palette map change so cached glyph rows can be
+	// invalidated
+	uint32_t palette_generation = 0;
+
 	uint8_t combine[16] = {};
 
 	// DAC 8-bit registers
@@ -1153,6 +1177,9 @@ double VGA_GetRefreshRate();
 void VGA_DACSetEntirePalette(void);
 void VGA_StartRetrace(void);
 void VGA_StartUpdateLFB(void);
+
+// Called when a frame starts
+void VGA_TrapDirectWrites();
 void VGA_SetBlinking(uint8_t enabled);
 void VGA_SetCGA2Table(uint8_t val0, uint8_t val1);
 void VGA_SetCGA4Table(uint8_t val0, uint8_t val1, uint8_t val2, uint8_t val3);
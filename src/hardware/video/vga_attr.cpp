@@ -94,6 +94,8 @@ static void write_p3c0(io_port_t, io_val_t value, io_width_t)
 {
 	auto val = check_cast<uint8_t>(value);
 
+	vga.draw.is_frame_dirty = true;
+
 	if (vga.attr.is_address_mode) {
 		vga.attr.is_address_mode = false;
 
@@ -29,6 +29,9 @@ uint8_t vga_read_p3d4(io_port_t, io_width_t)
 void vga_write_p3d5(io_port_t, io_val_t value, io_width_t)
 {
 	const auto val = check_cast<uint8_t>(value);
+
+	vga.draw.is_frame_dirty = true;
+
 	// if (vga.crtc.index > 0x18) {
 	// 	LOG_MSG("VGA crtc write %" sBitfs(X) " to reg %X", val, vga.crtc.index)
 	// }
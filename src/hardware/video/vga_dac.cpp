@@ -161,6 +161,8 @@ static void vga_dac_send_color(const uint8_t palette_idx, const uint8_t color_id
 
 	// Map the source color into palette's requested index
 	vga.dac.palette_map[palette_idx] = Bgrx8888(r8, g8, b8);
+	++vga.dac.palette_generation;
+	vga.draw.is_frame_dirty = true;
 
 	ReelMagic_RENDER_SetPalette(palette_idx, r8, g8, b8);
 }
@@ -19,6 +19,8 @@
 #include "hardware/video/reelmagic/reelmagic.h"
 #include "ints/int10.h"
 #include "misc/video.h"
+#include "misc/tracing.h"
+#include "simde/x86/sse2.h"
 #include "utils/bitops.h"
 #include "utils/math_utils.h"
 #include "utils/mem_unaligned.h"
@@ -216,6 +218,39 @@ static uint8_t byte_clamp(int v)
 	return v < 0 ? 0u : (v > 255 ? 255u : static_cast<uint8_t>(v));
 }
 
+// Separates the chroma of the composite signal into its two quadrature
+// components, four samples per SSE2 register. 'i' points at the sample of
+// the first output; the four samples on either side of each one are read.
+static void store_composite_chroma(const int* i, int* ap, int* bp, const int num_samples)
+{
+	auto load = [&](const int offset) {
+		return simde_mm_loadu_si128(reinterpret_cast<const simde__m128i*>(i + offset));
+	};
+	auto store = [](int* p, const simde__m128i v) {
+		simde_mm_storeu_si128(reinterpret_cast<simde__m128i*>(p), v);
+	};
+
+	int x = 0;
+	for (; x + 4 <= num_samples; x += 4, i += 4) {
+		const auto a_mid = simde_mm_add_epi32(simde_mm_sub_epi32(load(-2), load(0)),
+		                                      load(2));
+		const auto a = simde_mm_add_epi32(simde_mm_sub_epi32(load(-4),
+		                                                     simde_mm_slli_epi32(a_mid, 1)),
+		                                  load(4));
+
+		const auto b = simde_mm_sub_epi32(
+		        simde_mm_add_epi32(simde_mm_sub_epi32(load(-3), load(-1)), load(1)),
+		        load(3));
+
+		store(ap + x, a);
+		store(bp + x, simde_mm_slli_epi32(b, 1));
+	}
+	for (; x < num_samples; ++x, ++i) {
+		ap[x] = i[-4] - left_shift_signed(i[-2] - i[0] + i[2], 1) + i[4];
+		bp[x] = left_shift_signed(i[-3] - i[-1] + i[1] - i[3], 1);
+	}
+}
+
 static uint8_t* Composite_Process(uint8_t border, uint32_t blocks, bool double_width)
 {
 	static int temp[ScalerMaxWidth + 10] = {0};
@@ -278,21 +313,14 @@ static uint8_t* Composite_Process(uint8_t border, uint32_t blocks, bool double_w
 			                          byte_clamp(y) * 0x10101);
 		}
 	} else {
-		// Store chroma
-		int* i  = temp + 4;
+		// Store chroma, from one sample before the line to one after it
 		int* ap = atemp + 1;
 		int* bp = btemp + 1;
 
-		for (int x = -1; x < w + 1; ++x) {
-			ap[x] = i[-4] -
-			        left_shift_signed(i[-2] - i[0] + i[2], 1) + i[4];
-
-			bp[x] = left_shift_signed(i[-3] - i[-1] + i[1] - i[3], 1);
-			++i;
-		}
+		store_composite_chroma(temp + 4, ap - 1, bp - 1, w + 2);
 
 		// Decode
-		i     = temp + 5;
+		int* i = temp + 5;
 		i[-1] = (i[-1] << 3) - ap[-1];
 		i[0]  = (i[0] << 3) - ap[0];
 
@@ -432,42 +460,73 @@ static uint8_t* VGA_Draw_Linear_Line(Bitu vidstart, Bitu /*line*/)
 	return ret;
 }
 
+// Looks up the DAC palette colours of a run of 8-bit indices and writes them
+// as RGB888 pixels. Mode 13h and the 8-bit VESA modes spend most of their
+// drawing time here, so the colours are written four at a time with a single
+// 128-bit store. The lookups themselves stay scalar; a 256-entry table is
+// served from L1 and SSE2 and NEON lack a 32-bit gather.
+static uint8_t* expand_from_dac_palette(const uint8_t* indices,
+                                        const size_t num_pixels, uint8_t* out)
+{
+	const auto palette_map = vga.dac.palette_map;
+
+	auto lookup = [&](const size_t i) {
+		return static_cast<int32_t>(palette_map[indices[i]].color);
+	};
+
+	size_t i = 0;
+	for (; i + 8 <= num_pixels; i += 8) {
+		const auto lo = simde_mm_set_epi32(lookup(i + 3),
+		                                   lookup(i + 2),
+		                                   lookup(i + 1),
+		                                   lookup(i));
+		const auto hi = simde_mm_set_epi32(lookup(i + 7),
+		                                   lookup(i + 6),
+		                                   lookup(i + 5),
+		                                   lookup(i + 4));
+
+		simde_mm_storeu_si128(reinterpret_cast<simde__m128i*>(out), lo);
+		simde_mm_storeu_si128(reinterpret_cast<simde__m128i*>(out + 16), hi);
+		out += 32;
+	}
+	for (; i < num_pixels; ++i) {
+		memcpy(out, palette_map + indices[i], sizeof(palette_map[0]));
+		out += sizeof(palette_map[0]);
+	}
+	return out;
+}
+
 static uint8_t* draw_unwrapped_line_from_dac_palette(Bitu vidstart,
                                                      [[maybe_unused]] const Bitu line = 0)
 {
-	// Quick references
-	static constexpr auto palette_map        = vga.dac.palette_map;
-	static constexpr uint8_t bytes_per_pixel = sizeof(palette_map[0]);
+	static constexpr uint8_t bytes_per_pixel = sizeof(vga.dac.palette_map[0]);
 
 	const auto linear_mask = vga.draw.linear_mask;
 	const auto linear_addr = vga.draw.linear_base;
 
-	// Video mode-specific line variables
-	const auto pixels_in_line = static_cast<uint16_t>(vga.draw.line_length /
-	                                                  bytes_per_pixel);
-
-	const auto video_end = vidstart + pixels_in_line;
+	// The mask covers a power-of-two sized block, so the line is at most
+	// two contiguous runs: up to the end of the block, then from its base
+	assert(((linear_mask + 1) & linear_mask) == 0);
 
-	// The line address is where the RGB888 palettized pixel is written.
-	// It's incremented forward per pixel.
-	auto line_addr = reinterpret_cast<uint32_t*>(TempLine);
-
-	auto linear_pos = vidstart;
+	// Video mode-specific line variables
+	size_t pixels_remaining = vga.draw.line_length / bytes_per_pixel;
 
-	// Draw in batches of four to let the host pipeline deeper.
-	constexpr auto num_repeats = 4;
-	assert(pixels_in_line % num_repeats == 0);
+	auto linear_pos = vidstart & linear_mask;
+	auto line_addr  = TempLine;
 
 	// This function typically runs on 640+-wide lines and is a rendering
 	// bottleneck.
-	while (linear_pos < video_end) {
-		auto repeats = num_repeats;
-		while (repeats--) {
-			const auto masked_pos    = linear_pos++ & linear_mask;
-			const auto palette_index = *(linear_addr + masked_pos);
+	while (pixels_remaining > 0) {
+		const auto run_len = std::min(pixels_remaining,
+		                              static_cast<size_t>(linear_mask + 1 -
+		                                                  linear_pos));
 
-			*line_addr++ = *(palette_map + palette_index);
-		}
+		line_addr = expand_from_dac_palette(linear_addr + linear_pos,
+		                                    run_len,
+		                                    line_addr);
+
+		pixels_remaining -= run_len;
+		linear_pos = 0;
 	}
 
 	return TempLine;
@@ -480,17 +539,15 @@ static uint8_t* draw_linear_line_from_dac_palette(Bitu vidstart, Bitu /*line*/)
 	constexpr auto palette_map        = vga.dac.palette_map;
 	constexpr uint8_t bytes_per_pixel = sizeof(palette_map[0]);
 
-	// The line address is where the RGB888 palettized pixel is written.
-	// It's incremented forward per pixel.
+	// The line address is where the RGB888 palettized pixels are written.
 	auto line_addr = TempLine;
 
 	// The palette index iterator is used to lookup the DAC palette colour.
-	// It starts at the current VGA line's offset and is incremented per
-	// pixel.
+	// It starts at the current VGA line's offset.
 	auto palette_index_it = vga.draw.linear_base + offset;
 
 	// Pixels remaining starts as the total pixels in this current line and
-	// is decremented per pixel rendered. It acts as a lower-bound cutoff
+	// is decremented by the unwrapped chunk. It acts as a lower-bound cutoff
 	// regardless of how long the wrapped and unwrapped regions are.
 	auto pixels_remaining = check_cast<uint16_t>(vga.draw.line_length /
 	                                             bytes_per_pixel);
@@ -517,42 +574,21 @@ static uint8_t* draw_linear_line_from_dac_palette(Bitu vidstart, Bitu /*line*/)
 		        vga.draw.line_length - wrapped_len);
 
 		// Unwrapped chunk: to top of memory block
-		auto palette_index_end = palette_index_it +
-		                         std::min(unwrapped_len, pixels_remaining);
+		const auto num_unwrapped = std::min(unwrapped_len, pixels_remaining);
 
-		while (palette_index_it != palette_index_end) {
-			memcpy(line_addr,
-			       palette_map + *palette_index_it++,
-			       bytes_per_pixel);
-
-			line_addr += bytes_per_pixel;
-			--pixels_remaining;
-		}
+		line_addr = expand_from_dac_palette(palette_index_it,
+		                                    num_unwrapped,
+		                                    line_addr);
+		pixels_remaining = static_cast<uint16_t>(pixels_remaining -
+		                                         num_unwrapped);
 
 		// wrapped chunk: from the base of the memory block
-		palette_index_it  = vga.draw.linear_base;
-		palette_index_end = palette_index_it +
-		                    std::min(wrapped_len, pixels_remaining);
-
-		while (palette_index_it != palette_index_end) {
-			memcpy(line_addr,
-			       palette_map + *palette_index_it++,
-			       bytes_per_pixel);
-
-			line_addr += bytes_per_pixel;
-			--pixels_remaining;
-		}
+		expand_from_dac_palette(vga.draw.linear_base,
+		                        std::min(wrapped_len, pixels_remaining),
+		                        line_addr);
 
 	} else {
-		auto palette_index_end = palette_index_it + pixels_remaining;
-
-		while (palette_index_it != palette_index_end) {
-			memcpy(line_addr,
-			       palette_map + *palette_index_it++,
-			       bytes_per_pixel);
-
-			line_addr += bytes_per_pixel;
-		}
+		expand_from_dac_palette(palette_index_it, pixels_remaining, line_addr);
 	}
 	return TempLine;
 }
@@ -985,6 +1021,158 @@ static uint8_t* VGA_TEXT_Herc_Draw_Line(Bitu vidstart, Bitu line)
 	return TempLine;
 }
 
+// Expands one scanline of a text mode character cell to RGB888 pixels (8 or
+// 9 of them, depending on the dot width)
+static void expand_text_glyph_row(const uint8_t chr, const uint8_t attr,
+                                  const Bitu line, uint32_t* out)
+{
+	const auto palette_map = vga.dac.palette_map;
+
+	// The font pattern
+	uint16_t font = vga.draw.font_tables[(attr >> 3) & 1][(chr << 5) + line];
+
+	uint8_t bg_palette_idx = attr >> 4;
+	// If blinking is enabled bit7 is not mapped to attributes
+	//
+	if (vga.draw.blinking) {
+		bg_palette_idx &= ~0x8;
+	}
+
+	// Choose foreground color if blinking not set for this cell or
+	// blink on
+	const uint8_t fg_palette_idx = (vga.draw.blink || (attr & 0x80) == 0)
+	                                     ? (attr & 0xf)
+	                                     : bg_palette_idx;
+
+	// Underline: all foreground [freevga: 0x77, previous 0x7]
+	if (((attr & 0x77) == 0x01) && (vga.crtc.underline_location & 0x1f) == line) {
+
+		bg_palette_idx = fg_palette_idx;
+	}
+
+	// The font's bits will indicate which color is used per pixel
+	const auto fg_colour = palette_map[fg_palette_idx];
+	const auto bg_colour = palette_map[bg_palette_idx];
+
+	if (vga.seq.clocking_mode.is_eight_dot_mode) {
+		for (auto n = 0; n < 8; ++n) {
+			*out++ = (font & 0x80) ? fg_colour : bg_colour;
+			font <<= 1;
+		}
+	} else {
+		// 9 pixels
+		font <<= 1;
+
+		// Extend to the 9th pixel if needed
+		if ((font & 0x2) && vga.attr.mode_control.is_line_graphics_enabled &&
+		    (chr >= 0xc0) && (chr <= 0xdf)) {
+			font |= 1;
+		}
+
+		for (auto n = 0; n < 9; ++n) {
+			*out++ = (font & 0x100) ? fg_colour : bg_colour;
+			font <<= 1;
+		}
+	}
+}
+
+// Cache of expanded glyph rows keyed by character, attribute and scanline.
+// Text mode screens barely change from frame to frame, so most character
+// cells are drawn with a single copy.
+//
+// Everything else the pixels depend on invalidates the whole cache when it
+// changes: font and palette writes, the selected font tables, and the dot
+// width, line graphics, blink and underline settings.
+class TextGlyphCache {
+public:
+	static constexpr auto MaxPixelsPerRow = 9;
+
+	using GlyphRow = std::array<uint32_t, MaxPixelsPerRow>;
+
+	// Invalidates the cache if the drawing state has changed since the
+	// last call; to be called once per line
+	void Validate()
+	{
+		State current_state = {};
+
+		current_state.font_table_a       = vga.draw.font_tables[0];
+		current_state.font_table_b       = vga.draw.font_tables[1];
+		current_state.font_generation    = vga.draw.font_generation;
+		current_state.palette_generation = vga.dac.palette_generation;
+		current_state.blinking           = vga.draw.blinking;
+		current_state.blink              = vga.draw.blink;
+
+		current_state.is_eight_dot_mode =
+		        vga.seq.clocking_mode.is_eight_dot_mode;
+		current_state.is_line_graphics_enabled =
+		        vga.attr.mode_control.is_line_graphics_enabled;
+		current_state.underline_location = vga.crtc.underline_location &
+		                                   0x1f;
+
+		if (current_state != state) {
+			state = current_state;
+			++generation;
+		}
+	}
+
+	const GlyphRow& Get(const uint8_t chr, const uint8_t attr, const Bitu line)
+	{
+		// The font holds 32 scanlines per character
+		assert(line < 32);
+
+		const auto key = static_cast<uint32_t>(chr | (attr << 8) |
+		                                       (line << 16));
+
+		// Fibonacci hashing spreads neighbouring keys over the entries
+		auto& entry = entries[(key * 2654435769u) >> (32 - IndexBits)];
+
+		if (entry.key != key || entry.generation != generation) {
+			expand_text_glyph_row(chr, attr, line, entry.pixels.data());
+			entry.key        = key;
+			entry.generation = generation;
+		}
+		return entry.pixels;
+	}
+
+private:
+	struct State {
+		const uint8_t* font_table_a = nullptr;
+		const uint8_t* font_table_b = nullptr;
+
+		uint32_t font_generation    = 0;
+		uint32_t palette_generation = 0;
+
+		Bitu blinking = 0;
+		bool blink    = false;
+
+		uint8_t is_eight_dot_mode        = 0;
+		uint8_t is_line_graphics_enabled = 0;
+
+		uint8_t underline_location = 0;
+
+		bool operator==(const State&) const = default;
+	};
+
+	struct Entry {
+		uint32_t key        = 0;
+		uint32_t generation = 0;
+		GlyphRow pixels     = {};
+	};
+
+	// 4096 entries cover every cell of a 132x50 screen's scanline with
+	// room to spare
+	static constexpr auto IndexBits = 12;
+
+	std::array<Entry, 1 << IndexBits> entries = {};
+
+	State state = {};
+
+	// Starts above the entries' generation so none of them are valid
+	uint32_t generation = 1;
+};
+
+static TextGlyphCache text_glyph_cache = {};
+
 // Combined 8/9-dot wide text mode line drawing function
 static uint8_t* draw_text_line_from_dac_palette(Bitu vidstart, Bitu line)
 {
@@ -1004,68 +1192,25 @@ static uint8_t* draw_text_line_from_dac_palette(Bitu vidstart, Bitu line)
 	const uint16_t draw_idx_start = 8 + vga.draw.panning;
 
 	// This holds the to-be-written pixel offset, and is incremented per
-	// pixel and also per character block.
+	// character block.
 	auto draw_idx = draw_idx_start;
 
+	const auto pixels_per_row = vga.seq.clocking_mode.is_eight_dot_mode ? 8 : 9;
+
+	text_glyph_cache.Validate();
+
 	while (blocks--) {
 		// For each character in the line
 		const auto chr  = *vidmem++;
 		const auto attr = *vidmem++;
 
-		// The font pattern
-		uint16_t font = vga.draw.font_tables[(attr >> 3) & 1][(chr << 5) + line];
-
-		uint8_t bg_palette_idx = attr >> 4;
-		// If blinking is enabled bit7 is not mapped to attributes
-		//
-		if (vga.draw.blinking) {
-			bg_palette_idx &= ~0x8;
-		}
-
-		// Choose foreground color if blinking not set for this cell or
-		// blink on
-		const uint8_t fg_palette_idx = (vga.draw.blink || (attr & 0x80) == 0)
-		                                     ? (attr & 0xf)
-		                                     : bg_palette_idx;
+		const auto& glyph_row = text_glyph_cache.Get(chr, attr, line);
 
-		// Underline: all foreground [freevga: 0x77, previous 0x7]
-		if (((attr & 0x77) == 0x01) &&
-		    (vga.crtc.underline_location & 0x1f) == line) {
-
-			bg_palette_idx = fg_palette_idx;
-		}
+		memcpy(&TempLine[draw_idx * sizeof(uint32_t)],
+		       glyph_row.data(),
+		       pixels_per_row * sizeof(uint32_t));
 
-		// The font's bits will indicate which color is used per pixel
-		const auto fg_colour = palette_map[fg_palette_idx];
-		const auto bg_colour = palette_map[bg_palette_idx];
-
-		if (vga.seq.clocking_mode.is_eight_dot_mode) {
-			for (auto n = 0; n < 8; ++n) {
-				const auto color = (font & 0x80) ? fg_colour
-				                                 : bg_colour;
-
-				write_unaligned_uint32_at(TempLine, draw_idx++, color);
-				font <<= 1;
-			}
-		} else {
-			// 9 pixels
-			font <<= 1;
-
-			// Extend to the 9th pixel if needed
-			if ((font & 0x2) &&
-			    vga.attr.mode_control.is_line_graphics_enabled &&
-			    (chr >= 0xc0) && (chr <= 0xdf)) {
-				font |= 1;
-			}
-
-			for (auto n = 0; n < 9; ++n) {
-				const auto color = (font & 0x100) ? fg_colour
-				                                  : bg_colour;
-
-				write_unaligned_uint32_at(TempLine, draw_idx++, color);
-				font <<= 1;
-			}
-		}
+		draw_idx = static_cast<uint16_t>(draw_idx + pixels_per_row);
 	}
 
 	// Draw the text mode cursor if needed
@@ -1302,6 +1447,8 @@ static void VGA_DrawEGASingleLine([[maybe_unused]] uint32_t dummy)
 // All non EGA or VGA machine types draw the screen in four parts
 static void VGA_DrawPart(uint32_t lines)
 {
+	TRACE_SCOPE("VGA_DrawPart");
+
 	while (lines--) {
 		uint8_t* data = VGA_DrawLine(vga.draw.address, vga.draw.address_line);
 		ReelMagic_RENDER_DrawLine(data);
@@ -1335,6 +1482,8 @@ void VGA_SetBlinking(const uint8_t enabled)
 {
 	LOG(LOG_VGA, LOG_NORMAL)("Blinking %u", enabled);
 
+	vga.draw.is_frame_dirty = true;
+
 	if (enabled) {
 		vga.draw.blinking = 1; // used to -1 but blinking is unsigned
 		vga.attr.mode_control.is_blink_enabled = 1;
@@ -1385,6 +1534,41 @@ static void VGA_PanningLatch(uint32_t /*val*/)
 	vga.draw.panning = vga.config.pel_panning;
 }
 
+static bool is_frame_in_progress()
+{
+	return (vga.draw.mode == DrawMode::Part)
+	             ? (vga.draw.parts_left > 0)
+	             : (vga.draw.lines_done < vga.draw.lines_total);
+}
+
+// Returns true if the next frame would look exactly like the one on screen,
+// in which case drawing it can be skipped altogether
+static bool can_skip_frame()
+{
+	if (vga.draw.is_frame_dirty || !vga.draw.is_write_tracking_reliable) {
+		return false;
+	}
+
+	// Let a frame that's still being drawn finish as usual
+	if (is_frame_in_progress()) {
+		return false;
+	}
+
+	// MPEG playback and captures need every frame
+	return !ReelMagic_IsVideoMixerEnabled() && !RENDER_IsFrameUpdateRequired();
+}
+
+// Frames can be skipped while fast-forwarding or when the host can't keep
+// up. The retrace timings carry on as usual, and the skipped frames keep the
+// dirty flag, so the next drawn frame picks up their changes.
+static bool is_skipping_frame()
+{
+	if (is_frame_in_progress() || ReelMagic_IsVideoMixerEnabled()) {
+		return false;
+	}
+	return RENDER_IsSkippingFrame();
+}
+
 static void VGA_VerticalTimer(uint32_t /*val*/)
 {
 	vga.draw.delay.framestart = PIC_FullIndex();
@@ -1430,10 +1614,21 @@ static void VGA_VerticalTimer(uint32_t /*val*/)
 
 	++vga.draw.cursor.count;
 
-	if (vga.draw.vga_override || !ReelMagic_RENDER_StartUpdate()) {
+	// The text mode cursor and blinking attributes toggle every 16 frames.
+	// Redrawing then also catches any other time-dependent output.
+	if ((vga.draw.cursor.count & 0xf) == 0) {
+		vga.draw.is_frame_dirty = true;
+	}
+
+	if (vga.draw.vga_override || can_skip_frame() ||
+	    is_skipping_frame() || !ReelMagic_RENDER_StartUpdate()) {
 		return;
 	}
 
+	// Writes from now on are picked up by the next frame
+	vga.draw.is_frame_dirty = false;
+	VGA_TrapDirectWrites();
+
 	vga.draw.address_line = vga.config.hlines_skip;
 
 	if (is_machine_ega_or_better()) {
@@ -3267,6 +3462,8 @@ ImageInfo setup_drawing()
 
 void VGA_SetupDrawing(uint32_t /*val*/)
 {
+	vga.draw.is_frame_dirty = true;
+
 	if (vga.mode == M_ERROR) {
 		PIC_RemoveEvents(VGA_VerticalTimer);
 		PIC_RemoveEvents(VGA_PanningLatch);
@@ -24,6 +24,9 @@ static uint8_t read_p3ce(io_port_t, io_width_t)
 static void write_p3cf(io_port_t, io_val_t value, io_width_t)
 {
 	const auto val = check_cast<uint8_t>(value);
+
+	vga.draw.is_frame_dirty = true;
+
 	switch (gfx(index)) {
 	case 0:	/* Set/Reset Register */
 		gfx(set_reset)=val & 0x0f;
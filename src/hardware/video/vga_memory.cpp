@@ -4,8 +4,10 @@
 
 #include "dosbox.h"
 
+#include <array>
 #include <cstdlib>
 #include <cstring>
+#include <utility>
 #include <vector>
 
 #include "vga.h"
@@ -16,6 +18,7 @@
 #include "hardware/memory.h"
 #include "hardware/pic.h"
 #include "hardware/port.h"
+#include "misc/host_memory.h"
 #include "utils/mem_host.h"
 #include "utils/string_utils.h"
 
@@ -93,6 +96,144 @@ inline static uint32_t ModeOperation(uint8_t val) {
 	return full;
 }
 
+// Planar writes specialised for each combination of the Graphics Controller's
+// write mode and logical operation, so the per-byte path has no branches. The
+// specialisation is looked up from the two register fields once per access,
+// and a 16 or 32-bit access writes all its bytes in that one call.
+template <uint8_t RasterOpcode>
+static inline uint32_t raster_op(const uint32_t input, const uint32_t mask)
+{
+	if constexpr (RasterOpcode == 0) { // None
+		return (input & mask) | (vga.latch.d & ~mask);
+	} else if constexpr (RasterOpcode == 1) { // AND
+		return (input | ~mask) & vga.latch.d;
+	} else if constexpr (RasterOpcode == 2) { // OR
+		return (input & mask) | vga.latch.d;
+	} else { // XOR
+		return (input & mask) ^ vga.latch.d;
+	}
+}
+
+static inline uint8_t rotate_data(const uint8_t val)
+{
+	return static_cast<uint8_t>((val >> vga.config.data_rotate) |
+	                            (val << (8 - vga.config.data_rotate)));
+}
+
+// See ModeOperation() for the description of the write modes
+template <uint8_t WriteMode, uint8_t RasterOpcode>
+static inline uint32_t mode_operation(const uint8_t val)
+{
+	if constexpr (WriteMode == 0) {
+		const auto full = (ExpandTable[rotate_data(val)] &
+		                   vga.config.full_not_enable_set_reset) |
+		                  vga.config.full_enable_and_set_reset;
+		return raster_op<RasterOpcode>(full, vga.config.full_bit_mask);
+	} else if constexpr (WriteMode == 1) {
+		return vga.latch.d;
+	} else if constexpr (WriteMode == 2) {
+		return raster_op<RasterOpcode>(FillTable[val & 0xf],
+		                               vga.config.full_bit_mask);
+	} else {
+		return raster_op<RasterOpcode>(vga.config.full_set_reset,
+		                               ExpandTable[rotate_data(val)] &
+		                                       vga.config.full_bit_mask);
+	}
+}
+
+// Writes the bytes of 'val', lowest first, to the planar addresses from
+// 'start', and returns the four planes of the last one
+template <uint8_t WriteMode, uint8_t RasterOpcode>
+static inline uint32_t write_planes(const PhysPt start, const uint32_t val,
+                                    const int num_bytes, uint32_t* planes)
+{
+	uint32_t pixels = 0;
+	for (auto i = 0; i < num_bytes; ++i) {
+		const auto data = mode_operation<WriteMode, RasterOpcode>(
+		        static_cast<uint8_t>(val >> (i * 8)));
+
+		pixels = (planes[start + i] & vga.config.full_not_map_mask) |
+		         (data & vga.config.full_map_mask);
+		planes[start + i] = pixels;
+	}
+	return pixels;
+}
+
+// Updates the pixel buffer of the EGA modes from the four planes of a byte
+static inline void update_ega_pixels(const PhysPt start, const uint32_t planes)
+{
+	uint8_t* write_pixels = &vga.fastmem[start << 3];
+
+	VgaLatch temp;
+	temp.d = (planes >> 4) & 0x0f0f0f0f;
+
+	const uint32_t colors0_3 = Expand16Table[0][temp.b[0]] |
+	                           Expand16Table[1][temp.b[1]] |
+	                           Expand16Table[2][temp.b[2]] |
+	                           Expand16Table[3][temp.b[3]];
+	*(uint32_t*)write_pixels = colors0_3;
+
+	temp.d = planes & 0x0f0f0f0f;
+
+	const uint32_t colors4_7 = Expand16Table[0][temp.b[0]] |
+	                           Expand16Table[1][temp.b[1]] |
+	                           Expand16Table[2][temp.b[2]] |
+	                           Expand16Table[3][temp.b[3]];
+	*(uint32_t*)(write_pixels + 4) = colors4_7;
+}
+
+template <uint8_t WriteMode, uint8_t RasterOpcode>
+static void write_unchained_vga(const PhysPt start, const uint32_t val,
+                                const int num_bytes)
+{
+	auto planes = reinterpret_cast<uint32_t*>(vga.mem.linear);
+	write_planes<WriteMode, RasterOpcode>(start, val, num_bytes, planes);
+}
+
+template <uint8_t WriteMode, uint8_t RasterOpcode>
+static void write_unchained_ega(const PhysPt start, const uint32_t val,
+                                const int num_bytes)
+{
+	auto planes = reinterpret_cast<uint32_t*>(vga.mem.linear);
+	for (auto i = 0; i < num_bytes; ++i) {
+		const auto pixels = write_planes<WriteMode, RasterOpcode>(
+		        start + i, val >> (i * 8), 1, planes);
+		update_ega_pixels(start + i, pixels);
+	}
+}
+
+using PlanarWriter = void (*)(const PhysPt start, const uint32_t val,
+                              const int num_bytes);
+
+// Indexed by write mode * 4 + logical operation
+constexpr size_t NumPlanarWriters = 16;
+
+template <size_t... Indexes>
+static constexpr std::array<PlanarWriter, NumPlanarWriters> make_unchained_vga_writers(
+        std::index_sequence<Indexes...>)
+{
+	return {&write_unchained_vga<Indexes / 4, Indexes % 4>...};
+}
+
+template <size_t... Indexes>
+static constexpr std::array<PlanarWriter, NumPlanarWriters> make_unchained_ega_writers(
+        std::index_sequence<Indexes...>)
+{
+	return {&write_unchained_ega<Indexes / 4, Indexes % 4>...};
+}
+
+static constexpr auto unchained_vga_writers = make_unchained_vga_writers(
+        std::make_index_sequence<NumPlanarWriters>());
+
+static constexpr auto unchained_ega_writers = make_unchained_ega_writers(
+        std::make_index_sequence<NumPlanarWriters>());
+
+static inline PlanarWriter get_planar_writer(
+        const std::array<PlanarWriter, NumPlanarWriters>& writers)
+{
+	return writers[(vga.config.write_mode & 3) * 4 + (vga.config.raster_op & 3)];
+}
+
 /* Gonna assume that whoever maps vga memory, maps it on 32/64kb boundary */
 
 #define VGA_PAGES		(128/4)
@@ -114,8 +255,11 @@ static void read_delay()
 	}
 }
 
+// Called by every handler that traps video memory writes
 static void write_delay()
 {
+	vga.draw.is_frame_dirty = true;
+
 	if (vga.vmem_delay_ns > 0) {
 		const int32_t delay_cycles = (CPU_CycleMax * vga.vmem_delay_ns * 3) /
 		                             (1000000 * 4);
@@ -276,32 +420,10 @@ public:
 
 class VGA_UnchainedEGA_Handler : public VGA_UnchainedRead_Handler {
 public:
-	void writeHandler(PhysPt start, uint8_t val) {
-		uint32_t data=ModeOperation(val);
-		/* Update video memory and the pixel buffer */
-		VgaLatch pixels;
-		pixels.d=((uint32_t*)vga.mem.linear)[start];
-		pixels.d&=vga.config.full_not_map_mask;
-		pixels.d|=(data & vga.config.full_map_mask);
-		((uint32_t*)vga.mem.linear)[start]=pixels.d;
-		uint8_t * write_pixels=&vga.fastmem[start<<3];
-
-		uint32_t colors0_3, colors4_7;
-		VgaLatch temp;
-		temp.d=(pixels.d>>4) & 0x0f0f0f0f;
-			colors0_3 = 
-			Expand16Table[0][temp.b[0]] |
-			Expand16Table[1][temp.b[1]] |
-			Expand16Table[2][temp.b[2]] |
-			Expand16Table[3][temp.b[3]];
-		*(uint32_t *)write_pixels=colors0_3;
-		temp.d=pixels.d & 0x0f0f0f0f; //-V519
-		colors4_7 = 
-			Expand16Table[0][temp.b[0]] |
-			Expand16Table[1][temp.b[1]] |
-			Expand16Table[2][temp.b[2]] |
-			Expand16Table[3][temp.b[3]];
-		*(uint32_t *)(write_pixels+4)=colors4_7;
+	// Update video memory and the pixel buffer
+	void writeHandler(PhysPt start, uint32_t val, int num_bytes)
+	{
+		get_planar_writer(unchained_ega_writers)(start, val, num_bytes);
 	}
 public:	
 	VGA_UnchainedEGA_Handler()  {
@@ -315,7 +437,7 @@ public:
 		addr += vga.svga.bank_write_full;
 		addr = CHECKED2(addr);
 		MEM_CHANGED( addr << 3);
-		writeHandler(addr+0,(uint8_t)(val >> 0));
+		writeHandler(addr, val, 1);
 	}
 
 	void writew(PhysPt addr, uint16_t val) override
@@ -325,8 +447,7 @@ public:
 		addr += vga.svga.bank_write_full;
 		addr = CHECKED2(addr);
 		MEM_CHANGED( addr << 3);
-		writeHandler(addr+0,(uint8_t)(val >> 0));
-		writeHandler(addr+1,(uint8_t)(val >> 8));
+		writeHandler(addr, val, 2);
 	}
 
 	void writed(PhysPt addr, uint32_t val) override
@@ -336,10 +457,7 @@ public:
 		addr += vga.svga.bank_write_full;
 		addr = CHECKED2(addr);
 		MEM_CHANGED( addr << 3);
-		writeHandler(addr+0,(uint8_t)(val >> 0));
-		writeHandler(addr+1,(uint8_t)(val >> 8));
-		writeHandler(addr+2,(uint8_t)(val >> 16));
-		writeHandler(addr+3,(uint8_t)(val >> 24));
+		writeHandler(addr, val, 4);
 	}
 };
 
@@ -503,13 +621,9 @@ public:
 
 class VGA_UnchainedVGA_Handler final : public VGA_UnchainedRead_Handler {
 public:
-	void writeHandler( PhysPt addr, uint8_t val ) {
-		uint32_t data=ModeOperation(val);
-		VgaLatch pixels;
-		pixels.d=((uint32_t*)vga.mem.linear)[addr];
-		pixels.d&=vga.config.full_not_map_mask;
-		pixels.d|=(data & vga.config.full_map_mask);
-		((uint32_t*)vga.mem.linear)[addr]=pixels.d;
+	void writeHandler(PhysPt addr, uint32_t val, int num_bytes)
+	{
+		get_planar_writer(unchained_vga_writers)(addr, val, num_bytes);
 //		if(vga.config.compatible_chain4)
 //			((uint32_t*)vga.mem.linear)[CHECKED2(addr+64*1024)]=pixels.d; 
 	}
@@ -525,7 +639,7 @@ public:
 		addr += vga.svga.bank_write_full;
 		addr = CHECKED2(addr);
 		MEM_CHANGED( addr << 2 );
-		writeHandler(addr+0,(uint8_t)(val >> 0));
+		writeHandler(addr, val, 1);
 	}
 
 	void writew(PhysPt addr, uint16_t val) override
@@ -535,8 +649,7 @@ public:
 		addr += vga.svga.bank_write_full;
 		addr = CHECKED2(addr);
 		MEM_CHANGED( addr << 2);
-		writeHandler(addr+0,(uint8_t)(val >> 0));
-		writeHandler(addr+1,(uint8_t)(val >> 8));
+		writeHandler(addr, val, 2);
 	}
 
 	void writed(PhysPt addr, uint32_t val) override
@@ -546,10 +659,7 @@ public:
 		addr += vga.svga.bank_write_full;
 		addr = CHECKED2(addr);
 		MEM_CHANGED( addr << 2);
-		writeHandler(addr+0,(uint8_t)(val >> 0));
-		writeHandler(addr+1,(uint8_t)(val >> 8));
-		writeHandler(addr+2,(uint8_t)(val >> 16));
-		writeHandler(addr+3,(uint8_t)(val >> 24));
+		writeHandler(addr, val, 4);
 	}
 };
 
@@ -582,9 +692,12 @@ public:
 
 		if (vga.seq.map_mask == 0x4) {
 			vga.draw.font[addr] = val;
+			++vga.draw.font_generation;
 		} else {
-			if (vga.seq.map_mask & 0x4) // font map
+			if (vga.seq.map_mask & 0x4) { // font map
 				vga.draw.font[addr] = val;
+				++vga.draw.font_generation;
+			}
 			if (vga.seq.map_mask & 0x2) // character attribute
 				vga.mem.linear[CHECKED3(vga.svga.bank_read_full +
 				                        addr + 1)] = val;
@@ -609,6 +722,50 @@ public:
 	}
 };
 
+static void untrap_direct_writes();
+
+// Like the map handler, but only for direct reads; see
+// 'are_direct_writes_trapped'
+class VGA_MapFirstWrite_Handler final : public PageHandler {
+public:
+	VGA_MapFirstWrite_Handler() {
+		flags=PFLAG_READABLE|PFLAG_NOCODE;
+	}
+	HostPt GetHostReadPt(Bitu phys_page) override {
+		phys_page-=vgapages.base;
+		return &vga.mem.linear[CHECKED3(vga.svga.bank_read_full+phys_page*4096)];
+	}
+
+	void writeb(PhysPt addr, uint8_t val) override
+	{
+		const auto offset = GetWriteOffset(addr);
+		untrap_direct_writes();
+		host_writeb(&vga.mem.linear[offset], val);
+	}
+
+	void writew(PhysPt addr, uint16_t val) override
+	{
+		const auto offset = GetWriteOffset(addr);
+		untrap_direct_writes();
+		host_writew_at(vga.mem.linear, offset, val);
+	}
+
+	void writed(PhysPt addr, uint32_t val) override
+	{
+		const auto offset = GetWriteOffset(addr);
+		untrap_direct_writes();
+		host_writed_at(vga.mem.linear, offset, val);
+	}
+
+private:
+	static PhysPt GetWriteOffset(const PhysPt addr)
+	{
+		const auto offset = vga.svga.bank_write_full +
+		                    (PAGING_GetPhysicalAddress(addr) & vgapages.mask);
+		return CHECKED(offset);
+	}
+};
+
 class VGA_Changes_Handler final : public PageHandler {
 public:
 	VGA_Changes_Handler() {
@@ -683,7 +840,7 @@ public:
 		addr = vga.svga.bank_write_full + (PAGING_GetPhysicalAddress(addr) & 0xffff);
 		addr = CHECKED4(addr);
 		MEM_CHANGED( addr << 3 );
-		writeHandler(addr+0,(uint8_t)(val >> 0));
+		writeHandler(addr, val, 1);
 	}
 
 	void writew(PhysPt addr, uint16_t val) override
@@ -692,8 +849,7 @@ public:
 		addr = vga.svga.bank_write_full + (PAGING_GetPhysicalAddress(addr) & 0xffff);
 		addr = CHECKED4(addr);
 		MEM_CHANGED( addr << 3 );
-		writeHandler(addr+0,(uint8_t)(val >> 0));
-		writeHandler(addr+1,(uint8_t)(val >> 8));
+		writeHandler(addr, val, 2);
 	}
 
 	void writed(PhysPt addr, uint32_t val) override
@@ -702,10 +858,7 @@ public:
 		addr = vga.svga.bank_write_full + (PAGING_GetPhysicalAddress(addr) & 0xffff);
 		addr = CHECKED4(addr);
 		MEM_CHANGED( addr << 3 );
-		writeHandler(addr+0,(uint8_t)(val >> 0));
-		writeHandler(addr+1,(uint8_t)(val >> 8));
-		writeHandler(addr+2,(uint8_t)(val >> 16));
-		writeHandler(addr+3,(uint8_t)(val >> 24));
+		writeHandler(addr, val, 4);
 	}
 
 	uint8_t readb(PhysPt addr) override
@@ -810,6 +963,46 @@ public:
 	}
 };
 
+// Like the LFB handler, but only for direct reads; see
+// 'are_direct_writes_trapped'
+class VGA_LFBFirstWrite_Handler final : public PageHandler {
+public:
+	VGA_LFBFirstWrite_Handler() {
+		flags=PFLAG_READABLE|PFLAG_NOCODE;
+	}
+	HostPt GetHostReadPt( Bitu phys_page ) override {
+		phys_page -= vga.lfb.page;
+		return &vga.mem.linear[CHECKED3(phys_page * 4096)];
+	}
+
+	void writeb(PhysPt addr, uint8_t val) override
+	{
+		const auto offset = GetWriteOffset(addr);
+		untrap_direct_writes();
+		host_writeb(&vga.mem.linear[offset], val);
+	}
+
+	void writew(PhysPt addr, uint16_t val) override
+	{
+		const auto offset = GetWriteOffset(addr);
+		untrap_direct_writes();
+		host_writew_at(vga.mem.linear, offset, val);
+	}
+
+	void writed(PhysPt addr, uint32_t val) override
+	{
+		const auto offset = GetWriteOffset(addr);
+		untrap_direct_writes();
+		host_writed_at(vga.mem.linear, offset, val);
+	}
+
+private:
+	static PhysPt GetWriteOffset(const PhysPt addr)
+	{
+		return CHECKED(PAGING_GetPhysicalAddress(addr) - vga.lfb.addr);
+	}
+};
+
 extern void XGA_Write(io_port_t port, io_val_t value, io_width_t width);
 extern uint32_t XGA_Read(io_port_t port, io_width_t width);
 
@@ -944,7 +1137,9 @@ static struct vg {
 	VGA_PCJR_Handler pcjr = {};
 	VGA_HERC_Handler herc = {};
 	VGA_LIN4_Handler lin4 = {};
+	VGA_MapFirstWrite_Handler mapfirstwrite = {};
 	VGA_LFB_Handler lfb = {};
+	VGA_LFBFirstWrite_Handler lfbfirstwrite = {};
 	VGA_LFBChanges_Handler lfbchanges = {};
 	VGA_MMIO_Handler mmio = {};
 	VGA_Empty_Handler empty = {};
@@ -960,11 +1155,30 @@ void VGA_ChangedBank(void) {
 	VGA_SetupHandlers();
 }
 
+// Set up by VGA_SetupHandlers() for swapping the handlers of the directly
+// mapped VESA framebuffer when the first write of a frame is (un)trapped
+static bool is_window_mapped_directly = false;
+static bool can_track_window_writes   = false;
+
 void VGA_SetupHandlers(void) {
 	vga.svga.bank_read_full = vga.svga.bank_read*vga.svga.bank_size;
 	vga.svga.bank_write_full = vga.svga.bank_write*vga.svga.bank_size;
 
 	PageHandler *newHandler;
+
+	// The directly mapped VESA framebuffer can trap the first write of
+	// each frame
+	PageHandler* direct_handler = &vgaph.map;
+	if (vga.draw.are_direct_writes_trapped) {
+		direct_handler = &vgaph.mapfirstwrite;
+	}
+
+	// Only the EGA and VGA handlers below trap all writes
+	vga.draw.is_write_tracking_reliable = false;
+
+	is_window_mapped_directly = false;
+	can_track_window_writes   = false;
+
 	switch (machine) {
 	case MachineType::CgaMono:
 	case MachineType::CgaColor:
@@ -1029,7 +1243,8 @@ void VGA_SetupHandlers(void) {
 	case M_LIN24:
 	case M_LIN32:
 #ifdef VGA_LFB_MAPPED
-		newHandler = &vgaph.map;
+		newHandler = direct_handler;
+		is_window_mapped_directly = true;
 #else
 		newHandler = &vgaph.changes;
 #endif
@@ -1039,12 +1254,14 @@ void VGA_SetupHandlers(void) {
 		if (vga.config.chained) {
 			if(vga.config.compatible_chain4)
 				newHandler = &vgaph.cvga;
-			else 
+			else {
 #ifdef VGA_LFB_MAPPED
-				newHandler = &vgaph.map;
+				newHandler = direct_handler;
+				is_window_mapped_directly = true;
 #else
 				newHandler = &vgaph.changes;
 #endif
+			}
 		} else {
 			newHandler = &vgaph.uvga;
 		}
@@ -1065,6 +1282,15 @@ void VGA_SetupHandlers(void) {
 		newHandler = &vgaph.map;
 		break;
 	}
+
+	// The directly mapped pages can't see the writes. The VESA
+	// framebuffer only can while the first write of the frame is trapped,
+	// which is all that's needed to know whether the frame has changed.
+	can_track_window_writes = (newHandler != &vgaph.map) ||
+	                          is_window_mapped_directly;
+
+	vga.draw.is_write_tracking_reliable = can_track_window_writes &&
+	                                      vga.draw.are_direct_writes_trapped;
 	switch ((vga.gfx.miscellaneous >> 2) & 3) {
 	case 0:
 		vgapages.base = VGA_PAGE_A0;
@@ -1112,13 +1338,72 @@ void VGA_StartUpdateLFB(void) {
 	vga.lfb.page = vga.s3.la_window << 4;
 	vga.lfb.addr = vga.s3.la_window << 16;
 #ifdef VGA_LFB_MAPPED
-	vga.lfb.handler = &vgaph.lfb;
+	if (vga.draw.are_direct_writes_trapped) {
+		vga.lfb.handler = &vgaph.lfbfirstwrite;
+	} else {
+		vga.lfb.handler = &vgaph.lfb;
+	}
 #else
 	vga.lfb.handler = &vgaph.lfbchanges;
 #endif
 	MEM_SetLFB(vga.lfb.page, vga.vmemsize / 4096, vga.lfb.handler, &vgaph.mmio);
 }
 
+// Swaps only the handlers of the directly mapped VESA framebuffer pages and
+// unlinks only their TLB entries, so the rest of the TLB stays intact
+static void update_direct_handlers()
+{
+	const auto is_trapped = vga.draw.are_direct_writes_trapped;
+
+	vga.draw.is_write_tracking_reliable = can_track_window_writes && is_trapped;
+
+#ifdef VGA_LFB_MAPPED
+	if (is_window_mapped_directly) {
+		PageHandler* from = &vgaph.map;
+		PageHandler* to   = &vgaph.mapfirstwrite;
+		if (!is_trapped) {
+			std::swap(from, to);
+		}
+
+		// The S3 MMIO window can take over part of the range
+		for (Bitu page = VGA_PAGE_A0; page < VGA_PAGE_A0 + 32; ++page) {
+			if (MEM_GetPageHandler(page) == from) {
+				MEM_SetPageHandler(page, 1, to);
+			}
+		}
+		PAGING_UnlinkPhysPages(VGA_PAGE_A0, 32);
+	}
+
+	// The LFB is only set up by the S3 cards
+	if (vga.lfb.handler) {
+		if (is_trapped) {
+			vga.lfb.handler = &vgaph.lfbfirstwrite;
+		} else {
+			vga.lfb.handler = &vgaph.lfb;
+		}
+		MEM_SetLFBHandler(vga.lfb.handler);
+	}
+#endif
+}
+
+static void untrap_direct_writes()
+{
+	vga.draw.is_frame_dirty            = true;
+	vga.draw.are_direct_writes_trapped = false;
+
+	update_direct_handlers();
+}
+
+void VGA_TrapDirectWrites()
+{
+	if (vga.draw.are_direct_writes_trapped) {
+		return;
+	}
+	vga.draw.are_direct_writes_trapped = true;
+
+	update_direct_handlers();
+}
+
 void VGA_DestroyMemory()
 {
 #ifdef VGA_KEEP_CHANGES
@@ -1208,6 +1493,10 @@ void VGA_SetupMemory()
 	                                                           num_fastmem_bytes);
 	assert(reinterpret_cast<uintptr_t>(vga.fastmem) % vmem_alignment == 0);
 
+	HOST_MEMORY_AddSubsystem("Video memory", [=] {
+		return num_linear_bytes + num_fastmem_bytes;
+	});
+
 	// In most cases these values stay the same. Assumptions: vmemwrap is power of 2,
 	// vmemwrap <= vmemsize, fastmem implicitly has mem wrap twice as big
 	vga.vmemwrap = vga.vmemsize;
@@ -23,6 +23,9 @@ void write_p3c4(io_port_t, io_val_t value, io_width_t)
 void write_p3c5(io_port_t, io_val_t value, io_width_t)
 {
 	auto val = check_cast<uint8_t>(value);
+
+	vga.draw.is_frame_dirty = true;
+
 	//	LOG_MSG("SEQ WRITE reg %X val %X",seq(index),val);
 	switch (seq(index)) {
 	case 0: /* Reset */ seq(reset) = val; break;
@@ -4,10 +4,12 @@
 
 #include "dosbox.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdio>
 #include <cstring>
+#include <optional>
 
 #include "vga.h"
 
@@ -270,6 +272,248 @@ static Bitu GetMixResult(uint32_t mixmode, Bitu srcval, Bitu dstdata)
 	return destval;
 }
 
+// Fast paths for the rectangle, blit and pattern commands. When the result
+// of a row doesn't depend on the pixels already in the destination, the row
+// is written with bulk memory operations instead of one XGA_DrawPoint call
+// per pixel. The rows come out the same as when drawn pixel by pixel; rows
+// the fast paths can't reproduce exactly are left to the per-pixel loops.
+
+static int get_bytes_per_pixel()
+{
+	switch (XGA_COLOR_MODE) {
+	case M_LIN8: return 1;
+	case M_LIN15:
+	case M_LIN16: return 2;
+	case M_LIN32: return 4;
+	default: break;
+	}
+	return 0;
+}
+
+// Whether the pixels would be written at all, see XGA_DrawPoint
+static bool is_drawing_enabled()
+{
+	return (xga.curcommand & 0x1) && (xga.curcommand & 0x10);
+}
+
+// The mixes that don't read the destination
+static bool is_dst_independent_mix(const uint32_t mixmode)
+{
+	switch (mixmode & 0xf) {
+	case 0x01: /* 0 (false) */
+	case 0x02: /* 1 (true) */
+	case 0x04: /* not SRC */
+	case 0x07: /* SRC */ return true;
+	default: return false;
+	}
+}
+
+// The value XGA_DrawPoint stores for the given colour
+static uint32_t to_pixel_value(const Bitu c)
+{
+	if (XGA_COLOR_MODE == M_LIN15) {
+		return static_cast<uint32_t>(c & 0x7fff);
+	}
+	return static_cast<uint32_t>(c & get_point_mask());
+}
+
+// A run of pixels in a row of video memory, left to right
+struct XGASpan {
+	int x          = 0;
+	int y          = 0;
+	int num_pixels = 0;
+};
+
+// Clips a span to the scissors rectangle; the span can end up empty. The
+// number of pixels cut off on the left is returned.
+static int clip_to_scissors(XGASpan& span)
+{
+	if (span.y < xga.scissors.y1 || span.y > xga.scissors.y2) {
+		span.num_pixels = 0;
+		return 0;
+	}
+	const auto x_start = std::max(span.x, static_cast<int>(xga.scissors.x1));
+	const auto x_end = std::min(span.x + span.num_pixels - 1,
+	                            static_cast<int>(xga.scissors.x2));
+
+	const auto num_clipped = x_start - span.x;
+
+	span.x          = x_start;
+	span.num_pixels = std::max(x_end - x_start + 1, 0);
+	return num_clipped;
+}
+
+// Linear pixel offset of a span in video memory, or -1 if any of its pixels
+// are outside (which XGA_GetPoint and XGA_DrawPoint treat pixel by pixel)
+static int64_t get_span_offset(const XGASpan& span)
+{
+	const auto offset = static_cast<int64_t>(span.y) * XGA_SCREEN_WIDTH + span.x;
+	const auto end    = (offset + span.num_pixels) * get_bytes_per_pixel();
+
+	if (offset < 0 || end > vga.vmemsize) {
+		return -1;
+	}
+	return offset;
+}
+
+static uint8_t* get_pixel_pointer(const int64_t offset)
+{
+	return vga.mem.linear + offset * get_bytes_per_pixel();
+}
+
+static void fill_pixels(uint8_t* dest, const int num_pixels, const uint32_t value)
+{
+	switch (get_bytes_per_pixel()) {
+	case 1: memset(dest, static_cast<int>(value), num_pixels); break;
+	case 2:
+		std::fill_n(reinterpret_cast<uint16_t*>(dest),
+		            num_pixels,
+		            static_cast<uint16_t>(value));
+		break;
+	case 4: std::fill_n(reinterpret_cast<uint32_t*>(dest), num_pixels, value); break;
+	default: break;
+	}
+}
+
+static void write_pixel(uint8_t* dest, const int index, const uint32_t value)
+{
+	switch (get_bytes_per_pixel()) {
+	case 1: dest[index] = static_cast<uint8_t>(value); break;
+	case 2:
+		reinterpret_cast<uint16_t*>(dest)[index] = static_cast<uint16_t>(value);
+		break;
+	case 4: reinterpret_cast<uint32_t*>(dest)[index] = value; break;
+	default: break;
+	}
+}
+
+// Fills the span with a constant colour; returns false if the per-pixel path
+// has to draw it
+static bool fill_span(XGASpan span, const uint32_t value)
+{
+	clip_to_scissors(span);
+	if (span.num_pixels == 0) {
+		return true;
+	}
+	const auto offset = get_span_offset(span);
+	if (offset < 0) {
+		return false;
+	}
+	fill_pixels(get_pixel_pointer(offset), span.num_pixels, value);
+	return true;
+}
+
+// Fills the span with a row of an 8-pixel wide pattern, indexed by the low
+// three bits of the x coordinate. The pattern row was read from video memory
+// at 'pattern_offset'; if the span overwrites it, the per-pixel path has to
+// draw it, as it reads the pattern pixel by pixel. Returns false in that
+// case.
+static bool fill_span_with_pattern(XGASpan span, const uint32_t (&values)[8],
+                                   const int64_t pattern_offset)
+{
+	clip_to_scissors(span);
+	if (span.num_pixels == 0) {
+		return true;
+	}
+	const auto offset = get_span_offset(span);
+	if (offset < 0) {
+		return false;
+	}
+	if (pattern_offset < offset + span.num_pixels && offset < pattern_offset + 8) {
+		return false;
+	}
+	auto dest = get_pixel_pointer(offset);
+
+	const auto num_first = std::min(span.num_pixels, 8);
+	for (auto i = 0; i < num_first; ++i) {
+		write_pixel(dest, i, values[(span.x + i) & 0x7]);
+	}
+
+	// Repeat the first eight pixels, doubling the copied run each time so
+	// the pattern phase is kept
+	const auto bytes_per_pixel = get_bytes_per_pixel();
+
+	auto num_done = num_first;
+	while (num_done < span.num_pixels) {
+		const auto num_copy = std::min(num_done, span.num_pixels - num_done);
+		memcpy(dest + num_done * bytes_per_pixel, dest, num_copy * bytes_per_pixel);
+		num_done += num_copy;
+	}
+	return true;
+}
+
+// Copies a span of pixels from 'src_x', 'src_y' to the destination span.
+// 'dx' is the direction the per-pixel path walks in; overlapping copies
+// that would smear in that direction are left to it. Returns false if the
+// per-pixel path has to draw it.
+static bool copy_span(XGASpan span, const int src_x, const int src_y, const int dx)
+{
+	const auto num_clipped = clip_to_scissors(span);
+	if (span.num_pixels == 0) {
+		return true;
+	}
+
+	const XGASpan src_span = {src_x + num_clipped, src_y, span.num_pixels};
+
+	const auto dest_offset = get_span_offset(span);
+	const auto src_offset  = get_span_offset(src_span);
+	if (dest_offset < 0 || src_offset < 0) {
+		return false;
+	}
+
+	const auto overlaps = dest_offset < src_offset + span.num_pixels &&
+	                      src_offset < dest_offset + span.num_pixels;
+	if (overlaps && ((dx > 0) ? dest_offset > src_offset
+	                          : dest_offset < src_offset)) {
+		return false;
+	}
+
+	auto dest = get_pixel_pointer(dest_offset);
+	memmove(dest,
+	        get_pixel_pointer(src_offset),
+	        static_cast<size_t>(span.num_pixels) * get_bytes_per_pixel());
+
+	// The unused top bit is cleared when drawing 15-bit pixels
+	if (XGA_COLOR_MODE == M_LIN15) {
+		const auto pixels = reinterpret_cast<uint16_t*>(dest);
+		for (auto i = 0; i < span.num_pixels; ++i) {
+			pixels[i] &= 0x7fff;
+		}
+	}
+	return true;
+}
+
+// The span covered by 'num_pixels' pixels starting at 'x' and walking in
+// direction 'dx'
+static XGASpan make_span(const Bits x, const Bits y, const int num_pixels,
+                         const Bits dx)
+{
+	const auto start_x = (dx > 0) ? x : x - (num_pixels - 1);
+	return {static_cast<int>(start_x), static_cast<int>(y), num_pixels};
+}
+
+// Whether the pattern fast path can evaluate a mix once per pattern pixel
+static bool is_pattern_mix(const uint32_t mixmode)
+{
+	/* Src from the PIX_TRANS register isn't supported */
+	return is_dst_independent_mix(mixmode) && ((mixmode >> 5) & 0x03) != 0x02;
+}
+
+// The colour a constant-source mix produces, if it has one
+static std::optional<uint32_t> get_fill_value(const uint32_t mixmode)
+{
+	if (!is_dst_independent_mix(mixmode)) {
+		return {};
+	}
+	switch ((mixmode >> 5) & 0x03) {
+	case 0x00: /* Src is background color */
+		return to_pixel_value(GetMixResult(mixmode, xga.backcolor, 0));
+	case 0x01: /* Src is foreground color */
+		return to_pixel_value(GetMixResult(mixmode, xga.forecolor, 0));
+	default: return {};
+	}
+}
+
 static void XGA_DrawLineVector(const uint32_t val, const bool skip_last_pixel)
 {
 	// No work to do with a zero-length line
@@ -532,8 +776,21 @@ static void XGA_DrawRectangle(const uint32_t val, const bool skip_last_pixel)
 	// one pixel too wide (but don't underflow below zero).
 	const auto xrun = xga.MAPcount - (xga.MAPcount && skip_last_pixel);
 
+	// Solid fills don't need the per-pixel mix
+	std::optional<uint32_t> fill_value = {};
+	if (is_drawing_enabled() && get_bytes_per_pixel() &&
+	    ((xga.pix_cntl >> 6) & 0x3) == 0x00) {
+		fill_value = get_fill_value(xga.foremix);
+	}
+
 	for (auto yat = 0; yat <= xga.MIPcount; ++yat) {
 		srcx = xga.curx;
+		if (fill_value &&
+		    fill_span(make_span(srcx, srcy, xrun + 1, dx), *fill_value)) {
+			srcx += dx * (xrun + 1);
+			srcy += dy;
+			continue;
+		}
 		for (auto xat = 0; xat <= xrun; ++xat) {
 			uint32_t mixmode = (xga.pix_cntl >> 6) & 0x3;
 			Bitu dstdata;
@@ -846,6 +1103,21 @@ void XGA_BlitRect(Bitu val) {
 			break;
 	}
 
+	// Plain copies and solid fills don't need the per-pixel mix, as long
+	// as no colour comparison is done
+	using namespace bit::literals;
+
+	const auto is_fast_path = is_drawing_enabled() && get_bytes_per_pixel() &&
+	                          mixselect != 0x3 && bit::cleared(xga.control1, b8);
+
+	const auto is_copy = is_fast_path && ((mixmode >> 5) & 0x03) == 0x03 &&
+	                     (mixmode & 0xf) == 0x07;
+
+	const auto fill_value = is_fast_path ? get_fill_value(mixmode)
+	                                     : std::optional<uint32_t>{};
+
+	const auto num_pixels = static_cast<int>(xga.MAPcount) + 1;
+
 	/* Copy source to video ram */
 	srcy = xga.cury;
 	tary = xga.desty;
@@ -853,6 +1125,20 @@ void XGA_BlitRect(Bitu val) {
 		srcx = xga.curx;
 		tarx = xga.destx;
 
+		const auto dest_span = make_span(tarx, tary, num_pixels, dx);
+		if (is_copy) {
+			const auto src_span = make_span(srcx, srcy, num_pixels, dx);
+			if (copy_span(dest_span, src_span.x, src_span.y, static_cast<int>(dx))) {
+				srcy += dy;
+				tary += dy;
+				continue;
+			}
+		} else if (fill_value && fill_span(dest_span, *fill_value)) {
+			srcy += dy;
+			tary += dy;
+			continue;
+		}
+
 		for(xat=0;xat<=xga.MAPcount;xat++) {
 			srcdata = XGA_GetPoint(srcx, srcy);
 			dstdata = XGA_GetPoint(tarx, tary);
@@ -906,8 +1192,6 @@ void XGA_BlitRect(Bitu val) {
 			// set with a matching colour or vice-versa (SRC_NE not
 			// set with non-matching colour).
 
-			using namespace bit::literals;
-
 			if (bit::cleared(xga.control1, b8) ||
 			    bit::is(xga.control1, b7) == (srcval == colorcmpdata)) {
 
@@ -960,8 +1244,56 @@ void XGA_DrawPattern(Bitu val) {
 			break;
 	}
 
+	// Patterns whose mixes don't read the destination are evaluated once
+	// per pattern pixel and repeated across the rows
+	auto is_fast_path = is_drawing_enabled() && get_bytes_per_pixel();
+	if (mixselect == 0x3) {
+		is_fast_path = is_fast_path && is_pattern_mix(xga.foremix) &&
+		               is_pattern_mix(xga.backmix);
+	} else {
+		is_fast_path = is_fast_path && is_pattern_mix(mixmode);
+	}
+
+	const auto num_pixels = static_cast<int>(xga.MAPcount) + 1;
+
 	for(yat=0;yat<=xga.MIPcount;yat++) {
 		tarx = xga.destx;
+
+		if (is_fast_path) {
+			const auto pattern_y = srcy + (tary & 0x7);
+
+			uint32_t values[8] = {};
+			for (auto i = 0; i < 8; ++i) {
+				// Same selection as the per-pixel path below
+				srcdata = XGA_GetPoint(srcx + i, pattern_y);
+
+				auto pattern_mix = mixmode;
+				if (mixselect == 0x3) {
+					pattern_mix = ((srcdata & xga.readmask) == xga.readmask)
+					                    ? xga.foremix
+					                    : xga.backmix;
+				}
+				Bitu srcval = srcdata;
+				switch ((pattern_mix >> 5) & 0x03) {
+				case 0x00: srcval = xga.backcolor; break;
+				case 0x01: srcval = xga.forecolor; break;
+				default: break;
+				}
+				values[i] = to_pixel_value(GetMixResult(pattern_mix, srcval, 0));
+			}
+
+			const auto pattern_offset = static_cast<int64_t>(pattern_y) *
+			                                    XGA_SCREEN_WIDTH +
+			                            srcx;
+
+			if (fill_span_with_pattern(make_span(tarx, tary, num_pixels, dx),
+			                           values,
+			                           pattern_offset)) {
+				tary += dy;
+				continue;
+			}
+		}
+
 		for(xat=0;xat<=xga.MAPcount;xat++) {
 
 			srcdata = XGA_GetPoint(srcx + (tarx & 0x7), srcy + (tary & 0x7));
@@ -1319,6 +1651,9 @@ void XGA_Write(io_port_t port, io_val_t val, io_width_t width)
 {
 	//	LOG_MSG("XGA: Write to port %x, val %8x, len %x", port,val, len);
 
+	// The accelerator draws straight into video memory
+	vga.draw.is_frame_dirty = true;
+
 	switch (port) {
 	case 0x8100: // drawing control: row (low word), column (high word)
 		// "CUR_X" and "CUR_Y" (see PORT 82E8h,PORT 86E8h)
@@ -62,11 +62,13 @@
 #include <atomic>
 #include <bit>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <condition_variable>
 #include <cstdlib>
 #include <cstring>
 #include <mutex>
+#include <utility>
 
 #include <SDL.h>
 #include <SDL_cpuinfo.h> // for proper SSE defines for MSVC
@@ -82,7 +84,10 @@
 #include "hardware/pci_bus.h"
 #include "hardware/pic.h"
 #include "misc/cross.h"
+#include "misc/host_memory.h"
+#include "misc/metrics.h"
 #include "misc/support.h"
+#include "misc/tracing.h"
 #include "simde/x86/sse2.h"
 #include "utils/bitops.h"
 #include "utils/byteorder.h"
@@ -720,8 +725,36 @@ struct ncc_table
 	rgb_t *				palette;				/* pointer to associated RGB palette */
 	rgb_t *				palettea;				/* pointer to associated ARGB palette */
 	rgb_t				texel[256];				/* texel lookup */
+	uint32_t			generation;				/* bumped when the texels or palette change */
 };
 
+// A texture with all its LODs decoded to ARGB, so the rasterizer can fetch
+// texels without looking at their format. The key fields identify the
+// textures that decode to the same texels.
+struct decoded_texture {
+	// Key
+	uint32_t lodoffset[9]      = {};
+	uint32_t wmask             = 0;
+	uint32_t hmask             = 0;
+	uint32_t format            = 0;
+	const rgb_t* lookup        = nullptr;
+	uint32_t lookup_generation = 0;
+
+	// The span of texture memory the texels were decoded from
+	uint32_t start_address = 0;
+	uint32_t end_address   = 0;
+
+	// Index of the first texel of each LOD
+	uint32_t texel_offset[9]  = {};
+	std::vector<rgb_t> texels = {};
+
+	uint32_t last_used = 0;
+	bool is_valid      = false;
+};
+
+// Enough for the handful of textures a typical scene switches between
+constexpr size_t MaxDecodedTextures = 32;
+
 using mem_buffer_t = std::unique_ptr<uint8_t[]>;
 
 struct tmu_state
@@ -764,6 +797,10 @@ struct tmu_state
 
 	rgb_t				palette[256];			/* palette lookup table */
 	rgb_t				palettea[256];			/* palette+alpha lookup table */
+
+	std::vector<decoded_texture> decoded_textures;	/* cache of decoded textures */
+	decoded_texture*	decoded;				/* currently selected decoded texture */
+	uint32_t			decode_clock;			/* counts texture selections for LRU */
 };
 
 struct tmu_shared_state
@@ -892,6 +929,77 @@ struct draw_state {
 	bool screen_update_pending   = false;
 };
 
+// The iterated parameters of a TMU for one triangle
+struct tmu_gradients {
+	int64_t starts  = 0; /* starting S,T (14.18) */
+	int64_t startt  = 0;
+	int64_t startw  = 0; /* starting W (2.30) */
+	int64_t dsdx    = 0; /* delta S,T,W per X */
+	int64_t dtdx    = 0;
+	int64_t dwdx    = 0;
+	int64_t dsdy    = 0; /* delta S,T,W per Y */
+	int64_t dtdy    = 0;
+	int64_t dwdy    = 0;
+	int32_t lodbase = 0; /* lodbase calculated for the triangle */
+};
+
+// Everything the rasterizer needs to know about a triangle that changes from
+// one triangle to the next; the rest of the render state is read from the
+// registers, so it must stay put until the triangle has been drawn.
+struct triangle_setup {
+	uint16_t* drawbuf = {};
+
+	poly_vertex v1 = {};
+	poly_vertex v2 = {};
+	poly_vertex v3 = {};
+
+	int32_t v1y = 0;
+	int32_t v3y = 0;
+
+	int16_t ax = 0; /* vertex A x,y (12.4) */
+	int16_t ay = 0;
+
+	int32_t startr = 0; /* starting R,G,B,A (12.12) */
+	int32_t startg = 0;
+	int32_t startb = 0;
+	int32_t starta = 0;
+	int32_t startz = 0; /* starting Z (20.12) */
+	int64_t startw = 0; /* starting W (16.32) */
+	int32_t drdx   = 0; /* delta R,G,B,A,Z,W per X */
+	int32_t dgdx   = 0;
+	int32_t dbdx   = 0;
+	int32_t dadx   = 0;
+	int32_t dzdx   = 0;
+	int64_t dwdx   = 0;
+	int32_t drdy   = 0; /* delta R,G,B,A,Z,W per Y */
+	int32_t dgdy   = 0;
+	int32_t dbdy   = 0;
+	int32_t dady   = 0;
+	int32_t dzdy   = 0;
+	int64_t dwdy   = 0;
+
+	tmu_gradients tmu[MAX_TMU] = {};
+};
+
+// Triangles queued in binned mode before they're drawn in one go
+constexpr size_t MaxBinnedTriangles = 1024;
+
+// What the triangle workers did over a number of frames
+struct work_metrics {
+	int num_frames        = 0;
+	int64_t num_triangles = 0;
+
+	// Pixels written by all threads together
+	std::atomic<int64_t> num_pixels = 0;
+
+	// Time the main thread spent handing out work to the threads and
+	// waiting for it to complete
+	int64_t dispatch_ns = 0;
+
+	// Time all threads together spent drawing the handed out work
+	std::atomic<int64_t> busy_ns = 0;
+};
+
 struct triangle_worker
 {
 	triangle_worker(const int num_threads_)
@@ -899,7 +1007,8 @@ struct triangle_worker
 	          // I measured 4x the thread count to be the sweet spot, after which performance degrades.
 	          // This gives about 20% more FPS in Descent II over the old 1x count.
 	          num_work_units((num_threads + 1) * 4),
-	          threads(num_threads)
+	          threads(num_threads),
+	          num_active_threads(num_threads)
 	{
 		assert(num_work_units > num_threads);
 	}
@@ -915,15 +1024,19 @@ struct triangle_worker
 
 	std::atomic_bool threads_active = {};
 
-	uint16_t* drawbuf = {};
+	// The triangle being split across the work units
+	triangle_setup triangle = {};
+	int32_t totalpix        = 0;
 
-	poly_vertex v1 = {};
-	poly_vertex v2 = {};
-	poly_vertex v3 = {};
-
-	int32_t v1y      = 0;
-	int32_t v3y      = 0;
-	int32_t totalpix = 0;
+	// In binned mode, triangles are queued until something needs the
+	// frame buffer or changes the render state. The queue is then drawn
+	// with each work unit owning a band of scanlines, in which it draws
+	// all the queued triangles in order.
+	bool use_binning                      = false;
+	bool is_drawing_bins                  = false;
+	std::vector<triangle_setup> bin_queue = {};
+	int32_t bin_start_y                   = 0;
+	int32_t bin_rows_per_unit             = 0;
 
 	std::vector<std::thread> threads = {};
 
@@ -931,6 +1044,14 @@ struct triangle_worker
 	std::atomic<int> work_index = INT_MAX;
 
 	std::atomic<int> done_count = 0;
+
+	// Only the worker threads below this count take part in the work; the
+	// others wait for it to change. In adaptive mode, this follows the
+	// observed load.
+	std::atomic<int> num_active_threads = 0;
+	bool is_adaptive                    = false;
+
+	work_metrics metrics = {};
 };
 
 struct voodoo_state
@@ -1917,7 +2038,7 @@ while (0)
  *
  *************************************/
 
-#define TEXTURE_PIPELINE(TT, XX, DITHER4, TEXMODE, COTHER, LOOKUP, LODBASE, ITERS, ITERT, ITERW, RESULT) \
+#define TEXTURE_PIPELINE(TT, XX, DITHER4, TEXMODE, COTHER, LODBASE, ITERS, ITERT, ITERW, RESULT) \
 do																				\
 {																				\
 	int32_t blendr, blendg, blendb, blenda;										\
@@ -1925,7 +2046,7 @@ do																				\
 	int32_t s, t, lod, ilod;														\
 	int64_t oow;																	\
 	int32_t smax, tmax;															\
-	uint32_t texbase;																\
+	const rgb_t* texels;															\
 	rgb_union c_local;															\
 																				\
 	/* determine the S/T/LOD values for this texture */							\
@@ -1962,8 +2083,9 @@ do																				\
 	if (!(((TT)->lodmask >> ilod) & 1))											\
 		ilod++;																	\
 																				\
-	/* fetch the texture base */												\
-	texbase = (TT)->lodoffset[ilod];											\
+	/* fetch the decoded texels of the LOD */									\
+	texels = (TT)->decoded->texels.data() +										\
+	         (TT)->decoded->texel_offset[std::min(ilod, 8)];					\
 																				\
 	/* compute the maximum s and t values at this LOD */						\
 	smax = (TT)->wmask >> ilod;													\
@@ -1975,8 +2097,6 @@ do																				\
 	{																			\
 		/* point sampled */														\
 																				\
-		uint32_t texel0;															\
-																				\
 		/* adjust S/T for the LOD and strip off the fractions */				\
 		s >>= ilod + 18;														\
 		t >>= ilod + 18;														\
@@ -1991,20 +2111,7 @@ do																				\
 		t *= smax + 1;															\
 																				\
 		/* fetch texel data */													\
-		if (TEXMODE_FORMAT(TEXMODE) < 8)										\
-		{																		\
-			texel0 = (TT)->ram[(texbase + t + s) & (TT)->mask];					\
-			c_local.u = (LOOKUP)[texel0];										\
-		}																		\
-		else																	\
-		{																		\
-			texel0 = *(uint16_t *)&(TT)->ram[(texbase + 2*(t + s)) & (TT)->mask];	\
-			if (TEXMODE_FORMAT(TEXMODE) >= 10 && TEXMODE_FORMAT(TEXMODE) <= 12)	\
-				c_local.u = (LOOKUP)[texel0];									\
-			else																\
-				c_local.u = ((LOOKUP)[texel0 & 0xff] & 0xffffff) |				\
-							((texel0 & 0xff00) << 16);							\
-		}																		\
+		c_local.u = texels[t + s];												\
 	}																			\
 	else																		\
 	{																			\
@@ -2052,42 +2159,10 @@ do																				\
 		t1 *= smax + 1;															\
 																				\
 		/* fetch texel data */													\
-		if (TEXMODE_FORMAT(TEXMODE) < 8)										\
-		{																		\
-			texel0 = (TT)->ram[(texbase + t + s) & (TT)->mask];					\
-			texel1 = (TT)->ram[(texbase + t + s1) & (TT)->mask];				\
-			texel2 = (TT)->ram[(texbase + t1 + s) & (TT)->mask];				\
-			texel3 = (TT)->ram[(texbase + t1 + s1) & (TT)->mask];				\
-			texel0 = (LOOKUP)[texel0];											\
-			texel1 = (LOOKUP)[texel1];											\
-			texel2 = (LOOKUP)[texel2];											\
-			texel3 = (LOOKUP)[texel3];											\
-		}																		\
-		else																	\
-		{																		\
-			texel0 = *(uint16_t *)&(TT)->ram[(texbase + 2*(t + s)) & (TT)->mask];	\
-			texel1 = *(uint16_t *)&(TT)->ram[(texbase + 2*(t + s1)) & (TT)->mask];\
-			texel2 = *(uint16_t *)&(TT)->ram[(texbase + 2*(t1 + s)) & (TT)->mask];\
-			texel3 = *(uint16_t *)&(TT)->ram[(texbase + 2*(t1 + s1)) & (TT)->mask];\
-			if (TEXMODE_FORMAT(TEXMODE) >= 10 && TEXMODE_FORMAT(TEXMODE) <= 12)	\
-			{																	\
-				texel0 = (LOOKUP)[texel0];										\
-				texel1 = (LOOKUP)[texel1];										\
-				texel2 = (LOOKUP)[texel2];										\
-				texel3 = (LOOKUP)[texel3];										\
-			}																	\
-			else																\
-			{																	\
-				texel0 = ((LOOKUP)[texel0 & 0xff] & 0xffffff) | 				\
-							((texel0 & 0xff00) << 16);							\
-				texel1 = ((LOOKUP)[texel1 & 0xff] & 0xffffff) | 				\
-							((texel1 & 0xff00) << 16);							\
-				texel2 = ((LOOKUP)[texel2 & 0xff] & 0xffffff) | 				\
-							((texel2 & 0xff00) << 16);							\
-				texel3 = ((LOOKUP)[texel3 & 0xff] & 0xffffff) | 				\
-							((texel3 & 0xff00) << 16);							\
-			}																	\
-		}																		\
+		texel0 = texels[t + s];													\
+		texel1 = texels[t + s1];												\
+		texel2 = texels[t1 + s];												\
+		texel3 = texels[t1 + s1];												\
 																				\
 		/* weigh in each texel */												\
 		c_local.u = rgba_bilinear_filter(texel0, texel1, texel2, texel3, sfrac, tfrac);\
@@ -3015,7 +3090,15 @@ iterated W    = 18.32 [48 bits]
 static voodoo_state* v = nullptr; //-V707
 static auto vtype = VOODOO_1;
 
+static MetricCounter& num_triangles_drawn()
+{
+	static auto& counter = METRICS_Counter("dosbox_voodoo_triangles_total",
+	                                       "Triangles drawn by the Voodoo");
+	return counter;
+}
+
 static auto voodoo_bilinear_filtering = false;
+static auto voodoo_tile_binning = false;
 
 #define LOG_VOODOO LOG_PCI
 enum {
@@ -3045,9 +3128,15 @@ static double Voodoo_GetHRetracePosition();
 static dither_lut_t dither2_lookup = {};
 static dither_lut_t dither4_lookup = {};
 
-static inline void raster_generic(const voodoo_state* vs, uint32_t TMUS, uint32_t TEXMODE0,
-                                  uint32_t TEXMODE1, void* destbase, int32_t y,
-                                  const poly_extent* extent, stats_block& stats)
+// The rasterizer is specialised at compile time on the number of TMUs and on
+// whether fogging, alpha blending and bilinear filtering are enabled. The
+// disabled stages then drop out of the per-pixel loop entirely, instead of
+// being checked for every pixel.
+template <uint32_t TMUS, bool HasFog, bool HasAlphaBlend, bool HasBilinear>
+static void raster_generic(const voodoo_state* vs, uint32_t TEXMODE0,
+                           uint32_t TEXMODE1, const triangle_setup& tri,
+                           int32_t y, const poly_extent* extent,
+                           stats_block& stats)
 {
 	const uint8_t* dither_lookup = nullptr;
 	const uint8_t* dither4       = nullptr;
@@ -3058,17 +3147,30 @@ static inline void raster_generic(const voodoo_state* vs, uint32_t TMUS, uint32_
 	int32_t stopx = extent->stopx;
 
 	// Quick references
-	const auto regs  = vs->reg;
-	const auto& fbi  = vs->fbi;
-	const auto& tmu0 = vs->tmu[0];
-	const auto& tmu1 = vs->tmu[1];
+	const auto regs   = vs->reg;
+	const auto& fbi   = vs->fbi;
+	const auto& tmu0  = vs->tmu[0];
+	const auto& grad0 = tri.tmu[0];
+	const auto& grad1 = tri.tmu[1];
 
 	const uint32_t r_fbzColorPath = regs[fbzColorPath].u;
 	const uint32_t r_fbzMode      = regs[fbzMode].u;
-	const uint32_t r_alphaMode    = regs[alphaMode].u;
-	const uint32_t r_fogMode      = regs[fogMode].u;
 	const uint32_t r_zaColor      = regs[zaColor].u;
 
+	// Clear the enable bits of the stages this rasterizer leaves out, so
+	// the compiler can fold away the checks
+	constexpr uint32_t AlphaBlendBit = 1 << 4;
+	const uint32_t r_alphaMode = HasAlphaBlend
+	                                   ? regs[alphaMode].u
+	                                   : (regs[alphaMode].u & ~AlphaBlendBit);
+	const uint32_t r_fogMode = HasFog ? regs[fogMode].u : 0;
+
+	constexpr uint32_t FilterBits = (1 << 1) | (1 << 2);
+	if constexpr (!HasBilinear) {
+		TEXMODE0 &= ~FilterBits;
+		TEXMODE1 &= ~FilterBits;
+	}
+
 	uint32_t r_stipple = regs[stipple].u;
 
 	/* determine the screen Y */
@@ -3119,22 +3221,22 @@ static inline void raster_generic(const voodoo_state* vs, uint32_t TMUS, uint32_
 	}
 
 	/* get pointers to the target buffer and depth buffer */
-	uint16_t* dest  = (uint16_t*)destbase + scry * fbi.rowpixels;
+	uint16_t* dest  = tri.drawbuf + scry * fbi.rowpixels;
 	uint16_t* depth = (fbi.auxoffs != (uint32_t)(~0))
 	                        ? ((uint16_t*)(fbi.ram + fbi.auxoffs) +
 	                           scry * fbi.rowpixels)
 	                        : nullptr;
 
 	/* compute the starting parameters */
-	const int32_t dx = startx - (fbi.ax >> 4);
-	const int32_t dy = y - (fbi.ay >> 4);
-
-	int64_t iterr = fbi.startr + dy * fbi.drdy + dx * fbi.drdx;
-	int64_t iterg = fbi.startg + dy * fbi.dgdy + dx * fbi.dgdx;
-	int64_t iterb = fbi.startb + dy * fbi.dbdy + dx * fbi.dbdx;
-	int64_t itera = fbi.starta + dy * fbi.dady + dx * fbi.dadx;
-	int32_t iterz = fbi.startz + dy * fbi.dzdy + dx * fbi.dzdx;
-	int64_t iterw = fbi.startw + dy * fbi.dwdy + dx * fbi.dwdx;
+	const int32_t dx = startx - (tri.ax >> 4);
+	const int32_t dy = y - (tri.ay >> 4);
+
+	int64_t iterr = tri.startr + dy * tri.drdy + dx * tri.drdx;
+	int64_t iterg = tri.startg + dy * tri.dgdy + dx * tri.dgdx;
+	int64_t iterb = tri.startb + dy * tri.dbdy + dx * tri.dbdx;
+	int64_t itera = tri.starta + dy * tri.dady + dx * tri.dadx;
+	int32_t iterz = tri.startz + dy * tri.dzdy + dx * tri.dzdx;
+	int64_t iterw = tri.startw + dy * tri.dwdy + dx * tri.dwdx;
 	int64_t iterw0 = 0;
 	int64_t iterw1 = 0;
 	int64_t iters0 = 0;
@@ -3143,15 +3245,15 @@ static inline void raster_generic(const voodoo_state* vs, uint32_t TMUS, uint32_
 	int64_t itert1 = 0;
 	if (TMUS >= 1)
 	{
-		iterw0 = tmu0.startw + dy * tmu0.dwdy + dx * tmu0.dwdx;
-		iters0 = tmu0.starts + dy * tmu0.dsdy + dx * tmu0.dsdx;
-		itert0 = tmu0.startt + dy * tmu0.dtdy + dx * tmu0.dtdx;
+		iterw0 = grad0.startw + dy * grad0.dwdy + dx * grad0.dwdx;
+		iters0 = grad0.starts + dy * grad0.dsdy + dx * grad0.dsdx;
+		itert0 = grad0.startt + dy * grad0.dtdy + dx * grad0.dtdx;
 	}
 	if (TMUS >= 2)
 	{
-		iterw1 = tmu1.startw + dy * tmu1.dwdy + dx * tmu1.dwdx;
-		iters1 = tmu1.starts + dy * tmu1.dsdy + dx * tmu1.dsdx;
-		itert1 = tmu1.startt + dy * tmu1.dtdy + dx * tmu1.dtdx;
+		iterw1 = grad1.startw + dy * grad1.dwdy + dx * grad1.dwdx;
+		iters1 = grad1.starts + dy * grad1.dsdy + dx * grad1.dsdx;
+		itert1 = grad1.startt + dy * grad1.dtdy + dx * grad1.dtdx;
 	}
 
 	/* loop in X */
@@ -3168,9 +3270,8 @@ static inline void raster_generic(const voodoo_state* vs, uint32_t TMUS, uint32_
 
 		if (TMUS >= 2 && vs->tmu[1].lodmin < (8 << 8)) {
 			const tmu_state* const tmus = &vs->tmu[1];
-			const rgb_t* const lookup = tmus->lookup;
 			TEXTURE_PIPELINE(tmus, x, dither4, TEXMODE1, texel,
-								lookup, tmus->lodbasetemp,
+								grad1.lodbase,
 								iters1, itert1, iterw1, texel);
 		}
 
@@ -3180,9 +3281,8 @@ static inline void raster_generic(const voodoo_state* vs, uint32_t TMUS, uint32_
 		if (TMUS >= 1 && tmu0.lodmin < (8 << 8)) {
 			if (!vs->send_config) {
 				const tmu_state* const tmus = &tmu0;
-				const rgb_t* const lookup = tmus->lookup;
 				TEXTURE_PIPELINE(tmus, x, dither4, TEXMODE0, texel,
-								lookup, tmus->lodbasetemp,
+								grad0.lodbase,
 								iters0, itert0, iterw0, texel);
 			} else {	/* send config data to the frame buffer */
 				texel.u=vs->tmu_config;
@@ -3434,23 +3534,23 @@ static inline void raster_generic(const voodoo_state* vs, uint32_t TMUS, uint32_
 		PIXEL_PIPELINE_END(stats);
 
 		/* update the iterated parameters */
-		iterr += fbi.drdx;
-		iterg += fbi.dgdx;
-		iterb += fbi.dbdx;
-		itera += fbi.dadx;
-		iterz += fbi.dzdx;
-		iterw += fbi.dwdx;
+		iterr += tri.drdx;
+		iterg += tri.dgdx;
+		iterb += tri.dbdx;
+		itera += tri.dadx;
+		iterz += tri.dzdx;
+		iterw += tri.dwdx;
 		if (TMUS >= 1)
 		{
-			iterw0 += tmu0.dwdx;
-			iters0 += tmu0.dsdx;
-			itert0 += tmu0.dtdx;
+			iterw0 += grad0.dwdx;
+			iters0 += grad0.dsdx;
+			itert0 += grad0.dtdx;
 		}
 		if (TMUS >= 2)
 		{
-			iterw1 += tmu1.dwdx;
-			iters1 += tmu1.dsdx;
-			itert1 += tmu1.dtdx;
+			iterw1 += grad1.dwdx;
+			iters1 += grad1.dsdx;
+			itert1 += grad1.dtdx;
 		}
 	}
 }
@@ -3969,6 +4069,7 @@ static void ncc_table_write(ncc_table *n, uint32_t regnum, uint32_t data)
 		if (n->palette[index] != palette_entry) {
 			/* set the ARGB for this palette index */
 			n->palette[index] = palette_entry;
+			n->generation++;
 #ifdef C_ENABLE_VOODOO_OPENGL
 			v->ogl_palette_changed = true;
 #endif
@@ -4066,6 +4167,7 @@ static void ncc_table_update(ncc_table *n)
 
 	/* no longer dirty */
 	n->dirty = false;
+	n->generation++;
 }
 
 
@@ -4213,6 +4315,135 @@ static void recompute_texture_params(tmu_state *t)
 	//	E_Exit("Separate RGBA filters!"); // voodoo 2 feature not implemented
 }
 
+static uint32_t get_lookup_generation(const tmu_state* t)
+{
+	// Both counters only go up, so their sum changes whenever either does
+	return t->ncc[0].generation + t->ncc[1].generation;
+}
+
+static bool is_same_texture(const decoded_texture& d, const tmu_state* t)
+{
+	return d.is_valid && d.wmask == t->wmask && d.hmask == t->hmask &&
+	       d.format == TEXMODE_FORMAT(t->reg[textureMode].u) &&
+	       d.lookup == t->lookup &&
+	       d.lookup_generation == get_lookup_generation(t) &&
+	       std::equal(std::begin(d.lodoffset),
+	                  std::end(d.lodoffset),
+	                  std::begin(t->lodoffset));
+}
+
+static void decode_texture(decoded_texture& d, const tmu_state* t)
+{
+	d.wmask             = t->wmask;
+	d.hmask             = t->hmask;
+	d.format            = TEXMODE_FORMAT(t->reg[textureMode].u);
+	d.lookup            = t->lookup;
+	d.lookup_generation = get_lookup_generation(t);
+	std::copy(std::begin(t->lodoffset), std::end(t->lodoffset), d.lodoffset);
+
+	const auto bytes_per_texel = (d.format < 8) ? 1u : 2u;
+
+	// Lay out the LODs one after the other
+	uint32_t num_texels = 0;
+	for (auto lod = 0; lod < 9; ++lod) {
+		d.texel_offset[lod] = num_texels;
+		num_texels += ((d.wmask >> lod) + 1) * ((d.hmask >> lod) + 1);
+	}
+	d.texels.resize(num_texels);
+
+	// The span of memory the LODs were read from, for invalidating the
+	// texture when it's written to. A span that wraps around the end of
+	// the memory is widened to all of it.
+	d.start_address = t->mask;
+	d.end_address   = 0;
+
+	const auto lookup = d.lookup;
+
+	for (auto lod = 0; lod < 9; ++lod) {
+		const auto texbase    = d.lodoffset[lod];
+		const auto lod_texels = ((d.wmask >> lod) + 1) * ((d.hmask >> lod) + 1);
+		const auto lod_bytes  = lod_texels * bytes_per_texel;
+
+		if (texbase + lod_bytes > t->mask + 1) {
+			d.start_address = 0;
+			d.end_address   = t->mask + 1;
+		} else {
+			d.start_address = std::min(d.start_address, texbase);
+			d.end_address = std::max(d.end_address, texbase + lod_bytes);
+		}
+
+		auto out = d.texels.data() + d.texel_offset[lod];
+
+		// Formats without a lookup table have no texels
+		if (!lookup) {
+			std::fill_n(out, lod_texels, rgb_t{0});
+			continue;
+		}
+
+		for (uint32_t i = 0; i < lod_texels; ++i) {
+			if (d.format < 8) {
+				const uint8_t texel = t->ram[(texbase + i) & t->mask];
+				*out++ = lookup[texel];
+			} else {
+				const auto address = (texbase + 2 * i) & t->mask;
+				const uint32_t texel = *(uint16_t*)&t->ram[address];
+				if (d.format >= 10 && d.format <= 12) {
+					*out++ = lookup[texel];
+				} else {
+					*out++ = (lookup[texel & 0xff] & 0xffffff) |
+					         ((texel & 0xff00) << 16);
+				}
+			}
+		}
+	}
+	d.is_valid = true;
+}
+
+// Returns the selected texture decoded to ARGB, decoding it if it's not in
+// the cache already
+static decoded_texture* get_decoded_texture(tmu_state* t)
+{
+	++t->decode_clock;
+
+	if (t->decoded && is_same_texture(*t->decoded, t)) {
+		t->decoded->last_used = t->decode_clock;
+		return t->decoded;
+	}
+
+	auto& cache = t->decoded_textures;
+	if (cache.empty()) {
+		cache.resize(MaxDecodedTextures);
+	}
+
+	decoded_texture* least_recent = &cache.front();
+	for (auto& d : cache) {
+		if (is_same_texture(d, t)) {
+			d.last_used = t->decode_clock;
+			return &d;
+		}
+		if (!d.is_valid || (least_recent->is_valid &&
+		                    d.last_used < least_recent->last_used)) {
+			least_recent = &d;
+		}
+	}
+
+	decode_texture(*least_recent, t);
+	least_recent->last_used = t->decode_clock;
+	return least_recent;
+}
+
+// Drops the decoded textures that were read from the written bytes
+static void invalidate_decoded_textures(tmu_state* t, const uint32_t address,
+                                        const uint32_t num_bytes)
+{
+	for (auto& d : t->decoded_textures) {
+		if (d.is_valid && address < d.end_address &&
+		    address + num_bytes > d.start_address) {
+			d.is_valid = false;
+		}
+	}
+}
+
 static void prepare_tmu(tmu_state *t)
 {
 	int64_t texdx;
@@ -4252,6 +4483,26 @@ static void prepare_tmu(tmu_state *t)
 	/* get the log of the square root of texdx */
 	(void)fast_reciplog(texdx, &lodbase);
 	t->lodbasetemp = (-lodbase + (12 << 8)) / 2;
+
+	t->decoded = get_decoded_texture(t);
+}
+
+static tmu_gradients get_tmu_gradients(const tmu_state& t)
+{
+	tmu_gradients grad = {};
+
+	grad.starts  = t.starts;
+	grad.startt  = t.startt;
+	grad.startw  = t.startw;
+	grad.dsdx    = t.dsdx;
+	grad.dtdx    = t.dtdx;
+	grad.dwdx    = t.dwdx;
+	grad.dsdy    = t.dsdy;
+	grad.dtdy    = t.dtdy;
+	grad.dwdy    = t.dwdy;
+	grad.lodbase = t.lodbasetemp;
+
+	return grad;
 }
 
 static inline int32_t round_coordinate(float value)
@@ -4318,40 +4569,167 @@ static void update_statistics(voodoo_state *vs, bool accumulate)
     COMMAND HANDLERS
 ***************************************************************************/
 
-static void triangle_worker_work(const triangle_worker& tworker,
-                                 const int32_t work_start, const int32_t work_end)
+using raster_func = void (*)(const voodoo_state* vs, uint32_t TEXMODE0,
+                            uint32_t TEXMODE1, const triangle_setup& tri,
+                            int32_t y, const poly_extent* extent,
+                            stats_block& stats);
+
+// The tables of specialised rasterizers are indexed by the number of TMUs
+// times 8, plus 1 for fogging, 2 for alpha blending and 4 for bilinear
+// filtering
+template <size_t Index>
+constexpr raster_func rasterizer_at = &raster_generic<Index / 8,
+                                                      (Index & 1) != 0,
+                                                      (Index & 2) != 0,
+                                                      (Index & 4) != 0>;
+
+template <size_t... Indices>
+constexpr std::array<raster_func, sizeof...(Indices)> make_rasterizers(
+        std::index_sequence<Indices...>)
+{
+	return {rasterizer_at<Indices>...};
+}
+
+static constexpr auto rasterizers = make_rasterizers(
+        std::make_index_sequence<(MAX_TMU + 1) * 8>());
+
+struct raster_setup {
+	raster_func rasterizer = {};
+	uint32_t texmode0      = 0;
+	uint32_t texmode1      = 0;
+};
+
+static raster_setup get_raster_setup(const triangle_worker& tworker)
 {
 	/* determine the number of TMUs involved */
-	uint32_t tmus     = 0;
-	uint32_t texmode0 = 0;
-	uint32_t texmode1 = 0;
+	uint32_t tmus = 0;
+
+	raster_setup setup = {};
 	if (!FBIINIT3_DISABLE_TMUS(v->reg[fbiInit3].u) && FBZCP_TEXTURE_ENABLE(v->reg[fbzColorPath].u))
 	{
 		tmus = 1;
-		texmode0 = v->tmu[0].reg[textureMode].u;
+		setup.texmode0 = v->tmu[0].reg[textureMode].u;
 		if ((v->chipmask & 0x04) != 0)
 		{
 			tmus = 2;
-			texmode1 = v->tmu[1].reg[textureMode].u;
+			setup.texmode1 = v->tmu[1].reg[textureMode].u;
 		}
 		if (tworker.disable_bilinear_filter) //force disable bilinear filter
 		{
-			texmode0 &= ~6;
-			texmode1 &= ~6;
+			setup.texmode0 &= ~6;
+			setup.texmode1 &= ~6;
 		}
 	}
 
+	const auto has_fog = FOGMODE_ENABLE_FOG(v->reg[fogMode].u) != 0;
+	const auto has_alpha_blend = ALPHAMODE_ALPHABLEND(v->reg[alphaMode].u) != 0;
+	const auto has_bilinear = ((setup.texmode0 | setup.texmode1) & 6) != 0;
+
+	const auto index = tmus * 8 + (has_fog ? 1 : 0) +
+	                   (has_alpha_blend ? 2 : 0) + (has_bilinear ? 4 : 0);
+
+	setup.rasterizer = rasterizers[index];
+	return setup;
+}
+
+struct triangle_slopes {
+	float dxdy_v1v2 = 0.0f;
+	float dxdy_v1v3 = 0.0f;
+	float dxdy_v2v3 = 0.0f;
+};
+
+static triangle_slopes get_triangle_slopes(const triangle_setup& tri)
+{
 	/* compute the slopes for each portion of the triangle */
-	const poly_vertex v1 = tworker.v1;
-	const poly_vertex v2 = tworker.v2;
-	const poly_vertex v3 = tworker.v3;
+	const poly_vertex v1 = tri.v1;
+	const poly_vertex v2 = tri.v2;
+	const poly_vertex v3 = tri.v3;
+
+	triangle_slopes slopes = {};
+
+	slopes.dxdy_v1v2 = (v2.y == v1.y) ? 0.0f : (v2.x - v1.x) / (v2.y - v1.y);
+	slopes.dxdy_v1v3 = (v3.y == v1.y) ? 0.0f : (v3.x - v1.x) / (v3.y - v1.y);
+	slopes.dxdy_v2v3 = (v3.y == v2.y) ? 0.0f : (v3.x - v2.x) / (v3.y - v2.y);
+
+	return slopes;
+}
+
+// Returns the span of the triangle on the scanline, with start <= stop
+static poly_extent get_scanline_extent(const triangle_setup& tri,
+                                       const triangle_slopes& slopes,
+                                       const int32_t curscan)
+{
+	const float fully = (float)(curscan) + 0.5f;
+
+	const float startx = tri.v1.x + (fully - tri.v1.y) * slopes.dxdy_v1v3;
+
+	/* compute the ending X based on which part of the triangle we're in */
+	const float stopx = (fully < tri.v2.y
+	                             ? (tri.v1.x + (fully - tri.v1.y) * slopes.dxdy_v1v2)
+	                             : (tri.v2.x + (fully - tri.v2.y) * slopes.dxdy_v2v3));
+
+	/* clamp to full pixels */
+	poly_extent extent;
+	extent.startx = round_coordinate(startx);
+	extent.stopx = round_coordinate(stopx);
+
+	/* force start < stop */
+	if (extent.startx > extent.stopx) {
+		std::swap(extent.startx, extent.stopx);
+	}
+	return extent;
+}
+
+// Draws the queued triangles that fall into the bands of scanlines owned by
+// the work units. Each scanline belongs to a single band and the triangles
+// are drawn in the order they were queued, so the result is the same as
+// drawing them one by one.
+static int32_t draw_binned_triangles(const triangle_worker& tworker,
+                                     const int32_t work_start, const int32_t work_end)
+{
+	const auto raster = get_raster_setup(tworker);
+
+	stats_block my_stats = {};
+
+	const int32_t band_start = tworker.bin_start_y +
+	                           work_start * tworker.bin_rows_per_unit;
+	const int32_t band_end = tworker.bin_start_y +
+	                         work_end * tworker.bin_rows_per_unit;
+
+	for (const auto& tri : tworker.bin_queue) {
+		const auto first_scan = std::max(tri.v1y, band_start);
+		const auto last_scan  = std::min(tri.v3y, band_end);
+		if (first_scan >= last_scan) {
+			continue;
+		}
+
+		const auto slopes = get_triangle_slopes(tri);
+
+		for (auto curscan = first_scan; curscan < last_scan; ++curscan) {
+			const auto extent = get_scanline_extent(tri, slopes, curscan);
+			if (extent.startx == extent.stopx) {
+				continue;
+			}
+			raster.rasterizer(v, raster.texmode0, raster.texmode1, tri, curscan, &extent, my_stats);
+		}
+	}
+	sum_statistics(&v->thread_stats[work_start], &my_stats);
+	return my_stats.pixels_out;
+}
 
-	const float dxdy_v1v2 = (v2.y == v1.y) ? 0.0f
-	                                       : (v2.x - v1.x) / (v2.y - v1.y);
-	const float dxdy_v1v3 = (v3.y == v1.y) ? 0.0f
-	                                       : (v3.x - v1.x) / (v3.y - v1.y);
-	const float dxdy_v2v3 = (v3.y == v2.y) ? 0.0f
-	                                       : (v3.x - v2.x) / (v3.y - v2.y);
+// Draws a fraction of the current work and returns the number of pixels
+// written
+static int32_t triangle_worker_work(const triangle_worker& tworker,
+                                    const int32_t work_start, const int32_t work_end)
+{
+	if (tworker.is_drawing_bins) {
+		return draw_binned_triangles(tworker, work_start, work_end);
+	}
+
+	const auto raster = get_raster_setup(tworker);
+
+	const auto& tri   = tworker.triangle;
+	const auto slopes = get_triangle_slopes(tri);
 
 	stats_block my_stats = {};
 
@@ -4366,31 +4744,13 @@ static void triangle_worker_work(const triangle_worker& tworker,
 	const int32_t from = tworker.totalpix * work_start / num_work_units;
 	const int32_t to   = tworker.totalpix * work_end / num_work_units;
 
-	for (int32_t curscan = tworker.v1y, scanend = tworker.v3y, sumpix = 0, lastsum = 0;
+	for (int32_t curscan = tri.v1y, scanend = tri.v3y, sumpix = 0, lastsum = 0;
 	     curscan != scanend && lastsum < to;
 	     lastsum = sumpix, curscan++) {
 
-		const float fully = (float)(curscan) + 0.5f;
-
-		const float startx = v1.x + (fully - v1.y) * dxdy_v1v3;
-
-		/* compute the ending X based on which part of the triangle we're in */
-		const float stopx = (fully < v2.y
-		                             ? (v1.x + (fully - v1.y) * dxdy_v1v2)
-		                             : (v2.x + (fully - v2.y) * dxdy_v2v3));
-
-		/* clamp to full pixels */
-		poly_extent extent;
-		extent.startx = round_coordinate(startx);
-		extent.stopx = round_coordinate(stopx);
-
-		/* force start < stop */
-		if (extent.startx >= extent.stopx)
-		{
-			if (extent.startx == extent.stopx) {
-				continue;
-			}
-			std::swap(extent.startx, extent.stopx);
+		auto extent = get_scanline_extent(tri, slopes, curscan);
+		if (extent.startx == extent.stopx) {
+			continue;
 		}
 
 		sumpix += (extent.stopx - extent.startx);
@@ -4405,9 +4765,10 @@ static void triangle_worker_work(const triangle_worker& tworker,
 			extent.stopx -= (sumpix - to);
 		}
 
-		raster_generic(v, tmus, texmode0, texmode1, tworker.drawbuf, curscan, &extent, my_stats);
+		raster.rasterizer(v, raster.texmode0, raster.texmode1, tri, curscan, &extent, my_stats);
 	}
 	sum_statistics(&v->thread_stats[work_start], &my_stats);
+	return my_stats.pixels_out;
 }
 
 // NOTE (weirddan455): In case anyone wants to optimize this further on ARM:
@@ -4446,7 +4807,19 @@ static int do_triangle_work(triangle_worker& tworker)
 
 	i = tworker.work_index.fetch_add(1, std::memory_order_acq_rel);
 	if (i < tworker.num_work_units) {
-		triangle_worker_work(tworker, i, i + 1);
+		TRACE_SCOPE("Voodoo triangles");
+
+		const auto start = std::chrono::steady_clock::now();
+
+		const auto num_pixels = triangle_worker_work(tworker, i, i + 1);
+
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		tworker.metrics.busy_ns.fetch_add(
+		        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+		        std::memory_order_relaxed);
+		tworker.metrics.num_pixels.fetch_add(num_pixels,
+		                                     std::memory_order_relaxed);
+
 		int done = tworker.done_count.fetch_add(1, std::memory_order_acq_rel) + 1;
 		if (done >= tworker.num_work_units) {
 			tworker.done_count.notify_all();
@@ -4458,10 +4831,19 @@ static int do_triangle_work(triangle_worker& tworker)
 	return i + 1;
 }
 
-static int triangle_worker_thread_func()
+static int triangle_worker_thread_func(const int thread_index)
 {
+	TRACE_THREAD_NAME("Voodoo worker");
+
 	triangle_worker& tworker = v->tworker;
 	while (tworker.threads_active.load(std::memory_order_acquire)) {
+		// Inactive threads sit out until the active count changes
+		const int num_active = tworker.num_active_threads.load(std::memory_order_acquire);
+		if (thread_index >= num_active) {
+			tworker.num_active_threads.wait(num_active, std::memory_order_acquire);
+			continue;
+		}
+
 		int i = do_triangle_work(tworker);
 		if (i >= tworker.num_work_units) {
 			tworker.work_index.wait(i, std::memory_order_acquire);
@@ -4479,6 +4861,10 @@ static void triangle_worker_shutdown(triangle_worker& tworker)
 	tworker.work_index.store(0, std::memory_order_release);
 	tworker.work_index.notify_all();
 
+	// Wake up the inactive threads as well
+	tworker.num_active_threads.store(tworker.num_threads, std::memory_order_release);
+	tworker.num_active_threads.notify_all();
+
 	for (auto& thread : tworker.threads) {
 		if (thread.joinable()) {
 			thread.join();
@@ -4486,54 +4872,9 @@ static void triangle_worker_shutdown(triangle_worker& tworker)
 	}
 }
 
-static void triangle_worker_run(triangle_worker& tworker)
+// Has the worker threads and the main thread work through all the work units
+static void triangle_worker_dispatch(triangle_worker& tworker)
 {
-	if (!tworker.num_threads) {
-		// do not use threaded calculation
-		tworker.totalpix = 0xFFFFFFF;
-		triangle_worker_work(tworker, 0, tworker.num_work_units);
-		return;
-	}
-
-	/* compute the slopes for each portion of the triangle */
-	const poly_vertex v1 = tworker.v1;
-	const poly_vertex v2 = tworker.v2;
-	const poly_vertex v3 = tworker.v3;
-
-	const float dxdy_v1v2 = (v2.y == v1.y) ? 0.0f
-	                                       : (v2.x - v1.x) / (v2.y - v1.y);
-	const float dxdy_v1v3 = (v3.y == v1.y) ? 0.0f
-	                                       : (v3.x - v1.x) / (v3.y - v1.y);
-	const float dxdy_v2v3 = (v3.y == v2.y) ? 0.0f
-	                                       : (v3.x - v2.x) / (v3.y - v2.y);
-
-	int32_t pixsum = 0;
-	for (int32_t curscan = tworker.v1y, scanend = tworker.v3y; curscan != scanend; curscan++)
-	{
-		const float fully  = (float)(curscan) + 0.5f;
-		const float startx = v1.x + (fully - v1.y) * dxdy_v1v3;
-
-		/* compute the ending X based on which part of the triangle we're in */
-		const float stopx = (fully < v2.y
-		                             ? (v1.x + (fully - v1.y) * dxdy_v1v2)
-		                             : (v2.x + (fully - v2.y) * dxdy_v2v3));
-
-		/* clamp to full pixels */
-		const int32_t istartx = round_coordinate(startx);
-		const int32_t istopx  = round_coordinate(stopx);
-
-		/* force start < stop */
-		pixsum += (istartx > istopx ? istartx - istopx : istopx - istartx);
-	}
-	tworker.totalpix = pixsum;
-
-	// Don't wake up threads for just a few pixels
-	if (tworker.totalpix <= 200)
-	{
-		triangle_worker_work(tworker, 0, tworker.num_work_units);
-		return;
-	}
-
 	// The main thread is the only one who sets threads_active (here and in shutdown) so there is no race condition.
 	// In the future, if this changes, this will need to be an atomic compare_exchange.
 	// For now, this is better because 99% of the time threads_active == true.
@@ -4542,13 +4883,15 @@ static void triangle_worker_run(triangle_worker& tworker)
 	{
 		tworker.threads_active.store(true, std::memory_order_release);
 
-		for (auto& triangle_worker : tworker.threads) {
-			triangle_worker = std::thread([] {
-				triangle_worker_thread_func();
+		for (int i = 0; i < tworker.num_threads; ++i) {
+			tworker.threads[i] = std::thread([i] {
+				triangle_worker_thread_func(i);
 			});
 		}
 	}
 
+	const auto start = std::chrono::steady_clock::now();
+
 	tworker.done_count.store(0, std::memory_order_release);
 
 	// Reseting this index triggers the worker threads to start working
@@ -4563,6 +4906,153 @@ static void triangle_worker_run(triangle_worker& tworker)
 	while ((i = tworker.done_count.load(std::memory_order_acquire)) < tworker.num_work_units) {
 		tworker.done_count.wait(i, std::memory_order_acquire);
 	}
+
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	tworker.metrics.dispatch_ns +=
+	        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+static void triangle_worker_run(triangle_worker& tworker)
+{
+	if (!tworker.num_threads) {
+		// do not use threaded calculation
+		tworker.totalpix = 0xFFFFFFF;
+		tworker.metrics.num_pixels += triangle_worker_work(tworker, 0, tworker.num_work_units);
+		return;
+	}
+
+	const auto& tri   = tworker.triangle;
+	const auto slopes = get_triangle_slopes(tri);
+
+	int32_t pixsum = 0;
+	for (int32_t curscan = tri.v1y, scanend = tri.v3y; curscan != scanend; curscan++)
+	{
+		const auto extent = get_scanline_extent(tri, slopes, curscan);
+		pixsum += extent.stopx - extent.startx;
+	}
+	tworker.totalpix = pixsum;
+
+	// Don't wake up threads for just a few pixels
+	if (tworker.totalpix <= 200)
+	{
+		tworker.metrics.num_pixels += triangle_worker_work(tworker, 0, tworker.num_work_units);
+		return;
+	}
+
+	triangle_worker_dispatch(tworker);
+}
+
+// Draws the triangles queued in binned mode. This has to happen before
+// anything reads or writes the frame buffer, or changes the render state
+// other than the per-triangle parameters.
+static void triangle_worker_flush(triangle_worker& tworker)
+{
+	auto& queue = tworker.bin_queue;
+	if (queue.empty()) {
+		return;
+	}
+
+	// A lone triangle is better split by its pixels, and small ones
+	// don't need the worker threads at all
+	if (queue.size() == 1) {
+		tworker.triangle = queue.front();
+		queue.clear();
+		triangle_worker_run(tworker);
+		return;
+	}
+
+	auto start_y = tworker.bin_queue.front().v1y;
+	auto end_y   = tworker.bin_queue.front().v3y;
+	for (const auto& tri : queue) {
+		start_y = std::min(start_y, tri.v1y);
+		end_y   = std::max(end_y, tri.v3y);
+	}
+
+	// Split the covered scanlines into one band per work unit. The work
+	// units outnumber the threads, so the bands are handed out to
+	// whichever thread is free, which evens out the load.
+	const auto num_rows = end_y - start_y;
+
+	tworker.bin_start_y       = start_y;
+	tworker.bin_rows_per_unit = (num_rows + tworker.num_work_units - 1) /
+	                            tworker.num_work_units;
+
+	tworker.is_drawing_bins = true;
+	triangle_worker_dispatch(tworker);
+	tworker.is_drawing_bins = false;
+
+	queue.clear();
+}
+
+// Frames to collect the work metrics over before acting on them
+constexpr int WorkMetricsFrames = 30;
+
+// Logs the work metrics and, in adaptive mode, adjusts the number of active
+// worker threads. Called once per frame.
+static void triangle_worker_end_frame(triangle_worker& tworker,
+                                      const double frame_period_ms)
+{
+	auto& metrics = tworker.metrics;
+	if (++metrics.num_frames < WorkMetricsFrames) {
+		return;
+	}
+
+	const auto busy_ns    = metrics.busy_ns.load(std::memory_order_relaxed);
+	const auto num_pixels = metrics.num_pixels.load(std::memory_order_relaxed);
+
+	const auto num_active = tworker.num_active_threads.load(std::memory_order_acquire);
+
+	// The share of the time the participating threads spent drawing while
+	// work was being handed out; the rest went to waking up and waiting
+	const auto available_ns = metrics.dispatch_ns * (num_active + 1);
+	const auto efficiency   = available_ns > 0 ? static_cast<double>(busy_ns) /
+	                                                   static_cast<double>(available_ns)
+	                                           : 1.0;
+
+	maybe_log_debug("%d frames: %lld triangles, %lld pixels, %.2f ms dispatching, "
+	                "%.2f ms drawing, %d of %d threads active (%.0f%% busy)",
+	                metrics.num_frames,
+	                static_cast<long long>(metrics.num_triangles),
+	                static_cast<long long>(num_pixels),
+	                static_cast<double>(metrics.dispatch_ns) / 1e6,
+	                static_cast<double>(busy_ns) / 1e6,
+	                num_active,
+	                tworker.num_threads,
+	                efficiency * 100.0);
+
+	if (tworker.is_adaptive) {
+		// Drop a thread when the threads mostly wait on each other, and
+		// add one back when they're kept busy and the drawing takes up a
+		// good part of the frame
+		constexpr auto MinEfficiency    = 0.5;
+		constexpr auto MaxEfficiency    = 0.75;
+		constexpr auto MinDispatchShare = 0.25;
+
+		const auto frames_ns = frame_period_ms * 1e6 * metrics.num_frames;
+		const auto dispatch_share =
+		        frames_ns > 0 ? static_cast<double>(metrics.dispatch_ns) / frames_ns
+		                      : 0.0;
+
+		auto new_num_active = num_active;
+		if (efficiency < MinEfficiency && num_active > 0) {
+			--new_num_active;
+		} else if (efficiency > MaxEfficiency &&
+		           dispatch_share > MinDispatchShare &&
+		           num_active < tworker.num_threads) {
+			++new_num_active;
+		}
+		if (new_num_active != num_active) {
+			tworker.num_active_threads.store(new_num_active,
+			                                 std::memory_order_release);
+			tworker.num_active_threads.notify_all();
+		}
+	}
+
+	metrics.num_frames    = 0;
+	metrics.num_triangles = 0;
+	metrics.num_pixels.store(0, std::memory_order_relaxed);
+	metrics.dispatch_ns = 0;
+	metrics.busy_ns.store(0, std::memory_order_relaxed);
 }
 
 /*-------------------------------------------------
@@ -4571,6 +5061,8 @@ static void triangle_worker_run(triangle_worker& tworker)
 -------------------------------------------------*/
 static void triangle(voodoo_state *vs)
 {
+	num_triangles_drawn().Add();
+
 	// Quick references
 	const auto regs = vs->reg;
 	auto& fbi = vs->fbi;
@@ -4758,24 +5250,59 @@ static void triangle(voodoo_state *vs)
 	default: /* reserved */ return;
 	}
 
+	triangle_setup tri = {};
+
+	tri.drawbuf = drawbuf;
+	tri.v1 = *v1, tri.v2 = *v2, tri.v3 = *v3;
+	tri.v1y = v1y;
+	tri.v3y = v3y;
+
+	tri.ax     = fbi.ax;
+	tri.ay     = fbi.ay;
+	tri.startr = fbi.startr;
+	tri.startg = fbi.startg;
+	tri.startb = fbi.startb;
+	tri.starta = fbi.starta;
+	tri.startz = fbi.startz;
+	tri.startw = fbi.startw;
+	tri.drdx   = fbi.drdx;
+	tri.dgdx   = fbi.dgdx;
+	tri.dbdx   = fbi.dbdx;
+	tri.dadx   = fbi.dadx;
+	tri.dzdx   = fbi.dzdx;
+	tri.dwdx   = fbi.dwdx;
+	tri.drdy   = fbi.drdy;
+	tri.dgdy   = fbi.dgdy;
+	tri.dbdy   = fbi.dbdy;
+	tri.dady   = fbi.dady;
+	tri.dzdy   = fbi.dzdy;
+	tri.dwdy   = fbi.dwdy;
+
 	/* determine the number of TMUs involved */
 	if (texcount >= 1)
 	{
 		prepare_tmu(&tmu0);
+		tri.tmu[0] = get_tmu_gradients(tmu0);
 		if (texcount >= 2) {
 			prepare_tmu(&tmu1);
+			tri.tmu[1] = get_tmu_gradients(tmu1);
 		}
 	}
 
 	triangle_worker& tworker = vs->tworker;
-	tworker.v1 = *v1, tworker.v2 = *v2, tworker.v3 = *v3;
-	tworker.drawbuf = drawbuf;
-	tworker.v1y = v1y;
-	tworker.v3y = v3y;
-	triangle_worker_run(tworker);
+	if (tworker.use_binning) {
+		tworker.bin_queue.push_back(tri);
+		if (tworker.bin_queue.size() >= MaxBinnedTriangles) {
+			triangle_worker_flush(tworker);
+		}
+	} else {
+		tworker.triangle = tri;
+		triangle_worker_run(tworker);
+	}
 
 	/* update stats */
 	regs[fbiTrianglesOut].u++;
+	++tworker.metrics.num_triangles;
 }
 
 /*-------------------------------------------------
@@ -5185,6 +5712,15 @@ static void soft_reset(voodoo_state *vs)
  *  Voodoo register writes
  *
  *************************************/
+// The registers that are latched per triangle by the 'triangle' command,
+// rather than read while drawing
+static constexpr bool is_triangle_parameter(const uint8_t regnum)
+{
+	return (regnum >= vertexAx && regnum <= triangleCMD) ||
+	       (regnum >= fvertexAx && regnum <= ftriangleCMD) ||
+	       (regnum >= sSetupMode && regnum <= sBeginTriCMD);
+}
+
 static void register_w(uint32_t offset, uint32_t data)
 {
 	auto chips = check_cast<uint8_t>((offset >> 8) & 0xf);
@@ -5215,6 +5751,11 @@ static void register_w(uint32_t offset, uint32_t data)
 		return;
 	}
 
+	// Only the triangle parameters can change while triangles are queued
+	if (!is_triangle_parameter(regnum)) {
+		triangle_worker_flush(v->tworker);
+	}
+
 	/* switch off the register */
 	switch (regnum)
 	{
@@ -6757,6 +7298,10 @@ static int32_t texture_w(uint32_t offset, uint32_t data) {
 			changed = true;
 		}
 
+		if (changed) {
+			invalidate_decoded_textures(t, tbaseaddr, 4);
+		}
+
 #ifdef C_ENABLE_VOODOO_OPENGL
 		if (changed && v->ogl && v->active) {
 			voodoo_ogl_texture_clear(t->lodoffset[lod],tmunum);
@@ -6811,6 +7356,10 @@ static int32_t texture_w(uint32_t offset, uint32_t data) {
 			changed = true;
 		}
 
+		if (changed) {
+			invalidate_decoded_textures(t, tbaseaddr * 2, 4);
+		}
+
 #ifdef C_ENABLE_VOODOO_OPENGL
 		if (changed && v->ogl && v->active) {
 			voodoo_ogl_texture_clear(t->lodoffset[lod],tmunum);
@@ -6835,6 +7384,9 @@ static uint32_t register_r(const uint32_t offset)
 
 	//LOG(LOG_VOODOO,LOG_WARN)("Voodoo:read chip %x reg %x (%s)", chips, regnum<<2, voodoo_reg_name[regnum]);
 
+	// Reads see the statistics and status with the queued triangles drawn
+	triangle_worker_flush(v->tworker);
+
 	/* first make sure this register is readable */
 	if ((v->regaccess[regnum] & REGISTER_READ) == 0)
 	{
@@ -6946,6 +7498,8 @@ static uint32_t lfb_r(const uint32_t offset)
 	uint32_t bufmax  = 0;
 	uint32_t data    = 0;
 
+	triangle_worker_flush(v->tworker);
+
 	/* compute X,Y */
 	const auto x = (offset << 1) & 0x3fe;
 	const auto y = (offset >> 9) & 0x3ff;
@@ -7032,8 +7586,10 @@ static void voodoo_w(const uint32_t addr, const uint32_t data, const uint32_t ma
 	if ((offset & offset_base) == 0) {
 		register_w(offset, data);
 	} else if ((offset & lfb_base) == 0) {
+		triangle_worker_flush(v->tworker);
 		lfb_w(offset, data, mask);
 	} else {
+		triangle_worker_flush(v->tworker);
 		texture_w(offset, data);
 	}
 }
@@ -7061,9 +7617,10 @@ static int get_num_total_threads()
 	constexpr auto MaxAutoThreads = 16;
 	constexpr auto MaxThreads     = 128;
 
-	constexpr auto SectionName = "voodoo";
-	constexpr auto SettingName = "voodoo_threads";
-	constexpr auto AutoSetting = "auto";
+	constexpr auto SectionName     = "voodoo";
+	constexpr auto SettingName     = "voodoo_threads";
+	constexpr auto AutoSetting     = "auto";
+	constexpr auto AdaptiveSetting = "adaptive";
 
 	const auto sec = get_section(SectionName);
 	assert(sec);
@@ -7086,7 +7643,7 @@ static int get_num_total_threads()
 		return valid_int;
 	}
 
-	if (user_setting != AutoSetting) {
+	if (user_setting != AutoSetting && user_setting != AdaptiveSetting) {
 		LOG_WARNING("VOODOO: Invalid '%s' setting: '%s', using '%s'",
 		            SettingName,
 		            user_setting.c_str(),
@@ -7102,6 +7659,21 @@ static int get_num_total_threads()
     DEVICE INTERFACE
 ***************************************************************************/
 
+// The frame buffer and texture memory make up most of the state
+static size_t get_voodoo_memory_size()
+{
+	if (!v) {
+		return 0;
+	}
+	size_t num_bytes = sizeof(voodoo_state) + v->fbi.mask + 1;
+	for (const auto& tmu : v->tmu) {
+		if (tmu.ram) {
+			num_bytes += tmu.mask + 1;
+		}
+	}
+	return num_bytes;
+}
+
 /*-------------------------------------------------
     device start callback
 -------------------------------------------------*/
@@ -7114,6 +7686,8 @@ static void initialise_voodoo()
 
 	v = new voodoo_state(num_additional_threads);
 
+	HOST_MEMORY_AddSubsystem("3dfx Voodoo", get_voodoo_memory_size);
+
 #ifdef C_ENABLE_VOODOO_OPENGL
 	v->ogl = (emulation_type == VOODOO_EMU_TYPE_ACCELERATED);
 #endif
@@ -7330,6 +7904,8 @@ static void Voodoo_VerticalTimer(uint32_t /*val*/)
 	v->draw.frame_start = PIC_FullIndex();
 	PIC_AddEvent(Voodoo_VerticalTimer, v->draw.frame_period_ms);
 
+	triangle_worker_end_frame(v->tworker, v->draw.frame_period_ms);
+
 	if (v->fbi.vblank_flush_pending) {
 		voodoo_vblank_flush();
 #ifdef C_ENABLE_VOODOO_OPENGL
@@ -7343,6 +7919,9 @@ static void Voodoo_VerticalTimer(uint32_t /*val*/)
 	if (!v->ogl)
 #endif
 	{
+		// Show what's been drawn into the front buffer so far
+		triangle_worker_flush(v->tworker);
+
 		if (!RENDER_StartUpdate()) {
 			return; // frameskip
 		}
@@ -7852,6 +8431,7 @@ static void voodoo_shutdown()
 #endif
 
 	v->active = false;
+	triangle_worker_flush(v->tworker);
 	triangle_worker_shutdown(v->tworker);
 
 	delete v;
@@ -7872,6 +8452,16 @@ static void Voodoo_Startup() {
 
 	v->tworker.disable_bilinear_filter = (voodoo_bilinear_filtering == false);
 
+	// Binning only pays off when the bands can be drawn in parallel
+	v->tworker.use_binning = voodoo_tile_binning && v->tworker.num_threads > 0;
+	if (v->tworker.use_binning) {
+		v->tworker.bin_queue.reserve(MaxBinnedTriangles);
+	}
+
+	// Start with all threads and let the frame metrics scale them down
+	const auto sec = get_section("voodoo");
+	v->tworker.is_adaptive = sec && sec->GetString("voodoo_threads") == "adaptive";
+
 	// Switch the pagehandler now that v has been allocated and is in use
 	voodoo_pagehandler = &voodoo_real_pagehandler;
 	PAGING_InitTLB();
@@ -7894,6 +8484,7 @@ void VOODOO_Init()
 	vtype = (memsize_pref == "4" ? VOODOO_1 : VOODOO_1_DTMU);
 
 	voodoo_bilinear_filtering = section->GetBool("voodoo_bilinear_filtering");
+	voodoo_tile_binning = section->GetBool("voodoo_tile_binning");
 
 	// Check 64 KB alignment of LFB base
 	static_assert((PciVoodooLfbBase & 0xffff) == 0);
@@ -7913,6 +8504,11 @@ void VOODOO_Init()
 	        (voodoo_bilinear_filtering ? "" : "no "));
 }
 
+int64_t VOODOO_GetNumTrianglesDrawn()
+{
+	return num_triangles_drawn().Value();
+}
+
 void VOODOO_Destroy()
 {
 	voodoo_shutdown();
@@ -7954,6 +8550,8 @@ static void init_voodoo_config_settings(SectionProp& section)
 	        "values:\n"
 	        "\n"
 	        "  auto:      Use up to 16 threads based on available CPU cores (default).\n"
+	        "  adaptive:  Like 'auto', but only keep as many threads busy as the game's\n"
+	        "             workload benefits from; re-evaluated every 30 frames.\n"
 	        "  <number>:  Set a specific number of threads between 1 and 128.\n"
 	        "\n"
 	        "Note: Setting this to a higher value than the number of logical CPUs your\n"
@@ -7967,6 +8565,13 @@ static void init_voodoo_config_settings(SectionProp& section)
 	        "Use bilinear filtering to emulate the 3dfx Voodoo's texture smoothing effect\n"
 	        "('on' by default). Bilinear filtering can impact frame rates on slower systems;\n"
 	        "try turning it off if you're not getting adequate performance.");
+
+	bool_prop = section.AddBool("voodoo_tile_binning", OnlyAtStart, false);
+	bool_prop->SetHelp(
+	        "Queue up 3dfx Voodoo triangles and draw them in batches, with each thread\n"
+	        "drawing its own band of the screen ('off' by default). This can improve frame\n"
+	        "rates in games that draw lots of small triangles, as the threads don't have to\n"
+	        "be woken up for every triangle. Has no effect when 'voodoo_threads' is 1.");
 }
 
 void VOODOO_AddConfigSection(const ConfigPtr& conf)
@@ -11,4 +11,7 @@ void VOODOO_AddConfigSection(const ConfigPtr& conf);
 void VOODOO_Init();
 void VOODOO_Destroy();
 
+// Total number of triangles drawn since startup
+int64_t VOODOO_GetNumTrianglesDrawn();
+
 #endif // DOSBOX_VOODOO_H
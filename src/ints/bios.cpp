@@ -17,6 +17,7 @@
 #include "hardware/audio/ps1audio.h"
 #include "hardware/audio/soundblaster.h"
 #include "hardware/audio/tandy_sound.h"
+#include "hardware/input/input_replay.h"
 #include "hardware/input/joystick.h"
 #include "hardware/input/mouse.h"
 #include "hardware/memory.h"
@@ -30,12 +31,6 @@
 // Constants
 constexpr uint32_t BiosMachineSignatureAddress = 0xfffff;
 
-#if defined(HAVE_CLOCK_GETTIME) && !defined(WIN32)
-// time.h is already included
-#else
-#include <sys/timeb.h>
-#endif
-
 // Reference:
 // - Ralf Brown's Interrupt List
 // - https://www.stanislavs.org/helppc/idx_interrupt.html
@@ -389,25 +384,13 @@ static Bitu INT11_Handler(void) {
 #endif
 
 static void BIOS_HostTimeSync() {
-	uint32_t milli = 0;
-	// TODO investigate if clock_gettime and ftime can be replaced
-	// by using C++11 chrono
-#if defined(HAVE_CLOCK_GETTIME) && !defined(WIN32)
-	struct timespec tp;
-	clock_gettime(CLOCK_REALTIME,&tp);
+	// Recorded and replayed along with the input
+	const auto now_ms  = REPLAY_GetHostTimeMs();
+	const time_t now_s = now_ms / 1000;
+	const auto milli   = static_cast<uint32_t>(now_ms % 1000);
 
 	struct tm *loctime;
-	loctime = localtime(&tp.tv_sec);
-	milli = (uint32_t) (tp.tv_nsec / 1000000);
-#else
-	/* Setup time and date */
-	struct timeb timebuffer;
-	ftime(&timebuffer);
-
-	struct tm *loctime;
-	loctime = localtime (&timebuffer.time);
-	milli = (uint32_t) timebuffer.millitm;
-#endif
+	loctime = localtime(&now_s);
 	/*
 	loctime->tm_hour = 23;
 	loctime->tm_min = 59;
@@ -130,6 +130,13 @@ void BIOS_Destroy();
 
 bool BIOS_AddKeyToBuffer(uint16_t code);
 
+// True if the keyboard buffer has no room for another key
+bool BIOS_IsKeyboardBufferFull();
+
+// True if a program has replaced the BIOS keyboard interrupt handler, e.g.,
+// to read the scan codes from port 60h itself
+bool BIOS_IsKeyboardIrqHooked();
+
 void INT10_ReloadRomFonts();
 
 void BIOS_SetComPorts (uint16_t baseaddr[]);
@@ -13,6 +13,7 @@
 #include "dos/drives.h"
 #include "gui/mapper.h"
 #include "hardware/memory.h"
+#include "hardware/timer.h"
 #include "utils/string_utils.h"
 
 diskGeo DiskGeometryList[] = {
@@ -150,29 +151,152 @@ uint8_t imageDisk::Read_Sector(uint32_t head,uint32_t cylinder,uint32_t sector,v
 	return Read_AbsoluteSector(sectnum, data);
 }
 
-uint8_t imageDisk::Read_AbsoluteSector(uint32_t sectnum, void *data)
+// Sectors are read from the image in blocks of this size
+constexpr uint32_t CacheBlockBytes = 32 * 1024;
+
+// Per disk; enough to hold any floppy and the busy parts of a hard disk
+constexpr size_t MaxCacheBlocks = (16 * 1024 * 1024) / CacheBlockBytes;
+
+// Disks holding back writes, flushed about once a second
+static std::vector<imageDisk*> dirty_disks = {};
+static int flush_ticks = 0;
+
+static void flush_dirty_disks()
+{
+	constexpr int FlushIntervalMs = 1000;
+
+	if (++flush_ticks < FlushIntervalMs) {
+		return;
+	}
+
+	// Flushing removes the disk from the list, and the last one removes
+	// this handler
+	while (!dirty_disks.empty()) {
+		dirty_disks.back()->Flush();
+	}
+}
+
+imageDisk::CacheBlock* imageDisk::GetCacheBlock(const uint32_t block_num)
+{
+	if (const auto it = cache.find(block_num); it != cache.end()) {
+		cache_lru.splice(cache_lru.begin(), cache_lru, it->second.lru_pos);
+		return &it->second;
+	}
+
+	if (cache.size() >= MaxCacheBlocks) {
+		const auto oldest = cache.find(cache_lru.back());
+		assert(oldest != cache.end());
+		// Held back writes that fail now are lost, as they would have
+		// been if written right away
+		WriteOut(oldest->first, oldest->second);
+		cache.erase(oldest);
+		cache_lru.pop_back();
+	}
+
+	const auto block_bytes = block_sectors * sector_size;
+	const auto bytenum = check_cast<cross_off_t>(block_num) * block_bytes;
+
+	CacheBlock block = {};
+	block.data.resize(block_bytes);
+
+	// The last block can be partial; like before, reading past the end of
+	// the image is not an error
+	if (!diskimg || !diskimg->Read(bytenum, block.data.data(), block_bytes)) {
+		LOG_ERR("BIOSDISK: Could not read sector %u in file '%s': %s",
+		        block_num * block_sectors, diskname, strerror(errno));
+		return nullptr;
+	}
+
+	cache_lru.push_front(block_num);
+	block.lru_pos = cache_lru.begin();
+
+	return &cache.emplace(block_num, std::move(block)).first->second;
+}
+
+bool imageDisk::WriteOut(const uint32_t block_num, CacheBlock& block)
 {
+	if (block.dirty_first == block.dirty_end) {
+		return true;
+	}
+	const auto sectnum = block_num * block_sectors + block.dirty_first;
 	const auto bytenum = check_cast<cross_off_t>(sectnum) * sector_size;
+	const auto num_bytes = (block.dirty_end - block.dirty_first) * sector_size;
 
-	if (last_action == WRITE || bytenum != current_fpos) {
-		if (cross_fseeko(diskimg, bytenum, SEEK_SET) != 0) {
-			LOG_ERR("BIOSDISK: Could not seek to sector %u in file '%s': %s",
-			        sectnum, diskname, strerror(errno));
-			return 0xff;
-		}
+	block.dirty_first = 0;
+	block.dirty_end   = 0;
+
+	if (!diskimg->Write(bytenum, &block.data[(sectnum % block_sectors) * sector_size], num_bytes)) {
+		LOG_ERR("BIOSDISK: Could not write sector %u to file '%s': %s",
+		        sectnum, diskname, strerror(errno));
+		return false;
 	}
+	return true;
+}
+
+void imageDisk::Flush()
+{
+	if (!is_dirty) {
+		return;
+	}
+	for (auto& [block_num, block] : cache) {
+		WriteOut(block_num, block);
+	}
+	diskimg->Flush();
+
+	is_dirty = false;
+	std::erase(dirty_disks, this);
+	if (dirty_disks.empty()) {
+		TIMER_DelTickHandler(flush_dirty_disks);
+	}
+}
+
+void imageDisk::ResetCache()
+{
+	Flush();
+	cache.clear();
+	cache_lru.clear();
+	block_sectors = (sector_size > 0) ? std::max(CacheBlockBytes / sector_size, 1u) : 1;
+}
 
+void imageDisk::PerformIoDelay(uint32_t num_bytes) const
+{
 	// Only perform delay if we booted from a disk image
 	// Otherwise this would result in delay duplication in the int21 handler
-	if (DOS_IsGuestOsBooted()) {
-		DiskType type = hardDrive ? DiskType::HardDisk : DiskType::Floppy;
-		DOS_PerformDiskIoDelay(sector_size, type);
+	if (!DOS_IsGuestOsBooted()) {
+		return;
 	}
+	const auto type = hardDrive ? DiskType::HardDisk : DiskType::Floppy;
+	while (num_bytes > 0) {
+		const auto chunk = std::min<uint32_t>(num_bytes, UINT16_MAX);
+		DOS_PerformDiskIoDelay(static_cast<uint16_t>(chunk), type);
+		num_bytes -= chunk;
+	}
+}
 
-	size_t ret   = fread(data, 1, sector_size, diskimg);
-	current_fpos = bytenum + ret;
-	last_action=READ;
+uint8_t imageDisk::Read_AbsoluteSector(uint32_t sectnum, void *data)
+{
+	return Read_AbsoluteSectors(sectnum, 1, data);
+}
+
+uint8_t imageDisk::Read_AbsoluteSectors(const uint32_t sectnum,
+                                        const uint32_t count, void* data)
+{
+	PerformIoDelay(sector_size * count);
+
+	auto out = static_cast<uint8_t*>(data);
+	for (uint32_t done = 0; done < count;) {
+		const auto block = GetCacheBlock((sectnum + done) / block_sectors);
+		if (!block) {
+			return 0xff;
+		}
+		const auto first = (sectnum + done) % block_sectors;
+		const auto n     = std::min(count - done, block_sectors - first);
 
+		memcpy(out + done * sector_size,
+		       &block->data[first * sector_size],
+		       n * sector_size);
+		done += n;
+	}
 	return 0x00;
 }
 
@@ -186,48 +310,91 @@ uint8_t imageDisk::Write_Sector(uint32_t head,uint32_t cylinder,uint32_t sector,
 
 
 uint8_t imageDisk::Write_AbsoluteSector(uint32_t sectnum, void *data) {
-	const auto bytenum = check_cast<cross_off_t>(sectnum) * sector_size;
+	return Write_AbsoluteSectors(sectnum, 1, data);
+}
 
-	//LOG_MSG("Writing sectors to %ld at bytenum %d", sectnum, bytenum);
+uint8_t imageDisk::Write_AbsoluteSectors(const uint32_t sectnum,
+                                         const uint32_t count, const void* data)
+{
+	PerformIoDelay(sector_size * count);
 
-	if (last_action == READ || bytenum != current_fpos) {
-		if (cross_fseeko(diskimg, bytenum, SEEK_SET) != 0) {
-			LOG_ERR("BIOSDISK: Could not seek to byte %lld in file '%s': %s",
-			        static_cast<long long int>(bytenum),
-			        diskname,
-			        strerror(errno));
-			return 0xff;
+	const auto in = static_cast<const uint8_t*>(data);
+
+	if (is_write_back) {
+		for (uint32_t done = 0; done < count;) {
+			const auto block = GetCacheBlock((sectnum + done) / block_sectors);
+			if (!block) {
+				return 0x05;
+			}
+			const auto first = (sectnum + done) % block_sectors;
+			const auto n     = std::min(count - done, block_sectors - first);
+
+			memcpy(&block->data[first * sector_size],
+			       in + done * sector_size,
+			       n * sector_size);
+
+			if (block->dirty_first == block->dirty_end) {
+				block->dirty_first = first;
+				block->dirty_end   = first + n;
+			} else {
+				block->dirty_first = std::min(block->dirty_first, first);
+				block->dirty_end = std::max(block->dirty_end, first + n);
+			}
+			done += n;
 		}
+		if (!is_dirty) {
+			is_dirty = true;
+			if (dirty_disks.empty()) {
+				flush_ticks = 0;
+				TIMER_AddTickHandler(flush_dirty_disks);
+			}
+			dirty_disks.push_back(this);
+		}
+		return 0x00;
 	}
 
-	// Only perform delay if we booted from a disk image
-	// Otherwise this would result in delay duplication in the int21 handler
-	if (DOS_IsGuestOsBooted()) {
-		DiskType type = hardDrive ? DiskType::HardDisk : DiskType::Floppy;
-		DOS_PerformDiskIoDelay(sector_size, type);
-	}
+	const auto bytenum = check_cast<cross_off_t>(sectnum) * sector_size;
 
-	size_t ret   = fwrite(data, 1, sector_size, diskimg);
-	current_fpos = bytenum + ret;
-	last_action=WRITE;
+	//LOG_MSG("Writing sectors to %ld at bytenum %d", sectnum, bytenum);
 
-	return ((ret>0)?0x00:0x05);
+	if (!diskimg || !diskimg->Write(bytenum, in, static_cast<size_t>(sector_size) * count)) {
+		LOG_ERR("BIOSDISK: Could not write to byte %lld in file '%s': %s",
+		        static_cast<long long int>(bytenum),
+		        diskname,
+		        strerror(errno));
+		return 0x05;
+	}
+
+	// Write through to the cached copies, if any
+	for (uint32_t done = 0; done < count;) {
+		const auto first = (sectnum + done) % block_sectors;
+		const auto n     = std::min(count - done, block_sectors - first);
 
+		const auto it = cache.find((sectnum + done) / block_sectors);
+		if (it != cache.end()) {
+			memcpy(&it->second.data[first * sector_size],
+			       in + done * sector_size,
+			       n * sector_size);
+		}
+		done += n;
+	}
+	return 0x00;
 }
 
 imageDisk::imageDisk(FILE *img_file, const char *img_name, uint32_t img_size_k, bool is_hdd)
         : hardDrive(is_hdd),
           active(false),
-          diskimg(img_file),
+          diskimg(DISK_IMAGE_Open(img_file,
+                                  DOS_ShouldPreloadImage(DISK_IMAGE_GetSize(img_file)),
+                                  img_name)),
           floppytype(0),
           sector_size(512),
           heads(0),
           cylinders(0),
           sectors(0),
-          current_fpos(0),
-          last_action(NONE)
+          is_write_back(DOS_IsDiskImageWriteBack())
 {
-	fseek(diskimg,0,SEEK_SET);
+	ResetCache();
 	memset(diskname,0,512);
 	safe_strcpy(diskname, img_name);
 	if (!is_hdd) {
@@ -256,12 +423,20 @@ imageDisk::imageDisk(FILE *img_file, const char *img_name, uint32_t img_size_k,
 	}
 }
 
+imageDisk::~imageDisk()
+{
+	if (diskimg) {
+		Flush();
+	}
+}
+
 void imageDisk::Set_Geometry(uint32_t setHeads, uint32_t setCyl, uint32_t setSect, uint32_t setSectSize) {
 	heads = setHeads;
 	cylinders = setCyl;
 	sectors = setSect;
 	sector_size = setSectSize;
 	active = true;
+	ResetCache();
 }
 
 void imageDisk::Get_Geometry(uint32_t * getHeads, uint32_t *getCyl, uint32_t *getSect, uint32_t *getSectSize) {
@@ -328,11 +503,39 @@ static bool has_image(const std::array<T, N> &arr) {
 	return std::any_of(std::begin(arr), std::end(arr), to_bool);
 }
 
+// Sector number of the C/H/S address in CX and DH, as used by INT 13h
+static uint32_t get_int13_sectnum(const imageDisk& disk)
+{
+	const uint32_t cylinder = reg_ch | ((reg_cl & 0xc0) << 2);
+	const uint32_t sector   = reg_cl & 63;
+
+	return ((cylinder * disk.heads + reg_dh) * disk.sectors) + sector - 1;
+}
+
+// Like real_writeb/real_readb in a loop, the offset wraps around within the
+// segment
+static void copy_to_real(const uint16_t seg, const uint16_t offset,
+                         const uint8_t* data, const size_t num_bytes)
+{
+	const auto to_segment_end = std::min<size_t>(num_bytes, 0x10000 - offset);
+	MEM_BlockWrite(PhysicalMake(seg, offset), data, to_segment_end);
+	if (to_segment_end < num_bytes) {
+		copy_to_real(seg, 0, data + to_segment_end, num_bytes - to_segment_end);
+	}
+}
+
+static void copy_from_real(const uint16_t seg, const uint16_t offset,
+                           uint8_t* data, const size_t num_bytes)
+{
+	const auto to_segment_end = std::min<size_t>(num_bytes, 0x10000 - offset);
+	MEM_BlockRead(PhysicalMake(seg, offset), data, to_segment_end);
+	if (to_segment_end < num_bytes) {
+		copy_from_real(seg, 0, data + to_segment_end, num_bytes - to_segment_end);
+	}
+}
+
 static Bitu INT13_DiskHandler(void) {
-	uint16_t segat, bufptr;
-	uint8_t sectbuf[512];
 	uint8_t  drivenum;
-	Bitu t;
 	last_drive = reg_dl;
 	drivenum = GetDosDriveNumber(reg_dl);
 	const bool any_images = has_image(imageDiskList);
@@ -416,10 +619,13 @@ static Bitu INT13_DiskHandler(void) {
 			return CBRET_NONE;
 		}
 
-		segat = SegValue(es);
-		bufptr = reg_bx;
-		for (Bitu i = 0; i < reg_al; i++) {
-			last_status = imageDiskList[drivenum]->Read_Sector((uint32_t)reg_dh, (uint32_t)(reg_ch | ((reg_cl & 0xc0)<< 2)), (uint32_t)((reg_cl & 63)+i), sectbuf);
+		{
+			const auto& disk = imageDiskList[drivenum];
+			std::vector<uint8_t> buffer(disk->getSectSize() * reg_al);
+
+			last_status = disk->Read_AbsoluteSectors(get_int13_sectnum(*disk),
+			                                         reg_al,
+			                                         buffer.data());
 			if((last_status != 0x00) || killRead) {
 				LOG_MSG("Error in disk read");
 				killRead = false;
@@ -427,10 +633,7 @@ static Bitu INT13_DiskHandler(void) {
 				CALLBACK_SCF(true);
 				return CBRET_NONE;
 			}
-			for(t=0;t<512;t++) {
-				real_writeb(segat,bufptr,sectbuf[t]);
-				bufptr++;
-			}
+			copy_to_real(SegValue(es), reg_bx, buffer.data(), buffer.size());
 		}
 		reg_ah = 0x00;
 		CALLBACK_SCF(false);
@@ -441,13 +644,14 @@ static Bitu INT13_DiskHandler(void) {
 			CALLBACK_SCF(true);
 			return CBRET_NONE;
 		}
-		bufptr = reg_bx;
-		for (Bitu i = 0; i < reg_al; i++) {
-			for(t=0;t<imageDiskList[drivenum]->getSectSize();t++) {
-				sectbuf[t] = real_readb(SegValue(es),bufptr);
-				bufptr++;
-			}
-			last_status = imageDiskList[drivenum]->Write_Sector((uint32_t)reg_dh, (uint32_t)(reg_ch | ((reg_cl & 0xc0) << 2)), (uint32_t)((reg_cl & 63) + i), &sectbuf[0]);
+		{
+			const auto& disk = imageDiskList[drivenum];
+			std::vector<uint8_t> buffer(disk->getSectSize() * reg_al);
+			copy_from_real(SegValue(es), reg_bx, buffer.data(), buffer.size());
+
+			last_status = disk->Write_AbsoluteSectors(get_int13_sectnum(*disk),
+			                                          reg_al,
+			                                          buffer.data());
 			if(last_status != 0x00) {
 				CALLBACK_SCF(true);
 				return CBRET_NONE;
@@ -8,11 +8,15 @@
 
 #include <cstdio>
 #include <array>
+#include <list>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "dos/dos.h"
 #include "hardware/memory.h"
 #include "ints/bios.h"
+#include "ints/disk_image_file.h"
 
 /* The Section handling Bios Disk Access */
 #define BIOS_MAX_DISK 10
@@ -34,32 +38,60 @@ public:
 	uint8_t Read_AbsoluteSector(uint32_t sectnum, void * data);
 	uint8_t Write_AbsoluteSector(uint32_t sectnum, void * data);
 
+	// Consecutive sectors in one go, as fast as the cache allows
+	uint8_t Read_AbsoluteSectors(uint32_t sectnum, uint32_t count, void* data);
+	uint8_t Write_AbsoluteSectors(uint32_t sectnum, uint32_t count, const void* data);
+
 	void Set_Geometry(uint32_t setHeads, uint32_t setCyl, uint32_t setSect, uint32_t setSectSize);
 	void Get_Geometry(uint32_t * getHeads, uint32_t *getCyl, uint32_t *getSect, uint32_t *getSectSize);
 	uint8_t GetBiosType(void);
 	uint32_t getSectSize(void);
 
+	// Takes ownership of the file, which can be a raw or a compressed image
 	imageDisk(FILE *img_file, const char *img_name, uint32_t img_size_k, bool is_hdd);
 	imageDisk(const imageDisk&) = delete; // prevent copy
 	imageDisk& operator=(const imageDisk&) = delete; // prevent assignment
 
-	~imageDisk()
-	{
-		if (diskimg != nullptr)
-			fclose(diskimg);
-	}
+	~imageDisk();
+
+	// Writes out sectors held back in write-back mode
+	void Flush();
 
 	bool hardDrive;
 	bool active;
-	FILE *diskimg;
+	std::unique_ptr<DiskImageFile> diskimg;
 	char diskname[512];
 	uint8_t floppytype;
 
 	uint32_t sector_size;
 	uint32_t heads,cylinders,sectors;
 private:
-	cross_off_t current_fpos;
-	enum { NONE,READ,WRITE } last_action;
+	// Sectors are cached in blocks, read from the image as a whole, so
+	// the single-sector requests of a booted OS are mostly served from
+	// memory. Small images such as floppies end up cached entirely.
+	struct CacheBlock {
+		std::vector<uint8_t> data = {};
+		// Range of sectors to write out, in write-back mode
+		uint32_t dirty_first = 0;
+		uint32_t dirty_end   = 0;
+		std::list<uint32_t>::iterator lru_pos = {};
+	};
+
+	void PerformIoDelay(uint32_t num_bytes) const;
+
+	CacheBlock* GetCacheBlock(uint32_t block_num);
+	bool WriteOut(uint32_t block_num, CacheBlock& block);
+	void ResetCache();
+
+	std::unordered_map<uint32_t, CacheBlock> cache = {};
+	// Block numbers, most recently used first
+	std::list<uint32_t> cache_lru = {};
+	uint32_t block_sectors        = 0;
+
+	// Writes are kept in the cache and written out later (on a timer, on
+	// eviction, and when the disk is released) instead of right away
+	bool is_write_back = false;
+	bool is_dirty      = false;
 };
 
 void updateDPT(void);
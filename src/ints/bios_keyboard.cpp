@@ -164,9 +164,11 @@ static const KeyCodes& get_key_codes_for(const uint8_t scan_code)
 	return keyboard[scan_code];
 }
 
-bool BIOS_AddKeyToBuffer(uint16_t code) {
-	if (mem_readb(BIOS_KEYBOARD_FLAGS2)&8) return true;
-	uint16_t start,end,head,tail,ttail;
+// Returns the buffer's tail after adding a key; it equals the head if the
+// buffer is full
+static uint16_t get_next_buffer_tail(const uint16_t tail)
+{
+	uint16_t start,end;
 	if (is_machine_pcjr()) {
 		/* should be done for cga and others as well, to be tested */
 		start=0x1e;
@@ -175,12 +177,19 @@ bool BIOS_AddKeyToBuffer(uint16_t code) {
 		start=mem_readw(BIOS_KEYBOARD_BUFFER_START);
 		end	 =mem_readw(BIOS_KEYBOARD_BUFFER_END);
 	}
-	head =mem_readw(BIOS_KEYBOARD_BUFFER_HEAD);
-	tail =mem_readw(BIOS_KEYBOARD_BUFFER_TAIL);
-	ttail=tail+2;
+	uint16_t ttail=tail+2;
 	if (ttail>=end) {
 		ttail=start;
 	}
+	return ttail;
+}
+
+bool BIOS_AddKeyToBuffer(uint16_t code) {
+	if (mem_readb(BIOS_KEYBOARD_FLAGS2)&8) return true;
+	uint16_t head,tail,ttail;
+	head =mem_readw(BIOS_KEYBOARD_BUFFER_HEAD);
+	tail =mem_readw(BIOS_KEYBOARD_BUFFER_TAIL);
+	ttail=get_next_buffer_tail(tail);
 	/* Check for buffer Full */
 	//TODO Maybe beeeeeeep or something although that should happend when internal buffer is full
 	if (ttail==head) return false;
@@ -189,6 +198,18 @@ bool BIOS_AddKeyToBuffer(uint16_t code) {
 	return true;
 }
 
+bool BIOS_IsKeyboardBufferFull()
+{
+	const auto head = mem_readw(BIOS_KEYBOARD_BUFFER_HEAD);
+	const auto tail = mem_readw(BIOS_KEYBOARD_BUFFER_TAIL);
+	return get_next_buffer_tail(tail) == head;
+}
+
+bool BIOS_IsKeyboardIrqHooked()
+{
+	return RealGetVec(0x09) != BIOS_DEFAULT_IRQ1_LOCATION;
+}
+
 static void add_key(uint16_t code) {
 	if (code!=0) BIOS_AddKeyToBuffer(code);
 }
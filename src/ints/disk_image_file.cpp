@@ -0,0 +1,518 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "ints/disk_image_file.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <zlib.h>
+
+#include "misc/cross.h"
+#include "misc/image_preloader.h"
+#include "misc/logging.h"
+#include "misc/support.h"
+#include "utils/mem_host.h"
+
+constexpr char CompressedMagic[] = {'D', 'B', 'X', 'C', 'I', 'M', 'G', '1'};
+constexpr size_t MagicSize       = sizeof(CompressedMagic);
+
+constexpr uint32_t CompressedVersion = 1;
+
+constexpr uint32_t ChunkSize = 64 * 1024;
+
+constexpr size_t HeaderSize     = 32;
+constexpr size_t IndexEntrySize = 16;
+
+// Decompressed chunks kept in memory per image. The image disk caches the
+// sectors on top of this, so it only needs to cover the chunks being worked
+// through.
+constexpr size_t MaxCachedChunks = 16;
+
+struct CompressedHeader {
+	uint32_t chunk_size = 0;
+	int64_t disk_size   = 0;
+	uint32_t num_chunks = 0;
+};
+
+struct IndexEntry {
+	// Zero if the chunk only holds zeros
+	int64_t offset       = 0;
+	uint32_t stored_size = 0;
+};
+
+static bool read_at(FILE* file, const int64_t offset, uint8_t* data,
+                    const size_t num_bytes)
+{
+	return cross_fseeko(file, offset, SEEK_SET) == 0 &&
+	       fread(data, 1, num_bytes, file) == num_bytes;
+}
+
+static bool write_at(FILE* file, const int64_t offset, const uint8_t* data,
+                     const size_t num_bytes)
+{
+	return cross_fseeko(file, offset, SEEK_SET) == 0 &&
+	       fwrite(data, 1, num_bytes, file) == num_bytes;
+}
+
+static bool write_header(FILE* file, const CompressedHeader& header)
+{
+	std::array<uint8_t, HeaderSize> bytes = {};
+
+	std::memcpy(bytes.data(), CompressedMagic, MagicSize);
+	host_writed(&bytes[8], CompressedVersion);
+	host_writed(&bytes[12], header.chunk_size);
+	host_writeq(&bytes[16], static_cast<uint64_t>(header.disk_size));
+	host_writed(&bytes[24], header.num_chunks);
+
+	return write_at(file, 0, bytes.data(), bytes.size());
+}
+
+static bool read_header(FILE* file, CompressedHeader& header)
+{
+	std::array<uint8_t, HeaderSize> bytes = {};
+	if (!read_at(file, 0, bytes.data(), bytes.size()) ||
+	    std::memcmp(bytes.data(), CompressedMagic, MagicSize) != 0 ||
+	    host_readd(&bytes[8]) != CompressedVersion) {
+		return false;
+	}
+
+	header.chunk_size = host_readd(&bytes[12]);
+	header.disk_size  = static_cast<int64_t>(host_readq(&bytes[16]));
+	header.num_chunks = host_readd(&bytes[24]);
+
+	const auto expected_chunks = header.chunk_size > 0
+	                                   ? (header.disk_size + header.chunk_size - 1) /
+	                                             header.chunk_size
+	                                   : -1;
+	return header.chunk_size == ChunkSize && header.disk_size >= 0 &&
+	       header.num_chunks == expected_chunks;
+}
+
+static int64_t get_index_entry_offset(const uint32_t chunk_num)
+{
+	return static_cast<int64_t>(HeaderSize + chunk_num * IndexEntrySize);
+}
+
+static bool write_index_entry(FILE* file, const uint32_t chunk_num,
+                              const IndexEntry& entry)
+{
+	std::array<uint8_t, IndexEntrySize> bytes = {};
+	host_writeq(&bytes[0], static_cast<uint64_t>(entry.offset));
+	host_writed(&bytes[8], entry.stored_size);
+
+	return write_at(file, get_index_entry_offset(chunk_num), bytes.data(), bytes.size());
+}
+
+static bool is_zero_chunk(const std::vector<uint8_t>& data)
+{
+	return std::all_of(data.begin(), data.end(), [](const uint8_t b) {
+		return b == 0;
+	});
+}
+
+// Returns the chunk as it's stored in the image; chunks that don't compress
+// are stored as they are
+static std::vector<uint8_t> pack_chunk(const std::vector<uint8_t>& data)
+{
+	assert(data.size() == ChunkSize);
+
+	std::vector<uint8_t> packed(compressBound(ChunkSize));
+	auto packed_size = static_cast<uLongf>(packed.size());
+
+	if (compress2(packed.data(), &packed_size, data.data(), ChunkSize, Z_DEFAULT_COMPRESSION) !=
+	            Z_OK ||
+	    packed_size >= ChunkSize) {
+		return data;
+	}
+	packed.resize(packed_size);
+	return packed;
+}
+
+// Stores the chunk at the end of the file and returns its index entry, or an
+// empty entry if the chunk only holds zeros
+static std::optional<IndexEntry> store_chunk(FILE* file, int64_t& end_of_file,
+                                             const std::vector<uint8_t>& data)
+{
+	if (is_zero_chunk(data)) {
+		return IndexEntry{};
+	}
+	const auto packed = pack_chunk(data);
+	if (!write_at(file, end_of_file, packed.data(), packed.size())) {
+		return {};
+	}
+	const IndexEntry entry = {end_of_file, check_cast<uint32_t>(packed.size())};
+	end_of_file += check_cast<int64_t>(packed.size());
+	return entry;
+}
+
+class RawDiskImageFile final : public DiskImageFile {
+public:
+	explicit RawDiskImageFile(FILE* _file) : file(_file) {}
+
+	~RawDiskImageFile() override
+	{
+		fclose(file);
+	}
+
+	int64_t GetSize() const override
+	{
+		return stdio_size_bytes(file);
+	}
+
+	bool Read(const int64_t offset, uint8_t* data, const size_t num_bytes) override
+	{
+		if (cross_fseeko(file, offset, SEEK_SET) != 0) {
+			return false;
+		}
+		const auto num_read = fread(data, 1, num_bytes, file);
+		if (num_read < num_bytes) {
+			clearerr(file);
+			std::fill(data + num_read, data + num_bytes, uint8_t(0));
+		}
+		return true;
+	}
+
+	bool Write(const int64_t offset, const uint8_t* data, const size_t num_bytes) override
+	{
+		return write_at(file, offset, data, num_bytes);
+	}
+
+	void Flush() override
+	{
+		fflush(file);
+	}
+
+private:
+	FILE* file = nullptr;
+};
+
+class PreloadedDiskImageFile final : public DiskImageFile {
+public:
+	PreloadedDiskImageFile(FILE* file, const std::string& name)
+	        : preloader(file, name)
+	{}
+
+	int64_t GetSize() const override
+	{
+		return preloader.GetSize();
+	}
+
+	bool Read(const int64_t offset, uint8_t* data, const size_t num_bytes) override
+	{
+		return preloader.Read(offset, data, num_bytes);
+	}
+
+	bool Write(const int64_t offset, const uint8_t* data, const size_t num_bytes) override
+	{
+		return preloader.Write(offset, data, num_bytes);
+	}
+
+	// The writes are written out in the background, and at the latest
+	// when the image is closed
+	void Flush() override
+	{
+		preloader.Flush();
+	}
+
+private:
+	ImagePreloader preloader;
+};
+
+class CompressedDiskImageFile final : public DiskImageFile {
+public:
+	CompressedDiskImageFile(FILE* _file, const CompressedHeader& _header,
+	                        std::vector<IndexEntry> _index, const int64_t _end_of_file)
+	        : file(_file),
+	          header(_header),
+	          index(std::move(_index)),
+	          end_of_file(_end_of_file)
+	{}
+
+	~CompressedDiskImageFile() override
+	{
+		CompressedDiskImageFile::Flush();
+		fclose(file);
+	}
+
+	int64_t GetSize() const override
+	{
+		return header.disk_size;
+	}
+
+	bool Read(int64_t offset, uint8_t* data, size_t num_bytes) override
+	{
+		while (num_bytes > 0) {
+			const auto chunk_offset = static_cast<size_t>(offset % ChunkSize);
+			const auto n = std::min(num_bytes, ChunkSize - chunk_offset);
+
+			if (offset >= header.disk_size) {
+				std::fill(data, data + n, uint8_t(0));
+			} else {
+				const auto chunk = GetChunk(check_cast<uint32_t>(offset / ChunkSize));
+				if (!chunk) {
+					return false;
+				}
+				std::memcpy(data, &chunk->data[chunk_offset], n);
+			}
+			offset += n;
+			data += n;
+			num_bytes -= n;
+		}
+		return true;
+	}
+
+	bool Write(int64_t offset, const uint8_t* data, size_t num_bytes) override
+	{
+		if (offset + static_cast<int64_t>(num_bytes) > header.disk_size) {
+			return false;
+		}
+		while (num_bytes > 0) {
+			const auto chunk_offset = static_cast<size_t>(offset % ChunkSize);
+			const auto n = std::min(num_bytes, ChunkSize - chunk_offset);
+
+			const auto chunk = GetChunk(check_cast<uint32_t>(offset / ChunkSize));
+			if (!chunk) {
+				return false;
+			}
+			std::memcpy(&chunk->data[chunk_offset], data, n);
+			chunk->is_dirty = true;
+
+			offset += n;
+			data += n;
+			num_bytes -= n;
+		}
+		return true;
+	}
+
+	void Flush() override
+	{
+		for (auto& [chunk_num, chunk] : chunks) {
+			StoreChunk(chunk_num, chunk);
+		}
+		fflush(file);
+	}
+
+private:
+	struct Chunk {
+		std::vector<uint8_t> data = {};
+		bool is_dirty             = false;
+		std::list<uint32_t>::iterator lru_pos = {};
+	};
+
+	Chunk* GetChunk(const uint32_t chunk_num)
+	{
+		assert(chunk_num < header.num_chunks);
+
+		if (const auto it = chunks.find(chunk_num); it != chunks.end()) {
+			lru.splice(lru.begin(), lru, it->second.lru_pos);
+			return &it->second;
+		}
+
+		if (chunks.size() >= MaxCachedChunks) {
+			const auto oldest = chunks.find(lru.back());
+			assert(oldest != chunks.end());
+			StoreChunk(oldest->first, oldest->second);
+			chunks.erase(oldest);
+			lru.pop_back();
+		}
+
+		Chunk chunk = {};
+		chunk.data.resize(ChunkSize);
+		if (!LoadChunk(chunk_num, chunk.data)) {
+			return nullptr;
+		}
+
+		lru.push_front(chunk_num);
+		chunk.lru_pos = lru.begin();
+
+		return &chunks.emplace(chunk_num, std::move(chunk)).first->second;
+	}
+
+	bool LoadChunk(const uint32_t chunk_num, std::vector<uint8_t>& data)
+	{
+		const auto& entry = index[chunk_num];
+		if (entry.offset == 0) {
+			// Only zeros
+			return true;
+		}
+		if (entry.stored_size == ChunkSize) {
+			if (!read_at(file, entry.offset, data.data(), ChunkSize)) {
+				LOG_ERR("BIOSDISK: Could not read chunk %u of the compressed image",
+				        chunk_num);
+				return false;
+			}
+			return true;
+		}
+
+		std::vector<uint8_t> packed(entry.stored_size);
+		auto unpacked_size = static_cast<uLongf>(ChunkSize);
+		if (!read_at(file, entry.offset, packed.data(), packed.size()) ||
+		    uncompress(data.data(), &unpacked_size, packed.data(), entry.stored_size) !=
+		            Z_OK ||
+		    unpacked_size != ChunkSize) {
+			LOG_ERR("BIOSDISK: Could not decompress chunk %u of the compressed image",
+			        chunk_num);
+			return false;
+		}
+		return true;
+	}
+
+	// Held back writes that fail are lost, as they would be on a raw image
+	void StoreChunk(const uint32_t chunk_num, Chunk& chunk)
+	{
+		if (!chunk.is_dirty) {
+			return;
+		}
+		chunk.is_dirty = false;
+
+		const auto entry = store_chunk(file, end_of_file, chunk.data);
+		if (!entry || !write_index_entry(file, chunk_num, *entry)) {
+			LOG_ERR("BIOSDISK: Could not write chunk %u of the compressed image",
+			        chunk_num);
+			return;
+		}
+		index[chunk_num] = *entry;
+	}
+
+	FILE* file = nullptr;
+
+	const CompressedHeader header = {};
+	std::vector<IndexEntry> index = {};
+
+	// New versions of the chunks are appended here
+	int64_t end_of_file = 0;
+
+	std::unordered_map<uint32_t, Chunk> chunks = {};
+	// Chunk numbers, most recently used first
+	std::list<uint32_t> lru = {};
+};
+
+static std::unique_ptr<DiskImageFile> open_compressed(FILE* file)
+{
+	CompressedHeader header = {};
+	if (!read_header(file, header)) {
+		LOG_ERR("BIOSDISK: The header of the compressed image is damaged or from a newer version");
+		return {};
+	}
+
+	std::vector<uint8_t> bytes(header.num_chunks * IndexEntrySize);
+	if (!read_at(file, HeaderSize, bytes.data(), bytes.size())) {
+		LOG_ERR("BIOSDISK: Could not read the index of the compressed image");
+		return {};
+	}
+
+	const auto end_of_file = stdio_size_bytes(file);
+
+	std::vector<IndexEntry> index(header.num_chunks);
+	for (uint32_t i = 0; i < header.num_chunks; ++i) {
+		auto& entry       = index[i];
+		entry.offset      = static_cast<int64_t>(host_readq(&bytes[i * IndexEntrySize]));
+		entry.stored_size = host_readd(&bytes[i * IndexEntrySize + 8]);
+
+		if (entry.offset != 0 &&
+		    (entry.stored_size == 0 || entry.stored_size > ChunkSize ||
+		     entry.offset + entry.stored_size > end_of_file)) {
+			LOG_ERR("BIOSDISK: The index of the compressed image is damaged");
+			return {};
+		}
+	}
+
+	return std::make_unique<CompressedDiskImageFile>(file,
+	                                                 header,
+	                                                 std::move(index),
+	                                                 end_of_file);
+}
+
+std::unique_ptr<DiskImageFile> DISK_IMAGE_Open(FILE* file, const bool should_preload,
+                                               const std::string& name)
+{
+	assert(file);
+
+	if (!DISK_IMAGE_IsCompressed(file)) {
+		if (should_preload) {
+			return std::make_unique<PreloadedDiskImageFile>(file, name);
+		}
+		return std::make_unique<RawDiskImageFile>(file);
+	}
+	auto image = open_compressed(file);
+	if (!image) {
+		fclose(file);
+	}
+	return image;
+}
+
+bool DISK_IMAGE_IsCompressed(FILE* file)
+{
+	const auto orig_pos = cross_ftello(file);
+
+	std::array<uint8_t, MagicSize> magic = {};
+	const auto is_compressed = read_at(file, 0, magic.data(), magic.size()) &&
+	                           std::memcmp(magic.data(), CompressedMagic, MagicSize) == 0;
+	clearerr(file);
+
+	cross_fseeko(file, orig_pos, SEEK_SET);
+	return is_compressed;
+}
+
+int64_t DISK_IMAGE_GetSize(FILE* file)
+{
+	if (!DISK_IMAGE_IsCompressed(file)) {
+		return stdio_size_bytes(file);
+	}
+
+	const auto orig_pos = cross_ftello(file);
+
+	CompressedHeader header = {};
+	const auto is_valid     = read_header(file, header);
+
+	cross_fseeko(file, orig_pos, SEEK_SET);
+	return is_valid ? header.disk_size : -1;
+}
+
+bool DISK_IMAGE_Compress(FILE* source, FILE* dest)
+{
+	CompressedHeader header = {};
+
+	header.chunk_size = ChunkSize;
+	header.disk_size  = stdio_size_bytes(source);
+	if (header.disk_size < 0) {
+		return false;
+	}
+	header.num_chunks = check_cast<uint32_t>((header.disk_size + ChunkSize - 1) /
+	                                         ChunkSize);
+
+	// All chunks start out as zeros
+	const std::vector<uint8_t> empty_index(header.num_chunks * IndexEntrySize);
+	if (!write_header(dest, header) ||
+	    !write_at(dest, HeaderSize, empty_index.data(), empty_index.size())) {
+		return false;
+	}
+
+	auto end_of_file = get_index_entry_offset(header.num_chunks);
+
+	std::vector<uint8_t> data(ChunkSize);
+	for (uint32_t i = 0; i < header.num_chunks; ++i) {
+		if (cross_fseeko(source, static_cast<int64_t>(i) * ChunkSize, SEEK_SET) != 0) {
+			return false;
+		}
+		// The last chunk is padded with zeros
+		const auto num_read = fread(data.data(), 1, ChunkSize, source);
+		std::fill(data.begin() + check_cast<ptrdiff_t>(num_read), data.end(), uint8_t(0));
+
+		const auto entry = store_chunk(dest, end_of_file, data);
+		if (!entry) {
+			return false;
+		}
+		if (entry->offset != 0 && !write_index_entry(dest, i, *entry)) {
+			return false;
+		}
+	}
+	return fflush(dest) == 0;
+}
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_DISK_IMAGE_FILE_H
+#define DOSBOX_DISK_IMAGE_FILE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+// Random access to the disk held in an image file.
+//
+// Raw images are read and written in place. Compressed images store the disk
+// in fixed-size chunks that are deflated one by one, so any sector can be
+// read by inflating only the chunk that holds it. Chunks holding nothing but
+// zeros are not stored at all, which keeps mostly empty disks small.
+//
+// Compressed image layout, all values little-endian:
+//
+//   header  "DBXCIMG1" magic, chunk size, disk size, number of chunks
+//   index   file offset and stored size of every chunk. An offset of zero
+//           means the chunk only holds zeros, and a stored size equal to the
+//           chunk size means it's stored uncompressed.
+//   chunks  the stored chunks, in any order
+//
+// The chunks written by the guest are compressed again when flushed and
+// appended to the end of the file. The space of the versions they replace
+// isn't reused.
+//
+// Raw images can also be preloaded: they're read into memory on a worker
+// thread, and the writes go to the file in the background (see
+// ImagePreloader).
+
+class DiskImageFile {
+public:
+	virtual ~DiskImageFile() = default;
+
+	// Size of the disk held in the image
+	virtual int64_t GetSize() const = 0;
+
+	// Reading past the end of the disk is not an error; the missing part
+	// of the data is filled with zeros
+	virtual bool Read(const int64_t offset, uint8_t* data, const size_t num_bytes) = 0;
+	virtual bool Write(const int64_t offset, const uint8_t* data,
+	                   const size_t num_bytes) = 0;
+
+	// Writes out everything held back
+	virtual void Flush() = 0;
+};
+
+// Takes ownership of the file, which is closed when the returned object is
+// destroyed. Returns nullptr if the file is a damaged compressed image.
+// Compressed images are never preloaded; they're small and decompressed on
+// demand anyway.
+std::unique_ptr<DiskImageFile> DISK_IMAGE_Open(FILE* file,
+                                               const bool should_preload = false,
+                                               const std::string& name = {});
+
+bool DISK_IMAGE_IsCompressed(FILE* file);
+
+// Size of the disk held in the image file, or -1 on error. The file position
+// is restored.
+int64_t DISK_IMAGE_GetSize(FILE* file);
+
+// Writes a compressed copy of the raw image in 'source' to 'dest'
+bool DISK_IMAGE_Compress(FILE* source, FILE* dest);
+
+#endif // DOSBOX_DISK_IMAGE_FILE_H
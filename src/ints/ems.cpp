@@ -5,9 +5,11 @@
 #include "dosbox.h"
 
 #include <algorithm>
+#include <cassert>
 #include <cstring>
 #include <cstdlib>
 #include <memory>
+#include <vector>
 
 #include "config/setup.h"
 #include "cpu/callback.h"
@@ -90,6 +92,12 @@ static EMM_Handle emm_handles[EMM_MAX_HANDLES];
 static EMM_Mapping emm_mappings[EMM_MAX_PHYS];
 static EMM_Mapping emm_segmentmappings[0x40];
 
+// Memory handles of the 4 KB pages behind each EMS handle, so mapping a
+// logical page does not have to walk the allocation chain; built on first use
+static std::vector<MemHandle> emm_handle_pages[EMM_MAX_HANDLES];
+
+static uint64_t num_page_maps = 0;
+
 static uint16_t get_total_pages()
 {
 	return std::min(MaxPages, static_cast<size_t>(MEM_TotalPages() / EMM_MAX_PHYS));
@@ -261,6 +269,59 @@ static bool inline ValidHandle(uint16_t handle) {
 	return true;
 }
 
+uint64_t EMS_GetNumPageMaps()
+{
+	return num_page_maps;
+}
+
+static void InvalidatePageTable(uint16_t handle)
+{
+	emm_handle_pages[handle].clear();
+}
+
+// Returns the memory handles of the four 4 KB pages of a logical page
+static const MemHandle* GetPageHandles(uint16_t handle, uint16_t log_page)
+{
+	auto& table = emm_handle_pages[handle];
+	if (table.empty()) {
+		table.reserve(emm_handles[handle].pages * 4);
+		auto memh = emm_handles[handle].mem;
+		for (auto i = 0; i < emm_handles[handle].pages * 4; ++i) {
+			table.push_back(memh);
+			memh = MEM_NextHandle(memh);
+		}
+	}
+	assert(log_page * 4u + 3 < table.size());
+	return &table[log_page * 4];
+}
+
+// Points the four linear 4 KB pages of a 16 KB window at a logical page, or
+// back at themselves when unmapping
+static void MapWindow(Bitu first_page, uint16_t handle, uint16_t log_page)
+{
+	if (log_page == NULL_PAGE) {
+		for (Bitu i = 0; i < 4; i++) {
+			PAGING_MapPage(first_page + i, first_page + i);
+		}
+	} else {
+		const auto memh = GetPageHandles(handle, log_page);
+		for (Bitu i = 0; i < 4; i++) {
+			PAGING_MapPage(first_page + i, memh[i]);
+		}
+	}
+	++num_page_maps;
+}
+
+// Without paging, PAGING_MapPage has already reset the TLB entries of the
+// remapped pages and nothing else can refer to them. With paging enabled,
+// any linear page could alias the window, so the whole TLB has to go.
+static void FlushTLB()
+{
+	if (PAGING_Enabled()) {
+		PAGING_ClearTLB();
+	}
+}
+
 static uint8_t EMM_AllocateMemory(uint16_t pages,uint16_t & dhandle,bool can_allocate_zpages) {
 	/* Check for 0 page allocation */
 	if (!pages) {
@@ -282,6 +343,7 @@ static uint8_t EMM_AllocateMemory(uint16_t pages,uint16_t & dhandle,bool can_all
 	}
 	emm_handles[handle].pages = pages;
 	emm_handles[handle].mem = mem;
+	InvalidatePageTable(handle);
 	/* Change handle only if there is no error. */
 	dhandle = handle;
 	return EMM_NO_ERROR;
@@ -301,6 +363,7 @@ static uint8_t EMM_AllocateSystemHandle(uint16_t pages) {
 	if (!mem) E_Exit("EMS:System handle memory allocation failure");
 	emm_handles[handle].pages = pages;
 	emm_handles[handle].mem = mem;
+	InvalidatePageTable(handle);
 	return EMM_NO_ERROR;
 }
 
@@ -317,10 +380,11 @@ static uint8_t EMM_ReallocatePages(uint16_t handle,uint16_t & pages) {
 	}
 	/* Update size */
 	emm_handles[handle].pages=pages;
+	InvalidatePageTable(handle);
 	return EMM_NO_ERROR;
 }
 
-static uint8_t EMM_MapPage(Bitu phys_page,uint16_t handle,uint16_t log_page) {
+static uint8_t EMM_MapPage(Bitu phys_page,uint16_t handle,uint16_t log_page,bool flush_tlb=true) {
 //	LOG_MSG("EMS MapPage handle %d phys %d log %d",handle,phys_page,log_page);
 	/* Check for too high physical page */
 	if (phys_page>=EMM_MAX_PHYS) return EMM_ILL_PHYS;
@@ -330,9 +394,8 @@ static uint8_t EMM_MapPage(Bitu phys_page,uint16_t handle,uint16_t log_page) {
 		/* Unmapping */
 		emm_mappings[phys_page].handle=NULL_HANDLE;
 		emm_mappings[phys_page].page=NULL_PAGE;
-		for (Bitu i=0;i<4;i++)
-			PAGING_MapPage(EMM_PAGEFRAME4K+phys_page*4+i,EMM_PAGEFRAME4K+phys_page*4+i);
-		PAGING_ClearTLB();
+		MapWindow(EMM_PAGEFRAME4K+phys_page*4,NULL_HANDLE,NULL_PAGE);
+		if (flush_tlb) FlushTLB();
 		return EMM_NO_ERROR;
 	}
 	/* Check for valid handle */
@@ -343,12 +406,8 @@ static uint8_t EMM_MapPage(Bitu phys_page,uint16_t handle,uint16_t log_page) {
 		emm_mappings[phys_page].handle=handle;
 		emm_mappings[phys_page].page=log_page;
 
-		MemHandle memh=MEM_NextHandleAt(emm_handles[handle].mem,log_page*4);;
-		for (Bitu i=0;i<4;i++) {
-			PAGING_MapPage(EMM_PAGEFRAME4K+phys_page*4+i,memh);
-			memh=MEM_NextHandle(memh);
-		}
-		PAGING_ClearTLB();
+		MapWindow(EMM_PAGEFRAME4K+phys_page*4,handle,log_page);
+		if (flush_tlb) FlushTLB();
 		return EMM_NO_ERROR;
 	} else  {
 		/* Illegal logical page it is */
@@ -356,7 +415,7 @@ static uint8_t EMM_MapPage(Bitu phys_page,uint16_t handle,uint16_t log_page) {
 	}
 }
 
-static uint8_t EMM_MapSegment(Bitu segment,uint16_t handle,uint16_t log_page) {
+static uint8_t EMM_MapSegment(Bitu segment,uint16_t handle,uint16_t log_page,bool flush_tlb=true) {
 //	LOG_MSG("EMS MapSegment handle %d segment %d log %d",handle,segment,log_page);
 
 	bool valid_segment=false;
@@ -388,9 +447,8 @@ static uint8_t EMM_MapSegment(Bitu segment,uint16_t handle,uint16_t log_page) {
 				emm_segmentmappings[segment>>10].handle=NULL_HANDLE;
 				emm_segmentmappings[segment>>10].page=NULL_PAGE;
 			}
-			for (Bitu i=0;i<4;i++)
-				PAGING_MapPage(segment*16/4096+i,segment*16/4096+i);
-			PAGING_ClearTLB();
+			MapWindow(segment*16/4096,NULL_HANDLE,NULL_PAGE);
+			if (flush_tlb) FlushTLB();
 			return EMM_NO_ERROR;
 		}
 		/* Check for valid handle */
@@ -406,12 +464,8 @@ static uint8_t EMM_MapSegment(Bitu segment,uint16_t handle,uint16_t log_page) {
 				emm_segmentmappings[segment>>10].page=log_page;
 			}
 
-			MemHandle memh=MEM_NextHandleAt(emm_handles[handle].mem,log_page*4);;
-			for (Bitu i=0;i<4;i++) {
-				PAGING_MapPage(segment*16/4096+i,memh);
-				memh=MEM_NextHandle(memh);
-			}
-			PAGING_ClearTLB();
+			MapWindow(segment*16/4096,handle,log_page);
+			if (flush_tlb) FlushTLB();
 			return EMM_NO_ERROR;
 		} else  {
 			/* Illegal logical page it is */
@@ -440,6 +494,7 @@ static uint8_t EMM_ReleaseMemory(uint16_t handle) {
 	} else {
 		emm_handles[handle].pages=NULL_HANDLE;
 	}
+	InvalidatePageTable(handle);
 	emm_handles[handle].saved_page_map=false;
 	memset(&emm_handles[handle].name,0,8);
 	return EMM_NO_ERROR;
@@ -467,11 +522,13 @@ static uint8_t EMM_RestoreMappingTable(void) {
 		/* Skip the pageframe */
 		if ((i>=EMM_PAGEFRAME/0x400) && (i<(EMM_PAGEFRAME/0x400)+EMM_MAX_PHYS)) continue;
 		EMM_MapSegment(i << 10, emm_segmentmappings[i].handle,
-		               emm_segmentmappings[i].page);
+		               emm_segmentmappings[i].page, false);
 	}
 	for (Bitu i=0;i<EMM_MAX_PHYS;i++) {
-		EMM_MapPage(i, emm_mappings[i].handle, emm_mappings[i].page);
+		EMM_MapPage(i, emm_mappings[i].handle, emm_mappings[i].page, false);
 	}
+	/* One flush for the whole table */
+	FlushTLB();
 	return EMM_NO_ERROR;
 }
 static uint8_t EMM_RestorePageMap(uint16_t handle) {
@@ -673,6 +730,51 @@ static void LoadMoveRegion(PhysPt data,MoveRegion & region) {
 	region.dest_page_seg=mem_readw(data+0x10);
 }
 
+// A position in a region being moved: conventional memory, or a handle's
+// page and the offset into it
+struct RegionCursor {
+	bool is_handle       = false;
+	PhysPt address       = 0;
+	MemHandle mem_handle = 0;
+	Bitu offset          = 0;
+
+	// Bytes from here on, up to 'limit', that are contiguous in memory
+	Bitu ContiguousBytes(const Bitu limit) const
+	{
+		if (!is_handle) {
+			return limit;
+		}
+		Bitu bytes  = MEM_PAGE_SIZE - offset;
+		auto handle = mem_handle;
+		while (bytes < limit && MEM_NextHandle(handle) == handle + 1) {
+			++handle;
+			bytes += MEM_PAGE_SIZE;
+		}
+		return std::min(bytes, limit);
+	}
+
+	PhysPt Address() const
+	{
+		return is_handle ? static_cast<PhysPt>(mem_handle * MEM_PAGE_SIZE + offset)
+		                 : address;
+	}
+
+	void Advance(const Bitu bytes)
+	{
+		if (!is_handle) {
+			address += static_cast<PhysPt>(bytes);
+			return;
+		}
+		offset += bytes;
+		while (offset >= MEM_PAGE_SIZE) {
+			mem_handle = MEM_NextHandle(mem_handle);
+			offset -= MEM_PAGE_SIZE;
+		}
+	}
+};
+
+static uint64_t num_bytes_moved = 0;
+
 static uint8_t MemoryRegion()
 {
 	MoveRegion region;
@@ -683,95 +785,60 @@ static uint8_t MemoryRegion()
 	}
 	LoadMoveRegion(SegPhys(ds)+reg_si,region);
 	/* Parse the region for information */
-	PhysPt src_mem = 0,dest_mem = 0;
-	MemHandle src_handle = 0,dest_handle = 0;
-	Bitu src_off = 0,dest_off = 0 ;Bitu src_remain = 0,dest_remain = 0;
+	RegionCursor src = {};
+	RegionCursor dest = {};
 	if (!region.src_type) {
-		src_mem=region.src_page_seg*16+region.src_offset;
+		src.address=region.src_page_seg*16+region.src_offset;
 	} else {
 		if (!ValidHandle(region.src_handle)) return EMM_INVALID_HANDLE;
 		if ((emm_handles[region.src_handle].pages*EmsPageSize) < ((region.src_page_seg*EmsPageSize)+region.src_offset+region.bytes)) return EMM_LOG_OUT_RANGE;
-		src_handle=emm_handles[region.src_handle].mem;
 		Bitu pages=region.src_page_seg*4+(region.src_offset/MEM_PAGE_SIZE);
-		for (;pages>0;pages--) src_handle=MEM_NextHandle(src_handle);
-		src_off=region.src_offset&(MEM_PAGE_SIZE-1);
-		src_remain=MEM_PAGE_SIZE-src_off;
+		src.is_handle=true;
+		src.mem_handle=MEM_NextHandleAt(emm_handles[region.src_handle].mem,pages);
+		src.offset=region.src_offset&(MEM_PAGE_SIZE-1);
 	}
 	if (!region.dest_type) {
-		dest_mem=region.dest_page_seg*16+region.dest_offset;
+		dest.address=region.dest_page_seg*16+region.dest_offset;
 	} else {
 		if (!ValidHandle(region.dest_handle)) return EMM_INVALID_HANDLE;
 		if (emm_handles[region.dest_handle].pages*EmsPageSize < (region.dest_page_seg*EmsPageSize)+region.dest_offset+region.bytes) return EMM_LOG_OUT_RANGE;
-		dest_handle=emm_handles[region.dest_handle].mem;
 		Bitu pages=region.dest_page_seg*4+(region.dest_offset/MEM_PAGE_SIZE);
-		for (;pages>0;pages--) dest_handle=MEM_NextHandle(dest_handle);
-		dest_off=region.dest_offset&(MEM_PAGE_SIZE-1);
-		dest_remain=MEM_PAGE_SIZE-dest_off;
+		dest.is_handle=true;
+		dest.mem_handle=MEM_NextHandleAt(emm_handles[region.dest_handle].mem,pages);
+		dest.offset=region.dest_offset&(MEM_PAGE_SIZE-1);
 	}
 
-	uint8_t buf_src[MEM_PAGE_SIZE];
-	uint8_t buf_dest[MEM_PAGE_SIZE];
+	num_bytes_moved += region.bytes;
 
-	while (region.bytes > 0) {
-		const size_t toread = std::min<size_t>(region.bytes, MEM_PAGE_SIZE);
+	// Move or exchange the longest runs that are contiguous on both sides
+	static std::vector<uint8_t> buf_src  = {};
+	static std::vector<uint8_t> buf_dest = {};
 
-		/* Read from the source */
-		if (!region.src_type) {
-			MEM_BlockRead(src_mem,buf_src,toread);
-		} else {
-			assert(toread <= MEM_PAGE_SIZE);
-			if (toread <= src_remain) {
-				MEM_BlockRead((src_handle*MEM_PAGE_SIZE)+src_off,buf_src,toread);
-			} else {
-				MEM_BlockRead((src_handle*MEM_PAGE_SIZE)+src_off,buf_src,src_remain);
-				MEM_BlockRead((MEM_NextHandle(src_handle)*MEM_PAGE_SIZE),&buf_src[src_remain],toread-src_remain);
-			}
-		}
-		/* Check for a move */
-		if (reg_al==1) {
-			/* Read from the destination */
-			if (!region.dest_type) {
-				MEM_BlockRead(dest_mem,buf_dest,toread);
-			} else {
-				assert(toread <= MEM_PAGE_SIZE);
-				if (toread <= dest_remain) {
-					MEM_BlockRead((dest_handle*MEM_PAGE_SIZE)+dest_off,buf_dest,toread);
-				} else {
-					MEM_BlockRead((dest_handle*MEM_PAGE_SIZE)+dest_off,buf_dest,dest_remain);
-					MEM_BlockRead((MEM_NextHandle(dest_handle)*MEM_PAGE_SIZE),&buf_dest[dest_remain],toread-dest_remain);
-				}
-			}
-			/* Write to the source */
-			if (!region.src_type) {
-				MEM_BlockWrite(src_mem,buf_dest,toread);
-			} else {
-				assert(toread <= MEM_PAGE_SIZE);
-				if (toread <= src_remain) {
-					MEM_BlockWrite((src_handle*MEM_PAGE_SIZE)+src_off,buf_dest,toread);
-				} else {
-					MEM_BlockWrite((src_handle*MEM_PAGE_SIZE)+src_off,buf_dest,src_remain);
-					MEM_BlockWrite((MEM_NextHandle(src_handle)*MEM_PAGE_SIZE),&buf_dest[src_remain],toread-src_remain);
-				}
-			}
-		}
-		/* Write to the destination */
-		if (!region.dest_type) {
-			MEM_BlockWrite(dest_mem,buf_src,toread);
+	while (region.bytes > 0) {
+		const auto run = dest.ContiguousBytes(src.ContiguousBytes(region.bytes));
+		const auto src_pt  = src.Address();
+		const auto dest_pt = dest.Address();
+
+		if (reg_al == 1) {
+			/* Exchange */
+			buf_src.resize(run);
+			buf_dest.resize(run);
+			MEM_BlockRead(src_pt, buf_src.data(), run);
+			MEM_BlockRead(dest_pt, buf_dest.data(), run);
+			MEM_BlockWrite(src_pt, buf_dest.data(), run);
+			MEM_BlockWrite(dest_pt, buf_src.data(), run);
+		} else if (dest_pt > src_pt && dest_pt < src_pt + run) {
+			/* Overlapping from above, go through a buffer to keep
+			   the source intact */
+			buf_src.resize(run);
+			MEM_BlockRead(src_pt, buf_src.data(), run);
+			MEM_BlockWrite(dest_pt, buf_src.data(), run);
 		} else {
-			assert(toread <= MEM_PAGE_SIZE);
-			if (toread <= dest_remain) {
-				MEM_BlockWrite((dest_handle*MEM_PAGE_SIZE)+dest_off,buf_src,toread);
-			} else {
-				MEM_BlockWrite((dest_handle*MEM_PAGE_SIZE)+dest_off,buf_src,dest_remain);
-				MEM_BlockWrite((MEM_NextHandle(dest_handle)*MEM_PAGE_SIZE),&buf_src[dest_remain],toread-dest_remain);
-			}
+			mem_memcpy(dest_pt, src_pt, run);
 		}
-		/* Advance the pointers */
-		if (!region.src_type) src_mem+=toread;
-		else src_handle=MEM_NextHandle(src_handle);
-		if (!region.dest_type) dest_mem+=toread;
-		else dest_handle=MEM_NextHandle(dest_handle);
-		region.bytes-=toread;
+		src.Advance(run);
+		dest.Advance(run);
+		region.bytes -= static_cast<uint32_t>(run);
 	}
 	return EMM_NO_ERROR;
 }
@@ -970,7 +1037,7 @@ static Bitu INT67_Handler(void) {
 				for (ct=0; ct<4; ct++) {
 					uint16_t handle=emm_mappings[ct].handle;
 					if (handle != NULL_HANDLE) {
-						auto memh=(uint16_t)MEM_NextHandleAt(emm_handles[handle].mem,emm_mappings[ct].page*4);
+						auto memh=(uint16_t)*GetPageHandles(handle,emm_mappings[ct].page);
 						uint16_t entry_addr=reg_di+(EMM_PAGEFRAME>>6)+(ct*0x10);
 						real_writew(SegValue(es),entry_addr+0x00+0x01,(memh+0)*0x10);		// mapping of 1/4 of page
 						real_writew(SegValue(es),entry_addr+0x04+0x01,(memh+1)*0x10);		// mapping of 2/4 of page
@@ -1034,9 +1101,9 @@ static Bitu INT67_Handler(void) {
 						reg_ah=EMM_ILL_PHYS;
 						break;
 					} else {
-						MemHandle memh=MEM_NextHandleAt(
-							emm_handles[handle].mem,
-							emm_mappings[phys_page].page*4);
+						MemHandle memh=*GetPageHandles(
+							handle,
+							emm_mappings[phys_page].page);
 						reg_edx=(memh+(reg_cx&3))<<12;
 					}
 				} else {
@@ -1468,7 +1535,9 @@ public:
 			emm_handles[i].mem=0;
 			emm_handles[i].pages=NULL_HANDLE;
 			memset(&emm_handles[i].name,0,8);
+			InvalidatePageTable(i);
 		}
+		num_page_maps=0;
 		for (i=0;i<EMM_MAX_PHYS;i++) {
 			emm_mappings[i].page=NULL_PAGE;
 			emm_mappings[i].handle=NULL_HANDLE;
@@ -1534,6 +1603,11 @@ public:
 	EMS &operator=(const EMS &) = delete; // prevent assignment
 
 	~EMS() {
+		if (num_bytes_moved) {
+			LOG_DEBUG("EMS: Moved %llu bytes between regions",
+			          static_cast<unsigned long long>(num_bytes_moved));
+			num_bytes_moved = 0;
+		}
 		if (ems_type<=0) return;
 
 		/* Undo Biosclearing */
@@ -13,4 +13,7 @@ extern const std::string EmsDeviceName;
 void EMS_Init(SectionProp& section);
 void EMS_Destroy();
 
+// Number of 16 KB pages mapped or unmapped since EMS was set up
+uint64_t EMS_GetNumPageMaps();
+
 #endif // DOSBOX_EMS_H
@@ -926,6 +926,11 @@ static void SetupTandyBios()
 	}
 }
 
+bool INT10_IsVectorHooked()
+{
+	return RealGetVec(0x10) != CALLBACK_RealPointer(call_10);
+}
+
 void INT10_Init()
 {
 	INT10_SetupPalette();
@@ -352,6 +352,19 @@ void INT10_TeletypeOutputAttrViaInterrupt(const uint8_t char_value,
                                           const uint8_t attribute,
                                           const bool use_attribute);
 
+// Teletype output of a string in a text mode. Equivalent to calling
+// INT10_TeletypeOutputAttr() for each character, but the cursor is only moved
+// once at the end. The lines scrolled in are filled with 'fill_attribute' if
+// set, otherwise with the attribute at the cursor as the teletype does. The
+// string must not contain the bell character.
+void INT10_TeletypeOutputString(const uint8_t* chars, const uint16_t count,
+                                const uint8_t attribute, const bool use_attribute,
+                                const std::optional<uint8_t> fill_attribute);
+
+// True if a program has taken over the INT 10h vector, so the video BIOS
+// functions have to be called through it for the program to see them
+bool INT10_IsVectorHooked();
+
 void INT10_ReadCharAttr(uint16_t* result, uint8_t page);
 
 void INT10_WriteChar(const uint8_t char_value, const uint8_t attribute,
@@ -6,12 +6,15 @@
 
 #include "int10.h"
 
+#include <array>
+
 #include "ints/bios.h"
 #include "cpu/callback.h"
 #include "hardware/port.h"
 #include "hardware/memory.h"
 #include "hardware/pic.h"
 #include "cpu/registers.h"
+#include "utils/ascii.h"
 
 static void CGA2_CopyRow(uint8_t cleft,uint8_t cright,uint8_t rold,uint8_t rnew,PhysPt base) {
 	BIOS_CHEIGHT;
@@ -79,7 +82,7 @@ static void VGA_CopyRow(uint8_t cleft,uint8_t cright,uint8_t rold,uint8_t rnew,P
 	Bitu rowsize=8*(cright-cleft);
 	copy=cheight;
 	for (;copy>0;copy--) {
-		for (Bitu x=0;x<rowsize;x++) mem_writeb(dest+x,mem_readb(src+x));
+		MEM_BlockCopy(dest,src,rowsize);
 		dest+=nextline;src+=nextline;
 	}
 }
@@ -98,10 +101,8 @@ static void CGA2_FillRow(uint8_t cleft,uint8_t cright,uint8_t row,PhysPt base,ui
 	Bitu nextline=CurMode->twidth;
 	attr=(attr & 0x3) | ((attr & 0x3) << 2) | ((attr & 0x3) << 4) | ((attr & 0x3) << 6);
 	for (Bitu i=0;i<cheight/2U;i++) {
-		for (Bitu x=0;x<copy;x++) {
-			mem_writeb(dest+x,attr);
-			mem_writeb(dest+8*1024+x,attr);
-		}
+		MEM_BlockFill(dest,attr,copy);
+		MEM_BlockFill(dest+8*1024,attr,copy);
 		dest+=nextline;
 	}
 }
@@ -112,10 +113,8 @@ static void CGA4_FillRow(uint8_t cleft,uint8_t cright,uint8_t row,PhysPt base,ui
 	Bitu copy=(cright-cleft)*2;Bitu nextline=CurMode->twidth*2;
 	attr=(attr & 0x3) | ((attr & 0x3) << 2) | ((attr & 0x3) << 4) | ((attr & 0x3) << 6);
 	for (Bitu i=0;i<cheight/2U;i++) {
-		for (Bitu x=0;x<copy;x++) {
-			mem_writeb(dest+x,attr);
-			mem_writeb(dest+8*1024+x,attr);
-		}
+		MEM_BlockFill(dest,attr,copy);
+		MEM_BlockFill(dest+8*1024,attr,copy);
 		dest+=nextline;
 	}
 }
@@ -127,9 +126,7 @@ static void TANDY16_FillRow(uint8_t cleft,uint8_t cright,uint8_t row,PhysPt base
 	Bitu copy=(cright-cleft)*4;Bitu nextline=CurMode->twidth*4;
 	attr=(attr & 0xf) | (attr & 0xf) << 4;
 	for (Bitu i=0;i<static_cast<Bitu>(cheight/banks);i++) {
-		for (Bitu x=0;x<copy;x++) {
-			for (Bitu b=0;b<banks;b++) mem_writeb(dest+b*8*1024+x,attr);
-		}
+		for (Bitu b=0;b<banks;b++) MEM_BlockFill(dest+b*8*1024,attr,copy);
 		dest+=nextline;
 	}
 }
@@ -160,7 +157,7 @@ static void VGA_FillRow(uint8_t cleft,uint8_t cright,uint8_t row,PhysPt base,uin
 	Bitu nextline=8*CurMode->twidth;
 	Bitu copy = cheight;Bitu rowsize=8*(cright-cleft);
 	for (;copy>0;copy--) {
-		for (Bitu x=0;x<rowsize;x++) mem_writeb(dest+x,attr);
+		MEM_BlockFill(dest,attr,rowsize);
 		dest+=nextline;
 	}
 }
@@ -169,11 +166,15 @@ static void TEXT_FillRow(uint8_t cleft,uint8_t cright,uint8_t row,PhysPt base,ui
 	/* Do some filing */
 	PhysPt dest;
 	dest=base+(row*CurMode->twidth+cleft)*2;
-	uint16_t fill=(attr<<8)+' ';
-	for (uint8_t x=0;x<(cright-cleft);x++) {
-		mem_writew(dest,fill);
-		dest+=2;
+
+	// The row is written as one block of blank cells
+	std::array<uint8_t, 256 * 2> cells;
+	const auto num_cells = static_cast<size_t>(cright - cleft);
+	for (size_t x = 0; x < num_cells; ++x) {
+		cells[x * 2]     = ' ';
+		cells[x * 2 + 1] = attr;
 	}
+	MEM_BlockWrite(dest, cells.data(), num_cells * 2);
 }
 
 uint16_t INT10_GetTextColumns()
@@ -836,6 +837,64 @@ void INT10_TeletypeOutputAttrViaInterrupt(const uint8_t char_value,
 	                                               page);
 }
 
+void INT10_TeletypeOutputString(const uint8_t* chars, const uint16_t count,
+                                const uint8_t attribute, const bool use_attribute,
+                                const std::optional<uint8_t> fill_attribute)
+{
+	assert(CurMode->type == M_TEXT);
+
+	const auto page = real_readb(BIOSMEM_SEG, BIOSMEM_CURRENT_PAGE);
+	BIOS_NCOLS;
+	BIOS_NROWS;
+	uint8_t cur_row = CURSOR_POS_ROW(page);
+	uint8_t cur_col = CURSOR_POS_COL(page);
+
+	for (uint16_t i = 0; i < count; ++i) {
+		const auto chr = chars[i];
+		assert(chr != Ascii::Bell);
+
+		// Where the cursor would be while the character is handled
+		const auto prev_row = cur_row;
+		const auto prev_col = cur_col;
+
+		switch (chr) {
+		case Ascii::Backspace:
+			if (cur_col > 0) {
+				cur_col--;
+			}
+			break;
+		case Ascii::CarriageReturn: cur_col = 0; break;
+		case Ascii::LineFeed: cur_row++; break;
+		default:
+			WriteChar(cur_col, cur_row, page, chr, attribute, use_attribute);
+			cur_col++;
+		}
+		if (cur_col == ncols) {
+			cur_col = 0;
+			cur_row++;
+		}
+		if (cur_row == nrows) {
+			uint8_t fill = 0;
+			if (fill_attribute) {
+				fill = *fill_attribute;
+			} else {
+				uint16_t chat = 0;
+				ReadCharAttr(prev_col, prev_row, page, &chat);
+				fill = static_cast<uint8_t>(chat >> 8);
+			}
+			INT10_ScrollWindow(0,
+			                   0,
+			                   static_cast<uint8_t>(nrows - 1),
+			                   static_cast<uint8_t>(ncols - 1),
+			                   -1,
+			                   fill,
+			                   page);
+			cur_row--;
+		}
+	}
+	INT10_SetCursorPos(cur_row, cur_col, page);
+}
+
 void INT10_TeletypeOutput(uint8_t chr,uint8_t attr) {
 	INT10_TeletypeOutputAttr(chr,attr,CurMode->type!=M_TEXT);
 }
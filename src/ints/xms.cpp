@@ -130,6 +130,9 @@ static struct {
 	RealPt callback = 0;
 
 	XMS_Block handles[NumXmsHandles] = {};
+
+	// Bytes moved with function 0Bh
+	uint64_t num_bytes_moved = 0;
 } xms;
 
 // ***************************************************************************
@@ -382,6 +385,7 @@ static Result xms_move_memory(const PhysPt bpt)
 		a20_enable(true);
 
 		mem_memcpy(destpt, srcpt, length);
+		xms.num_bytes_moved += length;
 
 		--a20.num_times_enabled;
 		if (!a20_was_enabled) {
@@ -813,6 +817,10 @@ XMS::~XMS()
 		}
 	}
 
+	LOG_DEBUG("XMS: Moved %llu bytes between blocks",
+	          static_cast<unsigned long long>(xms.num_bytes_moved));
+	xms.num_bytes_moved = 0;
+
 	xms.is_available = false;
 }
 
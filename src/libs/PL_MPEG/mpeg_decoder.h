@@ -3389,6 +3389,9 @@ void plm_video_process_macroblock(
 		return; // corrupt video
 	}
 
+#ifdef PLM_USE_SIMD_KERNELS
+	predict_block(s + si, d + di, dw, block_size, odd_h, odd_v, interpolate);
+#else
 	#define PLM_MB_CASE(INTERPOLATE, ODD_H, ODD_V, OP) \
 		case ((INTERPOLATE << 2) | (ODD_H << 1) | (ODD_V)): \
 			PLM_BLOCK_SET(d, di, dw, si, dw, block_size, OP); \
@@ -3407,6 +3410,7 @@ void plm_video_process_macroblock(
 	}
 
 	#undef PLM_MB_CASE
+#endif
 }
 
 void plm_video_decode_block(plm_video_t *self, int block) {
@@ -3543,8 +3547,13 @@ void plm_video_decode_block(plm_video_t *self, int block) {
 			s[0] = 0;
 		}
 		else {
+#ifdef PLM_USE_SIMD_KERNELS
+			idct_8x8(s);
+			put_idct_block(s, d + di, dw);
+#else
 			plm_video_idct(s);
 			PLM_BLOCK_SET(d, di, dw, si, 8, 8, plm_clamp(s[si]));
+#endif
 			memset(self->block_data, 0, sizeof(self->block_data));
 		}
 	}
@@ -3556,8 +3565,13 @@ void plm_video_decode_block(plm_video_t *self, int block) {
 			s[0] = 0;
 		}
 		else {
+#ifdef PLM_USE_SIMD_KERNELS
+			idct_8x8(s);
+			add_idct_block(s, d + di, dw);
+#else
 			plm_video_idct(s);
 			PLM_BLOCK_SET(d, di, dw, si, 8, 8, plm_clamp(d[di] + s[si]));
+#endif
 			memset(self->block_data, 0, sizeof(self->block_data));
 		}
 	}
@@ -949,6 +949,94 @@ void YM7128B_ChipIdeal_Process(
 
 // ----------------------------------------------------------------------------
 
+void YM7128B_ChipIdeal_Process_Block(
+    YM7128B_ChipIdeal* self,
+    YM7128B_Float const* inputs,
+    YM7128B_Float* outputs,
+    size_t count
+)
+{
+    assert(self);
+    assert(inputs || !count);
+    assert(outputs || !count);
+
+    if ((self->buffer_ == NULL) || (self->length_ == 0)) {
+        return;
+    }
+
+    // The registers can't change within a block, so the gains and taps are
+    // kept in locals the compiler doesn't have to reload after each store
+    // to the delay buffer
+    YM7128B_Float* const buffer = self->buffer_;
+    YM7128B_TapIdeal const length = self->length_;
+    YM7128B_Float const gain_c0 = self->gains_[YM7128B_Reg_C0];
+    YM7128B_Float const gain_c1 = self->gains_[YM7128B_Reg_C1];
+    YM7128B_Float const gain_vc = self->gains_[YM7128B_Reg_VC];
+    YM7128B_Float const gain_vm = self->gains_[YM7128B_Reg_VM];
+    YM7128B_Float const og = 1 / (YM7128B_Float)YM7128B_Oversampling;
+
+    YM7128B_TapIdeal taps[YM7128B_Tap_Count];
+    YM7128B_Float gains[YM7128B_OutputChannel_Count][YM7128B_Tap_Count];
+    YM7128B_Float volumes[YM7128B_OutputChannel_Count];
+
+    for (YM7128B_Register tap = 0; tap < YM7128B_Tap_Count; ++tap) {
+        taps[tap] = self->taps_[tap];
+    }
+    for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+        YM7128B_Register gb = YM7128B_Reg_GL1 + (channel * YM7128B_Gain_Lane_Count);
+        gains[channel][0] = 0;
+        for (YM7128B_Register tap = 1; tap < YM7128B_Tap_Count; ++tap) {
+            gains[channel][tap] = self->gains_[gb + tap - 1];
+        }
+        volumes[channel] = self->gains_[YM7128B_Reg_VL + channel];
+    }
+
+    YM7128B_TapIdeal tail = self->tail_;
+    YM7128B_Float t0_d = self->t0_d_;
+
+    for (size_t i = 0; i < count; ++i) {
+        YM7128B_TapIdeal t0 = tail + taps[0];
+        YM7128B_TapIdeal filter_head = (t0 >= length) ? (t0 - length) : t0;
+        YM7128B_Float filter_t0  = buffer[filter_head];
+        YM7128B_Float filter_d   = t0_d;
+        t0_d = filter_t0;
+        YM7128B_Float filter_c0  = YM7128B_MulFloat(filter_t0, gain_c0);
+        YM7128B_Float filter_c1  = YM7128B_MulFloat(filter_d, gain_c1);
+        YM7128B_Float filter_sum = YM7128B_AddFloat(filter_c0, filter_c1);
+        YM7128B_Float filter_vc  = YM7128B_MulFloat(filter_sum, gain_vc);
+
+        YM7128B_Float input_vm  = YM7128B_MulFloat(inputs[i], gain_vm);
+        YM7128B_Float input_sum = YM7128B_AddFloat(input_vm, filter_vc);
+
+        tail = tail ? (tail - 1) : (length - 1);
+        buffer[tail] = input_sum;
+
+        // Both output channels read the same taps, so each tap is loaded
+        // from the delay buffer only once
+        YM7128B_Float accum[YM7128B_OutputChannel_Count] = {0};
+
+        for (YM7128B_Register tap = 1; tap < YM7128B_Tap_Count; ++tap) {
+            YM7128B_TapIdeal t = tail + taps[tap];
+            YM7128B_TapIdeal head = (t >= length) ? (t - length) : t;
+            YM7128B_Float buffered = buffer[head];
+
+            for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+                accum[channel] += YM7128B_MulFloat(buffered, gains[channel][tap]);
+            }
+        }
+
+        for (YM7128B_Register channel = 0; channel < YM7128B_OutputChannel_Count; ++channel) {
+            YM7128B_Float total_v = YM7128B_MulFloat(accum[channel], volumes[channel]);
+            outputs[i * YM7128B_OutputChannel_Count + channel] = YM7128B_MulFloat(total_v, og);
+        }
+    }
+
+    self->tail_ = tail;
+    self->t0_d_ = t0_d;
+}
+
+// ----------------------------------------------------------------------------
+
 YM7128B_Register YM7128B_ChipIdeal_Read(
     YM7128B_ChipIdeal const* self,
     YM7128B_Address address
@@ -32,6 +32,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assert.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -651,6 +652,15 @@ void YM7128B_ChipIdeal_Process(
     YM7128B_ChipIdeal_Process_Data* data
 );
 
+// Processes a block of mono input samples into interleaved stereo outputs;
+// equivalent to calling YM7128B_ChipIdeal_Process() for each sample
+void YM7128B_ChipIdeal_Process_Block(
+    YM7128B_ChipIdeal* self,
+    YM7128B_Float const* inputs,
+    YM7128B_Float* outputs,
+    size_t count
+);
+
 YM7128B_Register YM7128B_ChipIdeal_Read(
     YM7128B_ChipIdeal const* self,
     YM7128B_Address address
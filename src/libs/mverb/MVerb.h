@@ -143,33 +143,33 @@ public:
             }
             ++ControlRateCounter;
             predelay.SetLength(static_cast<int>(PredelaySmooth));
-            Density2 = static_cast<T>(DecaySmooth + 0.15);
-            if (Density2 > 0.5)
-                Density2 = 0.5;
-            if (Density2 < 0.25)
-                Density2 = 0.25;
+            Density2 = static_cast<T>(DecaySmooth + T(0.15));
+            if (Density2 > T(0.5))
+                Density2 = T(0.5);
+            if (Density2 < T(0.25))
+                Density2 = T(0.25);
             allpassFourTap[1].SetFeedback(Density2);
             allpassFourTap[3].SetFeedback(Density2);
             allpassFourTap[0].SetFeedback(Density1);
             allpassFourTap[2].SetFeedback(Density1);
             T bandwidthLeft = bandwidthFilter[0](left) ;
             T bandwidthRight = bandwidthFilter[1](right) ;
-            T earlyReflectionsL = static_cast<T>(earlyReflectionsDelayLine[0](static_cast<T>(bandwidthLeft * 0.5 + bandwidthRight * 0.3))
-                                + earlyReflectionsDelayLine[0].GetIndex(2) * 0.6
-                                + earlyReflectionsDelayLine[0].GetIndex(3) * 0.4
-                                + earlyReflectionsDelayLine[0].GetIndex(4) * 0.3
-                                + earlyReflectionsDelayLine[0].GetIndex(5) * 0.3
-                                + earlyReflectionsDelayLine[0].GetIndex(6) * 0.1
-                                + earlyReflectionsDelayLine[0].GetIndex(7) * 0.1
-                                + ( bandwidthLeft * 0.4 + bandwidthRight * 0.2 ) * 0.5);
-            T earlyReflectionsR = static_cast<T>(earlyReflectionsDelayLine[1](static_cast<T>(bandwidthLeft * 0.3 + bandwidthRight * 0.5))
-                                + earlyReflectionsDelayLine[1].GetIndex(2) * 0.6
-                                + earlyReflectionsDelayLine[1].GetIndex(3) * 0.4
-                                + earlyReflectionsDelayLine[1].GetIndex(4) * 0.3
-                                + earlyReflectionsDelayLine[1].GetIndex(5) * 0.3
-                                + earlyReflectionsDelayLine[1].GetIndex(6) * 0.1
-                                + earlyReflectionsDelayLine[1].GetIndex(7) * 0.1
-                                + ( bandwidthLeft * 0.2 + bandwidthRight * 0.4 ) * 0.5);
+            T earlyReflectionsL = static_cast<T>(earlyReflectionsDelayLine[0](static_cast<T>(bandwidthLeft * T(0.5) + bandwidthRight * T(0.3)))
+                                + earlyReflectionsDelayLine[0].GetIndex(2) * T(0.6)
+                                + earlyReflectionsDelayLine[0].GetIndex(3) * T(0.4)
+                                + earlyReflectionsDelayLine[0].GetIndex(4) * T(0.3)
+                                + earlyReflectionsDelayLine[0].GetIndex(5) * T(0.3)
+                                + earlyReflectionsDelayLine[0].GetIndex(6) * T(0.1)
+                                + earlyReflectionsDelayLine[0].GetIndex(7) * T(0.1)
+                                + ( bandwidthLeft * T(0.4) + bandwidthRight * T(0.2) ) * T(0.5));
+            T earlyReflectionsR = static_cast<T>(earlyReflectionsDelayLine[1](static_cast<T>(bandwidthLeft * T(0.3) + bandwidthRight * T(0.5)))
+                                + earlyReflectionsDelayLine[1].GetIndex(2) * T(0.6)
+                                + earlyReflectionsDelayLine[1].GetIndex(3) * T(0.4)
+                                + earlyReflectionsDelayLine[1].GetIndex(4) * T(0.3)
+                                + earlyReflectionsDelayLine[1].GetIndex(5) * T(0.3)
+                                + earlyReflectionsDelayLine[1].GetIndex(6) * T(0.1)
+                                + earlyReflectionsDelayLine[1].GetIndex(7) * T(0.1)
+                                + ( bandwidthLeft * T(0.2) + bandwidthRight * T(0.4) ) * T(0.5));
             T predelayMonoInput = predelay(( bandwidthRight + bandwidthLeft ) * 0.5f);
             T smearedInput = predelayMonoInput;
             for(int j=0;j<4;j++)
@@ -186,20 +186,20 @@ public:
             rightTank = staticDelayLine[3](rightTank);
             PreviousLeftTank = leftTank * DecaySmooth;
             PreviousRightTank = rightTank * DecaySmooth;
-            T accumulatorL = static_cast<T>((0.6*staticDelayLine[2].GetIndex(1))
-                            +(0.6*staticDelayLine[2].GetIndex(2))
-                            -(0.6*allpassFourTap[3].GetIndex(1))
-                            +(0.6*staticDelayLine[3].GetIndex(1))
-                            -(0.6*staticDelayLine[0].GetIndex(1))
-                            -(0.6*allpassFourTap[1].GetIndex(1))
-                            -(0.6*staticDelayLine[1].GetIndex(1)));
-            T accumulatorR = static_cast<T>((0.6*staticDelayLine[0].GetIndex(2))
-                            +(0.6*staticDelayLine[0].GetIndex(3))
-                            -(0.6*allpassFourTap[1].GetIndex(2))
-                            +(0.6*staticDelayLine[1].GetIndex(2))
-                            -(0.6*staticDelayLine[2].GetIndex(3))
-                            -(0.6*allpassFourTap[3].GetIndex(2))
-                            -(0.6*staticDelayLine[3].GetIndex(2)));
+            T accumulatorL = static_cast<T>((T(0.6)*staticDelayLine[2].GetIndex(1))
+                            +(T(0.6)*staticDelayLine[2].GetIndex(2))
+                            -(T(0.6)*allpassFourTap[3].GetIndex(1))
+                            +(T(0.6)*staticDelayLine[3].GetIndex(1))
+                            -(T(0.6)*staticDelayLine[0].GetIndex(1))
+                            -(T(0.6)*allpassFourTap[1].GetIndex(1))
+                            -(T(0.6)*staticDelayLine[1].GetIndex(1)));
+            T accumulatorR = static_cast<T>((T(0.6)*staticDelayLine[0].GetIndex(2))
+                            +(T(0.6)*staticDelayLine[0].GetIndex(3))
+                            -(T(0.6)*allpassFourTap[1].GetIndex(2))
+                            +(T(0.6)*staticDelayLine[1].GetIndex(2))
+                            -(T(0.6)*staticDelayLine[2].GetIndex(3))
+                            -(T(0.6)*allpassFourTap[3].GetIndex(2))
+                            -(T(0.6)*staticDelayLine[3].GetIndex(2)));
             accumulatorL = ((accumulatorL * EarlyMix) + ((1 - EarlyMix) * earlyReflectionsL));
             accumulatorR = ((accumulatorR * EarlyMix) + ((1 - EarlyMix) * earlyReflectionsR));
             left = ( left + MixSmooth * ( accumulatorL - left ) ) * Gain;
@@ -829,7 +829,7 @@ template<typename T, int OverSampleCount>
         {
             for(unsigned int i = 0; i < OverSampleCount; i++)
             {
-                low += static_cast<T>(f * band + 1e-25);
+                low += f * band + T(1e-25);
                 high = input - low - q * band;
                 band += f * high;
                 notch = low + high;
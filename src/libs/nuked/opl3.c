@@ -51,6 +51,14 @@
 
 #define RSM_FRAC    10
 
+#ifndef OPL_ENABLE_SIMD
+#define OPL_ENABLE_SIMD 0
+#endif
+
+#if OPL_ENABLE_SIMD
+#include "simde/x86/sse2.h"
+#endif
+
 /* Channel types */
 
 enum {
@@ -541,6 +549,199 @@ static void OPL3_EnvelopeKeyOff(opl3_slot *slot, uint8_t type)
     slot->key &= ~type;
 }
 
+#if OPL_ENABLE_SIMD
+/*
+    Envelope generator, eight slots at a time
+
+    Bit-exact equivalent of running OPL3_EnvelopeCalc() on every slot. The
+    envelope of a slot doesn't depend on any other slot, and the chip state it
+    reads only changes after all slots have been processed, so the envelopes
+    of all 36 slots are calculated up-front in 16-bit lanes.
+
+    The register-derived inputs are kept in structure-of-arrays form in the
+    chip and only refreshed after register writes.
+*/
+
+#define OPL_SIMD_LANES 8
+
+static void OPL3_EnvelopeRefreshSimd(opl3_chip *chip)
+{
+    opl3_slot *slot;
+    uint8_t ii;
+
+    for (ii = 0; ii < 36; ii++)
+    {
+        slot = &chip->slot[ii];
+        chip->simd_eg_rout[ii] = (int16_t)slot->eg_rout;
+        chip->simd_eg_gen[ii] = slot->eg_gen;
+        chip->simd_key[ii] = slot->key ? -1 : 0;
+        chip->simd_level[ii] = (int16_t)((slot->reg_tl << 2) + (slot->eg_ksl >> kslshift[slot->reg_ksl]));
+        chip->simd_trem[ii] = (slot->trem == &chip->tremolo) ? -1 : 0;
+        chip->simd_reg_ar[ii] = slot->reg_ar;
+        chip->simd_reg_dr[ii] = slot->reg_dr;
+        chip->simd_reg_rr[ii] = slot->reg_rr;
+        chip->simd_reg_sl[ii] = slot->reg_sl;
+        chip->simd_sus_hold[ii] = slot->reg_type ? -1 : 0;
+        chip->simd_ks[ii] = slot->channel->ksv >> ((slot->reg_ksr ^ 1) << 1);
+    }
+    /* Padding lanes stay silent */
+    for (; ii < OPL_SIMD_SLOTS; ii++)
+    {
+        chip->simd_eg_rout[ii] = 0x1ff;
+        chip->simd_eg_gen[ii] = envelope_gen_num_release;
+        chip->simd_key[ii] = chip->simd_level[ii] = chip->simd_trem[ii] = 0;
+        chip->simd_reg_ar[ii] = chip->simd_reg_dr[ii] = chip->simd_reg_rr[ii] = 0;
+        chip->simd_reg_sl[ii] = chip->simd_sus_hold[ii] = chip->simd_ks[ii] = 0;
+    }
+    chip->simd_refresh = 0;
+}
+
+static simde__m128i OPL3_SimdSelect(simde__m128i mask, simde__m128i a, simde__m128i b)
+{
+    return simde_mm_or_si128(simde_mm_and_si128(mask, a), simde_mm_andnot_si128(mask, b));
+}
+
+static simde__m128i OPL3_SimdLoad(const int16_t *src)
+{
+    return simde_mm_loadu_si128((const simde__m128i *)src);
+}
+
+static void OPL3_SimdStore(int16_t *dest, simde__m128i val)
+{
+    simde_mm_storeu_si128((simde__m128i *)dest, val);
+}
+
+static void OPL3_EnvelopeCalcSimd(opl3_chip *chip)
+{
+    int16_t eg_out[OPL_SIMD_SLOTS];
+    int16_t pg_reset[OPL_SIMD_SLOTS];
+    opl3_slot *slot;
+    uint8_t ii;
+
+    simde__m128i zero, one, all, c15, eg_add, eg_state, tremolo, incstep[4];
+    simde__m128i rout, gen, key_on, att, dec, sus, reset, reg_rate, rate;
+    simde__m128i rate_hi, rate_lo, eg_shift, shift, shift_lo, shift_hi;
+    simde__m128i eg_off, new_rout, inc, att_inc, lin_inc, not_rout, lin_ok;
+    simde__m128i at_sl, is_s1, is_s2, is_s3;
+
+    if (chip->simd_refresh)
+    {
+        OPL3_EnvelopeRefreshSimd(chip);
+    }
+
+    zero = simde_mm_setzero_si128();
+    one = simde_mm_set1_epi16(1);
+    all = simde_mm_set1_epi16(-1);
+    c15 = simde_mm_set1_epi16(0x0f);
+    eg_add = simde_mm_set1_epi16(chip->eg_add);
+    eg_state = simde_mm_set1_epi16(chip->eg_state);
+    tremolo = simde_mm_set1_epi16(chip->tremolo);
+    for (ii = 0; ii < 4; ii++)
+    {
+        incstep[ii] = simde_mm_set1_epi16(eg_incstep[ii][chip->eg_timer_lo]);
+    }
+
+    for (ii = 0; ii < OPL_SIMD_SLOTS; ii += OPL_SIMD_LANES)
+    {
+        rout = OPL3_SimdLoad(&chip->simd_eg_rout[ii]);
+        gen = OPL3_SimdLoad(&chip->simd_eg_gen[ii]);
+        key_on = OPL3_SimdLoad(&chip->simd_key[ii]);
+
+        OPL3_SimdStore(&eg_out[ii], simde_mm_add_epi16(simde_mm_add_epi16(rout, OPL3_SimdLoad(&chip->simd_level[ii])),
+                                                       simde_mm_and_si128(OPL3_SimdLoad(&chip->simd_trem[ii]), tremolo)));
+
+        att = simde_mm_cmpeq_epi16(gen, simde_mm_set1_epi16(envelope_gen_num_attack));
+        dec = simde_mm_cmpeq_epi16(gen, simde_mm_set1_epi16(envelope_gen_num_decay));
+        sus = simde_mm_cmpeq_epi16(gen, simde_mm_set1_epi16(envelope_gen_num_sustain));
+        reset = simde_mm_andnot_si128(simde_mm_or_si128(simde_mm_or_si128(att, dec), sus), key_on);
+
+        /* Sustained (type 1) sounds hold their level in the sustain phase */
+        reg_rate = simde_mm_andnot_si128(simde_mm_and_si128(sus, OPL3_SimdLoad(&chip->simd_sus_hold[ii])),
+                                         OPL3_SimdLoad(&chip->simd_reg_rr[ii]));
+        reg_rate = OPL3_SimdSelect(dec, OPL3_SimdLoad(&chip->simd_reg_dr[ii]), reg_rate);
+        reg_rate = OPL3_SimdSelect(simde_mm_or_si128(att, reset), OPL3_SimdLoad(&chip->simd_reg_ar[ii]), reg_rate);
+
+        rate = simde_mm_add_epi16(OPL3_SimdLoad(&chip->simd_ks[ii]), simde_mm_slli_epi16(reg_rate, 2));
+        rate_hi = simde_mm_min_epi16(simde_mm_srli_epi16(rate, 2), c15);
+        rate_lo = simde_mm_and_si128(rate, simde_mm_set1_epi16(0x03));
+        eg_shift = simde_mm_add_epi16(rate_hi, eg_add);
+
+        /* Low rates step every 2^n samples, on the odd cycles only */
+        shift_lo = simde_mm_and_si128(simde_mm_cmpeq_epi16(eg_shift, simde_mm_set1_epi16(12)), one);
+        shift_lo = OPL3_SimdSelect(simde_mm_cmpeq_epi16(eg_shift, simde_mm_set1_epi16(13)),
+                                   simde_mm_and_si128(simde_mm_srli_epi16(rate_lo, 1), one), shift_lo);
+        shift_lo = OPL3_SimdSelect(simde_mm_cmpeq_epi16(eg_shift, simde_mm_set1_epi16(14)),
+                                   simde_mm_and_si128(rate_lo, one), shift_lo);
+        shift_lo = simde_mm_and_si128(shift_lo, simde_mm_cmpeq_epi16(eg_state, one));
+
+        /* High rates step on every sample */
+        shift_hi = OPL3_SimdSelect(simde_mm_cmpeq_epi16(rate_lo, one), incstep[1], incstep[0]);
+        shift_hi = OPL3_SimdSelect(simde_mm_cmpeq_epi16(rate_lo, simde_mm_set1_epi16(2)), incstep[2], shift_hi);
+        shift_hi = OPL3_SimdSelect(simde_mm_cmpeq_epi16(rate_lo, simde_mm_set1_epi16(3)), incstep[3], shift_hi);
+        shift_hi = simde_mm_add_epi16(shift_hi, simde_mm_and_si128(rate_hi, simde_mm_set1_epi16(0x03)));
+        shift_hi = simde_mm_min_epi16(shift_hi, simde_mm_set1_epi16(0x03));
+        shift_hi = OPL3_SimdSelect(simde_mm_cmpeq_epi16(shift_hi, zero), eg_state, shift_hi);
+
+        shift = OPL3_SimdSelect(simde_mm_cmplt_epi16(rate_hi, simde_mm_set1_epi16(12)), shift_lo, shift_hi);
+        shift = simde_mm_andnot_si128(simde_mm_cmpeq_epi16(reg_rate, zero), shift);
+
+        eg_off = simde_mm_cmpeq_epi16(simde_mm_and_si128(rout, simde_mm_set1_epi16(0x1f8)),
+                                      simde_mm_set1_epi16(0x1f8));
+
+        /* Instant attack, and envelope off */
+        new_rout = simde_mm_andnot_si128(simde_mm_and_si128(reset, simde_mm_cmpeq_epi16(rate_hi, c15)), rout);
+        new_rout = OPL3_SimdSelect(simde_mm_andnot_si128(simde_mm_or_si128(att, reset), eg_off),
+                                   simde_mm_set1_epi16(0x1ff), new_rout);
+
+        is_s1 = simde_mm_cmpeq_epi16(shift, one);
+        is_s2 = simde_mm_cmpeq_epi16(shift, simde_mm_set1_epi16(2));
+        is_s3 = simde_mm_cmpeq_epi16(shift, simde_mm_set1_epi16(3));
+
+        /* Attack approaches zero exponentially */
+        not_rout = simde_mm_xor_si128(rout, all);
+        att_inc = simde_mm_and_si128(is_s1, simde_mm_srai_epi16(not_rout, 3));
+        att_inc = OPL3_SimdSelect(is_s2, simde_mm_srai_epi16(not_rout, 2), att_inc);
+        att_inc = OPL3_SimdSelect(is_s3, simde_mm_srai_epi16(not_rout, 1), att_inc);
+        att_inc = simde_mm_and_si128(att_inc, key_on);
+        att_inc = simde_mm_andnot_si128(simde_mm_cmpeq_epi16(rate_hi, c15), att_inc);
+        att_inc = simde_mm_andnot_si128(simde_mm_cmpeq_epi16(rout, zero), att_inc);
+
+        /* Decay, sustain and release are linear */
+        lin_inc = simde_mm_and_si128(is_s1, one);
+        lin_inc = OPL3_SimdSelect(is_s2, simde_mm_set1_epi16(2), lin_inc);
+        lin_inc = OPL3_SimdSelect(is_s3, simde_mm_set1_epi16(4), lin_inc);
+        at_sl = simde_mm_and_si128(dec, simde_mm_cmpeq_epi16(simde_mm_srli_epi16(rout, 4),
+                                                             OPL3_SimdLoad(&chip->simd_reg_sl[ii])));
+        lin_ok = simde_mm_andnot_si128(simde_mm_or_si128(simde_mm_or_si128(eg_off, reset), at_sl), all);
+        lin_inc = simde_mm_and_si128(lin_inc, lin_ok);
+
+        inc = OPL3_SimdSelect(att, att_inc, lin_inc);
+        OPL3_SimdStore(&chip->simd_eg_rout[ii],
+                       simde_mm_and_si128(simde_mm_add_epi16(new_rout, inc), simde_mm_set1_epi16(0x1ff)));
+
+        /* State transitions */
+        gen = OPL3_SimdSelect(simde_mm_and_si128(att, simde_mm_cmpeq_epi16(rout, zero)),
+                              simde_mm_set1_epi16(envelope_gen_num_decay), gen);
+        gen = OPL3_SimdSelect(at_sl, simde_mm_set1_epi16(envelope_gen_num_sustain), gen);
+        gen = simde_mm_andnot_si128(reset, gen);
+        gen = OPL3_SimdSelect(key_on, gen, simde_mm_set1_epi16(envelope_gen_num_release));
+        OPL3_SimdStore(&chip->simd_eg_gen[ii], gen);
+
+        OPL3_SimdStore(&pg_reset[ii], simde_mm_and_si128(reset, one));
+    }
+
+    /* Keep the slots in sync for the rest of the pipeline */
+    for (ii = 0; ii < 36; ii++)
+    {
+        slot = &chip->slot[ii];
+        slot->eg_out = (uint16_t)eg_out[ii];
+        slot->eg_rout = (uint16_t)chip->simd_eg_rout[ii];
+        slot->eg_gen = (uint8_t)chip->simd_eg_gen[ii];
+        slot->pg_reset = (uint32_t)pg_reset[ii];
+    }
+}
+#endif
+
 /*
     Phase Generator
 */
@@ -1108,7 +1309,28 @@ static void OPL3_ProcessSlot(opl3_slot *slot)
     OPL3_SlotGenerate(slot);
 }
 
-void OPL3_Generate4Ch(opl3_chip *chip, int16_t *buf4)
+/*
+    Run the slots [first, last) through the operator pipeline. The SIMD
+    version has already calculated the envelopes and phases of all slots.
+*/
+static void OPL3_ProcessSlots(opl3_chip *chip, uint8_t first, uint8_t last, uint8_t simd)
+{
+    uint8_t ii;
+    for (ii = first; ii < last; ii++)
+    {
+        if (simd)
+        {
+            OPL3_SlotCalcFB(&chip->slot[ii]);
+            OPL3_SlotGenerate(&chip->slot[ii]);
+        }
+        else
+        {
+            OPL3_ProcessSlot(&chip->slot[ii]);
+        }
+    }
+}
+
+static void OPL3_Generate4ChImpl(opl3_chip *chip, int16_t *buf4, uint8_t simd)
 {
     opl3_channel *channel;
     opl3_writebuf *writebuf;
@@ -1121,14 +1343,22 @@ void OPL3_Generate4Ch(opl3_chip *chip, int16_t *buf4)
     buf4[1] = OPL3_ClipSample(chip->mixbuff[1]);
     buf4[3] = OPL3_ClipSample(chip->mixbuff[3]);
 
+#if OPL_ENABLE_SIMD
+    if (simd)
+    {
+        OPL3_EnvelopeCalcSimd(chip);
+        for (ii = 0; ii < 36; ii++)
+        {
+            OPL3_PhaseGenerate(&chip->slot[ii]);
+        }
+    }
+#endif
+
 #if OPL_QUIRK_CHANNELSAMPLEDELAY
-    for (ii = 0; ii < 15; ii++)
+    OPL3_ProcessSlots(chip, 0, 15, simd);
 #else
-    for (ii = 0; ii < 36; ii++)
+    OPL3_ProcessSlots(chip, 0, 36, simd);
 #endif
-    {
-        OPL3_ProcessSlot(&chip->slot[ii]);
-    }
 
     mix[0] = mix[1] = 0;
     for (ii = 0; ii < 18; ii++)
@@ -1147,20 +1377,14 @@ void OPL3_Generate4Ch(opl3_chip *chip, int16_t *buf4)
     chip->mixbuff[2] = mix[1];
 
 #if OPL_QUIRK_CHANNELSAMPLEDELAY
-    for (ii = 15; ii < 18; ii++)
-    {
-        OPL3_ProcessSlot(&chip->slot[ii]);
-    }
+    OPL3_ProcessSlots(chip, 15, 18, simd);
 #endif
 
     buf4[0] = OPL3_ClipSample(chip->mixbuff[0]);
     buf4[2] = OPL3_ClipSample(chip->mixbuff[2]);
 
 #if OPL_QUIRK_CHANNELSAMPLEDELAY
-    for (ii = 18; ii < 33; ii++)
-    {
-        OPL3_ProcessSlot(&chip->slot[ii]);
-    }
+    OPL3_ProcessSlots(chip, 18, 33, simd);
 #endif
 
     mix[0] = mix[1] = 0;
@@ -1180,10 +1404,7 @@ void OPL3_Generate4Ch(opl3_chip *chip, int16_t *buf4)
     chip->mixbuff[3] = mix[1];
 
 #if OPL_QUIRK_CHANNELSAMPLEDELAY
-    for (ii = 33; ii < 36; ii++)
-    {
-        OPL3_ProcessSlot(&chip->slot[ii]);
-    }
+    OPL3_ProcessSlots(chip, 33, 36, simd);
 #endif
 
     if ((chip->timer & 0x3f) == 0x3f)
@@ -1252,6 +1473,16 @@ void OPL3_Generate4Ch(opl3_chip *chip, int16_t *buf4)
     chip->writebuf_samplecnt++;
 }
 
+void OPL3_Generate4Ch(opl3_chip *chip, int16_t *buf4)
+{
+    OPL3_Generate4ChImpl(chip, buf4, OPL_ENABLE_SIMD);
+}
+
+void OPL3_Generate4ChReference(opl3_chip *chip, int16_t *buf4)
+{
+    OPL3_Generate4ChImpl(chip, buf4, 0);
+}
+
 void OPL3_Generate(opl3_chip *chip, int16_t *buf)
 {
     int16_t samples[4];
@@ -1342,6 +1573,7 @@ void OPL3_Reset(opl3_chip *chip, uint32_t samplerate)
         OPL3_ChannelSetupAlg(channel);
     }
     chip->noise = 1;
+    chip->simd_refresh = 1;
     chip->rateratio = (samplerate << RSM_FRAC) / 49716;
     chip->tremoloshift = 4;
     chip->vibshift = 1;
@@ -1363,6 +1595,7 @@ void OPL3_WriteReg(opl3_chip *chip, uint16_t reg, uint8_t v)
 {
     uint8_t high = (reg >> 8) & 0x01;
     uint8_t regm = reg & 0xff;
+    chip->simd_refresh = 1;
     switch (regm & 0xf0)
     {
     case 0x00:
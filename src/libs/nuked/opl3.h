@@ -46,6 +46,9 @@ extern "C" {
 #define OPL_WRITEBUF_SIZE   1024
 #define OPL_WRITEBUF_DELAY  2
 
+/* The 36 slots rounded up to a multiple of eight 16-bit SIMD lanes */
+#define OPL_SIMD_SLOTS      40
+
 typedef struct _opl3_slot opl3_slot;
 typedef struct _opl3_channel opl3_channel;
 typedef struct _opl3_chip opl3_chip;
@@ -153,6 +156,22 @@ struct _opl3_chip {
     uint32_t writebuf_last;
     uint64_t writebuf_lasttime;
     opl3_writebuf writebuf[OPL_WRITEBUF_SIZE];
+
+    /* Structure-of-arrays copy of the slot state used by the SIMD envelope
+       generator (see OPL_ENABLE_SIMD). The register-derived values are
+       refreshed from the slots after every register write. */
+    uint8_t simd_refresh;
+    int16_t simd_eg_rout[OPL_SIMD_SLOTS];
+    int16_t simd_eg_gen[OPL_SIMD_SLOTS];
+    int16_t simd_key[OPL_SIMD_SLOTS];
+    int16_t simd_level[OPL_SIMD_SLOTS];
+    int16_t simd_trem[OPL_SIMD_SLOTS];
+    int16_t simd_reg_ar[OPL_SIMD_SLOTS];
+    int16_t simd_reg_dr[OPL_SIMD_SLOTS];
+    int16_t simd_reg_rr[OPL_SIMD_SLOTS];
+    int16_t simd_reg_sl[OPL_SIMD_SLOTS];
+    int16_t simd_sus_hold[OPL_SIMD_SLOTS];
+    int16_t simd_ks[OPL_SIMD_SLOTS];
 };
 
 void OPL3_Generate(opl3_chip *chip, int16_t *buf);
@@ -163,6 +182,7 @@ void OPL3_WriteRegBuffered(opl3_chip *chip, uint16_t reg, uint8_t v);
 void OPL3_GenerateStream(opl3_chip *chip, int16_t *sndptr, uint32_t numsamples);
 
 void OPL3_Generate4Ch(opl3_chip *chip, int16_t *buf4);
+void OPL3_Generate4ChReference(opl3_chip *chip, int16_t *buf4);
 void OPL3_Generate4ChResampled(opl3_chip *chip, int16_t *buf4);
 void OPL3_Generate4ChStream(opl3_chip *chip, int16_t *sndptr1, int16_t *sndptr2, uint32_t numsamples);
 
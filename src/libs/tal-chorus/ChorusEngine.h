@@ -98,6 +98,15 @@ public:
         *sampleL= *sampleL+resultL*1.4f;
         *sampleR= *sampleR+resultR*1.4f;
     }
+
+    // Processes a block of interleaved stereo samples in-place
+    void process(float *samples, int numFrames)
+    {
+        for (int i = 0; i < numFrames; ++i, samples += 2)
+        {
+            process(samples, samples + 1);
+        }
+    }
 };
 
 #endif
@@ -1,13 +1,22 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
 // SPDX-FileCopyrightText:  2002-2021 The DOSBox Team
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "zmbv.h"
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <cmath>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "simde/x86/sse2.h"
 
 #include "utils/math_utils.h"
 #include "utils/mem_unaligned.h"
@@ -32,6 +41,150 @@ constexpr int ZLIB_MEM_LEVEL           = 9;          // 1 to 9 (default 8)
 constexpr auto ZLIB_STRATEGY           = Z_FILTERED; // Z_DEFAULT_STRATEGY, Z_FILTERED,
                                                      // Z_HUFFMAN_ONLY, Z_RLE, Z_FIXED
 
+// The encoder always uses 16x16 blocks; only the partial blocks at the right
+// edge of the frame take the scalar paths
+constexpr int SimdBlockWidth = 16;
+
+// Search the motion vectors in parallel only if every stripe gets at least
+// this many blocks (e.g., 640x480 is split into four stripes)
+constexpr size_t MinBlocksPerStripe = 256;
+constexpr unsigned MaxNumStripes    = 4;
+
+// Persistent worker threads that process the stripes of a frame alongside
+// the calling thread, which always takes the first stripe
+class ZmbvStripeWorkers {
+public:
+	explicit ZmbvStripeWorkers(const int num_workers)
+	{
+		for (auto i = 1; i <= num_workers; ++i) {
+			workers.emplace_back(&ZmbvStripeWorkers::WorkerLoop, this, i);
+			set_thread_name(workers.back(), "dosbox:zmbv");
+		}
+	}
+
+	~ZmbvStripeWorkers()
+	{
+		{
+			std::lock_guard lock(mutex);
+			should_quit = true;
+		}
+		work_available.notify_all();
+
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	int GetNumStripes() const
+	{
+		return static_cast<int>(workers.size()) + 1;
+	}
+
+	// Calls 'stripe_job' with every stripe index and returns once all of
+	// them are done
+	void Run(const std::function<void(int)>& stripe_job)
+	{
+		{
+			std::lock_guard lock(mutex);
+			job         = &stripe_job;
+			num_pending = static_cast<int>(workers.size());
+			++generation;
+		}
+		work_available.notify_all();
+
+		stripe_job(0);
+
+		std::unique_lock lock(mutex);
+		work_done.wait(lock, [&] { return num_pending == 0; });
+	}
+
+	ZmbvStripeWorkers(const ZmbvStripeWorkers&)            = delete;
+	ZmbvStripeWorkers& operator=(const ZmbvStripeWorkers&) = delete;
+
+private:
+	void WorkerLoop(const int stripe)
+	{
+		uint64_t last_generation = 0;
+
+		std::unique_lock lock(mutex);
+		while (true) {
+			work_available.wait(lock, [&] {
+				return should_quit || generation != last_generation;
+			});
+			if (should_quit) {
+				return;
+			}
+			last_generation = generation;
+
+			const auto current_job = job;
+			lock.unlock();
+			(*current_job)(stripe);
+			lock.lock();
+
+			if (--num_pending == 0) {
+				work_done.notify_one();
+			}
+		}
+	}
+
+	std::vector<std::thread> workers = {};
+
+	std::mutex mutex                       = {};
+	std::condition_variable work_available = {};
+	std::condition_variable work_done      = {};
+	const std::function<void(int)>* job    = nullptr;
+	uint64_t generation                    = 0;
+	int num_pending                        = 0;
+	bool should_quit                       = false;
+};
+
+// Returns a mask with bit 'n' set if the nth of the 16 pixels is the same in
+// both spans. Like the scalar code, 32-bit pixels ignore their top byte.
+template <class P>
+static uint32_t equal_pixels_mask(const P* a, const P* b);
+
+template <>
+uint32_t equal_pixels_mask(const uint8_t* a, const uint8_t* b)
+{
+	const auto eq = simde_mm_cmpeq_epi8(simde_mm_loadu_si128(a),
+	                                    simde_mm_loadu_si128(b));
+
+	return static_cast<uint32_t>(simde_mm_movemask_epi8(eq));
+}
+
+template <>
+uint32_t equal_pixels_mask(const uint16_t* a, const uint16_t* b)
+{
+	const auto eq0 = simde_mm_cmpeq_epi16(simde_mm_loadu_si128(a),
+	                                      simde_mm_loadu_si128(b));
+	const auto eq1 = simde_mm_cmpeq_epi16(simde_mm_loadu_si128(a + 8),
+	                                      simde_mm_loadu_si128(b + 8));
+
+	// Narrow the all-ones or all-zeros lanes to one byte per pixel
+	return static_cast<uint32_t>(
+	        simde_mm_movemask_epi8(simde_mm_packs_epi16(eq0, eq1)));
+}
+
+template <>
+uint32_t equal_pixels_mask(const uint32_t* a, const uint32_t* b)
+{
+	const auto rgb_mask = simde_mm_set1_epi32(0x00ffffff);
+
+	auto compare = [&](const int offset) {
+		const auto x = simde_mm_xor_si128(simde_mm_loadu_si128(a + offset),
+		                                  simde_mm_loadu_si128(b + offset));
+
+		return simde_mm_cmpeq_epi32(simde_mm_and_si128(x, rgb_mask),
+		                            simde_mm_setzero_si128());
+	};
+
+	const auto eq01 = simde_mm_packs_epi32(compare(0), compare(4));
+	const auto eq23 = simde_mm_packs_epi32(compare(8), compare(12));
+
+	return static_cast<uint32_t>(
+	        simde_mm_movemask_epi8(simde_mm_packs_epi16(eq01, eq23)));
+}
+
 ZMBV_FORMAT BPPFormat(const int bpp)
 {
 	switch (bpp) {
@@ -151,7 +304,21 @@ int VideoCodec::PossibleBlock(const int vx, const int vy, const FrameBlock & blo
 	int ret = 0;
 	P *pold = reinterpret_cast<P *>(oldframe) + block.start + (vy * pitch) + vx;
 	P *pnew = reinterpret_cast<P *>(newframe) + block.start;
-	;
+
+	if (block.dx == SimdBlockWidth) {
+		// Sample every fourth pixel of every fourth row
+		constexpr uint32_t SampledPixels = 0x1111;
+
+		for (auto y = 0; y < block.dy; y += 4) {
+			const auto equal = equal_pixels_mask(pold, pnew);
+			ret += std::popcount(~equal & SampledPixels);
+
+			pold += pitch * 4;
+			pnew += pitch * 4;
+		}
+		return ret;
+	}
+
 	for (auto y = 0; y < block.dy; y += 4) {
 		for (auto x = 0; x < block.dx; x += 4) {
 			const auto test = 0 - ((pold[x] - pnew[x]) & 0x00ffffff);
@@ -170,6 +337,17 @@ int VideoCodec::CompareBlock(const int vx, const int vy, const FrameBlock & bloc
 	P *pold = reinterpret_cast<P *>(oldframe) + block.start + (vy * pitch) + vx;
 	P *pnew = reinterpret_cast<P *>(newframe) + block.start;
 
+	if (block.dx == SimdBlockWidth) {
+		for (auto y = 0; y < block.dy; y++) {
+			const auto equal = equal_pixels_mask(pold, pnew);
+			diff_count += SimdBlockWidth - std::popcount(equal);
+
+			pold += pitch;
+			pnew += pitch;
+		}
+		return diff_count;
+	}
+
 	for (auto y = 0; y < block.dy; y++) {
 		for (auto x = 0; x < block.dx; x++) {
 			diff_count += ((pold[x] ^ pnew[x]) & 0x00ffffff) != 0;
@@ -180,19 +358,46 @@ int VideoCodec::CompareBlock(const int vx, const int vy, const FrameBlock & bloc
 	return diff_count;
 }
 
+// Writes the XOR delta of the block to 'out' and returns the number of bytes
+// written
 template <class P>
-void VideoCodec::AddXorBlock(const int vx, const int vy, const FrameBlock & block)
+size_t VideoCodec::AddXorBlock(const int vx, const int vy,
+                               const FrameBlock & block, uint8_t *out)
 {
 	P *pold = reinterpret_cast<P *>(oldframe) + block.start + (vy * pitch) + vx;
 	P *pnew = reinterpret_cast<P *>(newframe) + block.start;
+
+	const auto row_bytes = static_cast<size_t>(block.dx) * sizeof(P);
+
+	if (block.dx == SimdBlockWidth) {
+		for (auto y = 0; y < block.dy; ++y) {
+			const auto old_bytes = reinterpret_cast<const uint8_t *>(pold);
+			const auto new_bytes = reinterpret_cast<const uint8_t *>(pnew);
+
+			for (size_t i = 0; i < row_bytes; i += 16) {
+				const auto x = simde_mm_xor_si128(
+				        simde_mm_loadu_si128(new_bytes + i),
+				        simde_mm_loadu_si128(old_bytes + i));
+				simde_mm_storeu_si128(out + i, x);
+			}
+			out += row_bytes;
+
+			pold += pitch;
+			pnew += pitch;
+		}
+		return row_bytes * static_cast<size_t>(block.dy);
+	}
+
 	for (auto y = 0; y < block.dy; ++y) {
 		for (auto x = 0; x < block.dx; ++x) {
-			*reinterpret_cast<P *>(&work[workUsed]) = pnew[x] ^ pold[x];
-			workUsed += sizeof(P);
+			const P delta = pnew[x] ^ pold[x];
+			memcpy(out, &delta, sizeof(P));
+			out += sizeof(P);
 		}
 		pold += pitch;
 		pnew += pitch;
 	}
+	return row_bytes * static_cast<size_t>(block.dy);
 }
 
 // align offset to the next 4-byte boundary
@@ -200,15 +405,17 @@ void VideoCodec::AlignWork(size_t & offset) {
 	offset = (offset + blocks.size() * 2u + 3u) & ~3u;
 }
 
+// Searches the motion vectors of the given range of blocks, writes them to
+// 'vectors' (indexed by block number) and the XOR deltas of the changed
+// blocks to 'out'. Returns the number of delta bytes written.
 template <class P>
-void VideoCodec::AddXorFrame()
+size_t VideoCodec::AddXorBlocks(const size_t first, const size_t last,
+                                uint8_t *vectors, uint8_t *out)
 {
-	auto vectors = &work[workUsed];
+	size_t num_bytes = 0;
 
-	AlignWork(workUsed);
-
-	size_t b = 0;
-	for (const auto & block : blocks) {
+	for (auto b = first; b < last; ++b) {
+		const auto & block = blocks[b];
 
 		int8_t bestvx   = 0;
 		int8_t bestvy   = 0;
@@ -236,9 +443,62 @@ void VideoCodec::AddXorFrame()
 		vectors[b * 2 + 1] = static_cast<uint8_t>(left_shift_signed(bestvy, 1));
 		if (bestchange) {
 			vectors[b * 2 + 0] |= 1;
-			AddXorBlock<P>(bestvx, bestvy, block);
+			num_bytes += AddXorBlock<P>(bestvx, bestvy, block, out + num_bytes);
+		}
+	}
+	return num_bytes;
+}
+
+template <class P>
+void VideoCodec::AddXorFrame()
+{
+	auto vectors = &work[workUsed];
+
+	AlignWork(workUsed);
+
+	const auto num_blocks = blocks.size();
+
+	if (!stripe_workers) {
+		const auto num_threads = std::min(std::thread::hardware_concurrency(),
+		                                  MaxNumStripes);
+		const auto num_stripes = std::min(static_cast<size_t>(num_threads),
+		                                  num_blocks / MinBlocksPerStripe);
+		if (num_stripes > 1) {
+			stripe_workers = std::make_unique<ZmbvStripeWorkers>(
+			        static_cast<int>(num_stripes) - 1);
 		}
-		++b;
+	}
+
+	if (!stripe_workers) {
+		workUsed += AddXorBlocks<P>(0, num_blocks, vectors, &work[workUsed]);
+		return;
+	}
+
+	// The stripes are searched in parallel, then their deltas joined in
+	// block order, so the output is the same as the serial encoder's
+	const auto num_stripes = static_cast<size_t>(stripe_workers->GetNumStripes());
+
+	stripe_bufs.resize(num_stripes);
+	std::vector<size_t> stripe_sizes(num_stripes);
+
+	const auto max_block_bytes = static_cast<size_t>(SimdBlockWidth) *
+	                             SimdBlockWidth * sizeof(P);
+
+	stripe_workers->Run([&](const int stripe) {
+		const auto s     = static_cast<size_t>(stripe);
+		const auto first = num_blocks * s / num_stripes;
+		const auto last  = num_blocks * (s + 1) / num_stripes;
+
+		auto& buf = stripe_bufs[s];
+		if (buf.size() < (last - first) * max_block_bytes) {
+			buf.resize((last - first) * max_block_bytes);
+		}
+		stripe_sizes[s] = AddXorBlocks<P>(first, last, vectors, buf.data());
+	});
+
+	for (size_t s = 0; s < num_stripes; ++s) {
+		memcpy(&work[workUsed], stripe_bufs[s].data(), stripe_sizes[s]);
+		workUsed += stripe_sizes[s];
 	}
 }
 
@@ -482,10 +742,11 @@ bool VideoCodec::DecompressFrame(uint8_t *framedata, int size)
 	zstream.avail_out = bufsize;
 	zstream.total_out = 0;
 
-	// decompress all the pending data. Note that if Z_FINISH isn't used,
-	// then inflate can also return Z_OK, which indicates multiple inflation
-	// passes are needed.
-	if (inflate(&zstream, Z_FINISH) != Z_STREAM_END)
+	// Decompress all the pending data. The encoder ends every frame with a
+	// sync flush instead of finishing the stream, so the stream only ends
+	// if it was written by another encoder.
+	const auto result = inflate(&zstream, Z_SYNC_FLUSH);
+	if ((result != Z_OK && result != Z_STREAM_END) || zstream.avail_in != 0)
 		return false;
 
 	workUsed = check_cast<uint32_t>(zstream.total_out);
@@ -592,3 +853,6 @@ VideoCodec::VideoCodec()
 	CreateVectorTable();
 	memset(&zstream, 0, sizeof(zstream));
 }
+
+// Defined here, where the stripe workers are a complete type
+VideoCodec::~VideoCodec() = default;
@@ -1,10 +1,13 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
 // SPDX-FileCopyrightText:  2002-2021 The DOSBox Team
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #ifndef DOSBOX_ZMBV_H
 #define DOSBOX_ZMBV_H
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "dosbox_config.h"
@@ -39,6 +42,8 @@ enum class ZMBV_FORMAT : uint8_t {
 
 void Msg(const char fmt[], ...);
 
+class ZmbvStripeWorkers;
+
 class VideoCodec {
 private:
 	struct FrameBlock {
@@ -95,6 +100,12 @@ private:
 	Compress compress = {};
 	z_stream zstream = {};
 
+	// Delta frames of large videos are split into stripes of blocks that
+	// are motion-searched in parallel, each into its own buffer. (Left
+	// without an initialiser, as GCC would then need the complete type.)
+	std::unique_ptr<ZmbvStripeWorkers> stripe_workers;
+	std::vector<std::vector<uint8_t>> stripe_bufs = {};
+
 	// methods
 	void CreateVectorTable();
 	bool SetupBuffers(ZMBV_FORMAT format, int blockwidth, int blockheight);
@@ -108,7 +119,9 @@ private:
 	template <class P>
 	int CompareBlock(int vx, int vy, const FrameBlock & block);
 	template <class P>
-	void AddXorBlock(int vx, int vy, const FrameBlock & block);
+	size_t AddXorBlock(int vx, int vy, const FrameBlock & block, uint8_t *out);
+	template <class P>
+	size_t AddXorBlocks(size_t first, size_t last, uint8_t *vectors, uint8_t *out);
 	template <class P>
 	void UnXorBlock(int vx, int vy, const FrameBlock & block);
 	template <class P>
@@ -118,6 +131,7 @@ private:
 
 public:
 	VideoCodec();
+	~VideoCodec();
 
 	VideoCodec(const VideoCodec &) = delete;            // prevent copy
 	VideoCodec &operator=(const VideoCodec &) = delete; // prevent assignment
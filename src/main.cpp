@@ -5,6 +5,7 @@
 
 #include "gui/common.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
 #include <memory>
@@ -25,7 +26,10 @@
 #include "dos/dos_locale.h"
 #include "gui/mapper.h"
 #include "gui/render/render.h"
+#include "hardware/input/input_replay.h"
+#include "misc/async_log.h"
 #include "misc/cross.h"
+#include "misc/tracing.h"
 #include "shell/command_line.h"
 #include "shell/shell.h"
 #include "utils/checks.h"
@@ -169,6 +173,25 @@ static void register_command_line_help_message()
 	        "\n"
 	        "  --socket <num>           Run nullmodem on the specified socket number.\n"
 	        "\n"
+	        "  --benchmark              Run headless and unthrottled without audio output, then\n"
+	        "                           print the emulated MIPS, the number of frames rendered,\n"
+	        "                           the wall and emulated time, and exit. Use with '--conf'.\n"
+	        "\n"
+	        "  --frames <num>           Number of emulated frames to run in benchmark mode\n"
+	        "                           (1000 by default).\n"
+	        "\n"
+	        "  --trace <file>           Record a timeline of the emulator subsystems to <file>\n"
+	        "                           in the Chrome trace event format (Perfetto UI or\n"
+	        "                           chrome://tracing). Needs a build with tracing enabled.\n"
+	        "\n"
+	        "  --record-input <file>    Record the keyboard, mouse and joystick input with the\n"
+	        "                           emulated time it arrived at, and the host clock and\n"
+	        "                           random seeds the emulation reads, to <file>.\n"
+	        "\n"
+	        "  --replay-input <file>    Replay the input recorded to <file> at the same emulated\n"
+	        "                           times, ignoring the host input. Use the same config as\n"
+	        "                           when recording, e.g., to run interactive benchmarks.\n"
+	        "\n"
 	        "  -h, -?, --help           Print help message and exit.\n"
 	        "\n"
 	        "  -V, --version            Print version information and exit.\n");
@@ -326,9 +349,14 @@ static void init_logger(const CommandLineArguments& args, int argc, char* argv[]
 	    args.list_code_pages || args.list_shaders || args.erasemapper) {
 
 		loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+		loguru::init(argc, argv);
+		return;
 	}
 
 	loguru::init(argc, argv);
+
+	// Keep the console output off the emulation thread
+	LOG_StartAsyncSink();
 }
 
 static void maybe_write_primary_config(const CommandLineArguments& args)
@@ -532,6 +560,7 @@ static void maybe_create_resource_directories()
 static void quit_func()
 {
 	GFX_Quit();
+	LOG_StopAsyncSink();
 #ifdef WIN32
 	restore_console_encoding();
 #endif
@@ -570,6 +599,31 @@ static void wait_for_pid(const int wait_pid)
 #endif
 }
 
+// Benchmark runs must not open a window or an audio device, so they can be
+// run on headless build machines
+static void setup_benchmark_mode()
+{
+	constexpr int Overwrite = 1;
+	set_env_var("SDL_VIDEODRIVER", "dummy", Overwrite);
+
+	handle_cli_set_commands({"nosound=on",
+	                         "output=texture",
+	                         "texture_renderer=software",
+	                         "fullscreen=off"});
+}
+
+static void maybe_start_tracing(const CommandLineArguments& arguments)
+{
+	if (arguments.trace.empty()) {
+		return;
+	}
+#if C_TRACING
+	TRACING_Start(arguments.trace);
+#else
+	LOG_WARNING("TRACING: This build has no trace points, ignoring '--trace'");
+#endif
+}
+
 int main(int argc, char* argv[])
 {
 	// Ensure we perform SDL cleanup and restore console settings at exit
@@ -672,12 +726,33 @@ int main(int argc, char* argv[])
 		// from the CLI.
 		handle_cli_set_commands(arguments->set);
 
+		if (arguments->benchmark) {
+			setup_benchmark_mode();
+		}
+
 		maybe_create_resource_directories();
 
+		maybe_start_tracing(*arguments);
+
+		// Before the modules read the host clock
+		if (!arguments->replay_input.empty()) {
+			REPLAY_StartPlayback(arguments->replay_input);
+		} else if (!arguments->record_input.empty()) {
+			REPLAY_StartRecording(arguments->record_input);
+		}
+
 		GFX_InitSdl();
 		DOSBOX_InitModules();
 		GFX_InitAndStartGui();
 
+		if (arguments->benchmark) {
+			constexpr auto DefaultBenchmarkFrames = 1000;
+
+			DOSBOX_StartBenchmark(std::max(
+			        arguments->frames.value_or(DefaultBenchmarkFrames), 1));
+		}
+		DOSBOX_LogStartupTime("Modules initialised");
+
 		// All subsystems' hotkeys need to be registered at this point
 		// to ensure their hotkeys appear in the graphical mapper.
 		MAPPER_BindKeys(get_sdl_section());
@@ -689,6 +764,11 @@ int main(int argc, char* argv[])
 		// Start emulation
 		SHELL_InitAndRun();
 
+#if C_TRACING
+		TRACING_Stop();
+#endif
+		REPLAY_Stop();
+
 		DOSBOX_DestroyModules();
 		GFX_Destroy();
 
@@ -3,6 +3,7 @@
 
 #include "private/fluidsynth.h"
 
+#include <algorithm>
 #include <bitset>
 #include <cassert>
 #include <compare>
@@ -21,6 +22,7 @@
 #include "misc/cross.h"
 #include "misc/notifications.h"
 #include "misc/support.h"
+#include "misc/tracing.h"
 #include "utils/fs_utils.h"
 #include "utils/math_utils.h"
 #include "utils/string_utils.h"
@@ -94,6 +96,20 @@ static void init_fluidsynth_config_settings(SectionProp& secprop)
 	                   MinVolume,
 	                   MaxVolume));
 
+	constexpr auto DefaultCpuCores = 1;
+	constexpr auto MinCpuCores     = 1;
+	constexpr auto MaxCpuCores     = 16;
+
+	int_prop = secprop.AddInt("fsynth_cpu_cores", WhenIdle, DefaultCpuCores);
+	int_prop->SetMinMax(MinCpuCores, MaxCpuCores);
+	int_prop->SetHelp(
+	        format_str("Number of CPU cores FluidSynth renders the voices on (%d by default). Values\n"
+	                   "above 1 spread the voices of dense MIDI passages and large SoundFonts across\n"
+	                   "additional worker threads. The value can range from %d to %d.",
+	                   DefaultCpuCores,
+	                   MinCpuCores,
+	                   MaxCpuCores));
+
 	str_prop = secprop.AddString(ChorusSettingName, WhenIdle, DefaultChorusSetting);
 	str_prop->SetHelp(
 	        "Configure the FluidSynth chorus ('auto' by default). Possible values:\n"
@@ -630,6 +646,11 @@ MidiDeviceFluidSynth::MidiDeviceFluidSynth()
 						  "synth.sample-rate",
 						  sample_rate_hz);
 
+	// Extra cores are used by FluidSynth's worker threads, which render
+	// the voices in parallel for every block of 64 audio frames.
+	const auto num_cpu_cores = section->GetInt("fsynth_cpu_cores");
+	fluid_settings_setint(fluid_settings.get(), "synth.cpu-cores", num_cpu_cores);
+
 	FluidSynthPtr fluid_synth(new_fluid_synth(fluid_settings.get()),
 	                          delete_fluid_synth);
 	if (!fluid_synth) {
@@ -726,6 +747,10 @@ MidiDeviceFluidSynth::MidiDeviceFluidSynth()
 
 	soundfont_path = sf_path;
 
+	if (num_cpu_cores > 1) {
+		LOG_MSG("FSYNTH: Rendering on %d CPU cores", num_cpu_cores);
+	}
+
 	// Start rendering audio
 	const auto render = std::bind(&MidiDeviceFluidSynth::Render, this);
 	renderer          = std::thread(render);
@@ -815,7 +840,7 @@ int MidiDeviceFluidSynth::GetNumPendingAudioFrames()
 	return num_audio_frames;
 }
 
-// The request to play the channel message is placed in the MIDI work FIFO
+// The request to play the channel message is queued for the MIDI work FIFO
 void MidiDeviceFluidSynth::SendMidiMessage(const MidiMessage& msg)
 {
 	std::vector<uint8_t> message(msg.data.begin(), msg.data.end());
@@ -825,10 +850,10 @@ void MidiDeviceFluidSynth::SendMidiMessage(const MidiMessage& msg)
 	              MessageType::Channel,
 	              PIC_AtomicIndex()};
 
-	work_fifo.Enqueue(std::move(work));
+	pending_work.emplace_back(std::move(work));
 }
 
-// The request to play the sysex message is placed in the MIDI work FIFO
+// The request to play the sysex message is queued for the MIDI work FIFO
 void MidiDeviceFluidSynth::SendSysExMessage(uint8_t* sysex, size_t len)
 {
 	std::vector<uint8_t> message(sysex, sysex + len);
@@ -838,7 +863,15 @@ void MidiDeviceFluidSynth::SendSysExMessage(uint8_t* sysex, size_t len)
 	              MessageType::SysEx,
 	              PIC_AtomicIndex()};
 
-	work_fifo.Enqueue(std::move(work));
+	pending_work.emplace_back(std::move(work));
+}
+
+// The messages of the tick are handed to the render thread in one batch
+void MidiDeviceFluidSynth::FlushPendingWork()
+{
+	if (!pending_work.empty()) {
+		work_fifo.BulkEnqueue(pending_work);
+	}
 }
 
 void MidiDeviceFluidSynth::ApplyChannelMessage(const std::vector<uint8_t>& msg)
@@ -955,6 +988,8 @@ void MidiDeviceFluidSynth::MixerCallback(const int requested_audio_frames)
 
 void MidiDeviceFluidSynth::RenderAudioFramesToFifo(const int num_audio_frames)
 {
+	TRACE_SCOPE("FluidSynth render");
+
 	static std::vector<AudioFrame> audio_frames = {};
 
 	// Maybe expand the vector
@@ -962,14 +997,26 @@ void MidiDeviceFluidSynth::RenderAudioFramesToFifo(const int num_audio_frames)
 		audio_frames.resize(num_audio_frames);
 	}
 
-	fluid_synth_write_float(synth.get(),
-							num_audio_frames,
-							&audio_frames[0][0],
-							0,
-							2,
-							&audio_frames[0][0],
-							1,
-							2);
+	// Skip the synthesis while fast-forwarding with muted audio. The MIDI
+	// messages are still applied, so only the notes left sounding have to
+	// be silenced when resuming.
+	if (MIXER_IsFastForwardAudioMuted()) {
+		std::fill_n(audio_frames.begin(), num_audio_frames, AudioFrame{});
+		is_render_suspended = true;
+	} else {
+		if (is_render_suspended) {
+			fluid_synth_all_sounds_off(synth.get(), -1);
+			is_render_suspended = false;
+		}
+		fluid_synth_write_float(synth.get(),
+								num_audio_frames,
+								&audio_frames[0][0],
+								0,
+								2,
+								&audio_frames[0][0],
+								1,
+								2);
+	}
 
 	audio_frame_fifo.BulkEnqueue(audio_frames, num_audio_frames);
 }
@@ -1006,11 +1053,31 @@ void MidiDeviceFluidSynth::ProcessWorkFromFifo()
 	}
 }
 
+// Returns how many audio frames to render while there's no MIDI work
+// pending. We render up to a block at a time to amortise FluidSynth's
+// per-call overhead (and the worker thread hand-off when rendering on
+// multiple cores), but only as much as the FIFO has room for so pending MIDI
+// work isn't held up behind a blocked enqueue.
+int MidiDeviceFluidSynth::GetNumIdleAudioFrames()
+{
+	// FluidSynth renders internally in blocks of 64 audio frames
+	constexpr size_t RenderBlockFrames = 64;
+
+	const auto fill_limit  = audio_frame_fifo.GetFillLimit();
+	const auto num_queued  = audio_frame_fifo.Size();
+	const auto num_vacant  = fill_limit > num_queued ? fill_limit - num_queued : 0;
+	const auto num_to_fill = std::clamp(num_vacant, size_t{1}, RenderBlockFrames);
+
+	return check_cast<int>(num_to_fill);
+}
+
 // Keep the fifo populated with freshly rendered buffers
 void MidiDeviceFluidSynth::Render()
 {
+	TRACE_THREAD_NAME("FluidSynth");
+
 	while (work_fifo.IsRunning()) {
-		work_fifo.IsEmpty() ? RenderAudioFramesToFifo()
+		work_fifo.IsEmpty() ? RenderAudioFramesToFifo(GetNumIdleAudioFrames())
 		                    : ProcessWorkFromFifo();
 	}
 }
@@ -607,6 +607,13 @@ static std::string get_mididevice_setting()
 static auto MidiDevicePortPref    = "port";
 static auto DefaultMidiDevicePref = MidiDevicePortPref;
 
+static void flush_midi_device_work()
+{
+	if (midi.device) {
+		midi.device->FlushPendingWork();
+	}
+}
+
 // We'll adapt the RtMidi library, eventually, so hold off any substantial
 // rewrites of the MIDI stuff until then to avoid unnecessary work.
 class MIDI final {
@@ -659,8 +666,15 @@ public:
 		if (midi.device) {
 			LOG_MSG("MIDI: Opened device '%s'",
 			        midi.device->GetName().c_str());
+
+			TIMER_AddTickHandler(flush_midi_device_work);
 		}
 	}
+
+	~MIDI()
+	{
+		TIMER_DelTickHandler(flush_midi_device_work);
+	}
 };
 
 void MIDI_ListDevices(Program* caller)
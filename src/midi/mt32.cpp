@@ -5,6 +5,7 @@
 
 #if C_MT32EMU
 
+#include <algorithm>
 #include <cassert>
 #include <deque>
 #include <functional>
@@ -28,6 +29,7 @@
 #include "misc/ansi_code_markup.h"
 #include "misc/cross.h"
 #include "misc/support.h"
+#include "misc/tracing.h"
 #include "utils/fs_utils.h"
 #include "utils/math_utils.h"
 #include "utils/string_utils.h"
@@ -731,18 +733,24 @@ MidiDeviceMt32::MidiDeviceMt32()
 		set_section_property_value("mt32", "mt32_filter", "off");
 	}
 
-	// Double the baseline PCM prebuffer because MIDI is demanding and
-	// bursty. The mixer's default of ~20 ms becomes 40 ms here, which gives
-	// slower systems a better chance to keep up (and prevent their audio
-	// frame FIFO from running dry).
-	const auto render_ahead_ms = MIXER_GetPreBufferMs() * 2;
-
-	// Size the out-bound audio frame FIFO
+	// Start by rendering ahead twice the baseline PCM prebuffer because
+	// MIDI is demanding and bursty. The mixer's default of ~20 ms becomes
+	// 40 ms here, which gives slower systems a better chance to keep up
+	// (and prevent their audio frame FIFO from running dry). From there,
+	// the render-ahead adapts between one and eight times the prebuffer.
 	assertm(sample_rate_hz >= 8000, "Sample rate must be at least 8 kHz");
 
 	const auto audio_frames_per_ms = iround(sample_rate_hz / MillisInSecond);
-	audio_frame_fifo.Resize(
-	        check_cast<size_t>(render_ahead_ms * audio_frames_per_ms));
+	const auto prebuffer_frames = MIXER_GetPreBufferMs() * audio_frames_per_ms;
+
+	render_ahead.min_frames       = prebuffer_frames;
+	render_ahead.target_frames    = prebuffer_frames * 2;
+	render_ahead.max_frames       = prebuffer_frames * 8;
+	render_ahead.low_water_frames = render_ahead.target_frames;
+
+	// Size the out-bound audio frame FIFO
+	audio_frame_fifo.Resize(check_cast<size_t>(render_ahead.max_frames));
+	audio_frame_fifo.SetFillLimit(check_cast<size_t>(render_ahead.target_frames));
 
 	// Size the in-bound work FIFO
 	work_fifo.Resize(MaxMidiWorkFifoSize);
@@ -826,7 +834,7 @@ int MidiDeviceMt32::GetNumPendingAudioFrames()
 	return num_audio_frames;
 }
 
-// The request to play the channel message is placed in the MIDI work FIFO
+// The request to play the channel message is queued for the MIDI work FIFO
 void MidiDeviceMt32::SendMidiMessage(const MidiMessage& msg)
 {
 	std::vector<uint8_t> message(msg.data.begin(), msg.data.end());
@@ -836,20 +844,32 @@ void MidiDeviceMt32::SendMidiMessage(const MidiMessage& msg)
 	              MessageType::Channel,
 	              PIC_AtomicIndex()};
 
-	work_fifo.Enqueue(std::move(work));
+	pending_work.emplace_back(std::move(work));
 }
 
-// The request to play the sysex message is placed in the MIDI work FIFO
+// The request to play the sysex message is queued for the MIDI work FIFO
 void MidiDeviceMt32::SendSysExMessage(uint8_t* sysex, size_t len)
 {
 	std::vector<uint8_t> message(sysex, sysex + len);
 
+	render_ahead.sysex_bytes += check_cast<int>(len);
+
 	MidiWork work{std::move(message),
 	              GetNumPendingAudioFrames(),
 	              MessageType::SysEx,
 	              PIC_AtomicIndex()};
 
-	work_fifo.Enqueue(std::move(work));
+	pending_work.emplace_back(std::move(work));
+}
+
+// The messages of the tick are moved into the MIDI work FIFO in one go. They
+// carry the number of audio frames since the previous message, so the render
+// thread still applies them at their positions in the audio stream.
+void MidiDeviceMt32::FlushPendingWork()
+{
+	if (!pending_work.empty()) {
+		work_fifo.BulkEnqueue(pending_work);
+	}
 }
 
 // The callback operates at the audio frame-level, steadily adding samples to
@@ -858,17 +878,24 @@ void MidiDeviceMt32::MixerCallback(const int requested_audio_frames)
 {
 	assert(channel);
 
+	const auto queued_frames = check_cast<int>(audio_frame_fifo.Size());
+
 	// Report buffer underruns
 	constexpr auto warning_percent = 5.0f;
 
-	if (const auto percent_full = audio_frame_fifo.GetPercentFull();
-	    percent_full < warning_percent) {
+	const auto percent_full = 100.0f * static_cast<float>(queued_frames) /
+	                          static_cast<float>(render_ahead.target_frames);
+	if (percent_full < warning_percent) {
 		static auto iteration = 0;
 		if (iteration++ % 100 == 0) {
 			LOG_WARNING("MT32: Audio buffer underrun");
 		}
 		had_underruns = true;
 	}
+	channel->RecordQueueFill(percent_full);
+	channel->RecordLatency(static_cast<float>(queued_frames * ms_per_audio_frame));
+
+	UpdateRenderAhead(queued_frames, requested_audio_frames);
 
 	static std::vector<AudioFrame> audio_frames = {};
 
@@ -887,8 +914,67 @@ void MidiDeviceMt32::MixerCallback(const int requested_audio_frames)
 	}
 }
 
+// Adjusts how far ahead of the mixer the renderer may run, based on the FIFO
+// level the mixer found before taking the requested frames
+void MidiDeviceMt32::UpdateRenderAhead(const int queued_frames,
+                                       const int requested_frames)
+{
+	auto& ra = render_ahead;
+
+	const auto prev_target_frames = ra.target_frames;
+
+	auto restart_window = [&] {
+		ra.low_water_frames = ra.target_frames;
+		ra.window_frames    = 0;
+	};
+
+	// The mixer nearly starved, so grow quickly
+	if (queued_frames < requested_frames) {
+		ra.target_frames = std::min(ra.target_frames * 3 / 2, ra.max_frames);
+		restart_window();
+	}
+
+	// Sysex messages arriving faster than a real MIDI cable could carry
+	// them (31250 baud) usually mean the game is uploading timbres or
+	// patches, which stalls the renderer. Make room before they do.
+	constexpr auto MidiBytesPerMs = 3.125;
+
+	const auto sysex_bytes = ra.sysex_bytes.exchange(0);
+	const auto callback_ms = requested_frames * ms_per_audio_frame;
+
+	if (sysex_bytes > iround(2 * MidiBytesPerMs * callback_ms)) {
+		ra.target_frames = std::max(ra.target_frames,
+		                            std::min(ra.min_frames * 4, ra.max_frames));
+		restart_window();
+	}
+
+	// Shrink slowly after a second without the FIFO dipping below half
+	// the target
+	ra.low_water_frames = std::min(ra.low_water_frames, queued_frames);
+	ra.window_frames += requested_frames;
+
+	if (ra.window_frames >= iround(MillisInSecond / ms_per_audio_frame)) {
+		if (ra.low_water_frames > ra.target_frames / 2) {
+			ra.target_frames = std::max(ra.target_frames - ra.target_frames / 8,
+			                            ra.min_frames);
+		}
+		restart_window();
+	}
+
+	if (ra.target_frames != prev_target_frames) {
+		audio_frame_fifo.SetFillLimit(check_cast<size_t>(ra.target_frames));
+#ifdef DEBUG_MT32
+		LOG_TRACE("MT32: Rendering %d audio frames ahead (%.1f ms)",
+		          ra.target_frames,
+		          ra.target_frames * ms_per_audio_frame);
+#endif
+	}
+}
+
 void MidiDeviceMt32::RenderAudioFramesToFifo(const int num_frames)
 {
+	TRACE_SCOPE("MT-32 render");
+
 	static std::vector<AudioFrame> audio_frames = {};
 
 	// Maybe expand the vector
@@ -897,7 +983,26 @@ void MidiDeviceMt32::RenderAudioFramesToFifo(const int num_frames)
 	}
 
 	std::unique_lock<std::mutex> lock(service_mutex);
-	service->renderFloat(&audio_frames[0][0], num_frames);
+
+	// Skip the synthesis while fast-forwarding with muted audio. The MIDI
+	// messages are still applied, so only the notes left sounding have to
+	// be silenced when resuming.
+	if (MIXER_IsFastForwardAudioMuted()) {
+		std::fill_n(audio_frames.begin(), num_frames, AudioFrame{});
+		is_render_suspended = true;
+	} else {
+		if (is_render_suspended) {
+			constexpr uint32_t AllNotesOff = MidiChannelMode::AllNotesOff
+			                              << 8;
+
+			for (uint8_t ch = 0; ch < NumMidiChannels; ++ch) {
+				service->playMsg(MidiStatus::ControlChange | ch |
+				                 AllNotesOff);
+			}
+			is_render_suspended = false;
+		}
+		service->renderFloat(&audio_frames[0][0], num_frames);
+	}
 	lock.unlock();
 
 	audio_frame_fifo.BulkEnqueue(audio_frames, num_frames);
@@ -947,6 +1052,8 @@ void MidiDeviceMt32::ProcessWorkFromFifo()
 // Keep the FIFO populated with freshly rendered buffers
 void MidiDeviceMt32::Render()
 {
+	TRACE_THREAD_NAME("MT-32");
+
 	while (work_fifo.IsRunning()) {
 		work_fifo.IsEmpty() ? RenderAudioFramesToFifo()
 		                    : ProcessWorkFromFifo();
@@ -7,6 +7,7 @@
 
 #include <cassert>
 #include <map>
+#include <memory>
 #include <set>
 
 #include "utils/fs_utils.h"
@@ -110,6 +111,25 @@ bool LASynthModel::InDir(MT32Emu::Service& service, const std_fs::path& dir) con
 	return have_pcm && have_ctrl;
 }
 
+// Adds a full ROM through a memory mapping of its file so all the instances
+// using it share its pages. The mappings are kept for the lifetime of the
+// process, because the loaded ROM images point into them until the service's
+// context is freed.
+static mt32emu_return_code add_mapped_rom(MT32Emu::Service& service,
+                                          const std_fs::path& rom_path)
+{
+	static std::map<std_fs::path, std::unique_ptr<ReadOnlyFileMapping>> mappings = {};
+
+	auto& mapping = mappings[rom_path];
+	if (!mapping) {
+		mapping = std::make_unique<ReadOnlyFileMapping>(rom_path);
+	}
+	if (!mapping->IsValid()) {
+		return service.addROMFile(rom_path.string().c_str());
+	}
+	return service.addROMData(mapping->GetData(), mapping->GetSize());
+}
+
 // If present, loads either the full or partial ROMs from the provided directory
 bool LASynthModel::Load(MT32Emu::Service& service, const std_fs::path& dir) const
 {
@@ -119,7 +139,7 @@ bool LASynthModel::Load(MT32Emu::Service& service, const std_fs::path& dir) cons
 		if (!rom_path) {
 			return false;
 		}
-		const auto rcode = service.addROMFile(rom_path->string().c_str());
+		const auto rcode = add_mapped_rom(service, *rom_path);
 		return (rcode == expected_code);
 	};
 
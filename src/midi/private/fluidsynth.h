@@ -16,6 +16,7 @@
 #include "audio/mixer.h"
 #include "misc/std_filesystem.h"
 #include "utils/rwqueue.h"
+#include "utils/spsc_queue.h"
 
 struct ChorusParameters {
 	int voice_count = {};
@@ -54,6 +55,7 @@ public:
 
 	void SendMidiMessage(const MidiMessage& msg) override;
 	void SendSysExMessage(uint8_t* sysex, size_t len) override;
+	void FlushPendingWork() override;
 
 	std_fs::path GetSoundFontPath();
 
@@ -73,6 +75,7 @@ private:
 	void ProcessWorkFromFifo();
 
 	int GetNumPendingAudioFrames();
+	int GetNumIdleAudioFrames();
 	void RenderAudioFramesToFifo(const int num_audio_frames = 1);
 	void Render();
 
@@ -85,8 +88,12 @@ private:
 	FluidSynthPtr synth{nullptr, &delete_fluid_synth};
 
 	MixerChannelPtr mixer_channel = nullptr;
-	RWQueue<AudioFrame> audio_frame_fifo{1};
+	SpscQueue<AudioFrame> audio_frame_fifo{1};
 	RWQueue<MidiWork> work_fifo{1};
+
+	// The messages of the current emulation tick; only used on the main
+	// thread
+	std::vector<MidiWork> pending_work = {};
 	std::thread renderer = {};
 
 	std_fs::path soundfont_path = {};
@@ -97,6 +104,9 @@ private:
 	double ms_per_audio_frame = 0.0;
 
 	bool had_underruns = false;
+
+	// Only accessed by the render thread
+	bool is_render_suspended = false;
 };
 
 void FSYNTH_ListDevices(MidiDeviceFluidSynth* device, Program* caller);
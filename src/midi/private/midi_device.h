@@ -35,6 +35,11 @@ public:
 
 	virtual void SendSysExMessage([[maybe_unused]] uint8_t* sysex,
 	                              [[maybe_unused]] size_t len) = 0;
+
+	// Called at the end of every emulation tick. The internal synths
+	// collect the messages of a tick and hand them over to their render
+	// thread here in a single batch.
+	virtual void FlushPendingWork() {}
 };
 
 void MIDI_Reset(MidiDevice* device);
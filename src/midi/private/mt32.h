@@ -23,6 +23,7 @@
 #include "midi/midi.h"
 #include "misc/std_filesystem.h"
 #include "utils/rwqueue.h"
+#include "utils/spsc_queue.h"
 
 // forward declaration
 class LASynthModel;
@@ -53,6 +54,7 @@ public:
 
 	void SendMidiMessage(const MidiMessage& msg) override;
 	void SendSysExMessage(uint8_t* sysex, size_t len) override;
+	void FlushPendingWork() override;
 
 	void PrintStats();
 
@@ -66,12 +68,17 @@ private:
 	int GetNumPendingAudioFrames();
 	void RenderAudioFramesToFifo(const int num_frames = 1);
 	void Render();
+	void UpdateRenderAhead(const int queued_frames, const int requested_frames);
 
 	// Managed objects
 	MixerChannelPtr channel = nullptr;
-	RWQueue<AudioFrame> audio_frame_fifo{1};
+	SpscQueue<AudioFrame> audio_frame_fifo{1};
 	RWQueue<MidiWork> work_fifo{1};
 
+	// The messages of the current emulation tick; only used on the main
+	// thread
+	std::vector<MidiWork> pending_work = {};
+
 	std::mutex service_mutex                  = {};
 	std::unique_ptr<MT32Emu::Service> service = {};
 	std::thread renderer                      = {};
@@ -83,7 +90,29 @@ private:
 	double last_rendered_ms   = 0.0;
 	double ms_per_audio_frame = 0.0;
 
+	// Adaptive render-ahead. The renderer fills the audio frame FIFO up
+	// to the target, which grows when the mixer nearly drains the FIFO or
+	// a burst of sysex messages arrives, and slowly shrinks back towards
+	// the minimum while the mixer is comfortably fed. Apart from
+	// 'sysex_bytes', it's only used on the mixer thread.
+	struct {
+		int min_frames    = 0;
+		int target_frames = 0;
+		int max_frames    = 0;
+
+		// Lowest FIFO level and frames consumed in the current
+		// observation window
+		int low_water_frames = 0;
+		int window_frames    = 0;
+
+		// Sysex bytes received since the last mixer callback
+		std::atomic<int> sysex_bytes = 0;
+	} render_ahead = {};
+
 	bool had_underruns = false;
+
+	// Only accessed by the render thread
+	bool is_render_suspended = false;
 };
 
 void MT32_ListDevices(MidiDeviceMt32* device, Program* caller);
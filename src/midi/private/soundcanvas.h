@@ -13,6 +13,7 @@
 #include "audio/clap/plugin.h"
 #include "audio/mixer.h"
 #include "utils/rwqueue.h"
+#include "utils/spsc_queue.h"
 
 namespace SoundCanvas {
 
@@ -71,6 +72,7 @@ public:
 
 	void SendMidiMessage(const MidiMessage& msg) override;
 	void SendSysExMessage(uint8_t* sysex, size_t len) override;
+	void FlushPendingWork() override;
 
 private:
 	void MixerCallback(const int requested_audio_frames);
@@ -79,16 +81,22 @@ private:
 
 	int GetNumPendingAudioFrames();
 	void RenderAudioFramesToFifo(const int num_frames = 1);
+	void RenderBlockToFifo();
+	void AdvanceBlockPosition(const int num_frames);
 	void Render();
 	void RenderBacklogged();
 
-	void AddClapEvent(const MidiWork& work);
+	void AddClapEvent(const MidiWork& work, const int sample_offset = 0);
 
 	// Managed objects
 	MixerChannelPtr mixer_channel = nullptr;
-	RWQueue<AudioFrame> audio_frame_fifo{1};
+	SpscQueue<AudioFrame> audio_frame_fifo{1};
 	RWQueue<MidiWork> work_fifo{1};
 
+	// The messages of the current emulation tick; only used on the main
+	// thread
+	std::vector<MidiWork> pending_work = {};
+
 	struct {
 		std::unique_ptr<Clap::Plugin> plugin = nullptr;
 		Clap::EventList event_list           = {};
@@ -103,6 +111,11 @@ private:
 	double last_rendered_ms   = 0.0;
 	double ms_per_audio_frame = 0.0;
 
+	// Only used by the render thread. The plugin is processed in blocks of
+	// a fixed size, and the MIDI events are placed at their sample offsets
+	// into the block that's being filled.
+	int block_position = 0;
+
 	bool had_underruns           = false;
 	bool is_work_fifo_backlogged = false;
 };
@@ -16,12 +16,18 @@
 #include "hardware/pic.h"
 #include "misc/ansi_code_markup.h"
 #include "misc/std_filesystem.h"
+#include "misc/tracing.h"
 #include "utils/checks.h"
 #include "utils/string_utils.h"
 #include "utils/env_utils.h"
 
 CHECK_NARROWING();
 
+// The plugin renders this many audio frames per process call, which keeps the
+// per-call overhead of CLAP synths low while staying well within the
+// render-ahead of the audio frame FIFO
+constexpr int RenderBlockFrames = 128;
+
 namespace SoundCanvas {
 
 // Symbolic model aliases
@@ -474,7 +480,7 @@ MidiDeviceSoundCanvas::MidiDeviceSoundCanvas()
 	// Size the in-bound work FIFO
 	work_fifo.Resize(MaxMidiWorkFifoSize);
 
-	clap.plugin->Activate(iroundf(sample_rate_hz));
+	clap.plugin->Activate(iroundf(sample_rate_hz), RenderBlockFrames);
 
 	// Start rendering audio
 	const auto render = std::bind(&MidiDeviceSoundCanvas::Render, this);
@@ -544,7 +550,7 @@ int MidiDeviceSoundCanvas::GetNumPendingAudioFrames()
 	return num_audio_frames;
 }
 
-// The request to play the channel message is placed in the MIDI work FIFO
+// The request to play the channel message is queued for the MIDI work FIFO
 void MidiDeviceSoundCanvas::SendMidiMessage(const MidiMessage& msg)
 {
 	std::vector<uint8_t> message(msg.data.begin(), msg.data.end());
@@ -554,10 +560,10 @@ void MidiDeviceSoundCanvas::SendMidiMessage(const MidiMessage& msg)
 	              MessageType::Channel,
 	              PIC_AtomicIndex()};
 
-	work_fifo.Enqueue(std::move(work));
+	pending_work.emplace_back(std::move(work));
 }
 
-// The request to play the sysex message is placed in the MIDI work FIFO
+// The request to play the sysex message is queued for the MIDI work FIFO
 void MidiDeviceSoundCanvas::SendSysExMessage(uint8_t* sysex, size_t len)
 {
 	std::vector<uint8_t> message(sysex, sysex + len);
@@ -567,7 +573,16 @@ void MidiDeviceSoundCanvas::SendSysExMessage(uint8_t* sysex, size_t len)
 	              MessageType::SysEx,
 	              PIC_AtomicIndex()};
 
-	work_fifo.Enqueue(std::move(work));
+	pending_work.emplace_back(std::move(work));
+}
+
+// The messages of the tick are handed to the render thread in one batch; the
+// render thread places them at their sample offsets into the block
+void MidiDeviceSoundCanvas::FlushPendingWork()
+{
+	if (!pending_work.empty()) {
+		work_fifo.BulkEnqueue(pending_work);
+	}
 }
 
 // The callback operates at the audio frame-level, steadily adding samples to
@@ -606,11 +621,15 @@ void MidiDeviceSoundCanvas::MixerCallback(const int requested_audio_frames)
 
 void MidiDeviceSoundCanvas::RenderAudioFramesToFifo(const int num_audio_frames)
 {
+	TRACE_SCOPE("Sound Canvas render");
+
 	assert(num_audio_frames > 0);
 
 	static std::vector<float> left  = {};
 	static std::vector<float> right = {};
 
+	static std::vector<AudioFrame> audio_frames = {};
+
 	// Maybe expand the vectors
 	if (check_cast<int>(left.size()) < num_audio_frames) {
 		left.resize(num_audio_frames);
@@ -622,13 +641,38 @@ void MidiDeviceSoundCanvas::RenderAudioFramesToFifo(const int num_audio_frames)
 	clap.plugin->Process(audio_out, num_audio_frames, clap.event_list);
 	clap.event_list.Clear();
 
+	audio_frames.resize(check_cast<size_t>(num_audio_frames));
 	for (auto i = 0; i < num_audio_frames; ++i) {
-		audio_frame_fifo.Enqueue({left[i], right[i]});
+		audio_frames[i] = {left[i], right[i]};
 	}
+	audio_frame_fifo.BulkEnqueue(audio_frames, audio_frames.size());
+}
+
+// Renders the block that's being filled along with its queued MIDI events
+void MidiDeviceSoundCanvas::RenderBlockToFifo()
+{
+	RenderAudioFramesToFifo(RenderBlockFrames);
+	block_position = 0;
 }
 
-// The next MIDI work task is processed, which includes rendering audio frames
-// prior to sending channel and sysex messages to the plugin
+// Moves the position of the next MIDI event forward by the audio frames that
+// precede it, rendering the blocks that become full along the way
+void MidiDeviceSoundCanvas::AdvanceBlockPosition(const int num_audio_frames)
+{
+	assert(num_audio_frames >= 0);
+
+	auto num_remaining = num_audio_frames;
+
+	while (block_position + num_remaining >= RenderBlockFrames) {
+		num_remaining -= (RenderBlockFrames - block_position);
+		RenderBlockToFifo();
+	}
+	block_position += num_remaining;
+}
+
+// The next MIDI work task is processed, which places the channel or sysex
+// message at its sample offset into the block, rendering the blocks that
+// precede it
 void MidiDeviceSoundCanvas::ProcessWorkFromFifo()
 {
 	const auto work = work_fifo.Dequeue();
@@ -642,9 +686,7 @@ void MidiDeviceSoundCanvas::ProcessWorkFromFifo()
 	const auto delta_from_now    = PIC_AtomicIndex() - work->timestamp;
 	constexpr auto OneSecondInMs = 1000.0;
 
-	if (delta_from_now > OneSecondInMs) {
-		is_work_fifo_backlogged = true;
-	}
+	const auto is_backlogged = (delta_from_now > OneSecondInMs);
 
 #if 0
 	// To log inter-cycle rendering
@@ -658,22 +700,36 @@ void MidiDeviceSoundCanvas::ProcessWorkFromFifo()
 	}
 #endif
 
-	if (work->num_pending_audio_frames > 0) {
-		RenderAudioFramesToFifo(work->num_pending_audio_frames);
+	AdvanceBlockPosition(work->num_pending_audio_frames);
+
+	// A burst of SysEx messages can fill up the event list before the end
+	// of the block, so render what we have and continue in the next block
+	if (work->message_type == MessageType::SysEx &&
+	    !clap.event_list.HasRoomForMidiSysExEvent(work->message.size())) {
+		RenderBlockToFifo();
 	}
 
-	AddClapEvent(*work);
+	AddClapEvent(*work, block_position);
+
+	// The backlogged mode renders single audio frames with the events at
+	// the start, so flush the events placed further into the block first
+	if (is_backlogged) {
+		RenderBlockToFifo();
+		is_work_fifo_backlogged = true;
+	}
 }
 
-void MidiDeviceSoundCanvas::AddClapEvent(const MidiWork& work)
+void MidiDeviceSoundCanvas::AddClapEvent(const MidiWork& work, const int sample_offset)
 {
+	const auto offset = check_cast<uint32_t>(sample_offset);
+
 	if (work.message_type == MessageType::Channel) {
 		assert(work.message.size() >= MaxMidiMessageLen);
-		clap.event_list.AddMidiEvent(work.message, 0);
+		clap.event_list.AddMidiEvent(work.message, offset);
 
 	} else {
 		assert(work.message_type == MessageType::SysEx);
-		clap.event_list.AddMidiSysExEvent(work.message, 0);
+		clap.event_list.AddMidiSysExEvent(work.message, offset);
 	}
 }
 
@@ -749,11 +805,13 @@ void MidiDeviceSoundCanvas::ProcessWorkFromFifoBacklogged()
 // Keep the FIFO populated with freshly rendered buffers
 void MidiDeviceSoundCanvas::Render()
 {
+	TRACE_THREAD_NAME("Sound Canvas");
+
 	while (work_fifo.IsRunning()) {
 		if (is_work_fifo_backlogged) {
 			RenderBacklogged();
 		} else {
-			work_fifo.IsEmpty() ? RenderAudioFramesToFifo()
+			work_fifo.IsEmpty() ? RenderBlockToFifo()
 			                    : ProcessWorkFromFifo();
 		}
 	}
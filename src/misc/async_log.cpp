@@ -0,0 +1,247 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "misc/async_log.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+#include "misc/logging.h"
+#include "utils/checks.h"
+#include "utils/spsc_queue.h"
+#include "utils/string_utils.h"
+
+CHECK_NARROWING();
+
+LogRepeatFilter::Result LogRepeatFilter::Check(const std::string_view message,
+                                               const int64_t now_ms)
+{
+	if (message != last_message) {
+		const auto num_repeats_to_report = TakeNumRepeats();
+		last_message = message;
+		return {false, num_repeats_to_report};
+	}
+
+	if (++num_repeats == 1) {
+		first_repeat_ms = now_ms;
+	}
+
+	// Report long runs periodically, so they don't look like a hang
+	if (now_ms - first_repeat_ms >= report_interval_ms) {
+		return {true, TakeNumRepeats()};
+	}
+	return {true, 0};
+}
+
+int LogRepeatFilter::TakeNumRepeats()
+{
+	const auto n = num_repeats;
+	num_repeats  = 0;
+	return n;
+}
+
+// Lines waiting to be written; the producers are serialised by loguru's own
+// lock, so a single-producer queue suffices
+constexpr size_t QueueCapacity = 4096;
+
+constexpr int64_t RepeatReportIntervalMs = 1000;
+
+// How long errors and flushes wait for the writer thread at most
+constexpr auto MaxWriteWait = std::chrono::seconds(1);
+
+constexpr auto CallbackId = "async_stderr";
+
+static struct {
+	bool is_running = false;
+
+	loguru::Verbosity stderr_verbosity = loguru::Verbosity_OFF;
+
+	std::unique_ptr<SpscQueue<std::string>> queue = {};
+	std::thread writer                            = {};
+
+	// Only accessed by the producers
+	LogRepeatFilter repeat_filter    = LogRepeatFilter(RepeatReportIntervalMs);
+	loguru::Verbosity last_verbosity = loguru::Verbosity_INFO;
+	std::string last_preamble        = {};
+	uint64_t num_queued              = 0;
+	int num_dropped                  = 0;
+
+	std::atomic<uint64_t> num_written = 0;
+} sink = {};
+
+static int64_t now_ms()
+{
+	using namespace std::chrono;
+	return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Decorates the line the same way loguru does when writing to the console
+// ('terminal_dim()' is not part of loguru's public interface)
+constexpr auto TerminalDim = "\x1b[2m";
+
+static std::string make_line(const loguru::Verbosity verbosity,
+                             const char* preamble, const char* indentation,
+                             const std::string& text)
+{
+	if (!loguru::g_colorlogtostderr || !loguru::terminal_has_color()) {
+		return format_str("%s%s%s\n", preamble, indentation, text.c_str());
+	}
+	if (verbosity > loguru::Verbosity_WARNING) {
+		return format_str("%s%s%s%s%s%s%s\n",
+		                  loguru::terminal_reset(),
+		                  TerminalDim,
+		                  preamble,
+		                  indentation,
+		                  // un-dim for info
+		                  verbosity == loguru::Verbosity_INFO
+		                          ? loguru::terminal_reset()
+		                          : "",
+		                  text.c_str(),
+		                  loguru::terminal_reset());
+	}
+	return format_str("%s%s%s%s%s%s\n",
+	                  loguru::terminal_reset(),
+	                  verbosity == loguru::Verbosity_WARNING
+	                          ? loguru::terminal_yellow()
+	                          : loguru::terminal_red(),
+	                  preamble,
+	                  indentation,
+	                  text.c_str(),
+	                  loguru::terminal_reset());
+}
+
+static void enqueue(std::string&& line)
+{
+	if (sink.num_dropped > 0) {
+		auto notice = make_line(loguru::Verbosity_WARNING,
+		                        sink.last_preamble.c_str(),
+		                        "",
+		                        format_str("LOG: Dropped %d messages, the "
+		                                   "console can't keep up",
+		                                   sink.num_dropped));
+
+		if (!sink.queue->NonblockingEnqueue(std::move(notice))) {
+			++sink.num_dropped;
+			return;
+		}
+		++sink.num_queued;
+		sink.num_dropped = 0;
+	}
+
+	// Rather drop the line than stall the logging thread
+	if (sink.queue->NonblockingEnqueue(std::move(line))) {
+		++sink.num_queued;
+	} else {
+		++sink.num_dropped;
+	}
+}
+
+// The summary is stamped like the last repeat
+static void enqueue_repeats(const int num_repeats)
+{
+	if (num_repeats == 0) {
+		return;
+	}
+	enqueue(make_line(sink.last_verbosity,
+	                  sink.last_preamble.c_str(),
+	                  "",
+	                  format_str("Last message repeated %d time%s",
+	                             num_repeats,
+	                             num_repeats == 1 ? "" : "s")));
+}
+
+static void wait_until_written()
+{
+	const auto deadline = std::chrono::steady_clock::now() + MaxWriteWait;
+
+	while (sink.num_written.load(std::memory_order_acquire) < sink.num_queued &&
+	       std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+// Called by loguru with its lock held
+static void log_callback(void*, const loguru::Message& message)
+{
+	const auto text = std::string(message.prefix) + message.message;
+
+	const auto [is_repeat, num_repeats] = sink.repeat_filter.Check(text, now_ms());
+
+	enqueue_repeats(num_repeats);
+
+	if (!is_repeat) {
+		enqueue(make_line(message.verbosity, message.preamble, message.indentation, text));
+		sink.last_verbosity = message.verbosity;
+	}
+	sink.last_preamble = message.preamble;
+
+	// Loguru aborts right after logging a fatal error
+	if (message.verbosity <= loguru::Verbosity_ERROR) {
+		wait_until_written();
+	}
+}
+
+static void flush_callback(void*)
+{
+	wait_until_written();
+}
+
+static void write_lines()
+{
+	while (auto line = sink.queue->Dequeue()) {
+		fputs(line->c_str(), stderr);
+
+		if (sink.queue->IsEmpty()) {
+			fflush(stderr);
+		}
+		sink.num_written.fetch_add(1, std::memory_order_release);
+	}
+	fflush(stderr);
+}
+
+void LOG_StartAsyncSink()
+{
+	if (sink.is_running || loguru::g_stderr_verbosity == loguru::Verbosity_OFF) {
+		return;
+	}
+
+	sink.queue = std::make_unique<SpscQueue<std::string>>(QueueCapacity);
+	sink.queue->Start();
+
+	sink.writer = std::thread(write_lines);
+
+	// Take over the console output from loguru
+	sink.stderr_verbosity = loguru::g_stderr_verbosity;
+
+	loguru::add_callback(CallbackId,
+	                     log_callback,
+	                     nullptr,
+	                     sink.stderr_verbosity,
+	                     nullptr,
+	                     flush_callback);
+
+	loguru::g_stderr_verbosity = loguru::Verbosity_OFF;
+
+	sink.is_running = true;
+}
+
+void LOG_StopAsyncSink()
+{
+	if (!sink.is_running) {
+		return;
+	}
+	sink.is_running = false;
+
+	// No more callbacks after this
+	loguru::remove_callback(CallbackId);
+
+	enqueue_repeats(sink.repeat_filter.TakeNumRepeats());
+
+	sink.queue->Stop();
+	sink.writer.join();
+
+	loguru::g_stderr_verbosity = sink.stderr_verbosity;
+}
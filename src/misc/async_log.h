@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_ASYNC_LOG_H
+#define DOSBOX_ASYNC_LOG_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Asynchronous sink for the console log.
+//
+// Loguru writes every message to the console synchronously on the thread
+// that logs it, so bursts of warnings from the emulated hardware (unhandled
+// ports, full event queues, etc.) can stall the emulation on console I/O.
+// While the sink runs, the formatted lines are queued in a lock-free ring
+// and written by a background thread instead.
+//
+// Runs of identical messages are collapsed into a single line followed by a
+// "repeated N times" summary. Errors wait until they have been written, so
+// they're not lost if the program aborts right after.
+//
+// The internal debugger's log window (C_DEBUGGER builds) is not affected.
+
+void LOG_StartAsyncSink();
+
+// Writes the queued lines and reverts to synchronous logging
+void LOG_StopAsyncSink();
+
+// Collapses runs of identical messages; the repeats are counted and reported
+// once the run ends, or periodically while it lasts.
+class LogRepeatFilter {
+public:
+	explicit LogRepeatFilter(const int64_t _report_interval_ms)
+	        : report_interval_ms(_report_interval_ms)
+	{}
+
+	struct Result {
+		// The message repeats the previous one and should be dropped
+		bool is_repeat = false;
+
+		// Number of dropped repeats to report before this message
+		// (if any)
+		int num_repeats_to_report = 0;
+	};
+
+	Result Check(const std::string_view message, const int64_t now_ms);
+
+	// Ends the current run and returns its unreported repeats
+	int TakeNumRepeats();
+
+private:
+	std::string last_message = {};
+
+	int num_repeats         = 0;
+	int64_t first_repeat_ms = 0;
+
+	const int64_t report_interval_ms = 0;
+};
+
+#endif // DOSBOX_ASYNC_LOG_H
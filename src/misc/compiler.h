@@ -40,6 +40,16 @@
 #define GCC_ATTRIBUTE(x) /* attribute not supported */
 #endif
 
+// GCC and Clang support taking the address of a label ('&&label') and
+// jumping to it ('goto *ptr'), which interpreter loops can use to dispatch
+// through a table of labels instead of a switch.
+
+#if defined(__GNUC__) || defined(__clang__)
+#define C_HAS_COMPUTED_GOTO 1
+#else
+#define C_HAS_COMPUTED_GOTO 0
+#endif
+
 // XSTR and STR macros can be used for turning defines into string literals:
 //
 // #define FOO 4
@@ -9,6 +9,7 @@
 #include <chrono>
 #include <cstring>
 #include <fstream>
+#include <vector>
 
 #include "dos/dos.h"
 #include "dos/dos_system.h"
@@ -165,6 +166,31 @@ uint16_t local_drive_create_dir(const std_fs::path& path)
 	return (result == 0) ? DOSERR_NONE : DOSERR_ACCESS_DENIED;
 }
 
+NativeIoResult copy_native_file_buffered(const NativeFileHandle source,
+                                         const NativeFileHandle dest)
+{
+	NativeIoResult ret = {};
+
+	std::vector<uint8_t> buffer(1024 * 1024);
+	while (true) {
+		const auto read_ret = read_native_file(source,
+		                                       buffer.data(),
+		                                       check_cast<int64_t>(buffer.size()));
+		if (read_ret.error || read_ret.num_bytes == 0) {
+			ret.error = read_ret.error;
+			return ret;
+		}
+		const auto write_ret = write_native_file(dest,
+		                                         buffer.data(),
+		                                         read_ret.num_bytes);
+		ret.num_bytes += write_ret.num_bytes;
+		if (write_ret.error || write_ret.num_bytes != read_ret.num_bytes) {
+			ret.error = true;
+			return ret;
+		}
+	}
+}
+
 int64_t get_native_file_position(const NativeFileHandle handle)
 {
 	return seek_native_file(handle, 0, NativeSeek::Current);
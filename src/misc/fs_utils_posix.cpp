@@ -14,6 +14,10 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#if defined(HAVE_MMAP)
+#include <sys/mman.h>
+#endif
+
 #if defined(HAVE_SYS_XATTR_H)
 #include <sys/xattr.h>
 #endif
@@ -405,6 +409,42 @@ NativeIoResult write_native_file(const NativeFileHandle handle, const uint8_t* b
 	return ret;
 }
 
+NativeIoResult copy_native_file(const NativeFileHandle source,
+                                const NativeFileHandle dest)
+{
+	NativeIoResult ret = {};
+
+#if defined(__linux__)
+	// Lets the kernel copy without a round trip through user space, or
+	// even share the extents on filesystems that support it
+	constexpr size_t MaxChunk = 1024 * 1024 * 1024;
+	while (true) {
+		const auto num_bytes_copied =
+		        copy_file_range(source, nullptr, dest, nullptr, MaxChunk, 0);
+		if (num_bytes_copied == 0) {
+			return ret;
+		}
+		if (num_bytes_copied < 0) {
+			// Not supported between these files (e.g. across
+			// filesystems on older kernels); copy the rest below
+			if (errno == EXDEV || errno == ENOSYS || errno == EINVAL ||
+			    errno == EOPNOTSUPP) {
+				break;
+			}
+			ret.error = true;
+			return ret;
+		}
+		ret.num_bytes += num_bytes_copied;
+	}
+#endif
+
+	const auto rest = copy_native_file_buffered(source, dest);
+
+	ret.num_bytes += rest.num_bytes;
+	ret.error = rest.error;
+	return ret;
+}
+
 int64_t seek_native_file(const NativeFileHandle handle, const int64_t offset,
                          const NativeSeek type)
 {
@@ -507,4 +547,35 @@ bool remove_dir(const std_fs::path& path)
 	return local_drive_remove_dir(path);
 }
 
+ReadOnlyFileMapping::ReadOnlyFileMapping([[maybe_unused]] const std_fs::path& path)
+{
+#if defined(HAVE_MMAP)
+	const auto fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+	struct stat file_stat = {};
+	if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+		const auto num_bytes = static_cast<size_t>(file_stat.st_size);
+
+		const auto ptr = mmap(nullptr, num_bytes, PROT_READ, MAP_SHARED, fd, 0);
+		if (ptr != MAP_FAILED) {
+			data = static_cast<const uint8_t*>(ptr);
+			size = num_bytes;
+		}
+	}
+	// The mapping stays valid after the file is closed
+	close(fd);
+#endif
+}
+
+ReadOnlyFileMapping::~ReadOnlyFileMapping()
+{
+#if defined(HAVE_MMAP)
+	if (data) {
+		munmap(const_cast<uint8_t*>(data), size);
+	}
+#endif
+}
+
 #endif
@@ -160,6 +160,14 @@ NativeIoResult write_native_file(const NativeFileHandle handle, const uint8_t* b
 	return ret;
 }
 
+NativeIoResult copy_native_file(const NativeFileHandle source,
+                                const NativeFileHandle dest)
+{
+	// CopyFileEx() only works on paths, so the open handles are copied
+	// with large reads and writes instead
+	return copy_native_file_buffered(source, dest);
+}
+
 int64_t seek_native_file(const NativeFileHandle handle, const int64_t offset,
                          const NativeSeek type)
 {
@@ -364,4 +372,46 @@ bool remove_dir(const std_fs::path& path)
 	return _rmdir(path.string().c_str()) == 0;
 }
 
+ReadOnlyFileMapping::ReadOnlyFileMapping(const std_fs::path& path)
+{
+	const auto file = CreateFileW(path.c_str(),
+	                              GENERIC_READ,
+	                              FILE_SHARE_READ,
+	                              nullptr,
+	                              OPEN_EXISTING,
+	                              FILE_ATTRIBUTE_NORMAL,
+	                              nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	LARGE_INTEGER file_size = {};
+	if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+		mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	}
+	// The mapping keeps the file open
+	CloseHandle(file);
+
+	if (!mapping) {
+		return;
+	}
+	const auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view) {
+		CloseHandle(mapping);
+		mapping = nullptr;
+		return;
+	}
+	data = static_cast<const uint8_t*>(view);
+	size = static_cast<size_t>(file_size.QuadPart);
+}
+
+ReadOnlyFileMapping::~ReadOnlyFileMapping()
+{
+	if (data) {
+		UnmapViewOfFile(data);
+	}
+	if (mapping) {
+		CloseHandle(mapping);
+	}
+}
+
 #endif
@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "misc/host_memory.h"
+
+#include <algorithm>
+#include <map>
+
+#include "dosbox_config.h"
+
+#if defined(WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(MACOSX)
+#include <mach/mach.h>
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
+
+static std::map<std::string, HostMemorySizeFunction> subsystems = {};
+
+void HOST_MEMORY_AddSubsystem(const std::string& name,
+                              const HostMemorySizeFunction& get_size)
+{
+	subsystems[name] = get_size;
+}
+
+void HOST_MEMORY_RemoveSubsystem(const std::string& name)
+{
+	subsystems.erase(name);
+}
+
+std::vector<HostMemoryUsage> HOST_MEMORY_GetUsage()
+{
+	std::vector<HostMemoryUsage> usage = {};
+
+	for (const auto& [name, get_size] : subsystems) {
+		if (const auto num_bytes = get_size(); num_bytes > 0) {
+			usage.push_back({name, num_bytes});
+		}
+	}
+	std::sort(usage.begin(), usage.end(), [](const auto& a, const auto& b) {
+		return a.num_bytes > b.num_bytes;
+	});
+	return usage;
+}
+
+std::optional<size_t> HOST_MEMORY_GetResidentSize()
+{
+#if defined(WIN32)
+	PROCESS_MEMORY_COUNTERS counters = {};
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return {};
+	}
+	return static_cast<size_t>(counters.WorkingSetSize);
+
+#elif defined(MACOSX)
+	mach_task_basic_info_data_t info = {};
+
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	if (task_info(mach_task_self(),
+	              MACH_TASK_BASIC_INFO,
+	              reinterpret_cast<task_info_t>(&info),
+	              &count) != KERN_SUCCESS) {
+		return {};
+	}
+	return static_cast<size_t>(info.resident_size);
+
+#else
+	// The second field is the resident size in pages
+	std::ifstream statm("/proc/self/statm");
+
+	size_t total_pages    = 0;
+	size_t resident_pages = 0;
+	if (!(statm >> total_pages >> resident_pages)) {
+		return {};
+	}
+	return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
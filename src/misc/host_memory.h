@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_HOST_MEMORY_H
+#define DOSBOX_HOST_MEMORY_H
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Accounting of the host memory used by the subsystems.
+//
+// Instead of hooking the allocations, each subsystem registers a function
+// that returns the size of its large buffers (the guest RAM, the video
+// memory, the code cache, etc.), so the accounting costs nothing until a
+// report is requested with 'MEM /HOST' or from the web server. Memory
+// allocated by third-party libraries (such as FluidSynth) isn't accounted.
+
+struct HostMemoryUsage {
+	std::string subsystem = {};
+	size_t num_bytes      = 0;
+};
+
+using HostMemorySizeFunction = std::function<size_t()>;
+
+// Registering a subsystem with the name of an existing one replaces it
+void HOST_MEMORY_AddSubsystem(const std::string& name,
+                              const HostMemorySizeFunction& get_size);
+void HOST_MEMORY_RemoveSubsystem(const std::string& name);
+
+// The subsystems currently using memory, largest first
+std::vector<HostMemoryUsage> HOST_MEMORY_GetUsage();
+
+// Resident set size of the whole process, if the host reports it
+std::optional<size_t> HOST_MEMORY_GetResidentSize();
+
+#endif // DOSBOX_HOST_MEMORY_H
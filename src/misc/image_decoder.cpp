@@ -64,6 +64,15 @@ void ImageDecoder::GetNextRowAsBgrx32Pixels(std::vector<uint32_t>::iterator out)
 	AdvanceRow();
 }
 
+void ImageDecoder::SkipRows(const int num_rows)
+{
+	assert(num_rows >= 0);
+
+	for (auto i = 0; i < num_rows; ++i) {
+		AdvanceRow();
+	}
+}
+
 void ImageDecoder::GetBgrx32RowFromIndexed8(std::vector<uint32_t>::iterator out)
 {
 	assert(image.is_paletted());
@@ -49,6 +49,10 @@ public:
 	//
 	void GetNextRowAsBgrx32Pixels(std::vector<uint32_t>::iterator out);
 
+	// Skips the next `num_rows` rows without decoding them.
+	//
+	void SkipRows(const int num_rows);
+
 	// prevent copying
 	ImageDecoder(const ImageDecoder&) = delete;
 	// prevent assignment
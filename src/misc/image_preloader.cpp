@@ -0,0 +1,214 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "misc/image_preloader.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+
+#include "misc/cross.h"
+#include "misc/host_memory.h"
+#include "misc/logging.h"
+#include "misc/support.h"
+
+// The worker holds the lock while reading a chunk, so keep the chunks small
+// enough for a direct read of the emulation thread not to wait long
+constexpr size_t ChunkSize = 256 * 1024;
+
+// Memory held by all preloaded images, for the host memory report
+static std::atomic<size_t> total_preloaded_bytes = 0;
+
+ImagePreloader::ImagePreloader(FILE* _file, const std::string& _name)
+        : file(_file),
+          name(_name),
+          size(std::max(stdio_size_bytes(_file), int64_t(0)))
+{
+	assert(file);
+
+	try {
+		contents.resize(static_cast<size_t>(size));
+	} catch (const std::bad_alloc&) {
+		LOG_WARNING("PRELOAD: Not enough memory to preload '%s'", name.c_str());
+		return;
+	}
+
+	total_preloaded_bytes += contents.size();
+	HOST_MEMORY_AddSubsystem("Preloaded images",
+	                         [] { return total_preloaded_bytes.load(); });
+
+	LOG_MSG("PRELOAD: Reading '%s' into memory", name.c_str());
+
+	thread = std::thread(&ImagePreloader::Run, this);
+	set_thread_name(thread, "dosbox:preload");
+}
+
+ImagePreloader::~ImagePreloader()
+{
+	if (thread.joinable()) {
+		{
+			std::lock_guard lock(mutex);
+			should_exit = true;
+		}
+		work_cv.notify_one();
+		thread.join();
+	}
+
+	// The worker writes the queue out before exiting; this covers the
+	// case it never ran
+	WriteOutQueue();
+	fclose(file);
+
+	total_preloaded_bytes -= contents.size();
+}
+
+bool ImagePreloader::ReadFile(const int64_t offset, uint8_t* data,
+                              const size_t num_bytes)
+{
+	if (cross_fseeko(file, offset, SEEK_SET) != 0) {
+		return false;
+	}
+	const auto num_read = fread(data, 1, num_bytes, file);
+	if (num_read < num_bytes) {
+		clearerr(file);
+		std::fill(data + num_read, data + num_bytes, uint8_t(0));
+	}
+	return true;
+}
+
+bool ImagePreloader::Read(const int64_t offset, uint8_t* data, const size_t num_bytes)
+{
+	const auto end = offset + static_cast<int64_t>(num_bytes);
+
+	auto copy_out = [&] {
+		const auto available = std::clamp(size - offset,
+		                                  int64_t(0),
+		                                  static_cast<int64_t>(num_bytes));
+		const auto n = static_cast<size_t>(available);
+
+		if (n > 0) {
+			std::memcpy(data, &contents[static_cast<size_t>(offset)], n);
+		}
+		std::fill(data + n, data + num_bytes, uint8_t(0));
+	};
+
+	if (std::min(end, size) <= loaded_size.load(std::memory_order_acquire)) {
+		copy_out();
+		return true;
+	}
+
+	std::lock_guard lock(mutex);
+
+	// The worker might have loaded the range while we waited for the lock
+	if (std::min(end, size) <= loaded_size.load(std::memory_order_acquire)) {
+		copy_out();
+		return true;
+	}
+
+	WriteOutQueue();
+	return ReadFile(offset, data, num_bytes);
+}
+
+bool ImagePreloader::Write(const int64_t offset, const uint8_t* data,
+                           const size_t num_bytes)
+{
+	{
+		std::lock_guard lock(mutex);
+
+		// Update the loaded part in memory; the part after it is loaded
+		// from the file after the write has been written out. The lock
+		// keeps the worker from loading more in between.
+		const auto loaded = loaded_size.load(std::memory_order_relaxed);
+		if (offset < loaded) {
+			const auto n = std::min(static_cast<int64_t>(num_bytes),
+			                        loaded - offset);
+			std::memcpy(&contents[static_cast<size_t>(offset)],
+			            data,
+			            static_cast<size_t>(n));
+		}
+
+		queued_writes.push_back({offset, {data, data + num_bytes}});
+
+		// Without a worker, write it out right away
+		if (!thread.joinable()) {
+			WriteOutQueue();
+			return true;
+		}
+	}
+	work_cv.notify_one();
+	return true;
+}
+
+void ImagePreloader::Flush()
+{
+	if (!thread.joinable()) {
+		fflush(file);
+		return;
+	}
+	{
+		std::lock_guard lock(mutex);
+		should_flush = true;
+	}
+	work_cv.notify_one();
+}
+
+// Called with the lock held, or after the worker has exited
+void ImagePreloader::WriteOutQueue()
+{
+	for (const auto& write : queued_writes) {
+		if (cross_fseeko(file, write.offset, SEEK_SET) != 0 ||
+		    fwrite(write.data.data(), 1, write.data.size(), file) !=
+		            write.data.size()) {
+			LOG_ERR("PRELOAD: Could not write %d bytes at offset %lld to '%s'",
+			        static_cast<int>(write.data.size()),
+			        static_cast<long long>(write.offset),
+			        name.c_str());
+		}
+	}
+	queued_writes.clear();
+}
+
+void ImagePreloader::Run()
+{
+	std::unique_lock lock(mutex);
+
+	while (true) {
+		WriteOutQueue();
+		if (should_flush) {
+			fflush(file);
+			should_flush = false;
+		}
+		if (should_exit) {
+			return;
+		}
+
+		// The queued writes were written out right before, so the
+		// chunk is read with the latest data
+		const auto offset = loaded_size.load(std::memory_order_relaxed);
+		if (offset < size && !has_failed) {
+			const auto n = static_cast<size_t>(
+			        std::min(static_cast<int64_t>(ChunkSize), size - offset));
+
+			if (!ReadFile(offset, &contents[static_cast<size_t>(offset)], n)) {
+				LOG_WARNING("PRELOAD: Could not read '%s', reading it directly from now on",
+				            name.c_str());
+				// Leave the rest to the direct reads
+				has_failed = true;
+				continue;
+			}
+			loaded_size.store(offset + static_cast<int64_t>(n),
+			                  std::memory_order_release);
+
+			if (offset + static_cast<int64_t>(n) == size) {
+				LOG_MSG("PRELOAD: '%s' has been read into memory",
+				        name.c_str());
+			}
+			continue;
+		}
+
+		work_cv.wait(lock, [this] {
+			return should_exit || should_flush || !queued_writes.empty();
+		});
+	}
+}
@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_IMAGE_PRELOADER_H
+#define DOSBOX_IMAGE_PRELOADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Reads a whole disk or CD-ROM image into memory on a worker thread, for
+// images on slow (e.g., network) storage.
+//
+// The image is loaded from the start to the end. Reads of the part loaded
+// so far are served from memory without locking; reads beyond it go to the
+// file directly. Writes update the copy in memory and are written to the
+// file by the worker thread, so the emulation doesn't wait for them either.
+//
+// All access to the file goes through the worker's lock, and the queued
+// writes are written out before the file is read, so the reads always see
+// the latest data.
+class ImagePreloader {
+public:
+	// Takes ownership of the file, which is closed when the preloader is
+	// destroyed. If there isn't enough memory for the image, everything
+	// is read from and written to the file directly.
+	ImagePreloader(FILE* file, const std::string& name);
+	~ImagePreloader();
+
+	ImagePreloader(const ImagePreloader&)            = delete;
+	ImagePreloader& operator=(const ImagePreloader&) = delete;
+
+	int64_t GetSize() const
+	{
+		return size;
+	}
+
+	// Reading past the end of the image is not an error; the missing part
+	// of the data is filled with zeros
+	bool Read(const int64_t offset, uint8_t* data, const size_t num_bytes);
+
+	// Queues the write for the worker thread. Errors writing the file are
+	// logged by the worker, as the guest has moved on by then.
+	bool Write(const int64_t offset, const uint8_t* data, const size_t num_bytes);
+
+	// Has the worker write out the queued writes and flush the file
+	// without waiting for it
+	void Flush();
+
+private:
+	struct QueuedWrite {
+		int64_t offset            = 0;
+		std::vector<uint8_t> data = {};
+	};
+
+	void Run();
+	void WriteOutQueue();
+	bool ReadFile(const int64_t offset, uint8_t* data, const size_t num_bytes);
+
+	FILE* file         = nullptr;
+	std::string name   = {};
+	const int64_t size = 0;
+
+	// The loaded part, which only grows, is written only by the emulation
+	// thread; the worker only fills in the part after it
+	std::vector<uint8_t> contents    = {};
+	std::atomic<int64_t> loaded_size = 0;
+
+	std::mutex mutex                       = {};
+	std::condition_variable work_cv        = {};
+	std::vector<QueuedWrite> queued_writes = {};
+	bool should_flush                      = false;
+	bool should_exit                       = false;
+	bool has_failed                        = false;
+
+	std::thread thread = {};
+};
+
+#endif // DOSBOX_IMAGE_PRELOADER_H
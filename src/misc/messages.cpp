@@ -222,13 +222,13 @@ void Message::VerifyFormatString(const std::string& message_key)
 	}
 
 	// clang-format off
-	const std::set<char> Flags   = {
+	static const std::set<char> Flags   = {
 		'-', '+', ' ', '#', '0'
 	};
-	const std::set<char> Lengths = {
+	static const std::set<char> Lengths = {
 		'h', 'l', 'j', 'z', 't', 'L'
 	};
-	const std::set<char> Formats = {
+	static const std::set<char> Formats = {
 		'd', 'i', 'u', 'o', 'x', 'X', 'f', 'F', 'e', 'E', 'g', 'G',
 		'a', 'A', 'c', 'C', 's', 'p', 'n'
 	};
@@ -618,6 +618,9 @@ static std::vector<std::string> message_order = {};
 
 static std::unordered_map<std::string, MessageLocation> message_location = {};
 
+// Messages are only verified when first used, so neither the startup nor
+// loading a translation pay for checking the many messages that are never
+// displayed; use the 'find_*' helpers below to access them
 static std::unordered_map<std::string, Message> dictionary_english    = {};
 static std::unordered_map<std::string, Message> dictionary_translated = {};
 
@@ -685,6 +688,33 @@ static bool check_message_exists(const std::string& message_key)
 	return true;
 }
 
+static Message* find_english(const std::string& message_key)
+{
+	const auto it = dictionary_english.find(message_key);
+	if (it == dictionary_english.end()) {
+		return nullptr;
+	}
+
+	it->second.VerifyEnglish(message_key);
+	return &it->second;
+}
+
+static Message* find_translated(const std::string& message_key)
+{
+	const auto it = dictionary_translated.find(message_key);
+	if (it == dictionary_translated.end()) {
+		return nullptr;
+	}
+
+	// Translations can only be verified against a valid English message;
+	// they stay invalid otherwise
+	const auto message_english = find_english(message_key);
+	if (message_english && message_english->IsValid()) {
+		it->second.VerifyTranslated(message_key, *message_english);
+	}
+	return &it->second;
+}
+
 static void clear_translated_messages()
 {
 	const bool notify_new_language = !translation_language.empty();
@@ -741,20 +771,21 @@ static bool write_messages(PoWriter& writer)
 {
 	for (const auto& message_key : message_order) {
 		assert(message_location.contains(message_key));
-		assert(dictionary_english.contains(message_key));
+
+		const auto message_english = find_english(message_key);
+		assert(message_english);
 
 		writer.AddFlag(PoEntry::FlagCFormat);
 		writer.AddFlag(PoEntry::FlagNoWrap);
 		writer.SetContext(message_key);
 		writer.SetLocation(message_location.at(message_key).GetUnified());
-		writer.SetEnglish(dictionary_english.at(message_key).GetRaw());
+		writer.SetEnglish(message_english->GetRaw());
 
 		bool is_fuzzy = false;
-		if (dictionary_translated.contains(message_key)) {
-			const auto translated = dictionary_translated.at(message_key);
+		if (const auto translated = find_translated(message_key); translated) {
 			// Translated message exists
-			writer.SetTranslated(translated.GetRaw());
-			if (translated.IsFuzzy() || !translated.IsValid()) {
+			writer.SetTranslated(translated->GetRaw());
+			if (translated->IsFuzzy() || !translated->IsValid()) {
 				is_fuzzy = true;
 			}
 		} else {
@@ -827,16 +858,11 @@ static void read_message(const PoReader& reader)
 
 	const auto english = reader.GetEnglish();
 
-	dictionary_translated.try_emplace(message_key, Message(english, translated));
+	const auto [it, _] = dictionary_translated.try_emplace(
+	        message_key, Message(english, translated));
 
-	auto& message = dictionary_translated.at(message_key);
 	if (reader.HasFlag(PoEntry::FlagFuzzy)) {
-		message.MarkFuzzy();
-	}
-
-	if (dictionary_english.contains(message_key)) {
-		message.VerifyTranslated(message_key,
-		                         dictionary_english.at(message_key));
+		it->second.MarkFuzzy();
 	}
 }
 
@@ -954,13 +980,6 @@ void MSG_Add(const std::string& message_key, const std::string& message,
 
 	message_order.push_back(message_key);
 	dictionary_english.try_emplace(message_key, Message(message));
-
-	auto& message_english = dictionary_english.at(message_key);
-	message_english.VerifyEnglish(message_key);
-	if (dictionary_translated.contains(message_key)) {
-		dictionary_translated.at(message_key)
-		        .VerifyTranslated(message_key, message_english);
-	}
 }
 
 std::string MSG_Get(const std::string& message_key)
@@ -971,17 +990,19 @@ std::string MSG_Get(const std::string& message_key)
 
 	// Try to return the translated message converted to the current DOS
 	// code page and the ANSI tags converted to ANSI sequences
-	if (is_code_page_compatible && dictionary_translated.contains(message_key) &&
-	    dictionary_translated.at(message_key).IsValid()) {
-
-		return dictionary_translated.at(message_key).Get();
+	if (is_code_page_compatible) {
+		const auto translated = find_translated(message_key);
+		if (translated && translated->IsValid()) {
+			return translated->Get();
+		}
 	}
 
 	// Fall back to English if any errors
-	if (!dictionary_english.at(message_key).IsValid()) {
+	const auto message_english = find_english(message_key);
+	if (!message_english->IsValid()) {
 		return MsgNotValid;
 	}
-	return dictionary_english.at(message_key).Get();
+	return message_english->Get();
 }
 
 std::string MSG_GetEnglishRaw(const std::string& message_key)
@@ -991,10 +1012,11 @@ std::string MSG_GetEnglishRaw(const std::string& message_key)
 	}
 
 	// Return English original in UTF-8 with the ANSI tags intact
-	if (!dictionary_english.at(message_key).IsValid()) {
+	const auto message_english = find_english(message_key);
+	if (!message_english->IsValid()) {
 		return MsgNotValid;
 	}
-	return dictionary_english.at(message_key).GetRaw();
+	return message_english->GetRaw();
 }
 
 std::string MSG_GetTranslatedRaw(const std::string& message_key)
@@ -1004,10 +1026,9 @@ std::string MSG_GetTranslatedRaw(const std::string& message_key)
 	}
 
 	// Try to return the translated message in UTF-8 with the ANSI tags intact
-	if (dictionary_translated.contains(message_key) &&
-	    dictionary_translated.at(message_key).IsValid()) {
-
-		return dictionary_translated.at(message_key).GetRaw();
+	const auto translated = find_translated(message_key);
+	if (translated && translated->IsValid()) {
+		return translated->GetRaw();
 	}
 
 	// Fall back to the English message if any errors
@@ -0,0 +1,241 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "misc/metrics.h"
+
+#include <cassert>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <variant>
+
+#include "misc/logging.h"
+#include "utils/checks.h"
+#include "utils/string_utils.h"
+
+CHECK_NARROWING();
+
+size_t METRICS_GetThreadSlot()
+{
+	static std::atomic<size_t> next_slot = 0;
+
+	thread_local const size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed) %
+	                                 MetricSlots;
+	return slot;
+}
+
+int64_t MetricCounter::Value() const
+{
+	int64_t total = 0;
+	for (const auto& slot : slots) {
+		total += slot.value.load(std::memory_order_relaxed);
+	}
+	return total;
+}
+
+MetricHistogram::MetricHistogram(const std::vector<double>& _bounds)
+        : bounds(_bounds)
+{
+	// One bucket is reserved for the values above the last bound
+	assert(bounds.size() < MaxBuckets);
+	if (bounds.size() >= MaxBuckets) {
+		bounds.resize(MaxBuckets - 1);
+	}
+}
+
+void MetricHistogram::Observe(const double v)
+{
+	size_t bucket = 0;
+	while (bucket < bounds.size() && v > bounds[bucket]) {
+		++bucket;
+	}
+
+	auto& slot = slots[METRICS_GetThreadSlot()];
+	slot.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+	slot.sum.fetch_add(v, std::memory_order_relaxed);
+}
+
+MetricHistogram::Snapshot MetricHistogram::GetSnapshot() const
+{
+	Snapshot snapshot = {};
+	snapshot.cumulative_counts.resize(bounds.size() + 1);
+
+	for (const auto& slot : slots) {
+		for (size_t i = 0; i < snapshot.cumulative_counts.size(); ++i) {
+			snapshot.cumulative_counts[i] += slot.counts[i].load(
+			        std::memory_order_relaxed);
+		}
+		snapshot.sum += slot.sum.load(std::memory_order_relaxed);
+	}
+
+	for (size_t i = 1; i < snapshot.cumulative_counts.size(); ++i) {
+		snapshot.cumulative_counts[i] += snapshot.cumulative_counts[i - 1];
+	}
+	snapshot.count = snapshot.cumulative_counts.back();
+
+	return snapshot;
+}
+
+// ***************************************************************************
+// Registry
+// ***************************************************************************
+
+using MetricPtr = std::variant<std::unique_ptr<MetricCounter>,
+                               std::unique_ptr<MetricGauge>,
+                               std::unique_ptr<MetricHistogram>>;
+
+struct RegisteredMetric {
+	std::string name = {};
+	std::string help = {};
+	MetricPtr metric = {};
+};
+
+// Rendering the text is far more expensive than updating the metrics, so
+// frequent scrapes are served from a copy
+constexpr auto PrometheusTextMaxAge = std::chrono::seconds(1);
+
+static struct {
+	std::mutex mutex = {};
+
+	// In order of registration
+	std::vector<RegisteredMetric> metrics = {};
+	std::map<std::string, size_t> index_by_name = {};
+
+	std::string prometheus_text = {};
+	std::chrono::steady_clock::time_point prometheus_text_time = {};
+	bool has_prometheus_text = false;
+} registry = {};
+
+template <typename T, typename... Args>
+static T& find_or_register(const std::string& name, const std::string& help,
+                           Args&&... args)
+{
+	const std::lock_guard lock(registry.mutex);
+
+	if (const auto it = registry.index_by_name.find(name);
+	    it != registry.index_by_name.end()) {
+
+		auto& existing = registry.metrics[it->second].metric;
+		if (const auto metric = std::get_if<std::unique_ptr<T>>(&existing); metric) {
+			return **metric;
+		}
+		// Programming error: the same name registered with two types
+		assert(false);
+	}
+
+	auto metric = std::make_unique<T>(std::forward<Args>(args)...);
+	auto& ref   = *metric;
+
+	registry.index_by_name[name] = registry.metrics.size();
+	registry.metrics.push_back({name, help, std::move(metric)});
+
+	return ref;
+}
+
+MetricCounter& METRICS_Counter(const std::string& name, const std::string& help)
+{
+	return find_or_register<MetricCounter>(name, help);
+}
+
+MetricGauge& METRICS_Gauge(const std::string& name, const std::string& help)
+{
+	return find_or_register<MetricGauge>(name, help);
+}
+
+MetricHistogram& METRICS_Histogram(const std::string& name,
+                                   const std::string& help,
+                                   const std::vector<double>& bounds)
+{
+	return find_or_register<MetricHistogram>(name, help, bounds);
+}
+
+// ***************************************************************************
+// Export
+// ***************************************************************************
+
+static std::string render_prometheus_text()
+{
+	std::string text = {};
+
+	auto add_header = [&](const RegisteredMetric& m, const char* type) {
+		text += format_str("# HELP %s %s\n", m.name.c_str(), m.help.c_str());
+		text += format_str("# TYPE %s %s\n", m.name.c_str(), type);
+	};
+
+	for (const auto& m : registry.metrics) {
+		if (const auto counter = std::get_if<std::unique_ptr<MetricCounter>>(&m.metric);
+		    counter) {
+			add_header(m, "counter");
+			text += format_str("%s %lld\n",
+			                   m.name.c_str(),
+			                   static_cast<long long>((*counter)->Value()));
+
+		} else if (const auto gauge = std::get_if<std::unique_ptr<MetricGauge>>(&m.metric);
+		           gauge) {
+			add_header(m, "gauge");
+			text += format_str("%s %g\n", m.name.c_str(), (*gauge)->Value());
+
+		} else if (const auto histogram = std::get_if<std::unique_ptr<MetricHistogram>>(
+		                   &m.metric);
+		           histogram) {
+			add_header(m, "histogram");
+
+			const auto& bounds  = (*histogram)->GetBounds();
+			const auto snapshot = (*histogram)->GetSnapshot();
+
+			for (size_t i = 0; i < bounds.size(); ++i) {
+				text += format_str("%s_bucket{le=\"%g\"} %lld\n",
+				                   m.name.c_str(),
+				                   bounds[i],
+				                   static_cast<long long>(
+				                           snapshot.cumulative_counts[i]));
+			}
+			text += format_str("%s_bucket{le=\"+Inf\"} %lld\n",
+			                   m.name.c_str(),
+			                   static_cast<long long>(snapshot.count));
+			text += format_str("%s_sum %g\n", m.name.c_str(), snapshot.sum);
+			text += format_str("%s_count %lld\n",
+			                   m.name.c_str(),
+			                   static_cast<long long>(snapshot.count));
+		}
+	}
+	return text;
+}
+
+std::string METRICS_GetPrometheusText()
+{
+	const std::lock_guard lock(registry.mutex);
+
+	const auto now = std::chrono::steady_clock::now();
+	if (!registry.has_prometheus_text ||
+	    now - registry.prometheus_text_time >= PrometheusTextMaxAge) {
+
+		registry.prometheus_text      = render_prometheus_text();
+		registry.prometheus_text_time = now;
+		registry.has_prometheus_text  = true;
+	}
+	return registry.prometheus_text;
+}
+
+void METRICS_LogSummary()
+{
+	const std::lock_guard lock(registry.mutex);
+
+	std::string line = {};
+	for (const auto& m : registry.metrics) {
+		if (const auto counter = std::get_if<std::unique_ptr<MetricCounter>>(&m.metric);
+		    counter) {
+			line += format_str(" %s=%lld",
+			                   m.name.c_str(),
+			                   static_cast<long long>((*counter)->Value()));
+
+		} else if (const auto gauge = std::get_if<std::unique_ptr<MetricGauge>>(&m.metric);
+		           gauge) {
+			line += format_str(" %s=%g", m.name.c_str(), (*gauge)->Value());
+		}
+	}
+	if (!line.empty()) {
+		LOG_MSG("METRICS:%s", line.c_str());
+	}
+}
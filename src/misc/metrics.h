@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_METRICS_H
+#define DOSBOX_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Registry of named performance metrics, exported in the Prometheus text
+// format (see the webserver's '/metrics' endpoint) and optionally logged.
+//
+// Metrics are registered once, typically into a function-local static:
+//
+//   static auto& events = METRICS_Counter("dosbox_pic_events_total",
+//                                         "PIC events serviced");
+//   events.Add();
+//
+// Updates only take relaxed atomic operations, so they are cheap enough for
+// the emulation's hot paths and safe from any thread. Counters and
+// histograms are split into cache-line sized slots that threads pick by
+// their own index, so threads updating the same metric don't contend on
+// the same cache line; readers sum the slots.
+
+constexpr size_t MetricSlots = 8;
+
+// Index of the slot the calling thread updates
+size_t METRICS_GetThreadSlot();
+
+// Monotonically increasing count of events
+class MetricCounter {
+public:
+	void Add(const int64_t n = 1)
+	{
+		slots[METRICS_GetThreadSlot()].value.fetch_add(n, std::memory_order_relaxed);
+	}
+
+	int64_t Value() const;
+
+private:
+	struct alignas(64) Slot {
+		std::atomic<int64_t> value = 0;
+	};
+	std::array<Slot, MetricSlots> slots = {};
+};
+
+// Value that can go up and down, e.g. a queue's fill level
+class MetricGauge {
+public:
+	void Set(const double v)
+	{
+		value.store(v, std::memory_order_relaxed);
+	}
+
+	double Value() const
+	{
+		return value.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<double> value = 0.0;
+};
+
+// Distribution of observed values over fixed, ascending bucket upper bounds
+// (an implicit last bucket catches everything above them)
+class MetricHistogram {
+public:
+	explicit MetricHistogram(const std::vector<double>& _bounds);
+
+	void Observe(const double v);
+
+	struct Snapshot {
+		// Cumulative counts, one per bound plus the implicit +Inf bucket
+		std::vector<int64_t> cumulative_counts = {};
+
+		int64_t count = 0;
+		double sum    = 0.0;
+	};
+
+	Snapshot GetSnapshot() const;
+
+	const std::vector<double>& GetBounds() const
+	{
+		return bounds;
+	}
+
+private:
+	static constexpr size_t MaxBuckets = 16;
+
+	struct alignas(64) Slot {
+		std::array<std::atomic<int64_t>, MaxBuckets> counts = {};
+		std::atomic<double> sum                             = 0.0;
+	};
+
+	std::vector<double> bounds   = {};
+	std::array<Slot, MetricSlots> slots = {};
+};
+
+// Registering an existing name returns the existing metric; the metrics live
+// until the end of the program. Names should follow the Prometheus
+// conventions (e.g. 'dosbox_' prefix, '_total' suffix for counters, unit
+// suffixes like '_seconds').
+MetricCounter& METRICS_Counter(const std::string& name, const std::string& help);
+MetricGauge& METRICS_Gauge(const std::string& name, const std::string& help);
+MetricHistogram& METRICS_Histogram(const std::string& name,
+                                   const std::string& help,
+                                   const std::vector<double>& bounds);
+
+// All registered metrics in the Prometheus text exposition format. The text
+// is rendered at most once per second; later calls return the cached copy.
+std::string METRICS_GetPrometheusText();
+
+// Logs the counters and gauges on a single line
+void METRICS_LogSummary();
+
+#endif // DOSBOX_METRICS_H
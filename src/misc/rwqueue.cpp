@@ -323,9 +323,20 @@ template class RWQueue<MidiWork>;
 #include "gui/render/render.h"
 template class RWQueue<SaveImageTask>;
 
+#include "capture/private/capture_video.h"
+template class RWQueue<VideoCaptureFrame>;
+
 //PC Speaker
 template class RWQueue<float>;
 
+// IBM Music Feature Card
+#include "hardware/audio/imfc.h"
+template class RWQueue<ImfcYmWork>;
+
+// Innovation SSI-2001
+#include "hardware/audio/innovation.h"
+template class RWQueue<SidWork>;
+
 // Tandy
 template class RWQueue<uint8_t>;
 
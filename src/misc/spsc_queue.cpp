@@ -0,0 +1,445 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "utils/spsc_queue.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+// All counter accesses use sequentially consistent ordering. A sleeping
+// thread publishes its wake-up target and loads 'events' before re-checking
+// its condition, and the other side updates its counter before looking at
+// the target. With a single total order either the re-check sees the new
+// counter or the other side sees the target and bumps 'events', which rules
+// out lost wake-ups.
+
+template <typename T>
+SpscQueue<T>::SpscQueue(size_t queue_capacity)
+{
+	Resize(queue_capacity);
+}
+
+template <typename T>
+void SpscQueue<T>::Resize(size_t queue_capacity)
+{
+	assert(queue_capacity > 0);
+
+	capacity   = queue_capacity;
+	fill_limit = queue_capacity;
+	buffer.assign(capacity, T{});
+
+	head       = 0;
+	head_index = 0;
+	tail       = 0;
+	tail_index = 0;
+}
+
+template <typename T>
+void SpscQueue<T>::Wake()
+{
+	++events;
+	events.notify_all();
+}
+
+template <typename T>
+void SpscQueue<T>::PublishHead(const size_t new_head)
+{
+	head = new_head;
+
+	// Only the first update reaching the target wakes up the waiter
+	auto target = wake_at_head.load();
+	if (target && new_head >= target &&
+	    wake_at_head.compare_exchange_strong(target, 0)) {
+		Wake();
+	}
+}
+
+template <typename T>
+void SpscQueue<T>::PublishTail(const size_t new_tail)
+{
+	tail = new_tail;
+
+	// Only the first update reaching the target wakes up the waiter
+	auto target = wake_at_tail.load();
+	if (target && new_tail >= target &&
+	    wake_at_tail.compare_exchange_strong(target, 0)) {
+		Wake();
+	}
+}
+
+template <typename T>
+template <typename Predicate>
+void SpscQueue<T>::WaitUntil(std::atomic<size_t>& wake_at,
+                             const size_t target, Predicate predicate)
+{
+	while (!predicate()) {
+		wake_at = target;
+
+		const auto last_event = events.load();
+		if (!predicate()) {
+			events.wait(last_event);
+		}
+
+		wake_at = 0;
+	}
+}
+
+template <typename T>
+size_t SpscQueue<T>::Size()
+{
+	const auto curr_head = head.load();
+	const auto curr_tail = tail.load();
+
+	// The consumer can advance the head between the two loads
+	return curr_tail >= curr_head ? curr_tail - curr_head : 0;
+}
+
+template <typename T>
+void SpscQueue<T>::Start()
+{
+	is_running = true;
+}
+
+template <typename T>
+void SpscQueue<T>::Stop()
+{
+	if (!is_running.exchange(false)) {
+		return;
+	}
+	Wake();
+}
+
+template <typename T>
+void SpscQueue<T>::Clear()
+{
+	const auto curr_tail = tail.load();
+
+	head_index = curr_tail % capacity;
+	PublishHead(curr_tail);
+}
+
+template <typename T>
+size_t SpscQueue<T>::MaxCapacity()
+{
+	return capacity;
+}
+
+template <typename T>
+void SpscQueue<T>::SetFillLimit(const size_t num_items)
+{
+	fill_limit = std::clamp(num_items, size_t{1}, capacity);
+
+	// A producer waiting for room re-checks against the new limit
+	Wake();
+}
+
+template <typename T>
+size_t SpscQueue<T>::GetFillLimit()
+{
+	return fill_limit;
+}
+
+template <typename T>
+size_t SpscQueue<T>::GetRoom(const size_t curr_tail)
+{
+	const auto curr_size = curr_tail - head;
+	const auto limit     = fill_limit.load();
+	return curr_size < limit ? limit - curr_size : 0;
+}
+
+template <typename T>
+float SpscQueue<T>::GetPercentFull()
+{
+	const auto cur_level = static_cast<float>(Size());
+	const auto max_level = static_cast<float>(capacity);
+	return (100.0f * cur_level) / max_level;
+}
+
+template <typename T>
+bool SpscQueue<T>::IsEmpty()
+{
+	return Size() == 0;
+}
+
+template <typename T>
+bool SpscQueue<T>::IsFull()
+{
+	return Size() >= capacity;
+}
+
+template <typename T>
+bool SpscQueue<T>::IsRunning()
+{
+	return is_running;
+}
+
+template <typename T>
+void SpscQueue<T>::Advance(size_t& index, const size_t num_items) const
+{
+	index += num_items;
+	if (index >= capacity) {
+		index -= capacity;
+	}
+}
+
+template <typename T>
+void SpscQueue<T>::MoveIn(T* const source, const size_t num_items)
+{
+	assert(num_items <= capacity);
+
+	const auto first_part = std::min(num_items, capacity - tail_index);
+
+	std::move(source, source + first_part, buffer.begin() + tail_index);
+	std::move(source + first_part, source + num_items, buffer.begin());
+
+	Advance(tail_index, num_items);
+}
+
+template <typename T>
+void SpscQueue<T>::MoveOut(T* const target, const size_t num_items)
+{
+	assert(num_items <= capacity);
+
+	const auto first_part = std::min(num_items, capacity - head_index);
+
+	const auto first = buffer.begin() + head_index;
+	std::move(first, first + first_part, target);
+	std::move(buffer.begin(),
+	          buffer.begin() + (num_items - first_part),
+	          target + first_part);
+
+	Advance(head_index, num_items);
+}
+
+template <typename T>
+bool SpscQueue<T>::Enqueue(T&& item)
+{
+	const auto curr_tail = tail.load();
+
+	// wait until we're stopped or the queue has room to accept the item
+	WaitUntil(wake_at_head, curr_tail + 1 - fill_limit, [&] {
+		return !is_running || GetRoom(curr_tail) > 0;
+	});
+
+	if (!is_running) {
+		return false;
+	}
+
+	buffer[tail_index] = std::move(item);
+	Advance(tail_index, 1);
+
+	PublishTail(curr_tail + 1);
+
+	return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::NonblockingEnqueue(T&& item)
+{
+	const auto curr_tail = tail.load();
+
+	if (!is_running || GetRoom(curr_tail) == 0) {
+		return false;
+	}
+
+	buffer[tail_index] = std::move(item);
+	Advance(tail_index, 1);
+
+	PublishTail(curr_tail + 1);
+
+	return true;
+}
+
+template <typename T>
+size_t SpscQueue<T>::BulkEnqueue(std::vector<T>& from_source)
+{
+	return BulkEnqueue(from_source, from_source.size());
+}
+
+template <typename T>
+size_t SpscQueue<T>::BulkEnqueue(std::vector<T>& from_source,
+                                 const size_t num_requested)
+{
+	assert(num_requested >= 1);
+	assert(num_requested <= from_source.size());
+
+	auto source        = from_source.data();
+	auto num_remaining = num_requested;
+
+	while (num_remaining > 0) {
+		const auto curr_tail = tail.load();
+
+		// wait until we're stopped or the queue has room for at least
+		// one item, then move in as many as fit
+		WaitUntil(wake_at_head, curr_tail + 1 - fill_limit, [&] {
+			return !is_running || GetRoom(curr_tail) > 0;
+		});
+
+		if (!is_running) {
+			// Anything that was enqueued prior to being stopped is
+			// safely in the queue.
+			break;
+		}
+
+		const auto num_items = std::min(GetRoom(curr_tail), num_remaining);
+
+		MoveIn(source, num_items);
+		PublishTail(curr_tail + num_items);
+
+		source += num_items;
+		num_remaining -= num_items;
+	}
+	from_source.clear();
+
+	assert(num_remaining <= num_requested);
+	return (num_requested - num_remaining);
+}
+
+template <typename T>
+size_t SpscQueue<T>::NonblockingBulkEnqueue(std::vector<T>& from_source)
+{
+	return NonblockingBulkEnqueue(from_source, from_source.size());
+}
+
+template <typename T>
+size_t SpscQueue<T>::NonblockingBulkEnqueue(std::vector<T>& from_source,
+                                            const size_t num_requested)
+{
+	assert(num_requested > 0);
+	assert(num_requested <= from_source.size());
+
+	const auto curr_tail = tail.load();
+	const auto room      = GetRoom(curr_tail);
+
+	if (!is_running || room == 0) {
+		return 0;
+	}
+
+	const auto num_items = std::min(room, num_requested);
+
+	MoveIn(from_source.data(), num_items);
+	PublishTail(curr_tail + num_items);
+
+	const auto source_start = from_source.begin();
+	from_source.erase(source_start,
+	                  source_start + static_cast<std::ptrdiff_t>(num_items));
+
+	return num_items;
+}
+
+template <typename T>
+std::optional<T> SpscQueue<T>::Dequeue()
+{
+	const auto curr_head = head.load();
+
+	// wait until we're stopped or the queue has an item
+	WaitUntil(wake_at_tail, curr_head + 1, [&] {
+		return !is_running || tail != curr_head;
+	});
+
+	// Even if the queue has stopped, we need to drain the (previously)
+	// queued items before we're done.
+	if (tail == curr_head) {
+		return {};
+	}
+
+	auto item = std::optional<T>(std::move(buffer[head_index]));
+	Advance(head_index, 1);
+
+	PublishHead(curr_head + 1);
+
+	return item;
+}
+
+template <typename T>
+size_t SpscQueue<T>::BulkDequeue(std::vector<T>& into_target,
+                                 const size_t num_requested)
+{
+	if (into_target.size() < num_requested) {
+		into_target.resize(num_requested);
+	}
+
+	const auto num_dequeued = BulkDequeue(into_target.data(), num_requested);
+
+	// cap off the target vector to match the dequeued quantity
+	into_target.resize(num_dequeued);
+
+	return num_dequeued;
+}
+
+template <typename T>
+size_t SpscQueue<T>::BulkDequeue(T* const into_target, const size_t num_requested)
+{
+	assert(into_target);
+
+	auto target        = into_target;
+	auto num_remaining = num_requested;
+
+	while (num_remaining > 0) {
+		const auto curr_head = head.load();
+
+		// Wait until we're stopped or all the remaining items (or the
+		// fill limit's worth) are available. The producer always moves
+		// in as many items as fit, so this can't deadlock, and we
+		// don't wake up for every single item.
+		const auto limit      = fill_limit.load();
+		const auto num_wanted = std::min(num_remaining, limit);
+
+		WaitUntil(wake_at_tail, curr_head + num_wanted, [&] {
+			return !is_running || tail - curr_head >= num_wanted ||
+			       fill_limit != limit;
+		});
+
+		// Even if the queue has stopped, we need to drain the
+		// (previously) queued items before we're done.
+		const auto num_queued = tail - curr_head;
+		if (is_running && num_queued < num_wanted) {
+			// The fill limit changed while we were waiting
+			continue;
+		}
+		if (num_queued == 0) {
+			// The queue was stopped mid-dequeue!
+			break;
+		}
+
+		const auto num_items = std::min(num_queued, num_remaining);
+
+		MoveOut(target, num_items);
+		PublishHead(curr_head + num_items);
+
+		target += num_items;
+		num_remaining -= num_items;
+	}
+	assert(num_remaining <= num_requested);
+	return (num_requested - num_remaining);
+}
+
+// Explicit template instantiations
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Unit tests
+template class SpscQueue<int>;
+
+// FluidSynth, MT-32, Sound Canvas
+#include "audio/audio_frame.h"
+template class SpscQueue<AudioFrame>;
+
+// Innovation SSI-2001
+template class SpscQueue<float>;
+
+// Disk noise
+#include "audio/disk_noise.h"
+template class SpscQueue<DiskNoiseEvent>;
+
+// Audio and MIDI capture
+template class SpscQueue<uint8_t>;
+
+// CD audio
+template class SpscQueue<int16_t>;
+
+// Ethernet frames
+template class SpscQueue<std::vector<uint8_t>>;
+
+// Console log lines
+#include <string>
+template class SpscQueue<std::string>;
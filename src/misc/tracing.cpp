@@ -0,0 +1,229 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "misc/tracing.h"
+
+#if C_TRACING
+
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "hardware/timer.h"
+#include "misc/logging.h"
+#include "utils/checks.h"
+
+CHECK_NARROWING();
+
+namespace {
+
+struct TraceEvent {
+	const char* name = nullptr;
+	int64_t start_us = 0;
+	int64_t end_us   = 0;
+};
+
+// Events are stored in fixed-size chunks that are never moved or freed
+// while the trace runs, so the writer thread can append without locking
+// and without reallocating under a concurrent reader.
+constexpr size_t EventsPerChunk = 16 * 1024;
+
+// Caps the memory of a thread at 8M events (192 MB); events past it are
+// dropped and counted
+constexpr size_t MaxChunksPerThread = 512;
+
+struct TraceChunk {
+	std::array<TraceEvent, EventsPerChunk> events = {};
+};
+
+struct ThreadBuffer {
+	explicit ThreadBuffer(const int _thread_id) : thread_id(_thread_id) {}
+
+	~ThreadBuffer()
+	{
+		for (auto& chunk : chunks) {
+			delete chunk.load(std::memory_order_relaxed);
+		}
+	}
+
+	ThreadBuffer(const ThreadBuffer&)            = delete;
+	ThreadBuffer& operator=(const ThreadBuffer&) = delete;
+
+	const int thread_id = 0;
+
+	std::atomic<const char*> name = nullptr;
+
+	std::array<std::atomic<TraceChunk*>, MaxChunksPerThread> chunks = {};
+
+	// Only the owning thread writes these; the count is published with
+	// release semantics after the event it covers has been stored
+	std::atomic<size_t> num_events  = 0;
+	std::atomic<size_t> num_dropped = 0;
+};
+
+struct Tracer {
+	std::atomic<bool> is_running = false;
+	bool has_run                 = false;
+
+	std::string path = {};
+
+	int64_t start_us = 0;
+
+	// Only taken when a thread records its first event or when the trace
+	// is written out
+	std::mutex registry_mutex = {};
+	std::vector<std::unique_ptr<ThreadBuffer>> buffers = {};
+};
+
+Tracer tracer = {};
+
+thread_local ThreadBuffer* thread_buffer = nullptr;
+
+ThreadBuffer& get_thread_buffer()
+{
+	if (!thread_buffer) {
+		const std::lock_guard lock(tracer.registry_mutex);
+
+		const auto thread_id = static_cast<int>(tracer.buffers.size()) + 1;
+		tracer.buffers.emplace_back(std::make_unique<ThreadBuffer>(thread_id));
+
+		thread_buffer = tracer.buffers.back().get();
+	}
+	return *thread_buffer;
+}
+
+void write_trace(FILE* file)
+{
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	fprintf(file,
+	        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+	        "\"args\":{\"name\":\"DOSBox Staging\"}}");
+
+	size_t num_dropped = 0;
+
+	const std::lock_guard lock(tracer.registry_mutex);
+
+	for (const auto& buffer : tracer.buffers) {
+		if (const auto name = buffer->name.load(std::memory_order_acquire); name) {
+			fprintf(file,
+			        ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+			        "\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+			        buffer->thread_id,
+			        name);
+		}
+
+		const auto num_events = buffer->num_events.load(std::memory_order_acquire);
+
+		for (size_t i = 0; i < num_events; ++i) {
+			const auto chunk = buffer->chunks[i / EventsPerChunk].load(
+			        std::memory_order_acquire);
+
+			const auto& event = chunk->events[i % EventsPerChunk];
+
+			fprintf(file,
+			        ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+			        "\"ts\":%" PRId64 ",\"dur\":%" PRId64 "}",
+			        event.name,
+			        buffer->thread_id,
+			        event.start_us,
+			        event.end_us - event.start_us);
+		}
+
+		num_dropped += buffer->num_dropped.load(std::memory_order_relaxed);
+	}
+
+	fprintf(file, "\n]}\n");
+
+	if (num_dropped > 0) {
+		LOG_WARNING("TRACING: Dropped %zu events after the buffers filled up",
+		            num_dropped);
+	}
+}
+
+} // namespace
+
+void TRACING_Start(const std::string& path)
+{
+	// Threads keep the pointers to their buffers for their lifetime, so
+	// the buffers can't be reset for a second trace
+	if (tracer.has_run) {
+		LOG_WARNING("TRACING: Only one trace can be recorded per session");
+		return;
+	}
+	tracer.has_run  = true;
+	tracer.path     = path;
+	tracer.start_us = GetTicksUs();
+
+	TRACING_SetThreadName("Main");
+
+	tracer.is_running.store(true, std::memory_order_release);
+
+	LOG_MSG("TRACING: Recording trace to '%s'", path.c_str());
+}
+
+void TRACING_Stop()
+{
+	if (!tracer.is_running.exchange(false, std::memory_order_acq_rel)) {
+		return;
+	}
+
+	auto file = fopen(tracer.path.c_str(), "w");
+	if (!file) {
+		LOG_WARNING("TRACING: Can't open '%s' for writing", tracer.path.c_str());
+		return;
+	}
+
+	write_trace(file);
+	fclose(file);
+
+	LOG_MSG("TRACING: Wrote trace to '%s'", tracer.path.c_str());
+}
+
+void TRACING_SetThreadName(const char* name)
+{
+	get_thread_buffer().name.store(name, std::memory_order_release);
+}
+
+bool TRACING_IsRunning()
+{
+	return tracer.is_running.load(std::memory_order_relaxed);
+}
+
+int64_t TRACING_GetTimestampUs()
+{
+	return GetTicksUs() - tracer.start_us;
+}
+
+void TRACING_AddEvent(const char* name, const int64_t start_us, const int64_t end_us)
+{
+	if (!TRACING_IsRunning()) {
+		return;
+	}
+
+	auto& buffer = get_thread_buffer();
+
+	const auto index       = buffer.num_events.load(std::memory_order_relaxed);
+	const auto chunk_index = index / EventsPerChunk;
+
+	if (chunk_index >= MaxChunksPerThread) {
+		buffer.num_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	auto chunk = buffer.chunks[chunk_index].load(std::memory_order_relaxed);
+	if (!chunk) {
+		chunk = new TraceChunk();
+		buffer.chunks[chunk_index].store(chunk, std::memory_order_release);
+	}
+
+	chunk->events[index % EventsPerChunk] = {name, start_us, end_us};
+
+	buffer.num_events.store(index + 1, std::memory_order_release);
+}
+
+#endif // C_TRACING
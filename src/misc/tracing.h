@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_TRACING_H
+#define DOSBOX_TRACING_H
+
+#include "dosbox_config.h"
+
+#include <cstdint>
+#include <string>
+
+// Timeline of the emulator subsystems, written in the Chrome trace event
+// format that chrome://tracing and the Perfetto UI can open.
+//
+// Trace points mark the scope of the work they time, e.g.:
+//
+//   void VGA_DrawPart(...)
+//   {
+//           TRACE_SCOPE("VGA_DrawPart");
+//           ...
+//
+// They're compiled out unless the build enables tracing (C_TRACING), and
+// only record while a trace is running (see the '--trace' command line
+// argument). Every thread records into its own buffers without taking any
+// locks; the buffers are written out to the trace file when it stops.
+//
+// Trace point and thread names must be string literals, as only the pointers
+// are recorded.
+
+#if C_TRACING
+
+void TRACING_Start(const std::string& path);
+void TRACING_Stop();
+
+// Names the calling thread in the trace
+void TRACING_SetThreadName(const char* name);
+
+void TRACING_AddEvent(const char* name, const int64_t start_us,
+                      const int64_t end_us);
+
+bool TRACING_IsRunning();
+
+int64_t TRACING_GetTimestampUs();
+
+class TraceScope {
+public:
+	explicit TraceScope(const char* _name)
+	        : name(_name),
+	          start_us(TRACING_IsRunning() ? TRACING_GetTimestampUs() : -1)
+	{}
+
+	~TraceScope()
+	{
+		if (start_us >= 0) {
+			TRACING_AddEvent(name, start_us, TRACING_GetTimestampUs());
+		}
+	}
+
+	TraceScope(const TraceScope&)            = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	const char* name = nullptr;
+	int64_t start_us = -1;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b)       TRACE_CONCAT_INNER(a, b)
+
+#define TRACE_SCOPE(name) \
+	const TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+
+#define TRACE_THREAD_NAME(name) TRACING_SetThreadName(name)
+
+#else
+
+#define TRACE_SCOPE(name)
+#define TRACE_THREAD_NAME(name)
+
+#endif // C_TRACING
+
+#endif // DOSBOX_TRACING_H
@@ -114,6 +114,25 @@ static void init_ethernet_config_settings(SectionProp& section)
 	                       "default). The format is the same as for TCP port forwards.");
 
 	pstring->SetEnabledOptions({"SLIRP"});
+
+	pbool = section.AddBool("tx_coalescing", WhenIdle, false);
+	pbool->SetOptionHelp(
+	        "SLIRP",
+	        "Batch the frames the DOS network driver sends back-to-back (disabled by\n"
+	        "default). Frames started while the previous one is still being sent are\n"
+	        "passed on together with it, and completed with a single interrupt, instead\n"
+	        "of forcing the previous frame out early. This can speed up bulk transfers\n"
+	        "with drivers that don't wait for the transmit-complete interrupt.");
+
+	pbool->SetEnabledOptions({"SLIRP"});
+
+	pint = section.AddInt("receive_queue_size", WhenIdle, 256);
+	pint->SetMinMax(16, 4096);
+	pint->SetOptionHelp("SLIRP",
+	                    "Number of received frames held for the NE2000 card until it picks them up\n"
+	                    "(256 by default). Frames arriving while the queue is full are dropped.");
+
+	pint->SetEnabledOptions({"SLIRP"});
 }
 
 void ETHERNET_Init()
@@ -6,8 +6,10 @@
 
 #include "dosbox.h"
 
+#include <cstdint>
 #include <functional>
 #include <string>
+#include <vector>
 
 #include "config/config.h"
 #include "dosbox_config.h"
@@ -50,6 +52,20 @@ public:
 	 */
 	virtual void SendPacket(const uint8_t *packet, int size) = 0;
 
+	/** Sends several packets through the connection in one go.
+	 * This behaves like calling SendPacket for each packet in order, but
+	 * lets the backend hand them over as a single batch.
+	 * The packets are consumed; the vector is left empty.
+	 * @param packets The Ethernet frames to send, oldest first
+	 */
+	virtual void SendPackets(std::vector<std::vector<uint8_t>>& packets)
+	{
+		for (const auto& packet : packets) {
+			SendPacket(packet.data(), static_cast<int>(packet.size()));
+		}
+		packets.clear();
+	}
+
 	/** Gets all pending packets from the connection.
 	 * This function passes each pending packet to the callback function.
 	 * The callback provides a pointer to the bytes of an Ethernet frame,
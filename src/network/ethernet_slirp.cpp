@@ -2,8 +2,10 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <chrono>
 #include <map>
 #include <stdexcept>
+#include <thread>
 
 #if defined(BSD)
 #include <sys/socket.h> // AF_INET
@@ -15,6 +17,7 @@
 #include "ethernet_slirp.h"
 #include "hardware/timer.h"
 #include "config/setup.h"
+#include "misc/support.h"
 #include "utils/string_utils.h"
 
 /**
@@ -28,6 +31,13 @@ constexpr const char* libslirp_dynlib_file = "libslirp.dylib";
 constexpr const char* libslirp_dynlib_file = "libslirp.so.0";
 #endif
 
+// Frames the guest can send ahead of the network thread
+constexpr size_t SentQueueSize = 256;
+
+// Upper bound of each poll, so frames sent by the guest are fed to libslirp
+// within about a millisecond (as with the timer tick that used to drive it)
+constexpr uint32_t MaxPollWaitMs = 1;
+
 namespace LibSlirp
 {
 /**
@@ -190,6 +200,17 @@ SlirpEthernetConnection::SlirpEthernetConnection()
 
 SlirpEthernetConnection::~SlirpEthernetConnection()
 {
+	if (thread.joinable()) {
+		should_exit = true;
+		thread.join();
+	}
+
+	if (num_dropped_sent_frames || num_dropped_received_frames) {
+		LOG_WARNING("SLIRP: Dropped %llu sent and %llu received frames as the queues were full",
+		            static_cast<unsigned long long>(num_dropped_sent_frames),
+		            static_cast<unsigned long long>(num_dropped_received_frames));
+	}
+
 	if (slirp)
 		LibSlirp::slirp_cleanup(slirp);
 }
@@ -266,6 +287,14 @@ bool SlirpEthernetConnection::Initialize(Section *dosbox_config)
 		ClearPortForwards(is_udp, forwarded_udp_ports);
 		forwarded_udp_ports = SetupPortForwards(is_udp, section->GetString("udp_port_forwards"));
 
+		sent_frames.Resize(SentQueueSize);
+		received_frames.Resize(
+		        static_cast<size_t>(section->GetInt("receive_queue_size")));
+
+		// From here on only the network thread calls into libslirp
+		thread = std::thread(&SlirpEthernetConnection::Run, this);
+		set_thread_name(thread, "dosbox:slirp");
+
 		LOG_MSG("SLIRP: Successfully initialized");
 		return true;
 	} else {
@@ -417,19 +446,42 @@ void SlirpEthernetConnection::SendPacket(const uint8_t *packet, int len)
 		            len, GetMTU());
 		return;
 	}
-	LibSlirp::slirp_input(slirp, packet, len);
+	if (!sent_frames.NonblockingEnqueue(std::vector<uint8_t>(packet, packet + len))) {
+		++num_dropped_sent_frames;
+	}
+}
+
+void SlirpEthernetConnection::SendPackets(std::vector<std::vector<uint8_t>>& packets)
+{
+	std::erase_if(packets, [this](const std::vector<uint8_t>& packet) {
+		const auto len = static_cast<int>(packet.size());
+		if (len > GetMTU()) {
+			LOG_WARNING("SLIRP: refusing to send packet with length %d exceeding MTU %d",
+			            len, GetMTU());
+		}
+		return len <= 0 || len > GetMTU();
+	});
+	if (packets.empty()) {
+		return;
+	}
+
+	// Queue the whole batch at once; the network thread is woken up once
+	sent_frames.NonblockingBulkEnqueue(packets);
+
+	num_dropped_sent_frames += packets.size();
+	packets.clear();
 }
 
 void SlirpEthernetConnection::GetPackets(std::function<int(const uint8_t *, int)> callback)
 {
-	get_packet_callback = callback;
-	uint32_t timeout_ms = 0;
-	PollsClear();
-	PollsAddRegistered();
-	LibSlirp::slirp_pollfds_fill(slirp, &timeout_ms, db_slirp_add_poll, this);
-	const bool poll_failed = !PollsPoll(timeout_ms);
-	LibSlirp::slirp_pollfds_poll(slirp, poll_failed, db_slirp_get_revents, this);
-	TimersRun();
+	// We're the only consumer, so a non-empty queue never blocks
+	while (!received_frames.IsEmpty()) {
+		const auto frame = received_frames.Dequeue();
+		if (!frame) {
+			break;
+		}
+		callback(frame->data(), check_cast<int>(frame->size()));
+	}
 }
 
 int SlirpEthernetConnection::ReceivePacket(const uint8_t *packet, int len)
@@ -442,7 +494,44 @@ int SlirpEthernetConnection::ReceivePacket(const uint8_t *packet, int len)
 		            len, GetMRU());
 		return -1;
 	}
-	return get_packet_callback(packet, len);
+	if (!received_frames.NonblockingEnqueue(std::vector<uint8_t>(packet, packet + len))) {
+		++num_dropped_received_frames;
+	}
+	return len;
+}
+
+void SlirpEthernetConnection::FeedSentPackets()
+{
+	// We're the only consumer, so a non-empty queue never blocks
+	while (!sent_frames.IsEmpty()) {
+		const auto frame = sent_frames.Dequeue();
+		if (!frame) {
+			break;
+		}
+		LibSlirp::slirp_input(slirp, frame->data(), check_cast<int>(frame->size()));
+	}
+}
+
+void SlirpEthernetConnection::Run()
+{
+	while (!should_exit) {
+		FeedSentPackets();
+
+		uint32_t timeout_ms = MaxPollWaitMs;
+		PollsClear();
+		PollsAddRegistered();
+		LibSlirp::slirp_pollfds_fill(slirp, &timeout_ms, db_slirp_add_poll, this);
+
+		bool poll_failed = true;
+		if (num_polled_fds > 0) {
+			poll_failed = !PollsPoll(timeout_ms);
+		} else {
+			// Nothing to wait on; don't spin
+			std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+		}
+		LibSlirp::slirp_pollfds_poll(slirp, poll_failed, db_slirp_get_revents, this);
+		TimersRun();
+	}
 }
 
 struct slirp_timer *SlirpEthernetConnection::TimerNew(SlirpTimerCb cb, void *cb_opaque)
@@ -528,6 +617,7 @@ void SlirpEthernetConnection::PollsAddRegistered()
 void SlirpEthernetConnection::PollsClear()
 {
 	polls.clear();
+	num_polled_fds = 0;
 }
 
 int SlirpEthernetConnection::PollAdd(const int fd, int slirp_events)
@@ -546,6 +636,7 @@ int SlirpEthernetConnection::PollAdd(const int fd, int slirp_events)
 	new_poll.fd = fd;
 	new_poll.events = real_events;
 	polls.push_back(new_poll);
+	++num_polled_fds;
 	return (check_cast<int>(polls.size() - 1));
 }
 
@@ -584,6 +675,7 @@ void SlirpEthernetConnection::PollsClear()
 	FD_ZERO(&readfds);
 	FD_ZERO(&writefds);
 	FD_ZERO(&exceptfds);
+	num_polled_fds = 0;
 }
 
 int SlirpEthernetConnection::PollAdd(int fd, int slirp_events)
@@ -612,6 +704,7 @@ int SlirpEthernetConnection::PollAdd(int fd, int slirp_events)
 	if (slirp_events & SLIRP_POLL_PRI)
 		FD_SET(fd, &exceptfds);
 #endif
+	++num_polled_fds;
 	return fd;
 }
 
@@ -6,14 +6,17 @@
 
 #include "dosbox.h"
 
+#include <atomic>
 #include <map>
 #include <deque>
+#include <thread>
 #include <vector>
 
 #include <slirp/libslirp.h>
 
 #include "dosbox_config.h"
 #include "ethernet.h"
+#include "utils/spsc_queue.h"
 
 /*
  * libslirp really wants a poll() API, so we'll use that when we're
@@ -44,6 +47,13 @@ struct slirp_timer {
  * This backend uses a virtual Ethernet device. Only TCP, UDP and some ICMP
  * work over this interface. This is because libslirp terminates guest
  * connections during routing and passes them to sockets created in the host.
+ *
+ * libslirp is driven by a network thread that polls the host sockets and
+ * runs the timers, so traffic keeps flowing while the emulation is busy.
+ * Only that thread calls into libslirp once it is running. Frames are
+ * handed between it and the emulation through lock-free queues: sent
+ * frames are fed to libslirp by the thread, and received frames wait for
+ * GetPackets() to pass them to the card on the next tick.
  */
 class SlirpEthernetConnection : public EthernetConnection {
 public:
@@ -57,11 +67,22 @@ public:
 
 	bool Initialize(Section* config) override;
 	void SendPacket(const uint8_t* packet, int len) override;
+	void SendPackets(std::vector<std::vector<uint8_t>>& packets) override;
 	void GetPackets(std::function<int(const uint8_t*, int)> callback) override;
 
 	/* Called by libslirp when it has a packet for us */
 	int ReceivePacket(const uint8_t* packet, int len);
 
+	// Frames lost because the queue towards the other thread was full
+	uint64_t GetNumDroppedSentFrames() const
+	{
+		return num_dropped_sent_frames;
+	}
+	uint64_t GetNumDroppedReceivedFrames() const
+	{
+		return num_dropped_received_frames;
+	}
+
 	// Used in callbacks to bounds-check packet lengths
 	int GetMTU() const
 	{
@@ -84,6 +105,10 @@ public:
 	void PollUnregister(int fd);
 
 private:
+	/* Polls the host sockets and runs the timers until stopped */
+	void Run();
+	void FeedSentPackets();
+
 	/* Runs and clears all the timers*/
 	void TimersRun();
 	void TimersClear();
@@ -101,15 +126,23 @@ private:
 	SlirpCb slirp_callbacks = {};  /*!< Callbacks used by libslirp */
 	std::deque<struct slirp_timer *> timers = {}; /*!< Stored timers */
 
-	/** The GetPacket callback
-	 * When libslirp has a new packet for us it calls ReceivePacket,
-	 * but the EthernetConnection interface requires users to poll
-	 * for new packets using GetPackets. We temporarily store the
-	 * callback from GetPackets here for ReceivePacket.
-	 * This might seem racy, but keep in mind we control when
-	 * libslirp sends us packets via our polling system.
+	/** Frames from the guest waiting to be fed to libslirp, and frames
+	 * from libslirp waiting to be picked up by GetPackets.
+	 * The emulation thread produces the former and consumes the latter,
+	 * the network thread the other way round.
 	 */
-	std::function<int(const uint8_t *, int)> get_packet_callback = nullptr;
+	SpscQueue<std::vector<uint8_t>> sent_frames{1};
+	SpscQueue<std::vector<uint8_t>> received_frames{1};
+
+	std::atomic<uint64_t> num_dropped_sent_frames     = 0;
+	std::atomic<uint64_t> num_dropped_received_frames = 0;
+
+	std::atomic<bool> should_exit = false;
+	std::thread thread            = {};
+
+	/* Number of descriptors in the current poll, used to sleep instead
+	 * of spinning when there are none */
+	int num_polled_fds = 0;
 
 	std::deque<int> registered_fds = {}; /*!< File descriptors to watch */
 
@@ -17,34 +17,58 @@ std::unique_ptr<FileReader> FileReader::GetFileReader(const std::string& filenam
 
 FileReader::FileReader(std::string filename)
         : filename(std::move(filename)),
-          cursor(0)
+          cursor(0),
+          contents(),
+          contents_change_count()
 {}
 
-std::optional<std::string> FileReader::Read()
+bool FileReader::LoadContents()
 {
+	contents.clear();
+	contents_change_count.reset();
+
 	uint16_t entry = {};
 	if (!DOS_OpenFile(filename.c_str(), (DOS_NOT_INHERIT | OPEN_READ), &entry)) {
+		return false;
+	}
+
+	constexpr uint16_t ChunkSize = 0x8000;
+	uint8_t buffer[ChunkSize];
+	while (true) {
+		uint16_t bytes_to_read = ChunkSize;
+		if (!DOS_ReadFile(entry, buffer, &bytes_to_read) || bytes_to_read == 0) {
+			break;
+		}
+		contents.append(reinterpret_cast<const char*>(buffer), bytes_to_read);
+	}
+	DOS_CloseFile(entry);
+
+	// Taken after reading, so our own open does not count as a change
+	contents_change_count = DOS_GetFileChangeCount();
+	return true;
+}
+
+std::optional<std::string> FileReader::Read()
+{
+	// Reading the file a byte at a time for every line was slow; keep it
+	// in memory for as long as nothing could have written to it. Batch
+	// files changing themselves still work, as the cursor is kept.
+	if (contents_change_count != DOS_GetFileChangeCount() && !LoadContents()) {
 		return {};
 	}
-	DOS_SeekFile(entry, &cursor, DOS_SEEK_SET);
 
-	uint8_t data           = 0;
-	uint16_t bytes_to_read = 1;
-	std::string line       = {};
+	std::string line = {};
+	char data        = 0;
 
-	while (data != '\n') {
+	while (data != '\n' && cursor < contents.size()) {
+		data = contents[cursor++];
 		// We should also stop at EOF (0x1a) character
-		if (!DOS_ReadFile(entry, &data, &bytes_to_read) ||
-		    bytes_to_read == 0 || data == 0x1a) {
+		if (data == 0x1a) {
 			break;
 		}
-		line += static_cast<char>(data);
+		line += data;
 	}
 
-	cursor = 0;
-	DOS_SeekFile(entry, &cursor, DOS_SEEK_CUR);
-	DOS_CloseFile(entry);
-
 	if (line.empty()) {
 		return {};
 	}
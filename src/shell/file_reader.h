@@ -25,8 +25,14 @@ public:
 private:
 	explicit FileReader(std::string filename);
 
+	bool LoadContents();
+
 	std::string filename;
 	uint32_t cursor;
+
+	// The whole file, re-read once it might have changed
+	std::string contents;
+	std::optional<uint32_t> contents_change_count;
 };
 
 #endif
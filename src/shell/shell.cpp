@@ -481,12 +481,14 @@ void DOS_Shell::Run()
 	}
 
 	is_shell_running = true;
+	DOSBOX_LogStartupTime("Shell started");
 
 	while (!exit_cmd_called && !DOSBOX_IsShutdownRequested()) {
 
 		if (!batchfiles.empty()) {
 			RunBatchFile();
 		} else {
+			DOSBOX_LogStartupTime("Prompt reached");
 			if (echo) {
 				ShowPrompt();
 			}
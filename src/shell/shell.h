@@ -7,10 +7,12 @@
 
 #include "dosbox.h"
 
+#include <array>
 #include <memory>
 #include <optional>
 #include <stack>
 #include <string>
+#include <unordered_map>
 
 #include "cpu/callback.h"
 #include "dos/programs.h"
@@ -94,11 +96,22 @@ private:
 	[[nodiscard]] std::string ReadCommand();
 	[[nodiscard]] std::string SubstituteEnvironmentVariables(std::string_view command);
 	[[nodiscard]] std::string ResolvePath(std::string_view name) const;
+	[[nodiscard]] std::string ResolvePathUncached(
+	        std::string_view name, const std::optional<std::string>& path) const;
 
 	bool ExecuteConfigChange(const char* const cmd_in, const std::string args);
 
 	friend class AutoexecEditor;
 
+	// ResolvePath results, keyed by the PATH, current directory, and
+	// command name; valid while no file or drive has come or gone
+	struct ResolvedPaths {
+		std::unordered_map<std::string, std::string> paths = {};
+		std::array<std::weak_ptr<DOS_Drive>, DOS_DRIVES> drives = {};
+		uint32_t directory_change_count = 0;
+	};
+	mutable ResolvedPaths resolved_paths = {};
+
 	std::shared_ptr<ShellHistory> history  = {};
 	std::stack<BatchFile> batchfiles       = {};
 	uint16_t input_handle                  = STDIN;
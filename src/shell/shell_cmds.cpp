@@ -25,6 +25,7 @@
 #include "dos/dos.h"
 #include "dos/drives.h"
 #include "dos/programs/more_output.h"
+#include "hardware/input/input_replay.h"
 #include "hardware/pic.h"
 #include "hardware/timer.h"
 #include "ints/bios.h"
@@ -1220,13 +1221,15 @@ void DOS_Shell::CMD_COPY(char* args)
 						//In concat mode. Open the target and seek to the eof
 						if (!oldsource.concat || (DOS_OpenFile(nameTarget,OPEN_READWRITE,&targetHandle) &&
 					        	                  DOS_SeekFile(targetHandle,&dummy,DOS_SEEK_END))) {
-							// Copy
+							// Copy, on the host if both files are there
 							static uint8_t buffer[0x8000]; // static, otherwise stack overflow possible.
 							uint16_t toread = 0x8000;
-							do {
-								DOS_ReadFile(sourceHandle, buffer, &toread);
-								DOS_WriteFile(targetHandle, buffer, &toread);
-							} while (toread == 0x8000);
+							if (!DOS_CopyFileOnHost(sourceHandle, targetHandle)) {
+								do {
+									DOS_ReadFile(sourceHandle, buffer, &toread);
+									DOS_WriteFile(targetHandle, buffer, &toread);
+								} while (toread == 0x8000);
+							}
 							if (!oldsource.concat) {
 								DOS_GetFileDate(
 								        sourceHandle,
@@ -1738,7 +1741,7 @@ void DOS_Shell::CMD_DATE(char *args)
 	}
 	if (scan_and_remove_cmdline_switch(args, "H")) {
 		// synchronize date with host
-		const time_t curtime = time(nullptr);
+		const time_t curtime = REPLAY_GetHostTimeMs() / 1000;
 		struct tm datetime;
 		cross::localtime_r(&curtime, &datetime);
 		reg_ah = 0x2b; // set system date
@@ -1838,7 +1841,7 @@ void DOS_Shell::CMD_TIME(char* args)
 	}
 	if (scan_and_remove_cmdline_switch(args, "H")) {
 		// synchronize time with host
-		const time_t curtime = time(nullptr);
+		const time_t curtime = REPLAY_GetHostTimeMs() / 1000;
 		struct tm datetime;
 		cross::localtime_r(&curtime, &datetime);
 		reg_ah = 0x2d; // set system time
@@ -2467,6 +2470,10 @@ void DOS_Shell::CMD_MOVE(char* args)
 			uint8_t buffer[buffer_capacity];
 			uint16_t bytes_requested = buffer_capacity;
 			bool success             = true;
+
+			// Copied on the host if both files are there, which leaves
+			// nothing for the loop below to read
+			DOS_CopyFileOnHost(source_handle, dest_handle);
 			do {
 				if (!DOS_ReadFile(source_handle, buffer, &bytes_requested)) {
 					WriteOut(MSG_Get("SHELL_READ_ERROR"),
@@ -531,13 +531,68 @@ bool DOS_Shell::ExecuteProgram(std::string_view name, std::string_view args)
 	return false;
 }
 
+// Checks whether the drives are the ones the paths were resolved on
+static bool are_same_drives(const std::array<std::weak_ptr<DOS_Drive>, DOS_DRIVES>& drives)
+{
+	for (size_t i = 0; i < DOS_DRIVES; ++i) {
+		const auto& drive = Drives[i];
+		if (drives[i].owner_before(drive) || drive.owner_before(drives[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
 std::string DOS_Shell::ResolvePath(const std::string_view name) const
+{
+	const auto path = psp->GetEnvironmentValue("PATH");
+
+	// Relative PATH entries depend on the current directory of their
+	// drive; only the default drive's one is part of the key
+	const auto current_drive = DOS_GetDefaultDrive();
+	char current_dir[DOS_PATHLENGTH] = {};
+	DOS_GetCurrentDir(current_drive + 1, current_dir);
+
+	std::string key = path.value_or("");
+	key += '\n';
+	key += static_cast<char>('A' + current_drive);
+	key += current_dir;
+	key += '\n';
+	key += name;
+
+	auto& cache = resolved_paths;
+	if (cache.directory_change_count != DOS_GetDirectoryChangeCount() ||
+	    !are_same_drives(cache.drives)) {
+		cache.paths.clear();
+		cache.directory_change_count = DOS_GetDirectoryChangeCount();
+		std::copy(Drives.begin(), Drives.end(), cache.drives.begin());
+	}
+
+	if (const auto it = cache.paths.find(key); it != cache.paths.end()) {
+		return it->second;
+	}
+
+	// Enough for any batch file; keeps it from growing without bounds
+	constexpr size_t MaxResolvedPaths = 256;
+	if (cache.paths.size() >= MaxResolvedPaths) {
+		cache.paths.clear();
+	}
+
+	auto resolved = ResolvePathUncached(name, path);
+
+	// Probing never creates files, so the counter is still current
+	cache.paths.emplace(std::move(key), resolved);
+	return resolved;
+}
+
+std::string DOS_Shell::ResolvePathUncached(const std::string_view name,
+                                           const std::optional<std::string>& path) const
 {
 	static constexpr auto Extensions = {".COM", ".EXE", ".BAT"};
 
 	std::vector<std::string> prefixes = {""};
 
-	if (const auto path = psp->GetEnvironmentValue("PATH")) {
+	if (path) {
 		auto path_directories = split_with_empties(*path, ';');
 
 		remove_empties(path_directories);
@@ -196,6 +196,17 @@ NativeIoResult read_native_file(const NativeFileHandle handle, uint8_t* buffer,
 NativeIoResult write_native_file(const NativeFileHandle handle, const uint8_t* buffer,
                                  const int64_t num_bytes_requested);
 
+// Copies the rest of the source file from its current position to the current
+// position of the destination; both positions are advanced by the number of
+// bytes copied. Uses the host's in-kernel copy where available.
+NativeIoResult copy_native_file(const NativeFileHandle source,
+                                const NativeFileHandle dest);
+
+// The portable part of copy_native_file(): copies with large reads and
+// writes, for hosts and files the in-kernel copy doesn't support
+NativeIoResult copy_native_file_buffered(const NativeFileHandle source,
+                                         const NativeFileHandle dest);
+
 int64_t seek_native_file(const NativeFileHandle handle, const int64_t offset,
                          const NativeSeek type);
 
@@ -216,4 +227,41 @@ bool delete_native_file(const std_fs::path& path);
 bool delete_file(const std_fs::path& path);
 bool remove_dir(const std_fs::path& path);
 
+// Read-only memory mapping of a whole file. The mapped pages are backed by the
+// file and shared by every process mapping it, so large read-only assets
+// loaded this way don't add to the private memory of each instance.
+class ReadOnlyFileMapping {
+public:
+	// Check IsValid() to see if the file could be mapped; empty files
+	// can't be
+	explicit ReadOnlyFileMapping(const std_fs::path& path);
+	~ReadOnlyFileMapping();
+
+	ReadOnlyFileMapping(const ReadOnlyFileMapping&)            = delete;
+	ReadOnlyFileMapping& operator=(const ReadOnlyFileMapping&) = delete;
+
+	bool IsValid() const
+	{
+		return data != nullptr;
+	}
+
+	const uint8_t* GetData() const
+	{
+		return data;
+	}
+
+	size_t GetSize() const
+	{
+		return size;
+	}
+
+private:
+	const uint8_t* data = nullptr;
+	size_t size         = 0;
+
+#if defined(WIN32)
+	HANDLE mapping = nullptr;
+#endif
+};
+
 #endif
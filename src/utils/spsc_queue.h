@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_SPSC_QUEUE_H
+#define DOSBOX_SPSC_QUEUE_H
+
+/*  SPSC (Single-Producer/Single-Consumer) Queue
+ *  --------------------------------------------
+ *  A fixed-size ring buffer with the same interface and blocking semantics
+ *  as RWQueue, for queues that have exactly one producer thread and one
+ *  consumer thread.
+ *
+ *  Enqueueing and dequeueing never take a lock: the producer only writes the
+ *  tail counter and the consumer only writes the head counter. A thread only
+ *  goes to sleep (on an atomic wait) when the queue is full or empty; the
+ *  other side wakes it up after it moved items in or out.
+ *
+ *  Differences from RWQueue:
+ *
+ *  - Only one thread may call the enqueue methods and only one (other)
+ *    thread may call the dequeue methods and Clear().
+ *
+ *  - Resize() discards the queued items and must not be called while the
+ *    producer or consumer are active.
+ *
+ *  - The enqueue methods can be limited to filling only part of the
+ *    capacity with SetFillLimit(), which (unlike Resize()) can be changed
+ *    by any thread at any time.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+template <typename T>
+class SpscQueue {
+private:
+	// Avoid false sharing between the producer and consumer counters
+	static constexpr size_t CacheLineSize = 64;
+
+	std::vector<T> buffer = {};
+	size_t capacity       = 0;
+
+	// Number of items the enqueue methods fill the queue up to
+	std::atomic<size_t> fill_limit = 0;
+
+	// Monotonic counters of the dequeued and enqueued items, and the
+	// matching buffer positions only used by the consumer and producer,
+	// respectively
+	alignas(CacheLineSize) std::atomic<size_t> head = 0;
+	size_t head_index                               = 0;
+
+	alignas(CacheLineSize) std::atomic<size_t> tail = 0;
+	size_t tail_index                               = 0;
+
+	// A sleeping consumer publishes the tail it waits for, and a sleeping
+	// producer the head it waits for (0 if not waiting). The other side
+	// only bumps 'events' to wake it up once that counter is reached, so
+	// a bulk dequeue sleeps until enough items are available instead of
+	// waking up after every single item.
+	alignas(CacheLineSize) std::atomic<size_t> wake_at_tail = 0;
+	std::atomic<size_t> wake_at_head                        = 0;
+	std::atomic<uint32_t> events                            = 0;
+
+	std::atomic<bool> is_running = true;
+
+	void Wake();
+	void PublishHead(const size_t new_head);
+	void PublishTail(const size_t new_tail);
+
+	template <typename Predicate>
+	void WaitUntil(std::atomic<size_t>& wake_at, const size_t target,
+	               Predicate predicate);
+
+public:
+	SpscQueue()                                        = delete;
+	SpscQueue(const SpscQueue<T>& other)               = delete;
+	SpscQueue<T>& operator=(const SpscQueue<T>& other) = delete;
+
+	SpscQueue(size_t queue_capacity);
+	void Resize(size_t queue_capacity);
+
+	// non-blocking call
+	bool IsEmpty();
+
+	// non-blocking call
+	bool IsFull();
+
+	// non-blocking call
+	bool IsRunning();
+
+	// non-blocking call
+	size_t Size();
+
+	// non-blocking call
+	void Start();
+
+	// non-blocking call
+	void Stop();
+
+	// non-blocking call; consumer side only
+	void Clear();
+
+	// non-blocking call
+	size_t MaxCapacity();
+
+	// non-blocking call; clamped to 1..MaxCapacity(). Resize() resets the
+	// limit to the full capacity.
+	void SetFillLimit(size_t num_items);
+
+	// non-blocking call
+	size_t GetFillLimit();
+
+	// non-blocking call
+	float GetPercentFull();
+
+	// The enqueue and dequeue methods behave exactly like their RWQueue
+	// counterparts; see 'rwqueue.h' for the details.
+
+	bool Enqueue(T&& item);
+	bool NonblockingEnqueue(T&& item);
+
+	std::optional<T> Dequeue();
+
+	size_t BulkEnqueue(std::vector<T>& from_source, const size_t num_requested);
+	size_t BulkEnqueue(std::vector<T>& from_source);
+
+	size_t NonblockingBulkEnqueue(std::vector<T>& from_source,
+	                              const size_t num_requested);
+	size_t NonblockingBulkEnqueue(std::vector<T>& from_source);
+
+	size_t BulkDequeue(std::vector<T>& into_target, const size_t num_requested);
+	size_t BulkDequeue(T* const into_target, const size_t num_requested);
+
+private:
+	// Move items between the ring and a linear range, handling the
+	// wrap-around at the end of the ring
+	void MoveIn(T* const source, const size_t num_items);
+	void MoveOut(T* const target, const size_t num_items);
+
+	void Advance(size_t& index, const size_t num_items) const;
+
+	// Free space up to the fill limit for the given tail
+	size_t GetRoom(const size_t curr_tail);
+};
+
+#endif
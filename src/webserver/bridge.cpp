@@ -26,6 +26,7 @@ void DebugBridge::ExecuteCommand(DebugCommand& cmd, const uint32_t timeout_ms)
 	std::unique_lock<std::mutex> lock(mtx);
 	cmd.done = false;
 	queue.push_back(&cmd);
+	has_requests.store(true, std::memory_order_relaxed);
 	bool success = cv.wait_for(lock,
 	                           std::chrono::milliseconds(timeout_ms),
 	                           [&] { return cmd.done; });
@@ -39,9 +40,10 @@ void DebugBridge::ExecuteCommand(DebugCommand& cmd, const uint32_t timeout_ms)
 	}
 }
 
-void DebugBridge::ProcessRequests()
+void DebugBridge::ProcessQueue()
 {
 	std::lock_guard<std::mutex> lock(mtx);
+	has_requests.store(false, std::memory_order_relaxed);
 	if (queue.empty()) {
 		return;
 	}
@@ -4,6 +4,7 @@
 #ifndef DOSBOX_WEBSERVER_BRIDGE_H
 #define DOSBOX_WEBSERVER_BRIDGE_H
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
@@ -31,14 +32,26 @@ public:
 	// Called by the web server thread
 	void ExecuteCommand(DebugCommand& cmd, const uint32_t timeout_ms);
 
-	// Called by the main thread running the CPU emulation
-	void ProcessRequests();
+	// Called by the main thread running the CPU emulation; this is in the
+	// emulation loop, so only a flag is checked unless a request waits
+	void ProcessRequests()
+	{
+		if (has_requests.load(std::memory_order_relaxed)) {
+			ProcessQueue();
+		}
+	}
 
 private:
+	void ProcessQueue();
+
 	std::mutex mtx                   = {};
 	std::condition_variable cv       = {};
 	std::vector<DebugCommand*> queue = {};
 
+	// Set with the queue filled; a late glimpse only delays the requests
+	// to the next loop iteration, the mutex orders the queue itself
+	std::atomic<bool> has_requests = false;
+
 	DebugBridge(const DebugBridge&)            = delete;
 	DebugBridge& operator=(const DebugBridge&) = delete;
 	DebugBridge()                              = default;
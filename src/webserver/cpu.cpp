@@ -9,6 +9,8 @@
 #include "libs/http/http.h"
 #include "libs/json/json.h"
 
+#include "dosbox.h"
+#include "cpu/paging.h"
 #include "cpu/registers.h"
 
 using json = nlohmann::json;
@@ -35,9 +37,47 @@ void Registers::load()
 	this->gs    = SegValue(SegNames::gs);
 }
 
+void TlbStats::load()
+{
+	const auto& stats = PAGING_GetTlbStats();
+
+	this->misses          = stats.misses;
+	this->links           = stats.links;
+	this->flushes         = stats.flushes;
+	this->flushed_entries = stats.flushed_entries;
+	this->cr3_reloads     = stats.cr3_reloads;
+	this->link_overflows  = stats.link_overflows;
+
+	this->page_faults        = stats.page_faults;
+	this->nested_page_faults = stats.nested_page_faults;
+}
+
+void CyclesStats::load()
+{
+	const auto stats = DOSBOX_GetCyclesAutoAdjustStats();
+
+	this->auto_adjust           = stats.is_enabled;
+	this->cycles                = stats.cycles;
+	this->increase_damping_left = stats.increase_damping_left;
+	this->increases             = stats.increases;
+	this->decreases             = stats.decreases;
+	this->holds                 = stats.holds;
+
+	this->history.clear();
+	for (const auto& a : stats.history) {
+		this->history.push_back({a.time_ms,
+		                         a.cycles_before,
+		                         a.cycles_target,
+		                         a.cycles_after,
+		                         a.headroom_percent});
+	}
+}
+
 void CpuInfoCommand::Execute()
 {
 	regs.load();
+	tlb.load();
+	cycles.load();
 	LOG_DEBUG("API: CpuInfoCommand()");
 }
 
@@ -48,6 +88,8 @@ void CpuInfoCommand::Get(const httplib::Request&, httplib::Response& res)
 
 	json j;
 	j["registers"] = cmd.regs;
+	j["tlb"]       = cmd.tlb;
+	j["cycles"]    = cmd.cycles;
 	send_json(res, j);
 }
 
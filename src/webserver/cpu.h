@@ -6,6 +6,8 @@
 
 #include "bridge.h"
 
+#include <vector>
+
 #include "libs/http/http.h"
 #include "libs/json/json.h"
 
@@ -36,13 +38,58 @@ struct Registers {
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Registers, eax, ebx, ecx, edx, esi, edi, esp,
                                    ebp, eip, flags, cs, ds, es, ss, fs, gs)
 
+struct TlbStats {
+	uint64_t misses          = 0;
+	uint64_t links           = 0;
+	uint64_t flushes         = 0;
+	uint64_t flushed_entries = 0;
+	uint64_t cr3_reloads     = 0;
+	uint64_t link_overflows  = 0;
+
+	uint64_t page_faults        = 0;
+	uint64_t nested_page_faults = 0;
+
+	void load();
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(TlbStats, misses, links, flushes,
+                                   flushed_entries, cr3_reloads, link_overflows,
+                                   page_faults, nested_page_faults)
+
+struct CyclesHistoryEntry {
+	int64_t time_ms      = 0;
+	int cycles_before    = 0;
+	int cycles_target    = 0;
+	int cycles_after     = 0;
+	int headroom_percent = 0;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(CyclesHistoryEntry, time_ms, cycles_before,
+                                   cycles_target, cycles_after, headroom_percent)
+
+struct CyclesStats {
+	bool auto_adjust          = false;
+	int cycles                = 0;
+	int increase_damping_left = 0;
+	uint64_t increases        = 0;
+	uint64_t decreases        = 0;
+	uint64_t holds            = 0;
+
+	std::vector<CyclesHistoryEntry> history = {};
+
+	void load();
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(CyclesStats, auto_adjust, cycles,
+                                   increase_damping_left, increases, decreases,
+                                   holds, history)
+
 class CpuInfoCommand : public DebugCommand {
 public:
 	void Execute() override;
 	static void Get(const httplib::Request&, httplib::Response&);
 
 private:
-	Registers regs = {};
+	Registers regs     = {};
+	TlbStats tlb       = {};
+	CyclesStats cycles = {};
 };
 
 } // namespace Webserver
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "io.h"
+#include "bridge.h"
+#include "webserver.h"
+
+#include "libs/http/http.h"
+#include "libs/json/json.h"
+
+using json = nlohmann::json;
+
+namespace Webserver {
+
+void PortProfileCommand::Execute()
+{
+	enabled = IO_IsProfilerEnabled();
+	ports   = IO_GetPortProfile();
+	LOG_DEBUG("API: PortProfileCommand()");
+}
+
+void PortProfileCommand::Get(const httplib::Request&, httplib::Response& res)
+{
+	PortProfileCommand cmd;
+	cmd.WaitForCompletion();
+
+	json j;
+	j["enabled"] = cmd.enabled;
+	j["ports"]   = json::array();
+	for (const auto& p : cmd.ports) {
+		j["ports"].push_back({{"port", p.port},
+		                      {"reads", p.reads},
+		                      {"writes", p.writes},
+		                      {"read_ns", p.read_ns},
+		                      {"write_ns", p.write_ns}});
+	}
+	send_json(res, j);
+}
+
+void SetPortProfilerCommand::Execute()
+{
+	IO_SetProfilerEnabled(enabled);
+	LOG_DEBUG("API: SetPortProfilerCommand(%d)", enabled);
+}
+
+void SetPortProfilerCommand::Put(const httplib::Request& req, httplib::Response& res)
+{
+	auto j = json::parse(req.body);
+
+	SetPortProfilerCommand cmd(j.at("enabled").get<bool>());
+	cmd.WaitForCompletion();
+
+	json response;
+	response["enabled"] = cmd.enabled;
+	send_json(res, response);
+}
+
+} // namespace Webserver
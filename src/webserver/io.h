@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_WEBSERVER_IO_H
+#define DOSBOX_WEBSERVER_IO_H
+
+#include "bridge.h"
+
+#include <vector>
+
+#include "libs/http/http.h"
+
+#include "hardware/port.h"
+
+namespace Webserver {
+
+// Read the port access profile
+class PortProfileCommand : public DebugCommand {
+public:
+	void Execute() override;
+	static void Get(const httplib::Request& req, httplib::Response& res);
+
+private:
+	bool enabled                     = false;
+	std::vector<IoPortProfile> ports = {};
+};
+
+// Start or stop the port access profiler
+class SetPortProfilerCommand : public DebugCommand {
+public:
+	SetPortProfilerCommand(const bool enabled) : enabled(enabled) {}
+
+	void Execute() override;
+	static void Put(const httplib::Request& req, httplib::Response& res);
+
+private:
+	bool enabled = false;
+};
+
+} // namespace Webserver
+
+#endif // DOSBOX_WEBSERVER_IO_H
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "latency.h"
+#include "bridge.h"
+#include "webserver.h"
+
+#include "libs/http/http.h"
+#include "libs/json/json.h"
+
+using json = nlohmann::json;
+
+namespace Webserver {
+
+void InputLatencyCommand::Execute()
+{
+	enabled = INPUT_LATENCY_IsEnabled();
+	stats   = INPUT_LATENCY_GetStats();
+	LOG_DEBUG("API: InputLatencyCommand()");
+}
+
+static json percentiles_to_json(const InputLatencyPercentiles& p)
+{
+	return {{"minUs", p.min_us},
+	        {"medianUs", p.median_us},
+	        {"p90Us", p.p90_us},
+	        {"p99Us", p.p99_us},
+	        {"maxUs", p.max_us}};
+}
+
+void InputLatencyCommand::Get(const httplib::Request&, httplib::Response& res)
+{
+	InputLatencyCommand cmd;
+	cmd.WaitForCompletion();
+
+	json j;
+	j["enabled"]    = cmd.enabled;
+	j["numSamples"] = cmd.stats.num_samples;
+	j["toFrame"]    = percentiles_to_json(cmd.stats.to_frame);
+	j["toPresent"]  = percentiles_to_json(cmd.stats.to_present);
+	send_json(res, j);
+}
+
+void SetInputLatencyCommand::Execute()
+{
+	INPUT_LATENCY_SetEnabled(enabled);
+	LOG_DEBUG("API: SetInputLatencyCommand(%d)", enabled);
+}
+
+void SetInputLatencyCommand::Put(const httplib::Request& req, httplib::Response& res)
+{
+	auto j = json::parse(req.body);
+
+	SetInputLatencyCommand cmd(j.at("enabled").get<bool>());
+	cmd.WaitForCompletion();
+
+	json response;
+	response["enabled"] = cmd.enabled;
+	send_json(res, response);
+}
+
+} // namespace Webserver
@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_WEBSERVER_LATENCY_H
+#define DOSBOX_WEBSERVER_LATENCY_H
+
+#include "bridge.h"
+
+#include "libs/http/http.h"
+
+#include "gui/input_latency.h"
+
+namespace Webserver {
+
+// Read the input latency distribution
+class InputLatencyCommand : public DebugCommand {
+public:
+	void Execute() override;
+	static void Get(const httplib::Request& req, httplib::Response& res);
+
+private:
+	bool enabled            = false;
+	InputLatencyStats stats = {};
+};
+
+// Start or stop the input latency measurement
+class SetInputLatencyCommand : public DebugCommand {
+public:
+	SetInputLatencyCommand(const bool enabled) : enabled(enabled) {}
+
+	void Execute() override;
+	static void Put(const httplib::Request& req, httplib::Response& res);
+
+private:
+	bool enabled = false;
+};
+
+} // namespace Webserver
+
+#endif // DOSBOX_WEBSERVER_LATENCY_H
@@ -5,6 +5,9 @@
 #include "webserver/bridge.h"
 #include "webserver/webserver.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "libs/base64/base64.h"
 #include "libs/http/http.h"
 #include "libs/json/json.h"
@@ -12,6 +15,7 @@
 
 #include "cpu/registers.h"
 #include "dos/dos_memory.h"
+#include "hardware/video/vga.h"
 
 using json = nlohmann::json;
 using httplib::Request, httplib::Response;
@@ -87,12 +91,14 @@ void ReadMemCommand::Execute()
 	MEM_BlockRead(effective_addr, memory.data(), len);
 }
 
+// 128 MiB per request ought to be enough for everyone.
+// This limit just prevents bad things when accidentally requesting an
+// unreasonably large size.
+constexpr uint32_t MaxReadLen = 128 * 1024 * 1024;
+
 void ReadMemCommand::Get(const Request& req, Response& res)
 {
-	// 128 MiB per request ought to be enough for everyone.
-	// This limit just prevents bad things when accidentally requesting an
-	// unreasonably large size.
-	auto num_bytes = num_param<uint32_t>(req, Source::Path, "len", 1, 128 * 1024 * 1024);
+	auto num_bytes = num_param<uint32_t>(req, Source::Path, "len", 1, MaxReadLen);
 	Segment segment;
 	uint32_t offset;
 	parse_mem_addr(req, segment, offset);
@@ -115,6 +121,103 @@ void ReadMemCommand::Get(const Request& req, Response& res)
 	}
 }
 
+void ReadMemRangesCommand::Execute()
+{
+	regs.load();
+	LOG_DEBUG("API: ReadMemRangesCommand(%zu ranges)", ranges.size());
+
+	size_t total_len = 0;
+	for (const auto& range : ranges) {
+		total_len += range.len;
+	}
+	memory.resize(total_len);
+
+	auto data = memory.data();
+	for (auto& range : ranges) {
+		if (range.is_video_memory) {
+			range.effective_addr = range.offset;
+
+			// Past the end of the video memory reads as zeros
+			std::fill_n(data, range.len, '\0');
+			if (range.offset < vga.vmemsize) {
+				const auto len = std::min(range.len,
+				                          vga.vmemsize - range.offset);
+				std::memcpy(data, vga.mem.linear + range.offset, len);
+			}
+		} else {
+			range.effective_addr = base_segment_to_offset(range.base) +
+			                       range.offset;
+			MEM_BlockRead(range.effective_addr, data, range.len);
+		}
+		data += range.len;
+	}
+}
+
+static ReadMemRangesCommand::Range parse_mem_range(const json& j)
+{
+	ReadMemRangesCommand::Range range = {};
+
+	range.offset = j.at("offset").get<uint32_t>();
+	range.len    = j.at("len").get<uint32_t>();
+
+	if (j.contains("vram")) {
+		range.is_video_memory = j.at("vram").get<bool>();
+	}
+	if (j.contains("segment") && !range.is_video_memory) {
+		const auto& segment = j.at("segment");
+		if (segment.is_string()) {
+			range.base = str_to_base_segment(segment.get<std::string>());
+			if (range.base == Segment::None) {
+				throw std::invalid_argument("Invalid segment: " +
+				                            segment.get<std::string>());
+			}
+		} else {
+			range.offset += PhysicalMake(segment.get<uint16_t>(), 0);
+		}
+	}
+	return range;
+}
+
+void ReadMemRangesCommand::Post(const Request& req, Response& res)
+{
+	const auto j = json::parse(req.body);
+
+	std::vector<Range> ranges = {};
+	uint64_t total_len        = 0;
+	for (const auto& range_json : j.at("ranges")) {
+		ranges.push_back(parse_mem_range(range_json));
+		total_len += ranges.back().len;
+	}
+	if (ranges.empty() || total_len > MaxReadLen) {
+		res.status = httplib::StatusCode::BadRequest_400;
+		send_json(res, {{"error", "Invalid total length"}});
+		return;
+	}
+
+	ReadMemRangesCommand cmd(std::move(ranges));
+	cmd.WaitForCompletion();
+
+	if (req.get_header_value("accept").starts_with(TypeJson)) {
+		json response;
+		response["registers"] = cmd.regs;
+		response["ranges"]    = json::array();
+
+		size_t pos = 0;
+		for (const auto& range : cmd.ranges) {
+			const auto data = std::string_view(cmd.memory).substr(pos,
+			                                                      range.len);
+			response["ranges"].push_back(
+			        {{"addr", range.effective_addr},
+			         {"vram", range.is_video_memory},
+			         {"data", base64::to_base64(data)}});
+			pos += range.len;
+		}
+		send_json(res, response);
+	} else {
+		res.set_content(std::move(cmd.memory), TypeBinary);
+	}
+}
+
 void WriteMemCommand::Execute()
 {
 	effective_addr = base_segment_to_offset(base) + offset;
@@ -176,4 +279,32 @@ void WriteMemCommand::Put(const httplib::Request& req, httplib::Response& res)
 	send_json(res, j);
 }
 
+void HostMemoryCommand::Execute()
+{
+	usage          = HOST_MEMORY_GetUsage();
+	resident_bytes = HOST_MEMORY_GetResidentSize();
+	LOG_DEBUG("API: HostMemoryCommand()");
+}
+
+void HostMemoryCommand::Get(const httplib::Request&, httplib::Response& res)
+{
+	HostMemoryCommand cmd;
+	cmd.WaitForCompletion();
+
+	json j;
+	j["subsystems"] = json::array();
+
+	size_t total_bytes = 0;
+	for (const auto& u : cmd.usage) {
+		j["subsystems"].push_back({{"name", u.subsystem}, {"bytes", u.num_bytes}});
+		total_bytes += u.num_bytes;
+	}
+	j["totalBytes"] = total_bytes;
+
+	// Not every host reports it
+	j["residentBytes"] = cmd.resident_bytes ? json(*cmd.resident_bytes)
+	                                        : json(nullptr);
+	send_json(res, j);
+}
+
 } // namespace Webserver
@@ -8,9 +8,13 @@
 #include "cpu.h"
 
 #include <limits>
+#include <optional>
+#include <vector>
 
 #include "libs/http/http.h"
 
+#include "misc/host_memory.h"
+
 namespace Webserver {
 
 enum class Segment { None, CS, SS, DS, ES, FS, GS };
@@ -39,6 +43,38 @@ private:
 	Registers regs          = {};
 };
 
+// Reads several ranges in one go, so they are consistent with each other
+// (e.g. the whole conventional memory and the video memory of one frame)
+class ReadMemRangesCommand : public DebugCommand {
+public:
+	struct Range {
+		// Request
+		Segment base    = {};
+		uint32_t offset = {};
+		uint32_t len    = {};
+		// Read the raw video memory at 'offset' instead of the address
+		// space, which bypasses the planar read logic and the latches
+		bool is_video_memory = false;
+
+		// Response
+		uint32_t effective_addr = {};
+	};
+
+	ReadMemRangesCommand(std::vector<Range> ranges)
+	        : ranges(std::move(ranges))
+	{}
+
+	void Execute() override;
+	static void Post(const httplib::Request& req, httplib::Response& res);
+
+private:
+	std::vector<Range> ranges = {};
+
+	// Response, the ranges back to back
+	std::string memory = {};
+	Registers regs     = {};
+};
+
 class WriteMemCommand : public DebugCommand {
 public:
 	WriteMemCommand(const Segment base, const uint32_t offset,
@@ -67,6 +103,18 @@ private:
 	std::string conflict_data = {};
 };
 
+// Reads the host memory used by the emulator's subsystems; the sizes are
+// taken on the main thread as the subsystems may be resized or destroyed
+class HostMemoryCommand : public DebugCommand {
+public:
+	void Execute() override;
+	static void Get(const httplib::Request& req, httplib::Response& res);
+
+private:
+	std::vector<HostMemoryUsage> usage   = {};
+	std::optional<size_t> resident_bytes = {};
+};
+
 } // namespace Webserver
 
 #endif //DOSBOX_WEBSERVER_MEMORY_H
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "mixer.h"
+#include "bridge.h"
+#include "webserver.h"
+
+#include "libs/http/http.h"
+#include "libs/json/json.h"
+
+using json = nlohmann::json;
+
+namespace Webserver {
+
+void MixerStatsCommand::Execute()
+{
+	stats = MIXER_GetStats();
+	LOG_DEBUG("API: MixerStatsCommand()");
+}
+
+json mixer_stats_to_json(const MixerStats& s)
+{
+	json j;
+	j["sampleRateHz"]           = s.sample_rate_hz;
+	j["blocksize"]              = s.blocksize;
+	j["prebufferMs"]            = s.prebuffer_ms;
+	j["outputQueuePercentFull"] = s.output_queue_percent_full;
+	j["outputUnderruns"]        = s.output_underruns;
+	j["captureOverruns"]        = s.capture_overruns;
+	j["numBlocks"]              = s.num_blocks;
+	j["mixUs"]                  = s.mix_us;
+	j["maxMixUs"]               = s.max_mix_us;
+	j["channels"]               = json::array();
+
+	for (const auto& c : s.channels) {
+		json channel = {{"name", c.name},
+		                {"sampleRateHz", c.sample_rate_hz},
+		                {"underruns", c.underruns},
+		                {"awakeMs", c.awake_ms},
+		                {"mixUs", c.mix_us},
+		                {"resampleUs", c.resample_us}};
+
+		// Only channels fed through a queue report its fill level
+		channel["queuePercentFull"] = c.queue_percent_full < 0.0f
+		                                    ? json(nullptr)
+		                                    : json(c.queue_percent_full);
+
+		// Only channels that render ahead of the mixer report latency
+		channel["latencyMs"] = c.latency_ms < 0.0f ? json(nullptr)
+		                                           : json(c.latency_ms);
+
+		j["channels"].push_back(channel);
+	}
+	return j;
+}
+
+void MixerStatsCommand::Get(const httplib::Request&, httplib::Response& res)
+{
+	MixerStatsCommand cmd;
+	cmd.WaitForCompletion();
+
+	send_json(res, mixer_stats_to_json(cmd.stats));
+}
+
+} // namespace Webserver
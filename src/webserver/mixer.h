@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_WEBSERVER_MIXER_H
+#define DOSBOX_WEBSERVER_MIXER_H
+
+#include "bridge.h"
+
+#include "libs/http/http.h"
+#include "libs/json/json.h"
+
+#include "audio/mixer.h"
+
+namespace Webserver {
+
+// Read the mixer's buffering and timing statistics
+class MixerStatsCommand : public DebugCommand {
+public:
+	void Execute() override;
+	static void Get(const httplib::Request& req, httplib::Response& res);
+
+private:
+	MixerStats stats = {};
+};
+
+nlohmann::json mixer_stats_to_json(const MixerStats& stats);
+
+} // namespace Webserver
+
+#endif // DOSBOX_WEBSERVER_MIXER_H
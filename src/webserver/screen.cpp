@@ -0,0 +1,311 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "screen.h"
+#include "webserver.h"
+
+#include <cstring>
+
+#include "libs/http/http.h"
+#include "libs/json/json.h"
+
+#include "dos/dos.h"
+#include "hardware/memory.h"
+#include "ints/int10.h"
+#include "misc/image_decoder.h"
+#include "misc/unicode.h"
+#include "utils/checks.h"
+#include "utils/string_utils.h"
+
+CHECK_NARROWING();
+
+using json = nlohmann::json;
+
+namespace Webserver {
+
+// Snapshots keep being taken for this long after the last request
+constexpr auto ActiveTimeout = std::chrono::seconds(5);
+
+// How long a request waits for a fresh snapshot after snapshots haven't
+// been taken for a while; the current one is returned if none arrives in
+// time (e.g. while the emulation is paused)
+constexpr auto FreshSnapshotTimeout = std::chrono::milliseconds(250);
+
+constexpr int DefaultWaitTimeoutMs = 10'000;
+constexpr int MaxWaitTimeoutMs     = 60'000;
+
+// Larger text modes are certainly not set up through the BIOS
+constexpr int MaxTextColumns = 256;
+constexpr int MaxTextRows    = 128;
+
+ScreenSnapshots& ScreenSnapshots::Instance()
+{
+	static ScreenSnapshots instance;
+	return instance;
+}
+
+bool ScreenSnapshots::IsActive() const
+{
+	if (num_waiting.load(std::memory_order_relaxed) > 0) {
+		return true;
+	}
+	const auto last_request = Clock::time_point(Clock::duration(
+	        last_request_ticks.load(std::memory_order_relaxed)));
+
+	return Clock::now() - last_request < ActiveTimeout;
+}
+
+static void read_text_screen(TextScreen& screen)
+{
+	screen.is_text_mode = (CurMode->type == M_TEXT);
+	if (!screen.is_text_mode) {
+		return;
+	}
+
+	screen.columns = INT10_GetTextColumns();
+	screen.rows    = INT10_GetTextRows();
+	if (screen.columns <= 0 || screen.columns > MaxTextColumns ||
+	    screen.rows <= 0 || screen.rows > MaxTextRows) {
+		screen.is_text_mode = false;
+		return;
+	}
+
+	const auto page = real_readb(BIOSMEM_SEG, BIOSMEM_CURRENT_PAGE);
+
+	const auto cursor_pos = real_readw(BIOSMEM_SEG,
+	                                   check_cast<uint16_t>(BIOSMEM_CURSOR_POS +
+	                                                        page * 2));
+	screen.cursor_column = cursor_pos & 0xff;
+	screen.cursor_row    = cursor_pos >> 8;
+
+	screen.code_page = dos.loaded_codepage;
+
+	const auto page_start = CurMode->pstart +
+	                        real_readw(BIOSMEM_SEG, BIOSMEM_CURRENT_START);
+
+	screen.cells.resize(static_cast<size_t>(screen.columns * screen.rows * 2));
+	MEM_BlockRead(page_start, screen.cells.data(), screen.cells.size());
+}
+
+static bool is_same_screen(const TextScreen& a, const TextScreen& b)
+{
+	return a.is_text_mode == b.is_text_mode && a.columns == b.columns &&
+	       a.rows == b.rows && a.cursor_column == b.cursor_column &&
+	       a.cursor_row == b.cursor_row && a.code_page == b.code_page &&
+	       a.cells == b.cells;
+}
+
+void ScreenSnapshots::AddText()
+{
+	TextScreen next = {};
+	read_text_screen(next);
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		if (text.sequence != 0 && is_same_screen(next, text)) {
+			return;
+		}
+	}
+
+	// Converted on the main thread, as the code page can change here
+	for (auto row = 0; row < next.rows; ++row) {
+		std::string chars = {};
+		for (auto column = 0; column < next.columns; ++column) {
+			const auto index = (row * next.columns + column) * 2;
+			chars += static_cast<char>(next.cells[static_cast<size_t>(index)]);
+		}
+		next.lines.push_back(
+		        dos_to_utf8(chars, DosStringConvertMode::ScreenCodesOnly));
+	}
+
+	std::lock_guard<std::mutex> lock(mtx);
+	next.sequence = text.sequence + 1;
+	text          = std::move(next);
+}
+
+void ScreenSnapshots::AddFramebuffer(const RenderedImage& image)
+{
+	Framebuffer next = {};
+
+	next.width              = image.params.width;
+	next.height             = image.params.height;
+	next.pixel_aspect_ratio = image.params.pixel_aspect_ratio.ToDouble();
+
+	const auto pitch = static_cast<size_t>(next.width) * 4;
+	next.pixels.resize(pitch * static_cast<size_t>(next.height));
+
+	row_buf.resize(static_cast<size_t>(next.width));
+
+	constexpr auto RowSkipCount   = 0;
+	constexpr auto PixelSkipCount = 0;
+
+	ImageDecoder decoder(image, RowSkipCount, PixelSkipCount);
+
+	for (auto y = 0; y < next.height; ++y) {
+		decoder.GetNextRowAsBgrx32Pixels(row_buf.begin());
+		std::memcpy(next.pixels.data() + static_cast<size_t>(y) * pitch,
+		            row_buf.data(),
+		            pitch);
+	}
+
+	std::lock_guard<std::mutex> lock(mtx);
+	if (framebuffer.sequence != 0 && next.width == framebuffer.width &&
+	    next.height == framebuffer.height && next.pixels == framebuffer.pixels) {
+		return;
+	}
+	next.sequence = framebuffer.sequence + 1;
+	framebuffer   = std::move(next);
+}
+
+void ScreenSnapshots::AddFrame(const RenderedImage& image, const bool is_dirty)
+{
+	if (!IsActive()) {
+		has_skipped_frames = true;
+		return;
+	}
+
+	AddText();
+
+	if (is_dirty || has_skipped_frames) {
+		AddFramebuffer(image);
+	}
+	has_skipped_frames = false;
+
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		++num_frames;
+	}
+	cv.notify_all();
+}
+
+void ScreenSnapshots::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		is_stopping = true;
+	}
+	cv.notify_all();
+}
+
+void ScreenSnapshots::WaitForSnapshot(const httplib::Request& req,
+                                      const uint64_t& sequence)
+{
+	const auto was_active = IsActive();
+
+	last_request_ticks.store(Clock::now().time_since_epoch().count(),
+	                         std::memory_order_relaxed);
+
+	const auto has_since = req.has_param("since");
+
+	const auto since = has_since
+	                         ? num_param<uint64_t>(req, Source::Param, "since")
+	                         : 0;
+
+	const auto timeout_ms = req.has_param("timeout")
+	                              ? num_param<int>(req,
+	                                               Source::Param,
+	                                               "timeout",
+	                                               0,
+	                                               MaxWaitTimeoutMs)
+	                              : DefaultWaitTimeoutMs;
+
+	++num_waiting;
+
+	std::unique_lock<std::mutex> lock(mtx);
+	if (has_since) {
+		cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&] {
+			return is_stopping || (sequence != 0 && sequence != since);
+		});
+	} else if (!was_active || sequence == 0) {
+		const auto first_frame = num_frames;
+		cv.wait_for(lock, FreshSnapshotTimeout, [&] {
+			return is_stopping || num_frames != first_frame;
+		});
+	}
+
+	--num_waiting;
+}
+
+static std::string to_hex(const uint8_t* data, const size_t size)
+{
+	constexpr auto Digits = "0123456789ABCDEF";
+
+	std::string hex = {};
+	hex.reserve(size * 2);
+	for (size_t i = 0; i < size; ++i) {
+		hex += Digits[data[i] >> 4];
+		hex += Digits[data[i] & 0xf];
+	}
+	return hex;
+}
+
+void ScreenSnapshots::GetText(const httplib::Request& req, httplib::Response& res)
+{
+	auto& snapshots = Instance();
+	snapshots.WaitForSnapshot(req, snapshots.text.sequence);
+
+	TextScreen screen = {};
+	{
+		std::lock_guard<std::mutex> lock(snapshots.mtx);
+		screen = snapshots.text;
+	}
+
+	json j;
+	j["sequence"]   = screen.sequence;
+	j["isTextMode"] = screen.is_text_mode;
+	if (screen.is_text_mode) {
+		j["columns"]  = screen.columns;
+		j["rows"]     = screen.rows;
+		j["cursor"]   = {{"column", screen.cursor_column},
+		                 {"row", screen.cursor_row}};
+		j["codePage"] = screen.code_page;
+		j["lines"]    = screen.lines;
+
+		// One hexadecimal byte per character
+		auto attributes = json::array();
+		for (auto row = 0; row < screen.rows; ++row) {
+			std::vector<uint8_t> row_attributes = {};
+			for (auto column = 0; column < screen.columns; ++column) {
+				const auto index = (row * screen.columns + column) * 2 + 1;
+				row_attributes.push_back(
+				        screen.cells[static_cast<size_t>(index)]);
+			}
+			attributes.push_back(
+			        to_hex(row_attributes.data(), row_attributes.size()));
+		}
+		j["attributes"] = attributes;
+	}
+	send_json(res, j);
+}
+
+void ScreenSnapshots::GetFramebuffer(const httplib::Request& req,
+                                     httplib::Response& res)
+{
+	auto& snapshots = Instance();
+	snapshots.WaitForSnapshot(req, snapshots.framebuffer.sequence);
+
+	Framebuffer frame = {};
+	{
+		std::lock_guard<std::mutex> lock(snapshots.mtx);
+		frame = snapshots.framebuffer;
+	}
+
+	if (frame.sequence == 0) {
+		json j;
+		j["error"] = "No frame has been rendered yet";
+		res.status = httplib::StatusCode::ServiceUnavailable_503;
+		send_json(res, j);
+		return;
+	}
+
+	res.set_header("X-Sequence", std::to_string(frame.sequence));
+	res.set_header("X-Width", std::to_string(frame.width));
+	res.set_header("X-Height", std::to_string(frame.height));
+	res.set_header("X-Pixel-Format", "BGRX32");
+	res.set_header("X-Pixel-Aspect-Ratio",
+	               format_str("%.6f", frame.pixel_aspect_ratio));
+
+	res.set_content(std::string(frame.pixels.begin(), frame.pixels.end()),
+	                TypeBinary);
+}
+
+} // namespace Webserver
@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_WEBSERVER_SCREEN_H
+#define DOSBOX_WEBSERVER_SCREEN_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "libs/http/http.h"
+
+#include "misc/rendered_image.h"
+
+namespace Webserver {
+
+// The active text page as the BIOS sees it
+struct TextScreen {
+	uint64_t sequence = 0;
+
+	bool is_text_mode = false;
+
+	int columns = 0;
+	int rows    = 0;
+
+	int cursor_column = 0;
+	int cursor_row    = 0;
+
+	uint16_t code_page = 0;
+
+	// Character and attribute byte pairs, row by row
+	std::vector<uint8_t> cells = {};
+
+	// The characters of each row converted to UTF-8 through the code page
+	std::vector<std::string> lines = {};
+};
+
+// The last rendered frame before scaling and shaders
+struct Framebuffer {
+	uint64_t sequence = 0;
+
+	int width  = 0;
+	int height = 0;
+
+	double pixel_aspect_ratio = 1.0;
+
+	// 32-bit BGRX pixels, row by row without padding
+	std::vector<uint8_t> pixels = {};
+};
+
+// Keeps snapshots of the text screen and the last rendered frame for test
+// automation. They are taken on the main thread at the end of every frame,
+// but only while clients have asked for them recently, so the emulation
+// doesn't pay for them otherwise. Each snapshot's sequence number only
+// changes when its content does, so clients can wait for the next change.
+class ScreenSnapshots {
+public:
+	static ScreenSnapshots& Instance();
+
+	bool IsActive() const;
+
+	// Called by the main thread at the end of every rendered frame
+	void AddFrame(const RenderedImage& image, const bool is_dirty);
+
+	// Wakes up the waiting clients
+	void Stop();
+
+	// Called by the web server threads
+	static void GetText(const httplib::Request& req, httplib::Response& res);
+	static void GetFramebuffer(const httplib::Request& req,
+	                           httplib::Response& res);
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	void AddText();
+	void AddFramebuffer(const RenderedImage& image);
+
+	// Waits for a snapshot with a sequence other than 'since', or for a
+	// fresh one if no sequence is given
+	void WaitForSnapshot(const httplib::Request& req,
+	                     const uint64_t& sequence);
+
+	std::mutex mtx             = {};
+	std::condition_variable cv = {};
+	TextScreen text            = {};
+	Framebuffer framebuffer    = {};
+	uint64_t num_frames        = 0;
+	bool is_stopping           = false;
+
+	std::atomic<int> num_waiting               = 0;
+	std::atomic<Clock::rep> last_request_ticks = 0;
+
+	// Only accessed by the main thread; a skipped frame might have
+	// changed the screen without the next one being marked dirty
+	bool has_skipped_frames       = true;
+	std::vector<uint32_t> row_buf = {};
+
+	ScreenSnapshots(const ScreenSnapshots&)            = delete;
+	ScreenSnapshots& operator=(const ScreenSnapshots&) = delete;
+	ScreenSnapshots()                                  = default;
+};
+
+} // namespace Webserver
+
+#endif // DOSBOX_WEBSERVER_SCREEN_H
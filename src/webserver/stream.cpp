@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "stream.h"
+#include "mixer.h"
+#include "webserver.h"
+
+#include <string_view>
+
+#include "libs/http/http.h"
+#include "libs/json/json.h"
+
+#include "dosbox.h"
+#include "hardware/timer.h"
+#include "hardware/video/vga.h"
+
+using json = nlohmann::json;
+
+namespace Webserver {
+
+constexpr int DefaultIntervalMs = 100;
+constexpr int MinIntervalMs     = 10;
+constexpr int MaxIntervalMs     = 60'000;
+
+// Without new snapshots (e.g. while the emulation is paused) a comment is
+// sent this often; that is also how a closed connection is noticed
+constexpr auto KeepAliveInterval = std::chrono::seconds(1);
+
+EventStream& EventStream::Instance()
+{
+	static EventStream instance;
+	return instance;
+}
+
+void EventStream::Tick()
+{
+	if (!has_subscribers.load(std::memory_order_relaxed)) {
+		return;
+	}
+	const auto now = Clock::now();
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		const auto min_interval = std::chrono::milliseconds(min_interval_ms);
+		if (now - snapshot_at < min_interval) {
+			return;
+		}
+	}
+
+	StreamSnapshot next = {};
+
+	next.uptime_ms = std::chrono::duration<double, std::milli>(
+	                         now - system_start_time)
+	                         .count();
+	next.ticks_done     = DOSBOX_GetTicksDone();
+	next.dos_refresh_hz = VGA_GetRefreshRate();
+	next.regs.load();
+	next.tlb.load();
+	next.mixer = MIXER_GetStats();
+
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		next.sequence = snapshot.sequence + 1;
+		snapshot      = std::move(next);
+		snapshot_at   = now;
+	}
+	cv.notify_all();
+}
+
+void EventStream::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		is_stopping = true;
+	}
+	cv.notify_all();
+}
+
+void EventStream::Subscribe(const int interval_ms)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	++intervals[interval_ms];
+	min_interval_ms = intervals.begin()->first;
+	has_subscribers = true;
+}
+
+void EventStream::Unsubscribe(const int interval_ms)
+{
+	std::lock_guard<std::mutex> lock(mtx);
+	const auto it = intervals.find(interval_ms);
+	if (it != intervals.end() && --it->second == 0) {
+		intervals.erase(it);
+	}
+	if (intervals.empty()) {
+		has_subscribers = false;
+	} else {
+		min_interval_ms = intervals.begin()->first;
+	}
+}
+
+EventStream::WaitResult EventStream::WaitForSnapshot(const uint64_t last_sequence,
+                                                     const Clock::time_point due,
+                                                     StreamSnapshot& out)
+{
+	std::unique_lock<std::mutex> lock(mtx);
+	const auto has_snapshot = cv.wait_for(lock, KeepAliveInterval, [&] {
+		return is_stopping ||
+		       (snapshot.sequence > last_sequence && snapshot_at >= due);
+	});
+	if (is_stopping) {
+		return WaitResult::Stopped;
+	}
+	if (!has_snapshot) {
+		return WaitResult::TimedOut;
+	}
+	out = snapshot;
+	return WaitResult::Snapshot;
+}
+
+static json snapshot_to_json(const StreamSnapshot& snapshot)
+{
+	json j;
+	j["sequence"]  = snapshot.sequence;
+	j["uptimeMs"]  = snapshot.uptime_ms;
+	j["ticksDone"] = snapshot.ticks_done;
+	j["frame"]     = {{"dosRefreshHz", snapshot.dos_refresh_hz}};
+	j["registers"] = snapshot.regs;
+	j["tlb"]       = snapshot.tlb;
+	j["mixer"]     = mixer_stats_to_json(snapshot.mixer);
+	return j;
+}
+
+void EventStream::Get(const httplib::Request& req, httplib::Response& res)
+{
+	const auto interval_ms = req.has_param("interval")
+	                               ? num_param<int>(req,
+	                                                Source::Param,
+	                                                "interval",
+	                                                MinIntervalMs,
+	                                                MaxIntervalMs)
+	                               : DefaultIntervalMs;
+
+	auto& stream = Instance();
+	stream.Subscribe(interval_ms);
+
+	auto provider = [&stream,
+	                 interval_ms,
+	                 last_sequence = uint64_t(0),
+	                 due = Clock::time_point()](size_t, httplib::DataSink& sink) mutable {
+		StreamSnapshot snapshot = {};
+		switch (stream.WaitForSnapshot(last_sequence, due, snapshot)) {
+		case WaitResult::Stopped: sink.done(); return true;
+		case WaitResult::TimedOut: {
+			constexpr std::string_view KeepAlive = ": keep-alive\n\n";
+			return sink.write(KeepAlive.data(), KeepAlive.size());
+		}
+		case WaitResult::Snapshot: break;
+		}
+		last_sequence = snapshot.sequence;
+		due = Clock::now() + std::chrono::milliseconds(interval_ms);
+
+		const auto event = "data: " + snapshot_to_json(snapshot).dump() + "\n\n";
+		return sink.write(event.data(), event.size());
+	};
+
+	res.set_header("Cache-Control", "no-cache");
+	res.set_chunked_content_provider("text/event-stream",
+	                                 std::move(provider),
+	                                 [&stream, interval_ms](bool) {
+		                                 stream.Unsubscribe(interval_ms);
+	                                 });
+}
+
+} // namespace Webserver
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_WEBSERVER_STREAM_H
+#define DOSBOX_WEBSERVER_STREAM_H
+
+#include "cpu.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+#include "libs/http/http.h"
+
+#include "audio/mixer.h"
+
+namespace Webserver {
+
+// State pushed to the subscribers, taken on the main thread
+struct StreamSnapshot {
+	uint64_t sequence     = 0;
+	double uptime_ms      = 0.0;
+	int64_t ticks_done    = 0;
+	double dos_refresh_hz = 0.0;
+	Registers regs        = {};
+	TlbStats tlb          = {};
+	MixerStats mixer      = {};
+};
+
+// Pushes the CPU state, the frame timing, and the mixer statistics to the
+// subscribed clients as server-sent events. The snapshot is taken at most
+// once per tick and only as often as the most demanding subscriber asks
+// for, so any number of clients cost a single round trip to the main
+// thread instead of one per poll.
+class EventStream {
+public:
+	static EventStream& Instance();
+
+	// Called by the main thread on every tick
+	void Tick();
+
+	// Wakes up the subscribers and ends their streams
+	void Stop();
+
+	// Called by a web server thread for each subscriber
+	static void Get(const httplib::Request& req, httplib::Response& res);
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	void Subscribe(const int interval_ms);
+	void Unsubscribe(const int interval_ms);
+
+	enum class WaitResult { Snapshot, TimedOut, Stopped };
+
+	// Waits for a snapshot newer than 'last_sequence' taken at or after
+	// 'due'
+	WaitResult WaitForSnapshot(const uint64_t last_sequence,
+	                           const Clock::time_point due,
+	                           StreamSnapshot& out);
+
+	std::mutex mtx                = {};
+	std::condition_variable cv    = {};
+	StreamSnapshot snapshot       = {};
+	Clock::time_point snapshot_at = {};
+	bool is_stopping              = false;
+
+	// Requested interval in milliseconds -> number of subscribers
+	std::map<int, int> intervals      = {};
+	std::atomic<int> min_interval_ms  = 0;
+	std::atomic<bool> has_subscribers = false;
+
+	EventStream(const EventStream&)            = delete;
+	EventStream& operator=(const EventStream&) = delete;
+	EventStream()                              = default;
+};
+
+} // namespace Webserver
+
+#endif // DOSBOX_WEBSERVER_STREAM_H
@@ -5,7 +5,12 @@
 #include "bridge.h"
 #include "cpu.h"
 #include "dos.h"
+#include "io.h"
+#include "latency.h"
 #include "memory.h"
+#include "mixer.h"
+#include "screen.h"
+#include "stream.h"
 
 #include <string>
 #include <thread>
@@ -15,8 +20,10 @@
 
 #include "config/config.h"
 #include "dosbox.h"
+#include "hardware/timer.h"
 #include "misc/cross.h"
 #include "misc/logging.h"
+#include "misc/metrics.h"
 #include "misc/support.h"
 
 using json = nlohmann::json;
@@ -56,9 +63,47 @@ static void setup_api_handlers()
 	server.Get("/api/memory/:segment/:offset/:len", ReadMemCommand::Get);
 	server.Put("/api/memory/:offset", WriteMemCommand::Put);
 	server.Put("/api/memory/:segment/:offset", WriteMemCommand::Put);
+	server.Post("/api/memory/read", ReadMemRangesCommand::Post);
 	server.Post("/api/memory/allocate", AllocMemoryCommand::Post);
 	server.Post("/api/memory/free", FreeMemoryCommand::Post);
+	server.Get("/api/memory/host", HostMemoryCommand::Get);
 	server.Get("/api/dos", DosInfoCommand::Get);
+	server.Get("/api/ports", PortProfileCommand::Get);
+	server.Put("/api/ports/profiler", SetPortProfilerCommand::Put);
+	server.Get("/api/mixer/stats", MixerStatsCommand::Get);
+	server.Get("/api/stream", EventStream::Get);
+	server.Get("/api/input-latency", InputLatencyCommand::Get);
+	server.Put("/api/input-latency/measurement", SetInputLatencyCommand::Put);
+
+	// The snapshots are taken at the end of every frame, so they're read
+	// without going through the emulation thread
+	server.Get("/api/screen/text", ScreenSnapshots::GetText);
+	server.Get("/api/screen/framebuffer", ScreenSnapshots::GetFramebuffer);
+
+	// The metrics are atomics, so they're read directly from the server
+	// thread without going through the emulation thread
+	server.Get("/metrics", [](const httplib::Request&, httplib::Response& res) {
+		res.set_content(METRICS_GetPrometheusText(),
+		                "text/plain; version=0.0.4");
+	});
+}
+
+static void tick_event_stream()
+{
+	EventStream::Instance().Tick();
+}
+
+static int metrics_log_interval_ms = 0;
+
+static void tick_metrics_log()
+{
+	static int elapsed_ms = 0;
+
+	// One tick is one emulated millisecond
+	if (++elapsed_ms >= metrics_log_interval_ms) {
+		elapsed_ms = 0;
+		METRICS_LogSummary();
+	}
 }
 
 static void run(std::string addr, int port)
@@ -110,6 +155,13 @@ static void init_config_settings(SectionProp& section)
 	auto bind_port = section.AddInt("webserver_port", OnlyAtStart, 8080);
 	bind_port->SetMinMax(1, 0xFFFF);
 	bind_port->SetHelp("TCP port to bind to.");
+
+	auto metrics_log = section.AddInt("metrics_log_interval", OnlyAtStart, 0);
+	metrics_log->SetMinMax(0, 3600);
+	metrics_log->SetHelp(
+	        "Log the performance counters and gauges every this many seconds of\n"
+	        "emulated time (0 by default, disabled). The full set of metrics is always\n"
+	        "available at the '/metrics' endpoint in the Prometheus text format.");
 }
 
 } // namespace Webserver
@@ -122,14 +174,35 @@ void WEBSERVER_Init()
 		auto port = section->GetInt("webserver_port");
 		std::thread thread(Webserver::run, addr, port);
 		thread.detach();
+
+		TIMER_AddTickHandler(Webserver::tick_event_stream);
+	}
+
+	constexpr auto MillisInSecond = 1000;
+
+	Webserver::metrics_log_interval_ms = section->GetInt("metrics_log_interval") *
+	                                     MillisInSecond;
+	if (Webserver::metrics_log_interval_ms > 0) {
+		TIMER_AddTickHandler(Webserver::tick_metrics_log);
 	}
 }
 
 void WEBSERVER_Destroy()
 {
+	TIMER_DelTickHandler(Webserver::tick_event_stream);
+	TIMER_DelTickHandler(Webserver::tick_metrics_log);
+
+	// The streams would keep their server threads busy otherwise
+	Webserver::EventStream::Instance().Stop();
+	Webserver::ScreenSnapshots::Instance().Stop();
 	Webserver::server.stop();
 }
 
+void WEBSERVER_AddFrame(const RenderedImage& image, const bool is_dirty)
+{
+	Webserver::ScreenSnapshots::Instance().AddFrame(image, is_dirty);
+}
+
 void WEBSERVER_AddConfigSection(const ConfigPtr& conf)
 {
 	assert(conf);
@@ -73,4 +73,10 @@ void WEBSERVER_Init();
 void WEBSERVER_Destroy();
 void WEBSERVER_AddConfigSection(const ConfigPtr& conf);
 
+struct RenderedImage;
+
+// Called by the renderer at the end of every frame for the screen snapshot
+// endpoints; returns right away unless they are being used
+void WEBSERVER_AddFrame(const RenderedImage& image, const bool is_dirty);
+
 #endif // DOSBOX_WEBSERVER_H
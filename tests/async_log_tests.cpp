@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "misc/async_log.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr int64_t ReportIntervalMs = 1000;
+
+TEST(LogRepeatFilter, PassesDistinctMessages)
+{
+	LogRepeatFilter filter(ReportIntervalMs);
+
+	for (const auto message : {"one", "two", "one"}) {
+		const auto result = filter.Check(message, 0);
+		EXPECT_FALSE(result.is_repeat);
+		EXPECT_EQ(result.num_repeats_to_report, 0);
+	}
+}
+
+TEST(LogRepeatFilter, ReportsRepeatsWhenTheRunEnds)
+{
+	LogRepeatFilter filter(ReportIntervalMs);
+
+	EXPECT_FALSE(filter.Check("port", 0).is_repeat);
+	for (auto i = 0; i < 3; ++i) {
+		const auto result = filter.Check("port", 10);
+		EXPECT_TRUE(result.is_repeat);
+		EXPECT_EQ(result.num_repeats_to_report, 0);
+	}
+
+	const auto result = filter.Check("other", 20);
+	EXPECT_FALSE(result.is_repeat);
+	EXPECT_EQ(result.num_repeats_to_report, 3);
+
+	EXPECT_EQ(filter.TakeNumRepeats(), 0);
+}
+
+TEST(LogRepeatFilter, ReportsLongRunsPeriodically)
+{
+	LogRepeatFilter filter(ReportIntervalMs);
+
+	filter.Check("queue full", 0);
+	filter.Check("queue full", 100);
+	filter.Check("queue full", 500);
+
+	const auto result = filter.Check("queue full", 100 + ReportIntervalMs);
+	EXPECT_TRUE(result.is_repeat);
+	EXPECT_EQ(result.num_repeats_to_report, 3);
+
+	// A new reporting period starts with the next repeat
+	EXPECT_EQ(filter.Check("queue full", 2000).num_repeats_to_report, 0);
+	EXPECT_EQ(filter.TakeNumRepeats(), 1);
+}
+
+} // namespace
@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gui/render/private/deinterlacer_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// Odd counts exercise the scalar tails after the vectorised parts
+constexpr int NumChunks[] = {1, 2, 3, 10, 11};
+
+std::mt19937_64 generator(1234);
+
+std::vector<uint64_t> random_chunks(const int num_chunks)
+{
+	std::vector<uint64_t> chunks(static_cast<size_t>(num_chunks));
+	for (auto& chunk : chunks) {
+		chunk = generator();
+	}
+	return chunks;
+}
+
+TEST(DeinterlacerKernels, ThresholdMatchesScalar)
+{
+	constexpr uint32_t BgColor = 0x080808;
+
+	for (const auto n : NumChunks) {
+		// Mostly background pixels, some with a set alpha component
+		std::vector<uint32_t> pixels(static_cast<size_t>(n) * 64);
+		for (auto& pixel : pixels) {
+			const auto r = generator();
+			pixel = (r & 1) ? BgColor : static_cast<uint32_t>(r >> 8);
+			if (r & 2) {
+				pixel |= 0xff000000;
+			}
+		}
+
+		std::vector<uint64_t> simd_mask(static_cast<size_t>(n));
+		std::vector<uint64_t> ref_mask(static_cast<size_t>(n));
+
+		threshold_row(pixels.data(), BgColor, simd_mask.data(), n);
+		scalar::threshold_row(pixels.data(), BgColor, ref_mask.data(), n);
+
+		EXPECT_EQ(simd_mask, ref_mask) << "num_chunks: " << n;
+	}
+}
+
+TEST(DeinterlacerKernels, HorizontalMorphologyMatchesScalar)
+{
+	for (const auto n : NumChunks) {
+		// The chunk before the row and the one after it are read as
+		// neighbours
+		const auto in = random_chunks(n + 2);
+
+		std::vector<uint64_t> simd_out(static_cast<size_t>(n));
+		std::vector<uint64_t> ref_out(static_cast<size_t>(n));
+
+		erode_row_horizontal(in.data() + 1, simd_out.data(), n);
+		scalar::erode_row_horizontal(in.data() + 1, ref_out.data(), n);
+		EXPECT_EQ(simd_out, ref_out) << "erode, num_chunks: " << n;
+
+		dilate_row_horizontal(in.data() + 1, simd_out.data(), n);
+		scalar::dilate_row_horizontal(in.data() + 1, ref_out.data(), n);
+		EXPECT_EQ(simd_out, ref_out) << "dilate, num_chunks: " << n;
+	}
+}
+
+TEST(DeinterlacerKernels, VerticalMorphologyMatchesScalar)
+{
+	for (const auto n : NumChunks) {
+		const auto prev = random_chunks(n);
+		const auto curr = random_chunks(n);
+		const auto next = random_chunks(n);
+
+		std::vector<uint64_t> simd_out(static_cast<size_t>(n));
+		std::vector<uint64_t> ref_out(static_cast<size_t>(n));
+
+		erode_row_vertical(prev.data(), curr.data(), next.data(), simd_out.data(), n);
+		scalar::erode_row_vertical(
+		        prev.data(), curr.data(), next.data(), ref_out.data(), n);
+		EXPECT_EQ(simd_out, ref_out) << "erode, num_chunks: " << n;
+
+		dilate_row_vertical(prev.data(), curr.data(), next.data(), simd_out.data(), n);
+		scalar::dilate_row_vertical(
+		        prev.data(), curr.data(), next.data(), ref_out.data(), n);
+		EXPECT_EQ(simd_out, ref_out) << "dilate, num_chunks: " << n;
+	}
+}
+
+TEST(DeinterlacerKernels, MaskedBleedMatchesScalar)
+{
+	// The scale factors of the deinterlacing strengths
+	constexpr int ScaleFactors[] = {153, 193, 204, 230, 234, 245, 256};
+
+	std::vector<uint32_t> in(64);
+	for (auto& pixel : in) {
+		pixel = static_cast<uint32_t>(generator());
+	}
+	in[0] = 0xffffffff;
+
+	const uint64_t masks[] = {0, 1, 0x8000'0000'0000'0000, ~uint64_t{0}, generator()};
+
+	for (const auto factor : ScaleFactors) {
+		for (const auto mask : masks) {
+			std::vector<uint32_t> simd_out(64);
+			for (auto& pixel : simd_out) {
+				pixel = static_cast<uint32_t>(generator()) & 0x0f0f0f0f;
+			}
+			auto ref_out = simd_out;
+
+			apply_masked_bleed_64(mask, in.data(), simd_out.data(), factor);
+			scalar::apply_masked_bleed_64(mask, in.data(), ref_out.data(), factor);
+
+			EXPECT_EQ(simd_out, ref_out) << "factor: " << factor;
+		}
+	}
+}
+
+} // namespace
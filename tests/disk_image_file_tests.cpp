@@ -0,0 +1,195 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "ints/disk_image_file.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+constexpr size_t DiskSize = 1024 * 1024 + 512;
+
+// A raw disk with a few non-zero sectors scattered over mostly zeros
+FILE* make_raw_disk(std::vector<uint8_t>& contents)
+{
+	contents.assign(DiskSize, 0);
+	std::iota(contents.begin(), contents.begin() + 512, uint8_t(1));
+	std::iota(contents.begin() + 300 * 1024, contents.begin() + 310 * 1024, uint8_t(7));
+	std::fill(contents.end() - 512, contents.end(), uint8_t(0xaa));
+
+	auto file = tmpfile();
+	if (file) {
+		fwrite(contents.data(), 1, contents.size(), file);
+		fflush(file);
+	}
+	return file;
+}
+
+FILE* make_compressed_disk(std::vector<uint8_t>& contents, FILE* compressed = tmpfile())
+{
+	auto raw = make_raw_disk(contents);
+	if (!raw) {
+		return nullptr;
+	}
+	if (compressed && !DISK_IMAGE_Compress(raw, compressed)) {
+		fclose(compressed);
+		compressed = nullptr;
+	}
+	fclose(raw);
+	return compressed;
+}
+
+std::vector<uint8_t> read_disk(DiskImageFile& image, const size_t num_bytes)
+{
+	std::vector<uint8_t> data(num_bytes, 0x55);
+	EXPECT_TRUE(image.Read(0, data.data(), data.size()));
+	return data;
+}
+
+TEST(DiskImageFile, CompressedImageReadsLikeTheRawOne)
+{
+	std::vector<uint8_t> contents = {};
+	auto file                     = make_compressed_disk(contents);
+	ASSERT_TRUE(file);
+
+	EXPECT_TRUE(DISK_IMAGE_IsCompressed(file));
+	EXPECT_EQ(DISK_IMAGE_GetSize(file), static_cast<int64_t>(DiskSize));
+
+	// The zero chunks aren't stored
+	fseek(file, 0, SEEK_END);
+	EXPECT_LT(ftell(file), static_cast<long>(DiskSize / 10));
+
+	auto image = DISK_IMAGE_Open(file);
+	ASSERT_TRUE(image);
+	EXPECT_EQ(image->GetSize(), static_cast<int64_t>(DiskSize));
+	EXPECT_EQ(read_disk(*image, DiskSize), contents);
+}
+
+TEST(DiskImageFile, ReadingPastTheEndGivesZeros)
+{
+	std::vector<uint8_t> contents = {};
+	auto image = DISK_IMAGE_Open(make_compressed_disk(contents));
+	ASSERT_TRUE(image);
+
+	std::vector<uint8_t> data(1024, 0x55);
+	EXPECT_TRUE(image->Read(DiskSize - 512, data.data(), data.size()));
+
+	EXPECT_EQ(data[0], 0xaa);
+	EXPECT_EQ(data[511], 0xaa);
+	EXPECT_EQ(data[512], 0);
+	EXPECT_EQ(data[1023], 0);
+}
+
+TEST(DiskImageFile, WritesSurviveReopening)
+{
+	const auto path = std::filesystem::temp_directory_path() /
+	                  "dosbox_disk_image_file_test.img";
+
+	std::vector<uint8_t> contents = {};
+	auto file = make_compressed_disk(contents, fopen(path.string().c_str(), "wb+"));
+	ASSERT_TRUE(file);
+
+	{
+		auto image = DISK_IMAGE_Open(file);
+		ASSERT_TRUE(image);
+
+		// Spans two chunks, one of which only held zeros
+		std::vector<uint8_t> sectors(128 * 1024);
+		std::iota(sectors.begin(), sectors.end(), uint8_t(3));
+		constexpr size_t Offset = 100 * 1024;
+		EXPECT_TRUE(image->Write(Offset, sectors.data(), sectors.size()));
+		std::copy(sectors.begin(), sectors.end(), contents.begin() + Offset);
+
+		// Overwriting a stored chunk with zeros
+		const std::vector<uint8_t> zeros(512, 0);
+		EXPECT_TRUE(image->Write(0, zeros.data(), zeros.size()));
+		std::copy(zeros.begin(), zeros.end(), contents.begin());
+
+		// Writing past the end of the disk fails
+		EXPECT_FALSE(image->Write(DiskSize, zeros.data(), zeros.size()));
+
+		EXPECT_EQ(read_disk(*image, DiskSize), contents);
+	}
+
+	auto reopened = DISK_IMAGE_Open(fopen(path.string().c_str(), "rb+"));
+	ASSERT_TRUE(reopened);
+	EXPECT_EQ(read_disk(*reopened, DiskSize), contents);
+
+	reopened.reset();
+	std::filesystem::remove(path);
+}
+
+TEST(DiskImageFile, RawImageIsPassedThrough)
+{
+	std::vector<uint8_t> contents = {};
+	auto file                     = make_raw_disk(contents);
+	ASSERT_TRUE(file);
+
+	EXPECT_FALSE(DISK_IMAGE_IsCompressed(file));
+	EXPECT_EQ(DISK_IMAGE_GetSize(file), static_cast<int64_t>(DiskSize));
+
+	auto image = DISK_IMAGE_Open(file);
+	ASSERT_TRUE(image);
+	EXPECT_EQ(read_disk(*image, DiskSize), contents);
+}
+
+TEST(DiskImageFile, PreloadedImageKeepsItsWrites)
+{
+	const auto path = std::filesystem::temp_directory_path() /
+	                  "dosbox_disk_image_preload_test.img";
+
+	std::vector<uint8_t> contents = {};
+	auto raw                      = make_raw_disk(contents);
+	ASSERT_TRUE(raw);
+	fclose(raw);
+
+	auto file = fopen(path.string().c_str(), "wb+");
+	ASSERT_TRUE(file);
+	fwrite(contents.data(), 1, contents.size(), file);
+	fflush(file);
+
+	{
+		auto image = DISK_IMAGE_Open(file, true, "test");
+		ASSERT_TRUE(image);
+		EXPECT_EQ(image->GetSize(), static_cast<int64_t>(DiskSize));
+
+		// Might land before, after, or across the part loaded so far
+		std::vector<uint8_t> sectors(128 * 1024);
+		std::iota(sectors.begin(), sectors.end(), uint8_t(5));
+		constexpr size_t Offset = 200 * 1024;
+		EXPECT_TRUE(image->Write(Offset, sectors.data(), sectors.size()));
+		std::copy(sectors.begin(), sectors.end(), contents.begin() + Offset);
+
+		EXPECT_EQ(read_disk(*image, DiskSize), contents);
+		image->Flush();
+	}
+
+	auto reopened = DISK_IMAGE_Open(fopen(path.string().c_str(), "rb+"));
+	ASSERT_TRUE(reopened);
+	EXPECT_EQ(read_disk(*reopened, DiskSize), contents);
+
+	reopened.reset();
+	std::filesystem::remove(path);
+}
+
+TEST(DiskImageFile, DamagedHeaderIsRejected)
+{
+	std::vector<uint8_t> contents = {};
+	auto file                     = make_compressed_disk(contents);
+	ASSERT_TRUE(file);
+
+	// Unsupported chunk size
+	fseek(file, 12, SEEK_SET);
+	fputc(0x12, file);
+	fflush(file);
+
+	EXPECT_EQ(DISK_IMAGE_GetSize(file), -1);
+	EXPECT_FALSE(DISK_IMAGE_Open(file));
+}
+
+} // namespace
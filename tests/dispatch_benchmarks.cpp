@@ -0,0 +1,194 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "misc/compiler.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Compares switch dispatch with a table of label addresses on a toy
+// interpreter, to show what threaded code could gain the interpreter cores
+// on the host. The handlers are as small as possible, so the dispatch
+// dominates; the real cores do far more work per instruction.
+
+namespace {
+
+enum Op : uint8_t {
+	Add,
+	Sub,
+	Xor,
+	And,
+	Or,
+	Shl,
+	Shr,
+	Inc,
+	Dec,
+	Neg,
+	Not,
+	Swap,
+	Mov,
+	Rol,
+	Ror,
+	Halt,
+};
+
+constexpr size_t ProgramSize = 4096;
+
+// Random opcodes, so the branch predictor can't learn the sequence from
+// the dispatch branch alone
+const std::vector<uint8_t>& get_program()
+{
+	static const auto program = [] {
+		std::vector<uint8_t> ops(ProgramSize);
+
+		std::mt19937 rng(1);
+		std::uniform_int_distribution<int> dist(Add, Ror);
+		for (auto& op : ops) {
+			op = static_cast<uint8_t>(dist(rng));
+		}
+		ops.back() = Halt;
+		return ops;
+	}();
+	return program;
+}
+
+uint32_t run_switch(const uint8_t* pc)
+{
+	uint32_t a = 1;
+	uint32_t b = 0x12345678;
+
+	while (true) {
+		switch (*pc++) {
+		case Add: a += b; break;
+		case Sub: a -= b; break;
+		case Xor: a ^= b; break;
+		case And: a &= b | 1; break;
+		case Or: a |= b; break;
+		case Shl: a <<= 1; break;
+		case Shr: a >>= 1; break;
+		case Inc: ++a; break;
+		case Dec: --a; break;
+		case Neg: a = 0 - a; break;
+		case Not: a = ~a; break;
+		case Swap: std::swap(a, b); break;
+		case Mov: b = a; break;
+		case Rol: a = (a << 3) | (a >> 29); break;
+		case Ror: a = (a >> 3) | (a << 29); break;
+		case Halt: return a ^ b;
+		}
+	}
+}
+
+void BM_DispatchSwitch(benchmark::State& state)
+{
+	const auto& program = get_program();
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(run_switch(program.data()));
+	}
+	state.SetItemsProcessed(state.iterations() * ProgramSize);
+}
+BENCHMARK(BM_DispatchSwitch);
+
+#if C_HAS_COMPUTED_GOTO
+
+// Every handler ends in its own indirect jump, so each one gets its own
+// branch prediction history
+uint32_t run_threaded(const uint8_t* pc)
+{
+	static const void* const Labels[] = {&&add,
+	                                     &&sub,
+	                                     &&xor_,
+	                                     &&and_,
+	                                     &&or_,
+	                                     &&shl,
+	                                     &&shr,
+	                                     &&inc,
+	                                     &&dec,
+	                                     &&neg,
+	                                     &&not_,
+	                                     &&swap,
+	                                     &&mov,
+	                                     &&rol,
+	                                     &&ror,
+	                                     &&halt};
+	uint32_t a = 1;
+	uint32_t b = 0x12345678;
+
+#define DISPATCH() goto* Labels[*pc++]
+
+	DISPATCH();
+
+add:
+	a += b;
+	DISPATCH();
+sub:
+	a -= b;
+	DISPATCH();
+xor_:
+	a ^= b;
+	DISPATCH();
+and_:
+	a &= b | 1;
+	DISPATCH();
+or_:
+	a |= b;
+	DISPATCH();
+shl:
+	a <<= 1;
+	DISPATCH();
+shr:
+	a >>= 1;
+	DISPATCH();
+inc:
+	++a;
+	DISPATCH();
+dec:
+	--a;
+	DISPATCH();
+neg:
+	a = 0 - a;
+	DISPATCH();
+not_:
+	a = ~a;
+	DISPATCH();
+swap:
+	std::swap(a, b);
+	DISPATCH();
+mov:
+	b = a;
+	DISPATCH();
+rol:
+	a = (a << 3) | (a >> 29);
+	DISPATCH();
+ror:
+	a = (a >> 3) | (a << 29);
+	DISPATCH();
+halt:
+	return a ^ b;
+
+#undef DISPATCH
+}
+
+void BM_DispatchThreaded(benchmark::State& state)
+{
+	const auto& program = get_program();
+
+	if (run_threaded(program.data()) != run_switch(program.data())) {
+		state.SkipWithError("The two interpreters disagree");
+		return;
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(run_threaded(program.data()));
+	}
+	state.SetItemsProcessed(state.iterations() * ProgramSize);
+}
+BENCHMARK(BM_DispatchThreaded);
+
+#endif // C_HAS_COMPUTED_GOTO
+
+} // namespace
@@ -20,8 +20,10 @@
 
 #include "dos/dos.h"
 
+#include <algorithm>
 #include <iterator>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -405,4 +407,77 @@ TEST_F(DOS_FilesTest, SetDate_LocalDrive)
 	ASSERT_TRUE(delete_native_file("tests/files/paths/date.txt"));
 }
 
+TEST_F(DOS_FilesTest, ReadAhead_LocalDrive)
+{
+	std::vector<uint8_t> contents(100 * 1000);
+	for (size_t i = 0; i < contents.size(); ++i) {
+		contents[i] = static_cast<uint8_t>(i * 7);
+	}
+	const auto temp_handle = create_native_file("tests/files/paths/readahd.bin", {});
+	ASSERT_NE(temp_handle, InvalidNativeFileHandle);
+	write_native_file(temp_handle, contents.data(), check_cast<int64_t>(contents.size()));
+	close_native_file(temp_handle);
+
+	auto local_drive = create_local_drive("tests/files/paths/");
+
+	auto reader = local_drive->FileOpen("readahd.bin", OPEN_READ);
+	ASSERT_NE(reader, nullptr);
+
+	auto expect_read_at = [&](const uint32_t pos, const uint16_t size) {
+		std::vector<uint8_t> buffer(size);
+		uint16_t num_bytes = size;
+		ASSERT_TRUE(reader->Read(buffer.data(), &num_bytes));
+
+		const auto end = std::min(contents.size(), size_t(pos) + size);
+		ASSERT_EQ(num_bytes, end - pos);
+		EXPECT_TRUE(std::equal(contents.begin() + pos,
+		                       contents.begin() + end,
+		                       buffer.begin()));
+	};
+
+	// Small sequential reads, crossing the read-ahead buffer boundaries
+	for (uint32_t pos = 0; pos < 70 * 1000; pos += 500) {
+		expect_read_at(pos, 500);
+	}
+
+	uint32_t pos = 0;
+	EXPECT_TRUE(reader->Seek(&pos, DOS_SEEK_CUR));
+	EXPECT_EQ(pos, 70 * 1000);
+
+	// Backwards, and a read larger than the buffer
+	pos = 1234;
+	EXPECT_TRUE(reader->Seek(&pos, DOS_SEEK_SET));
+	expect_read_at(1234, 60000);
+
+	// Up to the end of the file
+	pos = static_cast<uint32_t>(-100);
+	EXPECT_TRUE(reader->Seek(&pos, DOS_SEEK_END));
+	EXPECT_EQ(pos, contents.size() - 100);
+	expect_read_at(check_cast<uint32_t>(contents.size() - 100), 512);
+
+	// Writes through another handle are seen by the reader, even if it
+	// has the data buffered already
+	pos = 900;
+	EXPECT_TRUE(reader->Seek(&pos, DOS_SEEK_SET));
+	expect_read_at(900, 50);
+
+	auto writer = local_drive->FileOpen("readahd.bin", OPEN_READWRITE);
+	ASSERT_NE(writer, nullptr);
+	pos = 1000;
+	EXPECT_TRUE(writer->Seek(&pos, DOS_SEEK_SET));
+	uint16_t num_bytes = 4;
+	uint8_t data[]     = {1, 2, 3, 4};
+	EXPECT_TRUE(writer->Write(data, &num_bytes));
+	std::copy(std::begin(data), std::end(data), contents.begin() + 1000);
+
+	expect_read_at(950, 200);
+
+	writer->Close();
+	writer.reset();
+	reader->Close();
+	reader.reset();
+	local_drive.reset();
+	ASSERT_TRUE(delete_native_file("tests/files/paths/readahd.bin"));
+}
+
 } // namespace
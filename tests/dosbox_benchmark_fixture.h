@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_BENCHMARK_FIXTURE_H
+#define DOSBOX_BENCHMARK_FIXTURE_H
+
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "config/config.h"
+#include "cpu/cpu.h"
+#include "dosbox.h"
+#include "misc/cross.h"
+
+// Brings up the core of the emulator (memory, paging, port I/O, the PIC and
+// the CPU) for benchmarks of the hardware paths. Like the test fixture, it
+// has to be run from the top of the source tree to find its config file.
+class DOSBoxBenchmarkFixture : public benchmark::Fixture {
+public:
+	DOSBoxBenchmarkFixture()
+	        : arg_c_str("-conf tests/files/dosbox-staging-tests.conf\0"),
+	          argv{arg_c_str},
+	          command_line(1, argv)
+	{}
+
+	void SetUp(benchmark::State&) override
+	{
+		control = std::make_unique<Config>(&command_line);
+
+		init_config_dir();
+		control->ParseConfigFiles(get_config_dir());
+
+		DOSBOX_InitModuleConfigsAndMessages();
+
+		DOSBOX_Init();
+		CPU_Init();
+	}
+
+	void TearDown(benchmark::State&) override
+	{
+		CPU_Destroy();
+		DOSBOX_Destroy();
+
+		control = {};
+	}
+
+private:
+	const char* arg_c_str;
+	const char* argv[1];
+
+	CommandLine command_line;
+};
+
+#endif
@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dos/drive_cache_scanner.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+#include "misc/cross.h"
+
+namespace {
+
+class DirCacheScannerTest : public ::testing::Test {
+protected:
+	void SetUp() override
+	{
+		root = std_fs::temp_directory_path() / "dir_cache_scanner_tests";
+		std_fs::remove_all(root);
+		std_fs::create_directories(root / "sub");
+
+		std::ofstream(root / "a.txt") << "a";
+		std::ofstream(root / "sub" / "b.txt") << "b";
+
+		// Directories modified just now are not prefetched
+		const auto an_hour_ago = std_fs::file_time_type::clock::now() -
+		                         std::chrono::hours(1);
+		std_fs::last_write_time(root, an_hour_ago);
+		std_fs::last_write_time(root / "sub", an_hour_ago);
+
+		root_dir = root.string() + CROSS_FILESPLIT;
+		sub_dir  = root_dir + "sub" + CROSS_FILESPLIT;
+	}
+
+	void TearDown() override
+	{
+		std_fs::remove_all(root);
+	}
+
+	std_fs::path root    = {};
+	std::string root_dir = {};
+	std::string sub_dir  = {};
+};
+
+template <typename Predicate>
+bool wait_for(Predicate predicate)
+{
+	using namespace std::chrono_literals;
+
+	for (auto i = 0; i < 500; ++i) {
+		if (predicate()) {
+			return true;
+		}
+		std::this_thread::sleep_for(10ms);
+	}
+	return false;
+}
+
+bool has_entry(const std::vector<DirCacheScanner::Entry>& entries,
+               const std::string& name, const bool is_directory)
+{
+	return std::any_of(entries.begin(), entries.end(), [&](const auto& entry) {
+		return entry.name == name && entry.is_directory == is_directory;
+	});
+}
+
+TEST_F(DirCacheScannerTest, PrefetchesTheTree)
+{
+	DirCacheScanner scanner(root.string());
+
+	std::optional<std::vector<DirCacheScanner::Entry>> listing = {};
+	ASSERT_TRUE(wait_for([&] {
+		listing = scanner.TakeListing(sub_dir);
+		return listing.has_value();
+	}));
+	EXPECT_TRUE(has_entry(*listing, "b.txt", false));
+	EXPECT_TRUE(has_entry(*listing, "..", true));
+
+	// The root is scanned before the subdirectory
+	listing = scanner.TakeListing(root_dir);
+	ASSERT_TRUE(listing);
+	EXPECT_TRUE(has_entry(*listing, "a.txt", false));
+	EXPECT_TRUE(has_entry(*listing, "sub", true));
+
+	// A listing is only handed out once
+	EXPECT_FALSE(scanner.TakeListing(root_dir));
+}
+
+TEST_F(DirCacheScannerTest, DropsStaleListings)
+{
+	DirCacheScanner scanner(root.string());
+
+	ASSERT_TRUE(wait_for([&] {
+		return scanner.TakeListing(sub_dir).has_value();
+	}));
+
+	std::ofstream(root / "c.txt") << "c";
+
+	EXPECT_FALSE(scanner.TakeListing(root_dir));
+}
+
+#if defined(LINUX)
+TEST_F(DirCacheScannerTest, ReportsHostChanges)
+{
+	DirCacheScanner scanner(root.string());
+
+	ASSERT_TRUE(wait_for([&] {
+		return scanner.TakeListing(sub_dir).has_value();
+	}));
+
+	std::ofstream(root / "sub" / "c.txt") << "c";
+	std_fs::remove(root / "a.txt");
+
+	std::vector<DirCacheScanner::Change> changes = {};
+	ASSERT_TRUE(wait_for([&] {
+		for (auto& change : scanner.TakeChanges()) {
+			changes.push_back(std::move(change));
+		}
+		return changes.size() >= 2;
+	}));
+
+	EXPECT_EQ(changes[0].type, DirCacheScanner::ChangeType::Added);
+	EXPECT_EQ(changes[0].dir, sub_dir);
+	EXPECT_EQ(changes[0].name, "c.txt");
+
+	EXPECT_EQ(changes[1].type, DirCacheScanner::ChangeType::Removed);
+	EXPECT_EQ(changes[1].dir, root_dir);
+	EXPECT_EQ(changes[1].name, "a.txt");
+}
+#endif
+
+} // namespace
@@ -0,0 +1,230 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dos/drives.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+namespace {
+
+struct ZipTestFile {
+	std::string path         = {};
+	std::vector<uint8_t> data = {};
+	bool deflate              = false;
+
+	// Uncompressed size written to the archive instead of the real one
+	uint32_t claimed_size = 0;
+};
+
+void put_word(std::vector<uint8_t>& out, const uint32_t value)
+{
+	out.push_back(static_cast<uint8_t>(value));
+	out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void put_dword(std::vector<uint8_t>& out, const uint32_t value)
+{
+	put_word(out, value & 0xffff);
+	put_word(out, value >> 16);
+}
+
+std::vector<uint8_t> deflate_raw(const std::vector<uint8_t>& data)
+{
+	z_stream stream = {};
+	deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+
+	std::vector<uint8_t> out(deflateBound(&stream, static_cast<uLong>(data.size())));
+	stream.next_in   = const_cast<uint8_t*>(data.data());
+	stream.avail_in  = static_cast<uInt>(data.size());
+	stream.next_out  = out.data();
+	stream.avail_out = static_cast<uInt>(out.size());
+	deflate(&stream, Z_FINISH);
+	out.resize(stream.total_out);
+	deflateEnd(&stream);
+	return out;
+}
+
+// Writes a minimal ZIP archive holding the files
+void write_zip(const std::filesystem::path& zip_path,
+               const std::vector<ZipTestFile>& files)
+{
+	std::vector<uint8_t> archive     = {};
+	std::vector<uint8_t> central_dir = {};
+
+	for (const auto& file : files) {
+		const auto stored = file.deflate ? deflate_raw(file.data) : file.data;
+		const auto crc    = crc32(0, file.data.data(), static_cast<uInt>(file.data.size()));
+		const auto offset = static_cast<uint32_t>(archive.size());
+
+		auto put_common = [&](std::vector<uint8_t>& out) {
+			put_word(out, 0);                       // flags
+			put_word(out, file.deflate ? 8 : 0);    // method
+			put_word(out, 0x6000);                  // time 12:00
+			put_word(out, 0x5a21);                  // date 2025-01-01
+			put_dword(out, static_cast<uint32_t>(crc));
+			put_dword(out, static_cast<uint32_t>(stored.size()));
+			put_dword(out,
+			          file.claimed_size
+			                  ? file.claimed_size
+			                  : static_cast<uint32_t>(file.data.size()));
+			put_word(out, static_cast<uint32_t>(file.path.size()));
+			put_word(out, 0); // extra length
+		};
+
+		put_dword(archive, 0x04034b50);
+		put_word(archive, 20); // version needed
+		put_common(archive);
+		archive.insert(archive.end(), file.path.begin(), file.path.end());
+		archive.insert(archive.end(), stored.begin(), stored.end());
+
+		put_dword(central_dir, 0x02014b50);
+		put_word(central_dir, 20); // version made by, MS-DOS
+		put_word(central_dir, 20); // version needed
+		put_common(central_dir);
+		put_word(central_dir, 0);  // comment length
+		put_word(central_dir, 0);  // disk number
+		put_word(central_dir, 0);  // internal attributes
+		put_dword(central_dir, 0); // external attributes
+		put_dword(central_dir, offset);
+		central_dir.insert(central_dir.end(), file.path.begin(), file.path.end());
+	}
+
+	const auto dir_offset = static_cast<uint32_t>(archive.size());
+	archive.insert(archive.end(), central_dir.begin(), central_dir.end());
+
+	put_dword(archive, 0x06054b50);
+	put_word(archive, 0); // disk number
+	put_word(archive, 0); // disk with the central directory
+	put_word(archive, static_cast<uint32_t>(files.size()));
+	put_word(archive, static_cast<uint32_t>(files.size()));
+	put_dword(archive, static_cast<uint32_t>(central_dir.size()));
+	put_dword(archive, dir_offset);
+	put_word(archive, 0); // comment length
+
+	auto out = fopen(zip_path.string().c_str(), "wb");
+	ASSERT_TRUE(out);
+	fwrite(archive.data(), 1, archive.size(), out);
+	fclose(out);
+}
+
+std::vector<uint8_t> read_file(DOS_File& file)
+{
+	std::vector<uint8_t> contents = {};
+
+	uint8_t buffer[1000];
+	uint16_t size = sizeof(buffer);
+	while (file.Read(buffer, &size) && size > 0) {
+		contents.insert(contents.end(), buffer, buffer + size);
+		size = sizeof(buffer);
+	}
+	return contents;
+}
+
+class ZipDriveTest : public ::testing::Test {
+protected:
+	void SetUp() override
+	{
+		text.assign(5000, 'a');
+		std::iota(binary.begin(), binary.end(), uint8_t(0));
+
+		write_zip(zip_path,
+		          {{"readme.txt", text, true},
+		           {"game/data/level1.dat", binary, false},
+		           {"game/Long Name.data", text, true}});
+
+		int error = -1;
+		drive = std::make_shared<zipDrive>(zip_path.string().c_str(), 0xf8, error);
+		ASSERT_EQ(error, 0);
+	}
+
+	void TearDown() override
+	{
+		drive.reset();
+		std::filesystem::remove(zip_path);
+	}
+
+	const std::filesystem::path zip_path = std::filesystem::temp_directory_path() /
+	                                       "dosbox_drive_zip_test.zip";
+
+	std::vector<uint8_t> text   = {};
+	std::vector<uint8_t> binary = std::vector<uint8_t>(3000);
+
+	std::shared_ptr<zipDrive> drive = {};
+};
+
+TEST_F(ZipDriveTest, FilesAndImpliedDirectories)
+{
+	EXPECT_TRUE(drive->FileExists("README.TXT"));
+	EXPECT_TRUE(drive->FileExists("game\\data\\LEVEL1.DAT"));
+	EXPECT_FALSE(drive->FileExists("GAME"));
+	EXPECT_FALSE(drive->FileExists("MISSING.TXT"));
+
+	EXPECT_TRUE(drive->TestDir(""));
+	EXPECT_TRUE(drive->TestDir("GAME"));
+	EXPECT_TRUE(drive->TestDir("GAME\\DATA"));
+	EXPECT_FALSE(drive->TestDir("README.TXT"));
+
+	FatAttributeFlags attr = {};
+	EXPECT_TRUE(drive->GetFileAttr("GAME\\DATA", &attr));
+	EXPECT_TRUE(attr.directory);
+}
+
+TEST_F(ZipDriveTest, LongNamesGetShortNames)
+{
+	EXPECT_TRUE(drive->FileExists("GAME\\LONGNA~1.DAT"));
+}
+
+TEST_F(ZipDriveTest, ReadsStoredAndDeflatedFiles)
+{
+	auto file = drive->FileOpen("GAME\\DATA\\LEVEL1.DAT", OPEN_READ);
+	ASSERT_TRUE(file);
+	EXPECT_EQ(read_file(*file), binary);
+
+	file = drive->FileOpen("README.TXT", OPEN_READ);
+	ASSERT_TRUE(file);
+	EXPECT_EQ(read_file(*file), text);
+
+	// Reading again after seeking back
+	uint32_t pos = 4990;
+	EXPECT_TRUE(file->Seek(&pos, DOS_SEEK_SET));
+	EXPECT_EQ(read_file(*file), std::vector<uint8_t>(10, 'a'));
+}
+
+TEST_F(ZipDriveTest, RefusesOversizedDeflatedFiles)
+{
+	drive.reset();
+	write_zip(zip_path,
+	          {{"bomb.bin", text, true, 0xf0000000},
+	           {"ratio.bin", text, true, 64 * 1024 * 1024}});
+
+	int error = -1;
+	drive = std::make_shared<zipDrive>(zip_path.string().c_str(), 0xf8, error);
+	ASSERT_EQ(error, 0);
+
+	for (const auto name : {"BOMB.BIN", "RATIO.BIN"}) {
+		auto file = drive->FileOpen(name, OPEN_READ);
+		ASSERT_TRUE(file);
+
+		uint8_t buffer[100];
+		uint16_t size = sizeof(buffer);
+		EXPECT_FALSE(file->Read(buffer, &size));
+	}
+}
+
+TEST_F(ZipDriveTest, IsReadOnly)
+{
+	EXPECT_FALSE(drive->FileOpen("README.TXT", OPEN_READWRITE));
+	EXPECT_FALSE(drive->FileCreate("NEW.TXT", {}));
+	EXPECT_FALSE(drive->FileUnlink("README.TXT"));
+	EXPECT_FALSE(drive->MakeDir("NEWDIR"));
+}
+
+} // namespace
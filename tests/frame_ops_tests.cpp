@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "audio/private/frame_ops.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// Odd sizes exercise the scalar tail after the vectorised part
+constexpr size_t NumFrames[] = {0, 1, 2, 3, 7, 8, 511, 1024};
+
+std::vector<AudioFrame> random_frames(const size_t num_frames, const float range)
+{
+	static std::mt19937 generator(1234);
+	std::uniform_real_distribution<float> dist(-range, range);
+
+	std::vector<AudioFrame> frames(num_frames);
+	for (auto& frame : frames) {
+		frame = {dist(generator), dist(generator)};
+	}
+	return frames;
+}
+
+TEST(FrameOps, AddFramesMatchesScalar)
+{
+	for (const auto n : NumFrames) {
+		const auto src = random_frames(n, 32768.0f);
+		auto simd_dest = random_frames(n, 32768.0f);
+		auto ref_dest  = simd_dest;
+
+		add_frames(simd_dest.data(), src.data(), n);
+		scalar::add_frames(ref_dest.data(), src.data(), n);
+
+		EXPECT_EQ(simd_dest, ref_dest) << "num_frames: " << n;
+	}
+}
+
+TEST(FrameOps, AddFramesScaledMatchesScalar)
+{
+	for (const auto n : NumFrames) {
+		const auto src = random_frames(n, 32768.0f);
+		auto simd_dest = random_frames(n, 32768.0f);
+		auto ref_dest  = simd_dest;
+
+		add_frames_scaled(simd_dest.data(), src.data(), 0.3f, n);
+		scalar::add_frames_scaled(ref_dest.data(), src.data(), 0.3f, n);
+
+		EXPECT_EQ(simd_dest, ref_dest) << "num_frames: " << n;
+	}
+}
+
+TEST(FrameOps, ScaleFramesMatchesScalar)
+{
+	const AudioFrame gain = {0.5f, 1.7f};
+
+	for (const auto n : NumFrames) {
+		auto simd_frames = random_frames(n, 32768.0f);
+		auto ref_frames  = simd_frames;
+
+		scale_frames(simd_frames.data(), gain, n);
+		scalar::scale_frames(ref_frames.data(), gain, n);
+
+		EXPECT_EQ(simd_frames, ref_frames) << "num_frames: " << n;
+	}
+}
+
+TEST(FrameOps, FramesToInt16MatchesScalar)
+{
+	for (const auto n : NumFrames) {
+		// Exceed the 16-bit range to exercise the clamping
+		const auto src = random_frames(n, 100000.0f);
+
+		std::vector<int16_t> simd_samples(n * 2);
+		std::vector<int16_t> ref_samples(n * 2);
+
+		frames_to_int16(src.data(), simd_samples.data(), n);
+		scalar::frames_to_int16(src.data(), ref_samples.data(), n);
+
+		EXPECT_EQ(simd_samples, ref_samples) << "num_frames: " << n;
+	}
+}
+
+TEST(FrameOps, FramesToInt16TruncatesAndClamps)
+{
+	const std::vector<AudioFrame> src = {{1.9f, -1.9f},
+	                                     {40000.0f, -40000.0f},
+	                                     {32767.5f, -32768.5f},
+	                                     {0.0f, -0.4f}};
+
+	std::vector<int16_t> samples(src.size() * 2);
+	frames_to_int16(src.data(), samples.data(), src.size());
+
+	const std::vector<int16_t> expected = {
+	        1, -1, 32767, -32768, 32767, -32768, 0, 0};
+
+	EXPECT_EQ(samples, expected);
+}
+
+} // namespace
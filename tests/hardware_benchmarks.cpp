@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dosbox_benchmark_fixture.h"
+
+#include <numeric>
+#include <vector>
+
+#include "cpu/paging.h"
+#include "hardware/memory.h"
+#include "hardware/pic.h"
+#include "hardware/port.h"
+
+namespace {
+
+// Conventional memory above the BIOS data area and the DOS kernel
+constexpr PhysPt BenchmarkBase = 0x10000;
+constexpr size_t BenchmarkSize = 64 * 1024;
+
+BENCHMARK_F(DOSBoxBenchmarkFixture, MemReadDword)(benchmark::State& state)
+{
+	for (PhysPt addr = 0; addr < BenchmarkSize; addr += 4) {
+		mem_writed(BenchmarkBase + addr, addr);
+	}
+
+	for (auto _ : state) {
+		uint32_t sum = 0;
+		for (PhysPt addr = 0; addr < BenchmarkSize; addr += 4) {
+			sum += mem_readd(BenchmarkBase + addr);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * BenchmarkSize));
+}
+
+BENCHMARK_F(DOSBoxBenchmarkFixture, MemBlockWrite)(benchmark::State& state)
+{
+	std::vector<uint8_t> data(BenchmarkSize);
+	std::iota(data.begin(), data.end(), uint8_t(0));
+
+	for (auto _ : state) {
+		MEM_BlockWrite(BenchmarkBase, data.data(), data.size());
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * BenchmarkSize));
+}
+
+// Reads one byte of every page of conventional memory, so their TLB entries
+// are linked again after they were dropped, like a game running its frame
+uint32_t touch_conventional_pages()
+{
+	constexpr PhysPt ConventionalEnd = 0xa0000;
+
+	uint32_t sum = 0;
+	for (PhysPt addr = 0; addr < ConventionalEnd; addr += 4096) {
+		sum += mem_readb(addr);
+	}
+	return sum;
+}
+
+constexpr auto NumConventionalPages = 0xa0000 / 4096;
+
+// What the first-write trap of the VESA framebuffer used to cost: a full TLB
+// flush, after which every page the guest uses has to be linked again
+BENCHMARK_F(DOSBoxBenchmarkFixture, TlbFullFlush)(benchmark::State& state)
+{
+	touch_conventional_pages();
+
+	for (auto _ : state) {
+		PAGING_ClearTLB();
+		benchmark::DoNotOptimize(touch_conventional_pages());
+	}
+	state.SetItemsProcessed(state.iterations() * NumConventionalPages);
+}
+
+// What it costs now: only the links of the video memory window are dropped
+BENCHMARK_F(DOSBoxBenchmarkFixture, TlbVideoWindowUnlink)(benchmark::State& state)
+{
+	constexpr Bitu VideoWindowPage  = 0xa0000 / 4096;
+	constexpr Bitu VideoWindowPages = 32;
+
+	touch_conventional_pages();
+
+	for (auto _ : state) {
+		PAGING_UnlinkPhysPages(VideoWindowPage, VideoWindowPages);
+		benchmark::DoNotOptimize(touch_conventional_pages());
+	}
+	state.SetItemsProcessed(state.iterations() * NumConventionalPages);
+}
+
+// An unused port range, so the handlers don't clash with emulated devices
+constexpr io_port_t BenchmarkPort = 0x0500;
+
+BENCHMARK_F(DOSBoxBenchmarkFixture, PortDispatch)(benchmark::State& state)
+{
+	uint8_t latch = 0;
+
+	IO_ReadHandleObject read_handler   = {};
+	IO_WriteHandleObject write_handler = {};
+
+	read_handler.Install(
+	        BenchmarkPort,
+	        [&](io_port_t, io_width_t) -> io_val_t { return latch; },
+	        io_width_t::byte);
+
+	write_handler.Install(
+	        BenchmarkPort,
+	        [&](io_port_t, io_val_t value, io_width_t) {
+		        latch = static_cast<uint8_t>(value);
+	        },
+	        io_width_t::byte);
+
+	constexpr auto NumAccesses = 1000;
+
+	for (auto _ : state) {
+		for (auto i = 0; i < NumAccesses; ++i) {
+			IO_WriteB(BenchmarkPort, static_cast<uint8_t>(i));
+			benchmark::DoNotOptimize(IO_ReadB(BenchmarkPort));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * NumAccesses * 2);
+}
+
+uint32_t events_run = 0;
+
+void count_event(const uint32_t)
+{
+	++events_run;
+}
+
+// Schedules events spread over one emulated millisecond, then runs the queue
+// the way the main loop does, with the CPU core using up the cycles given to
+// it between events
+BENCHMARK_F(DOSBoxBenchmarkFixture, PicEventQueue)(benchmark::State& state)
+{
+	constexpr auto NumEvents = 256;
+
+	for (auto _ : state) {
+		CPU_CycleLeft = CPU_CycleMax;
+		CPU_Cycles    = 0;
+
+		for (auto i = 0; i < NumEvents; ++i) {
+			// Scrambled order, so the queue has to sort them
+			const auto slot = (i * 97) % NumEvents;
+			PIC_AddEvent(count_event, slot / static_cast<double>(NumEvents));
+		}
+
+		while (PIC_RunQueue()) {
+			CPU_Cycles = 0;
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * NumEvents);
+
+	PIC_RemoveEvents(count_event);
+	benchmark::DoNotOptimize(events_run);
+}
+
+} // namespace
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "hardware/input/input_replay.h"
+
+#include <gtest/gtest.h>
+
+#include "hardware/input/keyboard.h"
+
+namespace {
+
+TEST(InputReplay, EntriesRoundTrip)
+{
+	const std::vector<ReplayEntry> entries = {
+	        {0, {ReplayEventType::Key, 0, KBD_enter, {1.0f}}},
+	        {12345,
+	         {ReplayEventType::MouseMoved, 0, 0, {0.1f, -3.75f, 319.5f, 1e-7f}}},
+	        {12345, {ReplayEventType::MouseButton, 0, 2, {0.0f}}},
+	        {4000000000, {ReplayEventType::JoystickAxisY, 1, 0, {-32768.0f}}},
+	};
+
+	for (const auto& entry : entries) {
+		const auto line = REPLAY_FormatEntry(entry);
+
+		const auto parsed = REPLAY_ParseEntry(line);
+		ASSERT_TRUE(parsed) << line;
+		EXPECT_EQ(*parsed, entry) << line;
+	}
+}
+
+TEST(InputReplay, ParsesFormattedLine)
+{
+	const auto entry = REPLAY_ParseEntry("250 joystick_button 1 0 1 0 0 0");
+	ASSERT_TRUE(entry);
+
+	EXPECT_EQ(entry->tick, 250u);
+	EXPECT_EQ(entry->event.type, ReplayEventType::JoystickButton);
+	EXPECT_EQ(entry->event.device, 1);
+	EXPECT_EQ(entry->event.id, 0);
+	EXPECT_EQ(entry->event.values[0], 1.0f);
+}
+
+TEST(InputReplay, RejectsInvalidLines)
+{
+	for (const auto line : {"",
+	                        "# DOSBox Staging input recording, version 1",
+	                        "host_time 0 1760000000000",
+	                        "10 key 0 28 1 0 0",
+	                        "10 keys 0 28 1 0 0 0",
+	                        "-1 key 0 28 1 0 0 0",
+	                        "10 key 0 9999 1 0 0 0",
+	                        "10 joystick_x 2 0 100 0 0 0",
+	                        "10 mouse_wheel 0 0 x 0 0 0"}) {
+		EXPECT_FALSE(REPLAY_ParseEntry(line)) << line;
+	}
+}
+
+} // namespace
@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gui/render/private/line_pipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr size_t LineSize = 16;
+
+using Line = std::vector<uint8_t>;
+
+TEST(LinePipeline, ProcessesLinesInOrder)
+{
+	std::vector<Line> processed = {};
+
+	LinePipeline pipeline(
+	        [&](const void* line) {
+		        const auto bytes = static_cast<const uint8_t*>(line);
+		        processed.emplace_back(bytes, bytes + LineSize);
+	        },
+	        "test");
+
+	pipeline.SetLineSize(LineSize);
+
+	// More lines than slots, so submitting has to wait for the worker
+	std::vector<Line> expected = {};
+	Line line(LineSize);
+
+	for (auto n = 0; n < 500; ++n) {
+		std::memset(line.data(), n & 0xff, line.size());
+		line[0] = static_cast<uint8_t>(n >> 8);
+
+		// The pipeline copies the line, so it can be reused right away
+		pipeline.Submit(line.data());
+		expected.push_back(line);
+	}
+	pipeline.Wait();
+
+	EXPECT_EQ(processed, expected);
+}
+
+TEST(LinePipeline, PassesNullLines)
+{
+	std::vector<bool> is_null = {};
+
+	LinePipeline pipeline([&](const void* line) { is_null.push_back(!line); },
+	                      "test");
+
+	pipeline.SetLineSize(LineSize);
+
+	const Line line(LineSize);
+
+	pipeline.Submit(line.data());
+	pipeline.Submit(nullptr);
+	pipeline.Submit(line.data());
+	pipeline.Wait();
+
+	EXPECT_EQ(is_null, (std::vector<bool>{false, true, false}));
+}
+
+TEST(LinePipeline, ProcessesPendingLinesWhenDestroyed)
+{
+	auto num_processed = 0;
+	{
+		LinePipeline pipeline([&](const void*) { ++num_processed; }, "test");
+		pipeline.SetLineSize(LineSize);
+
+		const Line line(LineSize);
+		for (auto n = 0; n < 10; ++n) {
+			pipeline.Submit(line.data());
+		}
+	}
+	EXPECT_EQ(num_processed, 10);
+}
+
+} // namespace
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "misc/metrics.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+TEST(Metrics, CounterSumsAcrossThreads)
+{
+	auto& counter = METRICS_Counter("test_counter_threads_total", "Test counter");
+
+	constexpr int NumThreads    = 4;
+	constexpr int NumIncrements = 10'000;
+
+	std::vector<std::thread> threads = {};
+	for (auto i = 0; i < NumThreads; ++i) {
+		threads.emplace_back([&] {
+			for (auto j = 0; j < NumIncrements; ++j) {
+				counter.Add();
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	EXPECT_EQ(counter.Value(), NumThreads * NumIncrements);
+}
+
+TEST(Metrics, RegisteringTwiceReturnsTheSameMetric)
+{
+	auto& first  = METRICS_Counter("test_counter_same_total", "Test counter");
+	auto& second = METRICS_Counter("test_counter_same_total", "Test counter");
+
+	EXPECT_EQ(&first, &second);
+}
+
+TEST(Metrics, HistogramBuckets)
+{
+	auto& histogram = METRICS_Histogram("test_histogram_seconds",
+	                                    "Test histogram",
+	                                    {1.0, 2.0, 4.0});
+	histogram.Observe(0.5);
+	histogram.Observe(1.0);
+	histogram.Observe(3.0);
+	histogram.Observe(10.0);
+
+	const auto snapshot = histogram.GetSnapshot();
+
+	EXPECT_EQ(snapshot.cumulative_counts, (std::vector<int64_t>{2, 2, 3, 4}));
+	EXPECT_EQ(snapshot.count, 4);
+	EXPECT_DOUBLE_EQ(snapshot.sum, 14.5);
+}
+
+TEST(Metrics, PrometheusText)
+{
+	METRICS_Counter("test_text_total", "Test text counter").Add(3);
+	METRICS_Gauge("test_text_gauge", "Test text gauge").Set(0.5);
+	METRICS_Histogram("test_text_seconds", "Test text histogram", {1.0}).Observe(2.0);
+
+	const auto text = METRICS_GetPrometheusText();
+
+	EXPECT_NE(text.find("# TYPE test_text_total counter\ntest_text_total 3\n"),
+	          std::string::npos);
+	EXPECT_NE(text.find("# TYPE test_text_gauge gauge\ntest_text_gauge 0.5\n"),
+	          std::string::npos);
+	EXPECT_NE(text.find("test_text_seconds_bucket{le=\"1\"} 0\n"
+	                    "test_text_seconds_bucket{le=\"+Inf\"} 1\n"
+	                    "test_text_seconds_sum 2\n"
+	                    "test_text_seconds_count 1\n"),
+	          std::string::npos);
+}
+
+} // namespace
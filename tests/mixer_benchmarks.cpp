@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "audio/mixer.h"
+#include "audio/private/polyphase_resampler.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include <speex/speex_resampler.h>
+
+namespace {
+
+void callback(const uint16_t) {}
+
+// A typical block size of the sound devices rendering per tick
+constexpr int NumFrames = 1024;
+
+// A sine sweep, so the converted samples aren't all the same
+template <typename T>
+std::vector<T> make_samples(const int num_channels, const float amplitude,
+                            const float offset = 0.0f)
+{
+	std::vector<T> samples(static_cast<size_t>(NumFrames * num_channels));
+	for (size_t i = 0; i < samples.size(); ++i) {
+		const auto phase = std::numbers::pi_v<float> * static_cast<float>(i * i) /
+		                   static_cast<float>(samples.size() * 8);
+		samples[i] = static_cast<T>(offset + amplitude * std::sin(phase));
+	}
+	return samples;
+}
+
+template <typename T, typename AddFunc>
+void add_samples(benchmark::State& state, const std::vector<T>& samples, AddFunc add)
+{
+	MixerChannel channel(callback, "BENCHMARK", {ChannelFeature::Sleep});
+
+	for (auto _ : state) {
+		add(channel, samples.data());
+
+		benchmark::DoNotOptimize(channel.audio_frames.data());
+		channel.audio_frames.clear();
+	}
+	state.SetItemsProcessed(state.iterations() * NumFrames);
+}
+
+void BM_MixerAddSamplesM8(benchmark::State& state)
+{
+	const auto samples = make_samples<uint8_t>(1, 127.0f, 128.0f);
+
+	add_samples(state, samples, [](MixerChannel& channel, const uint8_t* data) {
+		channel.AddSamples_m8(NumFrames, data);
+	});
+}
+BENCHMARK(BM_MixerAddSamplesM8);
+
+void BM_MixerAddSamplesS16(benchmark::State& state)
+{
+	const auto samples = make_samples<int16_t>(2, 32000.0f);
+
+	add_samples(state, samples, [](MixerChannel& channel, const int16_t* data) {
+		channel.AddSamples_s16(NumFrames, data);
+	});
+}
+BENCHMARK(BM_MixerAddSamplesS16);
+
+void BM_MixerAddSamplesS16NonNative(benchmark::State& state)
+{
+	const auto samples = make_samples<int16_t>(2, 32000.0f);
+
+	add_samples(state, samples, [](MixerChannel& channel, const int16_t* data) {
+		channel.AddSamples_s16_nonnative(NumFrames, data);
+	});
+}
+BENCHMARK(BM_MixerAddSamplesS16NonNative);
+
+void BM_MixerAddSamplesSFloat(benchmark::State& state)
+{
+	const auto samples = make_samples<float>(2, 32000.0f);
+
+	add_samples(state, samples, [](MixerChannel& channel, const float* data) {
+		channel.AddSamples_sfloat(NumFrames, data);
+	});
+}
+BENCHMARK(BM_MixerAddSamplesSFloat);
+
+// One second of a 1 kHz tone at the channel rate, resampled to the mixer
+// rate in chunks of typical mixer callback sizes, by the polyphase resampler
+// and by Speex at the quality the mixer uses
+constexpr int MixerRateHz    = 48000;
+constexpr size_t ChunkFrames = 256;
+constexpr int SpeexQuality   = 5;
+
+std::vector<AudioFrame> make_tone(const int rate_hz)
+{
+	std::vector<AudioFrame> frames(static_cast<size_t>(rate_hz));
+	for (size_t i = 0; i < frames.size(); ++i) {
+		const auto t = static_cast<double>(i) / rate_hz;
+		const auto v = static_cast<float>(
+		        0.5 * std::sin(2.0 * std::numbers::pi * 1000.0 * t));
+		frames[i] = {v, -v};
+	}
+	return frames;
+}
+
+void BM_MixerResamplePolyphase(benchmark::State& state)
+{
+	const auto rate_hz = static_cast<int>(state.range(0));
+	const auto in      = make_tone(rate_hz);
+
+	std::vector<AudioFrame> out = {};
+
+	for (auto _ : state) {
+		PolyphaseResampler resampler = {};
+		resampler.Configure(rate_hz, MixerRateHz);
+
+		out.clear();
+		for (size_t i = 0; i < in.size(); i += ChunkFrames) {
+			resampler.Process(&in[i], std::min(ChunkFrames, in.size() - i), out);
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_MixerResampleSpeex(benchmark::State& state)
+{
+	const auto rate_hz = static_cast<int>(state.range(0));
+	const auto in      = make_tone(rate_hz);
+
+	std::vector<AudioFrame> out(static_cast<size_t>(MixerRateHz) + ChunkFrames);
+
+	for (auto _ : state) {
+		auto resampler = speex_resampler_init(2,
+		                                      static_cast<spx_uint32_t>(rate_hz),
+		                                      MixerRateHz,
+		                                      SpeexQuality,
+		                                      nullptr);
+		speex_resampler_skip_zeros(resampler);
+
+		size_t num_out = 0;
+		for (size_t i = 0; i < in.size(); i += ChunkFrames) {
+			auto in_frames = static_cast<spx_uint32_t>(
+			        std::min(ChunkFrames, in.size() - i));
+			auto out_frames = static_cast<spx_uint32_t>(out.size() - num_out);
+
+			speex_resampler_process_interleaved_float(resampler,
+			                                          &in[i].left,
+			                                          &in_frames,
+			                                          &out[num_out].left,
+			                                          &out_frames);
+			num_out += out_frames;
+		}
+		speex_resampler_destroy(resampler);
+
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Channel rates of the PC speaker, Sound Blaster, OPL, and CMS
+BENCHMARK(BM_MixerResamplePolyphase)
+        ->Arg(32000)
+        ->Arg(22050)
+        ->Arg(44100)
+        ->Arg(49716)
+        ->Arg(223722);
+BENCHMARK(BM_MixerResampleSpeex)
+        ->Arg(32000)
+        ->Arg(22050)
+        ->Arg(44100)
+        ->Arg(49716)
+        ->Arg(223722);
+
+} // namespace
@@ -2,9 +2,18 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "audio/mixer.h"
+#include "audio/private/noise_gate.h"
+#include "audio/private/polyphase_resampler.h"
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <vector>
+
+#include <speex/speex_resampler.h>
+
 static void callback(const uint16_t) {}
 
 constexpr auto ChannelName = "TEST";
@@ -64,4 +73,255 @@ TEST(MixerConfigureFadeOut, OutOfBounds)
 	ASSERT_FALSE(channel.ConfigureFadeOut("3001 10000"));
 }
 
+TEST(MixerNoiseGate, BlockMatchesPerFrame)
+{
+	constexpr auto SampleRateHz = 48000;
+	constexpr auto NumFrames    = 4800;
+
+	auto configure = [](NoiseGate& gate) {
+		gate.Configure(SampleRateHz, 32767.0f, -40.0f, 1.0f, 20.0f);
+	};
+
+	NoiseGate per_frame_gate = {};
+	NoiseGate block_gate     = {};
+	configure(per_frame_gate);
+	configure(block_gate);
+
+	// A decaying tone that falls below the threshold halfway through
+	std::vector<AudioFrame> frames = {};
+	for (auto i = 0; i < NumFrames; ++i) {
+		const auto amplitude = (i < NumFrames / 2) ? 10000.0f : 50.0f;
+		const auto sample = amplitude * static_cast<float>(std::sin(i * 0.05));
+		frames.emplace_back(sample, -sample);
+	}
+
+	auto expected = frames;
+	for (auto& frame : expected) {
+		frame = per_frame_gate.Process(frame);
+	}
+
+	// Uneven block sizes must carry the state over between blocks
+	auto remaining = std::span(frames);
+	for (size_t block_size = 1; !remaining.empty(); block_size *= 3) {
+		const auto n = std::min(block_size, remaining.size());
+		block_gate.Process(remaining.first(n));
+		remaining = remaining.subspan(n);
+	}
+
+	for (size_t i = 0; i < frames.size(); ++i) {
+		EXPECT_FLOAT_EQ(frames[i].left, expected[i].left);
+		EXPECT_FLOAT_EQ(frames[i].right, expected[i].right);
+	}
+}
+
+// Resampler quality compared with Speex at the quality the mixer uses
+
+constexpr auto SpeexQuality = 5;
+
+// Input is fed in chunks of typical mixer callback sizes
+constexpr size_t ChunkFrames = 256;
+
+static std::vector<AudioFrame> make_tone(const int rate_hz,
+                                         const double freq_hz,
+                                         const int num_frames)
+{
+	std::vector<AudioFrame> frames(static_cast<size_t>(num_frames));
+	for (int i = 0; i < num_frames; ++i) {
+		const auto t = static_cast<double>(i) / rate_hz;
+		const auto v = static_cast<float>(
+		        0.5 * std::sin(2.0 * std::numbers::pi * freq_hz * t));
+		frames[static_cast<size_t>(i)] = {v, -v};
+	}
+	return frames;
+}
+
+static std::vector<AudioFrame> resample_polyphase(
+        const int in_rate_hz, const int out_rate_hz,
+        const std::vector<AudioFrame>& in)
+{
+	PolyphaseResampler resampler = {};
+	resampler.Configure(in_rate_hz, out_rate_hz);
+
+	std::vector<AudioFrame> out = {};
+	for (size_t i = 0; i < in.size(); i += ChunkFrames) {
+		resampler.Process(&in[i], std::min(ChunkFrames, in.size() - i), out);
+	}
+	return out;
+}
+
+static std::vector<AudioFrame> resample_speex(const int in_rate_hz,
+                                              const int out_rate_hz,
+                                              const std::vector<AudioFrame>& in)
+{
+	auto state = speex_resampler_init(2,
+	                                  static_cast<spx_uint32_t>(in_rate_hz),
+	                                  static_cast<spx_uint32_t>(out_rate_hz),
+	                                  SpeexQuality,
+	                                  nullptr);
+	speex_resampler_skip_zeros(state);
+
+	std::vector<AudioFrame> out(in.size() * static_cast<size_t>(out_rate_hz) /
+	                                    static_cast<size_t>(in_rate_hz) +
+	                            ChunkFrames);
+	size_t num_out = 0;
+
+	for (size_t i = 0; i < in.size(); i += ChunkFrames) {
+		auto in_frames  = static_cast<spx_uint32_t>(
+		        std::min(ChunkFrames, in.size() - i));
+		auto out_frames = static_cast<spx_uint32_t>(out.size() - num_out);
+
+		speex_resampler_process_interleaved_float(state,
+		                                          &in[i].left,
+		                                          &in_frames,
+		                                          &out[num_out].left,
+		                                          &out_frames);
+		num_out += out_frames;
+	}
+	speex_resampler_destroy(state);
+
+	out.resize(num_out);
+	return out;
+}
+
+// Returns the ratio of the tone's power to everything else in the left
+// channel, in dB. The tone's amplitude and phase are fitted to the output so
+// the resamplers' different delays don't matter.
+static double tone_snr_db(const std::vector<AudioFrame>& frames,
+                          const int rate_hz, const double freq_hz)
+{
+	// Skip the filter warm-up and the tail
+	const auto start = frames.size() / 10;
+	const auto end   = frames.size() - start;
+
+	const auto w = 2.0 * std::numbers::pi * freq_hz / rate_hz;
+
+	// Least-squares fit of 'a * sin + b * cos'
+	double ss = 0.0;
+	double sc = 0.0;
+	double cc = 0.0;
+	double ys = 0.0;
+	double yc = 0.0;
+	for (auto i = start; i < end; ++i) {
+		const auto s = std::sin(w * static_cast<double>(i));
+		const auto c = std::cos(w * static_cast<double>(i));
+
+		ss += s * s;
+		sc += s * c;
+		cc += c * c;
+		ys += frames[i].left * s;
+		yc += frames[i].left * c;
+	}
+	const auto det = ss * cc - sc * sc;
+
+	const auto a = (ys * cc - yc * sc) / det;
+	const auto b = (yc * ss - ys * sc) / det;
+
+	double signal = 0.0;
+	double noise  = 0.0;
+	for (auto i = start; i < end; ++i) {
+		const auto t    = w * static_cast<double>(i);
+		const auto tone = a * std::sin(t) + b * std::cos(t);
+		signal += tone * tone;
+		noise += (frames[i].left - tone) * (frames[i].left - tone);
+	}
+	return 10.0 * std::log10(signal / noise);
+}
+
+// Returns the RMS level of the left channel relative to the test tone's
+static double level_db(const std::vector<AudioFrame>& frames)
+{
+	const auto start = frames.size() / 10;
+	const auto end   = frames.size() - start;
+
+	double power = 0.0;
+	for (auto i = start; i < end; ++i) {
+		power += frames[i].left * frames[i].left;
+	}
+	const auto rms = std::sqrt(power / static_cast<double>(end - start));
+
+	// RMS of the 0.5 amplitude test tone
+	const auto tone_rms = 0.5 / std::numbers::sqrt2;
+
+	return 20.0 * std::log10(rms / tone_rms);
+}
+
+constexpr int MixerRateHz = 48000;
+
+// Channel rates of the PC speaker, Sound Blaster, OPL, and CMS
+constexpr int ChannelRatesHz[] = {32000, 22050, 44100, 49716, 223722};
+
+TEST(MixerPolyphaseResampler, ToneQuality)
+{
+	for (const auto rate_hz : ChannelRatesHz) {
+		for (const auto freq_hz : {1000.0, 5000.0, 10000.0}) {
+			const auto in = make_tone(rate_hz, freq_hz, rate_hz);
+
+			const auto snr = tone_snr_db(
+			        resample_polyphase(rate_hz, MixerRateHz, in),
+			        MixerRateHz,
+			        freq_hz);
+
+			const auto speex_snr = tone_snr_db(
+			        resample_speex(rate_hz, MixerRateHz, in),
+			        MixerRateHz,
+			        freq_hz);
+
+			EXPECT_GT(snr, 80.0)
+			        << rate_hz << " Hz, " << freq_hz
+			        << " Hz tone; Speex SNR " << speex_snr << " dB";
+		}
+	}
+}
+
+TEST(MixerPolyphaseResampler, RejectsAliases)
+{
+	// Tones above the output's Nyquist frequency must be filtered out
+	// rather than fold back into the audible band
+	constexpr struct {
+		int in_rate_hz;
+		int out_rate_hz;
+		double freq_hz;
+	} Cases[] = {
+	        {223722, 48000, 30000.0},
+	        {223722, 48000, 60000.0},
+	        {49716, 44100, 24000.0},
+	        {48000, 44100, 23500.0},
+	};
+
+	for (const auto& c : Cases) {
+		const auto in = make_tone(c.in_rate_hz, c.freq_hz, c.in_rate_hz);
+
+		const auto level = level_db(
+		        resample_polyphase(c.in_rate_hz, c.out_rate_hz, in));
+
+		const auto speex_level = level_db(
+		        resample_speex(c.in_rate_hz, c.out_rate_hz, in));
+
+		EXPECT_LT(level, -70.0)
+		        << c.in_rate_hz << " Hz -> " << c.out_rate_hz << " Hz, "
+		        << c.freq_hz << " Hz tone; Speex " << speex_level << " dB";
+	}
+}
+
+TEST(MixerPolyphaseResampler, OutputLength)
+{
+	for (const auto rate_hz : ChannelRatesHz) {
+		PolyphaseResampler resampler = {};
+		resampler.Configure(rate_hz, MixerRateHz);
+
+		const std::vector<AudioFrame> in(static_cast<size_t>(rate_hz));
+
+		std::vector<AudioFrame> out = {};
+		resampler.Process(in.data(), in.size(), out);
+
+		// One second of input yields one second of output, minus the
+		// frames still waiting for the rest of the filter's input
+		const auto num_pending = static_cast<int>(resampler.GetNumTaps() / 2) *
+		                                 MixerRateHz / rate_hz + 1;
+
+		EXPECT_LE(static_cast<int>(out.size()), MixerRateHz);
+		EXPECT_GE(static_cast<int>(out.size()), MixerRateHz - num_pending);
+	}
+}
+
 } // namespace
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "hardware/video/reelmagic/private/mpeg_video_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+std::mt19937_64 generator(1234);
+
+// Dequantised coefficients are clipped to -2048..2047 and premultiplied by at
+// most 62; the sparse blocks are the common case of a few low-frequency
+// coefficients
+std::vector<int> random_block(const bool is_sparse)
+{
+	std::uniform_int_distribution<int> coefficient(-2048 * 62, 2047 * 62);
+
+	std::vector<int> block(64, 0);
+	for (auto n = 0; n < 64; ++n) {
+		if (!is_sparse || (n < 10 && (generator() & 1))) {
+			block[static_cast<size_t>(n)] = coefficient(generator);
+		}
+	}
+	return block;
+}
+
+std::vector<uint8_t> random_pixels(const size_t num_pixels)
+{
+	std::vector<uint8_t> pixels(num_pixels);
+	for (auto& pixel : pixels) {
+		pixel = static_cast<uint8_t>(generator());
+	}
+	return pixels;
+}
+
+TEST(MpegVideoKernels, IdctMatchesScalar)
+{
+	for (auto n = 0; n < 1000; ++n) {
+		auto simd_block = random_block(n % 2 == 0);
+		auto ref_block  = simd_block;
+
+		idct_8x8(simd_block.data());
+		scalar::idct_8x8(ref_block.data());
+
+		ASSERT_EQ(simd_block, ref_block) << "block: " << n;
+	}
+}
+
+TEST(MpegVideoKernels, PutAndAddMatchScalar)
+{
+	constexpr int Stride = 24;
+
+	for (auto n = 0; n < 100; ++n) {
+		auto block = random_block(false);
+		scalar::idct_8x8(block.data());
+
+		const auto pixels = random_pixels(Stride * 8);
+
+		auto simd_pixels = pixels;
+		auto ref_pixels  = pixels;
+		put_idct_block(block.data(), simd_pixels.data(), Stride);
+		scalar::put_idct_block(block.data(), ref_pixels.data(), Stride);
+		ASSERT_EQ(simd_pixels, ref_pixels) << "put block: " << n;
+
+		simd_pixels = pixels;
+		ref_pixels  = pixels;
+		add_idct_block(block.data(), simd_pixels.data(), Stride);
+		scalar::add_idct_block(block.data(), ref_pixels.data(), Stride);
+		ASSERT_EQ(simd_pixels, ref_pixels) << "add block: " << n;
+	}
+}
+
+TEST(MpegVideoKernels, PredictionMatchesScalar)
+{
+	constexpr int Stride = 40;
+
+	for (const auto size : {8, 16}) {
+		for (auto mode = 0; mode < 8; ++mode) {
+			const auto half_h  = (mode & 1) != 0;
+			const auto half_v  = (mode & 2) != 0;
+			const auto average = (mode & 4) != 0;
+
+			// The half-pixel offsets read one more row and column
+			const auto src = random_pixels(Stride * (size + 1));
+			const auto dest = random_pixels(Stride * size);
+
+			auto simd_dest = dest;
+			auto ref_dest  = dest;
+
+			predict_block(src.data(), simd_dest.data(), Stride, size,
+			              half_h, half_v, average);
+			scalar::predict_block(src.data(), ref_dest.data(), Stride,
+			                      size, half_h, half_v, average);
+
+			EXPECT_EQ(simd_dest, ref_dest)
+			        << "size: " << size << ", mode: " << mode;
+		}
+	}
+}
+
+} // namespace
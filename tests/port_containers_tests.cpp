@@ -5,6 +5,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -122,6 +123,68 @@ TEST(port_containers, empty_writes)
 	write_byte_to_port(unregistered, 0);
 }
 
+TEST(port_containers, freed_range)
+{
+	constexpr uint16_t port  = 0x3c0;
+	constexpr uint16_t range = 4;
+
+	IO_RegisterReadHandler(port, read_byte_new, io_width_t::byte, range);
+	IO_RegisterWriteHandler(port, write_byte_new, io_width_t::byte, range);
+
+	write_byte_to_port(port, 0x12);
+	EXPECT_EQ(read_byte_from_port(port + range - 1), 0x12);
+
+	// Freeing part of the range leaves the rest installed
+	IO_FreeReadHandler(port, io_width_t::byte, 2);
+	EXPECT_EQ(read_byte_from_port(port), 0xff);
+	EXPECT_EQ(read_byte_from_port(port + 2), 0x12);
+
+	IO_FreeReadHandler(port + 2, io_width_t::byte, 2);
+	IO_FreeWriteHandler(port, io_width_t::byte, range);
+	EXPECT_EQ(read_byte_from_port(port + 2), 0xff);
+
+	// Writes to the freed ports are dropped
+	write_byte_to_port(port, 0x34);
+	EXPECT_EQ(byte_val_new, 0x12);
+}
+
+TEST(port_containers, block_handlers)
+{
+	constexpr io_port_t port = 0x1f0;
+
+	std::vector<uint8_t> device(8);
+	for (size_t i = 0; i < device.size(); ++i) {
+		device[i] = static_cast<uint8_t>(i + 1);
+	}
+
+	// Serves whole words from the device buffer until it runs out
+	IO_RegisterBlockReadHandler(port,
+	                            [&](io_port_t, io_width_t width,
+	                                uint8_t* data, uint32_t count) {
+		                            const auto size = static_cast<uint32_t>(width);
+		                            const auto n = std::min<uint32_t>(
+		                                    count, device.size() / size);
+		                            std::memcpy(data, device.data(), n * size);
+		                            return n;
+	                            });
+
+	uint8_t data[16] = {};
+	EXPECT_EQ(read_block_from_port(port, io_width_t::word, data, 2), 2);
+	EXPECT_EQ(data[0], 1);
+	EXPECT_EQ(data[3], 4);
+	EXPECT_EQ(data[4], 0);
+
+	// A partial transfer leaves the rest to the regular handlers
+	EXPECT_EQ(read_block_from_port(port, io_width_t::word, data, 8), 4);
+
+	// Ports without a block handler move nothing
+	EXPECT_EQ(read_block_from_port(port + 1, io_width_t::word, data, 2), 0);
+	EXPECT_EQ(write_block_to_port(port, io_width_t::word, data, 2), 0);
+
+	IO_FreeBlockReadHandler(port);
+	EXPECT_EQ(read_block_from_port(port, io_width_t::word, data, 2), 0);
+}
+
 // The following tests are temporarily disabled as they
 // are currently failing on all platforms.
 // Investigations have revealed the test cases rely on 
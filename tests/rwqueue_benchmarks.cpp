@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "utils/rwqueue.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace {
+
+// Audio-sized blocks, as moved between the device and mixer threads
+void BM_RWQueueBulkRoundTrip(benchmark::State& state)
+{
+	const auto block_size = static_cast<size_t>(state.range(0));
+
+	RWQueue<float> queue(block_size * 4);
+
+	std::vector<float> source = {};
+	std::vector<float> target = {};
+
+	for (auto _ : state) {
+		source.assign(block_size, 0.5f);
+
+		queue.BulkEnqueue(source);
+		queue.BulkDequeue(target, block_size);
+
+		benchmark::DoNotOptimize(target.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RWQueueBulkRoundTrip)->Arg(64)->Arg(1024)->Arg(16384);
+
+void BM_RWQueueNonblockingBulkEnqueue(benchmark::State& state)
+{
+	const auto block_size = static_cast<size_t>(state.range(0));
+
+	RWQueue<float> queue(block_size);
+
+	std::vector<float> source = {};
+	std::vector<float> target(block_size);
+
+	for (auto _ : state) {
+		source.assign(block_size, 0.5f);
+
+		queue.NonblockingBulkEnqueue(source);
+		queue.BulkDequeue(target.data(), block_size);
+
+		benchmark::DoNotOptimize(target.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RWQueueNonblockingBulkEnqueue)->Arg(64)->Arg(1024)->Arg(16384);
+
+} // namespace
@@ -0,0 +1,273 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "utils/spsc_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+constexpr auto iterations = 10000;
+
+TEST(SpscQueue, TrivialSerial)
+{
+	SpscQueue<int> q(65);
+	for (int iteration = 0; iteration != 128; ++iteration) {
+		// The ring wraps around at different positions in each
+		// iteration
+		EXPECT_EQ(q.MaxCapacity(), 65);
+		EXPECT_EQ(q.Size(), 0);
+		EXPECT_TRUE(q.IsEmpty());
+		q.Enqueue(0);
+		EXPECT_EQ(q.Size(), 1);
+		EXPECT_FALSE(q.IsEmpty());
+		for (int i = 1; i != 65; ++i) {
+			q.Enqueue(std::move(i));
+		}
+		EXPECT_EQ(q.Size(), 65);
+		EXPECT_TRUE(q.IsFull());
+
+		auto item = q.Dequeue();
+		EXPECT_EQ(*item, 0);
+		for (int i = 1; i != 65; ++i) {
+			item = q.Dequeue();
+			EXPECT_EQ(*item, i);
+		}
+		EXPECT_TRUE(q.IsEmpty());
+
+		// Offset the next iteration by one item
+		q.Enqueue(-1);
+		EXPECT_EQ(*q.Dequeue(), -1);
+	}
+}
+
+TEST(SpscQueue, TrivialZeroCapacity)
+{
+	EXPECT_DEBUG_DEATH({ SpscQueue<int> q(0); }, "");
+}
+
+TEST(SpscQueue, Nonblocking)
+{
+	SpscQueue<int> q(4);
+
+	std::vector<int> items = {0, 1, 2};
+	EXPECT_EQ(q.NonblockingBulkEnqueue(items), 3);
+	EXPECT_TRUE(items.empty());
+
+	EXPECT_TRUE(q.NonblockingEnqueue(3));
+	EXPECT_FALSE(q.NonblockingEnqueue(4));
+
+	items = {4, 5};
+	EXPECT_EQ(q.NonblockingBulkEnqueue(items), 0);
+	EXPECT_EQ(items.size(), 2);
+
+	EXPECT_EQ(*q.Dequeue(), 0);
+	EXPECT_EQ(q.NonblockingBulkEnqueue(items), 1);
+	EXPECT_EQ(items, std::vector<int>{5});
+
+	std::vector<int> out = {};
+	EXPECT_EQ(q.BulkDequeue(out, 4), 4);
+	EXPECT_EQ(out, (std::vector<int>{1, 2, 3, 4}));
+}
+
+TEST(SpscQueue, FillLimit)
+{
+	SpscQueue<int> q(8);
+	EXPECT_EQ(q.GetFillLimit(), 8);
+
+	q.SetFillLimit(3);
+	EXPECT_EQ(q.GetFillLimit(), 3);
+
+	std::vector<int> items = {0, 1, 2, 3, 4};
+	EXPECT_EQ(q.NonblockingBulkEnqueue(items), 3);
+	EXPECT_FALSE(q.NonblockingEnqueue(5));
+
+	q.SetFillLimit(4);
+	EXPECT_EQ(q.NonblockingBulkEnqueue(items), 1);
+	EXPECT_EQ(q.Size(), 4);
+
+	// Lowering the limit keeps the queued items
+	q.SetFillLimit(2);
+	EXPECT_EQ(q.Size(), 4);
+	EXPECT_FALSE(q.NonblockingEnqueue(5));
+
+	// Clamped to the capacity
+	q.SetFillLimit(0);
+	EXPECT_EQ(q.GetFillLimit(), 1);
+	q.SetFillLimit(100);
+	EXPECT_EQ(q.GetFillLimit(), 8);
+
+	// Resizing resets the limit
+	q.SetFillLimit(2);
+	q.Resize(16);
+	EXPECT_EQ(q.GetFillLimit(), 16);
+}
+
+TEST(SpscQueue, FillLimitAsync)
+{
+	SpscQueue<int> q(64);
+	q.SetFillLimit(4);
+
+	std::thread writer([&] {
+		for (int i = 0; i != iterations; ++i) {
+			q.Enqueue(std::move(i));
+		}
+	});
+
+	// Bulk dequeues larger than the limit must not wait forever, even
+	// when the limit changes in between
+	std::vector<int> items = {};
+	int expected_val       = 0;
+	for (size_t limit = 1; expected_val != iterations; limit = limit % 48 + 1) {
+		q.SetFillLimit(limit);
+
+		const auto num_wanted = std::min(50, iterations - expected_val);
+		EXPECT_EQ(q.BulkDequeue(items, num_wanted), num_wanted);
+		for (const auto item : items) {
+			EXPECT_EQ(item, expected_val++);
+		}
+	}
+	writer.join();
+
+	EXPECT_EQ(q.Size(), 0);
+}
+
+TEST(SpscQueue, StopDrainsQueuedItems)
+{
+	SpscQueue<int> q(8);
+
+	q.Enqueue(1);
+	q.Enqueue(2);
+	q.Stop();
+
+	EXPECT_FALSE(q.IsRunning());
+	EXPECT_FALSE(q.Enqueue(3));
+
+	std::vector<int> out = {};
+	EXPECT_EQ(q.BulkDequeue(out, 5), 2);
+	EXPECT_EQ(out, (std::vector<int>{1, 2}));
+	EXPECT_FALSE(q.Dequeue().has_value());
+}
+
+TEST(SpscQueue, StopWakesBlockedConsumer)
+{
+	SpscQueue<int> q(8);
+
+	std::thread reader([&] { EXPECT_FALSE(q.Dequeue().has_value()); });
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	q.Stop();
+	reader.join();
+}
+
+TEST(SpscQueue, TrivialMoveAsync)
+{
+	const size_t max_depth = 8;
+	SpscQueue<int> q(max_depth);
+
+	std::thread writer([&] {
+		for (int i = 0; i != iterations; ++i) {
+			q.Enqueue(std::move(i));
+			EXPECT_TRUE(q.Size() <= max_depth);
+		}
+	});
+	std::thread reader([&] {
+		for (int i = 0; i != iterations; ++i) {
+			EXPECT_EQ(*q.Dequeue(), i);
+		}
+	});
+
+	writer.join();
+	reader.join();
+
+	EXPECT_EQ(q.Size(), 0);
+}
+
+void bulk_enqueue(SpscQueue<int>& q, const size_t total_to_enqueue,
+                  const size_t num_per_bulk_enqueue)
+{
+	auto i               = 0;
+	auto remaining_items = total_to_enqueue;
+	auto num_to_enqueue  = num_per_bulk_enqueue;
+
+	std::vector<int> items = {};
+
+	while (remaining_items > 0) {
+		items.push_back(i);
+		--remaining_items;
+
+		if (items.size() == num_to_enqueue) {
+			q.BulkEnqueue(items, num_to_enqueue);
+			EXPECT_TRUE(items.empty());
+
+			num_to_enqueue = std::min(remaining_items,
+			                          num_per_bulk_enqueue);
+		}
+		++i;
+	}
+}
+
+void bulk_dequeue(SpscQueue<int>& q, const size_t total_to_dequeue,
+                  const size_t num_per_bulk_dequeue)
+{
+	auto expected_val    = 0;
+	auto remaining_items = total_to_dequeue;
+
+	std::vector<int> items = {};
+
+	while (remaining_items > 0) {
+		const auto num_to_dequeue = std::min(remaining_items,
+		                                     num_per_bulk_dequeue);
+
+		EXPECT_EQ(q.BulkDequeue(items, num_to_dequeue), num_to_dequeue);
+		remaining_items -= num_to_dequeue;
+
+		for (const auto item : items) {
+			EXPECT_EQ(item, expected_val++);
+		}
+	}
+}
+
+using bulk_params_t = typename std::tuple<size_t, size_t, size_t, size_t>;
+
+TEST(SpscQueue, AsyncBulkIO)
+{
+	for (const auto& [queue_capacity,
+	                  num_per_bulk_enqueue,
+	                  num_per_bulk_dequeue,
+	                  total_to_queue] : {
+
+	             bulk_params_t{1, 1, 1, 50},
+	             bulk_params_t{50, 1, 1, 242},
+	             bulk_params_t{10, 10, 10, 50},
+	             bulk_params_t{10, 3, 10, 50},
+	             bulk_params_t{10, 10, 3, 50},
+	             bulk_params_t{7, 50, 2, 57},
+	             bulk_params_t{9, 5, 20, 53},
+	             bulk_params_t{64, 48, 37, 10000},
+
+	     }) {
+		SpscQueue<int> q(queue_capacity);
+
+		std::thread writer(bulk_enqueue,
+		                   std::ref(q),
+		                   total_to_queue,
+		                   num_per_bulk_enqueue);
+		std::thread reader(bulk_dequeue,
+		                   std::ref(q),
+		                   total_to_queue,
+		                   num_per_bulk_dequeue);
+
+		writer.join();
+		reader.join();
+
+		EXPECT_EQ(q.Size(), 0);
+	}
+}
+
+} // namespace
@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gui/render/private/deinterlacer_kernels.h"
+#include "zmbv/zmbv.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// 640 pixels wide rows, as in the common VGA modes
+constexpr int NumChunks = 10;
+
+std::vector<uint32_t> make_row(std::mt19937& generator)
+{
+	constexpr uint32_t BgColor = 0x080808;
+
+	std::vector<uint32_t> pixels(NumChunks * 64);
+	for (auto& pixel : pixels) {
+		const auto r = generator();
+		pixel        = (r & 1) ? BgColor : (r >> 8);
+	}
+	return pixels;
+}
+
+void BM_DeinterlacerThresholdRow(benchmark::State& state)
+{
+	std::mt19937 generator(1234);
+	const auto pixels = make_row(generator);
+
+	std::vector<uint64_t> mask(NumChunks);
+
+	for (auto _ : state) {
+		threshold_row(pixels.data(), 0x080808, mask.data(), NumChunks);
+		benchmark::DoNotOptimize(mask.data());
+	}
+	state.SetItemsProcessed(state.iterations() * NumChunks * 64);
+}
+BENCHMARK(BM_DeinterlacerThresholdRow);
+
+void BM_DeinterlacerMorphology(benchmark::State& state)
+{
+	std::mt19937_64 generator(1234);
+
+	// One extra chunk read past the end by the horizontal operations
+	std::vector<uint64_t> prev(NumChunks + 1);
+	std::vector<uint64_t> curr(NumChunks + 1);
+	std::vector<uint64_t> next(NumChunks + 1);
+	for (auto i = 0; i < NumChunks; ++i) {
+		prev[i] = generator();
+		curr[i] = generator();
+		next[i] = generator();
+	}
+
+	std::vector<uint64_t> vertical(NumChunks + 1);
+	std::vector<uint64_t> out(NumChunks + 1);
+
+	for (auto _ : state) {
+		erode_row_vertical(prev.data(), curr.data(), next.data(), vertical.data(), NumChunks);
+		dilate_row_horizontal(vertical.data(), out.data(), NumChunks);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * NumChunks * 64);
+}
+BENCHMARK(BM_DeinterlacerMorphology);
+
+void BM_DeinterlacerMaskedBleed(benchmark::State& state)
+{
+	std::mt19937 generator(1234);
+	const auto in = make_row(generator);
+
+	std::vector<uint32_t> out(in.size());
+
+	for (auto _ : state) {
+		for (auto i = 0; i < NumChunks; ++i) {
+			apply_masked_bleed_64(0x5555'aaaa'0f0f'f0f0,
+			                      in.data() + i * 64,
+			                      out.data() + i * 64,
+			                      128);
+		}
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * NumChunks * 64);
+}
+BENCHMARK(BM_DeinterlacerMaskedBleed);
+
+// Compresses frames of a scrolling noise pattern with a few changed pixels
+// each, so the encoder has to search for motion vectors
+void BM_ZmbvCompressFrame(benchmark::State& state)
+{
+	constexpr int Width  = 640;
+	constexpr int Height = 480;
+	constexpr int NumFrames = 8;
+
+	const auto format = static_cast<ZMBV_FORMAT>(state.range(0));
+	const auto pitch  = Width * ZMBV_ToBytesPerPixel(format);
+
+	std::mt19937 generator(1234);
+
+	std::vector<uint8_t> pattern(static_cast<size_t>(pitch * (Height + NumFrames)));
+	for (auto& b : pattern) {
+		b = static_cast<uint8_t>(generator());
+	}
+
+	VideoCodec encoder = {};
+	if (!encoder.SetupCompress(Width, Height)) {
+		state.SkipWithError("Could not set up the encoder");
+		return;
+	}
+
+	std::vector<uint8_t> palette(256 * 4);
+	std::vector<uint8_t> compressed(
+	        static_cast<size_t>(encoder.NeededSize(Width, Height, format)));
+
+	auto frame_num = 0;
+	for (auto _ : state) {
+		const auto n = frame_num % NumFrames;
+
+		encoder.PrepareCompressFrame((n == 0) ? 1 : 0,
+		                             format,
+		                             palette.data(),
+		                             compressed.data(),
+		                             static_cast<uint32_t>(compressed.size()));
+
+		for (auto y = 0; y < Height; ++y) {
+			const uint8_t* row = pattern.data() + (y + n) * pitch;
+			encoder.CompressLines(1, &row);
+		}
+		benchmark::DoNotOptimize(encoder.FinishCompressFrame());
+
+		++frame_num;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ZmbvCompressFrame)
+        ->Arg(static_cast<int>(ZMBV_FORMAT::BPP_8))
+        ->Arg(static_cast<int>(ZMBV_FORMAT::BPP_32))
+        ->Unit(benchmark::kMillisecond);
+
+} // namespace
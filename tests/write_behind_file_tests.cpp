@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "capture/private/write_behind_file.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+std::vector<uint8_t> read_all(FILE* file)
+{
+	std::vector<uint8_t> contents = {};
+
+	rewind(file);
+	for (auto c = fgetc(file); c != EOF; c = fgetc(file)) {
+		contents.push_back(static_cast<uint8_t>(c));
+	}
+	return contents;
+}
+
+TEST(WriteBehindFile, WritesEverythingInOrder)
+{
+	auto file = tmpfile();
+	ASSERT_TRUE(file);
+
+	// Larger than a write chunk so the background thread writes both full
+	// chunks and the remainder when flushed
+	std::vector<uint8_t> expected(200 * 1000);
+	std::iota(expected.begin(), expected.end(), uint8_t(0));
+
+	{
+		WriteBehindFile writer(file, 1024 * 1024, "test");
+
+		constexpr size_t WriteSize = 1000;
+		for (size_t pos = 0; pos < expected.size(); pos += WriteSize) {
+			EXPECT_TRUE(writer.Write(expected.data() + pos, WriteSize));
+		}
+		writer.Flush();
+
+		EXPECT_EQ(writer.GetNumBytesWritten(), expected.size());
+		EXPECT_EQ(writer.GetNumBytesDropped(), 0);
+	}
+
+	EXPECT_EQ(read_all(file), expected);
+	fclose(file);
+}
+
+TEST(WriteBehindFile, DropsWholeWritesThatDontFit)
+{
+	auto file = tmpfile();
+	ASSERT_TRUE(file);
+
+	const std::vector<uint8_t> small = {1, 2, 3, 4};
+	const std::vector<uint8_t> large(17, 0xff);
+
+	{
+		WriteBehindFile writer(file, 16, "test");
+
+		EXPECT_TRUE(writer.Write(small.data(), small.size()));
+		EXPECT_FALSE(writer.Write(large.data(), large.size()));
+		writer.Flush();
+
+		// Nothing can be written after flushing
+		EXPECT_FALSE(writer.Write(small.data(), small.size()));
+
+		EXPECT_EQ(writer.GetNumBytesWritten(), small.size());
+		EXPECT_EQ(writer.GetNumBytesDropped(), large.size() + small.size());
+	}
+
+	EXPECT_EQ(read_all(file), small);
+	fclose(file);
+}
+
+} // namespace
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "hardware/video/reelmagic/private/ycbcr_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// Widths that aren't a multiple of 16 exercise the scalar tails after the
+// vectorised parts
+constexpr int Widths[] = {2, 14, 16, 18, 46, 320, 352};
+
+std::mt19937_64 generator(1234);
+
+std::vector<uint8_t> random_bytes(const int num_bytes)
+{
+	std::vector<uint8_t> bytes(static_cast<size_t>(num_bytes));
+	for (auto& byte : bytes) {
+		byte = static_cast<uint8_t>(generator());
+	}
+	return bytes;
+}
+
+TEST(YCbCrKernels, RowPairMatchesScalar)
+{
+	for (const auto width : Widths) {
+		const auto y0 = random_bytes(width);
+		const auto y1 = random_bytes(width);
+		const auto cb = random_bytes(width / 2);
+		const auto cr = random_bytes(width / 2);
+
+		const auto num_pixels = static_cast<size_t>(width);
+
+		std::vector<uint32_t> simd_out0(num_pixels);
+		std::vector<uint32_t> simd_out1(num_pixels);
+		std::vector<uint32_t> ref_out0(num_pixels);
+		std::vector<uint32_t> ref_out1(num_pixels);
+
+		ycbcr420_to_bgrx_row_pair(y0.data(), y1.data(), cb.data(), cr.data(),
+		                          simd_out0.data(), simd_out1.data(), width);
+		scalar::ycbcr420_to_bgrx_row_pair(y0.data(), y1.data(), cb.data(),
+		                                  cr.data(), ref_out0.data(),
+		                                  ref_out1.data(), width);
+
+		EXPECT_EQ(simd_out0, ref_out0) << "width: " << width;
+		EXPECT_EQ(simd_out1, ref_out1) << "width: " << width;
+	}
+}
+
+TEST(YCbCrKernels, ConvertsReferenceColours)
+{
+	// Black, white, and the saturated primaries in BT.601 studio swing
+	struct Sample {
+		uint8_t y, cb, cr;
+		uint32_t bgrx;
+	};
+	constexpr Sample Samples[] = {
+	        {16, 128, 128, 0x000000},
+	        {235, 128, 128, 0xffffff},
+	        {81, 90, 240, 0xff0000},
+	        {145, 54, 34, 0x00ff00},
+	        {41, 240, 110, 0x0000ff},
+	};
+
+	for (const auto& s : Samples) {
+		const uint8_t y[2] = {s.y, s.y};
+
+		uint32_t out0[2] = {};
+		uint32_t out1[2] = {};
+		scalar::ycbcr420_to_bgrx_row_pair(y, y, &s.cb, &s.cr, out0, out1, 2);
+
+		// Allow a step of rounding error per component
+		for (auto shift = 0; shift < 32; shift += 8) {
+			const auto expected = static_cast<int>((s.bgrx >> shift) & 0xff);
+			const auto actual = static_cast<int>((out0[0] >> shift) & 0xff);
+			EXPECT_NEAR(actual, expected, 2) << "shift: " << shift;
+		}
+		EXPECT_EQ(out0[0], out1[1]);
+	}
+}
+
+} // namespace
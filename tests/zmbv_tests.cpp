@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText:  2026-2026 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "zmbv/zmbv.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct VideoSize {
+	int width  = 0;
+	int height = 0;
+};
+
+// 640x480 is split into stripes searched in parallel (given enough cores);
+// 100x70 has partial blocks at the right and bottom edges
+constexpr VideoSize VideoSizes[] = {{640, 480}, {100, 70}};
+
+constexpr auto NumFrames = 6;
+
+using Frame = std::vector<uint8_t>;
+
+// Builds frames that scroll, change in places and flip some pixels so the
+// encoder has to find motion vectors and emit XOR deltas
+std::vector<Frame> make_frames(const VideoSize size, const int bytes_per_pixel)
+{
+	std::mt19937 generator(1234);
+	std::uniform_int_distribution<int> byte_dist(0, 255);
+
+	const auto pitch = size.width * bytes_per_pixel;
+
+	Frame pattern(static_cast<size_t>(pitch * (size.height + NumFrames)));
+	for (auto& b : pattern) {
+		b = static_cast<uint8_t>(byte_dist(generator));
+	}
+
+	std::vector<Frame> frames = {};
+	for (auto n = 0; n < NumFrames; ++n) {
+		// Scroll the pattern down by a line per frame
+		Frame frame(pattern.begin() + pitch * n,
+		            pattern.begin() + pitch * (n + size.height));
+
+		// Add noise to a few scattered pixels
+		std::uniform_int_distribution<size_t> pos_dist(0, frame.size() - 1);
+		for (auto i = 0; i < 50; ++i) {
+			frame[pos_dist(generator)] = static_cast<uint8_t>(
+			        byte_dist(generator));
+		}
+		frames.emplace_back(std::move(frame));
+	}
+	return frames;
+}
+
+void round_trip(const VideoSize size, const ZMBV_FORMAT format)
+{
+	const auto bytes_per_pixel = ZMBV_ToBytesPerPixel(format);
+	const auto pitch           = size.width * bytes_per_pixel;
+
+	const auto frames = make_frames(size, bytes_per_pixel);
+
+	VideoCodec encoder = {};
+	ASSERT_TRUE(encoder.SetupCompress(size.width, size.height));
+
+	VideoCodec decoder = {};
+	ASSERT_TRUE(decoder.SetupDecompress(size.width, size.height));
+
+	std::vector<uint8_t> palette(256 * 4);
+	for (size_t i = 0; i < palette.size(); ++i) {
+		palette[i] = static_cast<uint8_t>(i);
+	}
+
+	std::vector<uint8_t> compressed(static_cast<size_t>(
+	        encoder.NeededSize(size.width, size.height, format)));
+
+	for (auto n = 0; n < NumFrames; ++n) {
+		const auto is_key_frame = (n == 0) ? 1 : 0;
+
+		ASSERT_TRUE(encoder.PrepareCompressFrame(
+		        is_key_frame,
+		        format,
+		        palette.data(),
+		        compressed.data(),
+		        static_cast<uint32_t>(compressed.size())));
+
+		for (auto y = 0; y < size.height; ++y) {
+			const uint8_t* row = frames[n].data() + y * pitch;
+			encoder.CompressLines(1, &row);
+		}
+
+		const auto num_bytes = encoder.FinishCompressFrame();
+		ASSERT_GT(num_bytes, 0);
+
+		ASSERT_TRUE(decoder.DecompressFrame(compressed.data(), num_bytes));
+
+		// The decoder only exposes its frame as upside-down BGR24
+		std::vector<uint8_t> decoded(static_cast<size_t>(
+		        (size.width * 3 + 3) * size.height));
+		decoder.Output_UpsideDown_24(decoded.data());
+
+		VideoCodec reference = {};
+		ASSERT_TRUE(reference.SetupDecompress(size.width, size.height));
+
+		// Compare against a key frame of the same image, which doesn't
+		// involve any motion search
+		VideoCodec key_encoder = {};
+		ASSERT_TRUE(key_encoder.SetupCompress(size.width, size.height));
+		std::vector<uint8_t> key_compressed(compressed.size());
+		ASSERT_TRUE(key_encoder.PrepareCompressFrame(
+		        1,
+		        format,
+		        palette.data(),
+		        key_compressed.data(),
+		        static_cast<uint32_t>(key_compressed.size())));
+		for (auto y = 0; y < size.height; ++y) {
+			const uint8_t* row = frames[n].data() + y * pitch;
+			key_encoder.CompressLines(1, &row);
+		}
+		const auto key_bytes = key_encoder.FinishCompressFrame();
+		ASSERT_TRUE(reference.DecompressFrame(key_compressed.data(), key_bytes));
+
+		std::vector<uint8_t> expected(decoded.size());
+		reference.Output_UpsideDown_24(expected.data());
+
+		EXPECT_EQ(decoded, expected) << "frame " << n;
+	}
+}
+
+TEST(Zmbv, RoundTrip8Bpp)
+{
+	for (const auto size : VideoSizes) {
+		round_trip(size, ZMBV_FORMAT::BPP_8);
+	}
+}
+
+TEST(Zmbv, RoundTrip16Bpp)
+{
+	for (const auto size : VideoSizes) {
+		round_trip(size, ZMBV_FORMAT::BPP_16);
+	}
+}
+
+TEST(Zmbv, RoundTrip32Bpp)
+{
+	for (const auto size : VideoSizes) {
+		round_trip(size, ZMBV_FORMAT::BPP_32);
+	}
+}
+
+} // namespace